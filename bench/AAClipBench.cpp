@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "SkAAClip.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkPath.h"
 #include "SkRandom.h"
@@ -242,6 +243,58 @@ private:
     typedef Benchmark INHERITED;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Draws an A8 mask through an AA clip that is either one round rect (long runs) or many small
+// circles (short runs along every edge).
+class AAClipMaskBench : public Benchmark {
+public:
+    AAClipMaskBench(bool dense) : fDense(dense) {
+        fName.printf("aaclip_mask_%s", dense ? "dense" : "sparse");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fMask.allocPixels(SkImageInfo::MakeA8(300, 300));
+        SkRandom rand;
+        for (int y = 0; y < fMask.height(); ++y) {
+            for (int x = 0; x < fMask.width(); ++x) {
+                *fMask.getAddr8(x, y) = rand.nextU() & 0xFF;
+            }
+        }
+
+        if (fDense) {
+            for (int i = 0; i < 40; ++i) {
+                fClip.addCircle(20 + (i % 8) * 45.3f, 20 + (i / 8) * 70.7f, 17.3f);
+            }
+        } else {
+            fClip.addRoundRect(SkRect::MakeLTRB(10.5f, 10.5f, 390.5f, 390.5f), 60, 60);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setColor(0xFF3366AA);
+
+        canvas->save();
+        canvas->clipPath(fClip, true);
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawBitmap(fMask, 10, 20, &paint);
+        }
+        canvas->restore();
+    }
+
+private:
+    SkString fName;
+    SkBitmap fMask;
+    SkPath   fClip;
+    bool     fDense;
+
+    typedef Benchmark INHERITED;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH(return new AAClipBuilderBench(false, false);)
@@ -255,3 +308,5 @@ DEF_BENCH(return new AAClipBench(true, false);)
 DEF_BENCH(return new AAClipBench(true, true);)
 DEF_BENCH(return new NestedAAClipBench(false);)
 DEF_BENCH(return new NestedAAClipBench(true);)
+DEF_BENCH(return new AAClipMaskBench(false);)
+DEF_BENCH(return new AAClipMaskBench(true);)
@@ -63,6 +63,11 @@ public:
         return backend != kNonRendering_Backend;
     }
 
+    // Benches that return true here may have draw() called on several threads at once, each
+    // with its own canvas (or none), and without preDraw()/postDraw().  nanobench --benchThreads
+    // uses this to measure contention on shared state, like Skia's global caches.
+    virtual bool isThreadSafe() const { return false; }
+
     // Allows a benchmark to override options used to construct the GrContext.
     virtual void modifyGrContextOptions(GrContextOptions*) {}
 
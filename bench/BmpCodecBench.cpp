@@ -0,0 +1,132 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "CodecBench.h"
+#include "SkStream.h"
+
+// Benchmarks the RLE and bit mask paths of the bmp codec on synthesized images, since the
+// resources only contain small bmps of these kinds.
+
+static constexpr int kSize = 1024;
+
+enum {
+    kRLE8_Compression = 1,
+    kRLE4_Compression = 2,
+    kBitMasks_Compression = 3,
+};
+
+// Writes a bottom-up bmp with a V1 (40 byte) or V4 (108 byte) info header. V1 headers with bit
+// masks are followed by the red, green and blue masks, V4 headers contain all four.
+static sk_sp<SkData> make_bmp(int bitsPerPixel, uint32_t compression, uint32_t infoBytes,
+                              const uint32_t masks[4], int numColors, const SkData* pixels) {
+    const uint32_t maskBytes = (kBitMasks_Compression == compression && 40 == infoBytes) ? 12 : 0;
+    const uint32_t offset = 14 + infoBytes + maskBytes + 4 * numColors;
+
+    SkDynamicMemoryWStream stream;
+    stream.write("BM", 2);
+    stream.write32(offset + SkToU32(pixels->size()));
+    stream.write32(0);
+    stream.write32(offset);
+
+    stream.write32(infoBytes);
+    stream.write32(kSize);
+    stream.write32(kSize);
+    stream.write16(1);
+    stream.write16(bitsPerPixel);
+    stream.write32(compression);
+    stream.write32(SkToU32(pixels->size()));
+    stream.write32(2835);
+    stream.write32(2835);
+    stream.write32(numColors);
+    stream.write32(0);
+    if (maskBytes) {
+        stream.write(masks, maskBytes);
+    } else if (108 == infoBytes) {
+        stream.write(masks, 16);
+        stream.write32(0x73524742);     // 'sRGB'
+        stream.write32(0);              // Unused endpoints and gamma.
+        for (int i = 0; i < 12; i++) {
+            stream.write32(0);
+        }
+    }
+
+    // A color table of distinct grays.
+    for (int i = 0; i < numColors; i++) {
+        uint8_t gray = i * 255 / (numColors - 1);
+        uint8_t color[4] = { gray, gray, (uint8_t) (255 - gray), 0 };
+        stream.write(color, 4);
+    }
+    stream.write(pixels->data(), pixels->size());
+    return stream.detachAsData();
+}
+
+// Runs of 4 to 67 pixels, which is typical of RLE encoded artwork. RLE4 runs alternate between
+// runs of a single index and runs of two alternating indices.
+static sk_sp<SkData> make_rle_pixels(int bitsPerPixel) {
+    SkDynamicMemoryWStream stream;
+    uint32_t seed = 1;
+    for (int y = 0; y < kSize; y++) {
+        for (int x = 0; x < kSize;) {
+            seed = seed * 1103515245 + 12345;
+            int run = SkTMin<int>(4 + ((seed >> 16) & 63), kSize - x);
+            uint8_t index = (seed >> 24) & (4 == bitsPerPixel ? 0xF : 0xFF);
+            if (4 == bitsPerPixel) {
+                uint8_t other = (seed & 0x10000) ? (index ^ 1) : index;
+                index = (index << 4) | other;
+            }
+            uint8_t code[2] = { (uint8_t) run, index };
+            stream.write(code, 2);
+            x += run;
+        }
+        const uint8_t eol[2] = { 0, 0 };
+        stream.write(eol, 2);
+    }
+    const uint8_t eof[2] = { 0, 1 };
+    stream.write(eof, 2);
+    return stream.detachAsData();
+}
+
+static sk_sp<SkData> make_mask_pixels(int bitsPerPixel) {
+    SkDynamicMemoryWStream stream;
+    for (int y = 0; y < kSize; y++) {
+        for (int x = 0; x < kSize; x++) {
+            if (16 == bitsPerPixel) {
+                stream.write16((x & 0x1F) << 11 | (y & 0x3F) << 5 | ((x + y) & 0x1F));
+            } else {
+                stream.write32((x & 0xFF) << 24 | (y & 0xFF) << 16 | ((x + y) & 0xFF) << 8 |
+                               ((x ^ y) & 0xFF));
+            }
+        }
+    }
+    return stream.detachAsData();
+}
+
+static Benchmark* make_bench(const char* name, sk_sp<SkData> encoded, SkAlphaType alphaType) {
+    return new CodecBench(SkString(name), encoded.get(), kN32_SkColorType, alphaType);
+}
+
+DEF_BENCH(return make_bench("bmp_rle8", make_bmp(8, kRLE8_Compression, 40, nullptr, 256,
+                                                 make_rle_pixels(8).get()),
+                            kPremul_SkAlphaType);)
+DEF_BENCH(return make_bench("bmp_rle4", make_bmp(4, kRLE4_Compression, 40, nullptr, 16,
+                                                 make_rle_pixels(4).get()),
+                            kPremul_SkAlphaType);)
+
+static const uint32_t k565Masks[4] = { 0xF800, 0x07E0, 0x001F, 0 };
+DEF_BENCH(return make_bench("bmp_565", make_bmp(16, kBitMasks_Compression, 40, k565Masks, 0,
+                                                make_mask_pixels(16).get()),
+                            kPremul_SkAlphaType);)
+
+static const uint32_t k8888Masks[4] = { 0x0000FF00, 0x00FF0000, 0xFF000000, 0x000000FF };
+DEF_BENCH(return make_bench("bmp_bitfields", make_bmp(32, kBitMasks_Compression, 108,
+                                                      k8888Masks, 0,
+                                                      make_mask_pixels(32).get()),
+                            kPremul_SkAlphaType);)
+DEF_BENCH(return make_bench("bmp_bitfields", make_bmp(32, kBitMasks_Compression, 108,
+                                                      k8888Masks, 0,
+                                                      make_mask_pixels(32).get()),
+                            kUnpremul_SkAlphaType);)
@@ -15,22 +15,30 @@
 enum ChecksumType {
     kMD5_ChecksumType,
     kHash_ChecksumType,
+    kHasher_ChecksumType,
 };
 
 class ComputeChecksumBench : public Benchmark {
-    enum {
-        U32COUNT  = 256,
-        SIZE      = U32COUNT * 4,
-    };
-    uint32_t    fData[U32COUNT];
+    SkAutoTMalloc<uint32_t> fData;
+    size_t       fBytes;
     ChecksumType fType;
+    SkString     fName;
 
 public:
-    ComputeChecksumBench(ChecksumType type) : fType(type) {
+    ComputeChecksumBench(ChecksumType type, size_t bytes = 1024)
+        : fData(bytes / 4), fBytes(bytes), fType(type) {
         SkRandom rand;
-        for (int i = 0; i < U32COUNT; ++i) {
+        for (size_t i = 0; i < bytes / 4; ++i) {
             fData[i] = rand.nextU();
         }
+        switch (fType) {
+            case kMD5_ChecksumType:    fName.set("compute_md5");    break;
+            case kHash_ChecksumType:   fName.set("compute_hash");   break;
+            case kHasher_ChecksumType: fName.set("compute_hasher"); break;
+        }
+        if (bytes != 1024) {
+            fName.appendf("_%zu", bytes);
+        }
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -39,12 +47,7 @@ public:
 
 protected:
     const char* onGetName() override {
-        switch (fType) {
-            case kMD5_ChecksumType: return "compute_md5";
-            case kHash_ChecksumType: return "compute_hash";
-
-            default: SK_ABORT("Invalid Type"); return "";
-        }
+        return fName.c_str();
     }
 
     void onDraw(int loops, SkCanvas*) override {
@@ -52,14 +55,25 @@ protected:
             case kMD5_ChecksumType: {
                 for (int i = 0; i < loops; i++) {
                     SkMD5 md5;
-                    md5.write(fData, sizeof(fData));
+                    md5.write(fData.get(), fBytes);
                     SkMD5::Digest digest;
                     md5.finish(digest);
                 }
             } break;
             case kHash_ChecksumType: {
                 for (int i = 0; i < loops; i++) {
-                    volatile uint32_t result = SkOpts::hash(fData, sizeof(fData));
+                    volatile uint32_t result = SkOpts::hash(fData.get(), fBytes);
+                    sk_ignore_unused_variable(result);
+                }
+            }break;
+            case kHasher_ChecksumType: {
+                // As a key would be streamed, in small pieces.
+                for (int i = 0; i < loops; i++) {
+                    SkChecksum::Hasher hasher;
+                    for (size_t j = 0; j < fBytes / 4; j += 25) {
+                        hasher.write(fData.get() + j, 4 * SkTMin<size_t>(25, fBytes / 4 - j));
+                    }
+                    volatile uint32_t result = hasher.finish();
                     sk_ignore_unused_variable(result);
                 }
             }break;
@@ -75,3 +89,7 @@ private:
 
 DEF_BENCH( return new ComputeChecksumBench(kMD5_ChecksumType); )
 DEF_BENCH( return new ComputeChecksumBench(kHash_ChecksumType); )
+DEF_BENCH( return new ComputeChecksumBench(kHash_ChecksumType, 16); )
+DEF_BENCH( return new ComputeChecksumBench(kHash_ChecksumType, 256); )
+DEF_BENCH( return new ComputeChecksumBench(kHash_ChecksumType, 64 * 1024); )
+DEF_BENCH( return new ComputeChecksumBench(kHasher_ChecksumType, 64 * 1024); )
@@ -70,6 +70,61 @@ DEF_BENCH(return new ClipMaskBench("picture", [](int size) -> sk_sp<SkImage> {
 #include "SkSurface.h"
 #include "SkPath.h"
 
+// Draws several complex AA paths per frame, each mostly clipped out, under the same clips every
+// frame. On the GPU these are left to the software path renderer, which rasterizes their masks
+// (in parallel, with an executor) and, with fCacheClippedSoftwarePathMasks, reuses them.
+class ClippedSoftwarePathsBench : public Benchmark {
+public:
+    ClippedSoftwarePathsBench() {
+        for (int i = 0; i < kNumPaths; ++i) {
+            SkPath& path = fPaths[i];
+            // A self-intersecting star with many points, too complex for the GPU path renderers.
+            static constexpr int kNumPoints = 2000;
+            for (int j = 0; j < kNumPoints; ++j) {
+                SkScalar angle = j * 2 * SK_ScalarPI * (7 + i) / kNumPoints;
+                SkScalar radius = (j & 1) ? kSize * 0.3f : kSize * 0.45f;
+                SkPoint pt = {kSize / 2 + radius * SkScalarCos(angle),
+                              kSize / 2 + radius * SkScalarSin(angle)};
+                if (0 == j) {
+                    path.moveTo(pt);
+                } else {
+                    path.lineTo(pt);
+                }
+            }
+            path.close();
+        }
+    }
+
+protected:
+    const char* onGetName() override { return "clipmask_clipped_sw_paths"; }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(SK_ColorBLUE);
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < kNumPaths; ++j) {
+                // Show a quarter of each path, so its mask can't be cached whole.
+                canvas->save();
+                canvas->translate(SkIntToScalar(j % 4 * kSize), SkIntToScalar(j / 4 * kSize));
+                canvas->clipRect(SkRect::MakeWH(kSize / 2, kSize / 2));
+                canvas->drawPath(fPaths[j], paint);
+                canvas->restore();
+            }
+            canvas->flush();
+        }
+    }
+
+private:
+    static constexpr int kNumPaths = 8;
+    static constexpr int kSize = 256;
+
+    SkPath fPaths[kNumPaths];
+};
+DEF_BENCH(return new ClippedSoftwarePathsBench;)
+
+/////////
+
 class RasterTileBench : public Benchmark {
     sk_sp<SkSurface> fSurf;
     SkPath           fPath;
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkClipStack.h"
+#include "SkRRect.h"
+
+/**
+ * Clips the way a deep view hierarchy does: every level saves, clips to its own bounds (often
+ * the same as, or larger than, its parent's), and asks about the clip before drawing.
+ */
+class ClipStackBench : public Benchmark {
+public:
+    ClipStackBench(int depth, bool shrink) : fDepth(depth), fShrink(shrink) {
+        fName.printf("clip_stack_nested_%d%s", depth, shrink ? "_shrink" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkRRect root = SkRRect::MakeRectXY(SkRect::MakeWH(1000, 1000), 8, 8);
+        const SkRect query = SkRect::MakeLTRB(200, 200, 300, 300);
+        SkRRect rrect;
+        bool aa;
+        int found = 0;
+        for (int loop = 0; loop < loops; ++loop) {
+            SkClipStack stack;
+            stack.clipRRect(root, SkMatrix::I(), kIntersect_SkClipOp, true);
+            for (int i = 0; i < fDepth; ++i) {
+                stack.save();
+                SkScalar inset = fShrink ? SkIntToScalar(i + 10) : 0;
+                stack.clipRect(SkRect::MakeLTRB(inset, inset, 1000 - inset, 1000 - inset),
+                               SkMatrix::I(), kIntersect_SkClipOp, true);
+                found += stack.isRRect(query, &rrect, &aa);
+                found += stack.isWideOpen();
+            }
+        }
+        fFound = found;
+    }
+
+private:
+    SkString fName;
+    int fDepth;
+    bool fShrink;
+    int fFound;
+};
+
+DEF_BENCH( return new ClipStackBench(8, false); )
+DEF_BENCH( return new ClipStackBench(32, false); )
+DEF_BENCH( return new ClipStackBench(8, true); )
+DEF_BENCH( return new ClipStackBench(32, true); )
@@ -10,10 +10,12 @@
 #include "SkBitmap.h"
 #include "SkCodec.h"
 #include "SkCommandLineFlags.h"
+#include "SkExecutor.h"
 #include "SkOSFile.h"
 
 // Actually zeroing the memory would throw off timing, so we just lie.
 DEFINE_bool(zero_init, false, "Pretend our destination is zero-intialized, simulating Android?");
+DEFINE_int32(codec_threads, 0, "If > 0, codecs that support it decode on this many threads.");
 
 CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType,
         SkAlphaType alphaType)
@@ -52,6 +54,9 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
     if (FLAGS_zero_init) {
         options.fZeroInitialized = SkCodec::kYes_ZeroInitialized;
     }
+    static std::unique_ptr<SkExecutor> gExecutor = FLAGS_codec_threads > 0
+            ? SkExecutor::MakeFIFOThreadPool(FLAGS_codec_threads) : nullptr;
+    options.fExecutor = gExecutor.get();
     for (int i = 0; i < n; i++) {
         codec = SkCodec::MakeFromData(fData);
 #ifdef SK_DEBUG
@@ -9,6 +9,9 @@
 #include "SkCanvas.h"
 #include "SkColorFilterImageFilter.h"
 #include "SkColorMatrixFilter.h"
+#include "SkImage.h"
+#include "SkSurface.h"
+#include "SkTableColorFilter.h"
 
 #define FILTER_WIDTH_SMALL  SkIntToScalar(32)
 #define FILTER_HEIGHT_SMALL SkIntToScalar(32)
@@ -260,6 +263,64 @@ private:
     typedef ColorFilterBaseBench INHERITED;
 };
 
+// Draws a 256x256 image through a matrix or table color filter set on the paint, which
+// runs the filter per pixel in the raster pipeline.
+class ColorFilterImageBench : public Benchmark {
+public:
+    enum Filter { kGray_Filter, kTable_Filter };
+
+    ColorFilterImageBench(Filter filter, bool opaque) : fFilter(filter), fOpaque(opaque) {
+        fName.printf("colorfilter_image_%s_%s", filter == kGray_Filter ? "gray" : "table",
+                     opaque ? "opaque" : "alpha");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        auto surface = SkSurface::MakeRasterN32Premul(256, 256);
+        for (int y = 0; y < 256; y++) {
+            SkPaint paint;
+            paint.setColor(SkColorSetARGB(fOpaque ? 0xFF : y, y, 255 - y, 0x80));
+            surface->getCanvas()->drawRect(SkRect::MakeXYWH(0, y, 256, 1), paint);
+        }
+        fImage = surface->makeImageSnapshot();
+
+        if (fFilter == kGray_Filter) {
+            SkScalar matrix[20];
+            memset(matrix, 0, 20 * sizeof(SkScalar));
+            matrix[0] = matrix[5] = matrix[10] = 0.2126f;
+            matrix[1] = matrix[6] = matrix[11] = 0.7152f;
+            matrix[2] = matrix[7] = matrix[12] = 0.0722f;
+            matrix[18] = 1.0f;
+            fColorFilter = SkColorFilter::MakeMatrixFilterRowMajor255(matrix);
+        } else {
+            uint8_t table[256];
+            for (int i = 0; i < 256; i++) {
+                table[i] = 255 - i;
+            }
+            fColorFilter = SkTableColorFilter::MakeARGB(nullptr, table, table, table);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setColorFilter(fColorFilter);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawImage(fImage, 0, 0, &paint);
+        }
+    }
+
+private:
+    SkString             fName;
+    Filter               fFilter;
+    bool                 fOpaque;
+    sk_sp<SkImage>       fImage;
+    sk_sp<SkColorFilter> fColorFilter;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ColorFilterDimBrightBench(true); )
@@ -279,3 +340,8 @@ DEF_BENCH( return new ColorFilterBrightBlueBench(false); )
 DEF_BENCH( return new ColorFilterBrightBench(false); )
 DEF_BENCH( return new ColorFilterBlueBench(false); )
 DEF_BENCH( return new ColorFilterGrayBench(false); )
+
+DEF_BENCH( return new ColorFilterImageBench(ColorFilterImageBench::kGray_Filter,  true); )
+DEF_BENCH( return new ColorFilterImageBench(ColorFilterImageBench::kGray_Filter,  false); )
+DEF_BENCH( return new ColorFilterImageBench(ColorFilterImageBench::kTable_Filter, true); )
+DEF_BENCH( return new ColorFilterImageBench(ColorFilterImageBench::kTable_Filter, false); )
@@ -13,7 +13,9 @@
 #include "SkDraw.h"
 #include "SkMatrix.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "SkRasterClip.h"
+#include "SkScan.h"
 
 class DrawPathBench : public Benchmark {
     SkPaint     fPaint;
@@ -71,5 +73,117 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Draws the same path with either the delta (DAA) or the analytic (AAA) scan converter so the two
+// can be compared path by path.  The "tiles" and "glyphs" paths are made of many small edges, like
+// map tiles and CJK glyph outlines; that's where DAA's delta accumulation dominates.
+class DrawPathAABench : public Benchmark {
+public:
+    enum class PathType { kQuad, kTiles, kGlyphs };
+
+    DrawPathAABench(PathType type, bool useDeltaAA) : fUseDeltaAA(useDeltaAA) {
+        fPaint.setAntiAlias(true);
+
+        int size = 500;
+        switch (type) {
+            case PathType::kQuad:
+                fName = "quad";
+                fPath.moveTo(0, 0);
+                fPath.quadTo(500, 0, 500, 500);
+                fPath.quadTo(250, 0, 0, 500);
+                break;
+            case PathType::kTiles: {
+                // Lots of small, jagged polygons, like the roads and blocks on a map tile.
+                fName = "tiles";
+                SkRandom rand;
+                for (int i = 0; i < 200; ++i) {
+                    SkScalar cx = rand.nextRangeScalar(20, 480),
+                             cy = rand.nextRangeScalar(20, 480);
+                    fPath.moveTo(cx + rand.nextRangeScalar(-20, 20),
+                                 cy + rand.nextRangeScalar(-20, 20));
+                    for (int j = 0; j < 16; ++j) {
+                        fPath.lineTo(cx + rand.nextRangeScalar(-20, 20),
+                                     cy + rand.nextRangeScalar(-20, 20));
+                    }
+                    fPath.close();
+                }
+                break;
+            }
+            case PathType::kGlyphs: {
+                // A small glyph-sized path with many short strokes, like a CJK outline.
+                fName = "glyphs";
+                size = 24;
+                SkRandom rand;
+                for (int i = 0; i < 12; ++i) {
+                    SkScalar x = rand.nextRangeScalar(1, 20),
+                             y = rand.nextRangeScalar(1, 20);
+                    fPath.moveTo(x, y);
+                    for (int j = 0; j < 6; ++j) {
+                        x = SkTPin(x + rand.nextRangeScalar(-6, 6), 0.0f, 23.0f);
+                        y = SkTPin(y + rand.nextRangeScalar(-6, 6), 0.0f, 23.0f);
+                        fPath.lineTo(x, y);
+                    }
+                    fPath.close();
+                }
+                break;
+            }
+        }
+        fName.prepend("draw_path_aa_");
+        fName.append(useDeltaAA ? "_daa" : "_aaa");
+
+        fPixmap.alloc(SkImageInfo::MakeA8(size, size));
+        fPixmap.erase(0);
+
+        fIdentity.setIdentity();
+        fRC.setRect(SkIRect::MakeWH(size, size));
+
+        fDraw.fDst      = fPixmap;
+        fDraw.fMatrix   = &fIdentity;
+        fDraw.fRC       = &fRC;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        bool useDeltaAA    = gSkUseDeltaAA,
+             forceDeltaAA  = gSkForceDeltaAA,
+             forceAnalytic = gSkForceAnalyticAA;
+        gSkUseDeltaAA      = fUseDeltaAA;
+        gSkForceDeltaAA    = fUseDeltaAA;
+        gSkForceAnalyticAA = !fUseDeltaAA;
+
+        for (int i = 0; i < loops; ++i) {
+            fDraw.drawPath(fPath, fPaint);
+        }
+
+        gSkUseDeltaAA      = useDeltaAA;
+        gSkForceDeltaAA    = forceDeltaAA;
+        gSkForceAnalyticAA = forceAnalytic;
+    }
+
+private:
+    SkPaint             fPaint;
+    SkString            fName;
+    SkPath              fPath;
+    SkRasterClip        fRC;
+    SkAutoPixmapStorage fPixmap;
+    SkMatrix            fIdentity;
+    SkDraw              fDraw;
+    bool                fUseDeltaAA;
+
+    typedef Benchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 DEF_BENCH( return new DrawPathBench(false) )
 DEF_BENCH( return new DrawPathBench(true) )
+
+DEF_BENCH( return new DrawPathAABench(DrawPathAABench::PathType::kQuad,   true ) )
+DEF_BENCH( return new DrawPathAABench(DrawPathAABench::PathType::kQuad,   false) )
+DEF_BENCH( return new DrawPathAABench(DrawPathAABench::PathType::kTiles,  true ) )
+DEF_BENCH( return new DrawPathAABench(DrawPathAABench::PathType::kTiles,  false) )
+DEF_BENCH( return new DrawPathAABench(DrawPathAABench::PathType::kGlyphs, true ) )
+DEF_BENCH( return new DrawPathAABench(DrawPathAABench::PathType::kGlyphs, false) )
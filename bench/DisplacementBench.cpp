@@ -8,7 +8,11 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkDisplacementMapEffect.h"
+#include "SkExecutor.h"
+#include "SkGradientShader.h"
 #include "SkImageSource.h"
+#include "SkSpecialImage.h"
+#include "SkString.h"
 #include "SkSurface.h"
 
 #define FILTER_WIDTH_SMALL  32
@@ -175,3 +179,64 @@ DEF_BENCH( return new DisplacementFullBench(true); )
 DEF_BENCH( return new DisplacementZeroBench(false); )
 DEF_BENCH( return new DisplacementAlphaBench(false); )
 DEF_BENCH( return new DisplacementFullBench(false); )
+
+// Displaces a large raster image by a gradient directly, on a thread pool if threaded, to measure
+// the raster displacement loop itself.
+class DisplacementBandsBench : public Benchmark {
+public:
+    DisplacementBandsBench(bool threaded)
+        : fThreaded(threaded)
+        , fName(SkStringPrintf("displacement_bands%s", threaded ? "_threaded" : "")) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        SkCanvas canvas(bitmap);
+        const SkPoint pts[] = { { 0, 0 }, { kSize, kSize } };
+        const SkColor colors[] = { 0xFF000000, 0xFFFF00FF, 0x80808080, 0xFF00FF00 };
+        SkPaint paint;
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 4,
+                                                     SkShader::kMirror_TileMode));
+        canvas.drawPaint(paint);
+        fImage = SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kSize, kSize), bitmap);
+        fFilter = SkDisplacementMapEffect::Make(SkDisplacementMapEffect::kR_ChannelSelectorType,
+                                                SkDisplacementMapEffect::kA_ChannelSelectorType,
+                                                32, nullptr, nullptr);
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkImageFilter::OutputProperties noColorSpace(nullptr);
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                   noColorSpace, fExecutor.get());
+        for (int i = 0; i < loops; i++) {
+            SkIPoint offset;
+            fFilter->filterImage(fImage.get(), ctx, &offset);
+        }
+    }
+
+private:
+    static constexpr int kSize = 1024;
+
+    bool                        fThreaded;
+    SkString                    fName;
+    sk_sp<SkSpecialImage>       fImage;
+    sk_sp<SkImageFilter>        fFilter;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new DisplacementBandsBench(false); )
+DEF_BENCH( return new DisplacementBandsBench(true); )
@@ -12,14 +12,22 @@
 
 /**
  * Draws full screen opaque rectangles. It is designed to test any optimizations in the GPU backend
- * to turn such draws into clears.
+ * to turn such draws into clears. The bigger sizes don't fit in cache, and exercise the
+ * non-temporal fills in the raster backend.
  */
 class FSRectBench : public Benchmark {
 public:
-    FSRectBench() : fInit(false) { }
+    FSRectBench(int w = 640, int h = 480) : fW(w), fH(h), fInit(false) {
+        fName = "fullscreen_rects";
+        if (w != 640 || h != 480) {
+            fName.appendf("_%dx%d", w, h);
+        }
+    }
 
 protected:
-    const char* onGetName() override { return "fullscreen_rects"; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    SkIPoint onGetSize() override { return SkIPoint::Make(fW, fH); }
 
     void onDelayedSetup() override {
         if (!fInit) {
@@ -30,8 +38,8 @@ protected:
             for (int i = 0; i < N; ++i) {
                 fRects[i].fLeft = -kMinOffset - rand.nextUScalar1() * kOffsetRange;
                 fRects[i].fTop = -kMinOffset - rand.nextUScalar1() * kOffsetRange;
-                fRects[i].fRight = W + kMinOffset + rand.nextUScalar1() * kOffsetRange;
-                fRects[i].fBottom = H + kMinOffset + rand.nextUScalar1() * kOffsetRange;
+                fRects[i].fRight = fW + kMinOffset + rand.nextUScalar1() * kOffsetRange;
+                fRects[i].fBottom = fH + kMinOffset + rand.nextUScalar1() * kOffsetRange;
                 fColors[i] = rand.nextU() | 0xFF000000;
             }
             fInit = true;
@@ -48,10 +56,10 @@ protected:
 
 private:
     enum {
-        W = 640,
-        H = 480,
         N = 300,
     };
+    SkString fName;
+    int     fW, fH;
     SkRect  fRects[N];
     SkColor fColors[N];
     bool fInit;
@@ -60,3 +68,5 @@ private:
 };
 
 DEF_BENCH(return new FSRectBench();)
+DEF_BENCH(return new FSRectBench(2048, 2048);)
+DEF_BENCH(return new FSRectBench(3840, 2160);)
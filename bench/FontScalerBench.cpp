@@ -11,6 +11,8 @@
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
+#include "SkSurface.h"
+#include "SkTaskGroup.h"
 
 class FontScalerBench : public Benchmark {
     SkString fName;
@@ -46,7 +48,60 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Creates scaler contexts for the same typeface on several threads at once, each thread drawing
+// its own sizes to its own surface.
+class FontScalerMTBench : public Benchmark {
+    SkString fName;
+    SkString fText;
+    bool     fDoLCD;
+public:
+    FontScalerMTBench(bool doLCD)  {
+        fName.printf("fontscaler_%s_mt", doLCD ? "lcd" : "aa");
+        fText.set("abcdefghijklmnopqrstuvwxyz01234567890");
+        fDoLCD = doLCD;
+    }
+
+protected:
+    static constexpr int kThreads = 4;
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        for (auto& surface : fSurfaces) {
+            surface = SkSurface::MakeRasterN32Premul(640, 40);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkGraphics::PurgeFontCache();
+
+            SkTaskGroup().batch(kThreads, [&](int thread) {
+                SkCanvas* canvas = fSurfaces[thread]->getCanvas();
+                SkPaint paint;
+                paint.setAntiAlias(true);
+                paint.setLCDRenderText(fDoLCD);
+                for (int ps = 9 + thread; ps <= 24 + thread; ps += 2) {
+                    paint.setTextSize(SkIntToScalar(ps));
+                    canvas->drawString(fText, 0, SkIntToScalar(30), paint);
+                }
+            });
+        }
+    }
+
+private:
+    sk_sp<SkSurface> fSurfaces[kThreads];
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH(return new FontScalerBench(false);)
 DEF_BENCH(return new FontScalerBench(true);)
+DEF_BENCH(return new FontScalerMTBench(false);)
+DEF_BENCH(return new FontScalerMTBench(true);)
@@ -11,11 +11,15 @@
 #if SK_SUPPORT_GPU
 
 #include "Benchmark.h"
+#include "GrConcurrentMemoryPool.h"
 #include "GrMemoryPool.h"
 #include "SkRandom.h"
 #include "SkTDArray.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 
+#include <atomic>
+
 // change this to 0 to compare GrMemoryPool to default new / delete
 #define OVERRIDE_NEW    1
 
@@ -171,10 +175,71 @@ private:
     typedef Benchmark INHERITED;
 };
 
+struct D {
+    int gStuff[10];
+#if OVERRIDE_NEW
+    void* operator new (size_t size) { return gBenchPool.allocate(size); }
+    void operator delete (void* mem) { if (mem) { return gBenchPool.release(mem); } }
+#endif
+    static GrConcurrentMemoryPool gBenchPool;
+};
+GrConcurrentMemoryPool D::gBenchPool(10 * (1 << 10), 10 * (1 << 10));
+
+/**
+ * This benchmark creates objects on several threads at once. Each thread keeps a ring of its
+ * objects, deleting the object it replaces, and steals objects from its neighbor's ring to delete
+ * them on a thread other than the one that created them.
+ */
+class GrMemoryPoolBenchThreads : public Benchmark {
+    enum {
+        kThreads = 4,
+        kRingSize = 1 << 10,
+    };
+public:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return "grmemorypool_threads";
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        std::atomic<D*> rings[kThreads][kRingSize];
+        for (auto& ring : rings) {
+            for (auto& slot : ring) {
+                slot.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        SkTaskGroup().batch(kThreads, [&](int t) {
+            std::atomic<D*>* ring = rings[t];
+            std::atomic<D*>* neighbor = rings[(t + 1) % kThreads];
+            for (int i = 0; i < loops; i++) {
+                delete ring[i % kRingSize].exchange(new D);
+                if (i & 1) {
+                    delete neighbor[(7 * i) % kRingSize].exchange(nullptr);
+                }
+            }
+        });
+
+        for (auto& ring : rings) {
+            for (auto& slot : ring) {
+                delete slot.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new GrMemoryPoolBenchStack(); )
 DEF_BENCH( return new GrMemoryPoolBenchRandom(); )
 DEF_BENCH( return new GrMemoryPoolBenchQueue(); )
+DEF_BENCH( return new GrMemoryPoolBenchThreads(); )
 
 #endif
@@ -68,6 +68,79 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Dirties the mips of several surfaces and then draws all of them reduced in one flush. Run with
+// --batchMips to regenerate their mips together before the flush's draws execute; --gpuStats
+// reports how many textures were regenerated each way.
+class GrMipMapBatchBench: public Benchmark {
+    SkTArray<sk_sp<SkSurface>> fSurfaces;
+    SkString fName;
+    const int fCount, fSize;
+
+public:
+    GrMipMapBatchBench(int count, int size) : fCount(count), fSize(size) {
+        fName.printf("gr_mipmap_build_batch_%dx%d", count, size);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kGPU_Backend == backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        if (fSurfaces.empty()) {
+            GrContext* context = canvas->getGrContext();
+            if (nullptr == context) {
+                return;
+            }
+            SkImageInfo info = SkImageInfo::MakeN32Premul(fSize, fSize);
+            for (int i = 0; i < fCount; ++i) {
+                auto surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info, 0,
+                                                           kBottomLeft_GrSurfaceOrigin, nullptr,
+                                                           true);
+                if (!surface) {
+                    fSurfaces.reset();
+                    return;
+                }
+                surface->getCanvas()->clear(SK_ColorBLACK);
+                fSurfaces.push_back(std::move(surface));
+            }
+        }
+
+        SkPaint paint;
+        paint.setFilterQuality(kMedium_SkFilterQuality);
+        paint.setColor(SK_ColorWHITE);
+        for (int i = 0; i < loops; i++) {
+            SkTArray<sk_sp<SkImage>> images;
+            for (const sk_sp<SkSurface>& surface : fSurfaces) {
+                // Touch surface so mips are dirtied
+                surface->getCanvas()->drawPoint(0, 0, paint);
+                images.push_back(surface->makeImageSnapshot());
+            }
+            // Flush the touched surfaces so that their mips are dirty when the canvas flushes.
+            for (const sk_sp<SkSurface>& surface : fSurfaces) {
+                surface->getCanvas()->flush();
+            }
+            canvas->save();
+            canvas->scale(0.1f, 0.1f);
+            for (int j = 0; j < images.count(); ++j) {
+                canvas->drawImage(images[j], SkIntToScalar((j % 8) * fSize),
+                                  SkIntToScalar((j / 8) * fSize), &paint);
+            }
+            canvas->restore();
+            canvas->flush();
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        fSurfaces.reset();
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 // Build variants that exercise the width and heights being even or odd at each level, as the
 // impl specializes on each of these.
 //
@@ -76,4 +149,7 @@ DEF_BENCH( return new GrMipMapBench(512, 511); )
 DEF_BENCH( return new GrMipMapBench(511, 512); )
 DEF_BENCH( return new GrMipMapBench(512, 512); )
 
+DEF_BENCH( return new GrMipMapBatchBench(16, 256); )
+DEF_BENCH( return new GrMipMapBatchBench(64, 128); )
+
 #endif
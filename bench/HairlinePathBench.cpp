@@ -110,6 +110,29 @@ private:
     typedef HairlinePathBench INHERITED;
 };
 
+// A chart: a few long polylines of short segments.
+class PolylinePathBench : public HairlinePathBench {
+public:
+    PolylinePathBench(Flags flags) : INHERITED(flags) {}
+
+    void appendName(SkString* name) override {
+        name->append("polyline");
+    }
+    void makePath(SkPath* path) override {
+        SkRandom rand;
+        for (int i = 0; i < 4; ++i) {
+            SkScalar y = SkIntToScalar(10 + 20 * i);
+            path->moveTo(0, y);
+            for (int x = 2; x <= 200; x += 2) {
+                y += rand.nextRangeScalar(-2, 2);
+                path->lineTo(SkIntToScalar(x), y);
+            }
+        }
+    }
+private:
+    typedef HairlinePathBench INHERITED;
+};
+
 class QuadPathBench : public HairlinePathBench {
 public:
     QuadPathBench(Flags flags) : INHERITED(flags) {}
@@ -223,6 +246,11 @@ DEF_BENCH( return new LinePathBench(FLAGS01); )
 DEF_BENCH( return new LinePathBench(FLAGS10); )
 DEF_BENCH( return new LinePathBench(FLAGS11); )
 
+DEF_BENCH( return new PolylinePathBench(FLAGS00); )
+DEF_BENCH( return new PolylinePathBench(FLAGS01); )
+DEF_BENCH( return new PolylinePathBench(FLAGS10); )
+DEF_BENCH( return new PolylinePathBench(FLAGS11); )
+
 DEF_BENCH( return new QuadPathBench(FLAGS00); )
 DEF_BENCH( return new QuadPathBench(FLAGS01); )
 DEF_BENCH( return new QuadPathBench(FLAGS10); )
@@ -30,11 +30,14 @@ static const char* get_tilemode_name(SkShader::TileMode tilemode) {
 
 class HardStopGradientBench_ScaleNumColors : public Benchmark {
 public:
-    HardStopGradientBench_ScaleNumColors(SkShader::TileMode tilemode, int count) {
-        fName.printf("hardstop_scale_num_colors_%s_%03d_colors", get_tilemode_name(tilemode), count);
+    HardStopGradientBench_ScaleNumColors(SkShader::TileMode tilemode, int count,
+                                         bool radial = false) {
+        fName.printf("hardstop_scale_num_colors_%s%s_%03d_colors", radial ? "radial_" : "",
+                     get_tilemode_name(tilemode), count);
 
         fTileMode   = tilemode;
         fColorCount = count;
+        fRadial     = radial;
     }
 
     const char* onGetName() override {
@@ -51,6 +54,8 @@ public:
      * different colors. The positions are evenly spaced,
      * with the exception of the first two; these create a
      * hard stop in order to trigger the hard stop code.
+     * Radial gradients always draw with raster pipeline stages,
+     * so they measure its search of the stops.
      */
     void onPreDraw(SkCanvas* canvas) override {
         // Left to right
@@ -82,6 +87,17 @@ public:
             positions[i] = i / (fColorCount - 1.0f);
         }
 
+        if (fRadial) {
+            fPaint.setShader(SkGradientShader::MakeRadial(SkPoint::Make(kSize/2, kSize/2),
+                                                          kSize/2,
+                                                          colors,
+                                                          positions,
+                                                          fColorCount,
+                                                          fTileMode,
+                                                          0,
+                                                          nullptr));
+            return;
+        }
         fPaint.setShader(SkGradientShader::MakeLinear(points,
                                                       colors,
                                                       positions,
@@ -106,6 +122,7 @@ private:
     SkShader::TileMode  fTileMode;
     SkString            fName;
     int                 fColorCount;
+    bool                fRadial;
     SkPaint             fPaint;
 
     typedef Benchmark INHERITED;
@@ -137,3 +154,10 @@ DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kMirror_Tile
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kMirror_TileMode,  25);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kMirror_TileMode,  50);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kMirror_TileMode, 100);)
+
+// Radial
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,   5, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  10, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  25, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode,  50, true);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkShader::kClamp_TileMode, 100, true);)
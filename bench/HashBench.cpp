@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkGlyph.h"
+#include "SkRandom.h"
+#include "SkTFlatHash.h"
+#include "SkTHash.h"
+
+#include <vector>
+
+// Looks up glyphs the way SkGlyphCache does, in a table of the given type, for text that mostly
+// hits (the common case) or mostly misses (filling a new strike).
+template <typename Table>
+class GlyphHashBench : public Benchmark {
+public:
+    GlyphHashBench(const char* name, int glyphCount, bool hits)
+        : fGlyphCount(glyphCount), fHits(hits) {
+        fName.printf("glyph_hash_%s_%d_%s", name, glyphCount, hits ? "hits" : "misses");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    // Lookups don't change the table, so this shows scaling with no contention at all.
+    bool isThreadSafe() const override { return true; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom random;
+        for (int i = 0; i < fGlyphCount; i++) {
+            SkGlyph glyph;
+            // Sub-pixel positioned glyphs, as with most text.
+            glyph.initWithGlyphID(SkPackedGlyphID(SkToU16(i), random.nextULessThan(4) << 14,
+                                                  random.nextULessThan(4) << 14));
+            fTable.set(glyph);
+            fIDs.push_back(glyph.getPackedID());
+        }
+        if (!fHits) {
+            for (SkPackedGlyphID& id : fIDs) {
+                id = SkPackedGlyphID(SkToU16(id.code() + fGlyphCount));
+            }
+        }
+        // Text repeats glyphs, in no particular order.
+        std::vector<SkPackedGlyphID> text;
+        for (int i = 0; i < kTextLength; i++) {
+            text.push_back(fIDs[random.nextULessThan(fGlyphCount)]);
+        }
+        fIDs = std::move(text);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        int found = 0;
+        for (int i = 0; i < loops; i++) {
+            for (const SkPackedGlyphID& id : fIDs) {
+                found += fTable.find(id) != nullptr;
+            }
+        }
+        volatile int sink = found;
+        sk_ignore_unused_variable(sink);
+    }
+
+private:
+    static constexpr int kTextLength = 1000;
+
+    SkString                     fName;
+    const int                    fGlyphCount;
+    const bool                   fHits;
+    Table                        fTable;
+    std::vector<SkPackedGlyphID> fIDs;
+
+    typedef Benchmark INHERITED;
+};
+
+using LinearTable = SkTHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits>;
+using FlatTable = SkTFlatHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits>;
+
+DEF_BENCH( return new GlyphHashBench<LinearTable>("linear", 100, true); )
+DEF_BENCH( return new GlyphHashBench<FlatTable>("flat", 100, true); )
+DEF_BENCH( return new GlyphHashBench<LinearTable>("linear", 5000, true); )
+DEF_BENCH( return new GlyphHashBench<FlatTable>("flat", 5000, true); )
+DEF_BENCH( return new GlyphHashBench<LinearTable>("linear", 5000, false); )
+DEF_BENCH( return new GlyphHashBench<FlatTable>("flat", 5000, false); )
@@ -7,6 +7,8 @@
 
 #include "Benchmark.h"
 #include "SkResourceCache.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
 
 namespace {
 static void* gGlobalAddress;
@@ -14,8 +16,8 @@ class TestKey : public SkResourceCache::Key {
 public:
     intptr_t fValue;
 
-    TestKey(intptr_t value) : fValue(value) {
-        this->init(&gGlobalAddress, 0, sizeof(fValue));
+    TestKey(intptr_t value, uint64_t sharedID = 0) : fValue(value) {
+        this->init(&gGlobalAddress, sharedID, sizeof(fValue));
     }
 };
 struct TestRec : public SkResourceCache::Rec {
@@ -33,6 +35,12 @@ struct TestRec : public SkResourceCache::Rec {
         return true;
     }
 };
+
+struct ConcurrentTestRec : public TestRec {
+    using TestRec::TestRec;
+
+    bool canBeFoundConcurrently() const override { return true; }
+};
 }
 
 class ImageCacheBench : public Benchmark {
@@ -75,3 +83,59 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+
+/*
+ *  Many threads hitting the global cache at once, with Recs that either let Find() skip the
+ *  cache's lock or don't.
+ */
+class ImageCacheContentionBench : public Benchmark {
+    enum {
+        CACHE_COUNT = 500,
+        THREAD_COUNT = 8,
+    };
+
+public:
+    explicit ImageCacheContentionBench(bool concurrent) : fConcurrent(concurrent) {
+        fName.printf("imagecache_contention_%s", concurrent ? "unlocked" : "locked");
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < CACHE_COUNT; ++i) {
+            TestKey key(i, this->sharedID());
+            SkResourceCache::Add(fConcurrent ? new ConcurrentTestRec(key, i)
+                                             : new TestRec(key, i));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const uint64_t sharedID = this->sharedID();
+        SkTaskGroup().batch(THREAD_COUNT, [&](int thread) {
+            for (int i = 0; i < loops; ++i) {
+                TestKey key((thread * 37 + i) % CACHE_COUNT, sharedID);
+                SkResourceCache::Find(key, TestRec::Visitor, nullptr);
+            }
+        });
+    }
+
+private:
+    uint64_t sharedID() const {
+        return ((uint64_t)SkSetFourByteTag('i', 'c', 'b', 'h') << 32) | fConcurrent;
+    }
+
+    const bool fConcurrent;
+    SkString   fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ImageCacheContentionBench(false); )
+DEF_BENCH( return new ImageCacheContentionBench(true); )
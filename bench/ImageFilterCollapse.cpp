@@ -12,6 +12,7 @@
 #include "SkColorMatrixFilter.h"
 #include "SkGradientShader.h"
 #include "SkImageFilter.h"
+#include "SkMergeImageFilter.h"
 #include "SkTableColorFilter.h"
 
 // Chains several matrix color filters image filter or several
@@ -34,6 +35,11 @@ protected:
         }
     }
 
+    void setImageFilter(sk_sp<SkImageFilter> imageFilter) {
+        SkASSERT(!fImageFilter);
+        fImageFilter = std::move(imageFilter);
+    }
+
     void onDraw(int loops, SkCanvas* canvas) override {
         makeBitmap();
 
@@ -133,5 +139,25 @@ protected:
     }
 };
 
+// Merges several color filtered copies of the bitmap. Each color filter is applied as its copy is
+// merged, rather than in a pass of its own.
+class MergeCollapseBench: public BaseImageFilterCollapseBench {
+protected:
+    const char* onGetName() override {
+        return "image_filter_collapse_merge";
+    }
+
+    void onDelayedSetup() override {
+        sk_sp<SkImageFilter> inputs[] = {
+            SkColorFilterImageFilter::Make(make_brightness(0.1f), nullptr),
+            SkColorFilterImageFilter::Make(make_grayscale(), nullptr),
+            SkColorFilterImageFilter::Make(make_brightness(-0.1f), nullptr),
+        };
+
+        this->setImageFilter(SkMergeImageFilter::Make(inputs, SK_ARRAY_COUNT(inputs)));
+    }
+};
+
 DEF_BENCH(return new TableCollapseBench;)
 DEF_BENCH(return new MatrixCollapseBench;)
+DEF_BENCH(return new MergeCollapseBench;)
@@ -9,6 +9,8 @@
 #include "Resources.h"
 #include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
+#include "SkColorFilterImageFilter.h"
 #include "SkDisplacementMapEffect.h"
 #include "SkImage.h"
 #include "SkMergeImageFilter.h"
@@ -144,7 +146,37 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Exercise an Xfermode filter blending two color filtered blurs. The color filters are applied as
+// the blurs are blended, rather than each in a pass of its own.
+class ImageFilterXfermodeColorFilter : public Benchmark {
+public:
+    ImageFilterXfermodeColorFilter() {}
+
+protected:
+    const char* onGetName() override { return "image_filter_xfermode_colorfilter"; }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int j = 0; j < loops; j++) {
+            auto blur = SkBlurImageFilter::Make(4.0f, 4.0f, nullptr);
+            auto red = SkColorFilterImageFilter::Make(
+                    SkColorFilter::MakeModeFilter(SK_ColorRED, SkBlendMode::kSrcIn), blur);
+            auto gray = SkColorFilterImageFilter::Make(
+                    SkColorFilter::MakeModeFilter(SK_ColorGRAY, SkBlendMode::kModulate), blur);
+            auto xfermode =
+                    SkXfermodeImageFilter::Make(SkBlendMode::kMultiply, red, gray, nullptr);
+
+            SkPaint paint;
+            paint.setImageFilter(xfermode);
+            canvas->drawRect(SkRect::MakeWH(400.0f, 400.0f), paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
+DEF_BENCH(return new ImageFilterXfermodeColorFilter;)
@@ -5,9 +5,14 @@
  * found in the LICENSE file.
  */
 #include "Benchmark.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkLightingImageFilter.h"
 #include "SkPoint3.h"
+#include "SkRandom.h"
+#include "SkSpecialImage.h"
+#include "SkString.h"
 
 #define FILTER_WIDTH_SMALL  SkIntToScalar(32)
 #define FILTER_HEIGHT_SMALL SkIntToScalar(32)
@@ -244,3 +249,76 @@ DEF_BENCH( return new LightingDistantLitSpecularBench(true); )
 DEF_BENCH( return new LightingDistantLitSpecularBench(false); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(true); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(false); )
+
+// Lights a large raster image directly, on a thread pool if threaded, to measure the raster
+// lighting loop itself.
+class LightingBandsBench : public Benchmark {
+public:
+    LightingBandsBench(bool specular, bool threaded)
+        : fSpecular(specular)
+        , fThreaded(threaded)
+        , fName(SkStringPrintf("lightingbands_spot_%s%s", specular ? "specular" : "diffuse",
+                               threaded ? "_threaded" : "")) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkRandom rand;
+        for (int i = 0; i < 64; i++) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas.drawCircle(rand.nextUScalar1() * kSize, rand.nextUScalar1() * kSize, 32, paint);
+        }
+        fImage = SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kSize, kSize), bitmap);
+
+        SkPoint3 location = SkPoint3::Make(-10, -10, 200),
+                 target = SkPoint3::Make(kSize / 2, kSize / 2, 0);
+        fFilter = fSpecular
+                ? SkLightingImageFilter::MakeSpotLitSpecular(location, target, 1, 60,
+                                                             SK_ColorWHITE, 1, 1, 8, nullptr)
+                : SkLightingImageFilter::MakeSpotLitDiffuse(location, target, 1, 60,
+                                                            SK_ColorWHITE, 1, 1, nullptr);
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkImageFilter::OutputProperties noColorSpace(nullptr);
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                   noColorSpace, fExecutor.get());
+        for (int i = 0; i < loops; i++) {
+            SkIPoint offset;
+            fFilter->filterImage(fImage.get(), ctx, &offset);
+        }
+    }
+
+private:
+    static constexpr int kSize = 1024;
+
+    bool                        fSpecular;
+    bool                        fThreaded;
+    SkString                    fName;
+    sk_sp<SkSpecialImage>       fImage;
+    sk_sp<SkImageFilter>        fFilter;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new LightingBandsBench(false, false); )
+DEF_BENCH( return new LightingBandsBench(false, true); )
+DEF_BENCH( return new LightingBandsBench(true, false); )
+DEF_BENCH( return new LightingBandsBench(true, true); )
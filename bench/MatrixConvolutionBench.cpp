@@ -5,10 +5,13 @@
  * found in the LICENSE file.
  */
 #include "Benchmark.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkMatrixConvolutionImageFilter.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
+#include "SkSpecialImage.h"
 #include "SkString.h"
 
 static const char* name(SkMatrixConvolutionImageFilter::TileMode mode) {
@@ -22,19 +25,24 @@ static const char* name(SkMatrixConvolutionImageFilter::TileMode mode) {
 
 class MatrixConvolutionBench : public Benchmark {
 public:
-    MatrixConvolutionBench(SkMatrixConvolutionImageFilter::TileMode tileMode, bool convolveAlpha)
+    MatrixConvolutionBench(SkMatrixConvolutionImageFilter::TileMode tileMode, bool convolveAlpha,
+                           int kernelSize = 3)
         : fName(SkStringPrintf("matrixconvolution_%s%s",
                                name(tileMode),
                                convolveAlpha ? "" : "_noConvolveAlpha")) {
-        SkISize kernelSize = SkISize::Make(3, 3);
-        SkScalar kernel[9] = {
-            SkIntToScalar( 1), SkIntToScalar( 1), SkIntToScalar( 1),
-            SkIntToScalar( 1), SkIntToScalar(-7), SkIntToScalar( 1),
-            SkIntToScalar( 1), SkIntToScalar( 1), SkIntToScalar( 1),
-        };
+        if (kernelSize != 3) {
+            fName.appendf("_%dx%d", kernelSize, kernelSize);
+        }
+        // An edge detector: every tap is 1, except the center, which balances them.
+        SkAutoTArray<SkScalar> kernel(kernelSize * kernelSize);
+        for (int i = 0; i < kernelSize * kernelSize; i++) {
+            kernel[i] = SK_Scalar1;
+        }
+        kernel[kernelSize * kernelSize / 2] = SkIntToScalar(2 - kernelSize * kernelSize);
         SkScalar gain = 0.3f, bias = SkIntToScalar(100);
-        SkIPoint kernelOffset = SkIPoint::Make(1, 1);
-        fFilter = SkMatrixConvolutionImageFilter::Make(kernelSize, kernel, gain, bias,
+        SkIPoint kernelOffset = SkIPoint::Make(kernelSize / 2, kernelSize / 2);
+        fFilter = SkMatrixConvolutionImageFilter::Make(SkISize::Make(kernelSize, kernelSize),
+                                                       kernel.get(), gain, bias,
                                                        kernelOffset, tileMode, convolveAlpha,
                                                        nullptr);
     }
@@ -68,3 +76,68 @@ DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kCl
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kRepeat_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, false); )
+DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClamp_TileMode, true, 7); )
+
+// Filters a large raster image directly, so the filter can split its rows into bands on an
+// executor.
+class MatrixConvolutionBandsBench : public Benchmark {
+public:
+    MatrixConvolutionBandsBench(bool threaded)
+        : fThreaded(threaded)
+        , fName(SkStringPrintf("matrixconvolution_bands%s", threaded ? "_threaded" : "")) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        SkRandom rand;
+        for (int y = 0; y < kSize; y++) {
+            for (int x = 0; x < kSize; x++) {
+                *bitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+            }
+        }
+        fImage = SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kSize, kSize), bitmap);
+        SkScalar kernel[25];
+        for (SkScalar& k : kernel) {
+            k = 1.0f / 25;
+        }
+        fFilter = SkMatrixConvolutionImageFilter::Make(
+                SkISize::Make(5, 5), kernel, SK_Scalar1, 0, SkIPoint::Make(2, 2),
+                SkMatrixConvolutionImageFilter::kClamp_TileMode, true, nullptr);
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkImageFilter::OutputProperties noColorSpace(nullptr);
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                   noColorSpace, fExecutor.get());
+        for (int i = 0; i < loops; i++) {
+            SkIPoint offset;
+            fFilter->filterImage(fImage.get(), ctx, &offset);
+        }
+    }
+
+private:
+    static constexpr int kSize = 1024;
+
+    bool                        fThreaded;
+    SkString                    fName;
+    sk_sp<SkSpecialImage>       fImage;
+    sk_sp<SkImageFilter>        fFilter;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new MatrixConvolutionBandsBench(false); )
+DEF_BENCH( return new MatrixConvolutionBandsBench(true); )
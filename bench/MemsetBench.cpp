@@ -40,6 +40,13 @@ template <> void MemsetBench<uint16_t, false>::onDraw(int loops, SkCanvas*) {
     }
 }
 
+// e.g. an F16 pixel.
+template <> void MemsetBench<uint64_t, false>::onDraw(int loops, SkCanvas*) {
+    for (int i = 0; i < 1000*loops; i++) {
+        sk_memset64(fBuffer.get(), 0x3C003C003C003C00, fN);
+    }
+}
+
 template <typename T>
 static void memsetT(T* dst, T val, int n) {
     for (int i = 0; i < n; i++) { dst[i] = val; }
@@ -51,6 +58,12 @@ template <> void MemsetBench<uint32_t, true>::onDraw(int loops, SkCanvas*) {
     }
 }
 
+template <> void MemsetBench<uint64_t, true>::onDraw(int loops, SkCanvas*) {
+    for (int i = 0; i < 1000*loops; i++) {
+        memsetT<uint64_t>(fBuffer.get(), 0x3C003C003C003C00, fN);
+    }
+}
+
 template <> void MemsetBench<uint16_t, true>::onDraw(int loops, SkCanvas*) {
     for (int i = 0; i < 1000*loops; i++) {
         memsetT<uint16_t>(fBuffer.get(), 0x4973, fN);
@@ -82,3 +95,16 @@ DEF_BENCH(return (new MemsetBench<uint16_t,  true>(10000)));
 DEF_BENCH(return (new MemsetBench<uint16_t, false>(10000)));
 DEF_BENCH(return (new MemsetBench<uint16_t,  true>(100000)));
 DEF_BENCH(return (new MemsetBench<uint16_t, false>(100000)));
+
+DEF_BENCH(return (new MemsetBench<uint64_t,  true>(1)));
+DEF_BENCH(return (new MemsetBench<uint64_t, false>(1)));
+DEF_BENCH(return (new MemsetBench<uint64_t,  true>(10)));
+DEF_BENCH(return (new MemsetBench<uint64_t, false>(10)));
+DEF_BENCH(return (new MemsetBench<uint64_t,  true>(100)));
+DEF_BENCH(return (new MemsetBench<uint64_t, false>(100)));
+DEF_BENCH(return (new MemsetBench<uint64_t,  true>(1000)));
+DEF_BENCH(return (new MemsetBench<uint64_t, false>(1000)));
+DEF_BENCH(return (new MemsetBench<uint64_t,  true>(10000)));
+DEF_BENCH(return (new MemsetBench<uint64_t, false>(10000)));
+DEF_BENCH(return (new MemsetBench<uint64_t,  true>(100000)));
+DEF_BENCH(return (new MemsetBench<uint64_t, false>(100000)));
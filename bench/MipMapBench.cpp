@@ -77,3 +77,5 @@ DEF_BENCH( return new MipMapBench(2048, 2047,
 DEF_BENCH( return new MipMapBench(2047, 2048, SkDestinationSurfaceColorMode::kLegacy); )
 DEF_BENCH( return new MipMapBench(2047, 2048,
                                   SkDestinationSurfaceColorMode::kGammaAndColorSpaceAware); )
+// A 24MP photo; its larger levels are filtered in bands, in parallel if there's a default executor.
+DEF_BENCH( return new MipMapBench(6000, 4000, SkDestinationSurfaceColorMode::kLegacy); )
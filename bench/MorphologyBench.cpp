@@ -6,16 +6,20 @@
  */
 
 #include "Benchmark.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkMorphologyImageFilter.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
+#include "SkSpecialImage.h"
 #include "SkString.h"
 
 #define SMALL   SkIntToScalar(2)
 #define REAL    1.5f
 #define BIG     SkIntToScalar(10)
+#define GIANT   SkIntToScalar(40)
 
 enum MorphologyType {
     kErode_MT,
@@ -92,7 +96,73 @@ DEF_BENCH( return new MorphologyBench(SMALL, kDilate_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kDilate_MT); )
 
+DEF_BENCH( return new MorphologyBench(GIANT, kErode_MT); )
+DEF_BENCH( return new MorphologyBench(GIANT, kDilate_MT); )
+
 DEF_BENCH( return new MorphologyBench(REAL, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(REAL, kDilate_MT); )
 
 DEF_BENCH( return new MorphologyBench(0, kErode_MT); )
+
+// Filters a large raster image directly, so the filter can split its rows and columns into bands
+// on an executor.
+class MorphologyBandsBench : public Benchmark {
+public:
+    MorphologyBandsBench(int radius, bool threaded)
+        : fRadius(radius)
+        , fThreaded(threaded)
+        , fName(SkStringPrintf("morph_bands_%d%s", radius, threaded ? "_threaded" : "")) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkRandom rand;
+        for (int i = 0; i < 64; i++) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas.drawCircle(rand.nextUScalar1() * kSize, rand.nextUScalar1() * kSize, 32, paint);
+        }
+        fImage = SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kSize, kSize), bitmap);
+        fFilter = SkDilateImageFilter::Make(fRadius, fRadius, nullptr);
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkImageFilter::OutputProperties noColorSpace(nullptr);
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                   noColorSpace, fExecutor.get());
+        for (int i = 0; i < loops; i++) {
+            SkIPoint offset;
+            fFilter->filterImage(fImage.get(), ctx, &offset);
+        }
+    }
+
+private:
+    static constexpr int kSize = 1024;
+
+    int                         fRadius;
+    bool                        fThreaded;
+    SkString                    fName;
+    sk_sp<SkSpecialImage>       fImage;
+    sk_sp<SkImageFilter>        fFilter;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new MorphologyBandsBench(16, false); )
+DEF_BENCH( return new MorphologyBandsBench(16, true); )
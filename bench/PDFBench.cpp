@@ -9,7 +9,10 @@
 
 #include "Resources.h"
 #include "SkAutoPixmapStorage.h"
+#include "SkCanvas.h"
 #include "SkData.h"
+#include "SkDocument.h"
+#include "SkExecutor.h"
 #include "SkFloatToDecimal.h"
 #include "SkGradientShader.h"
 #include "SkImage.h"
@@ -58,6 +61,7 @@ DEF_BENCH(return new PDFScalarBench;)
 
 #ifdef SK_SUPPORT_PDF
 
+#include "SkDeflate.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFDocument.h"
 #include "SkPDFShader.h"
@@ -183,6 +187,53 @@ private:
     std::unique_ptr<SkStreamAsset> fAsset;
 };
 
+// Deflates a 1.2MB command stream (pdf_command_stream.txt repeated) at the given level, and
+// optionally in parallel blocks.
+class PDFDeflateBench : public Benchmark {
+public:
+    PDFDeflateBench(int level, bool parallel) : fLevel(level), fParallel(parallel) {
+        fName.printf("PDFDeflate_level%d%s", level, parallel ? "_parallel" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        sk_sp<SkData> commands = GetResourceAsData("pdf_command_stream.txt");
+        if (!commands) {
+            return;
+        }
+        SkDynamicMemoryWStream stream;
+        for (int i = 0; i < 16; ++i) {
+            stream.write(commands->data(), commands->size());
+        }
+        fInput = stream.detachAsData();
+        if (fParallel) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fInput) {
+            return;
+        }
+        while (loops-- > 0) {
+            SkNullWStream out;
+            SkDeflateWStream deflate(&out, fLevel, false, fExecutor.get());
+            deflate.write(fInput->data(), fInput->size());
+            deflate.finalize();
+        }
+    }
+
+private:
+    const int fLevel;
+    const bool fParallel;
+    SkString fName;
+    sk_sp<SkData> fInput;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
 struct PDFColorComponentBench : public Benchmark {
     bool isSuitableFor(Backend b) override {
         return b == kNonRendering_Backend;
@@ -242,13 +293,78 @@ struct WritePDFTextBenchmark : public Benchmark {
     }
 };
 
+// A document of independent pages, each with its own image and some text, like a batch of
+// generated invoices. With 'threaded', the document serializes pages on a thread pool.
+class PDFMultiPageBench : public Benchmark {
+public:
+    explicit PDFMultiPageBench(bool threaded) : fThreaded(threaded) {}
+
+protected:
+    const char* onGetName() override {
+        return fThreaded ? "PDFMultiPage_threaded" : "PDFMultiPage";
+    }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+        SkRandom random;
+        for (sk_sp<SkImage>& image : fImages) {
+            SkAutoPixmapStorage pixmap;
+            pixmap.alloc(SkImageInfo::MakeN32Premul(256, 256));
+            for (int y = 0; y < pixmap.height(); ++y) {
+                for (int x = 0; x < pixmap.width(); ++x) {
+                    // Smooth enough to compress, like a photo or a logo.
+                    *pixmap.writable_addr32(x, y) =
+                            SkPackARGB32(0xFF, x, y, ((x + y) / 2) ^ random.nextULessThan(4));
+                }
+            }
+            image = SkImage::MakeRasterCopy(pixmap);
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        SkDocument::PDFMetadata metadata;
+        metadata.fExecutor = fExecutor.get();
+        SkPaint paint;
+        paint.setTextSize(12);
+        while (loops-- > 0) {
+            SkNullWStream stream;
+            sk_sp<SkDocument> doc = SkDocument::MakePDF(&stream, metadata);
+            for (int page = 0; page < kPageCount; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                // Each image is only drawn on one page, like the per-page content of a report.
+                canvas->drawImage(fImages[page], 36, 36);
+                for (int line = 0; line < 40; ++line) {
+                    static const char kText[] = "Item  Quantity  Unit price  Total";
+                    canvas->drawText(kText, sizeof(kText) - 1, 36, 320 + 10 * line, paint);
+                }
+                doc->endPage();
+            }
+            doc->close();
+        }
+    }
+
+private:
+    static constexpr int kPageCount = 32;
+    const bool fThreaded;
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkImage> fImages[kPageCount];
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
 DEF_BENCH(return new PDFCompressionBench;)
+DEF_BENCH(return new PDFDeflateBench(1, false);)
+DEF_BENCH(return new PDFDeflateBench(6, false);)
+DEF_BENCH(return new PDFDeflateBench(6, true);)
 DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
+DEF_BENCH(return new PDFMultiPageBench(false);)
+DEF_BENCH(return new PDFMultiPageBench(true);)
 
 #endif
 
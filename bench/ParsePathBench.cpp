@@ -0,0 +1,64 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkData.h"
+#include "SkParsePath.h"
+#include "SkPath.h"
+#include "SkTArray.h"
+
+// Times SkParsePath::FromSVGString() over the path data of an SVG resource.
+class ParsePathBench : public Benchmark {
+public:
+    explicit ParsePathBench(const char* name)
+        : fName(SkStringPrintf("parse_path_%s", name))
+        , fPath(SkStringPrintf("%s.svg", name)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        sk_sp<SkData> data = GetResourceAsData(fPath.c_str());
+        if (!data) {
+            return;
+        }
+
+        // Collect the d="..." attributes; good enough for the resources this runs on.
+        const SkString svg(static_cast<const char*>(data->data()), data->size());
+        static constexpr char kAttr[] = " d=\"";
+        for (const char* d = strstr(svg.c_str(), kAttr); d; d = strstr(d, kAttr)) {
+            d += strlen(kAttr);
+            const char* end = strchr(d, '"');
+            if (!end) {
+                break;
+            }
+            fPathData.push_back().set(d, end - d);
+            d = end;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPath path;
+        while (loops-- > 0) {
+            for (const SkString& d : fPathData) {
+                SkParsePath::FromSVGString(d.c_str(), &path);
+            }
+        }
+    }
+
+private:
+    SkString           fName,
+                       fPath;
+    SkTArray<SkString> fPathData;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ParsePathBench("Cowboy"); )
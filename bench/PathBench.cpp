@@ -295,6 +295,36 @@ private:
     typedef PathBench INHERITED;
 };
 
+// Hundreds of small polygons in one path, like the land masses of a map: thousands of line
+// edges, few of which cross.
+class ManyPolygonsPathBench : public PathBench {
+public:
+    ManyPolygonsPathBench(Flags flags) : INHERITED(flags) {}
+
+    void appendName(SkString* name) override {
+        name->append("many_polygons");
+    }
+    void makePath(SkPath* path) override {
+        SkRandom rand;
+        for (int i = 0; i < 300; i++) {
+            SkScalar cx = rand.nextUScalar1() * 640,
+                     cy = rand.nextUScalar1() * 480,
+                     r  = rand.nextRangeScalar(3, 30);
+            int n = 5 + rand.nextULessThan(20);
+            for (int j = 0; j < n; j++) {
+                SkScalar angle = j * 2 * SK_ScalarPI / n,
+                         radius = r * rand.nextRangeScalar(0.6f, 1);
+                SkPoint pt = { cx + radius * SkScalarCos(angle), cy + radius * SkScalarSin(angle) };
+                j ? path->lineTo(pt) : path->moveTo(pt);
+            }
+            path->close();
+        }
+    }
+    int complexity() override { return 2; }
+private:
+    typedef PathBench INHERITED;
+};
+
 class RandomPathBench : public Benchmark {
 public:
     bool isSuitableFor(Backend backend) override {
@@ -1154,6 +1184,8 @@ DEF_BENCH( return new LongCurvedPathBench(FLAGS00); )
 DEF_BENCH( return new LongCurvedPathBench(FLAGS01); )
 DEF_BENCH( return new LongLinePathBench(FLAGS00); )
 DEF_BENCH( return new LongLinePathBench(FLAGS01); )
+DEF_BENCH( return new ManyPolygonsPathBench(FLAGS00); )
+DEF_BENCH( return new ManyPolygonsPathBench(FLAGS10); )
 
 DEF_BENCH( return new PathCreateBench(); )
 DEF_BENCH( return new PathCopyBench(); )
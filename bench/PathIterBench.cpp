@@ -10,9 +10,11 @@
 #include "SkColorPriv.h"
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkPathPriv.h"
 #include "SkRandom.h"
 #include "SkShader.h"
 #include "SkString.h"
+#include "SkTemplates.h"
 
 static int rand_pts(SkRandom& rand, SkPoint pts[4]) {
     int n = rand.nextU() & 3;
@@ -93,3 +95,86 @@ private:
 
 DEF_BENCH( return new PathIterBench(false); )
 DEF_BENCH( return new PathIterBench(true); )
+
+// Walks the verbs and points of the path straight out of its storage.
+class PathIterateBench : public Benchmark {
+    SkPath fPath;
+
+public:
+    PathIterateBench() {
+        SkRandom rand;
+        for (int i = 0; i < 1000; ++i) {
+            SkPoint pts[4];
+            switch (rand_pts(rand, pts)) {
+                case 1: fPath.moveTo(pts[0]); break;
+                case 2: fPath.lineTo(pts[1]); break;
+                case 3: fPath.quadTo(pts[1], pts[2]); break;
+                case 4: fPath.cubicTo(pts[1], pts[2], pts[3]); break;
+            }
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return "pathiter_iterate";
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkScalar sum = 0;
+            for (SkPathPriv::Segment segment : SkPathPriv::Iterate(fPath)) {
+                sum += segment.fPts[0].fX;
+            }
+            fSum += sum;
+        }
+    }
+
+private:
+    SkScalar fSum = 0;
+
+    typedef Benchmark INHERITED;
+};
+
+// Computes the bounds of a path's points, which SkPathRef does whenever a path changes.
+class PathBoundsBench : public Benchmark {
+    SkString               fName;
+    SkAutoTMalloc<SkPoint> fPts;
+    int                    fCount;
+
+public:
+    PathBoundsBench(int count) : fPts(count), fCount(count) {
+        fName.printf("path_bounds_%d", count);
+        SkRandom rand;
+        for (int i = 0; i < count; ++i) {
+            fPts[i].set(rand.nextSScalar1(), rand.nextSScalar1());
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkRect bounds;
+        for (int i = 0; i < loops; ++i) {
+            bounds.setBoundsCheck(fPts.get(), fCount);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathIterateBench(); )
+DEF_BENCH( return new PathBoundsBench(7); )
+DEF_BENCH( return new PathBoundsBench(100); )
+DEF_BENCH( return new PathBoundsBench(100000); )
@@ -7,23 +7,37 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkPerlinNoiseShader.h"
+#include "SkPerlinNoiseShaderPriv.h"
 #include "SkShader.h"
+#include "SkString.h"
 
 class PerlinNoiseBench : public Benchmark {
-    SkISize fSize;
+    SkISize  fSize;
+    bool     fStitchTiles;
+    bool     fCacheTiles;
+    SkString fName;
 
 public:
-    PerlinNoiseBench()  {
+    PerlinNoiseBench(bool stitchTiles = false, bool cacheTiles = false)
+        : fStitchTiles(stitchTiles)
+        , fCacheTiles(cacheTiles) {
         fSize = SkISize::Make(80, 80);
+        fName.set("perlinnoise");
+        if (stitchTiles) {
+            fName.append("_stitched");
+        }
+        if (cacheTiles) {
+            fName.append("_cached");
+        }
     }
 
 protected:
     const char* onGetName() override {
-        return "perlinnoise";
+        return fName.c_str();
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
-        this->test(loops, canvas, 0, 0, 0.1f, 0.1f, 3, 0, false);
+        this->test(loops, canvas, 0, 0, 0.1f, 0.1f, 3, 0, fStitchTiles);
     }
 
 private:
@@ -42,9 +56,12 @@ private:
               float baseFrequencyX, float baseFrequencyY, int numOctaves, float seed,
               bool stitchTiles) {
         SkPaint paint;
-        paint.setShader(SkPerlinNoiseShader::MakeFractalNoise(baseFrequencyX, baseFrequencyY,
-                                                              numOctaves, seed,
-                                                              stitchTiles ? &fSize : nullptr));
+        const SkISize* tileSize = stitchTiles ? &fSize : nullptr;
+        paint.setShader(fCacheTiles
+                ? SkPerlinNoiseShaderPriv::MakeFractalNoiseCachingTiles(
+                        baseFrequencyX, baseFrequencyY, numOctaves, seed, tileSize)
+                : SkPerlinNoiseShader::MakeFractalNoise(
+                        baseFrequencyX, baseFrequencyY, numOctaves, seed, tileSize));
         for (int i = 0; i < loops; i++) {
             this->drawClippedRect(canvas, x, y, paint);
         }
@@ -56,3 +73,5 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new PerlinNoiseBench(); )
+DEF_BENCH( return new PerlinNoiseBench(true); )
+DEF_BENCH( return new PerlinNoiseBench(true, true); )
@@ -7,12 +7,15 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkData.h"
 #include "SkPaint.h"
+#include "SkPath.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkPoint.h"
 #include "SkRandom.h"
 #include "SkRect.h"
+#include "SkStream.h"
 #include "SkString.h"
 
 // This is designed to emulate about 4 screens of textual content
@@ -217,3 +220,59 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Measures loading a serialized picture. kInPlace loads from memory, which reads the op data and
+// buffers in place; kCopy hides the stream's memory, so they are copied first.
+enum Load { kInPlace, kCopy };
+class PictureLoadBench : public Benchmark {
+public:
+    PictureLoadBench(Load load) : fLoad(load) {
+        fName.printf("picture_load_%s", kInPlace == load ? "in_place" : "copy");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024);
+        SkRandom rand;
+        for (int i = 0; i < 10000; i++) {
+            SkPaint paint;
+            paint.setColor(rand.nextU());
+            SkPath path;
+            path.moveTo(rand.nextRangeScalar(0, 1024), rand.nextRangeScalar(0, 1024));
+            for (int j = 0; j < 4; j++) {
+                path.lineTo(rand.nextRangeScalar(0, 1024), rand.nextRangeScalar(0, 1024));
+            }
+            canvas->drawPath(path, paint);
+            canvas->drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, 1024),
+                                              rand.nextRangeScalar(0, 1024), 16, 16), paint);
+        }
+        fData = recorder.finishRecordingAsPicture()->serialize();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        struct CopyingStream : public SkMemoryStream {
+            CopyingStream(sk_sp<SkData> data) : SkMemoryStream(std::move(data)) {}
+            const void* getMemoryBase() override { return nullptr; }
+        };
+        for (int i = 0; i < loops; i++) {
+            if (kInPlace == fLoad) {
+                SkMemoryStream stream(fData);
+                SkPicture::MakeFromStream(&stream);
+            } else {
+                CopyingStream stream(fData);
+                SkPicture::MakeFromStream(&stream);
+            }
+        }
+    }
+
+private:
+    Load          fLoad;
+    SkString      fName;
+    sk_sp<SkData> fData;
+};
+
+DEF_BENCH( return new PictureLoadBench(kInPlace); )
+DEF_BENCH( return new PictureLoadBench(kCopy); )
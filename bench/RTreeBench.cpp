@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkPackedRTree.h"
 #include "SkRTree.h"
 #include "SkRandom.h"
 #include "SkString.h"
@@ -16,14 +17,21 @@ static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
 static const int NUM_QUERY_RECTS = 5000;
 static const int GRID_WIDTH = 100;
+// Large pictures, e.g. long web pages, have this many ops.
+static const int NUM_LARGE_QUERY_RECTS = 100000;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
+static SkBBoxHierarchy* make_tree(bool packed) {
+    return packed ? static_cast<SkBBoxHierarchy*>(new SkPackedRTree) : new SkRTree;
+}
+
 // Time how long it takes to build an R-Tree.
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+    RTreeBuildBench(const char* name, MakeRectProc proc, bool packed = false)
+            : fProc(proc), fPacked(packed) {
+        fName.printf("%s_%s_build", packed ? "packed_rtree" : "rtree", name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -42,13 +50,14 @@ protected:
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
-            tree.insert(rects.get(), NUM_BUILD_RECTS);
+            std::unique_ptr<SkBBoxHierarchy> tree(make_tree(fPacked));
+            tree->insert(rects.get(), NUM_BUILD_RECTS);
             SkASSERT(rects != nullptr);  // It'd break this bench if the tree took ownership of rects.
         }
     }
 private:
     MakeRectProc fProc;
+    bool fPacked;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -56,8 +65,13 @@ private:
 // Time how long it takes to perform queries on an R-Tree.
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+    RTreeQueryBench(const char* name, MakeRectProc proc, bool packed = false,
+                    int numRects = NUM_QUERY_RECTS)
+            : fProc(proc), fPacked(packed), fNumRects(numRects) {
+        fName.printf("%s_%s_query", packed ? "packed_rtree" : "rtree", name);
+        if (NUM_QUERY_RECTS != numRects) {
+            fName.appendf("_%d", numRects);
+        }
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -69,11 +83,12 @@ protected:
     }
     void onDelayedSetup() override {
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_QUERY_RECTS);
-        for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
-        fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        fTree.reset(make_tree(fPacked));
+        fTree->insert(rects.get(), fNumRects);
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -85,12 +100,14 @@ protected:
             query.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
             query.fRight  = query.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
             query.fBottom = query.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
-            fTree.search(query, &hits);
+            fTree->search(query, &hits);
         }
     }
 private:
-    SkRTree fTree;
+    std::unique_ptr<SkBBoxHierarchy> fTree;
     MakeRectProc fProc;
+    bool fPacked;
+    int fNumRects;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -136,3 +153,18 @@ DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
 DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
 DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
 DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeBuildBench("XY", &make_XYordered_rects, true));
+DEF_BENCH(return new RTreeBuildBench("random", &make_random_rects, true));
+
+DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects, true));
+DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects, true));
+DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects, true));
+DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects, true));
+
+DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects, false, NUM_LARGE_QUERY_RECTS));
+DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects, false,
+                                     NUM_LARGE_QUERY_RECTS));
+DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects, true, NUM_LARGE_QUERY_RECTS));
+DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects, true,
+                                     NUM_LARGE_QUERY_RECTS));
@@ -105,3 +105,57 @@ private:
     typedef Benchmark INHERITED;
 };
 DEF_BENCH( return new PixmapOrientBench(); )
+
+////////////////////////////////////////////////////////////////////////////////
+#include "SkExecutor.h"
+
+// Converts a large F16 image to 8888 sRGB, as when encoding it, on an executor of the given
+// number of threads, or serially if there are none.
+class ReadPixConvertBench : public Benchmark {
+public:
+    ReadPixConvertBench(int threads) : fThreads(threads) {
+        fName.printf("readpix_f16_to_8888_%d_threads", threads);
+    }
+
+protected:
+    void onDelayedSetup() override {
+        fSrc.allocPixels(SkImageInfo::Make(kW, kH, kRGBA_F16_SkColorType, kPremul_SkAlphaType,
+                                           SkColorSpace::MakeSRGBLinear()));
+        fSrc.eraseColor(0x80408020);
+        fDst.allocPixels(SkImageInfo::MakeS32(kW, kH, kPremul_SkAlphaType));
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            fSrc.pixmap().readPixels(fDst.info(), fDst.getPixels(), fDst.rowBytes(), 0, 0,
+                                     SkTransferFunctionBehavior::kRespect, fExecutor.get());
+        }
+    }
+
+private:
+    static const int kW = 3840;
+    static const int kH = 2160;
+
+    int                         fThreads;
+    SkString                    fName;
+    SkBitmap                    fSrc, fDst;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+DEF_BENCH( return new ReadPixConvertBench(0); )
+DEF_BENCH( return new ReadPixConvertBench(1); )
+DEF_BENCH( return new ReadPixConvertBench(2); )
+DEF_BENCH( return new ReadPixConvertBench(4); )
+DEF_BENCH( return new ReadPixConvertBench(8); )
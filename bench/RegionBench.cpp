@@ -8,6 +8,7 @@
 #include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 static bool union_proc(SkRegion& a, SkRegion& b) {
     SkRegion result;
@@ -129,3 +130,47 @@ DEF_BENCH(return new RegionBench(SMALL, containsrect_proc, "containsrect");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrgn_proc, "intersectsrgn");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrect_proc, "intersectsrect");)
 DEF_BENCH(return new RegionBench(SMALL, containsxy_proc, "containsxy");)
+
+// Builds a region from many rects at once, as clips from display lists do.
+class RegionSetRectsBench : public Benchmark {
+public:
+    RegionSetRectsBench(int count, bool oneByOne) : fOneByOne(oneByOne) {
+        fName.printf("region_setrects_%s_%d", oneByOne ? "op" : "batch", count);
+        SkRandom rand;
+        for (int i = 0; i < count; i++) {
+            int x = rand.nextU() % 1024;
+            int y = rand.nextU() % 768;
+            *fRects.append() = SkIRect::MakeXYWH(x, y, rand.nextU() % 64, rand.nextU() % 64);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            SkRegion rgn;
+            if (fOneByOne) {
+                for (const SkIRect& r : fRects) {
+                    rgn.op(r, SkRegion::kUnion_Op);
+                }
+            } else {
+                rgn.setRects(fRects.begin(), fRects.count());
+            }
+        }
+    }
+
+private:
+    SkTDArray<SkIRect> fRects;
+    bool               fOneByOne;
+    SkString           fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new RegionSetRectsBench(256, true);)
+DEF_BENCH(return new RegionSetRectsBench(256, false);)
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkString.h"
+
+/**
+ * Draws the way a view hierarchy does: each view saves, translates to its own origin, maybe
+ * clips to its bounds, draws a little, and restores.
+ */
+class SaveRestoreBench : public Benchmark {
+public:
+    enum Mode {
+        kTranslate_Mode,        // save, translate, restore
+        kTranslateDraw_Mode,    // save, translate, draw a small rect, restore
+        kTranslateClip_Mode,    // save, translate, clip, draw a small rect, restore
+    };
+
+    SaveRestoreBench(Mode mode) : fMode(mode) {
+        static const char* kNames[] = { "translate", "translate_draw", "translate_clip" };
+        fName.printf("save_restore_%s", kNames[mode]);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setColor(0xFF336699);
+        const SkRect rect = SkRect::MakeWH(4, 4);
+        for (int loop = 0; loop < loops; ++loop) {
+            for (int i = 0; i < 100; ++i) {
+                canvas->save();
+                canvas->translate(SkIntToScalar(i), SkIntToScalar(i / 2));
+                if (fMode == kTranslateClip_Mode) {
+                    canvas->clipRect(SkRect::MakeWH(20, 20));
+                }
+                if (fMode != kTranslate_Mode) {
+                    canvas->drawRect(rect, paint);
+                }
+                canvas->restore();
+            }
+        }
+    }
+
+private:
+    SkString fName;
+    Mode     fMode;
+};
+
+DEF_BENCH( return new SaveRestoreBench(SaveRestoreBench::kTranslate_Mode); )
+DEF_BENCH( return new SaveRestoreBench(SaveRestoreBench::kTranslateDraw_Mode); )
+DEF_BENCH( return new SaveRestoreBench(SaveRestoreBench::kTranslateClip_Mode); )
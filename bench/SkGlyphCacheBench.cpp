@@ -10,6 +10,7 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkSharedStrike.h"
 #include "SkStrikeCache.h"
 #include "SkGraphics.h"
 #include "SkTaskGroup.h"
@@ -17,11 +18,21 @@
 #include "sk_tool_utils.h"
 
 
+static SkExclusiveStrikePtr find_or_create_strike(const SkPaint& paint, SkExclusiveStrikePtr*) {
+    return SkStrikeCache::FindOrCreateStrikeExclusive(
+            paint, nullptr, SkScalerContextFlags::kNone, nullptr);
+}
+
+static sk_sp<SkSharedStrike> find_or_create_strike(const SkPaint& paint, sk_sp<SkSharedStrike>*) {
+    return SkStrikeCache::FindOrCreateStrikeShared(
+            paint, nullptr, SkScalerContextFlags::kNone, nullptr);
+}
+
+template <typename StrikePtr = SkExclusiveStrikePtr>
 static void do_font_stuff(SkPaint* paint) {
     for (SkScalar i = 8; i < 64; i++) {
         paint->setTextSize(i);
-        auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(
-                *paint, nullptr, SkScalerContextFlags::kNone, nullptr);
+        auto cache = find_or_create_strike(*paint, (StrikePtr*)nullptr);
         uint16_t glyphs['z'];
         for (int c = ' '; c < 'z'; c++) {
             glyphs[c] = cache->unicharToGlyph(c);
@@ -50,9 +61,18 @@ protected:
         return backend == kNonRendering_Backend;
     }
 
-    void onDraw(int loops, SkCanvas*) override {
-        size_t oldCacheLimitSize = SkGraphics::GetFontCacheLimit();
+    bool isThreadSafe() const override { return true; }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fOldCacheLimitSize = SkGraphics::GetFontCacheLimit();
         SkGraphics::SetFontCacheLimit(fCacheSize);
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkGraphics::SetFontCacheLimit(fOldCacheLimitSize);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
         SkPaint paint;
         paint.setAntiAlias(true);
         paint.setSubpixelText(true);
@@ -61,22 +81,24 @@ protected:
         for (int work = 0; work < loops; work++) {
             do_font_stuff(&paint);
         }
-        SkGraphics::SetFontCacheLimit(oldCacheLimitSize);
     }
 
 private:
     typedef Benchmark INHERITED;
     const size_t fCacheSize;
+    size_t fOldCacheLimitSize = 0;
     SkString fName;
 };
 
+template <typename StrikePtr>
 class SkGlyphCacheStressTest : public Benchmark {
 public:
-    explicit SkGlyphCacheStressTest(int cacheSize) : fCacheSize(cacheSize) { }
+    SkGlyphCacheStressTest(const char* name, int cacheSize) : fCacheSize(cacheSize) {
+        fName.printf("%s%dK", name, (int)(fCacheSize >> 10));
+    }
 
 protected:
     const char* onGetName() override {
-        fName.printf("SkGlyphCacheStressTest%dK", (int)(fCacheSize >> 10));
         return fName.c_str();
     }
 
@@ -97,7 +119,7 @@ protected:
                 paint.setAntiAlias(true);
                 paint.setSubpixelText(true);
                 paint.setTypeface(typefaces[threadIndex % 2]);
-                do_font_stuff(&paint);
+                do_font_stuff<StrikePtr>(&paint);
             });
         }
         SkGraphics::SetFontCacheLimit(oldCacheLimitSize);
@@ -111,5 +133,11 @@ private:
 
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
-DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
-DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheStressTest<SkExclusiveStrikePtr>(
+        "SkGlyphCacheStressTest", 256 * 1024); )
+DEF_BENCH( return new SkGlyphCacheStressTest<SkExclusiveStrikePtr>(
+        "SkGlyphCacheStressTest", 32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheStressTest<sk_sp<SkSharedStrike>>(
+        "SkGlyphCacheSharedStressTest", 256 * 1024); )
+DEF_BENCH( return new SkGlyphCacheStressTest<sk_sp<SkSharedStrike>>(
+        "SkGlyphCacheSharedStressTest", 32 * 1024 * 1024); )
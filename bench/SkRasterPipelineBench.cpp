@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkTaskGroup.h"
 #include "../src/jumper/SkJumper.h"
 
 static const int N = 15;
@@ -104,6 +105,36 @@ private:
 DEF_BENCH( return (new SkRasterPipelineCompileVsRunBench(true )); )
 DEF_BENCH( return (new SkRasterPipelineCompileVsRunBench(false)); )
 
+// Compiles short-lived pipelines on several threads at once, as tiled raster drawing does.
+class SkRasterPipelineCompileMTBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return "SkRasterPipeline_compileMT"; }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup().batch(kThreads, [&](int thread) {
+            SkJumper_MemoryCtx src_ctx = {fSrc[thread], 0},
+                               dst_ctx = {fDst[thread], 0};
+            for (int i = 0; i < loops; i++) {
+                SkRasterPipeline_<256> p;
+                p.append(SkRasterPipeline::load_8888, &dst_ctx);
+                p.append(SkRasterPipeline::move_src_dst);
+                p.append(SkRasterPipeline::load_8888, &src_ctx);
+                p.append(SkRasterPipeline::srcover);
+                p.append(SkRasterPipeline::store_8888, &dst_ctx);
+                p.compile()(0,0,N,1);
+            }
+        });
+    }
+
+private:
+    static constexpr int kThreads = 4;
+
+    uint32_t fSrc[kThreads][N] = {},
+             fDst[kThreads][N] = {};
+};
+DEF_BENCH( return (new SkRasterPipelineCompileMTBench); )
+
 static SkColorSpaceTransferFn gamma(float g) {
     SkColorSpaceTransferFn fn = {0,0,0,0,0,0,0};
     fn.fG = g;
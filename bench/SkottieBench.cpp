@@ -0,0 +1,63 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#if defined(SK_ENABLE_SKOTTIE)
+
+#include "Resources.h"
+#include "Skottie.h"
+#include "SkData.h"
+#include "SkStream.h"
+
+// Times Animation::Make(): parsing the json and building the scene.
+class SkottieLoadBench : public Benchmark {
+public:
+    explicit SkottieLoadBench(const char* name)
+        : fName(SkStringPrintf("skottie_load_%s", name))
+        , fPath(SkStringPrintf("skotty/%s.json", name)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fPath.c_str());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        class ResourceDirProvider final : public skottie::ResourceProvider {
+        public:
+            std::unique_ptr<SkStream> openStream(const char resource[]) const override {
+                return GetResourceAsStream(SkStringPrintf("skotty/%s", resource).c_str());
+            }
+        };
+        ResourceDirProvider resources;
+
+        if (!fData) {
+            return;
+        }
+        while (loops-- > 0) {
+            SkMemoryStream stream(fData);
+            SkAssertResult(skottie::Animation::Make(&stream, resources));
+        }
+    }
+
+private:
+    SkString      fName,
+                  fPath;
+    sk_sp<SkData> fData;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SkottieLoadBench("skotty_sample_1"); )
+DEF_BENCH( return new SkottieLoadBench("skotty_sample_2"); )
+DEF_BENCH( return new SkottieLoadBench("skotty_sample_nested"); )
+
+#endif
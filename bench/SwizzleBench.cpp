@@ -16,7 +16,8 @@ public:
     const char* onGetName() override { return fName; }
     void onDraw(int loops, SkCanvas*) override {
         static const int K = 1023; // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
-        uint32_t dst[K], src[K];
+        // Sources are up to 8 bytes per pixel (RGBA16).
+        uint32_t dst[K], src[2*K];
         while (loops --> 0) {
             fFn(dst, src, K);
         }
@@ -37,3 +38,9 @@ DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA
 DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_RGB1", SkOpts::RGB16_to_RGB1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_BGR1", SkOpts::RGB16_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_RGBA", SkOpts::RGBA16_to_RGBA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_BGRA", SkOpts::RGBA16_to_BGRA));
+DEF_BENCH(return new SwizzleBench("SkOpts::rgbA_to_RGBA", SkOpts::rgbA_to_RGBA));
+DEF_BENCH(return new SwizzleBench("SkOpts::rgbA_to_BGRA", SkOpts::rgbA_to_BGRA));
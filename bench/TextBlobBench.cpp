@@ -12,6 +12,7 @@
 #include "SkRandom.h"
 #include "SkStream.h"
 #include "SkString.h"
+#include "SkSurface.h"
 #include "SkTemplates.h"
 #include "SkTextBlob.h"
 #include "SkTypeface.h"
@@ -20,10 +21,11 @@
 
 /*
  * A trivial test which benchmarks the performance of a textblob with a single run.
+ * Optionally with SkTextBlobRasterCache turned on, for raster canvases.
  */
 class TextBlobBench : public Benchmark {
 public:
-    TextBlobBench() {}
+    explicit TextBlobBench(bool useRasterCache = false) : fUseRasterCache(useRasterCache) {}
 
 protected:
     void onDelayedSetup() override {
@@ -48,10 +50,25 @@ protected:
     }
 
     const char* onGetName() override {
-        return "TextBlobBench";
+        return fUseRasterCache ? "TextBlobBench_rasterCache" : "TextBlobBench";
+    }
+
+    void onPerCanvasPreDraw(SkCanvas* canvas) override {
+        if (fUseRasterCache) {
+            // The cache is a property of the surface, so draw into one of our own that has it.
+            SkSurfaceProps props(SkSurfaceProps::kCacheTextBlobs_Flag, kUnknown_SkPixelGeometry);
+            fSurface = canvas->makeSurface(canvas->imageInfo(), &props);
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        fSurface = nullptr;
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
+        if (fSurface) {
+            canvas = fSurface->getCanvas();
+        }
         SkPaint paint;
 
         // To ensure maximum caching, we just redraw the blob at the same place everytime
@@ -65,8 +82,11 @@ private:
     sk_sp<SkTextBlob>   fBlob;
     SkTDArray<uint16_t> fGlyphs;
     sk_sp<SkTypeface>   fTypeface;
+    const bool          fUseRasterCache;
+    sk_sp<SkSurface>    fSurface;
 
     typedef Benchmark INHERITED;
 };
 
 DEF_BENCH( return new TextBlobBench(); )
+DEF_BENCH( return new TextBlobBench(true); )
@@ -11,6 +11,7 @@
 #include "SkRandom.h"
 #include "SkShader.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 #include "SkVertices.h"
 
 enum VertFlags {
@@ -23,15 +24,13 @@ class VertBench : public Benchmark {
     enum {
         W = 640,
         H = 480,
-        ROW = 20,
-        COL = 20,
-        PTS = (ROW + 1) * (COL + 1),
-        IDX = ROW * COL * 6,
     };
 
-    SkPoint fPts[PTS];
-    SkColor fColors[PTS];
-    uint16_t fIdx[IDX];
+    // A grid of rows x cols cells, two triangles each.
+    const int fRows, fCols;
+    SkTDArray<SkPoint> fPts;
+    SkTDArray<SkColor> fColors;
+    SkTDArray<uint16_t> fIdx;
 
     static void load_2_tris(uint16_t idx[], int x, int y, int rb) {
         int n = y * rb + x;
@@ -40,40 +39,47 @@ class VertBench : public Benchmark {
     }
 
 public:
-    VertBench() {
-        const SkScalar dx = SkIntToScalar(W) / COL;
-        const SkScalar dy = SkIntToScalar(H) / COL;
+    VertBench(int rows = 20, int cols = 20) : fRows(rows), fCols(cols) {
+        const int ptCount = (fRows + 1) * (fCols + 1);
+        SkASSERT(ptCount <= 65536);
+        const SkScalar dx = SkIntToScalar(W) / fCols;
+        const SkScalar dy = SkIntToScalar(H) / fRows;
 
-        SkPoint* pts = fPts;
-        uint16_t* idx = fIdx;
+        SkPoint* pts = fPts.append(ptCount);
+        uint16_t* idx = fIdx.append(fRows * fCols * 6);
 
         SkScalar yy = 0;
-        for (int y = 0; y <= ROW; y++) {
+        for (int y = 0; y <= fRows; y++) {
             SkScalar xx = 0;
-            for (int x = 0; x <= COL; ++x) {
+            for (int x = 0; x <= fCols; ++x) {
                 pts->set(xx, yy);
                 pts += 1;
                 xx += dx;
 
-                if (x < COL && y < ROW) {
-                    load_2_tris(idx, x, y, COL + 1);
+                if (x < fCols && y < fRows) {
+                    load_2_tris(idx, x, y, fCols + 1);
                     for (int i = 0; i < 6; i++) {
-                        SkASSERT(idx[i] < PTS);
+                        SkASSERT(idx[i] < ptCount);
                     }
                     idx += 6;
                 }
             }
             yy += dy;
         }
-        SkASSERT(PTS == pts - fPts);
-        SkASSERT(IDX == idx - fIdx);
+        SkASSERT(fPts.end() == pts);
+        SkASSERT(fIdx.end() == idx);
 
         SkRandom rand;
-        for (int i = 0; i < PTS; ++i) {
-            fColors[i] = rand.nextU() | (0xFF << 24);
+        for (int i = 0; i < ptCount; ++i) {
+            *fColors.append() = rand.nextU() | (0xFF << 24);
         }
 
-        fName.set("verts");
+        // The original 20x20 grid keeps its name.
+        if (fRows == 20 && fCols == 20) {
+            fName.set("verts");
+        } else {
+            fName.printf("verts_%dx%d", fCols, fRows);
+        }
     }
 
 protected:
@@ -82,8 +88,9 @@ protected:
         SkPaint paint;
         this->setupPaint(&paint);
 
-        auto verts = SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, PTS,
-                                          fPts, nullptr, fColors, IDX, fIdx);
+        auto verts = SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, fPts.count(),
+                                          fPts.begin(), nullptr, fColors.begin(),
+                                          fIdx.count(), fIdx.begin());
         for (int i = 0; i < loops; i++) {
             canvas->drawVertices(verts, SkBlendMode::kModulate, paint);
         }
@@ -95,3 +102,4 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH(return new VertBench();)
+DEF_BENCH(return new VertBench(100, 100);)
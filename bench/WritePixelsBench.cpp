@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkString.h"
 
 class WritePixelsBench : public Benchmark {
@@ -74,3 +75,58 @@ private:
 
 DEF_BENCH(return new WritePixelsBench(kRGBA_8888_SkColorType, kPremul_SkAlphaType);)
 DEF_BENCH(return new WritePixelsBench(kRGBA_8888_SkColorType, kUnpremul_SkAlphaType);)
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Writes a large unpremul RGBA image into a premul BGRA bitmap, on an executor of the given
+// number of threads, or serially if there are none.
+class WritePixelsConvertBench : public Benchmark {
+public:
+    WritePixelsConvertBench(int threads) : fThreads(threads) {
+        fName.printf("writepix_large_RGBA_UPM_%d_threads", threads);
+    }
+
+protected:
+    void onDelayedSetup() override {
+        fSrc.allocPixels(SkImageInfo::Make(kW, kH, kRGBA_8888_SkColorType,
+                                           kUnpremul_SkAlphaType));
+        fSrc.eraseColor(0x80408020);
+        fDst.allocPixels(SkImageInfo::Make(kW, kH, kBGRA_8888_SkColorType,
+                                           kPremul_SkAlphaType));
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int loop = 0; loop < loops; ++loop) {
+            fDst.writePixels(fSrc.pixmap(), 0, 0, SkTransferFunctionBehavior::kRespect,
+                             fExecutor.get());
+        }
+    }
+
+private:
+    static const int kW = 3840;
+    static const int kH = 2160;
+
+    int                         fThreads;
+    SkString                    fName;
+    SkBitmap                    fSrc, fDst;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new WritePixelsConvertBench(0);)
+DEF_BENCH(return new WritePixelsConvertBench(1);)
+DEF_BENCH(return new WritePixelsConvertBench(2);)
+DEF_BENCH(return new WritePixelsConvertBench(4);)
+DEF_BENCH(return new WritePixelsConvertBench(8);)
@@ -35,6 +35,43 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Writes 100MB of 64 byte records, as recording a big picture does, then detaches them.
+class BigWriterBench : public Benchmark {
+public:
+    BigWriterBench(bool reserve) : fReserve(reserve) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fReserve ? "writer_100MB_reserve" : "writer_100MB";
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        static const size_t kBytes = 100 << 20;
+        static const uint32_t gRecord[16] = { 0 };
+        for (int i = 0; i < loops; i++) {
+            SkWriter32 writer;
+            if (fReserve) {
+                writer.setReserve(kBytes);
+            }
+            for (size_t j = 0; j < kBytes; j += sizeof(gRecord)) {
+                writer.write(gRecord, sizeof(gRecord));
+            }
+            sk_sp<SkData> data = writer.detachAsData();
+        }
+    }
+
+private:
+    bool fReserve;
+
+    typedef Benchmark INHERITED;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new WriterBench(); )
+DEF_BENCH( return new BigWriterBench(false); )
+DEF_BENCH( return new BigWriterBench(true); )
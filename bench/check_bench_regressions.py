@@ -24,9 +24,14 @@ EXPECTED_IDX = -3
 LB_IDX = -2
 UB_IDX = -1
 
-# Indices of the tuple of dictionaries containing slower and faster alerts.
-SLOWER = 0
-FASTER = 1
+# Indices of the tuple of dictionaries containing regressed and improved alerts.
+WORSE = 0
+BETTER = 1
+
+# Besides times, expectations may be set on the per-loop counters from
+# nanobench --perfCounters, e.g. cache_misses or branch_misses. Like times,
+# those regress as they grow; the metrics listed here regress as they drop.
+HIGHER_IS_BETTER = ('ipc',)
 
 # URL prefix for the bench dashboard page. Showing recent 15 days of data.
 DASHBOARD_URL_PREFIX = 'http://go/skpdash/#15'
@@ -41,6 +46,7 @@ def usage():
     print '-e <file> file containing expected bench builder values/ranges.'
     print '   Will raise exception if actual bench values are out of range.'
     print '   See bench_expectations_<builder>.txt for data format / examples.'
+    print '   Besides times, ipc and the other --perfCounters metrics are checked.'
     print '-r <revision> the git commit hash or svn revision for checking '
     print '   bench values.'
 
@@ -143,9 +149,10 @@ def check_expectations(lines, expectations, key_suffix):
     """
     # The platform for this bot, to pass to the dashboard plot.
     platform = key_suffix[ : key_suffix.rfind('-')]
-    # Tuple of dictionaries recording exceptions that are slower and faster,
-    # respectively. Each dictionary maps off_ratio (ratio of actual to expected)
-    # to a list of corresponding exception messages.
+    # Tuple of dictionaries recording exceptions that are worse and better,
+    # respectively. Each dictionary maps how far off the value is (ratio of
+    # actual to expected, inverted where higher is better, so larger is always
+    # worse) to a list of corresponding exception messages.
     exceptions = ({}, {})
     for line in lines:
         line_str = str(line)
@@ -165,21 +172,23 @@ def check_expectations(lines, expectations, key_suffix):
                 this_expected, (off_ratio - 1) * 100)
             exception += '\n' + '~'.join([
                 DASHBOARD_URL_PREFIX, bench, platform, config])
-            if off_ratio > 1:  # Bench is slower.
-                exceptions[SLOWER].setdefault(off_ratio, []).append(exception)
+            if line.time_type in HIGHER_IS_BETTER:
+                off_ratio = 1 / off_ratio
+            if off_ratio > 1:  # Bench is slower, or otherwise worse.
+                exceptions[WORSE].setdefault(off_ratio, []).append(exception)
             else:
-                exceptions[FASTER].setdefault(off_ratio, []).append(exception)
+                exceptions[BETTER].setdefault(off_ratio, []).append(exception)
     outputs = []
-    for i in [SLOWER, FASTER]:
+    for i in [WORSE, BETTER]:
       if exceptions[i]:
           ratios = exceptions[i].keys()
           ratios.sort(reverse=True)
           li = []
           for ratio in ratios:
               li.extend(exceptions[i][ratio])
-          header = '%s benches got slower (sorted by %% difference):' % len(li)
-          if i == FASTER:
-              header = header.replace('slower', 'faster')
+          header = '%s benches got worse (sorted by %% difference):' % len(li)
+          if i == BETTER:
+              header = header.replace('worse', 'better')
           outputs.extend(['', header] + li)
 
     if outputs:
@@ -9,6 +9,7 @@
 
 #include "nanobench.h"
 
+#include "AACostCalibration.h"
 #include "AndroidCodecBench.h"
 #include "Benchmark.h"
 #include "BitmapRegionDecoderBench.h"
@@ -17,11 +18,14 @@
 #include "ColorCodecBench.h"
 #include "CrashHandler.h"
 #include "GMBench.h"
+#include "PerfCounters.h"
 #include "ProcStats.h"
 #include "RecordingBench.h"
 #include "ResultsWriter.h"
 #include "SKPAnimationBench.h"
 #include "SKPBench.h"
+#include "SkAACostModel.h"
+#include "SkAllocationCounter.h"
 #include "SkAndroidCodec.h"
 #include "SkAutoMalloc.h"
 #include "SkBBoxHierarchy.h"
@@ -35,10 +39,13 @@
 #include "SkDebugfTracer.h"
 #include "SkEventTracingPriv.h"
 #include "SkGraphics.h"
+#include "SkImageFilterPriv.h"
+#include "SkJSONWriter.h"
 #include "SkLeanWindows.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkPictureRecorder.h"
+#include "SkRasterPipeline.h"
 #include "SkScan.h"
 #include "SkString.h"
 #include "SkSurface.h"
@@ -51,8 +58,10 @@
 #include "SkSVGDOM.h"
 #endif  // SK_XML
 
+#include <atomic>
 #include <stdlib.h>
 #include <thread>
+#include <vector>
 
 extern bool gSkForceRasterPipelineBlitter;
 
@@ -135,12 +144,24 @@ DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
 DEFINE_bool(gpuStatsDump, false, "Dump GPU states after each benchmark to json");
 DEFINE_bool(keepAlive, false, "Print a message every so often so that we don't time out");
 DEFINE_bool(csv, false, "Print status in CSV format");
+DEFINE_bool(calibrateAACost, false, "Fit SkAACostModel to this machine before running benches, "
+                                    "print its coefficients, and pick AA scan converters with it.");
 DEFINE_string(sourceType, "",
         "Apply usual --match rules to source type: bench, gm, skp, image, etc.");
 DEFINE_string(benchType,  "",
         "Apply usual --match rules to bench type: micro, recording, piping, playback, skcodec, etc.");
 
 DEFINE_bool(forceRasterPipeline, false, "sets gSkForceRasterPipelineBlitter");
+DEFINE_bool(fuseStages, true, "If false, don't fuse SkRasterPipeline stages; "
+                              "sets gSkRasterPipelineFuseStages");
+DEFINE_string(stageProfile, "", "If set, profile SkRasterPipeline stages and write the totals "
+                                "for the whole run to this JSON file.");
+DEFINE_int32(benchThreads, 1, "If >1, also run thread-safe CPU benches on this many threads at "
+                              "once, and report their throughput and scaling vs. one thread.");
+DEFINE_bool(countAllocations, false, "Count heap allocations and bytes allocated per loop, and "
+                                     "peak heap growth, in an extra untimed run of each bench.");
+DEFINE_bool(perfCounters, false, "Count cycles, instructions, cache and branch misses, and context "
+                                 "switches per loop while sampling each bench.  Linux only.");
 
 static double now_ms() { return SkTime::GetNSecs() * 1e-6; }
 
@@ -264,6 +285,60 @@ static double time(int loops, Benchmark* bench, Target* target) {
     return elapsed;
 }
 
+// Runs bench on threads threads at once, thread 0 drawing into target's canvas and the others
+// into their own, and returns how long it took all of them to draw loops times.
+static double time_threaded(int threads, int loops, Benchmark* bench, Target* target) {
+    SkTArray<SkCanvas*> canvases;
+    SkTArray<sk_sp<SkSurface>> surfaces;
+    canvases.push_back(target->getCanvas());
+    for (int t = 1; t < threads; t++) {
+        SkCanvas* canvas = nullptr;
+        if (canvases[0]) {
+            surfaces.push_back(SkSurface::MakeRaster(canvases[0]->imageInfo()));
+            canvas = surfaces.back()->getCanvas();
+        }
+        canvases.push_back(canvas);
+    }
+    for (SkCanvas* canvas : canvases) {
+        if (canvas) {
+            canvas->clear(SK_ColorWHITE);
+        }
+    }
+
+    std::atomic<int> waiting{threads};
+    SkAutoTMalloc<double> finished(threads);
+    auto draw = [&](int t) {
+        // Start together, so the threads contend for the whole run.
+        waiting--;
+        while (waiting > 0) {
+            std::this_thread::yield();
+        }
+        bench->draw(loops, canvases[t]);
+        if (canvases[t]) {
+            canvases[t]->flush();
+        }
+        finished[t] = now_ms();
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(draw, t);
+    }
+    while (waiting > 1) {
+        std::this_thread::yield();
+    }
+    double start = now_ms();
+    draw(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double end = start;
+    for (int t = 0; t < threads; t++) {
+        end = SkTMax(end, finished[t]);
+    }
+    return end - start;
+}
+
 static double estimate_timer_overhead() {
     double overhead = 0;
     for (int i = 0; i < FLAGS_overheadLoops; i++) {
@@ -1212,7 +1287,7 @@ int main(int argc, char** argv) {
     const double overhead = estimate_timer_overhead();
     SkDebugf("Timer overhead: %s\n", HUMANIZE(overhead));
 
-    SkTArray<double> samples;
+    SkTArray<double> samples, threadedSamples;
 
     if (kAutoTuneLoops != FLAGS_loops) {
         SkDebugf("Fixed number of loops; times would only be misleading so we won't print them.\n");
@@ -1235,6 +1310,24 @@ int main(int argc, char** argv) {
 
     gSkUseAnalyticAA = FLAGS_analyticAA;
     gSkUseDeltaAA = FLAGS_deltaAA;
+    gSkDAABandEdgeThreshold = FLAGS_daaBandEdges;
+    gSkRasterBlurDownsampleSigma = FLAGS_blurDownsampleSigma;
+    gSkUseAACostModel = FLAGS_aaCostModel;
+
+    if (!FLAGS_aaCostCoefficients.isEmpty()) {
+        SkAACostModel model = SkAACostModel::Get();
+        if (!model.parse(FLAGS_aaCostCoefficients[0])) {
+            SkDebugf("Could not parse --aaCostCoefficients %s\n", FLAGS_aaCostCoefficients[0]);
+            return 1;
+        }
+        SkAACostModel::Set(model);
+    }
+    if (FLAGS_calibrateAACost) {
+        SkAACostModel model = sk_tools::calibrateAACostModel();
+        SkAACostModel::Set(model);
+        gSkUseAACostModel = true;
+        SkDebugf("--aaCostCoefficients %s\n", model.toString().c_str());
+    }
 
     if (FLAGS_forceDeltaAA) {
         gSkForceDeltaAA = true;
@@ -1245,6 +1338,19 @@ int main(int argc, char** argv) {
     if (FLAGS_forceRasterPipeline) {
         gSkForceRasterPipelineBlitter = true;
     }
+    gSkRasterPipelineFuseStages = FLAGS_fuseStages;
+    if (!FLAGS_stageProfile.isEmpty()) {
+        gSkRasterPipelineProfileStages = true;
+    }
+
+    std::unique_ptr<sk_tools::PerfCounters> perfCounters;
+    if (FLAGS_perfCounters) {
+        perfCounters.reset(new sk_tools::PerfCounters);
+        if (!perfCounters->isValid()) {
+            SkDebugf("No performance counters are available; ignoring --perfCounters.\n");
+            perfCounters.reset();
+        }
+    }
 
     int runs = 0;
     BenchmarkStream benchStream;
@@ -1303,6 +1409,9 @@ int main(int argc, char** argv) {
                 } while (now_ms() < stop);
             }
 
+            if (perfCounters) {
+                perfCounters->start();
+            }
             if (FLAGS_ms) {
                 samples.reset();
                 auto stop = now_ms() + FLAGS_ms;
@@ -1315,6 +1424,29 @@ int main(int argc, char** argv) {
                     samples[s] = time(loops, bench.get(), target) / loops;
                 }
             }
+            if (perfCounters) {
+                perfCounters->stop();
+            }
+
+            SkAllocationCounter::Counts allocations = {0, 0, 0};
+            if (FLAGS_countAllocations) {
+                SkAllocationCounter::SetEnabled(true);
+                SkAllocationCounter::Reset();
+                time(loops, bench.get(), target);
+                allocations = SkAllocationCounter::Get();
+                SkAllocationCounter::SetEnabled(false);
+            }
+
+            // Time each loop of all the threads together, so ideal scaling matches one thread.
+            threadedSamples.reset();
+            if (FLAGS_benchThreads > 1 && bench->isThreadSafe() &&
+                (Benchmark::kNonRendering_Backend == target->config.backend ||
+                 Benchmark::kRaster_Backend == target->config.backend)) {
+                for (int s = 0; s < SkTMax(samples.count(), 1); s++) {
+                    threadedSamples.push_back(
+                            time_threaded(FLAGS_benchThreads, loops, bench.get(), target) / loops);
+                }
+            }
 
 #if SK_SUPPORT_GPU
             SkTArray<SkString> keys;
@@ -1343,6 +1475,45 @@ int main(int argc, char** argv) {
             target->fillOptions(log.get());
             log->metric("min_ms",    stats.min);
             log->metrics("samples",    samples);
+            SkString perLoop;
+            if (FLAGS_countAllocations) {
+                log->metric("allocations", (double)allocations.fAllocations / loops);
+                log->metric("allocated_bytes", (double)allocations.fBytes / loops);
+                log->metric("peak_heap_bytes", allocations.fPeakBytes);
+                perLoop.appendf("\tallocations %.4g\tallocated_bytes %.4g\tpeak_heap_bytes %lld",
+                                (double)allocations.fAllocations / loops,
+                                (double)allocations.fBytes / loops,
+                                (long long)allocations.fPeakBytes);
+            }
+            if (perfCounters) {
+                using sk_tools::PerfCounters;
+                const double totalLoops = (double)loops * samples.count();
+                for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+                    auto counter = (PerfCounters::Counter)c;
+                    double count = perfCounters->value(counter);
+                    if (count >= 0) {
+                        log->metric(PerfCounters::Name(counter), count / totalLoops);
+                        perLoop.appendf("\t%s %.4g", PerfCounters::Name(counter),
+                                        count / totalLoops);
+                    }
+                }
+                double cycles = perfCounters->value(PerfCounters::kCycles),
+                       instructions = perfCounters->value(PerfCounters::kInstructions);
+                if (cycles > 0 && instructions >= 0) {
+                    log->metric("ipc", instructions / cycles);
+                    perLoop.appendf("\tipc %.2f", instructions / cycles);
+                }
+            }
+            double scaling = 0;
+            if (!threadedSamples.empty()) {
+                Stats threadedStats(threadedSamples);
+                // 1 when each thread runs as fast as one alone, 1/N when they fully serialize.
+                scaling = stats.median / threadedStats.median;
+                log->metric("threads", FLAGS_benchThreads);
+                log->metric("threaded_min_ms", threadedStats.min);
+                log->metric("scaling_efficiency", scaling);
+                log->metrics("threaded_samples", threadedSamples);
+            }
 #if SK_SUPPORT_GPU
             if (gpuStatsDump) {
                 // dump to json, only SKPBench currently returns valid keys / values
@@ -1402,6 +1573,22 @@ int main(int argc, char** argv) {
                         , bench->getUniqueName()
                         );
             }
+            if (!perLoop.isEmpty() && kAutoTuneLoops == FLAGS_loops) {
+                SkDebugf("\tper loop:%s\t%s\t%s\n"
+                         , perLoop.c_str()
+                         , config
+                         , bench->getUniqueName()
+                         );
+            }
+            if (!threadedSamples.empty() && kAutoTuneLoops == FLAGS_loops) {
+                SkDebugf("\t%d threads: %.2fx throughput, %.0f%% scaling efficiency\t%s\t%s\n"
+                         , FLAGS_benchThreads
+                         , FLAGS_benchThreads * scaling
+                         , 100 * scaling
+                         , config
+                         , bench->getUniqueName()
+                         );
+            }
 
 #if SK_SUPPORT_GPU
             if (FLAGS_gpuStats && Benchmark::kGPU_Backend == configs[i].backend) {
@@ -1426,5 +1613,11 @@ int main(int argc, char** argv) {
     log->config("meta");
     log->metric("max_rss_mb", sk_tools::getMaxResidentSetSizeMB());
 
+    if (!FLAGS_stageProfile.isEmpty()) {
+        SkFILEWStream stream(FLAGS_stageProfile[0]);
+        SkJSONWriter writer(&stream, SkJSONWriter::Mode::kPretty);
+        SkRasterPipeline::DumpStageProfile(&writer);
+    }
+
     return 0;
 }
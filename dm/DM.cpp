@@ -9,6 +9,8 @@
 #include "DMSrcSink.h"
 #include "ProcStats.h"
 #include "Resources.h"
+#include "SkAACostModel.h"
+#include "SkAllocationCounter.h"
 #include "SkBBHFactory.h"
 #include "SkChecksum.h"
 #include "SkChromeTracingTracer.h"
@@ -27,6 +29,7 @@
 #include "SkFontMgrPriv.h"
 #include "SkGraphics.h"
 #include "SkHalf.h"
+#include "SkImageFilterPriv.h"
 #include "SkLeanWindows.h"
 #include "SkMD5.h"
 #include "SkMutex.h"
@@ -34,6 +37,7 @@
 #include "SkOSPath.h"
 #include "SkPM4fPriv.h"
 #include "SkPngEncoder.h"
+#include "SkRasterPipeline.h"
 #include "SkScan.h"
 #include "SkSpinlock.h"
 #include "SkTestFontMgr.h"
@@ -96,6 +100,8 @@ DEFINE_int32(shard,  0, "Which shard do I run?");
 
 DEFINE_string(mskps, "", "Directory to read mskps from, or a single mskp file.");
 DEFINE_bool(forceRasterPipeline, false, "sets gSkForceRasterPipelineBlitter");
+DEFINE_bool(fuseStages, true, "If false, don't fuse SkRasterPipeline stages; "
+                              "sets gSkRasterPipelineFuseStages");
 
 DEFINE_bool(ignoreSigInt, false, "ignore SIGINT signals during test execution");
 
@@ -103,6 +109,14 @@ DEFINE_string(dont_write, "", "File extensions to skip writing to --writePath.")
 
 DEFINE_bool(gdi, false, "On Windows, use GDI instead of DirectWrite for font rendering.");
 
+DEFINE_bool(countAllocations, false, "Print the heap allocations, bytes allocated, and peak heap "
+                                     "growth of each task's thread while it runs.");
+
+DEFINE_int32(timings, 0, "If > 0, draw each src into each sink this many times, and record the "
+                         "time each draw took, with the first draw's heap allocations and peak "
+                         "heap growth, in dm.json.  Compare runs with "
+                         "tools/compare_dm_timings.py.");
+
 using namespace DM;
 using sk_gpu_test::GrContextFactory;
 using sk_gpu_test::GLTestContext;
@@ -201,6 +215,24 @@ static void start(const char* config, const char* src, const char* srcOptions, c
     gRunning.push_back({id,SkGetThreadID()});
 }
 
+static void start_counting_allocations() {
+    if (FLAGS_countAllocations || FLAGS_timings > 0) {
+        SkAllocationCounter::Reset();
+    }
+}
+
+static void report_allocations(const char* config, const char* src, const char* srcOptions,
+                               const char* name) {
+    if (FLAGS_countAllocations) {
+        SkAllocationCounter::Counts counts = SkAllocationCounter::Get();
+        info("%s %s %s %s: %llu allocations, %llu bytes, %lld peak bytes\n",
+             config, src, srcOptions, name,
+             (unsigned long long)counts.fAllocations,
+             (unsigned long long)counts.fBytes,
+             (long long)counts.fPeakBytes);
+    }
+}
+
 static void find_culprit() {
     // Assumes gMutex is locked.
     SkThreadID thisThread = SkGetThreadID();
@@ -1093,7 +1125,13 @@ struct Task {
             SkDynamicMemoryWStream stream;
             start(task.sink.tag.c_str(), task.src.tag.c_str(),
                   task.src.options.c_str(), name.c_str());
+            start_counting_allocations();
+            const double startNs = SkTime::GetNSecs();
             Error err = task.sink->draw(*task.src, &bitmap, &stream, &log);
+            const double drawMs = (SkTime::GetNSecs() - startNs) * 1e-6;
+            const SkAllocationCounter::Counts allocations = SkAllocationCounter::Get();
+            report_allocations(task.sink.tag.c_str(), task.src.tag.c_str(),
+                               task.src.options.c_str(), name.c_str());
             if (!log.isEmpty()) {
                 info("%s %s %s %s:\n%s\n", task.sink.tag.c_str()
                                          , task.src.tag.c_str()
@@ -1116,6 +1154,10 @@ struct Task {
                 }
             }
 
+            if (FLAGS_timings > 0 && err.isEmpty()) {
+                RecordTimings(task, name, drawMs, allocations);
+            }
+
             // We're likely switching threads here, so we must capture by value, [=] or [foo,bar].
             SkStreamAsset* data = stream.detachAsStream().release();
             gDefinitelyThreadSafeWork.add([task,name,bitmap,data]{
@@ -1176,6 +1218,31 @@ struct Task {
         done(task.sink.tag.c_str(), task.src.tag.c_str(), task.src.options.c_str(), name.c_str());
     }
 
+    // Draws task another FLAGS_timings-1 times, throwing the results away, and records the
+    // time each draw took along with the first draw's.
+    static void RecordTimings(const Task& task, const SkString& name, double firstDrawMs,
+                              const SkAllocationCounter::Counts& allocations) {
+        JsonWriter::TimingResult result;
+        result.name          = name;
+        result.config        = task.sink.tag;
+        result.sourceType    = task.src.tag;
+        result.sourceOptions = task.src.options;
+        result.allocations   = allocations.fAllocations;
+        result.peakHeapBytes = allocations.fPeakBytes;
+        result.ms.push_back(firstDrawMs);
+        for (int i = 1; i < FLAGS_timings; i++) {
+            SkBitmap bitmap;
+            SkDynamicMemoryWStream stream;
+            SkString log;
+            const double startNs = SkTime::GetNSecs();
+            if (!task.sink->draw(*task.src, &bitmap, &stream, &log).isEmpty()) {
+                break;
+            }
+            result.ms.push_back((SkTime::GetNSecs() - startNs) * 1e-6);
+        }
+        JsonWriter::AddTimingResult(result);
+    }
+
     static void WriteToDisk(const Task& task,
                             SkString md5,
                             const char* ext,
@@ -1294,7 +1361,9 @@ static void run_test(skiatest::Test test, const GrContextOptions& grCtxOptions)
         test.modifyGrContextOptions(&options);
 
         start("unit", "test", "", test.name);
+        start_counting_allocations();
         test.run(&reporter, options);
+        report_allocations("unit", "test", "", test.name);
     }
     done("unit", "test", "", test.name);
 }
@@ -1332,6 +1401,7 @@ int main(int argc, char** argv) {
 #endif
 
     initializeEventTracingForTools();
+    SkAllocationCounter::SetEnabled(FLAGS_countAllocations || FLAGS_timings > 0);
 
 #if !defined(SK_BUILD_FOR_GOOGLE3) && defined(SK_BUILD_FOR_IOS)
     cd_Documents();
@@ -1341,6 +1411,18 @@ int main(int argc, char** argv) {
 
     gSkUseAnalyticAA = FLAGS_analyticAA;
     gSkUseDeltaAA = FLAGS_deltaAA;
+    gSkDAABandEdgeThreshold = FLAGS_daaBandEdges;
+    gSkRasterBlurDownsampleSigma = FLAGS_blurDownsampleSigma;
+    gSkUseAACostModel = FLAGS_aaCostModel;
+
+    if (!FLAGS_aaCostCoefficients.isEmpty()) {
+        SkAACostModel model = SkAACostModel::Get();
+        if (!model.parse(FLAGS_aaCostCoefficients[0])) {
+            info("Could not parse --aaCostCoefficients %s\n", FLAGS_aaCostCoefficients[0]);
+            return 1;
+        }
+        SkAACostModel::Set(model);
+    }
 
     if (FLAGS_forceAnalyticAA) {
         gSkForceAnalyticAA = true;
@@ -1351,6 +1433,7 @@ int main(int argc, char** argv) {
     if (FLAGS_forceRasterPipeline) {
         gSkForceRasterPipelineBlitter = true;
     }
+    gSkRasterPipelineFuseStages = FLAGS_fuseStages;
 
     // The bots like having a verbose.log to upload, so always touch the file even if --verbose.
     if (!FLAGS_writePath.isEmpty()) {
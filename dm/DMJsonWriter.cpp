@@ -27,6 +27,14 @@ void JsonWriter::AddBitmapResult(const BitmapResult& result) {
     gBitmapResults.push_back(result);
 }
 
+SkTArray<JsonWriter::TimingResult> gTimingResults;
+SK_DECLARE_STATIC_MUTEX(gTimingResultLock);
+
+void JsonWriter::AddTimingResult(const TimingResult& result) {
+    SkAutoMutexAcquire lock(gTimingResultLock);
+    gTimingResults.push_back(result);
+}
+
 SkTArray<skiatest::Failure> gFailures;
 SK_DECLARE_STATIC_MUTEX(gFailureLock);
 
@@ -70,6 +78,26 @@ void JsonWriter::DumpJson() {
         }
     }
 
+    {
+        SkAutoMutexAcquire lock(gTimingResultLock);
+        for (const TimingResult& timing : gTimingResults) {
+            Json::Value result;
+            result["key"]["name"]        = timing.name.c_str();
+            result["key"]["config"]      = timing.config.c_str();
+            result["key"]["source_type"] = timing.sourceType.c_str();
+            if (!timing.sourceOptions.isEmpty()) {
+                result["key"]["source_options"] = timing.sourceOptions.c_str();
+            }
+            for (double ms : timing.ms) {
+                result["ms"].append(ms);
+            }
+            result["allocations"]     = (Json::UInt64)timing.allocations;
+            result["peak_heap_bytes"] = (Json::Int64)timing.peakHeapBytes;
+
+            root["timings"].append(result);
+        }
+    }
+
     {
         SkAutoMutexAcquire lock(gFailureLock);
         for (int i = 0; i < gFailures.count(); i++) {
@@ -9,6 +9,7 @@
 #define DMJsonWriter_DEFINED
 
 #include "SkString.h"
+#include "SkTArray.h"
 #include "Test.h"
 
 namespace DM {
@@ -32,11 +33,29 @@ public:
         bool gammaCorrect;        // Old configs are not gamma correct, some new ones are.
     };
 
+    /**
+     *  How long drawing a single Src into a single Sink took, recorded with --timings.
+     */
+    struct TimingResult {
+        SkString name;            // Same as BitmapResult.
+        SkString config;
+        SkString sourceType;
+        SkString sourceOptions;
+        SkTArray<double> ms;      // Time each draw took, first draw first.
+        uint64_t allocations;     // Heap allocations made by the first draw.
+        int64_t peakHeapBytes;    // Most heap the first draw had allocated at once.
+    };
+
     /**
      *  Add a result to the end of the list of results.
      */
     static void AddBitmapResult(const BitmapResult&);
 
+    /**
+     *  Add a timing to the end of the list of timings.
+     */
+    static void AddTimingResult(const TimingResult&);
+
     /**
      *  Add a Failure from a Test.
      */
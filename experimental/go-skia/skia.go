@@ -117,6 +117,27 @@ func (c *Canvas) DrawPath(path *Path, paint *Paint) {
 	C.sk_canvas_draw_path(c.ptr, path.ptr, paint.ptr)
 }
 
+// DrawRects draws each of rects with paints[paintIndices[i]], or with
+// paints[0] if paintIndices is nil, crossing into C once for all of them.
+func (c *Canvas) DrawRects(rects []Rect, paintIndices []int32, paints []*Paint) {
+	if len(rects) == 0 || len(paints) == 0 {
+		return
+	}
+	if paintIndices != nil && len(paintIndices) < len(rects) {
+		panic("skia: DrawRects needs a paint index per rect")
+	}
+	cPaints := make([]*C.sk_paint_t, len(paints))
+	for i, p := range paints {
+		cPaints[i] = p.ptr
+	}
+	var cIndices *C.int32_t
+	if paintIndices != nil {
+		cIndices = (*C.int32_t)(unsafe.Pointer(&paintIndices[0]))
+	}
+	C.sk_canvas_draw_rects(c.ptr, rects[0].cPointer(), cIndices, C.int(len(rects)),
+		&cPaints[0], C.int(len(cPaints)))
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Paint
 //////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,7 @@
 #include "SkSGMerge.h"
 #include "SkSGOpacityEffect.h"
 #include "SkSGPath.h"
+#include "SkSGPictureCache.h"
 #include "SkSGRect.h"
 #include "SkSGRoundEffect.h"
 #include "SkSGScene.h"
@@ -54,11 +55,22 @@ namespace {
 
 using AssetMap = SkTHashMap<SkString, json::ValueRef>;
 
+// What pre-compositions built lazily need from the json, once Animation::Make() has returned.
+struct LazyScope : public SkNVRefCnt<LazyScope> {
+    explicit LazyScope(sk_sp<json::Document> document) : fDocument(std::move(document)) {}
+
+    const sk_sp<json::Document> fDocument;
+    AssetMap                    fAssets;
+    Animation::Stats            fStats = {}; // Load stats for the lazily built layers go here.
+};
+
 struct AttachContext {
     const ResourceProvider& fResources;
     const AssetMap&         fAssets;
     const float             fFrameRate;
     sksg::AnimatorList&     fAnimators;
+    Animation::Stats*       fStats;
+    LazyScope*              fLazyScope;
 };
 
 bool LogFail(const json::ValueRef& json, const char* msg) {
@@ -712,6 +724,12 @@ sk_sp<sksg::RenderNode> AttachNestedAnimation(const char* path, AttachContext* c
             SkASSERT(fAnimation);
         }
 
+        void animationTick(SkMSec ms) {
+            fAnimation->animationTick(ms);
+            // The nested scene doesn't report its damage, so all of it is damaged.
+            this->invalidate();
+        }
+
     protected:
         SkRect onRevalidate(sksg::InvalidationController*, const SkMatrix&) override {
             return SkRect::MakeSize(fAnimation->size());
@@ -727,10 +745,10 @@ sk_sp<sksg::RenderNode> AttachNestedAnimation(const char* path, AttachContext* c
 
     class SkottieAnimatorAdapter final : public sksg::Animator {
     public:
-        SkottieAnimatorAdapter(sk_sp<Animation> animation, float frameRate)
-            : fAnimation(std::move(animation))
+        SkottieAnimatorAdapter(sk_sp<SkottieSGAdapter> adapter, float frameRate)
+            : fAdapter(std::move(adapter))
             , fFrameRate(frameRate) {
-            SkASSERT(fAnimation);
+            SkASSERT(fAdapter);
             SkASSERT(fFrameRate > 0);
         }
 
@@ -738,12 +756,12 @@ sk_sp<sksg::RenderNode> AttachNestedAnimation(const char* path, AttachContext* c
         void onTick(float t) {
             // map back from frame # to ms.
             const auto t_ms = t * 1000 / fFrameRate;
-            fAnimation->animationTick(t_ms);
+            fAdapter->animationTick(t_ms);
         }
 
     private:
-        const sk_sp<Animation> fAnimation;
-        const float            fFrameRate;
+        const sk_sp<SkottieSGAdapter> fAdapter;
+        const float                   fFrameRate;
     };
 
     const auto resStream  = ctx->fResources.openStream(path);
@@ -758,10 +776,88 @@ sk_sp<sksg::RenderNode> AttachNestedAnimation(const char* path, AttachContext* c
         return nullptr;
     }
 
-    ctx->fAnimators.push_back(skstd::make_unique<SkottieAnimatorAdapter>(animation,
+    auto adapter = sk_make_sp<SkottieSGAdapter>(std::move(animation));
+    ctx->fAnimators.push_back(skstd::make_unique<SkottieAnimatorAdapter>(adapter,
                                                                          ctx->fFrameRate));
 
-    return sk_make_sp<SkottieSGAdapter>(std::move(animation));
+    return std::move(adapter);
+}
+
+// Whether building the composition would open any resources: images or nested animations.
+bool UsesResources(const json::ValueRef& comp, const AssetMap& assets, int depth) {
+    // Deeper than any sensible nesting; also stops cycles.
+    static constexpr int kMaxDepth = 16;
+    if (depth > kMaxDepth) {
+        return true;
+    }
+
+    for (const json::ValueRef jlayer : comp["layers"]) {
+        const auto type = jlayer["ty"].toDefault<int>(-1);
+        if (type == 2) {
+            return true;
+        }
+        SkString refId;
+        if (type == 0 && jlayer["refId"].to(&refId)) {
+            if (refId.startsWith("$")) {
+                return true;
+            }
+            const auto* precomp = assets.find(refId);
+            if (precomp && UsesResources(*precomp, assets, depth + 1)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Builds a pre-composition the first time its layer is active, rather than when the animation
+// is loaded. Layers only tick their animators while they're active.
+sk_sp<sksg::RenderNode> AttachLazyComposition(const json::ValueRef& comp, AttachContext* ctx) {
+    class LazyCompositionAnimator final : public sksg::Animator {
+    public:
+        LazyCompositionAnimator(sk_sp<LazyScope> scope, const json::ValueRef& comp,
+                                float frameRate, sk_sp<sksg::Group> group)
+            : fScope(std::move(scope))
+            , fComp(comp)
+            , fFrameRate(frameRate)
+            , fGroup(std::move(group)) {}
+
+    protected:
+        void onTick(float t) override {
+            if (fScope) {
+                // Compositions that use resources are never lazy.
+                class NullResourceProvider final : public ResourceProvider {
+                    std::unique_ptr<SkStream> openStream(const char[]) const override {
+                        return nullptr;
+                    }
+                };
+                NullResourceProvider resources;
+                AttachContext ctx = { resources, fScope->fAssets, fFrameRate, fAnimators,
+                                      &fScope->fStats, fScope.get() };
+                if (auto root = AttachComposition(fComp, &ctx)) {
+                    fGroup->addChild(std::move(root));
+                }
+                fScope.reset();
+            }
+
+            for (const auto& animator : fAnimators) {
+                animator->tick(t);
+            }
+        }
+
+    private:
+        sk_sp<LazyScope>         fScope;  // Until the composition is built.
+        const json::ValueRef     fComp;
+        const float              fFrameRate;
+        const sk_sp<sksg::Group> fGroup;
+        sksg::AnimatorList       fAnimators;
+    };
+
+    auto group = sksg::Group::Make();
+    ctx->fAnimators.push_back(skstd::make_unique<LazyCompositionAnimator>(
+            sk_ref_sp(ctx->fLazyScope), comp, ctx->fFrameRate, group));
+
+    return std::move(group);
 }
 
 sk_sp<sksg::RenderNode> AttachCompLayer(const json::ValueRef& jlayer, AttachContext* ctx,
@@ -793,6 +889,10 @@ sk_sp<sksg::RenderNode> AttachCompLayer(const json::ValueRef& jlayer, AttachCont
         return nullptr;
     }
 
+    if (ctx->fLazyScope && !UsesResources(*comp, ctx->fAssets, 0)) {
+        return AttachLazyComposition(*comp, ctx);
+    }
+
     // TODO: cycle detection
     return AttachComposition(*comp, ctx);
 }
@@ -1052,7 +1152,9 @@ sk_sp<sksg::RenderNode> AttachLayer(const json::ValueRef& jlayer, AttachLayerCon
     AttachContext local_ctx = { layerCtx->fCtx->fResources,
                                 layerCtx->fCtx->fAssets,
                                 layerCtx->fCtx->fFrameRate,
-                                layer_animators};
+                                layer_animators,
+                                layerCtx->fCtx->fStats,
+                                layerCtx->fCtx->fLazyScope};
 
     // Layer attachers may adjust these.
     float time_bias  = 0,
@@ -1072,6 +1174,15 @@ sk_sp<sksg::RenderNode> AttachLayer(const json::ValueRef& jlayer, AttachLayerCon
     // Optional layer mask.
     layer = AttachMask(jlayer["masksProperties"], &local_ctx, std::move(layer));
 
+    if (layer) {
+        local_ctx.fStats->fLayerCount++;
+        // Nothing below the layer transform animates: render it from a picture.
+        if (layer_animators.empty()) {
+            layer = sksg::PictureCache::Make(std::move(layer));
+            local_ctx.fStats->fStaticLayerCount++;
+        }
+    }
+
     // Optional layer transform.
     if (auto layerMatrix = layerCtx->AttachLayerMatrix(jlayer)) {
         layer = sksg::Transform::Make(std::move(layer), std::move(layerMatrix));
@@ -1206,8 +1317,8 @@ sk_sp<Animation> Animation::Make(SkStream* stream, const ResourceProvider& res,
     stats->fJsonSize = stream->getLength();
     const auto t0 = SkTime::GetMSecs();
 
-    const json::Document doc(stream);
-    const auto json = doc.root();
+    auto doc = sk_make_sp<json::Document>(stream);
+    const auto json = doc->root();
     if (!json.isObject())
         return nullptr;
 
@@ -1226,7 +1337,7 @@ sk_sp<Animation> Animation::Make(SkStream* stream, const ResourceProvider& res,
     }
 
     const auto anim =
-        sk_sp<Animation>(new Animation(res, std::move(version), size, fps, json, stats));
+        sk_sp<Animation>(new Animation(res, std::move(version), size, fps, std::move(doc), stats));
     const auto t2 = SkTime::GetMSecs();
     stats->fSceneParseTimeMS = t2 - t1;
     stats->fTotalLoadTimeMS  = t2 - t0;
@@ -1262,23 +1373,26 @@ sk_sp<Animation> Animation::MakeFromFile(const char path[], const ResourceProvid
 }
 
 Animation::Animation(const ResourceProvider& resources,
-                     SkString version, const SkSize& size, SkScalar fps, const json::ValueRef& json,
-                     Stats* stats)
+                     SkString version, const SkSize& size, SkScalar fps,
+                     sk_sp<json::Document> doc, Stats* stats)
     : fVersion(std::move(version))
     , fSize(size)
     , fFrameRate(fps)
-    , fInPoint(json["ip"].toDefault(0.0f))
-    , fOutPoint(SkTMax(json["op"].toDefault(SK_ScalarMax), fInPoint)) {
+    , fInPoint(doc->root()["ip"].toDefault(0.0f))
+    , fOutPoint(SkTMax(doc->root()["op"].toDefault(SK_ScalarMax), fInPoint)) {
+
+    const auto json = doc->root();
 
-    AssetMap assets;
+    // Pre-compositions which are built lazily hold on to the json.
+    auto scope = sk_make_sp<LazyScope>(std::move(doc));
     for (const json::ValueRef asset : json["assets"]) {
         if (asset.isObject()) {
-            assets.set(asset["id"].toDefault(SkString()), asset);
+            scope->fAssets.set(asset["id"].toDefault(SkString()), asset);
         }
     }
 
     sksg::AnimatorList animators;
-    AttachContext ctx = { resources, assets, fFrameRate, animators };
+    AttachContext ctx = { resources, scope->fAssets, fFrameRate, animators, stats, scope.get() };
     auto root = AttachComposition(json, &ctx);
 
     stats->fAnimatorCount = animators.size();
@@ -1310,16 +1424,38 @@ void Animation::render(SkCanvas* canvas, const SkRect* dstR) const {
     fScene->render(canvas);
 }
 
+SkIRect Animation::renderDamage(SkCanvas* canvas, const SkRect* dstR, SkColor background) const {
+    if (!fScene)
+        return SkIRect::MakeEmpty();
+
+    SkAutoCanvasRestore restore(canvas, true);
+    const SkRect srcR = SkRect::MakeSize(this->size());
+    if (dstR) {
+        canvas->concat(SkMatrix::MakeRectToRect(srcR, *dstR, SkMatrix::kCenter_ScaleToFit));
+    }
+    canvas->clipRect(srcR);
+    return fScene->renderDamage(canvas, background);
+}
+
 void Animation::animationTick(SkMSec ms) {
+    // 't' in the BM model really means 'frame #'
+    this->seekFrame(static_cast<float>(ms) * fFrameRate / 1000);
+}
+
+void Animation::seekFrame(SkScalar t) {
     if (!fScene)
         return;
 
-    // 't' in the BM model really means 'frame #'
-    auto t = static_cast<float>(ms) * fFrameRate / 1000;
+    fScene->animate(fInPoint + std::fmod(t, fOutPoint - fInPoint));
+}
 
-    t = fInPoint + std::fmod(t, fOutPoint - fInPoint);
+SkRect Animation::revalidate() {
+    if (!fScene)
+        return SkRect::MakeEmpty();
 
-    fScene->animate(t);
+    sksg::InvalidationController ic;
+    fScene->revalidate(&ic);
+    return ic.bounds();
 }
 
 } // namespace skottie
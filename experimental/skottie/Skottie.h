@@ -8,6 +8,8 @@
 #ifndef Skottie_DEFINED
 #define Skottie_DEFINED
 
+#include "SkColor.h"
+#include "SkRect.h"
 #include "SkRefCnt.h"
 #include "SkSize.h"
 #include "SkString.h"
@@ -16,14 +18,13 @@
 #include <memory>
 
 class SkCanvas;
-struct SkRect;
 class SkStream;
 
 namespace sksg { class Scene;  }
 
 namespace skottie {
 
-namespace json { class ValueRef; }
+namespace json { class Document; }
 
 class ResourceProvider : public SkNoncopyable {
 public:
@@ -39,7 +40,9 @@ public:
                fJsonParseTimeMS,
                fSceneParseTimeMS;
         size_t fJsonSize,
-               fAnimatorCount;
+               fAnimatorCount,
+               fLayerCount,
+               fStaticLayerCount; // Layers whose content is rendered from a cached picture.
     };
 
     static sk_sp<Animation> Make(SkStream*, const ResourceProvider&, Stats* = nullptr);
@@ -50,8 +53,21 @@ public:
 
     void render(SkCanvas*, const SkRect* dst = nullptr) const;
 
+    // Like render(), but only redraws what changed since the last render or revalidate(),
+    // over the previous frame that the canvas must still hold. See sksg::Scene::renderDamage().
+    SkIRect renderDamage(SkCanvas*, const SkRect* dst = nullptr,
+                         SkColor background = SK_ColorTRANSPARENT) const;
+
     void animationTick(SkMSec);
 
+    // Seeks to frame t, counted from the in point and wrapping at the out point.
+    void seekFrame(SkScalar t);
+
+    // Brings the scene up to date with the last tick or seek, and returns the bounds of
+    // everything that changed since the previous call, in the animation's coordinates.
+    // render() doesn't need this; it lets callers redraw only what changed.
+    SkRect revalidate();
+
     const SkString& version() const { return fVersion;   }
     const SkSize&      size() const { return fSize;      }
          SkScalar frameRate() const { return fFrameRate; }
@@ -62,7 +78,7 @@ public:
 
 private:
     Animation(const ResourceProvider&, SkString ver, const SkSize& size, SkScalar fps,
-              const json::ValueRef&, Stats*);
+              sk_sp<json::Document>, Stats*);
 
     SkString                     fVersion;
     SkSize                       fSize;
@@ -50,11 +50,22 @@ protected:
 
     const KeyframeRec& frame(float t) {
         if (!fCachedRec || !fCachedRec->contains(t)) {
-            fCachedRec = findFrame(t);
+            // Sequential playback mostly moves on to the next frame.
+            const auto* next = fCachedRec ? fCachedRec + 1 : nullptr;
+            fCachedRec = next && next <= &fRecs.back() && next->contains(t) ? next
+                                                                            : findFrame(t);
         }
         return *fCachedRec;
     }
 
+    // The index of the value at t, if it's a key frame value rather than an interpolated one.
+    int valueIndex(const KeyframeRec& rec, float t) const {
+        if (rec.isConstant() || t <= rec.t0) {
+            return rec.vidx0;
+        }
+        return t >= rec.t1 ? rec.vidx1 : -1;
+    }
+
     float localT(const KeyframeRec& rec, float t) const {
         SkASSERT(rec.isValid());
         SkASSERT(!rec.isConstant());
@@ -111,11 +122,21 @@ protected:
                            c1 = jframe["o"].toDefault(kDefaultC1);
 
                 if (c0 != kDefaultC0 || c1 != kDefaultC1) {
-                    // TODO: is it worth de-duping these?
-                    cmidx = fCubicMaps.count();
-                    fCubicMaps.emplace_back();
-                    // TODO: why do we have to plug these inverted?
-                    fCubicMaps.back().setPts(c1, c0);
+                    // Most key frames share a few easing curves, and building a cubic map
+                    // solves for its x->t table.
+                    for (int i = 0; i < fCubicMapPts.count(); ++i) {
+                        if (fCubicMapPts[i].fC0 == c0 && fCubicMapPts[i].fC1 == c1) {
+                            cmidx = i;
+                            break;
+                        }
+                    }
+                    if (cmidx < 0) {
+                        cmidx = fCubicMaps.count();
+                        fCubicMaps.emplace_back();
+                        fCubicMapPts.push_back({ c0, c1 });
+                        // TODO: why do we have to plug these inverted?
+                        fCubicMaps.back().setPts(c1, c0);
+                    }
                 }
             }
 
@@ -168,9 +189,14 @@ private:
         return f0;
     }
 
-    SkTArray<KeyframeRec> fRecs;
-    SkTArray<SkCubicMap>  fCubicMaps;
-    const KeyframeRec*    fCachedRec = nullptr;
+    struct CubicMapPts {
+        SkPoint fC0, fC1;
+    };
+
+    SkTArray<KeyframeRec>       fRecs;
+    SkTArray<SkCubicMap>        fCubicMaps;
+    SkTArray<CubicMapPts, true> fCubicMapPts; // The control points of each cubic map.
+    const KeyframeRec*          fCachedRec = nullptr;
 
     using INHERITED = sksg::Animator;
 };
@@ -189,8 +215,17 @@ public:
 
 protected:
     void onTick(float t) override {
+        const auto& rec = this->frame(t);
+
+        // Held and clamped values don't change from tick to tick: only apply them once.
+        const auto vidx = this->valueIndex(rec, t);
+        if (vidx >= 0 && vidx == fAppliedValueIndex) {
+            return;
+        }
+        fAppliedValueIndex = vidx;
+
         T val;
-        this->eval(this->frame(t), t, &val);
+        this->eval(rec, t, &val);
 
         fApplyFunc(val);
     }
@@ -232,6 +267,7 @@ private:
 
     const std::function<void(const T&)> fApplyFunc;
     SkTArray<T>                         fVs;
+    int                                 fAppliedValueIndex = -1;
 
 
     using INHERITED = KeyframeAnimatorBase;
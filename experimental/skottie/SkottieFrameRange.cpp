@@ -0,0 +1,83 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkottieFrameRange.h"
+
+#include "Skottie.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkExecutor.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTaskGroup.h"
+
+#include <atomic>
+
+namespace skottie {
+
+namespace {
+
+bool render_run(const SkData& json, const ResourceProvider& resources, const SkImageInfo& info,
+                int firstFrame, int frameCount, bool cacheStaticContent, const FrameProc& proc) {
+    SkMemoryStream stream(json.data(), json.size());
+    auto animation = Animation::Make(&stream, resources);
+    auto surface = SkSurface::MakeRaster(info);
+    if (!animation || !surface) {
+        return false;
+    }
+
+    const auto dst = SkRect::Make(info.bounds());
+    SkCanvas* canvas = surface->getCanvas();
+    SkPixmap pixels;
+
+    for (int frame = firstFrame; frame < firstFrame + frameCount; ++frame) {
+        animation->seekFrame(frame);
+
+        if (cacheStaticContent && frame != firstFrame) {
+            animation->renderDamage(canvas, &dst);
+        } else {
+            canvas->clear(SK_ColorTRANSPARENT);
+            animation->render(canvas, &dst);
+        }
+
+        if (!surface->peekPixels(&pixels)) {
+            return false;
+        }
+        proc(frame, pixels);
+    }
+    return true;
+}
+
+} // namespace
+
+bool RenderFrameRange(const SkData& json, const ResourceProvider& resources,
+                      const SkImageInfo& info, int firstFrame, int frameCount,
+                      const FrameRangeOptions& options, const FrameProc& proc) {
+    if (frameCount <= 0) {
+        return true;
+    }
+
+    const int workers = SkTPin(options.fWorkers, 1, frameCount);
+    SkExecutor& executor = options.fExecutor ? *options.fExecutor : SkExecutor::GetDefault();
+    std::atomic<bool> ok(true);
+
+    SkTaskGroup tg(executor);
+    tg.batch(workers, [&](int worker) {
+        // Split the range into runs whose lengths differ by at most one frame.
+        const int begin = firstFrame + frameCount *  worker      / workers,
+                    end = firstFrame + frameCount * (worker + 1) / workers;
+        if (!render_run(json, resources, info, begin, end - begin, options.fCacheStaticContent,
+                        proc)) {
+            ok = false;
+        }
+    });
+    tg.wait();
+
+    return ok;
+}
+
+} // namespace skottie
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkottieFrameRange_DEFINED
+#define SkottieFrameRange_DEFINED
+
+#include "SkImageInfo.h"
+
+#include <functional>
+
+class SkData;
+class SkExecutor;
+class SkPixmap;
+
+namespace skottie {
+
+class ResourceProvider;
+
+struct FrameRangeOptions {
+    // Runs the workers. SkExecutor::GetDefault() if null.
+    SkExecutor* fExecutor = nullptr;
+
+    // Each worker parses its own Animation, and renders a run of consecutive frames.
+    int         fWorkers = 4;
+
+    // Each frame after the first of a run only redraws what the scene reports as changed since
+    // the frame before it, and keeps the rest of its pixels.
+    bool        fCacheStaticContent = true;
+};
+
+// Called on the workers' threads, concurrently and in no particular order. The pixels are only
+// valid for the duration of the call.
+using FrameProc = std::function<void(int frame, const SkPixmap&)>;
+
+/**
+ * Renders frames [firstFrame, firstFrame + frameCount) of the animation in json, counted as in
+ * Animation::seekFrame(), scaled to fit info. For exporting an animation to video, where many
+ * frames are needed as quickly as possible.
+ *
+ * The resource provider is called from the workers' threads.
+ *
+ * Returns false if the animation can't be parsed or the frames can't be rendered; some frames
+ * may have been passed to proc by then.
+ */
+bool RenderFrameRange(const SkData& json, const ResourceProvider&, const SkImageInfo& info,
+                      int firstFrame, int frameCount, const FrameRangeOptions&,
+                      const FrameProc& proc);
+
+} // namespace skottie
+
+#endif // SkottieFrameRange_DEFINED
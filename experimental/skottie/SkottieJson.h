@@ -58,7 +58,7 @@ private:
 };
 
 // Container for the json DOM
-class Document {
+class Document : public SkNVRefCnt<Document> {
 public:
     explicit Document(SkStream*);
 
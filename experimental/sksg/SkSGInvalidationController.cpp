@@ -29,4 +29,31 @@ void InvalidationController::inval(const SkRect& r, const SkMatrix& ctm) {
     fBounds.join(*rect);
 }
 
+void InvalidationController::merge(int maxRects) {
+    SkASSERT(maxRects > 0);
+
+    auto area = [](const SkRect& r) { return r.width() * r.height(); };
+
+    while (fRects.count() > maxRects) {
+        int      best_i = 0,
+                 best_j = 1;
+        SkScalar best_cost = SK_ScalarInfinity;
+        for (int i = 0; i < fRects.count(); ++i) {
+            for (int j = i + 1; j < fRects.count(); ++j) {
+                SkRect u = fRects[i];
+                u.join(fRects[j]);
+                const auto cost = area(u) - area(fRects[i]) - area(fRects[j]);
+                if (cost < best_cost) {
+                    best_i = i;
+                    best_j = j;
+                    best_cost = cost;
+                }
+            }
+        }
+
+        fRects[best_i].join(fRects[best_j]);
+        fRects.removeShuffle(best_j);
+    }
+}
+
 } // namespace sksg
@@ -27,6 +27,10 @@ public:
 
     void inval(const SkRect&, const SkMatrix& ctm = SkMatrix::I());
 
+    // Merges the damage rects into at most maxRects, joining the ones whose union adds the
+    // least area first.
+    void merge(int maxRects);
+
     const SkRect& bounds() const { return fBounds;        }
     const SkRect*  begin() const { return fRects.begin(); }
     const SkRect*    end() const { return fRects.end();   }
@@ -10,6 +10,7 @@
 #include "SkCanvas.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
+#include "SkRegion.h"
 #include "SkSGInvalidationController.h"
 #include "SkSGRenderNode.h"
 
@@ -61,10 +62,43 @@ void Scene::render(SkCanvas* canvas) const {
     }
 }
 
+SkIRect Scene::renderDamage(SkCanvas* canvas, SkColor background) const {
+    // Each rect costs a clip and overdraw along the seams; a few cover most scenes.
+    static constexpr int kMaxDamageRects = 4;
+
+    InvalidationController ic;
+    fRoot->revalidate(&ic, SkMatrix::I());
+    ic.merge(kMaxDamageRects);
+
+    const auto& ctm = canvas->getTotalMatrix();
+    SkRegion damage;
+    for (const auto& r : ic) {
+        SkRect devRect;
+        ctm.mapRect(&devRect, r);
+        // Outset for antialiasing.
+        damage.op(devRect.roundOut().makeOutset(1, 1), SkRegion::kUnion_Op);
+    }
+    if (damage.isEmpty()) {
+        return SkIRect::MakeEmpty();
+    }
+
+    SkAutoCanvasRestore acr(canvas, true);
+    canvas->clipRegion(damage);
+    canvas->drawColor(background, SkBlendMode::kSrc);
+    fRoot->render(canvas);
+
+    SkIRect bounds;
+    return canvas->getDeviceClipBounds(&bounds) ? bounds : SkIRect::MakeEmpty();
+}
+
 void Scene::animate(float t) {
     for (const auto& anim : fAnimators) {
         anim->tick(t);
     }
 }
 
+void Scene::revalidate(InvalidationController* ic) {
+    fRoot->revalidate(ic, SkMatrix::I());
+}
+
 } // namespace sksg
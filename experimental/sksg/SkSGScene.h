@@ -8,6 +8,8 @@
 #ifndef SkSGScene_DEFINED
 #define SkSGScene_DEFINED
 
+#include "SkColor.h"
+#include "SkRect.h"
 #include "SkRefCnt.h"
 #include "SkTypes.h"
 
@@ -18,6 +20,7 @@ class SkCanvas;
 
 namespace sksg {
 
+class InvalidationController;
 class RenderNode;
 
 /**
@@ -67,6 +70,14 @@ public:
     void render(SkCanvas*) const;
     void animate(float t);
 
+    // Renders only what changed since the scene was last revalidated, over the previous frame
+    // that the canvas must still hold. The damage is merged into a few rects, cleared to the
+    // background color and redrawn. Returns the device bounds of what was redrawn.
+    SkIRect renderDamage(SkCanvas*, SkColor background = SK_ColorTRANSPARENT) const;
+
+    // Revalidates the scene, and reports the damage since the last revalidation.
+    void revalidate(InvalidationController*);
+
     void setShowInval(bool show) { fShowInval = show; }
 
 private:
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSGPictureCache.h"
+
+#include "SkCanvas.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+
+namespace sksg {
+
+PictureCache::PictureCache(sk_sp<RenderNode> child)
+    : INHERITED(std::move(child)) {}
+
+PictureCache::~PictureCache() = default;
+
+void PictureCache::onRender(SkCanvas* canvas) const {
+    if (!fPicture) {
+        SkPictureRecorder recorder;
+        this->INHERITED::onRender(recorder.beginRecording(this->bounds()));
+        fPicture = recorder.finishRecordingAsPicture();
+        fRecordCount++;
+    }
+
+    canvas->drawPicture(fPicture);
+    fRenderCount++;
+}
+
+SkRect PictureCache::onRevalidate(InvalidationController* ic, const SkMatrix& ctm) {
+    SkASSERT(this->hasInval());
+
+    // Something in the sub-DAG changed.
+    fPicture.reset();
+
+    return this->INHERITED::onRevalidate(ic, ctm);
+}
+
+} // namespace sksg
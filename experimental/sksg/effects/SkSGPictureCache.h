@@ -0,0 +1,53 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSGPictureCache_DEFINED
+#define SkSGPictureCache_DEFINED
+
+#include "SkSGEffectNode.h"
+
+class SkPicture;
+
+namespace sksg {
+
+/**
+ * Concrete Effect node, rendering its descendants from an SkPicture recorded when they were
+ * last revalidated.
+ *
+ * Meant for sub-DAGs which don't animate: the picture is recorded on the first render, and
+ * only recorded again if the sub-DAG is invalidated.
+ */
+class PictureCache final : public EffectNode {
+public:
+    static sk_sp<PictureCache> Make(sk_sp<RenderNode> child) {
+        return child ? sk_sp<PictureCache>(new PictureCache(std::move(child))) : nullptr;
+    }
+
+    ~PictureCache() override;
+
+    // How many times the picture was recorded, and rendered.
+    int recordCount() const { return fRecordCount; }
+    int renderCount() const { return fRenderCount; }
+
+protected:
+    explicit PictureCache(sk_sp<RenderNode>);
+
+    void onRender(SkCanvas*) const override;
+
+    SkRect onRevalidate(InvalidationController*, const SkMatrix&) override;
+
+private:
+    mutable sk_sp<SkPicture> fPicture;
+    mutable int              fRecordCount = 0,
+                             fRenderCount = 0;
+
+    typedef EffectNode INHERITED;
+};
+
+} // namespace sksg
+
+#endif // SkSGPictureCache_DEFINED
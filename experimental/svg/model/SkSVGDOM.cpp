@@ -7,7 +7,11 @@
 
 #include "SkCanvas.h"
 #include "SkDOM.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 #include "SkParsePath.h"
+#include "SkPictureRecorder.h"
+#include "SkRectPriv.h"
 #include "SkString.h"
 #include "SkSVGAttributeParser.h"
 #include "SkSVGCircle.h"
@@ -83,10 +87,45 @@ bool SetClipPathAttribute(const sk_sp<SkSVGNode>& node, SkSVGAttribute attr,
 }
 
 
+// Path and points data parsed so far, shared by all the DOMs: documents loaded from the same
+// source repeat the same strings, and copies of a cached SkPath share its storage. Strings that
+// fail to parse aren't cached.
+template <typename T>
+class ParseCache {
+public:
+    template <typename Parse>
+    bool find(const char* str, T* value, Parse&& parse) {
+        const SkString key(str);
+        {
+            SkAutoMutexAcquire lock(fMutex);
+            if (const T* cached = fCache.find(key)) {
+                *value = *cached;
+                return true;
+            }
+        }
+        if (!parse(str, value)) {
+            return false;
+        }
+        SkAutoMutexAcquire lock(fMutex);
+        fCache.insert(key, *value);
+        return true;
+    }
+
+private:
+    static constexpr int kMaxEntries = 1024;
+
+    SkMutex                 fMutex;
+    SkLRUCache<SkString, T> fCache{kMaxEntries};
+};
+
 bool SetPathDataAttribute(const sk_sp<SkSVGNode>& node, SkSVGAttribute attr,
                           const char* stringValue) {
+    static auto* gCache = new ParseCache<SkPath>;
+
     SkPath path;
-    if (!SkParsePath::FromSVGString(stringValue, &path)) {
+    if (!gCache->find(stringValue, &path, [](const char* str, SkPath* path) {
+        return SkParsePath::FromSVGString(str, path);
+    })) {
         return false;
     }
 
@@ -180,9 +219,13 @@ bool SetSpreadMethodAttribute(const sk_sp<SkSVGNode>& node, SkSVGAttribute attr,
 
 bool SetPointsAttribute(const sk_sp<SkSVGNode>& node, SkSVGAttribute attr,
                         const char* stringValue) {
+    static auto* gCache = new ParseCache<SkSVGPointsType>;
+
     SkSVGPointsType points;
-    SkSVGAttributeParser parser(stringValue);
-    if (!parser.parsePoints(&points)) {
+    if (!gCache->find(stringValue, &points, [](const char* str, SkSVGPointsType* points) {
+        SkSVGAttributeParser parser(str);
+        return parser.parsePoints(points);
+    })) {
         return false;
     }
 
@@ -479,11 +522,43 @@ sk_sp<SkSVGDOM> SkSVGDOM::MakeFromStream(SkStream& svgStream) {
 }
 
 void SkSVGDOM::render(SkCanvas* canvas) const {
-    if (fRoot) {
+    if (!fRoot) {
+        return;
+    }
+
+    static constexpr int kMaxPictures = 4;
+
+    int i = 0;
+    while (i < fPictures.count() && fPictures[i].fContainerSize != fContainerSize) {
+        ++i;
+    }
+
+    if (i == fPictures.count()) {
+        // The length context, and so the whole rendering, only depends on the container size.
+        SkPictureRecorder recorder;
         SkSVGLengthContext       lctx(fContainerSize);
         SkSVGPresentationContext pctx;
-        fRoot->render(SkSVGRenderContext(canvas, fIDMapper, lctx, pctx));
+        fRoot->render(SkSVGRenderContext(recorder.beginRecording(SkRectPriv::MakeLargest()),
+                                         fIDMapper, lctx, pctx));
+
+        if (fPictures.count() == kMaxPictures) {
+            fPictures.pop_back();
+            --i;
+        }
+        fPictures.push_back({ fContainerSize, recorder.finishRecordingAsPicture() });
+    }
+
+    // Move it to the front.
+    for (; i > 0; --i) {
+        using std::swap;
+        swap(fPictures[i], fPictures[i - 1]);
     }
+
+    canvas->drawPicture(fPictures[0].fPicture);
+}
+
+void SkSVGDOM::invalidate() {
+    fPictures.reset();
 }
 
 SkSize SkSVGDOM::intrinsicSize() const {
@@ -501,10 +576,11 @@ const SkSize& SkSVGDOM::containerSize() const {
 }
 
 void SkSVGDOM::setContainerSize(const SkSize& containerSize) {
-    // TODO: inval
+    // Pictures are cached per container size, so there's nothing to invalidate.
     fContainerSize = containerSize;
 }
 
 void SkSVGDOM::setRoot(sk_sp<SkSVGNode> root) {
     fRoot = std::move(root);
+    this->invalidate();
 }
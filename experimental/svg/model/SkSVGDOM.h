@@ -8,9 +8,11 @@
 #ifndef SkSVGDOM_DEFINED
 #define SkSVGDOM_DEFINED
 
+#include "SkPicture.h"
 #include "SkRefCnt.h"
 #include "SkSize.h"
 #include "SkSVGIDMapper.h"
+#include "SkTArray.h"
 #include "SkTemplates.h"
 
 class SkCanvas;
@@ -31,15 +33,34 @@ public:
 
     void setRoot(sk_sp<SkSVGNode>);
 
+    /**
+     * The document is recorded into a picture the first time it is rendered at a container size,
+     * and later renders at that size play the picture back. Pictures are kept for the last few
+     * container sizes.
+     */
     void render(SkCanvas*) const;
 
+    /**
+     * Drops the recorded pictures. Call after changing the attributes of nodes passed to
+     * setRoot(); setRoot() itself invalidates.
+     */
+    void invalidate();
+
 private:
     SkSize intrinsicSize() const;
 
+    struct CachedPicture {
+        SkSize           fContainerSize;
+        sk_sp<SkPicture> fPicture;
+    };
+
     SkSize           fContainerSize;
     sk_sp<SkSVGNode> fRoot;
     SkSVGIDMapper    fIDMapper;
 
+    // Most recently used first.
+    mutable SkTArray<CachedPicture> fPictures;
+
     typedef SkRefCnt INHERITED;
 };
 
@@ -17,7 +17,8 @@ SkAtlasTextRenderer* SkGetAtlasTextRendererFromInternalContext(class SkInternalA
 
 /**
  * Class that Atlas Text client uses to register their SkAtlasTextRenderer implementation and
- * to create one or more SkAtlasTextTargets (destination surfaces for text rendering).
+ * to create one or more SkAtlasTextTargets (destination surfaces for text rendering). All of a
+ * context's targets share its glyph atlas.
  */
 class SK_API SkAtlasTextContext : public SkRefCnt {
 public:
@@ -27,6 +28,12 @@ public:
         return SkGetAtlasTextRendererFromInternalContext(*fInternalContext);
     }
 
+    /**
+     * Issues the text draws of every target that has called flushToContext() since the last
+     * flush, along with the atlas updates they need, to the SkAtlasTextRenderer.
+     */
+    void flush();
+
     SkInternalAtlasTextContext& internal() { return *fInternalContext; }
 
 private:
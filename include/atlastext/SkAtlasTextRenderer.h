@@ -34,6 +34,24 @@ public:
         int16_t fTextureCoordY;
     };
 
+    /** A rectangle of new pixel data for the atlas texture. */
+    struct TextureUpload {
+        /** Pixel data in the atlas' format, 'fRowBytes' apart. */
+        const void* fData;
+        size_t fRowBytes;
+        int fX;
+        int fY;
+        int fWidth;
+        int fHeight;
+    };
+
+    /** A run of consecutive quads in a flushed vertex buffer that go to one target. */
+    struct SDFDraw {
+        void* fTargetHandle;
+        int fFirstQuad;
+        int fQuadCnt;
+    };
+
     virtual ~SkAtlasTextRenderer() = default;
 
     /**
@@ -65,6 +83,25 @@ public:
     virtual void drawSDFGlyphs(void* targetHandle, void* textureHandle, const SDFVertex vertices[],
                                int quadCnt) = 0;
 
+    /**
+     * Issues a whole flush of an SkAtlasTextContext at once, for renderers that would rather
+     * upload one buffer and make few draw calls than respond to each glyph run.
+     *
+     * First updates the texture with handle 'textureHandle' with the 'uploadCnt' rectangles in
+     * 'uploads', then draws the 'drawCnt' runs of quads in 'draws', in order. The runs are
+     * slices of 'vertices', which holds 4 * 'quadCnt' entries for all targets drawn in the flush.
+     * Consecutive runs go to different targets. The data pointed to is only valid during the
+     * call.
+     *
+     * A flush makes more than one call only if it has to reuse atlas space that earlier draws in
+     * the flush read.
+     *
+     * The default calls setTextureData() for each upload and drawSDFGlyphs() for each draw.
+     */
+    virtual void flushSDFGlyphs(void* textureHandle, const TextureUpload uploads[], int uploadCnt,
+                                const SDFVertex vertices[], int quadCnt, const SDFDraw draws[],
+                                int drawCnt);
+
     /** Called when a SkAtlasTextureTarget is destroyed. */
     virtual void targetDeleted(void* targetHandle) = 0;
 };
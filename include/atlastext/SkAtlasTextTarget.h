@@ -38,8 +38,17 @@ public:
     virtual void drawText(const SkGlyphID[], const SkPoint[], int glyphCnt, uint32_t color,
                           const SkAtlasTextFont&) = 0;
 
-    /** Issues all queued text draws to SkAtlasTextRenderer. */
-    virtual void flush() = 0;
+    /**
+     * Hands all queued text draws to the context, to be issued to the SkAtlasTextRenderer by the
+     * next SkAtlasTextContext::flush(), together with those of the context's other targets.
+     */
+    virtual void flushToContext() = 0;
+
+    /**
+     * Issues all queued text draws, and any handed to the context by other targets, to
+     * SkAtlasTextRenderer.
+     */
+    void flush();
 
     int width() const { return fWidth; }
     int height() const { return fHeight; }
@@ -154,6 +154,44 @@ SK_API void sk_canvas_draw_image_rect(sk_canvas_t*, const sk_image_t*,
 SK_API void sk_canvas_draw_picture(sk_canvas_t*, const sk_picture_t*,
                                    const sk_matrix_t*, const sk_paint_t*);
 
+/**
+    The batch calls below each draw count items in one call, to save
+    bindings from other languages crossing into C once per item.  Item
+    i is drawn with paints[paintIndices[i]], or with paints[0] if
+    paintIndices is NULL.  Items whose paint index is out of range
+    are skipped.
+*/
+
+/**
+    Draw count rectangles, as if by sk_canvas_draw_rect().
+*/
+SK_API void sk_canvas_draw_rects(sk_canvas_t*, const sk_rect_t rects[],
+                                 const int32_t paintIndices[], int count,
+                                 const sk_paint_t* const paints[], int paintCount);
+/**
+    Draw count paths, as if by sk_canvas_draw_path().
+*/
+SK_API void sk_canvas_draw_paths(sk_canvas_t*, const sk_path_t* const paths[],
+                                 const int32_t paintIndices[], int count,
+                                 const sk_paint_t* const paints[], int paintCount);
+/**
+    Draw count images with their top/left corners at positions, as if
+    by sk_canvas_draw_image().  A paint index of -1 draws that image
+    without a paint.
+*/
+SK_API void sk_canvas_draw_images(sk_canvas_t*, const sk_image_t* const images[],
+                                  const sk_point_t positions[],
+                                  const int32_t paintIndices[], int count,
+                                  const sk_paint_t* const paints[], int paintCount);
+
+/**
+    Run count commands on the canvas, in order.  Commands with an out
+    of range paint or object index are skipped.  Any saves the
+    commands leave unbalanced are restored at the end.
+*/
+SK_API void sk_canvas_draw_commands(sk_canvas_t*, const sk_drawcommand_t commands[], int count,
+                                    const sk_drawtables_t*);
+
 SK_C_PLUS_PLUS_END_GUARD
 
 #endif
@@ -42,6 +42,16 @@ sk_canvas_t* sk_picture_recorder_begin_recording(sk_picture_recorder_t*, const s
 */
 sk_picture_t* sk_picture_recorder_end_recording(sk_picture_recorder_t*);
 
+/**
+    Record count commands into a new picture with the given cull rect,
+    in one call.  This is the same as begin_recording,
+    sk_canvas_draw_commands(), end_recording, but needs no recorder.
+    The caller must call sk_picture_unref() on the result.
+*/
+sk_picture_t* sk_picture_record_commands(const sk_rect_t* cullRect,
+                                         const sk_drawcommand_t commands[], int count,
+                                         const sk_drawtables_t*);
+
 /**
     Increment the reference count on the given sk_picture_t. Must be
     balanced by a call to sk_picture_unref().
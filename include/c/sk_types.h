@@ -263,6 +263,49 @@ typedef enum {
     LUMINOSITY_SK_XFERMODE_MODE,
 } sk_xfermode_mode_t;
 
+/**
+    The operations of a sk_drawcommand_t, and which of its fields each
+    one uses.  rect means args[0..3] as left, top, right, bottom.
+*/
+typedef enum {
+    SAVE_SK_DRAWOP,             // (nothing)
+    RESTORE_SK_DRAWOP,          // (nothing)
+    TRANSLATE_SK_DRAWOP,        // args[0..1]: dx, dy
+    SCALE_SK_DRAWOP,            // args[0..1]: sx, sy
+    CLIP_RECT_SK_DRAWOP,        // args: rect
+    DRAW_PAINT_SK_DRAWOP,       // paint
+    DRAW_RECT_SK_DRAWOP,        // args: rect, paint
+    DRAW_OVAL_SK_DRAWOP,        // args: rect, paint
+    DRAW_CIRCLE_SK_DRAWOP,      // args[0..2]: cx, cy, radius, paint
+    DRAW_PATH_SK_DRAWOP,        // object: path, paint
+    DRAW_IMAGE_SK_DRAWOP,       // object: image, args[0..1]: x, y, paint (may be -1)
+    DRAW_IMAGE_RECT_SK_DRAWOP,  // object: image, args: dst rect, paint (may be -1)
+} sk_drawop_t;
+
+/**
+    One command in a buffer of them, for sk_canvas_draw_commands() and
+    sk_picture_record_commands().  paint and object index the tables
+    of a sk_drawtables_t.
+*/
+typedef struct {
+    sk_drawop_t op;
+    int32_t     paint;
+    int32_t     object;
+    float       args[4];
+} sk_drawcommand_t;
+
+/**
+    The paints, paths and images that sk_drawcommand_ts refer to.
+*/
+typedef struct {
+    const sk_paint_t* const*    paints;
+    int32_t                     paintCount;
+    const sk_path_t* const*     paths;
+    int32_t                     pathCount;
+    const sk_image_t* const*    images;
+    int32_t                     imageCount;
+} sk_drawtables_t;
+
 //////////////////////////////////////////////////////////////////////////////////////////
 
 SK_C_PLUS_PLUS_END_GUARD
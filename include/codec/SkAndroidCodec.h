@@ -181,6 +181,22 @@ public:
      */
     SkISize getSampledSubsetDimensions(int sampleSize, const SkIRect& subset) const;
 
+    enum class SampleFilter {
+        /**
+         *  Each dst pixel is one pixel of the sampleSize x sampleSize block of
+         *  src pixels it covers.
+         */
+        kPoint,
+
+        /**
+         *  Each dst pixel is the average of the block of src pixels it covers.
+         *  The src rows are accumulated as they are decoded, so no full size
+         *  image is allocated. Only used for 8888, alpha 8 and gray 8 dsts and
+         *  top down scanline orders; kPoint is used otherwise.
+         */
+        kBox,
+    };
+
     /**
      *  Additional options to pass to getAndroidPixels().
      */
@@ -193,6 +209,7 @@ public:
             : fZeroInitialized(SkCodec::kNo_ZeroInitialized)
             , fSubset(nullptr)
             , fSampleSize(1)
+            , fSampleFilter(SampleFilter::kPoint)
         {}
 
         /**
@@ -222,6 +239,13 @@ public:
          *  The default is 1, representing no downscaling.
          */
         int fSampleSize;
+
+        /**
+         *  How fSampleSize is applied when the codec cannot scale natively.
+         *
+         *  The default is SampleFilter::kPoint.
+         */
+        SampleFilter fSampleFilter;
     };
 
     /**
@@ -26,6 +26,8 @@
 
 class SkColorSpace;
 class SkData;
+class SkCodecFrameCache;
+class SkExecutor;
 class SkFrameHolder;
 class SkPngChunkReader;
 class SkSampler;
@@ -254,6 +256,7 @@ public:
             , fFrameIndex(0)
             , fPriorFrame(kNone)
             , fPremulBehavior(SkTransferFunctionBehavior::kRespect)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -305,6 +308,15 @@ public:
          *  we will always do a legacy premultiply.
          */
         SkTransferFunctionBehavior fPremulBehavior;
+
+        /**
+         *  If not NULL, getPixels() may split the decode into tasks that run on this
+         *  executor, and waits for them to finish before returning.
+         *
+         *  Currently only used by baseline JPEGs with restart markers and by
+         *  non-interlaced PNGs.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -664,6 +676,25 @@ public:
         return this->onGetRepetitionCount();
     }
 
+    /**
+     *  Keep up to |bytes| of decoded frames of a multi-frame image, so that
+     *  getPixels() can copy a frame that has been decoded before instead of
+     *  decoding it (and its required frames) again. A cached frame in
+     *  [fRequiredFrame, fFrameIndex) is also used as the prior frame when
+     *  Options.fPriorFrame is kNone. Frames that do not depend on a prior
+     *  frame are the last to be evicted.
+     *
+     *  If |executor| and |prefetchCodec| are not NULL, after decoding frame N
+     *  getPixels() starts decoding frame N + 1 into the cache on |executor|,
+     *  using |prefetchCodec|, which must be created from the same data as this
+     *  codec. The cache takes ownership of |prefetchCodec|.
+     *
+     *  Passing 0 for |bytes| removes the cache. Subset decodes do not use the
+     *  cache.
+     */
+    void setFrameCache(size_t bytes, SkExecutor* executor = nullptr,
+                       std::unique_ptr<SkCodec> prefetchCodec = nullptr);
+
 protected:
     const SkEncodedInfo& getEncodedInfo() const { return fEncodedInfo; }
 
@@ -847,6 +878,12 @@ private:
 
     bool                               fStartedIncrementalDecode;
 
+    std::unique_ptr<SkCodecFrameCache> fOwnedFrameCache;
+    // fOwnedFrameCache, or the cache of the codec that prefetches with this one.
+    SkCodecFrameCache*                 fFrameCache;
+    // Set while handleFrameIndex() decodes a required frame.
+    bool                               fDecodingRequiredFrame;
+
     /**
      *  Return whether {srcColor, srcIsOpaque, srcCS} can convert to dst.
      *
@@ -879,6 +916,17 @@ private:
      */
     Result handleFrameIndex(const SkImageInfo&, void* pixels, size_t rowBytes, const Options&);
 
+    /**
+     *  The part of getPixels() after the parameters have been checked and the stream rewound.
+     */
+    Result decodeFrame(const SkImageInfo&, void* pixels, size_t rowBytes, const Options&);
+
+    /**
+     *  getPixels() for a frame of a multi-frame image when there is a frame cache.
+     */
+    Result decodeFrameWithCache(const SkImageInfo&, void* pixels, size_t rowBytes,
+                                const Options&);
+
     // Methods for scanline decoding.
     virtual Result onStartScanlineDecode(const SkImageInfo& /*dstInfo*/,
             const Options& /*options*/) {
@@ -28,4 +28,16 @@ private:
     typedef SkBBHFactory INHERITED;
 };
 
+/**
+ *  Creates an R-Tree that sorts ops by position rather than recording order, and tests several
+ *  bounds at once when searching. Prefer it to SkRTreeFactory for pictures with many ops that
+ *  were not recorded in top to bottom order.
+ */
+class SK_API SkPackedRTreeFactory : public SkBBHFactory {
+public:
+    SkBBoxHierarchy* operator()(const SkRect& bounds) const override;
+private:
+    typedef SkBBHFactory INHERITED;
+};
+
 #endif
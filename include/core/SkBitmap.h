@@ -14,6 +14,7 @@
 #include "SkPoint.h"
 #include "SkRefCnt.h"
 
+class SkExecutor;
 struct SkMask;
 struct SkIRect;
 struct SkRect;
@@ -1115,14 +1116,19 @@ public:
         If behavior is SkTransferFunctionBehavior::kIgnore: src
         pixels are treated as if they are linear, regardless of how they are encoded.
 
+        If executor is not nullptr, large copies are split into bands of rows that are
+        converted in parallel on executor. writePixels() returns once all bands are copied.
+
         @param src       source SkPixmap: SkImageInfo, pixels, row bytes
         @param x         column index whose absolute value is less than width()
         @param y         row index whose absolute value is less than height()
         @param behavior  one of: SkTransferFunctionBehavior::kRespect,
                          SkTransferFunctionBehavior::kIgnore
+        @param executor  runs bands of rows in parallel; may be nullptr
         @return          true if src pixels are copied to SkBitmap
     */
-    bool writePixels(const SkPixmap& src, int x, int y, SkTransferFunctionBehavior behavior);
+    bool writePixels(const SkPixmap& src, int x, int y, SkTransferFunctionBehavior behavior,
+                     SkExecutor* executor = nullptr);
 
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
     /** Android framework only.
@@ -2632,6 +2632,12 @@ private:
                                                                 : kNotOpaque_ShaderOverrideOpacity);
     }
 
+    // if our surface tracks damage, tell it what drawing bounds with paint may change: bounds
+    // (nullptr for anything in the clip) in local coordinates, outset for paint
+    void damageNotify(const SkRect* bounds, const SkPaint* paint);
+    // ... or, in device coordinates, what drawing a layer of deviceBounds with paint may change
+    void damageNotifyDevice(const SkIRect& deviceBounds, const SkPaint* paint);
+
     SkBaseDevice* getDevice() const;
 
     class MCRec;
@@ -2666,7 +2672,9 @@ private:
     SkIRect fClipRestrictionRect = SkIRect::MakeEmpty();
 
     void doSave();
+    void doMatrixSave();
     void checkForDeferredSave();
+    void checkForDeferredMatrixSave();
     void internalSetMatrix(const SkMatrix&);
 
     friend class SkAndroidFrameworkUtils;
@@ -2722,6 +2730,7 @@ private:
     // shared by save() and saveLayer()
     void internalSave();
     void internalRestore();
+    void internalRestoreMatrix();
 
     /*
      *  Returns true if drawing the specified rect (or all if it is null) with the specified
@@ -58,6 +58,14 @@ public:
     virtual bool apply(ColorFormat dstFormat, void* dst, ColorFormat srcFormat, const void* src,
                        int count, SkAlphaType alphaType) const = 0;
 
+    /**
+     *  Like apply(), on |rows| rows of |count| pixels, |dstRowBytes| and |srcRowBytes| apart.
+     *  Rows that are packed together are converted as one span.
+     */
+    virtual bool applyRows(ColorFormat dstFormat, void* dst, size_t dstRowBytes,
+                           ColorFormat srcFormat, const void* src, size_t srcRowBytes,
+                           int count, int rows, SkAlphaType alphaType) const;
+
     virtual ~SkColorSpaceXform() {}
 
     enum AlphaOp {
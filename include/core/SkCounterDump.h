@@ -0,0 +1,38 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCounterDump_DEFINED
+#define SkCounterDump_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ *  Receives Skia's always-on event counters, e.g. for export to a metrics system, when passed to
+ *  SkGraphics::DumpCounters(). Unlike trace events these are counted whether or not tracing is
+ *  enabled. Values are totals since the process started, across all threads.
+ *
+ *  The implementation of this interface is provided by the embedder.
+ */
+class SK_API SkCounterDump {
+public:
+    /**
+     *  Called with the total of each counter.
+     *  name is slash-separated, e.g. "skia/glyph_cache/hits".
+     */
+    virtual void dumpCounter(const char* name, uint64_t value) = 0;
+
+    /**
+     *  Called with each histogram, as how many recorded values fell in each of bucketCount
+     *  buckets. buckets[0] counts zeros, and buckets[i] counts values in [2^(i-1), 2^i).
+     */
+    virtual void dumpHistogram(const char* name, const uint64_t buckets[], int bucketCount) = 0;
+
+protected:
+    virtual ~SkCounterDump() = default;
+};
+
+#endif
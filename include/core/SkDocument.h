@@ -16,6 +16,7 @@
 #include "SkTime.h"
 
 class SkCanvas;
+class SkExecutor;
 class SkWStream;
 
 #ifdef SK_BUILD_FOR_WIN
@@ -44,6 +45,23 @@ public:
         OptionalTimestamp() : fEnabled(false) {}
     };
 
+    /**
+     *  A cache that outlives PDF documents, so that documents drawing the same images and
+     *  typefaces reuse their compressed pixels, font subsets and glyph widths instead of
+     *  recomputing them. Images are matched by their unique ID, so the cache only helps if
+     *  the same SkImage (or the same SkBitmap pixels) is drawn into each document.
+     *
+     *  A cache may be shared by documents on several threads. Once it holds more than
+     *  byteLimit bytes the least recently used entries are dropped.
+     */
+    class SK_API PDFCache : public SkRefCnt {
+    public:
+        static sk_sp<PDFCache> Make(size_t byteLimit = 32 * 1024 * 1024);
+
+    protected:
+        PDFCache() {}
+    };
+
     /**
      *  Optional metadata to be passed into the PDF factory function.
      */
@@ -110,6 +128,44 @@ public:
          *  quality setting.
          */
         int fEncodingQuality = 101;
+
+        /**
+         *  If not null, page content streams, images and font subsets are compressed and
+         *  serialized on this executor's threads, while the caller draws the following pages.
+         *  Objects are numbered and written in the same order as without an executor, so the
+         *  output does not change unless fParallelCompression is set. The executor must
+         *  outlive the document.
+         */
+        SkExecutor* fExecutor = nullptr;
+
+        /**
+         *  The zlib compression level of page content streams, images and form XObjects:
+         *  0 is no compression, 1 is the fastest and 9 the smallest. The default, -1, is
+         *  zlib's default level.
+         */
+        int fCompressionLevel = -1;
+
+        /**
+         *  If true and fExecutor is set, page content streams, images and form XObjects
+         *  larger than 128KB are split into blocks that are compressed on the executor's
+         *  threads. This makes the streams slightly larger.
+         */
+        bool fParallelCompression = false;
+
+        /**
+         *  If not null, compressed images, font subsets and glyph widths are looked up in and
+         *  added to this cache. The output does not change.
+         */
+        sk_sp<PDFCache> fCache;
+
+        /**
+         *  If true, each page is written to the stream when it ends, together with the
+         *  objects only it uses, and then freed. Only fonts, which are subset once every
+         *  page is known, and a few bytes per object are kept until the document is closed,
+         *  so memory use no longer grows with the page count. All pages are children of a
+         *  single page tree node, so the output differs from the default mode.
+         */
+        bool fStreaming = false;
     };
 
     /**
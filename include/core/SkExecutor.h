@@ -19,6 +19,17 @@ public:
     static std::unique_ptr<SkExecutor> MakeFIFOThreadPool(int threads = 0);
     static std::unique_ptr<SkExecutor> MakeLIFOThreadPool(int threads = 0);
 
+    // Like the above, but each thread has its own work, and takes from the others' when it runs
+    // out, so threads adding work don't all contend for one list. It honors Priority and thread
+    // hints, and splits batches between threads only as they go idle.
+    static std::unique_ptr<SkExecutor> MakeWorkStealingThreadPool(int threads = 0);
+
+    enum class Priority {
+        kHigh,    // Latency critical, e.g. raster tiles for the next frame.
+        kNormal,
+        kLow,     // Background work, e.g. decoding images ahead of need.
+    };
+
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
     static void SetDefault(SkExecutor*);  // Does not take ownership.  Not thread safe.
@@ -26,6 +37,20 @@ public:
     // Add work to execute.
     virtual void add(std::function<void(void)>) = 0;
 
+    // Add work to execute before any of lower priority that's waiting. If threadHint isn't -1,
+    // the work prefers that thread, e.g. one that just worked on the same data.
+    // By default, this ignores the hints.
+    virtual void addPrioritized(std::function<void(void)> work, Priority, int threadHint = -1) {
+        this->add(std::move(work));
+    }
+
+    // Add work calling fn(i) for each i in [0, N). By default, each i is added separately.
+    virtual void batch(int N, std::function<void(int)> fn, Priority priority = Priority::kNormal) {
+        for (int i = 0; i < N; i++) {
+            this->addPrioritized([=] { fn(i); }, priority);
+        }
+    }
+
     // If it makes sense for this executor, use this thread to execute work for a little while.
     virtual void borrow() {}
 };
@@ -10,6 +10,7 @@
 
 #include "SkRefCnt.h"
 
+class SkCounterDump;
 class SkData;
 class SkImageGenerator;
 class SkTraceMemoryDump;
@@ -137,12 +138,31 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  SkImage::MakeFromEncoded() called twice on the same bytes normally makes two unrelated
+     *  images, which are decoded and cached separately.  With a limit above zero, images made
+     *  from equal bytes share one generator, unique ID and cached decode, as long as the bytes
+     *  were among the last count distinct ones seen.  This costs a hash of the bytes per image,
+     *  and keeps the last count generators (and their encoded data) alive.
+     *
+     *  Zero, the default, turns sharing off.  Returns the previous limit.
+     */
+    static int GetSharedEncodedImageCountLimit();
+    static int SetSharedEncodedImageCountLimit(int count);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
      */
     static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 
+    /**
+     *  Dumps Skia's always-on counters of events like glyph cache hits and misses, resource cache
+     *  purges and shader compiles, using the SkCounterDump interface. These are kept whether or
+     *  not tracing is enabled.
+     */
+    static void DumpCounters(SkCounterDump* dump);
+
     /**
      *  Free as much globally cached memory as possible. This will purge all private caches in Skia,
      *  including font and image caches.
@@ -22,6 +22,7 @@
 
 class SkData;
 class SkCanvas;
+class SkExecutor;
 class SkImageFilter;
 class SkImageGenerator;
 class SkPaint;
@@ -779,6 +780,27 @@ public:
     */
     sk_sp<SkImage> makeRasterImage() const;
 
+    typedef std::function<void(sk_sp<SkImage>)> DecodeCompleteProc;
+
+    /** Decodes lazy image on executor, so that the thread that first draws SkImage does
+        not stall on the decode. Calls proc on the executor's thread with a raster SkImage
+        sharing the decoded pixels, or with nullptr if the decode fails.
+
+        The decoded pixels are kept in the same cache that drawing SkImage into a raster
+        SkSurface with dstColorSpace reads from, so a draw after proc has been called does
+        not decode again unless the cache has purged them. To draw on the GPU, call
+        makeTextureImage() on the returned SkImage from the thread that owns the GrContext.
+
+        If SkImage is not lazy generated, or executor is nullptr, calls proc with
+        makeRasterImage() before returning.
+
+        @param executor       runs the decode
+        @param dstColorSpace  range of colors of the SkSurface SkImage will be drawn into
+        @param proc           called with the decoded SkImage, or nullptr
+    */
+    void makeDecodedAsync(SkExecutor* executor, SkColorSpace* dstColorSpace,
+                          DecodeCompleteProc proc) const;
+
     /** Creates filtered SkImage. filter processes original SkImage, potentially changing
         color, position, and size. subset is the bounds of original SkImage processed
         by filter. clipBounds is the expected bounds of the filtered SkImage. outSubset
@@ -21,6 +21,7 @@ class GrContext;
 class GrFragmentProcessor;
 class SkColorFilter;
 class SkColorSpaceXformer;
+class SkExecutor;
 struct SkIPoint;
 class SkSpecialImage;
 class SkImageFilterCache;
@@ -54,17 +55,23 @@ public:
     class Context {
     public:
         Context(const SkMatrix& ctm, const SkIRect& clipBounds, SkImageFilterCache* cache,
-                const OutputProperties& outputProperties)
+                const OutputProperties& outputProperties, SkExecutor* executor = nullptr)
             : fCTM(ctm)
             , fClipBounds(clipBounds)
             , fCache(cache)
             , fOutputProperties(outputProperties)
+            , fExecutor(executor)
         {}
 
         const SkMatrix& ctm() const { return fCTM; }
         const SkIRect& clipBounds() const { return fClipBounds; }
         SkImageFilterCache* cache() const { return fCache; }
         const OutputProperties& outputProperties() const { return fOutputProperties; }
+        /**
+         *  Raster filters that can split their work into bands of rows may run the bands in
+         *  parallel on this executor, if there is one.
+         */
+        SkExecutor* executor() const { return fExecutor; }
 
         /**
          *  Since a context can be build directly, its constructor has no chance to
@@ -81,6 +88,7 @@ public:
         SkIRect                fClipBounds;
         SkImageFilterCache*    fCache;
         OutputProperties       fOutputProperties;
+        SkExecutor*            fExecutor;
     };
 
     class CropRect {
@@ -141,6 +149,26 @@ public:
     sk_sp<SkSpecialImage> filterImage(SkSpecialImage* src, const Context& context,
                                       SkIPoint* offset) const;
 
+    /**
+     *  Same as filterImage(), but for raster sources whose clip bounds span more than one tile,
+     *  the output is split into tiles of at most tileSize pixels on a side. Each tile is filtered
+     *  on its own, with the tile as the clip bounds, so every node only makes the part of its
+     *  output that the tile needs. The tiles are filtered in parallel on the executor, if there
+     *  is one, and it is passed on to the filters through the tiles' contexts.
+     *
+     *  If the context's cache has a tile size, that is used instead, and every tile is filtered
+     *  whole and cached, even where it sticks out of the clip bounds. Tiles lie on a grid
+     *  anchored at the CTM's integer translation, and are keyed by the source pixels they read.
+     *  So a later request for the same content moved by whole pixels, e.g. a scrolled layer,
+     *  reuses the tiles whose input it shares, even if its source is a new image.
+     *
+     *  The result is the same as filterImage()'s, as long as each node's reverse-mapped bounds
+     *  cover the input it reads.
+     */
+    sk_sp<SkSpecialImage> filterImageTiled(SkSpecialImage* src, const Context& context,
+                                           SkIPoint* offset, SkExecutor* executor,
+                                           int tileSize = 256) const;
+
     enum MapDirection {
         kForward_MapDirection,
         kReverse_MapDirection,
@@ -354,6 +382,19 @@ protected:
                                       const Context&,
                                       SkIPoint* offset) const;
 
+    /**
+     *  Same as filterInput(), except that if the input is a color filter node that doesn't affect
+     *  transparent black, this skips that node: it returns the node's own input, and sets
+     *  "colorFilter" to the node's color filter, for the caller to apply as it draws the result.
+     *  That fuses the color filter into the caller's pass, saving an intermediate image.
+     *  Otherwise "colorFilter" is set to null.
+     */
+    sk_sp<SkSpecialImage> filterInputFusingColorFilter(int index,
+                                                       SkSpecialImage* src,
+                                                       const Context&,
+                                                       SkIPoint* offset,
+                                                       sk_sp<SkColorFilter>* colorFilter) const;
+
     /**
      *  Return true (and return a ref'd colorfilter) if this node in the DAG is just a
      *  colorfilter w/o CropRect constraints.
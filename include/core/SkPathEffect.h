@@ -153,12 +153,19 @@ public:
     virtual bool exposedInAndroidJavaAPI() const { return false; }
 #endif
 
+    /**
+     *  Returns an ID that no other path effect has, e.g. to cache the results of filterPath().
+     */
+    uint32_t uniqueID() const { return fUniqueID; }
+
     SK_DECLARE_FLATTENABLE_REGISTRAR_GROUP()
 
 protected:
-    SkPathEffect() {}
+    SkPathEffect();
 
 private:
+    uint32_t fUniqueID;
+
     // illegal
     SkPathEffect(const SkPathEffect&);
     SkPathEffect& operator=(const SkPathEffect&);
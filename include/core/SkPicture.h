@@ -12,6 +12,7 @@
 #include "SkRect.h"
 #include "SkTypes.h"
 
+class SkBBHFactory;
 class SkBigPicture;
 class SkCanvas;
 class SkData;
@@ -20,6 +21,7 @@ class SkImage;
 class SkPictureData;
 class SkReadBuffer;
 class SkRefCntSet;
+class SkRegion;
 struct SkSerialProcs;
 class SkStream;
 class SkTypefacePlayback;
@@ -79,6 +81,17 @@ public:
     */
     virtual void playback(SkCanvas*, AbortCallback* = nullptr) const = 0;
 
+    /** Replays the drawing commands on the specified canvas, clipped to damage, in the
+        canvas's device pixels. This redraws only what's in damage, such as the damage that
+        SkSurface::takeDamage() returns. If this picture was recorded with a bounding box
+        hierarchy, only the commands that may draw within the bounds of damage are replayed.
+        @param canvas the canvas receiving the drawing commands.
+        @param damage the device pixels to redraw
+        @param callback a callback that allows interruption of playback
+    */
+    void playbackDamage(SkCanvas* canvas, const SkRegion& damage,
+                        AbortCallback* callback = nullptr) const;
+
     /** Return a cull rect for this picture.
         Ops recorded into this picture that attempt to draw outside the cull might not be drawn.
      */
@@ -121,6 +134,7 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkLazyPicture;
     template <typename> friend class SkMiniPicture;
 
     void serialize(SkWStream*, const SkSerialProcs*, SkRefCntSet* typefaces) const;
@@ -169,15 +183,18 @@ private:
     // V60: Remove flags in picture header
     // V61: Change SkDrawPictureRec to take two colors rather than two alphas
     // V62: Don't negate size of custom encoded images (don't write origin x,y either)
+    // V63: Align tags, so op data and buffers can be read in place from memory
+    // V64: Prefix sub-pictures in streams with their size
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t     MIN_PICTURE_VERSION = 56;     // august 2017
-    static const uint32_t CURRENT_PICTURE_VERSION = 62;
+    static const uint32_t CURRENT_PICTURE_VERSION = 64;
 
     static bool IsValidPictInfo(const SkPictInfo& info);
     static sk_sp<SkPicture> Forwardport(const SkPictInfo&,
                                         const SkPictureData*,
-                                        SkReadBuffer* buffer);
+                                        SkReadBuffer* buffer,
+                                        SkBBHFactory* = nullptr);
 
     SkPictInfo createHeader() const;
     SkPictureData* backport() const;
@@ -12,6 +12,8 @@
 #include "SkPicture.h"
 #include "SkRefCnt.h"
 
+#include <vector>
+
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
 namespace android {
     class Picture;
@@ -38,6 +40,9 @@ public:
     };
 
     enum FinishFlags {
+        // Find the draws that are entirely covered by opaque draws recorded after them, so that
+        // playback can skip them. This costs a pass over the recording when it is finished.
+        kCullOccludedDraws_FinishFlag       = 1 << 0,
     };
 
     /** Returns the canvas that records the drawing commands.
@@ -62,6 +67,24 @@ public:
     */
     SkCanvas* getRecordingCanvas();
 
+    /**
+     *  Returns a canvas that records into its own buffer, so that it can be drawn to on another
+     *  thread while the canvas from beginRecording() and other sub-recording canvases are in use.
+     *  It has the same cull rect as the canvas from beginRecording(), and starts out with an
+     *  identity matrix.
+     *
+     *  finishRecordingAsPicture() appends the sub-recordings to the main recording, in the order
+     *  they were begun, without copying the recorded commands. Each recording is played back with
+     *  the matrix and clip of the picture's playback, so state left over in one does not affect
+     *  the next. The sub-recordings are optimized and bounded in parallel on the default
+     *  SkExecutor.
+     *
+     *  Must be called on the thread that owns the recorder, after beginRecording(). All drawing
+     *  to sub-recording canvases must be done before the recording is finished, which invalidates
+     *  them. Sub-recordings are ignored by finishRecordingAsDrawable().
+     */
+    SkCanvas* beginSubRecording();
+
     /**
      *  Signal that the caller is done recording. This invalidates the canvas returned by
      *  beginRecording/getRecordingCanvas. Ownership of the object is passed to the caller, who
@@ -117,6 +140,9 @@ private:
     std::unique_ptr<SkRecorder> fRecorder;
     sk_sp<SkRecord>             fRecord;
     std::unique_ptr<SkMiniRecorder> fMiniRecorder;
+    // Recorders from beginSubRecording(), each recording into its own SkRecord.
+    std::vector<std::unique_ptr<SkRecorder>> fSubRecorders;
+    std::vector<sk_sp<SkRecord>>             fSubRecords;
 
     typedef SkNoncopyable INHERITED;
 };
@@ -13,6 +13,7 @@
 #include "SkImageInfo.h"
 
 class SkData;
+class SkExecutor;
 struct SkMask;
 
 /** \class SkPixmap
@@ -539,6 +540,9 @@ public:
         If behavior is SkTransferFunctionBehavior::kIgnore: source
         pixels are treated as if they are linear, regardless of how they are encoded.
 
+        If executor is not nullptr, large copies are split into bands of rows that are
+        converted in parallel on executor. readPixels() returns once all bands are copied.
+
         @param dstInfo      destination width, height, SkColorType, SkAlphaType, SkColorSpace
         @param dstPixels    destination pixel storage
         @param dstRowBytes  destination row length
@@ -546,10 +550,12 @@ public:
         @param srcY         row index whose absolute value is less than height()
         @param behavior     one of: SkTransferFunctionBehavior::kRespect,
                             SkTransferFunctionBehavior::kIgnore
+        @param executor     runs bands of rows in parallel; may be nullptr
         @return             true if pixels are copied to dstPixels
     */
     bool readPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
-                    int srcX, int srcY, SkTransferFunctionBehavior behavior) const;
+                    int srcX, int srcY, SkTransferFunctionBehavior behavior,
+                    SkExecutor* executor = nullptr) const;
 
     /** Copies a SkRect of pixels to dstPixels. Copy starts at (0, 0), and does not
         exceed SkPixmap (width(), height()).
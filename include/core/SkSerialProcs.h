@@ -12,6 +12,8 @@
 #include "SkPicture.h"
 #include "SkTypeface.h"
 
+class SkExecutor;
+
 /**
  *  A serial-proc is asked to serialize the specified object (e.g. picture or image).
  *  If a data object is returned, it will be used (even if it is zero-length).
@@ -56,6 +58,12 @@ struct SK_API SkSerialProcs {
 
     SkSerialTypefaceProc fTypefaceProc = nullptr;
     void*                fTypefaceCtx = nullptr;
+
+    /**
+     *  If not null, the pictures nested in a picture are serialized in parallel on this executor,
+     *  and written in order. The image and typeface procs may then be called from its threads.
+     */
+    SkExecutor*          fExecutor = nullptr;
 };
 
 struct SK_API SkDeserialProcs {
@@ -67,6 +75,20 @@ struct SK_API SkDeserialProcs {
 
     SkDeserialTypefaceProc  fTypefaceProc = nullptr;
     void*                   fTypefaceCtx = nullptr;
+
+    /**
+     *  If true, pictures nested in a picture stream are kept in their serialized form and only
+     *  deserialized the first time they are drawn, and the loaded pictures get a bounding box
+     *  hierarchy, so playing back a small part of a large picture only parses what it draws.
+     *  The procs and their contexts must then stay valid for the lifetime of the picture.
+     */
+    bool                    fLazyPictures = false;
+
+    /**
+     *  If not null, typefaces and images are created on this executor while the rest of the
+     *  picture is parsed. The image and typeface procs may then be called from its threads.
+     */
+    SkExecutor*             fExecutor = nullptr;
 };
 
 #endif
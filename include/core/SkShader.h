@@ -20,6 +20,7 @@ class SkBitmap;
 class SkColorFilter;
 class SkColorSpace;
 class SkColorSpaceXformer;
+class SkExecutor;
 class SkImage;
 class SkPath;
 class SkPicture;
@@ -267,10 +268,16 @@ public:
      *              affected by localMatrix and does not imply scaling (only translation
      *              and cropping). If null, the tile rect is considered equal to the picture
      *              bounds.
+     *  @param executor If not null, the tile is rasterized at scales rounded up to quarter
+     *              octaves, and a scale that isn't cached yet is rasterized on this executor
+     *              while draws use the nearest scale that is. Later draws then pick up the
+     *              exact scale. The first draw still rasterizes on the drawing thread. The
+     *              executor must outlive the shader.
      *  @return     Returns a new shader object. Note: this function never returns null.
     */
     static sk_sp<SkShader> MakePictureShader(sk_sp<SkPicture> src, TileMode tmx, TileMode tmy,
-                                             const SkMatrix* localMatrix, const SkRect* tile);
+                                             const SkMatrix* localMatrix, const SkRect* tile,
+                                             SkExecutor* executor = nullptr);
 
     /**
      *  If this shader can be represented by another shader + a localMatrix, return that shader and
@@ -143,6 +143,15 @@ public:
     //TODO: replace with virtual const SkData* getData()
     virtual const void* getMemoryBase() { return nullptr; }
 
+    /** Returns the address of the next bytes to be read, if they're in memory, and sets size to
+     *  how many of them follow contiguously there. Streams whose data is in several pieces of
+     *  memory, like those from SkRWBuffer, return one piece at a time. The bytes stay valid while
+     *  the stream does, and the position does not change.
+     *  If this cannot be done, or there are no more bytes, returns NULL and leaves size alone.
+     *  By default, uses getMemoryBase().
+     */
+    virtual const void* getMemoryChunk(size_t* size);
+
 private:
     virtual SkStream* onDuplicate() const { return nullptr; }
     virtual SkStream* onFork() const { return nullptr; }
@@ -14,6 +14,8 @@
 
 #include "GrTypes.h"
 
+#include <vector>
+
 class SkCanvas;
 class SkDeferredDisplayList;
 class SkPaint;
@@ -407,6 +409,30 @@ public:
     */
     void notifyContentWillChange(ContentChangeMode mode);
 
+    /** Starts or stops tracking damage: the pixels of SkSurface that change. While tracking,
+        each draw to the canvas from getCanvas(), each writePixels(), and each
+        notifyContentWillChange() adds to the damage the bounds of what it may change, within
+        the clip. Bounds are conservative; a draw whose paint can't bound it damages all of the
+        clip. Draws to a layer damage SkSurface as the layer is restored. Starting clears the
+        damage. SkSurface does not track damage by default.
+
+        Combined with SkPicture::playback() of a region, a client can repaint only what changed.
+
+        @param track  true to track damage
+    */
+    void setTrackDamage(bool track);
+
+    /** Returns the bounds of the damage since tracking started or since the last call, and
+        clears it. Returns the bounds of SkSurface if not tracking damage.
+
+        If rects is not nullptr, it is set to a few rects that together cover the damage,
+        typically more tightly than their union does; they may overlap.
+
+        @param rects  storage for rects covering the damage; may be nullptr
+        @return       bounds of the damage; may be empty
+    */
+    SkIRect takeDamage(std::vector<SkIRect>* rects = nullptr);
+
     enum BackendHandleAccess {
         kFlushRead_BackendHandleAccess,    //!< Caller may read from the back-end object.
         kFlushWrite_BackendHandleAccess,   //!< Caller may write to the back-end object.
@@ -741,6 +767,23 @@ public:
     */
     bool draw(SkDeferredDisplayList* deferredDisplayList);
 
+    /** Draws count deferred display lists, each into the SkSurface at the same index, as if
+        by surfaces[i]->draw(deferredDisplayLists[i]), and then flushes their GrContext once.
+        The ops of every deferred display list are ordered and flushed together, so tiles of
+        one frame can be submitted without a flush each.
+
+        Has no effect and returns false if any SkSurface is not a GPU surface of the same
+        GrContext as the others, if any deferred display list is not compatible with its
+        SkSurface, or if a deferred display list appears more than once.
+
+        @param count                 number of SkSurface and deferred display list pairs
+        @param surfaces              destinations, one per deferred display list
+        @param deferredDisplayLists  drawing commands
+        @return                      false if the batch was not drawn
+    */
+    static bool DrawBatch(int count, SkSurface* const surfaces[],
+                          SkDeferredDisplayList* const deferredDisplayLists[]);
+
 protected:
     SkSurface(int width, int height, const SkSurfaceProps* surfaceProps);
     SkSurface(const SkImageInfo& imageInfo, const SkSurfaceProps* surfaceProps);
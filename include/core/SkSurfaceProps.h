@@ -52,6 +52,34 @@ class SK_API SkSurfaceProps {
 public:
     enum Flags {
         kUseDeviceIndependentFonts_Flag = 1 << 0,
+        /**
+         *  Raster canvases with this flag keep the composited result of picture layers in the
+         *  SkResourceCache, and draw them from there when a picture is drawn again the same way.
+         *  Only for pictures whose layer contents don't change between draws (e.g. they don't
+         *  draw images backed by pixels that are later changed). GPU canvases use
+         *  GrContextOptions::fCachePictureLayers instead.
+         */
+        kCachePictureLayers_Flag        = 1 << 1,
+        /**
+         *  Raster canvases with this flag remember where they placed each text blob's glyphs, and
+         *  redraws of the same blob under the same matrix skip finding and positioning the glyphs
+         *  again. See SkTextBlobRasterCache.
+         */
+        kCacheTextBlobs_Flag            = 1 << 2,
+        /**
+         *  Raster surfaces of 4MB or more made with this flag share pages with their snapshots,
+         *  so drawing after a snapshot copies only the pages it touches (Linux only). Each such
+         *  surface keeps a file descriptor open, its pixels are shared with child processes
+         *  forked while it's alive, and copies read /proc/self/pagemap. See SkCOWPixelRef.
+         */
+        kCopyOnWritePixels_Flag         = 1 << 3,
+        /**
+         *  Raster canvases with this flag filter images in tiles, and keep the tiles by the
+         *  source pixels they read, so a filtered layer or image that is scrolled by whole pixels
+         *  only filters the tiles that scroll into view. This costs a hash of each tile's input
+         *  on every draw. See SkImageFilter::filterImageTiled().
+         */
+        kCacheImageFilterTiles_Flag     = 1 << 4,
     };
     /** Deprecated alias used by Chromium. Will be removed. */
     static const Flags kUseDistanceFieldFonts_Flag = kUseDeviceIndependentFonts_Flag;
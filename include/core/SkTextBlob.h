@@ -110,13 +110,20 @@ private:
         fCacheID.store(cacheID);
     }
 
+    // Likewise for the raster backend's cache of placed glyphs.
+    void notifyAddedToRasterCache() const {
+        fAddedToRasterCache.store(true);
+    }
+
     friend class GrTextBlobCache;
     friend class SkTextBlobBuilder;
+    friend class SkTextBlobRasterCache;
     friend class SkTextBlobRunIterator;
 
     const SkRect               fBounds;
     const uint32_t             fUniqueID;
     mutable SkAtomic<uint32_t> fCacheID;
+    mutable SkAtomic<bool>     fAddedToRasterCache;
 
     SkDEBUGCODE(size_t fStorageSize;)
 
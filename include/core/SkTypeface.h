@@ -311,6 +311,14 @@ protected:
     virtual void onFilterRec(SkScalerContextRec*) const = 0;
     friend class SkScalerContext;  // onFilterRec
 
+    /** Returns true if the advances of the scaler contexts made for the filtered rec are the ones
+     *  in the 'hmtx' table scaled to size pixels per em, so text can be measured without them.
+     */
+    virtual bool onGetLinearAdvanceSize(const SkScalerContextRec&, SkScalar* size) const {
+        return false;
+    }
+    friend class SkAdvanceCache;  // onGetLinearAdvanceSize
+
     //  Subclasses *must* override this method to work with the PDF backend.
     virtual std::unique_ptr<SkAdvancedTypefaceMetrics> onGetAdvancedMetrics() const;
     // For type1 postscript fonts only, set the glyph names for each glyph.
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRuntimeShader_DEFINED
+#define SkRuntimeShader_DEFINED
+
+#include "SkShader.h"
+
+/** \class SkRuntimeShader
+
+    SkRuntimeShader makes shaders whose colors are computed by an SkSL program supplied at
+    runtime, for drawing to raster surfaces. The program must define
+
+        void main(float x, float y, inout float r, inout float g, inout float b, inout float a)
+
+    which sets r, g, b and a, starting at 0, to the premultiplied color of the shader at local
+    coordinates (x, y).
+
+    Programs are compiled once, and shared by all the shaders made from the same SkSL. When Skia
+    is built with LLVM, they are just-in-time compiled into a raster pipeline stage; otherwise
+    the SkSL interpreter runs them on a batch of pixels at a time, and it only runs scalar int,
+    float and bool code, with if and for statements and no function calls.
+*/
+class SK_API SkRuntimeShader {
+public:
+    /**
+     *  Returns nullptr if the program doesn't compile, doesn't define main() as above, or can't
+     *  be run. SkSL is built with the GPU backend, so without it this always returns nullptr.
+     */
+    static sk_sp<SkShader> Make(const char* sksl);
+
+    SK_DECLARE_FLATTENABLE_REGISTRAR_GROUP()
+
+private:
+    SkRuntimeShader() = delete;
+};
+
+#endif
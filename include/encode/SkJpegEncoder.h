@@ -10,6 +10,7 @@
 
 #include "SkEncoder.h"
 
+class SkExecutor;
 class SkJpegEncoderMgr;
 class SkWStream;
 
@@ -62,6 +63,17 @@ public:
          */
         AlphaOption fAlphaOption = AlphaOption::kIgnore;
         SkTransferFunctionBehavior fBlendBehavior = SkTransferFunctionBehavior::kRespect;
+
+        /**
+         *  If non-null, Encode() color converts and compresses bands of MCU rows on this
+         *  executor.  The bands are separated by restart markers and use the standard Huffman
+         *  tables, so the output matches an encode with that restart interval and without
+         *  optimized Huffman tables.
+         *
+         *  The band size only depends on the image, so the output is the same for any number
+         *  of threads.  This is ignored by Make().
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
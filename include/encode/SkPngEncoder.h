@@ -11,6 +11,7 @@
 #include "SkEncoder.h"
 #include "SkDataTable.h"
 
+class SkExecutor;
 class SkPngEncoderMgr;
 class SkWStream;
 
@@ -66,6 +67,17 @@ public:
          *  and the (2i + 1)-th entry is the text for the i-th comment.
          */
         sk_sp<SkDataTable> fComments;
+
+        /**
+         *  If non-null, Encode() filters and compresses bands of rows on this executor.  The
+         *  bands are compressed as separate deflate blocks, each primed with the end of the
+         *  previous band, and are joined into a single zlib stream.
+         *
+         *  The band size only depends on the image, so the output is the same for any number
+         *  of threads.  It does differ from the output without an executor.  This is ignored
+         *  by Make().
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
@@ -96,6 +108,9 @@ protected:
 
     std::unique_ptr<SkPngEncoderMgr> fEncoderMgr;
     typedef SkEncoder INHERITED;
+
+private:
+    bool encodeInParallel(const Options&);
 };
 
 static inline SkPngEncoder::FilterFlag operator|(SkPngEncoder::FilterFlag x,
@@ -76,6 +76,29 @@ public:
 
     bool avoidStencilBuffers() const { return fAvoidStencilBuffers; }
 
+    /** Should text ops draw unchanged cached text vertices from GPU buffers they keep around? */
+    bool reuseTextVertexBuffers() const { return fReuseTextVertexBuffers; }
+
+    /** Should small raster images be packed into shared atlas textures at upload time? */
+    bool packSmallImagesInAtlas() const { return fPackSmallImagesInAtlas; }
+
+    /** Should dirty mips be regenerated for all the textures of a flush before it executes? */
+    bool batchMipMapRegeneration() const {
+        return fBatchMipMapRegeneration && fMipMapSupport;
+    }
+
+    /** Should YUV planes be uploaded by an upload scheduled at flush time? */
+    bool deferYUVPlaneUploads() const { return fDeferYUVPlaneUploads; }
+
+    /** Should the vertex and index buffers of a flush be fenced and reused by later flushes? */
+    bool useStreamingBufferRing() const {
+        return fUseStreamingBufferRing && fFenceSyncSupport && kNone_MapFlags != fMapBufferFlags &&
+               !fPreferClientSideDynamicBuffers;
+    }
+
+    /** Should picture layers be kept in the resource cache and reused? */
+    bool cachePictureLayers() const { return fCachePictureLayers; }
+
     /**
      * Indicates the capabilities of the fixed function blend unit.
      */
@@ -296,6 +319,12 @@ protected:
     bool fPreferClientSideDynamicBuffers             : 1;
     bool fPreferFullscreenClears                     : 1;
     bool fMustClearUploadedBufferData                : 1;
+    bool fReuseTextVertexBuffers                     : 1;
+    bool fPackSmallImagesInAtlas                     : 1;
+    bool fUseStreamingBufferRing                     : 1;
+    bool fCachePictureLayers                         : 1;
+    bool fBatchMipMapRegeneration                    : 1;
+    bool fDeferYUVPlaneUploads                       : 1;
 
     // Driver workaround
     bool fBlacklistCoverageCounting                  : 1;
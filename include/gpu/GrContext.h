@@ -31,6 +31,7 @@ class GrIndexBuffer;
 struct GrMockOptions;
 class GrOvalRenderer;
 class GrPath;
+class GrProgramKeyAnalysis;
 class GrProxyProvider;
 class GrRenderTargetContext;
 class GrResourceEntry;
@@ -159,6 +160,35 @@ public:
      */
     void setResourceCacheLimits(int maxResources, size_t maxResourceBytes);
 
+    /**
+     *  Spreads out the purging the GPU resource cache does to stay within its limits. Between
+     *  flushes it will release at most 'maxBytesPerFlush' bytes of resources, rather than all it
+     *  is over by at once, unless it has grown to twice its limits. This avoids long stalls when
+     *  the limits drop or a frame leaves behind many resources. Zero, the default, turns this off.
+     */
+    void setResourceCacheIncrementalPurging(size_t maxBytesPerFlush);
+
+    /**
+     *  Reports how long the last frame took to draw, and how long it had. When incremental purging
+     *  is on, the cache does none of it after frames that missed their target (unless it is past
+     *  twice its limits), leaving it for frames with time to spare.
+     */
+    void reportFrameTime(std::chrono::microseconds frameTime,
+                         std::chrono::microseconds targetFrameTime);
+
+    enum class MemoryPressureLevel {
+        kModerate,
+        kCritical,
+    };
+
+    /**
+     *  Call when the system asks the app to use less memory. On moderate pressure all unlocked
+     *  scratch resources are purged, and resources with persistent data are kept. On critical
+     *  pressure all unlocked resources are purged, and the backend also releases memory it holds
+     *  on to for reuse. Neither waits for a flush or for incremental purging.
+     */
+    void notifyMemoryPressure(MemoryPressureLevel);
+
     /**
      * Frees GPU created by the context. Can be called to reduce GPU memory
      * pressure.
@@ -277,7 +307,10 @@ public:
     GrContextPriv contextPriv();
     const GrContextPriv contextPriv() const;
 
-    /** Enumerates all cached GPU resources and dumps their memory to traceMemoryDump. */
+    /**
+     * Enumerates all cached GPU resources and dumps their memory to traceMemoryDump. Also dumps
+     * the text blob cache, including its hit, miss and purge counts for the last flush.
+     */
     // Chrome is using this!
     void dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const;
 
@@ -325,6 +358,8 @@ private:
 
     GrContextOptions::PersistentCache*      fPersistentCache;
 
+    std::unique_ptr<GrProgramKeyAnalysis>   fProgramKeyAnalysis;
+
     // TODO: have the GrClipStackClip use renderTargetContexts and rm this friending
     friend class GrContextPriv;
 
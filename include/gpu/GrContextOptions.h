@@ -32,7 +32,9 @@ struct GrContextOptions {
     /**
      * Abstract class which stores Skia data in a cache that persists between sessions. Currently,
      * Skia stores compiled shader binaries (only when glProgramBinary / glGetProgramBinary are
-     * supported) when provided a persistent cache, but this may extend to other data in the future.
+     * supported), and the SPIR-V of its Vulkan shaders and the data of its VkPipelineCache, when
+     * provided a persistent cache, but this may extend to other data in the future. Keys include the driver that made the data, so a
+     * driver update starts from an empty cache rather than a stale one.
      */
     class PersistentCache {
     public:
@@ -87,6 +89,23 @@ struct GrContextOptions {
      */
     bool fAllowPathMaskCaching = true;
 
+    /**
+     * If true, the coverage counting path renderer keeps the masks of non-volatile paths from one
+     * flush to the next, and draws them again without re-rendering them when the path is drawn
+     * with the same view matrix, up to integer translation. This also lets it draw the paths that
+     * fAllowPathMaskCaching would otherwise leave to the software path renderer's mask cache.
+     */
+    bool fCacheCoverageCountingPathMasks = false;
+
+    /**
+     * If true, along with fAllowPathMaskCaching, the software path renderer also caches the masks
+     * of paths that are mostly clipped out. These are keyed by the path, the view matrix and the
+     * integer device bounds of the visible part, so they are reused when a complex path is drawn
+     * again under the same clip. As with other software masks, they are rasterized in parallel on
+     * fExecutor when there is one.
+     */
+    bool fCacheClippedSoftwarePathMasks = false;
+
     /**
      * If true, sRGB support will not be enabled unless sRGB decoding can be disabled (via an
      * extension). If mixed use of "legacy" mode and sRGB/color-correct mode is not required, this
@@ -125,6 +144,56 @@ struct GrContextOptions {
      */
     Enable fAllowMultipleGlyphCacheTextures = Enable::kDefault;
 
+    /**
+     * If true, the glyph atlases keep glyphs that were evicted and are needed again in plots apart
+     * from glyphs that have only been used once. Evicting the least recently used plots then
+     * mostly removes glyphs that have scrolled away, which reduces re-uploads for scrolling text.
+     */
+    bool fPackGlyphsByLifetime = false;
+
+    /**
+     * If true, bitmap text that is drawn again from the text blob cache keeps its vertices in a
+     * GPU buffer. When the text has only moved, e.g. while scrolling, the buffer is drawn with a
+     * translation instead of uploading the vertices again.
+     */
+    bool fReuseTextVertexBuffers = false;
+
+    /**
+     * If true, small raster images drawn with simple paints are copied into a few shared atlas
+     * textures when they are first uploaded. Grids of many distinct images can then be drawn
+     * with a single texture and batched into one draw.
+     */
+    bool fPackSmallImagesInAtlas = false;
+
+    /**
+     * If true, the dynamic vertex and index buffers used by a flush are kept behind a fence and
+     * reused by a later flush once the GPU is done with them. Vertex data is then written directly
+     * into mapped buffers rather than staged in CPU memory and uploaded. Only has an effect when
+     * the backend supports fences and buffer mapping.
+     */
+    bool fUseStreamingBufferRing = false;
+
+    /**
+     * If true, the filtered contents of picture layers drawn with a simple clip are kept in the
+     * resource cache, keyed by picture, layer and matrix, and reused when the picture is drawn
+     * again the same way. See SkPictureLayerCache.
+     */
+    bool fCachePictureLayers = false;
+
+    /**
+     * If true, the dirty mip levels of the textures sampled in a flush are regenerated together
+     * before any op list executes, instead of one texture at a time by the first draw that samples
+     * each of them.
+     */
+    bool fBatchMipMapRegeneration = false;
+
+    /**
+     * If true, the Y, U and V planes of images decoded to YUV are uploaded from the decoded planes
+     * by an upload scheduled at flush time, rather than through raster images that keep the decoded
+     * planes alive for as long as their texture proxies.
+     */
+    bool fDeferYUVPlaneUploads = false;
+
     /**
      * Bugs on certain drivers cause stencil buffers to leak. This flag causes Skia to avoid
      * allocating stencil buffers and use alternate rasterization paths, avoiding the leak.
@@ -170,6 +239,30 @@ struct GrContextOptions {
      */
     Enable fSortRenderTargets = Enable::kDefault;
 
+    /**
+     * When explicitly allocating resources, let an approx-fit proxy (such as an intermediate
+     * render target) take a larger compatible surface that an earlier proxy in the flush is done
+     * with, rather than only one that rounds to the same size. This trades some memory per
+     * surface for fewer surfaces when many differently sized intermediates have disjoint lifetimes.
+     */
+    bool fReuseLargerSurfacesForApproxFit = false;
+
+    /**
+     * Keep the bounds of the ops recorded into each render target opList in a spatial index, so
+     * that a new op can be combined with any earlier op of its kind that it may be reordered
+     * with, rather than only with the last few ops. This costs some CPU per op, and helps
+     * content with many interleaved draws of a few kinds.
+     */
+    bool fIndexOpBoundsForCombining = false;
+
+    /**
+     * On Vulkan, encode the secondary command buffers of render target flushes on fExecutor, in
+     * parallel with each other and with recording the rest of the flush. Draws are still prepared
+     * on the thread that flushes; only the encoding of their Vulkan commands moves. This has no
+     * effect without an fExecutor, or on other backends.
+     */
+    bool fEncodeVulkanCommandsOnExecutor = false;
+
     /**
      * Disables correctness workarounds that are enabled for particular GPUs, OSes, or drivers.
      * This does not affect code path choices that are made for perfomance reasons nor does it
@@ -182,6 +275,13 @@ struct GrContextOptions {
      */
     PersistentCache* fPersistentCache = nullptr;
 
+    /**
+     * Program key bits to replace with uniforms. Each one set here makes the programs that differed
+     * only in that bit into one program, which sets a uniform and does a little more shader work
+     * per draw. This trades some GPU time for fewer shader compiles and a smaller program cache.
+     */
+    GrUniformKeyBits fUniformKeyBits = GrUniformKeyBits::kNone;
+
 #if GR_TEST_UTILS
     /**
      * Private options that are only meant for testing within Skia's tools.
@@ -223,6 +323,12 @@ struct GrContextOptions {
      * supported GPUs.
      */
     bool fDisableImageMultitexturing = false;
+
+    /**
+     * Records the key and SkSL of every program the context builds, so that
+     * GrContextPriv::dumpProgramKeyAnalysis() can report which key bits change the SkSL.
+     */
+    bool fAnalyzeProgramKeys = false;
 #endif
 
 #if SK_SUPPORT_ATLAS_TEXT
@@ -238,6 +238,9 @@ public:
 
     GrGLSLGeneration generation() const { return fGLSLGeneration; }
 
+    /** Program key bits that are replaced by uniforms. */
+    GrUniformKeyBits uniformKeyBits() const { return fUniformKeyBits; }
+
 private:
     void applyOptionsOverrides(const GrContextOptions& options);
 
@@ -303,6 +306,8 @@ private:
 
     size_t fDisableImageMultitexturingDstRectAreaThreshold;
 
+    GrUniformKeyBits fUniformKeyBits;
+
     AdvBlendEqInteraction fAdvBlendEqInteraction;
 
     GrSwizzle fConfigTextureSwizzle[kGrPixelConfigCnt];
@@ -119,6 +119,7 @@ typedef GrGLvoid (* GrGLLinkProgramProc)(GrGLuint program);
 typedef GrGLvoid* (* GrGLMapBufferProc)(GrGLenum target, GrGLenum access);
 typedef GrGLvoid* (* GrGLMapBufferRangeProc)(GrGLenum target, GrGLintptr offset, GrGLsizeiptr length, GrGLbitfield access);
 typedef GrGLvoid* (* GrGLMapBufferSubDataProc)(GrGLuint target, GrGLintptr offset, GrGLsizeiptr size, GrGLenum access);
+typedef GrGLvoid (* GrGLMaxShaderCompilerThreadsProc)(GrGLuint count);
 typedef GrGLvoid* (* GrGLMapTexSubImage2DProc)(GrGLenum target, GrGLint level, GrGLint xoffset, GrGLint yoffset, GrGLsizei width, GrGLsizei height, GrGLenum format, GrGLenum type, GrGLenum access);
 typedef GrGLvoid (* GrGLPixelStoreiProc)(GrGLenum pname, GrGLint param);
 typedef GrGLvoid (* GrGLPolygonModeProc)(GrGLenum face, GrGLenum mode);
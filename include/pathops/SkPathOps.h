@@ -11,6 +11,7 @@
 #include "../private/SkTDArray.h"
 #include "SkPreConfig.h"
 
+class SkExecutor;
 class SkPath;
 struct SkRect;
 
@@ -45,6 +46,14 @@ enum SkPathOp {
   */
 bool SK_API Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result);
 
+/** Like Op(), but finds where the operands' curves cross on the executor's threads. The result is
+    the same as Op()'s; this only pays off for operands with many segments.
+
+    @param executor Runs the intersection tasks. If null, this is the same as Op().
+  */
+bool SK_API Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+               SkExecutor* executor);
+
 /** Set this path to a set of non-overlapping contours that describe the
     same area as the original path.
     The curve order is reduced where possible so that cubics may
@@ -59,6 +68,29 @@ bool SK_API Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
   */
 bool SK_API Simplify(const SkPath& path, SkPath* result);
 
+/** Like Simplify(), but finds where the path's curves cross on the executor's threads. The result
+    is the same as Simplify()'s.
+
+    @param executor Runs the intersection tasks. If null, this is the same as Simplify().
+  */
+bool SK_API Simplify(const SkPath& path, SkPath* result, SkExecutor* executor);
+
+/** Set result to the union of count paths. This is much faster than SkOpBuilder for many paths:
+    paths whose bounds don't overlap are appended rather than unioned, and the rest are unioned
+    pairwise in a balanced tree. With an executor, independent unions run in parallel.
+
+    Returns true if operation was able to produce a result;
+    otherwise, result is unmodified.
+
+    @param paths The paths to union.
+    @param count The number of paths.
+    @param result The union of the paths. The result may be one of the inputs.
+    @param executor Runs independent unions in parallel, if not null.
+    @return True if the operation succeeded.
+  */
+bool SK_API Union(const SkPath paths[], int count, SkPath* result,
+                  SkExecutor* executor = nullptr);
+
 /** Set the resulting rectangle to the tight bounds of the path.
 
     @param path The path measured.
@@ -87,6 +119,14 @@ public:
       */
     bool resolve(SkPath* result);
 
+    /** Like resolve(), but runs each path operation on the executor's threads.
+
+        @param result The product of the operands.
+        @param executor Runs the intersection tasks. If null, this is the same as resolve().
+        @return True if the operation succeeded.
+      */
+    bool resolve(SkPath* result, SkExecutor* executor);
+
 private:
     SkTArray<SkPath> fPathRefs;
     SkTDArray<SkPathOp> fOps;
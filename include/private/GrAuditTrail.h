@@ -85,6 +85,36 @@ public:
 
     void opsCombined(const GrOp* consumer, const GrOp* consumed);
 
+    // What happened each time an opList asked two ops to combine.
+    enum class CombineOutcome {
+        kCombined,
+        kDifferentClass,
+        kPipelineMismatch,   // the ops have different applied clips or dst copies
+        kOpRefused,          // same class, but the ops' processors or state don't fit together
+    };
+
+    // Why an opList stopped looking for an op to combine with, short of running out of ops.
+    enum class CombineSearchEnd {
+        kOverlap,            // the next op overlaps, so we can't reorder past it
+        kLimit,              // we looked back, or ahead, as far as we're willing to
+    };
+
+    void combineAttempted(CombineOutcome);
+    void combineSearchEnded(CombineSearchEnd);
+
+    // Counts of the above since the last fullReset().
+    struct CombineStats {
+        int fAttempts = 0;
+        int fCombined = 0;
+        int fDifferentClass = 0;
+        int fPipelineMismatch = 0;
+        int fOpRefused = 0;
+        int fStoppedAtOverlap = 0;
+        int fStoppedAtLimit = 0;
+    };
+
+    const CombineStats& combineStats() const { return fCombineStats; }
+
     // Because op combining is heavily dependent on sequence of draw calls, these calls will only
     // produce valid information for the given draw sequence which preceeded them. Specifically, ops
     // of future draw calls may combine with previous ops and thus would invalidate the json. What
@@ -157,6 +187,7 @@ private:
     SkTHashMap<int, Ops*> fClientIDLookup;
     OpList fOpList;
     SkTArray<SkString> fCurrentStackTrace;
+    CombineStats fCombineStats;
 
     // The client can pass in an optional client ID which we will use to mark the ops
     int fClientID;
@@ -180,6 +211,12 @@ private:
 #define GR_AUDIT_TRAIL_OPS_RESULT_COMBINED(audit_trail, combineWith, op) \
     GR_AUDIT_TRAIL_INVOKE_GUARD(audit_trail, opsCombined, combineWith, op);
 
+#define GR_AUDIT_TRAIL_COMBINE_ATTEMPTED(audit_trail, outcome) \
+    GR_AUDIT_TRAIL_INVOKE_GUARD(audit_trail, combineAttempted, outcome);
+
+#define GR_AUDIT_TRAIL_COMBINE_SEARCH_ENDED(audit_trail, end) \
+    GR_AUDIT_TRAIL_INVOKE_GUARD(audit_trail, combineSearchEnded, end);
+
 #define GR_AUDIT_TRAIL_OP_RESULT_NEW(audit_trail, op) // Doesn't do anything now, one day...
 
 #endif
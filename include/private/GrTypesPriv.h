@@ -966,6 +966,21 @@ enum class  GrMipMapsStatus {
 
 GR_MAKE_BITFIELD_CLASS_OPS(GpuPathRenderers)
 
+/**
+ * Program key bits that can be replaced by uniforms (see GrContextOptions::fUniformKeyBits).
+ */
+enum class GrUniformKeyBits {
+    kNone               = 0,
+    kIdentityViewMatrix = 1 << 0, // Geometry processors keep their view matrix uniform when it's
+                                  // the identity, rather than keying a program that skips it.
+    kSolidCoverage      = 1 << 1, // The default geometry processor keeps its coverage uniform
+                                  // when coverage is solid.
+
+    kAll                = (kSolidCoverage | (kSolidCoverage - 1))
+};
+
+GR_MAKE_BITFIELD_CLASS_OPS(GrUniformKeyBits)
+
 /**
  * We want to extend the GrPixelConfig enum to add cases for dealing with alpha_8 which is
  * internally either alpha8 or red8. Also for Gray_8 which can be luminance_8 or red_8.
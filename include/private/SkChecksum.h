@@ -47,6 +47,53 @@ public:
         hash ^= hash >> 16;
         return hash;
     }
+
+    /**
+     *  Hashes a key written a piece at a time, e.g. as it's serialized, without gathering it all
+     *  in one buffer.  The result depends only on the bytes written, not on how they were split
+     *  into write() calls, but it's not SkOpts::hash() of those bytes.
+     */
+    class Hasher : SkNoncopyable {
+    public:
+        explicit Hasher(uint32_t seed = 0) : fHash(seed) {}
+
+        void write(const void* data, size_t bytes) {
+            if (0 == bytes) {
+                return;
+            }
+            auto bytePtr = (const uint8_t*)data;
+            if (fBuffered) {
+                size_t n = SkTMin(bytes, kBlockBytes - fBuffered);
+                memcpy(fBuffer + fBuffered, bytePtr, n);
+                fBuffered += n;
+                bytePtr   += n;
+                bytes     -= n;
+                if (fBuffered < kBlockBytes) {
+                    return;
+                }
+                fHash = SkOpts::hash_fn(fBuffer, kBlockBytes, fHash);
+                fBuffered = 0;
+            }
+            // Hash whole blocks straight from data.
+            for (; bytes >= kBlockBytes; bytes -= kBlockBytes, bytePtr += kBlockBytes) {
+                fHash = SkOpts::hash_fn(bytePtr, kBlockBytes, fHash);
+            }
+            memcpy(fBuffer, bytePtr, bytes);
+            fBuffered = bytes;
+        }
+
+        void write32(uint32_t value) { this->write(&value, sizeof(value)); }
+
+        uint32_t finish() const { return SkOpts::hash_fn(fBuffer, fBuffered, fHash); }
+
+    private:
+        // Big enough for the fastest SkOpts::hash_fn to hit its stride.
+        static constexpr size_t kBlockBytes = 1024;
+
+        uint32_t fHash;
+        size_t   fBuffered = 0;
+        uint8_t  fBuffer[kBlockBytes];
+    };
 };
 
 // SkGoodHash should usually be your first choice in hashing data.
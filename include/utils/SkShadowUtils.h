@@ -41,6 +41,29 @@ public:
                            SkColor ambientColor, SkColor spotColor,
                            uint32_t flags = SkShadowFlags::kNone_ShadowFlag);
 
+    /**
+     * Draw the shadows of count occluders, as DrawShadow() would draw each in turn, sharing the
+     * light and colors. Lists of elevated items cast many shadows at once; on the GPU those of
+     * round rects are drawn together.
+     *
+     * @param canvas  The canvas on which to draw the shadows.
+     * @param paths  The occluders used to generate the shadows.
+     * @param zPlaneParams  For each occluder, the values for its plane function, as DrawShadow()
+     *  takes them.
+     * @param count  The number of occluders.
+     * @param lightPos  The 3D position of the light relative to the canvas plane. This is
+     *  independent of the canvas's current matrix.
+     * @param lightRadius  The radius of the disc light.
+     * @param ambientColor  The color of the ambient shadows.
+     * @param spotColor  The color of the spot shadows.
+     * @param flags  Options controlling opaque occluder optimizations and shadow appearance. See
+     *               SkShadowFlags.
+     */
+    static void DrawShadows(SkCanvas* canvas, const SkPath paths[], const SkPoint3 zPlaneParams[],
+                            int count, const SkPoint3& lightPos, SkScalar lightRadius,
+                            SkColor ambientColor, SkColor spotColor,
+                            uint32_t flags = SkShadowFlags::kNone_ShadowFlag);
+
     /**
      * Helper routine to compute color values for one-pass tonal alpha.
      *
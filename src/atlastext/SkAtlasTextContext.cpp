@@ -15,3 +15,21 @@ sk_sp<SkAtlasTextContext> SkAtlasTextContext::Make(sk_sp<SkAtlasTextRenderer> re
 
 SkAtlasTextContext::SkAtlasTextContext(sk_sp<SkAtlasTextRenderer> renderer)
         : fInternalContext(SkInternalAtlasTextContext::Make(std::move(renderer))) {}
+
+void SkAtlasTextContext::flush() { fInternalContext->flush(); }
+
+//////////////////////////////////////////////////////////////////////////////
+
+void SkAtlasTextRenderer::flushSDFGlyphs(void* textureHandle, const TextureUpload uploads[],
+                                         int uploadCnt, const SDFVertex vertices[], int quadCnt,
+                                         const SDFDraw draws[], int drawCnt) {
+    for (int i = 0; i < uploadCnt; ++i) {
+        this->setTextureData(textureHandle, uploads[i].fData, uploads[i].fX, uploads[i].fY,
+                             uploads[i].fWidth, uploads[i].fHeight, uploads[i].fRowBytes);
+    }
+    for (int i = 0; i < drawCnt; ++i) {
+        SkASSERT(draws[i].fFirstQuad + draws[i].fQuadCnt <= quadCnt);
+        this->drawSDFGlyphs(draws[i].fTargetHandle, textureHandle,
+                            vertices + 4 * draws[i].fFirstQuad, draws[i].fQuadCnt);
+    }
+}
@@ -68,6 +68,11 @@ void SkAtlasTextTarget::skew(SkScalar sx, SkScalar sy) { this->accessCTM()->preS
 
 void SkAtlasTextTarget::concat(const SkMatrix& matrix) { this->accessCTM()->preConcat(matrix); }
 
+void SkAtlasTextTarget::flush() {
+    this->flushToContext();
+    fContext->flush();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 static const GrColorSpaceInfo kColorSpaceInfo(nullptr, kRGBA_8888_GrPixelConfig);
@@ -99,7 +104,7 @@ public:
 
     void drawText(const SkGlyphID[], const SkPoint[], int glyphCnt, uint32_t color,
                   const SkAtlasTextFont&) override;
-    void flush() override;
+    void flushToContext() override;
 
 private:
     uint32_t fColor;
@@ -164,11 +169,10 @@ void SkInternalAtlasTextTarget::addDrawOp(const GrClip& clip, std::unique_ptr<Gr
     fOps.emplace_back(std::move(op));
 }
 
-void SkInternalAtlasTextTarget::flush() {
+void SkInternalAtlasTextTarget::flushToContext() {
     for (int i = 0; i < fOps.count(); ++i) {
         fOps[i]->executeForTextTarget(this);
     }
-    this->context()->internal().flush();
     fOps.reset();
 }
 
@@ -72,11 +72,11 @@ GrDeferredUploadToken SkInternalAtlasTextContext::addASAPUpload(
 
 void SkInternalAtlasTextContext::recordDraw(const void* srcVertexData, int glyphCnt,
                                             const SkMatrix& matrix, void* targetHandle) {
-    auto vertexDataSize = sizeof(SkAtlasTextRenderer::SDFVertex) * 4 * glyphCnt;
-    auto vertexData = fArena.makeArrayDefault<char>(vertexDataSize);
-    memcpy(vertexData, srcVertexData, vertexDataSize);
+    int firstQuad = fVertices.count() / 4;
+    auto* vertices = fVertices.append(4 * glyphCnt);
+    memcpy(vertices, srcVertexData, sizeof(SkAtlasTextRenderer::SDFVertex) * 4 * glyphCnt);
     for (int i = 0; i < 4 * glyphCnt; ++i) {
-        auto* vertex = reinterpret_cast<SkAtlasTextRenderer::SDFVertex*>(vertexData) + i;
+        auto* vertex = vertices + i;
         // GrAtlasTextContext encodes a texture index into the lower bit of each texture coord.
         // This isn't expected by SkAtlasTextRenderer subclasses.
         vertex->fTextureCoordX /= 2;
@@ -84,7 +84,7 @@ void SkInternalAtlasTextContext::recordDraw(const void* srcVertexData, int glyph
         matrix.mapHomogeneousPoints(&vertex->fPosition, &vertex->fPosition, 1);
     }
     fDraws.append(&fArena,
-                  Draw{glyphCnt, fTokenTracker.issueDrawToken(), targetHandle, vertexData});
+                  Draw{firstQuad, glyphCnt, fTokenTracker.issueDrawToken(), targetHandle});
 }
 
 void SkInternalAtlasTextContext::flush() {
@@ -98,31 +98,55 @@ void SkInternalAtlasTextContext::flush() {
                                          fDistanceFieldAtlas.fProxy->width(),
                                          fDistanceFieldAtlas.fProxy->height());
     }
+    // Uploads point at the atlas plots' own pixels. The recorded upload functions hold refs on
+    // their plots, and nothing writes to a plot during a flush, so the pointers stay good until
+    // the lists are reset below.
     GrDeferredTextureUploadWritePixelsFn writePixelsFn =
             [this](GrTextureProxy* proxy, int left, int top, int width, int height,
                    GrColorType colorType, const void* data, size_t rowBytes) -> bool {
         SkASSERT(GrColorType::kAlpha_8 == colorType);
         SkASSERT(proxy == this->fDistanceFieldAtlas.fProxy);
-        void* handle = fDistanceFieldAtlas.fTextureHandle;
-        this->fRenderer->setTextureData(handle, data, left, top, width, height, rowBytes);
+        *fUploads.append() = {data, rowBytes, left, top, width, height};
         return true;
     };
+    auto issueBatch = [this]() {
+        if (fUploads.isEmpty() && fBatchDraws.isEmpty()) {
+            return;
+        }
+        fRenderer->flushSDFGlyphs(fDistanceFieldAtlas.fTextureHandle, fUploads.begin(),
+                                  fUploads.count(), fVertices.begin(), fVertices.count() / 4,
+                                  fBatchDraws.begin(), fBatchDraws.count());
+        fUploads.rewind();
+        fBatchDraws.rewind();
+    };
     for (const auto& upload : fASAPUploads) {
         upload(writePixelsFn);
     }
     auto inlineUpload = fInlineUploads.begin();
     for (const auto& draw : fDraws) {
-        while (inlineUpload != fInlineUploads.end() && inlineUpload->fToken == draw.fToken) {
-            inlineUpload->fUpload(writePixelsFn);
-            ++inlineUpload;
+        if (inlineUpload != fInlineUploads.end() && inlineUpload->fToken == draw.fToken) {
+            // An inline upload may overwrite glyphs that the draws before it read, so those
+            // draws have to be issued first.
+            if (!fBatchDraws.isEmpty()) {
+                issueBatch();
+            }
+            do {
+                inlineUpload->fUpload(writePixelsFn);
+                ++inlineUpload;
+            } while (inlineUpload != fInlineUploads.end() && inlineUpload->fToken == draw.fToken);
+        }
+        if (!fBatchDraws.isEmpty() && fBatchDraws.top().fTargetHandle == draw.fTargetHandle) {
+            SkASSERT(fBatchDraws.top().fFirstQuad + fBatchDraws.top().fQuadCnt == draw.fFirstQuad);
+            fBatchDraws.top().fQuadCnt += draw.fGlyphCnt;
+        } else {
+            *fBatchDraws.append() = {draw.fTargetHandle, draw.fFirstQuad, draw.fGlyphCnt};
         }
-        auto vertices = reinterpret_cast<const SkAtlasTextRenderer::SDFVertex*>(draw.fVertexData);
-        fRenderer->drawSDFGlyphs(draw.fTargetHandle, fDistanceFieldAtlas.fTextureHandle, vertices,
-                                 draw.fGlyphCnt);
         fTokenTracker.flushToken();
     }
+    issueBatch();
     fASAPUploads.reset();
     fInlineUploads.reset();
     fDraws.reset();
     fArena.reset();
+    fVertices.rewind();
 }
@@ -11,13 +11,14 @@
 #include "GrDeferredUpload.h"
 #include "SkArenaAlloc.h"
 #include "SkArenaAllocList.h"
+#include "SkAtlasTextRenderer.h"
 #include "SkRefCnt.h"
+#include "SkTDArray.h"
 
 class GrContext;
 class GrGlyphCache;
 class GrTextBlobCache;
 
-class SkAtlasTextRenderer;
 class SkMatrix;
 
 /**
@@ -42,6 +43,10 @@ public:
 
     void recordDraw(const void* vertexData, int glyphCnt, const SkMatrix&, void* targetHandle);
 
+    /**
+     * Issues the recorded draws to the renderer, in as few SkAtlasTextRenderer::flushSDFGlyphs()
+     * calls as the atlas uploads allow.
+     */
     void flush();
 
 private:
@@ -60,10 +65,10 @@ private:
     };
 
     struct Draw {
+        int fFirstQuad;
         int fGlyphCnt;
         GrDeferredUploadToken fToken;
         void* fTargetHandle;
-        const void* fVertexData;
     };
 
     struct InlineUpload {
@@ -78,6 +83,12 @@ private:
     SkArenaAlloc fArena{1024 * 40};
     sk_sp<GrContext> fGrContext;
     AtlasTexture fDistanceFieldAtlas;
+
+    // The quads of every recorded draw, back to back, so a flush can hand them over as one buffer.
+    SkTDArray<SkAtlasTextRenderer::SDFVertex> fVertices;
+    // Scratch for flush().
+    SkTDArray<SkAtlasTextRenderer::TextureUpload> fUploads;
+    SkTDArray<SkAtlasTextRenderer::SDFDraw> fBatchDraws;
 };
 
 #endif
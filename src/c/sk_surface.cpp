@@ -20,6 +20,7 @@
 #include "sk_image.h"
 #include "sk_paint.h"
 #include "sk_path.h"
+#include "sk_picture.h"
 #include "sk_surface.h"
 #include "sk_types_priv.h"
 
@@ -419,6 +420,131 @@ void sk_canvas_draw_picture(sk_canvas_t* ccanvas, const sk_picture_t* cpicture,
     AsCanvas(ccanvas)->drawPicture(AsPicture(cpicture), matrixPtr, AsPaint(cpaint));
 }
 
+// Returns the paint for item i of a batch, or nullptr if its index is out of range.
+static const SkPaint* batch_paint(const int32_t paintIndices[], int i,
+                                  const sk_paint_t* const paints[], int paintCount) {
+    int32_t index = paintIndices ? paintIndices[i] : 0;
+    if (index < 0 || index >= paintCount) {
+        return nullptr;
+    }
+    return AsPaint(paints[index]);
+}
+
+void sk_canvas_draw_rects(sk_canvas_t* ccanvas, const sk_rect_t rects[],
+                          const int32_t paintIndices[], int count,
+                          const sk_paint_t* const paints[], int paintCount) {
+    SkCanvas* canvas = AsCanvas(ccanvas);
+    for (int i = 0; i < count; ++i) {
+        if (const SkPaint* paint = batch_paint(paintIndices, i, paints, paintCount)) {
+            canvas->drawRect(AsRect(rects[i]), *paint);
+        }
+    }
+}
+
+void sk_canvas_draw_paths(sk_canvas_t* ccanvas, const sk_path_t* const paths[],
+                          const int32_t paintIndices[], int count,
+                          const sk_paint_t* const paints[], int paintCount) {
+    SkCanvas* canvas = AsCanvas(ccanvas);
+    for (int i = 0; i < count; ++i) {
+        if (const SkPaint* paint = batch_paint(paintIndices, i, paints, paintCount)) {
+            canvas->drawPath(AsPath(*paths[i]), *paint);
+        }
+    }
+}
+
+void sk_canvas_draw_images(sk_canvas_t* ccanvas, const sk_image_t* const images[],
+                           const sk_point_t positions[],
+                           const int32_t paintIndices[], int count,
+                           const sk_paint_t* const paints[], int paintCount) {
+    SkCanvas* canvas = AsCanvas(ccanvas);
+    for (int i = 0; i < count; ++i) {
+        const SkPaint* paint = batch_paint(paintIndices, i, paints, paintCount);
+        if (paint || (paintIndices && paintIndices[i] == -1)) {
+            canvas->drawImage(AsImage(images[i]), positions[i].x, positions[i].y, paint);
+        }
+    }
+}
+
+static void draw_commands(SkCanvas* canvas, const sk_drawcommand_t commands[], int count,
+                          const sk_drawtables_t& tables) {
+    const int saveCount = canvas->getSaveCount();
+    for (int i = 0; i < count; ++i) {
+        const sk_drawcommand_t& cmd = commands[i];
+        const SkRect& rect = *reinterpret_cast<const SkRect*>(cmd.args);
+        const SkPaint* paint = nullptr;
+        if (cmd.paint >= 0 && cmd.paint < tables.paintCount) {
+            paint = AsPaint(tables.paints[cmd.paint]);
+        }
+        const SkImage* image = nullptr;
+        if (cmd.object >= 0 && cmd.object < tables.imageCount) {
+            image = AsImage(tables.images[cmd.object]);
+        }
+        // Images may be drawn without a paint, but only if asked for with -1.
+        const bool imagePaintOK = paint || cmd.paint == -1;
+
+        switch (cmd.op) {
+            case SAVE_SK_DRAWOP:
+                canvas->save();
+                break;
+            case RESTORE_SK_DRAWOP:
+                if (canvas->getSaveCount() > saveCount) {
+                    canvas->restore();
+                }
+                break;
+            case TRANSLATE_SK_DRAWOP:
+                canvas->translate(cmd.args[0], cmd.args[1]);
+                break;
+            case SCALE_SK_DRAWOP:
+                canvas->scale(cmd.args[0], cmd.args[1]);
+                break;
+            case CLIP_RECT_SK_DRAWOP:
+                canvas->clipRect(rect);
+                break;
+            case DRAW_PAINT_SK_DRAWOP:
+                if (paint) {
+                    canvas->drawPaint(*paint);
+                }
+                break;
+            case DRAW_RECT_SK_DRAWOP:
+                if (paint) {
+                    canvas->drawRect(rect, *paint);
+                }
+                break;
+            case DRAW_OVAL_SK_DRAWOP:
+                if (paint) {
+                    canvas->drawOval(rect, *paint);
+                }
+                break;
+            case DRAW_CIRCLE_SK_DRAWOP:
+                if (paint) {
+                    canvas->drawCircle(cmd.args[0], cmd.args[1], cmd.args[2], *paint);
+                }
+                break;
+            case DRAW_PATH_SK_DRAWOP:
+                if (paint && cmd.object >= 0 && cmd.object < tables.pathCount) {
+                    canvas->drawPath(AsPath(*tables.paths[cmd.object]), *paint);
+                }
+                break;
+            case DRAW_IMAGE_SK_DRAWOP:
+                if (image && imagePaintOK) {
+                    canvas->drawImage(image, cmd.args[0], cmd.args[1], paint);
+                }
+                break;
+            case DRAW_IMAGE_RECT_SK_DRAWOP:
+                if (image && imagePaintOK) {
+                    canvas->drawImageRect(image, rect, paint);
+                }
+                break;
+        }
+    }
+    canvas->restoreToCount(saveCount);
+}
+
+void sk_canvas_draw_commands(sk_canvas_t* ccanvas, const sk_drawcommand_t commands[], int count,
+                             const sk_drawtables_t* ctables) {
+    draw_commands(AsCanvas(ccanvas), commands, count, *ctables);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 sk_surface_t* sk_surface_new_raster(const sk_imageinfo_t* cinfo,
@@ -485,6 +611,14 @@ sk_picture_t* sk_picture_recorder_end_recording(sk_picture_recorder_t* crec) {
     return ToPicture(AsPictureRecorder(crec)->finishRecordingAsPicture().release());
 }
 
+sk_picture_t* sk_picture_record_commands(const sk_rect_t* ccull,
+                                         const sk_drawcommand_t commands[], int count,
+                                         const sk_drawtables_t* ctables) {
+    SkPictureRecorder recorder;
+    draw_commands(recorder.beginRecording(AsRect(*ccull)), commands, count, *ctables);
+    return ToPicture(recorder.finishRecordingAsPicture().release());
+}
+
 void sk_picture_ref(sk_picture_t* cpic) {
     SkSafeRef(AsPicture(cpic));
 }
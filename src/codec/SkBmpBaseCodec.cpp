@@ -15,3 +15,18 @@ SkBmpBaseCodec::SkBmpBaseCodec(int width, int height, const SkEncodedInfo& info,
     : INHERITED(width, height, info, std::move(stream), bitsPerPixel, rowOrder)
     , fSrcBuffer(sk_malloc_canfail(this->srcRowBytes()))
 {}
+
+const uint8_t* SkBmpBaseCodec::readSrcRow() {
+    SkStream* stream = this->stream();
+    const size_t rowBytes = this->srcRowBytes();
+    const void* memoryBase = stream->getMemoryBase();
+    if (memoryBase && stream->hasLength() && stream->hasPosition()) {
+        const size_t position = stream->getPosition();
+        if (stream->getLength() - position < rowBytes) {
+            return nullptr;
+        }
+        stream->skip(rowBytes);
+        return SkTAddOffset<const uint8_t>(memoryBase, position);
+    }
+    return stream->read(this->srcBuffer(), rowBytes) == rowBytes ? this->srcBuffer() : nullptr;
+}
@@ -30,6 +30,15 @@ protected:
 
     uint8_t* srcBuffer() { return reinterpret_cast<uint8_t*>(fSrcBuffer.get()); }
 
+    /*
+     * Reads the next srcRowBytes() of the stream. Returns nullptr if the stream
+     * ends first.
+     *
+     * If the stream has a memory base, the returned row points into it rather
+     * than into a copy in srcBuffer().
+     */
+    const uint8_t* readSrcRow();
+
 private:
     SkAutoFree fSrcBuffer;
 
@@ -79,11 +79,11 @@ int SkBmpMaskCodec::decodeRows(const SkImageInfo& dstInfo,
                                            void* dst, size_t dstRowBytes,
                                            const Options& opts) {
     // Iterate over rows of the image
-    uint8_t* srcRow = this->srcBuffer();
     const int height = dstInfo.height();
     for (int y = 0; y < height; y++) {
         // Read a row of the input
-        if (this->stream()->read(srcRow, this->srcRowBytes()) != this->srcRowBytes()) {
+        const uint8_t* srcRow = this->readSrcRow();
+        if (!srcRow) {
             SkCodecPrintf("Warning: incomplete input stream.\n");
             return y;
         }
@@ -9,6 +9,7 @@
 #include "SkCodecPriv.h"
 #include "SkColorData.h"
 #include "SkStream.h"
+#include "SkUtils.h"
 
 /*
  * Creates an instance of the decoder
@@ -233,6 +234,46 @@ void SkBmpRLECodec::setRGBPixel(void* dst, size_t dstRowBytes,
     }
 }
 
+void SkBmpRLECodec::fillRun(void* dst, size_t dstRowBytes, const SkImageInfo& dstInfo,
+                            int x, int endX, uint32_t y, SkPMColor color) {
+    if (!dst) {
+        return;
+    }
+
+    // Find the dst columns of the necessary src columns in [x, endX)
+    int dstX = x;
+    int dstEndX = endX;
+    if (fSampleX > 1) {
+        const int startX = get_start_coord(fSampleX);
+        dstX = x <= startX ? 0 : (x - startX + fSampleX - 1) / fSampleX;
+        dstEndX = endX <= startX ? 0 : (endX - startX + fSampleX - 1) / fSampleX;
+    }
+    dstEndX = SkTMin(dstEndX, dstInfo.width());
+    if (dstX >= dstEndX) {
+        return;
+    }
+
+    const uint32_t row = this->getDstRow(y, dstInfo.height());
+    switch (dstInfo.colorType()) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType: {
+            SkPMColor* dstRow = SkTAddOffset<SkPMColor>(dst, row * (int) dstRowBytes);
+            sk_memset32(dstRow + dstX, color, dstEndX - dstX);
+            break;
+        }
+        case kRGB_565_SkColorType: {
+            uint16_t* dstRow = SkTAddOffset<uint16_t>(dst, row * (int) dstRowBytes);
+            sk_memset16(dstRow + dstX, SkPixel32ToPixel16(color), dstEndX - dstX);
+            break;
+        }
+        default:
+            // This case should not be reached.  We should catch an invalid
+            // color type when we check that the conversion is possible.
+            SkASSERT(false);
+            break;
+    }
+}
+
 SkCodec::Result SkBmpRLECodec::onPrepareToDecode(const SkImageInfo& dstInfo,
         const SkCodec::Options& options) {
     // FIXME: Support subsets for scanline decodes.
@@ -496,9 +537,20 @@ int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRo
                 uint8_t blue = task;
                 uint8_t green = fStreamBuffer[fCurrRLEByte++];
                 uint8_t red = fStreamBuffer[fCurrRLEByte++];
-                while (x < endX) {
-                    setRGBPixel(dst, dstRowBytes, dstInfo, x++, y, red, green, blue);
+                SkPMColor color;
+                switch (dstInfo.colorType()) {
+                    case kRGBA_8888_SkColorType:
+                        color = SkPackARGB_as_RGBA(0xFF, red, green, blue);
+                        break;
+                    case kBGRA_8888_SkColorType:
+                        color = SkPackARGB_as_BGRA(0xFF, red, green, blue);
+                        break;
+                    default:
+                        color = SkPackARGB32NoCheck(0xFF, red, green, blue);
+                        break;
                 }
+                fillRun(dst, dstRowBytes, dstInfo, x, endX, y, color);
+                x = SkTMax(x, endX);
             } else {
                 // In RLE8 or RLE4, the second byte read gives the index in the
                 // color table to look up the pixel color.
@@ -512,9 +564,15 @@ int SkBmpRLECodec::decodeRLE(const SkImageInfo& dstInfo, void* dst, size_t dstRo
                 }
 
                 // Set the indicated number of pixels
-                for (int which = 0; x < endX; x++) {
-                    setPixel(dst, dstRowBytes, dstInfo, x, y, indices[which]);
-                    which = !which;
+                if (indices[0] == indices[1]) {
+                    fillRun(dst, dstRowBytes, dstInfo, x, endX, y,
+                            fColorTable->operator[](indices[0]));
+                    x = SkTMax(x, endX);
+                } else {
+                    for (int which = 0; x < endX; x++) {
+                        setPixel(dst, dstRowBytes, dstInfo, x, y, indices[which]);
+                        which = !which;
+                    }
                 }
             }
         }
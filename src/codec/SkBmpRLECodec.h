@@ -82,6 +82,13 @@ private:
                      const SkImageInfo& dstInfo, uint32_t x, uint32_t y,
                      uint8_t red, uint8_t green, uint8_t blue);
 
+    /*
+     * Set the pixels in [x, endX) of row y to a color in the dst's 8888
+     * order (N32 for 565), as setPixel() or setRGBPixel() would for each one
+     */
+    void fillRun(void* dst, size_t dstRowBytes, const SkImageInfo& dstInfo,
+                 int x, int endX, uint32_t y, SkPMColor color);
+
     /*
      * If dst is NULL, this is a signal to skip the rows.
      */
@@ -208,7 +208,8 @@ int SkBmpStandardCodec::decodeRows(const SkImageInfo& dstInfo, void* dst, size_t
     const int height = dstInfo.height();
     for (int y = 0; y < height; y++) {
         // Read a row of the input
-        if (this->stream()->read(this->srcBuffer(), this->srcRowBytes()) != this->srcRowBytes()) {
+        const uint8_t* srcRow = this->readSrcRow();
+        if (!srcRow) {
             SkCodecPrintf("Warning: incomplete input stream.\n");
             return y;
         }
@@ -220,10 +221,10 @@ int SkBmpStandardCodec::decodeRows(const SkImageInfo& dstInfo, void* dst, size_t
 
         if (this->xformOnDecode()) {
             SkASSERT(this->colorXform());
-            fSwizzler->swizzle(this->xformBuffer(), this->srcBuffer());
+            fSwizzler->swizzle(this->xformBuffer(), srcRow);
             this->applyColorXform(dstRow, this->xformBuffer(), fSwizzler->swizzleWidth());
         } else {
-            fSwizzler->swizzle(dstRow, this->srcBuffer());
+            fSwizzler->swizzle(dstRow, srcRow);
         }
     }
 
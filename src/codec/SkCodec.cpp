@@ -7,9 +7,11 @@
 
 #include "SkBmpCodec.h"
 #include "SkCodec.h"
+#include "SkCodecFrameCache.h"
 #include "SkCodecPriv.h"
 #include "SkColorSpace.h"
 #include "SkColorSpaceXform_Base.h"
+#include "SkCounters.h"
 #include "SkData.h"
 #include "SkFrameHolder.h"
 #include "SkGifCodec.h"
@@ -139,6 +141,8 @@ SkCodec::SkCodec(int width, int height, const SkEncodedInfo& info,
     , fOptions()
     , fCurrScanline(-1)
     , fStartedIncrementalDecode(false)
+    , fFrameCache(nullptr)
+    , fDecodingRequiredFrame(false)
 {}
 
 SkCodec::SkCodec(const SkEncodedInfo& info, const SkImageInfo& imageInfo,
@@ -154,10 +158,33 @@ SkCodec::SkCodec(const SkEncodedInfo& info, const SkImageInfo& imageInfo,
     , fOptions()
     , fCurrScanline(-1)
     , fStartedIncrementalDecode(false)
+    , fFrameCache(nullptr)
+    , fDecodingRequiredFrame(false)
 {}
 
 SkCodec::~SkCodec() {}
 
+void SkCodec::setFrameCache(size_t bytes, SkExecutor* executor,
+                            std::unique_ptr<SkCodec> prefetchCodec) {
+    // Drop the old cache first, which waits for its prefetch.
+    fOwnedFrameCache.reset();
+    fFrameCache = nullptr;
+    if (!bytes) {
+        return;
+    }
+    if (!executor) {
+        prefetchCodec.reset();
+    }
+    SkCodec* prefetcher = prefetchCodec.get();
+    fOwnedFrameCache.reset(new SkCodecFrameCache(bytes, executor, std::move(prefetchCodec)));
+    fFrameCache = fOwnedFrameCache.get();
+    if (prefetcher) {
+        // The prefetch codec adds its frames to this cache, but does not prefetch itself.
+        prefetcher->setFrameCache(0);
+        prefetcher->fFrameCache = fFrameCache;
+    }
+}
+
 bool SkCodec::conversionSupported(const SkImageInfo& dst, SkColorType srcColor,
                                   bool srcIsOpaque, const SkColorSpace* srcCS) const {
     if (!valid_alpha(dst.alphaType(), srcIsOpaque)) {
@@ -307,7 +334,10 @@ SkCodec::Result SkCodec::handleFrameIndex(const SkImageInfo& info, void* pixels,
             Options prevFrameOptions(options);
             prevFrameOptions.fFrameIndex = requiredFrame;
             prevFrameOptions.fZeroInitialized = kNo_ZeroInitialized;
+            const bool decodingRequiredFrame = fDecodingRequiredFrame;
+            fDecodingRequiredFrame = true;
             const Result result = this->getPixels(info, pixels, rowBytes, &prevFrameOptions);
+            fDecodingRequiredFrame = decodingRequiredFrame;
             if (result != kSuccess) {
                 return result;
             }
@@ -354,8 +384,64 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
         }
     }
 
-    const Result frameIndexResult = this->handleFrameIndex(info, pixels, rowBytes,
-                                                           *options);
+    if (fFrameCache && !options->fSubset && options->fFrameIndex >= 0) {
+        return this->decodeFrameWithCache(info, pixels, rowBytes, *options);
+    }
+    return this->decodeFrame(info, pixels, rowBytes, *options);
+}
+
+SkCodec::Result SkCodec::decodeFrameWithCache(const SkImageInfo& info, void* pixels,
+                                              size_t rowBytes, const Options& options) {
+    const int index = options.fFrameIndex;
+    const int frameCount = this->getFrameCount();
+    if (frameCount <= 1 || index >= frameCount) {
+        return this->decodeFrame(info, pixels, rowBytes, options);
+    }
+    const auto* frameHolder = this->getFrameHolder();
+    SkASSERT(frameHolder);
+    const auto behavior = options.fPremulBehavior;
+    const bool prefetchNext = fOwnedFrameCache && !fDecodingRequiredFrame
+                              && index + 1 < frameCount;
+    if (fOwnedFrameCache) {
+        // The prefetch is most likely decoding this frame.
+        fFrameCache->waitForPrefetch();
+    }
+
+    if (fFrameCache->copyFrame(index, info, behavior, pixels, rowBytes)) {
+        if (prefetchNext) {
+            fFrameCache->prefetch(index + 1, info, behavior);
+        }
+        return kSuccess;
+    }
+
+    // Start from the latest cached frame that the frame can be blended with, rather than
+    // decoding the required frame again.
+    Options cachedPriorOptions(options);
+    const int requiredFrame = frameHolder->getFrame(index)->getRequiredFrame();
+    if (kNone == options.fPriorFrame && requiredFrame != kNone) {
+        for (int i = index - 1; i >= requiredFrame; --i) {
+            if (frameHolder->getFrame(i)->getDisposalMethod()
+                    != SkCodecAnimation::DisposalMethod::kRestorePrevious
+                && fFrameCache->copyFrame(i, info, behavior, pixels, rowBytes)) {
+                cachedPriorOptions.fPriorFrame = i;
+                break;
+            }
+        }
+    }
+
+    const Result result = this->decodeFrame(info, pixels, rowBytes, cachedPriorOptions);
+    if (kSuccess == result) {
+        fFrameCache->addFrame(index, kNone == requiredFrame, info, behavior, pixels, rowBytes);
+        if (prefetchNext) {
+            fFrameCache->prefetch(index + 1, info, behavior);
+        }
+    }
+    return result;
+}
+
+SkCodec::Result SkCodec::decodeFrame(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                                     const Options& options) {
+    const Result frameIndexResult = this->handleFrameIndex(info, pixels, rowBytes, options);
     if (frameIndexResult != kSuccess) {
         return frameIndexResult;
     }
@@ -367,12 +453,18 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
     }
 
     fDstInfo = info;
-    fOptions = *options;
+    fOptions = options;
 
     // On an incomplete decode, the subclass will specify the number of scanlines that it decoded
     // successfully.
     int rowsDecoded = 0;
-    const Result result = this->onGetPixels(info, pixels, rowBytes, *options, &rowsDecoded);
+    const Result result = this->onGetPixels(info, pixels, rowBytes, options, &rowsDecoded);
+    if (kSuccess == result || kIncompleteInput == result || kErrorInInput == result) {
+        const uint64_t bytes = (uint64_t)(kSuccess == result ? info.height() : rowsDecoded)
+                             * info.minRowBytes();
+        SkCounters::Add(SkCounter::kCodecBytesDecoded, bytes);
+        SkCounters::Record(SkHistogram::kCodecDecodeBytes, bytes);
+    }
 
     // A return value of kIncompleteInput indicates a truncated image stream.
     // In this case, we will fill any uninitialized memory with a default value.
@@ -386,7 +478,7 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
         // differenty from the other codecs, and it needs to use the width specified by the info.
         // Set the subset to null so SkWebpCodec uses the correct width.
         fOptions.fSubset = nullptr;
-        this->fillIncompleteImage(info, pixels, rowBytes, options->fZeroInitialized, info.height(),
+        this->fillIncompleteImage(info, pixels, rowBytes, options.fZeroInitialized, info.height(),
                 rowsDecoded);
     }
 
@@ -527,6 +619,7 @@ int SkCodec::getScanlines(void* dst, int countLines, size_t rowBytes) {
     }
 
     const int linesDecoded = this->onGetScanlines(dst, countLines, rowBytes);
+    SkCounters::Add(SkCounter::kCodecBytesDecoded, (uint64_t)linesDecoded * fDstInfo.minRowBytes());
     if (linesDecoded < countLines) {
         this->fillIncompleteImage(this->dstInfo(), dst, rowBytes, this->options().fZeroInitialized,
                 countLines, linesDecoded);
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodecFrameCache.h"
+#include "SkConvertPixels.h"
+
+SkCodecFrameCache::SkCodecFrameCache(size_t budget, SkExecutor* executor,
+                                     std::unique_ptr<SkCodec> prefetchCodec)
+    : fBudget(budget)
+    , fPrefetchCodec(std::move(prefetchCodec)) {
+    if (executor && fPrefetchCodec) {
+        fPrefetchTasks.reset(new SkTaskGroup(*executor));
+    }
+}
+
+SkCodecFrameCache::~SkCodecFrameCache() {
+    this->waitForPrefetch();
+}
+
+int SkCodecFrameCache::find(int index, const SkImageInfo& info,
+                            SkTransferFunctionBehavior behavior) const {
+    for (int i = fEntries.count() - 1; i >= 0; --i) {
+        const Entry& entry = *fEntries[i];
+        if (entry.fIndex == index && entry.fBehavior == behavior && entry.fInfo == info) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool SkCodecFrameCache::copyFrame(int index, const SkImageInfo& info,
+                                  SkTransferFunctionBehavior behavior, void* pixels,
+                                  size_t rowBytes) {
+    SkAutoMutexAcquire lock(fMutex);
+    int i = this->find(index, info, behavior);
+    if (i < 0) {
+        return false;
+    }
+    // Make it the most recently used entry.
+    for (; i < fEntries.count() - 1; ++i) {
+        std::swap(fEntries[i], fEntries[i + 1]);
+    }
+    SkRectMemcpy(pixels, rowBytes, fEntries.back()->fPixels.get(), info.minRowBytes(),
+                 info.minRowBytes(), info.height());
+    return true;
+}
+
+void SkCodecFrameCache::addFrame(int index, bool independent, const SkImageInfo& info,
+                                 SkTransferFunctionBehavior behavior, const void* pixels,
+                                 size_t rowBytes) {
+    const size_t size = info.computeMinByteSize();
+    if (SkImageInfo::ByteSizeOverflowed(size) || size > fBudget) {
+        return;
+    }
+    SkAutoMutexAcquire lock(fMutex);
+    if (this->find(index, info, behavior) >= 0) {
+        return;
+    }
+    while (fBytesUsed + size > fBudget) {
+        // Evict the least recently used frame, preferring frames that depend on a prior frame.
+        int victim = 0;
+        for (int i = 0; i < fEntries.count(); ++i) {
+            if (!fEntries[i]->fIndependent) {
+                victim = i;
+                break;
+            }
+        }
+        fBytesUsed -= fEntries[victim]->fInfo.computeMinByteSize();
+        for (int i = victim; i < fEntries.count() - 1; ++i) {
+            std::swap(fEntries[i], fEntries[i + 1]);
+        }
+        fEntries.pop_back();
+    }
+    std::unique_ptr<Entry> entry(new Entry);
+    entry->fIndex = index;
+    entry->fIndependent = independent;
+    entry->fInfo = info;
+    entry->fBehavior = behavior;
+    entry->fPixels.reset(size);
+    SkRectMemcpy(entry->fPixels.get(), info.minRowBytes(), pixels, rowBytes, info.minRowBytes(),
+                 info.height());
+    fEntries.push_back(std::move(entry));
+    fBytesUsed += size;
+}
+
+void SkCodecFrameCache::prefetch(int index, const SkImageInfo& info,
+                                 SkTransferFunctionBehavior behavior) {
+    if (!fPrefetchTasks) {
+        return;
+    }
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (this->find(index, info, behavior) >= 0) {
+            return;
+        }
+    }
+    this->waitForPrefetch();
+    ++fNumPrefetched;
+    fPrefetchTasks->add([this, index, info, behavior] {
+        SkAutoMalloc storage(info.computeMinByteSize());
+        SkCodec::Options options;
+        options.fFrameIndex = index;
+        options.fPremulBehavior = behavior;
+        // On success the codec adds the frame to this cache.
+        fPrefetchCodec->getPixels(info, storage.get(), info.minRowBytes(), &options);
+    });
+}
+
+void SkCodecFrameCache::waitForPrefetch() {
+    if (fPrefetchTasks) {
+        fPrefetchTasks->wait();
+    }
+}
+
+size_t SkCodecFrameCache::bytesUsed() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fBytesUsed;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodecFrameCache_DEFINED
+#define SkCodecFrameCache_DEFINED
+
+#include "SkAutoMalloc.h"
+#include "SkCodec.h"
+#include "SkImageInfo.h"
+#include "SkMutex.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
+
+/**
+ *  A cache of decoded frames of a multi-frame image, owned by the SkCodec that decodes them (see
+ *  SkCodec::setFrameCache()). Entries are keyed by frame index, dst info and premul behavior.
+ *
+ *  When the cache is over budget, the least recently used frame that depends on a prior frame is
+ *  evicted first, since independent frames are the most expensive to reach again.
+ *
+ *  If the owner provided a second codec and an executor, prefetch() decodes a frame into the
+ *  cache with that codec in the background. The entries are guarded by a mutex, since the
+ *  prefetch codec uses the same cache.
+ */
+class SkCodecFrameCache : SkNoncopyable {
+public:
+    SkCodecFrameCache(size_t budget, SkExecutor*, std::unique_ptr<SkCodec> prefetchCodec);
+
+    // Waits for a prefetch in progress.
+    ~SkCodecFrameCache();
+
+    /**
+     *  Copies the frame to |pixels| and returns true if it is in the cache.
+     */
+    bool copyFrame(int index, const SkImageInfo&, SkTransferFunctionBehavior, void* pixels,
+                   size_t rowBytes);
+
+    /**
+     *  Adds a decoded frame. |independent| is whether the frame has no required frame.
+     */
+    void addFrame(int index, bool independent, const SkImageInfo&, SkTransferFunctionBehavior,
+                  const void* pixels, size_t rowBytes);
+
+    /**
+     *  Starts decoding a frame into the cache on the executor, unless it is already cached or
+     *  there is no prefetch codec. Only one prefetch runs at a time.
+     */
+    void prefetch(int index, const SkImageInfo&, SkTransferFunctionBehavior);
+
+    void waitForPrefetch();
+
+    size_t bytesUsed() const;
+    int numPrefetched() const { return fNumPrefetched; }
+
+private:
+    struct Entry {
+        int                        fIndex;
+        bool                       fIndependent;
+        SkImageInfo                fInfo;
+        SkTransferFunctionBehavior fBehavior;
+        SkAutoMalloc               fPixels;
+    };
+
+    // Returns the index of the entry or -1. Must be called with fMutex held.
+    int find(int index, const SkImageInfo&, SkTransferFunctionBehavior) const;
+
+    const size_t                     fBudget;
+    std::unique_ptr<SkCodec>         fPrefetchCodec;
+    std::unique_ptr<SkTaskGroup>     fPrefetchTasks;
+    int                              fNumPrefetched = 0;
+
+    mutable SkMutex                  fMutex;
+    // The most recently used entry is last.
+    SkTArray<std::unique_ptr<Entry>> fEntries;
+    size_t                           fBytesUsed = 0;
+};
+
+#endif  // SkCodecFrameCache_DEFINED
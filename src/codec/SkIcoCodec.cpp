@@ -107,6 +107,17 @@ std::unique_ptr<SkCodec> SkIcoCodec::MakeFromStream(std::unique_ptr<SkStream> st
     EntryLessThan lessThan;
     SkTQSort(directoryEntries, &directoryEntries[numImages - 1], lessThan);
 
+    // If the stream is backed by memory, the embedded streams point into it
+    // rather than into copies of the embedded images. The memory is kept alive
+    // by giving the stream to the SkData that the embedded streams share.
+    SkStream* icoStream = stream.get();
+    sk_sp<SkData> streamData;
+    if (icoStream->getMemoryBase() && icoStream->hasLength()) {
+        streamData = SkData::MakeWithProc(icoStream->getMemoryBase(), icoStream->getLength(),
+                [](const void*, void* ctx) { delete static_cast<SkStream*>(ctx); },
+                stream.release());
+    }
+
     // Now will construct a candidate codec for each of the embedded images
     uint32_t bytesRead = kIcoDirectoryBytes + numImages * kIcoDirEntryBytes;
     std::unique_ptr<SkTArray<std::unique_ptr<SkCodec>, true>> codecs(
@@ -123,26 +134,36 @@ std::unique_ptr<SkCodec> SkIcoCodec::MakeFromStream(std::unique_ptr<SkStream> st
 
         // If we cannot skip, assume we have reached the end of the stream and
         // stop trying to make codecs
-        if (stream->skip(offset - bytesRead) != offset - bytesRead) {
+        if (icoStream->skip(offset - bytesRead) != offset - bytesRead) {
             SkCodecPrintf("Warning: could not skip to ico offset.\n");
             break;
         }
         bytesRead = offset;
 
         // Create a new stream for the embedded codec
-        SkAutoFree buffer(sk_malloc_canfail(size));
-        if (!buffer) {
-            SkCodecPrintf("Warning: OOM trying to create embedded stream.\n");
-            break;
-        }
+        sk_sp<SkData> data;
+        if (streamData) {
+            if (icoStream->skip(size) != size) {
+                SkCodecPrintf("Warning: could not create embedded stream.\n");
+                *result = kIncompleteInput;
+                break;
+            }
+            data = SkData::MakeSubset(streamData.get(), offset, size);
+        } else {
+            SkAutoFree buffer(sk_malloc_canfail(size));
+            if (!buffer) {
+                SkCodecPrintf("Warning: OOM trying to create embedded stream.\n");
+                break;
+            }
 
-        if (stream->read(buffer.get(), size) != size) {
-            SkCodecPrintf("Warning: could not create embedded stream.\n");
-            *result = kIncompleteInput;
-            break;
-        }
+            if (icoStream->read(buffer.get(), size) != size) {
+                SkCodecPrintf("Warning: could not create embedded stream.\n");
+                *result = kIncompleteInput;
+                break;
+            }
 
-        sk_sp<SkData> data(SkData::MakeFromMalloc(buffer.release(), size));
+            data = SkData::MakeFromMalloc(buffer.release(), size);
+        }
         auto embeddedStream = SkMemoryStream::Make(data);
         bytesRead += size;
 
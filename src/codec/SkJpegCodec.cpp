@@ -10,12 +10,18 @@
 #include "SkCodec.h"
 #include "SkCodecPriv.h"
 #include "SkColorData.h"
+#include "SkData.h"
+#include "SkExecutor.h"
 #include "SkJpegDecoderMgr.h"
 #include "SkJpegInfo.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
 #include "SkTypes.h"
 
+#include <atomic>
+
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "SkJpegUtility.h"
@@ -306,8 +312,11 @@ SkJpegCodec::SkJpegCodec(int width, int height, const SkEncodedInfo& info,
     , fSwizzleSrcRow(nullptr)
     , fColorXformSrcRow(nullptr)
     , fSwizzlerSubset(SkIRect::MakeEmpty())
+    , fRestartIndexBuilt(false)
 {}
 
+SkJpegCodec::~SkJpegCodec() {}
+
 /*
  * Return the row bytes of a particular image type and width
  */
@@ -376,6 +385,7 @@ bool SkJpegCodec::onRewind() {
     }
     SkASSERT(nullptr != decoderMgr);
     fDecoderMgr.reset(decoderMgr);
+    fBandStream.reset();
 
     fSwizzler.reset(nullptr);
     fSwizzleSrcRow = nullptr;
@@ -570,6 +580,320 @@ static inline bool needs_swizzler_to_convert_from_cmyk(J_COLOR_SPACE jpegColorTy
     return !hasCMYKColorSpace || !hasColorSpaceXform;
 }
 
+/*
+ * The layout of a baseline, huffman coded jpeg with a single scan and restart markers. Restart
+ * markers reset the entropy decoder and DC predictors, so decoding can start at any of them.
+ */
+struct SkJpegRestartIndex {
+    size_t            fSOFHeightOffset;  // Offset of the image height in the SOF segment.
+    size_t            fEntropyStart;     // Offset of the entropy coded data after the SOS segment.
+    size_t            fEntropyEnd;       // Offset of the EOI marker.
+    SkTDArray<size_t> fRestarts;         // Offsets of the RSTn markers, in order.
+
+    int               fHeight;
+    int               fMCUHeight;
+    int               fMCURows;
+    uint64_t          fMCUsPerRow;
+    uint64_t          fInterval;         // MCUs per restart interval.
+    SkTDArray<int>    fRowStarts;        // The MCU rows that begin at a restart marker, followed
+                                         // by fMCURows.
+
+    // Vertically upsampled components blend neighboring rows, which the decoder replicates at
+    // the top and bottom of the image. When this is true a jpeg that starts or ends at a restart
+    // marker decodes the MCU row next to that edge differently than the whole image does.
+    bool              fNeedsContext;
+
+    int intervalOf(int mcuRow) const {
+        return mcuRow == fMCURows ? fRestarts.count() + 1
+                                  : SkToInt(mcuRow * fMCUsPerRow / fInterval);
+    }
+
+    /*
+     * Makes a jpeg of the MCU rows [firstRow, endRow), which must be in fRowStarts.
+     */
+    sk_sp<SkData> makeBand(const uint8_t* data, int firstRow, int endRow) const;
+};
+
+/*
+ * Finds the restart markers of a baseline, huffman coded jpeg with a single scan. Returns false
+ * for any other jpeg, and for incomplete or malformed data.
+ */
+static bool index_restart_markers(const uint8_t* data, size_t size, SkJpegRestartIndex* index) {
+    if (size < 4 || 0xFF != data[0] || 0xD8 != data[1]) {
+        return false;
+    }
+
+    // Walk the marker segments up to the start of the scan.
+    bool foundSOF = false;
+    size_t pos = 2;
+    while (true) {
+        if (pos >= size || 0xFF != data[pos]) {
+            return false;
+        }
+        while (pos < size && 0xFF == data[pos]) {
+            pos++;
+        }
+        if (pos + 3 > size) {
+            return false;
+        }
+        const uint8_t marker = data[pos];
+        const size_t segment = pos + 1;
+        const size_t length = (data[segment] << 8) | data[segment + 1];
+        if (length < 2 || segment + length > size) {
+            return false;
+        }
+        if (0xC0 == marker || 0xC1 == marker) {
+            // Length, precision, height, width and component count.
+            if (length < 8) {
+                return false;
+            }
+            index->fSOFHeightOffset = segment + 3;
+            foundSOF = true;
+        } else if (0xC2 <= marker && marker <= 0xCF && 0xC4 != marker && 0xCC != marker) {
+            // Progressive, lossless, hierarchical and arithmetic coded frames.
+            return false;
+        } else if (0xDA == marker) {
+            index->fEntropyStart = segment + length;
+            break;
+        } else if (marker < 0xC0 || (0xD0 <= marker && marker <= JPEG_EOI)) {
+            // Markers without a length are not expected before the scan.
+            return false;
+        }
+        pos = segment + length;
+    }
+    if (!foundSOF) {
+        return false;
+    }
+
+    // Find the restart markers in the entropy coded data. Any marker other than RSTn and EOI
+    // starts another scan.
+    index->fRestarts.rewind();
+    pos = index->fEntropyStart;
+    while (pos + 1 < size) {
+        if (0xFF != data[pos]) {
+            pos++;
+        } else if (0x00 == data[pos + 1]) {
+            // A stuffed 0xFF byte.
+            pos += 2;
+        } else if (0xFF == data[pos + 1]) {
+            // Fill byte.
+            pos++;
+        } else if (JPEG_RST0 <= data[pos + 1] && data[pos + 1] <= JPEG_RST0 + 7) {
+            *index->fRestarts.append() = pos;
+            pos += 2;
+        } else if (JPEG_EOI == data[pos + 1]) {
+            index->fEntropyEnd = pos;
+            return true;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+/*
+ * Builds the restart index of the jpeg whose header has been read into dinfo. Returns nullptr if
+ * decoding can't start at its restart markers.
+ */
+static std::unique_ptr<SkJpegRestartIndex> make_restart_index(jpeg_decompress_struct* dinfo,
+                                                              const uint8_t* data, size_t size) {
+    if (dinfo->progressive_mode || dinfo->arith_code || !dinfo->restart_interval ||
+            dinfo->comps_in_scan != dinfo->num_components) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkJpegRestartIndex> index(new SkJpegRestartIndex);
+    if (!index_restart_markers(data, size, index.get())) {
+        return nullptr;
+    }
+
+    // Find the size of the MCUs. A scan with one component is not interleaved.
+    int mcuWidth = DCTSIZE * dinfo->max_h_samp_factor;
+    int mcuHeight = DCTSIZE * dinfo->max_v_samp_factor;
+    if (1 == dinfo->comps_in_scan) {
+        mcuWidth /= dinfo->comp_info[0].h_samp_factor;
+        mcuHeight /= dinfo->comp_info[0].v_samp_factor;
+    }
+    index->fHeight = dinfo->image_height;
+    index->fMCUHeight = mcuHeight;
+    index->fMCURows = (index->fHeight + mcuHeight - 1) / mcuHeight;
+    index->fMCUsPerRow = (dinfo->image_width + mcuWidth - 1) / mcuWidth;
+    index->fInterval = dinfo->restart_interval;
+    const uint64_t mcuCount = index->fMCUsPerRow * index->fMCURows;
+    if ((uint64_t) index->fRestarts.count() + 1 !=
+            (mcuCount + index->fInterval - 1) / index->fInterval) {
+        return nullptr;
+    }
+
+    for (int row = 0; row < index->fMCURows; row++) {
+        if (0 == (row * index->fMCUsPerRow) % index->fInterval) {
+            *index->fRowStarts.append() = row;
+        }
+    }
+    *index->fRowStarts.append() = index->fMCURows;
+
+    index->fNeedsContext = false;
+    for (int i = 0; i < dinfo->num_components; i++) {
+        index->fNeedsContext |= dinfo->comp_info[i].v_samp_factor != dinfo->max_v_samp_factor;
+    }
+    return index;
+}
+
+sk_sp<SkData> SkJpegRestartIndex::makeBand(const uint8_t* data, int firstRow, int endRow) const {
+    const int firstInterval = this->intervalOf(firstRow);
+    const int endInterval = this->intervalOf(endRow);
+    const int height = SkTMin(endRow * fMCUHeight, fHeight) - firstRow * fMCUHeight;
+    const size_t begin = firstInterval ? fRestarts[firstInterval - 1] + 2 : fEntropyStart;
+    const size_t end = endInterval <= fRestarts.count() ? fRestarts[endInterval - 1]
+                                                        : fEntropyEnd;
+    const size_t headerSize = fEntropyStart;
+    sk_sp<SkData> band = SkData::MakeUninitialized(headerSize + (end - begin) + 2);
+    uint8_t* bandData = static_cast<uint8_t*>(band->writable_data());
+
+    memcpy(bandData, data, headerSize);
+    bandData[fSOFHeightOffset] = (height >> 8) & 0xFF;
+    bandData[fSOFHeightOffset + 1] = height & 0xFF;
+
+    memcpy(bandData + headerSize, data + begin, end - begin);
+    // The decoder expects the restart markers of the band to count up from RST0.
+    for (int i = firstInterval; i < endInterval - 1; i++) {
+        bandData[headerSize + fRestarts[i] - begin + 1] = JPEG_RST0 + ((i - firstInterval) & 7);
+    }
+
+    bandData[band->size() - 2] = 0xFF;
+    bandData[band->size() - 1] = JPEG_EOI;
+    return band;
+}
+
+const SkJpegRestartIndex* SkJpegCodec::restartIndex() {
+    if (!fRestartIndexBuilt) {
+        fRestartIndexBuilt = true;
+        const void* data = this->stream()->getMemoryBase();
+        if (data && this->stream()->hasLength()) {
+            fRestartIndex = make_restart_index(fDecoderMgr->dinfo(),
+                                               static_cast<const uint8_t*>(data),
+                                               this->stream()->getLength());
+        }
+    }
+    return fRestartIndex.get();
+}
+
+struct SkJpegCodec::Band {
+    sk_sp<SkData> fData;       // A jpeg of the band's rows.
+    int           fSkipRows;   // Rows of fData above the band, decoded for upsampling context.
+    int           fFirstRow;   // The first row of the image in the band.
+    int           fRowCount;
+};
+
+// The most bands an image is split into.
+static constexpr int kMaxParallelBands = 16;
+
+bool SkJpegCodec::decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                   SkExecutor* executor) {
+    // CMYK needs the swizzler, which is only set up for serial decodes.
+    if (dstInfo.dimensions() != this->getInfo().dimensions() ||
+            JCS_CMYK == fDecoderMgr->dinfo()->out_color_space) {
+        return false;
+    }
+    const SkJpegRestartIndex* index = this->restartIndex();
+    if (!index) {
+        return false;
+    }
+    const uint8_t* data = static_cast<const uint8_t*>(this->stream()->getMemoryBase());
+    const SkTDArray<int>& starts = index->fRowStarts;
+
+    // Group the rows into bands, by indices into starts.
+    const int minBandRows = SkTMax(index->fMCURows / kMaxParallelBands, 1);
+    SkTDArray<int> bounds;
+    *bounds.append() = 0;
+    for (int i = 1; i < starts.count() - 1; i++) {
+        if (starts[i] - starts[bounds.top()] >= minBandRows) {
+            *bounds.append() = i;
+        }
+    }
+    *bounds.append() = starts.count() - 1;
+    if (bounds.count() < 3) {
+        return false;
+    }
+
+    // When upsampling needs context, each band also decodes the restart aligned rows above and
+    // below it, so that the rows it keeps match a serial decode.
+    const int mcuHeight = index->fMCUHeight;
+    SkTArray<Band> bands(bounds.count() - 1);
+    for (int i = 0; i < bounds.count() - 1; i++) {
+        int first = starts[bounds[i]];
+        int end = starts[bounds[i + 1]];
+        int decodeFirst = index->fNeedsContext && bounds[i] > 0 ? starts[bounds[i] - 1] : first;
+        int decodeEnd = index->fNeedsContext && end < index->fMCURows ? starts[bounds[i + 1] + 1]
+                                                                     : end;
+
+        Band& band = bands.push_back();
+        band.fData = index->makeBand(data, decodeFirst, decodeEnd);
+        band.fSkipRows = (first - decodeFirst) * mcuHeight;
+        band.fFirstRow = first * mcuHeight;
+        band.fRowCount = SkTMin(end * mcuHeight, index->fHeight) - band.fFirstRow;
+    }
+
+    std::atomic<bool> success(true);
+    SkTaskGroup taskGroup(*executor);
+    for (const Band& band : bands) {
+        taskGroup.add([&, this] {
+            if (!this->decodeBand(band, dstInfo, dst, rowBytes)) {
+                success = false;
+            }
+        });
+    }
+    taskGroup.wait();
+    return success;
+}
+
+bool SkJpegCodec::decodeBand(const Band& band, const SkImageInfo& dstInfo, void* dst,
+                             size_t rowBytes) const {
+    SkMemoryStream stream(band.fData);
+    JpegDecoderMgr decoderMgr(&stream);
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+    if (setjmp(jmp)) {
+        return decoderMgr.returnFalse("decodeBand");
+    }
+
+    decoderMgr.init();
+    jpeg_decompress_struct* dinfo = decoderMgr.dinfo();
+    if (JPEG_HEADER_OK != jpeg_read_header(dinfo, true)) {
+        return decoderMgr.returnFalse("decodeBand");
+    }
+    dinfo->out_color_space = fDecoderMgr->dinfo()->out_color_space;
+    dinfo->dither_mode = fDecoderMgr->dinfo()->dither_mode;
+    if (!jpeg_start_decompress(dinfo)) {
+        return decoderMgr.returnFalse("decodeBand");
+    }
+
+    // Rows are decoded into the dst and color transformed in place, except when the color xform
+    // writes F16 or 565 (see allocateStorage()). Context rows are decoded into the same storage.
+    const bool xformFromStorage = this->colorXform() &&
+                                  (kRGBA_F16_SkColorType == dstInfo.colorType() ||
+                                   kRGB_565_SkColorType == dstInfo.colorType());
+    SkAutoTMalloc<JSAMPLE> storage(get_row_bytes(dinfo));
+    JSAMPLE* row = storage.get();
+    for (int y = 0; y < band.fSkipRows; y++) {
+        if (1 != jpeg_read_scanlines(dinfo, &row, 1)) {
+            return false;
+        }
+    }
+
+    void* dstRow = SkTAddOffset<void>(dst, band.fFirstRow * rowBytes);
+    for (int y = 0; y < band.fRowCount; y++) {
+        row = xformFromStorage ? storage.get() : (JSAMPLE*) dstRow;
+        if (1 != jpeg_read_scanlines(dinfo, &row, 1)) {
+            return false;
+        }
+        if (this->colorXform()) {
+            this->applyColorXform(dstRow, row, dstInfo.width(), kOpaque_SkAlphaType);
+        }
+        dstRow = SkTAddOffset<void>(dstRow, rowBytes);
+    }
+    return true;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -596,6 +920,11 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("setOutputColorSpace", kInvalidConversion);
     }
 
+    if (options.fExecutor &&
+            this->decodeInParallel(dstInfo, dst, dstRowBytes, options.fExecutor)) {
+        return kSuccess;
+    }
+
     if (!jpeg_start_decompress(dinfo)) {
         return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
     }
@@ -766,7 +1095,77 @@ int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
     return rows;
 }
 
+bool SkJpegCodec::seekToRow(int row) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    // Scaled decodes output different rows than the MCU rows of the index.
+    if (0 != dinfo->output_scanline || dinfo->output_height != dinfo->image_height) {
+        return false;
+    }
+    const SkJpegRestartIndex* index = this->restartIndex();
+    if (!index) {
+        return false;
+    }
+
+    // Find the last restart aligned MCU row at or above the row, leaving an MCU row of context
+    // for upsampling.
+    const int contextRows = index->fNeedsContext ? index->fMCUHeight : 0;
+    int start = 0;
+    for (int mcuRow : index->fRowStarts) {
+        if (mcuRow == index->fMCURows || mcuRow * index->fMCUHeight + contextRows > row) {
+            break;
+        }
+        start = mcuRow;
+    }
+    if (!start) {
+        return false;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(this->stream()->getMemoryBase());
+    std::unique_ptr<SkMemoryStream> bandStream(
+            new SkMemoryStream(index->makeBand(data, start, index->fMCURows)));
+    std::unique_ptr<JpegDecoderMgr> decoderMgr(new JpegDecoderMgr(bandStream.get()));
+    {
+        skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr->errorMgr());
+        if (setjmp(jmp)) {
+            return decoderMgr->returnFalse("seekToRow");
+        }
+
+        decoderMgr->init();
+        jpeg_decompress_struct* bandInfo = decoderMgr->dinfo();
+        if (JPEG_HEADER_OK != jpeg_read_header(bandInfo, true)) {
+            return decoderMgr->returnFalse("seekToRow");
+        }
+        bandInfo->out_color_space = dinfo->out_color_space;
+        bandInfo->dither_mode = dinfo->dither_mode;
+        if (!jpeg_start_decompress(bandInfo)) {
+            return decoderMgr->returnFalse("seekToRow");
+        }
+        if (const SkIRect* subset = this->options().fSubset) {
+            uint32_t startX = subset->x();
+            uint32_t width = subset->width();
+            jpeg_crop_scanline(bandInfo, &startX, &width);
+            SkASSERT(bandInfo->output_width == dinfo->output_width);
+        }
+
+        const uint32_t skip = row - start * index->fMCUHeight;
+        if (skip != jpeg_skip_scanlines(bandInfo, skip)) {
+            return false;
+        }
+    }
+
+    // Replace the decoder before the stream it reads from.
+    fDecoderMgr = std::move(decoderMgr);
+    fBandStream = std::move(bandStream);
+    return true;
+}
+
 bool SkJpegCodec::onSkipScanlines(int count) {
+    // Region decodes skip to the top of the region before reading any rows. If the jpeg has
+    // restart markers, start decoding at the last one above the region instead.
+    if (this->seekToRow(count)) {
+        return true;
+    }
+
     // Set the jump location for libjpeg errors
     skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
     if (setjmp(jmp)) {
@@ -17,6 +17,8 @@
 #include "SkTemplates.h"
 
 class JpegDecoderMgr;
+class SkExecutor;
+struct SkJpegRestartIndex;
 
 /*
  *
@@ -33,6 +35,8 @@ public:
      */
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*);
 
+    ~SkJpegCodec() override;
+
 protected:
 
     /*
@@ -122,6 +126,29 @@ private:
     void allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
 
+    /*
+     * Parallel decoding of baseline jpegs with restart markers. The image is split into bands of
+     * MCU rows that begin at restart markers, and each band is decoded as a separate jpeg on the
+     * executor. Returns false if the image can't be decoded this way, in which case it is decoded
+     * serially.
+     */
+    struct Band;
+    bool decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, SkExecutor*);
+    bool decodeBand(const Band&, const SkImageInfo& dstInfo, void* dst, size_t rowBytes) const;
+
+    /*
+     * Returns the index of the restart markers in the encoded data, building it on first use.
+     * Returns nullptr if the data is not in memory or decoding can't start at restart markers.
+     */
+    const SkJpegRestartIndex* restartIndex();
+
+    /*
+     * Called before the first row of a scanline decode is read. Replaces fDecoderMgr with a
+     * decoder of the rows from the last restart marker above 'row', skipped to 'row'. Returns
+     * false, leaving the decoder unchanged, if that is not possible.
+     */
+    bool seekToRow(int row);
+
     /*
      * Scanline decoding.
      */
@@ -131,6 +158,9 @@ private:
     int onGetScanlines(void* dst, int count, size_t rowBytes) override;
     bool onSkipScanlines(int count) override;
 
+    // The encoded rows fDecoderMgr reads after seekToRow(). Declared first, so that it outlives
+    // fDecoderMgr.
+    std::unique_ptr<SkMemoryStream>    fBandStream;
     std::unique_ptr<JpegDecoderMgr>    fDecoderMgr;
 
     // We will save the state of the decompress struct after reading the header.
@@ -149,6 +179,9 @@ private:
 
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
+    bool                               fRestartIndexBuilt;
+    std::unique_ptr<SkJpegRestartIndex> fRestartIndex;
+
     friend class SkRawCodec;
 
     typedef SkCodec INHERITED;
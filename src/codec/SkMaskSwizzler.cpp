@@ -9,6 +9,46 @@
 #include "SkColorData.h"
 #include "SkMaskSwizzler.h"
 
+enum class MaskAlpha {
+    kOpaque,
+    kUnpremul,
+    kPremul,
+};
+
+static Sk4u load_mask_pixels(const uint16_t* src) {
+    return Sk4u(src[0], src[1], src[2], src[3]);
+}
+
+static Sk4u load_mask_pixels(const uint32_t* src) {
+    return Sk4u::Load(src);
+}
+
+// Swizzles the row four pixels at a time, and returns the number of pixels swizzled. The rest
+// are left to the scalar loop of the caller. Only used when sampleX is 1.
+template <bool kBGRA, MaskAlpha kAlpha, typename T>
+static int swizzle_mask_Nx(SkPMColor* dst, const T* src, int width, const SkMasks* masks) {
+    int i = 0;
+    for (; i + 4 <= width; i += 4) {
+        const Sk4u p = load_mask_pixels(src + i);
+        Sk4i red = masks->getRed(p);
+        Sk4i green = masks->getGreen(p);
+        Sk4i blue = masks->getBlue(p);
+        Sk4i alpha = MaskAlpha::kOpaque == kAlpha ? Sk4i(0xFF) : masks->getAlpha(p);
+        if (MaskAlpha::kPremul == kAlpha) {
+            // Rounds like SkMulDiv255Round().
+            const Sk4f scale = SkNx_cast<float>(alpha) * (1 / 255.0f);
+            red = SkNx_cast<int32_t>(SkNx_cast<float>(red) * scale + 0.5f);
+            green = SkNx_cast<int32_t>(SkNx_cast<float>(green) * scale + 0.5f);
+            blue = SkNx_cast<int32_t>(SkNx_cast<float>(blue) * scale + 0.5f);
+        }
+        if (kBGRA) {
+            std::swap(red, blue);
+        }
+        (red | (green << 8) | (blue << 16) | (alpha << 24)).store(dst + i);
+    }
+    return i;
+}
+
 static void swizzle_mask16_to_rgba_opaque(
         void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
         uint32_t startX, uint32_t sampleX) {
@@ -16,7 +56,12 @@ static void swizzle_mask16_to_rgba_opaque(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<false, MaskAlpha::kOpaque>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -33,7 +78,12 @@ static void swizzle_mask16_to_bgra_opaque(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<true, MaskAlpha::kOpaque>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -50,7 +100,12 @@ static void swizzle_mask16_to_rgba_unpremul(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<false, MaskAlpha::kUnpremul>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -68,7 +123,12 @@ static void swizzle_mask16_to_bgra_unpremul(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<true, MaskAlpha::kUnpremul>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -86,7 +146,12 @@ static void swizzle_mask16_to_rgba_premul(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<false, MaskAlpha::kPremul>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -104,7 +169,12 @@ static void swizzle_mask16_to_bgra_premul(
     // Use the masks to decode to the destination
     uint16_t* srcPtr = ((uint16_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<true, MaskAlpha::kPremul>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint16_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -264,7 +334,12 @@ static void swizzle_mask32_to_rgba_opaque(
     // Use the masks to decode to the destination
     uint32_t* srcPtr = ((uint32_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<false, MaskAlpha::kOpaque>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint32_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -281,7 +356,12 @@ static void swizzle_mask32_to_bgra_opaque(
     // Use the masks to decode to the destination
     uint32_t* srcPtr = ((uint32_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<true, MaskAlpha::kOpaque>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint32_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -298,7 +378,12 @@ static void swizzle_mask32_to_rgba_unpremul(
     // Use the masks to decode to the destination
     uint32_t* srcPtr = ((uint32_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<false, MaskAlpha::kUnpremul>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint32_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -316,7 +401,12 @@ static void swizzle_mask32_to_bgra_unpremul(
     // Use the masks to decode to the destination
     uint32_t* srcPtr = ((uint32_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<true, MaskAlpha::kUnpremul>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint32_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -334,7 +424,12 @@ static void swizzle_mask32_to_rgba_premul(
     // Use the masks to decode to the destination
     uint32_t* srcPtr = ((uint32_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<false, MaskAlpha::kPremul>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint32_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -352,7 +447,12 @@ static void swizzle_mask32_to_bgra_premul(
     // Use the masks to decode to the destination
     uint32_t* srcPtr = ((uint32_t*) srcRow) + startX;
     SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
+    int i = 0;
+    if (1 == sampleX) {
+        i = swizzle_mask_Nx<true, MaskAlpha::kPremul>(dstPtr, srcPtr, width, masks);
+        srcPtr += i;
+    }
+    for (; i < width; i++) {
         uint32_t p = srcPtr[0];
         uint8_t red = masks->getRed(p);
         uint8_t green = masks->getGreen(p);
@@ -81,6 +81,33 @@ uint8_t SkMasks::getAlpha(uint32_t pixel) const {
     return get_comp(pixel, fAlpha.mask, fAlpha.shift, fAlpha.size);
 }
 
+// Matches get_comp() for four pixels. n_bit_to_8_bit_lookup_table holds comp * 255 / (2^n - 1)
+// rounded to the nearest integer, which this computes with floats.
+static Sk4i get_comps(const Sk4u& pixels, const SkMasks::MaskInfo& info) {
+    const Sk4u comps = (pixels & info.mask) >> info.shift;
+    if (0 == info.size) {
+        return 0;
+    }
+    if (8 == info.size) {
+        return SkNx_cast<int32_t>(comps);
+    }
+    const float scale = 255.0f / ((1 << info.size) - 1);
+    return SkNx_cast<int32_t>(SkNx_cast<float>(comps) * scale + 0.5f);
+}
+
+Sk4i SkMasks::getRed(const Sk4u& pixels) const {
+    return get_comps(pixels, fRed);
+}
+Sk4i SkMasks::getGreen(const Sk4u& pixels) const {
+    return get_comps(pixels, fGreen);
+}
+Sk4i SkMasks::getBlue(const Sk4u& pixels) const {
+    return get_comps(pixels, fBlue);
+}
+Sk4i SkMasks::getAlpha(const Sk4u& pixels) const {
+    return get_comps(pixels, fAlpha);
+}
+
 /*
  *
  * Process an input mask to obtain the necessary information
@@ -7,6 +7,7 @@
 #ifndef SkMasks_DEFINED
 #define SkMasks_DEFINED
 
+#include "SkNx.h"
 #include "SkTypes.h"
 
 /*
@@ -57,6 +58,16 @@ public:
     uint8_t getBlue(uint32_t pixel) const;
     uint8_t getAlpha(uint32_t pixel) const;
 
+    /*
+     *
+     * Get a color component of four pixels at once
+     *
+     */
+    Sk4i getRed(const Sk4u& pixels) const;
+    Sk4i getGreen(const Sk4u& pixels) const;
+    Sk4i getBlue(const Sk4u& pixels) const;
+    Sk4i getAlpha(const Sk4u& pixels) const;
+
     /*
      *
      * Getter for the alpha mask
@@ -11,6 +11,7 @@
 #include "SkColorSpace.h"
 #include "SkColorSpacePriv.h"
 #include "SkColorTable.h"
+#include "SkExecutor.h"
 #include "SkMath.h"
 #include "SkOpts.h"
 #include "SkPngCodec.h"
@@ -19,6 +20,7 @@
 #include "SkSize.h"
 #include "SkStream.h"
 #include "SkSwizzler.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkUtils.h"
 
@@ -132,6 +134,16 @@ static inline bool is_chunk(const png_byte* chunk, const char* tag) {
 static inline bool process_data(png_structp png_ptr, png_infop info_ptr,
         SkStream* stream, void* buffer, size_t bufferSize, size_t length) {
     while (length > 0) {
+        // Hand libpng the stream's memory, a chunk at a time, rather than a copy in buffer.
+        size_t chunkSize;
+        if (const void* chunk = stream->getMemoryChunk(&chunkSize)) {
+            const size_t bytesToProcess = std::min(chunkSize, length);
+            // Skip first: png_process_data() may longjmp out.
+            stream->skip(bytesToProcess);
+            length -= bytesToProcess;
+            png_process_data(png_ptr, info_ptr, (png_bytep) chunk, bytesToProcess);
+            continue;
+        }
         const size_t bytesToProcess = std::min(bufferSize, length);
         const size_t bytesRead = stream->read(buffer, bytesToProcess);
         png_process_data(png_ptr, info_ptr, (png_bytep) buffer, bytesRead);
@@ -448,6 +460,7 @@ void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
             const size_t colorXformBytes = dstInfo.width() * bytesPerPixel;
             fStorage.reset(colorXformBytes);
             fColorXformSrcRow = fStorage.get();
+            fColorXformSrcRowBytes = colorXformBytes;
             break;
         }
     }
@@ -467,6 +480,10 @@ static SkColorSpaceXform::ColorFormat png_select_xform_format(const SkEncodedInf
 }
 
 void SkPngCodec::applyXformRow(void* dst, const void* src) {
+    this->applyXformRow(dst, src, fColorXformSrcRow);
+}
+
+void SkPngCodec::applyXformRow(void* dst, const void* src, void* colorXformSrcRow) {
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
             fSwizzler->swizzle(dst, (const uint8_t*) src);
@@ -475,8 +492,8 @@ void SkPngCodec::applyXformRow(void* dst, const void* src) {
             this->applyColorXform(dst, src, fXformWidth);
             break;
         case kSwizzleColor_XformMode:
-            fSwizzler->swizzle(fColorXformSrcRow, (const uint8_t*) src);
-            this->applyColorXform(dst, fColorXformSrcRow, fXformWidth);
+            fSwizzler->swizzle(colorXformSrcRow, (const uint8_t*) src);
+            this->applyColorXform(dst, colorXformSrcRow, fXformWidth);
             break;
     }
 }
@@ -518,9 +535,31 @@ private:
         return static_cast<SkPngNormalDecoder*>(png_get_progressive_ptr(png_ptr));
     }
 
+    // Rows that libpng has inflated and unfiltered, waiting to be swizzled and color transformed
+    // on fExecutor.
+    struct RowBatch {
+        SkAutoTMalloc<uint8_t> fSrcRows;
+        SkAutoTMalloc<uint8_t> fColorXformSrcRow;
+        void*                  fDst;
+        int                    fRowCount;
+    };
+
+    static constexpr int kRowsPerBatch = 16;
+    static constexpr int kBatchesInFlight = 4;
+
+    static void ParallelRowsCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum,
+                                     int /*pass*/) {
+        GetDecoder(png_ptr)->parallelRowsCallback(row, rowNum);
+    }
+
+    SkTaskGroup*                fTaskGroup = nullptr;
+    RowBatch                    fBatches[kBatchesInFlight];
+    int                         fCurrentBatch = 0;
+    int                         fBatchesSinceWait = 0;
+    size_t                      fSrcRowBytes = 0;
+
     Result decodeAllRows(void* dst, size_t rowBytes, int* rowsDecoded) override {
         const int height = this->getInfo().height();
-        png_set_progressive_read_fn(this->png_ptr(), this, nullptr, AllRowsCallback, nullptr);
         fDst = dst;
         fRowBytes = rowBytes;
 
@@ -528,7 +567,36 @@ private:
         fFirstRow = 0;
         fLastRow = height - 1;
 
-        if (!this->processData()) {
+        bool success;
+        if (fExecutor && height > kRowsPerBatch) {
+            // libpng inflates and unfilters on this thread, while the swizzle and color xform
+            // of each batch of rows run on the executor.
+            png_set_progressive_read_fn(this->png_ptr(), this, nullptr, ParallelRowsCallback,
+                                        nullptr);
+            fSrcRowBytes = png_get_rowbytes(this->png_ptr(), this->info_ptr());
+            for (RowBatch& batch : fBatches) {
+                batch.fSrcRows.reset(kRowsPerBatch * fSrcRowBytes);
+                batch.fColorXformSrcRow.reset(fColorXformSrcRowBytes);
+                batch.fDst = nullptr;
+                batch.fRowCount = 0;
+            }
+            fCurrentBatch = 0;
+            fBatchesSinceWait = 0;
+
+            SkTaskGroup taskGroup(*fExecutor);
+            fTaskGroup = &taskGroup;
+            success = this->processData();
+            // Rows of an incomplete image still need to be written.
+            this->submitBatch();
+            taskGroup.wait();
+            fTaskGroup = nullptr;
+        } else {
+            png_set_progressive_read_fn(this->png_ptr(), this, nullptr, AllRowsCallback,
+                                        nullptr);
+            success = this->processData();
+        }
+
+        if (!success) {
             return kErrorInInput;
         }
 
@@ -550,6 +618,41 @@ private:
         fDst = SkTAddOffset<void>(fDst, fRowBytes);
     }
 
+    void parallelRowsCallback(png_bytep row, int rowNum) {
+        SkASSERT(rowNum == fRowsWrittenToOutput);
+        fRowsWrittenToOutput++;
+        RowBatch& batch = fBatches[fCurrentBatch];
+        if (0 == batch.fRowCount) {
+            batch.fDst = fDst;
+        }
+        memcpy(batch.fSrcRows.get() + batch.fRowCount * fSrcRowBytes, row, fSrcRowBytes);
+        fDst = SkTAddOffset<void>(fDst, fRowBytes);
+        if (++batch.fRowCount == kRowsPerBatch) {
+            this->submitBatch();
+        }
+    }
+
+    void submitBatch() {
+        RowBatch* batch = &fBatches[fCurrentBatch];
+        if (0 == batch->fRowCount) {
+            return;
+        }
+        fTaskGroup->add([this, batch] {
+            for (int i = 0; i < batch->fRowCount; ++i) {
+                this->applyXformRow(SkTAddOffset<void>(batch->fDst, i * fRowBytes),
+                                    batch->fSrcRows.get() + i * fSrcRowBytes,
+                                    batch->fColorXformSrcRow.get());
+            }
+        });
+        fCurrentBatch = (fCurrentBatch + 1) % kBatchesInFlight;
+        if (++fBatchesSinceWait == kBatchesInFlight) {
+            // The next batch's storage may still be in use.
+            fTaskGroup->wait();
+            fBatchesSinceWait = 0;
+        }
+        fBatches[fCurrentBatch].fRowCount = 0;
+    }
+
     void setRange(int firstRow, int lastRow, void* dst, size_t rowBytes) override {
         png_set_progressive_read_fn(this->png_ptr(), this, nullptr, RowCallback, nullptr);
         fFirstRow = firstRow;
@@ -983,7 +1086,9 @@ SkPngCodec::SkPngCodec(const SkEncodedInfo& encodedInfo, const SkImageInfo& imag
     , fPng_ptr(png_ptr)
     , fInfo_ptr(info_ptr)
     , fColorXformSrcRow(nullptr)
+    , fColorXformSrcRowBytes(0)
     , fBitDepth(bitDepth)
+    , fExecutor(nullptr)
     , fIdatLength(0)
     , fDecodedIdat(false)
 {}
@@ -1130,7 +1235,10 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
 
     this->allocateStorage(dstInfo);
     this->initializeXformParams();
-    return this->decodeAllRows(dst, rowBytes, rowsDecoded);
+    fExecutor = options.fExecutor;
+    result = this->decodeAllRows(dst, rowBytes, rowsDecoded);
+    fExecutor = nullptr;
+    return result;
 }
 
 SkCodec::Result SkPngCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo,
@@ -56,6 +56,9 @@ protected:
 
     SkSampler* getSampler(bool createIfNecessary) override;
     void applyXformRow(void* dst, const void* src);
+    // Same as above, but swizzles into 'colorXformSrcRow' instead of fColorXformSrcRow. It only
+    // reads shared state, so it may be called from several threads at once.
+    void applyXformRow(void* dst, const void* src, void* colorXformSrcRow);
 
     voidp png_ptr() { return fPng_ptr; }
     voidp info_ptr() { return fInfo_ptr; }
@@ -86,8 +89,12 @@ protected:
     std::unique_ptr<SkSwizzler> fSwizzler;
     SkAutoTMalloc<uint8_t>      fStorage;
     void*                       fColorXformSrcRow;
+    size_t                      fColorXformSrcRowBytes;
     const int                   fBitDepth;
 
+    // Set by onGetPixels() to Options::fExecutor. May be used by decodeAllRows().
+    SkExecutor*                 fExecutor;
+
 private:
 
     enum XformMode {
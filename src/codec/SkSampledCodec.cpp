@@ -214,6 +214,14 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
 
     const SkImageInfo nativeInfo = info.makeWH(nativeSize.width(), nativeSize.height());
 
+    if (SampleFilter::kBox == options.fSampleFilter) {
+        const SkCodec::Result boxResult = this->boxFilterDecode(info, pixels, rowBytes,
+                nativeInfo, sampledOptions, subsetY, sampleX, sampleY, options.fZeroInitialized);
+        if (boxResult != SkCodec::kUnimplemented) {
+            return boxResult;
+        }
+    }
+
     {
         // Although startScanlineDecode expects the bottom and top to match the
         // SkImageInfo, startIncrementalDecode uses them to determine which rows to
@@ -347,3 +355,82 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
             return SkCodec::kUnimplemented;
     }
 }
+
+// Adds each run of sampleX pixels of src to a pixel of sums.
+template <int kChannels>
+static void accumulate_row(uint32_t* sums, const uint8_t* src, int dstWidth, int sampleX) {
+    for (int x = 0; x < dstWidth; x++) {
+        for (int i = 0; i < sampleX; i++) {
+            for (int c = 0; c < kChannels; c++) {
+                sums[c] += src[c];
+            }
+            src += kChannels;
+        }
+        sums += kChannels;
+    }
+}
+
+SkCodec::Result SkSampledCodec::boxFilterDecode(const SkImageInfo& info, void* pixels,
+        size_t rowBytes, const SkImageInfo& nativeInfo, const SkCodec::Options& nativeOptions,
+        int subsetY, int sampleX, int sampleY, SkCodec::ZeroInitialized zeroInit) {
+    void (*accumulate)(uint32_t*, const uint8_t*, int, int);
+    switch (info.colorType()) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+            accumulate = accumulate_row<4>;
+            break;
+        case kAlpha_8_SkColorType:
+        case kGray_8_SkColorType:
+            accumulate = accumulate_row<1>;
+            break;
+        default:
+            return SkCodec::kUnimplemented;
+    }
+    if (this->codec()->getScanlineOrder() != SkCodec::kTopDown_SkScanlineOrder) {
+        return SkCodec::kUnimplemented;
+    }
+
+    const SkCodec::Result result = this->codec()->startScanlineDecode(nativeInfo,
+            &nativeOptions);
+    if (SkCodec::kSuccess != result) {
+        return result;
+    }
+
+    const int channels = info.bytesPerPixel();
+    const int dstWidth = info.width();
+    const int dstHeight = info.height();
+    const uint32_t area = sampleX * sampleY;
+    SkAutoTMalloc<uint8_t> row(nativeInfo.minRowBytes());
+    SkAutoTMalloc<uint32_t> sums(dstWidth * channels);
+
+    int y = 0;
+    if (this->codec()->skipScanlines(subsetY)) {
+        for (; y < dstHeight; y++) {
+            sk_bzero(sums.get(), dstWidth * channels * sizeof(uint32_t));
+            int rows = 0;
+            for (; rows < sampleY; rows++) {
+                if (1 != this->codec()->getScanlines(row.get(), 1, nativeInfo.minRowBytes())) {
+                    break;
+                }
+                accumulate(sums.get(), row.get(), dstWidth, sampleX);
+            }
+            if (rows < sampleY) {
+                break;
+            }
+            uint8_t* dst = SkTAddOffset<uint8_t>(pixels, y * rowBytes);
+            for (int i = 0; i < dstWidth * channels; i++) {
+                dst[i] = (sums[i] + area / 2) / area;
+            }
+        }
+    }
+    if (dstHeight == y) {
+        return SkCodec::kSuccess;
+    }
+
+    // We handle filling uninitialized memory here instead of using this->codec(), whose
+    // sampler does not know about the dst width.
+    const SkImageInfo fillInfo = info.makeWH(dstWidth, dstHeight - y);
+    SkSampler::Fill(fillInfo, SkTAddOffset<void>(pixels, y * rowBytes), rowBytes,
+                    this->codec()->getFillValue(info), zeroInit);
+    return SkCodec::kIncompleteInput;
+}
@@ -54,6 +54,18 @@ private:
     SkCodec::Result sampledDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
             const AndroidOptions& options);
 
+    /**
+     *  Called by sampledDecode() for SampleFilter::kBox. Decodes the scanlines of
+     *  nativeInfo one at a time and averages each sampleX x sampleY block into a
+     *  dst pixel.
+     *
+     *  Returns kUnimplemented if the dst or the codec's scanline order is not
+     *  supported, in which case the caller should point sample.
+     */
+    SkCodec::Result boxFilterDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
+            const SkImageInfo& nativeInfo, const SkCodec::Options& nativeOptions, int subsetY,
+            int sampleX, int sampleY, SkCodec::ZeroInitialized);
+
     typedef SkAndroidCodec INHERITED;
 };
 #endif // SkSampledCodec_DEFINED
@@ -13,6 +13,8 @@ SkStreamBuffer::SkStreamBuffer(std::unique_ptr<SkStream> stream)
     , fBytesBuffered(0)
     , fHasLengthAndPosition(fStream->hasLength() && fStream->hasPosition())
     , fTrulyBuffered(0)
+    , fMemoryBase(fHasLengthAndPosition ? static_cast<const char*>(fStream->getMemoryBase())
+                                        : nullptr)
 {}
 
 SkStreamBuffer::~SkStreamBuffer() {
@@ -21,6 +23,19 @@ SkStreamBuffer::~SkStreamBuffer() {
 
 const char* SkStreamBuffer::get() const {
     SkASSERT(fBytesBuffered >= 1);
+    if (fMemoryBase) {
+        // fTrulyBuffered stays zero, so the stream is at fPosition.
+        return fMemoryBase + fPosition;
+    }
+    if (fHasLengthAndPosition && fTrulyBuffered == 0) {
+        // If the bytes are in one chunk of the stream's memory, point there instead, leaving the
+        // stream at fPosition.
+        size_t chunkSize;
+        const void* chunk = const_cast<SkStream*>(fStream.get())->getMemoryChunk(&chunkSize);
+        if (chunk && chunkSize >= fBytesBuffered) {
+            return static_cast<const char*>(chunk);
+        }
+    }
     if (fHasLengthAndPosition && fTrulyBuffered < fBytesBuffered) {
         const size_t bytesToBuffer = fBytesBuffered - fTrulyBuffered;
         char* dst = SkTAddOffset<char>(const_cast<char*>(fBuffer), fTrulyBuffered);
@@ -74,11 +89,24 @@ sk_sp<SkData> SkStreamBuffer::getDataAtPosition(size_t position, size_t length)
 
     SkASSERT(position + length <= fStream->getLength());
 
+    if (fMemoryBase) {
+        // The data is only used while the stream is alive.
+        return SkData::MakeWithoutCopy(fMemoryBase + position, length);
+    }
+
     const size_t oldPosition = fStream->getPosition();
     if (!fStream->seek(position)) {
         return nullptr;
     }
 
+    size_t chunkSize;
+    const void* chunk = fStream->getMemoryChunk(&chunkSize);
+    if (chunk && chunkSize >= length) {
+        fStream->seek(oldPosition);
+        // As above, the data is only used while the stream is alive.
+        return SkData::MakeWithoutCopy(chunk, length);
+    }
+
     sk_sp<SkData> data(SkData::MakeUninitialized(length));
     void* dst = data->writable_data();
     const bool success = fStream->read(dst, length) == length;
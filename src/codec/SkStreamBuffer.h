@@ -108,6 +108,11 @@ private:
     // The second call to get() needs to only truly buffer the part that was
     // not already buffered.
     mutable size_t              fTrulyBuffered;
+    // If the stream also has a memory base, get() and getDataAtPosition()
+    // point into that memory, and nothing is truly buffered. Otherwise they
+    // still point into the stream's memory when the bytes they want are in
+    // one of its chunks (see SkStream::getMemoryChunk()).
+    const char*                 fMemoryBase;
     // Only used if !fHasLengthAndPosition. In that case, markPosition will
     // copy into an SkData, stored here.
     SkTHashMap<size_t, SkData*> fMarkedData;
@@ -545,6 +545,28 @@ static void swizzle_rgb16_to_bgra(
     }
 }
 
+static void fast_swizzle_rgb16_to_rgba(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_RGB1((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgb16_to_bgra(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_BGR1((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgb16_to_565(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -620,6 +642,54 @@ static void swizzle_rgba16_to_bgra_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgba16_to_rgba_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    // Strip to 8-bit, then premultiply in place.
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+    SkOpts::RGBA_to_rgbA((uint32_t*) dst, dst, width);
+}
+
+static void fast_swizzle_rgba16_to_bgra_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgba16_to_bgra_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    // Strip to 8-bit, then swap RB and premultiply in place.
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+    SkOpts::RGBA_to_bgrA((uint32_t*) dst, dst, width);
+}
+
 // kCMYK
 //
 // CMYK is stored as four bytes per pixel.
@@ -968,6 +1038,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                     case kRGBA_8888_SkColorType:
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = &swizzle_rgb16_to_rgba;
+                            fastProc = &fast_swizzle_rgb16_to_rgba;
                             break;
                         }
 
@@ -978,6 +1049,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                     case kBGRA_8888_SkColorType:
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = &swizzle_rgb16_to_bgra;
+                            fastProc = &fast_swizzle_rgb16_to_bgra;
                             break;
                         }
 
@@ -1003,6 +1075,8 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = premultiply ? &swizzle_rgba16_to_rgba_premul :
                                                  &swizzle_rgba16_to_rgba_unpremul;
+                            fastProc = premultiply ? &fast_swizzle_rgba16_to_rgba_premul :
+                                                     &fast_swizzle_rgba16_to_rgba_unpremul;
                             break;
                         }
 
@@ -1030,6 +1104,8 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                         if (16 == encodedInfo.bitsPerComponent()) {
                             proc = premultiply ? &swizzle_rgba16_to_bgra_premul :
                                                  &swizzle_rgba16_to_bgra_unpremul;
+                            fastProc = premultiply ? &fast_swizzle_rgba16_to_bgra_premul :
+                                                     &fast_swizzle_rgba16_to_bgra_unpremul;
                             break;
                         }
 
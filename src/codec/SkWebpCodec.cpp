@@ -228,6 +228,85 @@ bool SkWebpCodec::onGetValidSubset(SkIRect* desiredSubset) const {
     return true;
 }
 
+bool SkWebpCodec::onQueryYUV8(SkYUVSizeInfo* sizeInfo, SkYUVColorSpace* colorSpace) const {
+    // Only opaque, lossy still images are decoded to YUV. Frames of animations are blended in RGB.
+    auto flags = WebPDemuxGetI(fDemux.get(), WEBP_FF_FORMAT_FLAGS);
+    if (SkEncodedInfo::kYUV_Color != this->getEncodedInfo().color() || (flags & ANIMATION_FLAG)) {
+        return false;
+    }
+
+    // libwebp outputs 4:2:0 planes with any stride.
+    const int width = this->getInfo().width();
+    const int height = this->getInfo().height();
+    sizeInfo->fSizes[SkYUVSizeInfo::kY].set(width, height);
+    sizeInfo->fSizes[SkYUVSizeInfo::kU].set((width + 1) / 2, (height + 1) / 2);
+    sizeInfo->fSizes[SkYUVSizeInfo::kV] = sizeInfo->fSizes[SkYUVSizeInfo::kU];
+    for (auto i : { SkYUVSizeInfo::kY, SkYUVSizeInfo::kU, SkYUVSizeInfo::kV }) {
+        sizeInfo->fWidthBytes[i] = sizeInfo->fSizes[i].width();
+    }
+
+    if (colorSpace) {
+        // VP8 uses BT.601 with limited range.
+        *colorSpace = kRec601_SkYUVColorSpace;
+    }
+
+    return true;
+}
+
+SkCodec::Result SkWebpCodec::onGetYUV8Planes(const SkYUVSizeInfo& sizeInfo, void* planes[3]) {
+    SkYUVSizeInfo defaultInfo;
+    if (!this->onQueryYUV8(&defaultInfo, nullptr) ||
+            sizeInfo.fSizes[SkYUVSizeInfo::kY] != defaultInfo.fSizes[SkYUVSizeInfo::kY] ||
+            sizeInfo.fSizes[SkYUVSizeInfo::kU] != defaultInfo.fSizes[SkYUVSizeInfo::kU] ||
+            sizeInfo.fSizes[SkYUVSizeInfo::kV] != defaultInfo.fSizes[SkYUVSizeInfo::kV] ||
+            sizeInfo.fWidthBytes[SkYUVSizeInfo::kY] < defaultInfo.fWidthBytes[SkYUVSizeInfo::kY] ||
+            sizeInfo.fWidthBytes[SkYUVSizeInfo::kU] < defaultInfo.fWidthBytes[SkYUVSizeInfo::kU] ||
+            sizeInfo.fWidthBytes[SkYUVSizeInfo::kV] < defaultInfo.fWidthBytes[SkYUVSizeInfo::kV]) {
+        return kInvalidInput;
+    }
+
+    WebPDecoderConfig config;
+    if (0 == WebPInitDecoderConfig(&config)) {
+        // ABI mismatch.
+        return kInvalidInput;
+    }
+
+    // Free any memory associated with the buffer. Must be called last, so we declare it first.
+    SkAutoTCallVProc<WebPDecBuffer, WebPFreeDecBuffer> autoFree(&(config.output));
+
+    WebPIterator frame;
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
+    if (!WebPDemuxGetFrame(fDemux, 1, &frame)) {
+        return kIncompleteInput;
+    }
+
+    config.output.colorspace = MODE_YUV;
+    config.output.is_external_memory = 1;
+    WebPYUVABuffer& yuv = config.output.u.YUVA;
+    yuv.y = static_cast<uint8_t*>(planes[SkYUVSizeInfo::kY]);
+    yuv.u = static_cast<uint8_t*>(planes[SkYUVSizeInfo::kU]);
+    yuv.v = static_cast<uint8_t*>(planes[SkYUVSizeInfo::kV]);
+    yuv.y_stride = SkToInt(sizeInfo.fWidthBytes[SkYUVSizeInfo::kY]);
+    yuv.u_stride = SkToInt(sizeInfo.fWidthBytes[SkYUVSizeInfo::kU]);
+    yuv.v_stride = SkToInt(sizeInfo.fWidthBytes[SkYUVSizeInfo::kV]);
+    yuv.y_size = sizeInfo.fWidthBytes[SkYUVSizeInfo::kY] *
+                 sizeInfo.fSizes[SkYUVSizeInfo::kY].height();
+    yuv.u_size = sizeInfo.fWidthBytes[SkYUVSizeInfo::kU] *
+                 sizeInfo.fSizes[SkYUVSizeInfo::kU].height();
+    yuv.v_size = sizeInfo.fWidthBytes[SkYUVSizeInfo::kV] *
+                 sizeInfo.fSizes[SkYUVSizeInfo::kV].height();
+
+    switch (WebPDecode(frame.fragment.bytes, frame.fragment.size, &config)) {
+        case VP8_STATUS_OK:
+            return kSuccess;
+        case VP8_STATUS_SUSPENDED:
+        case VP8_STATUS_NOT_ENOUGH_DATA:
+            return kIncompleteInput;
+        default:
+            return kInvalidInput;
+    }
+}
+
 int SkWebpCodec::onGetRepetitionCount() {
     auto flags = WebPDemuxGetI(fDemux.get(), WEBP_FF_FORMAT_FLAGS);
     if (!(flags & ANIMATION_FLAG)) {
@@ -6,6 +6,7 @@
  */
 
 #include "SkAAClip.h"
+#include "Sk4px.h"
 #include "SkAtomics.h"
 #include "SkBlitter.h"
 #include "SkColorData.h"
@@ -2066,10 +2067,6 @@ static void small_bzero(void* dst, size_t n) {
     sk_bzero(dst, n);
 }
 
-static inline uint8_t mergeOne(uint8_t value, unsigned alpha) {
-    return SkMulDiv255Round(value, alpha);
-}
-
 static inline uint16_t mergeOne(uint16_t value, unsigned alpha) {
     unsigned r = SkGetPackedR16(value);
     unsigned g = SkGetPackedG16(value);
@@ -2112,6 +2109,51 @@ void mergeT(const void* inSrc, int srcN, const uint8_t* SK_RESTRICT row, int row
     }
 }
 
+// dst[i] = SkMulDiv255Round(src[i], alpha), 16 at a time.
+static void scale_a8(uint8_t* SK_RESTRICT dst, const uint8_t* SK_RESTRICT src, unsigned alpha,
+                     int n) {
+    const Sk4px a = Sk4px::DupAlpha(alpha);
+    while (n >= 16) {
+        (Sk4px(Sk16b::Load(src)) * a).div255().store(dst);
+        dst += 16; src += 16; n -= 16;
+    }
+    for (int i = 0; i < n; ++i) {
+        dst[i] = SkMulDiv255Round(src[i], alpha);
+    }
+}
+
+// mergeT<uint8_t>, scaling partial runs 16 pixels at a time.
+static void merge_a8(const void* inSrc, int srcN, const uint8_t* SK_RESTRICT row, int rowN,
+                     void* inDst) {
+    const uint8_t* SK_RESTRICT src = static_cast<const uint8_t*>(inSrc);
+    uint8_t* SK_RESTRICT       dst = static_cast<uint8_t*>(inDst);
+    for (;;) {
+        SkASSERT(rowN > 0);
+        SkASSERT(srcN > 0);
+
+        int n = SkMin32(rowN, srcN);
+        unsigned rowA = row[1];
+        if (0xFF == rowA) {
+            small_memcpy(dst, src, n);
+        } else if (0 == rowA) {
+            small_bzero(dst, n);
+        } else {
+            scale_a8(dst, src, rowA, n);
+        }
+
+        if (0 == (srcN -= n)) {
+            break;
+        }
+
+        src += n;
+        dst += n;
+
+        SkASSERT(rowN == n);
+        row += 2;
+        rowN = row[0];
+    }
+}
+
 static MergeAAProc find_merge_aa_proc(SkMask::Format format) {
     switch (format) {
         case SkMask::kBW_Format:
@@ -2119,7 +2161,7 @@ static MergeAAProc find_merge_aa_proc(SkMask::Format format) {
             return nullptr;
         case SkMask::kA8_Format:
         case SkMask::k3D_Format:
-            return mergeT<uint8_t> ;
+            return merge_a8;
         case SkMask::kLCD16_Format:
             return mergeT<uint16_t>;
         default:
@@ -2214,8 +2256,8 @@ void SkAAClipBlitter::blitMask(const SkMask& origMask, const SkIRect& clip) {
     rowMask.fFormat = SkMask::k3D_Format == mask->fFormat ? SkMask::kA8_Format : mask->fFormat;
     rowMask.fBounds.fLeft = clip.fLeft;
     rowMask.fBounds.fRight = clip.fRight;
-    rowMask.fRowBytes = mask->fRowBytes; // doesn't matter, since our height==1
-    rowMask.fImage = (uint8_t*)fScanlineScratch;
+    rowMask.fRowBytes = width * (SkMask::kLCD16_Format == rowMask.fFormat ? 2 : 1);
+    const int maxTileRows = SkTMax(1, (int)(kMaxTileBytes / rowMask.fRowBytes));
 
     int y = clip.fTop;
     const int stopY = y + clip.height();
@@ -2228,13 +2270,25 @@ void SkAAClipBlitter::blitMask(const SkMask& origMask, const SkIRect& clip) {
 
         int initialCount;
         row = fAAClip->findX(row, clip.fLeft, &initialCount);
+        // The rows down to localStopY share this clip row, so we merge as many of them as fit
+        // into one tile, and hand the blitter a single mask for the lot.
         do {
-            mergeProc(src, width, row, initialCount, rowMask.fImage);
+            int tileRows = SkMin32(localStopY - y, maxTileRows);
+            uint8_t* tile = (uint8_t*)fScanlineScratch;
+            if (tileRows > 1) {
+                tile = (uint8_t*)fTileScratch.reset(tileRows * rowMask.fRowBytes,
+                                                    SkAutoMalloc::kReuse_OnShrink);
+            }
+            for (int i = 0; i < tileRows; ++i) {
+                mergeProc(src, width, row, initialCount, tile + i * rowMask.fRowBytes);
+                src = (const void*)((const char*)src + srcRB);
+            }
+            rowMask.fImage = tile;
             rowMask.fBounds.fTop = y;
-            rowMask.fBounds.fBottom = y + 1;
+            rowMask.fBounds.fBottom = y + tileRows;
             fBlitter->blitMask(rowMask, rowMask.fBounds);
-            src = (const void*)((const char*)src + srcRB);
-        } while (++y < localStopY);
+            y += tileRows;
+        } while (y < localStopY);
     } while (y < stopY);
 }
 
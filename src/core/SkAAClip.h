@@ -126,9 +126,11 @@ private:
     SkAlpha*        fAA;
 
     enum {
-        kSize = 32 * 32
+        kSize = 32 * 32,
+        kMaxTileBytes = 8 * 1024
     };
     SkAutoSMalloc<kSize> fGrayMaskScratch;  // used for blitMask
+    SkAutoMalloc fTileScratch;  // used for blitMask, to merge rows that share a clip row
     void* fScanlineScratch;  // enough for a mask at 32bit, or runs+aa
 
     void ensureRunsAndAA();
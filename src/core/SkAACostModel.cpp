@@ -0,0 +1,119 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAACostModel.h"
+#include "SkPath.h"
+#include "SkPoint.h"
+
+#include <stdlib.h>
+
+static SkAACostModel gModel = {{
+    //  perPath  perEdge  perEdgeRow  perPixel  perCrossing
+    {   1000.0f,   40.0f,     12.00f,    0.50f,       0.20f },  // kSupersample
+    {    600.0f,   60.0f,      3.00f,    0.20f,      20.00f },  // kAnalytic
+    {    500.0f,   60.0f,      4.00f,    0.60f,       0.00f },  // kDelta
+}};
+
+const SkAACostModel& SkAACostModel::Get() { return gModel; }
+void SkAACostModel::Set(const SkAACostModel& model) { gModel = model; }
+
+const char* SkAACostModel::Name(ScanConverter sc) {
+    switch (sc) {
+        case kSupersample: return "supersample";
+        case kAnalytic:    return "analytic";
+        case kDelta:       return "delta";
+    }
+    return "";
+}
+
+SkAACostModel::Features SkAACostModel::Features::Make(const SkPath& path,
+                                                      const SkIRect& clipBounds) {
+    // Like ShouldUseDAA(), we only look at the first few points to guess how long the edges are.
+    constexpr int kSampleSize = 8;
+
+    Features f = {0, 0, 0, 0};
+
+    const SkRect& bounds = path.getBounds();
+    SkIRect clippedIR;
+    if (!clippedIR.intersect(bounds.roundOut(), clipBounds)) {
+        return f;
+    }
+
+    int n = path.countPoints();
+    int samples = SkTMin(n, kSampleSize);
+    SkScalar sumDY = 0,
+             sumLength = 0;
+    for (int i = 1; i < samples; ++i) {
+        SkPoint p0 = path.getPoint(i - 1),
+                p1 = path.getPoint(i);
+        sumDY     += SkScalarAbs(p1.fY - p0.fY);
+        sumLength += SkPoint::Distance(p0, p1);
+    }
+    SkScalar avgDY     = samples > 1 ? sumDY     / (samples - 1) : bounds.height();
+    SkScalar avgLength = samples > 1 ? sumLength / (samples - 1) : 0;
+
+    // Only the part of the path inside the clip costs us per row and per crossing.
+    SkScalar clipFraction = bounds.height() > 0
+                          ? SkTMin(1.0f, clippedIR.height() / bounds.height()) : 1.0f;
+
+    f.fEdges    = n;
+    f.fEdgeRows = n * clipFraction * (SkTMin(avgDY, (SkScalar)clippedIR.height()) + 1);
+    f.fPixels   = (float)clippedIR.width() * clippedIR.height();
+
+    // As in ShouldUseDAA(), random line segments cross about (n * sampleSpan)^2 times.
+    SkScalar diagonal = SkPoint::Length(bounds.width(), bounds.height());
+    if (!path.isConvex() && diagonal > 0) {
+        SkScalar span = n * avgLength / diagonal;
+        f.fCrossings  = span * span * clipFraction;
+    }
+    return f;
+}
+
+SkAACostModel::ScanConverter SkAACostModel::choose(const Features& f, bool allowAnalytic,
+                                                   bool allowDelta) const {
+    ScanConverter best = kSupersample;
+    float bestCost = fCosts[kSupersample].estimate(f);
+    if (allowAnalytic && fCosts[kAnalytic].estimate(f) < bestCost) {
+        best     = kAnalytic;
+        bestCost = fCosts[kAnalytic].estimate(f);
+    }
+    if (allowDelta && fCosts[kDelta].estimate(f) < bestCost) {
+        best     = kDelta;
+    }
+    return best;
+}
+
+SkString SkAACostModel::toString() const {
+    SkString str;
+    for (int i = 0; i < kScanConverterCount; ++i) {
+        const Cost& c = fCosts[i];
+        str.appendf("%s%.9g,%.9g,%.9g,%.9g,%.9g", i ? "," : "",
+                    c.fPerPath, c.fPerEdge, c.fPerEdgeRow, c.fPerPixel, c.fPerCrossing);
+    }
+    return str;
+}
+
+bool SkAACostModel::parse(const char* str) {
+    constexpr int kCoefficients = kScanConverterCount * sizeof(Cost) / sizeof(float);
+
+    float coefficients[kCoefficients];
+    for (int i = 0; i < kCoefficients; ++i) {
+        char* end;
+        coefficients[i] = strtof(str, &end);
+        if (end == str || (i + 1 < kCoefficients && *end != ',')) {
+            return false;
+        }
+        str = end + (i + 1 < kCoefficients);
+    }
+    if (*str != '\0') {
+        return false;
+    }
+
+    static_assert(sizeof(fCosts) == sizeof(coefficients), "");
+    memcpy(fCosts, coefficients, sizeof(fCosts));
+    return true;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAACostModel_DEFINED
+#define SkAACostModel_DEFINED
+
+#include "SkRect.h"
+#include "SkString.h"
+
+class SkPath;
+
+// A tiny linear model of how long each AA scan converter takes to fill a path.  When
+// gSkUseAACostModel is set, SkScan::AntiFillPath uses it to pick the cheapest scan converter for
+// each path instead of the static ShouldUseDAA/ShouldUseAAA heuristics.
+//
+// The model is per-process.  The defaults are rough guesses for a desktop x86 machine; running
+// nanobench --calibrateAACost measures the current machine, installs the fitted model, and prints
+// it in a form that --aaCostCoefficients accepts.
+struct SkAACostModel {
+    enum ScanConverter {
+        kSupersample,   // SkScan::SAAFillPath
+        kAnalytic,      // SkScan::AAAFillPath
+        kDelta,         // SkScan::DAAFillPath
+    };
+    static constexpr int kScanConverterCount = 3;
+
+    // What we can cheaply learn about a path (and its device clip) before scan converting it.
+    struct Features {
+        float fEdges;       // number of edges, estimated by path.countPoints()
+        float fEdgeRows;    // estimated sum over all edges of the pixel rows they span
+        float fPixels;      // area of the path bounds within the clip
+        float fCrossings;   // estimated number of edge intersections; 0 for convex paths
+
+        static Features Make(const SkPath&, const SkIRect& clipBounds);
+    };
+
+    // Estimated cost in nanoseconds:
+    //   fPerPath + fPerEdge * edges + fPerEdgeRow * edgeRows + fPerPixel * pixels
+    //            + fPerCrossing * crossings
+    struct Cost {
+        float fPerPath;
+        float fPerEdge;
+        float fPerEdgeRow;
+        float fPerPixel;
+        float fPerCrossing;
+
+        float estimate(const Features& f) const {
+            return fPerPath + fPerEdge     * f.fEdges
+                            + fPerEdgeRow  * f.fEdgeRows
+                            + fPerPixel    * f.fPixels
+                            + fPerCrossing * f.fCrossings;
+        }
+    };
+
+    Cost fCosts[kScanConverterCount];
+
+    // Returns the cheapest scan converter that's allowed.  Supersampling is always allowed.
+    ScanConverter choose(const Features&, bool allowAnalytic, bool allowDelta) const;
+
+    // Comma-separated coefficients, kSupersample's first, in the order of Cost's fields.
+    SkString toString() const;
+    bool parse(const char*);   // Returns false (leaving this unchanged) if it can't be parsed.
+
+    static const char* Name(ScanConverter);
+
+    static const SkAACostModel& Get();
+    static void Set(const SkAACostModel&);   // Not thread safe.
+};
+
+#endif
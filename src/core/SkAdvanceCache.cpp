@@ -0,0 +1,112 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAdvanceCache.h"
+
+#include "SkEndian.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
+#include "SkOTTable_hhea.h"
+#include "SkOTTable_hmtx.h"
+#include "SkPaint.h"
+#include "SkPaintPriv.h"
+#include "SkScalerContext.h"
+#include "SkTypeface.h"
+
+#include <stddef.h>
+
+// Typefaces whose advances are kept, including those found not to have usable ones.
+static constexpr int kMaxTypefaces = 64;
+
+SK_DECLARE_STATIC_MUTEX(gAdvanceCacheMutex);
+
+SkAdvanceCache::SkAdvanceCache(int count, int unitsPerEm)
+    : fCount(count)
+    , fUnitsPerEm(unitsPerEm)
+    , fAdvances(count) {}
+
+sk_sp<SkAdvanceCache> SkAdvanceCache::Make(const SkTypeface& typeface) {
+    constexpr SkFontTableTag hheaTag = SkTEndian_SwapBE32(SkOTTableHorizontalHeader::TAG);
+    constexpr SkFontTableTag hmtxTag = SkTEndian_SwapBE32(SkOTTableHorizontalMetrics::TAG);
+
+    // Variable fonts adjust their advances with 'HVAR', and scalers size the strikes of bitmap
+    // fonts to the text, so only outline fonts without variations scale 'hmtx' linearly.
+    if (typeface.getTableSize(SkSetFourByteTag('f', 'v', 'a', 'r')) ||
+        (!typeface.getTableSize(SkSetFourByteTag('g', 'l', 'y', 'f')) &&
+         !typeface.getTableSize(SkSetFourByteTag('C', 'F', 'F', ' ')))) {
+        return nullptr;
+    }
+
+    const int count = typeface.countGlyphs();
+    const int unitsPerEm = typeface.getUnitsPerEm();
+    SK_OT_USHORT numberOfHMetrics;
+    constexpr size_t numberOfHMetricsOffset =
+            offsetof(SkOTTableHorizontalHeader, numberOfHMetrics);
+    if (count <= 0 || unitsPerEm <= 0 ||
+        typeface.getTableData(hheaTag, numberOfHMetricsOffset, sizeof(numberOfHMetrics),
+                              &numberOfHMetrics) != sizeof(numberOfHMetrics)) {
+        return nullptr;
+    }
+
+    // Glyphs after the last full metric have its advance.
+    using FullMetric = SkOTTableHorizontalMetrics::FullMetric;
+    const int fullCount = SkTMin<int>(SkEndian_SwapBE16(numberOfHMetrics), count);
+    SkAutoTMalloc<FullMetric> metrics(fullCount);
+    const size_t metricsSize = fullCount * sizeof(FullMetric);
+    if (fullCount == 0 ||
+        typeface.getTableData(hmtxTag, 0, metricsSize, metrics.get()) != metricsSize) {
+        return nullptr;
+    }
+
+    sk_sp<SkAdvanceCache> advances(new SkAdvanceCache(count, unitsPerEm));
+    for (int i = 0; i < count; ++i) {
+        const FullMetric& metric = metrics[SkTMin(i, fullCount - 1)];
+        advances->fAdvances[i] = SkEndian_SwapBE16(metric.advanceWidth);
+    }
+    return advances;
+}
+
+sk_sp<SkAdvanceCache> SkAdvanceCache::Find(const SkPaint& paint, SkScalar* scale) {
+    SkScalerContextRec rec;
+    SkScalerContextEffects effects;
+    SkScalerContext::MakeRecAndEffects(paint, nullptr, nullptr, SkScalerContextFlags::kNone,
+                                       &rec, &effects);
+    SkTypeface* typeface = SkPaintPriv::GetTypefaceOrDefault(paint);
+    SkScalar size;
+    if (!typeface->onGetLinearAdvanceSize(rec, &size)) {
+        return nullptr;
+    }
+
+    static auto* gCache = new SkLRUCache<SkFontID, sk_sp<SkAdvanceCache>>(kMaxTypefaces);
+    sk_sp<SkAdvanceCache> advances;
+    {
+        SkAutoMutexAcquire lock(gAdvanceCacheMutex);
+        if (sk_sp<SkAdvanceCache>* cached = gCache->find(typeface->uniqueID())) {
+            advances = *cached;
+            if (!advances) {
+                return nullptr;
+            }
+        }
+    }
+    if (!advances) {
+        // Read the tables without the lock. Another thread may be reading them too; the first
+        // to finish caches its advances.
+        advances = Make(*typeface);
+        SkAutoMutexAcquire lock(gAdvanceCacheMutex);
+        if (sk_sp<SkAdvanceCache>* cached = gCache->find(typeface->uniqueID())) {
+            advances = *cached;
+        } else {
+            gCache->insert(typeface->uniqueID(), advances);
+        }
+        if (!advances) {
+            return nullptr;
+        }
+    }
+
+    *scale = size / advances->fUnitsPerEm;
+    return advances;
+}
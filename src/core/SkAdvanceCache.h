@@ -0,0 +1,50 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAdvanceCache_DEFINED
+#define SkAdvanceCache_DEFINED
+
+#include "SkRefCnt.h"
+#include "SkScalar.h"
+#include "SkTemplates.h"
+#include "SkTypes.h"
+
+class SkPaint;
+class SkTypeface;
+
+/**
+ *  The advances of a typeface's glyphs in font units, read in bulk from its 'hmtx' table and
+ *  cached by typeface.
+ *
+ *  Scalers that don't hint advances just scale these by the text size, so text drawn with them can
+ *  be measured without finding or creating a strike, which needs a scaler context and caches a
+ *  glyph per glyph ID. SkPaint measures text this way when it doesn't need glyph bounds.
+ */
+class SkAdvanceCache : public SkNVRefCnt<SkAdvanceCache> {
+public:
+    /**
+     *  If the paint's typeface scales its advances linearly at the paint's settings (see
+     *  SkTypeface::onGetLinearAdvanceSize), returns its advances and sets scale to what converts
+     *  them to pixels. Otherwise returns nullptr, and a strike has to be used.
+     */
+    static sk_sp<SkAdvanceCache> Find(const SkPaint&, SkScalar* scale);
+
+    /** Returns the advance of the glyph in font units, 0 if the typeface has no such glyph. */
+    int advance(SkGlyphID glyph) const { return glyph < fCount ? fAdvances[glyph] : 0; }
+
+private:
+    SkAdvanceCache(int count, int unitsPerEm);
+
+    // Returns nullptr if the typeface's advances can't be read from its tables.
+    static sk_sp<SkAdvanceCache> Make(const SkTypeface&);
+
+    const int               fCount;
+    const int               fUnitsPerEm;
+    SkAutoTMalloc<uint16_t> fAdvances;
+};
+
+#endif
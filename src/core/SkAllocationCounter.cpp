@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAllocationCounter.h"
+
+#include "SkTLS.h"
+
+#include <atomic>
+#include <stdlib.h>
+
+#if defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_IOS)
+    #include <malloc/malloc.h>
+    static size_t allocated_size(void* ptr) { return malloc_size(ptr); }
+#elif defined(SK_BUILD_FOR_WIN)
+    #include <malloc.h>
+    static size_t allocated_size(void* ptr) { return _msize(ptr); }
+#elif defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID)
+    #include <malloc.h>
+    static size_t allocated_size(void* ptr) { return malloc_usable_size(ptr); }
+#else
+    static size_t allocated_size(void*) { return 0; }
+#endif
+
+static std::atomic<bool> gEnabled{false};
+
+namespace {
+
+// Plain old data, so each thread's is zeroed without any construction.
+struct ThreadCounts {
+    uint64_t fAllocations;
+    uint64_t fBytes;
+    int64_t  fLiveBytes;
+    int64_t  fPeakBytes;
+};
+
+}  // namespace
+
+// Each thread's counts are made by Reset() or Get().  Recording only looks them up with
+// SkTLS::Find(), which never allocates, so recording can't recurse into itself.  They're
+// calloc()ed rather than sk_malloc()ed so that making them isn't recorded either.
+static void* create_counts() { return calloc(1, sizeof(ThreadCounts)); }
+static void delete_counts(void* counts) { free(counts); }
+
+static ThreadCounts* get_counts() {
+    return static_cast<ThreadCounts*>(SkTLS::Get(create_counts, delete_counts));
+}
+
+static ThreadCounts* find_counts() {
+    return static_cast<ThreadCounts*>(SkTLS::Find(create_counts));
+}
+
+void SkAllocationCounter::SetEnabled(bool enabled) {
+    gEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void SkAllocationCounter::Reset() {
+    if (ThreadCounts* counts = get_counts()) {
+        *counts = ThreadCounts{0, 0, 0, 0};
+    }
+}
+
+SkAllocationCounter::Counts SkAllocationCounter::Get() {
+    if (const ThreadCounts* counts = get_counts()) {
+        return {counts->fAllocations, counts->fBytes, counts->fPeakBytes};
+    }
+    return {0, 0, 0};
+}
+
+void SkAllocationCounter::RecordAlloc(void* ptr) {
+    if (!ptr || !gEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ThreadCounts* counts = find_counts();
+    if (!counts) {
+        return;
+    }
+    const size_t bytes = allocated_size(ptr);
+    counts->fAllocations++;
+    counts->fBytes += bytes;
+    counts->fLiveBytes += bytes;
+    counts->fPeakBytes = SkTMax(counts->fPeakBytes, counts->fLiveBytes);
+}
+
+void SkAllocationCounter::RecordFree(void* ptr) {
+    if (!ptr || !gEnabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (ThreadCounts* counts = find_counts()) {
+        counts->fLiveBytes -= allocated_size(ptr);
+    }
+}
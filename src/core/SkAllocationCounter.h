@@ -0,0 +1,45 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAllocationCounter_DEFINED
+#define SkAllocationCounter_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ *  Counts the heap allocations each thread makes, for tools measuring allocations per operation.
+ *
+ *  sk_malloc() and friends report to it (when built with SkMemory_malloc.cpp), as does operator
+ *  new in tools that link tools/AllocationCounterNew.cpp.  Nothing is counted until counting is
+ *  enabled, and then only while enabled.
+ */
+class SkAllocationCounter {
+public:
+    struct Counts {
+        uint64_t fAllocations;  // Calls to allocate (and reallocate) memory.
+        uint64_t fBytes;        // Bytes those calls allocated.
+        int64_t  fPeakBytes;    // Most bytes allocated but not yet freed at once.
+    };
+
+    // Turn counting on or off, for all threads.
+    static void SetEnabled(bool);
+
+    // Start counting this thread's allocations from zero.  Threads that have never called Reset()
+    // (or Get()) aren't counted.
+    static void Reset();
+
+    // This thread's allocations since Reset().  Bytes are measured by the allocator, so include
+    // its rounding up.  Memory freed on a different thread than allocated it isn't matched up, so
+    // peaks are only meaningful for work that frees what it allocates on the same thread.
+    static Counts Get();
+
+    // For allocators: record that ptr was just allocated, or is about to be freed.
+    static void RecordAlloc(void* ptr);
+    static void RecordFree(void* ptr);
+};
+
+#endif
@@ -139,6 +139,7 @@ void SkArenaAlloc::ensureSpace(uint32_t size, uint32_t alignment) {
     }
 
     char* newBlock = new char[allocationSize];
+    fHeapBytes += allocationSize;
 
     if (fTotalSlop >= 0) {
         fTotalAlloc += allocationSize;
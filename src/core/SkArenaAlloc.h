@@ -147,6 +147,9 @@ public:
     // Destroy all allocated objects, free any heap allocations.
     void reset();
 
+    // Bytes allocated from the heap because the initial block was too small.
+    size_t heapBytes() const { return fHeapBytes; }
+
 private:
     using Footer = int64_t;
     using FooterAction = char* (char*);
@@ -223,6 +226,7 @@ private:
     char* const    fFirstBlock;
     const uint32_t fFirstSize;
     const uint32_t fExtraSize;
+    uint32_t       fHeapBytes {0};
 
     // Track some useful stats. Track stats if fTotalSlop is >= 0;
     uint32_t       fTotalAlloc { 0};
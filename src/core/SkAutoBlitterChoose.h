@@ -8,9 +8,9 @@
 #ifndef SkAutoBlitterChoose_DEFINED
 #define SkAutoBlitterChoose_DEFINED
 
-#include "SkArenaAlloc.h"
 #include "SkBlitter.h"
 #include "SkDraw.h"
+#include "SkScratchArena.h"
 
 class SkMatrix;
 class SkPaint;
@@ -48,7 +48,7 @@ private:
     // Owned by fAlloc, which will handle the delete.
     SkBlitter* fBlitter = nullptr;
 
-    SkSTArenaAlloc<kSkBlitterContextSize> fAlloc;
+    SkScratchArena fAlloc;
 };
 #define SkAutoBlitterChoose(...) SK_REQUIRE_LOCAL_VAR(SkAutoBlitterChoose)
 
@@ -8,6 +8,7 @@
 #include "SkBBoxHierarchy.h"
 #include "SkBigPicture.h"
 #include "SkPictureCommon.h"
+#include "SkPictureLayerCache.h"
 #include "SkRecord.h"
 #include "SkRecordDraw.h"
 #include "SkTraceEvent.h"
@@ -16,27 +17,43 @@ SkBigPicture::SkBigPicture(const SkRect& cull,
                            SkRecord* record,
                            SnapshotArray* drawablePicts,
                            SkBBoxHierarchy* bbh,
-                           size_t approxBytesUsedBySubPictures)
+                           size_t approxBytesUsedBySubPictures,
+                           std::unique_ptr<const SkRecordOcclusion> occlusion)
     : fCullRect(cull)
     , fApproxBytesUsedBySubPictures(approxBytesUsedBySubPictures)
     , fRecord(record)               // Take ownership of caller's ref.
     , fDrawablePicts(drawablePicts) // Take ownership.
     , fBBH(bbh)                     // Take ownership of caller's ref.
+    , fOcclusion(std::move(occlusion))
 {}
 
+SkBigPicture::~SkBigPicture() {
+    if (fLayersCached.load(std::memory_order_relaxed)) {
+        SkPictureLayerCache::PostPurgePicture(this->uniqueID());
+    }
+}
+
 void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
     SkASSERT(canvas);
 
     // If the query contains the whole picture, don't bother with the BBH.
     const bool useBBH = !canvas->getLocalClipBounds().contains(this->cullRect());
 
+    uint32_t layerCachePictureID = SK_InvalidUniqueID;
+    if (SkPictureLayerCache::IsEnabled(canvas)) {
+        layerCachePictureID = this->uniqueID();
+        fLayersCached.store(true, std::memory_order_relaxed);
+    }
+
     SkRecordDraw(*fRecord,
                  canvas,
                  this->drawablePicts(),
                  nullptr,
                  this->drawableCount(),
                  useBBH ? fBBH.get() : nullptr,
-                 callback);
+                 callback,
+                 fOcclusion.get(),
+                 layerCachePictureID);
 }
 
 void SkBigPicture::partialPlayback(SkCanvas* canvas,
@@ -58,6 +75,7 @@ int    SkBigPicture::approximateOpCount()   const { return fRecord->count(); }
 size_t SkBigPicture::approximateBytesUsed() const {
     size_t bytes = sizeof(*this) + fRecord->bytesUsed() + fApproxBytesUsedBySubPictures;
     if (fBBH) { bytes += fBBH->bytesUsed(); }
+    if (fOcclusion) { bytes += fOcclusion->bytesUsed(); }
     return bytes;
 }
 
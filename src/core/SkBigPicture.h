@@ -13,9 +13,12 @@
 #include "SkRect.h"
 #include "SkTemplates.h"
 
+#include <atomic>
+
 class SkBBoxHierarchy;
 class SkMatrix;
 class SkRecord;
+class SkRecordOcclusion;
 
 // An implementation of SkPicture supporting an arbitrary number of drawing commands.
 class SkBigPicture final : public SkPicture {
@@ -37,7 +40,9 @@ public:
                  SkRecord*,            // We take ownership of the caller's ref.
                  SnapshotArray*,       // We take exclusive ownership.
                  SkBBoxHierarchy*,     // We take ownership of the caller's ref.
-                 size_t approxBytesUsedBySubPictures);
+                 size_t approxBytesUsedBySubPictures,
+                 std::unique_ptr<const SkRecordOcclusion> = nullptr);
+    ~SkBigPicture() override;
 
 
 // SkPicture overrides
@@ -65,6 +70,10 @@ private:
     sk_sp<const SkRecord>                fRecord;
     std::unique_ptr<const SnapshotArray> fDrawablePicts;
     sk_sp<const SkBBoxHierarchy>         fBBH;
+    // Draws playback skips because later opaque draws cover them, if computed.
+    std::unique_ptr<const SkRecordOcclusion> fOcclusion;
+    // Set once playback has put layers of this picture in SkPictureLayerCache.
+    mutable std::atomic<bool>            fLayersCached{false};
 };
 
 #endif//SkBigPicture_DEFINED
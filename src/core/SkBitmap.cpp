@@ -489,7 +489,7 @@ bool SkBitmap::readPixels(const SkPixmap& dst, int srcX, int srcY) const {
 }
 
 bool SkBitmap::writePixels(const SkPixmap& src, int dstX, int dstY,
-                           SkTransferFunctionBehavior behavior) {
+                           SkTransferFunctionBehavior behavior, SkExecutor* executor) {
     if (!SkImageInfoValidConversion(this->info(), src.info())) {
         return false;
     }
@@ -502,7 +502,7 @@ bool SkBitmap::writePixels(const SkPixmap& src, int dstX, int dstY,
     void* dstPixels = this->getAddr(rec.fX, rec.fY);
     const SkImageInfo dstInfo = this->info().makeWH(rec.fInfo.width(), rec.fInfo.height());
     SkConvertPixels(dstInfo, dstPixels, this->rowBytes(), rec.fInfo, rec.fPixels, rec.fRowBytes,
-                    nullptr, behavior);
+                    nullptr, behavior, executor);
     this->notifyPixelsChanged();
     return true;
 }
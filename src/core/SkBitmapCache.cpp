@@ -170,6 +170,7 @@ public:
         SkAssertResult(this->install(static_cast<SkBitmap*>(payload)));
     }
 
+    bool canBeFoundConcurrently() const override { return true; }
     const char* getCategory() const override { return "bitmap"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fDM.get();
@@ -361,6 +362,7 @@ struct MipMapRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(fKey) + fMipMap->size(); }
+    bool canBeFoundConcurrently() const override { return true; }
     const char* getCategory() const override { return "mipmap"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fMipMap->diagnostic_only_getDiscardable();
@@ -407,8 +409,8 @@ static SkResourceCache::DiscardableFactory get_fact(SkResourceCache* localCache)
 
 const SkMipMap* SkMipMapCache::AddAndRef(const SkBitmap& src,
                                          SkDestinationSurfaceColorMode colorMode,
-                                         SkResourceCache* localCache) {
-    SkMipMap* mipmap = SkMipMap::Build(src, colorMode, get_fact(localCache));
+                                         SkResourceCache* localCache, int maxLevelCount) {
+    SkMipMap* mipmap = SkMipMap::Build(src, colorMode, get_fact(localCache), maxLevelCount);
     if (mipmap) {
         MipMapRec* rec = new MipMapRec(src.getGenerationID(), get_bounds_from_bitmap(src),
                                        colorMode, mipmap);
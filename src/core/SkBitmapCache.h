@@ -66,8 +66,11 @@ public:
     // Note: the scaled width/height in desc must be 0, as any other value would not make sense.
     static const SkMipMap* FindAndRef(const SkBitmapCacheDesc&, SkDestinationSurfaceColorMode,
                                       SkResourceCache* localCache = nullptr);
+    // Builds at most maxLevelCount levels; see SkMipMap::Build(). If the cache already has a
+    // mipmap for src, the new one replaces it.
     static const SkMipMap* AddAndRef(const SkBitmap& src, SkDestinationSurfaceColorMode,
-                                     SkResourceCache* localCache = nullptr);
+                                     SkResourceCache* localCache = nullptr,
+                                     int maxLevelCount = SK_MaxS32);
 };
 
 #endif
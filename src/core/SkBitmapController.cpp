@@ -97,13 +97,29 @@ bool SkDefaultBitmapControllerState::processMediumRequest(const SkBitmapProvider
         ? SkDestinationSurfaceColorMode::kGammaAndColorSpaceAware
         : SkDestinationSurfaceColorMode::kLegacy;
     if (invScaleSize.width() > SK_Scalar1 || invScaleSize.height() > SK_Scalar1) {
+        const SkSize scale = SkSize::Make(SkScalarInvert(invScaleSize.width()),
+                                          SkScalarInvert(invScaleSize.height()));
+
+        // Lazily built mipmaps stop at the level this draw samples. One that stops short of it
+        // is built again.
+        int levelCount = SkMipMap::ComputeLevelCount(provider.width(), provider.height());
+        if (gSkBuildMipMapsLazily) {
+            levelCount = SkTMin(levelCount, SkMipMap::ComputeLevelCountForScale(scale));
+            if (levelCount < 1) {
+                return false;
+            }
+        }
+
         fCurrMip.reset(SkMipMapCache::FindAndRef(provider.makeCacheDesc(), colorMode));
+        if (fCurrMip && fCurrMip->countLevels() < levelCount) {
+            fCurrMip.reset(nullptr);
+        }
         if (nullptr == fCurrMip.get()) {
             SkBitmap orig;
             if (!provider.asBitmap(&orig)) {
                 return false;
             }
-            fCurrMip.reset(SkMipMapCache::AddAndRef(orig, colorMode));
+            fCurrMip.reset(SkMipMapCache::AddAndRef(orig, colorMode, nullptr, levelCount));
             if (nullptr == fCurrMip.get()) {
                 return false;
             }
@@ -111,8 +127,6 @@ bool SkDefaultBitmapControllerState::processMediumRequest(const SkBitmapProvider
         // diagnostic for a crasher...
         SkASSERT_RELEASE(fCurrMip->data());
 
-        const SkSize scale = SkSize::Make(SkScalarInvert(invScaleSize.width()),
-                                          SkScalarInvert(invScaleSize.height()));
         SkMipMap::Level level;
         if (fCurrMip->extractLevel(scale, &level)) {
             const SkSize& invScaleFixup = level.fScale;
@@ -21,6 +21,7 @@
 #include "SkShader.h"
 #include "SkSpecialImage.h"
 #include "SkSurface.h"
+#include "SkTextBlobRasterCache.h"
 #include "SkTLazy.h"
 #include "SkVertices.h"
 
@@ -580,6 +581,17 @@ void SkBitmapDevice::drawPosText(const void* text, size_t len, const SkScalar xp
                 nullptr)
 }
 
+void SkBitmapDevice::drawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
+                                  const SkPaint& paint, SkDrawFilter* drawFilter) {
+    // A draw filter can change the paint run by run, so we leave those to the general version.
+    if (!(fSurfaceProps.flags() & SkSurfaceProps::kCacheTextBlobs_Flag) || drawFilter) {
+        this->INHERITED::drawTextBlob(blob, x, y, paint, drawFilter);
+        return;
+    }
+    SkBitmapDeviceFilteredSurfaceProps props(fBitmap, paint, fSurfaceProps);
+    LOOP_TILER( drawTextBlob(blob, x, y, paint, &props()), nullptr)
+}
+
 void SkBitmapDevice::drawVertices(const SkVertices* vertices, SkBlendMode bmode,
                                   const SkPaint& paint) {
     BDDraw(this).drawVertices(vertices->mode(), vertices->vertexCount(), vertices->positions(),
@@ -655,7 +667,12 @@ void SkBitmapDevice::drawSpecial(SkSpecialImage* src, int x, int y, const SkPain
         SkImageFilter::OutputProperties outputProperties(fBitmap.colorSpace());
         SkImageFilter::Context ctx(matrix, clipBounds, cache.get(), outputProperties);
 
-        filteredImage = filter->filterImage(src, ctx, &offset);
+        SkExecutor* executor = this->imageFilterExecutor();
+        if (executor || (cache && cache->tileSize() > 0)) {
+            filteredImage = filter->filterImageTiled(src, ctx, &offset, executor);
+        } else {
+            filteredImage = filter->filterImage(src, ctx, &offset);
+        }
         if (!filteredImage) {
             return;
         }
@@ -751,7 +768,10 @@ sk_sp<SkSurface> SkBitmapDevice::makeSurface(const SkImageInfo& info, const SkSu
 }
 
 SkImageFilterCache* SkBitmapDevice::getImageFilterCache() {
-    SkImageFilterCache* cache = SkImageFilterCache::Get();
+    SkImageFilterCache* cache =
+            this->surfaceProps().flags() & SkSurfaceProps::kCacheImageFilterTiles_Flag
+                    ? SkImageFilterCache::GetTiled()
+                    : SkImageFilterCache::Get();
     cache->ref();
     return cache;
 }
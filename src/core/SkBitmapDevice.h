@@ -21,6 +21,7 @@
 #include "SkSize.h"
 #include "SkSurfaceProps.h"
 
+class SkExecutor;
 class SkImageFilterCache;
 class SkMatrix;
 class SkPaint;
@@ -115,7 +116,14 @@ protected:
                   const SkPaint&) override;
     void drawPosText(const void* text, size_t len, const SkScalar pos[],
                      int scalarsPerPos, const SkPoint& offset, const SkPaint& paint) override;
+    void drawTextBlob(const SkTextBlob*, SkScalar x, SkScalar y,
+                      const SkPaint& paint, SkDrawFilter* drawFilter) override;
     void drawVertices(const SkVertices*, SkBlendMode, const SkPaint&) override;
+    /**
+     *  Draws the shadows of rects and rrects analytically, and tessellates others.
+     *  Defined in SkShadowUtils.cpp, with SkBaseDevice::drawShadow().
+     */
+    void drawShadow(const SkPath&, const SkDrawShadowRec&) override;
     void drawDevice(SkBaseDevice*, int x, int y, const SkPaint&) override;
 
     ///////////////////////////////////////////////////////////////////////////
@@ -148,6 +156,9 @@ protected:
     virtual void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
                             const SkPaint&);
 
+    // If non-null, image filters are evaluated in tiles, in parallel on this executor.
+    virtual SkExecutor* imageFilterExecutor() const { return nullptr; }
+
 private:
     friend class SkCanvas;
     friend struct DeviceCM; //for setMatrixClip
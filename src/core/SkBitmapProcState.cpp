@@ -27,6 +27,7 @@ extern void Clamp_S32_opaque_D32_nofilter_DX_shaderproc(const void*, int, int, u
 #define   NAME_WRAP(x)  x
 #include "SkBitmapProcState_filter.h"
 #include "SkBitmapProcState_procs.h"
+#include "SkBitmapProcState_shaderproc.h"
 
 SkBitmapProcInfo::SkBitmapProcInfo(const SkBitmapProvider& provider,
                                    SkShader::TileMode tmx, SkShader::TileMode tmy)
@@ -232,6 +233,10 @@ bool SkBitmapProcState::chooseScanlineProcs(bool trivialMatrix, bool clampClamp)
     // see if our platform has any accelerated overrides
     this->platformProcs();
 
+    if (nullptr == fShaderProc32 && fFilterQuality < kHigh_SkFilterQuality) {
+        fShaderProc32 = this->chooseScaleShaderProc32(trivialMatrix);
+    }
+
     return true;
 }
 
@@ -511,6 +516,50 @@ SkBitmapProcState::ShaderProc32 SkBitmapProcState::chooseShaderProc32() {
     return nullptr;
 }
 
+/**
+ *  Scale/translate spans that would map and sample through the portable procs instead run one
+ *  loop specialized on the tile mode, filtering and alpha. Platform sample procs that filter
+ *  several pixels at a time are faster than that loop, so they are kept.
+ */
+SkBitmapProcState::ShaderProc32 SkBitmapProcState::chooseScaleShaderProc32(bool trivialMatrix) {
+    if (fInvType > (SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask) ||
+        fTileModeX != fTileModeY) {
+        return nullptr;
+    }
+    // Unfiltered translates map with the integer tile procs, and don't set up fFilterOne{X|Y}.
+    const bool filter = kNone_SkFilterQuality != fFilterQuality;
+    if (trivialMatrix && !filter) {
+        return nullptr;
+    }
+    if (filter && S32_opaque_D32_filter_DX != fSampleProc32 &&
+                  S32_alpha_D32_filter_DX  != fSampleProc32) {
+        return nullptr;
+    }
+
+    static const ShaderProc32 gClampProcs[] = {
+        S32_D32_scale_shaderproc<SkClampShaderTileProcs, false, false>,
+        S32_D32_scale_shaderproc<SkClampShaderTileProcs, false, true>,
+        S32_D32_scale_shaderproc<SkClampShaderTileProcs, true,  false>,
+        S32_D32_scale_shaderproc<SkClampShaderTileProcs, true,  true>,
+    };
+    static const ShaderProc32 gRepeatProcs[] = {
+        S32_D32_scale_shaderproc<SkRepeatShaderTileProcs, false, false>,
+        S32_D32_scale_shaderproc<SkRepeatShaderTileProcs, false, true>,
+        S32_D32_scale_shaderproc<SkRepeatShaderTileProcs, true,  false>,
+        S32_D32_scale_shaderproc<SkRepeatShaderTileProcs, true,  true>,
+    };
+
+    const int index = (filter ? 2 : 0) | (fAlphaScale < 256 ? 1 : 0);
+    switch (fTileModeX) {
+        case SkShader::kClamp_TileMode:
+            return gClampProcs[index];
+        case SkShader::kRepeat_TileMode:
+            return gRepeatProcs[index];
+        default:
+            return nullptr;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG
@@ -142,6 +142,7 @@ private:
     bool chooseProcs(); // caller must have called init() first (on our base-class)
     bool chooseScanlineProcs(bool trivialMatrix, bool clampClamp);
     ShaderProc32 chooseShaderProc32();
+    ShaderProc32 chooseScaleShaderProc32(bool trivialMatrix);
 
     // Return false if we failed to setup for fast translate (e.g. overflow)
     bool setupForTranslate();
@@ -5,6 +5,8 @@
  * found in the LICENSE file.
  */
 
+#ifndef SkBitmapProcState_filter_DEFINED
+#define SkBitmapProcState_filter_DEFINED
 
 #include "SkColorData.h"
 
@@ -122,3 +124,5 @@ static inline void Filter_32_alpha(unsigned t,
 
     *dstColor = ((lo >> 8) & mask) | (hi & ~mask);
 }
+
+#endif
@@ -5,84 +5,94 @@
  * found in the LICENSE file.
  */
 
+#ifndef SkBitmapProcState_shaderproc_DEFINED
+#define SkBitmapProcState_shaderproc_DEFINED
+
+#include "SkBitmapProcState.h"
+#include "SkBitmapProcState_filter.h"
+#include "SkBitmapProcState_utils.h"
+#include "SkColorData.h"
 #include "SkMathPriv.h"
 
-#define SCALE_FILTER_NAME       MAKENAME(_filter_DX_shaderproc)
+/*
+    Shader procs that map, tile and sample each span of a scale/translate draw in one loop,
+    specialized at compile time on the tile mode, filtering and paint alpha. The matrix and
+    sample procs they replace instead pass the span's coordinates through a buffer, and pick
+    their tiling through a function pointer.
+
+    Each produces the same colors as the portable matrix and sample procs it replaces.
+ */
+
+// Clamp tiles in bitmap coordinates, 16.16 fixed.
+struct SkClampShaderTileProcs {
+    static unsigned Index(SkFixed f, unsigned max) {
+        return SkClampMax(f >> 16, max);
+    }
+    static unsigned Subpixel(SkFixed f, unsigned max) {
+        return (f >> 12) & 0xF;
+    }
+};
 
-// Can't be static in the general case because some of these implementations
-// will be defined and referenced in different object files.
-void SCALE_FILTER_NAME(const void* sIn, int x, int y, SkPMColor* SK_RESTRICT colors, int count);
+// Repeat tiles in unit coordinates, where the fractional 16 bits span the bitmap; see
+// SkBitmapProcInfo::init().
+struct SkRepeatShaderTileProcs {
+    static unsigned Index(SkFixed f, unsigned max) {
+        SkASSERT(max < 65535);
+        return SK_USHIFT16((unsigned)(f & 0xFFFF) * (max + 1));
+    }
+    static unsigned Subpixel(SkFixed f, unsigned max) {
+        return (((unsigned)(f & 0xFFFF) * (max + 1)) >> 12) & 0xF;
+    }
+};
 
-void SCALE_FILTER_NAME(const void* sIn, int x, int y, SkPMColor* SK_RESTRICT colors, int count) {
+template <typename TileProcs, bool kFilter, bool kAlpha>
+void S32_D32_scale_shaderproc(const void* sIn, int x, int y, SkPMColor* SK_RESTRICT colors,
+                              int count) {
     const SkBitmapProcState& s = *static_cast<const SkBitmapProcState*>(sIn);
-    SkASSERT((s.fInvType & ~(SkMatrix::kTranslate_Mask |
-                             SkMatrix::kScale_Mask)) == 0);
-    SkASSERT(s.fInvKy == 0);
+    SkASSERT((s.fInvType & ~(SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask)) == 0);
     SkASSERT(count > 0 && colors != nullptr);
-    SkASSERT(s.fFilterQuality != kNone_SkFilterQuality);
-    SkDEBUGCODE(CHECKSTATE(s);)
+    SkASSERT(kFilter == (kNone_SkFilterQuality != s.fFilterQuality));
+    SkASSERT(kAlpha == (s.fAlphaScale < 256));
 
     const unsigned maxX = s.fPixmap.width() - 1;
     const SkFixed oneX = s.fFilterOneX;
-    const SkFixed dx = s.fInvSx;
-    SkFixed fx;
-    const SRCTYPE* SK_RESTRICT row0;
-    const SRCTYPE* SK_RESTRICT row1;
-    unsigned subY;
+    const SkFractionalInt dx = s.fInvSxFractionalInt;
+    const unsigned alphaScale = s.fAlphaScale;
 
+    SkFractionalInt fx;
+    const SkPMColor* SK_RESTRICT row0;
+    const SkPMColor* SK_RESTRICT row1 = nullptr;
+    unsigned subY = 0;
     {
         const SkBitmapProcStateAutoMapper mapper(s, x, y);
-        SkFixed fy = mapper.fixedY();
+        const SkFixed fy = mapper.fixedY();
         const unsigned maxY = s.fPixmap.height() - 1;
-        // compute our two Y values up front
-        subY = EXTRACT_LOW_BITS(fy, maxY);
-        int y0 = TILEY_PROCF(fy, maxY);
-        int y1 = TILEY_PROCF((fy + s.fFilterOneY), maxY);
-
-        const char* SK_RESTRICT srcAddr = (const char*)s.fPixmap.addr();
-        size_t rb = s.fPixmap.rowBytes();
-        row0 = (const SRCTYPE*)(srcAddr + y0 * rb);
-        row1 = (const SRCTYPE*)(srcAddr + y1 * rb);
-        // now initialize fx
-        fx = mapper.fixedX();
+        row0 = s.fPixmap.addr32(0, TileProcs::Index(fy, maxY));
+        if (kFilter) {
+            subY = TileProcs::Subpixel(fy, maxY);
+            row1 = s.fPixmap.addr32(0, TileProcs::Index(fy + s.fFilterOneY, maxY));
+        }
+        fx = mapper.fractionalIntX();
     }
 
-#ifdef PREAMBLE
-    PREAMBLE(s);
-#endif
-
-    do {
-        unsigned subX = EXTRACT_LOW_BITS(fx, maxX);
-        unsigned x0 = TILEX_PROCF(fx, maxX);
-        unsigned x1 = TILEX_PROCF((fx + oneX), maxX);
-
-        FILTER_PROC(subX, subY,
-                    SRC_TO_FILTER(row0[x0]),
-                    SRC_TO_FILTER(row0[x1]),
-                    SRC_TO_FILTER(row1[x0]),
-                    SRC_TO_FILTER(row1[x1]),
-                    colors);
-        colors += 1;
-
+    for (int i = 0; i < count; ++i) {
+        const SkFixed fixedFx = SkFractionalIntToFixed(fx);
+        const unsigned x0 = TileProcs::Index(fixedFx, maxX);
+        if (kFilter) {
+            const unsigned x1 = TileProcs::Index(fixedFx + oneX, maxX),
+                           subX = TileProcs::Subpixel(fixedFx, maxX);
+            if (kAlpha) {
+                Filter_32_alpha(subX, subY, row0[x0], row0[x1], row1[x0], row1[x1],
+                                colors + i, alphaScale);
+            } else {
+                Filter_32_opaque(subX, subY, row0[x0], row0[x1], row1[x0], row1[x1],
+                                 colors + i);
+            }
+        } else {
+            colors[i] = kAlpha ? SkAlphaMulQ(row0[x0], alphaScale) : row0[x0];
+        }
         fx += dx;
-    } while (--count != 0);
-
-#ifdef POSTAMBLE
-    POSTAMBLE(s);
-#endif
+    }
 }
 
-///////////////////////////////////////////////////////////////////////////////
-
-#undef TILEX_PROCF
-#undef TILEY_PROCF
-#undef EXTRACT_LOW_BITS
-#undef MAKENAME
-#undef SRCTYPE
-#undef CHECKSTATE
-#undef SRC_TO_FILTER
-#undef FILTER_TO_DST
-#undef PREAMBLE
-#undef POSTAMBLE
-
-#undef SCALE_FILTER_NAME
+#endif
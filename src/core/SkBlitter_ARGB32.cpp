@@ -256,6 +256,11 @@ void SkARGB32_Blitter::blitRect(int x, int y, int width, int height) {
     uint32_t    color = fPMColor;
     size_t      rowBytes = fDevice.rowBytes();
 
+    if (255 == SkGetPackedA32(color)) {
+        sk_rect_memset32(device, color, width, rowBytes, height);
+        return;
+    }
+
     while (--height >= 0) {
         SkBlitRow::Color32(device, device, width, color);
         device = (uint32_t*)((char*)device + rowBytes);
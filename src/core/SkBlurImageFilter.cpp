@@ -454,45 +454,19 @@ static sk_sp<SkSpecialImage> copy_image_with_bounds(
                                           dst, &source->props());
 }
 
-// TODO: Implement CPU backend for different fTileMode.
-static sk_sp<SkSpecialImage> cpu_blur(
-        SkVector sigma,
-        SkSpecialImage *source, const sk_sp<SkSpecialImage> &input,
-        SkIRect srcBounds, SkIRect dstBounds) {
-    auto windowW = calculate_window(sigma.x()),
-         windowH = calculate_window(sigma.y());
-
-    if (windowW <= 1 && windowH <= 1) {
-        return copy_image_with_bounds(source, input, srcBounds, dstBounds);
-    }
-
-    SkBitmap inputBM;
-
-    if (!input->getROPixels(&inputBM)) {
-        return nullptr;
-    }
-
-    if (inputBM.colorType() != kN32_SkColorType) {
-        return nullptr;
-    }
-
-    SkBitmap src;
-    inputBM.extractSubset(&src, srcBounds);
-
-    // Make everything relative to the destination bounds.
-    srcBounds.offset(-dstBounds.x(), -dstBounds.y());
-    dstBounds.offset(-dstBounds.x(), -dstBounds.y());
-
+// Blurs src, which covers srcBounds of dstBounds, into dst. dstBounds starts at the origin and
+// contains srcBounds.
+static bool blur_pixels(int windowW, int windowH, const SkBitmap& src,
+                        const SkIRect& srcBounds, const SkIRect& dstBounds, SkBitmap* dst) {
     auto srcW = srcBounds.width(),
          srcH = srcBounds.height(),
          dstW = dstBounds.width(),
          dstH = dstBounds.height();
 
-    SkImageInfo dstInfo = SkImageInfo::Make(dstW, dstH, inputBM.colorType(), inputBM.alphaType());
+    SkImageInfo dstInfo = SkImageInfo::Make(dstW, dstH, src.colorType(), src.alphaType());
 
-    SkBitmap dst;
-    if (!dst.tryAllocPixels(dstInfo)) {
-        return nullptr;
+    if (!dst->tryAllocPixels(dstInfo)) {
+        return false;
     }
 
     auto bufferSizeW = calculate_buffer(windowW),
@@ -520,14 +494,14 @@ static sk_sp<SkSpecialImage> cpu_blur(
     // src and dst left values are the same. If sigma is small resulting in a window size of
     // 1, then border calculations add some pixels which will always be zero. Inset the
     // destination by those zero pixels. This case is very rare.
-    auto intermediateDst = dst.getAddr32(srcBounds.left(), 0);
+    auto intermediateDst = dst->getAddr32(srcBounds.left(), 0);
 
     // The following code is executed very rarely, I have never seen it in a real web
     // page. If sigma is small but not zero then shared GPU/CPU border calculation
     // code adds extra pixels for the border. Just clear everything to clear those pixels.
     // This solution is overkill, but very simple.
     if (windowW == 1 || windowH == 1) {
-        dst.eraseColor(0);
+        dst->eraseColor(0);
     }
 
     if (windowW > 1) {
@@ -537,11 +511,11 @@ static sk_sp<SkSpecialImage> cpu_blur(
         // For the horizontal blur, starts part way down in anticipation of the vertical blur.
         // For a vertical sigma of zero shift should be zero. But, for small sigma,
         // shift may be > 0 but the vertical window could be 1.
-        intermediateSrc = static_cast<uint32_t *>(dst.getPixels())
-                          + (shift > 0 ? shift * dst.rowBytesAsPixels() : 0);
-        intermediateRowBytesAsPixels = dst.rowBytesAsPixels();
+        intermediateSrc = static_cast<uint32_t *>(dst->getPixels())
+                          + (shift > 0 ? shift * dst->rowBytesAsPixels() : 0);
+        intermediateRowBytesAsPixels = dst->rowBytesAsPixels();
         intermediateWidth = dstW;
-        intermediateDst = static_cast<uint32_t *>(dst.getPixels());
+        intermediateDst = static_cast<uint32_t *>(dst->getPixels());
 
         blur_one_direction(
                 buffer, windowW,
@@ -555,7 +529,138 @@ static sk_sp<SkSpecialImage> cpu_blur(
                 buffer, windowH,
                 srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
                 intermediateSrc, intermediateRowBytesAsPixels, 1, intermediateWidth,
-                intermediateDst, dst.rowBytesAsPixels(), 1);
+                intermediateDst, dst->rowBytesAsPixels(), 1);
+    }
+
+    return true;
+}
+
+// The default for gSkRasterBlurDownsampleSigma. Off unless a build turns it on.
+#ifndef SK_RASTER_BLUR_DOWNSAMPLE_SIGMA
+    #define SK_RASTER_BLUR_DOWNSAMPLE_SIGMA 0
+#endif
+
+std::atomic<int> gSkRasterBlurDownsampleSigma{SK_RASTER_BLUR_DOWNSAMPLE_SIGMA};
+
+// Keeps the sums of the downsampling blocks, 255 * 64 * 64, well within 32 bits.
+static constexpr int kMaxDownsampleScale = 64;
+
+static int calculate_scale(SkScalar sigma, int downsampleSigma) {
+    int scale = 1;
+    if (downsampleSigma <= 0) {
+        return scale;
+    }
+    while (sigma >= downsampleSigma * scale && scale < kMaxDownsampleScale) {
+        scale *= 2;
+    }
+    return scale;
+}
+
+// Where each pixel of a row of the upsampled image lies in the row of the small image it is
+// interpolated from. Pixel i of the small image covers scale pixels from smallOrigin + i * scale.
+static void calculate_upsample(int count, int smallOrigin, int scale, int smallCount,
+                               int* srcIdx, uint32_t* weights) {
+    for (int i = 0; i < count; i++) {
+        // Centers of pixels are at half pixels in both images.
+        double u = (i - smallOrigin + 0.5) / scale - 0.5;
+        int idx = SkTPin(static_cast<int>(floor(u)), 0, smallCount - 2);
+        srcIdx[i] = idx;
+        weights[i] = SkTPin(static_cast<int>(round((u - idx) * 256)), 0, 256);
+    }
+}
+
+// Blurs a copy of src, scaled down by scaleX and scaleY, and scales the result back up to dst.
+static bool blur_downsampled(SkVector sigma, int scaleX, int scaleY, const SkBitmap& src,
+                             const SkIRect& srcBounds, const SkIRect& dstBounds, SkBitmap* dst) {
+    auto srcW = srcBounds.width(),
+         srcH = srcBounds.height(),
+         dstW = dstBounds.width(),
+         dstH = dstBounds.height();
+
+    // The small image's pixels are aligned to the src's top left, and it reaches one pixel past
+    // the dst on every side, so that every dst pixel has neighbors to interpolate between.
+    SkIRect smallSrcBounds = SkIRect::MakeWH((srcW + scaleX - 1) / scaleX,
+                                             (srcH + scaleY - 1) / scaleY);
+    const int smallLeft   = -(srcBounds.left() + scaleX - 1) / scaleX - 1,
+              smallTop    = -(srcBounds.top() + scaleY - 1) / scaleY - 1,
+              smallRight  = (dstW - srcBounds.left() + scaleX - 1) / scaleX + 1,
+              smallBottom = (dstH - srcBounds.top() + scaleY - 1) / scaleY + 1;
+    smallSrcBounds.offset(-smallLeft, -smallTop);
+    const SkIRect smallDstBounds = SkIRect::MakeWH(smallRight - smallLeft,
+                                                   smallBottom - smallTop);
+
+    SkBitmap smallSrc;
+    if (!smallSrc.tryAllocPixels(src.info().makeWH(smallSrcBounds.width(),
+                                                   smallSrcBounds.height()))) {
+        return false;
+    }
+    for (int y = 0; y < smallSrc.height(); y++) {
+        SkOpts::blur_downsample_row(src.getAddr32(0, y * scaleY), src.rowBytesAsPixels(), srcW,
+                                    std::min(scaleY, srcH - y * scaleY), scaleX, scaleY,
+                                    smallSrc.getAddr32(0, y), smallSrc.width());
+    }
+
+    SkBitmap smallDst;
+    if (!blur_pixels(calculate_window(sigma.x() / scaleX), calculate_window(sigma.y() / scaleY),
+                     smallSrc, smallSrcBounds, smallDstBounds, &smallDst)) {
+        return false;
+    }
+
+    if (!dst->tryAllocPixels(src.info().makeWH(dstW, dstH))) {
+        return false;
+    }
+    SkAutoTMalloc<int> srcX(dstW), srcY(dstH);
+    SkAutoTMalloc<uint32_t> weightX(dstW), weightY(dstH);
+    calculate_upsample(dstW, srcBounds.left() + smallLeft * scaleX, scaleX, smallDst.width(),
+                       srcX.get(), weightX.get());
+    calculate_upsample(dstH, srcBounds.top() + smallTop * scaleY, scaleY, smallDst.height(),
+                       srcY.get(), weightY.get());
+    for (int y = 0; y < dstH; y++) {
+        SkOpts::blur_upsample_row(smallDst.getAddr32(0, srcY[y]), smallDst.getAddr32(0, srcY[y] + 1),
+                                  weightY[y], srcX.get(), weightX.get(), dst->getAddr32(0, y),
+                                  dstW);
+    }
+    return true;
+}
+
+// TODO: Implement CPU backend for different fTileMode.
+static sk_sp<SkSpecialImage> cpu_blur(
+        SkVector sigma, int downsampleSigma,
+        SkSpecialImage *source, const sk_sp<SkSpecialImage> &input,
+        SkIRect srcBounds, SkIRect dstBounds) {
+    auto windowW = calculate_window(sigma.x()),
+         windowH = calculate_window(sigma.y());
+
+    if (windowW <= 1 && windowH <= 1) {
+        return copy_image_with_bounds(source, input, srcBounds, dstBounds);
+    }
+
+    SkBitmap inputBM;
+
+    if (!input->getROPixels(&inputBM)) {
+        return nullptr;
+    }
+
+    if (inputBM.colorType() != kN32_SkColorType) {
+        return nullptr;
+    }
+
+    SkBitmap src;
+    inputBM.extractSubset(&src, srcBounds);
+
+    // Make everything relative to the destination bounds.
+    srcBounds.offset(-dstBounds.x(), -dstBounds.y());
+    dstBounds.offset(-dstBounds.x(), -dstBounds.y());
+
+    SkBitmap dst;
+    auto scaleX = calculate_scale(sigma.x(), downsampleSigma),
+         scaleY = calculate_scale(sigma.y(), downsampleSigma);
+    if (scaleX > 1 || scaleY > 1) {
+        if (!blur_downsampled(sigma, scaleX, scaleY, src, srcBounds, dstBounds, &dst)) {
+            return nullptr;
+        }
+    } else if (!blur_pixels(windowW, windowH, src, srcBounds, dstBounds, &dst)) {
+        return nullptr;
     }
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(),
@@ -563,6 +668,13 @@ static sk_sp<SkSpecialImage> cpu_blur(
                                           dst, &source->props());
 }
 
+sk_sp<SkSpecialImage> SkRasterBlurForTesting(SkVector sigma, int downsampleSigma,
+                                             const sk_sp<SkSpecialImage>& input,
+                                             const SkIRect& srcBounds, const SkIRect& dstBounds) {
+    SkASSERT(dstBounds.contains(srcBounds));
+    return cpu_blur(sigma, downsampleSigma, input.get(), input, srcBounds, dstBounds);
+}
+
 sk_sp<SkSpecialImage> SkBlurImageFilterImpl::onFilterImage(SkSpecialImage* source,
                                                            const Context& ctx,
                                                            SkIPoint* offset) const {
@@ -609,7 +721,8 @@ sk_sp<SkSpecialImage> SkBlurImageFilterImpl::onFilterImage(SkSpecialImage* sourc
     } else
 #endif
     {
-        result = cpu_blur(sigma, source, input, inputBounds, dstBounds);
+        result = cpu_blur(sigma, gSkRasterBlurDownsampleSigma.load(std::memory_order_relaxed),
+                          source, input, inputBounds, dstBounds);
     }
 
     // Return the resultOffset if the blur succeeded.
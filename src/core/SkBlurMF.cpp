@@ -437,6 +437,10 @@ static SkCachedData* add_cached_rects(SkMask* mask, SkScalar sigma, SkBlurStyle
   static const bool c_analyticBlurRRect{true};
 #endif
 
+// We only keep a whole blurred dimension in the patch if it's small enough that caching it is
+// cheaper than blurring it again.
+static constexpr SkScalar kMaxUnstretchedPatchSize = 256;
+
 SkMaskFilterBase::FilterReturn
 SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& matrix,
                                         const SkIRect& clipBounds,
@@ -448,15 +452,13 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
             return kFalse_FilterReturn;
 
         case SkRRect::kRect_Type:
-            // We should have caught this earlier.
+            // We should have caught this earlier, and we already have code for rectangles.
             SkASSERT(false);
-            // Fall through.
-        case SkRRect::kOval_Type:
-            // The nine patch special case does not handle ovals, and we
-            // already have code for rectangles.
             return kUnimplemented_FilterReturn;
 
-        // These three can take advantage of this fast path.
+        // These four can take advantage of this fast path. Ovals never stretch, so their
+        // patch is the whole blurred oval.
+        case SkRRect::kOval_Type:
         case SkRRect::kSimple_Type:
         case SkRRect::kNinePatch_Type:
         case SkRRect::kComplex_Type:
@@ -507,27 +509,42 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
 
     const SkScalar leftUnstretched = SkTMax(UL.fX, LL.fX) + SkIntToScalar(2 * margin.fX);
     const SkScalar rightUnstretched = SkTMax(UR.fX, LR.fX) + SkIntToScalar(2 * margin.fX);
+    const SkScalar topUnstretched = SkTMax(UL.fY, UR.fY) + SkIntToScalar(2 * margin.fY);
+    const SkScalar bottomUnstretched = SkTMax(LL.fY, LR.fY) + SkIntToScalar(2 * margin.fY);
 
     // Extra space in the middle to ensure an unchanging piece for stretching. Use 3 to cover
     // any fractional space on either side plus 1 for the part to stretch.
     const SkScalar stretchSize = SkIntToScalar(3);
 
     const SkScalar totalSmallWidth = leftUnstretched + rightUnstretched + stretchSize;
-    if (totalSmallWidth >= rrect.rect().width()) {
-        // There is no valid piece to stretch.
-        return kUnimplemented_FilterReturn;
-    }
-
-    const SkScalar topUnstretched = SkTMax(UL.fY, UR.fY) + SkIntToScalar(2 * margin.fY);
-    const SkScalar bottomUnstretched = SkTMax(LL.fY, LR.fY) + SkIntToScalar(2 * margin.fY);
-
     const SkScalar totalSmallHeight = topUnstretched + bottomUnstretched + stretchSize;
-    if (totalSmallHeight >= rrect.rect().height()) {
-        // There is no valid piece to stretch.
+
+    // If there's no piece to stretch in a direction, the small round rectangle keeps the full
+    // size (and the fractional offset) of the original in that direction instead, so the patch
+    // is exactly the blurred original there. Only that size then goes into the cache key, so
+    // rrects that differ just in the other direction, or in where they're drawn, still share it.
+    const bool stretchX = totalSmallWidth < rrect.rect().width();
+    const bool stretchY = totalSmallHeight < rrect.rect().height();
+    if ((!stretchX && rrect.rect().width()  > kMaxUnstretchedPatchSize) ||
+        (!stretchY && rrect.rect().height() > kMaxUnstretchedPatchSize)) {
         return kUnimplemented_FilterReturn;
     }
 
-    SkRect smallR = SkRect::MakeWH(totalSmallWidth, totalSmallHeight);
+    SkRect smallR;
+    if (stretchX) {
+        smallR.fLeft  = 0;
+        smallR.fRight = totalSmallWidth;
+    } else {
+        smallR.fLeft  = rrect.rect().fLeft - SkScalarFloorToScalar(rrect.rect().fLeft);
+        smallR.fRight = smallR.fLeft + rrect.rect().width();
+    }
+    if (stretchY) {
+        smallR.fTop    = 0;
+        smallR.fBottom = totalSmallHeight;
+    } else {
+        smallR.fTop    = rrect.rect().fTop - SkScalarFloorToScalar(rrect.rect().fTop);
+        smallR.fBottom = smallR.fTop + rrect.rect().height();
+    }
 
     SkRRect smallRR;
     SkVector radii[4];
@@ -563,8 +580,12 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
 
     patch->fMask.fBounds.offsetTo(0, 0);
     patch->fOuterRect = dstM.fBounds;
-    patch->fCenter.fX = SkScalarCeilToInt(leftUnstretched) + 1;
-    patch->fCenter.fY = SkScalarCeilToInt(topUnstretched) + 1;
+    patch->fCenter.fX = stretchX ? SkScalarCeilToInt(leftUnstretched) + 1
+                                 : patch->fMask.fBounds.width() / 2;
+    patch->fCenter.fY = stretchY ? SkScalarCeilToInt(topUnstretched) + 1
+                                 : patch->fMask.fBounds.height() / 2;
+    SkASSERT(stretchX || patch->fMask.fBounds.width() == patch->fOuterRect.width());
+    SkASSERT(stretchY || patch->fMask.fBounds.height() == patch->fOuterRect.height());
     SkASSERT(nullptr == patch->fCache);
     patch->fCache = cache;  // transfer ownership to patch
     return kTrue_FilterReturn;
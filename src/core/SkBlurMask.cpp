@@ -9,6 +9,7 @@
 #include "SkBlurMask.h"
 #include "SkColorPriv.h"
 #include "SkMaskBlurFilter.h"
+#include "SkMaskCache.h"
 #include "SkMath.h"
 #include "SkTemplates.h"
 #include "SkEndian.h"
@@ -230,9 +231,42 @@ void SkBlurMask::ComputeBlurProfile(uint8_t* profile, int size, SkScalar sigma)
     }
 }
 
-// TODO MAYBE: Maintain a profile cache to avoid recomputing this for
-// commonly used radii.  Consider baking some of the most common blur radii
-// directly in as static data?
+namespace {
+// The profile for sigma, shared with every other thread blurring with the same sigma through
+// the SkMaskCache.  If the cache can't hold it, we make our own.
+class BlurProfile {
+public:
+    BlurProfile(int size, SkScalar sigma) : fData(SkMaskCache::FindAndRefProfile(sigma)) {
+        if (fData) {
+            SkASSERT(fData->size() == (size_t)size);
+            fProfile = (const uint8_t*)fData->data();
+            return;
+        }
+        fData = SkResourceCache::NewCachedData(size);
+        if (fData) {
+            SkBlurMask::ComputeBlurProfile((uint8_t*)fData->writable_data(), size, sigma);
+            SkMaskCache::AddProfile(sigma, fData);
+            fProfile = (const uint8_t*)fData->data();
+        } else {
+            fStorage.reset(size);
+            SkBlurMask::ComputeBlurProfile(fStorage.get(), size, sigma);
+            fProfile = fStorage.get();
+        }
+    }
+    ~BlurProfile() {
+        if (fData) {
+            fData->unref();
+        }
+    }
+
+    operator const uint8_t*() const { return fProfile; }
+
+private:
+    SkCachedData*          fData;
+    SkAutoTMalloc<uint8_t> fStorage;
+    const uint8_t*         fProfile;
+};
+}  // namespace
 
 // Implementation adapted from Michael Herf's approach:
 // http://stereopsis.com/shadowrect/
@@ -309,9 +343,7 @@ bool SkBlurMask::BlurRect(SkScalar sigma, SkMask *dst,
         return true;
     }
 
-    SkAutoTMalloc<uint8_t> profile(profileSize);
-
-    ComputeBlurProfile(profile, profileSize, sigma);
+    BlurProfile profile(profileSize, sigma);
 
     size_t dstSize = dst->computeImageSize();
     if (0 == dstSize) {
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCOWPixelRef.h"
+
+#if defined(SK_BUILD_FOR_UNIX) && defined(__linux__)
+    #include <sys/syscall.h>
+    #if defined(SYS_memfd_create)
+        #define SK_COW_PIXELS_MEMFD
+    #endif
+#endif
+
+#if defined(SK_COW_PIXELS_MEMFD)
+
+#include "SkTemplates.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MFD_CLOEXEC
+    #define MFD_CLOEXEC 0x0001U
+#endif
+
+namespace {
+
+// An anonymous shared memory file, mapped by the pixel ref that made it, and privately by its
+// copies.
+class Backing : public SkNVRefCnt<Backing> {
+public:
+    static sk_sp<Backing> Make(size_t size) {
+        int fd = (int)syscall(SYS_memfd_create, "skia-pixels", MFD_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        if (ftruncate(fd, size) != 0) {
+            close(fd);
+            return nullptr;
+        }
+        return sk_sp<Backing>(new Backing(fd, size));
+    }
+
+    ~Backing() { close(fFD); }
+
+    // Only the pixel ref that made the file maps it shared, so the file changes only through it.
+    void* map(bool shared) const {
+        void* addr = mmap(nullptr, fSize, PROT_READ | PROT_WRITE,
+                          shared ? MAP_SHARED : MAP_PRIVATE, fFD, 0);
+        return addr == MAP_FAILED ? nullptr : addr;
+    }
+
+    size_t size() const { return fSize; }
+
+private:
+    Backing(int fd, size_t size) : fFD(fd), fSize(size) {}
+
+    int    fFD;
+    size_t fSize;
+};
+
+class COWPixelRef final : public SkPixelRef {
+public:
+    COWPixelRef(int width, int height, void* addr, size_t rowBytes, sk_sp<Backing> backing,
+                bool shared)
+        : SkPixelRef(width, height, addr, rowBytes)
+        , fBacking(std::move(backing))
+        , fShared(shared) {}
+
+    ~COWPixelRef() override { munmap(this->pixels(), fBacking->size()); }
+
+    const sk_sp<Backing>& backing() const { return fBacking; }
+    bool isShared() const { return fShared; }
+
+private:
+    sk_sp<Backing> fBacking;
+    bool           fShared;    // If false, this maps fBacking privately.
+};
+
+}  // namespace
+
+static size_t page_size() {
+    static const size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+static sk_sp<SkPixelRef> make_shared(int width, int height, size_t rowBytes, size_t bytes) {
+    const size_t page = page_size();
+    sk_sp<Backing> backing = Backing::Make((bytes + page - 1) / page * page);
+    if (!backing) {
+        return nullptr;
+    }
+    void* addr = backing->map(true);
+    if (!addr) {
+        return nullptr;
+    }
+    return sk_make_sp<COWPixelRef>(width, height, addr, rowBytes, std::move(backing), true);
+}
+
+sk_sp<SkPixelRef> SkCOWPixelRef::MakeZeroed(const SkImageInfo& info, size_t rowBytes) {
+    if (rowBytes == 0) {
+        rowBytes = info.minRowBytes();
+    }
+    if (info.isEmpty() || !info.validRowBytes(rowBytes)) {
+        return nullptr;
+    }
+    size_t bytes = info.computeByteSize(rowBytes);
+    if (SkImageInfo::ByteSizeOverflowed(bytes)) {
+        return nullptr;
+    }
+    // A new file reads as zeros.
+    return make_shared(info.width(), info.height(), rowBytes, bytes);
+}
+
+// Sets dirty[i] if src's page i is its own, rather than the page of the file it maps.
+// Returns how many are, or -1 if we can't tell.
+static int find_dirty_pages(const void* src, int pages, bool dirty[]) {
+    int fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    SkAutoTMalloc<uint64_t> entries(pages);
+    const size_t bytes = pages * sizeof(uint64_t);
+    const off_t offset = (off_t)((uintptr_t)src / page_size() * sizeof(uint64_t));
+    ssize_t read = pread(fd, entries.get(), bytes, offset);
+    close(fd);
+    if (read != (ssize_t)bytes) {
+        return -1;
+    }
+
+    // Pages we've written are anonymous: either present and not file pages, or swapped out.
+    const uint64_t kPresent = 1ULL << 63,
+                   kSwapped = 1ULL << 62,
+                   kFile    = 1ULL << 61;
+    int count = 0;
+    for (int i = 0; i < pages; i++) {
+        uint64_t e = entries[i];
+        dirty[i] = (e & kSwapped) || ((e & kPresent) && !(e & kFile));
+        count += dirty[i];
+    }
+    return count;
+}
+
+sk_sp<SkPixelRef> SkCOWPixelRef::MakeCopy(SkPixelRef* src) {
+    auto pr = static_cast<COWPixelRef*>(src);
+    const sk_sp<Backing>& backing = pr->backing();
+    const size_t size = backing->size();
+    const int pages = SkToInt(size / page_size());
+
+    // A copy of a shared mapping is free: it starts out reading the same file.
+    // A copy of a private mapping also has to copy the pages that mapping wrote.
+    SkAutoTMalloc<bool> dirty;
+    if (!pr->isShared()) {
+        dirty.reset(pages);
+        int count = find_dirty_pages(pr->pixels(), pages, dirty.get());
+        // If most pages have been written, start a new file, so the copies after this are cheap.
+        if (count < 0 || count > pages / 2) {
+            sk_sp<SkPixelRef> copy = make_shared(pr->width(), pr->height(), pr->rowBytes(), size);
+            if (copy) {
+                memcpy(copy->pixels(), pr->pixels(), size);
+            }
+            return copy;
+        }
+    }
+
+    char* addr = (char*)backing->map(false);
+    if (!addr) {
+        return nullptr;
+    }
+    if (dirty) {
+        const char* srcAddr = (const char*)pr->pixels();
+        for (int i = 0; i < pages; i++) {
+            if (dirty[i]) {
+                memcpy(addr + i * page_size(), srcAddr + i * page_size(), page_size());
+            }
+        }
+    }
+    return sk_make_sp<COWPixelRef>(pr->width(), pr->height(), addr, pr->rowBytes(), backing,
+                                   false);
+}
+
+#else
+
+sk_sp<SkPixelRef> SkCOWPixelRef::MakeZeroed(const SkImageInfo&, size_t) { return nullptr; }
+sk_sp<SkPixelRef> SkCOWPixelRef::MakeCopy(SkPixelRef*) { return nullptr; }
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCOWPixelRef_DEFINED
+#define SkCOWPixelRef_DEFINED
+
+#include "SkImageInfo.h"
+#include "SkPixelRef.h"
+
+/**
+ *  Pixel refs whose copies share memory with the original, page by page, until the copy writes
+ *  to a page.  SkSurface_Raster uses these for big surfaces made with
+ *  SkSurfaceProps::kCopyOnWritePixels_Flag, so that drawing after a snapshot copies only the
+ *  pages the drawing touches, not the whole surface.
+ *
+ *  The pixels live in an anonymous shared memory file.  A copy maps the file privately, so the
+ *  kernel copies a page the first time the copy writes it.  Copies of copies map the same file,
+ *  and copy the pages their source wrote themselves.
+ *
+ *  Unlike malloc'd pixels, the original's pixels are shared with any child process forked while
+ *  it's alive.
+ *
+ *  Only available on Linux.  Elsewhere, MakeZeroed() returns nullptr.
+ */
+namespace SkCOWPixelRef {
+    /**
+     *  Returns a pixel ref of zeroed pixels, or nullptr if they can't be allocated this way.
+     *  If rowBytes is 0, uses info.minRowBytes().
+     */
+    sk_sp<SkPixelRef> MakeZeroed(const SkImageInfo& info, size_t rowBytes);
+
+    /**
+     *  Returns a pixel ref with a copy of src's pixels, or nullptr on failure.  src must come
+     *  from MakeZeroed() or MakeCopy(), and must not change while it shares pages with the copy,
+     *  i.e. for the rest of its life.
+     */
+    sk_sp<SkPixelRef> MakeCopy(SkPixelRef* src);
+}
+
+#endif
@@ -15,6 +15,7 @@
 #include "SkDrawable.h"
 #include "SkDrawFilter.h"
 #include "SkDrawLooper.h"
+#include "SkDrawShadowInfo.h"
 #include "SkImage.h"
 #include "SkImage_Base.h"
 #include "SkImageFilter.h"
@@ -36,6 +37,7 @@
 #include "SkSpecialImage.h"
 #include "SkString.h"
 #include "SkSurface_Base.h"
+#include "SkTDArray.h"
 #include "SkTextBlob.h"
 #include "SkTextFormatParams.h"
 #include "SkTLazy.h"
@@ -169,6 +171,46 @@ void SkCanvas::predrawNotify(const SkRect* rect, const SkPaint* paint,
     }
 }
 
+void SkCanvas::damageNotify(const SkRect* bounds, const SkPaint* paint) {
+    if (!fSurfaceBase || !fSurfaceBase->isTrackingDamage()) {
+        return;
+    }
+    // Drawing into a layer changes the surface only as the layer is drawn back.
+    if (this->getTopDevice() != this->getDevice()) {
+        return;
+    }
+    SkIRect damage = this->getDeviceClipBounds();
+    if (bounds && (!paint || paint->canComputeFastBounds())) {
+        SkRect storage, devBounds;
+        this->getTotalMatrix().mapRect(&devBounds,
+                                       paint ? paint->computeFastBounds(*bounds, &storage)
+                                             : *bounds);
+        // Leave room for anti-aliasing.
+        if (!damage.intersect(devBounds.roundOut().makeOutset(1, 1))) {
+            return;
+        }
+    }
+    fSurfaceBase->addDamage(damage);
+}
+
+void SkCanvas::damageNotifyDevice(const SkIRect& deviceBounds, const SkPaint* paint) {
+    if (!fSurfaceBase || !fSurfaceBase->isTrackingDamage()) {
+        return;
+    }
+    if (this->getTopDevice() != this->getDevice()) {
+        return;
+    }
+    SkIRect damage = this->getDeviceClipBounds();
+    // An image filter was applied with the layer's matrix, and a looper may draw the layer
+    // elsewhere, so either may reach anywhere in the clip.
+    if (!paint || (!paint->getImageFilter() && !paint->getLooper())) {
+        if (!damage.intersect(deviceBounds)) {
+            return;
+        }
+    }
+    fSurfaceBase->addDamage(damage);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /*  This is the record we keep for each SkBaseDevice that the user installs.
@@ -227,6 +269,16 @@ public:
     SkMatrix            fMatrix;
     int                 fDeferredSaveCount;
 
+    /*  Save levels on top of this one that have changed only the matrix. Rather than copy all
+        of this MCRec for one, we remember the matrix it started with, and put that back on
+        restore.
+    */
+    struct MatrixRec {
+        SkMatrix    fMatrix;
+        int         fDeferredSaveCount;
+    };
+    SkTDArray<MatrixRec> fMatrixRecs;
+
     MCRec() {
         fFilter     = nullptr;
         fLayer      = nullptr;
@@ -255,11 +307,22 @@ public:
     void reset(const SkIRect& bounds) {
         SkASSERT(fLayer);
         SkASSERT(fDeferredSaveCount == 0);
+        SkASSERT(fMatrixRecs.isEmpty());
 
         fMatrix.reset();
         fRasterClip.setRect(bounds);
         fLayer->reset(bounds);
     }
+
+    // Returns the top save level's MatrixRec, or null if that level is this MCRec itself.
+    MatrixRec* topMatrixRec() {
+        return fMatrixRecs.isEmpty() ? nullptr : &fMatrixRecs.top();
+    }
+
+    int& topDeferredSaveCount() {
+        MatrixRec* rec = this->topMatrixRec();
+        return rec ? rec->fDeferredSaveCount : fDeferredSaveCount;
+    }
 };
 
 class SkDrawIter {
@@ -507,6 +570,7 @@ bool AutoDrawLooper::doNext(SkDrawFilter::Type drawType) {
 
 #define LOOPER_BEGIN_DRAWBITMAP(paint, skipLayerForFilter, bounds)  \
     this->predrawNotify();                                          \
+    this->damageNotify(bounds, &paint);                             \
     AutoDrawLooper looper(this, paint, skipLayerForFilter, bounds); \
     while (looper.next(SkDrawFilter::kBitmap_Type)) {               \
         SkDrawIter iter(this);
@@ -520,12 +584,14 @@ bool AutoDrawLooper::doNext(SkDrawFilter::Type drawType) {
 
 #define LOOPER_BEGIN(paint, type, bounds)                           \
     this->predrawNotify();                                          \
+    this->damageNotify(bounds, &paint);                             \
     AutoDrawLooper  looper(this, paint, false, bounds);             \
     while (looper.next(type)) {                                     \
         SkDrawIter          iter(this);
 
 #define LOOPER_BEGIN_CHECK_COMPLETE_OVERWRITE(paint, type, bounds, auxOpaque)  \
     this->predrawNotify(bounds, &paint, auxOpaque);                 \
+    this->damageNotify(bounds, &paint);                             \
     AutoDrawLooper  looper(this, paint, false, bounds);             \
     while (looper.next(type)) {                                     \
         SkDrawIter          iter(this);
@@ -783,6 +849,9 @@ bool SkCanvas::writePixels(const SkImageInfo& srcInfo, const void* pixels, size_
     const bool completeOverwrite =
             srcRect.size() == SkISize::Make(device->width(), device->height());
     this->predrawNotify(completeOverwrite);
+    if (fSurfaceBase) {
+        fSurfaceBase->addDamage(srcRect);
+    }
 
     // This can still fail, most notably in the case of a invalid color type or alpha type
     // conversion.  We could pull those checks into this function and avoid the unnecessary
@@ -793,9 +862,24 @@ bool SkCanvas::writePixels(const SkImageInfo& srcInfo, const void* pixels, size_
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Call before changing the clip or filter: the top save level needs an MCRec of its own.
 void SkCanvas::checkForDeferredSave() {
-    if (fMCRec->fDeferredSaveCount > 0) {
+    if (fMCRec->topDeferredSaveCount() > 0) {
         this->doSave();
+    } else if (const MCRec::MatrixRec* rec = fMCRec->topMatrixRec()) {
+        // Trade the top MatrixRec for an MCRec, giving the level below back its matrix.
+        MCRec* below = fMCRec;
+        SkMatrix matrix = rec->fMatrix;
+        below->fMatrixRecs.pop();
+        this->internalSave();
+        below->fMatrix = matrix;
+    }
+}
+
+// Call before changing only the matrix: the top save level needs at least a MatrixRec.
+void SkCanvas::checkForDeferredMatrixSave() {
+    if (fMCRec->topDeferredSaveCount() > 0) {
+        this->doMatrixSave();
     }
 }
 
@@ -809,6 +893,9 @@ int SkCanvas::getSaveCount() const {
             break;
         }
         count += 1 + rec->fDeferredSaveCount;
+        for (const MCRec::MatrixRec& matrixRec : rec->fMatrixRecs) {
+            count += 1 + matrixRec.fDeferredSaveCount;
+        }
     }
     SkASSERT(count == fSaveCount);
 #endif
@@ -817,23 +904,40 @@ int SkCanvas::getSaveCount() const {
 
 int SkCanvas::save() {
     fSaveCount += 1;
-    fMCRec->fDeferredSaveCount += 1;
+    fMCRec->topDeferredSaveCount() += 1;
     return this->getSaveCount() - 1;  // return our prev value
 }
 
 void SkCanvas::doSave() {
     this->willSave();
 
-    SkASSERT(fMCRec->fDeferredSaveCount > 0);
-    fMCRec->fDeferredSaveCount -= 1;
+    SkASSERT(fMCRec->topDeferredSaveCount() > 0);
+    fMCRec->topDeferredSaveCount() -= 1;
     this->internalSave();
 }
 
+void SkCanvas::doMatrixSave() {
+    this->willSave();
+
+    SkASSERT(fMCRec->topDeferredSaveCount() > 0);
+    fMCRec->topDeferredSaveCount() -= 1;
+    MCRec::MatrixRec* rec = fMCRec->fMatrixRecs.push();
+    rec->fMatrix = fMCRec->fMatrix;
+    rec->fDeferredSaveCount = 0;
+}
+
 void SkCanvas::restore() {
-    if (fMCRec->fDeferredSaveCount > 0) {
+    int& deferredSaveCount = fMCRec->topDeferredSaveCount();
+    if (deferredSaveCount > 0) {
+        SkASSERT(fSaveCount > 1);
+        fSaveCount -= 1;
+        deferredSaveCount -= 1;
+    } else if (fMCRec->topMatrixRec()) {
+        this->willRestore();
         SkASSERT(fSaveCount > 1);
         fSaveCount -= 1;
-        fMCRec->fDeferredSaveCount -= 1;
+        this->internalRestoreMatrix();
+        this->didRestore();
     } else {
         // check for underflow
         if (fMCStack.count() > 1) {
@@ -1101,8 +1205,16 @@ int SkCanvas::saveLayerAlpha(const SkRect* bounds, U8CPU alpha) {
     }
 }
 
+void SkCanvas::internalRestoreMatrix() {
+    const MCRec::MatrixRec* rec = fMCRec->topMatrixRec();
+    SkASSERT(rec);
+    this->internalSetMatrix(rec->fMatrix);
+    fMCRec->fMatrixRecs.pop();
+}
+
 void SkCanvas::internalRestore() {
     SkASSERT(fMCStack.count() != 0);
+    SkASSERT(fMCRec->fMatrixRecs.isEmpty());
 
     // reserve our layer (if any)
     DeviceCM* layer = fMCRec->fLayer;   // may be null
@@ -1227,6 +1339,7 @@ void SkCanvas::internalDrawDevice(SkBaseDevice* srcDev, int x, int y, const SkPa
         paint = &tmp;
     }
 
+    this->damageNotifyDevice(SkIRect::MakeXYWH(x, y, srcDev->width(), srcDev->height()), paint);
     LOOPER_BEGIN_DRAWDEVICE(*paint, SkDrawFilter::kBitmap_Type)
 
     while (iter.next()) {
@@ -1252,7 +1365,7 @@ void SkCanvas::internalDrawDevice(SkBaseDevice* srcDev, int x, int y, const SkPa
 
 void SkCanvas::translate(SkScalar dx, SkScalar dy) {
     if (dx || dy) {
-        this->checkForDeferredSave();
+        this->checkForDeferredMatrixSave();
         fMCRec->fMatrix.preTranslate(dx,dy);
 
         // Translate shouldn't affect the is-scale-translateness of the matrix.
@@ -1293,7 +1406,7 @@ void SkCanvas::concat(const SkMatrix& matrix) {
         return;
     }
 
-    this->checkForDeferredSave();
+    this->checkForDeferredMatrixSave();
     fMCRec->fMatrix.preConcat(matrix);
     fIsScaleTranslate = fMCRec->fMatrix.isScaleTranslate();
 
@@ -1310,7 +1423,7 @@ void SkCanvas::internalSetMatrix(const SkMatrix& matrix) {
 }
 
 void SkCanvas::setMatrix(const SkMatrix& matrix) {
-    this->checkForDeferredSave();
+    this->checkForDeferredMatrixSave();
     this->internalSetMatrix(matrix);
     this->didSetMatrix(matrix);
 }
@@ -1895,9 +2008,14 @@ void SkCanvas::private_draw_shadow_rec(const SkPath& path, const SkDrawShadowRec
 
 void SkCanvas::onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
     SkPaint paint;
-    const SkRect& pathBounds = path.getBounds();
+    SkRect shadowBounds;
+    const SkRect* bounds = nullptr;
+    if (!this->getTotalMatrix().hasPerspective()) {
+        SkDrawShadowMetrics::GetLocalBounds(path, rec, this->getTotalMatrix(), &shadowBounds);
+        bounds = &shadowBounds;
+    }
 
-    LOOPER_BEGIN(paint, SkDrawFilter::kPath_Type, &pathBounds)
+    LOOPER_BEGIN(paint, SkDrawFilter::kPath_Type, bounds)
     while (iter.next()) {
         iter.fDevice->drawShadow(path, rec);
     }
@@ -1911,6 +2029,7 @@ void SkCanvas::onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
 void SkCanvas::onDiscard() {
     if (fSurfaceBase) {
         fSurfaceBase->aboutToDraw(SkSurface::kDiscard_ContentChangeMode);
+        fSurfaceBase->addDamage(SkIRect::MakeWH(fSurfaceBase->width(), fSurfaceBase->height()));
     }
 }
 
@@ -1947,9 +2066,12 @@ void SkCanvas::onDrawPoints(PointMode mode, size_t count, const SkPoint pts[],
             return;
         }
         SkRect storage;
-        if (this->quickReject(paint.computeFastStrokeBounds(r, &storage))) {
+        const SkRect& strokeBounds = paint.computeFastStrokeBounds(r, &storage);
+        if (this->quickReject(strokeBounds)) {
             return;
         }
+        // Points are stroked whatever the paint's style.
+        r = strokeBounds;
         bounds = &r;
     }
 
@@ -1991,6 +2113,7 @@ void SkCanvas::onDrawRect(const SkRect& r, const SkPaint& paint) {
         LOOPER_END
     } else {
         this->predrawNotify(&r, &paint, false);
+        this->damageNotify(&r, &paint);
         SkDrawIter iter(this);
         while (iter.next()) {
             iter.fDevice->drawRect(r, paint);
@@ -2119,7 +2242,9 @@ void SkCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
         }
     }
 
-    LOOPER_BEGIN(paint, SkDrawFilter::kPath_Type, &pathBounds)
+    // Inverse fills draw outside their bounds.
+    const SkRect* bounds = path.isInverseFillType() ? nullptr : &pathBounds;
+    LOOPER_BEGIN(paint, SkDrawFilter::kPath_Type, bounds)
 
     while (iter.next()) {
         iter.fDevice->drawPath(path, looper.paint());
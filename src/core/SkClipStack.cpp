@@ -42,6 +42,7 @@ SkClipStack::Element::Element(const Element& that) {
     fFiniteBoundType = that.fFiniteBoundType;
     fFiniteBound = that.fFiniteBound;
     fIsIntersectionOfRects = that.fIsIntersectionOfRects;
+    fIsSingleRRect = that.fIsSingleRRect;
     fGenID = that.fGenID;
 }
 
@@ -149,6 +150,7 @@ void SkClipStack::Element::initCommon(int saveCount, SkClipOp op, bool doAA) {
     fFiniteBoundType = kInsideOut_BoundsType;
     fFiniteBound.setEmpty();
     fIsIntersectionOfRects = false;
+    fIsSingleRRect = false;
     fGenID = kInvalidGenID;
 }
 
@@ -503,6 +505,16 @@ void SkClipStack::Element::updateBoundAndGenID(const Element* prior) {
             break;
     }
 
+    fIsSingleRRect = false;
+    if (DeviceSpaceType::kRect == fDeviceSpaceType ||
+        DeviceSpaceType::kRRect == fDeviceSpaceType) {
+        if (kReplace_SkClipOp == fOp || (kIntersect_SkClipOp == fOp && nullptr == prior) ||
+            (kIntersect_SkClipOp == fOp && prior->fIsSingleRRect &&
+             prior->contains(fDeviceSpaceRRect))) {
+            fIsSingleRRect = true;
+        }
+    }
+
     if (!fDoAA) {
         fFiniteBound.set(SkScalarRoundToScalar(fFiniteBound.fLeft),
                          SkScalarRoundToScalar(fFiniteBound.fTop),
@@ -785,6 +797,24 @@ void SkClipStack::pushElement(const Element& element) {
     SkDeque::Iter iter(fDeque, SkDeque::Iter::kBack_IterStart);
     Element* prior = (Element*) iter.prev();
 
+    if (prior && kIntersect_SkClipOp == element.getOp() &&
+        kNormal_BoundsType == prior->fFiniteBoundType && !element.isInverseFilled()) {
+        // If the new shape contains everything the clip lets through, intersecting with it is a
+        // no-op. A non-AA shape is snapped to pixels, so it only counts if the bound is too.
+        const SkRect& bound = prior->fFiniteBound;
+        bool exact = element.isAA() ||
+                     (SkScalarIsInt(bound.fLeft) && SkScalarIsInt(bound.fTop) &&
+                      SkScalarIsInt(bound.fRight) && SkScalarIsInt(bound.fBottom));
+        if (exact && !bound.isEmpty() && element.contains(bound)) {
+            return;
+        }
+        // The same goes for re-clipping to the rrect the clip already is, with the same AA.
+        if (prior->fIsSingleRRect && element.isAA() == prior->isAA() &&
+            element.contains(prior->asDeviceSpaceRRect())) {
+            return;
+        }
+    }
+
     if (prior) {
         if (prior->canBeIntersectedInPlace(fSaveCount, element.getOp())) {
             switch (prior->fDeviceSpaceType) {
@@ -966,10 +996,23 @@ bool SkClipStack::isRRect(const SkRect& bounds, SkRRect* rrect, bool* aa) const
     // We limit to 5 elements. This means the back element will be bounds checked at most 4 times if
     // it is an rrect.
     int cnt = fDeque.count();
-    if (!cnt || cnt > 5) {
+    if (!cnt) {
         return false;
     }
     const Element* back = static_cast<const Element*>(fDeque.back());
+    if (back->fIsSingleRRect) {
+        // The elements below are already known not to cut into this one, however deep they go.
+        if (back->getOp() == kIntersect_SkClipOp &&
+            !SkRect::Intersects(bounds, back->asDeviceSpaceRRect().rect())) {
+            return false;
+        }
+        *rrect = back->asDeviceSpaceRRect();
+        *aa = back->isAA();
+        return true;
+    }
+    if (cnt > 5) {
+        return false;
+    }
     if (back->getDeviceSpaceType() != SkClipStack::Element::DeviceSpaceType::kRect &&
         back->getDeviceSpaceType() != SkClipStack::Element::DeviceSpaceType::kRRect) {
         return false;
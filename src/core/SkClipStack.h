@@ -214,6 +214,11 @@ public:
         // equivalent to a single rect intersection? IIOW, is the clip effectively a rectangle.
         bool fIsIntersectionOfRects;
 
+        // When element is applied to the previous elements in the stack is the result known to be
+        // equivalent to intersecting with just this element's rect or rrect? This is what lets
+        // isRRect() answer without walking the stack.
+        bool fIsSingleRRect;
+
         uint32_t fGenID;
 #if SK_SUPPORT_GPU
         mutable SkTArray<std::unique_ptr<GrUniqueKeyInvalidatedMessage>> fMessages;
@@ -499,7 +504,9 @@ private:
     bool internalQuickContains(const SkRRect& devRRect) const;
 
     /**
-     * Helper for clipDevPath, etc.
+     * Helper for clipDevPath, etc. Intersections that can't shrink the clip are dropped, so deep
+     * hierarchies that re-clip to the same (or a larger) rect at every level don't grow the
+     * stack, and keep the gen ID of the clip they're already in.
      */
     void pushElement(const Element& element);
 
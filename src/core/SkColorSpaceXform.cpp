@@ -597,6 +597,19 @@ std::unique_ptr<SkColorSpaceXform> SlowIdentityXform(SkColorSpace_XYZ* space) {
     return std::move(xform);
 }
 
+bool SkColorSpaceXform::applyRows(ColorFormat dstFormat, void* dst, size_t dstRowBytes,
+                                  ColorFormat srcFormat, const void* src, size_t srcRowBytes,
+                                  int count, int rows, SkAlphaType alphaType) const {
+    for (int y = 0; y < rows; y++) {
+        if (!this->apply(dstFormat, dst, srcFormat, src, count, alphaType)) {
+            return false;
+        }
+        dst = SkTAddOffset<void>(dst, dstRowBytes);
+        src = SkTAddOffset<const void>(src, srcRowBytes);
+    }
+    return true;
+}
+
 bool SkColorSpaceXform::Apply(SkColorSpace* dstCS, ColorFormat dstFormat, void* dst,
                               SkColorSpace* srcCS, ColorFormat srcFormat, const void* src,
                               int len, AlphaOp op) {
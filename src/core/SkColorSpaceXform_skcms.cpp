@@ -7,32 +7,36 @@
 
 #include "SkColorSpaceXform.h"
 #include "SkData.h"
+#include "SkLRUCache.h"
 #include "SkMakeUnique.h"
+#include "SkMutex.h"
+#include "SkOpts.h"
 #include "skcms.h"
 
+// A src and dst profile, parsed and optimized for speed. Parsed profiles point into their color
+// spaces' ICC data, so the color spaces are kept alive with them.
+struct SkcmsProfiles : public SkNVRefCnt<SkcmsProfiles> {
+    sk_sp<SkColorSpace> fSrcSpace;
+    sk_sp<SkColorSpace> fDstSpace;
+    skcms_ICCProfile    fSrc;
+    skcms_ICCProfile    fDst;
+};
+
 class SkColorSpaceXform_skcms : public SkColorSpaceXform {
 public:
-    SkColorSpaceXform_skcms(const skcms_ICCProfile& srcProfile,
-                            const skcms_ICCProfile& dstProfile,
-                            skcms_AlphaFormat premulFormat)
-        : fSrcProfile(srcProfile)
-        , fDstProfile(dstProfile)
-        , fPremulFormat(premulFormat) {
-    #ifndef SK_DONT_OPTIMIZE_SRC_PROFILES_FOR_SPEED
-        skcms_OptimizeForSpeed(&fSrcProfile);
-    #endif
-    #ifndef SK_DONT_OPTIMIZE_DST_PROFILES_FOR_SPEED
-        // (This doesn't do anything yet, but we'd sure like it to.)
-        skcms_OptimizeForSpeed(&fDstProfile);
-    #endif
-    }
+    SkColorSpaceXform_skcms(sk_sp<const SkcmsProfiles> profiles, skcms_AlphaFormat premulFormat)
+        : fProfiles(std::move(profiles))
+        , fPremulFormat(premulFormat) {}
 
     bool apply(ColorFormat, void*, ColorFormat, const void*, int, SkAlphaType) const override;
+    bool applyRows(ColorFormat, void*, size_t, ColorFormat, const void*, size_t, int, int,
+                   SkAlphaType) const override;
 
 private:
-    skcms_ICCProfile  fSrcProfile;
-    skcms_ICCProfile  fDstProfile;
-    skcms_AlphaFormat fPremulFormat;
+    sk_sp<const SkcmsProfiles> fProfiles;
+    skcms_AlphaFormat          fPremulFormat;
+
+    typedef SkColorSpaceXform INHERITED;
 };
 
 static skcms_PixelFormat get_skcms_format(SkColorSpaceXform::ColorFormat fmt) {
@@ -57,6 +61,19 @@ static skcms_PixelFormat get_skcms_format(SkColorSpaceXform::ColorFormat fmt) {
     }
 }
 
+static size_t bytes_per_pixel(SkColorSpaceXform::ColorFormat fmt) {
+    switch (fmt) {
+        case SkColorSpaceXform::kRGBA_8888_ColorFormat:
+        case SkColorSpaceXform::kBGRA_8888_ColorFormat:   return 4;
+        case SkColorSpaceXform::kRGB_U16_BE_ColorFormat:  return 6;
+        case SkColorSpaceXform::kRGBA_U16_BE_ColorFormat: return 8;
+        case SkColorSpaceXform::kRGBA_F16_ColorFormat:    return 8;
+        case SkColorSpaceXform::kRGBA_F32_ColorFormat:    return 16;
+        case SkColorSpaceXform::kBGR_565_ColorFormat:     return 2;
+    }
+    return 0;
+}
+
 bool SkColorSpaceXform_skcms::apply(ColorFormat dstFormat, void* dst,
                                     ColorFormat srcFormat, const void* src,
                                     int count, SkAlphaType alphaType) const {
@@ -64,8 +81,28 @@ bool SkColorSpaceXform_skcms::apply(ColorFormat dstFormat, void* dst,
     skcms_AlphaFormat dstAlpha = kPremul_SkAlphaType == alphaType ? fPremulFormat
                                                                   : skcms_AlphaFormat_Unpremul;
 
-    return skcms_Transform(src, get_skcms_format(srcFormat), srcAlpha, &fSrcProfile,
-                           dst, get_skcms_format(dstFormat), dstAlpha, &fDstProfile, count);
+    return skcms_Transform(src, get_skcms_format(srcFormat), srcAlpha, &fProfiles->fSrc,
+                           dst, get_skcms_format(dstFormat), dstAlpha, &fProfiles->fDst, count);
+}
+
+bool SkColorSpaceXform_skcms::applyRows(ColorFormat dstFormat, void* dst, size_t dstRowBytes,
+                                        ColorFormat srcFormat, const void* src,
+                                        size_t srcRowBytes, int count, int rows,
+                                        SkAlphaType alphaType) const {
+    // skcms_Transform() takes a single span, so it can only do all the rows at once when
+    // they're packed together.
+    if (count > 0 && rows > 1 &&
+        dstRowBytes == count * bytes_per_pixel(dstFormat) &&
+        srcRowBytes == count * bytes_per_pixel(srcFormat)) {
+        skcms_AlphaFormat srcAlpha = skcms_AlphaFormat_Unpremul;
+        skcms_AlphaFormat dstAlpha = kPremul_SkAlphaType == alphaType ? fPremulFormat
+                                                                      : skcms_AlphaFormat_Unpremul;
+        return skcms_Transform(src, get_skcms_format(srcFormat), srcAlpha, &fProfiles->fSrc,
+                               dst, get_skcms_format(dstFormat), dstAlpha, &fProfiles->fDst,
+                               (size_t)count * rows);
+    }
+    return this->INHERITED::applyRows(dstFormat, dst, dstRowBytes, srcFormat, src, srcRowBytes,
+                                      count, rows, alphaType);
 }
 
 static bool cs_to_profile(const SkColorSpace* cs, skcms_ICCProfile* profile) {
@@ -106,24 +143,105 @@ static bool cs_to_profile(const SkColorSpace* cs, skcms_ICCProfile* profile) {
     return false;
 }
 
-std::unique_ptr<SkColorSpaceXform> MakeSkcmsXform(SkColorSpace* src, SkColorSpace* dst,
-                                                  SkTransferFunctionBehavior premulBehavior) {
+// Hashes what SkColorSpace::Equals() compares: the ICC data, or the gamut and transfer function.
+static uint32_t cs_hash(const SkColorSpace* cs) {
+    if (cs->profileData()) {
+        return SkOpts::hash(cs->profileData()->data(), cs->profileData()->size());
+    }
+    SkColorSpaceTransferFn tf;
+    if (!cs->isNumericalTransferFn(&tf)) {
+        return cs->toXYZD50Hash();
+    }
+    return SkOpts::hash(&tf, sizeof(tf), cs->toXYZD50Hash());
+}
+
+static sk_sp<const SkcmsProfiles> make_profiles(SkColorSpace* src, SkColorSpace* dst) {
     // Construct skcms_ICCProfiles from each color space. For now, support A2B and XYZ.
-    // Eventually, only need to support XYZ. Map premulBehavior to one of the two premul formats
-    // in skcms.
-    skcms_ICCProfile srcProfile, dstProfile;
+    // Eventually, only need to support XYZ.
+    sk_sp<SkcmsProfiles> profiles(new SkcmsProfiles);
+    if (!cs_to_profile(src, &profiles->fSrc) || !cs_to_profile(dst, &profiles->fDst)) {
+        return nullptr;
+    }
 
-    if (!cs_to_profile(src, &srcProfile) || !cs_to_profile(dst, &dstProfile)) {
+    if (!skcms_MakeUsableAsDestination(&profiles->fDst)) {
         return nullptr;
     }
 
-    if (!skcms_MakeUsableAsDestination(&dstProfile)) {
+#ifndef SK_DONT_OPTIMIZE_SRC_PROFILES_FOR_SPEED
+    skcms_OptimizeForSpeed(&profiles->fSrc);
+#endif
+#ifndef SK_DONT_OPTIMIZE_DST_PROFILES_FOR_SPEED
+    // (This doesn't do anything yet, but we'd sure like it to.)
+    skcms_OptimizeForSpeed(&profiles->fDst);
+#endif
+    profiles->fSrcSpace = sk_ref_sp(src);
+    profiles->fDstSpace = sk_ref_sp(dst);
+    return std::move(profiles);
+}
+
+namespace {
+struct ProfilesKey {
+    uint32_t fSrcHash;
+    uint32_t fDstHash;
+
+    bool operator==(const ProfilesKey& that) const {
+        return fSrcHash == that.fSrcHash && fDstHash == that.fDstHash;
+    }
+};
+
+struct ProfilesKeyHash {
+    uint32_t operator()(const ProfilesKey& key) const {
+        return SkOpts::hash(&key, sizeof(key));
+    }
+};
+} // namespace
+
+// Codecs, SkConvertPixels() and SkColorSpaceXformCanvas make xforms between the same few pairs of
+// color spaces over and over, so the pairs' profiles are prepared once and shared.
+static constexpr int kMaxCachedProfiles = 16;
+
+static sk_sp<const SkcmsProfiles> find_or_make_profiles(SkColorSpace* src, SkColorSpace* dst) {
+    static SkMutex gMutex;
+    static auto* gCache =
+            new SkLRUCache<ProfilesKey, sk_sp<const SkcmsProfiles>, ProfilesKeyHash>(
+                    kMaxCachedProfiles);
+
+    const ProfilesKey key = { cs_hash(src), cs_hash(dst) };
+    {
+        SkAutoMutexAcquire lock(gMutex);
+        if (sk_sp<const SkcmsProfiles>* found = gCache->find(key)) {
+            // Hashes can collide, so the color spaces must match too.
+            if (SkColorSpace::Equals((*found)->fSrcSpace.get(), src) &&
+                SkColorSpace::Equals((*found)->fDstSpace.get(), dst)) {
+                return *found;
+            }
+        }
+    }
+
+    // Preparing profiles is slow, so it's done unlocked. Racing threads both prepare them.
+    sk_sp<const SkcmsProfiles> profiles = make_profiles(src, dst);
+    if (profiles) {
+        SkAutoMutexAcquire lock(gMutex);
+        if (sk_sp<const SkcmsProfiles>* found = gCache->find(key)) {
+            *found = profiles;
+        } else {
+            gCache->insert(key, profiles);
+        }
+    }
+    return profiles;
+}
+
+std::unique_ptr<SkColorSpaceXform> MakeSkcmsXform(SkColorSpace* src, SkColorSpace* dst,
+                                                  SkTransferFunctionBehavior premulBehavior) {
+    sk_sp<const SkcmsProfiles> profiles = find_or_make_profiles(src, dst);
+    if (!profiles) {
         return nullptr;
     }
 
+    // Map premulBehavior to one of the two premul formats in skcms.
     skcms_AlphaFormat premulFormat = SkTransferFunctionBehavior::kRespect == premulBehavior
             ? skcms_AlphaFormat_PremulLinear : skcms_AlphaFormat_PremulAsEncoded;
-    return skstd::make_unique<SkColorSpaceXform_skcms>(srcProfile, dstProfile, premulFormat);
+    return skstd::make_unique<SkColorSpaceXform_skcms>(std::move(profiles), premulFormat);
 }
 
 sk_sp<SkColorSpace> SkColorSpace::Make(const skcms_ICCProfile* profile) {
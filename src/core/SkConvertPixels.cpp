@@ -15,8 +15,8 @@
 #include "SkOpts.h"
 #include "SkPM4fPriv.h"
 #include "SkRasterPipeline.h"
+#include "SkTaskGroup.h"
 #include "SkUnPreMultiply.h"
-#include "SkUnPreMultiplyPriv.h"
 #include "../jumper/SkJumper.h"
 
 // Fast Path 1: The memcpy() case.
@@ -48,11 +48,6 @@ enum AlphaVerb {
     kUnpremul_AlphaVerb,
 };
 
-template <bool kSwapRB>
-static void wrap_unpremultiply(uint32_t* dst, const void* src, int count) {
-    SkUnpremultiplyRow<kSwapRB>(dst, (const uint32_t*) src, count);
-}
-
 void swizzle_and_multiply(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRB,
                           const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB) {
     void (*proc)(uint32_t* dst, const void* src, int count);
@@ -77,7 +72,7 @@ void swizzle_and_multiply(const SkImageInfo& dstInfo, void* dstPixels, size_t ds
             proc = swapRB ? SkOpts::RGBA_to_bgrA : SkOpts::RGBA_to_rgbA;
             break;
         case kUnpremul_AlphaVerb:
-            proc = swapRB ? wrap_unpremultiply<true> : wrap_unpremultiply<false>;
+            proc = swapRB ? SkOpts::rgbA_to_BGRA : SkOpts::rgbA_to_RGBA;
             break;
     }
 
@@ -154,12 +149,8 @@ static inline bool apply_color_xform(const SkImageInfo& dstInfo, void* dstPixels
         return false;
     }
 
-    for (int y = 0; y < dstInfo.height(); y++) {
-        SkAssertResult(xform->apply(dstFormat, dstPixels, srcFormat, srcPixels, dstInfo.width(),
-                       xformAlpha));
-        dstPixels = SkTAddOffset<void>(dstPixels, dstRB);
-        srcPixels = SkTAddOffset<const void>(srcPixels, srcRB);
-    }
+    SkAssertResult(xform->applyRows(dstFormat, dstPixels, dstRB, srcFormat, srcPixels, srcRB,
+                                    dstInfo.width(), dstInfo.height(), xformAlpha));
     return true;
 }
 
@@ -404,11 +395,9 @@ static bool swizzle_and_multiply_color_type(SkColorType ct) {
     }
 }
 
-void SkConvertPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRB,
-                     const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB,
-                     SkColorTable* ctable, SkTransferFunctionBehavior behavior) {
-    SkASSERT(dstInfo.dimensions() == srcInfo.dimensions());
-    SkASSERT(SkImageInfoValidConversion(dstInfo, srcInfo));
+static void convert_pixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRB,
+                           const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB,
+                           SkColorTable* ctable, SkTransferFunctionBehavior behavior) {
 
     // Fast Path 1: The memcpy() case.
     if (can_memcpy(dstInfo, srcInfo)) {
@@ -443,3 +432,35 @@ void SkConvertPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRB,
     convert_with_pipeline(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, isColorAware,
                           behavior);
 }
+
+// Conversions of at least this many pixels are split into bands of kBandRows rows. Bands are a
+// multiple of 8 rows so that dithering, which repeats every 8 rows, matches a serial conversion.
+static constexpr int kParallelPixels = 256 * 1024;
+static constexpr int kBandRows = 64;
+
+void SkConvertPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRB,
+                     const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB,
+                     SkColorTable* ctable, SkTransferFunctionBehavior behavior,
+                     SkExecutor* executor) {
+    SkASSERT(dstInfo.dimensions() == srcInfo.dimensions());
+    SkASSERT(SkImageInfoValidConversion(dstInfo, srcInfo));
+
+    const int height = dstInfo.height();
+    if (!executor || height <= kBandRows ||
+        (int64_t)dstInfo.width() * height < kParallelPixels) {
+        convert_pixels(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, ctable, behavior);
+        return;
+    }
+
+    SkTaskGroup tasks(*executor);
+    tasks.batch((height + kBandRows - 1) / kBandRows, [&](int i) {
+        const int top = i * kBandRows,
+                  rows = SkTMin(kBandRows, height - top);
+        convert_pixels(dstInfo.makeWH(dstInfo.width(), rows),
+                       SkTAddOffset<void>(dstPixels, top * dstRB), dstRB,
+                       srcInfo.makeWH(srcInfo.width(), rows),
+                       SkTAddOffset<const void>(srcPixels, top * srcRB), srcRB,
+                       ctable, behavior);
+    });
+    tasks.wait();
+}
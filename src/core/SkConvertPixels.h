@@ -12,10 +12,16 @@
 #include "SkTemplates.h"
 
 class SkColorTable;
+class SkExecutor;
 
+/**
+ *  Converts srcPixels to dstInfo's color type, alpha type and color space. If there is an
+ *  executor, large conversions are split into bands of rows that are converted in parallel on it.
+ */
 void SkConvertPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
                      const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRowBytes,
-                     SkColorTable* srcCTable, SkTransferFunctionBehavior behavior);
+                     SkColorTable* srcCTable, SkTransferFunctionBehavior behavior,
+                     SkExecutor* executor = nullptr);
 
 static inline void SkRectMemcpy(void* dst, size_t dstRB, const void* src, size_t srcRB,
                                 size_t bytesPerRow, int rowCount) {
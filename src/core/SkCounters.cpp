@@ -0,0 +1,152 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCounters.h"
+
+#include "SkCounterDump.h"
+#include "SkMathPriv.h"
+#include "SkMutex.h"
+#include "SkTLS.h"
+
+#include <atomic>
+
+static constexpr int kCounterCount = 0
+#define M(name, path) + 1
+    SK_COUNTERS(M)
+#undef M
+    ;
+
+static constexpr int kHistogramCount = 0
+#define M(name, path) + 1
+    SK_HISTOGRAMS(M)
+#undef M
+    ;
+
+static const char* kCounterNames[] = {
+#define M(name, path) path,
+    SK_COUNTERS(M)
+#undef M
+};
+
+static const char* kHistogramNames[] = {
+#define M(name, path) path,
+    SK_HISTOGRAMS(M)
+#undef M
+};
+
+// A bucket for 0, and one for each bit a value's highest set bit might be.
+static constexpr int kBucketCount = 65;
+
+static int bucket(uint64_t value) {
+    uint32_t hi = (uint32_t)(value >> 32);
+    return hi ? 64 - SkCLZ(hi) : 32 - SkCLZ((uint32_t)value);
+}
+
+namespace {
+
+struct Counts {
+    uint64_t fCounters[kCounterCount] = {};
+    uint64_t fHistograms[kHistogramCount][kBucketCount] = {};
+};
+
+// Only its own thread writes to a ThreadCounts, so it can count with plain loads and stores;
+// they're atomic so Dump() can read them from another thread.
+class ThreadCounts {
+public:
+    ThreadCounts();
+    ~ThreadCounts();
+
+    void addTo(Counts* counts) const {
+        for (int i = 0; i < kCounterCount; i++) {
+            counts->fCounters[i] += fCounters[i].load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < kHistogramCount; i++) {
+            for (int j = 0; j < kBucketCount; j++) {
+                counts->fHistograms[i][j] += fHistograms[i][j].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::atomic<uint64_t> fCounters[kCounterCount];
+    std::atomic<uint64_t> fHistograms[kHistogramCount][kBucketCount];
+
+    // Guarded by gRegistryMutex.
+    ThreadCounts* fPrev = nullptr;
+    ThreadCounts* fNext = nullptr;
+};
+
+}  // namespace
+
+SK_DECLARE_STATIC_MUTEX(gRegistryMutex);
+static ThreadCounts* gThreads = nullptr;   // Guarded by gRegistryMutex.
+static Counts* gExited = nullptr;          // Guarded by gRegistryMutex.
+
+ThreadCounts::ThreadCounts() {
+    for (auto& counter : fCounters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto& histogram : fHistograms) {
+        for (auto& count : histogram) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+    SkAutoMutexAcquire lock(gRegistryMutex);
+    fNext = gThreads;
+    if (gThreads) {
+        gThreads->fPrev = this;
+    }
+    gThreads = this;
+}
+
+ThreadCounts::~ThreadCounts() {
+    SkAutoMutexAcquire lock(gRegistryMutex);
+    if (!gExited) {
+        gExited = new Counts;
+    }
+    this->addTo(gExited);
+    (fPrev ? fPrev->fNext : gThreads) = fNext;
+    if (fNext) {
+        fNext->fPrev = fPrev;
+    }
+}
+
+static void add(std::atomic<uint64_t>* count, uint64_t n) {
+    count->store(count->load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+static ThreadCounts& thread_counts() {
+    return *static_cast<ThreadCounts*>(
+            SkTLS::Get([]() -> void* { return new ThreadCounts; },
+                       [](void* counts) { delete (ThreadCounts*)counts; }));
+}
+
+void SkCounters::Add(SkCounter counter, uint64_t n) {
+    add(&thread_counts().fCounters[(int)counter], n);
+}
+
+void SkCounters::Record(SkHistogram histogram, uint64_t value) {
+    add(&thread_counts().fHistograms[(int)histogram][bucket(value)], 1);
+}
+
+void SkCounters::Dump(SkCounterDump* dump) {
+    Counts counts;
+    {
+        SkAutoMutexAcquire lock(gRegistryMutex);
+        if (gExited) {
+            counts = *gExited;
+        }
+        for (const ThreadCounts* thread = gThreads; thread; thread = thread->fNext) {
+            thread->addTo(&counts);
+        }
+    }
+    for (int i = 0; i < kCounterCount; i++) {
+        dump->dumpCounter(kCounterNames[i], counts.fCounters[i]);
+    }
+    for (int i = 0; i < kHistogramCount; i++) {
+        dump->dumpHistogram(kHistogramNames[i], counts.fHistograms[i], kBucketCount);
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCounters_DEFINED
+#define SkCounters_DEFINED
+
+#include "SkTypes.h"
+
+class SkCounterDump;
+
+// Counters of hot path events, with the names they're dumped under.
+#define SK_COUNTERS(M)                                                      \
+    M(GlyphCacheHits,         "skia/glyph_cache/hits")                      \
+    M(GlyphCacheMisses,       "skia/glyph_cache/misses")                    \
+    M(ResourceCachePurges,    "skia/resource_cache/purges")                 \
+    M(PipelineHighpFallbacks, "skia/raster_pipeline/highp_fallbacks")       \
+    M(OpsCombined,            "skia/gpu/ops_combined")                      \
+    M(ShaderCompiles,         "skia/gpu/shader_compiles")                   \
+    M(CodecBytesDecoded,      "skia/codec/bytes_decoded")
+
+// Histograms of the sizes of hot path events, with the names they're dumped under.
+#define SK_HISTOGRAMS(M)                                                    \
+    M(CodecDecodeBytes,       "skia/codec/decode_bytes")                    \
+    M(ResourceCachePurgeBytes, "skia/resource_cache/purge_bytes")
+
+enum class SkCounter {
+#define M(name, path) k##name,
+    SK_COUNTERS(M)
+#undef M
+};
+
+enum class SkHistogram {
+#define M(name, path) k##name,
+    SK_HISTOGRAMS(M)
+#undef M
+};
+
+/**
+ *  Always-on counters and histograms of hot path events.
+ *
+ *  Each thread counts into its own relaxed atomics, so counting never contends or needs a read-
+ *  modify-write; a dump adds up every thread's counts (and those of threads that have exited).
+ *  Finding a thread's counts still costs an SkTLS lookup, so the hottest loops (e.g. glyph
+ *  lookups) count locally and add their totals in one go.
+ */
+namespace SkCounters {
+    void Add(SkCounter, uint64_t n = 1);
+    void Record(SkHistogram, uint64_t value);
+
+    void Dump(SkCounterDump*);
+}
+
+#endif
@@ -38,6 +38,14 @@ bool SkGenerateDistanceFieldFromA8Image(unsigned char* distanceField,
                                         const unsigned char* image,
                                         int w, int h, size_t rowBytes);
 
+/** For tests: SkGenerateDistanceFieldFromA8Image(), finding edges and packing distances a texel at
+ *  a time unless vectorize is set, so both can be checked against each other.
+ */
+bool SkGenerateDistanceFieldFromA8ImageForTesting(unsigned char* distanceField,
+                                                  const unsigned char* image,
+                                                  int w, int h, size_t rowBytes,
+                                                  bool vectorize);
+
 /** Given 1-bit mask data, generate the associated distance field
 
  *  @param distanceField     The distance field to be generated. Should already be allocated
@@ -28,6 +28,7 @@
 #include "SkRRect.h"
 #include "SkScalerContext.h"
 #include "SkScan.h"
+#include "SkScratchArena.h"
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkStroke.h"
@@ -72,24 +73,34 @@ bool SkDraw::computeConservativeLocalClipBounds(SkRect* localBounds) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-typedef void (*BitmapXferProc)(void* pixels, size_t bytes, uint32_t data);
+// Fills height rows of widthBytes each, starting at pixels and rowBytes apart.
+typedef void (*BitmapXferProc)(void* pixels, size_t rowBytes, size_t widthBytes, int height,
+                               uint32_t data);
 
-static void D_Clear_BitmapXferProc(void* pixels, size_t bytes, uint32_t) {
-    sk_bzero(pixels, bytes);
+static void D_Clear_BitmapXferProc(void* pixels, size_t rowBytes, size_t widthBytes, int height,
+                                   uint32_t) {
+    for (int y = 0; y < height; y++) {
+        sk_bzero((char*)pixels + y * rowBytes, widthBytes);
+    }
 }
 
-static void D_Dst_BitmapXferProc(void*, size_t, uint32_t data) {}
+static void D_Dst_BitmapXferProc(void*, size_t, size_t, int, uint32_t data) {}
 
-static void D32_Src_BitmapXferProc(void* pixels, size_t bytes, uint32_t data) {
-    sk_memset32((uint32_t*)pixels, data, SkToInt(bytes >> 2));
+static void D32_Src_BitmapXferProc(void* pixels, size_t rowBytes, size_t widthBytes, int height,
+                                   uint32_t data) {
+    sk_rect_memset32((uint32_t*)pixels, data, SkToInt(widthBytes >> 2), rowBytes, height);
 }
 
-static void D16_Src_BitmapXferProc(void* pixels, size_t bytes, uint32_t data) {
-    sk_memset16((uint16_t*)pixels, data, SkToInt(bytes >> 1));
+static void D16_Src_BitmapXferProc(void* pixels, size_t rowBytes, size_t widthBytes, int height,
+                                   uint32_t data) {
+    sk_rect_memset16((uint16_t*)pixels, data, SkToInt(widthBytes >> 1), rowBytes, height);
 }
 
-static void DA8_Src_BitmapXferProc(void* pixels, size_t bytes, uint32_t data) {
-    memset(pixels, data, bytes);
+static void DA8_Src_BitmapXferProc(void* pixels, size_t rowBytes, size_t widthBytes, int height,
+                                   uint32_t data) {
+    for (int y = 0; y < height; y++) {
+        memset((char*)pixels + y * rowBytes, data, widthBytes);
+    }
 }
 
 static BitmapXferProc ChooseBitmapXferProc(const SkPixmap& dst, const SkPaint& paint,
@@ -180,10 +191,7 @@ static void CallBitmapXferProc(const SkPixmap& dst, const SkIRect& rect, BitmapX
 
     // skip down to the first scanline and X position
     pixels += rect.fTop * rowBytes + (rect.fLeft << shiftPerPixel);
-    for (int scans = rect.height() - 1; scans >= 0; --scans) {
-        proc(pixels, widthBytes, procData);
-        pixels += rowBytes;
-    }
+    proc(pixels, rowBytes, widthBytes, rect.height(), procData);
 }
 
 void SkDraw::drawPaint(const SkPaint& paint) const {
@@ -1265,7 +1273,7 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
         int ix = SkScalarRoundToInt(matrix.getTranslateX());
         int iy = SkScalarRoundToInt(matrix.getTranslateY());
         if (clipHandlesSprite(*fRC, ix, iy, pmap)) {
-            SkSTArenaAlloc<kSkBlitterContextSize> allocator;
+            SkScratchArena allocator;
             // blitter will be owned by the allocator.
             SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, *paint, pmap, ix, iy, &allocator);
             if (blitter) {
@@ -1321,7 +1329,7 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
 
     if (nullptr == paint.getColorFilter() && clipHandlesSprite(*fRC, x, y, pmap)) {
         // blitter will be owned by the allocator.
-        SkSTArenaAlloc<kSkBlitterContextSize> allocator;
+        SkScratchArena allocator;
         SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator);
         if (blitter) {
             SkScan::FillIRect(bounds, *fRC, blitter);
@@ -1350,6 +1358,9 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
 #include "SkPaintPriv.h"
 #include "SkScalerContext.h"
 #include "SkGlyphCache.h"
+#include "SkSharedStrike.h"
+#include "SkTextBlobRasterCache.h"
+#include "SkTextBlobRunIterator.h"
 #include "SkTextToPathIter.h"
 #include "SkUtils.h"
 
@@ -1399,9 +1410,11 @@ void SkDraw::drawText_asPaths(const char text[], size_t byteLength, SkScalar x,
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Strike is SkGlyphCache or SkSharedStrike; all we need from it are glyph images.
+template <typename Strike>
 class DrawOneGlyph {
 public:
-    DrawOneGlyph(const SkDraw& draw, const SkPaint& paint, SkGlyphCache* cache, SkBlitter* blitter)
+    DrawOneGlyph(const SkDraw& draw, const SkPaint& paint, Strike* cache, SkBlitter* blitter)
         : fUseRegionToDraw(UsingRegionToDraw(draw.fRC))
         , fGlyphCache(cache)
         , fBlitter(blitter)
@@ -1510,7 +1523,7 @@ private:
     }
 
     const bool            fUseRegionToDraw;
-    SkGlyphCache  * const fGlyphCache;
+    Strike        * const fGlyphCache;
     SkBlitter     * const fBlitter;
     const SkRegion* const fClip;
     const SkDraw&         fDraw;
@@ -1528,6 +1541,30 @@ SkScalerContextFlags SkDraw::scalerContextFlags() const {
     return flags;
 }
 
+// Rasterize all of a long run's missing glyphs up front, in parallel, instead of one at a time
+// as we draw them.  Subpixel positioned glyphs depend on their positions, so we leave those be.
+static void prepare_glyph_images(const char text[], size_t byteLength, const SkPaint& paint,
+                                 SkGlyphCache* cache) {
+    static constexpr int kMinGlyphs = 64;
+
+    SkExecutor* executor = SkStrikeCache::GetGlyphRasterExecutor();
+    if (executor == nullptr || cache->isSubpixel() ||
+        paint.getTextEncoding() != SkPaint::kGlyphID_TextEncoding) {
+        return;
+    }
+    int count = SkToInt(byteLength / sizeof(SkGlyphID));
+    if (count < kMinGlyphs) {
+        return;
+    }
+
+    const SkGlyphID* glyphIDs = reinterpret_cast<const SkGlyphID*>(text);
+    SkAutoSTMalloc<256, SkPackedGlyphID> ids(count);
+    for (int i = 0; i < count; ++i) {
+        ids[i] = SkPackedGlyphID(glyphIDs[i]);
+    }
+    cache->prepareGlyphs(ids.get(), count, true, executor);
+}
+
 void SkDraw::drawText(const char text[], size_t byteLength, SkScalar x, SkScalar y,
                       const SkPaint& paint, const SkSurfaceProps* props) const {
     SkASSERT(byteLength == 0 || text != nullptr);
@@ -1548,11 +1585,12 @@ void SkDraw::drawText(const char text[], size_t byteLength, SkScalar x, SkScalar
 
     auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(
             paint, props, this->scalerContextFlags(), fMatrix);
+    prepare_glyph_images(text, byteLength, paint, cache.get());
 
     // The Blitter Choose needs to be live while using the blitter below.
     SkAutoBlitterChoose    blitterChooser(*this, nullptr, paint);
     SkAAClipBlitterWrapper wrapper(*fRC, blitterChooser.get());
-    DrawOneGlyph           drawOneGlyph(*this, paint, cache.get(), wrapper.getBlitter());
+    DrawOneGlyph<SkGlyphCache> drawOneGlyph(*this, paint, cache.get(), wrapper.getBlitter());
 
     SkFindAndPlaceGlyph::ProcessText(
         paint.getTextEncoding(), text, byteLength,
@@ -1627,11 +1665,12 @@ void SkDraw::drawPosText(const char text[], size_t byteLength, const SkScalar po
 
     auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(
             paint, props, this->scalerContextFlags(), fMatrix);
+    prepare_glyph_images(text, byteLength, paint, cache.get());
 
     // The Blitter Choose needs to be live while using the blitter below.
     SkAutoBlitterChoose    blitterChooser(*this, nullptr, paint);
     SkAAClipBlitterWrapper wrapper(*fRC, blitterChooser.get());
-    DrawOneGlyph           drawOneGlyph(*this, paint, cache.get(), wrapper.getBlitter());
+    DrawOneGlyph<SkGlyphCache> drawOneGlyph(*this, paint, cache.get(), wrapper.getBlitter());
     SkPaint::Align         textAlignment = paint.getTextAlign();
 
     SkFindAndPlaceGlyph::ProcessPosText(
@@ -1639,6 +1678,148 @@ void SkDraw::drawPosText(const char text[], size_t byteLength, const SkScalar po
         offset, *fMatrix, pos, scalarsPerPosition, textAlignment, cache.get(), drawOneGlyph);
 }
 
+void SkDraw::drawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y, const SkPaint& paint,
+                          const SkSurfaceProps* props) const {
+    using Run = SkTextBlobRasterCache::Run;
+
+    SkDEBUGCODE(this->validate();)
+
+    // nothing to draw
+    if (fRC->isEmpty()) {
+        return;
+    }
+
+    int runCount = 0;
+    for (SkTextBlobRunIterator it(blob); !it.done(); it.next()) {
+        runCount++;
+    }
+
+    sk_sp<const SkTextBlobRasterCache::Blob> cached =
+            SkTextBlobRasterCache::Find(*blob, x, y, *fMatrix);
+    SkASSERT(!cached || SkToInt(cached->runs().size()) == runCount);
+
+    // Stays empty as long as every run is in the cache.  Once one isn't, it starts as a copy of
+    // what we found, and each run we place replaces its entry.
+    std::vector<Run> placedRuns;
+    auto placedRun = [&](int runIndex) -> Run& {
+        if (placedRuns.empty()) {
+            placedRuns.resize(runCount);
+            for (int i = 0; cached && i < runCount; ++i) {
+                const Run& cachedRun = cached->runs()[i];
+                placedRuns[i].fDesc      = cachedRun.fDesc ? cachedRun.fDesc->copy() : nullptr;
+                placedRuns[i].fGlyphIDs  = cachedRun.fGlyphIDs;
+                placedRuns[i].fPositions = cachedRun.fPositions;
+            }
+        }
+        return placedRuns[runIndex];
+    };
+
+    SkPaint runPaint = paint;
+    int runIndex = 0;
+    for (SkTextBlobRunIterator it(blob); !it.done(); it.next(), ++runIndex) {
+        const char* text = (const char*)it.glyphs();
+        size_t textLen = it.glyphCount() * sizeof(uint16_t);
+        const SkPoint& offset = it.offset();
+        // applyFontToPaint() always overwrites the exact same attributes,
+        // so it is safe to not re-seed the paint for this reason.
+        it.applyFontToPaint(&runPaint);
+
+        const Run* cachedRun = cached ? &cached->runs()[runIndex] : nullptr;
+
+        if (ShouldDrawTextAsPaths(runPaint, *fMatrix)) {
+            // Paths aren't placed through a strike, so all we remember is that.
+            if (!cachedRun || cachedRun->fDesc) {
+                placedRun(runIndex) = Run();
+            }
+            switch (it.positioning()) {
+                case SkTextBlob::kDefault_Positioning:
+                    this->drawText_asPaths(text, textLen, x + offset.x(), y + offset.y(),
+                                           runPaint);
+                    break;
+                case SkTextBlob::kHorizontal_Positioning:
+                    this->drawPosText_asPaths(text, textLen, it.pos(), 1,
+                                              SkPoint::Make(x, y + offset.y()), runPaint, props);
+                    break;
+                case SkTextBlob::kFull_Positioning:
+                    this->drawPosText_asPaths(text, textLen, it.pos(), 2,
+                                              SkPoint::Make(x, y), runPaint, props);
+                    break;
+            }
+            continue;
+        }
+
+        SkAutoDescriptor       ad;
+        SkScalerContextEffects effects;
+        const SkDescriptor* desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+                runPaint, props, this->scalerContextFlags(), fMatrix, &ad, &effects);
+        auto typeface = SkPaintPriv::GetTypefaceOrDefault(runPaint);
+
+        // The Blitter Choose needs to be live while using the blitter below.
+        SkAutoBlitterChoose    blitterChooser(*this, nullptr, runPaint);
+        SkAAClipBlitterWrapper wrapper(*fRC, blitterChooser.get());
+
+        if (cachedRun && cachedRun->fDesc && *cachedRun->fDesc == *desc) {
+            // The glyphs are already found and placed, so all we need are their images.  Those
+            // come from a shared strike, so threads drawing this blob at once (e.g. tile by tile)
+            // use the same glyphs instead of each checking out a strike of its own.
+            sk_sp<SkSharedStrike> strike =
+                    SkStrikeCache::FindOrCreateStrikeShared(*desc, effects, *typeface);
+            DrawOneGlyph<SkSharedStrike> drawOneGlyph(*this, runPaint, strike.get(),
+                                                      wrapper.getBlitter());
+            for (size_t i = 0; i < cachedRun->fGlyphIDs.size(); ++i) {
+                SkPackedGlyphID id = cachedRun->fGlyphIDs[i];
+                const SkGlyph& glyph =
+                        strike->getGlyphIDMetrics(id.code(), id.getSubXFixed(), id.getSubYFixed());
+                drawOneGlyph(glyph, cachedRun->fPositions[i], {0, 0});
+            }
+            continue;
+        }
+
+        auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(*desc, effects, *typeface);
+        DrawOneGlyph<SkGlyphCache> drawOneGlyph(*this, runPaint, cache.get(),
+                                                wrapper.getBlitter());
+
+        Run& placed = placedRun(runIndex);
+        placed.fDesc = cache->getDescriptor().copy();
+        placed.fGlyphIDs.clear();
+        placed.fPositions.clear();
+        placed.fGlyphIDs.reserve(it.glyphCount());
+        placed.fPositions.reserve(it.glyphCount());
+        auto placeOneGlyph = [&](const SkGlyph& glyph, SkPoint position, SkPoint rounding) {
+            placed.fGlyphIDs.push_back(glyph.getPackedID());
+            placed.fPositions.push_back(position + rounding);
+            drawOneGlyph(glyph, position, rounding);
+        };
+
+        prepare_glyph_images(text, textLen, runPaint, cache.get());
+        switch (it.positioning()) {
+            case SkTextBlob::kDefault_Positioning:
+                SkFindAndPlaceGlyph::ProcessText(
+                    runPaint.getTextEncoding(), text, textLen,
+                    {x + offset.x(), y + offset.y()}, *fMatrix, runPaint.getTextAlign(),
+                    cache.get(), placeOneGlyph);
+                break;
+            case SkTextBlob::kHorizontal_Positioning:
+                SkFindAndPlaceGlyph::ProcessPosText(
+                    runPaint.getTextEncoding(), text, textLen,
+                    {x, y + offset.y()}, *fMatrix, it.pos(), 1, runPaint.getTextAlign(),
+                    cache.get(), placeOneGlyph);
+                break;
+            case SkTextBlob::kFull_Positioning:
+                SkFindAndPlaceGlyph::ProcessPosText(
+                    runPaint.getTextEncoding(), text, textLen,
+                    {x, y}, *fMatrix, it.pos(), 2, runPaint.getTextAlign(),
+                    cache.get(), placeOneGlyph);
+                break;
+        }
+    }
+
+    if (!placedRuns.empty()) {
+        SkTextBlobRasterCache::Add(*blob, x, y, *fMatrix,
+                                   sk_make_sp<SkTextBlobRasterCache::Blob>(std::move(placedRuns)));
+    }
+}
+
 #if defined _WIN32
 #pragma warning ( pop )
 #endif
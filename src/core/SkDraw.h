@@ -26,6 +26,7 @@ class SkMatrix;
 class SkPath;
 class SkRegion;
 class SkRasterClip;
+class SkTextBlob;
 struct SkDrawProcs;
 struct SkRect;
 class SkRRect;
@@ -67,6 +68,12 @@ public:
     void    drawPosText(const char text[], size_t byteLength,
                         const SkScalar pos[], int scalarsPerPosition,
                         const SkPoint& offset, const SkPaint&, const SkSurfaceProps*) const;
+    /**
+     *  Draws every run of the blob, going through SkTextBlobRasterCache to reuse the glyphs
+     *  placed the last time this blob was drawn with the same matrix.
+     */
+    void    drawTextBlob(const SkTextBlob*, SkScalar x, SkScalar y, const SkPaint&,
+                         const SkSurfaceProps*) const;
     void    drawVertices(SkVertices::VertexMode mode, int count,
                          const SkPoint vertices[], const SkPoint textures[],
                          const SkColor colors[], SkBlendMode bmode,
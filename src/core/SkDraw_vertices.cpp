@@ -9,10 +9,13 @@
 #include "SkAutoBlitterChoose.h"
 #include "SkComposeShader.h"
 #include "SkDraw.h"
+#include "SkEdge.h"
 #include "SkNx.h"
 #include "SkPM4fPriv.h"
 #include "SkRasterClip.h"
+#include "SkSafe32.h"
 #include "SkScan.h"
+#include "SkScratchArena.h"
 #include "SkShaderBase.h"
 #include "SkString.h"
 #include "SkVertState.h"
@@ -137,6 +140,109 @@ update_tricolor_matrix(const SkMatrix& ctmInv, const SkPoint pts[], const SkPM4f
     return true;
 }
 
+// Without perspective the colors are as linear in device space as they are in local space, so
+// the matrix from device space to color can be solved for directly from the device points, rather
+// than by inverting and concatenating a pair of SkMatrix for each triangle.
+static bool SK_WARN_UNUSED_RESULT
+update_tricolor_matrix_affine(const SkPoint devPts[], const SkPM4f colors[],
+                              int index0, int index1, int index2, Matrix43* result) {
+    const SkPoint& p0 = devPts[index0];
+    const SkVector e1 = devPts[index1] - p0,
+                   e2 = devPts[index2] - p0;
+    const float det = e1.fX * e2.fY - e2.fX * e1.fY;
+    // The same tolerance SkMatrix::invert() has for the matrix update_tricolor_matrix() inverts.
+    if (SkScalarNearlyZero(det, SK_ScalarNearlyZero * SK_ScalarNearlyZero * SK_ScalarNearlyZero)) {
+        return false;
+    }
+    const float invDet = 1 / det;
+
+    Sk4f c0  = colors[index0].to4f(),
+         dc1 = colors[index1].to4f() - c0,
+         dc2 = colors[index2].to4f() - c0;
+
+    Sk4f ddx = (dc1 * e2.fY - dc2 * e1.fY) * invDet,
+         ddy = (dc2 * e1.fX - dc1 * e2.fX) * invDet;
+    ddx.store(&result->fMat[0]);
+    ddy.store(&result->fMat[4]);
+    (c0 - ddx * p0.fX - ddy * p0.fY).store(&result->fMat[8]);
+    return true;
+}
+
+// Fills a triangle within the clip rect, covering the pixels SkScan::FillTriangle() does there:
+// its edges are the same SkEdges, walked the same way. It skips SkScan's sorting of the edges
+// into a list and its clip blitters, which add up when meshes draw many small triangles. The
+// triangle must lie within SkScan's fixed point limits.
+static void fill_triangle(const SkPoint pts[3], const SkIRect& clip, SkBlitter* blitter) {
+    SkRect r;
+    r.set(pts, 3);
+    SkIRect ir = r.round();
+    if (ir.isEmpty() || !ir.intersect(clip)) {
+        return;
+    }
+
+    const SkPoint* p0 = &pts[0];
+    const SkPoint* p1 = &pts[1];
+    const SkPoint* p2 = &pts[2];
+    if (p1->fY < p0->fY) { SkTSwap(p0, p1); }
+    if (p2->fY < p1->fY) { SkTSwap(p1, p2); }
+    if (p1->fY < p0->fY) { SkTSwap(p0, p1); }
+
+    // The long edge spans all the triangle's rows, first beside the upper short edge, then beside
+    // the lower one.
+    SkEdge longEdge, shortEdges[2];
+    if (!longEdge.setLine(*p0, *p2, nullptr, 0)) {
+        return;
+    }
+    const int shortCounts[2] = {
+        shortEdges[0].setLine(*p0, *p1, nullptr, 0),
+        shortEdges[1].setLine(*p1, *p2, nullptr, 0),
+    };
+
+    // Edges step with wrapping arithmetic, as they do in walk_convex_edges().
+    auto advance = [](SkFixed x, SkFixed dx, int rows) {
+        return (SkFixed)((uint32_t)x + (uint32_t)dx * (uint32_t)rows);
+    };
+
+    SkFixed longX = longEdge.fX;
+    int y = longEdge.fFirstY;
+    for (const SkEdge* shortEdge = shortEdges; shortEdge < shortEdges + 2; ++shortEdge) {
+        if (!shortCounts[shortEdge - shortEdges]) {
+            continue;
+        }
+        SkASSERT(shortEdge->fFirstY == y);
+
+        const int top = SkTMax(y, ir.fTop),
+                  bot = SkTMin(shortEdge->fLastY + 1, ir.fBottom);
+        if (top >= bot) {
+            longX = advance(longX, longEdge.fDX, shortEdge->fLastY + 1 - y);
+            y = shortEdge->fLastY + 1;
+            continue;
+        }
+        longX = advance(longX, longEdge.fDX, top - y);
+        SkFixed shortX = advance(shortEdge->fX, shortEdge->fDX, top - y);
+
+        // As walk_convex_edges() does, pick the left edge once for all the rows they share.
+        const bool longIsLeft = longX < shortX ||
+                                (longX == shortX && longEdge.fDX <= shortEdge->fDX);
+        SkFixed& left = longIsLeft ? longX : shortX;
+        SkFixed& rite = longIsLeft ? shortX : longX;
+        const SkFixed dLeft = longIsLeft ? longEdge.fDX : shortEdge->fDX,
+                      dRite = longIsLeft ? shortEdge->fDX : longEdge.fDX;
+        for (y = top; y < bot; ++y) {
+            const int L = SkTMax(SkFixedRoundToInt(left), clip.fLeft),
+                      R = SkTMin(SkFixedRoundToInt(rite), clip.fRight);
+            if (L < R) {
+                blitter->blitH(L, y, R - L);
+            }
+            left = Sk32_can_overflow_add(left, dLeft);
+            rite = Sk32_can_overflow_add(rite, dRite);
+        }
+        if (y >= ir.fBottom) {
+            return;
+        }
+    }
+}
+
 // Convert the SkColors into float colors. The conversion depends on some conditions:
 // - If the pixmap has a dst colorspace, we have to be "color-correct".
 //   Do we map into dst-colorspace before or after we interpolate?
@@ -214,11 +320,7 @@ void SkDraw::drawVertices(SkVertices::VertexMode vmode, int count,
         shader = nullptr;
     }
 
-    constexpr size_t defCount = 16;
-    constexpr size_t outerSize = sizeof(SkTriColorShader) +
-                                 sizeof(SkComposeShader) +
-                                 (sizeof(SkPoint) + sizeof(SkPM4f)) * defCount;
-    SkSTArenaAlloc<outerSize> outerAlloc;
+    SkScratchArena outerAlloc;
 
     SkPoint* devVerts = outerAlloc.makeArray<SkPoint>(count);
     fMatrix->mapPoints(devVerts, vertices, count);
@@ -235,6 +337,28 @@ void SkDraw::drawVertices(SkVertices::VertexMode vmode, int count,
     VertState       state(count, indices, indexCount);
     VertState::Proc vertProc = state.chooseProc(vmode);
 
+    // Triangles entirely outside the clip are skipped before anything is set up for them. When
+    // the clip is a rect, triangles that SkScan would fill without clipping them geometrically
+    // are filled directly, rather than through SkScan's edge lists and clip blitters.
+    const SkIRect& clipBounds = fRC->getBounds();
+    const bool clipIsRect = fRC->isRect();
+    const SkScalar limit = SK_MaxS16 >> 1;
+    const SkRect fixedLimits = SkRect::MakeLTRB(-limit, -limit, limit, limit);
+    auto cull = [&](const SkPoint tri[3]) {
+        SkRect r;
+        r.set(tri, 3);
+        return !SkIRect::Intersects(r.roundOut(), clipBounds);
+    };
+    auto fill = [&](const SkPoint tri[3], SkBlitter* blitter) {
+        SkRect r;
+        r.set(tri, 3);
+        if (clipIsRect && fixedLimits.contains(r)) {
+            fill_triangle(tri, clipBounds, blitter);
+        } else {
+            SkScan::FillTriangle(tri, *fRC, blitter);
+        }
+    };
+
     if (colors || textures) {
         SkPM4f*     dstColors = nullptr;
         Matrix43*   matrix43 = nullptr;
@@ -256,23 +380,35 @@ void SkDraw::drawVertices(SkVertices::VertexMode vmode, int count,
         SkPaint p(paint);
         p.setShader(sk_ref_sp(shader));
 
+        const bool affine = !fMatrix->hasPerspective();
+        auto updateTricolor = [&]() {
+            return affine ? update_tricolor_matrix_affine(devVerts, dstColors,
+                                                          state.f0, state.f1, state.f2, matrix43)
+                          : update_tricolor_matrix(ctmInv, vertices, dstColors,
+                                                   state.f0, state.f1, state.f2, matrix43);
+        };
+
         if (!textures) {    // only tricolor shader
             SkASSERT(matrix43);
             auto blitter = SkCreateRasterPipelineBlitter(fDst, p, *fMatrix, &outerAlloc);
             while (vertProc(&state)) {
-                if (!update_tricolor_matrix(ctmInv, vertices, dstColors,
-                                            state.f0, state.f1, state.f2,
-                                            matrix43)) {
-                    continue;
-                }
-
                 SkPoint tmp[] = {
                     devVerts[state.f0], devVerts[state.f1], devVerts[state.f2]
                 };
-                SkScan::FillTriangle(tmp, *fRC, blitter);
+                if (cull(tmp) || !updateTricolor()) {
+                    continue;
+                }
+                fill(tmp, blitter);
             }
         } else {
             while (vertProc(&state)) {
+                SkPoint tmp[] = {
+                    devVerts[state.f0], devVerts[state.f1], devVerts[state.f2]
+                };
+                if (cull(tmp)) {
+                    continue;
+                }
+
                 SkSTArenaAlloc<2048> innerAlloc;
 
                 const SkMatrix* ctm = fMatrix;
@@ -286,17 +422,12 @@ void SkDraw::drawVertices(SkVertices::VertexMode vmode, int count,
                     ctm = &tmpCtm;
                 }
 
-                if (matrix43 && !update_tricolor_matrix(ctmInv, vertices, dstColors,
-                                                        state.f0, state.f1, state.f2,
-                                                        matrix43)) {
+                if (matrix43 && !updateTricolor()) {
                     continue;
                 }
 
-                SkPoint tmp[] = {
-                    devVerts[state.f0], devVerts[state.f1], devVerts[state.f2]
-                };
                 auto blitter = SkCreateRasterPipelineBlitter(fDst, p, *ctm, &innerAlloc);
-                SkScan::FillTriangle(tmp, *fRC, blitter);
+                fill(tmp, blitter);
             }
         }
     } else {
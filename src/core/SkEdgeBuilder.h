@@ -7,8 +7,8 @@
 #ifndef SkEdgeBuilder_DEFINED
 #define SkEdgeBuilder_DEFINED
 
-#include "SkArenaAlloc.h"
 #include "SkRect.h"
+#include "SkScratchArena.h"
 #include "SkTDArray.h"
 #include "SkEdge.h"
 #include "SkAnalyticEdge.h"
@@ -69,7 +69,7 @@ private:
     bool vertical_line(const SkEdge* edge);
     bool vertical_line(const SkAnalyticEdge* edge);
 
-    SkSTArenaAlloc<512> fAlloc;
+    SkScratchArena      fAlloc;
     SkTDArray<void*>    fList;
 
     /*
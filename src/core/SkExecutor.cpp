@@ -11,8 +11,10 @@
 #include "SkSemaphore.h"
 #include "SkSpinlock.h"
 #include "SkTArray.h"
+#include <atomic>
 #include <deque>
 #include <thread>
+#include <vector>
 
 #if defined(SK_BUILD_FOR_WIN)
     #include "SkLeanWindows.h"
@@ -90,6 +92,28 @@ public:
         fWorkAvailable.signal(1);
     }
 
+    virtual void batch(int N, std::function<void(int)> fn, Priority) override {
+        // Rather than a piece of work per index, add one per thread, each doing indices until
+        // there are none left.
+        struct Batch {
+            std::function<void(int)> fFn;
+            int                      fN;
+            std::atomic<int>         fNext;
+        };
+        auto batch = std::make_shared<Batch>();
+        batch->fFn = std::move(fn);
+        batch->fN = N;
+        batch->fNext = 0;
+        for (int i = 0; i < SkTMin(N, fThreads.count()); i++) {
+            this->add([batch] {
+                int j;
+                while ((j = batch->fNext.fetch_add(1, std::memory_order_relaxed)) < batch->fN) {
+                    batch->fFn(j);
+                }
+            });
+        }
+    }
+
     virtual void borrow() override {
         // If there is work waiting, do it.
         if (fWorkAvailable.try_wait()) {
@@ -131,6 +155,221 @@ private:
     SkSemaphore           fWorkAvailable;
 };
 
+// An SkWorkStealingThreadPool gives each thread its own work lists, one per priority. Threads
+// add to and take from the back of their own, and when those run dry take from the front of
+// others'. Batches are added as one range of indices, which thieves split in half.
+class SkWorkStealingThreadPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingThreadPool(int threads) : fQueues(threads) {
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, i);
+        }
+    }
+
+    ~SkWorkStealingThreadPool() override {
+        // Threads finish all the work there is before shutting down.
+        fShutdown.store(true);
+        fWorkAvailable.signal(fThreads.count());
+        for (int i = 0; i < fThreads.count(); i++) {
+            fThreads[i].join();
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        this->addPrioritized(std::move(work), Priority::kNormal, -1);
+    }
+
+    void addPrioritized(std::function<void(void)> fn, Priority priority,
+                        int threadHint) override {
+        Work work;
+        work.fFn = std::move(fn);
+        this->push(std::move(work), priority, threadHint);
+        fWorkAvailable.signal(1);
+    }
+
+    void batch(int N, std::function<void(int)> fn, Priority priority) override {
+        if (N <= 0) {
+            return;
+        }
+        Work work;
+        work.fBatch = new Batch{std::move(fn), {N}};
+        work.fBegin = 0;
+        work.fEnd = N;
+        this->push(std::move(work), priority, -1);
+        // Wake enough threads to split it between them.
+        fWorkAvailable.signal(SkTMin(N, fThreads.count()));
+    }
+
+    void borrow() override {
+        Work work;
+        if (fPending.load(std::memory_order_relaxed) > 0 &&
+            this->take(this->currentThread(), &work)) {
+            this->run(&work);
+        }
+    }
+
+private:
+    static constexpr int kPriorityCount = 3;
+
+    struct Batch {
+        std::function<void(int)> fFn;
+        std::atomic<int>         fRemaining;
+    };
+
+    // Either a function, or the indices [fBegin, fEnd) of a batch.
+    struct Work {
+        std::function<void(void)> fFn;
+        Batch*                    fBatch = nullptr;
+        int                       fBegin = 0;
+        int                       fEnd = 0;
+    };
+
+    struct Queue {
+        SkMutex           fLock;
+        std::deque<Work>  fWork[kPriorityCount];
+    };
+
+    // Returns the index of the calling thread if it's one of ours, or -1.
+    int currentThread() const {
+        const std::thread::id id = std::this_thread::get_id();
+        for (int i = 0; i < fThreads.count(); i++) {
+            if (fThreads[i].get_id() == id) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void push(Work&& work, Priority priority, int threadHint) {
+        // Work added from our threads stays with them, close to the work that added it.
+        int thread = this->currentThread();
+        if (thread < 0) {
+            thread = (threadHint >= 0 ? threadHint
+                                      : fNextThread.fetch_add(1, std::memory_order_relaxed)) %
+                     fThreads.count();
+        }
+        fPending.fetch_add(Size(work), std::memory_order_relaxed);
+        Queue& queue = fQueues[thread];
+        SkAutoMutexAcquire lock(queue.fLock);
+        queue.fWork[(int)priority].push_back(std::move(work));
+    }
+
+    static int Size(const Work& work) { return work.fBatch ? work.fEnd - work.fBegin : 1; }
+
+    bool take(int thread, Work* work) {
+        if (this->takeAny(thread, work)) {
+            fPending.fetch_sub(Size(*work), std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    // Takes one piece of work, from thread's own lists if it has any, otherwise the highest
+    // priority work in anyone's. thread is -1 for threads not in the pool.
+    bool takeAny(int thread, Work* work) {
+        if (thread >= 0) {
+            Queue& queue = fQueues[thread];
+            SkAutoMutexAcquire lock(queue.fLock);
+            for (auto& list : queue.fWork) {
+                if (!list.empty()) {
+                    Work& back = list.back();
+                    if (back.fBatch && back.fEnd - back.fBegin > 1) {
+                        // Take the last index, leaving the rest.
+                        work->fBatch = back.fBatch;
+                        work->fBegin = --back.fEnd;
+                        work->fEnd = work->fBegin + 1;
+                    } else {
+                        *work = std::move(back);
+                        list.pop_back();
+                    }
+                    return true;
+                }
+            }
+        }
+
+        for (int priority = 0; priority < kPriorityCount; priority++) {
+            for (int i = 1; i <= fThreads.count(); i++) {
+                const int victim = (SkTMax(thread, 0) + i) % fThreads.count();
+                if (victim != thread && this->steal(victim, priority, thread, work)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool steal(int victim, int priority, int thread, Work* work) {
+        Work rest;
+        {
+            Queue& queue = fQueues[victim];
+            SkAutoMutexAcquire lock(queue.fLock);
+            auto& list = queue.fWork[priority];
+            if (list.empty()) {
+                return false;
+            }
+            Work& front = list.front();
+            if (front.fBatch && front.fEnd - front.fBegin > 1) {
+                // Split the batch, taking the first half, or just its first index if we've
+                // nowhere to keep the rest.
+                const int mid = thread < 0 ? front.fBegin + 1
+                                           : front.fBegin + (front.fEnd - front.fBegin) / 2;
+                *work = front;
+                work->fEnd = mid;
+                front.fBegin = mid;
+            } else {
+                *work = std::move(front);
+                list.pop_front();
+            }
+        }
+
+        // Keep all but one of a stolen range, for ourselves or more thieves.
+        if (work->fBatch && work->fEnd - work->fBegin > 1) {
+            rest = *work;
+            rest.fBegin++;
+            work->fEnd = work->fBegin + 1;
+            Queue& queue = fQueues[thread];
+            SkAutoMutexAcquire lock(queue.fLock);
+            queue.fWork[priority].push_back(std::move(rest));
+        }
+        return true;
+    }
+
+    void run(Work* work) {
+        if (!work->fBatch) {
+            work->fFn();
+            return;
+        }
+        Batch* batch = work->fBatch;
+        for (int i = work->fBegin; i < work->fEnd; i++) {
+            batch->fFn(i);
+        }
+        if (batch->fRemaining.fetch_sub(work->fEnd - work->fBegin,
+                                        std::memory_order_acq_rel) == work->fEnd - work->fBegin) {
+            delete batch;
+        }
+    }
+
+    static void Loop(SkWorkStealingThreadPool* pool, int thread) {
+        // Threads wait before touching anything, since the pool isn't built until they're all
+        // started. Then they do work until there's none to take, and sleep until there's more.
+        Work work;
+        do {
+            pool->fWorkAvailable.wait();
+            while (pool->take(thread, &work)) {
+                pool->run(&work);
+                work = Work();
+            }
+        } while (!pool->fShutdown.load());
+    }
+
+    SkTArray<std::thread> fThreads;
+    std::vector<Queue>    fQueues;
+    std::atomic<int>      fNextThread{0};
+    std::atomic<int>      fPending{0};  // How much work hasn't been taken yet.
+    std::atomic<bool>     fShutdown{false};
+    SkSemaphore           fWorkAvailable;
+};
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads) {
     using WorkList = std::deque<std::function<void(void)>>;
     return skstd::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores());
@@ -139,3 +378,6 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads) {
     using WorkList = SkTArray<std::function<void(void)>>;
     return skstd::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores());
 }
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingThreadPool(int threads) {
+    return skstd::make_unique<SkWorkStealingThreadPool>(threads > 0 ? threads : num_cores());
+}
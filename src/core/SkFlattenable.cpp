@@ -148,10 +148,7 @@ sk_sp<SkData> SkFlattenable::serialize(const SkSerialProcs* procs) const {
         writer.setSerialProcs(*procs);
     }
     writer.writeFlattenable(this);
-    size_t size = writer.bytesWritten();
-    auto data = SkData::MakeUninitialized(size);
-    writer.writeToMemory(data->writable_data());
-    return data;
+    return writer.detachAsData();
 }
 
 size_t SkFlattenable::serialize(void* memory, size_t memory_size,
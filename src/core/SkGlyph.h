@@ -207,6 +207,7 @@ public:
  private:
     // TODO(herb) remove friend statement after SkGlyphCache cleanup.
     friend class SkGlyphCache;
+    friend class SkSharedStrike;
     SkPackedGlyphID fID;
 };
 
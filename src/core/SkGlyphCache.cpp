@@ -7,12 +7,15 @@
 
 #include "SkGlyphCache.h"
 
+#include "SkCounters.h"
 #include "SkGraphics.h"
 #include "SkMutex.h"
 #include "SkOnce.h"
 #include "SkPath.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTypeface.h"
+#include <algorithm>
 #include <cctype>
 
 SkGlyphCache::SkGlyphCache(
@@ -28,6 +31,7 @@ SkGlyphCache::SkGlyphCache(
 }
 
 SkGlyphCache::~SkGlyphCache() {
+    this->flushCounters();
     fGlyphMap.foreach([](SkGlyph* g) {
         if (g->fPathData) {
             delete g->fPathData->fPath;
@@ -35,6 +39,16 @@ SkGlyphCache::~SkGlyphCache() {
     });
 }
 
+void SkGlyphCache::flushCounters() {
+    if (fHits) {
+        SkCounters::Add(SkCounter::kGlyphCacheHits, fHits);
+    }
+    if (fMisses) {
+        SkCounters::Add(SkCounter::kGlyphCacheMisses, fMisses);
+    }
+    fHits = fMisses = 0;
+}
+
 const SkDescriptor& SkGlyphCache::getDescriptor() const {
     return *fDesc.getDesc();
 }
@@ -138,9 +152,12 @@ SkGlyph* SkGlyphCache::lookupByPackedGlyphID(SkPackedGlyphID packedGlyphID, Metr
     SkGlyph* glyph = fGlyphMap.find(packedGlyphID);
 
     if (nullptr == glyph) {
+        fMisses++;
         glyph = this->allocateNewGlyph(packedGlyphID, type);
     } else {
-        if (type == kFull_MetricsType && glyph->isJustAdvance()) {
+        fHits++;
+        if (type == kFull_MetricsType && glyph->isJustAdvance() &&
+            !fStoredStrike.findMetrics(glyph)) {
            fScalerContext->getMetrics(glyph);
         }
     }
@@ -159,6 +176,8 @@ SkGlyph* SkGlyphCache::allocateNewGlyph(SkPackedGlyphID packedGlyphID, MetricsTy
 
     if (kNothing_MetricsType == mtype) {
         return glyphPtr;
+    } else if (fStoredStrike.findMetrics(glyphPtr)) {
+        // The stored metrics are full metrics, which will do for either type.
     } else if (kJustAdvance_MetricsType == mtype) {
         fScalerContext->getAdvance(glyphPtr);
     } else {
@@ -176,7 +195,9 @@ const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
             size_t  size = const_cast<SkGlyph&>(glyph).allocImage(&fAlloc);
             // check that alloc() actually succeeded
             if (glyph.fImage) {
-                fScalerContext->getImage(glyph);
+                if (!fStoredStrike.findImage(glyph)) {
+                    fScalerContext->getImage(glyph);
+                }
                 // TODO: the scaler may have changed the maskformat during
                 // getImage (e.g. from AA or LCD to BW) which means we may have
                 // overallocated the buffer. Check if the new computedImageSize
@@ -188,6 +209,96 @@ const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
     return glyph.fImage;
 }
 
+void SkGlyphCache::prepareGlyphs(const SkPackedGlyphID ids[], int count, bool wantImages,
+                                 SkExecutor* executor) {
+    VALIDATE();
+
+    // Adding glyphs may move the others around in fGlyphMap, so add them all before we hold on
+    // to any pointers.
+    for (int i = 0; i < count; ++i) {
+        if (fGlyphMap.find(ids[i]) == nullptr) {
+            this->allocateNewGlyph(ids[i], kNothing_MetricsType);
+        }
+    }
+
+    SkAutoSTMalloc<64, SkGlyph*> glyphs(count);
+    int needMetrics = 0;
+    for (int i = 0; i < count; ++i) {
+        SkGlyph* glyph = fGlyphMap.find(ids[i]);
+        if (glyph->isJustAdvance() && !fStoredStrike.findMetrics(glyph)) {
+            glyphs[needMetrics++] = glyph;
+        }
+    }
+    // Drop any duplicates in ids.
+    std::sort(glyphs.get(), glyphs.get() + needMetrics);
+    needMetrics = SkToInt(std::unique(glyphs.get(), glyphs.get() + needMetrics) - glyphs.get());
+    fScalerContext->getMetrics(glyphs.get(), needMetrics);
+
+    if (!wantImages) {
+        return;
+    }
+
+    int needImages = 0;
+    for (int i = 0; i < count; ++i) {
+        SkGlyph* glyph = fGlyphMap.find(ids[i]);
+        if (glyph->fWidth > 0 && glyph->fWidth < kMaxGlyphWidth && glyph->fImage == nullptr) {
+            // Allocating here also keeps a duplicate id from being counted twice.
+            fMemoryUsed += glyph->allocImage(&fAlloc);
+            if (glyph->fImage && !fStoredStrike.findImage(*glyph)) {
+                glyphs[needImages++] = glyph;
+            }
+        }
+    }
+    if (executor != nullptr) {
+        this->generateImagesInParallel(
+                const_cast<const SkGlyph**>(glyphs.get()), needImages, executor);
+    } else {
+        fScalerContext->getImages(const_cast<const SkGlyph**>(glyphs.get()), needImages);
+    }
+}
+
+void SkGlyphCache::generateImagesInParallel(const SkGlyph* glyphs[], int count,
+                                            SkExecutor* executor) {
+    // Each task needs a new scaler context, so don't bother unless there's a fair bit of work.
+    static constexpr int kMinGlyphsPerTask = 32;
+    static constexpr int kMaxTasks         = 8;
+
+    const int taskCount = SkTMin(kMaxTasks, count / kMinGlyphsPerTask);
+    if (taskCount < 2) {
+        fScalerContext->getImages(glyphs, count);
+        return;
+    }
+
+    // The clones hold their own font data, which fMemoryUsed can't see, so they only live as long
+    // as this call.
+    std::unique_ptr<SkScalerContext> scalers[kMaxTasks];
+    SkAutoSTMalloc<kMaxTasks, bool> failed(taskCount);
+
+    // The glyphs and their image storage are already allocated, so each task only writes to
+    // its own glyphs' images, and there's nothing to merge afterwards.
+    SkTaskGroup tasks(*executor);
+    tasks.batch(taskCount, [&](int i) {
+        std::unique_ptr<SkScalerContext>& scaler = scalers[i];
+        scaler = fScalerContext->getTypeface()->createScalerContext(
+                fScalerContext->getEffects(), &this->getDescriptor(), true /* can fail */);
+        failed[i] = scaler == nullptr;
+        if (scaler) {
+            int start = count *  i      / taskCount,
+                end   = count * (i + 1) / taskCount;
+            scaler->getImages(glyphs + start, end - start);
+        }
+    });
+    tasks.wait();
+
+    for (int i = 0; i < taskCount; ++i) {
+        if (failed[i]) {
+            int start = count *  i      / taskCount,
+                end   = count * (i + 1) / taskCount;
+            fScalerContext->getImages(glyphs + start, end - start);
+        }
+    }
+}
+
 const SkPath* SkGlyphCache::findPath(const SkGlyph& glyph) {
     if (glyph.fWidth) {
         if (glyph.fPathData == nullptr) {
@@ -195,7 +306,11 @@ const SkPath* SkGlyphCache::findPath(const SkGlyph& glyph) {
             const_cast<SkGlyph&>(glyph).fPathData = pathData;
             pathData->fIntercept = nullptr;
             SkPath* path = new SkPath;
-            if (fScalerContext->getPath(glyph.getPackedID(), path)) {
+            bool hasPath;
+            if (!fStoredStrike.findPath(glyph.getPackedID(), path, &hasPath)) {
+                hasPath = fScalerContext->getPath(glyph.getPackedID(), path);
+            }
+            if (hasPath) {
                 pathData->fPath = path;
                 fMemoryUsed += sizeof(SkPath) + path->countPoints() * sizeof(SkPoint);
             } else {
@@ -207,6 +322,10 @@ const SkPath* SkGlyphCache::findPath(const SkGlyph& glyph) {
     return glyph.fPathData ? glyph.fPathData->fPath : nullptr;
 }
 
+void SkGlyphCache::forEachGlyph(const std::function<void(const SkGlyph&)>& visitor) const {
+    fGlyphMap.foreach([&visitor](const SkGlyph& glyph) { visitor(glyph); });
+}
+
 #include "../pathops/SkPathOpsCubic.h"
 #include "../pathops/SkPathOpsQuad.h"
 
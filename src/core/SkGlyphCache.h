@@ -8,13 +8,19 @@
 #define SkGlyphCache_DEFINED
 
 #include "SkArenaAlloc.h"
+#include "SkData.h"
 #include "SkDescriptor.h"
 #include "SkGlyph.h"
+#include "SkGlyphStore.h"
 #include "SkPaint.h"
-#include "SkTHash.h"
 #include "SkScalerContext.h"
+#include "SkTFlatHash.h"
 #include "SkTemplates.h"
+#include <functional>
 #include <memory>
+#include <vector>
+
+class SkExecutor;
 
 /** \class SkGlyphCache
 
@@ -27,7 +33,7 @@
     either Find{OrCreate}Exclusive().
 
     The Find*Exclusive() method returns SkExclusiveStrikePtr, which releases exclusive ownership
-    when they go out of scope.
+    when they go out of scope. To share one strike between threads, see SkSharedStrike.
 */
 class SkGlyphCache {
 public:
@@ -93,6 +99,17 @@ public:
     */
     const void* findImage(const SkGlyph&);
 
+    /** Make sure each of the glyphs has full metrics and, if wantImages is set, its image.
+        Everything missing is generated in one batch, which can be much cheaper than filling
+        in the glyphs one at a time, e.g. when warming up a new strike for a run of text.
+
+        If executor is not null and there are many images to make, they are split between
+        tasks on the executor, each with its own copy of the scaler context. This returns once
+        all the images are in the strike.
+    */
+    void prepareGlyphs(const SkPackedGlyphID ids[], int count, bool wantImages,
+                       SkExecutor* executor = nullptr);
+
     /** If the advance axis intersects the glyph's path, append the positions scaled and offset
         to the array (if non-null), and set the count to the updated array length.
     */
@@ -121,6 +138,31 @@ public:
     /** Return the approx RAM usage for this cache. */
     size_t getMemoryUsed() const { return fMemoryUsed; }
 
+    /**
+     *  Add the glyph hits and misses counted since the last call to SkCounters.  Lookups only
+     *  bump our own counts; SkStrikeCache calls this when a strike is returned to it.
+     */
+    void flushCounters();
+
+    /** Glyphs that aren't cached yet are looked for in strike before they're generated. */
+    void setStoredStrike(SkGlyphStore::Strike strike) { fStoredStrike = std::move(strike); }
+    const SkGlyphStore::Strike& getStoredStrike() const { return fStoredStrike; }
+
+    /** Return the cached glyph, or nullptr. Its metrics may be incomplete. */
+    const SkGlyph* findGlyph(SkPackedGlyphID packedGlyphID) const {
+        return fGlyphMap.find(packedGlyphID);
+    }
+
+    /** Keep data alive as long as this strike, e.g. because glyph images point into it. */
+    void retainData(sk_sp<SkData> data) {
+        if (fRetainedData.empty() || fRetainedData.back() != data) {
+            fRetainedData.push_back(std::move(data));
+        }
+    }
+
+    /** Call visitor on every cached glyph. */
+    void forEachGlyph(const std::function<void(const SkGlyph&)>& visitor) const;
+
     void dump() const;
 
     SkScalerContext* getScalerContext() const { return fScalerContext.get(); }
@@ -197,12 +239,15 @@ private:
     static const SkGlyph::Intercept* MatchBounds(const SkGlyph* glyph,
                                                  const SkScalar bounds[2]);
 
+    // Make the images for glyphs in parallel, each task with its own copy of fScalerContext.
+    void generateImagesInParallel(const SkGlyph* glyphs[], int count, SkExecutor* executor);
+
     const SkAutoDescriptor fDesc;
     const std::unique_ptr<SkScalerContext> fScalerContext;
     SkPaint::FontMetrics   fFontMetrics;
 
     // Map from a combined GlyphID and sub-pixel position to a SkGlyph.
-    SkTHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits> fGlyphMap;
+    SkTFlatHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits> fGlyphMap;
 
     // so we don't grow our arrays a lot
     static constexpr size_t kMinGlyphCount = 8;
@@ -213,8 +258,18 @@ private:
 
     std::unique_ptr<CharGlyphRec[]> fPackedUnicharIDToPackedGlyphID;
 
+    // Memory that glyph images point into, other than fAlloc.
+    std::vector<sk_sp<SkData>> fRetainedData;
+
+    // Glyphs kept from an earlier run, see SkGlyphStore.
+    SkGlyphStore::Strike    fStoredStrike;
+
     // used to track (approx) how much ram is tied-up in this cache
     size_t                  fMemoryUsed;
+
+    // Lookups since the last flushCounters().
+    int                     fHits   = 0;
+    int                     fMisses = 0;
 };
 
 #endif  // SkGlyphCache_DEFINED
@@ -0,0 +1,474 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGlyphStore.h"
+
+#include "SkDescriptor.h"
+#include "SkFontDescriptor.h"
+#include "SkGlyphCache.h"
+#include "SkOpts.h"
+#include "SkPath.h"
+#include "SkScalerContext.h"
+#include "SkStream.h"
+#include "SkTypeface.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+// Stop taking new strikes once we're holding this much, so a long running process can't grow
+// the file (or our copy of it) without bound.
+static constexpr size_t kMaxAddedBytes = 64 * 1024 * 1024;
+
+static constexpr uint32_t kMagic   = SkSetFourByteTag('s', 'k', 'g', 's');
+static constexpr uint32_t kVersion = 1;
+
+static uint32_t hash_data(const SkData& data) { return SkOpts::hash(data.data(), data.size()); }
+
+// The file is a Header, then an array of StrikeEntry, then the keys and strikes they point to.
+struct SkGlyphStore::Header {
+    uint32_t fMagic;
+    uint32_t fVersion;
+    uint32_t fStrikeCount;
+    uint32_t fPad;
+};
+
+struct SkGlyphStore::StrikeEntry {
+    uint32_t fKeyHash;
+    uint32_t fKeyOffset;
+    uint32_t fKeySize;
+    uint32_t fDataOffset;
+    uint32_t fDataSize;
+    uint32_t fDataHash;   // checked before the strike is used
+};
+
+// A strike is a uint32_t count and padding, then count GlyphEntries sorted by packed ID, then
+// the images and paths they point to.  Offsets are from the start of the strike.
+struct SkGlyphStore::GlyphEntry {
+    enum PathState : uint8_t {
+        kUnknown_PathState,   // we never asked for the path
+        kNone_PathState,      // the glyph has no path
+        kStored_PathState,
+    };
+
+    uint32_t fPackedID;
+    float    fAdvanceX, fAdvanceY;
+    uint16_t fWidth, fHeight;
+    int16_t  fTop, fLeft;
+    uint8_t  fMaskFormat;
+    int8_t   fForceBW;
+    uint8_t  fPathState;
+    uint8_t  fPad;
+    uint32_t fImageOffset, fImageSize;
+    uint32_t fPathOffset, fPathSize;
+};
+
+static constexpr size_t kStrikeHeaderSize = 2 * sizeof(uint32_t);
+
+static bool in_bounds(uint32_t offset, uint32_t size, size_t total) {
+    return offset <= total && size <= total - offset;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const SkGlyphStore::GlyphEntry* SkGlyphStore::Strike::find(SkPackedGlyphID packedID) const {
+    const uint32_t id = packedID.getPackedID();
+    const GlyphEntry* end = fGlyphs + fCount;
+    const GlyphEntry* entry = std::lower_bound(fGlyphs, end, id,
+            [](const GlyphEntry& e, uint32_t id) { return e.fPackedID < id; });
+    return entry != end && entry->fPackedID == id ? entry : nullptr;
+}
+
+bool SkGlyphStore::Strike::findMetrics(SkGlyph* glyph) const {
+    const GlyphEntry* entry = this->find(glyph->getPackedID());
+    if (entry == nullptr) {
+        return false;
+    }
+    glyph->fAdvanceX   = entry->fAdvanceX;
+    glyph->fAdvanceY   = entry->fAdvanceY;
+    glyph->fWidth      = entry->fWidth;
+    glyph->fHeight     = entry->fHeight;
+    glyph->fTop        = entry->fTop;
+    glyph->fLeft       = entry->fLeft;
+    glyph->fForceBW    = entry->fForceBW;
+    glyph->fMaskFormat = entry->fMaskFormat;
+    return true;
+}
+
+bool SkGlyphStore::Strike::findImage(const SkGlyph& glyph) const {
+    const GlyphEntry* entry = this->find(glyph.getPackedID());
+    if (entry == nullptr || entry->fImageSize == 0 ||
+        entry->fWidth != glyph.fWidth || entry->fHeight != glyph.fHeight ||
+        entry->fMaskFormat != glyph.fMaskFormat ||
+        entry->fImageSize != glyph.computeImageSize()) {
+        return false;
+    }
+    memcpy(glyph.fImage, fData->bytes() + entry->fImageOffset, entry->fImageSize);
+    return true;
+}
+
+bool SkGlyphStore::Strike::findPath(SkPackedGlyphID packedID, SkPath* path, bool* hasPath) const {
+    const GlyphEntry* entry = this->find(packedID);
+    if (entry == nullptr || entry->fPathState == GlyphEntry::kUnknown_PathState) {
+        return false;
+    }
+    if (entry->fPathState == GlyphEntry::kNone_PathState) {
+        *hasPath = false;
+        return true;
+    }
+    if (path->readFromMemory(fData->bytes() + entry->fPathOffset, entry->fPathSize) !=
+        entry->fPathSize) {
+        path->reset();
+        return false;
+    }
+    *hasPath = true;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SkGlyphStore::SkGlyphStore(const char path[])
+    : fPath{path}
+    , fFile{SkData::MakeFromFileName(path)} {}
+
+SkGlyphStore::Strike SkGlyphStore::MakeStrike(sk_sp<SkData> strikeData) {
+    const size_t size = strikeData->size();
+    if (size < kStrikeHeaderSize ||
+        !SkIsAlign4(reinterpret_cast<uintptr_t>(strikeData->data()))) {
+        return Strike{};
+    }
+    uint32_t count;
+    memcpy(&count, strikeData->data(), sizeof(count));
+    if (count > (size - kStrikeHeaderSize) / sizeof(GlyphEntry)) {
+        return Strike{};
+    }
+
+    auto glyphs = reinterpret_cast<const GlyphEntry*>(strikeData->bytes() + kStrikeHeaderSize);
+    for (uint32_t i = 0; i < count; ++i) {
+        const GlyphEntry& entry = glyphs[i];
+        if ((i > 0 && glyphs[i - 1].fPackedID >= entry.fPackedID) ||
+            entry.fPathState > GlyphEntry::kStored_PathState ||
+            !in_bounds(entry.fImageOffset, entry.fImageSize, size) ||
+            !in_bounds(entry.fPathOffset, entry.fPathSize, size)) {
+            return Strike{};
+        }
+    }
+
+    Strike strike;
+    strike.fData   = std::move(strikeData);
+    strike.fGlyphs = glyphs;
+    strike.fCount  = SkToInt(count);
+    return strike;
+}
+
+sk_sp<SkData> SkGlyphStore::SerializeStrike(const SkGlyphCache& cache, const Strike& old) {
+    // Each glyph takes what it can from the cache, and the rest from what was stored before.
+    struct Source {
+        uint32_t          fPackedID;
+        const SkGlyph*    fGlyph;
+        const GlyphEntry* fOld;
+    };
+    std::vector<Source> sources;
+    cache.forEachGlyph([&](const SkGlyph& glyph) {
+        if (glyph.isFullMetrics()) {
+            sources.push_back({glyph.getPackedID().getPackedID(), &glyph,
+                               old.find(glyph.getPackedID())});
+        }
+    });
+    for (int i = 0; i < old.fCount; ++i) {
+        const GlyphEntry& entry = old.fGlyphs[i];
+        const SkGlyph* glyph = cache.findGlyph(SkPackedGlyphID(entry.fPackedID));
+        if (glyph == nullptr || !glyph->isFullMetrics()) {
+            sources.push_back({entry.fPackedID, nullptr, &entry});
+        }
+    }
+    if (sources.empty()) {
+        return nullptr;
+    }
+    std::sort(sources.begin(), sources.end(),
+              [](const Source& a, const Source& b) { return a.fPackedID < b.fPackedID; });
+
+    std::vector<GlyphEntry> entries(sources.size());
+    size_t size = kStrikeHeaderSize + entries.size() * sizeof(GlyphEntry);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const Source& src = sources[i];
+        GlyphEntry& entry = entries[i];
+        memset(&entry, 0, sizeof(entry));
+        entry.fPackedID = src.fPackedID;
+        if (const SkGlyph* glyph = src.fGlyph) {
+            entry.fAdvanceX   = glyph->fAdvanceX;
+            entry.fAdvanceY   = glyph->fAdvanceY;
+            entry.fWidth      = glyph->fWidth;
+            entry.fHeight     = glyph->fHeight;
+            entry.fTop        = glyph->fTop;
+            entry.fLeft       = glyph->fLeft;
+            entry.fMaskFormat = glyph->fMaskFormat;
+            entry.fForceBW    = glyph->fForceBW;
+        } else {
+            entry = *src.fOld;
+        }
+
+        const GlyphEntry* oldEntry = src.fOld;
+        if (src.fGlyph && src.fGlyph->fImage) {
+            entry.fImageSize = SkToU32(src.fGlyph->computeImageSize());
+        } else if (oldEntry && oldEntry->fWidth == entry.fWidth &&
+                   oldEntry->fHeight == entry.fHeight &&
+                   oldEntry->fMaskFormat == entry.fMaskFormat) {
+            entry.fImageSize = oldEntry->fImageSize;
+        } else {
+            entry.fImageSize = 0;
+        }
+        entry.fImageOffset = SkToU32(size);
+        size += SkAlign4(entry.fImageSize);
+
+        if (src.fGlyph && src.fGlyph->fPathData) {
+            const SkPath* path = src.fGlyph->fPathData->fPath;
+            entry.fPathState = path ? GlyphEntry::kStored_PathState
+                                    : GlyphEntry::kNone_PathState;
+            entry.fPathSize  = path ? SkToU32(path->writeToMemory(nullptr)) : 0;
+        } else if (oldEntry) {
+            entry.fPathState = oldEntry->fPathState;
+            entry.fPathSize  = oldEntry->fPathSize;
+        } else {
+            entry.fPathState = GlyphEntry::kUnknown_PathState;
+            entry.fPathSize  = 0;
+        }
+        entry.fPathOffset = SkToU32(size);
+        size += SkAlign4(entry.fPathSize);
+    }
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(size);
+    uint8_t* bytes = static_cast<uint8_t*>(data->writable_data());
+    memset(bytes, 0, size);
+    const uint32_t count = SkToU32(entries.size());
+    memcpy(bytes, &count, sizeof(count));
+    memcpy(bytes + kStrikeHeaderSize, entries.data(), entries.size() * sizeof(GlyphEntry));
+
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const Source& src = sources[i];
+        const GlyphEntry& entry = entries[i];
+        if (entry.fImageSize) {
+            const void* image = src.fGlyph && src.fGlyph->fImage
+                              ? src.fGlyph->fImage
+                              : old.fData->bytes() + src.fOld->fImageOffset;
+            memcpy(bytes + entry.fImageOffset, image, entry.fImageSize);
+        }
+        if (entry.fPathSize) {
+            if (src.fGlyph && src.fGlyph->fPathData) {
+                src.fGlyph->fPathData->fPath->writeToMemory(bytes + entry.fPathOffset);
+            } else {
+                memcpy(bytes + entry.fPathOffset,
+                       old.fData->bytes() + src.fOld->fPathOffset, entry.fPathSize);
+            }
+        }
+    }
+    return data;
+}
+
+sk_sp<SkData> SkGlyphStore::makeKey(const SkDescriptor& desc, const SkTypeface& typeface) {
+    sk_sp<SkData> prefix;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (sk_sp<SkData>* found = fKeyPrefixes.find(typeface.uniqueID())) {
+            prefix = *found;
+        } else {
+            // Identify the font by its contents (and variation), since font IDs are only good
+            // for this process.
+            std::unique_ptr<SkFontData> fontData = typeface.makeFontData();
+            if (fontData && fontData->hasStream()) {
+                sk_sp<SkData> contents = SkData::MakeFromStream(fontData->getStream(),
+                                                                fontData->getStream()->getLength());
+                if (contents) {
+                    const int axisCount = fontData->getAxisCount();
+                    SkDynamicMemoryWStream buffer;
+                    buffer.write32(SkOpts::hash(contents->data(), contents->size()));
+                    buffer.write32(SkToU32(contents->size()));
+                    buffer.write32(fontData->getIndex());
+                    buffer.write32(axisCount);
+                    buffer.write(fontData->getAxis(), axisCount * sizeof(SkFixed));
+                    prefix = buffer.detachAsData();
+                }
+            }
+            fKeyPrefixes.set(typeface.uniqueID(), prefix);
+        }
+    }
+    if (prefix == nullptr) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkDescriptor> copy = desc.copy();
+    auto rec = static_cast<SkScalerContextRec*>(
+            const_cast<void*>(copy->findEntry(kRec_SkDescriptorTag, nullptr)));
+    if (rec == nullptr) {
+        return nullptr;
+    }
+    rec->fFontID = 0;
+    copy->computeChecksum();
+
+    sk_sp<SkData> key = SkData::MakeUninitialized(prefix->size() + copy->getLength());
+    uint8_t* bytes = static_cast<uint8_t*>(key->writable_data());
+    memcpy(bytes, prefix->data(), prefix->size());
+    memcpy(bytes + prefix->size(), copy.get(), copy->getLength());
+    return key;
+}
+
+void SkGlyphStore::internalParseIndex() {
+    if (fIndexParsed) {
+        return;
+    }
+    fIndexParsed = true;
+    if (fFile == nullptr || fFile->size() < sizeof(Header)) {
+        return;
+    }
+
+    const size_t size = fFile->size();
+    Header header;
+    memcpy(&header, fFile->data(), sizeof(header));
+    if (header.fMagic != kMagic || header.fVersion != kVersion ||
+        header.fStrikeCount > (size - sizeof(Header)) / sizeof(StrikeEntry)) {
+        return;
+    }
+
+    auto entries = reinterpret_cast<const StrikeEntry*>(fFile->bytes() + sizeof(Header));
+    for (uint32_t i = 0; i < header.fStrikeCount; ++i) {
+        StrikeEntry entry;
+        memcpy(&entry, &entries[i], sizeof(entry));
+        if (!in_bounds(entry.fKeyOffset, entry.fKeySize, size) ||
+            !in_bounds(entry.fDataOffset, entry.fDataSize, size)) {
+            fFileStrikes.clear();
+            return;
+        }
+        fFileStrikes.push_back({entry.fKeyHash, entry.fDataHash,
+                                SkData::MakeSubset(fFile.get(), entry.fKeyOffset, entry.fKeySize),
+                                SkData::MakeSubset(fFile.get(), entry.fDataOffset,
+                                                   entry.fDataSize)});
+    }
+}
+
+const SkGlyphStore::Record* SkGlyphStore::Find(const std::vector<Record>& records,
+                                               uint32_t keyHash, const SkData& key) {
+    for (const Record& record : records) {
+        if (record.fKeyHash == keyHash && record.fKey->equals(&key)) {
+            return &record;
+        }
+    }
+    return nullptr;
+}
+
+SkGlyphStore::Strike SkGlyphStore::findStrike(const SkDescriptor& desc,
+                                              const SkTypeface& typeface) {
+    sk_sp<SkData> key = this->makeKey(desc, typeface);
+    if (key == nullptr) {
+        return Strike{};
+    }
+    const uint32_t keyHash = hash_data(*key);
+
+    sk_sp<SkData> data;
+    uint32_t dataHash;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        this->internalParseIndex();
+        const Record* record = Find(fAddedStrikes, keyHash, *key);
+        if (record == nullptr) {
+            record = Find(fFileStrikes, keyHash, *key);
+        }
+        if (record == nullptr) {
+            return Strike{};
+        }
+        data = record->fData;
+        dataHash = record->fDataHash;
+    }
+    // Only check the strikes we use, rather than the whole file up front.
+    if (hash_data(*data) != dataHash) {
+        return Strike{};
+    }
+    return MakeStrike(std::move(data));
+}
+
+void SkGlyphStore::add(const SkGlyphCache& cache) {
+    sk_sp<SkData> key = this->makeKey(cache.getDescriptor(),
+                                      *cache.getScalerContext()->getTypeface());
+    if (key == nullptr) {
+        return;
+    }
+    const uint32_t keyHash = hash_data(*key);
+
+    sk_sp<SkData> data = SerializeStrike(cache, cache.getStoredStrike());
+    if (data == nullptr) {
+        return;
+    }
+    const uint32_t dataHash = hash_data(*data);
+
+    SkAutoMutexAcquire lock(fMutex);
+    Record* record = const_cast<Record*>(Find(fAddedStrikes, keyHash, *key));
+    if (record != nullptr) {
+        fAddedBytes -= record->fData->size();
+        fAddedBytes += data->size();
+        record->fDataHash = dataHash;
+        record->fData     = std::move(data);
+    } else if (fAddedBytes + key->size() + data->size() <= kMaxAddedBytes) {
+        fAddedBytes += key->size() + data->size();
+        fAddedStrikes.push_back({keyHash, dataHash, std::move(key), std::move(data)});
+    }
+}
+
+bool SkGlyphStore::write() {
+    SkAutoMutexAcquire lock(fMutex);
+    this->internalParseIndex();
+
+    std::vector<const Record*> records;
+    for (const Record& record : fAddedStrikes) {
+        records.push_back(&record);
+    }
+    for (const Record& record : fFileStrikes) {
+        if (!Find(fAddedStrikes, record.fKeyHash, *record.fKey)) {
+            records.push_back(&record);
+        }
+    }
+
+    Header header = {kMagic, kVersion, SkToU32(records.size()), 0};
+    std::vector<StrikeEntry> entries(records.size());
+    size_t offset = sizeof(Header) + entries.size() * sizeof(StrikeEntry);
+    for (size_t i = 0; i < records.size(); ++i) {
+        StrikeEntry& entry = entries[i];
+        entry.fKeyHash    = records[i]->fKeyHash;
+        entry.fKeySize    = SkToU32(records[i]->fKey->size());
+        entry.fKeyOffset  = SkToU32(offset);
+        offset += SkAlign4(entry.fKeySize);
+        entry.fDataSize   = SkToU32(records[i]->fData->size());
+        entry.fDataHash   = records[i]->fDataHash;
+        entry.fDataOffset = SkToU32(offset);
+        offset += SkAlign4(entry.fDataSize);
+    }
+
+    // Write the new file beside the old one, and then put it in its place, so a reader never
+    // sees half a file.  fFile stays mapped to the old one until we're gone.
+    SkString tmpPath = SkStringPrintf("%s.tmp", fPath.c_str());
+    {
+        SkFILEWStream stream(tmpPath.c_str());
+        if (!stream.isValid()) {
+            return false;
+        }
+        bool ok = stream.write(&header, sizeof(header)) &&
+                  stream.write(entries.data(), entries.size() * sizeof(StrikeEntry));
+        for (size_t i = 0; ok && i < records.size(); ++i) {
+            const SkData& key  = *records[i]->fKey;
+            const SkData& data = *records[i]->fData;
+            ok = stream.write(key.data(), key.size()) &&
+                 stream.write("\0\0\0", SkAlign4(key.size()) - key.size()) &&
+                 stream.write(data.data(), data.size()) &&
+                 stream.write("\0\0\0", SkAlign4(data.size()) - data.size());
+        }
+        stream.flush();
+        if (!ok) {
+            return false;
+        }
+    }
+#if defined(SK_BUILD_FOR_WIN)
+    remove(fPath.c_str());
+#endif
+    return rename(tmpPath.c_str(), fPath.c_str()) == 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGlyphStore_DEFINED
+#define SkGlyphStore_DEFINED
+
+#include "SkData.h"
+#include "SkGlyph.h"
+#include "SkMutex.h"
+#include "SkRefCnt.h"
+#include "SkString.h"
+#include "SkTHash.h"
+
+#include <vector>
+
+class SkDescriptor;
+class SkGlyphCache;
+class SkPath;
+class SkTypeface;
+
+/** \class SkGlyphStore
+
+    A file of glyph metrics, images and paths, kept between runs so that a new process doesn't
+    have to rasterize the same glyphs again. Strikes are keyed by their descriptor (minus the
+    process specific font ID) and a hash of the typeface's font data, so the file can only ever
+    hand back glyphs made from the same font file with the same settings. Typefaces that can't
+    provide their font data with openStream() are never stored.
+
+    The file is memory mapped when the store is made, and only read as strikes ask for glyphs.
+    Strikes are added with add() as they leave the strike cache, and everything is written back
+    with write(). The file is in native byte order and is only meant to be read on the machine
+    that wrote it.
+*/
+class SkGlyphStore {
+    struct GlyphEntry;
+
+public:
+    explicit SkGlyphStore(const char path[]);
+
+    /** The stored glyphs for one strike. A default constructed Strike holds no glyphs. */
+    class Strike {
+    public:
+        Strike() = default;
+
+        explicit operator bool() const { return fCount > 0; }
+
+        /** Fill in glyph's full metrics. Returns false if they aren't stored. */
+        bool findMetrics(SkGlyph* glyph) const;
+
+        /** Copy the image into glyph.fImage, which must already be allocated. Returns false if
+            there's no image stored to match glyph. */
+        bool findImage(const SkGlyph& glyph) const;
+
+        /** Returns false if it's not known whether the glyph has a path. Otherwise sets
+            *hasPath, and if it's true, reads the path into *path. */
+        bool findPath(SkPackedGlyphID, SkPath* path, bool* hasPath) const;
+
+    private:
+        friend class SkGlyphStore;
+        const GlyphEntry* find(SkPackedGlyphID) const;
+
+        sk_sp<SkData>     fData;   // keeps the glyphs alive if the store replaces them
+        const GlyphEntry* fGlyphs{nullptr};
+        int               fCount{0};
+    };
+
+    /** Return the stored glyphs for the strike, if there are any. */
+    Strike findStrike(const SkDescriptor&, const SkTypeface&);
+
+    /** Remember all of cache's glyphs (and any stored glyphs it didn't use) for write(). */
+    void add(const SkGlyphCache& cache);
+
+    /** Write every strike we've added, and those we read and haven't replaced, to the file.
+        Returns false if the file can't be written. */
+    bool write();
+
+private:
+    struct Header;
+    struct StrikeEntry;
+
+    // The key for a strike, or nullptr if the typeface can't be stored.
+    sk_sp<SkData> makeKey(const SkDescriptor&, const SkTypeface&);
+    // The following methods can only be called when fMutex is already held.
+    void internalParseIndex();
+
+    // Returns an empty Strike if strikeData is malformed.
+    static Strike MakeStrike(sk_sp<SkData> strikeData);
+    static sk_sp<SkData> SerializeStrike(const SkGlyphCache&, const Strike& old);
+
+    struct Record {
+        uint32_t      fKeyHash;
+        uint32_t      fDataHash;
+        sk_sp<SkData> fKey;
+        sk_sp<SkData> fData;
+    };
+    static const Record* Find(const std::vector<Record>&, uint32_t keyHash, const SkData& key);
+
+    const SkString fPath;
+    const sk_sp<SkData> fFile;   // memory mapped, or null
+
+    SkMutex                             fMutex;   // guards everything below
+    bool                                fIndexParsed{false};
+    std::vector<Record>                 fFileStrikes;    // pointing into fFile
+    std::vector<Record>                 fAddedStrikes;
+    size_t                              fAddedBytes{0};
+    SkTHashMap<uint32_t, sk_sp<SkData>> fKeyPrefixes;    // by SkFontID; null if not storable
+};
+
+#endif  // SkGlyphStore_DEFINED
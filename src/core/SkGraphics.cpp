@@ -9,9 +9,11 @@
 
 #include "SkBlitter.h"
 #include "SkCanvas.h"
+#include "SkCounters.h"
 #include "SkCpu.h"
 #include "SkGeometry.h"
 #include "SkImageFilter.h"
+#include "SkImagePriv.h"
 #include "SkMath.h"
 #include "SkMatrix.h"
 #include "SkOpts.h"
@@ -55,10 +57,15 @@ void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkStrikeCache::DumpMemoryStatistics(dump);
 }
 
+void SkGraphics::DumpCounters(SkCounterDump* dump) {
+    SkCounters::Dump(dump);
+}
+
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter::PurgeCache();
+    SkSharedEncodedImageCache::Global()->purgeAll();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
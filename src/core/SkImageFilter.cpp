@@ -8,15 +8,19 @@
 #include "SkImageFilter.h"
 
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
+#include "SkExecutor.h"
 #include "SkFuzzLogging.h"
 #include "SkImageFilterCache.h"
 #include "SkLocalMatrixImageFilter.h"
 #include "SkMatrixImageFilter.h"
+#include "SkOpts.h"
 #include "SkReadBuffer.h"
 #include "SkRect.h"
 #include "SkSafe32.h"
 #include "SkSpecialImage.h"
 #include "SkSpecialSurface.h"
+#include "SkTaskGroup.h"
 #include "SkValidationUtils.h"
 #include "SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
@@ -28,6 +32,8 @@
 #include "SkGr.h"
 #endif
 
+#include <atomic>
+
 void SkImageFilter::CropRect::toString(SkString* str) const {
     if (!fFlags) {
         return;
@@ -228,6 +234,164 @@ sk_sp<SkSpecialImage> SkImageFilter::filterImage(SkSpecialImage* src, const Cont
     return result;
 }
 
+static int floor_to_multiple(int x, int m) {
+    int r = x % m;
+    return r < 0 ? x - r - m : x - r;
+}
+
+// Hashes the pixels of src within read, which is in src's space.
+static bool hash_src_pixels(SkSpecialImage* src, const SkIRect& read, uint64_t* hash) {
+    SkBitmap bm;
+    if (!src->getROPixels(&bm)) {
+        return false;
+    }
+    const SkIRect subset = read.makeOffset(src->subset().fLeft, src->subset().fTop);
+    const size_t rowBytes = subset.width() * bm.bytesPerPixel();
+    // Two seeds make a 64-bit hash, so a collision is too unlikely to hand back wrong pixels.
+    uint32_t lo = 0, hi = 0x9e3779b9;
+    for (int y = subset.fTop; y < subset.fBottom; ++y) {
+        const void* row = bm.getAddr(subset.fLeft, y);
+        lo = SkOpts::hash(row, rowBytes, lo);
+        hi = SkOpts::hash(row, rowBytes, hi);
+    }
+    *hash = (uint64_t)hi << 32 | lo;
+    return true;
+}
+
+sk_sp<SkSpecialImage> SkImageFilter::filterImageTiled(SkSpecialImage* src, const Context& context,
+                                                      SkIPoint* offset, SkExecutor* executor,
+                                                      int tileSize) const {
+    SkASSERT(src && offset && tileSize > 0);
+    const SkIRect& bounds = context.clipBounds();
+    const bool cacheTiles = context.cache() && context.cache()->tileSize() > 0;
+    if (cacheTiles) {
+        tileSize = context.cache()->tileSize();
+    }
+    if (src->isTextureBacked() || !context.isValid() || bounds.isEmpty() ||
+        (!cacheTiles && bounds.width() <= tileSize && bounds.height() <= tileSize)) {
+        // A single tile can still split its work into bands on the executor.
+        Context bandContext(context.ctm(), bounds, context.cache(), context.outputProperties(),
+                            executor ? executor : context.executor());
+        return this->filterImage(src, bandContext, offset);
+    }
+
+    sk_sp<SkSpecialSurface> surf(src->makeSurface(context.outputProperties(), bounds.size()));
+    if (!surf) {
+        return nullptr;
+    }
+    SkCanvas* canvas = surf->getCanvas();
+    canvas->clear(0x0);
+    SkPixmap dst;
+    if (!canvas->peekPixels(&dst)) {
+        return this->filterImage(src, context, offset);
+    }
+
+    // Each tile writes only its own pixels of dst, so the tiles need no locking. A tile's
+    // intermediate images are freed as soon as it is copied out.
+    //
+    // Cached tiles are filtered whole, on a grid anchored at the matrix's integer translation.
+    // They are keyed relative to that translation, and by the source pixels they read rather
+    // than the source's ID. Scrolling moves both the content and the translation by whole
+    // pixels, so a scrolled request, even one for a freshly drawn layer, finds the tiles whose
+    // input is unchanged.
+    SkIPoint shift = SkIPoint::Make(0, 0);
+    SkMatrix contentMatrix = context.ctm();
+    if (cacheTiles) {
+        shift = SkIPoint::Make(SkScalarFloorToInt(contentMatrix.getTranslateX()),
+                               SkScalarFloorToInt(contentMatrix.getTranslateY()));
+        contentMatrix.postTranslate(SkIntToScalar(-shift.fX), SkIntToScalar(-shift.fY));
+    }
+    const SkIPoint origin =
+            cacheTiles ? SkIPoint::Make(shift.fX + floor_to_multiple(bounds.fLeft - shift.fX,
+                                                                     tileSize),
+                                        shift.fY + floor_to_multiple(bounds.fTop - shift.fY,
+                                                                     tileSize))
+                       : SkIPoint::Make(bounds.fLeft, bounds.fTop);
+    const SkIRect srcBounds = SkIRect::MakeWH(src->width(), src->height());
+
+    // Looks the cell up in the cache, or filters it and adds it.
+    auto filterCachedCell = [&](const SkIRect& cell, SkIPoint* cellOffset) {
+        SkIRect read = SkIRect::MakeEmpty();
+        uint64_t contentHash = 0;
+        if (fUsesSrcInput) {
+            read = this->filterBounds(cell, context.ctm(), kReverse_MapDirection);
+            if (!read.intersect(srcBounds)) {
+                read.setEmpty();
+            } else if (!hash_src_pixels(src, read, &contentHash)) {
+                return sk_sp<SkSpecialImage>();
+            }
+            read.offset(-cell.fLeft, -cell.fTop);
+        }
+        SkImageFilterCacheKey key(fUniqueID, contentMatrix, cell.makeOffset(-shift.fX, -shift.fY),
+                                  SK_InvalidGenID, read, contentHash);
+        sk_sp<SkSpecialImage> result = context.cache()->get(key, cellOffset);
+        if (result) {
+            *cellOffset += shift;
+            return result;
+        }
+
+        // The cell is cached as a whole, so its nodes needn't cache their parts of it too.
+        Context cellContext(context.ctm(), cell, nullptr, context.outputProperties(),
+                            context.executor());
+        result = this->filterImage(src, cellContext, cellOffset);
+        if (result) {
+            context.cache()->set(key, result.get(), *cellOffset - shift, this);
+        }
+        return result;
+    };
+    const int cols = (bounds.fRight - origin.fX + tileSize - 1) / tileSize;
+    const int rows = (bounds.fBottom - origin.fY + tileSize - 1) / tileSize;
+    std::atomic<bool> drewAny{false};
+    auto filterTile = [&](int i) {
+        const SkIRect cell = SkIRect::MakeXYWH(origin.fX + (i % cols) * tileSize,
+                                               origin.fY + (i / cols) * tileSize,
+                                               tileSize, tileSize);
+        SkIRect tile = cell;
+        SkAssertResult(tile.intersect(bounds));
+
+        SkIPoint tileOffset = SkIPoint::Make(0, 0);
+        sk_sp<SkSpecialImage> result;
+        if (cacheTiles) {
+            result = filterCachedCell(cell, &tileOffset);
+        } else {
+            Context tileContext(context.ctm(), tile, context.cache(), context.outputProperties(),
+                                context.executor());
+            result = this->filterImage(src, tileContext, &tileOffset);
+        }
+        SkBitmap bm;
+        if (!result || !result->getROPixels(&bm)) {
+            return;
+        }
+
+        SkIRect covered = SkIRect::MakeXYWH(tileOffset.x(), tileOffset.y(),
+                                            result->width(), result->height());
+        SkPixmap dstTile;
+        if (!covered.intersect(tile) ||
+            !dst.extractSubset(&dstTile, covered.makeOffset(-bounds.fLeft, -bounds.fTop))) {
+            return;
+        }
+        if (bm.readPixels(dstTile, result->subset().fLeft + covered.fLeft - tileOffset.x(),
+                          result->subset().fTop + covered.fTop - tileOffset.y())) {
+            drewAny = true;
+        }
+    };
+    if (executor) {
+        SkTaskGroup tasks(*executor);
+        tasks.batch(cols * rows, filterTile);
+        tasks.wait();
+    } else {
+        for (int i = 0; i < cols * rows; ++i) {
+            filterTile(i);
+        }
+    }
+
+    if (!drewAny) {
+        return nullptr;
+    }
+    *offset = SkIPoint::Make(bounds.fLeft, bounds.fTop);
+    return surf->makeImageSnapshot();
+}
+
 SkIRect SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
                                  MapDirection direction) const {
     if (kReverse_MapDirection == direction) {
@@ -466,7 +630,7 @@ SkIRect SkImageFilter::onFilterNodeBounds(const SkIRect& src, const SkMatrix&, M
 SkImageFilter::Context SkImageFilter::mapContext(const Context& ctx) const {
     SkIRect clipBounds = this->onFilterNodeBounds(ctx.clipBounds(), ctx.ctm(),
                                                   MapDirection::kReverse_MapDirection);
-    return Context(ctx.ctm(), clipBounds, ctx.cache(), ctx.outputProperties());
+    return Context(ctx.ctm(), clipBounds, ctx.cache(), ctx.outputProperties(), ctx.executor());
 }
 
 sk_sp<SkImageFilter> SkImageFilter::MakeMatrixFilter(const SkMatrix& matrix,
@@ -499,6 +663,27 @@ sk_sp<SkSpecialImage> SkImageFilter::filterInput(int index,
     return result;
 }
 
+sk_sp<SkSpecialImage> SkImageFilter::filterInputFusingColorFilter(
+                                                 int index,
+                                                 SkSpecialImage* src,
+                                                 const Context& ctx,
+                                                 SkIPoint* offset,
+                                                 sk_sp<SkColorFilter>* colorFilter) const {
+    SkImageFilter* input = this->getInput(index);
+    SkColorFilter* inputCF;
+    if (input && input->isColorFilterNode(&inputCF)) {
+        colorFilter->reset(inputCF);
+        // A color filter node's output bounds are its input's, unless it affects transparent
+        // black, when they are the whole clip.
+        if (!inputCF->affectsTransparentBlack()) {
+            return input->filterInput(0, src, this->mapContext(ctx), offset);
+        }
+    }
+    colorFilter->reset();
+    return this->filterInput(index, src, ctx, offset);
+}
+
 void SkImageFilter::PurgeCache() {
     SkImageFilterCache::Get()->purge();
+    SkImageFilterCache::GetTiled()->purge();
 }
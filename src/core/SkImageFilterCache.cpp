@@ -30,7 +30,8 @@ namespace {
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
+    CacheImpl(size_t maxBytes, int tileSize)
+        : fMaxBytes(maxBytes), fCurrentBytes(0), fTileSize(tileSize) { }
     ~CacheImpl() override {
         SkTDynamicHash<Value, Key>::Iter iter(&fLookup);
 
@@ -119,6 +120,7 @@ public:
         fImageFilterValues.remove(filter);
     }
 
+    int tileSize() const override { return fTileSize; }
     SkDEBUGCODE(int count() const override { return fLookup.count(); })
 private:
     void removeInternal(Value* v) {
@@ -149,13 +151,14 @@ private:
     SkTHashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
     size_t                                                fMaxBytes;
     size_t                                                fCurrentBytes;
+    const int                                             fTileSize;
     mutable SkMutex                                       fMutex;
 };
 
 } // namespace
 
-SkImageFilterCache* SkImageFilterCache::Create(size_t maxBytes) {
-    return new CacheImpl(maxBytes);
+SkImageFilterCache* SkImageFilterCache::Create(size_t maxBytes, int tileSize) {
+    return new CacheImpl(maxBytes, tileSize);
 }
 
 SkImageFilterCache* SkImageFilterCache::Get() {
@@ -165,3 +168,11 @@ SkImageFilterCache* SkImageFilterCache::Get() {
     once([]{ cache = SkImageFilterCache::Create(kDefaultCacheSize); });
     return cache;
 }
+
+SkImageFilterCache* SkImageFilterCache::GetTiled() {
+    static SkOnce once;
+    static SkImageFilterCache* cache;
+
+    once([]{ cache = SkImageFilterCache::Create(kDefaultCacheSize, kDefaultTileSize); });
+    return cache;
+}
@@ -17,15 +17,18 @@ class SkSpecialImage;
 
 struct SkImageFilterCacheKey {
     SkImageFilterCacheKey(const uint32_t uniqueID, const SkMatrix& matrix,
-        const SkIRect& clipBounds, uint32_t srcGenID, const SkIRect& srcSubset)
+        const SkIRect& clipBounds, uint32_t srcGenID, const SkIRect& srcSubset,
+        uint64_t srcContentHash = 0)
         : fUniqueID(uniqueID)
         , fMatrix(matrix)
         , fClipBounds(clipBounds)
         , fSrcGenID(srcGenID)
-        , fSrcSubset(srcSubset) {
+        , fSrcSubset(srcSubset)
+        , fSrcContentHash(srcContentHash) {
         // Assert that Key is tightly-packed, since it is hashed.
         static_assert(sizeof(SkImageFilterCacheKey) == sizeof(uint32_t) + sizeof(SkMatrix) +
-                                     sizeof(SkIRect) + sizeof(uint32_t) + 4 * sizeof(int32_t),
+                                     sizeof(SkIRect) + sizeof(uint32_t) + 4 * sizeof(int32_t) +
+                                     sizeof(uint64_t),
                                      "image_filter_key_tight_packing");
         fMatrix.getType();  // force initialization of type, so hashes match
         SkASSERT(fMatrix.isFinite());   // otherwise we can't rely on == self when comparing keys
@@ -36,13 +39,17 @@ struct SkImageFilterCacheKey {
     SkIRect fClipBounds;
     uint32_t fSrcGenID;
     SkIRect fSrcSubset;
+    // Tiles cached by filterImageTiled() have no fSrcGenID. They name their source by a hash of
+    // the pixels they read from it instead, with fSrcSubset the part of it they read.
+    uint64_t fSrcContentHash;
 
     bool operator==(const SkImageFilterCacheKey& other) const {
         return fUniqueID == other.fUniqueID &&
                fMatrix == other.fMatrix &&
                fClipBounds == other.fClipBounds &&
                fSrcGenID == other.fSrcGenID &&
-               fSrcSubset == other.fSrcSubset;
+               fSrcSubset == other.fSrcSubset &&
+               fSrcContentHash == other.fSrcContentHash;
     }
 };
 
@@ -51,10 +58,18 @@ struct SkImageFilterCacheKey {
 class SkImageFilterCache : public SkRefCnt {
 public:
     enum { kDefaultTransientSize = 32 * 1024 * 1024 };
+    enum { kDefaultTileSize = 256 };
 
     virtual ~SkImageFilterCache() {}
-    static SkImageFilterCache* Create(size_t maxBytes);
+    // If tileSize is positive, devices filter images in tiles of that size through
+    // SkImageFilter::filterImageTiled(), and the cache keeps each tile by the source pixels it
+    // read. A request whose content overlaps an earlier one's, say after a scroll, then only
+    // filters the new tiles.
+    static SkImageFilterCache* Create(size_t maxBytes, int tileSize = 0);
     static SkImageFilterCache* Get();
+    // The cache of raster devices made with SkSurfaceProps::kCacheImageFilterTiles_Flag.
+    static SkImageFilterCache* GetTiled();
+    virtual int tileSize() const { return 0; }
     virtual sk_sp<SkSpecialImage> get(const SkImageFilterCacheKey& key, SkIPoint* offset) const = 0;
     virtual void set(const SkImageFilterCacheKey& key, SkSpecialImage* image,
                      const SkIPoint& offset, const SkImageFilter* filter) = 0;
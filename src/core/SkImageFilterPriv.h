@@ -9,6 +9,25 @@
 #define SkImageFilterPriv_DEFINED
 
 #include "SkImageFilter.h"
+#include "SkTaskGroup.h"
+
+#include <atomic>
+
+// If > 0, raster blurs with a sigma at least this large run at a resolution reduced by powers of
+// two until it's smaller than this there, and are scaled back up. The box passes then cover a
+// fraction of the pixels, but results differ from a full resolution blur (by up to 6/255 per
+// channel at 16, mostly from rounding the box sizes at the lower resolution), so it's off by
+// default.
+extern std::atomic<int> gSkRasterBlurDownsampleSigma;
+
+/**
+ *  SkBlurImageFilter's raster blur, downsampling sigmas of at least downsampleSigma instead of
+ *  gSkRasterBlurDownsampleSigma. Blurs input's pixels within srcBounds into an image covering
+ *  dstBounds, both relative to input. srcBounds must lie within dstBounds. For tests.
+ */
+sk_sp<SkSpecialImage> SkRasterBlurForTesting(SkVector sigma, int downsampleSigma,
+                                             const sk_sp<SkSpecialImage>& input,
+                                             const SkIRect& srcBounds, const SkIRect& dstBounds);
 
 /**
  *  Helper to unflatten the common data, and return nullptr if we fail.
@@ -21,4 +40,23 @@
         }                                                           \
     } while (0)
 
+/**
+ *  Calls fn(start, end) on bands of lines that together cover [0, count), in parallel on the
+ *  executor if there is one. Raster filters use it to split the rows (or columns) of their
+ *  output, so each band must write only its own lines.
+ */
+template <typename Fn>
+void SkImageFilterForEachBand(SkExecutor* executor, int count, Fn&& fn) {
+    static constexpr int kBandLines = 32;
+    if (!executor || count <= kBandLines) {
+        fn(0, count);
+        return;
+    }
+    SkTaskGroup tasks(*executor);
+    tasks.batch((count + kBandLines - 1) / kBandLines, [&](int i) {
+        fn(i * kBandLines, SkTMin((i + 1) * kBandLines, count));
+    });
+    tasks.wait();
+}
+
 #endif
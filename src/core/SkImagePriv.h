@@ -11,6 +11,11 @@
 #include "SkImage.h"
 #include "SkSurface.h"
 
+#include <atomic>
+#include <memory>
+
+class SkImageGenerator;
+
 enum SkCopyPixelsMode {
     kIfMutable_SkCopyPixelsMode,  //!< only copy src pixels if they are marked mutable
     kAlways_SkCopyPixelsMode,     //!< always copy src pixels (even if they are marked immutable)
@@ -83,4 +88,38 @@ void SkImage_unpinAsTexture(const SkImage*, GrContext*);
  */
 sk_sp<SkImage> SkImageMakeRasterCopyAndAssignColorSpace(const SkImage*, SkColorSpace*);
 
+/**
+ *  Makes lazy images from encoded bytes that share their generator (and so their unique ID and
+ *  cached decodes) with other images it made from the same bytes, while those are among the last
+ *  count limit distinct bytes seen. SkImage::MakeFromEncoded() uses Global() when its limit,
+ *  SkGraphics::GetSharedEncodedImageCountLimit(), is above zero.
+ */
+class SkSharedEncodedImageCache {
+public:
+    using Factory = std::unique_ptr<SkImageGenerator> (*)(sk_sp<SkData>);
+
+    /** Makes generators with factory, or SkImageGenerator::MakeFromEncoded() if it is null. */
+    explicit SkSharedEncodedImageCache(int countLimit, Factory factory = nullptr);
+    ~SkSharedEncodedImageCache();
+
+    static SkSharedEncodedImageCache* Global();
+
+    sk_sp<SkImage> makeImage(sk_sp<SkData> encoded, const SkIRect* subset);
+
+    int getCountLimit() const { return fCountLimit.load(std::memory_order_relaxed); }
+
+    /** Empties the cache, and returns the previous limit. Zero shares nothing. */
+    int setCountLimit(int count);
+
+    /** Forgets all the bytes seen so far. Images already made keep their generators. */
+    void purgeAll();
+
+private:
+    struct Entries;
+
+    std::unique_ptr<Entries> fEntries;
+    std::atomic<int>         fCountLimit;
+    const Factory            fFactory;
+};
+
 #endif
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkLazyPicture.h"
+#include "SkPictureData.h"
+#include "SkStream.h"
+
+// A serialized op is at least its op/size word plus an argument or two, so this doesn't
+// underestimate by much.
+static constexpr size_t kMinBytesPerOp = 16;
+
+sk_sp<SkLazyPicture> SkLazyPicture::Make(sk_sp<SkData> data, const SkDeserialProcs& procs,
+                                         const SkTypefacePlayback& typefaces) {
+    SkMemoryStream stream(data);
+    SkPictInfo info;
+    if (!StreamIsSKP(&stream, &info)) {
+        return nullptr;
+    }
+
+    // The op data is the first tag after the trailing byte and an optional align tag.
+    size_t opBytes = 0;
+    (void)stream.readU8();
+    for (int i = 0; i < 2; ++i) {
+        uint32_t tag = stream.readU32();
+        uint32_t size = stream.readU32();
+        if (SK_PICT_READER_TAG == tag) {
+            opBytes = size;
+            break;
+        }
+        if (SK_PICT_ALIGN_TAG != tag || stream.skip(size) != size) {
+            break;
+        }
+    }
+
+    // SkCanvas unrolls pictures with a single op, which would parse this one while it is
+    // recorded, so report at least two until we know better.
+    int opCountEstimate = SkTMax<int>(2, SkToInt(opBytes / kMinBytesPerOp));
+    return sk_sp<SkLazyPicture>(new SkLazyPicture(info.fCullRect, opCountEstimate,
+                                                  std::move(data), procs, typefaces));
+}
+
+SkLazyPicture::SkLazyPicture(const SkRect& cull, int opCountEstimate, sk_sp<SkData> data,
+                             const SkDeserialProcs& procs, const SkTypefacePlayback& typefaces)
+    : fCullRect(cull)
+    , fOpCountEstimate(opCountEstimate)
+    , fData(std::move(data))
+    , fProcs(procs) {
+    fTypefaces.setCount(typefaces.count());
+    for (int i = 0; i < typefaces.count(); ++i) {
+        fTypefaces.set(i, typefaces.get(i));
+    }
+}
+
+const SkPicture* SkLazyPicture::picture() const {
+    fParseOnce([this] {
+        SkMemoryStream stream(fData);
+        fPicture = SkPicture::MakeFromStream(&stream, &fProcs,
+                                             const_cast<SkTypefacePlayback*>(&fTypefaces));
+        fParsed.store(true, std::memory_order_release);
+    });
+    return fPicture.get();
+}
+
+void SkLazyPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    if (const SkPicture* picture = this->picture()) {
+        picture->playback(canvas, callback);
+    }
+}
+
+int SkLazyPicture::approximateOpCount() const {
+    if (this->isParsed()) {
+        return fPicture ? fPicture->approximateOpCount() : 0;
+    }
+    return fOpCountEstimate;
+}
+
+size_t SkLazyPicture::approximateBytesUsed() const {
+    size_t bytes = sizeof(*this) + fData->size();
+    if (this->isParsed() && fPicture) {
+        bytes += fPicture->approximateBytesUsed();
+    }
+    return bytes;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLazyPicture_DEFINED
+#define SkLazyPicture_DEFINED
+
+#include "SkData.h"
+#include "SkOnce.h"
+#include "SkPicture.h"
+#include "SkPictureFlat.h"
+#include "SkRect.h"
+#include "SkSerialProcs.h"
+
+#include <atomic>
+
+// A sub-picture read with SkDeserialProcs::fLazyPictures. It keeps the serialized picture and
+// parses it the first time it is played back, so nested pictures that are culled never are.
+class SkLazyPicture final : public SkPicture {
+public:
+    // Returns null if 'data' doesn't start with a valid picture header.
+    static sk_sp<SkLazyPicture> Make(sk_sp<SkData>, const SkDeserialProcs&,
+                                     const SkTypefacePlayback&);
+
+// SkPicture overrides
+    void playback(SkCanvas*, AbortCallback*) const override;
+    SkRect cullRect() const override { return fCullRect; }
+    // Until the picture is parsed, this is estimated from the size of the serialized ops.
+    int approximateOpCount() const override;
+    size_t approximateBytesUsed() const override;
+
+    bool isParsed() const { return fParsed.load(std::memory_order_acquire); }
+
+private:
+    SkLazyPicture(const SkRect& cull, int opCountEstimate, sk_sp<SkData>, const SkDeserialProcs&,
+                  const SkTypefacePlayback&);
+
+    // Parses the picture on first use. Returns null if it can't be parsed.
+    const SkPicture* picture() const;
+
+    const SkRect             fCullRect;
+    const int                fOpCountEstimate;
+    const sk_sp<SkData>      fData;
+    const SkDeserialProcs    fProcs;
+    SkTypefacePlayback       fTypefaces;
+
+    mutable SkOnce           fParseOnce;
+    mutable sk_sp<SkPicture> fPicture;
+    mutable std::atomic<bool> fParsed{false};
+
+    typedef SkPicture INHERITED;
+};
+
+#endif//SkLazyPicture_DEFINED
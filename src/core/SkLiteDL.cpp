@@ -16,6 +16,7 @@
 #include "SkPicture.h"
 #include "SkRegion.h"
 #include "SkRSXform.h"
+#include "SkTHash.h"
 #include "SkTextBlob.h"
 #include "SkVertices.h"
 
@@ -507,6 +508,9 @@ namespace {
 
 template <typename T, typename... Args>
 void* SkLiteDL::push(size_t pod, Args&&... args) {
+    if (fCompiled) {
+        this->uncompile();
+    }
     size_t skip = SkAlignPtr(sizeof(T) + pod);
     SkASSERT(skip < (1<<24));
     if (fUsed + skip > fReserved) {
@@ -719,9 +723,79 @@ static const draw_fn draw_fns[] = { TYPES(M) };
 static const void_fn dtor_fns[] = { TYPES(M) };
 #undef M
 
+// The paint a draw op draws with, if its paint could make it draw nothing.  SaveLayer's paint is
+// applied when the layer is restored, so it is left to the canvas.
+template <typename T>
+static auto draw_paint(const T* op, int) -> decltype(&op->paint) { return &op->paint; }
+template <typename T>
+static const SkPaint* draw_paint(const T*, ...) { return nullptr; }
+
+static const SkPaint* draw_paint(const SaveLayer*, int) { return nullptr; }
+static const SkPaint* draw_paint(const DrawPicture* op, int) {
+    return op->has_paint ? &op->paint : nullptr;
+}
+
+#define M(T) [](const void* op) { return draw_paint((const T*)op, 0); },
+static const SkPaint*(* const paint_fns[])(const void*) = { TYPES(M) };
+#undef M
+
+namespace {
+    struct PaintHash {
+        uint32_t operator()(const SkPaint& paint) const { return paint.getHash(); }
+    };
+}
+
+void SkLiteDL::compile() {
+    this->uncompile();
+
+    // Draws with equal paints share their nothingToDraw() answer.
+    SkTHashMap<SkPaint, bool, PaintHash> nothingToDraw;
+    // A draw filter may change the paints after it, so we can't skip anything.
+    bool filtered = false;
+    auto end = fBytes.get() + fUsed;
+    for (const uint8_t* ptr = fBytes.get(); ptr < end; ) {
+        auto op = (const Op*)ptr;
+        ptr += op->skip;
+
+        filtered |= (op->type == (uint32_t)Type::SetDrawFilter);
+        const SkPaint* paint = paint_fns[op->type](op);
+        if (paint && !filtered) {
+            bool* skip = nothingToDraw.find(*paint);
+            if (!skip) {
+                skip = nothingToDraw.set(*paint, paint->nothingToDraw());
+            }
+            if (*skip) {
+                fCompiledSkippedDraws++;
+                continue;
+            }
+        }
+        if (draw_fns[op->type]) {
+            *fCompiledOps.append() = { draw_fns[op->type],
+                                       SkToU32((const uint8_t*)op - fBytes.get()) };
+        }
+    }
+    fCompiledPaintCount = nothingToDraw.count();
+    fCompiled = true;
+}
+
+void SkLiteDL::uncompile() {
+    fCompiledOps.reset();
+    fCompiled = false;
+    fCompiledPaintCount = 0;
+    fCompiledSkippedDraws = 0;
+}
+
 void SkLiteDL::draw(SkCanvas* canvas) const {
     SkAutoCanvasRestore acr(canvas, false);
-    this->map(draw_fns, canvas, canvas->getTotalMatrix());
+    const SkMatrix original = canvas->getTotalMatrix();
+    if (fCompiled) {
+        const uint8_t* bytes = fBytes.get();
+        for (const CompiledOp& op : fCompiledOps) {
+            op.fDraw(bytes + op.fOffset, canvas, original);
+        }
+        return;
+    }
+    this->map(draw_fns, canvas, original);
 }
 
 SkLiteDL::~SkLiteDL() {
@@ -729,6 +803,7 @@ SkLiteDL::~SkLiteDL() {
 }
 
 void SkLiteDL::reset() {
+    this->uncompile();
     this->map(dtor_fns);
 
     // Leave fBytes and fReserved alone.
@@ -25,6 +25,17 @@ public:
     void reset();
     bool empty() const { return fUsed == 0; }
 
+    // An optional step once recording is done.  Finds the distinct paints of the recorded draws
+    // and works out once per paint whether it can draw anything at all.  draw() then replays
+    // from a compact list of ops with their draw functions resolved, leaving out the draws that
+    // can't draw.  Anything that depends on the destination, like the raster blitter, is still
+    // chosen per draw by the canvas.  Recording more ops undoes this.
+    void compile();
+    bool isCompiled() const { return fCompiled; }
+    // The number of distinct paints found by compile(), and the draws it left out.
+    int compiledPaintCount() const { return fCompiledPaintCount; }
+    int compiledSkippedDraws() const { return fCompiledSkippedDraws; }
+
 #ifdef SK_SUPPORT_LEGACY_DRAWFILTER
     void setDrawFilter(SkDrawFilter*);
 #endif
@@ -88,9 +99,22 @@ private:
     template <typename Fn, typename... Args>
     void map(const Fn[], Args...) const;
 
+    void uncompile();
+
+    typedef void(*DrawFn)(const void*, SkCanvas*, const SkMatrix&);
+    struct CompiledOp {
+        DrawFn   fDraw;
+        uint32_t fOffset;  // Of the op in fBytes, which may move when it grows.
+    };
+
     SkAutoTMalloc<uint8_t> fBytes;
     size_t                 fUsed = 0;
     size_t                 fReserved = 0;
+
+    SkTDArray<CompiledOp>  fCompiledOps;
+    bool                   fCompiled = false;
+    int                    fCompiledPaintCount = 0;
+    int                    fCompiledSkippedDraws = 0;
 };
 
 #endif//SkLiteDL_DEFINED
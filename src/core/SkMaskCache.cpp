@@ -10,6 +10,9 @@
 #define CHECK_LOCAL(localCache, localName, globalName, ...) \
     ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
 
+// Blurring writes each pixel of the mask several times, after drawing the shape to blur.
+static constexpr size_t kBlurCostPerByte = 8;
+
 struct MaskValue {
     SkMask          fMask;
     SkCachedData*   fData;
@@ -51,6 +54,8 @@ struct RRectBlurRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    size_t regenerationCost() const override { return kBlurCostPerByte * fValue.fData->size(); }
+    bool canBeFoundConcurrently() const override { return true; }
     const char* getCategory() const override { return "rrect-blur"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fValue.fData->diagnostic_only_getDiscardable();
@@ -142,6 +147,8 @@ struct RectsBlurRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    size_t regenerationCost() const override { return kBlurCostPerByte * fValue.fData->size(); }
+    bool canBeFoundConcurrently() const override { return true; }
     const char* getCategory() const override { return "rects-blur"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fValue.fData->diagnostic_only_getDiscardable();
@@ -183,3 +190,71 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style,
     RectsBlurKey key(sigma, style, rects, count);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gBlurProfileKeyNamespaceLabel;
+
+struct BlurProfileKey : public SkResourceCache::Key {
+public:
+    explicit BlurProfileKey(SkScalar sigma) : fSigma(sigma) {
+        this->init(&gBlurProfileKeyNamespaceLabel, 0, sizeof(fSigma));
+    }
+
+    SkScalar    fSigma;
+};
+
+struct BlurProfileRec : public SkResourceCache::Rec {
+    BlurProfileRec(BlurProfileKey key, SkCachedData* data)
+        : fKey(key)
+        , fData(data)
+    {
+        fData->attachToCacheAndRef();
+    }
+    ~BlurProfileRec() override {
+        fData->detachFromCacheAndUnref();
+    }
+
+    BlurProfileKey fKey;
+    SkCachedData*  fData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+    // Each entry is an integral of the gaussian, and there are few of them.
+    size_t regenerationCost() const override { return 4 * kBlurCostPerByte * fData->size(); }
+    bool canBeFoundConcurrently() const override { return true; }
+    const char* getCategory() const override { return "blur-profile"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const BlurProfileRec& rec = static_cast<const BlurProfileRec&>(baseRec);
+        SkCachedData** result = static_cast<SkCachedData**>(contextData);
+
+        SkCachedData* tmpData = rec.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = tmpData;
+        return true;
+    }
+};
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRefProfile(SkScalar sigma, SkResourceCache* localCache) {
+    SkCachedData* result = nullptr;
+    BlurProfileKey key(sigma);
+    if (!CHECK_LOCAL(localCache, find, Find, key, BlurProfileRec::Visitor, &result)) {
+        return nullptr;
+    }
+    return result;
+}
+
+void SkMaskCache::AddProfile(SkScalar sigma, SkCachedData* data, SkResourceCache* localCache) {
+    BlurProfileKey key(sigma);
+    return CHECK_LOCAL(localCache, add, Add, new BlurProfileRec(key, data));
+}
@@ -39,6 +39,18 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
+
+    /**
+     * The blurred half-plane profile for sigma, as made by SkBlurMask::ComputeBlurProfile().
+     * Returns a ref to the SkCachedData holding it, or nullptr if it isn't cached.
+     */
+    static SkCachedData* FindAndRefProfile(SkScalar sigma, SkResourceCache* localCache = nullptr);
+
+    /**
+     * Add the profile for sigma to the cache.
+     */
+    static void AddProfile(SkScalar sigma, SkCachedData* data,
+                           SkResourceCache* localCache = nullptr);
 };
 
 #endif
@@ -129,10 +129,6 @@ static void draw_nine_clipped(const SkMask& mask, const SkIRect& outerR,
                outerR.top() + cy - mask.fBounds.top(),
                outerR.right() + (cx + 1 - mask.fBounds.right()),
                outerR.bottom() + (cy + 1 - mask.fBounds.bottom()));
-    if (fillCenter) {
-        blitClippedRect(blitter, innerR, clipR);
-    }
-
     const int innerW = innerR.width();
     size_t storageSize = (innerW + 1) * (sizeof(int16_t) + sizeof(uint8_t));
     SkAutoSMalloc<4*1024> storage(storageSize);
@@ -140,6 +136,22 @@ static void draw_nine_clipped(const SkMask& mask, const SkIRect& outerR,
     uint8_t* alpha = (uint8_t*)(runs + innerW + 1);
 
     SkIRect r;
+    if (fillCenter) {
+        // The center usually covers everything, but a patch that doesn't stretch in one
+        // direction (see SkBlurMaskFilterImpl::filterRRectToNine) may have any value there.
+        const uint8_t centerAlpha = *mask.getAddr8(cx, cy);
+        if (0xFF == centerAlpha) {
+            blitClippedRect(blitter, innerR, clipR);
+        } else if (centerAlpha && r.intersect(innerR, clipR)) {
+            for (int y = r.top(); y < r.bottom(); ++y) {
+                runs[0] = r.width();
+                runs[r.width()] = 0;
+                alpha[0] = centerAlpha;
+                blitter->blitAntiH(r.left(), y, alpha, runs);
+            }
+        }
+    }
+
     // top
     r.set(innerR.left(), outerR.top(), innerR.right(), innerR.top());
     if (r.intersect(clipR)) {
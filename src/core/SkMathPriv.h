@@ -136,6 +136,16 @@ int SkCLZ_portable(uint32_t);
     #endif
 #endif
 
+//! Returns the number of trailing zero bits (0...32)
+static inline int SkCTZ(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    // __builtin_ctz(0) is undefined, so we have to detect that case.
+    return mask ? __builtin_ctz(mask) : 32;
+#else
+    return mask ? 31 - SkCLZ(mask & (0 - mask)) : 32;
+#endif
+}
+
 /**
  *  Returns the smallest power-of-2 that is >= the specified value. If value
  *  is already a power of 2, then it is returned unchanged. It is undefined
@@ -14,8 +14,11 @@
 #include "SkNx.h"
 #include "SkPM4fPriv.h"
 #include "SkSRGB.h"
+#include "SkTaskGroup.h"
 #include "SkTypes.h"
 
+std::atomic<bool> gSkBuildMipMapsLazily{false};
+
 //
 // ColorTypeFilter is the "Type" we pass to some downsample template functions.
 // It controls how we expand a pixel into a large type, with space between each component,
@@ -472,6 +475,10 @@ void downsample_2_3_srgb(void* dst, const void* src, size_t srcRB, int count) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Levels of at least this many pixels are filtered in bands of this many rows, in parallel.
+static constexpr int kParallelPixels = 256 * 1024;
+static constexpr int kBandRows = 64;
+
 size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     if (levelCount < 0) {
         return 0;
@@ -484,7 +491,7 @@ size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
 }
 
 SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDestinationSurfaceColorMode colorMode,
-                          SkDiscardableFactoryProc fact) {
+                          SkDiscardableFactoryProc fact, int maxLevelCount) {
     typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
 
     FilterProc* proc_1_2 = nullptr;
@@ -576,8 +583,11 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDestinationSurfaceColorMode col
     }
     // whip through our loop to compute the exact size needed
     size_t size = 0;
-    int countLevels = ComputeLevelCount(src.width(), src.height());
-    for (int currentMipLevel = countLevels; currentMipLevel >= 0; currentMipLevel--) {
+    int countLevels = SkTMin(ComputeLevelCount(src.width(), src.height()), maxLevelCount);
+    if (countLevels < 1) {
+        return nullptr;
+    }
+    for (int currentMipLevel = countLevels - 1; currentMipLevel >= 0; currentMipLevel--) {
         SkISize mipSize = ComputeLevelSize(src.width(), src.height(), currentMipLevel);
         size += SkColorTypeMinRowBytes(ct, mipSize.fWidth) * mipSize.fHeight;
     }
@@ -659,10 +669,25 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDestinationSurfaceColorMode col
         void* dstBasePtr = dstPM.writable_addr();
 
         const size_t srcRB = srcPM.rowBytes();
-        for (int y = 0; y < height; y++) {
-            proc(dstBasePtr, srcBasePtr, srcRB, width);
-            srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-            dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+        auto filterRows = [&](int top, int bottom) {
+            auto srcPtr = (const char*)srcBasePtr + srcRB * 2 * top;  // two src rows per dst row
+            auto dstPtr = (char*)dstBasePtr + dstPM.rowBytes() * top;
+            for (int y = top; y < bottom; y++) {
+                proc(dstPtr, srcPtr, srcRB, width);
+                srcPtr += srcRB * 2;
+                dstPtr += dstPM.rowBytes();
+            }
+        };
+
+        // Each band reads only the src rows of its own dst rows, and the one shared below them.
+        if (width * height < kParallelPixels) {
+            filterRows(0, height);
+        } else {
+            SkTaskGroup tasks;
+            tasks.batch((height + kBandRows - 1) / kBandRows, [&](int band) {
+                filterRows(band * kBandRows, SkTMin((band + 1) * kBandRows, height));
+            });
+            tasks.wait();
         }
         srcPM = dstPM;
         addr += height * rowBytes;
@@ -730,13 +755,7 @@ SkISize SkMipMap::ComputeLevelSize(int baseWidth, int baseHeight, int level) {
     return SkISize::Make(width, height);
 }
 
-///////////////////////////////////////////////////////////////////////////////
-
-bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
-    if (nullptr == fLevels) {
-        return false;
-    }
-
+int SkMipMap::ComputeLevelCountForScale(const SkSize& scaleSize) {
     SkASSERT(scaleSize.width() >= 0 && scaleSize.height() >= 0);
 
 #ifndef SK_SUPPORT_LEGACY_ANISOTROPIC_MIPMAP_SCALE
@@ -750,17 +769,28 @@ bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
 #endif
 
     if (scale >= SK_Scalar1 || scale <= 0 || !SkScalarIsFinite(scale)) {
-        return false;
+        return 0;
     }
 
     SkScalar L = -SkScalarLog2(scale);
     if (!SkScalarIsFinite(L)) {
-        return false;
+        return 0;
     }
     SkASSERT(L >= 0);
     int level = SkScalarFloorToInt(L);
 
     SkASSERT(level >= 0);
+    return level;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
+    if (nullptr == fLevels) {
+        return false;
+    }
+
+    int level = ComputeLevelCountForScale(scaleSize);
     if (level <= 0) {
         return false;
     }
@@ -779,12 +809,12 @@ bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
 // Helper which extracts a pixmap from the src bitmap
 //
 SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDestinationSurfaceColorMode colorMode,
-                          SkDiscardableFactoryProc fact) {
+                          SkDiscardableFactoryProc fact, int maxLevelCount) {
     SkPixmap srcPixmap;
     if (!src.peekPixels(&srcPixmap)) {
         return nullptr;
     }
-    return Build(srcPixmap, colorMode, fact);
+    return Build(srcPixmap, colorMode, fact, maxLevelCount);
 }
 
 int SkMipMap::countLevels() const {
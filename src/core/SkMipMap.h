@@ -15,11 +15,17 @@
 #include "SkSize.h"
 #include "SkShaderBase.h"
 
+#include <atomic>
+
 class SkBitmap;
 class SkDiscardableMemory;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
 
+// If true, raster draws build mipmaps only down to the level they sample, and build them again
+// when a later draw needs a smaller level.
+extern std::atomic<bool> gSkBuildMipMapsLazily;
+
 /*
  * SkMipMap will generate mipmap levels when given a base mipmap level image.
  *
@@ -29,10 +35,12 @@ typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
  */
 class SkMipMap : public SkCachedData {
 public:
+    // Builds at most maxLevelCount levels. Large levels are filtered in bands of rows, in
+    // parallel on SkExecutor::GetDefault().
     static SkMipMap* Build(const SkPixmap& src, SkDestinationSurfaceColorMode,
-                           SkDiscardableFactoryProc);
+                           SkDiscardableFactoryProc, int maxLevelCount = SK_MaxS32);
     static SkMipMap* Build(const SkBitmap& src, SkDestinationSurfaceColorMode,
-                           SkDiscardableFactoryProc);
+                           SkDiscardableFactoryProc, int maxLevelCount = SK_MaxS32);
 
     static SkDestinationSurfaceColorMode DeduceColorMode(const SkShaderBase::ContextRec& rec) {
         return (SkShaderBase::ContextRec::kPMColor_DstType == rec.fPreferredDstType)
@@ -50,6 +58,10 @@ public:
     // the base level. So index 0 represents mipmap level 1.
     static SkISize ComputeLevelSize(int baseWidth, int baseHeight, int level);
 
+    // Determines how many levels a SkMipMap needs for extractLevel() to return the level it
+    // would pick for scale from a complete SkMipMap. Returns 0 if it would use the base level.
+    static int ComputeLevelCountForScale(const SkSize& scale);
+
     struct Level {
         SkPixmap    fPixmap;
         SkSize      fScale; // < 1.0
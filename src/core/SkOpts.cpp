@@ -38,7 +38,9 @@
 
 #include "SkBlitMask_opts.h"
 #include "SkBlitRow_opts.h"
+#include "SkBlurImageFilter_opts.h"
 #include "SkChecksum_opts.h"
+#include "SkCoverageDelta_opts.h"
 #include "SkMorphologyImageFilter_opts.h"
 #include "SkRasterPipeline_opts.h"
 #include "SkSwizzler_opts.h"
@@ -58,6 +60,9 @@ namespace SkOpts {
     DEFINE_DEFAULT( erode_x);
     DEFINE_DEFAULT( erode_y);
 
+    DEFINE_DEFAULT(blur_downsample_row);
+    DEFINE_DEFAULT(blur_upsample_row);
+
     DEFINE_DEFAULT(blit_mask_d32_a8);
 
     DEFINE_DEFAULT(blit_row_color32);
@@ -73,11 +78,23 @@ namespace SkOpts {
     DEFINE_DEFAULT(grayA_to_rgbA);
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
+    DEFINE_DEFAULT(RGB16_to_RGB1);
+    DEFINE_DEFAULT(RGB16_to_BGR1);
+    DEFINE_DEFAULT(RGBA16_to_RGBA);
+    DEFINE_DEFAULT(RGBA16_to_BGRA);
+    DEFINE_DEFAULT(rgbA_to_RGBA);
+    DEFINE_DEFAULT(rgbA_to_BGRA);
+
+    DEFINE_DEFAULT(coverage_to_alpha);
 
     DEFINE_DEFAULT(memset16);
     DEFINE_DEFAULT(memset32);
     DEFINE_DEFAULT(memset64);
 
+    DEFINE_DEFAULT(rect_memset16);
+    DEFINE_DEFAULT(rect_memset32);
+    DEFINE_DEFAULT(rect_memset64);
+
     DEFINE_DEFAULT(hash_fn);
 
 #undef DEFINE_DEFAULT
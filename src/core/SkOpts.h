@@ -28,6 +28,13 @@ namespace SkOpts {
     typedef void (*Morph)(const SkPMColor*, SkPMColor*, int, int, int, int, int);
     extern Morph dilate_x, dilate_y, erode_x, erode_y;
 
+    // The resampling stages of SkBlurImageFilter's raster blur at a reduced resolution.
+    extern void (*blur_downsample_row)(const uint32_t* src, int srcRowBytesAsPixels, int srcW,
+                                       int rows, int scaleX, int scaleY, uint32_t* dst, int dstW);
+    extern void (*blur_upsample_row)(const uint32_t* row0, const uint32_t* row1, uint32_t weightY,
+                                     const int* srcX, const uint32_t* weightX,
+                                     uint32_t* dst, int dstW);
+
     extern void (*blit_mask_d32_a8)(SkPMColor*, size_t, const SkAlpha*, size_t, SkColor, int, int);
     extern void (*blit_row_color32)(SkPMColor*, const SkPMColor*, int, SkPMColor);
     extern void (*blit_row_s32a_opaque)(SkPMColor*, const SkPMColor*, int, U8CPU);
@@ -43,13 +50,32 @@ namespace SkOpts {
                         grayA_to_RGBA,         // i.e. expand to color channels
                         grayA_to_rgbA,         // i.e. expand to color channels and premultiply
                         inverted_CMYK_to_RGB1, // i.e. convert color space
-                        inverted_CMYK_to_BGR1; // i.e. convert color space
+                        inverted_CMYK_to_BGR1, // i.e. convert color space
+                        RGB16_to_RGB1,         // i.e. drop the low bytes + an opaque alpha
+                        RGB16_to_BGR1,         // i.e. drop the low bytes, swap RB + an opaque alpha
+                        RGBA16_to_RGBA,        // i.e. drop the (big-endian) low bytes
+                        RGBA16_to_BGRA,        // i.e. drop the low bytes and swap RB
+                        rgbA_to_RGBA,          // i.e. just unpremultiply
+                        rgbA_to_BGRA;          // i.e. swap RB and unpremultiply
+
+    // Accumulate a row of SkCoverageDeltaMask deltas into coverages and convert them to alphas.
+    // width must be a multiple of SkCoverageDeltaMask::SIMD_WIDTH.
+    extern void (*coverage_to_alpha)(const int32_t deltas[], uint8_t alphas[], int width,
+                                     bool isEvenOdd, bool isInverse, bool isConvex);
 
     extern void (*memset16)(uint16_t[], uint16_t, int);
     extern void SK_API (*memset32)(uint32_t[], uint32_t, int);
     extern void (*memset64)(uint64_t[], uint64_t, int);
 
-    // The fastest high quality 32-bit hash we can provide on this platform.
+    // Fill height rows of count values, rowBytes apart.  Big fills bypass the cache if they can.
+    extern void (*rect_memset16)(uint16_t[], uint16_t, int, size_t, int);
+    extern void (*rect_memset32)(uint32_t[], uint32_t, int, size_t, int);
+    extern void (*rect_memset64)(uint64_t[], uint64_t, int, size_t, int);
+
+    // The fastest high quality 32-bit hash we can provide on this platform.  Its values are the
+    // same for the same input on any one kind of CPU, but differ between them: it's Murmur3
+    // without SSE4.2 or ARMv8 CRC32, built from crc32 instructions with either, and on AVX2 CPUs,
+    // an xxh3-style multiply-accumulate for keys of 512 bytes or more.  Don't persist it.
     extern uint32_t (*hash_fn)(const void*, size_t, uint32_t seed);
     static inline uint32_t hash(const void* data, size_t bytes, uint32_t seed=0) {
         return hash_fn(data, bytes, seed);
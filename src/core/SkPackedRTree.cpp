@@ -0,0 +1,147 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPackedRTree.h"
+#include "SkNx.h"
+#include "SkTSort.h"
+
+#include <algorithm>
+
+constexpr int SkPackedRTree::kFanout;
+
+// Position of (x,y) along a Hilbert curve filling a 2^16 x 2^16 grid.
+static uint32_t hilbert_index(uint32_t x, uint32_t y) {
+    uint32_t d = 0;
+    for (uint32_t s = 1 << 15; s > 0; s >>= 1) {
+        uint32_t rx = (x & s) ? 1 : 0,
+                 ry = (y & s) ? 1 : 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so the curve stays continuous.
+        if (0 == ry) {
+            if (1 == rx) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+void SkPackedRTree::insert(const SkRect boundsArray[], int N) {
+    SkASSERT(0 == fOps.count());
+
+    struct Item {
+        uint32_t fHilbert;
+        int      fOp;
+    };
+    SkTDArray<Item> items;
+    items.setReserve(N);
+    fRootBound.setEmpty();
+    for (int i = 0; i < N; i++) {
+        if (!boundsArray[i].isEmpty()) {
+            fRootBound.join(boundsArray[i]);
+            items.append()->fOp = i;
+        }
+    }
+    if (items.isEmpty()) {
+        return;
+    }
+
+    // Sort the ops by the Hilbert index of their centers.
+    const float scaleX = fRootBound.width()  > 0 ? 65535 / fRootBound.width()  : 0,
+                scaleY = fRootBound.height() > 0 ? 65535 / fRootBound.height() : 0;
+    for (Item& item : items) {
+        const SkRect& r = boundsArray[item.fOp];
+        float x = (r.centerX() - fRootBound.fLeft) * scaleX,
+              y = (r.centerY() - fRootBound.fTop)  * scaleY;
+        item.fHilbert = hilbert_index(SkTPin<uint32_t>((uint32_t)x, 0, 65535),
+                                      SkTPin<uint32_t>((uint32_t)y, 0, 65535));
+    }
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        return a.fHilbert < b.fHilbert || (a.fHilbert == b.fHilbert && a.fOp < b.fOp);
+    });
+
+    fOps.setCount(items.count());
+    SkTDArray<SkRect> bounds;
+    bounds.setCount(items.count());
+    for (int i = 0; i < items.count(); i++) {
+        fOps[i] = items[i].fOp;
+        bounds[i] = boundsArray[items[i].fOp];
+    }
+
+    // Build the levels bottom up, each one with a node per kFanout bounds of the level below.
+    // Unused children get inverted bounds, which no query intersects.
+    do {
+        int nodeCount = (bounds.count() + kFanout - 1) / kFanout;
+        fLevels.push(fNodes.count());
+        Node* nodes = fNodes.append(nodeCount);
+        for (int i = 0; i < nodeCount; i++) {
+            SkRect nodeBounds = SkRect::MakeEmpty();
+            for (int j = 0; j < kFanout; j++) {
+                int child = i * kFanout + j;
+                SkRect r = { SK_ScalarInfinity, SK_ScalarInfinity,
+                             SK_ScalarNegativeInfinity, SK_ScalarNegativeInfinity };
+                if (child < bounds.count()) {
+                    r = bounds[child];
+                    nodeBounds.join(r);
+                }
+                nodes[i].fLeft[j]   = r.fLeft;
+                nodes[i].fTop[j]    = r.fTop;
+                nodes[i].fRight[j]  = r.fRight;
+                nodes[i].fBottom[j] = r.fBottom;
+            }
+            bounds[i] = nodeBounds;
+        }
+        bounds.setCount(nodeCount);
+    } while (bounds.count() > 1);
+}
+
+void SkPackedRTree::search(const SkRect& query, SkTDArray<int>* results) const {
+    if (fOps.isEmpty() || !SkRect::Intersects(fRootBound, query)) {
+        return;
+    }
+    int start = results->count();
+    this->search(fLevels.count() - 1, 0, query, results);
+    // The Hilbert order is not the op order, and ops must be drawn in order.
+    if (results->count() - start > 1) {
+        SkTQSort(results->begin() + start, results->end() - 1);
+    }
+}
+
+void SkPackedRTree::search(int level, int index, const SkRect& query,
+                           SkTDArray<int>* results) const {
+    const Node& node = fNodes[fLevels[level] + index];
+    // Same test as SkRect::Intersects(), for all the children at once: the intersection of the
+    // child and the query must not be empty.
+    Sk8f hitsX = Sk8f::Max(Sk8f::Load(node.fLeft), query.fLeft) <
+                 Sk8f::Min(Sk8f::Load(node.fRight), query.fRight),
+         hitsY = Sk8f::Max(Sk8f::Load(node.fTop), query.fTop) <
+                 Sk8f::Min(Sk8f::Load(node.fBottom), query.fBottom);
+    Sk8f hits = hitsX.thenElse(hitsY, 0);
+    if (!hits.anyTrue()) {
+        return;
+    }
+    uint32_t mask[kFanout];
+    hits.store(mask);
+    for (int i = 0; i < kFanout; i++) {
+        if (!mask[i]) {
+            continue;
+        }
+        int child = index * kFanout + i;
+        if (0 == level) {
+            results->push(fOps[child]);
+        } else {
+            this->search(level - 1, child, query, results);
+        }
+    }
+}
+
+size_t SkPackedRTree::bytesUsed() const {
+    return sizeof(SkPackedRTree) + fNodes.reserved() * sizeof(Node) +
+           fLevels.reserved() * sizeof(int) + fOps.reserved() * sizeof(int);
+}
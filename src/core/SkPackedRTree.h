@@ -0,0 +1,61 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPackedRTree_DEFINED
+#define SkPackedRTree_DEFINED
+
+#include "SkBBoxHierarchy.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+
+/**
+ * An R-Tree stored as a flat array of nodes, each holding the bounds of its 8 children as four
+ * arrays (lefts, tops, rights, bottoms). A node is two cache lines, and search() tests all of its
+ * children against the query at once with Sk8f. Children are not linked: the children of node i
+ * are the nodes 8i to 8i+7 of the level below it, and the leaves index into the ops sorted along
+ * a Hilbert curve, which keeps ops that are close on screen in the same nodes.
+ *
+ * Like SkRTree it is bulk-loaded, and search() returns ops in increasing order. SkRTree groups ops
+ * in recording order, which is hard to beat when they were recorded top to bottom, but degrades
+ * badly when they were not; this tree does not depend on the recording order, at the cost of
+ * sorting the results of each search.
+ */
+class SkPackedRTree : public SkBBoxHierarchy {
+public:
+    static constexpr int kFanout = 8;
+
+    SkPackedRTree() {}
+    ~SkPackedRTree() override {}
+
+    void insert(const SkRect[], int N) override;
+    void search(const SkRect& query, SkTDArray<int>* results) const override;
+    size_t bytesUsed() const override;
+    SkRect getRootBound() const override { return fRootBound; }
+
+    // Only public for tests.
+    int getCount() const { return fOps.count(); }
+    int getDepth() const { return fLevels.count(); }
+
+private:
+    struct Node {
+        float fLeft[kFanout];
+        float fTop[kFanout];
+        float fRight[kFanout];
+        float fBottom[kFanout];
+    };
+
+    void search(int level, int index, const SkRect& query, SkTDArray<int>* results) const;
+
+    SkTDArray<Node> fNodes;   // All levels, leaves first.
+    SkTDArray<int>  fLevels;  // Index of each level's first node in fNodes, leaves first.
+    SkTDArray<int>  fOps;     // Op indices in Hilbert order.
+    SkRect          fRootBound = SkRect::MakeEmpty();
+
+    typedef SkBBoxHierarchy INHERITED;
+};
+
+#endif
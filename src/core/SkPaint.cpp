@@ -7,6 +7,7 @@
 
 #include "SkPaint.h"
 #include "SkPaintPriv.h"
+#include "SkAdvanceCache.h"
 #include "SkColorFilter.h"
 #include "SkData.h"
 #include "SkDraw.h"
@@ -28,6 +29,7 @@
 #include "SkShader.h"
 #include "SkShaderBase.h"
 #include "SkStringUtils.h"
+#include "SkStyledPathCache.h"
 #include "SkStroke.h"
 #include "SkStrokeRec.h"
 #include "SkSurfacePriv.h"
@@ -721,6 +723,63 @@ static SkScalar advance(const SkGlyph& glyph, int xyIndex) {
     return SkFloatToScalar((&glyph.fAdvanceX)[xyIndex]);
 }
 
+// Sets advances to the advances of the text's glyphs at the paint's text size, read from the
+// typeface's SkAdvanceCache instead of a strike. Returns false if the paint needs a strike.
+static bool get_linear_advances(const SkPaint& paint, const void* text, size_t byteLength,
+                                SkAutoSTMalloc<64, SkScalar>* advances, int* count) {
+    SkScalar scale;
+    sk_sp<SkAdvanceCache> cache = SkAdvanceCache::Find(paint, &scale);
+    if (!cache) {
+        return false;
+    }
+
+    const int n = paint.countText(text, byteLength);
+    if (n <= 0) {
+        return false;
+    }
+    SkAutoSTMalloc<64, SkGlyphID> glyphs(n);
+    SkTypeface* typeface = SkPaintPriv::GetTypefaceOrDefault(paint);
+    switch (paint.getTextEncoding()) {
+        case SkPaint::kUTF8_TextEncoding:
+            typeface->charsToGlyphs(text, SkTypeface::kUTF8_Encoding, glyphs.get(), n);
+            break;
+        case SkPaint::kUTF16_TextEncoding:
+            typeface->charsToGlyphs(text, SkTypeface::kUTF16_Encoding, glyphs.get(), n);
+            break;
+        case SkPaint::kUTF32_TextEncoding:
+            typeface->charsToGlyphs(text, SkTypeface::kUTF32_Encoding, glyphs.get(), n);
+            break;
+        case SkPaint::kGlyphID_TextEncoding:
+            memcpy(glyphs.get(), text, n * sizeof(SkGlyphID));
+            break;
+    }
+
+    advances->reset(n);
+    for (int i = 0; i < n; ++i) {
+        (*advances)[i] = cache->advance(glyphs[i]) * scale;
+    }
+    *count = n;
+    return true;
+}
+
+// Advances text past one character (or glyph ID), as the GlyphCacheProcs do.
+static void next_char(SkPaint::TextEncoding encoding, const char** text) {
+    switch (encoding) {
+        case SkPaint::kUTF8_TextEncoding:
+            SkUTF8_NextUnichar(text);
+            break;
+        case SkPaint::kUTF16_TextEncoding:
+            SkUTF16_NextUnichar((const uint16_t**)text);
+            break;
+        case SkPaint::kUTF32_TextEncoding:
+            *text += sizeof(int32_t);
+            break;
+        case SkPaint::kGlyphID_TextEncoding:
+            *text += sizeof(uint16_t);
+            break;
+    }
+}
+
 SkScalar SkPaint::measure_text(SkGlyphCache* cache,
                                const char* text, size_t byteLength,
                                int* count, SkRect* bounds) const {
@@ -778,14 +837,21 @@ SkScalar SkPaint::measureText(const void* textData, size_t length, SkRect* bound
     const SkPaint& paint = canon.getPaint();
     SkScalar scale = canon.getScale();
 
-    auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(paint);
-
     SkScalar width = 0;
 
     if (length > 0) {
         int tempCount;
+        SkAutoSTMalloc<64, SkScalar> advances;
 
-        width = paint.measure_text(cache.get(), text, length, &tempCount, bounds);
+        // Measuring without bounds only needs advances.
+        if (!bounds && get_linear_advances(paint, text, length, &advances, &tempCount)) {
+            for (int i = 0; i < tempCount; ++i) {
+                width += advances[i];
+            }
+        } else {
+            auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(paint);
+            width = paint.measure_text(cache.get(), text, length, &tempCount, bounds);
+        }
         if (scale) {
             width *= scale;
             if (bounds) {
@@ -831,20 +897,36 @@ size_t SkPaint::breakText(const void* textD, size_t length, SkScalar maxWidth,
         maxWidth /= scale;
     }
 
-    auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(paint);
-
-    GlyphCacheProc   glyphCacheProc = SkPaint::GetGlyphCacheProc(paint.getTextEncoding(),
-                                                                 false);
-    const int        xyIndex = paint.isVerticalText() ? 1 : 0;
     SkScalar         width = 0;
+    SkAutoSTMalloc<64, SkScalar> advances;
+    int              count;
+
+    if (get_linear_advances(paint, text, length, &advances, &count)) {
+        for (int i = 0; text < stop && i < count; ++i) {
+            const char* curr = text;
+            next_char(paint.getTextEncoding(), &text);
+            SkScalar x = advances[i];
+            if ((width += x) > maxWidth) {
+                width -= x;
+                text = curr;
+                break;
+            }
+        }
+    } else {
+        auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(paint);
 
-    while (text < stop) {
-        const char* curr = text;
-        SkScalar x = advance(glyphCacheProc(cache.get(), &text), xyIndex);
-        if ((width += x) > maxWidth) {
-            width -= x;
-            text = curr;
-            break;
+        GlyphCacheProc glyphCacheProc = SkPaint::GetGlyphCacheProc(paint.getTextEncoding(),
+                                                                   false);
+        const int      xyIndex = paint.isVerticalText() ? 1 : 0;
+
+        while (text < stop) {
+            const char* curr = text;
+            SkScalar x = advance(glyphCacheProc(cache.get(), &text), xyIndex);
+            if ((width += x) > maxWidth) {
+                width -= x;
+                text = curr;
+                break;
+            }
         }
     }
 
@@ -920,14 +1002,24 @@ int SkPaint::getTextWidths(const void* textData, size_t byteLength,
     const SkPaint& paint = canon.getPaint();
     SkScalar scale = canon.getScale();
 
+    // Widths alone only need advances.
+    SkAutoSTMalloc<64, SkScalar> advances;
+    int count;
+    if (!bounds && get_linear_advances(paint, textData, byteLength, &advances, &count)) {
+        for (int i = 0; i < count; ++i) {
+            widths[i] = scale ? advances[i] * scale : advances[i];
+        }
+        return count;
+    }
+
     auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(paint);
     GlyphCacheProc      glyphCacheProc = SkPaint::GetGlyphCacheProc(paint.getTextEncoding(),
                                                                     nullptr != bounds);
 
     const char* text = (const char*)textData;
     const char* stop = text + byteLength;
-    int         count = 0;
     const int   xyIndex = paint.isVerticalText() ? 1 : 0;
+    count = 0;
 
     if (scale) {
         while (text < stop) {
@@ -1393,6 +1485,18 @@ bool SkPaint::getFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect
 
     SkStrokeRec rec(*this, resScale);
 
+    // Only look up paths there is work to do on.
+    bool cache = (fPathEffect || rec.needToApply()) && !src.isVolatile() && &src != dst &&
+                 SkStyledPathCache::CanCache(src);
+    if (cache) {
+        SkStrokeRec dstRec(SkStrokeRec::kFill_InitStyle);
+        if (SkStyledPathCache::Find(SkStyledPathCache::Step::kFillPath, src, rec,
+                                    fPathEffect.get(), cullRect, dst, &dstRec)) {
+            return !dstRec.isHairlineStyle();
+        }
+    }
+    const SkStrokeRec srcRec = rec;
+
     const SkPath* srcPtr = &src;
     SkPath tmpPath;
 
@@ -1416,6 +1520,12 @@ bool SkPaint::getFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect
         dst->reset();
         return false;
     }
+    if (cache) {
+        SkStyledPathCache::Add(SkStyledPathCache::Step::kFillPath, src, srcRec, fPathEffect.get(),
+                               cullRect, *dst,
+                               SkStrokeRec(rec.isHairlineStyle() ? SkStrokeRec::kHairline_InitStyle
+                                                                 : SkStrokeRec::kFill_InitStyle));
+    }
     return !rec.isHairlineStyle();
 }
 
@@ -10,6 +10,21 @@
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 
+#include <atomic>
+
+static uint32_t next_path_effect_unique_id() {
+    static std::atomic<uint32_t> gPathEffectUniqueID{0};
+
+    // Never return 0.
+    uint32_t id;
+    do {
+        id = gPathEffectUniqueID.fetch_add(1, std::memory_order_relaxed) + 1;
+    } while (0 == id);
+    return id;
+}
+
+SkPathEffect::SkPathEffect() : fUniqueID(next_path_effect_unique_id()) {}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkPathEffect::computeFastBounds(SkRect* dst, const SkRect& src) const {
@@ -135,6 +135,54 @@ public:
         SkPathRef* fPathRef;
     };
 
+    /**
+     * Returns a C++11-iterable object that traverses a path's verbs along with their points and
+     * conic weights, straight out of the path's storage, e.g:
+     *
+     *   for (SkPathPriv::Segment segment : SkPathPriv::Iterate(path)) {
+     *       ...
+     *   }
+     *
+     * For kMove_Verb fPts[0] is the new point. For other verbs fPts[0] is the last point of the
+     * previous verb, followed by the verb's own points, like SkPath::RawIter. fWeight is only
+     * valid for kConic_Verb. Unlike SkPath::Iter this neither closes contours nor skips
+     * degenerate segments, and nothing is copied.
+     */
+    struct Segment {
+        SkPath::Verb    fVerb;
+        const SkPoint*  fPts;
+        const SkScalar* fWeight;
+    };
+    struct Iterate {
+    public:
+        Iterate(const SkPath& path) : fPathRef(path.fPathRef.get()) {}
+        struct Iter {
+            void operator++() {
+                unsigned verb = *fVerb--;  // verbs are laid out backwards in memory.
+                fPts += PtsInVerb(verb);
+                fWeight += (SkPath::kConic_Verb == verb);
+            }
+            bool operator!=(const Iter& b) { return fVerb != b.fVerb; }
+            Segment operator*() {
+                SkPath::Verb verb = static_cast<SkPath::Verb>(*fVerb);
+                return { verb, SkPath::kMove_Verb == verb ? fPts : fPts - 1, fWeight };
+            }
+            const uint8_t*  fVerb;
+            const SkPoint*  fPts;
+            const SkScalar* fWeight;
+        };
+        Iter begin() {
+            return Iter{fPathRef->verbs() - 1, fPathRef->points(), fPathRef->conicWeights()};
+        }
+        Iter end() {
+            return Iter{fPathRef->verbs() - fPathRef->countVerbs() - 1, nullptr, nullptr};
+        }
+    private:
+        Iterate(const Iterate&) = delete;
+        Iterate& operator=(const Iterate&) = delete;
+        SkPathRef* fPathRef;
+    };
+
     /**
      * Returns a pointer to the verb data. Note that the verbs are stored backwards in memory and
      * thus the returned pointer is the last verb.
@@ -237,6 +285,22 @@ public:
         SkASSERT(verb < SK_ARRAY_COUNT(gPtsInVerb));
         return gPtsInVerb[verb];
     }
+
+    // Returns the number of points each verb adds to the path's storage
+    static int PtsInVerb(unsigned verb) {
+        static const uint8_t gPtsInVerb[] = {
+            1,  // kMove
+            1,  // kLine
+            2,  // kQuad
+            2,  // kConic
+            3,  // kCubic
+            0,  // kClose
+            0   // kDone
+        };
+
+        SkASSERT(verb < SK_ARRAY_COUNT(gPtsInVerb));
+        return gPtsInVerb[verb];
+    }
 };
 
 #endif
@@ -6,6 +6,7 @@
  */
 
 #include "SkBuffer.h"
+#include "SkMutex.h"
 #include "SkNx.h"
 #include "SkOnce.h"
 #include "SkPath.h"
@@ -669,11 +670,16 @@ uint32_t SkPathRef::genID() const {
     return fGenerationID;
 }
 
+// Listeners may be added to a shared path ref by several threads drawing it at once.  They are
+// only called once the path ref is unique (when it is edited or deleted), so that needs no lock.
+SK_DECLARE_STATIC_MUTEX(gGenIDChangeListenersMutex);
+
 void SkPathRef::addGenIDChangeListener(GenIDChangeListener* listener) {
     if (nullptr == listener || this == gEmpty) {
         delete listener;
         return;
     }
+    SkAutoMutexAcquire lock(gGenIDChangeListenersMutex);
     *fGenIDChangeListeners.append() = listener;
 }
 
@@ -6,6 +6,8 @@
  */
 
 #include "SkAtomics.h"
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
 #include "SkImageGenerator.h"
 #include "SkMathPriv.h"
 #include "SkPicture.h"
@@ -63,6 +65,14 @@ SkPictInfo SkPicture::createHeader() const {
     return info;
 }
 
+void SkPicture::playbackDamage(SkCanvas* canvas, const SkRegion& damage,
+                               AbortCallback* callback) const {
+    SkAutoCanvasRestore acr(canvas, true);
+    // Playback culls against the canvas's clip bounds, with a bounding box hierarchy if any.
+    canvas->clipRegion(damage);
+    this->playback(canvas, callback);
+}
+
 bool SkPicture::IsValidPictInfo(const SkPictInfo& info) {
     if (0 != memcmp(info.fMagic, kMagic, sizeof(kMagic))) {
         return false;
@@ -125,7 +135,8 @@ bool SkPicture::BufferIsSKP(SkReadBuffer* buffer, SkPictInfo* pInfo) {
 
 sk_sp<SkPicture> SkPicture::Forwardport(const SkPictInfo& info,
                                         const SkPictureData* data,
-                                        SkReadBuffer* buffer) {
+                                        SkReadBuffer* buffer,
+                                        SkBBHFactory* bbhFactory) {
     if (!data) {
         return nullptr;
     }
@@ -134,7 +145,7 @@ sk_sp<SkPicture> SkPicture::Forwardport(const SkPictInfo& info,
     }
     SkPicturePlayback playback(data);
     SkPictureRecorder r;
-    playback.draw(r.beginRecording(info.fCullRect), nullptr/*no callback*/, buffer);
+    playback.draw(r.beginRecording(info.fCullRect, bbhFactory), nullptr/*no callback*/, buffer);
     return r.finishRecordingAsPicture();
 }
 
@@ -175,7 +186,17 @@ sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialPro
         case kPictureData_TrailingStreamByteAfterPictInfo: {
             std::unique_ptr<SkPictureData> data(
                     SkPictureData::CreateFromStream(stream, info, procs, typefaces));
-            return Forwardport(info, data.get(), nullptr);
+            sk_sp<SkPicture> picture;
+            if (procs.fLazyPictures) {
+                // Lazy sub-pictures are only worth it if ops outside the clip can be skipped.
+                SkRTreeFactory factory;
+                picture = Forwardport(info, data.get(), nullptr, &factory);
+            } else {
+                picture = Forwardport(info, data.get(), nullptr);
+            }
+            // The op data may point into the stream's memory, so it must die with data, here.
+            SkASSERT(!data || !data->opData() || data->opData()->unique());
+            return picture;
         }
         case kCustom_TrailingStreamByteAfterPictInfo: {
             int32_t ssize = stream->readS32();
@@ -221,6 +242,9 @@ sk_sp<SkPicture> SkPicture::MakeFromBuffer(SkReadBuffer& buffer) {
 SkPictureData* SkPicture::backport() const {
     SkPictInfo info = this->createHeader();
     SkPictureRecord rec(SkISize::Make(info.fCullRect.width(), info.fCullRect.height()), 0/*flags*/);
+    // Our ops take about as much space recorded as they do in memory.  Reserving that up front
+    // saves growing (and copying) big pictures' ops many times over.
+    rec.setOpReserve(this->approximateBytesUsed());
     rec.beginRecording();
         this->playback(&rec);
     rec.endRecording();
@@ -8,7 +8,9 @@
 #include <new>
 
 #include "SkAutoMalloc.h"
+#include "SkFontDescriptor.h"
 #include "SkImageGenerator.h"
+#include "SkLazyPicture.h"
 #include "SkPictureData.h"
 #include "SkPictureRecord.h"
 #include "SkReadBuffer.h"
@@ -36,21 +38,21 @@ void SkPictureData::initForPlayback() const {
     }
 }
 
-SkPictureData::SkPictureData(const SkPictureRecord& record,
+SkPictureData::SkPictureData(SkPictureRecord& record,
                              const SkPictInfo& info)
     : fInfo(info) {
 
     this->init();
 
-    fOpData = record.opData();
+    fOpData = record.detachOpData();
 
     fPaints  = record.fPaints;
 
     fPaths.reset(record.fPaths.count());
-    record.fPaths.foreach([this](const SkPath& path, int n) {
+    record.fPaths.foreach([this](const SkPath& path, int* n) {
         // These indices are logically 1-based, but we need to serialize them
         // 0-based to keep the deserializing SkPictureData::getPath() working.
-        fPaths[n-1] = path;
+        fPaths[*n-1] = path;
     });
 
     this->initForPlayback();
@@ -121,6 +123,9 @@ void SkPictureData::init() {
 }
 
 SkPictureData::~SkPictureData() {
+    // If parsing failed, tasks may still be creating typefaces and images.
+    this->waitForTasks();
+
     for (int i = 0; i < fPictureCount; i++) {
         fPictureRefs[i]->unref();
     }
@@ -145,7 +150,8 @@ SkPictureData::~SkPictureData() {
     delete[] fVerticesRefs;
 
     for (int i = 0; i < fImageCount; i++) {
-        fImageRefs[i]->unref();
+        // Null if parsing failed before all images were read in parallel.
+        SkSafeUnref(fImageRefs[i]);
     }
     delete[] fImageRefs;
 
@@ -184,6 +190,33 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
+// Pads the stream so that the payload of the next tag starts on a 4-byte boundary, which lets a
+// reader use the op data and buffer in place when the stream is backed by aligned memory (e.g. a
+// memory-mapped .skp).
+static void write_align_tag(SkWStream* stream) {
+    // The align tag and the next tag both have 8 byte headers.
+    size_t padding = (4 - (stream->bytesWritten() & 3)) & 3;
+    if (padding) {
+        write_tag_size(stream, SK_PICT_ALIGN_TAG, padding);
+        const uint8_t zeros[3] = { 0, 0, 0 };
+        stream->write(zeros, padding);
+    }
+}
+
+// Returns the next 'size' bytes of the stream if they can be used in place, and skips them.
+static const void* read_in_place(SkStream* stream, size_t size) {
+    const char* base = (const char*)stream->getMemoryBase();
+    if (!base || !stream->hasPosition() || !stream->hasLength()) {
+        return nullptr;
+    }
+    size_t position = stream->getPosition();
+    if (position > stream->getLength() || stream->getLength() - position < size ||
+        !SkIsAlign4((uintptr_t)(base + position))) {
+        return nullptr;
+    }
+    return stream->skip(size) == size ? base + position : nullptr;
+}
+
 void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
@@ -269,6 +302,7 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
 void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
                               SkRefCntSet* topLevelTypeFaceSet) const {
     // This can happen at pretty much any time, so might as well do it first.
+    write_align_tag(stream);
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
 
@@ -292,9 +326,45 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
         size_t fBytesWritten;
         bool write(const void*, size_t size) override { fBytesWritten += size; return true; }
         size_t bytesWritten() const override { return fBytesWritten; }
-    } devnull;
-    for (int i = 0; i < fPictureCount; i++) {
-        fPictureRefs[i]->serialize(&devnull, nullptr, typefaceSet);
+    };
+
+    // With an executor, each sub-picture is serialized on its own thread, both times.  Their
+    // procs drop the executor, so only this level shares typefaceSet across threads.
+    SkAutoTArray<sk_sp<SkData>> pictures;
+    if (procs.fExecutor && fPictureCount > 1) {
+        SkTaskGroup tasks(*procs.fExecutor);
+        SkSerialProcs pictureProcs = procs;
+        pictureProcs.fExecutor = nullptr;
+
+        // Each collects its typefaces in its own set, which we add to typefaceSet in order, so
+        // the typefaces get the same indices as when we do this serially.
+        SkAutoTArray<SkRefCntSet> pictureTypefaces(fPictureCount);
+        tasks.batch(fPictureCount, [&](int i) {
+            DevNull devnull;
+            fPictureRefs[i]->serialize(&devnull, nullptr, &pictureTypefaces[i]);
+        });
+        tasks.wait();
+        for (int i = 0; i < fPictureCount; i++) {
+            SkAutoTMalloc<SkRefCnt*> typefaces(pictureTypefaces[i].count());
+            pictureTypefaces[i].copyToArray(typefaces.get());
+            for (int j = 0; j < pictureTypefaces[i].count(); j++) {
+                typefaceSet->add(typefaces[j]);
+            }
+        }
+
+        // typefaceSet now holds every typeface, so the sub-pictures only read it.
+        pictures.reset(fPictureCount);
+        tasks.batch(fPictureCount, [&](int i) {
+            SkDynamicMemoryWStream picture;
+            fPictureRefs[i]->serialize(&picture, &pictureProcs, typefaceSet);
+            pictures[i] = picture.detachAsData();
+        });
+        tasks.wait();
+    } else {
+        DevNull devnull;
+        for (int i = 0; i < fPictureCount; i++) {
+            fPictureRefs[i]->serialize(&devnull, nullptr, typefaceSet);
+        }
     }
 
     // We need to write factories before we write the buffer.
@@ -305,14 +375,27 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     }
 
     // Write the buffer.
+    write_align_tag(stream);
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
 
-    // Write sub-pictures by calling serialize again.
+    // Write sub-pictures by calling serialize again. Each is prefixed with its size and padded to
+    // a multiple of 4 bytes, so a reader can skip it or keep its bytes for later.
     if (fPictureCount > 0) {
+        write_align_tag(stream);
         write_tag_size(stream, SK_PICT_PICTURE_TAG, fPictureCount);
         for (int i = 0; i < fPictureCount; i++) {
-            fPictureRefs[i]->serialize(stream, &procs, typefaceSet);
+            sk_sp<SkData> picture = pictures.get() ? std::move(pictures[i]) : nullptr;
+            if (!picture) {
+                SkDynamicMemoryWStream dynamic;
+                fPictureRefs[i]->serialize(&dynamic, &procs, typefaceSet);
+                picture = dynamic.detachAsData();
+            }
+            size_t size = picture->size();
+            stream->write32(SkToU32(SkAlign4(size)));
+            stream->write(picture->data(), size);
+            const uint8_t zeros[3] = { 0, 0, 0 };
+            stream->write(zeros, SkAlign4(size) - size);
         }
     }
 
@@ -344,6 +427,31 @@ void SkPictureData::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Installed by clients that serialize typefaces their own way; see SkTypeface.cpp.
+extern sk_sp<SkTypeface> (*gDeserializeTypefaceDelegate)(SkStream*);
+
+const SkPicture* SkPictureData::ReadSizedPicture(SkStream* stream, const SkDeserialProcs& procs,
+                                                 SkTypefacePlayback* typefaces) {
+    size_t size = stream->readU32();
+    if (procs.fLazyPictures) {
+        // Lazy pictures outlive the stream, so they keep a copy of their bytes.
+        sk_sp<SkData> data = SkData::MakeFromStream(stream, size);
+        return data ? SkLazyPicture::Make(std::move(data), procs, *typefaces).release() : nullptr;
+    }
+    sk_sp<SkData> data;
+    if (const void* memory = read_in_place(stream, size)) {
+        // As with the op data in parseStreamTag(), this only lives as long as the call below.
+        data = SkData::MakeWithoutCopy(memory, size);
+    } else {
+        data = SkData::MakeFromStream(stream, size);
+    }
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream picture(std::move(data));
+    return SkPicture::MakeFromStream(&picture, &procs, typefaces).release();
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
@@ -361,9 +469,21 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     SkDEBUGCODE(bool haveBuffer = false;)
 
     switch (tag) {
+        case SK_PICT_ALIGN_TAG:
+            if (size > 3 || stream->skip(size) != size) {
+                return false;
+            }
+            break;
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            if (const void* ops = read_in_place(stream, size)) {
+                // This doesn't ref the stream's memory. It's safe only because SkPictureData made
+                // from a stream never outlives SkPicture::MakeFromStream(), which plays the ops
+                // into a new SkRecord (copying what it keeps) and asserts nothing else took a ref.
+                fOpData = SkData::MakeWithoutCopy(ops, size);
+            } else {
+                fOpData = SkData::MakeFromStream(stream, size);
+            }
             if (!fOpData) {
                 return false;
             }
@@ -385,6 +505,10 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
         case SK_PICT_TYPEFACE_TAG: {
             SkASSERT(!haveBuffer);
             const int count = SkToInt(size);
+            if (procs.fExecutor && !gDeserializeTypefaceDelegate) {
+                this->parseTypefacesInParallel(stream, count, procs.fExecutor);
+                break;
+            }
             fTFPlayback.setCount(count);
             for (int i = 0; i < count; i++) {
                 sk_sp<SkTypeface> tf(SkTypeface::MakeDeserialize(stream));
@@ -399,8 +523,14 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
         case SK_PICT_PICTURE_TAG: {
             fPictureCount = 0;
             fPictureRefs = new const SkPicture* [size];
+            const bool sized = fInfo.getVersion() >= SkReadBuffer::kSizedSubPictures_Version;
             for (uint32_t i = 0; i < size; i++) {
-                fPictureRefs[i] = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback).release();
+                if (sized) {
+                    fPictureRefs[i] = ReadSizedPicture(stream, procs, topLevelTFPlayback);
+                } else {
+                    fPictureRefs[i] = SkPicture::MakeFromStream(stream, &procs,
+                                                                topLevelTFPlayback).release();
+                }
                 if (!fPictureRefs[i]) {
                     return false;
                 }
@@ -408,12 +538,19 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            // Paints refer to the typefaces.
+            this->waitForTasks();
+
+            SkAutoMalloc storage;
+            const void* memory = read_in_place(stream, size);
+            if (!memory) {
+                memory = storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(memory, size);
             buffer.setVersion(fInfo.getVersion());
 
             if (!fFactoryPlayback) {
@@ -494,6 +631,62 @@ bool new_array_from_buffer(SkReadBuffer& buffer, uint32_t inCount,
     return true;
 }
 
+// Same as SkTypeface::MakeDeserialize(), after the descriptor has been read.
+static sk_sp<SkTypeface> make_typeface(SkFontDescriptor* desc) {
+    std::unique_ptr<SkFontData> data = desc->detachFontData();
+    if (data) {
+        sk_sp<SkTypeface> typeface(SkTypeface::MakeFromFontData(std::move(data)));
+        if (typeface) {
+            return typeface;
+        }
+    }
+    return SkTypeface::MakeFromName(desc->getFamilyName(), desc->getStyle());
+}
+
+void SkPictureData::parseTypefacesInParallel(SkStream* stream, int count, SkExecutor* executor) {
+    if (!fTasks) {
+        fTasks.reset(new SkTaskGroup(*executor));
+    }
+    // Reading the descriptors copies the font data; creating the typefaces parses it.
+    fTFPlayback.setCount(count);
+    for (int i = 0; i < count; i++) {
+        auto desc = std::make_shared<SkFontDescriptor>();
+        if (!SkFontDescriptor::Deserialize(stream, desc.get())) {
+            fTFPlayback.set(i, SkTypeface::MakeDefault().get());
+            continue;
+        }
+        fTasks->add([this, i, desc] {
+            sk_sp<SkTypeface> tf = make_typeface(desc.get());
+            if (!tf) {
+                tf = SkTypeface::MakeDefault();
+            }
+            fTFPlayback.set(i, tf.get());
+        });
+    }
+}
+
+void SkPictureData::parseImagesInParallel(SkReadBuffer& buffer, uint32_t count,
+                                          SkExecutor* executor) {
+    if (!buffer.validate(0 == fImageCount && nullptr == fImageRefs && SkTFitsIn<int>(count)) ||
+        0 == count) {
+        return;
+    }
+    if (!fTasks) {
+        fTasks.reset(new SkTaskGroup(*executor));
+    }
+    fImageCount = count;
+    fImageRefs = new const SkImage* [fImageCount]();
+    for (int i = 0; i < fImageCount; i++) {
+        std::function<sk_sp<SkImage>()> makeImage = buffer.readDeferredImage();
+        if (!makeImage) {
+            buffer.validate(false);
+            return;
+        }
+        const SkImage** image = &fImageRefs[i];
+        fTasks->add([image, makeImage] { *image = makeImage().release(); });
+    }
+}
+
 void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t size) {
     switch (tag) {
         case SK_PICT_PAINT_BUFFER_TAG: {
@@ -528,8 +721,12 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
                                   create_vertices_from_buffer);
             break;
         case SK_PICT_IMAGE_BUFFER_TAG:
-            new_array_from_buffer(buffer, size, &fImageRefs, &fImageCount,
-                                  create_image_from_buffer);
+            if (SkExecutor* executor = buffer.getDeserialProcs().fExecutor) {
+                this->parseImagesInParallel(buffer, size, executor);
+            } else {
+                new_array_from_buffer(buffer, size, &fImageRefs, &fImageCount,
+                                      create_image_from_buffer);
+            }
             break;
         case SK_PICT_READER_TAG: {
             auto data(SkData::MakeUninitialized(size));
@@ -594,6 +791,7 @@ bool SkPictureData::parseStream(SkStream* stream,
             return false; // we're invalid
         }
     }
+    this->waitForTasks();
     return true;
 }
 
@@ -605,6 +803,7 @@ bool SkPictureData::parseBuffer(SkReadBuffer& buffer) {
         }
         this->parseBufferTag(buffer, tag, buffer.readUInt());
     }
+    this->waitForTasks();
 
     // Check that we encountered required tags
     if (!buffer.validate(this->opData())) {
@@ -12,6 +12,7 @@
 #include "SkDrawable.h"
 #include "SkPicture.h"
 #include "SkPictureFlat.h"
+#include "SkTaskGroup.h"
 
 class SkData;
 class SkPictureRecord;
@@ -52,6 +53,8 @@ public:
 #define SK_PICT_TYPEFACE_TAG   SkSetFourByteTag('t', 'p', 'f', 'c')
 #define SK_PICT_PICTURE_TAG    SkSetFourByteTag('p', 'c', 't', 'r')
 #define SK_PICT_DRAWABLE_TAG   SkSetFourByteTag('d', 'r', 'a', 'w')
+// Followed by 'size' padding bytes, so that the next tag's payload is 4-byte aligned.
+#define SK_PICT_ALIGN_TAG      SkSetFourByteTag('a', 'l', 'i', 'n')
 
 // This tag specifies the size of the ReadBuffer, needed for the following tags
 #define SK_PICT_BUFFER_SIZE_TAG     SkSetFourByteTag('a', 'r', 'a', 'y')
@@ -72,8 +75,10 @@ template <typename T> T* read_index_base_1_or_null(SkReadBuffer* reader, int cou
 
 class SkPictureData {
 public:
-    SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
-    // Does not affect ownership of SkStream.
+    SkPictureData(SkPictureRecord& record, const SkPictInfo&);
+    // Does not affect ownership of SkStream. If the stream is backed by memory
+    // (getMemoryBase()), the op data and buffer are read in place, so the
+    // returned SkPictureData must not outlive the stream's memory.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            const SkDeserialProcs&,
@@ -92,6 +97,10 @@ protected:
 
     // Does not affect ownership of SkStream.
     bool parseStream(SkStream*, const SkDeserialProcs&, SkTypefacePlayback*);
+
+    // Reads one sub-picture of a SK_PICT_PICTURE_TAG that is prefixed with its size.
+    static const SkPicture* ReadSizedPicture(SkStream*, const SkDeserialProcs&,
+                                             SkTypefacePlayback*);
     bool parseBuffer(SkReadBuffer& buffer);
 
 public:
@@ -142,6 +151,12 @@ private:
     void parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&) const;
 
+    // With SkDeserialProcs::fExecutor, typefaces and images are created on fTasks. Their slots
+    // in fTFPlayback and fImageRefs are filled in once fTasks is done.
+    void parseTypefacesInParallel(SkStream*, int count, SkExecutor*);
+    void parseImagesInParallel(SkReadBuffer&, uint32_t count, SkExecutor*);
+    void waitForTasks() { if (fTasks) { fTasks->wait(); } }
+
     SkTArray<SkPaint>  fPaints;
     SkTArray<SkPath>   fPaths;
 
@@ -166,6 +181,8 @@ private:
     SkTypefacePlayback fTFPlayback;
     SkFactoryPlayback* fFactoryPlayback;
 
+    std::unique_ptr<SkTaskGroup> fTasks;
+
     const SkPictInfo fInfo;
 
     static void WriteFactories(SkWStream* stream, const SkFactorySet& rec);
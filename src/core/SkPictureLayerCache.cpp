@@ -0,0 +1,250 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPictureLayerCache.h"
+
+#include "SkCanvas.h"
+#include "SkCanvasPriv.h"
+#include "SkImage.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRecords.h"
+#include "SkResourceCache.h"
+#include "SkSurface.h"
+
+#if SK_SUPPORT_GPU
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrProxyProvider.h"
+#include "GrRenderTargetContext.h"
+#include "GrResourceKey.h"
+#include "SkImage_Gpu.h"
+#endif
+
+// Larger layers are drawn directly rather than kept around.
+static constexpr int64_t kMaxLayerArea = 2048 * 2048;
+
+namespace {
+static unsigned gPictureLayerKeyNamespaceLabel;
+
+static uint64_t make_shared_id(uint32_t pictureID) {
+    uint64_t sharedID = SkSetFourByteTag('p', 'l', 'a', 'y');
+    return (sharedID << 32) | pictureID;
+}
+
+// Everything that identifies a cached layer, tightly packed.
+struct LayerKeyData {
+    LayerKeyData(uint32_t pictureID, int op, const SkMatrix& matrix, const SkIRect& clip)
+        : fPictureID(pictureID)
+        , fOp(op)
+        , fClip(clip)
+    {
+        matrix.get9(fMatrix);
+    }
+
+    uint32_t fPictureID;
+    int32_t  fOp;
+    SkIRect  fClip;
+    SkScalar fMatrix[9];
+};
+
+struct PictureLayerKey : public SkResourceCache::Key {
+public:
+    explicit PictureLayerKey(const LayerKeyData& data) : fData(data) {
+        this->init(&gPictureLayerKeyNamespaceLabel, make_shared_id(data.fPictureID),
+                   sizeof(fData));
+    }
+
+    LayerKeyData fData;
+};
+
+struct PictureLayerRec : public SkResourceCache::Rec {
+    PictureLayerRec(const PictureLayerKey& key, sk_sp<SkImage> image, size_t pixelBytes)
+        : fKey(key)
+        , fImage(std::move(image))
+        , fPixelBytes(pixelBytes) {}
+
+    PictureLayerKey fKey;
+    sk_sp<SkImage>  fImage;
+    size_t          fPixelBytes;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fPixelBytes; }
+    const char* getCategory() const override { return "picture-layer"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PictureLayerRec& rec = static_cast<const PictureLayerRec&>(baseRec);
+        *(sk_sp<SkImage>*)contextData = rec.fImage;
+        return true;
+    }
+};
+
+#if SK_SUPPORT_GPU
+static void make_gpu_key(const LayerKeyData& data, GrUniqueKey* key) {
+    static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    static_assert(0 == sizeof(LayerKeyData) % sizeof(uint32_t), "");
+    GrUniqueKey::Builder builder(key, kDomain, sizeof(LayerKeyData) / sizeof(uint32_t),
+                                 "Picture Layer");
+    memcpy(&builder[0], &data, sizeof(LayerKeyData));
+}
+#endif
+} // namespace
+
+static sk_sp<SkImage> find_layer(const LayerKeyData& data, SkCanvas* canvas) {
+#if SK_SUPPORT_GPU
+    if (GrContext* context = canvas->getGrContext()) {
+        GrRenderTargetContext* rtc = canvas->internal_private_accessTopLayerRenderTargetContext();
+        if (!rtc) {
+            return nullptr;
+        }
+        GrUniqueKey key;
+        make_gpu_key(data, &key);
+        sk_sp<GrTextureProxy> proxy =
+                context->contextPriv().proxyProvider()->findOrCreateProxyByUniqueKey(
+                        key, rtc->origin());
+        if (!proxy) {
+            return nullptr;
+        }
+        return sk_make_sp<SkImage_Gpu>(context, kNeedNewImageUniqueID, kPremul_SkAlphaType,
+                                       std::move(proxy), canvas->imageInfo().refColorSpace(),
+                                       SkBudgeted::kYes);
+    }
+#endif
+    sk_sp<SkImage> image;
+    if (!SkResourceCache::Find(PictureLayerKey(data), PictureLayerRec::Visitor, &image)) {
+        return nullptr;
+    }
+    return image;
+}
+
+static void add_layer(const LayerKeyData& data, SkCanvas* canvas, sk_sp<SkImage> image,
+                      size_t pixelBytes) {
+#if SK_SUPPORT_GPU
+    if (GrContext* context = canvas->getGrContext()) {
+        // The key keeps the texture in the GrResourceCache once the image is gone.
+        if (sk_sp<GrTextureProxy> proxy = as_IB(image)->asTextureProxyRef()) {
+            GrUniqueKey key;
+            make_gpu_key(data, &key);
+            context->contextPriv().proxyProvider()->assignUniqueKeyToProxy(key, proxy.get());
+        }
+        return;
+    }
+#endif
+    SkResourceCache::Add(new PictureLayerRec(PictureLayerKey(data), std::move(image), pixelBytes));
+}
+
+namespace {
+struct AsSaveLayer {
+    const SkRecords::SaveLayer* operator()(const SkRecords::SaveLayer& op) { return &op; }
+    template <typename T>
+    const SkRecords::SaveLayer* operator()(const T&) { return nullptr; }
+};
+
+// Tracks the save depth from a SaveLayer to its Restore, and whether there are drawables inside.
+struct BlockScanner {
+    int  fDepth = 0;
+    bool fHasDrawable = false;
+
+    void operator()(const SkRecords::Save&)         { fDepth++; }
+    void operator()(const SkRecords::SaveLayer&)    { fDepth++; }
+    void operator()(const SkRecords::Restore&)      { fDepth--; }
+    void operator()(const SkRecords::DrawDrawable&) { fHasDrawable = true; }
+    template <typename T>
+    void operator()(const T&) {}
+};
+} // namespace
+
+// Returns the index of the Restore matching the SaveLayer at op, or -1 if the block can't be cached.
+static int find_cacheable_restore(const SkRecord& record, int op) {
+    BlockScanner scanner;
+    for (int i = op; i < record.count(); i++) {
+        record.visit(i, scanner);
+        if (scanner.fHasDrawable) {
+            return -1;
+        }
+        if (0 == scanner.fDepth) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool SkPictureLayerCache::IsEnabled(SkCanvas* canvas) {
+    if (kUnknown_SkColorType == canvas->imageInfo().colorType()) {
+        return false;  // No pixels to cache.
+    }
+#if SK_SUPPORT_GPU
+    if (GrContext* context = canvas->getGrContext()) {
+        return context->caps()->cachePictureLayers();
+    }
+#endif
+    SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+    return canvas->getProps(&props) &&
+           SkToBool(props.flags() & SkSurfaceProps::kCachePictureLayers_Flag);
+}
+
+int SkPictureLayerCache::DrawLayer(uint32_t pictureID, const SkRecord& record, int op,
+                                   SkCanvas* canvas, const SkMatrix& initialCTM) {
+    const SkRecords::SaveLayer* layer = record.visit(op, AsSaveLayer());
+    if (!layer || layer->backdrop || layer->clipMask ||
+        (layer->saveLayerFlags & SkCanvasPriv::kDontClipToLayer_SaveLayerFlag) ||
+        (layer->paint && !layer->paint->isSrcOver())) {
+        return -1;
+    }
+    if (!canvas->isClipRect()) {
+        return -1;
+    }
+    const SkIRect clip = canvas->getDeviceClipBounds();
+    if (clip.isEmpty() || (int64_t)clip.width() * clip.height() > kMaxLayerArea) {
+        return -1;
+    }
+    const int restore = find_cacheable_restore(record, op);
+    if (restore < 0) {
+        return -1;
+    }
+
+    const SkMatrix& ctm = canvas->getTotalMatrix();
+    LayerKeyData key(pictureID, op, ctm, clip);
+    sk_sp<SkImage> image = find_layer(key, canvas);
+    if (!image) {
+        // Draw the whole block into a transparent surface covering the clip. Since the layer
+        // composites with src-over, this is what the block adds to whatever is under it.
+        SkImageInfo info = canvas->imageInfo().makeWH(clip.width(), clip.height())
+                                              .makeAlphaType(kPremul_SkAlphaType);
+        sk_sp<SkSurface> surface = canvas->makeSurface(info);
+        if (!surface) {
+            return -1;
+        }
+        SkCanvas* layerCanvas = surface->getCanvas();
+        layerCanvas->clear(SK_ColorTRANSPARENT);
+        layerCanvas->translate(-clip.fLeft, -clip.fTop);
+        layerCanvas->concat(ctm);
+
+        SkMatrix layerInitialCTM = initialCTM;
+        layerInitialCTM.postTranslate(-clip.fLeft, -clip.fTop);
+        SkRecords::Draw draw(layerCanvas, nullptr, nullptr, 0, &layerInitialCTM);
+        for (int i = op; i <= restore; i++) {
+            record.visit(i, draw);
+        }
+        image = surface->makeImageSnapshot();
+        if (!image) {
+            return -1;
+        }
+        add_layer(key, canvas, image, info.computeMinByteSize());
+    }
+
+    canvas->save();
+    canvas->resetMatrix();
+    canvas->drawImage(image, clip.fLeft, clip.fTop);
+    canvas->restore();
+    return restore;
+}
+
+void SkPictureLayerCache::PostPurgePicture(uint32_t pictureID) {
+    SkResourceCache::PostPurgeSharedID(make_shared_id(pictureID));
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPictureLayerCache_DEFINED
+#define SkPictureLayerCache_DEFINED
+
+#include "SkMatrix.h"
+
+class SkCanvas;
+class SkRecord;
+
+/** \class SkPictureLayerCache
+
+    Keeps the composited result of a picture's saveLayer()/restore() blocks, so drawing the picture
+    again with the same matrix and clip doesn't rasterize the layer contents and run the layer's
+    image filter again. Raster layers live in the SkResourceCache, GPU layers are textures in the
+    GrResourceCache. Both are keyed by the picture's unique ID, the op index of the SaveLayer, the
+    total matrix and the device clip bounds.
+
+    A layer is cached by drawing the whole block into a transparent surface covering the device
+    clip bounds, which gives the same pixels as drawing it directly only when:
+      - the clip is a device-space rect, so nothing else about the clip affects the layer,
+      - the layer paint composites with src-over, and there is no backdrop or clip mask,
+      - the layer contains no drawables, whose content may change between draws.
+*/
+class SkPictureLayerCache {
+public:
+    /**
+     *  Does this canvas cache the layers of the pictures drawn into it? Raster canvases do if
+     *  their SkSurfaceProps have kCachePictureLayers_Flag, GPU canvases if their context was made
+     *  with GrContextOptions::fCachePictureLayers.
+     */
+    static bool IsEnabled(SkCanvas*);
+
+    /**
+     *  If op is the SaveLayer of a block that can be cached, draws the block from the cache,
+     *  caching it first if needed, and returns the index of the block's Restore. Otherwise
+     *  returns -1 and the caller should draw the op as usual.
+     *
+     *  initialCTM is the matrix the record's SetMatrix ops are relative to.
+     */
+    static int DrawLayer(uint32_t pictureID, const SkRecord&, int op, SkCanvas*,
+                         const SkMatrix& initialCTM);
+
+    /** Forget all raster layers of the picture with this unique ID. */
+    static void PostPurgePicture(uint32_t pictureID);
+};
+
+#endif
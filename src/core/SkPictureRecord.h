@@ -53,13 +53,19 @@ public:
         return fImageRefs;
     }
 
-    sk_sp<SkData> opData() const {
+    // Returns the ops recorded, leaving none.
+    sk_sp<SkData> detachOpData() {
         this->validate(fWriter.bytesWritten(), 0);
 
         if (fWriter.bytesWritten() == 0) {
             return SkData::MakeEmpty();
         }
-        return fWriter.snapshotAsData();
+        return fWriter.detachAsData();
+    }
+
+    // Hint that about size bytes of ops will be recorded.
+    void setOpReserve(size_t size) {
+        fWriter.setReserve(size);
     }
 
     void setFlags(uint32_t recordFlags) {
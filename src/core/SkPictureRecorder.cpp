@@ -15,6 +15,7 @@
 #include "SkRecordOpts.h"
 #include "SkRecordedDrawable.h"
 #include "SkRecorder.h"
+#include "SkTaskGroup.h"
 #include "SkTypes.h"
 
 SkPictureRecorder::SkPictureRecorder() {
@@ -41,6 +42,8 @@ SkCanvas* SkPictureRecorder::beginRecording(const SkRect& userCullRect,
     if (!fRecord) {
         fRecord.reset(new SkRecord);
     }
+    fSubRecorders.clear();
+    fSubRecords.clear();
     SkRecorder::DrawPictureMode dpm = (recordFlags & kPlaybackDrawPicture_RecordFlag)
         ? SkRecorder::Playback_DrawPictureMode
         : SkRecorder::Record_DrawPictureMode;
@@ -53,42 +56,177 @@ SkCanvas* SkPictureRecorder::getRecordingCanvas() {
     return fActivelyRecording ? fRecorder.get() : nullptr;
 }
 
+SkCanvas* SkPictureRecorder::beginSubRecording() {
+    SkASSERT(fActivelyRecording);
+    if (!fActivelyRecording) {
+        return nullptr;
+    }
+    SkRecorder::DrawPictureMode dpm = (fFlags & kPlaybackDrawPicture_RecordFlag)
+        ? SkRecorder::Playback_DrawPictureMode
+        : SkRecorder::Record_DrawPictureMode;
+    fSubRecords.emplace_back(new SkRecord);
+    fSubRecorders.emplace_back(new SkRecorder(fSubRecords.back().get(), fCullRect));
+    fSubRecorders.back()->reset(fSubRecords.back().get(), fCullRect, dpm);
+    return fSubRecorders.back().get();
+}
+
+namespace {
+struct OffsetDrawableIndices {
+    int fOffset;
+
+    void operator()(SkRecords::DrawDrawable* op) { op->index += fOffset; }
+    template <typename T>
+    void operator()(T*) {}
+};
+} // namespace
+
+// Optimizes the recordings and finds the bounds of their ops in parallel, then moves them all into
+// one SkRecord, each between a Save and a Restore.  Fills bounds if it is not null, and returns
+// snapshots of the recordings' drawables.
+static SkBigPicture::SnapshotArray* join_recordings(const SkRect& cullRect,
+                                                    const std::vector<SkRecorder*>& recorders,
+                                                    const std::vector<sk_sp<SkRecord>>& records,
+                                                    sk_sp<SkRecord>* joined,
+                                                    SkAutoTMalloc<SkRect>* bounds) {
+    const int count = SkToInt(records.size());
+
+    // The drawables of each recording follow those of the recordings before it.
+    SkTDArray<SkDrawable*> drawables;
+    SkAutoTMalloc<int> drawableOffsets(count);
+    for (int i = 0; i < count; i++) {
+        drawableOffsets[i] = drawables.count();
+        if (SkDrawableList* list = recorders[i]->getDrawableList()) {
+            drawables.append(list->count(), list->begin());
+        }
+    }
+
+    std::vector<SkAutoTMalloc<SkRect>> recordBounds(count);
+    SkAutoTMalloc<SkRect> recordUnions(count);
+    SkTaskGroup tasks;
+    tasks.batch(count, [&](int i) {
+        SkRecord* record = records[i].get();
+        SkRecordOptimize(record);
+        if (drawableOffsets[i] > 0 && recorders[i]->getDrawableList()) {
+            OffsetDrawableIndices offset{drawableOffsets[i]};
+            for (int op = 0; op < record->count(); op++) {
+                record->mutate(op, offset);
+            }
+        }
+        if (bounds) {
+            recordBounds[i].reset(record->count());
+            SkRecordFillBounds(cullRect, *record, recordBounds[i]);
+            recordUnions[i].setEmpty();
+            for (int op = 0; op < record->count(); op++) {
+                recordUnions[i].join(recordBounds[i][op]);
+            }
+        }
+    });
+    tasks.wait();
+
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        total += records[i]->count() ? records[i]->count() + 2 : 0;
+    }
+    if (bounds) {
+        bounds->reset(total);
+    }
+
+    // Wrapping each recording keeps the matrix and clip it leaves behind from reaching the next.
+    // Like those of any Save block, the bounds of the Save and Restore are those of the block.
+    sk_sp<SkRecord> result(new SkRecord);
+    for (int i = 0; i < count; i++) {
+        const int n = records[i]->count();
+        if (0 == n) {
+            continue;
+        }
+        if (bounds) {
+            SkRect* dst = bounds->get() + result->count();
+            dst[0] = recordUnions[i];
+            memcpy(dst + 1, recordBounds[i].get(), n * sizeof(SkRect));
+            dst[n + 1] = recordUnions[i];
+        }
+        new (result->append<SkRecords::Save>()) SkRecords::Save{};
+        result->concat(records[i]);
+        new (result->append<SkRecords::Restore>()) SkRecords::Restore{SkMatrix::I()};
+    }
+    SkASSERT(result->count() == total);
+    *joined = std::move(result);
+
+    if (drawables.isEmpty()) {
+        return nullptr;
+    }
+    SkAutoTMalloc<const SkPicture*> pics(drawables.count());
+    for (int i = 0; i < drawables.count(); i++) {
+        pics[i] = drawables[i]->newPictureSnapshot();
+    }
+    return new SkBigPicture::SnapshotArray(pics.release(), drawables.count());
+}
+
 sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlags) {
     fActivelyRecording = false;
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
-    if (fRecord->count() == 0) {
+    if (fRecord->count() == 0 && fSubRecorders.empty()) {
         auto pic = fMiniRecorder->detachAsPicture(fBBH ? nullptr : &fCullRect);
         fBBH.reset(nullptr);
         return pic;
     }
 
-    // TODO: delay as much of this work until just before first playback?
-    SkRecordOptimize(fRecord.get());
+    const bool cullOccluded = SkToBool(finishFlags & kCullOccludedDraws_FinishFlag);
+    const bool needBounds = fBBH.get() || cullOccluded;
+    SkAutoTMalloc<SkRect> bounds;
+    size_t subPictureBytes = fRecorder->approxBytesUsedBySubPictures();
+    SkBigPicture::SnapshotArray* pictList;
+    if (fSubRecorders.empty()) {
+        // TODO: delay as much of this work until just before first playback?
+        SkRecordOptimize(fRecord.get());
 
-    SkDrawableList* drawableList = fRecorder->getDrawableList();
-    SkBigPicture::SnapshotArray* pictList =
-        drawableList ? drawableList->newDrawableSnapshot() : nullptr;
+        SkDrawableList* drawableList = fRecorder->getDrawableList();
+        pictList = drawableList ? drawableList->newDrawableSnapshot() : nullptr;
 
-    if (fBBH.get()) {
-        SkAutoTMalloc<SkRect> bounds(fRecord->count());
-        SkRecordFillBounds(fCullRect, *fRecord, bounds);
-        fBBH->insert(bounds, fRecord->count());
+        if (needBounds) {
+            bounds.reset(fRecord->count());
+            SkRecordFillBounds(fCullRect, *fRecord, bounds);
+        }
+    } else {
+        fRecorder->flushMiniRecorder();
+        std::vector<SkRecorder*> recorders = { fRecorder.get() };
+        std::vector<sk_sp<SkRecord>> records = { fRecord };
+        for (size_t i = 0; i < fSubRecorders.size(); i++) {
+            fSubRecorders[i]->restoreToCount(1);
+            subPictureBytes += fSubRecorders[i]->approxBytesUsedBySubPictures();
+            recorders.push_back(fSubRecorders[i].get());
+            records.push_back(fSubRecords[i]);
+        }
+        pictList = join_recordings(fCullRect, recorders, records, &fRecord,
+                                   needBounds ? &bounds : nullptr);
+        fSubRecorders.clear();
+        fSubRecords.clear();
+    }
+
+    std::unique_ptr<const SkRecordOcclusion> occlusion;
+    if (needBounds) {
+        if (cullOccluded) {
+            occlusion = SkRecordOcclusion::Make(fCullRect, *fRecord, bounds);
+        }
+        if (fBBH.get()) {
+            fBBH->insert(bounds, fRecord->count());
 
-        // Now that we've calculated content bounds, we can update fCullRect, often trimming it.
-        // TODO: get updated fCullRect from bounds instead of forcing the BBH to return it?
-        SkRect bbhBound = fBBH->getRootBound();
-        SkASSERT((bbhBound.isEmpty() || fCullRect.contains(bbhBound))
-            || (bbhBound.isEmpty() && fCullRect.isEmpty()));
-        fCullRect = bbhBound;
+            // Now that we've calculated content bounds, we can update fCullRect, often trimming
+            // it.
+            // TODO: get updated fCullRect from bounds instead of forcing the BBH to return it?
+            SkRect bbhBound = fBBH->getRootBound();
+            SkASSERT((bbhBound.isEmpty() || fCullRect.contains(bbhBound))
+                || (bbhBound.isEmpty() && fCullRect.isEmpty()));
+            fCullRect = bbhBound;
+        }
     }
 
-    size_t subPictureBytes = fRecorder->approxBytesUsedBySubPictures();
     for (int i = 0; pictList && i < pictList->count(); i++) {
         subPictureBytes += pictList->begin()[i]->approximateBytesUsed();
     }
     return sk_make_sp<SkBigPicture>(fCullRect, fRecord.release(), pictList, fBBH.release(),
-                                    subPictureBytes);
+                                    subPictureBytes, std::move(occlusion));
 }
 
 sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPictureWithCull(const SkRect& cullRect,
@@ -115,6 +253,8 @@ void SkPictureRecorder::partialReplay(SkCanvas* canvas) const {
 
 sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable(uint32_t finishFlags) {
     fActivelyRecording = false;
+    fSubRecorders.clear();
+    fSubRecords.clear();
     fRecorder->flushMiniRecorder();
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
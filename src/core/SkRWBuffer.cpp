@@ -317,6 +317,19 @@ public:
         return fBuffer->size() == fGlobalOffset;
     }
 
+    const void* getMemoryChunk(size_t* size) override {
+        AUTO_VALIDATE
+        if (fLocalOffset == fIter.size()) {
+            // The current block is used up, so point at the next, as read() would.
+            fLocalOffset = 0;
+            if (!fIter.next()) {
+                return nullptr;
+            }
+        }
+        *size = fIter.size() - fLocalOffset;
+        return (const char*)fIter.data() + fLocalOffset;
+    }
+
     size_t getPosition() const override {
         return fGlobalOffset;
     }
@@ -11,7 +11,11 @@
 #include "../jumper/SkJumper.h"
 #include <algorithm>
 
-SkRasterPipeline::SkRasterPipeline(SkArenaAlloc* alloc) : fAlloc(alloc) {
+std::atomic<bool> gSkRasterPipelineFuseStages{true};
+
+SkRasterPipeline::SkRasterPipeline(SkArenaAlloc* alloc)
+    : fAlloc(alloc)
+    , fFuseStages(gSkRasterPipelineFuseStages) {
     this->reset();
 }
 void SkRasterPipeline::reset() {
@@ -25,10 +29,61 @@ void SkRasterPipeline::append(StockStage stage, void* ctx) {
     this->unchecked_append(stage, ctx);
 }
 void SkRasterPipeline::unchecked_append(StockStage stage, void* ctx) {
+    if (fFuseStages && this->try_fuse(stage, ctx)) {
+        return;
+    }
     fStages = fAlloc->make<StageList>( StageList{fStages, (uint64_t) stage, ctx, false} );
     fNumStages   += 1;
     fSlotsNeeded += ctx ? 2 : 1;
 }
+
+bool SkRasterPipeline::try_fuse(StockStage stage, void* ctx) {
+    // Each run of stages is listed first to last, ending with the stage being appended.
+    // Every stage in a run that takes a context must have the same one, which the compound
+    // stage then takes.
+    static const struct {
+        int        count;
+        StockStage run[3];
+        StockStage fused;
+    } kFusions[] = {
+        { 2, { seed_shader, matrix_2x3 },                 seed_shader_matrix_2x3 },
+        { 3, { load_8888_dst, srcover, store_8888 },      srcover_rgba_8888      },
+        { 3, { load_bgra_dst, srcover, store_bgra },      srcover_bgra_8888      },
+    };
+
+    for (const auto& fusion : kFusions) {
+        if (fusion.run[fusion.count-1] != stage) {
+            continue;
+        }
+        void* fusedCtx = ctx;
+        const StageList* st = fStages;
+        int i = fusion.count - 2;
+        for (; i >= 0 && st; i--, st = st->prev) {
+            if (st->rawFunction || st->stage != (uint64_t)fusion.run[i]) {
+                break;
+            }
+            if (st->ctx) {
+                if (fusedCtx && fusedCtx != st->ctx) {
+                    break;
+                }
+                fusedCtx = st->ctx;
+            }
+        }
+        if (i >= 0) {
+            continue;
+        }
+
+        // Pop the earlier stages of the run, then append the compound stage in their place.
+        for (int j = 0; j < fusion.count - 1; j++) {
+            fNumStages   -= 1;
+            fSlotsNeeded -= fStages->ctx ? 2 : 1;
+            fStages = fStages->prev;
+        }
+        this->unchecked_append(fusion.fused, fusedCtx);
+        return true;
+    }
+    return false;
+}
 void SkRasterPipeline::append(void* fn, void* ctx) {
     fStages = fAlloc->make<StageList>( StageList{fStages, (uint64_t) fn, ctx, true} );
     fNumStages   += 1;
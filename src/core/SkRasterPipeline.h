@@ -14,6 +14,7 @@
 #include "SkPM4f.h"
 #include "SkTArray.h"
 #include "SkTypes.h"
+#include <atomic>
 #include <functional>
 #include <vector>
 
@@ -32,10 +33,20 @@
  * vary depending on CPU feature detection.
  *
  * If you'd like to see how this works internally, you want to start digging around src/jumper.
+ *
+ * As stages are appended, a few common runs of stages are fused into hand-written compound
+ * stages, e.g. load_8888_dst -> srcover -> store_8888 on the same memory becomes a single
+ * srcover_rgba_8888.  Set gSkRasterPipelineFuseStages to false to bisect a suspected fusion bug,
+ * or call setFuseStages(false) to turn fusion off for one pipeline.
+ *
+ * run() and compile() can count the pixels and cycles spent in each stage into a StageProfiles.
+ * Setting gSkRasterPipelineProfileStages to true does that for every pipeline run or compiled from
+ * then on, into process-wide totals; see GetStageProfile() and DumpStageProfile().  Pipelines
+ * built without a profile run exactly as they would without profiling.
  */
 
 #define SK_RASTER_PIPELINE_STAGES(M)                               \
-    M(callback)                                                    \
+    M(callback) M(profile)                                         \
     M(move_src_dst) M(move_dst_src)                                \
     M(clamp_0) M(clamp_1) M(clamp_a) M(clamp_a_dst)                \
     M(unpremul) M(premul) M(premul_dst)                            \
@@ -43,7 +54,7 @@
     M(set_rgb) M(swap_rb) M(invert)                                \
     M(from_srgb) M(from_srgb_dst) M(to_srgb)                       \
     M(black_color) M(white_color) M(uniform_color)                 \
-    M(seed_shader) M(dither)                                       \
+    M(seed_shader) M(seed_shader_matrix_2x3) M(dither)             \
     M(load_a8)   M(load_a8_dst)   M(store_a8)   M(gather_a8)       \
     M(load_g8)   M(load_g8_dst)                 M(gather_g8)       \
     M(load_565)  M(load_565_dst)  M(store_565)  M(gather_565)      \
@@ -53,7 +64,7 @@
     M(load_8888) M(load_8888_dst) M(store_8888) M(gather_8888)     \
     M(load_bgra) M(load_bgra_dst) M(store_bgra) M(gather_bgra)     \
     M(load_1010102) M(load_1010102_dst) M(store_1010102) M(gather_1010102) \
-    M(bilerp_clamp_8888)                                           \
+    M(bilerp_clamp_8888) M(bilerp_tile_8888)                       \
     M(load_u16_be) M(load_rgb_u16_be) M(store_u16_be)              \
     M(load_tables_u16_be) M(load_tables_rgb_u16_be) M(load_tables) \
     M(load_rgba) M(store_rgba)                                     \
@@ -87,6 +98,7 @@
     M(evenly_spaced_gradient)                                      \
     M(gradient)                                                    \
     M(evenly_spaced_2_stop_gradient)                               \
+    M(gradient_lut)                                                \
     M(xy_to_unit_angle)                                            \
     M(xy_to_radius)                                                \
     M(xy_to_2pt_conical_strip)                                     \
@@ -101,7 +113,13 @@
     M(byte_tables) M(byte_tables_rgb)                              \
     M(rgb_to_hsl) M(hsl_to_rgb)                                    \
     M(clut_3D) M(clut_4D)                                          \
-    M(gauss_a_to_rgba)
+    M(gauss_a_to_rgba) M(rrect_shadow)
+
+extern std::atomic<bool> gSkRasterPipelineFuseStages;
+extern std::atomic<bool> gSkRasterPipelineProfileStages;
+
+class SkJSONWriter;
+struct SkJumper_ProfileCtx;
 
 class SkRasterPipeline {
 public:
@@ -120,6 +138,11 @@ public:
         SK_RASTER_PIPELINE_STAGES(M)
     #undef M
     };
+    static constexpr int kNumStockStages = 0
+    #define M(stage) +1
+        SK_RASTER_PIPELINE_STAGES(M);
+    #undef M
+
     void append(StockStage, void* = nullptr);
     void append(StockStage stage, const void* ctx) { this->append(stage, const_cast<void*>(ctx)); }
     // For raw functions (i.e. from a JIT).  Don't use this unless you know exactly what fn needs to
@@ -129,11 +152,58 @@ public:
     // Append all stages to this pipeline.
     void extend(const SkRasterPipeline&);
 
+    // Whether stages appended from now on may be fused.  Starts as gSkRasterPipelineFuseStages
+    // was when this pipeline was created.
+    void setFuseStages(bool fuse) { fFuseStages = fuse; }
+
+    struct StageProfile {
+        uint64_t fPixels;
+        uint64_t fCycles;   // rdtsc on x86, the virtual timer on ARMv8, otherwise always 0
+    };
+
+    // Totals for each stock stage, and one more for all raw functions, across the pipelines
+    // profiled into it.  Each profiled run counts privately and adds its counts in when it's
+    // done, so one StageProfiles may be shared by pipelines running on several threads.
+    class StageProfiles {
+    public:
+        StageProfiles() { this->reset(); }
+
+        StageProfile get(StockStage) const;
+        void reset();
+        // Writes an array of {stage, pixels, cycles, cycles_per_pixel} for each stage that ran.
+        void dump(SkJSONWriter*) const;
+
+    private:
+        friend class SkRasterPipeline;
+
+        std::atomic<uint64_t> fPixels[kNumStockStages + 1];
+        std::atomic<uint64_t> fCycles[kNumStockStages + 1];
+    };
+
     // Runs the pipeline in 2d from (x,y) inclusive to (x+w,y+h) exclusive.
-    void run(size_t x, size_t y, size_t w, size_t h) const;
+    // If profiles is non-null, adds the pixels and cycles spent in each stage to it.
+    void run(size_t x, size_t y, size_t w, size_t h, StageProfiles* profiles = nullptr) const;
 
     // Allocates a thunk which amortizes run() setup cost in alloc.
-    std::function<void(size_t, size_t, size_t, size_t)> compile() const;
+    // The choice of stage functions is memoized in a per-thread LRU cache keyed on the list of
+    // stages and which of them have a context, so recurring pipelines only need to patch in their
+    // new context pointers.  A thunk profiled into profiles is never cached, and acts like run().
+    std::function<void(size_t, size_t, size_t, size_t)> compile(
+            StageProfiles* profiles = nullptr) const;
+
+    struct ProgramCacheStats {
+        int fHits;
+        int fMisses;
+        int fCount;     // number of programs currently cached
+    };
+    // The stats of, and purging, the calling thread's cache.
+    static ProgramCacheStats GetProgramCacheStats();
+    static void PurgeProgramCache();
+
+    // The process-wide totals gSkRasterPipelineProfileStages profiles into.
+    static StageProfile GetStageProfile(StockStage);
+    static void ResetStageProfile();
+    static void DumpStageProfile(SkJSONWriter*);
 
     void dump() const;
 
@@ -163,14 +233,36 @@ private:
     };
 
     using StartPipelineFn = void(*)(size_t,size_t,size_t,size_t, void** program);
-    StartPipelineFn build_pipeline(void**) const;
+    // Writes the program back to front, ending just before ip, and points *program at its
+    // first slot.  That may not be the start of the slots allocated; lowp drops some stages.
+    // If profileCtxs is non-null, it's the fNumStages+1 contexts from init_profile(), and the
+    // program interleaves profile stages with ours, needing profile_slots() more slots.
+    StartPipelineFn build_pipeline(void** ip, void*** program,
+                                   const SkJumper_ProfileCtx* profileCtxs = nullptr) const;
+    int profile_slots() const { return 2*(fNumStages + 1); }
+    // Points profileCtxs at last and at cycles[i] and pixels[i] for the i-th stage of fStages,
+    // counting back to front from 1; add_profile() adds those into profiles by stock stage.
+    void init_profile(SkJumper_ProfileCtx* profileCtxs, uint64_t* last,
+                      uint64_t* cycles, uint64_t* pixels) const;
+    void add_profile(StageProfiles* profiles,
+                     const uint64_t* cycles, const uint64_t* pixels) const;
+
+    // A stable hash of the stage list and of which stages have a context (but not their values).
+    uint32_t program_hash() const;
+
+    friend class SkRasterPipelineProgramCache;
 
     void unchecked_append(StockStage, void*);
 
+    // If appending this stage completes a run of stages we have a compound stage for,
+    // replaces that run with the compound stage and returns true.
+    bool try_fuse(StockStage, void*);
+
     SkArenaAlloc* fAlloc;
     StageList*    fStages;
     int           fNumStages;
     int           fSlotsNeeded;
+    bool          fFuseStages;
 };
 
 template <size_t bytes>
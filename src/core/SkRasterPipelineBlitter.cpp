@@ -115,7 +115,8 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
                                                is_opaque, is_constant);
     }
 
-    if (shader->appendStages({&shaderPipeline, alloc, dstCS, paint, nullptr, ctm})) {
+    if (shader->appendStages({&shaderPipeline, alloc, dst.colorType(), dstCS, paint, nullptr,
+                              ctm})) {
         if (paintColor.a() != 1.0f) {
             shaderPipeline.append(SkRasterPipeline::scale_1_float,
                                   alloc->make<float>(paintColor.a()));
@@ -306,14 +307,17 @@ void SkRasterPipelineBlitter::blitH(int x, int y, int w) {
 
 void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
     if (fCanMemsetInBlitRect) {
-        for (int ylimit = y+h; y < ylimit; y++) {
-            switch (fDst.shiftPerPixel()) {
-                case 0:    memset  (fDst.writable_addr8 (x,y), fMemsetColor, w); break;
-                case 1: sk_memset16(fDst.writable_addr16(x,y), fMemsetColor, w); break;
-                case 2: sk_memset32(fDst.writable_addr32(x,y), fMemsetColor, w); break;
-                case 3: sk_memset64(fDst.writable_addr64(x,y), fMemsetColor, w); break;
-                default: break;
-            }
+        const size_t rb = fDst.rowBytes();
+        switch (fDst.shiftPerPixel()) {
+            case 0:
+                for (int ylimit = y+h; y < ylimit; y++) {
+                    memset(fDst.writable_addr8(x,y), fMemsetColor, w);
+                }
+                break;
+            case 1: sk_rect_memset16(fDst.writable_addr16(x,y), fMemsetColor, w, rb, h); break;
+            case 2: sk_rect_memset32(fDst.writable_addr32(x,y), fMemsetColor, w, rb, h); break;
+            case 3: sk_rect_memset64(fDst.writable_addr64(x,y), fMemsetColor, w, rb, h); break;
+            default: break;
         }
         return;
     }
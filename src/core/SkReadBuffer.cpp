@@ -267,9 +267,18 @@ uint32_t SkReadBuffer::getArrayCount() {
 }
 
 sk_sp<SkImage> SkReadBuffer::readImage() {
+    std::function<sk_sp<SkImage>()> makeImage = this->readDeferredImage();
+    return makeImage ? makeImage() : nullptr;
+}
+
+std::function<sk_sp<SkImage>()> SkReadBuffer::readDeferredImage() {
     if (fInflator) {
         SkImage* img = fInflator->getImage(this->read32());
-        return img ? sk_ref_sp(img) : nullptr;
+        if (!img) {
+            return nullptr;
+        }
+        sk_sp<SkImage> image = sk_ref_sp(img);
+        return [image] { return image; };
     }
 
     int width = this->read32();
@@ -287,7 +296,7 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
     }
     if (size == 0) {
         // The image could not be encoded at serialization time - return an empty placeholder.
-        return MakeEmptyImage(width, height);
+        return [width, height] { return MakeEmptyImage(width, height); };
     }
 
     // we used to negate the size for "custom" encoded images -- ignore that signal (Dec-2017)
@@ -308,16 +317,20 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
         (void)this->read32();   // originY
     }
 
-    sk_sp<SkImage> image;
-    if (fProcs.fImageProc) {
-        image = fProcs.fImageProc(data->data(), data->size(), fProcs.fImageCtx);
-    }
-    if (!image) {
-        image = SkImage::MakeFromEncoded(std::move(data));
-    }
-    // Question: are we correct to return an "empty" image instead of nullptr, if the decoder
-    //           failed for some reason?
-    return image ? image : MakeEmptyImage(width, height);
+    SkDeserialImageProc imageProc = fProcs.fImageProc;
+    void* imageCtx = fProcs.fImageCtx;
+    return [data, width, height, imageProc, imageCtx] {
+        sk_sp<SkImage> image;
+        if (imageProc) {
+            image = imageProc(data->data(), data->size(), imageCtx);
+        }
+        if (!image) {
+            image = SkImage::MakeFromEncoded(data);
+        }
+        // Question: are we correct to return an "empty" image instead of nullptr, if the decoder
+        //           failed for some reason?
+        return image ? image : MakeEmptyImage(width, height);
+    };
 }
 
 sk_sp<SkTypeface> SkReadBuffer::readTypeface() {
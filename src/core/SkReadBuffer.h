@@ -24,6 +24,8 @@
 #include "SkTHash.h"
 #include "SkWriteBuffer.h"
 
+#include <functional>
+
 class SkImage;
 class SkInflator;
 
@@ -78,6 +80,8 @@ public:
         kRemoveHeaderFlags_Version         = 60,
         kTwoColorDrawShadow_Version        = 61,
         kDontNegateImageSize_Version       = 62,
+        kAlignedPictureTags_Version        = 63,
+        kSizedSubPictures_Version          = 64,
     };
 
     /**
@@ -185,6 +189,10 @@ public:
     // be created (e.g. it was not originally encoded) then this returns an image that doesn't
     // draw.
     sk_sp<SkImage> readImage();
+    // Reads an image like readImage(), but returns a function that creates it (from its encoded
+    // data, or with the image proc), so that the image can be created on another thread. Returns
+    // an empty function if there is a real error.
+    std::function<sk_sp<SkImage>()> readDeferredImage();
     sk_sp<SkTypeface> readTypeface();
 
     void setTypefaceArray(SkTypeface* array[], int count) {
@@ -216,6 +224,7 @@ public:
     }
 
     void setDeserialProcs(const SkDeserialProcs& procs);
+    const SkDeserialProcs& getDeserialProcs() const { return fProcs; }
 
     /**
      *  If isValid is false, sets the buffer to be "invalid". Returns true if the buffer
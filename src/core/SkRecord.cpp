@@ -27,6 +27,22 @@ size_t SkRecord::bytesUsed() const {
     return bytes;
 }
 
+void SkRecord::concat(sk_sp<SkRecord> other) {
+    SkASSERT(other && other.get() != this);
+    if (fCount + other->fCount > fReserved) {
+        fReserved = fCount + other->fCount;
+        fRecords.realloc(fReserved);
+    }
+    memcpy(fRecords.get() + fCount, other->fRecords.get(), other->fCount * sizeof(Record));
+    fCount += other->fCount;
+    fApproxBytesAllocated += other->fApproxBytesAllocated;
+
+    // other no longer owns its commands, only the memory they live in.
+    other->fCount = 0;
+    other->fApproxBytesAllocated = 0;
+    fConcatenated.push_back(std::move(other));
+}
+
 void SkRecord::defrag() {
     // Remove all the NoOps, preserving the order of other ops, e.g.
     //      Save, ClipRect, NoOp, DrawRect, NoOp, NoOp, Restore
@@ -10,6 +10,7 @@
 
 #include "SkArenaAlloc.h"
 #include "SkRecords.h"
+#include "SkTArray.h"
 #include "SkTLogic.h"
 #include "SkTemplates.h"
 
@@ -102,6 +103,10 @@ public:
     // need to iterate with a visitor to measure those they care for.
     size_t bytesUsed() const;
 
+    // Move all of other's commands to the end of this SkRecord without copying them.  This
+    // SkRecord keeps other (and so the memory holding the commands) alive, and other is left empty.
+    void concat(sk_sp<SkRecord> other);
+
     // Rearrange and resize this record to eliminate any NoOps.
     // May change count() and the indices of ops, but preserves their order.
     void defrag();
@@ -191,6 +196,9 @@ private:
     // chunks, returning a stable handle to that data for later retrieval.
     SkArenaAlloc fAlloc{256};
     size_t       fApproxBytesAllocated{0};
+
+    // Records whose commands were moved here by concat().  They own memory our commands point to.
+    SkTArray<sk_sp<SkRecord>> fConcatenated;
 };
 
 #endif//SkRecord_DEFINED
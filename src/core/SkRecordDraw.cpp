@@ -6,8 +6,16 @@
  */
 
 #include "SkRecordDraw.h"
+#include "SkExecutor.h"
 #include "SkImage.h"
 #include "SkPatchUtils.h"
+#include "SkPictureLayerCache.h"
+#include "SkPixmap.h"
+#include "SkShader.h"
+#include "SkTaskGroup.h"
+
+#include <algorithm>
+#include <thread>
 
 void SkRecordDraw(const SkRecord& record,
                   SkCanvas* canvas,
@@ -15,9 +23,16 @@ void SkRecordDraw(const SkRecord& record,
                   SkDrawable* const drawables[],
                   int drawableCount,
                   const SkBBoxHierarchy* bbh,
-                  SkPicture::AbortCallback* callback) {
+                  SkPicture::AbortCallback* callback,
+                  const SkRecordOcclusion* occlusion,
+                  uint32_t layerCachePictureID) {
     SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
 
+    const SkMatrix ctm = canvas->getTotalMatrix();
+    if (!ctm.rectStaysRect()) {
+        occlusion = nullptr;
+    }
+
     if (bbh) {
         // Draw only ops that affect pixels in the canvas's current clip.
         // The SkRecord and BBH were recorded in identity space.  This canvas
@@ -30,6 +45,7 @@ void SkRecordDraw(const SkRecord& record,
         bbh->search(query, &ops);
 
         SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
+        int cachedRestore = -1;
         for (int i = 0; i < ops.count(); i++) {
             if (callback && callback->abort()) {
                 return;
@@ -37,6 +53,17 @@ void SkRecordDraw(const SkRecord& record,
             // This visit call uses the SkRecords::Draw::operator() to call
             // methods on the |canvas|, wrapped by methods defined with the
             // DRAW() macro.
+            if (ops[i] <= cachedRestore ||
+                (occlusion && occlusion->isOccluded(ops[i], ctm))) {
+                continue;
+            }
+            if (layerCachePictureID != SK_InvalidUniqueID) {
+                cachedRestore = SkPictureLayerCache::DrawLayer(layerCachePictureID, record,
+                                                               ops[i], canvas, ctm);
+                if (cachedRestore >= 0) {
+                    continue;
+                }
+            }
             record.visit(ops[i], draw);
         }
     } else {
@@ -49,6 +76,17 @@ void SkRecordDraw(const SkRecord& record,
             // This visit call uses the SkRecords::Draw::operator() to call
             // methods on the |canvas|, wrapped by methods defined with the
             // DRAW() macro.
+            if (occlusion && occlusion->isOccluded(i, ctm)) {
+                continue;
+            }
+            if (layerCachePictureID != SK_InvalidUniqueID) {
+                int restore = SkPictureLayerCache::DrawLayer(layerCachePictureID, record, i,
+                                                             canvas, ctm);
+                if (restore >= 0) {
+                    i = restore;
+                    continue;
+                }
+            }
             record.visit(i, draw);
         }
     }
@@ -67,6 +105,91 @@ void SkRecordPartialDraw(const SkRecord& record, SkCanvas* canvas,
     }
 }
 
+// Cut [0, height) into regionCount regions, returning their tops (plus height at the end). With a
+// BBH we count the ops touching each of a number of thin strips, and then give every region about
+// the same number of ops to draw.
+static void cut_parallel_regions(const SkBBoxHierarchy* bbh, int width, int height,
+                                 int regionCount, SkTDArray<int>* tops) {
+    static constexpr int kStripsPerRegion = 8;
+
+    int stripCount = bbh ? SkTMin(height, regionCount * kStripsPerRegion) : 0;
+    SkTDArray<int> opCounts;
+    int totalOps = 0;
+    for (int i = 0; i < stripCount; ++i) {
+        SkTDArray<int> ops;
+        bbh->search(SkRect::MakeLTRB(0, height * i / stripCount,
+                                     width, height * (i + 1) / stripCount), &ops);
+        opCounts.push(ops.count());
+        totalOps += ops.count();
+    }
+
+    tops->push(0);
+    if (totalOps == 0) {
+        for (int i = 1; i < regionCount; ++i) {
+            tops->push(height * i / regionCount);
+        }
+    } else {
+        int strip = 0, opsBeforeStrip = 0;
+        for (int i = 1; i < regionCount && strip < stripCount; ++i) {
+            int targetOps = totalOps * i / regionCount;
+            while (strip < stripCount && opsBeforeStrip + opCounts[strip] <= targetOps) {
+                opsBeforeStrip += opCounts[strip++];
+            }
+            int top = height * strip / stripCount;
+            if (top > tops->top()) {
+                tops->push(top);
+            }
+        }
+    }
+    if (tops->top() < height) {
+        tops->push(height);
+    }
+}
+
+void SkRecordDrawParallel(const SkPicture* picture, const SkPixmap& dst, SkExecutor* executor,
+                          int regionCount) {
+    if (regionCount <= 0) {
+        // A few regions per thread so threads that finish early can pick up more work.
+        regionCount = 4 * SkTMax(1, (int)std::thread::hardware_concurrency());
+    }
+    regionCount = SkTMin(regionCount, dst.height());
+    if (regionCount <= 1) {
+        SkBitmap bitmap;
+        if (bitmap.installPixels(dst)) {
+            SkCanvas canvas(bitmap);
+            picture->playback(&canvas);
+        }
+        return;
+    }
+
+    const SkBigPicture* bigPicture = picture->asSkBigPicture();
+    const SkBBoxHierarchy* bbh = bigPicture ? bigPicture->bbh() : nullptr;
+
+    SkTDArray<int> tops;
+    cut_parallel_regions(bbh, dst.width(), dst.height(), regionCount, &tops);
+
+    SkTaskGroup tg(executor ? *executor : SkExecutor::GetDefault());
+    for (int i = 0; i + 1 < tops.count(); ++i) {
+        SkIRect region = SkIRect::MakeLTRB(0, tops[i], dst.width(), tops[i + 1]);
+        tg.add([picture, dst, region] {
+            SkPixmap subset;
+            if (!dst.extractSubset(&subset, region)) {
+                return;
+            }
+            SkBitmap bitmap;
+            if (!bitmap.installPixels(subset)) {
+                return;
+            }
+            // The canvas' device covers only this region, so everything outside is clipped out,
+            // and SkBigPicture::playback will only visit the ops that the BBH finds touching it.
+            SkCanvas canvas(bitmap);
+            canvas.translate(-SkIntToScalar(region.fLeft), -SkIntToScalar(region.fTop));
+            picture->playback(&canvas);
+        });
+    }
+    tg.wait();
+}
+
 namespace SkRecords {
 
 // NoOps draw nothing.
@@ -565,6 +688,255 @@ private:
 
 }  // namespace SkRecords
 
+namespace SkRecords {
+
+// What an op means for occlusion culling.
+struct OcclusionInfo {
+    SkRect fOpaque;      // Identity space rect this op fills with opaque pixels, or empty.
+    bool   fOccludable;  // Can this op be skipped if a later op covers its bounds?
+    bool   fBarrier;     // Does this op read pixels drawn before it outside its own bounds?
+};
+
+// Walks an SkRecord forward, tracking the matrix and an inner bound of the clip, and fills in the
+// OcclusionInfo of each op. Only draws outside of layers are opaque: a layer composites its
+// content with the layer paint, and it is its Restore that draws over earlier ops.
+class FindOcclusionInfo : SkNoncopyable {
+public:
+    FindOcclusionInfo(const SkRect& cullRect, OcclusionInfo infos[])
+        : fCullRect(cullRect), fInfos(infos) {
+        fStack.push_back({ SkMatrix::I(), cullRect, 0 });
+    }
+
+    void setCurrentOp(int op) {
+        fInfo = &fInfos[op];
+        *fInfo = { SkRect::MakeEmpty(), false, false };
+    }
+
+    template <typename T> void operator()(const T& op) {
+        this->updateState(op);
+        this->classify(op);
+        this->findOpaque(op);
+    }
+
+private:
+    struct State {
+        SkMatrix ctm;
+        SkRect   clip;        // Pixels inside this identity space rect are not clipped out.
+        int      layerDepth;
+    };
+
+    State& state() { return fStack.back(); }
+
+    static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
+    static const SkPaint* AsPtr(const Optional<SkPaint>& p) { return p; }
+
+    void intersectClip(const SkRect& rect, SkClipOp op, bool mapRect) {
+        SkRect clip = rect.makeSorted();
+        if (SkClipOp::kIntersect != op || (mapRect && !this->state().ctm.rectStaysRect())) {
+            // We can't describe what is left of the clip with a rect.
+            this->state().clip.setEmpty();
+            return;
+        }
+        if (mapRect) {
+            this->state().ctm.mapRect(&clip);
+        }
+        if (!this->state().clip.intersect(clip)) {
+            this->state().clip.setEmpty();
+        }
+    }
+
+    template <typename T> void updateState(const T&) {}
+    void updateState(const Save&) { fStack.push_back(this->state()); }
+    void updateState(const SaveLayer& op) {
+        fStack.push_back(this->state());
+        this->state().layerDepth++;
+        fInfo->fBarrier = SkToBool(op.backdrop);
+    }
+    void updateState(const Restore&) {
+        if (fStack.count() > 1) {
+            fStack.pop_back();
+        }
+    }
+    void updateState(const SetMatrix& op) { this->state().ctm = op.matrix; }
+    void updateState(const Concat& op)    { this->state().ctm.preConcat(op.matrix); }
+    void updateState(const Translate& op) { this->state().ctm.preTranslate(op.dx, op.dy); }
+    void updateState(const ClipRect& op) {
+        this->intersectClip(op.rect, op.opAA.op(), true);
+    }
+    void updateState(const ClipRRect& op) {
+        if (op.rrect.isRect()) {
+            this->intersectClip(op.rrect.rect(), op.opAA.op(), true);
+        } else {
+            this->state().clip.setEmpty();
+        }
+    }
+    void updateState(const ClipPath& op) {
+        SkRect rect;
+        if (!op.path.isInverseFillType() && op.path.isRect(&rect)) {
+            this->intersectClip(rect, op.opAA.op(), true);
+        } else {
+            this->state().clip.setEmpty();
+        }
+    }
+    void updateState(const ClipRegion& op) {
+        // Regions are in device space.
+        if (op.region.isRect()) {
+            this->intersectClip(SkRect::Make(op.region.getBounds()), op.op, false);
+        } else {
+            this->state().clip.setEmpty();
+        }
+    }
+
+    // Pictures and drawables may contain layers with backdrops, which read what was drawn before.
+    void classify(const DrawPicture&)  { fInfo->fBarrier = true; }
+    void classify(const DrawDrawable&) { fInfo->fBarrier = true; }
+    // Points and hairlines touch pixels outside of their bounds when the matrix scales down.
+    void classify(const DrawPoints&) {}
+
+    template <typename T>
+    SK_WHEN((T::kTags & kDrawWithPaint_Tag) == kDrawWithPaint_Tag, void) classify(const T& op) {
+        const SkPaint* paint = AsPtr(op.paint);
+        fInfo->fOccludable = !paint || SkPaint::kFill_Style == paint->getStyle() ||
+                             paint->getStrokeWidth() > 0;
+    }
+    template <typename T>
+    SK_WHEN((T::kTags & kDrawWithPaint_Tag) == kDraw_Tag, void) classify(const T&) {
+        fInfo->fOccludable = true;
+    }
+    template <typename T>
+    SK_WHEN(!(T::kTags & kDraw_Tag), void) classify(const T&) {}
+
+    // Does a draw with this paint replace every pixel it fully covers with an opaque color?
+    // Images ignore the paint's shader; other draws need it to be opaque.
+    static bool PaintIsOpaque(const SkPaint* paint, bool usesShader) {
+        if (!paint) {
+            return true;
+        }
+        return (paint->isSrcOver() || SkBlendMode::kSrc == paint->getBlendMode()) &&
+               0xFF == paint->getAlpha() && SkPaint::kFill_Style == paint->getStyle() &&
+               (!usesShader || !paint->getShader() || paint->getShader()->isOpaque()) &&
+               !paint->getColorFilter() && !paint->getMaskFilter() &&
+               !paint->getPathEffect() && !paint->getImageFilter() && !paint->getLooper();
+    }
+
+    void setOpaque(const SkRect& rect) {
+        const State& state = this->state();
+        if (state.layerDepth > 0 || !state.ctm.rectStaysRect()) {
+            return;
+        }
+        SkRect opaque;
+        state.ctm.mapRect(&opaque, rect.makeSorted());
+        if (opaque.intersect(state.clip) && opaque.intersect(fCullRect)) {
+            fInfo->fOpaque = opaque;
+        }
+    }
+
+    template <typename T> void findOpaque(const T&) {}
+    void findOpaque(const DrawRect& op) {
+        if (PaintIsOpaque(&op.paint, true)) {
+            this->setOpaque(op.rect);
+        }
+    }
+    void findOpaque(const DrawPaint& op) {
+        // The paint fills the whole clip, whatever the matrix.
+        SkRect opaque = this->state().clip;
+        if (0 == this->state().layerDepth && PaintIsOpaque(&op.paint, true) &&
+            opaque.intersect(fCullRect)) {
+            fInfo->fOpaque = opaque;
+        }
+    }
+    void findOpaque(const DrawImage& op) {
+        if (op.image->isOpaque() && PaintIsOpaque(op.paint, false)) {
+            this->setOpaque(SkRect::MakeXYWH(op.left, op.top,
+                                             op.image->width(), op.image->height()));
+        }
+    }
+    void findOpaque(const DrawImageRect& op) {
+        if (op.image->isOpaque() && PaintIsOpaque(op.paint, false)) {
+            this->setOpaque(op.dst);
+        }
+    }
+
+    const SkRect              fCullRect;
+    OcclusionInfo*            fInfos;
+    OcclusionInfo*            fInfo = nullptr;
+    SkSTArray<16, State>      fStack;
+};
+
+}  // namespace SkRecords
+
+std::unique_ptr<SkRecordOcclusion> SkRecordOcclusion::Make(const SkRect& cullRect,
+                                                           const SkRecord& record,
+                                                           const SkRect bounds[]) {
+    // We only keep the largest few occluders around while walking back to front.
+    static constexpr int kMaxOccluders = 4;
+
+    SkAutoTMalloc<SkRecords::OcclusionInfo> infos(record.count());
+    SkRecords::FindOcclusionInfo visitor(cullRect, infos.get());
+    for (int i = 0; i < record.count(); i++) {
+        visitor.setCurrentOp(i);
+        record.visit(i, visitor);
+    }
+
+    std::unique_ptr<SkRecordOcclusion> occlusion(new SkRecordOcclusion);
+    SkSTArray<kMaxOccluders, SkRect> occluders;
+    for (int i = record.count() - 1; i >= 0; i--) {
+        const SkRecords::OcclusionInfo& info = infos[i];
+        if (info.fBarrier) {
+            occluders.reset();
+        }
+        if (info.fOccludable && !bounds[i].isEmpty()) {
+            const SkRect* occluder = std::find_if(occluders.begin(), occluders.end(),
+                                                  [&](const SkRect& r) {
+                return r.contains(bounds[i]);
+            });
+            if (occluder != occluders.end()) {
+                *occlusion->fOccluded.append() = { i, bounds[i], *occluder };
+                continue;
+            }
+        }
+        if (info.fOpaque.isEmpty()) {
+            continue;
+        }
+        auto area = [](const SkRect& r) { return r.width() * r.height(); };
+        if (occluders.count() < kMaxOccluders) {
+            occluders.push_back(info.fOpaque);
+        } else {
+            SkRect* smallest = std::min_element(occluders.begin(), occluders.end(),
+                                                [&](const SkRect& a, const SkRect& b) {
+                return area(a) < area(b);
+            });
+            if (area(*smallest) < area(info.fOpaque)) {
+                *smallest = info.fOpaque;
+            }
+        }
+    }
+    if (occlusion->fOccluded.isEmpty()) {
+        return nullptr;
+    }
+    std::reverse(occlusion->fOccluded.begin(), occlusion->fOccluded.end());
+    return occlusion;
+}
+
+bool SkRecordOcclusion::isOccluded(int op, const SkMatrix& ctm) const {
+    const Occluded* occluded = std::lower_bound(fOccluded.begin(), fOccluded.end(), op,
+                                                [](const Occluded& o, int op) {
+        return o.fOp < op;
+    });
+    if (occluded == fOccluded.end() || occluded->fOp != op) {
+        return false;
+    }
+    SkASSERT(ctm.rectStaysRect());
+    // Pixels fully inside the occluder are opaque whether or not it is anti-aliased, and
+    // the op can only touch pixels that intersect its bounds.
+    SkRect occluder, bounds;
+    ctm.mapRect(&occluder, occluded->fOccluder);
+    ctm.mapRect(&bounds, occluded->fBounds);
+    SkIRect inner;
+    occluder.roundIn(&inner);
+    return inner.contains(bounds.roundOut());
+}
+
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record, SkRect bounds[]) {
     SkRecords::FillBounds visitor(cullRect, record, bounds);
     for (int curOp = 0; curOp < record.count(); curOp++) {
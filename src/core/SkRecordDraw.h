@@ -13,9 +13,14 @@
 #include "SkCanvas.h"
 #include "SkMatrix.h"
 #include "SkRecord.h"
+#include "SkTDArray.h"
+
+#include <memory>
 
 class SkDrawable;
+class SkExecutor;
 class SkLayerInfo;
+class SkPixmap;
 
 // Calculate conservative identity space bounds for each op in the record.
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord&, SkRect bounds[]);
@@ -26,10 +31,40 @@ void SkRecordFillBounds(const SkRect& cullRect, const SkRecord&, SkRect bounds[]
 void SkRecordComputeLayers(const SkRect& cullRect, const SkRecord&, SkRect bounds[],
                            const SkBigPicture::SnapshotArray*, SkLayerInfo* data);
 
+// The draws of an SkRecord that are entirely covered by opaque draws after them, which playback
+// can skip. It is computed back to front from the SkRecordFillBounds() bounds of each draw, and
+// conservative opaque bounds of the rects, paints and opaque images drawn outside of layers.
+class SkRecordOcclusion : SkNoncopyable {
+public:
+    // Returns null if no draw is occluded.
+    static std::unique_ptr<SkRecordOcclusion> Make(const SkRect& cullRect, const SkRecord&,
+                                                   const SkRect bounds[]);
+
+    // Is the op covered when the record is drawn with this (rectStaysRect) matrix? Both bounds are
+    // mapped to device space, so pixels the occluder only partially covers are never skipped.
+    bool isOccluded(int op, const SkMatrix& ctm) const;
+
+    int count() const { return fOccluded.count(); }
+    size_t bytesUsed() const { return sizeof(*this) + fOccluded.bytes(); }
+
+private:
+    struct Occluded {
+        int    fOp;
+        SkRect fBounds;    // Identity space bounds of the op.
+        SkRect fOccluder;  // Identity space rect that a later op fills with opaque pixels.
+    };
+
+    SkTDArray<Occluded> fOccluded;  // Sorted by op.
+};
+
 // Draw an SkRecord into an SkCanvas.  A convenience wrapper around SkRecords::Draw.
+// When occlusion is given, draws it marks as covered are skipped.
+// When layerCachePictureID is valid, layers are drawn through SkPictureLayerCache.
 void SkRecordDraw(const SkRecord&, SkCanvas*, SkPicture const* const drawablePicts[],
                   SkDrawable* const drawables[], int drawableCount,
-                  const SkBBoxHierarchy*, SkPicture::AbortCallback*);
+                  const SkBBoxHierarchy*, SkPicture::AbortCallback*,
+                  const SkRecordOcclusion* occlusion = nullptr,
+                  uint32_t layerCachePictureID = SK_InvalidUniqueID);
 
 // Draw a portion of an SkRecord into an SkCanvas.
 // When drawing a portion of an SkRecord the CTM on the passed in canvas must be
@@ -40,6 +75,14 @@ void SkRecordPartialDraw(const SkRecord&, SkCanvas*,
                          SkPicture const* const drawablePicts[], int drawableCount,
                          int start, int stop, const SkMatrix& initialCTM);
 
+// Draw a picture into a raster destination on multiple threads. The destination is split into up
+// to regionCount horizontal regions that are drawn at the same time on the executor, each with its
+// own canvas clipped to the region. When the picture has a BBH, the regions are cut so that they
+// all draw about the same number of ops; otherwise they all get the same height. When regionCount
+// is <= 0, we pick a count that keeps all cores busy. A null executor means SkExecutor::GetDefault().
+void SkRecordDrawParallel(const SkPicture*, const SkPixmap& dst, SkExecutor*,
+                          int regionCount = 0);
+
 namespace SkRecords {
 
 // This is an SkRecord visitor that will draw that SkRecord to an SkCanvas.
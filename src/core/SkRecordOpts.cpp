@@ -10,6 +10,7 @@
 #include "SkCanvasPriv.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkShader.h"
 #include "SkTDArray.h"
 
 using namespace SkRecords;
@@ -19,36 +20,99 @@ using namespace SkRecords;
 //   - a bool onMatch(SkRceord*, Match*, int begin, int end) method,
 //     which returns true if it made changes and false if not.
 
-// Run a pattern-based optimization once across the SkRecord, returning true if it made any changes.
+// Run a pattern-based optimization once across the SkRecord, returning how many matches it changed.
 // It looks for spans which match Pass::Match, and when found calls onMatch() with that pattern,
 // record, and [begin,end) span of the commands that matched.
 template <typename Pass>
-static bool apply(Pass* pass, SkRecord* record) {
+static int apply(Pass* pass, SkRecord* record) {
     typename Pass::Match match;
-    bool changed = false;
+    int changes = 0;
     int begin, end = 0;
 
     while (match.search(record, &begin, &end)) {
-        changed |= pass->onMatch(record, &match, begin, end);
+        changes += pass->onMatch(record, &match, begin, end) ? 1 : 0;
     }
-    return changed;
+    return changes;
+}
+
+// Like apply(), but the last command of each match may also start the next one, for passes that
+// compare neighboring draws.
+template <typename Pass>
+static int apply_chained(Pass* pass, SkRecord* record) {
+    typename Pass::Match match;
+    int changes = 0;
+    int begin, end = 0;
+
+    while (match.search(record, &begin, &end)) {
+        changes += pass->onMatch(record, &match, begin, end) ? 1 : 0;
+        end -= 1;
+    }
+    return changes;
+}
+
+// Applies a pass until it stops changing the record, and returns the total number of changes.
+template <typename Pass>
+static int apply_until_done(Pass* pass, SkRecord* record) {
+    int changes = 0;
+    while (int n = apply(pass, record)) {
+        changes += n;
+    }
+    return changes;
+}
+
+// apply_until_done() for passes run with apply_chained().
+template <typename Pass>
+static int apply_chained_until_done(Pass* pass, SkRecord* record) {
+    int changes = 0;
+    while (int n = apply_chained(pass, record)) {
+        changes += n;
+    }
+    return changes;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-static void multiple_set_matrices(SkRecord* record) {
+// A SetMatrix replaces whatever matrix ops came right before it.
+static int overwritten_matrices(SkRecord* record) {
     struct {
-        typedef Pattern<Is<SetMatrix>,
+        typedef Pattern<Or<Is<SetMatrix>, Is<Concat>, Is<Translate>>,
                         Greedy<Is<NoOp>>,
                         Is<SetMatrix> >
             Match;
 
         bool onMatch(SkRecord* record, Match* pattern, int begin, int end) {
-            record->replace<NoOp>(begin);  // first SetMatrix
+            record->replace<NoOp>(begin);  // first matrix op
             return true;
         }
     } pass;
-    while (apply(&pass, record));
+    return apply_until_done(&pass, record);
+}
+
+// Consecutive Concats (or Translates) are merged into the last one.
+static int merged_matrices(SkRecord* record) {
+    struct {
+        typedef Pattern<Is<Concat>, Greedy<Is<NoOp>>, Is<Concat>> Match;
+
+        bool onMatch(SkRecord* record, Match* pattern, int begin, int end) {
+            Concat* last = pattern->third<Concat>();
+            last->matrix = TypedMatrix(SkMatrix::Concat(pattern->first<Concat>()->matrix,
+                                                        last->matrix));
+            record->replace<NoOp>(begin);
+            return true;
+        }
+    } concats;
+    struct {
+        typedef Pattern<Is<Translate>, Greedy<Is<NoOp>>, Is<Translate>> Match;
+
+        bool onMatch(SkRecord* record, Match* pattern, int begin, int end) {
+            Translate* last = pattern->third<Translate>();
+            last->dx += pattern->first<Translate>()->dx;
+            last->dy += pattern->first<Translate>()->dy;
+            record->replace<NoOp>(begin);
+            return true;
+        }
+    } translates;
+    return apply_until_done(&concats, record) + apply_until_done(&translates, record);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -164,12 +228,19 @@ struct SaveNoDrawsRestoreNooper {
         return true;
     }
 };
-void SkRecordNoopSaveRestores(SkRecord* record) {
+static int noop_save_restores(SkRecord* record) {
     SaveOnlyDrawsRestoreNooper onlyDraws;
     SaveNoDrawsRestoreNooper noDraws;
 
     // Run until they stop changing things.
-    while (apply(&onlyDraws, record) || apply(&noDraws, record));
+    int changes = 0;
+    while (int n = apply(&onlyDraws, record) + apply(&noDraws, record)) {
+        changes += n;
+    }
+    return changes;
+}
+void SkRecordNoopSaveRestores(SkRecord* record) {
+    noop_save_restores(record);
 }
 
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
@@ -231,8 +302,205 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord* record) {
     SaveLayerDrawRestoreNooper pass;
     apply(&pass, record);
 }
+
+// Turns SaveLayer-[non-layer command]*-Restore into Save-...-Restore when the layer has no paint
+// and everything drawn into it is src-over: compositing those draws into a clear layer and the
+// layer onto its parent is the same as drawing them into the parent. Pictures and drawables are
+// excluded because they may use other blend modes internally.
+struct ClipOnlySaveLayerToSave {
+    typedef Pattern<Is<SaveLayer>,
+                    Greedy<Not<Or<Is<Save>,
+                                  Is<SaveLayer>,
+                                  Is<Restore>,
+                                  Is<DrawPicture>,
+                                  Is<DrawDrawable>>>>,
+                    Is<Restore>>
+        Match;
+
+    bool onMatch(SkRecord* record, Match* match, int begin, int end) {
+        const SaveLayer* layer = match->first<SaveLayer>();
+        // Layer bounds clip the draws, and a Save can't express that.
+        if (layer->bounds || layer->paint || layer->backdrop || layer->clipMask ||
+            (layer->saveLayerFlags & SkCanvasPriv::kDontClipToLayer_SaveLayerFlag)) {
+            return false;
+        }
+        for (int i = begin + 1; i < end - 1; i++) {
+            IsDraw isDraw;
+            if (record->mutate(i, isDraw) && !effectively_srcover(isDraw.get())) {
+                return false;
+            }
+        }
+        new (record->replace<Save>(begin)) Save;
+        return true;
+    }
+};
+void SkRecordSaveLayersToSaves(SkRecord* record, SkRecordOptStats* stats) {
+    ClipOnlySaveLayerToSave pass;
+    int changes = apply(&pass, record);
+    if (stats) {
+        stats->fClipOnlySaveLayers += changes;
+    }
+}
 #endif
 
+// True if drawing a rect with this paint replaces every pixel it touches with an opaque color.
+static bool overwrites_opaque(const SkPaint& paint) {
+    return !paint.isAntiAlias() && SkPaint::kFill_Style == paint.getStyle() &&
+           paint.isSrcOver() && 0xFF == paint.getAlpha() &&
+           (!paint.getShader() || paint.getShader()->isOpaque()) &&
+           !paint.getColorFilter() && !paint.getMaskFilter() && !paint.getPathEffect() &&
+           !paint.getImageFilter() && !paint.getLooper();
+}
+
+// Computes the local bounds of the pixels touched by simple aliased geometry draws.
+struct AliasedDrawBounds {
+    SkRect* fBounds;
+
+    bool operator()(const DrawRect& op)   { return this->set(op.paint, op.rect.makeSorted()); }
+    bool operator()(const DrawOval& op)   { return this->set(op.paint, op.oval.makeSorted()); }
+    bool operator()(const DrawRRect& op)  { return this->set(op.paint, op.rrect.getBounds()); }
+    bool operator()(const DrawDRRect& op) { return this->set(op.paint, op.outer.getBounds()); }
+    bool operator()(const DrawPath& op) {
+        return !op.path.isInverseFillType() && this->set(op.paint, op.path.getBounds());
+    }
+    template <typename T>
+    bool operator()(const T&) { return false; }
+
+    bool set(const SkPaint& paint, const SkRect& geometry) {
+        // Hairlines touch pixels whose centers are outside the geometry.
+        bool hairline = SkPaint::kFill_Style != paint.getStyle() && 0 == paint.getStrokeWidth();
+        if (paint.isAntiAlias() || hairline || !paint.canComputeFastBounds()) {
+            return false;
+        }
+        *fBounds = paint.computeFastBounds(geometry, fBounds);
+        return true;
+    }
+};
+
+// Marks which ops may draw through an anti-aliased clip made earlier in the record. The clip the
+// record is played back into is taken to be aliased.
+struct AAClipTracker {
+    SkTDArray<bool> fSaved;
+    bool fAA = false;
+
+    void operator()(const Save&)      { fSaved.push(fAA); }
+    void operator()(const SaveLayer&) { fSaved.push(fAA); }
+    void operator()(const Restore&) {
+        if (!fSaved.isEmpty()) {
+            fSaved.pop(&fAA);
+        }
+    }
+    void operator()(const ClipRect& op)  { fAA |= op.opAA.aa(); }
+    void operator()(const ClipRRect& op) { fAA |= op.opAA.aa(); }
+    void operator()(const ClipPath& op)  { fAA |= op.opAA.aa(); }
+    template <typename T>
+    void operator()(const T&) {}
+
+    static void Find(const SkRecord& record, SkTDArray<bool>* aaClipped) {
+        AAClipTracker tracker;
+        aaClipped->setCount(record.count());
+        for (int i = 0; i < record.count(); i++) {
+            (*aaClipped)[i] = tracker.fAA;
+            record.visit(i, tracker);
+        }
+    }
+};
+
+// Noops a draw whose bounds are inside the opaque, aliased rect drawn right after it. Both use the
+// same matrix and clip, and aliased draws only touch pixels whose centers they cover. Through an
+// anti-aliased clip the pair would blend partially covered pixels twice, so those are left alone.
+struct OccludedDrawNooper {
+    typedef Pattern<IsDraw, Greedy<Is<NoOp>>, Is<DrawRect>> Match;
+
+    const SkTDArray<bool>& fAAClipped;
+
+    bool onMatch(SkRecord* record, Match* match, int begin, int end) {
+        const DrawRect* occluder = match->third<DrawRect>();
+        if (fAAClipped[begin] || !overwrites_opaque(occluder->paint)) {
+            return false;
+        }
+        SkRect bounds;
+        if (!record->visit(begin, AliasedDrawBounds{&bounds}) ||
+            !occluder->rect.makeSorted().contains(bounds)) {
+            return false;
+        }
+        record->replace<NoOp>(begin);
+        return true;
+    }
+};
+void SkRecordNoopOccludedDraws(SkRecord* record, SkRecordOptStats* stats) {
+    SkTDArray<bool> aaClipped;
+    AAClipTracker::Find(*record, &aaClipped);
+    OccludedDrawNooper pass{aaClipped};
+    int changes = apply_chained_until_done(&pass, record);
+    if (stats) {
+        stats->fOccludedDraws += changes;
+    }
+}
+
+// Returns the paint and pixel area of a DrawRect or DrawRegion that can be merged with others.
+struct CoalescableArea {
+    const SkPaint** fPaint;
+    SkRegion* fRegion;
+
+    bool operator()(const DrawRect& op) {
+        SkIRect rect = op.rect.makeSorted().round();
+        if (SkRect::Make(rect) != op.rect || !overwrites_opaque(op.paint)) {
+            return false;
+        }
+        *fPaint = &op.paint;
+        fRegion->setRect(rect);
+        return true;
+    }
+    bool operator()(const DrawRegion& op) {
+        if (!overwrites_opaque(op.paint)) {
+            return false;
+        }
+        *fPaint = &op.paint;
+        *fRegion = op.region;
+        return true;
+    }
+    template <typename T>
+    bool operator()(const T&) { return false; }
+};
+
+// Merges an opaque, aliased DrawRect with integer coordinates into the DrawRect or DrawRegion with
+// the same paint before it. Since the draws are opaque, drawing their union once is the same as
+// drawing them one after the other, unless an anti-aliased clip blends where they overlap twice.
+struct RectCoalescer {
+    typedef Pattern<Or<Is<DrawRect>, Is<DrawRegion>>, Greedy<Is<NoOp>>, Is<DrawRect>> Match;
+
+    const SkTDArray<bool>& fAAClipped;
+
+    bool onMatch(SkRecord* record, Match*, int begin, int end) {
+        if (fAAClipped[begin]) {
+            return false;
+        }
+        const SkPaint* firstPaint = nullptr;
+        const SkPaint* lastPaint = nullptr;
+        SkRegion region, last;
+        if (!record->visit(begin, CoalescableArea{&firstPaint, &region}) ||
+            !record->visit(end - 1, CoalescableArea{&lastPaint, &last}) ||
+            *firstPaint != *lastPaint) {
+            return false;
+        }
+        region.op(last, SkRegion::kUnion_Op);
+        SkPaint paint = *lastPaint;
+        record->replace<NoOp>(begin);
+        new (record->replace<DrawRegion>(end - 1)) DrawRegion{paint, region};
+        return true;
+    }
+};
+void SkRecordCoalesceRects(SkRecord* record, SkRecordOptStats* stats) {
+    SkTDArray<bool> aaClipped;
+    AAClipTracker::Find(*record, &aaClipped);
+    RectCoalescer pass{aaClipped};
+    int changes = apply_chained_until_done(&pass, record);
+    if (stats) {
+        stats->fCoalescedRects += changes;
+    }
+}
+
 /* For SVG generated:
   SaveLayer (non-opaque, typically for CSS opacity)
     Save
@@ -282,9 +550,12 @@ struct SvgOpacityAndFilterLayerMergePass {
     }
 };
 
-void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
+static int merge_svg_opacity_and_filter_layers(SkRecord* record) {
     SvgOpacityAndFilterLayerMergePass pass;
-    apply(&pass, record);
+    return apply(&pass, record);
+}
+void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
+    merge_svg_opacity_and_filter_layers(record);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -310,14 +581,25 @@ void SkRecordOptimize(SkRecord* record) {
     record->defrag();
 }
 
-void SkRecordOptimize2(SkRecord* record) {
-    multiple_set_matrices(record);
-    SkRecordNoopSaveRestores(record);
+void SkRecordOptimize2(SkRecord* record, SkRecordOptStats* stats) {
+    SkRecordOptStats local;
+    if (!stats) {
+        stats = &local;
+    }
+    stats->fOverwrittenMatrices += overwritten_matrices(record);
+    stats->fMergedMatrices += merged_matrices(record);
+    stats->fNoopSaveRestores += noop_save_restores(record);
     // See why we turn this off in SkRecordOptimize above.
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
-    SkRecordNoopSaveLayerDrawRestores(record);
+    SaveLayerDrawRestoreNooper saveLayerDraws;
+    stats->fSaveLayerDraws += apply(&saveLayerDraws, record);
+    SkRecordSaveLayersToSaves(record, stats);
+    // Layers turned into Saves may now be noops.
+    stats->fNoopSaveRestores += noop_save_restores(record);
 #endif
-    SkRecordMergeSvgOpacityAndFilterLayers(record);
+    stats->fSvgLayers += merge_svg_opacity_and_filter_layers(record);
+    SkRecordNoopOccludedDraws(record, stats);
+    SkRecordCoalesceRects(record, stats);
 
     record->defrag();
 }
@@ -26,7 +26,32 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// How many times each of the SkRecordOptimize2 passes changed a record.
+struct SkRecordOptStats {
+    int fOverwrittenMatrices = 0;  // Matrix ops replaced by a later SetMatrix
+    int fMergedMatrices      = 0;  // Consecutive Concats or Translates merged into one
+    int fNoopSaveRestores    = 0;
+    int fClipOnlySaveLayers  = 0;  // Layers turned into Saves
+    int fSaveLayerDraws      = 0;  // Layer alpha folded into a single draw
+    int fSvgLayers           = 0;
+    int fOccludedDraws       = 0;  // Draws covered by the following opaque rect
+    int fCoalescedRects      = 0;  // Rects merged into the following rect as a region
+};
+
+// For SaveLayer-[clips, matrices, src-over draws]*-Restore patterns with a layer that has no paint
+// or bounds, the layer's only effect is to scope the clip, so turn the SaveLayer into a Save.
+void SkRecordSaveLayersToSaves(SkRecord*, SkRecordOptStats* = nullptr);
+
+// Noops draws of simple geometry that are entirely covered by the opaque DrawRect after them.
+// Draws under an anti-aliased clip from the record are kept. The clip the record is played back
+// into must be aliased for the result to match.
+void SkRecordNoopOccludedDraws(SkRecord*, SkRecordOptStats* = nullptr);
+
+// Merges runs of opaque, aliased, pixel aligned DrawRects with the same paint into a DrawRegion.
+// As with SkRecordNoopOccludedDraws(), only outside anti-aliased clips.
+void SkRecordCoalesceRects(SkRecord*, SkRecordOptStats* = nullptr);
+
 // Experimental optimizers
-void SkRecordOptimize2(SkRecord*);
+void SkRecordOptimize2(SkRecord*, SkRecordOptStats* = nullptr);
 
 #endif//SkRecordOpts_DEFINED
@@ -66,13 +66,31 @@ bool SkRect::setBoundsCheck(const SkPoint pts[], int count) {
         accum = max = min;
         accum = accum * Sk4s(0);
 
-        count >>= 1;
-        for (int i = 0; i < count; ++i) {
+        // Four points at a time, in two independent chains so that each min, max and multiply
+        // doesn't wait on the one before it.  This about doubles the speed for large paths.
+        if (count >= 4) {
+            Sk4s min2 = min, max2 = max, accum2 = accum;
+            for (; count >= 4; count -= 4) {
+                Sk4s xy0 = Sk4s::Load(pts),
+                     xy1 = Sk4s::Load(pts + 2);
+                accum  = accum  * xy0;
+                accum2 = accum2 * xy1;
+                min  = Sk4s::Min(min,  xy0);
+                min2 = Sk4s::Min(min2, xy1);
+                max  = Sk4s::Max(max,  xy0);
+                max2 = Sk4s::Max(max2, xy1);
+                pts += 4;
+            }
+            min = Sk4s::Min(min, min2);
+            max = Sk4s::Max(max, max2);
+            accum = accum * accum2;
+        }
+        if (count) {
+            SkASSERT(2 == count);
             Sk4s xy = Sk4s::Load(pts);
             accum = accum * xy;
             min = Sk4s::Min(min, xy);
             max = Sk4s::Max(max, xy);
-            pts += 2;
         }
 
         /**
@@ -9,9 +9,13 @@
 #include "SkAtomics.h"
 #include "SkRegionPriv.h"
 #include "SkSafeMath.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
 #include "SkTemplates.h"
 #include "SkUtils.h"
 
+#include <algorithm>
+
 /* Region Layout
  *
  *  TOP
@@ -645,20 +649,6 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool SkRegion::setRects(const SkIRect rects[], int count) {
-    if (0 == count) {
-        this->setEmpty();
-    } else {
-        this->setRect(rects[0]);
-        for (int i = 1; i < count; i++) {
-            this->op(rects[i], kUnion_Op);
-        }
-    }
-    return !this->isEmpty();
-}
-
-///////////////////////////////////////////////////////////////////////////////
-
 #if defined _WIN32  // disable warning : local variable used without having been initialized
 #pragma warning ( push )
 #pragma warning ( disable : 4701 )
@@ -770,15 +760,48 @@ static int distance_to_sentinel(const SkRegion::RunType* runs) {
     return ptr - runs;
 }
 
+static SkRegion::RunType* copy_intervals(SkRegion::RunType* dst, const SkRegion::RunType runs[],
+                                         int count) {
+    memcpy(dst, runs, count * sizeof(SkRegion::RunType));
+    return dst + count;
+}
+
 static int operate_on_span(const SkRegion::RunType a_runs[],
                            const SkRegion::RunType b_runs[],
                            RunArray* array, int dstOffset,
                            int min, int max) {
+    const int a_count = distance_to_sentinel(a_runs);
+    const int b_count = distance_to_sentinel(b_runs);
     // This is a worst-case for this span plus two for TWO terminating sentinels.
-    array->resizeToAtLeast(
-            dstOffset + distance_to_sentinel(a_runs) + distance_to_sentinel(b_runs) + 2);
+    array->resizeToAtLeast(dstOffset + a_count + b_count + 2);
     SkRegion::RunType* dst = &(*array)[dstOffset]; // get pointer AFTER resizing.
 
+    // When no interval of a meets one of b, each keeps or drops all its intervals, the way the
+    // merge below would, and they're already sorted and apart. Rect-heavy regions hit this on
+    // most scanlines: only one operand has intervals there, or the two are side by side.
+    const bool keep_a = (unsigned)(1 - min) <= (unsigned)(max - min);
+    const bool keep_b = (unsigned)(2 - min) <= (unsigned)(max - min);
+    if (0 == a_count || 0 == b_count || a_runs[a_count - 1] < b_runs[0]) {
+        if (keep_a) {
+            dst = copy_intervals(dst, a_runs, a_count);
+        }
+        if (keep_b) {
+            dst = copy_intervals(dst, b_runs, b_count);
+        }
+        *dst++ = SkRegion::kRunTypeSentinel;
+        return dst - &(*array)[0];
+    }
+    if (b_runs[b_count - 1] < a_runs[0]) {
+        if (keep_b) {
+            dst = copy_intervals(dst, b_runs, b_count);
+        }
+        if (keep_a) {
+            dst = copy_intervals(dst, a_runs, a_count);
+        }
+        *dst++ = SkRegion::kRunTypeSentinel;
+        return dst - &(*array)[0];
+    }
+
     spanRec rec;
     bool    firstInterval = true;
 
@@ -889,23 +912,24 @@ private:
 // want a unique value to signal that we exited due to quickExit
 #define QUICK_EXIT_TRUE_COUNT   (-1)
 
+static const SkRegion::RunType gEmptyScanline[] = {
+    0,  // dummy bottom value
+    0,  // zero intervals
+    SkRegion::kRunTypeSentinel,
+    // just need a 2nd value, since spanRec.init() reads 2 values, even
+    // though if the first value is the sentinel, it ignores the 2nd value.
+    // w/o the 2nd value here, we might read uninitialized memory.
+    // This happens when we are using gSentinel, which is pointing at
+    // our sentinel value.
+    0
+};
+static const SkRegion::RunType* const gSentinel = &gEmptyScanline[2];
+
 static int operate(const SkRegion::RunType a_runs[],
                    const SkRegion::RunType b_runs[],
                    RunArray* dst,
                    SkRegion::Op op,
                    bool quickExit) {
-    const SkRegion::RunType gEmptyScanline[] = {
-        0,  // dummy bottom value
-        0,  // zero intervals
-        SkRegion::kRunTypeSentinel,
-        // just need a 2nd value, since spanRec.init() reads 2 values, even
-        // though if the first value is the sentinel, it ignores the 2nd value.
-        // w/o the 2nd value here, we might read uninitialized memory.
-        // This happens when we are using gSentinel, which is pointing at
-        // our sentinel value.
-        0
-    };
-    const SkRegion::RunType* const gSentinel = &gEmptyScanline[2];
 
     int a_top = *a_runs++;
     int a_bot = *a_runs++;
@@ -1001,6 +1025,76 @@ static int operate(const SkRegion::RunType a_runs[],
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool SkRegion::setRects(const SkIRect rects[], int count) {
+    SkTDArray<SkIRect> sorted;
+    SkTDArray<RunType> edges;
+    for (int i = 0; i < count; i++) {
+        if (!rects[i].isEmpty()) {
+            *sorted.append() = rects[i];
+            *edges.append() = rects[i].fTop;
+            *edges.append() = rects[i].fBottom;
+        }
+    }
+    if (sorted.count() <= 1) {
+        return sorted.isEmpty() ? this->setEmpty() : this->setRect(sorted[0]);
+    }
+
+    // Sweep down the rects, one band between consecutive edges at a time. Each band's
+    // scanline is the union of the rects spanning it, which RgnOper coalesces with the band
+    // above when they're the same.
+    SkTQSort(sorted.begin(), sorted.end() - 1, [](const SkIRect& a, const SkIRect& b) {
+        return a.fTop < b.fTop;
+    });
+    SkTQSort(edges.begin(), edges.end() - 1);
+    edges.setCount((int)(std::unique(edges.begin(), edges.end()) - edges.begin()));
+
+    RunArray array;
+    RgnOper oper(edges[0], &array, kUnion_Op);
+    SkTDArray<SkIRect> active;
+    SkTDArray<RunType> scanline;
+    int next = 0;
+    for (int i = 0; i + 1 < edges.count(); i++) {
+        const int top = edges[i];
+        const int bot = edges[i + 1];
+        int kept = 0;
+        for (const SkIRect& r : active) {
+            if (r.fBottom > top) {
+                active[kept++] = r;
+            }
+        }
+        active.setCount(kept);
+        while (next < sorted.count() && sorted[next].fTop == top) {
+            *active.append() = sorted[next++];
+        }
+
+        scanline.rewind();
+        if (!active.isEmpty()) {
+            SkTQSort(active.begin(), active.end() - 1, [](const SkIRect& a, const SkIRect& b) {
+                return a.fLeft < b.fLeft;
+            });
+            RunType left = active[0].fLeft,
+                    rite = active[0].fRight;
+            for (int j = 1; j < active.count(); j++) {
+                if (active[j].fLeft > rite) {
+                    *scanline.append() = left;
+                    *scanline.append() = rite;
+                    left = active[j].fLeft;
+                }
+                rite = SkMax32(rite, active[j].fRight);
+            }
+            *scanline.append() = left;
+            *scanline.append() = rite;
+        }
+        // spanRec.init() reads a value past the sentinel.
+        *scanline.append() = kRunTypeSentinel;
+        *scanline.append() = 0;
+        oper.addSpan(bot, scanline.begin(), gSentinel);
+    }
+    return this->setRuns(&array[0], oper.flush());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 /*  Given count RunTypes in a complex region, return the worst case number of
     logical intervals that represents (i.e. number of rects that would be
     returned from the iterator).
@@ -1028,6 +1122,18 @@ static bool setRegionCheck(SkRegion* result, const SkRegion& rgn) {
     return result ? result->setRegion(rgn) : !rgn.isEmpty();
 }
 
+// Two rects stacked with the same left and right, or side by side with the same top and bottom,
+// that overlap or touch.
+static bool union_is_rect(const SkIRect& a, const SkIRect& b, SkIRect* bounds) {
+    if ((a.fLeft == b.fLeft && a.fRight == b.fRight && a.fTop <= b.fBottom && b.fTop <= a.fBottom)
+     || (a.fTop == b.fTop && a.fBottom == b.fBottom && a.fLeft <= b.fRight && b.fLeft <= a.fRight)) {
+        bounds->set(SkMin32(a.fLeft, b.fLeft), SkMin32(a.fTop, b.fTop),
+                    SkMax32(a.fRight, b.fRight), SkMax32(a.fBottom, b.fBottom));
+        return true;
+    }
+    return false;
+}
+
 bool SkRegion::Oper(const SkRegion& rgnaOrig, const SkRegion& rgnbOrig, Op op,
                     SkRegion* result) {
     SkASSERT((unsigned)op < kOpCount);
@@ -1096,6 +1202,9 @@ bool SkRegion::Oper(const SkRegion& rgnaOrig, const SkRegion& rgnbOrig, Op op,
         if (b_rect && rgnb->fBounds.contains(rgna->fBounds)) {
             return setRegionCheck(result, *rgnb);
         }
+        if ((a_rect & b_rect) && union_is_rect(rgna->fBounds, rgnb->fBounds, &bounds)) {
+            return setRectCheck(result, bounds);
+        }
         break;
 
     case kXOR_Op:
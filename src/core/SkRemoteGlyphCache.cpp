@@ -7,6 +7,7 @@
 
 #include "SkRemoteGlyphCache.h"
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -85,6 +86,12 @@ private:
 
 size_t pad(size_t size, size_t alignment) { return (size + (alignment - 1)) & ~(alignment - 1); }
 
+// Glyph images are aligned so that the client can use them where they are in a chunk.
+static constexpr size_t kImageAlignment = SkStrikeServer::kChunkAlignment;
+
+// The most space writing size bytes at the given alignment can take.
+static constexpr size_t bound(size_t size, size_t alignment) { return size + alignment - 1; }
+
 class Serializer {
 public:
     Serializer(std::vector<uint8_t>* buffer) : fBuffer{buffer} { }
@@ -119,6 +126,8 @@ public:
         return new (result) T[count];
     }
 
+    void* allocateImage(size_t size) { return allocate(size, kImageAlignment); }
+
 private:
     void* allocate(size_t size, size_t alignment) {
         size_t aligned = pad(fBuffer->size(), alignment);
@@ -167,6 +176,12 @@ public:
         return result;
     }
 
+    ArraySlice<uint8_t> readImage(size_t size) {
+        const uint8_t* base = (const uint8_t*)this->ensureAtLeast(size, kImageAlignment);
+        if (!base) return ArraySlice<uint8_t>();
+        return ArraySlice<uint8_t>{base, size};
+    }
+
 private:
     const volatile char* ensureAtLeast(size_t size, size_t alignment) {
         size_t padded = pad(fBytesRead, alignment);
@@ -362,7 +377,8 @@ void SkTextBlobCacheDiffCanvas::processGlyphRun(
     TRACE_EVENT1("skia", "RecForDesc", "rec", TRACE_STR_COPY(rec.dump().c_str()));
     auto desc = SkScalerContext::DescriptorGivenRecAndEffects(rec, effects);
     auto* glyphCacheState = static_cast<SkStrikeServer*>(fStrikeServer)
-                                    ->getOrCreateCache(runPaint.getTypeface(), std::move(desc));
+                                    ->getOrCreateCache(runPaint.getTypeface(), effects,
+                                                       std::move(desc));
     SkASSERT(glyphCacheState);
 
     bool isSubpixel = SkToBool(rec.fFlags & SkScalerContext::kSubpixelPositioning_Flag);
@@ -379,9 +395,12 @@ void SkTextBlobCacheDiffCanvas::processGlyphRun(
             subPixelPos = SkFindAndPlaceGlyph::SubpixelAlignment(axisAlignment, glyphPos);
         }
 
-        glyphCacheState->addGlyph(runPaint.getTypeface(),
-                                  effects,
-                                  SkPackedGlyphID(glyphs[index], subPixelPos.x(), subPixelPos.y()));
+        if (glyphCacheState->addGlyph(runPaint.getTypeface(),
+                                      effects,
+                                      SkPackedGlyphID(glyphs[index], subPixelPos.x(),
+                                                      subPixelPos.y()))) {
+            fStrikeServer->addSeenGlyph(runPaint.getTypeface(), glyphs[index]);
+        }
     }
 }
 
@@ -410,6 +429,91 @@ struct WireTypeface {
     bool            isFixed;
 };
 
+// -- ChunkSerializer -----------------------------------------------------------------------------
+// Writes the same messages as the Serializer, but into fixed size chunks from a ChunkAllocator.
+// Since the chunks never move, counts can be filled in after what they count has been written.
+class ChunkSerializer {
+public:
+    ChunkSerializer(SkStrikeServer::ChunkAllocator* allocator,
+                    std::vector<WireTypeface>* typefacesToSend)
+            : fAllocator{allocator}, fTypefacesToSend{typefacesToSend} {}
+    ~ChunkSerializer() { this->finishChunk(); }
+
+    // Returns true if there's a chunk with room for bytes more, starting a new chunk if needed.
+    bool ensureSpace(size_t bytes) {
+        if (this->fits(bytes)) {
+            return true;
+        }
+        this->finishChunk();
+
+        size_t headerSize = 2 * bound(sizeof(size_t), alignof(size_t)) +
+                            fTypefacesToSend->size() * bound(sizeof(WireTypeface),
+                                                             alignof(WireTypeface));
+        fChunk = static_cast<uint8_t*>(fAllocator->allocateChunk(headerSize + bytes, &fSize));
+        if (fChunk == nullptr) {
+            return false;
+        }
+        SkASSERT(SkIsAlign16(reinterpret_cast<uintptr_t>(fChunk)));
+        SkASSERT(fSize >= headerSize + bytes);
+        fUsed = 0;
+
+        // Typefaces only need to go in the first chunk, as the client reads them in order.
+        this->write<size_t>(fTypefacesToSend->size());
+        for (const auto& tf : *fTypefacesToSend) this->write<WireTypeface>(tf);
+        fTypefacesToSend->clear();
+        fStrikeCount = this->emplace<size_t>(0u);
+        return true;
+    }
+
+    // True if bytes more fit in the current chunk. Call ensureSpace() before writing.
+    bool fits(size_t bytes) const { return fChunk && fUsed + bytes <= fSize; }
+
+    // Begins a strike in the current chunk; the caller fills in its glyph count.
+    void addStrike() { *fStrikeCount += 1; }
+
+    template <typename T, typename... Args>
+    T* emplace(Args&&... args) {
+        auto result = allocate(sizeof(T), alignof(T));
+        return new (result) T{std::forward<Args>(args)...};
+    }
+
+    template <typename T>
+    void write(const T& data) {
+        T* result = (T*)allocate(sizeof(T), alignof(T));
+        memcpy(result, &data, sizeof(T));
+    }
+
+    void writeDescriptor(const SkDescriptor& desc) {
+        write(desc.getLength());
+        auto result = allocate(desc.getLength(), alignof(SkDescriptor));
+        memcpy(result, &desc, desc.getLength());
+    }
+
+    void* allocateImage(size_t size) { return allocate(size, kImageAlignment); }
+
+private:
+    void* allocate(size_t size, size_t alignment) {
+        size_t aligned = pad(fUsed, alignment);
+        SkASSERT(aligned + size <= fSize);
+        fUsed = aligned + size;
+        return fChunk + aligned;
+    }
+
+    void finishChunk() {
+        if (fChunk) {
+            fAllocator->finishChunk(fChunk, fUsed);
+            fChunk = nullptr;
+        }
+    }
+
+    SkStrikeServer::ChunkAllocator* const fAllocator;
+    std::vector<WireTypeface>* const      fTypefacesToSend;
+    uint8_t*                              fChunk{nullptr};
+    size_t                                fSize{0};
+    size_t                                fUsed{0};
+    size_t*                               fStrikeCount{nullptr};
+};
+
 // SkStrikeServer -----------------------------------------
 
 SkStrikeServer::SkStrikeServer(DiscardableHandleManager* discardableHandleManager)
@@ -417,9 +521,12 @@ SkStrikeServer::SkStrikeServer(DiscardableHandleManager* discardableHandleManage
     SkASSERT(fDiscardableHandleManager);
 }
 
-SkStrikeServer::~SkStrikeServer() = default;
+SkStrikeServer::~SkStrikeServer() {
+    fWeakTypefaces.foreach([](SkFontID, SkTypeface** tf) { (*tf)->weak_unref(); });
+}
 
 sk_sp<SkData> SkStrikeServer::serializeTypeface(SkTypeface* tf) {
+    this->addWeakTypeface(tf);
     WireTypeface wire(SkTypeface::UniqueID(tf), tf->countGlyphs(), tf->fontStyle(),
                       tf->isFixedPitch());
     return SkData::MakeWithCopy(&wire, sizeof(wire));
@@ -449,8 +556,101 @@ void SkStrikeServer::writeStrikeData(std::vector<uint8_t>* memory) {
     fLockedDescs.clear();
 }
 
+bool SkStrikeServer::writeStrikeData(ChunkAllocator* allocator) {
+    if (fLockedDescs.empty() && fTypefacesToSend.empty()) return true;
+
+    ChunkSerializer serializer(allocator, &fTypefacesToSend);
+    if (!serializer.ensureSpace(0)) return false;
+
+    for (auto it = fLockedDescs.begin(); it != fLockedDescs.end();) {
+        auto state = fRemoteGlyphStateMap.find(*it);
+        SkASSERT(state != fRemoteGlyphStateMap.end());
+
+        // Strikes with no new glyphs aren't written at all.
+        if (state->second->has_pending_glyphs() &&
+            !state->second->writePendingGlyphs(&serializer)) {
+            return false;
+        }
+        it = fLockedDescs.erase(it);
+    }
+    return true;
+}
+
+bool SkStrikeServer::readGlyphRequests(const volatile void* memory, size_t memorySize) {
+    Deserializer deserializer(static_cast<const volatile char*>(memory), memorySize);
+
+    size_t strikeCount = 0u;
+    if (!deserializer.read<size_t>(&strikeCount)) return false;
+
+    for (size_t i = 0; i < strikeCount; ++i) {
+        SkScalerContextRec rec;
+        size_t glyphCount = 0u;
+        if (!deserializer.read<SkScalerContextRec>(&rec)) return false;
+        if (!deserializer.read<size_t>(&glyphCount)) return false;
+        if (glyphCount > memorySize / sizeof(SkPackedGlyphID)) return false;
+        auto glyphs = deserializer.readArray<SkPackedGlyphID>(SkToInt(glyphCount));
+        if (glyphCount != 0 && !glyphs.data()) return false;
+
+        SkTypeface** weak = fWeakTypefaces.find(rec.fFontID);
+        if (!weak || !(*weak)->try_ref()) continue;
+        sk_sp<SkTypeface> tf(*weak);
+
+        // The client only asks for glyphs of strikes without effects.
+        SkScalerContextEffects effects;
+        auto* glyphCacheState = this->getOrCreateCache(
+                tf.get(), effects, SkScalerContext::DescriptorGivenRecAndEffects(rec, effects));
+        for (const auto& glyph : glyphs) {
+            glyphCacheState->addGlyph(tf.get(), effects, glyph);
+        }
+    }
+    return true;
+}
+
+void SkStrikeServer::addSeenGlyph(SkTypeface* tf, SkGlyphID glyph) {
+    // Bounds what gets sent with each new strike of a typeface drawn with many glyphs.
+    static constexpr size_t kMaxSeenGlyphs = 512;
+
+    if (fPrefetch != Prefetch::kSeenGlyphs) return;
+    auto& seen = fSeenGlyphs[tf->uniqueID()];
+    if (seen.size() < kMaxSeenGlyphs) seen.insert(glyph);
+}
+
+void SkStrikeServer::addWeakTypeface(SkTypeface* tf) {
+    if (fWeakTypefaces.find(tf->uniqueID())) return;
+    tf->weak_ref();
+    fWeakTypefaces.set(tf->uniqueID(), tf);
+}
+
+void SkStrikeServer::prefetchGlyphs(SkTypeface* tf, const SkScalerContextEffects& effects,
+                                    SkGlyphCacheState* glyphCacheState) {
+    switch (fPrefetch) {
+        case Prefetch::kNone:
+            break;
+        case Prefetch::kASCII: {
+            static constexpr char kFirst = ' ', kLast = '~';
+            static constexpr int kCount = kLast - kFirst + 1;
+            char ascii[kCount];
+            SkGlyphID glyphs[kCount];
+            for (int i = 0; i < kCount; ++i) ascii[i] = kFirst + i;
+            tf->charsToGlyphs(ascii, SkTypeface::kUTF8_Encoding, glyphs, kCount);
+            for (SkGlyphID glyph : glyphs) {
+                glyphCacheState->addGlyph(tf, effects, SkPackedGlyphID(glyph));
+            }
+            break;
+        }
+        case Prefetch::kSeenGlyphs: {
+            auto seen = fSeenGlyphs.find(tf->uniqueID());
+            if (seen == fSeenGlyphs.end()) break;
+            for (SkGlyphID glyph : seen->second) {
+                glyphCacheState->addGlyph(tf, effects, SkPackedGlyphID(glyph));
+            }
+            break;
+        }
+    }
+}
+
 SkStrikeServer::SkGlyphCacheState* SkStrikeServer::getOrCreateCache(
-        SkTypeface* tf, std::unique_ptr<SkDescriptor> desc) {
+        SkTypeface* tf, const SkScalerContextEffects& effects, std::unique_ptr<SkDescriptor> desc) {
     SkASSERT(desc);
 
     // Already locked.
@@ -479,6 +679,7 @@ SkStrikeServer::SkGlyphCacheState* SkStrikeServer::getOrCreateCache(
         fCachedTypefaces.add(typeface_id);
         fTypefacesToSend.emplace_back(typeface_id, tf->countGlyphs(), tf->fontStyle(),
                                       tf->isFixedPitch());
+        this->addWeakTypeface(tf);
     }
 
     auto* desc_ptr = desc.get();
@@ -488,6 +689,7 @@ SkStrikeServer::SkGlyphCacheState* SkStrikeServer::getOrCreateCache(
 
     fLockedDescs.insert(desc_ptr);
     fRemoteGlyphStateMap[desc_ptr] = std::move(cache_state);
+    this->prefetchGlyphs(tf, effects, cache_state_ptr);
     return cache_state_ptr;
 }
 
@@ -499,17 +701,18 @@ SkStrikeServer::SkGlyphCacheState::SkGlyphCacheState(std::unique_ptr<SkDescripto
 
 SkStrikeServer::SkGlyphCacheState::~SkGlyphCacheState() = default;
 
-void SkStrikeServer::SkGlyphCacheState::addGlyph(SkTypeface* typeface,
+bool SkStrikeServer::SkGlyphCacheState::addGlyph(SkTypeface* typeface,
                                                  const SkScalerContextEffects& effects,
                                                  SkPackedGlyphID glyph) {
     // Already cached.
-    if (fCachedGlyphs.contains(glyph)) return;
+    if (fCachedGlyphs.contains(glyph)) return false;
 
     // Serialize and cache. Also create the scalar context to use when serializing
     // this glyph.
     fCachedGlyphs.add(glyph);
     fPendingGlyphs.push_back(glyph);
     if (!fContext) fContext = typeface->createScalerContext(effects, fDesc.get(), false);
+    return true;
 }
 
 void SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(Serializer* serializer) {
@@ -535,7 +738,7 @@ void SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(Serializer* serialize
         if (imageSize > 0) {
             // Since the allocateArray can move glyph, make one that stays in one place.
             SkGlyph stationaryGlyph = *glyph;
-            stationaryGlyph.fImage = serializer->allocateArray<uint8_t>(imageSize);
+            stationaryGlyph.fImage = serializer->allocateImage(imageSize);
             fContext->getImage(stationaryGlyph);
         }
     }
@@ -546,6 +749,58 @@ void SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(Serializer* serialize
     fContext.reset();
 }
 
+bool SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(ChunkSerializer* serializer) {
+    SkPaint::FontMetrics fontMetrics;
+    fContext->getFontMetrics(&fontMetrics);
+
+    const size_t strikeSize = bound(sizeof(bool), alignof(bool)) +
+                              bound(sizeof(StrikeSpec), alignof(StrikeSpec)) +
+                              bound(sizeof(uint32_t), alignof(uint32_t)) +
+                              bound(fDesc->getLength(), alignof(SkDescriptor)) +
+                              bound(sizeof(SkPaint::FontMetrics), alignof(SkPaint::FontMetrics));
+
+    // A strike is split across chunks if its glyphs don't fit in one, with its header repeated.
+    StrikeSpec* spec = nullptr;
+    size_t written = 0;
+    for (const auto& glyphID : fPendingGlyphs) {
+        SkGlyph glyph;
+        glyph.initWithGlyphID(glyphID);
+        fContext->getMetrics(&glyph);
+        glyph.fPathData = nullptr;
+        glyph.fImage = nullptr;
+        const size_t imageSize = glyph.computeImageSize();
+        const size_t glyphSize = bound(sizeof(SkGlyph), alignof(SkGlyph)) +
+                                 (imageSize > 0 ? bound(imageSize, kImageAlignment) : 0);
+
+        if (spec == nullptr || !serializer->fits(glyphSize)) {
+            if (!serializer->ensureSpace(strikeSize + glyphSize)) {
+                // Keep what we couldn't write for next time.
+                fPendingGlyphs.erase(fPendingGlyphs.begin(), fPendingGlyphs.begin() + written);
+                return false;
+            }
+            serializer->addStrike();
+            serializer->emplace<bool>(true);
+            spec = serializer->emplace<StrikeSpec>(fContext->getTypeface()->uniqueID(), 0u,
+                                                   fDiscardableHandleId);
+            serializer->writeDescriptor(*fDesc.get());
+            serializer->write<SkPaint::FontMetrics>(fontMetrics);
+        }
+
+        serializer->write<SkGlyph>(glyph);
+        if (imageSize > 0) {
+            // Render the image right where the client will read it from.
+            glyph.fImage = serializer->allocateImage(imageSize);
+            fContext->getImage(glyph);
+        }
+        spec->glyphCount += 1;
+        written += 1;
+    }
+
+    fPendingGlyphs.clear();
+    fContext.reset();
+    return true;
+}
+
 // SkStrikeClient -----------------------------------------
 
 class SkStrikeClient::DiscardableStrikePinner : public SkStrikePinner {
@@ -574,6 +829,21 @@ SkStrikeClient::~SkStrikeClient() = default;
     }
 
 bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySize) {
+    return this->readStrikeData(memory, memorySize, nullptr);
+}
+
+bool SkStrikeClient::readStrikeData(sk_sp<SkData> chunk) {
+    const void* memory = chunk->data();
+    const size_t memorySize = chunk->size();
+    // The images are only aligned if the chunk is; otherwise fall back to copying them.
+    if (!SkIsAlign16(reinterpret_cast<uintptr_t>(memory))) {
+        chunk = nullptr;
+    }
+    return this->readStrikeData(memory, memorySize, chunk);
+}
+
+bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySize,
+                                    const sk_sp<SkData>& chunk) {
     SkASSERT(memorySize != 0u);
     Deserializer deserializer(static_cast<const volatile char*>(memory), memorySize);
 
@@ -642,12 +912,21 @@ bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySi
             ArraySlice<uint8_t> image;
             auto imageSize = glyph.computeImageSize();
             if (imageSize != 0) {
-                image = deserializer.readArray<uint8_t>(imageSize);
+                image = deserializer.readImage(imageSize);
                 if (!image.data()) READ_FAILURE
-                allocatedGlyph->allocImage(strike->getAlloc());
-                memcpy(allocatedGlyph->fImage, image.data(), image.size());
+                if (chunk) {
+                    // The image only holds pixels, so it's safe to read from memory the server
+                    // could still write to, unlike the metrics we've already copied out.
+                    allocatedGlyph->fImage = const_cast<uint8_t*>(image.data());
+                } else {
+                    allocatedGlyph->allocImage(strike->getAlloc());
+                    memcpy(allocatedGlyph->fImage, image.data(), image.size());
+                }
             }
         }
+        if (chunk) {
+            strike->retainData(chunk);
+        }
     }
 
     return true;
@@ -671,23 +950,58 @@ sk_sp<SkTypeface> SkStrikeClient::addTypeface(const WireTypeface& wire) {
     return std::move(newTypeface);
 }
 
+bool SkStrikeClient::writeGlyphRequests(std::vector<uint8_t>* memory) {
+    if (fGlyphRequests.empty()) return false;
+
+    Serializer serializer(memory);
+    serializer.emplace<size_t>(fGlyphRequests.size());
+    for (const auto& request : fGlyphRequests) {
+        serializer.write<SkScalerContextRec>(request.fRec);
+        serializer.emplace<size_t>(request.fGlyphs.size());
+        auto* glyphs = serializer.allocateArray<SkPackedGlyphID>(request.fGlyphs.size());
+        std::copy(request.fGlyphs.begin(), request.fGlyphs.end(), glyphs);
+    }
+    fGlyphRequests.clear();
+    return true;
+}
+
 void SkStrikeClient::generateFontMetrics(const SkTypefaceProxy& typefaceProxy,
                                          const SkScalerContextRec& rec,
                                          SkPaint::FontMetrics* metrics) {
     TRACE_EVENT1("skia", "generateFontMetrics", "rec", TRACE_STR_COPY(rec.dump().c_str()));
-    SkDebugf("generateFontMetrics: %s\n", rec.dump().c_str());
-    SkStrikeCache::Dump();
-    SkDEBUGFAIL("GlyphCacheMiss");
+
+    // The server hasn't sent this strike. Its glyphs are asked for as they're missed, but the
+    // metrics stay empty for as long as this strike is cached.
+    sk_bzero(metrics, sizeof(*metrics));
 }
 
 void SkStrikeClient::generateMetricsAndImage(const SkTypefaceProxy& typefaceProxy,
                                              const SkScalerContextRec& rec,
+                                             const SkScalerContextEffects& effects,
                                              SkArenaAlloc* alloc,
                                              SkGlyph* glyph) {
     TRACE_EVENT1("skia", "generateMetricsAndImage", "rec", TRACE_STR_COPY(rec.dump().c_str()));
-    SkDebugf("generateMetricsAndImage: %s\n", rec.dump().c_str());
-    SkStrikeCache::Dump();
-    SkDEBUGFAIL("GlyphCacheMiss");
+
+    // The server can't recreate the effects, so their glyphs can't be asked for.
+    if (effects.fPathEffect || effects.fMaskFilter) {
+        SkDebugf("generateMetricsAndImage: %s\n", rec.dump().c_str());
+        SkStrikeCache::Dump();
+        SkDEBUGFAIL("GlyphCacheMiss");
+        return;
+    }
+
+    // Leave the glyph empty, and ask for it. When the server sends it, it replaces this one.
+    SkScalerContextRec remoteRec = rec;
+    remoteRec.fFontID = typefaceProxy.remoteTypefaceID();
+    auto request = std::find_if(fGlyphRequests.begin(), fGlyphRequests.end(),
+                                [&remoteRec](const GlyphRequest& r) {
+                                    return 0 == memcmp(&r.fRec, &remoteRec, sizeof(remoteRec));
+                                });
+    if (request == fGlyphRequests.end()) {
+        fGlyphRequests.push_back(GlyphRequest{remoteRec, {}});
+        request = fGlyphRequests.end() - 1;
+    }
+    request->fGlyphs.push_back(glyph->getPackedID());
 }
 
 void SkStrikeClient::generatePath(const SkTypefaceProxy& typefaceProxy,
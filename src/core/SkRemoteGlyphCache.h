@@ -21,9 +21,11 @@
 #include "SkNoDrawCanvas.h"
 #include "SkRefCnt.h"
 #include "SkRemoteGlyphCache.h"
+#include "SkScalerContext.h"
 #include "SkSerialProcs.h"
 #include "SkTypeface.h"
 
+class ChunkSerializer;
 class Serializer;
 class SkDescriptor;
 class SkGlyphCache;
@@ -103,17 +105,59 @@ public:
         // have been purged on the remote side.
     };
 
+    // An interface for the memory the server writes strike data into, e.g. shared memory that
+    // the client can read glyph images from without copying them.
+    class SK_API ChunkAllocator {
+    public:
+        virtual ~ChunkAllocator() {}
+
+        // Returns memory aligned to kChunkAlignment for the next chunk, at least minSize bytes,
+        // and sets *size to how many bytes there are. Returns nullptr if there is no memory.
+        virtual void* allocateChunk(size_t minSize, size_t* size) = 0;
+
+        // Called when the server is done writing to chunk, having used the first used bytes.
+        // Each chunk is a complete message for SkStrikeClient::readStrikeData().
+        virtual void finishChunk(void* chunk, size_t used) = 0;
+    };
+
+    // Chunks (and the glyph images in them) are aligned to this many bytes.
+    static constexpr size_t kChunkAlignment = 16;
+
+    // Glyphs sent with a strike the first time it's sent, besides the ones drawn with it, so that
+    // the client can draw text that hasn't gone through the server without missing glyphs. They
+    // are sent at whole pixel positions.
+    enum class Prefetch {
+        kNone,
+        // The glyphs for printable ASCII.
+        kASCII,
+        // The glyphs drawn so far with any strike of the same typeface, e.g. at other sizes.
+        kSeenGlyphs,
+    };
+
     SkStrikeServer(DiscardableHandleManager* discardableHandleManager);
     ~SkStrikeServer();
 
     // Serializes the typeface to be remoted using this server.
     sk_sp<SkData> serializeTypeface(SkTypeface*);
 
+    void setPrefetch(Prefetch prefetch) { fPrefetch = prefetch; }
+
+    // Reads the glyphs requested by SkStrikeClient::writeGlyphRequests(), to be sent by the next
+    // writeStrikeData(). Requests for typefaces that have since been deleted are dropped.
+    // Returns false if the data is invalid.
+    bool readGlyphRequests(const volatile void* memory, size_t memorySize);
+
     // Serializes the strike data captured using a SkTextBlobCacheDiffCanvas. Any
     // handles locked using the DiscardableHandleManager will be assumed to be
     // unlocked after this call.
     void writeStrikeData(std::vector<uint8_t>* memory);
 
+    // Like writeStrikeData() above, but writes straight into memory from allocator, with each
+    // glyph image rendered in place at an aligned offset. The data is split into as many chunks
+    // as it needs. Returns false if the allocator runs out of memory; anything not yet written
+    // is kept, and written by the next call.
+    bool writeStrikeData(ChunkAllocator* allocator);
+
     // Methods used internally in skia ------------------------------------------
     class SkGlyphCacheState {
     public:
@@ -121,8 +165,10 @@ public:
                           SkDiscardableHandleId discardableHandleId);
         ~SkGlyphCacheState();
 
-        void addGlyph(SkTypeface*, const SkScalerContextEffects&, SkPackedGlyphID);
+        // Returns true if the glyph is new to the client.
+        bool addGlyph(SkTypeface*, const SkScalerContextEffects&, SkPackedGlyphID);
         void writePendingGlyphs(Serializer* serializer);
+        bool writePendingGlyphs(ChunkSerializer* serializer);
         bool has_pending_glyphs() const { return !fPendingGlyphs.empty(); }
         SkDiscardableHandleId discardable_handle_id() const { return fDiscardableHandleId; }
 
@@ -138,12 +184,24 @@ public:
         const SkDiscardableHandleId fDiscardableHandleId = -1;
         std::unique_ptr<SkScalerContext> fContext;
     };
-    SkGlyphCacheState* getOrCreateCache(SkTypeface*, std::unique_ptr<SkDescriptor>);
+    SkGlyphCacheState* getOrCreateCache(SkTypeface*, const SkScalerContextEffects&,
+                                        std::unique_ptr<SkDescriptor>);
+
+    // Notes a glyph the client didn't have, for Prefetch::kSeenGlyphs.
+    void addSeenGlyph(SkTypeface*, SkGlyphID);
 
 private:
+    // Keeps a weak ref to the typeface, so glyph requests can find it by ID.
+    void addWeakTypeface(SkTypeface*);
+    void prefetchGlyphs(SkTypeface*, const SkScalerContextEffects&, SkGlyphCacheState*);
+
     SkDescriptorMap<std::unique_ptr<SkGlyphCacheState>> fRemoteGlyphStateMap;
     DiscardableHandleManager* const fDiscardableHandleManager;
     SkTHashSet<SkFontID> fCachedTypefaces;
+    SkTHashMap<SkFontID, SkTypeface*> fWeakTypefaces;
+
+    Prefetch fPrefetch = Prefetch::kNone;
+    std::unordered_map<SkFontID, std::unordered_set<SkGlyphID>> fSeenGlyphs;
 
     // State cached until the next serialization.
     SkDescriptorSet fLockedDescs;
@@ -175,12 +233,25 @@ public:
     // Returns false if the data is invalid.
     bool readStrikeData(const volatile void* memory, size_t memorySize);
 
-    // TODO: Remove these since we don't support pulling this data on-demand.
+    // Like readStrikeData() above, for a chunk written by SkStrikeServer::writeStrikeData() into
+    // memory from a ChunkAllocator. Glyph images are used where they are in chunk rather than
+    // copied, and the strikes using them keep chunk alive. The chunk must not be written to once
+    // it's been read.
+    bool readStrikeData(sk_sp<SkData> chunk);
+
+    // Glyphs missing from strikes the server sent are drawn empty rather than waited for, and
+    // asked for from the server instead: this writes the glyphs missed since the last call for
+    // SkStrikeServer::readGlyphRequests(), which sends them with its next strike data. Returns
+    // false if there are none.
+    bool writeGlyphRequests(std::vector<uint8_t>* memory);
+
+    // Called by SkScalerContextProxy on cache misses.
     void generateFontMetrics(const SkTypefaceProxy& typefaceProxy,
                              const SkScalerContextRec& rec,
                              SkPaint::FontMetrics* metrics);
     void generateMetricsAndImage(const SkTypefaceProxy& typefaceProxy,
                                  const SkScalerContextRec& rec,
+                                 const SkScalerContextEffects& effects,
                                  SkArenaAlloc* alloc,
                                  SkGlyph* glyph);
     void generatePath(const SkTypefaceProxy& typefaceProxy,
@@ -191,10 +262,21 @@ public:
 private:
     class DiscardableStrikePinner;
 
+    // The glyphs missed from a strike, whose rec has the server's typeface ID.
+    struct GlyphRequest {
+        SkScalerContextRec           fRec;
+        std::vector<SkPackedGlyphID> fGlyphs;
+    };
+
     sk_sp<SkTypeface> addTypeface(const WireTypeface& wire);
 
+    // If chunk is not null, the glyph images are left in memory, which is chunk's data.
+    bool readStrikeData(const volatile void* memory, size_t memorySize,
+                        const sk_sp<SkData>& chunk);
+
     SkTHashMap<SkFontID, sk_sp<SkTypeface>> fRemoteFontIdToTypeface;
     sk_sp<DiscardableHandleManager> fDiscardableHandleManager;
+    std::vector<GlyphRequest> fGlyphRequests;
 };
 
 #endif  // SkRemoteGlyphCache_DEFINED
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkCounters.h"
 #include "SkDiscardableMemory.h"
 #include "SkMessageBus.h"
 #include "SkMipMap.h"
@@ -51,23 +52,221 @@ void SkResourceCache::Key::init(void* nameSpace, uint64_t sharedID, size_t dataS
                          (fCount32 - kUnhashedLocal32s) << 2);
 }
 
-#include "SkTHash.h"
+#include "SkChecksum.h"
 
-namespace {
-    struct HashTraits {
-        static uint32_t Hash(const SkResourceCache::Key& key) { return key.hash(); }
-        static const SkResourceCache::Key& GetKey(const SkResourceCache::Rec* rec) {
-            return rec->getKey();
+#include <thread>
+#include <vector>
+
+/**
+ *  An open addressed hash table of Recs that find() can probe without holding the cache's lock,
+ *  while set() and remove(), which must hold it, change the table underneath.
+ *
+ *  Removed Recs, and tables we've outgrown, are retired rather than deleted, and only handed back
+ *  by reclaim() once every reader that might have seen them has finished. Readers announce
+ *  themselves with a ReadScope, which counts them against the current epoch; reclaim() moves to a
+ *  new epoch whenever nobody is left reading in the one before it, since then nobody can still
+ *  be looking at what was retired back then.
+ */
+class SkResourceCache::Hash {
+public:
+    Hash() : fTable(new Table(kMinCapacity)) {
+        for (auto& epochReaders : fReaders) {
+            for (auto& counter : epochReaders) {
+                counter.fCount.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ~Hash() {
+        for (int parity = 0; parity < 2; ++parity) {
+            for (Table* table : fRetiredTables[parity]) {
+                delete table;
+            }
+            for (Rec* rec : fRetiredRecs[parity]) {
+                delete rec;
+            }
         }
+        delete fTable.load(std::memory_order_relaxed);
+    }
+
+    class ReadScope {
+    public:
+        explicit ReadScope(Hash* hash) {
+            int stripe = SkChecksum::Mix(
+                    (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id()))
+                    & (kStripes - 1);
+            for (;;) {
+                uint64_t epoch = hash->fEpoch.load();
+                std::atomic<int>* counter = &hash->fReaders[epoch & 1][stripe].fCount;
+                counter->fetch_add(1);
+                // If reclaim() moved on while we registered, we may be counted against an epoch
+                // it's no longer waiting for, so try again.
+                if (hash->fEpoch.load() == epoch) {
+                    fCounter = counter;
+                    return;
+                }
+                counter->fetch_sub(1);
+            }
+        }
+        ~ReadScope() { fCounter->fetch_sub(1, std::memory_order_release); }
+
+    private:
+        std::atomic<int>* fCounter;
     };
-}
 
-class SkResourceCache::Hash :
-    public SkTHashTable<SkResourceCache::Rec*, SkResourceCache::Key, HashTraits> {};
+    // May be called without the lock, in a ReadScope.
+    Rec* find(const Key& key) const {
+        const Table* table = fTable.load(std::memory_order_acquire);
+        const int mask = table->fCapacity - 1;
+        // The table always has empty slots, so this terminates.
+        for (int i = key.hash() & mask; ; i = (i + 1) & mask) {
+            Rec* rec = table->fSlots[i].load(std::memory_order_acquire);
+            if (rec == nullptr) {
+                return nullptr;
+            }
+            if (rec != Removed() && rec->getHash() == key.hash() && rec->getKey() == key) {
+                return rec;
+            }
+        }
+    }
+
+    // The following methods can only be called with the lock held.
 
+    // rec's key must not already be in the table.
+    void set(Rec* rec) {
+        SkASSERT(!this->find(rec->getKey()));
+        Table* table = fTable.load(std::memory_order_relaxed);
+        if (2 * (fCount + fRemovedCount + 1) > table->fCapacity) {
+            table = this->rebuild();
+        }
+        const int mask = table->fCapacity - 1;
+        int i = rec->getHash() & mask;
+        for (;; i = (i + 1) & mask) {
+            Rec* slot = table->fSlots[i].load(std::memory_order_relaxed);
+            if (slot == nullptr || slot == Removed()) {
+                fRemovedCount -= (slot == Removed());
+                break;
+            }
+        }
+        // Publish the Rec only once it's complete.
+        table->fSlots[i].store(rec, std::memory_order_release);
+        fCount++;
+    }
+
+    void remove(const Key& key) {
+        Table* table = fTable.load(std::memory_order_relaxed);
+        const int mask = table->fCapacity - 1;
+        for (int i = key.hash() & mask; ; i = (i + 1) & mask) {
+            Rec* rec = table->fSlots[i].load(std::memory_order_relaxed);
+            SkASSERT(rec);
+            if (rec != Removed() && rec->getKey() == key) {
+                // Readers may still be probing past this slot, so it can't go back to empty.
+                table->fSlots[i].store(Removed(), std::memory_order_release);
+                fCount--;
+                fRemovedCount++;
+                return;
+            }
+        }
+    }
+
+    // rec has been taken out of the table, but may still be in use by readers.
+    void retire(Rec* rec) {
+        fRetiredRecs[fEpoch.load(std::memory_order_relaxed) & 1].push_back(rec);
+    }
+
+    // Append any retired Recs that nobody can be using anymore to recs, and delete any such
+    // tables.
+    void reclaim(std::vector<Rec*>* recs) {
+        // With no readers around this goes through both epochs, so everything retired so far
+        // comes back at once.
+        for (int i = 0; i < 2; ++i) {
+            uint64_t epoch = fEpoch.load(std::memory_order_relaxed);
+            int previous = (int)((epoch + 1) & 1);
+            for (const ReaderCount& counter : fReaders[previous]) {
+                if (counter.fCount.load(std::memory_order_acquire) != 0) {
+                    return;
+                }
+            }
+            for (Table* table : fRetiredTables[previous]) {
+                delete table;
+            }
+            fRetiredTables[previous].clear();
+            recs->insert(recs->end(), fRetiredRecs[previous].begin(), fRetiredRecs[previous].end());
+            fRetiredRecs[previous].clear();
+            fEpoch.store(epoch + 1);
+        }
+    }
+
+private:
+    static constexpr int kMinCapacity = 16;
+    static constexpr int kStripes = 16;   // a power of 2
+
+    struct Table {
+        explicit Table(int capacity) : fCapacity(capacity), fSlots(new std::atomic<Rec*>[capacity]) {
+            for (int i = 0; i < capacity; ++i) {
+                fSlots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        const int                              fCapacity;   // a power of 2
+        std::unique_ptr<std::atomic<Rec*>[]>   fSlots;
+    };
+
+    // Each counter gets its own cache line, so readers on different threads don't contend.
+    struct ReaderCount {
+        std::atomic<int> fCount;
+        char             fPad[64 - sizeof(std::atomic<int>)];
+    };
+
+    static Rec* Removed() {
+        static char gRemoved;
+        return reinterpret_cast<Rec*>(&gRemoved);
+    }
+
+    // Publish a copy of the table without removed slots, sized for one more Rec.
+    Table* rebuild() {
+        Table* oldTable = fTable.load(std::memory_order_relaxed);
+        int capacity = kMinCapacity;
+        while (capacity < 4 * (fCount + 1)) {
+            capacity *= 2;
+        }
+        Table* table = new Table(capacity);
+        const int mask = capacity - 1;
+        for (int j = 0; j < oldTable->fCapacity; ++j) {
+            Rec* rec = oldTable->fSlots[j].load(std::memory_order_relaxed);
+            if (rec == nullptr || rec == Removed()) {
+                continue;
+            }
+            int i = rec->getHash() & mask;
+            while (table->fSlots[i].load(std::memory_order_relaxed) != nullptr) {
+                i = (i + 1) & mask;
+            }
+            table->fSlots[i].store(rec, std::memory_order_relaxed);
+        }
+        fRemovedCount = 0;
+
+        // Readers who load the new table see all its slots filled in.
+        fTable.store(table, std::memory_order_release);
+        fRetiredTables[fEpoch.load(std::memory_order_relaxed) & 1].push_back(oldTable);
+        return table;
+    }
+
+    std::atomic<Table*>   fTable;
+    std::atomic<uint64_t> fEpoch{0};
+    ReaderCount           fReaders[2][kStripes];
+
+    // Guarded by the lock.
+    int                   fCount = 0;
+    int                   fRemovedCount = 0;
+    std::vector<Rec*>     fRetiredRecs[2];     // by the parity of the epoch they were retired in
+    std::vector<Table*>   fRetiredTables[2];
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Counts PostPurgeSharedID() calls, after their messages have been delivered.
+static std::atomic<uint32_t> gPurgeMessagesPosted{0};
+
 void SkResourceCache::init() {
     fHead = nullptr;
     fTail = nullptr;
@@ -79,6 +278,17 @@ void SkResourceCache::init() {
     // One of these should be explicit set by the caller after we return.
     fTotalByteLimit = 0;
     fDiscardableFactory = nullptr;
+
+    fEvictionPolicy = EvictionPolicy::kLRU;
+    fInflation = 0;
+    fUseCount = 0;
+    fLargeRecAdmissionLimit = 0;
+    memset(fProbationHashes, 0, sizeof(fProbationHashes));
+
+    // Anything posted so far was either delivered to fPurgeSharedIDInbox, or posted before there
+    // was anything of ours to purge.
+    fPurgeMessagesSeen.store(gPurgeMessagesPosted.load(std::memory_order_acquire),
+                             std::memory_order_relaxed);
 }
 
 SkResourceCache::SkResourceCache(DiscardableFactory factory) {
@@ -106,19 +316,43 @@ SkResourceCache::~SkResourceCache() {
 bool SkResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
     this->checkMessages();
 
-    if (auto found = fHash->find(key)) {
-        Rec* rec = *found;
+    if (Rec* rec = fHash->find(key)) {
         if (visitor(*rec, context)) {
             this->moveToHead(rec);  // for our LRU
             return true;
         } else {
             this->remove(rec);  // stale
+            this->reclaim();
             return false;
         }
     }
     return false;
 }
 
+SkResourceCache::FindResult SkResourceCache::findConcurrently(const Key& key, FindVisitor visitor,
+                                                              void* context) {
+    // Purges we haven't processed yet might include this key.
+    if (fPurgeMessagesSeen.load(std::memory_order_acquire) !=
+            gPurgeMessagesPosted.load(std::memory_order_acquire)) {
+        return FindResult::kNeedsLock;
+    }
+
+    Hash::ReadScope scope(fHash);
+
+    Rec* rec = fHash->find(key);
+    if (!rec) {
+        return FindResult::kNotFound;
+    }
+    if (!rec->canBeFoundConcurrently() || !visitor(*rec, context)) {
+        return FindResult::kNeedsLock;
+    }
+    // Only write if we have to, so threads hitting the same Rec don't fight over its cache line.
+    if (!rec->fRecentlyUsed.load(std::memory_order_relaxed)) {
+        rec->fRecentlyUsed.store(true, std::memory_order_relaxed);
+    }
+    return FindResult::kFound;
+}
+
 static void make_size_str(size_t size, SkString* str) {
     const char suffix[] = { 'b', 'k', 'm', 'g', 't', 0 };
     int i = 0;
@@ -136,8 +370,7 @@ void SkResourceCache::add(Rec* rec, void* payload) {
 
     SkASSERT(rec);
     // See if we already have this key (racy inserts, etc.)
-    if (Rec** preexisting = fHash->find(rec->getKey())) {
-        Rec* prev = *preexisting;
+    if (Rec* prev = fHash->find(rec->getKey())) {
         if (prev->canBePurged()) {
             // if it can be purged, the install may fail, so we have to remove it
             this->remove(prev);
@@ -149,8 +382,7 @@ void SkResourceCache::add(Rec* rec, void* payload) {
         }
     }
 
-    this->addToHead(rec);
-    fHash->set(rec);
+    this->insert(rec, this->admitOnProbation(*rec));
     rec->postAddInstall(payload);
 
     if (gDumpCacheTransactions) {
@@ -172,6 +404,10 @@ void SkResourceCache::remove(Rec* rec) {
 
     this->release(rec);
     fHash->remove(rec->getKey());
+    if (rec->fPriorityIndex >= 0) {
+        fPriorityQueue.remove(rec);
+        rec->fPriorityIndex = -1;
+    }
 
     fTotalBytesUsed -= used;
     fCount -= 1;
@@ -186,33 +422,126 @@ void SkResourceCache::remove(Rec* rec) {
                  bytesStr.c_str(), rec, rec->getHash(), totalStr.c_str(), fCount);
     }
 
-    delete rec;
+    // An unlocked Find() may still be looking at rec, so reclaim() deletes it later.
+    fHash->retire(rec);
 }
 
-void SkResourceCache::purgeAsNeeded(bool forcePurge) {
-    size_t byteLimit;
-    int    countLimit;
+void SkResourceCache::reclaim() {
+    std::vector<Rec*> recs;
+    fHash->reclaim(&recs);
+    for (Rec* rec : recs) {
+        if (rec->canBePurged()) {
+            delete rec;
+        } else if (!fHash->find(rec->getKey())) {
+            // An unlocked Find() started using it again after we removed it, so keep it.
+            this->insert(rec, false);
+        } else {
+            fHash->retire(rec);  // a newer Rec took its place; try again later
+        }
+    }
+}
 
-    if (fDiscardableFactory) {
-        countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
-        byteLimit = SK_MaxU32;  // no limit based on bytes
+void SkResourceCache::insert(Rec* rec, bool onProbation) {
+    if (onProbation) {
+        this->addToTail(rec);
     } else {
-        countLimit = SK_MaxS32; // no limit based on count
-        byteLimit = fTotalByteLimit;
+        this->addToHead(rec);
+    }
+    fHash->set(rec);
+    if (EvictionPolicy::kCostAware == fEvictionPolicy) {
+        this->updatePriority(rec, onProbation);
+        fPriorityQueue.insert(rec);
+    }
+}
+
+bool SkResourceCache::admitOnProbation(const Rec& rec) {
+    if (0 == fLargeRecAdmissionLimit || rec.bytesUsed() <= fLargeRecAdmissionLimit) {
+        return false;
+    }
+    uint32_t hash = rec.getHash();
+    uint32_t* seen = &fProbationHashes[hash & (kProbationHashCount - 1)];
+    if (*seen == hash) {
+        // We've seen this one before, so it's not a one-off after all.
+        *seen = 0;
+        return false;
+    }
+    *seen = hash;
+    return true;
+}
+
+void SkResourceCache::updatePriority(Rec* rec, bool onProbation) {
+    if (EvictionPolicy::kCostAware != fEvictionPolicy) {
+        return;
+    }
+    rec->fPriority = fInflation;
+    rec->fLastUse = onProbation ? 0 : ++fUseCount;
+    if (!onProbation) {
+        rec->fPriority += (double)rec->regenerationCost() / SkTMax<size_t>(rec->bytesUsed(), 1);
+    }
+    if (rec->fPriorityIndex >= 0) {
+        fPriorityQueue.priorityDidChange(rec);
+    }
+}
+
+bool SkResourceCache::overBudget() const {
+    if (fDiscardableFactory) {
+        // no limit based on bytes
+        return fCount >= SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+    }
+    // no limit based on count
+    return fTotalBytesUsed >= fTotalByteLimit;
+}
+
+void SkResourceCache::purgeByPriority() {
+    SkTDArray<Rec*> inUse;
+    while (fPriorityQueue.count() > 0 && this->overBudget()) {
+        Rec* rec = fPriorityQueue.peek();
+        if (rec->fRecentlyUsed.exchange(false, std::memory_order_relaxed)) {
+            // An unlocked Find() used it since we last set its priority.
+            this->moveToHead(rec);
+            continue;
+        }
+        fPriorityQueue.pop();
+        rec->fPriorityIndex = -1;
+        if (rec->canBePurged()) {
+            fInflation = rec->fPriority;
+            SkCounters::Add(SkCounter::kResourceCachePurges);
+            SkCounters::Record(SkHistogram::kResourceCachePurgeBytes, rec->bytesUsed());
+            this->remove(rec);
+        } else {
+            inUse.push(rec);
+        }
+    }
+    for (Rec* rec : inUse) {
+        fPriorityQueue.insert(rec);
+    }
+}
+
+void SkResourceCache::purgeAsNeeded(bool forcePurge) {
+    if (!forcePurge && EvictionPolicy::kCostAware == fEvictionPolicy) {
+        this->purgeByPriority();
+        this->reclaim();
+        return;
     }
 
     Rec* rec = fTail;
     while (rec) {
-        if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
+        if (!forcePurge && !this->overBudget()) {
             break;
         }
 
         Rec* prev = rec->fPrev;
-        if (rec->canBePurged()) {
+        if (!forcePurge && rec->fRecentlyUsed.exchange(false, std::memory_order_relaxed)) {
+            // An unlocked Find() used it since it was last moved, so it's not really the LRU.
+            this->moveToHead(rec);
+        } else if (rec->canBePurged()) {
+            SkCounters::Add(SkCounter::kResourceCachePurges);
+            SkCounters::Record(SkHistogram::kResourceCachePurgeBytes, rec->bytesUsed());
             this->remove(rec);
         }
         rec = prev;
     }
+    this->reclaim();
 }
 
 //#define SK_TRACK_PURGE_SHAREDID_HITRATE
@@ -248,6 +577,7 @@ void SkResourceCache::purgeSharedID(uint64_t sharedID) {
         }
         rec = prev;
     }
+    this->reclaim();
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
     if (found) {
@@ -280,6 +610,32 @@ size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
     return prevLimit;
 }
 
+void SkResourceCache::setEvictionPolicy(EvictionPolicy policy) {
+    if (policy == fEvictionPolicy) {
+        return;
+    }
+    fEvictionPolicy = policy;
+    if (EvictionPolicy::kCostAware == policy) {
+        for (Rec* rec = fHead; rec; rec = rec->fNext) {
+            this->updatePriority(rec);
+            fPriorityQueue.insert(rec);
+        }
+        this->purgeAsNeeded();
+    } else {
+        while (fPriorityQueue.count() > 0) {
+            Rec* rec = fPriorityQueue.peek();
+            fPriorityQueue.pop();
+            rec->fPriorityIndex = -1;
+        }
+    }
+}
+
+size_t SkResourceCache::setLargeRecAdmissionLimit(size_t newLimit) {
+    size_t prevLimit = fLargeRecAdmissionLimit;
+    fLargeRecAdmissionLimit = newLimit;
+    return prevLimit;
+}
+
 SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
     this->checkMessages();
 
@@ -314,6 +670,7 @@ void SkResourceCache::release(Rec* rec) {
 }
 
 void SkResourceCache::moveToHead(Rec* rec) {
+    this->updatePriority(rec);
     if (fHead == rec) {
         return;
     }
@@ -350,6 +707,24 @@ void SkResourceCache::addToHead(Rec* rec) {
     this->validate();
 }
 
+void SkResourceCache::addToTail(Rec* rec) {
+    this->validate();
+
+    rec->fNext = nullptr;
+    rec->fPrev = fTail;
+    if (fTail) {
+        fTail->fNext = rec;
+    }
+    fTail = rec;
+    if (!fHead) {
+        fHead = rec;
+    }
+    fTotalBytesUsed += rec->bytesUsed();
+    fCount += 1;
+
+    this->validate();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG
@@ -431,30 +806,36 @@ size_t SkResourceCache::getEffectiveSingleAllocationByteLimit() const {
 }
 
 void SkResourceCache::checkMessages() {
+    // Every message counted here is already in our inbox.
+    uint32_t posted = gPurgeMessagesPosted.load(std::memory_order_acquire);
     SkTArray<PurgeSharedIDMessage> msgs;
     fPurgeSharedIDInbox.poll(&msgs);
     for (int i = 0; i < msgs.count(); ++i) {
         this->purgeSharedID(msgs[i].fSharedID);
     }
+    fPurgeMessagesSeen.store(posted, std::memory_order_release);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = nullptr;
+// Written with gMutex held, but Find() reads it without.
+static std::atomic<SkResourceCache*> gResourceCache{nullptr};
 
 /** Must hold gMutex when calling. */
 static SkResourceCache* get_cache() {
     // gMutex is always held when this is called, so we don't need to be fancy in here.
     gMutex.assertHeld();
-    if (nullptr == gResourceCache) {
+    SkResourceCache* cache = gResourceCache.load(std::memory_order_relaxed);
+    if (nullptr == cache) {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+        cache = new SkResourceCache(SkDiscardableMemory::Create);
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+        cache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
 #endif
+        gResourceCache.store(cache, std::memory_order_release);
     }
-    return gResourceCache;
+    return cache;
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
@@ -507,7 +888,24 @@ void SkResourceCache::PurgeAll() {
     return get_cache()->purgeAll();
 }
 
+void SkResourceCache::SetEvictionPolicy(EvictionPolicy policy) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->setEvictionPolicy(policy);
+}
+
+size_t SkResourceCache::SetLargeRecAdmissionLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->setLargeRecAdmissionLimit(newLimit);
+}
+
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
+    if (SkResourceCache* cache = gResourceCache.load(std::memory_order_acquire)) {
+        switch (cache->findConcurrently(key, visitor, context)) {
+            case FindResult::kFound:     return true;
+            case FindResult::kNotFound:  return false;
+            case FindResult::kNeedsLock: break;
+        }
+    }
     SkAutoMutexAcquire am(gMutex);
     return get_cache()->find(key, visitor, context);
 }
@@ -525,6 +923,7 @@ void SkResourceCache::VisitAll(Visitor visitor, void* context) {
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
     if (sharedID) {
         SkMessageBus<PurgeSharedIDMessage>::Post(PurgeSharedIDMessage(sharedID));
+        gPurgeMessagesPosted.fetch_add(1, std::memory_order_release);
     }
 }
 
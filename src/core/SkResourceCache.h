@@ -11,6 +11,9 @@
 #include "SkBitmap.h"
 #include "SkMessageBus.h"
 #include "SkTDArray.h"
+#include "SkTDPQueue.h"
+
+#include <atomic>
 
 class SkCachedData;
 class SkDiscardableMemory;
@@ -25,6 +28,8 @@ class SkTraceMemoryDump;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  Find() on the global instance doesn't take its lock when the Rec it finds says it can be
+ *  found concurrently, so hits on those don't serialize the threads looking them up.
  */
 class SkResourceCache {
 public:
@@ -82,11 +87,26 @@ public:
         virtual const Key& getKey() const = 0;
         virtual size_t bytesUsed() const = 0;
 
+        // Roughly how much work it would be to make this Rec again if it's purged, in bytes
+        // written. EvictionPolicy::kCostAware keeps the Recs that cost the most per byte used.
+        // The default, bytesUsed(), suits Recs about as cheap to remake as to copy. This must not
+        // change while the Rec is in the cache.
+        virtual size_t regenerationCost() const { return this->bytesUsed(); }
+
         // Called if the cache needs to purge/remove/delete the Rec. Default returns true.
         // Subclass may return false if there are outstanding references to it (e.g. bitmaps).
         // Will only be deleted/removed-from-the-cache when this returns true.
         virtual bool canBePurged() { return true; }
 
+        // Return true if this Rec's FindVisitors are safe to call from several threads at once,
+        // without the cache's lock, and while other threads add and remove Recs. The global
+        // cache's Find() then calls them without taking its lock. Default returns false.
+        //
+        // A visitor may see a Rec that another thread has just removed from the cache. Such a Rec
+        // is only deleted once no unlocked Find() can still be looking at it, and if it can no
+        // longer be purged by then (e.g. the visitor handed out its pixels), it's put back.
+        virtual bool canBeFoundConcurrently() const { return false; }
+
         // A rec is first created/initialized, and then added to the cache. As part of the add(),
         // the cache will callback into the rec with postAddInstall, passing in whatever payload
         // was passed to add/Add.
@@ -106,6 +126,15 @@ public:
         Rec*    fNext;
         Rec*    fPrev;
 
+        // Set by unlocked Find()s, which can't move us to the head of the LRU list themselves.
+        // The next purge does it for them instead of purging us.
+        std::atomic<bool> fRecentlyUsed{false};
+
+        // For EvictionPolicy::kCostAware.
+        double   fPriority = 0;
+        uint64_t fLastUse = 0;   // breaks ties in fPriority, least recently used first
+        int      fPriorityIndex = -1;
+
         friend class SkResourceCache;
     };
 
@@ -118,6 +147,14 @@ public:
 
     typedef const Rec* ID;
 
+    enum class EvictionPolicy {
+        // Purge the least recently used Recs first.
+        kLRU,
+        // GreedyDual-Size: purge the Recs with the lowest regenerationCost() per byte first,
+        // aging everyone else so that Recs nobody uses eventually go too.
+        kCostAware,
+    };
+
     /**
      *  Callback function for find(). If called, the cache will have found a match for the
      *  specified Key, and will pass in the corresponding Rec, along with a caller-specified
@@ -167,6 +204,9 @@ public:
 
     static void PurgeAll();
 
+    static void SetEvictionPolicy(EvictionPolicy);
+    static size_t SetLargeRecAdmissionLimit(size_t);
+
     static void TestDumpMemoryStatistics();
 
     /** Dump memory usage statistics of every Rec in the cache using the
@@ -242,6 +282,22 @@ public:
      */
     size_t setTotalByteLimit(size_t newLimit);
 
+    /**
+     *  Choose how to pick the Recs to purge when we're over budget. The default is kLRU.
+     */
+    void setEvictionPolicy(EvictionPolicy);
+    EvictionPolicy getEvictionPolicy() const { return fEvictionPolicy; }
+
+    /**
+     *  Recs using more than this many bytes are admitted on probation the first time their key is
+     *  added: they're the next to be purged, so a one-off huge Rec can't push out the working set.
+     *  If the Rec is found again before it's purged, or its key is added again after, it's
+     *  treated like any other. 0 (the default) admits every Rec normally.
+     *  Returns the previous limit.
+     */
+    size_t setLargeRecAdmissionLimit(size_t);
+    size_t getLargeRecAdmissionLimit() const { return fLargeRecAdmissionLimit; }
+
     void purgeSharedID(uint64_t sharedID);
 
     void purgeAll() {
@@ -271,14 +327,54 @@ private:
     size_t  fSingleAllocationByteLimit;
     int     fCount;
 
+    static bool PriorityLess(Rec* const& a, Rec* const& b) {
+        return a->fPriority < b->fPriority ||
+               (a->fPriority == b->fPriority && a->fLastUse < b->fLastUse);
+    }
+    static int* PriorityIndex(Rec* const& rec) { return &rec->fPriorityIndex; }
+
+    EvictionPolicy  fEvictionPolicy;
+    // kCostAware's aging: the priority of the last Rec it purged. New and newly used Recs start
+    // this far up, so those that have been idle longest sink to the bottom.
+    double          fInflation;
+    uint64_t        fUseCount;
+    SkTDPQueue<Rec*, PriorityLess, PriorityIndex> fPriorityQueue;   // kCostAware only
+
+    // The recent keys admitted on probation, by hash, so we know when one comes back.
+    static constexpr int kProbationHashCount = 256;
+    size_t          fLargeRecAdmissionLimit;
+    uint32_t        fProbationHashes[kProbationHashCount];
+
     SkMessageBus<PurgeSharedIDMessage>::Inbox fPurgeSharedIDInbox;
+    // How many PostPurgeSharedID()s had been posted when we last checked our messages. Until
+    // we've seen them all, findConcurrently() can't answer without the lock.
+    std::atomic<uint32_t> fPurgeMessagesSeen;
+
+    enum class FindResult {
+        kFound,
+        kNotFound,
+        kNeedsLock,   // the Rec can't be found concurrently, or was stale and must be removed
+    };
+    // Like find(), but without holding the lock, for the global cache's Find().
+    FindResult findConcurrently(const Key&, FindVisitor, void* context);
 
     void checkMessages();
     void purgeAsNeeded(bool forcePurge = false);
+    // Delete the Recs we've removed, once no unlocked find can still be using them.
+    void reclaim();
+
+    bool overBudget() const;
+    void purgeByPriority();
+    bool admitOnProbation(const Rec&);
+    // Set rec's priority for kCostAware, as if it was just used.
+    void updatePriority(Rec*, bool onProbation = false);
+    // Link a new rec into the list, the hash and the priority queue.
+    void insert(Rec*, bool onProbation);
 
     // linklist management
     void moveToHead(Rec*);
     void addToHead(Rec*);
+    void addToTail(Rec*);
     void release(Rec*);
     void remove(Rec*);
 
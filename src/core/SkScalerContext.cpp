@@ -465,6 +465,22 @@ void SkScalerContext::getImage(const SkGlyph& origGlyph) {
     }
 }
 
+void SkScalerContext::getMetrics(SkGlyph* glyphs[], int count) {
+    this->generateBatch([&] {
+        for (int i = 0; i < count; ++i) {
+            this->getMetrics(glyphs[i]);
+        }
+    });
+}
+
+void SkScalerContext::getImages(const SkGlyph* glyphs[], int count) {
+    this->generateBatch([&] {
+        for (int i = 0; i < count; ++i) {
+            this->getImage(*glyphs[i]);
+        }
+    });
+}
+
 bool SkScalerContext::getPath(SkPackedGlyphID glyphID, SkPath* path) {
     return this->internalGetPath(glyphID, path);
 }
@@ -478,6 +494,10 @@ SkUnichar SkScalerContext::generateGlyphToChar(uint16_t glyph) {
     return 0;
 }
 
+void SkScalerContext::generateBatch(const std::function<void()>& fn) {
+    fn();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 bool SkScalerContext::internalGetPath(SkPackedGlyphID glyphID, SkPath* devPath) {
@@ -8,6 +8,7 @@
 #ifndef SkScalerContext_DEFINED
 #define SkScalerContext_DEFINED
 
+#include <functional>
 #include <memory>
 
 #include "SkGlyph.h"
@@ -297,6 +298,13 @@ public:
     bool SK_WARN_UNUSED_RESULT getPath(SkPackedGlyphID, SkPath*);
     void        getFontMetrics(SkPaint::FontMetrics*);
 
+    /** Batch versions of getMetrics and getImage, which subclasses can make cheaper than one
+        call per glyph (see generateBatch). As with getImage, each glyph's fImage must already
+        point to glyph.computeImageSize() bytes.
+    */
+    void        getMetrics(SkGlyph* glyphs[], int count);
+    void        getImages(const SkGlyph* glyphs[], int count);
+
     /** Return the size in bytes of the associated gamma lookup table
      */
     static size_t GetGammaLUTSize(SkScalar contrast, SkScalar paintGamma, SkScalar deviceGamma,
@@ -404,6 +412,12 @@ protected:
      */
     virtual SkUnichar generateGlyphToChar(uint16_t glyphId);
 
+    /** Calls fn, which makes a run of generateMetrics and generateImage calls on this context.
+     *  Subclasses with expensive per-glyph setup (taking locks, activating a size) can do it
+     *  once here instead.  The default implementation just calls fn.
+     */
+    virtual void generateBatch(const std::function<void()>& fn);
+
     void forceGenerateImageFromPath() { fGenerateImageFromPath = true; }
     void forceOffGenerateImageFromPath() { fGenerateImageFromPath = false; }
 
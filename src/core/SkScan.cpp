@@ -16,6 +16,10 @@ std::atomic<bool> gSkForceAnalyticAA{false};
 std::atomic<bool> gSkUseDeltaAA{true};
 std::atomic<bool> gSkForceDeltaAA{false};
 
+std::atomic<int>  gSkDAABandEdgeThreshold{0};
+
+std::atomic<bool> gSkUseAACostModel{false};
+
 static inline void blitrect(SkBlitter* blitter, const SkIRect& r) {
     blitter->blitRect(r.fLeft, r.fTop, r.width(), r.height());
 }
@@ -29,6 +29,14 @@ extern std::atomic<bool> gSkForceDeltaAA;
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
 
+// If > 0, DAA splits paths with more edges than this into horizontal bands whose deltas are
+// generated in parallel on SkExecutor::GetDefault().
+extern std::atomic<int>  gSkDAABandEdgeThreshold;
+
+// If true, pick the AA scan converter with the lowest estimated cost (see SkAACostModel.h) unless
+// analytic or delta AA is forced.
+extern std::atomic<bool> gSkUseAACostModel;
+
 class AdditiveBlitter;
 
 class SkScan {
@@ -77,6 +85,11 @@ public:
     static void AntiFillPath(const SkPath& path, const SkRasterClip& rc, SkBlitter* blitter) {
         AntiFillPath(path, rc, blitter, nullptr);
     }
+
+    // Fills a path inside clipBounds with delta AA, splitting it into bands like AntiFillPath()
+    // does when gSkDAABandEdgeThreshold is bandEdgeThreshold.
+    static void DAAFillPathForTesting(const SkPath&, const SkIRect& clipBounds, SkBlitter*,
+                                      int bandEdgeThreshold);
 private:
     friend class SkAAClip;
     friend class SkRegion;
@@ -97,7 +110,8 @@ private:
     static void AAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
     static void DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
-                            const SkIRect& clipBounds, bool forceRLE, SkDAARecord* daaRecord);
+                            const SkIRect& clipBounds, bool forceRLE, SkDAARecord* daaRecord,
+                            int bandEdgeThreshold);
     static void SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
 };
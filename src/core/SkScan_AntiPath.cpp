@@ -14,6 +14,8 @@
 #include "SkRegion.h"
 #include "SkAntiRun.h"
 #include "SkCoverageDelta.h"
+#include "SkAACostModel.h"
+#include "SkTraceEvent.h"
 
 #define SHIFT   SK_SUPERSAMPLE_SHIFT
 #define SCALE   (1 << SHIFT)
@@ -684,6 +686,31 @@ static bool ShouldUseAAA(const SkPath& path) {
     return path.countPoints() < SkTMax(bounds.width(), bounds.height()) / 2 - 10;
 }
 
+static SkAACostModel::ScanConverter ChooseScanConverter(const SkPath& path,
+                                                        const SkIRect& clipBounds,
+                                                        bool hasDAARecord) {
+    // The threaded backend has already decided to use DAA.
+    if (hasDAARecord) {
+        return SkAACostModel::kDelta;
+    }
+
+    if (gSkUseAACostModel && !gSkForceDeltaAA && !gSkForceAnalyticAA) {
+        bool allowDelta = gSkUseDeltaAA && !SkPathPriv::IsBadForDAA(path);
+        return SkAACostModel::Get().choose(SkAACostModel::Features::Make(path, clipBounds),
+                                           gSkUseAnalyticAA, allowDelta);
+    }
+
+    if (ShouldUseDAA(path)) {
+        return SkAACostModel::kDelta;
+    }
+    if (ShouldUseAAA(path)) {
+        // Do not use AAA if path is too complicated:
+        // there won't be any speedup or significant visual improvement.
+        return SkAACostModel::kAnalytic;
+    }
+    return SkAACostModel::kSupersample;
+}
+
 void SkScan::SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
                   const SkIRect& clipBounds, bool forceRLE) {
     bool containedInClip = clipBounds.contains(ir);
@@ -799,14 +826,21 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         sk_blit_above(blitter, ir, *clipRgn);
     }
 
-    if (daaRecord || ShouldUseDAA(path)) {
-        SkScan::DAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE, daaRecord);
-    } else if (ShouldUseAAA(path)) {
-        // Do not use AAA if path is too complicated:
-        // there won't be any speedup or significant visual improvement.
-        SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
-    } else {
-        SkScan::SAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+    SkAACostModel::ScanConverter scanConverter =
+            ChooseScanConverter(path, clipRgn->getBounds(), daaRecord != nullptr);
+    TRACE_EVENT1("skia", "SkScan::AntiFillPath",
+                 "scanConverter", SkAACostModel::Name(scanConverter));
+    switch (scanConverter) {
+        case SkAACostModel::kDelta:
+            SkScan::DAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE, daaRecord,
+                                gSkDAABandEdgeThreshold.load(std::memory_order_relaxed));
+            break;
+        case SkAACostModel::kAnalytic:
+            SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+            break;
+        case SkAACostModel::kSupersample:
+            SkScan::SAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+            break;
     }
 
     if (isInverse) {
@@ -10,6 +10,7 @@
 #include "SkBlitter.h"
 #include "SkColorData.h"
 #include "SkLineClipper.h"
+#include "SkNx.h"
 #include "SkRasterClip.h"
 #include "SkFDot6.h"
 
@@ -519,6 +520,68 @@ static void do_anti_hairline(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1,
     }
 }
 
+static void anti_hair_segment(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1,
+                              const SkRegion* clip, SkBlitter* blitter) {
+    if (clip) {
+        SkFDot6 left = SkMin32(x0, x1);
+        SkFDot6 top = SkMin32(y0, y1);
+        SkFDot6 right = SkMax32(x0, x1);
+        SkFDot6 bottom = SkMax32(y0, y1);
+        SkIRect ir;
+
+        ir.set( SkFDot6Floor(left) - 1,
+                SkFDot6Floor(top) - 1,
+                SkFDot6Ceil(right) + 1,
+                SkFDot6Ceil(bottom) + 1);
+
+        if (clip->quickReject(ir)) {
+            return;
+        }
+        if (!clip->quickContains(ir)) {
+            SkRegion::Cliperator iter(*clip, ir);
+            const SkIRect*       r = &iter.rect();
+
+            while (!iter.done()) {
+                do_anti_hairline(x0, y0, x1, y1, r, blitter);
+                iter.next();
+            }
+            return;
+        }
+        // fall through to no-clip case
+    }
+    do_anti_hairline(x0, y0, x1, y1, nullptr, blitter);
+}
+
+// Like SkRect::contains(), but inner may be empty, e.g. the bounds of a horizontal polyline.
+static bool contains_no_empty_check(const SkRect& outer, const SkRect& inner) {
+    return  outer.fLeft <= inner.fLeft && outer.fTop <= inner.fTop &&
+            outer.fRight >= inner.fRight && outer.fBottom >= inner.fBottom;
+}
+
+/*  Draws a polyline that lies within the (outset) clip bounds and SkFixed's range, so no
+    segment needs IntersectLine(). We convert all the points to SkFDot6 up front, four
+    coordinates at a time, the same way SkScalarToFDot6() does one at a time.
+ */
+static void anti_hair_polyline(const SkPoint array[], int arrayCount, const SkRegion* clip,
+                               SkBlitter* blitter) {
+    const int n = 2 * arrayCount;
+    const float* src = &array[0].fX;
+    SkAutoSTMalloc<64, SkFDot6> storage(n);
+    SkFDot6* dot6 = storage.get();
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        SkNx_cast<int>(Sk4f::Load(src + i) * 64).store(dot6 + i);
+    }
+    for (; i < n; ++i) {
+        dot6[i] = SkScalarToFDot6(src[i]);
+    }
+
+    for (i = 0; i + 2 < n; i += 2) {
+        anti_hair_segment(dot6[i], dot6[i + 1], dot6[i + 2], dot6[i + 3], clip, blitter);
+    }
+}
+
 void SkScan::AntiHairLineRgn(const SkPoint array[], int arrayCount, const SkRegion* clip,
                              SkBlitter* blitter) {
     if (clip && clip->isEmpty()) {
@@ -549,6 +612,16 @@ void SkScan::AntiHairLineRgn(const SkPoint array[], int arrayCount, const SkRegi
         clipBounds.outset(SK_Scalar1, SK_Scalar1);
     }
 
+    // Usually a polyline lies inside the clip, and IntersectLine() would pass every segment
+    // through unchanged. Check that once for the whole polyline.
+    SkRect bounds;
+    if (arrayCount > 2 && bounds.setBoundsCheck(array, arrayCount) &&
+            contains_no_empty_check(fixedBounds, bounds) &&
+            (!clip || contains_no_empty_check(clipBounds, bounds))) {
+        anti_hair_polyline(array, arrayCount, clip, blitter);
+        return;
+    }
+
     for (int i = 0; i < arrayCount - 1; ++i) {
         SkPoint pts[2];
 
@@ -562,39 +635,8 @@ void SkScan::AntiHairLineRgn(const SkPoint array[], int arrayCount, const SkRegi
             continue;
         }
 
-        SkFDot6 x0 = SkScalarToFDot6(pts[0].fX);
-        SkFDot6 y0 = SkScalarToFDot6(pts[0].fY);
-        SkFDot6 x1 = SkScalarToFDot6(pts[1].fX);
-        SkFDot6 y1 = SkScalarToFDot6(pts[1].fY);
-
-        if (clip) {
-            SkFDot6 left = SkMin32(x0, x1);
-            SkFDot6 top = SkMin32(y0, y1);
-            SkFDot6 right = SkMax32(x0, x1);
-            SkFDot6 bottom = SkMax32(y0, y1);
-            SkIRect ir;
-
-            ir.set( SkFDot6Floor(left) - 1,
-                    SkFDot6Floor(top) - 1,
-                    SkFDot6Ceil(right) + 1,
-                    SkFDot6Ceil(bottom) + 1);
-
-            if (clip->quickReject(ir)) {
-                continue;
-            }
-            if (!clip->quickContains(ir)) {
-                SkRegion::Cliperator iter(*clip, ir);
-                const SkIRect*       r = &iter.rect();
-
-                while (!iter.done()) {
-                    do_anti_hairline(x0, y0, x1, y1, r, blitter);
-                    iter.next();
-                }
-                continue;
-            }
-            // fall through to no-clip case
-        }
-        do_anti_hairline(x0, y0, x1, y1, nullptr, blitter);
+        anti_hair_segment(SkScalarToFDot6(pts[0].fX), SkScalarToFDot6(pts[0].fY),
+                          SkScalarToFDot6(pts[1].fX), SkScalarToFDot6(pts[1].fY), clip, blitter);
     }
 }
 
@@ -20,6 +20,7 @@
 #include "SkRegion.h"
 #include "SkScan.h"
 #include "SkScanPriv.h"
+#include "SkTaskGroup.h"
 #include "SkTSort.h"
 #include "SkTemplates.h"
 #include "SkUtils.h"
@@ -149,76 +150,11 @@ public:
     }
 };
 
-template<class Deltas> static SK_ALWAYS_INLINE
-void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRect& clipBounds,
-        Deltas& result, SkBlitter* blitter, bool skipRect, bool pathContainedInClip) {
-    // 1. Build edges
-    SkEdgeBuilder builder;
-    // We have to use clipBounds instead of clippedIR to build edges because of "canCullToTheRight":
-    // if the builder finds a right edge past the right clip, it won't build that right edge.
-    int  count = builder.build_edges(path, &clipBounds, 0, pathContainedInClip,
-                                     SkEdgeBuilder::kBezier);
-
-    if (count == 0) {
-        return;
-    }
-    SkBezier** list = builder.bezierList();
-
-    // 2. Try to find the rect part because blitAntiRect is so much faster than blitCoverageDeltas
-    int rectTop = clippedIR.fBottom;   // the rect is initialized to be empty as top = bot
-    int rectBot = clippedIR.fBottom;
-    if (skipRect) {             // only find that rect is skipRect == true
-        YLessThan lessThan;     // sort edges in YX order
-        SkTQSort(list, list + count - 1, lessThan);
-        for(int i = 0; i < count - 1; ++i) {
-            SkBezier* lb = list[i];
-            SkBezier* rb = list[i + 1];
-
-            // fCount == 2 ensures that lb and rb are lines instead of quads or cubics.
-            bool lDX0 = lb->fP0.fX == lb->fP1.fX && lb->fCount == 2;
-            bool rDX0 = rb->fP0.fX == rb->fP1.fX && rb->fCount == 2;
-            if (!lDX0 || !rDX0) { // make sure that the edges are vertical
-                continue;
-            }
-
-            SkAnalyticEdge l, r;
-            l.setLine(lb->fP0, lb->fP1);
-            r.setLine(rb->fP0, rb->fP1);
-
-            SkFixed xorUpperY = l.fUpperY ^ r.fUpperY;
-            SkFixed xorLowerY = l.fLowerY ^ r.fLowerY;
-            if ((xorUpperY | xorLowerY) == 0) { // equal upperY and lowerY
-                rectTop = SkFixedCeilToInt(l.fUpperY);
-                rectBot = SkFixedFloorToInt(l.fLowerY);
-                if (rectBot > rectTop) { // if bot == top, the rect is too short for blitAntiRect
-                    int L = SkFixedCeilToInt(l.fUpperX);
-                    int R = SkFixedFloorToInt(r.fUpperX);
-                    if (L <= R) {
-                        SkAlpha la = (SkIntToFixed(L) - l.fUpperX) >> 8;
-                        SkAlpha ra = (r.fUpperX - SkIntToFixed(R)) >> 8;
-                        result.setAntiRect(L - 1, rectTop, R - L, rectBot - rectTop, la, ra);
-                    } else { // too thin to use blitAntiRect; reset the rect region to be emtpy
-                        rectTop = rectBot = clippedIR.fBottom;
-                    }
-                }
-                break;
-            }
-
-        }
-    }
-
-    // 3. Sort edges in x so we may need less sorting for delta based on x. This only helps
-    //    SkCoverageDeltaList. And we don't want to sort more than SORT_THRESHOLD edges where
-    //    the log(count) factor of the quick sort may become a bottleneck; when there are so
-    //    many edges, we're unlikely to make deltas sorted anyway.
-    constexpr int SORT_THRESHOLD = 256;
-    if (std::is_same<Deltas, SkCoverageDeltaList>::value && count < SORT_THRESHOLD) {
-        XLessThan lessThan;
-        SkTQSort(list, list + count - 1, lessThan);
-    }
-
-    // Future todo: parallize and SIMD the following code.
-    // 4. iterate through edges and generate deltas
+// Generates the deltas of the edges in list, but only for the rows in [rows.fTop, rows.fBottom).
+// We only read the edges so multiple threads can do this at the same time for different rows.
+template<class Deltas>
+static void gen_edge_deltas(SkBezier** list, int count, const SkIRect& rows, int rectTop,
+                            int rectBot, Deltas& result) {
     for(int index = 0; index < count; ++index) {
         SkAnalyticCubicEdge storage;
         SkASSERT(sizeof(SkAnalyticQuadraticEdge) >= sizeof(SkAnalyticEdge));
@@ -228,6 +164,13 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
         SkAnalyticEdge* currE   = &storage;
         bool edgeSet            = false;
 
+        // Skip lines that can't touch our rows. (1 pixel of slack for the fixed point rounding.)
+        if (bezier->fCount == 2 &&
+                (SkTMax(bezier->fP0.fY, bezier->fP1.fY) < rows.fTop - 1 ||
+                 SkTMin(bezier->fP0.fY, bezier->fP1.fY) > rows.fBottom + 1)) {
+            continue;
+        }
+
         int originalWinding = 1;
         bool sortY = true;
         switch (bezier->fCount) {
@@ -267,7 +210,7 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
             if (lowerCeil <= upperFloor + SK_Fixed1) { // only one row is affected by the currE
                 SkFixed rowHeight = currE->fLowerY - currE->fUpperY;
                 SkFixed nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
-                if (iy >= clippedIR.fTop && iy < clippedIR.fBottom) {
+                if (iy >= rows.fTop && iy < rows.fBottom) {
                     add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
                 }
                 continue;
@@ -278,20 +221,30 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
             SkFixed nextX;
             if (rowHeight != SK_Fixed1) {   // it's a partial row
                 nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
-                add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
+                if (iy >= rows.fTop && iy < rows.fBottom) {
+                    add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
+                }
             } else {                        // it's a full row so we can leave it to the while loop
                 iy--;                       // compensate the iy++ in the while loop
                 nextX = currE->fX;
             }
 
+            // Jump over the full rows above our rows. Adding fDX row by row is exact in SkFixed,
+            // so this lands on the very same nextX as the while loop below would have.
+            int skipRows = SkTMin(rows.fTop, SkFixedFloorToInt(currE->fLowerY)) - (iy + 1);
+            if (skipRows > 0) {
+                iy    += skipRows;
+                nextX += currE->fDX * skipRows;
+            }
+
             while (true) { // process the full rows in the middle
                 iy++;
                 SkFixed y = SkIntToFixed(iy);
                 currE->fX = nextX;
                 nextX += currE->fDX;
 
-                if (y + SK_Fixed1 > currE->fLowerY) {
-                    break; // no full rows left, break
+                if (y + SK_Fixed1 > currE->fLowerY || iy >= rows.fBottom) {
+                    break; // no full rows left (or no rows left that we care about), break
                 }
 
                 // Check whether we're in the rect part that will be covered by blitAntiRect
@@ -307,7 +260,7 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
 
             // last partial row
             if (SkIntToFixed(iy) < currE->fLowerY &&
-                    iy >= clippedIR.fTop && iy < clippedIR.fBottom) {
+                    iy >= rows.fTop && iy < rows.fBottom) {
                 rowHeight = currE->fLowerY - SkIntToFixed(iy);
                 nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
                 add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
@@ -317,8 +270,131 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
     }
 }
 
+template<class Deltas> static SK_ALWAYS_INLINE
+void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRect& clipBounds,
+        Deltas& result, SkBlitter* blitter, bool skipRect, bool pathContainedInClip) {
+    // 1. Build edges
+    SkEdgeBuilder builder;
+    // We have to use clipBounds instead of clippedIR to build edges because of "canCullToTheRight":
+    // if the builder finds a right edge past the right clip, it won't build that right edge.
+    int  count = builder.build_edges(path, &clipBounds, 0, pathContainedInClip,
+                                     SkEdgeBuilder::kBezier);
+
+    if (count == 0) {
+        return;
+    }
+    SkBezier** list = builder.bezierList();
+
+    // 2. Try to find the rect part because blitAntiRect is so much faster than blitCoverageDeltas
+    int rectTop = clippedIR.fBottom;   // the rect is initialized to be empty as top = bot
+    int rectBot = clippedIR.fBottom;
+    if (skipRect) {             // only find that rect is skipRect == true
+        YLessThan lessThan;     // sort edges in YX order
+        SkTQSort(list, list + count - 1, lessThan);
+        for(int i = 0; i < count - 1; ++i) {
+            SkBezier* lb = list[i];
+            SkBezier* rb = list[i + 1];
+
+            // fCount == 2 ensures that lb and rb are lines instead of quads or cubics.
+            bool lDX0 = lb->fP0.fX == lb->fP1.fX && lb->fCount == 2;
+            bool rDX0 = rb->fP0.fX == rb->fP1.fX && rb->fCount == 2;
+            if (!lDX0 || !rDX0) { // make sure that the edges are vertical
+                continue;
+            }
+
+            SkAnalyticEdge l, r;
+            l.setLine(lb->fP0, lb->fP1);
+            r.setLine(rb->fP0, rb->fP1);
+
+            SkFixed xorUpperY = l.fUpperY ^ r.fUpperY;
+            SkFixed xorLowerY = l.fLowerY ^ r.fLowerY;
+            if ((xorUpperY | xorLowerY) == 0) { // equal upperY and lowerY
+                rectTop = SkFixedCeilToInt(l.fUpperY);
+                rectBot = SkFixedFloorToInt(l.fLowerY);
+                if (rectBot > rectTop) { // if bot == top, the rect is too short for blitAntiRect
+                    int L = SkFixedCeilToInt(l.fUpperX);
+                    int R = SkFixedFloorToInt(r.fUpperX);
+                    if (L <= R) {
+                        SkAlpha la = (SkIntToFixed(L) - l.fUpperX) >> 8;
+                        SkAlpha ra = (r.fUpperX - SkIntToFixed(R)) >> 8;
+                        result.setAntiRect(L - 1, rectTop, R - L, rectBot - rectTop, la, ra);
+                    } else { // too thin to use blitAntiRect; reset the rect region to be emtpy
+                        rectTop = rectBot = clippedIR.fBottom;
+                    }
+                }
+                break;
+            }
+
+        }
+    }
+
+    // 3. Sort edges in x so we may need less sorting for delta based on x. This only helps
+    //    SkCoverageDeltaList. And we don't want to sort more than SORT_THRESHOLD edges where
+    //    the log(count) factor of the quick sort may become a bottleneck; when there are so
+    //    many edges, we're unlikely to make deltas sorted anyway.
+    constexpr int SORT_THRESHOLD = 256;
+    if (std::is_same<Deltas, SkCoverageDeltaList>::value && count < SORT_THRESHOLD) {
+        XLessThan lessThan;
+        SkTQSort(list, list + count - 1, lessThan);
+    }
+
+    // 4. iterate through edges and generate deltas
+    gen_edge_deltas(list, count, clippedIR, rectTop, rectBot, result);
+}
+
+// How many horizontal bands should we split clippedIR into so their deltas can be generated in
+// parallel? Returns 1 if the path isn't big enough to be worth it.
+static int band_count(const SkPath& path, const SkIRect& clippedIR, int threshold) {
+    constexpr int kMinBandHeight = 16;
+    constexpr int kMaxBands      = 32;
+
+    // countPoints() is a cheap upper bound of the number of edges that we'll build.
+    if (threshold <= 0 || path.countPoints() <= threshold) {
+        return 1;
+    }
+    return SkTPin(clippedIR.height() / kMinBandHeight, 1, kMaxBands);
+}
+
+// The edges are built once, then each band generates its own SkCoverageDeltaList from them on an
+// SkExecutor thread. Blitters aren't thread-safe, so the bands are then blitted in order on this
+// thread. Every row only ever gets the deltas it would have gotten without bands, so the result is
+// exactly the same as drawing the whole path at once.
+static void fill_path_in_bands(const SkPath& path, SkBlitter* blitter, const SkIRect& clippedIR,
+                               const SkIRect& clipBounds, bool forceRLE, bool isEvenOdd,
+                               bool isConvex, bool containedInClip, int bands) {
+    constexpr int kBandAllocSize = 16 << 10;
+
+    SkEdgeBuilder builder;
+    int count = builder.build_edges(path, &clipBounds, 0, containedInClip, SkEdgeBuilder::kBezier);
+    if (count == 0) {
+        return;
+    }
+    SkBezier** list = builder.bezierList();
+
+    SkAutoTArray<std::unique_ptr<SkArenaAlloc>> allocs(bands);
+    SkAutoTArray<SkCoverageDeltaList*>          lists(bands);
+
+    SkTaskGroup tg;
+    tg.batch(bands, [&](int i) {
+        SkIRect bandIR = clippedIR;
+        bandIR.fTop    = clippedIR.fTop + clippedIR.height() *  i      / bands;
+        bandIR.fBottom = clippedIR.fTop + clippedIR.height() * (i + 1) / bands;
+
+        allocs[i].reset(new SkArenaAlloc(kBandAllocSize));
+        lists[i] = allocs[i]->make<SkCoverageDeltaList>(allocs[i].get(), bandIR, forceRLE);
+        // We don't look for a rect to blitAntiRect: it could span several bands.
+        gen_edge_deltas(list, count, bandIR, bandIR.fBottom, bandIR.fBottom, *lists[i]);
+    });
+    tg.wait();
+
+    for (int i = 0; i < bands; ++i) {
+        blitter->blitCoverageDeltas(lists[i], clipBounds, isEvenOdd, false, isConvex);
+    }
+}
+
 void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
-                         const SkIRect& clipBounds, bool forceRLE, SkDAARecord* record) {
+                         const SkIRect& clipBounds, bool forceRLE, SkDAARecord* record,
+                         int bandEdgeThreshold) {
     bool containedInClip = clipBounds.contains(ir);
     bool isEvenOdd  = path.getFillType() & 1;
     bool isConvex   = path.isConvex();
@@ -336,6 +412,16 @@ void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect&
         return;
     }
 
+    // The threaded backend (record != nullptr) already splits the work across threads.
+    if (!record && !isInverse && !SkCoverageDeltaMask::Suitable(clippedIR)) {
+        int bands = band_count(path, clippedIR, bandEdgeThreshold);
+        if (bands > 1) {
+            fill_path_in_bands(path, blitter, clippedIR, clipBounds, forceRLE, isEvenOdd, isConvex,
+                               containedInClip, bands);
+            return;
+        }
+    }
+
 #ifdef SK_BUILD_FOR_GOOGLE3
     constexpr int STACK_SIZE = 12 << 10; // 12K stack size alloc; Google3 has 16K limit.
 #else
@@ -383,3 +469,10 @@ void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect&
         }
     }
 }
+
+void SkScan::DAAFillPathForTesting(const SkPath& path, const SkIRect& clipBounds,
+                                   SkBlitter* blitter, int bandEdgeThreshold) {
+    SkASSERT(!path.isInverseFillType());
+    DAAFillPath(path, blitter, path.getBounds().roundOut(), clipBounds, false, nullptr,
+                bandEdgeThreshold);
+}
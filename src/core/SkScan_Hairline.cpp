@@ -201,6 +201,7 @@ void SkScan::HairRect(const SkRect& rect, const SkRasterClip& clip, SkBlitter* b
 #include "SkPath.h"
 #include "SkGeometry.h"
 #include "SkNx.h"
+#include "SkTDArray.h"
 
 #define kMaxCubicSubdivideLevel 9
 #define kMaxQuadSubdivideLevel  5
@@ -559,10 +560,23 @@ void hair_path(const SkPath& path, const SkRasterClip& rclip, SkBlitter* blitter
     SkPath::Verb        verb, prevVerb;
     SkAutoConicToQuads  converter;
 
+    // With butt caps, each run of lines is drawn as one polyline, so lineproc can clip and set
+    // up once for the whole run rather than once per segment.
+    SkTDArray<SkPoint> polyline;
+    auto flushPolyline = [&]() {
+        if (polyline.count() > 1) {
+            lineproc(polyline.begin(), polyline.count(), clip, blitter);
+        }
+        polyline.rewind();
+    };
+
     if (SkPaint::kButt_Cap != capStyle) {
         prevVerb = SkPath::kDone_Verb;
     }
     while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        if (SkPath::kLine_Verb != verb) {
+            flushPolyline();
+        }
         switch (verb) {
             case SkPath::kMove_Verb:
                 firstPt = lastPt = pts[0];
@@ -570,8 +584,13 @@ void hair_path(const SkPath& path, const SkRasterClip& rclip, SkBlitter* blitter
             case SkPath::kLine_Verb:
                 if (SkPaint::kButt_Cap != capStyle) {
                     extend_pts<capStyle>(prevVerb, iter.peek(), pts, 2);
+                    lineproc(pts, 2, clip, blitter);
+                } else {
+                    if (polyline.isEmpty()) {
+                        *polyline.append() = pts[0];
+                    }
+                    *polyline.append() = pts[1];
                 }
-                lineproc(pts, 2, clip, blitter);
                 lastPt = pts[1];
                 break;
             case SkPath::kQuad_Verb:
@@ -624,6 +643,7 @@ void hair_path(const SkPath& path, const SkRasterClip& rclip, SkBlitter* blitter
             prevVerb = verb;
         }
     }
+    flushPolyline();
 }
 
 void SkScan::HairPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
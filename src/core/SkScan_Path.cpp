@@ -10,6 +10,7 @@
 #include "SkEdge.h"
 #include "SkEdgeBuilder.h"
 #include "SkGeometry.h"
+#include "SkNx.h"
 #include "SkPath.h"
 #include "SkQuadClipper.h"
 #include "SkRasterClip.h"
@@ -187,6 +188,274 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// Flipping the sign bit makes signed values sort as unsigned.
+static inline uint32_t sortable_key(int32_t value) {
+    return (uint32_t)value ^ 0x80000000;
+}
+
+// Stable LSD radix sort of values[] by keys[], a byte at a time. The scratch arrays must hold
+// count entries each.
+template <typename Key, typename T>
+static void radix_sort(Key keys[], T values[], Key keyScratch[], T valueScratch[], int count) {
+    SkASSERT(count > 0);
+    constexpr int kPasses = sizeof(Key);
+    int histograms[kPasses][256] = {};
+    for (int i = 0; i < count; ++i) {
+        for (int pass = 0; pass < kPasses; ++pass) {
+            histograms[pass][(keys[i] >> (8 * pass)) & 0xFF] += 1;
+        }
+    }
+
+    Key* srcKeys = keys;
+    Key* dstKeys = keyScratch;
+    T*   src = values;
+    T*   dst = valueScratch;
+    for (int pass = 0; pass < kPasses; ++pass) {
+        const int shift = 8 * pass;
+        int* offsets = histograms[pass];
+        if (offsets[(srcKeys[0] >> shift) & 0xFF] == count) {
+            continue;   // every key has the same byte here, so this pass wouldn't move anything
+        }
+        int sum = 0;
+        for (int d = 0; d < 256; ++d) {
+            int n = offsets[d];
+            offsets[d] = sum;
+            sum += n;
+        }
+        for (int i = 0; i < count; ++i) {
+            int j = offsets[(srcKeys[i] >> shift) & 0xFF]++;
+            dstKeys[j] = srcKeys[i];
+            dst[j] = src[i];
+        }
+        SkTSwap(srcKeys, dstKeys);
+        SkTSwap(src, dst);
+    }
+
+    if (src != values) {
+        memcpy(values, src, count * sizeof(T));
+    }
+}
+
+/*  walk_edges() for paths of many line edges. Rather than a linked list of edges, we keep each
+    field of the active edges in its own array, so we can step all their x's four at a time, and
+    keep their order as a separate array of indices, sorted by x. Re-sorting after a step and
+    merging in new edges (which arrive sorted by x) then only moves indices. Edges end up in
+    exactly the order walk_edges() would put them in, ties included, so the two draw the same
+    spans.
+ */
+class ActiveLineEdges {
+public:
+    explicit ActiveLineEdges(int capacity) {
+        // Pad the fields to a multiple of 4, so step() can run past the last edge.
+        const int padded = SkAlign4(capacity);
+        fStorage.reset(4 * padded + 2 * capacity);
+        fKeys.reset(2 * capacity);
+        fX       = fStorage.get();
+        fDX      = fStorage.get() + 1 * padded;
+        fLastY   = fStorage.get() + 2 * padded;
+        fWinding = fStorage.get() + 3 * padded;
+        fOrder   = fStorage.get() + 4 * padded;
+        fMerged  = fStorage.get() + 4 * padded + capacity;
+    }
+
+    int count() const { return fCount; }
+    SkFixed x(int i) const { return fX[fOrder[i]]; }
+    int winding(int i) const { return fWinding[fOrder[i]]; }
+
+    // Appends an edge, which must not be left of the last one.
+    void append(const SkEdge* edge) {
+        fOrder[fCount++] = this->add(edge);
+    }
+
+    // Drops the edges that end at y, steps the rest to y + 1, and re-sorts them by x.
+    void step(int y) {
+        // Dropped edges keep their slots until we compact, so we step some dead ones too.
+        for (int i = 0; i < fSlots; i += 4) {
+            (Sk4i::Load(fX + i) + Sk4i::Load(fDX + i)).store(fX + i);
+        }
+
+        int n = 0;
+        for (int i = 0; i < fCount; ++i) {
+            if (fLastY[fOrder[i]] != y) {
+                fOrder[n++] = fOrder[i];
+            }
+        }
+        fCount = n;
+
+        // Stepping only swaps edges that cross, so an insertion sort is usually all we need.
+        // Each edge goes after the last edge with x <= its own, like
+        // backward_insert_edge_based_on_x(). If many edges cross, we radix sort instead; it's
+        // stable too, so it gives the same order.
+        int budget = 4 * fCount + 64;
+        for (int i = 1; i < fCount; ++i) {
+            if (budget < 0) {
+                this->radixSort();
+                break;
+            }
+            const int slot = fOrder[i];
+            const SkFixed x = fX[slot];
+            int j = i;
+            while (j > 0 && fX[fOrder[j - 1]] > x) {
+                fOrder[j] = fOrder[j - 1];
+                --j;
+            }
+            fOrder[j] = slot;
+            budget -= i - j;
+        }
+
+        if (fSlots > 2 * fCount + 64) {
+            this->compact();
+        }
+    }
+
+    // Merges in newEdges[0..count), which are sorted by x, the way insert_new_edges() does:
+    // the first goes after any edges with the same x, the rest before them.
+    void merge(SkEdge* const newEdges[], int count) {
+        if (0 == count) {
+            return;
+        }
+        int i = 0, n = 0;
+        while (i < fCount && fX[fOrder[i]] <= newEdges[0]->fX) {
+            fMerged[n++] = fOrder[i++];
+        }
+        fMerged[n++] = this->add(newEdges[0]);
+        for (int e = 1; e < count; ++e) {
+            while (i < fCount && fX[fOrder[i]] < newEdges[e]->fX) {
+                fMerged[n++] = fOrder[i++];
+            }
+            fMerged[n++] = this->add(newEdges[e]);
+        }
+        while (i < fCount) {
+            fMerged[n++] = fOrder[i++];
+        }
+        fCount = n;
+        SkTSwap(fOrder, fMerged);
+    }
+
+private:
+    int add(const SkEdge* edge) {
+        const int slot = fSlots++;
+        fX[slot] = edge->fX;
+        fDX[slot] = edge->fDX;
+        fLastY[slot] = edge->fLastY;
+        fWinding[slot] = edge->fWinding;
+        return slot;
+    }
+
+    void radixSort() {
+        uint32_t* keys = fKeys.get();
+        for (int i = 0; i < fCount; ++i) {
+            keys[i] = sortable_key(fX[fOrder[i]]);
+        }
+        radix_sort(keys, fOrder, keys + fCount, fMerged, fCount);
+    }
+
+    // Moves the live edges' fields to the front, keeping their order.
+    void compact() {
+        int32_t* remap = fMerged;
+        for (int slot = 0; slot < fSlots; ++slot) {
+            remap[slot] = -1;
+        }
+        for (int i = 0; i < fCount; ++i) {
+            remap[fOrder[i]] = 0;
+        }
+        int n = 0;
+        for (int slot = 0; slot < fSlots; ++slot) {
+            if (remap[slot] < 0) {
+                continue;
+            }
+            fX[n] = fX[slot];
+            fDX[n] = fDX[slot];
+            fLastY[n] = fLastY[slot];
+            fWinding[n] = fWinding[slot];
+            remap[slot] = n++;
+        }
+        SkASSERT(n == fCount);
+        for (int i = 0; i < fCount; ++i) {
+            fOrder[i] = remap[fOrder[i]];
+        }
+        fSlots = n;
+    }
+
+    SkAutoTMalloc<int32_t>  fStorage;
+    SkAutoTMalloc<uint32_t> fKeys;      // scratch for radixSort()
+    SkFixed* fX;
+    SkFixed* fDX;
+    int32_t* fLastY;
+    int32_t* fWinding;
+    int32_t* fOrder;    // the active edges' slots, sorted by x
+    int32_t* fMerged;   // scratch for merge()
+    int      fSlots = 0;
+    int      fCount = 0;
+};
+
+// list[] holds count line edges, sorted by y and then x.
+static void walk_line_edges(SkEdge* list[], int count, SkPath::FillType fillType,
+                            SkBlitter* blitter, int start_y, int stop_y,
+                            PrePostProc proc, int rightClip) {
+    ActiveLineEdges active(count);
+    int next = 0;
+    while (next < count && list[next]->fFirstY <= start_y) {
+        active.append(list[next++]);
+    }
+
+    int curr_y = start_y;
+    // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
+    int windingMask = (fillType & 1) ? 1 : -1;
+
+    for (;;) {
+        int     w = 0;
+        int     left SK_INIT_TO_AVOID_WARNING;
+        bool    in_interval = false;
+
+        if (proc) {
+            proc(blitter, curr_y, PREPOST_START);    // pre-proc
+        }
+
+        for (int i = 0; i < active.count(); ++i) {
+            int x = SkFixedRoundToInt(active.x(i));
+            w += active.winding(i);
+            if ((w & windingMask) == 0) { // we finished an interval
+                SkASSERT(in_interval);
+                int width = x - left;
+                SkASSERT(width >= 0);
+                if (width)
+                    blitter->blitH(left, curr_y, width);
+                in_interval = false;
+            } else if (!in_interval) {
+                left = x;
+                in_interval = true;
+            }
+        }
+
+        // was our right-edge culled away?
+        if (in_interval) {
+            int width = rightClip - left;
+            if (width > 0) {
+                blitter->blitH(left, curr_y, width);
+            }
+        }
+
+        if (proc) {
+            proc(blitter, curr_y, PREPOST_END);    // post-proc
+        }
+
+        active.step(curr_y);
+        curr_y += 1;
+        if (curr_y >= stop_y) {
+            break;
+        }
+
+        int first = next;
+        while (next < count && list[next]->fFirstY == curr_y) {
+            next += 1;
+        }
+        active.merge(list + first, next - first);
+    }
+}
+
 // return true if we're NOT done with this edge
 static bool update_edge(SkEdge* edge, int last_y) {
     SkASSERT(edge->fLastY >= last_y);
@@ -391,6 +660,30 @@ static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
     return list[0];
 }
 
+// Sorts like sort_edges(), by y and then x, but with a radix sort, and without linking the
+// edges. Edges with the same y and x keep their order.
+static void radix_sort_edges(SkEdge* list[], int count) {
+    SkAutoTMalloc<uint64_t> keys(2 * count);
+    SkAutoTMalloc<SkEdge*>  scratch(count);
+    for (int i = 0; i < count; ++i) {
+        keys[i] = (uint64_t)sortable_key(list[i]->fFirstY) << 32 | sortable_key(list[i]->fX);
+    }
+    radix_sort(keys.get(), list, keys.get() + count, scratch.get(), count);
+}
+
+static bool all_lines(SkEdge* const list[], int count) {
+    for (int i = 0; i < count; ++i) {
+        if (list[i]->fCurveCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Below this many edges, walk_edges() is as fast as walk_line_edges(), or faster when most of
+// the edges cross each other.
+static constexpr int kMinLineWalkEdges = 2048;
+
 // clipRect has not been shifted up
 void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitter,
                   int start_y, int stop_y, int shiftEdgesUp, bool pathContainedInClip) {
@@ -431,22 +724,30 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
         return;
     }
 
+    // count >= 2 is required as the convex walker does not handle missing right edges
+    const bool walkConvex = path.isConvex() && !path.isInverseFillType() && count >= 2;
+    const bool walkLines = !walkConvex && count >= kMinLineWalkEdges && all_lines(list, count);
+
     SkEdge headEdge, tailEdge, *last;
-    // this returns the first and last edge after they're sorted into a dlink list
-    SkEdge* edge = sort_edges(list, count, &last);
+    if (walkLines) {
+        radix_sort_edges(list, count);
+    } else {
+        // this returns the first and last edge after they're sorted into a dlink list
+        SkEdge* edge = sort_edges(list, count, &last);
 
-    headEdge.fPrev = nullptr;
-    headEdge.fNext = edge;
-    headEdge.fFirstY = kEDGE_HEAD_Y;
-    headEdge.fX = SK_MinS32;
-    edge->fPrev = &headEdge;
+        headEdge.fPrev = nullptr;
+        headEdge.fNext = edge;
+        headEdge.fFirstY = kEDGE_HEAD_Y;
+        headEdge.fX = SK_MinS32;
+        edge->fPrev = &headEdge;
 
-    tailEdge.fPrev = last;
-    tailEdge.fNext = nullptr;
-    tailEdge.fFirstY = kEDGE_TAIL_Y;
-    last->fNext = &tailEdge;
+        tailEdge.fPrev = last;
+        tailEdge.fNext = nullptr;
+        tailEdge.fFirstY = kEDGE_TAIL_Y;
+        last->fNext = &tailEdge;
 
-    // now edge is the head of the sorted linklist
+        // now edge is the head of the sorted linklist
+    }
 
     start_y = SkLeftShift(start_y, shiftEdgesUp);
     stop_y = SkLeftShift(stop_y, shiftEdgesUp);
@@ -466,9 +767,12 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
         proc = PrePostInverseBlitterProc;
     }
 
-    // count >= 2 is required as the convex walker does not handle missing right edges
-    if (path.isConvex() && (nullptr == proc) && count >= 2) {
+    if (walkConvex) {
+        SkASSERT(nullptr == proc);
         walk_convex_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, nullptr);
+    } else if (walkLines) {
+        walk_line_edges(list, count, path.getFillType(), blitter, start_y, stop_y, proc,
+                        shiftedClip.right());
     } else {
         walk_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, proc,
                 shiftedClip.right());
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScratchArena.h"
+
+#include "SkTLS.h"
+
+#include <memory>
+
+// Scratch arenas nested deeper than this start out on the heap.
+static constexpr int kMaxDepth = 4;
+static constexpr size_t kInitialBlockSize = 4096;
+
+struct SkScratchArena::Level {
+    Thread*                 fThread = nullptr;
+    std::unique_ptr<char[]> fBlock;
+    size_t                  fSize = 0;
+    size_t                  fWanted = kInitialBlockSize;
+};
+
+struct SkScratchArena::Thread {
+    Thread() {
+        for (Level& level : fLevels) {
+            level.fThread = this;
+        }
+    }
+
+    Level fLevels[kMaxDepth];
+    int   fDepth = 0;
+    Stats fStats;
+};
+
+SkScratchArena::Thread* SkScratchArena::GetThread() {
+    return static_cast<Thread*>(SkTLS::Get([]() -> void* { return new Thread; },
+                                           [](void* thread) { delete (Thread*)thread; }));
+}
+
+SkScratchArena::Level* SkScratchArena::Acquire() {
+    Thread* thread = GetThread();
+    if (thread->fDepth == kMaxDepth) {
+        return nullptr;
+    }
+    Level* level = &thread->fLevels[thread->fDepth++];
+    if (level->fWanted > level->fSize) {
+        thread->fStats.fBlockBytes += level->fWanted - level->fSize;
+        level->fBlock.reset(new char[level->fWanted]);
+        level->fSize = level->fWanted;
+    }
+    return level;
+}
+
+SkScratchArena::SkScratchArena(Level* level)
+    : INHERITED(level ? level->fBlock.get() : nullptr, level ? level->fSize : 0,
+                kInitialBlockSize)
+    , fLevel(level) {}
+
+SkScratchArena::~SkScratchArena() {
+    if (!fLevel) {
+        return;
+    }
+    Thread* thread = fLevel->fThread;
+    SkASSERT(fLevel == &thread->fLevels[thread->fDepth - 1]);
+    const size_t needed = fLevel->fSize + this->heapBytes();
+    if (this->heapBytes()) {
+        thread->fStats.fSpills++;
+        // The block is still in use until the arena's destructor runs, so it's grown by the
+        // next Acquire().
+        fLevel->fWanted = SkTMin(needed, kMaxBlockSize);
+    }
+    thread->fStats.fHighWater = SkTMax(thread->fStats.fHighWater, needed);
+    thread->fDepth--;
+}
+
+SkScratchArena::Stats SkScratchArena::GetThreadStats() {
+    return GetThread()->fStats;
+}
+
+void SkScratchArena::PurgeThreadBlocks() {
+    Thread* thread = GetThread();
+    SkASSERT(thread->fDepth == 0);
+    for (Level& level : thread->fLevels) {
+        level.fBlock.reset();
+        level.fSize = 0;
+        level.fWanted = kInitialBlockSize;
+    }
+    thread->fStats.fBlockBytes = 0;
+}
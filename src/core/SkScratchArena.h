@@ -0,0 +1,53 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkScratchArena_DEFINED
+#define SkScratchArena_DEFINED
+
+#include "SkArenaAlloc.h"
+
+/**
+ *  An SkArenaAlloc for scratch that lives no longer than one draw, e.g. blitters and their
+ *  contexts, or edge lists, which starts out in a block the thread keeps from draw to draw.
+ *
+ *  Each thread keeps a block for each of the first few scratch arenas alive on it at once, as
+ *  they nest (e.g. a path's edges are built while its blitter is alive). When a draw needs
+ *  more than its block, the block is grown to fit next time, up to kMaxBlockSize, so steady
+ *  state drawing doesn't touch the heap. Scratch arenas must be destroyed on the thread that
+ *  made them, in the reverse order, which is what keeping them on the stack does.
+ */
+class SkScratchArena : public SkArenaAlloc {
+public:
+    static constexpr size_t kMaxBlockSize = 64 * 1024;
+
+    SkScratchArena() : SkScratchArena(Acquire()) {}
+    ~SkScratchArena();
+
+    struct Stats {
+        size_t fBlockBytes = 0;  // The size of the blocks this thread keeps.
+        size_t fHighWater = 0;   // The most one scratch arena has had, block and heap.
+        int    fSpills = 0;      // How often a scratch arena outgrew its block.
+    };
+    static Stats GetThreadStats();
+
+    // Frees this thread's blocks. They must not be in use.
+    static void PurgeThreadBlocks();
+
+private:
+    struct Level;
+    struct Thread;
+
+    explicit SkScratchArena(Level*);
+    static Thread* GetThread();
+    static Level* Acquire();
+
+    Level* const fLevel;
+
+    using INHERITED = SkArenaAlloc;
+};
+
+#endif
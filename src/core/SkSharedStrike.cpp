@@ -0,0 +1,198 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSharedStrike.h"
+
+#include "SkAtomics.h"
+#include "SkPath.h"
+
+static constexpr int kMinGlyphTableCapacity = 64;
+static constexpr uint64_t kUnicharValid = 1 << 16;
+
+SkSharedStrike::SkSharedStrike(
+    const SkDescriptor& desc,
+    std::unique_ptr<SkScalerContext> scaler,
+    const SkPaint::FontMetrics& fontMetrics)
+    : fDesc{desc}
+    , fScalerContext{std::move(scaler)}
+    , fFontMetrics(fontMetrics)
+{
+    SkASSERT(fScalerContext != nullptr);
+    for (auto& rec : fUnicharToGlyph) {
+        rec.store(0, std::memory_order_relaxed);
+    }
+
+    auto table = fAlloc.make<GlyphTable>();
+    table->fCapacity = kMinGlyphTableCapacity;
+    table->fSlots    = fAlloc.makeArray<std::atomic<SkGlyph*>>(kMinGlyphTableCapacity);
+    fTable.store(table, std::memory_order_relaxed);
+
+    fMemoryUsed.store(sizeof(*this) + kMinGlyphTableCapacity * sizeof(std::atomic<SkGlyph*>),
+                      std::memory_order_relaxed);
+}
+
+SkSharedStrike::~SkSharedStrike() {
+    const GlyphTable* table = fTable.load(std::memory_order_relaxed);
+    for (int i = 0; i < table->fCapacity; ++i) {
+        SkGlyph* glyph = table->fSlots[i].load(std::memory_order_relaxed);
+        if (glyph && glyph->fPathData) {
+            delete glyph->fPathData->fPath;
+        }
+    }
+}
+
+SkGlyph* SkSharedStrike::findGlyph(SkPackedGlyphID packedGlyphID) const {
+    const GlyphTable* table = fTable.load(std::memory_order_acquire);
+    const int mask = table->fCapacity - 1;
+    // The table always has empty slots, so this terminates.
+    for (int i = packedGlyphID.hash() & mask; ; i = (i + 1) & mask) {
+        SkGlyph* glyph = table->fSlots[i].load(std::memory_order_acquire);
+        if (glyph == nullptr || glyph->getPackedID() == packedGlyphID) {
+            return glyph;
+        }
+    }
+}
+
+void SkSharedStrike::internalGrowTable() {
+    const GlyphTable* oldTable = fTable.load(std::memory_order_relaxed);
+
+    auto table = fAlloc.make<GlyphTable>();
+    table->fCapacity = oldTable->fCapacity * 2;
+    table->fSlots    = fAlloc.makeArray<std::atomic<SkGlyph*>>(table->fCapacity);
+
+    const int mask = table->fCapacity - 1;
+    for (int j = 0; j < oldTable->fCapacity; ++j) {
+        SkGlyph* glyph = oldTable->fSlots[j].load(std::memory_order_relaxed);
+        if (glyph == nullptr) {
+            continue;
+        }
+        int i = glyph->getPackedID().hash() & mask;
+        while (table->fSlots[i].load(std::memory_order_relaxed) != nullptr) {
+            i = (i + 1) & mask;
+        }
+        table->fSlots[i].store(glyph, std::memory_order_relaxed);
+    }
+
+    // Readers who load the new table see all its slots filled in.
+    fTable.store(table, std::memory_order_release);
+    // The old table stays in fAlloc for readers still probing it, but nothing new goes in it, so
+    // only the live table counts against the budget.
+    fMemoryUsed += (table->fCapacity - oldTable->fCapacity) * sizeof(std::atomic<SkGlyph*>);
+}
+
+SkGlyph* SkSharedStrike::internalInsertGlyph(SkPackedGlyphID packedGlyphID) {
+    const int count = fGlyphCount.load(std::memory_order_relaxed);
+    if (2 * (count + 1) > fTable.load(std::memory_order_relaxed)->fCapacity) {
+        this->internalGrowTable();
+    }
+
+    SkGlyph* glyph = fAlloc.make<SkGlyph>();
+    glyph->initWithGlyphID(packedGlyphID);
+    fScalerContext->getMetrics(glyph);
+    SkASSERT(glyph->fID != SkPackedGlyphID());
+
+    const GlyphTable* table = fTable.load(std::memory_order_relaxed);
+    const int mask = table->fCapacity - 1;
+    int i = packedGlyphID.hash() & mask;
+    while (table->fSlots[i].load(std::memory_order_relaxed) != nullptr) {
+        i = (i + 1) & mask;
+    }
+    // Publish the glyph only once its metrics are complete.
+    table->fSlots[i].store(glyph, std::memory_order_release);
+
+    fGlyphCount.store(count + 1, std::memory_order_relaxed);
+    fMemoryUsed += sizeof(SkGlyph);
+    return glyph;
+}
+
+SkGlyphID SkSharedStrike::unicharToGlyph(SkUnichar charCode) {
+    SkPackedUnicharID packedUnicharID(charCode);
+    std::atomic<uint64_t>& rec = fUnicharToGlyph[packedUnicharID.hash() & (kUnicharCount - 1)];
+
+    // Each entry holds the unichar in its top 32 bits, a valid bit, and the glyph in the bottom
+    // 16 bits, so one relaxed load tells us everything.
+    const uint64_t key = ((uint64_t)(uint32_t)charCode << 32) | kUnicharValid;
+    uint64_t entry = rec.load(std::memory_order_relaxed);
+    if ((entry & ~(uint64_t)0xFFFF) == key) {
+        return (SkGlyphID)(entry & 0xFFFF);
+    }
+
+    SkGlyphID glyphID;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        glyphID = fScalerContext->charToGlyphID(charCode);
+    }
+    rec.store(key | glyphID, std::memory_order_relaxed);
+    return glyphID;
+}
+
+const SkGlyph& SkSharedStrike::getGlyphIDMetrics(SkGlyphID glyphID) {
+    return this->getGlyphIDMetrics(glyphID, 0, 0);
+}
+
+const SkGlyph& SkSharedStrike::getGlyphIDMetrics(SkGlyphID glyphID, SkFixed x, SkFixed y) {
+    SkPackedGlyphID packedGlyphID(glyphID, x, y);
+    if (SkGlyph* glyph = this->findGlyph(packedGlyphID)) {
+        return *glyph;
+    }
+
+    SkAutoMutexAcquire lock(fMutex);
+    // Someone may have added it while we were waiting for the lock.
+    SkGlyph* glyph = this->findGlyph(packedGlyphID);
+    if (glyph == nullptr) {
+        glyph = this->internalInsertGlyph(packedGlyphID);
+    }
+    return *glyph;
+}
+
+const SkGlyph& SkSharedStrike::getUnicharMetrics(SkUnichar charCode) {
+    return this->getGlyphIDMetrics(this->unicharToGlyph(charCode));
+}
+
+const void* SkSharedStrike::findImage(const SkGlyph& glyph) {
+    const void* image = sk_atomic_load(&glyph.fImage, sk_memory_order_acquire);
+    if (image != nullptr || glyph.fWidth == 0 || glyph.fWidth >= kMaxGlyphWidth) {
+        return image;
+    }
+
+    SkAutoMutexAcquire lock(fMutex);
+    if (glyph.fImage == nullptr) {
+        // Render into a copy so that nobody sees fImage until the image is complete.
+        SkGlyph tmpGlyph = glyph;
+        size_t size = tmpGlyph.allocImage(&fAlloc);
+        if (tmpGlyph.fImage) {
+            fScalerContext->getImage(tmpGlyph);
+            fMemoryUsed += size;
+            sk_atomic_store(&const_cast<SkGlyph&>(glyph).fImage, tmpGlyph.fImage,
+                            sk_memory_order_release);
+        }
+    }
+    return glyph.fImage;
+}
+
+const SkPath* SkSharedStrike::findPath(const SkGlyph& glyph) {
+    const SkGlyph::PathData* pathData = sk_atomic_load(&glyph.fPathData, sk_memory_order_acquire);
+    if (pathData == nullptr && glyph.fWidth) {
+        SkAutoMutexAcquire lock(fMutex);
+        pathData = glyph.fPathData;
+        if (pathData == nullptr) {
+            SkGlyph::PathData* newPathData = fAlloc.make<SkGlyph::PathData>();
+            newPathData->fIntercept = nullptr;
+            std::unique_ptr<SkPath> path(new SkPath);
+            if (fScalerContext->getPath(glyph.getPackedID(), path.get())) {
+                fMemoryUsed += sizeof(SkPath) + path->countPoints() * sizeof(SkPoint);
+                newPathData->fPath = path.release();
+            } else {
+                newPathData->fPath = nullptr;
+            }
+            sk_atomic_store(&const_cast<SkGlyph&>(glyph).fPathData, newPathData,
+                            sk_memory_order_release);
+            pathData = newPathData;
+        }
+    }
+    return pathData ? pathData->fPath : nullptr;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSharedStrike_DEFINED
+#define SkSharedStrike_DEFINED
+
+#include "SkArenaAlloc.h"
+#include "SkDescriptor.h"
+#include "SkGlyph.h"
+#include "SkMutex.h"
+#include "SkPaint.h"
+#include "SkRefCnt.h"
+#include "SkScalerContext.h"
+
+#include <atomic>
+#include <memory>
+
+/** \class SkSharedStrike
+
+    A strike that many threads can use at the same time, handed out by
+    SkStrikeCache::FindOrCreateStrikeShared().  Unlike SkGlyphCache, which a thread checks out of
+    the strike cache while it uses it, a shared strike stays in the cache, so threads drawing the
+    same font at the same size share one set of glyphs instead of each building their own.
+    SkDraw uses them to redraw text blob runs whose glyphs SkTextBlobRasterCache already placed.
+
+    Looking up a glyph (or its image or path) that is already in the strike takes no lock.  Only
+    generating something new from the scaler context is serialized.
+
+    Glyphs always have full metrics, and never move once created.  Their fImage and fPathData are
+    published after the glyph itself, so always go through findImage() and findPath() rather
+    than reading those fields directly.
+*/
+class SkSharedStrike : public SkNVRefCnt<SkSharedStrike> {
+public:
+    SkSharedStrike(const SkDescriptor& desc,
+                   std::unique_ptr<SkScalerContext> scaler,
+                   const SkPaint::FontMetrics&);
+    ~SkSharedStrike();
+
+    const SkDescriptor& getDescriptor() const { return *fDesc.getDesc(); }
+
+    SkGlyphID unicharToGlyph(SkUnichar);
+
+    const SkGlyph& getGlyphIDMetrics(SkGlyphID);
+    const SkGlyph& getGlyphIDMetrics(SkGlyphID, SkFixed x, SkFixed y);
+    const SkGlyph& getUnicharMetrics(SkUnichar);
+
+    /** Return the image associated with the glyph, generating it if needed. */
+    const void* findImage(const SkGlyph&);
+
+    /** Return the path associated with the glyph, generating it if needed. */
+    const SkPath* findPath(const SkGlyph&);
+
+    const SkPaint::FontMetrics& getFontMetrics() const { return fFontMetrics; }
+    SkMask::Format getMaskFormat() const { return fScalerContext->getMaskFormat(); }
+    bool isSubpixel() const { return fScalerContext->isSubpixel(); }
+
+    /** Return the number of glyphs currently cached. */
+    int countCachedGlyphs() const { return fGlyphCount.load(std::memory_order_relaxed); }
+
+    /** Return the approx RAM usage for this strike. */
+    size_t getMemoryUsed() const { return fMemoryUsed.load(std::memory_order_relaxed); }
+
+private:
+    // An open addressed hash table of glyphs that readers probe without locking.  It's never
+    // more than half full; when it would be, we publish a copy twice the size, and keep the old
+    // one around (in fAlloc) for any reader still looking at it.
+    struct GlyphTable {
+        int                    fCapacity;   // a power of 2
+        std::atomic<SkGlyph*>* fSlots;
+    };
+
+    SkGlyph* findGlyph(SkPackedGlyphID) const;
+
+    // The following methods can only be called when fMutex is already held.
+    SkGlyph* internalInsertGlyph(SkPackedGlyphID);
+    void internalGrowTable();
+
+    // The unichar to glyph mapping is a small direct mapped cache of (unichar, glyph) pairs.
+    static constexpr int kUnicharCount = 256;
+
+    const SkAutoDescriptor                 fDesc;
+    const std::unique_ptr<SkScalerContext> fScalerContext;   // guarded by fMutex
+    const SkPaint::FontMetrics             fFontMetrics;
+
+    std::atomic<GlyphTable*> fTable;
+    std::atomic<uint64_t>    fUnicharToGlyph[kUnicharCount];
+    std::atomic<int>         fGlyphCount{0};
+    std::atomic<size_t>      fMemoryUsed;
+
+    // Guards fScalerContext, fAlloc, and all writes to the glyphs and tables.
+    SkMutex                  fMutex;
+    SkArenaAlloc             fAlloc{4096};
+};
+
+#endif  // SkSharedStrike_DEFINED
@@ -48,6 +48,20 @@ SkScalar SkStream::readScalar() {
 #define SK_BYTE_SENTINEL_FOR_U16    0xFE
 #define SK_BYTE_SENTINEL_FOR_U32    0xFF
 
+const void* SkStream::getMemoryChunk(size_t* size) {
+    if (!this->hasLength() || !this->hasPosition()) {
+        return nullptr;
+    }
+    const void* base = this->getMemoryBase();
+    const size_t position = this->getPosition(),
+                 length   = this->getLength();
+    if (!base || position >= length) {
+        return nullptr;
+    }
+    *size = length - position;
+    return SkTAddOffset<const void>(base, position);
+}
+
 size_t SkStream::readPackedUInt() {
     uint8_t byte;
     if (!this->read(&byte, 1)) {
@@ -789,6 +803,19 @@ public:
         return nullptr;
     }
 
+    const void* getMemoryChunk(size_t* size) override {
+        if (fOffset == fSize) {
+            return nullptr;
+        }
+        // There are bytes left, so if this block is used up, a later one has them.
+        while (fCurrentOffset == fCurrent->written()) {
+            fCurrent = fCurrent->fNext;
+            fCurrentOffset = 0;
+        }
+        *size = SkTMin(fCurrent->written() - fCurrentOffset, fSize - fOffset);
+        return fCurrent->start() + fCurrentOffset;
+    }
+
 private:
     sk_sp<SkBlockMemoryRefCnt> const fBlockMemory;
     SkDynamicMemoryWStream::Block const * fCurrent;
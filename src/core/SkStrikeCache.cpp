@@ -7,13 +7,17 @@
 
 #include "SkStrikeCache.h"
 
+#include <atomic>
 #include <cctype>
+#include <vector>
 
 #include "SkDeduper.h"
 #include "SkGlyphCache.h"
+#include "SkGlyphStore.h"
 #include "SkGraphics.h"
 #include "SkMutex.h"
 #include "SkOnce.h"
+#include "SkSharedStrike.h"
 #include "SkTraceMemoryDump.h"
 #include "SkTypeface.h"
 #include "SkTypefaceCache.h"
@@ -24,24 +28,60 @@ static SkStrikeCache& get_globals() {
     static SkOnce once;
     static SkStrikeCache* globals;
 
-    once([]{ globals = new SkStrikeCache; });
+    once([]{ globals = new SkStrikeCache{SK_DEFAULT_FONT_CACHE_SHARD_COUNT}; });
     return *globals;
 }
 
 struct SkStrikeCache::Node {
-    Node(const SkDescriptor& desc,
+    Node(SkStrikeCache* strikeCache,
+        const SkDescriptor& desc,
         std::unique_ptr<SkScalerContext> scaler,
         const SkPaint::FontMetrics& metrics,
         std::unique_ptr<SkStrikePinner> pinner)
-        : fCache{desc, std::move(scaler), metrics}
+        : fStrikeCache{strikeCache}
+        , fCache{desc, std::move(scaler), metrics}
         , fPinner{std::move(pinner)} {}
 
+    SkStrikeCache* const            fStrikeCache;
     Node*                           fNext{nullptr};
     Node*                           fPrev{nullptr};
     SkGlyphCache                    fCache;
     std::unique_ptr<SkStrikePinner> fPinner;
 };
 
+// One independently locked LRU list of strikes, with its own share of the budgets.
+struct SkStrikeCache::Shard {
+    // The following methods can only be called when fLock is already held.
+    size_t internalMemoryUsed() const;
+    int internalCacheCount() const;
+    void internalDetachCache(Node*);
+    void internalAttachToHead(Node*);
+
+    // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
+    // and attempt to purge caches to match.
+    // Returns number of bytes freed.
+    size_t internalPurge(size_t minBytesNeeded = 0);
+
+#ifdef SK_DEBUG
+    void validate() const;
+#else
+    void validate() const {}
+#endif
+
+    mutable SkSpinlock fLock;
+    Node*              fHead{nullptr};
+    Node*              fTail{nullptr};
+    size_t             fTotalMemoryUsed{0};
+    size_t             fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
+    int32_t            fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
+    int32_t            fCacheCount{0};
+
+    // Shared strikes never leave the cache while in use, so they don't fit in the lists above.
+    // Their memory use changes under our feet, so it's totalled up when it's needed.  This is
+    // kept in LRU order, with the least recently used strike first.
+    std::vector<sk_sp<SkSharedStrike>> fSharedStrikes;
+};
+
 SkStrikeCache::ExclusiveStrikePtr::ExclusiveStrikePtr(SkStrikeCache::Node* node) : fNode{node} {}
 SkStrikeCache::ExclusiveStrikePtr::ExclusiveStrikePtr() : fNode{nullptr} {}
 SkStrikeCache::ExclusiveStrikePtr::ExclusiveStrikePtr(ExclusiveStrikePtr&& o)
@@ -51,14 +91,18 @@ SkStrikeCache::ExclusiveStrikePtr::ExclusiveStrikePtr(ExclusiveStrikePtr&& o)
 
 SkStrikeCache::ExclusiveStrikePtr&
 SkStrikeCache::ExclusiveStrikePtr::operator = (ExclusiveStrikePtr&& o) {
-    Attach(fNode);
+    if (fNode != nullptr) {
+        fNode->fStrikeCache->attachNode(fNode);
+    }
     fNode = o.fNode;
     o.fNode = nullptr;
     return *this;
 }
 
 SkStrikeCache::ExclusiveStrikePtr::~ExclusiveStrikePtr() {
-    SkStrikeCache::Attach(fNode);
+    if (fNode != nullptr) {
+        fNode->fStrikeCache->attachNode(fNode);
+    }
 }
 SkGlyphCache* SkStrikeCache::ExclusiveStrikePtr::get() const {
     return &fNode->fCache;
@@ -84,23 +128,42 @@ bool operator == (decltype(nullptr), const SkStrikeCache::ExclusiveStrikePtr& rh
     return nullptr == rhs.fNode;
 }
 
+SkStrikeCache::SkStrikeCache(int shardCount)
+    : fShardCount{SkTMax(shardCount, 1)}
+    , fShards{new Shard[fShardCount]} {
+    SkAutoExclusive ac(fLimitsLock);
+    this->internalDistributeLimits();
+}
+
 SkStrikeCache::~SkStrikeCache() {
-    Node* node = fHead;
-    while (node) {
-        Node* next = node->fNext;
-        delete node;
-        node = next;
+    for (int i = 0; i < fShardCount; ++i) {
+        Node* node = fShards[i].fHead;
+        while (node) {
+            Node* next = node->fNext;
+            delete node;
+            node = next;
+        }
     }
 }
 
-void SkStrikeCache::Attach(Node* node) {
-    get_globals().attachNode(node);
+SkStrikeCache::Shard* SkStrikeCache::shardFor(const SkDescriptor& desc) const {
+    return &fShards[desc.getChecksum() % fShardCount];
 }
 
 SkExclusiveStrikePtr SkStrikeCache::FindStrikeExclusive(const SkDescriptor& desc) {
     return get_globals().findStrikeExclusive(desc);
 }
 
+SkExclusiveStrikePtr SkStrikeCache::CreateStrikeExclusive(
+        const SkDescriptor& desc,
+        std::unique_ptr<SkScalerContext> scaler,
+        SkPaint::FontMetrics* maybeMetrics,
+        std::unique_ptr<SkStrikePinner> pinner)
+{
+    return get_globals().createStrikeExclusive(
+            desc, std::move(scaler), maybeMetrics, std::move(pinner));
+}
+
 std::unique_ptr<SkScalerContext> SkStrikeCache::CreateScalerContext(
         const SkDescriptor& desc,
         const SkScalerContextEffects& effects,
@@ -151,10 +214,62 @@ SkExclusiveStrikePtr SkStrikeCache::FindOrCreateStrikeExclusive(const SkPaint& p
             paint, nullptr, kFakeGammaAndBoostContrast, nullptr);
 }
 
+sk_sp<SkSharedStrike> SkStrikeCache::FindOrCreateStrikeShared(
+        const SkDescriptor& desc, const SkScalerContextEffects& effects, const SkTypeface& typeface)
+{
+    return get_globals().findOrCreateStrikeShared(desc, effects, typeface);
+}
+
+sk_sp<SkSharedStrike> SkStrikeCache::FindOrCreateStrikeShared(
+        const SkPaint& paint,
+        const SkSurfaceProps* surfaceProps,
+        SkScalerContextFlags scalerContextFlags,
+        const SkMatrix* deviceMatrix)
+{
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            paint, surfaceProps, scalerContextFlags, deviceMatrix, &ad, &effects);
+
+    auto tf = SkPaintPriv::GetTypefaceOrDefault(paint);
+
+    return FindOrCreateStrikeShared(*desc, effects, *tf);
+}
+
 void SkStrikeCache::PurgeAll() {
     get_globals().purgeAll();
 }
 
+static std::atomic<SkExecutor*> gGlyphRasterExecutor{nullptr};
+
+void SkStrikeCache::SetGlyphRasterExecutor(SkExecutor* executor) {
+    gGlyphRasterExecutor.store(executor, std::memory_order_relaxed);
+}
+
+SkExecutor* SkStrikeCache::GetGlyphRasterExecutor() {
+    return gGlyphRasterExecutor.load(std::memory_order_relaxed);
+}
+
+static std::atomic<SkGlyphStore*> gGlyphStore{nullptr};
+
+void SkStrikeCache::SetPersistentGlyphFile(const char path[]) {
+    SkGlyphStore* store = new SkGlyphStore{path};
+    SkGlyphStore* expected = nullptr;
+    if (!gGlyphStore.compare_exchange_strong(expected, store)) {
+        delete store;
+    }
+}
+
+bool SkStrikeCache::WritePersistentGlyphFile() {
+    SkGlyphStore* store = gGlyphStore.load();
+    if (store == nullptr) {
+        return false;
+    }
+    get_globals().forEachStrike([store](const SkGlyphCache& cache) { store->add(cache); });
+    return store->write();
+}
+
 void SkStrikeCache::Dump() {
     SkDebugf("GlyphCache [     used    budget ]\n");
     SkDebugf("    bytes  [ %8zu  %8zu ]\n",
@@ -224,22 +339,26 @@ void SkStrikeCache::attachNode(Node* node) {
     if (node == nullptr) {
         return;
     }
-    SkAutoExclusive ac(fLock);
+    SkASSERT(node->fStrikeCache == this);
+    node->fCache.flushCounters();
+    Shard* shard = this->shardFor(node->fCache.getDescriptor());
+    SkAutoExclusive ac(shard->fLock);
 
-    this->validate();
+    shard->validate();
     node->fCache.validate();
 
-    this->internalAttachToHead(node);
-    this->internalPurge();
+    shard->internalAttachToHead(node);
+    shard->internalPurge();
 }
 
 SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc) {
     Node*           node;
-    SkAutoExclusive ac(fLock);
+    Shard*          shard = this->shardFor(desc);
+    SkAutoExclusive ac(shard->fLock);
 
-    for (node = internalGetHead(); node != nullptr; node = node->fNext) {
+    for (node = shard->fHead; node != nullptr; node = node->fNext) {
         if (node->fCache.getDescriptor() == desc) {
-            this->internalDetachCache(node);
+            shard->internalDetachCache(node);
             return SkExclusiveStrikePtr(node);
         }
     }
@@ -247,7 +366,7 @@ SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc
     return SkExclusiveStrikePtr(nullptr);
 }
 
-SkExclusiveStrikePtr SkStrikeCache::CreateStrikeExclusive(
+SkExclusiveStrikePtr SkStrikeCache::createStrikeExclusive(
         const SkDescriptor& desc,
         std::unique_ptr<SkScalerContext> scaler,
         SkPaint::FontMetrics* maybeMetrics,
@@ -260,26 +379,84 @@ SkExclusiveStrikePtr SkStrikeCache::CreateStrikeExclusive(
         scaler->getFontMetrics(&fontMetrics);
     }
 
-    return SkExclusiveStrikePtr(new Node(desc, std::move(scaler), fontMetrics, std::move(pinner)));
+    Node* node = new Node(this, desc, std::move(scaler), fontMetrics, std::move(pinner));
+    if (SkGlyphStore* store = gGlyphStore.load()) {
+        node->fCache.setStoredStrike(
+                store->findStrike(desc, *node->fCache.getScalerContext()->getTypeface()));
+    }
+    return SkExclusiveStrikePtr(node);
+}
+
+sk_sp<SkSharedStrike> SkStrikeCache::findOrCreateStrikeShared(
+        const SkDescriptor& desc, const SkScalerContextEffects& effects, const SkTypeface& typeface)
+{
+    Shard* shard = this->shardFor(desc);
+
+    auto find = [shard, &desc]() -> sk_sp<SkSharedStrike> {
+        auto& strikes = shard->fSharedStrikes;
+        for (auto it = strikes.rbegin(); it != strikes.rend(); ++it) {
+            if ((*it)->getDescriptor() == desc) {
+                sk_sp<SkSharedStrike> strike = *it;
+                // Move it to the most recently used end.
+                strikes.erase(std::next(it).base());
+                strikes.push_back(strike);
+                return strike;
+            }
+        }
+        return nullptr;
+    };
+
+    {
+        SkAutoExclusive ac(shard->fLock);
+        if (auto strike = find()) {
+            return strike;
+        }
+    }
+
+    // Making the scaler context can be slow, so don't hold the lock while we do it.
+    auto scaler = CreateScalerContext(desc, effects, typeface);
+    SkPaint::FontMetrics fontMetrics;
+    scaler->getFontMetrics(&fontMetrics);
+    auto newStrike = sk_make_sp<SkSharedStrike>(desc, std::move(scaler), fontMetrics);
+
+    SkAutoExclusive ac(shard->fLock);
+    // If another thread beat us to it, use their strike so there's only ever one.
+    if (auto strike = find()) {
+        return strike;
+    }
+    shard->fSharedStrikes.push_back(newStrike);
+    shard->internalPurge();
+    return newStrike;
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoExclusive ac(fLock);
-    this->internalPurge(fTotalMemoryUsed);
+    for (int i = 0; i < fShardCount; ++i) {
+        Shard* shard = &fShards[i];
+        SkAutoExclusive ac(shard->fLock);
+        shard->internalPurge(shard->internalMemoryUsed());
+    }
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoExclusive ac(fLock);
-    return fTotalMemoryUsed;
+    size_t total = 0;
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoExclusive ac(fShards[i].fLock);
+        total += fShards[i].internalMemoryUsed();
+    }
+    return total;
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoExclusive ac(fLock);
-    return fCacheCount;
+    int total = 0;
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoExclusive ac(fShards[i].fLock);
+        total += fShards[i].internalCacheCount();
+    }
+    return total;
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoExclusive ac(fLock);
+    SkAutoExclusive ac(fLimitsLock);
     return fCacheCountLimit;
 }
 
@@ -289,16 +466,16 @@ size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
         newLimit = minLimit;
     }
 
-    SkAutoExclusive ac(fLock);
+    SkAutoExclusive ac(fLimitsLock);
 
     size_t prevLimit = fCacheSizeLimit;
     fCacheSizeLimit = newLimit;
-    this->internalPurge();
+    this->internalDistributeLimits();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoExclusive ac(fLock);
+    SkAutoExclusive ac(fLimitsLock);
     return fCacheSizeLimit;
 }
 
@@ -307,16 +484,16 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoExclusive ac(fLock);
+    SkAutoExclusive ac(fLimitsLock);
 
     int prevCount = fCacheCountLimit;
     fCacheCountLimit = newCount;
-    this->internalPurge();
+    this->internalDistributeLimits();
     return prevCount;
 }
 
 int SkStrikeCache::getCachePointSizeLimit() const {
-    SkAutoExclusive ac(fLock);
+    SkAutoExclusive ac(fLimitsLock);
     return fPointSizeLimit;
 }
 
@@ -325,41 +502,72 @@ int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
         newLimit = 0;
     }
 
-    SkAutoExclusive ac(fLock);
+    SkAutoExclusive ac(fLimitsLock);
 
     int prevLimit = fPointSizeLimit;
     fPointSizeLimit = newLimit;
     return prevLimit;
 }
 
+void SkStrikeCache::internalDistributeLimits() {
+    // Split the budgets so that the shards' limits add up exactly to the global ones.
+    for (int i = 0; i < fShardCount; ++i) {
+        Shard* shard = &fShards[i];
+        SkAutoExclusive ac(shard->fLock);
+        shard->fCacheSizeLimit  = fCacheSizeLimit  / fShardCount
+                                + (i < (int)(fCacheSizeLimit  % fShardCount));
+        shard->fCacheCountLimit = fCacheCountLimit / fShardCount
+                                + (i < fCacheCountLimit % fShardCount);
+        shard->internalPurge();
+    }
+}
+
 void SkStrikeCache::forEachStrike(std::function<void(const SkGlyphCache&)> visitor) const {
-    SkAutoExclusive ac(fLock);
+    for (int i = 0; i < fShardCount; ++i) {
+        const Shard& shard = fShards[i];
+        SkAutoExclusive ac(shard.fLock);
 
-    this->validate();
+        shard.validate();
 
-    for (Node* node = this->internalGetHead(); node != nullptr; node = node->fNext) {
-        visitor(node->fCache);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            visitor(node->fCache);
+        }
+    }
+}
+
+size_t SkStrikeCache::Shard::internalMemoryUsed() const {
+    size_t total = fTotalMemoryUsed;
+    for (const auto& strike : fSharedStrikes) {
+        total += strike->getMemoryUsed();
     }
+    return total;
+}
+
+int SkStrikeCache::Shard::internalCacheCount() const {
+    return fCacheCount + SkToInt(fSharedStrikes.size());
 }
 
-size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
+size_t SkStrikeCache::Shard::internalPurge(size_t minBytesNeeded) {
     this->validate();
 
+    const size_t totalMemoryUsed = this->internalMemoryUsed();
+    const int    cacheCount      = this->internalCacheCount();
+
     size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+    if (totalMemoryUsed > fCacheSizeLimit) {
+        bytesNeeded = totalMemoryUsed - fCacheSizeLimit;
     }
     bytesNeeded = SkTMax(bytesNeeded, minBytesNeeded);
     if (bytesNeeded) {
         // no small purges!
-        bytesNeeded = SkTMax(bytesNeeded, fTotalMemoryUsed >> 2);
+        bytesNeeded = SkTMax(bytesNeeded, totalMemoryUsed >> 2);
     }
 
     int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
+    if (cacheCount > fCacheCountLimit) {
+        countNeeded = cacheCount - fCacheCountLimit;
         // no small purges!
-        countNeeded = SkMax32(countNeeded, fCacheCount >> 2);
+        countNeeded = SkMax32(countNeeded, cacheCount >> 2);
     }
 
     // early exit
@@ -372,7 +580,7 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
 
     // Start at the tail and proceed backwards deleting; the list is in LRU
     // order, with unimportant entries at the tail.
-    Node* node = this->internalGetTail();
+    Node* node = fTail;
     while (node != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
         Node* prev = node->fPrev;
 
@@ -381,11 +589,25 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
             bytesFreed += node->fCache.getMemoryUsed();
             countFreed += 1;
             this->internalDetachCache(node);
+            if (SkGlyphStore* store = gGlyphStore.load()) {
+                store->add(node->fCache);
+            }
             delete node;
         }
         node = prev;
     }
 
+    // Then drop shared strikes, least recently used first.  Threads still using one keep it
+    // alive until they're done with it, but it's no longer ours to account for.
+    size_t sharedDropped = 0;
+    while (sharedDropped < fSharedStrikes.size() &&
+           (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
+        bytesFreed += fSharedStrikes[sharedDropped]->getMemoryUsed();
+        countFreed += 1;
+        sharedDropped += 1;
+    }
+    fSharedStrikes.erase(fSharedStrikes.begin(), fSharedStrikes.begin() + sharedDropped);
+
     this->validate();
 
 #ifdef SPEW_PURGE_STATUS
@@ -398,7 +620,7 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     return bytesFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(Node* node) {
+void SkStrikeCache::Shard::internalAttachToHead(Node* node) {
     SkASSERT(nullptr == node->fPrev && nullptr == node->fNext);
     if (fHead) {
         fHead->fPrev = node;
@@ -414,7 +636,7 @@ void SkStrikeCache::internalAttachToHead(Node* node) {
     fTotalMemoryUsed += node->fCache.getMemoryUsed();
 }
 
-void SkStrikeCache::internalDetachCache(Node* node) {
+void SkStrikeCache::Shard::internalDetachCache(Node* node) {
     SkASSERT(fCacheCount > 0);
     fCacheCount -= 1;
     fTotalMemoryUsed -= node->fCache.getMemoryUsed();
@@ -433,7 +655,7 @@ void SkStrikeCache::internalDetachCache(Node* node) {
 }
 
 #ifdef SK_DEBUG
-void SkStrikeCache::validate() const {
+void SkStrikeCache::Shard::validate() const {
     size_t computedBytes = 0;
     int computedCount = 0;
 
@@ -451,6 +673,16 @@ void SkStrikeCache::validate() const {
 }
 #endif
 
+
+#ifdef SK_DEBUG
+void SkStrikeCache::validate() const {
+    for (int i = 0; i < fShardCount; ++i) {
+        SkAutoExclusive ac(fShards[i].fLock);
+        fShards[i].validate();
+    }
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 size_t SkGraphics::GetFontCacheLimit() {
@@ -8,14 +8,18 @@
 #ifndef SkStrikeCache_DEFINED
 #define SkStrikeCache_DEFINED
 
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "SkDescriptor.h"
+#include "SkRefCnt.h"
 #include "SkSpinlock.h"
 #include "SkTemplates.h"
 
+class SkExecutor;
 class SkGlyphCache;
+class SkSharedStrike;
 class SkTraceMemoryDump;
 
 #ifndef SK_DEFAULT_FONT_CACHE_COUNT_LIMIT
@@ -30,6 +34,14 @@ class SkTraceMemoryDump;
     #define SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT  256
 #endif
 
+// The global strike cache is split into this many independently locked shards, chosen by
+// descriptor hash.  Each shard keeps its own LRU list and gets an equal share of the byte and
+// count budgets, so the SkGraphics limits hold for the cache as a whole.  Clients rendering
+// text on many threads at once can raise this to cut down on lock contention.
+#ifndef SK_DEFAULT_FONT_CACHE_SHARD_COUNT
+    #define SK_DEFAULT_FONT_CACHE_SHARD_COUNT   1
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class SkStrikePinner {
@@ -40,9 +52,10 @@ public:
 
 class SkStrikeCache {
     struct Node;
+    struct Shard;
 
 public:
-    SkStrikeCache() = default;
+    explicit SkStrikeCache(int shardCount = 1);
     ~SkStrikeCache();
 
     class ExclusiveStrikePtr {
@@ -88,11 +101,37 @@ public:
 
     static ExclusiveStrikePtr FindOrCreateStrikeExclusive(const SkPaint& paint);
 
+    // Unlike an exclusive strike, a shared strike stays in the cache while it's used, and any
+    // number of threads may use it at once.  See SkSharedStrike.
+    static sk_sp<SkSharedStrike> FindOrCreateStrikeShared(
+            const SkDescriptor& desc,
+            const SkScalerContextEffects& effects,
+            const SkTypeface& typeface);
+
+    static sk_sp<SkSharedStrike> FindOrCreateStrikeShared(
+            const SkPaint& paint,
+            const SkSurfaceProps* surfaceProps,
+            SkScalerContextFlags scalerContextFlags,
+            const SkMatrix* deviceMatrix);
+
     static std::unique_ptr<SkScalerContext> CreateScalerContext(
             const SkDescriptor&, const SkScalerContextEffects&, const SkTypeface&);
 
     static void PurgeAll();
 
+    // When set, drawing a long run of glyphs makes all of its missing glyph images up front,
+    // spread over this executor (see SkGlyphCache::prepareGlyphs()).  The executor is not owned
+    // and must outlive its use here; pass nullptr to go back to making glyphs as they're drawn.
+    static void SetGlyphRasterExecutor(SkExecutor*);
+    static SkExecutor* GetGlyphRasterExecutor();
+
+    // Keep glyphs between runs in the file at path (see SkGlyphStore).  New strikes look there
+    // for glyphs before generating them, and purged strikes are remembered for the next
+    // WritePersistentGlyphFile(), which writes the file back with every strike we know about;
+    // call it before exiting.  Only the first call to SetPersistentGlyphFile() has any effect.
+    static void SetPersistentGlyphFile(const char path[]);
+    static bool WritePersistentGlyphFile();
+
     static void Dump();
 
     // Dump memory usage statistics of all the attaches caches in the process using the
@@ -103,6 +142,18 @@ public:
     void attachNode(Node* node);
     ExclusiveStrikePtr findStrikeExclusive(const SkDescriptor&);
 
+    // The strike returns to this cache (rather than the global one) when it is no longer in use.
+    ExclusiveStrikePtr createStrikeExclusive(
+            const SkDescriptor& desc,
+            std::unique_ptr<SkScalerContext> scaler,
+            SkPaint::FontMetrics* maybeMetrics = nullptr,
+            std::unique_ptr<SkStrikePinner> = nullptr);
+
+    sk_sp<SkSharedStrike> findOrCreateStrikeShared(
+            const SkDescriptor& desc,
+            const SkScalerContextEffects& effects,
+            const SkTypeface& typeface);
+
     void purgeAll(); // does not change budget
 
     int getCacheCountLimit() const;
@@ -116,6 +167,8 @@ public:
     int  getCachePointSizeLimit() const;
     int  setCachePointSizeLimit(int limit);
 
+    int  shardCount() const { return fShardCount; }
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
@@ -123,28 +176,20 @@ public:
 #endif
 
 private:
-    static void Attach(Node* node);
-
-    // The following methods can only be called when mutex is already held.
-    Node* internalGetHead() const { return fHead; }
-    Node* internalGetTail() const { return fTail; }
-    void internalDetachCache(Node*);
-    void internalAttachToHead(Node*);
+    Shard* shardFor(const SkDescriptor&) const;
 
-    // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
-    // and attempt to purge caches to match.
-    // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0);
+    // Hand each shard its share of fCacheSizeLimit and fCacheCountLimit, and purge to match.
+    // Can only be called when fLimitsLock is already held.
+    void internalDistributeLimits();
 
     void forEachStrike(std::function<void(const SkGlyphCache&)> visitor) const;
 
-    mutable SkSpinlock fLock;
-    Node*              fHead{nullptr};
-    Node*              fTail{nullptr};
-    size_t             fTotalMemoryUsed{0};
+    const int                fShardCount;
+    std::unique_ptr<Shard[]> fShards;
+
+    mutable SkSpinlock fLimitsLock;
     size_t             fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
     int32_t            fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
-    int32_t            fCacheCount{0};
     int32_t            fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
 };
 
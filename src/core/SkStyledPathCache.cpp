@@ -0,0 +1,135 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStyledPathCache.h"
+
+#include "SkPathEffect.h"
+#include "SkPathPriv.h"
+#include "SkResourceCache.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+// Stroking a few verbs is cheaper than looking them up.
+static constexpr int kMinVerbsToCache = 8;
+
+// Dashing and stroking measure and offset every segment, on top of writing the result.
+static constexpr size_t kStyleCostPerByte = 4;
+
+namespace {
+static unsigned gStyledPathKeyNamespaceLabel;
+
+static uint64_t make_shared_id(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('s', 'p', 't', 'h');
+    return (sharedID << 32) | pathGenID;
+}
+
+struct StyledPathKey : public SkResourceCache::Key {
+public:
+    StyledPathKey(SkStyledPathCache::Step step, const SkPath& src, const SkStrokeRec& rec,
+                  const SkPathEffect* pe, const SkRect* cullRect)
+        : fGenID(src.getGenerationID())
+        , fPathEffectID(pe ? pe->uniqueID() : 0)
+        , fFlags(((uint32_t)step << 6) | (rec.getCap() << 3) | (rec.getJoin() << 1) |
+                 (cullRect ? 1 : 0))
+        , fWidth(rec.getWidth())
+        , fMiter(rec.getMiter())
+        , fResScale(rec.getResScale())
+    {
+        // getStyle() tells stroke-and-fill from stroke; width already tells the rest.
+        fFlags |= (SkStrokeRec::kStrokeAndFill_Style == rec.getStyle()) << 8;
+        // The gen ID only covers the fill type on the framework, and styling keeps it.
+        fFlags |= (uint32_t)src.getFillType() << 9;
+        if (cullRect) {
+            fCullRect = *cullRect;
+        } else {
+            fCullRect.setEmpty();
+        }
+        this->init(&gStyledPathKeyNamespaceLabel, make_shared_id(fGenID),
+                   sizeof(fGenID) + sizeof(fPathEffectID) + sizeof(fFlags) + sizeof(fWidth) +
+                   sizeof(fMiter) + sizeof(fResScale) + sizeof(fCullRect));
+    }
+
+    uint32_t fGenID;
+    uint32_t fPathEffectID;
+    uint32_t fFlags;
+    SkScalar fWidth;
+    SkScalar fMiter;
+    SkScalar fResScale;
+    SkRect   fCullRect;
+};
+
+struct StyledPathValue {
+    SkPath      fPath;
+    SkStrokeRec fRec;
+};
+
+struct StyledPathRec : public SkResourceCache::Rec {
+    StyledPathRec(const StyledPathKey& key, const SkPath& path, const SkStrokeRec& rec)
+        : fKey(key)
+        , fValue{path, rec} {}
+
+    StyledPathKey   fKey;
+    StyledPathValue fValue;
+
+    size_t pathBytes() const {
+        return fValue.fPath.countPoints() * sizeof(SkPoint) + fValue.fPath.countVerbs();
+    }
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + this->pathBytes(); }
+    size_t regenerationCost() const override { return kStyleCostPerByte * this->pathBytes(); }
+    bool canBeFoundConcurrently() const override { return true; }
+    const char* getCategory() const override { return "styled-path"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const StyledPathRec& rec = static_cast<const StyledPathRec&>(baseRec);
+        StyledPathValue* result = static_cast<StyledPathValue*>(contextData);
+        result->fPath = rec.fValue.fPath;
+        result->fRec = rec.fValue.fRec;
+        return true;
+    }
+};
+
+// When the source path is edited or deleted, purge everything styled from it.
+class PathInvalidator : public SkPathRef::GenIDChangeListener {
+public:
+    explicit PathInvalidator(uint32_t genID) : fGenID(genID) {}
+private:
+    uint32_t fGenID;
+
+    void onChange() override {
+        SkResourceCache::PostPurgeSharedID(make_shared_id(fGenID));
+    }
+};
+} // namespace
+
+bool SkStyledPathCache::CanCache(const SkPath& src) {
+    return src.countVerbs() >= kMinVerbsToCache;
+}
+
+bool SkStyledPathCache::Find(Step step, const SkPath& src, const SkStrokeRec& rec,
+                             const SkPathEffect* pe, const SkRect* cullRect,
+                             SkPath* dst, SkStrokeRec* dstRec, SkResourceCache* localCache) {
+    StyledPathValue result{SkPath(), SkStrokeRec(SkStrokeRec::kFill_InitStyle)};
+    StyledPathKey key(step, src, rec, pe, cullRect);
+    if (!CHECK_LOCAL(localCache, find, Find, key, StyledPathRec::Visitor, &result)) {
+        return false;
+    }
+    *dst = result.fPath;
+    *dstRec = result.fRec;
+    return true;
+}
+
+void SkStyledPathCache::Add(Step step, const SkPath& src, const SkStrokeRec& rec,
+                            const SkPathEffect* pe, const SkRect* cullRect,
+                            const SkPath& dst, const SkStrokeRec& dstRec,
+                            SkResourceCache* localCache) {
+    StyledPathKey key(step, src, rec, pe, cullRect);
+    CHECK_LOCAL(localCache, add, Add, new StyledPathRec(key, dst, dstRec));
+    SkPathPriv::AddGenIDChangeListener(src, new PathInvalidator(key.fGenID));
+}
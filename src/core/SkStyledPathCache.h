@@ -0,0 +1,57 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStyledPathCache_DEFINED
+#define SkStyledPathCache_DEFINED
+
+#include "SkPath.h"
+#include "SkStrokeRec.h"
+
+class SkPathEffect;
+class SkResourceCache;
+
+/** \class SkStyledPathCache
+
+    Keeps the paths made by applying a path effect and/or stroke to a source path, so drawing the
+    same path with the same style again doesn't re-dash or re-stroke it. Entries live in the
+    SkResourceCache, keyed by the source path's gen ID and fill type, the stroke parameters, the
+    path effect's unique ID, the resolution scale and the cull rect. They are purged when the
+    source path is edited or deleted.
+
+    Callers must only pass source paths whose gen ID identifies their geometry for as long as it
+    is in use: not volatile paths or scratch paths made anew for each draw. A styled path found in
+    the cache is fine, even though it is volatile, since it keeps its gen ID until purged.
+*/
+class SkStyledPathCache {
+public:
+    /** Which styling step made the cached path. Each variant keys its own entries. */
+    enum class Step {
+        kFillPath,          // SkPaint::getFillPath()
+        kGrPathEffect,      // GrStyle::applyPathEffectToPath()
+        kGrStyle,           // GrStyle::applyToPath()
+    };
+
+    /** Does src have enough verbs to be worth caching the styled results of? */
+    static bool CanCache(const SkPath& src);
+
+    /**
+     *  On success, sets dst to the styled path and dstRec to the style it is to be drawn with,
+     *  and returns true. rec is the style before the step, its res scale is part of the key.
+     */
+    static bool Find(Step, const SkPath& src, const SkStrokeRec& rec, const SkPathEffect*,
+                     const SkRect* cullRect, SkPath* dst, SkStrokeRec* dstRec,
+                     SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Add the result of styling src to the cache.
+     */
+    static void Add(Step, const SkPath& src, const SkStrokeRec& rec, const SkPathEffect*,
+                    const SkRect* cullRect, const SkPath& dst, const SkStrokeRec& dstRec,
+                    SkResourceCache* localCache = nullptr);
+};
+
+#endif
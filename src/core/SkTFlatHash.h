@@ -0,0 +1,234 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTFlatHash_DEFINED
+#define SkTFlatHash_DEFINED
+
+#include "SkMathPriv.h"
+#include "SkTemplates.h"
+#include "SkTypes.h"
+
+#include <utility>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+// A drop-in for SkTHashTable (same Traits, same API) for tables on hot lookup paths.
+//
+// Alongside each slot is a control byte holding 7 bits of the slot's hash, or marking it empty
+// or removed. Slots are probed in aligned groups of 16, and a group's control bytes are all
+// compared with the hash at once, so a lookup compares keys only where those 7 bits matched,
+// and usually looks at just one group, however long the probe would have been one slot at a time.
+//
+// As with SkTHashTable, the pointers returned by set() and find() are valid only until the next
+// call to set(), and entries must not be changed so that their key changes.
+template <typename T, typename K, typename Traits = T>
+class SkTFlatHashTable : SkNoncopyable {
+public:
+    SkTFlatHashTable() {}
+
+    // Clear the table.
+    void reset() {
+        this->~SkTFlatHashTable();
+        new (this) SkTFlatHashTable;
+    }
+
+    // How many entries are in the table?
+    int count() const { return fCount; }
+
+    // Approximately how many bytes of memory do we use beyond sizeof(*this)?
+    size_t approxBytesUsed() const { return fCapacity * (sizeof(T) + 1); }
+
+    // Copy val into the hash table, returning a pointer to the copy now in the table.
+    // If there already is an entry in the table with the same key, we overwrite it.
+    T* set(T val) {
+        // Keep at least a quarter of the slots empty, so probes end quickly.
+        if (4 * (fCount + fRemoved + 1) > 3 * fCapacity) {
+            // Removed slots are dropped by resizing, so only grow if they weren't the problem.
+            this->resize(2 * (fCount + 1) > fCapacity ? SkTMax(2 * fCapacity, kGroupSize)
+                                                      : fCapacity);
+        }
+        return this->uncheckedSet(std::move(val));
+    }
+
+    // If there is an entry in the table with this key, return a pointer to it.  If not, null.
+    T* find(const K& key) const {
+        if (fCapacity == 0) {
+            return nullptr;
+        }
+        const uint32_t hash = Traits::Hash(key);
+        Probe probe(hash, fCapacity);
+        for (;;) {
+            const int group = probe.group();
+            for (uint32_t bits = Match(&fControl[group], H2(hash)); bits; bits &= bits - 1) {
+                T& val = fSlots[group + SkCTZ(bits)];
+                if (key == Traits::GetKey(val)) {
+                    return &val;
+                }
+            }
+            if (Match(&fControl[group], kEmpty)) {
+                return nullptr;
+            }
+            probe.next();
+        }
+    }
+
+    // Remove the value with this key from the hash table.
+    void remove(const K& key) {
+        T* val = this->find(key);
+        SkASSERT(val);
+        const int index = SkToInt(val - fSlots.get());
+        *val = T();
+        fCount--;
+
+        // A group that has never been full hasn't sent any probe on to the next group, so its
+        // slots can go back to being empty. Otherwise probes for other entries must go past it.
+        const int group = index & ~(kGroupSize - 1);
+        if (Match(&fControl[group], kEmpty)) {
+            fControl[index] = kEmpty;
+        } else {
+            fControl[index] = kRemoved;
+            fRemoved++;
+        }
+    }
+
+    // Call fn on every entry in the table.  You may mutate the entries, but be very careful.
+    template <typename Fn>  // f(T*)
+    void foreach(Fn&& fn) {
+        for (int i = 0; i < fCapacity; i++) {
+            if (IsFull(fControl[i])) {
+                fn(&fSlots[i]);
+            }
+        }
+    }
+
+    // Call fn on every entry in the table.  You may not mutate anything.
+    template <typename Fn>  // f(T) or f(const T&)
+    void foreach(Fn&& fn) const {
+        for (int i = 0; i < fCapacity; i++) {
+            if (IsFull(fControl[i])) {
+                fn(fSlots[i]);
+            }
+        }
+    }
+
+private:
+    static constexpr int kGroupSize = 16;
+
+    // Full slots' control bytes are the low 7 bits of their hash.
+    static constexpr uint8_t kEmpty = 0x80;
+    static constexpr uint8_t kRemoved = 0xFE;
+
+    static bool IsFull(uint8_t control) { return control < 0x80; }
+    static uint8_t H2(uint32_t hash) { return hash & 0x7F; }
+
+    // Visits the groups in an order that covers each once (as fCapacity is a power of 2),
+    // starting at one picked by the hash bits not in the control byte.
+    class Probe {
+    public:
+        Probe(uint32_t hash, int capacity)
+            : fMask(capacity / kGroupSize - 1), fGroup((hash >> 7) & fMask) {}
+        int group() const { return fGroup * kGroupSize; }
+        void next() { fGroup = (fGroup + ++fStep) & fMask; }
+
+    private:
+        const uint32_t fMask;
+        uint32_t       fGroup;
+        uint32_t       fStep = 0;
+    };
+
+    // Returns a bit for each of the 16 control bytes at group that's equal to control.
+    static uint32_t Match(const uint8_t* group, uint8_t control) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(control)));
+    #elif defined(SK_ARM_HAS_NEON)
+        // Keep one bit of each matching byte, then add up the bits of each half.
+        static const uint8_t kBits[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                          1, 2, 4, 8, 16, 32, 64, 128};
+        uint8x16_t eq = vandq_u8(vceqq_u8(vld1q_u8(group), vdupq_n_u8(control)),
+                                 vld1q_u8(kBits));
+        uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(eq)));
+        return (uint32_t)vgetq_lane_u64(sums, 0) | ((uint32_t)vgetq_lane_u64(sums, 1) << 8);
+    #else
+        uint32_t bits = 0;
+        for (int i = 0; i < kGroupSize; i++) {
+            bits |= (uint32_t)(group[i] == control) << i;
+        }
+        return bits;
+    #endif
+    }
+
+    T* uncheckedSet(T&& val) {
+        const K& key = Traits::GetKey(val);
+        const uint32_t hash = Traits::Hash(key);
+        int insertAt = -1;
+        Probe probe(hash, fCapacity);
+        for (;;) {
+            const int group = probe.group();
+            for (uint32_t bits = Match(&fControl[group], H2(hash)); bits; bits &= bits - 1) {
+                T& slot = fSlots[group + SkCTZ(bits)];
+                if (key == Traits::GetKey(slot)) {
+                    // Overwrite previous entry.
+                    slot = std::move(val);
+                    return &slot;
+                }
+            }
+            if (insertAt < 0) {
+                if (uint32_t removed = Match(&fControl[group], kRemoved)) {
+                    insertAt = group + SkCTZ(removed);
+                }
+            }
+            if (uint32_t empty = Match(&fControl[group], kEmpty)) {
+                if (insertAt < 0) {
+                    insertAt = group + SkCTZ(empty);
+                } else {
+                    fRemoved--;
+                }
+                break;
+            }
+            probe.next();
+        }
+        fControl[insertAt] = H2(hash);
+        fSlots[insertAt] = std::move(val);
+        fCount++;
+        return &fSlots[insertAt];
+    }
+
+    void resize(int capacity) {
+        SkASSERT(SkIsPow2(capacity) && capacity >= kGroupSize);
+        const int oldCapacity = fCapacity;
+        SkDEBUGCODE(int oldCount = fCount);
+
+        SkAutoTMalloc<uint8_t> oldControl = std::move(fControl);
+        SkAutoTArray<T> oldSlots = std::move(fSlots);
+        fCount = 0;
+        fRemoved = 0;
+        fCapacity = capacity;
+        fControl.reset(capacity);
+        memset(fControl.get(), kEmpty, capacity);
+        fSlots = SkAutoTArray<T>(capacity);
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (IsFull(oldControl[i])) {
+                this->uncheckedSet(std::move(oldSlots[i]));
+            }
+        }
+        SkASSERT(fCount == oldCount);
+    }
+
+    int fCount = 0;
+    int fRemoved = 0;    // Slots marked kRemoved, which probes go past like full ones.
+    int fCapacity = 0;   // 0, or a power of 2 no less than kGroupSize.
+    SkAutoTMalloc<uint8_t> fControl;
+    SkAutoTArray<T>        fSlots;
+};
+
+#endif//SkTFlatHash_DEFINED
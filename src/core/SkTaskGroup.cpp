@@ -8,25 +8,24 @@
 #include "SkExecutor.h"
 #include "SkTaskGroup.h"
 
-SkTaskGroup::SkTaskGroup(SkExecutor& executor) : fPending(0), fExecutor(executor) {}
+SkTaskGroup::SkTaskGroup(SkExecutor& executor, SkExecutor::Priority priority)
+    : fPending(0), fExecutor(executor), fPriority(priority) {}
 
-void SkTaskGroup::add(std::function<void(void)> fn) {
-    fPending.fetch_add(+1, std::memory_order_relaxed);
-    fExecutor.add([=] {
-        fn();
+void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
+    // The executor decides how to split the batch up.
+    fPending.fetch_add(+N, std::memory_order_relaxed);
+    fExecutor.batch(N, [=](int i) {
+        fn(i);
         fPending.fetch_add(-1, std::memory_order_release);
-    });
+    }, fPriority);
 }
 
-void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
-    // TODO: I really thought we had some sort of more clever chunking logic.
-    fPending.fetch_add(+N, std::memory_order_relaxed);
-    for (int i = 0; i < N; i++) {
-        fExecutor.add([=] {
-            fn(i);
-            fPending.fetch_add(-1, std::memory_order_release);
-        });
-    }
+void SkTaskGroup::parallelFor(int N, int grain, std::function<void(int, int)> fn) {
+    SkASSERT(grain > 0);
+    this->batch((N + grain - 1) / grain, [=](int i) {
+        const int begin = i * grain;
+        fn(begin, SkTMin(begin + grain, N));
+    });
 }
 
 bool SkTaskGroup::done() const {
@@ -41,11 +40,15 @@ void SkTaskGroup::wait() {
     while (!this->done()) {
         fExecutor.borrow();
     }
+
+    // None of the tasks are running any more, so their space can be reused.
+    SkAutoExclusive lock(fArenaLock);
+    fArena.reset();
 }
 
 SkTaskGroup::Enabler::Enabler(int threads) {
     if (threads) {
-        fThreadPool = SkExecutor::MakeLIFOThreadPool(threads);
+        fThreadPool = SkExecutor::MakeWorkStealingThreadPool(threads);
         SkExecutor::SetDefault(fThreadPool.get());
     }
 }
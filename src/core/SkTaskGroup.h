@@ -8,23 +8,49 @@
 #ifndef SkTaskGroup_DEFINED
 #define SkTaskGroup_DEFINED
 
+#include "SkArenaAlloc.h"
 #include "SkExecutor.h"
+#include "SkMutex.h"
+#include "SkSpinlock.h"
 #include "SkTypes.h"
 #include <atomic>
 #include <functional>
+#include <type_traits>
 
 class SkTaskGroup : SkNoncopyable {
 public:
-    // Tasks added to this SkTaskGroup will run on its executor.
-    explicit SkTaskGroup(SkExecutor& executor = SkExecutor::GetDefault());
+    // Tasks added to this SkTaskGroup will run on its executor, at its priority.
+    explicit SkTaskGroup(SkExecutor& executor = SkExecutor::GetDefault(),
+                         SkExecutor::Priority priority = SkExecutor::Priority::kNormal);
     ~SkTaskGroup() { this->wait(); }
 
-    // Add a task to this SkTaskGroup.
-    void add(std::function<void(void)> fn);
+    // Add a task to this SkTaskGroup. Tasks are kept in an arena owned by the group, reused once
+    // wait() is done, so adding them allocates nothing most of the time.
+    template <typename Fn>
+    void add(Fn&& fn) {
+        using Task = typename std::decay<Fn>::type;
+        void* storage;
+        {
+            SkAutoExclusive lock(fArenaLock);
+            storage = fArena.makeBytesAlignedTo(sizeof(Task), alignof(Task));
+        }
+        Task* task = new (storage) Task(std::forward<Fn>(fn));
+        fPending.fetch_add(+1, std::memory_order_relaxed);
+        // This is small enough for std::function to hold without allocating.
+        fExecutor.addPrioritized([this, task] {
+            (*task)();
+            task->~Task();
+            fPending.fetch_add(-1, std::memory_order_release);
+        }, fPriority);
+    }
 
     // Add a batch of N tasks, all calling fn with different arguments.
     void batch(int N, std::function<void(int)> fn);
 
+    // Calls fn(begin, end) for consecutive ranges covering [0, N), each grain long but the last,
+    // as one batch. Better than batch() when each index is too little work to be a task.
+    void parallelFor(int N, int grain, std::function<void(int begin, int end)> fn);
+
     // Returns true if all Tasks previously add()ed to this SkTaskGroup have run.
     // It is safe to reuse this SkTaskGroup once done().
     bool done() const;
@@ -40,8 +66,11 @@ public:
     };
 
 private:
-    std::atomic<int32_t> fPending;
-    SkExecutor&          fExecutor;
+    std::atomic<int32_t>       fPending;
+    SkExecutor&                fExecutor;
+    const SkExecutor::Priority fPriority;
+    SkSpinlock                 fArenaLock;
+    SkSTArenaAlloc<256>        fArena;
 };
 
 #endif//SkTaskGroup_DEFINED
@@ -7,6 +7,8 @@
 
 #include "SkTaskGroup2D.h"
 
+#include "SkTime.h"
+
 void SkTaskGroup2D::start() {
     fThreadsGroup->batch(fThreadCnt, [this](int threadId){
         this->work(threadId);
@@ -84,3 +86,88 @@ void SkFlexibleTaskGroup2D::work(int threadId) {
         this->initAnUninitializedColumn(initCol, threadId); // Initialize something
     }
 }
+
+SkWorkStealingTaskGroup2D::SkWorkStealingTaskGroup2D(SkWorkKernel2D* kernel, int h, SkExecutor* x,
+                                                     int t)
+        : SkTaskGroup2D(kernel, h, x, t)
+        , fRowData(h)
+        , fThreadStats(t)
+        , fRowsCompleted(0)
+        , fThreadsRunning(t)
+        , fStartMs(0)
+        , fElapsedMs(0) {}
+
+void SkWorkStealingTaskGroup2D::start() {
+    fStartMs = SkTime::GetMSecs();
+    this->SkTaskGroup2D::start();
+}
+
+bool SkWorkStealingTaskGroup2D::tryWorkRow(int row, int threadId, bool isStealing) {
+    RowData& rowData = fRowData[row];
+
+    // See SkFlexibleTaskGroup2D::work for why we need to disable -Wthread-safety-analysis.
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wthread-safety-analysis"
+#endif
+    if (!rowData.fMutex.try_lock()) {
+        return false;
+    }
+
+    // Read isFinishing before fWidth: once it's true, fWidth can no longer grow.
+    bool isFinishing = this->isFinishing();
+    int  width       = fWidth;
+    int  startColumn = rowData.fNextColumn;
+    if (startColumn < width) {
+        double startMs = SkTime::GetMSecs();
+        while (rowData.fNextColumn < width &&
+                fKernel->work2D(row, rowData.fNextColumn, threadId)) {
+            rowData.fNextColumn++;
+        }
+        rowData.fStats.fBusyMs += SkTime::GetMSecs() - startMs;
+        rowData.fStats.fStolenRuns += (isStealing && rowData.fNextColumn > startColumn);
+    }
+    if (isFinishing && !rowData.fCompleted && rowData.fNextColumn == width) {
+        rowData.fCompleted = true;
+        fRowsCompleted++;
+    }
+    bool didWork = rowData.fNextColumn > startColumn;
+    rowData.fMutex.unlock();
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+    return didWork;
+}
+
+void SkWorkStealingTaskGroup2D::work(int threadId) {
+    const int ownBegin = this->firstRowOf(threadId);
+    const int ownEnd   = this->firstRowOf(threadId + 1);
+    int initCol = 0;
+    ThreadStats& stats = fThreadStats[threadId];
+
+    while (fRowsCompleted < fHeight) {
+        double iterationStartMs = SkTime::GetMSecs();
+        bool didWork = false;
+        for (int row = ownBegin; row < ownEnd; ++row) {
+            didWork |= this->tryWorkRow(row, threadId, false);
+        }
+
+        // Out of our own ready work: steal from the other rows, starting right after our band so
+        // different thieves are spread over different victims.
+        if (!didWork) {
+            for (int i = 0; i < fHeight - (ownEnd - ownBegin) && !didWork; ++i) {
+                didWork = this->tryWorkRow((ownEnd + i) % fHeight, threadId, true);
+            }
+        }
+
+        if (!didWork && !this->initAnUninitializedColumn(initCol, threadId)) {
+            stats.fIdleMs += SkTime::GetMSecs() - iterationStartMs;
+        }
+    }
+
+    // The last thread to leave records the wall time of the whole group.
+    if (--fThreadsRunning == 0) {
+        fElapsedMs = SkTime::GetMSecs() - fStartMs;
+    }
+}
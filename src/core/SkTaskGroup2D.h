@@ -9,6 +9,7 @@
 #define SkTaskGroup2D_DEFINED
 
 #include "SkTaskGroup.h"
+#include "SkTArray.h"
 
 #include <mutex>
 #include <vector>
@@ -55,7 +56,7 @@ public:
 
     virtual void addColumn(); // Add a new column of tasks.
 
-    void start(); // start threads to execute tasks
+    virtual void start(); // start threads to execute tasks
     void finish(); // wait and finish all tasks (no more tasks can be added after calling this)
 
     SK_ALWAYS_INLINE bool isFinishing() const {
@@ -70,12 +71,13 @@ protected:
 
     // Initialize a column that needs to be initialized. The parameter initCol is not thread safe
     // and should only be exclusively accessed by the working thread which will modify it to the
-    // column that may need to be initialized next.
-    void initAnUninitializedColumn(int& initCol, int threadId) {
+    // column that may need to be initialized next. Returns true iff some column was initialized.
+    bool initAnUninitializedColumn(int& initCol, int threadId) {
         bool didSomeInit = false;
         while (initCol < fWidth && !didSomeInit) {
             didSomeInit = fKernel->initColumn(initCol++, threadId);
         }
+        return didSomeInit;
     }
 
     SkWorkKernel2D*     fKernel;
@@ -120,4 +122,64 @@ private:
     std::vector<RowData>    fRowData;
 };
 
+// A work-stealing task group that does not require height to be equal to threadCnt.
+//
+// Each thread owns a contiguous band of rows and works on them first. Once all of its own rows are
+// blocked (out of ready columns, or held by another thread), it steals ready (row, column) work
+// from the rows of other threads. The per-row ordering is still guaranteed because whoever works
+// on a row must hold that row's lock, and the row's next column is only advanced under the lock.
+//
+// It also measures how long each row (tile) is busy, and how long each thread spins without any
+// ready work, so clients can tune their tile count.
+class SkWorkStealingTaskGroup2D final : public SkTaskGroup2D {
+public:
+    struct RowStats {
+        double  fBusyMs     = 0; // time spent inside work2D for this row
+        int     fStolenRuns = 0; // number of times this row was worked on by a non-owner thread
+    };
+
+    struct ThreadStats {
+        double  fIdleMs     = 0; // time spent without any ready work or initialization to do
+    };
+
+    SkWorkStealingTaskGroup2D(SkWorkKernel2D* kernel, int h, SkExecutor* x, int t);
+
+    void start() override;
+
+    // The stats below are only stable after finish() returns.
+    const RowStats& rowStats(int row) const { return fRowData[row].fStats; }
+    const ThreadStats& threadStats(int threadId) const { return fThreadStats[threadId]; }
+
+    // Wall time between start() and the moment the last thread ran out of work. A row's idle time
+    // is elapsedMs() - rowStats(row).fBusyMs.
+    double elapsedMs() const { return fElapsedMs; }
+
+protected:
+    void work(int threadId) override;
+
+private:
+    struct alignas(MAX_CACHE_LINE) RowData {
+        RowData() : fNextColumn(0), fCompleted(false) {}
+
+        int         fNextColumn; // next column index to work; guarded by fMutex
+        bool        fCompleted;  // guarded by fMutex
+        RowStats    fStats;      // guarded by fMutex
+        std::mutex  fMutex;
+    };
+
+    struct alignas(MAX_CACHE_LINE) AlignedThreadStats : ThreadStats {};
+
+    // Run as many ready columns of the row as possible. Returns true iff some work was done.
+    bool tryWorkRow(int row, int threadId, bool isStealing);
+
+    int firstRowOf(int threadId) const { return threadId * fHeight / fThreadCnt; }
+
+    std::vector<RowData>            fRowData;
+    std::vector<AlignedThreadStats> fThreadStats;
+    std::atomic<int>                fRowsCompleted;
+    std::atomic<int>                fThreadsRunning;
+    double                          fStartMs;
+    double                          fElapsedMs;
+};
+
 #endif//SkTaskGroup2D_DEFINED
@@ -10,6 +10,7 @@
 #include "SkPaintPriv.h"
 #include "SkReadBuffer.h"
 #include "SkSafeMath.h"
+#include "SkTextBlobRasterCache.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
 
@@ -307,7 +308,8 @@ static int32_t next_id() {
 SkTextBlob::SkTextBlob(const SkRect& bounds)
     : fBounds(bounds)
     , fUniqueID(next_id())
-    , fCacheID(SK_InvalidUniqueID) {}
+    , fCacheID(SK_InvalidUniqueID)
+    , fAddedToRasterCache(false) {}
 
 SkTextBlob::~SkTextBlob() {
 #if SK_SUPPORT_GPU
@@ -315,6 +317,9 @@ SkTextBlob::~SkTextBlob() {
         GrTextBlobCache::PostPurgeBlobMessage(fUniqueID, fCacheID);
     }
 #endif
+    if (fAddedToRasterCache.load()) {
+        SkTextBlobRasterCache::PostPurgeBlob(fUniqueID);
+    }
 
     const auto* run = RunRecord::First(this);
     do {
@@ -873,11 +878,7 @@ sk_sp<SkData> SkTextBlob::serialize(const SkSerialProcs& procs) const {
     SkBinaryWriteBuffer buffer;
     buffer.setSerialProcs(procs);
     this->flatten(buffer);
-
-    size_t total = buffer.bytesWritten();
-    sk_sp<SkData> data = SkData::MakeUninitialized(total);
-    buffer.writeToMemory(data->writable_data());
-    return data;
+    return buffer.detachAsData();
 }
 
 sk_sp<SkData> SkTextBlob::serialize() const {
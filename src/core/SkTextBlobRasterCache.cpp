@@ -0,0 +1,89 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTextBlobRasterCache.h"
+
+#include "SkResourceCache.h"
+#include "SkTextBlob.h"
+
+size_t SkTextBlobRasterCache::Blob::bytesUsed() const {
+    size_t size = sizeof(*this) + fRuns.size() * sizeof(Run);
+    for (const Run& run : fRuns) {
+        size += run.fDesc ? run.fDesc->getLength() : 0;
+        size += run.fGlyphIDs.size() * sizeof(SkPackedGlyphID)
+              + run.fPositions.size() * sizeof(SkPoint);
+    }
+    return size;
+}
+
+namespace {
+static unsigned gTextBlobRasterKeyNamespaceLabel;
+
+static uint64_t make_shared_id(uint32_t blobID) {
+    uint64_t sharedID = SkSetFourByteTag('t', 'b', 'l', 'b');
+    return (sharedID << 32) | blobID;
+}
+
+struct TextBlobRasterKey : public SkResourceCache::Key {
+public:
+    TextBlobRasterKey(uint32_t blobID, SkScalar x, SkScalar y, const SkMatrix& matrix)
+        : fX(x)
+        , fY(y)
+    {
+        matrix.get9(fMatrix);
+        this->init(&gTextBlobRasterKeyNamespaceLabel, make_shared_id(blobID),
+                   sizeof(fX) + sizeof(fY) + sizeof(fMatrix));
+    }
+
+    SkScalar fX;
+    SkScalar fY;
+    SkScalar fMatrix[9];
+};
+
+struct TextBlobRasterRec : public SkResourceCache::Rec {
+    TextBlobRasterRec(const TextBlobRasterKey& key, sk_sp<const SkTextBlobRasterCache::Blob> blob)
+        : fKey(key)
+        , fBlob(std::move(blob)) {}
+
+    TextBlobRasterKey                         fKey;
+    sk_sp<const SkTextBlobRasterCache::Blob> fBlob;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fBlob->bytesUsed(); }
+    bool canBeFoundConcurrently() const override { return true; }
+    const char* getCategory() const override { return "text-blob"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const TextBlobRasterRec& rec = static_cast<const TextBlobRasterRec&>(baseRec);
+        auto* result = (sk_sp<const SkTextBlobRasterCache::Blob>*)contextData;
+        *result = rec.fBlob;
+        return true;
+    }
+};
+} // namespace
+
+sk_sp<const SkTextBlobRasterCache::Blob> SkTextBlobRasterCache::Find(
+        const SkTextBlob& blob, SkScalar x, SkScalar y, const SkMatrix& matrix) {
+    sk_sp<const Blob> result;
+    TextBlobRasterKey key(blob.uniqueID(), x, y, matrix);
+    if (!SkResourceCache::Find(key, TextBlobRasterRec::Visitor, &result)) {
+        return nullptr;
+    }
+    return result;
+}
+
+void SkTextBlobRasterCache::Add(const SkTextBlob& blob, SkScalar x, SkScalar y,
+                                const SkMatrix& matrix, sk_sp<const Blob> placed) {
+    TextBlobRasterKey key(blob.uniqueID(), x, y, matrix);
+    SkResourceCache::Add(new TextBlobRasterRec(key, std::move(placed)));
+    blob.notifyAddedToRasterCache();
+}
+
+void SkTextBlobRasterCache::PostPurgeBlob(uint32_t blobID) {
+    SkResourceCache::PostPurgeSharedID(make_shared_id(blobID));
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTextBlobRasterCache_DEFINED
+#define SkTextBlobRasterCache_DEFINED
+
+#include "SkDescriptor.h"
+#include "SkGlyph.h"
+#include "SkMatrix.h"
+#include "SkPoint.h"
+#include "SkRefCnt.h"
+
+#include <memory>
+#include <vector>
+
+class SkTextBlob;
+
+/** \class SkTextBlobRasterCache
+
+    The raster backend's counterpart to GrTextBlobCache: the glyphs of a text blob, already
+    looked up and positioned in device space, kept in the SkResourceCache.  Entries are keyed by
+    the blob's unique ID, the origin it was drawn at and the matrix, and go away with the blob.
+    SkBitmapDevice uses it when its SkSurfaceProps have kCacheTextBlobs_Flag.
+
+    Each run remembers the descriptor of the strike it was placed with.  Anything else about the
+    paint that changes where glyphs land (size, typeface, hinting, subpixel positioning...)
+    changes that descriptor too, so a run is only replayed if the strike we'd draw it with now
+    has the same one.
+
+    We keep packed glyph IDs rather than SkGlyph pointers: glyphs move around inside their strike
+    as it grows, and the strike may be purged between draws.
+*/
+class SkTextBlobRasterCache {
+public:
+    struct Run {
+        std::unique_ptr<SkDescriptor> fDesc;   // null if the run isn't drawn from a strike
+        std::vector<SkPackedGlyphID>  fGlyphIDs;
+        std::vector<SkPoint>          fPositions;   // device space, rounding already applied
+    };
+
+    class Blob : public SkNVRefCnt<Blob> {
+    public:
+        explicit Blob(std::vector<Run> runs) : fRuns(std::move(runs)) {}
+
+        const std::vector<Run>& runs() const { return fRuns; }
+        size_t bytesUsed() const;
+
+    private:
+        const std::vector<Run> fRuns;
+    };
+
+    /** Return the placed glyphs for blob drawn at (x, y) with matrix, or nullptr. */
+    static sk_sp<const Blob> Find(const SkTextBlob& blob, SkScalar x, SkScalar y,
+                                  const SkMatrix& matrix);
+
+    /** Remember the placed glyphs for blob drawn at (x, y) with matrix. */
+    static void Add(const SkTextBlob& blob, SkScalar x, SkScalar y, const SkMatrix& matrix,
+                    sk_sp<const Blob> placed);
+
+    /** Forget everything about the blob with this unique ID. */
+    static void PostPurgeBlob(uint32_t blobID);
+};
+
+#endif  // SkTextBlobRasterCache_DEFINED
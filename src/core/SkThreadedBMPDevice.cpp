@@ -24,20 +24,96 @@ bool SkThreadedBMPDevice::DrawQueue::work2D(int row, int column, int thread) {
     return fElements[column].tryDraw(fDevice->fTileBounds[row], &fThreadAllocs[thread]);
 }
 
+void SkThreadedBMPDevice::DrawQueue::accumulateTileStats() {
+    for (int row = 0; row < fDevice->fTileCnt; ++row) {
+        const SkWorkStealingTaskGroup2D::RowStats& rowStats = fTasks->rowStats(row);
+        TileStats& tileStats = fDevice->fTileStats[row];
+        tileStats.fBusyMs     += rowStats.fBusyMs;
+        tileStats.fIdleMs     += SkTMax(0.0, fTasks->elapsedMs() - rowStats.fBusyMs);
+        tileStats.fStolenRuns += rowStats.fStolenRuns;
+    }
+}
+
+void SkThreadedBMPDevice::DrawQueue::addCost(const SkIRect& drawBounds, float cost) {
+    SkIRect bounds = drawBounds;
+    if (!bounds.intersect(SkIRect::MakeWH(fDevice->width(), fDevice->height()))) {
+        return;
+    }
+    int binHeight = fDevice->costBinHeight();
+    int topBin    = bounds.fTop / binHeight;
+    int bottomBin = (bounds.fBottom - 1) / binHeight + 1;
+    SkASSERT(0 <= topBin && topBin < bottomBin && bottomBin <= COST_BIN_CNT);
+    float rowCost = cost * bounds.width();
+    fCostDeltas[topBin]    += rowCost;
+    fCostDeltas[bottomBin] -= rowCost;
+}
+
+void SkThreadedBMPDevice::DrawQueue::startTasks() {
+    if (fTasksStarted) {
+        return;
+    }
+
+    float binCosts[COST_BIN_CNT];
+    float rowCost = 0;
+    for (int i = 0; i < COST_BIN_CNT; ++i) {
+        rowCost += fCostDeltas[i];
+        binCosts[i] = SkTMax(rowCost, 0.0f); // float errors may leave a tiny negative cost
+        fCostDeltas[i] *= 0.5f; // keep half of the history for the next batch
+    }
+    fCostDeltas[COST_BIN_CNT] *= 0.5f;
+    fDevice->balanceTiles(binCosts, COST_BIN_CNT);
+
+    fTasks->start();
+    fTasksStarted = true;
+}
+
 void SkThreadedBMPDevice::DrawQueue::reset() {
     if (fTasks) {
+        this->startTasks(); // the queued elements may not have been started yet
         fTasks->finish();
+        this->accumulateTileStats();
     }
 
     fThreadAllocs.reset(fDevice->fThreadCnt);
     fSize = 0;
 
-    // using TaskGroup2D = SkSpinningTaskGroup2D;
-    using TaskGroup2D = SkFlexibleTaskGroup2D;
-
+    // The tasks are started by startTasks once the tiles are balanced.
     fTasks.reset(new TaskGroup2D(this, fDevice->fTileCnt, fDevice->fExecutor,
                                  fDevice->fThreadCnt));
-    fTasks->start();
+    fTasksStarted = false;
+}
+
+void SkThreadedBMPDevice::balanceTiles(const float binCosts[], int binCnt) {
+    float totalCost = 0;
+    for (int i = 0; i < binCnt; ++i) {
+        totalCost += binCosts[i];
+    }
+    const int w = this->width();
+    const int h = this->height();
+    if (totalCost <= 0 || fTileCnt > h) {
+        return; // nothing to balance; keep the current tiles
+    }
+
+    const int binHeight = this->costBinHeight();
+    int   top = 0;
+    int   bin = 0;
+    float costBeforeBin = 0; // total cost of the bins before bin
+    for (int tid = 0; tid < fTileCnt; ++tid) {
+        int bottom = h;
+        if (tid < fTileCnt - 1) {
+            float targetCost = totalCost * (tid + 1) / fTileCnt;
+            while (bin < binCnt && costBeforeBin + binCosts[bin] < targetCost) {
+                costBeforeBin += binCosts[bin++];
+            }
+            float binCost = bin < binCnt ? binCosts[bin] : 0;
+            float t = binCost > 0 ? (targetCost - costBeforeBin) / binCost : 0;
+            bottom = SkScalarRoundToInt((bin + t) * binHeight);
+            // Leave at least one row of pixels to this and each of the remaining tiles.
+            bottom = SkTPin(bottom, top + 1, h - (fTileCnt - 1 - tid));
+        }
+        fTileBounds[tid] = SkIRect::MakeLTRB(0, top, w, bottom);
+        top = bottom;
+    }
 }
 
 SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap,
@@ -62,6 +138,7 @@ SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap,
     for(int tid = 0; tid < fTileCnt; ++tid, top += h) {
         fTileBounds.push_back(SkIRect::MakeLTRB(0, top, w, top + h));
     }
+    fTileStats.reset(fTileCnt);
     fQueue.reset();
 }
 
@@ -154,12 +231,12 @@ void SkThreadedBMPDevice::drawPath(const SkPath& path, const SkPaint& paint,
     if (path.countVerbs() < 4 || paint.getMaskFilter()) {
         fQueue.push(drawBounds, [=](SkArenaAlloc*, const DrawState& ds, const SkIRect& tileBounds) {
             TileDraw(ds, tileBounds).drawPath(path, paint, prePathMatrix, false);
-        });
+        }, kPathCost);
     } else {
         fQueue.push(drawBounds, [=](SkArenaAlloc* alloc, DrawElement* elem) {
             SkInitOnceData data = {alloc, elem};
             elem->getDraw().drawPath(path, paint, prePathMatrix, false, false, nullptr, &data);
-        });
+        }, kPathCost);
     }
 }
 
@@ -188,7 +265,7 @@ void SkThreadedBMPDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& mat
     fQueue.push(drawBounds, [=](SkArenaAlloc*, const DrawState& ds, const SkIRect& tileBounds){
         SkBitmap local = snap; // bitmap is not thread safe; copy a local one.
         TileDraw(ds, tileBounds).drawBitmap(local, matrix, clonedDstOrNull, paint);
-    });
+    }, kBitmapCost);
 }
 
 void SkThreadedBMPDevice::drawBitmapRect(const SkBitmap& bitmap, const SkRect* src,
@@ -207,7 +284,7 @@ void SkThreadedBMPDevice::drawSprite(const SkBitmap& bitmap, int x, int y, const
                                        const SkIRect& tileBounds){
         SkBitmap local = snap; // bitmap is not thread safe; copy a local one.
         TileDraw(ds, tileBounds).drawSprite(local, x, y, paint);
-    });
+    }, kBitmapCost);
 }
 
 void SkThreadedBMPDevice::drawText(const void* text, size_t len, SkScalar x, SkScalar y,
@@ -217,7 +294,7 @@ void SkThreadedBMPDevice::drawText(const void* text, size_t len, SkScalar x, SkS
     SkSurfaceProps prop(SkBitmapDeviceFilteredSurfaceProps(fBitmap, paint, this->surfaceProps())());
     fQueue.push(drawBounds, [=](SkArenaAlloc*, const DrawState& ds, const SkIRect& tileBounds){
         TileDraw(ds, tileBounds).drawText(clonedText, len, x, y, paint, &prop);
-    });
+    }, kTextCost);
 }
 
 void SkThreadedBMPDevice::drawPosText(const void* text, size_t len, const SkScalar xpos[],
@@ -229,19 +306,30 @@ void SkThreadedBMPDevice::drawPosText(const void* text, size_t len, const SkScal
     fQueue.push(drawBounds, [=](SkArenaAlloc*, const DrawState& ds, const SkIRect& tileBounds){
         TileDraw(ds, tileBounds).drawPosText(clonedText, len, clonedXpos, scalarsPerPos, offset,
                                              paint, &prop);
-    });
+    }, kTextCost);
+}
+
+void SkThreadedBMPDevice::drawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
+                                       const SkPaint& paint, SkDrawFilter* drawFilter) {
+    // Skip SkBitmapDevice's blob cache, so each run goes through our threaded drawText()s.
+    this->SkBaseDevice::drawTextBlob(blob, x, y, paint, drawFilter);
 }
 
 void SkThreadedBMPDevice::drawVertices(const SkVertices* vertices, SkBlendMode bmode,
         const SkPaint& paint) {
     const sk_sp<SkVertices> verts = sk_ref_sp(vertices);  // retain vertices until flush
-    SkRect drawBounds = SkRectPriv::MakeLargest(); // TODO tighter drawBounds
+    // Filled triangles stay within their points' bounds, so each tile only draws the meshes that
+    // reach it, and SkDraw skips the triangles of a mesh that miss its tile. Hairlines, drawn
+    // when there's nothing to fill with, may reach a little beyond.
+    const bool filled = verts->hasColors() || (verts->hasTexCoords() && paint.getShader());
+    SkRect drawBounds = filled && !this->ctm().hasPerspective() ? verts->bounds()
+                                                                : SkRectPriv::MakeLargest();
     fQueue.push(drawBounds, [=](SkArenaAlloc*, const DrawState& ds, const SkIRect& tileBounds){
         TileDraw(ds, tileBounds).drawVertices(verts->mode(), verts->vertexCount(),
                                               verts->positions(), verts->texCoords(),
                                               verts->colors(), bmode, verts->indices(),
                                               verts->indexCount(), paint);
-    });
+    }, kVerticesCost);
 }
 
 sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapSpecial() {
@@ -22,6 +22,16 @@ public:
 
     ~SkThreadedBMPDevice() override { fQueue.finish(); }
 
+    struct TileStats {
+        double  fBusyMs     = 0; // time spent drawing this tile
+        double  fIdleMs     = 0; // time this tile had nothing to draw while other tiles were busy
+        int     fStolenRuns = 0; // how often this tile was drawn by a thread other than its owner
+    };
+
+    // The stats of each tile accumulated over all the flushes so far. Use them to tune the tile
+    // count: large idle times on most tiles mean that a few hot tiles are bounding the draw.
+    const SkTArray<TileStats>& tileStats() const { return fTileStats; }
+
 protected:
     void drawPaint(const SkPaint& paint) override;
     void drawPoints(SkCanvas::PointMode mode, size_t count,
@@ -37,6 +47,8 @@ protected:
                   const SkPaint&) override;
     void drawPosText(const void* text, size_t len, const SkScalar pos[],
                      int scalarsPerPos, const SkPoint& offset, const SkPaint& paint) override;
+    void drawTextBlob(const SkTextBlob*, SkScalar x, SkScalar y,
+                      const SkPaint& paint, SkDrawFilter* drawFilter) override;
     void drawVertices(const SkVertices*, SkBlendMode, const SkPaint&) override;
 
     void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
@@ -46,6 +58,8 @@ protected:
 
     sk_sp<SkSpecialImage> snapSpecial() override;
 
+    SkExecutor* imageFilterExecutor() const override { return fExecutor; }
+
     void flush() override;
 
 private:
@@ -125,30 +139,53 @@ private:
         SkIRect             fDrawBounds;
     };
 
+    // Rough per-pixel costs of the draw ops relative to a simple fill. They're only used to
+    // balance the tiles so they don't need to be precise.
+    static constexpr float kFillCost     = 1;
+    static constexpr float kPathCost     = 2;
+    static constexpr float kBitmapCost   = 2;
+    static constexpr float kTextCost     = 4;
+    static constexpr float kVerticesCost = 4;
+
     class DrawQueue : public SkWorkKernel2D {
     public:
         static constexpr int MAX_QUEUE_SIZE = 100000;
 
+        // We hold the threads back until this many elements are queued (or until a flush) so the
+        // tiles can be balanced by the cost of the queued elements before any tile starts drawing.
+        static constexpr int ADAPTIVE_WINDOW = 1024;
+
+        // The resolution (number of horizontal bands) at which we estimate the cost of draws.
+        static constexpr int COST_BIN_CNT = 256;
+
         DrawQueue(SkThreadedBMPDevice* device) : fDevice(device) {}
         void reset();
 
         // For ~SkThreadedBMPDevice() to shutdown tasks, we use this instead of reset because reset
         // will start new tasks.
-        void finish() { fTasks->finish(); }
+        void finish() {
+            this->startTasks();
+            fTasks->finish();
+        }
 
         // Push a draw command into the queue. If Fn is DrawFn, we're pushing an element without
         // the need of initialization. If Fn is InitFn, we're pushing an element with init-once
         // and the InitFn will generate the DrawFn during initialization.
         template<bool useCTM = true, typename Fn>
-        SK_ALWAYS_INLINE void push(const SkRect& rawDrawBounds, Fn&& fn) {
+        SK_ALWAYS_INLINE void push(const SkRect& rawDrawBounds, Fn&& fn,
+                                   float cost = kFillCost) {
             if (fSize == MAX_QUEUE_SIZE) {
                 this->reset();
             }
             SkASSERT(fSize < MAX_QUEUE_SIZE);
             SkIRect drawBounds = fDevice->transformDrawBounds<useCTM>(rawDrawBounds);
+            this->addCost(drawBounds, cost);
             fElements[fSize].~DrawElement(); // release previous resources to prevent memory leak
             new (&fElements[fSize++]) DrawElement(fDevice, std::move(fn), drawBounds);
             fTasks->addColumn();
+            if (fSize == ADAPTIVE_WINDOW) {
+                this->startTasks();
+            }
         }
 
         // SkWorkKernel2D
@@ -156,13 +193,35 @@ private:
         bool work2D(int row, int column, int thread) override;
 
     private:
+        using TaskGroup2D = SkWorkStealingTaskGroup2D;
+
+        // Add the stats of the finished fTasks to fDevice->fTileStats.
+        void accumulateTileStats();
+
+        // Spread cost * (area of drawBounds within the device) over the cost bins it covers.
+        // The bins store the differences of the per-row cost so this is O(1) per element.
+        void addCost(const SkIRect& drawBounds, float cost);
+
+        // Rebalance fDevice->fTileBounds with the costs queued so far, then start the threads.
+        void startTasks();
+
         SkThreadedBMPDevice*                fDevice;
-        std::unique_ptr<SkTaskGroup2D>      fTasks;
+        std::unique_ptr<TaskGroup2D>        fTasks;
+        bool                                fTasksStarted = false;
         SkTArray<SkSTArenaAlloc<8 << 10>>   fThreadAllocs; // 8k stack size
         DrawElement                         fElements[MAX_QUEUE_SIZE];
         int                                 fSize;
+        float                               fCostDeltas[COST_BIN_CNT + 1] = {};
     };
 
+    // Re-cut the horizontal tile stripes so that each tile gets about the same estimated cost:
+    // hot regions get split into thin tiles and cold regions get merged into tall ones.
+    void balanceTiles(const float binCosts[], int binCnt);
+
+    int costBinHeight() const {
+        return SkTMax(1, (this->height() + DrawQueue::COST_BIN_CNT - 1) / DrawQueue::COST_BIN_CNT);
+    }
+
     template<bool useCTM = true>
     SkIRect transformDrawBounds(const SkRect& drawBounds) const {
         if (drawBounds == SkRectPriv::MakeLargest()) {
@@ -191,6 +250,7 @@ private:
     const int fTileCnt;
     const int fThreadCnt;
     SkTArray<SkIRect> fTileBounds;
+    SkTArray<TileStats> fTileStats;
 
     /**
      * This can either be
@@ -31,7 +31,8 @@ void  SkScalerContextProxy::generateAdvance(SkGlyph* glyph) {
 }
 
 void SkScalerContextProxy::generateMetrics(SkGlyph* glyph) {
-    fClient->generateMetricsAndImage(*this->typefaceProxy(), this->getRec(), &fAlloc, glyph);
+    fClient->generateMetricsAndImage(*this->typefaceProxy(), this->getRec(), this->getEffects(),
+                                     &fAlloc, glyph);
 }
 
 void SkScalerContextProxy::generateImage(const SkGlyph& glyph) {
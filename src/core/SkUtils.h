@@ -26,6 +26,23 @@ static inline void sk_memset32(uint32_t buffer[], uint32_t value, int count) {
 static inline void sk_memset64(uint64_t buffer[], uint64_t value, int count) {
     SkOpts::memset64(buffer, value, count);
 }
+
+/** Like sk_memset16/32/64(), but fills a rectangle of height rows of count values each, starting
+    at buffer and rowBytes apart.  Fills too big to fit in cache skip it where possible, so
+    filling a large surface doesn't flush everything else out of the cache.
+*/
+static inline void sk_rect_memset16(uint16_t buffer[], uint16_t value, int count,
+                                    size_t rowBytes, int height) {
+    SkOpts::rect_memset16(buffer, value, count, rowBytes, height);
+}
+static inline void sk_rect_memset32(uint32_t buffer[], uint32_t value, int count,
+                                    size_t rowBytes, int height) {
+    SkOpts::rect_memset32(buffer, value, count, rowBytes, height);
+}
+static inline void sk_rect_memset64(uint64_t buffer[], uint64_t value, int count,
+                                    size_t rowBytes, int height) {
+    SkOpts::rect_memset64(buffer, value, count, rowBytes, height);
+}
 ///////////////////////////////////////////////////////////////////////////////
 
 #define kMaxBytesInUTF8Sequence     4
@@ -90,6 +90,9 @@ public:
         fWriter.reset(storage, storageSize);
     }
 
+    // Hint that about size bytes will be written in all.
+    void setReserve(size_t size) { fWriter.setReserve(size); }
+
     size_t bytesWritten() const { return fWriter.bytesWritten(); }
 
     // Returns true iff all of the bytes written so far are stored in the initial storage
@@ -124,6 +127,8 @@ public:
 
     bool writeToStream(SkWStream*);
     void writeToMemory(void* dst) { fWriter.flatten(dst); }
+    // Returns what's been written, usually without copying it, and resets to empty.
+    sk_sp<SkData> detachAsData() { return fWriter.detachAsData(); }
 
     SkFactorySet* setFactoryRecorder(SkFactorySet*);
     SkRefCntSet* setTypefaceRecorder(SkRefCntSet*);
@@ -71,9 +71,13 @@ size_t SkWriter32::WriteStringSize(const char* str, size_t len) {
 }
 
 void SkWriter32::growToAtLeast(size_t size) {
+    this->growTo(4096 + SkTMax(size, fCapacity + (fCapacity / 2)));
+}
+
+void SkWriter32::growTo(size_t capacity) {
     const bool wasExternal = (fExternal != nullptr) && (fData == fExternal);
 
-    fCapacity = 4096 + SkTMax(size, fCapacity + (fCapacity / 2));
+    fCapacity = capacity;
     fInternal.realloc(fCapacity);
     fData = fInternal.get();
 
@@ -86,3 +90,19 @@ void SkWriter32::growToAtLeast(size_t size) {
 sk_sp<SkData> SkWriter32::snapshotAsData() const {
     return SkData::MakeWithCopy(fData, fUsed);
 }
+
+sk_sp<SkData> SkWriter32::detachAsData() {
+    sk_sp<SkData> data;
+    if (fUsed == 0) {
+        data = SkData::MakeEmpty();
+    } else if (fData == fInternal.get()) {
+        // Trim off what we didn't use (which shouldn't need to move the rest), and hand it over.
+        fInternal.realloc(fUsed);
+        data = SkData::MakeFromMalloc(fInternal.release(), fUsed);
+    } else {
+        data = SkData::MakeWithCopy(fData, fUsed);
+    }
+    fInternal.reset();
+    this->reset();
+    return data;
+}
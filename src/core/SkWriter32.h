@@ -58,6 +58,16 @@ public:
         fExternal = external;
     }
 
+    /**
+     *  Hint that about size bytes will be written in all, so we can allocate them up front rather
+     *  than growing (and copying) as they're written.
+     */
+    void setReserve(size_t size) {
+        if (size > fCapacity) {
+            this->growTo(SkAlign4(size));
+        }
+    }
+
     // size MUST be multiple of 4
     uint32_t* reserve(size_t size) {
         SkASSERT(SkAlign4(size) == size);
@@ -248,8 +258,16 @@ public:
      *  Captures a snapshot of the data as it is right now, and return it.
      */
     sk_sp<SkData> snapshotAsData() const;
+
+    /**
+     *  Returns the data written so far, and resets to empty with no initial storage.  Unlike
+     *  snapshotAsData(), this hands over our storage rather than copying it, unless the data is
+     *  still in the initial storage.
+     */
+    sk_sp<SkData> detachAsData();
 private:
     void growToAtLeast(size_t size);
+    void growTo(size_t capacity);
 
     uint8_t* fData;                    // Points to either fInternal or fExternal.
     size_t fCapacity;                  // Number of bytes we can write to fData.
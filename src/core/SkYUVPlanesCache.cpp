@@ -48,6 +48,7 @@ struct YUVPlanesRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    bool canBeFoundConcurrently() const override { return true; }
     const char* getCategory() const override { return "yuv-planes"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fValue.fData->diagnostic_only_getDiscardable();
@@ -10,6 +10,7 @@
 #include "SkBitmap.h"
 #include "SkColorSpaceXformer.h"
 #include "SkImageFilterPriv.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
 #include "SkWriteBuffer.h"
@@ -69,31 +70,64 @@ static SkPMColor unpremul_pm(SkPMColor c) {
                                SkUnPreMultiply::ApplyScale(scale, SkGetPackedB32(c)));
 }
 
+// Unpremultiplies the channel at shift of four displacement pixels c, as unpremul_pm() does.
+static Sk4f unpremul_channel(const Sk4u& c, const Sk4u& unpremulScale, unsigned shift) {
+    Sk4u channel = (c >> shift) & 0xFF;
+    if (shift != SK_A32_SHIFT) {
+        // As SkUnPreMultiply::ApplyScale(). The scales of alpha 0 and 255 zero the channel and
+        // leave it as is, just as unpremul_pm() special-cases them.
+        channel = ((unpremulScale * channel + (1 << 23)) >> 24) & 0xFF;
+    }
+    return SkNx_cast<float>(channel);
+}
+
 void computeDisplacement(Extractor ex, const SkVector& scale, SkBitmap* dst,
                          const SkBitmap& displ, const SkIPoint& offset,
                          const SkBitmap& src,
-                         const SkIRect& bounds) {
+                         const SkIRect& bounds,
+                         SkExecutor* executor) {
     static const SkScalar Inv8bit = SkScalarInvert(255);
     const int srcW = src.width();
     const int srcH = src.height();
     const SkVector scaleForColor = SkVector::Make(scale.fX * Inv8bit, scale.fY * Inv8bit);
     const SkVector scaleAdj = SkVector::Make(SK_ScalarHalf - scale.fX * SK_ScalarHalf,
                                              SK_ScalarHalf - scale.fY * SK_ScalarHalf);
-    SkPMColor* dstPtr = dst->getAddr32(0, 0);
-    for (int y = bounds.top(); y < bounds.bottom(); ++y) {
-        const SkPMColor* displPtr = displ.getAddr32(bounds.left() + offset.fX, y + offset.fY);
-        for (int x = bounds.left(); x < bounds.right(); ++x, ++displPtr) {
-            SkPMColor c = unpremul_pm(*displPtr);
-
-            SkScalar displX = scaleForColor.fX * ex.getX(c) + scaleAdj.fX;
-            SkScalar displY = scaleForColor.fY * ex.getY(c) + scaleAdj.fY;
-            // Truncate the displacement values
-            const int32_t srcX = Sk32_sat_add(x, SkScalarTruncToInt(displX));
-            const int32_t srcY = Sk32_sat_add(y, SkScalarTruncToInt(displY));
-            *dstPtr++ = ((srcX < 0) || (srcX >= srcW) || (srcY < 0) || (srcY >= srcH)) ?
-                      0 : *(src.getAddr32(srcX, srcY));
+    auto fetch = [&](int x, int y, SkScalar displX, SkScalar displY) {
+        // Truncate the displacement values
+        const int32_t srcX = Sk32_sat_add(x, SkScalarTruncToInt(displX));
+        const int32_t srcY = Sk32_sat_add(y, SkScalarTruncToInt(displY));
+        return ((srcX < 0) || (srcX >= srcW) || (srcY < 0) || (srcY >= srcH)) ?
+               0 : *(src.getAddr32(srcX, srcY));
+    };
+    const SkUnPreMultiply::Scale* unpremulScales = SkUnPreMultiply::GetScaleTable();
+    SkImageFilterForEachBand(executor, bounds.height(), [&](int start, int end) {
+        for (int y = bounds.top() + start; y < bounds.top() + end; ++y) {
+            const SkPMColor* displPtr = displ.getAddr32(bounds.left() + offset.fX,
+                                                        y + offset.fY);
+            SkPMColor* dstPtr = dst->getAddr32(0, y - bounds.top());
+            int x = bounds.left();
+            // The displacements of four pixels are computed at once. Their fetches from src land
+            // anywhere, so those are still made one at a time.
+            for (; x + 4 <= bounds.right(); x += 4, displPtr += 4, dstPtr += 4) {
+                Sk4u c = Sk4u::Load(displPtr),
+                     a = c >> SK_A32_SHIFT;
+                Sk4u unpremulScale(unpremulScales[a[0]], unpremulScales[a[1]],
+                                   unpremulScales[a[2]], unpremulScales[a[3]]);
+                Sk4f displX = unpremul_channel(c, unpremulScale, ex.fShiftX) * scaleForColor.fX
+                            + scaleAdj.fX,
+                     displY = unpremul_channel(c, unpremulScale, ex.fShiftY) * scaleForColor.fY
+                            + scaleAdj.fY;
+                for (int i = 0; i < 4; ++i) {
+                    dstPtr[i] = fetch(x + i, y, displX[i], displY[i]);
+                }
+            }
+            for (; x < bounds.right(); ++x, ++displPtr) {
+                SkPMColor c = unpremul_pm(*displPtr);
+                *dstPtr++ = fetch(x, y, scaleForColor.fX * ex.getX(c) + scaleAdj.fX,
+                                        scaleForColor.fY * ex.getY(c) + scaleAdj.fY);
+            }
         }
-    }
+    });
 }
 
 bool channel_selector_type_is_valid(SkDisplacementMapEffect::ChannelSelectorType cst) {
@@ -242,7 +276,8 @@ sk_sp<SkSpecialImage> SkDisplacementMapEffect::onFilterImage(SkSpecialImage* sou
     // With a more complex DAG attached to this input, it's not clear that working in ANY specific
     // color space makes sense, so we ignore color spaces (and gamma) entirely. This may not be
     // ideal, but it's at least consistent and predictable.
-    Context displContext(ctx.ctm(), ctx.clipBounds(), ctx.cache(), OutputProperties(nullptr));
+    Context displContext(ctx.ctm(), ctx.clipBounds(), ctx.cache(), OutputProperties(nullptr),
+                         ctx.executor());
     sk_sp<SkSpecialImage> displ(this->filterInput(0, source, displContext, &displOffset));
     if (!displ) {
         return nullptr;
@@ -358,7 +393,8 @@ sk_sp<SkSpecialImage> SkDisplacementMapEffect::onFilterImage(SkSpecialImage* sou
     }
 
     computeDisplacement(Extractor(fXChannelSelector, fYChannelSelector), scale, &dst,
-                        displBM, colorOffset - displOffset, colorBM, colorBounds);
+                        displBM, colorOffset - displOffset, colorBM, colorBounds,
+                        ctx.executor());
 
     offset->fX = bounds.left();
     offset->fY = bounds.top();
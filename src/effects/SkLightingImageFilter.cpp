@@ -10,6 +10,7 @@
 #include "SkColorData.h"
 #include "SkColorSpaceXformer.h"
 #include "SkImageFilterPriv.h"
+#include "SkNx.h"
 #include "SkPoint3.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
@@ -58,16 +59,6 @@ static void setUniformNormal3(const GrGLSLProgramDataManager& pdman, UniformHand
 }
 #endif
 
-// Shift matrix components to the left, as we advance pixels to the right.
-static inline void shiftMatrixLeft(int m[9]) {
-    m[0] = m[1];
-    m[3] = m[4];
-    m[6] = m[7];
-    m[1] = m[2];
-    m[4] = m[5];
-    m[7] = m[8];
-}
-
 static inline void fast_normalize(SkPoint3* vector) {
     // add a tiny bit so we don't have to worry about divide-by-zero
     SkScalar magSq = vector->dot(*vector) + SK_ScalarNearlyZero;
@@ -77,6 +68,28 @@ static inline void fast_normalize(SkPoint3* vector) {
     vector->fZ *= scale;
 }
 
+// A point or vector for each of four pixels, one per lane, as the raster lighting loop works on.
+struct Point3x4 {
+    Sk4f fX, fY, fZ;
+
+    Sk4f dot(const Point3x4& other) const {
+        return fX * other.fX + fY * other.fY + fZ * other.fZ;
+    }
+};
+
+static inline void fast_normalize(Point3x4* vector) {
+    // add a tiny bit so we don't have to worry about divide-by-zero
+    Sk4f magSq = vector->dot(*vector) + SK_ScalarNearlyZero;
+    Sk4f scale = magSq.rsqrt();
+    vector->fX = vector->fX * scale;
+    vector->fY = vector->fY * scale;
+    vector->fZ = vector->fZ * scale;
+}
+
+static inline Point3x4 broadcast(const SkPoint3& point) {
+    return { Sk4f(point.fX), Sk4f(point.fY), Sk4f(point.fZ) };
+}
+
 static SkPoint3 read_point3(SkReadBuffer& buffer) {
     SkPoint3 point;
     point.fX = buffer.readScalar();
@@ -118,8 +131,11 @@ public:
     void flattenLight(SkWriteBuffer& buffer) const;
     static SkImageFilterLight* UnflattenLight(SkReadBuffer& buffer);
 
-    virtual SkPoint3 surfaceToLight(int x, int y, int z, SkScalar surfaceScale) const = 0;
-    virtual SkPoint3 lightColor(const SkPoint3& surfaceToLight) const = 0;
+    // Each subclass also has these, non-virtual, for the raster lighting loop, which is templated
+    // on the type of light. They take four pixels at once, at x, y and alpha z:
+    //   Point3x4 surfaceToLight(const Sk4f& x, const Sk4f& y, const Sk4f& z,
+    //                           SkScalar surfaceScale) const;
+    //   Point3x4 lightColor(const Point3x4& surfaceToLight) const;
 
 protected:
     SkImageFilterLight(SkColor color) {
@@ -141,53 +157,55 @@ private:
     SkPoint3 fColor;
 };
 
-class BaseLightingType {
-public:
-    BaseLightingType() {}
-    virtual ~BaseLightingType() {}
-
-    virtual SkPMColor light(const SkPoint3& normal, const SkPoint3& surfaceTolight,
-                            const SkPoint3& lightColor) const= 0;
-};
+// Rounds each lane, and clamps it to [0, 255].
+static inline Sk4i round_to_byte(const Sk4f& value) {
+    return SkNx_cast<int>(Sk4f::Max(Sk4f::Min((value + 0.5f).floor(), 255), 0));
+}
 
-class DiffuseLightingType : public BaseLightingType {
+class DiffuseLightingType {
 public:
     DiffuseLightingType(SkScalar kd)
         : fKD(kd) {}
-    SkPMColor light(const SkPoint3& normal, const SkPoint3& surfaceTolight,
-                    const SkPoint3& lightColor) const override {
-        SkScalar colorScale = fKD * normal.dot(surfaceTolight);
-        colorScale = SkScalarClampMax(colorScale, SK_Scalar1);
-        SkPoint3 color = lightColor.makeScale(colorScale);
-        return SkPackARGB32(255,
-                            SkClampMax(SkScalarRoundToInt(color.fX), 255),
-                            SkClampMax(SkScalarRoundToInt(color.fY), 255),
-                            SkClampMax(SkScalarRoundToInt(color.fZ), 255));
+    void light(const Point3x4& normal, const Point3x4& surfaceTolight,
+               const Point3x4& lightColor, SkPMColor dst[4]) const {
+        Sk4f colorScale = fKD * normal.dot(surfaceTolight);
+        colorScale = Sk4f::Max(Sk4f::Min(colorScale, SK_Scalar1), 0);
+        Sk4i r = round_to_byte(lightColor.fX * colorScale),
+             g = round_to_byte(lightColor.fY * colorScale),
+             b = round_to_byte(lightColor.fZ * colorScale);
+        for (int i = 0; i < 4; i++) {
+            dst[i] = SkPackARGB32(255, r[i], g[i], b[i]);
+        }
     }
 private:
     SkScalar fKD;
 };
 
-static SkScalar max_component(const SkPoint3& p) {
-    return p.x() > p.y() ? (p.x() > p.z() ? p.x() : p.z()) : (p.y() > p.z() ? p.y() : p.z());
-}
-
-class SpecularLightingType : public BaseLightingType {
+class SpecularLightingType {
 public:
     SpecularLightingType(SkScalar ks, SkScalar shininess)
         : fKS(ks), fShininess(shininess) {}
-    SkPMColor light(const SkPoint3& normal, const SkPoint3& surfaceTolight,
-                    const SkPoint3& lightColor) const override {
-        SkPoint3 halfDir(surfaceTolight);
-        halfDir.fZ += SK_Scalar1;        // eye position is always (0, 0, 1)
+    void light(const Point3x4& normal, const Point3x4& surfaceTolight,
+               const Point3x4& lightColor, SkPMColor dst[4]) const {
+        Point3x4 halfDir(surfaceTolight);
+        halfDir.fZ = halfDir.fZ + SK_Scalar1;        // eye position is always (0, 0, 1)
         fast_normalize(&halfDir);
-        SkScalar colorScale = fKS * SkScalarPow(normal.dot(halfDir), fShininess);
-        colorScale = SkScalarClampMax(colorScale, SK_Scalar1);
-        SkPoint3 color = lightColor.makeScale(colorScale);
-        return SkPackARGB32(SkClampMax(SkScalarRoundToInt(max_component(color)), 255),
-                            SkClampMax(SkScalarRoundToInt(color.fX), 255),
-                            SkClampMax(SkScalarRoundToInt(color.fY), 255),
-                            SkClampMax(SkScalarRoundToInt(color.fZ), 255));
+        Sk4f cosAngle = normal.dot(halfDir);
+        Sk4f colorScale = fKS * Sk4f(SkScalarPow(cosAngle[0], fShininess),
+                                     SkScalarPow(cosAngle[1], fShininess),
+                                     SkScalarPow(cosAngle[2], fShininess),
+                                     SkScalarPow(cosAngle[3], fShininess));
+        colorScale = Sk4f::Max(Sk4f::Min(colorScale, SK_Scalar1), 0);
+        Point3x4 color = { lightColor.fX * colorScale,
+                           lightColor.fY * colorScale,
+                           lightColor.fZ * colorScale };
+        Sk4i a = round_to_byte(Sk4f::Max(Sk4f::Max(color.fX, color.fY), color.fZ)),
+             r = round_to_byte(color.fX),
+             g = round_to_byte(color.fY),
+             b = round_to_byte(color.fZ);
+        for (int i = 0; i < 4; i++) {
+            dst[i] = SkPackARGB32(a[i], r[i], g[i], b[i]);
+        }
     }
 private:
     SkScalar fKS;
@@ -260,129 +278,113 @@ static inline SkPoint3 bottomRightNormal(int m[9], SkScalar surfaceScale) {
 }
 
 
-class UncheckedPixelFetcher {
-public:
-    static inline uint32_t Fetch(const SkBitmap& src, int x, int y, const SkIRect& bounds) {
-        return SkGetPackedA32(*src.getAddr32(x, y));
-    }
-};
+// Writes the normals of one row of an alpha plane that is width pixels wide, and at least two
+// pixels wide and high, to normals[]. above and below are the neighboring rows, or null at the
+// top and bottom. The pixels on the edges have normals of their own, and are computed one at a
+// time; the rest, four at a time.
+static void row_normals(const uint8_t* above, const uint8_t* row, const uint8_t* below,
+                        int width, SkScalar surfaceScale, SkPoint3 normals[]) {
+    auto normal = [&](int x) {
+        int m[9];
+        for (int dx = -1; dx <= 1; dx++) {
+            bool inside = 0 <= x + dx && x + dx < width;
+            m[dx + 1] = inside && above ? above[x + dx] : 0;
+            m[dx + 4] = inside          ? row[x + dx]   : 0;
+            m[dx + 7] = inside && below ? below[x + dx] : 0;
+        }
+        bool left = 0 == x, right = width - 1 == x;
+        if (!above) {
+            return left ? topLeftNormal(m, surfaceScale) : right ? topRightNormal(m, surfaceScale)
+                                                             : topNormal(m, surfaceScale);
+        }
+        if (!below) {
+            return left ? bottomLeftNormal(m, surfaceScale)
+                        : right ? bottomRightNormal(m, surfaceScale)
+                                : bottomNormal(m, surfaceScale);
+        }
+        return left ? leftNormal(m, surfaceScale) : right ? rightNormal(m, surfaceScale)
+                                                          : interiorNormal(m, surfaceScale);
+    };
 
-// The DecalPixelFetcher is used when the destination crop rect exceeds the input bitmap bounds.
-class DecalPixelFetcher {
-public:
-    static inline uint32_t Fetch(const SkBitmap& src, int x, int y, const SkIRect& bounds) {
-        if (x < bounds.fLeft || x >= bounds.fRight || y < bounds.fTop || y >= bounds.fBottom) {
-            return 0;
-        } else {
-            return SkGetPackedA32(*src.getAddr32(x, y));
+    normals[0] = normal(0);
+    int x = 1;
+    if (above && below) {
+        auto load = [](const uint8_t* p) { return SkNx_cast<float>(Sk4b::Load(p)); };
+        for (; x + 4 < width; x += 4) {
+            Sk4f m0 = load(above + x - 1), m1 = load(above + x), m2 = load(above + x + 1),
+                 m3 = load(row   + x - 1),                       m5 = load(row   + x + 1),
+                 m6 = load(below + x - 1), m7 = load(below + x), m8 = load(below + x + 1);
+            // As interiorNormal(), which computes the sobel sums in integers, exactly as here.
+            Sk4f sobelX = (m2 - m0 + (m5 - m3) * 2 + m8 - m6) * gOneQuarter,
+                 sobelY = (m6 - m0 + (m7 - m1) * 2 + m8 - m2) * gOneQuarter;
+            Point3x4 n = { sobelX * -surfaceScale, sobelY * -surfaceScale, Sk4f(1) };
+            fast_normalize(&n);
+            for (int i = 0; i < 4; i++) {
+                normals[x + i] = SkPoint3::Make(n.fX[i], n.fY[i], n.fZ[i]);
+            }
         }
     }
-};
+    for (; x < width; x++) {
+        normals[x] = normal(x);
+    }
+}
 
-template <class PixelFetcher>
-static void lightBitmap(const BaseLightingType& lightingType,
-                 const SkImageFilterLight* l,
-                 const SkBitmap& src,
-                 SkBitmap* dst,
-                 SkScalar surfaceScale,
-                 const SkIRect& bounds) {
+// Lights bounds of src into dst, four pixels at a time, with the lighting and light types known
+// at compile time. Pixels of bounds outside src are transparent. The alpha of bounds is copied
+// out first, so the normals need no bounds checks, and the rows are lit in bands on the
+// executor, if there is one.
+template <class LightingType, class LightType>
+static bool light_bitmap(const LightingType& lightingType, const LightType* light,
+                         const SkBitmap& src, SkBitmap* dst, SkScalar surfaceScale,
+                         const SkIRect& bounds, SkExecutor* executor) {
     SkASSERT(dst->width() == bounds.width() && dst->height() == bounds.height());
-    int left = bounds.left(), right = bounds.right();
-    int bottom = bounds.bottom();
-    int y = bounds.top();
-    SkIRect srcBounds = src.bounds();
-    SkPMColor* dptr = dst->getAddr32(0, 0);
-    {
-        int x = left;
-        int m[9];
-        m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-        m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
-        m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topLeftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x)
-        {
-            shiftMatrixLeft(m);
-            m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-            m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(topNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
+    const int width = bounds.width(), height = bounds.height();
+    SkAutoTMalloc<uint8_t> alpha;
+    if (!alpha.reset(SkToSizeT(width) * height)) {
+        return false;
+    }
+    for (int y = 0; y < height; y++) {
+        uint8_t* alphaRow = alpha.get() + y * width;
+        for (int x = 0; x < width; x++) {
+            int srcX = bounds.left() + x, srcY = bounds.top() + y;
+            alphaRow[x] = src.bounds().contains(srcX, srcY)
+                        ? SkGetPackedA32(*src.getAddr32(srcX, srcY)) : 0;
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topRightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
     }
 
-    for (++y; y < bottom - 1; ++y) {
-        int x = left;
-        int m[9];
-        m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
-        m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
-        m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-        m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
-        m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x) {
-            shiftMatrixLeft(m);
-            m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
-            m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-            m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
+    // Lighting a partial group of four reads normals up to the next multiple of four.
+    const int paddedWidth = SkAlign4(width);
+    SkImageFilterForEachBand(executor, height, [&](int start, int end) {
+        SkAutoTMalloc<SkPoint3> normals(paddedWidth);
+        for (int x = width; x < paddedWidth; x++) {
+            normals[x] = SkPoint3::Make(0, 0, 1);
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-    }
-
-    {
-        int x = left;
-        int m[9];
-        m[1] = PixelFetcher::Fetch(src, x,     bottom - 2, srcBounds);
-        m[2] = PixelFetcher::Fetch(src, x + 1, bottom - 2, srcBounds);
-        m[4] = PixelFetcher::Fetch(src, x,     bottom - 1, srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, bottom - 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomLeftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x)
-        {
-            shiftMatrixLeft(m);
-            m[2] = PixelFetcher::Fetch(src, x + 1, bottom - 2, srcBounds);
-            m[5] = PixelFetcher::Fetch(src, x + 1, bottom - 1, srcBounds);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(bottomNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
+        for (int y = start; y < end; y++) {
+            const uint8_t* row = alpha.get() + y * width;
+            row_normals(y > 0 ? row - width : nullptr, row,
+                        y < height - 1 ? row + width : nullptr,
+                        width, surfaceScale, normals.get());
+
+            SkPMColor* dptr = dst->getAddr32(0, y);
+            for (int x = 0; x < width; x += 4) {
+                float nx[4], ny[4], nz[4], z[4];
+                for (int i = 0; i < 4; i++) {
+                    nx[i] = normals[x + i].fX;
+                    ny[i] = normals[x + i].fY;
+                    nz[i] = normals[x + i].fZ;
+                    z[i] = x + i < width ? row[x + i] : 0;
+                }
+                Point3x4 normal = { Sk4f::Load(nx), Sk4f::Load(ny), Sk4f::Load(nz) };
+                Point3x4 surfaceToLight = light->surfaceToLight(
+                        Sk4f(bounds.left() + x) + Sk4f(0, 1, 2, 3),
+                        Sk4f(SkIntToScalar(bounds.top() + y)), Sk4f::Load(z), surfaceScale);
+                SkPMColor lit[4];
+                lightingType.light(normal, surfaceToLight, light->lightColor(surfaceToLight), lit);
+                memcpy(dptr + x, lit, SkTMin(4, width - x) * sizeof(SkPMColor));
+            }
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomRightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-    }
-}
-
-static void lightBitmap(const BaseLightingType& lightingType,
-                 const SkImageFilterLight* light,
-                 const SkBitmap& src,
-                 SkBitmap* dst,
-                 SkScalar surfaceScale,
-                 const SkIRect& bounds) {
-    if (src.bounds().contains(bounds)) {
-        lightBitmap<UncheckedPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
-    } else {
-        lightBitmap<DecalPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
-    }
+    });
+    return true;
 }
 
 enum BoundaryMode {
@@ -836,10 +838,10 @@ public:
       : INHERITED(color), fDirection(direction) {
     }
 
-    SkPoint3 surfaceToLight(int x, int y, int z, SkScalar surfaceScale) const override {
-        return fDirection;
+    Point3x4 surfaceToLight(const Sk4f&, const Sk4f&, const Sk4f&, SkScalar) const {
+        return broadcast(fDirection);
     }
-    SkPoint3 lightColor(const SkPoint3&) const override { return this->color(); }
+    Point3x4 lightColor(const Point3x4&) const { return broadcast(this->color()); }
     LightType type() const override { return kDistant_LightType; }
     const SkPoint3& direction() const { return fDirection; }
     GrGLLight* createGLLight() const override {
@@ -893,14 +895,15 @@ public:
     SkPointLight(const SkPoint3& location, SkColor color)
      : INHERITED(color), fLocation(location) {}
 
-    SkPoint3 surfaceToLight(int x, int y, int z, SkScalar surfaceScale) const override {
-        SkPoint3 direction = SkPoint3::Make(fLocation.fX - SkIntToScalar(x),
-                                            fLocation.fY - SkIntToScalar(y),
-                                            fLocation.fZ - SkIntToScalar(z) * surfaceScale);
+    Point3x4 surfaceToLight(const Sk4f& x, const Sk4f& y, const Sk4f& z,
+                            SkScalar surfaceScale) const {
+        Point3x4 direction = { fLocation.fX - x,
+                               fLocation.fY - y,
+                               fLocation.fZ - z * surfaceScale };
         fast_normalize(&direction);
         return direction;
     }
-    SkPoint3 lightColor(const SkPoint3&) const override { return this->color(); }
+    Point3x4 lightColor(const Point3x4&) const { return broadcast(this->color()); }
     LightType type() const override { return kPoint_LightType; }
     const SkPoint3& location() const { return fLocation; }
     GrGLLight* createGLLight() const override {
@@ -1007,23 +1010,29 @@ public:
                                color());
     }
 
-    SkPoint3 surfaceToLight(int x, int y, int z, SkScalar surfaceScale) const override {
-        SkPoint3 direction = SkPoint3::Make(fLocation.fX - SkIntToScalar(x),
-                                            fLocation.fY - SkIntToScalar(y),
-                                            fLocation.fZ - SkIntToScalar(z) * surfaceScale);
+    Point3x4 surfaceToLight(const Sk4f& x, const Sk4f& y, const Sk4f& z,
+                            SkScalar surfaceScale) const {
+        Point3x4 direction = { fLocation.fX - x,
+                               fLocation.fY - y,
+                               fLocation.fZ - z * surfaceScale };
         fast_normalize(&direction);
         return direction;
     }
-    SkPoint3 lightColor(const SkPoint3& surfaceToLight) const override {
-        SkScalar cosAngle = -surfaceToLight.dot(fS);
-        SkScalar scale = 0;
-        if (cosAngle >= fCosOuterConeAngle) {
-            scale = SkScalarPow(cosAngle, fSpecularExponent);
-            if (cosAngle < fCosInnerConeAngle) {
-                scale *= (cosAngle - fCosOuterConeAngle) * fConeScale;
+    Point3x4 lightColor(const Point3x4& surfaceToLight) const {
+        Sk4f cosAngles = Sk4f(0) - surfaceToLight.dot(broadcast(fS));
+        SkScalar scales[4];
+        for (int i = 0; i < 4; i++) {
+            SkScalar cosAngle = cosAngles[i];
+            scales[i] = 0;
+            if (cosAngle >= fCosOuterConeAngle) {
+                scales[i] = SkScalarPow(cosAngle, fSpecularExponent);
+                if (cosAngle < fCosInnerConeAngle) {
+                    scales[i] *= (cosAngle - fCosOuterConeAngle) * fConeScale;
+                }
             }
         }
-        return this->color().makeScale(scale);
+        Sk4f scale = Sk4f::Load(scales);
+        return { this->color().fX * scale, this->color().fY * scale, this->color().fZ * scale };
     }
     GrGLLight* createGLLight() const override {
 #if SK_SUPPORT_GPU
@@ -1118,6 +1127,26 @@ private:
 const SkScalar SkSpotLight::kSpecularExponentMin = 1.0f;
 const SkScalar SkSpotLight::kSpecularExponentMax = 128.0f;
 
+// Lights src with the concrete type of light, so light_bitmap() inlines its calls.
+template <class LightingType>
+static bool lightBitmap(const LightingType& lightingType, const SkImageFilterLight* light,
+                         const SkBitmap& src, SkBitmap* dst, SkScalar surfaceScale,
+                         const SkIRect& bounds, SkExecutor* executor) {
+    switch (light->type()) {
+        case SkImageFilterLight::kDistant_LightType:
+            return light_bitmap(lightingType, static_cast<const SkDistantLight*>(light),
+                                src, dst, surfaceScale, bounds, executor);
+        case SkImageFilterLight::kPoint_LightType:
+            return light_bitmap(lightingType, static_cast<const SkPointLight*>(light),
+                                src, dst, surfaceScale, bounds, executor);
+        case SkImageFilterLight::kSpot_LightType:
+            return light_bitmap(lightingType, static_cast<const SkSpotLight*>(light),
+                                src, dst, surfaceScale, bounds, executor);
+    }
+    SkASSERT(false);
+    return false;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkImageFilterLight::flattenLight(SkWriteBuffer& buffer) const {
@@ -1348,12 +1377,10 @@ sk_sp<SkSpecialImage> SkDiffuseLightingImageFilter::onFilterImage(SkSpecialImage
     sk_sp<SkImageFilterLight> transformedLight(light()->transform(matrix));
 
     DiffuseLightingType lightingType(fKD);
-    lightBitmap(lightingType,
-                                                             transformedLight.get(),
-                                                             inputBM,
-                                                             &dst,
-                                                             surfaceScale(),
-                                                             bounds);
+    if (!lightBitmap(lightingType, transformedLight.get(), inputBM, &dst, surfaceScale(), bounds,
+                     ctx.executor())) {
+        return nullptr;
+    }
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(bounds.width(), bounds.height()),
                                           dst);
@@ -1502,12 +1529,10 @@ sk_sp<SkSpecialImage> SkSpecularLightingImageFilter::onFilterImage(SkSpecialImag
 
     sk_sp<SkImageFilterLight> transformedLight(light()->transform(matrix));
 
-    lightBitmap(lightingType,
-                                                              transformedLight.get(),
-                                                              inputBM,
-                                                              &dst,
-                                                              surfaceScale(),
-                                                              bounds);
+    if (!lightBitmap(lightingType, transformedLight.get(), inputBM, &dst, surfaceScale(), bounds,
+                     ctx.executor())) {
+        return nullptr;
+    }
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(bounds.width(), bounds.height()), dst);
 }
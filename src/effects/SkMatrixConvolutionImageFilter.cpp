@@ -10,6 +10,7 @@
 #include "SkColorData.h"
 #include "SkColorSpaceXformer.h"
 #include "SkImageFilterPriv.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
 #include "SkWriteBuffer.h"
@@ -175,36 +176,33 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
     if (!rect.intersect(bounds)) {
         return;
     }
+    // The channels are summed together, in the lanes of an Sk4f, in the order they're stored.
+    constexpr int kA = SK_A32_SHIFT / 8;
     for (int y = rect.fTop; y < rect.fBottom; ++y) {
         SkPMColor* dptr = result->getAddr32(rect.fLeft - bounds.fLeft, y - bounds.fTop);
         for (int x = rect.fLeft; x < rect.fRight; ++x) {
-            SkScalar sumA = 0, sumR = 0, sumG = 0, sumB = 0;
+            Sk4f sum(0);
             for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
                 for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
                     SkPMColor s = PixelFetcher::fetch(src,
                                                       x + cx - fKernelOffset.fX,
                                                       y + cy - fKernelOffset.fY,
                                                       bounds);
-                    SkScalar k = fKernel[cy * fKernelSize.fWidth + cx];
-                    if (convolveAlpha) {
-                        sumA += SkGetPackedA32(s) * k;
-                    }
-                    sumR += SkGetPackedR32(s) * k;
-                    sumG += SkGetPackedG32(s) * k;
-                    sumB += SkGetPackedB32(s) * k;
+                    sum = sum + SkNx_cast<float>(Sk4b::Load(&s))
+                              * fKernel[cy * fKernelSize.fWidth + cx];
                 }
             }
-            int a = convolveAlpha
-                  ? SkClampMax(SkScalarFloorToInt(sumA * fGain + fBias), 255)
-                  : 255;
-            int r = SkClampMax(SkScalarFloorToInt(sumR * fGain + fBias), a);
-            int g = SkClampMax(SkScalarFloorToInt(sumG * fGain + fBias), a);
-            int b = SkClampMax(SkScalarFloorToInt(sumB * fGain + fBias), a);
+            Sk4f value = (sum * fGain + fBias).floor();
+            float a = convolveAlpha ? SkTPin(value[kA], 0.0f, 255.0f) : 255.0f;
+            SkPMColor clamped;
+            SkNx_cast<uint8_t>(Sk4f::Min(Sk4f::Max(value, 0), a)).store(&clamped);
             if (!convolveAlpha) {
-                a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
-                *dptr++ = SkPreMultiplyARGB(a, r, g, b);
+                *dptr++ = SkPreMultiplyARGB(SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds)),
+                                            SkGetPackedR32(clamped),
+                                            SkGetPackedG32(clamped),
+                                            SkGetPackedB32(clamped));
             } else {
-                *dptr++ = SkPackARGB32(a, r, g, b);
+                *dptr++ = clamped;
             }
         }
     }
@@ -377,11 +375,19 @@ sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilter::onFilterImage(SkSpecialIma
                                      interior.left(), interior.bottom());
     SkIRect right = SkIRect::MakeLTRB(interior.right(), interior.top(),
                                       bounds.right(), interior.bottom());
-    this->filterBorderPixels(inputBM, &dst, top, bounds);
-    this->filterBorderPixels(inputBM, &dst, left, bounds);
-    this->filterInteriorPixels(inputBM, &dst, interior, bounds);
-    this->filterBorderPixels(inputBM, &dst, right, bounds);
-    this->filterBorderPixels(inputBM, &dst, bottom, bounds);
+    // Each band of rows filters its part of the border and of the interior.
+    SkImageFilterForEachBand(ctx.executor(), bounds.height(), [&](int start, int end) {
+        auto band = [&](SkIRect rect) {
+            rect.fTop = SkTMax(rect.fTop, bounds.fTop + start);
+            rect.fBottom = SkTMin(rect.fBottom, bounds.fTop + end);
+            return rect;
+        };
+        this->filterBorderPixels(inputBM, &dst, band(top), bounds);
+        this->filterBorderPixels(inputBM, &dst, band(left), bounds);
+        this->filterInteriorPixels(inputBM, &dst, band(interior), bounds);
+        this->filterBorderPixels(inputBM, &dst, band(right), bounds);
+        this->filterBorderPixels(inputBM, &dst, band(bottom), bounds);
+    });
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(bounds.width(), bounds.height()),
                                           dst);
 }
@@ -8,6 +8,7 @@
 #include "SkMergeImageFilter.h"
 
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
 #include "SkColorSpaceXformer.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
@@ -40,11 +41,13 @@ sk_sp<SkSpecialImage> SkMergeImageFilter::onFilterImage(SkSpecialImage* source,
 
     std::unique_ptr<sk_sp<SkSpecialImage>[]> inputs(new sk_sp<SkSpecialImage>[inputCount]);
     std::unique_ptr<SkIPoint[]> offsets(new SkIPoint[inputCount]);
+    std::unique_ptr<sk_sp<SkColorFilter>[]> colorFilters(new sk_sp<SkColorFilter>[inputCount]);
 
-    // Filter all of the inputs.
+    // Filter all of the inputs. Color filter inputs are applied as they are composited.
     for (int i = 0; i < inputCount; ++i) {
         offsets[i] = { 0, 0 };
-        inputs[i] = this->filterInput(i, source, ctx, &offsets[i]);
+        inputs[i] = this->filterInputFusingColorFilter(i, source, ctx, &offsets[i],
+                                                       &colorFilters[i]);
         if (!inputs[i]) {
             continue;
         }
@@ -84,9 +87,11 @@ sk_sp<SkSpecialImage> SkMergeImageFilter::onFilterImage(SkSpecialImage* source,
             continue;
         }
 
+        SkPaint paint;
+        paint.setColorFilter(std::move(colorFilters[i]));
         inputs[i]->draw(canvas,
                         SkIntToScalar(offsets[i].x() - x0), SkIntToScalar(offsets[i].y() - y0),
-                        nullptr);
+                        &paint);
     }
 
     offset->fX = bounds.left();
@@ -69,20 +69,26 @@ void SkMorphologyImageFilter::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fRadius.fHeight);
 }
 
+// The rows are independent, so they're split into bands.
 static void call_proc_X(SkMorphologyImageFilter::Proc procX,
                         const SkBitmap& src, SkBitmap* dst,
-                        int radiusX, const SkIRect& bounds) {
-    procX(src.getAddr32(bounds.left(), bounds.top()), dst->getAddr32(0, 0),
-          radiusX, bounds.width(), bounds.height(),
-          src.rowBytesAsPixels(), dst->rowBytesAsPixels());
+                        int radiusX, const SkIRect& bounds, SkExecutor* executor) {
+    SkImageFilterForEachBand(executor, bounds.height(), [&](int start, int end) {
+        procX(src.getAddr32(bounds.left(), bounds.top() + start), dst->getAddr32(0, start),
+              radiusX, bounds.width(), end - start,
+              src.rowBytesAsPixels(), dst->rowBytesAsPixels());
+    });
 }
 
+// The columns are independent, so they're split into bands.
 static void call_proc_Y(SkMorphologyImageFilter::Proc procY,
                         const SkPMColor* src, int srcRowBytesAsPixels, SkBitmap* dst,
-                        int radiusY, const SkIRect& bounds) {
-    procY(src, dst->getAddr32(0, 0),
-          radiusY, bounds.height(), bounds.width(),
-          srcRowBytesAsPixels, dst->rowBytesAsPixels());
+                        int radiusY, const SkIRect& bounds, SkExecutor* executor) {
+    SkImageFilterForEachBand(executor, bounds.width(), [&](int start, int end) {
+        procY(src + start, dst->getAddr32(start, 0),
+              radiusY, bounds.height(), end - start,
+              srcRowBytesAsPixels, dst->rowBytesAsPixels());
+    });
 }
 
 SkRect SkMorphologyImageFilter::computeFastBounds(const SkRect& src) const {
@@ -624,18 +630,18 @@ sk_sp<SkSpecialImage> SkMorphologyImageFilter::onFilterImage(SkSpecialImage* sou
             return nullptr;
         }
 
-        call_proc_X(procX, inputBM, &tmp, width, srcBounds);
+        call_proc_X(procX, inputBM, &tmp, width, srcBounds, ctx.executor());
         SkIRect tmpBounds = SkIRect::MakeWH(srcBounds.width(), srcBounds.height());
         call_proc_Y(procY,
                     tmp.getAddr32(tmpBounds.left(), tmpBounds.top()), tmp.rowBytesAsPixels(),
-                    &dst, height, tmpBounds);
+                    &dst, height, tmpBounds, ctx.executor());
     } else if (width > 0) {
-        call_proc_X(procX, inputBM, &dst, width, srcBounds);
+        call_proc_X(procX, inputBM, &dst, width, srcBounds, ctx.executor());
     } else if (height > 0) {
         call_proc_Y(procY,
                     inputBM.getAddr32(srcBounds.left(), srcBounds.top()),
                     inputBM.rowBytesAsPixels(),
-                    &dst, height, srcBounds);
+                    &dst, height, srcBounds, ctx.executor());
     }
     offset->fX = bounds.left();
     offset->fY = bounds.top();
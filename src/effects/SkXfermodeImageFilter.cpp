@@ -9,6 +9,7 @@
 #include "SkArithmeticImageFilter.h"
 #include "SkCanvas.h"
 #include "SkColorData.h"
+#include "SkColorFilter.h"
 #include "SkColorSpaceXformer.h"
 #include "SkImageFilterPriv.h"
 #include "SkReadBuffer.h"
@@ -48,15 +49,18 @@ protected:
     sk_sp<SkSpecialImage> filterImageGPU(SkSpecialImage* source,
                                          sk_sp<SkSpecialImage> background,
                                          const SkIPoint& backgroundOffset,
+                                         sk_sp<SkColorFilter> backgroundColorFilter,
                                          sk_sp<SkSpecialImage> foreground,
                                          const SkIPoint& foregroundOffset,
+                                         sk_sp<SkColorFilter> foregroundColorFilter,
                                          const SkIRect& bounds,
                                          const OutputProperties& outputProperties) const;
 #endif
 
     void flatten(SkWriteBuffer&) const override;
 
-    void drawForeground(SkCanvas* canvas, SkSpecialImage*, const SkIRect&) const;
+    void drawForeground(SkCanvas* canvas, SkSpecialImage*, const SkIRect&,
+                        sk_sp<SkColorFilter>) const;
 #if SK_SUPPORT_GPU
     std::unique_ptr<GrFragmentProcessor> makeFGFrag(
             std::unique_ptr<GrFragmentProcessor> bgFP) const;
@@ -113,11 +117,19 @@ void SkXfermodeImageFilter_Base::flatten(SkWriteBuffer& buffer) const {
 sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::onFilterImage(SkSpecialImage* source,
                                                            const Context& ctx,
                                                            SkIPoint* offset) const {
+    // Color filter inputs are applied as their images are blended, rather than each making an
+    // image of its own.
     SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, source, ctx, &backgroundOffset));
+    sk_sp<SkColorFilter> backgroundCF;
+    sk_sp<SkSpecialImage> background(this->filterInputFusingColorFilter(0, source, ctx,
+                                                                        &backgroundOffset,
+                                                                        &backgroundCF));
 
     SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, source, ctx, &foregroundOffset));
+    sk_sp<SkColorFilter> foregroundCF;
+    sk_sp<SkSpecialImage> foreground(this->filterInputFusingColorFilter(1, source, ctx,
+                                                                        &foregroundOffset,
+                                                                        &foregroundCF));
 
     SkIRect foregroundBounds = SkIRect::EmptyIRect();
     if (foreground) {
@@ -147,8 +159,8 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::onFilterImage(SkSpecialImage*
 #if SK_SUPPORT_GPU
     if (source->isTextureBacked()) {
         return this->filterImageGPU(source,
-                                    background, backgroundOffset,
-                                    foreground, foregroundOffset,
+                                    background, backgroundOffset, std::move(backgroundCF),
+                                    foreground, foregroundOffset, std::move(foregroundCF),
                                     bounds, ctx.outputProperties());
     }
 #endif
@@ -167,12 +179,13 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::onFilterImage(SkSpecialImage*
     if (background) {
         SkPaint paint;
         paint.setBlendMode(SkBlendMode::kSrc);
+        paint.setColorFilter(std::move(backgroundCF));
         background->draw(canvas,
                          SkIntToScalar(backgroundOffset.fX), SkIntToScalar(backgroundOffset.fY),
                          &paint);
     }
 
-    this->drawForeground(canvas, foreground.get(), foregroundBounds);
+    this->drawForeground(canvas, foreground.get(), foregroundBounds, std::move(foregroundCF));
 
     return surf->makeImageSnapshot();
 }
@@ -233,11 +246,14 @@ const {
 }
 
 void SkXfermodeImageFilter_Base::drawForeground(SkCanvas* canvas, SkSpecialImage* img,
-                                                const SkIRect& fgBounds) const {
+                                                const SkIRect& fgBounds,
+                                                sk_sp<SkColorFilter> colorFilter) const {
     SkPaint paint;
     paint.setBlendMode(fMode);
     if (img) {
+        paint.setColorFilter(std::move(colorFilter));
         img->draw(canvas, SkIntToScalar(fgBounds.fLeft), SkIntToScalar(fgBounds.fTop), &paint);
+        paint.setColorFilter(nullptr);
     }
 
     SkAutoCanvasRestore acr(canvas, true);
@@ -266,18 +282,65 @@ void SkXfermodeImageFilter_Base::toString(SkString* str) const {
 
 #include "effects/GrXfermodeFragmentProcessor.h"
 
+// Returns the processor for the color filter, or null if there is none. If the color filter has no
+// processor, it is applied to the image, drawing a new one.
+static std::unique_ptr<GrFragmentProcessor> color_filter_fp(
+        SkSpecialImage* source, sk_sp<SkSpecialImage>* image, sk_sp<SkColorFilter> colorFilter,
+        const SkImageFilter::OutputProperties& outputProperties) {
+    if (!*image || !colorFilter) {
+        return nullptr;
+    }
+    SkColorSpace* colorSpace = outputProperties.colorSpace();
+    GrColorSpaceInfo dstColorSpaceInfo(sk_ref_sp(colorSpace),
+                                       GrRenderableConfigForColorSpace(colorSpace));
+    auto fp = colorFilter->asFragmentProcessor(source->getContext(), dstColorSpaceInfo);
+    if (fp) {
+        return fp;
+    }
+
+    sk_sp<SkSpecialSurface> surf(source->makeSurface(outputProperties, (*image)->subset().size()));
+    if (!surf) {
+        image->reset();
+        return nullptr;
+    }
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    paint.setColorFilter(std::move(colorFilter));
+    (*image)->draw(surf->getCanvas(), 0, 0, &paint);
+    *image = surf->makeImageSnapshot();
+    return nullptr;
+}
+
+// Runs fp, then colorFilterFP on its output, if there is one.
+static std::unique_ptr<GrFragmentProcessor> then_color_filter(
+        std::unique_ptr<GrFragmentProcessor> fp,
+        std::unique_ptr<GrFragmentProcessor> colorFilterFP) {
+    if (!colorFilterFP) {
+        return fp;
+    }
+    std::unique_ptr<GrFragmentProcessor> series[] = { std::move(fp), std::move(colorFilterFP) };
+    return GrFragmentProcessor::RunInSeries(series, SK_ARRAY_COUNT(series));
+}
+
 sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::filterImageGPU(
                                                    SkSpecialImage* source,
                                                    sk_sp<SkSpecialImage> background,
                                                    const SkIPoint& backgroundOffset,
+                                                   sk_sp<SkColorFilter> backgroundColorFilter,
                                                    sk_sp<SkSpecialImage> foreground,
                                                    const SkIPoint& foregroundOffset,
+                                                   sk_sp<SkColorFilter> foregroundColorFilter,
                                                    const SkIRect& bounds,
                                                    const OutputProperties& outputProperties) const {
     SkASSERT(source->isTextureBacked());
 
     GrContext* context = source->getContext();
 
+    auto bgColorFilterFP = color_filter_fp(source, &background, std::move(backgroundColorFilter),
+                                           outputProperties);
+    auto fgColorFilterFP = color_filter_fp(source, &foreground, std::move(foregroundColorFilter),
+                                           outputProperties);
+
     sk_sp<GrTextureProxy> backgroundProxy, foregroundProxy;
 
     if (background) {
@@ -301,6 +364,7 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::filterImageGPU(
                                            GrSamplerState::Filter::kNearest);
         bgFP = GrColorSpaceXformEffect::Make(std::move(bgFP), background->getColorSpace(),
                                              bgConfig, outputProperties.colorSpace());
+        bgFP = then_color_filter(std::move(bgFP), std::move(bgColorFilterFP));
     } else {
         bgFP = GrConstColorProcessor::Make(GrColor4f::TransparentBlack(),
                                            GrConstColorProcessor::InputMode::kIgnore);
@@ -317,6 +381,7 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::filterImageGPU(
         foregroundFP = GrColorSpaceXformEffect::Make(std::move(foregroundFP),
                                                      foreground->getColorSpace(), fgConfig,
                                                      outputProperties.colorSpace());
+        foregroundFP = then_color_filter(std::move(foregroundFP), std::move(fgColorFilterFP));
         paint.addColorFragmentProcessor(std::move(foregroundFP));
 
         std::unique_ptr<GrFragmentProcessor> xferFP = this->makeFGFrag(std::move(bgFP));
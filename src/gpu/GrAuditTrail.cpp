@@ -125,8 +125,26 @@ void GrAuditTrail::getBoundsByOpListID(OpInfo* outInfo, int opListID) {
     this->copyOutFromOpList(outInfo, opListID);
 }
 
+void GrAuditTrail::combineAttempted(CombineOutcome outcome) {
+    fCombineStats.fAttempts++;
+    switch (outcome) {
+        case CombineOutcome::kCombined:         fCombineStats.fCombined++;         break;
+        case CombineOutcome::kDifferentClass:   fCombineStats.fDifferentClass++;   break;
+        case CombineOutcome::kPipelineMismatch: fCombineStats.fPipelineMismatch++; break;
+        case CombineOutcome::kOpRefused:        fCombineStats.fOpRefused++;        break;
+    }
+}
+
+void GrAuditTrail::combineSearchEnded(CombineSearchEnd end) {
+    switch (end) {
+        case CombineSearchEnd::kOverlap: fCombineStats.fStoppedAtOverlap++; break;
+        case CombineSearchEnd::kLimit:   fCombineStats.fStoppedAtLimit++;   break;
+    }
+}
+
 void GrAuditTrail::fullReset() {
     SkASSERT(fEnabled);
+    fCombineStats = CombineStats();
     fOpList.reset();
     fIDLookup.reset();
     // free all client ops
@@ -227,6 +245,18 @@ SkString GrAuditTrail::toJson(bool prettyPrint) const {
     SkString json;
     json.append("{");
     JsonifyTArray(&json, "Ops", fOpList, false);
+    if (fOpList.count()) {
+        json.append(",");
+    }
+    json.append("\"CombineStats\": {");
+    json.appendf("\"Attempts\": %d,", fCombineStats.fAttempts);
+    json.appendf("\"Combined\": %d,", fCombineStats.fCombined);
+    json.appendf("\"DifferentClass\": %d,", fCombineStats.fDifferentClass);
+    json.appendf("\"PipelineMismatch\": %d,", fCombineStats.fPipelineMismatch);
+    json.appendf("\"OpRefused\": %d,", fCombineStats.fOpRefused);
+    json.appendf("\"StoppedAtOverlap\": %d,", fCombineStats.fStoppedAtOverlap);
+    json.appendf("\"StoppedAtLimit\": %d", fCombineStats.fStoppedAtLimit);
+    json.append("}");
     json.append("}");
 
     if (prettyPrint) {
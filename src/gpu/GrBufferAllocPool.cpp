@@ -13,6 +13,7 @@
 #include "GrContextPriv.h"
 #include "GrGpu.h"
 #include "GrResourceProvider.h"
+#include "GrStreamingBufferRing.h"
 #include "GrTypes.h"
 #include "SkSafeMath.h"
 #include "SkTraceEvent.h"
@@ -39,8 +40,10 @@ do {
     (block).fBuffer->unmap();                                                             \
 } while (false)
 
-GrBufferAllocPool::GrBufferAllocPool(GrGpu* gpu, GrBufferType bufferType, size_t blockSize)
-        : fBlocks(8) {
+GrBufferAllocPool::GrBufferAllocPool(GrGpu* gpu, GrBufferType bufferType, size_t blockSize,
+                                     GrStreamingBufferRing* ring)
+        : fBlocks(8)
+        , fRing(ring) {
 
     fGpu = SkRef(gpu);
     fCpuData = nullptr;
@@ -301,10 +304,11 @@ bool GrBufferAllocPool::createBlock(size_t requestSize) {
 
     // If the buffer is CPU-backed we map it because it is free to do so and saves a copy.
     // Otherwise when buffer mapping is supported we map if the buffer size is greater than the
-    // threshold.
+    // threshold, or always when the buffers are recycled through a ring since the GPU is known to
+    // be done with them.
     bool attemptMap = block.fBuffer->isCPUBacked();
     if (!attemptMap && GrCaps::kNone_MapFlags != fGpu->caps()->mapBufferFlags()) {
-        attemptMap = size > fBufferMapThreshold;
+        attemptMap = fRing || size > fBufferMapThreshold;
     }
 
     if (attemptMap) {
@@ -326,7 +330,11 @@ void GrBufferAllocPool::destroyBlock() {
     BufferBlock& block = fBlocks.back();
 
     SkASSERT(!block.fBuffer->isMapped());
-    block.fBuffer->unref();
+    if (fRing) {
+        fRing->release(fBufferType, block.fBuffer);
+    } else {
+        block.fBuffer->unref();
+    }
     fBlocks.pop_back();
     fBufferPtr = nullptr;
 }
@@ -368,6 +376,11 @@ void GrBufferAllocPool::flushCpuData(const BufferBlock& block, size_t flushSize)
 }
 
 GrBuffer* GrBufferAllocPool::getBuffer(size_t size) {
+    if (fRing) {
+        if (GrBuffer* buffer = fRing->acquire(fBufferType, size)) {
+            return buffer;
+        }
+    }
 
     auto resourceProvider = fGpu->getContext()->contextPriv().resourceProvider();
 
@@ -378,8 +391,8 @@ GrBuffer* GrBufferAllocPool::getBuffer(size_t size) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-GrVertexBufferAllocPool::GrVertexBufferAllocPool(GrGpu* gpu)
-    : GrBufferAllocPool(gpu, kVertex_GrBufferType, MIN_VERTEX_BUFFER_SIZE) {
+GrVertexBufferAllocPool::GrVertexBufferAllocPool(GrGpu* gpu, GrStreamingBufferRing* ring)
+    : GrBufferAllocPool(gpu, kVertex_GrBufferType, MIN_VERTEX_BUFFER_SIZE, ring) {
 }
 
 void* GrVertexBufferAllocPool::makeSpace(size_t vertexSize,
@@ -433,8 +446,8 @@ void* GrVertexBufferAllocPool::makeSpaceAtLeast(size_t vertexSize, int minVertex
 
 ////////////////////////////////////////////////////////////////////////////////
 
-GrIndexBufferAllocPool::GrIndexBufferAllocPool(GrGpu* gpu)
-    : GrBufferAllocPool(gpu, kIndex_GrBufferType, MIN_INDEX_BUFFER_SIZE) {
+GrIndexBufferAllocPool::GrIndexBufferAllocPool(GrGpu* gpu, GrStreamingBufferRing* ring)
+    : GrBufferAllocPool(gpu, kIndex_GrBufferType, MIN_INDEX_BUFFER_SIZE, ring) {
 }
 
 void* GrIndexBufferAllocPool::makeSpace(int indexCount,
@@ -15,6 +15,7 @@
 
 class GrBuffer;
 class GrGpu;
+class GrStreamingBufferRing;
 
 /**
  * A pool of geometry buffers tied to a GrGpu.
@@ -55,10 +56,13 @@ protected:
      * @param bufferSize            The minimum size of created buffers.
      *                              This value will be clamped to some
      *                              reasonable minimum.
+     * @param ring                  If not null, blocks are recycled through the ring across
+     *                              flushes and are always written through a mapping.
      */
      GrBufferAllocPool(GrGpu* gpu,
                        GrBufferType bufferType,
-                       size_t   bufferSize = 0);
+                       size_t   bufferSize = 0,
+                       GrStreamingBufferRing* ring = nullptr);
 
      virtual ~GrBufferAllocPool();
 
@@ -144,6 +148,7 @@ private:
     void*                           fCpuData;
     void*                           fBufferPtr;
     size_t                          fBufferMapThreshold;
+    GrStreamingBufferRing*          fRing;
 };
 
 /**
@@ -155,8 +160,9 @@ public:
      * Constructor
      *
      * @param gpu                   The GrGpu used to create the vertex buffers.
+     * @param ring                  Optional ring that recycles the buffers across flushes.
      */
-    GrVertexBufferAllocPool(GrGpu* gpu);
+    GrVertexBufferAllocPool(GrGpu* gpu, GrStreamingBufferRing* ring = nullptr);
 
     /**
      * Returns a block of memory to hold vertices. A buffer designated to hold
@@ -231,8 +237,9 @@ public:
      * Constructor
      *
      * @param gpu                   The GrGpu used to create the index buffers.
+     * @param ring                  Optional ring that recycles the buffers across flushes.
      */
-    GrIndexBufferAllocPool(GrGpu* gpu);
+    GrIndexBufferAllocPool(GrGpu* gpu, GrStreamingBufferRing* ring = nullptr);
 
     /**
      * Returns a block of memory to hold indices. A buffer designated to hold
@@ -90,6 +90,12 @@ GrCaps::GrCaps(const GrContextOptions& options) {
     fWireframeMode = false;
 #endif
     fBufferMapThreshold = options.fBufferMapThreshold;
+    fReuseTextVertexBuffers = options.fReuseTextVertexBuffers;
+    fPackSmallImagesInAtlas = options.fPackSmallImagesInAtlas;
+    fUseStreamingBufferRing = options.fUseStreamingBufferRing;
+    fCachePictureLayers = options.fCachePictureLayers;
+    fBatchMipMapRegeneration = options.fBatchMipMapRegeneration;
+    fDeferYUVPlaneUploads = options.fDeferYUVPlaneUploads;
     fBlacklistCoverageCounting = false;
     fAvoidStencilBuffers = false;
 
@@ -167,6 +173,12 @@ void GrCaps::dumpJSON(SkJSONWriter* writer) const {
     writer->appendBool("Prefer client-side dynamic buffers", fPreferClientSideDynamicBuffers);
     writer->appendBool("Prefer fullscreen clears", fPreferFullscreenClears);
     writer->appendBool("Must clear buffer memory", fMustClearUploadedBufferData);
+    writer->appendBool("Reuse text vertex buffers", fReuseTextVertexBuffers);
+    writer->appendBool("Pack small images in atlas", fPackSmallImagesInAtlas);
+    writer->appendBool("Use streaming buffer ring", fUseStreamingBufferRing);
+    writer->appendBool("Cache picture layers", fCachePictureLayers);
+    writer->appendBool("Batch mip map regeneration", fBatchMipMapRegeneration);
+    writer->appendBool("Defer YUV plane uploads", fDeferYUVPlaneUploads);
     writer->appendBool("Sample shading support", fSampleShadingSupport);
     writer->appendBool("Fence sync support", fFenceSyncSupport);
     writer->appendBool("Cross context texture support", fCrossContextTextureSupport);
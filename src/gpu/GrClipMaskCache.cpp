@@ -0,0 +1,153 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrClipMaskCache.h"
+#include "GrShape.h"
+#include "GrTextureProxy.h"
+
+constexpr int GrClipMaskCache::kMaxEntries;
+constexpr int GrClipMaskCache::kMaxMaskArea;
+
+using Element = SkClipStack::Element;
+using KeyArray = SkTArray<uint32_t>;
+
+static void append_key_data(const void* data, size_t size, KeyArray* key) {
+    SkASSERT(0 == size % sizeof(uint32_t));
+    memcpy(key->push_back_n(SkToInt(size / sizeof(uint32_t))), data, size);
+}
+
+// Appends a key for the element translated by -origin. Returns false if the element can't be
+// keyed by its content.
+static bool append_element_key(const Element* element, const SkIPoint& origin, KeyArray* key) {
+    key->push_back(static_cast<uint32_t>(element->getOp()) |
+                   (static_cast<uint32_t>(element->getDeviceSpaceType()) << 8) |
+                   (static_cast<uint32_t>(element->isAA()) << 16) |
+                   (static_cast<uint32_t>(element->isInverseFilled()) << 17));
+    SkScalar dx = SkIntToScalar(-origin.fX);
+    SkScalar dy = SkIntToScalar(-origin.fY);
+    switch (element->getDeviceSpaceType()) {
+        case Element::DeviceSpaceType::kEmpty:
+            return true;
+        case Element::DeviceSpaceType::kRect: {
+            SkRect rect = element->getDeviceSpaceRect().makeOffset(dx, dy);
+            append_key_data(&rect, sizeof(rect), key);
+            return true;
+        }
+        case Element::DeviceSpaceType::kRRect: {
+            SkRRect rrect = element->getDeviceSpaceRRect();
+            rrect.offset(dx, dy);
+            uint32_t data[SkRRect::kSizeInMemory / sizeof(uint32_t)];
+            rrect.writeToMemory(data);
+            append_key_data(data, sizeof(data), key);
+            return true;
+        }
+        case Element::DeviceSpaceType::kPath: {
+            // Paths that are too large to be keyed by their points are keyed by gen ID, which the
+            // translated copy doesn't share with any other path.
+            const SkPath& devicePath = element->getDeviceSpacePath();
+            if (devicePath.isVolatile() ||
+                devicePath.countVerbs() > GrShape::kMaxKeyFromDataVerbCnt) {
+                return false;
+            }
+            SkPath path;
+            devicePath.offset(dx, dy, &path);
+            GrShape shape(path);
+            int keySize = shape.unstyledKeySize();
+            if (keySize < 0) {
+                return false;
+            }
+            shape.writeUnstyledKey(key->push_back_n(keySize));
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool keys_equal(const KeyArray& a, const KeyArray& b) {
+    return a.count() == b.count() && !memcmp(a.begin(), b.begin(), a.count() * sizeof(uint32_t));
+}
+
+bool GrClipMaskCache::BuildKeys(const GrReducedClip& reducedClip, MaskType type, Keys* keys) {
+    const SkIRect& scissor = reducedClip.scissor();
+    if (reducedClip.maskElements().isEmpty() ||
+        static_cast<int64_t>(scissor.width()) * scissor.height() > kMaxMaskArea) {
+        return false;
+    }
+    if (MaskType::kAlpha == type && !reducedClip.windowRectangles().empty()) {
+        // Alpha masks are left undefined inside the window rectangles.
+        return false;
+    }
+    uint32_t header = static_cast<uint32_t>(type) |
+                      (static_cast<uint32_t>(reducedClip.initialState()) << 1);
+    keys->fMaskKey.reset();
+    keys->fMaskKey.push_back(header);
+    keys->fMaskKey.push_back(scissor.width());
+    keys->fMaskKey.push_back(scissor.height());
+    keys->fDeviceKey.reset();
+    keys->fDeviceKey.push_back(header);
+
+    const SkIPoint origin = {scissor.fLeft, scissor.fTop};
+    const int lastIdx = reducedClip.maskElements().count() - 1;
+    int i = 0;
+    for (GrReducedClip::ElementList::Iter iter(reducedClip.maskElements()); iter.get();
+         iter.next(), ++i) {
+        if (lastIdx == i) {
+            keys->fPrefixDeviceKey = keys->fDeviceKey;
+        }
+        if (!append_element_key(iter.get(), origin, &keys->fMaskKey) ||
+            !append_element_key(iter.get(), {0, 0}, &keys->fDeviceKey)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void GrClipMaskCache::makeMRU(int index) {
+    for (int i = index; i < fEntries.count() - 1; ++i) {
+        std::swap(fEntries[i], fEntries[i + 1]);
+    }
+}
+
+sk_sp<GrTextureProxy> GrClipMaskCache::find(const Keys& keys) {
+    for (int i = fEntries.count() - 1; i >= 0; --i) {
+        if (keys_equal(fEntries[i]->fMaskKey, keys.fMaskKey)) {
+            this->makeMRU(i);
+            ++fNumHits;
+            return fEntries.back()->fMask;
+        }
+    }
+    return nullptr;
+}
+
+sk_sp<GrTextureProxy> GrClipMaskCache::findPrefix(const Keys& keys, const SkIRect& bounds,
+                                                  SkIRect* prefixBounds) {
+    for (int i = fEntries.count() - 1; i >= 0; --i) {
+        const Entry& entry = *fEntries[i];
+        if (entry.fBounds.contains(bounds) &&
+            keys_equal(entry.fDeviceKey, keys.fPrefixDeviceKey)) {
+            this->makeMRU(i);
+            ++fNumComposed;
+            *prefixBounds = fEntries.back()->fBounds;
+            return fEntries.back()->fMask;
+        }
+    }
+    return nullptr;
+}
+
+void GrClipMaskCache::add(const Keys& keys, const SkIRect& bounds, sk_sp<GrTextureProxy> mask) {
+    if (fEntries.count() == kMaxEntries) {
+        // Recycle the least recently used entry.
+        this->makeMRU(0);
+    } else {
+        fEntries.emplace_back(new Entry);
+    }
+    Entry* entry = fEntries.back().get();
+    entry->fMaskKey = keys.fMaskKey;
+    entry->fDeviceKey = keys.fDeviceKey;
+    entry->fBounds = bounds;
+    entry->fMask = std::move(mask);
+}
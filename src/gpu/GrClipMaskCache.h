@@ -0,0 +1,92 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrClipMaskCache_DEFINED
+#define GrClipMaskCache_DEFINED
+
+#include "GrReducedClip.h"
+#include "SkRefCnt.h"
+#include "SkTArray.h"
+
+class GrTextureProxy;
+
+/**
+ * A small LRU cache of recently generated clip masks that is keyed by the content of the reduced
+ * clip rather than by the clip stack's gen ID. Clip masks found by gen ID are purged when the clip
+ * element that produced them is popped, so a clip that is pushed again a frame later (e.g. nested
+ * rounded clips in a scrolling list) would otherwise be rasterized again. The content key is the
+ * list of mask elements relative to the mask's top left corner, so a mask is also found when the
+ * whole clip has moved by whole pixels.
+ *
+ * Each entry also records the device space elements and bounds of its mask. When the reduced clip
+ * is a cached mask's element list plus one more element, the alpha mask is composed from the
+ * cached mask and the new element (see findPrefix()).
+ *
+ * The cache holds refs on its masks, so only masks up to kMaxMaskArea pixels are kept.
+ */
+class GrClipMaskCache {
+public:
+    static constexpr int kMaxEntries = 8;
+    static constexpr int kMaxMaskArea = 512 * 512;
+
+    enum class MaskType : uint32_t {
+        kAlpha,
+        kSoftware
+    };
+
+    /** The keys identifying a reduced clip's mask in this cache. */
+    struct Keys {
+        // Elements relative to the mask's top left corner plus the mask size.
+        SkSTArray<32, uint32_t> fMaskKey;
+        // Device space elements; used to compose a mask from the mask of a prefix of them.
+        SkSTArray<32, uint32_t> fDeviceKey;
+        // fDeviceKey for all but the last element.
+        SkSTArray<32, uint32_t> fPrefixDeviceKey;
+    };
+
+    /**
+     * Builds the keys for the reduced clip's mask. Returns false if the clip can't be cached, e.g.
+     * because the mask is too large or an element is a path that can't be keyed.
+     */
+    static bool BuildKeys(const GrReducedClip&, MaskType, Keys*);
+
+    /** Finds a mask with the same content as the one described by 'keys'. */
+    sk_sp<GrTextureProxy> find(const Keys& keys);
+
+    /**
+     * Finds a mask of all but the last of the elements described by 'keys' that covers 'bounds'.
+     * On success 'prefixBounds' is set to the device space bounds of the returned mask.
+     */
+    sk_sp<GrTextureProxy> findPrefix(const Keys& keys, const SkIRect& bounds,
+                                     SkIRect* prefixBounds);
+
+    /** Adds a mask, evicting the least recently used one if the cache is full. */
+    void add(const Keys&, const SkIRect& bounds, sk_sp<GrTextureProxy>);
+
+    void reset() { fEntries.reset(); }
+
+    int count() const { return fEntries.count(); }
+    int numHits() const { return fNumHits; }
+    int numComposed() const { return fNumComposed; }
+
+private:
+    struct Entry {
+        SkSTArray<32, uint32_t> fMaskKey;
+        SkSTArray<32, uint32_t> fDeviceKey;
+        SkIRect fBounds;
+        sk_sp<GrTextureProxy> fMask;
+    };
+
+    void makeMRU(int index);
+
+    // The most recently used entry is last.
+    SkTArray<std::unique_ptr<Entry>> fEntries;
+    int fNumHits = 0;
+    int fNumComposed = 0;
+};
+
+#endif
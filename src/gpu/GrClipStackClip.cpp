@@ -8,6 +8,7 @@
 #include "GrClipStackClip.h"
 
 #include "GrAppliedClip.h"
+#include "GrClipMaskCache.h"
 #include "GrContextPriv.h"
 #include "GrDeferredProxyUploader.h"
 #include "GrDrawingManager.h"
@@ -325,6 +326,18 @@ static void add_invalidate_on_pop_message(const SkClipStack& stack, uint32_t cli
     SkDEBUGFAIL("Gen ID was not found in stack.");
 }
 
+void GrClipStackClip::assignMaskKey(GrProxyProvider* proxyProvider,
+                                    const GrReducedClip& reducedClip, const GrUniqueKey& key,
+                                    GrTextureProxy* mask) const {
+    // A mask found in the GrClipMaskCache may still be keyed by the clip that first produced it.
+    // It is then found through the cache again next time.
+    if (mask->getUniqueKey().isValid()) {
+        return;
+    }
+    proxyProvider->assignUniqueKeyToProxy(key, mask);
+    add_invalidate_on_pop_message(*fStack, reducedClip.maskGenID(), key);
+}
+
 sk_sp<GrTextureProxy> GrClipStackClip::createAlphaClipMask(GrContext* context,
                                                            const GrReducedClip& reducedClip) const {
     GrProxyProvider* proxyProvider = context->contextPriv().proxyProvider();
@@ -338,6 +351,17 @@ sk_sp<GrTextureProxy> GrClipStackClip::createAlphaClipMask(GrContext* context,
         return proxy;
     }
 
+    GrClipMaskCache* maskCache = context->contextPriv().drawingManager()->getClipMaskCache();
+    GrClipMaskCache::Keys cacheKeys;
+    bool cacheable = GrClipMaskCache::BuildKeys(reducedClip, GrClipMaskCache::MaskType::kAlpha,
+                                                &cacheKeys);
+    if (cacheable) {
+        if (sk_sp<GrTextureProxy> cached = maskCache->find(cacheKeys)) {
+            this->assignMaskKey(proxyProvider, reducedClip, key, cached.get());
+            return cached;
+        }
+    }
+
     sk_sp<GrRenderTargetContext> rtc(
         context->contextPriv().makeDeferredRenderTargetContextWithFallback(SkBackingFit::kApprox,
                                                                            reducedClip.width(),
@@ -348,7 +372,12 @@ sk_sp<GrTextureProxy> GrClipStackClip::createAlphaClipMask(GrContext* context,
         return nullptr;
     }
 
-    if (!reducedClip.drawAlphaClipMask(rtc.get())) {
+    sk_sp<GrTextureProxy> prefixMask;
+    SkIRect prefixBounds = SkIRect::MakeEmpty();
+    if (cacheable && reducedClip.maskElements().count() > 1) {
+        prefixMask = maskCache->findPrefix(cacheKeys, reducedClip.scissor(), &prefixBounds);
+    }
+    if (!reducedClip.drawAlphaClipMask(rtc.get(), std::move(prefixMask), prefixBounds)) {
         return nullptr;
     }
 
@@ -358,8 +387,10 @@ sk_sp<GrTextureProxy> GrClipStackClip::createAlphaClipMask(GrContext* context,
     }
 
     SkASSERT(result->origin() == kBottomLeft_GrSurfaceOrigin);
-    proxyProvider->assignUniqueKeyToProxy(key, result.get());
-    add_invalidate_on_pop_message(*fStack, reducedClip.maskGenID(), key);
+    this->assignMaskKey(proxyProvider, reducedClip, key, result.get());
+    if (cacheable) {
+        maskCache->add(cacheKeys, reducedClip.scissor(), result);
+    }
 
     return result;
 }
@@ -453,6 +484,17 @@ sk_sp<GrTextureProxy> GrClipStackClip::createSoftwareClipMask(
         return proxy;
     }
 
+    GrClipMaskCache* maskCache = context->contextPriv().drawingManager()->getClipMaskCache();
+    GrClipMaskCache::Keys cacheKeys;
+    bool cacheable = GrClipMaskCache::BuildKeys(reducedClip, GrClipMaskCache::MaskType::kSoftware,
+                                                &cacheKeys);
+    if (cacheable) {
+        if (sk_sp<GrTextureProxy> cached = maskCache->find(cacheKeys)) {
+            this->assignMaskKey(proxyProvider, reducedClip, key, cached.get());
+            return cached;
+        }
+    }
+
     // The mask texture may be larger than necessary. We round out the clip bounds and pin the top
     // left corner of the resulting rect to the top left of the texture.
     SkIRect maskSpaceIBounds = SkIRect::MakeWH(reducedClip.width(), reducedClip.height());
@@ -499,7 +541,9 @@ sk_sp<GrTextureProxy> GrClipStackClip::createSoftwareClipMask(
     }
 
     SkASSERT(proxy->origin() == kTopLeft_GrSurfaceOrigin);
-    proxyProvider->assignUniqueKeyToProxy(key, proxy.get());
-    add_invalidate_on_pop_message(*fStack, reducedClip.maskGenID(), key);
+    this->assignMaskKey(proxyProvider, reducedClip, key, proxy.get());
+    if (cacheable) {
+        maskCache->add(cacheKeys, reducedClip.scissor(), proxy);
+    }
     return proxy;
 }
@@ -12,7 +12,9 @@
 #include "SkClipStack.h"
 
 class GrPathRenderer;
+class GrProxyProvider;
 class GrTextureProxy;
+class GrUniqueKey;
 
 /**
  * GrClipStackClip can apply a generic SkClipStack to the draw state. It may need to generate an
@@ -57,6 +59,11 @@ private:
     sk_sp<GrTextureProxy> createSoftwareClipMask(GrContext*, const GrReducedClip&,
                                                  GrRenderTargetContext*) const;
 
+    // Gives the mask the gen ID based key so that it is found directly while this clip remains on
+    // the stack and purged when the clip is popped.
+    void assignMaskKey(GrProxyProvider*, const GrReducedClip&, const GrUniqueKey&,
+                       GrTextureProxy* mask) const;
+
     static bool UseSWOnlyPath(GrContext*,
                               bool hasUserStencilSettings,
                               const GrRenderTargetContext*,
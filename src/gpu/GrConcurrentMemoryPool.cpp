@@ -0,0 +1,188 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrConcurrentMemoryPool.h"
+
+#include "GrMemoryPool.h"
+#include "SkMutex.h"
+#include "SkSpinlock.h"
+#include "SkTArray.h"
+#include "SkTLS.h"
+
+namespace {
+// Released space waiting on a remote-free list. The link takes the place of the magazine pointer.
+struct FreeNode {
+    FreeNode* fNext;
+};
+
+// A remote-free list's head once its magazine's thread has exited.
+FreeNode* const kOrphaned = reinterpret_cast<FreeNode*>(static_cast<intptr_t>(1));
+
+// Keeps allocations as aligned as GrMemoryPool's are.
+constexpr size_t kPrefixSize = GR_CT_ALIGN_UP(sizeof(void*), 8);
+}  // namespace
+
+class GrConcurrentMemoryPool::Magazine {
+public:
+    Magazine(uint32_t poolID, size_t preallocSize, size_t minAllocSize)
+        : fPoolID(poolID)
+        , fPool(preallocSize, minAllocSize)
+        , fRemoteFrees(nullptr) {}
+
+    ~Magazine() { SkASSERT(fPool.isEmpty()); }
+
+    uint32_t poolID() const { return fPoolID; }
+
+    // allocate() and releaseLocal() may only be called on the magazine's thread.
+    void* allocate(size_t size) {
+        this->drainRemoteFrees();
+        void* p = fPool.allocate(kPrefixSize + size);
+        *static_cast<Magazine**>(p) = this;
+        return static_cast<char*>(p) + kPrefixSize;
+    }
+
+    void releaseLocal(void* p) {
+        fPool.release(p);
+        this->drainRemoteFrees();
+    }
+
+    void releaseRemote(void* p) {
+        FreeNode* node = static_cast<FreeNode*>(p);
+        FreeNode* head = fRemoteFrees.load(std::memory_order_acquire);
+        do {
+            if (kOrphaned == head) {
+                this->releaseOrphaned(p);
+                return;
+            }
+            node->fNext = head;
+        } while (!fRemoteFrees.compare_exchange_weak(head, node, std::memory_order_release,
+                                                     std::memory_order_acquire));
+    }
+
+    // Called on the magazine's thread as it exits. The magazine may be deleted before this
+    // returns.
+    void orphan() {
+        FreeNode* list = fRemoteFrees.exchange(kOrphaned, std::memory_order_acq_rel);
+        bool empty;
+        {
+            SkAutoExclusive lock(fOrphanLock);
+            this->releaseList(list);
+            empty = fPool.isEmpty();
+        }
+        if (empty) {
+            delete this;
+        }
+    }
+
+private:
+    void drainRemoteFrees() {
+        // Usually there's nothing there, and we can skip the exchange.
+        if (fRemoteFrees.load(std::memory_order_relaxed)) {
+            this->releaseList(fRemoteFrees.exchange(nullptr, std::memory_order_acquire));
+        }
+    }
+
+    void releaseList(FreeNode* list) {
+        while (list) {
+            FreeNode* next = list->fNext;
+            fPool.release(list);
+            list = next;
+        }
+    }
+
+    void releaseOrphaned(void* p) {
+        bool empty;
+        {
+            SkAutoExclusive lock(fOrphanLock);
+            fPool.release(p);
+            empty = fPool.isEmpty();
+        }
+        // Nothing else can be using the magazine: its thread is gone, and so are its allocations.
+        if (empty) {
+            delete this;
+        }
+    }
+
+    const uint32_t         fPoolID;
+    GrMemoryPool           fPool;
+    std::atomic<FreeNode*> fRemoteFrees;
+    SkSpinlock             fOrphanLock;  // Guards fPool once the magazine is orphaned.
+};
+
+// The magazines a thread has made, for every pool it has allocated from.
+struct GrConcurrentMemoryPool::Rack {
+    static Rack* ForThisThread() { return static_cast<Rack*>(SkTLS::Get(Create, ThreadExited)); }
+
+    // Returns nullptr, rather than making a rack, if this thread hasn't allocated from any pool.
+    static Rack* FindForThisThread() { return static_cast<Rack*>(SkTLS::Find(Create)); }
+
+    Magazine* find(uint32_t poolID) const {
+        for (Magazine* magazine : fMagazines) {
+            if (magazine->poolID() == poolID) {
+                return magazine;
+            }
+        }
+        return nullptr;
+    }
+
+    static void* Create() { return new Rack; }
+
+    static void ThreadExited(void* ptr) {
+        Rack* rack = static_cast<Rack*>(ptr);
+        for (Magazine* magazine : rack->fMagazines) {
+            magazine->orphan();
+        }
+        delete rack;
+    }
+
+    SkSTArray<4, Magazine*, true> fMagazines;
+};
+
+static uint32_t next_pool_id() {
+    static std::atomic<uint32_t> gNextID{1};
+    return gNextID.fetch_add(1, std::memory_order_relaxed);
+}
+
+GrConcurrentMemoryPool::GrConcurrentMemoryPool(size_t preallocSize, size_t minAllocSize)
+    : fUniqueID(next_pool_id())
+    , fPreallocSize(preallocSize)
+    , fMinAllocSize(minAllocSize) {
+    SkDEBUGCODE(fAllocationCnt = 0);
+}
+
+GrConcurrentMemoryPool::~GrConcurrentMemoryPool() {
+    SkASSERT(0 == fAllocationCnt);
+}
+
+GrConcurrentMemoryPool::Magazine* GrConcurrentMemoryPool::magazineForThisThread() {
+    Rack* rack = Rack::ForThisThread();
+    if (Magazine* magazine = rack->find(fUniqueID)) {
+        return magazine;
+    }
+    Magazine* magazine = new Magazine(fUniqueID, fPreallocSize, fMinAllocSize);
+    rack->fMagazines.push_back(magazine);
+    return magazine;
+}
+
+void* GrConcurrentMemoryPool::allocate(size_t size) {
+    SkDEBUGCODE(fAllocationCnt.fetch_add(1, std::memory_order_relaxed));
+    return this->magazineForThisThread()->allocate(size);
+}
+
+void GrConcurrentMemoryPool::release(void* target) {
+    SkDEBUGCODE(fAllocationCnt.fetch_sub(1, std::memory_order_relaxed));
+    void* p = static_cast<char*>(target) - kPrefixSize;
+    Magazine* magazine = *static_cast<Magazine**>(p);
+    SkASSERT(magazine->poolID() == fUniqueID);
+    // A magazine stays in its thread's rack until the thread exits, so if it's in ours, it's ours.
+    Rack* rack = Rack::FindForThisThread();
+    if (rack && rack->find(fUniqueID) == magazine) {
+        magazine->releaseLocal(p);
+    } else {
+        magazine->releaseRemote(p);
+    }
+}
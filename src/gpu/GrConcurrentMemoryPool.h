@@ -0,0 +1,73 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrConcurrentMemoryPool_DEFINED
+#define GrConcurrentMemoryPool_DEFINED
+
+#include "GrTypes.h"
+
+#include <atomic>
+
+/**
+ * A GrMemoryPool that any number of threads may allocate from and release to at once, without
+ * taking a lock.
+ *
+ * Each thread allocates from a magazine of its own: a GrMemoryPool that only it touches. Space
+ * released by the thread that allocated it goes straight back to its magazine. Space released on
+ * any other thread is pushed onto the magazine's remote-free list, an atomic singly linked list
+ * threaded through the released allocations themselves, and the owning thread returns it to the
+ * magazine the next time it allocates or releases. Each allocation is prefixed with a pointer to
+ * its magazine.
+ *
+ * When a thread exits its magazines are orphaned. From then on, releases to an orphaned magazine
+ * briefly take a lock, and it is deleted along with the last of its allocations.
+ *
+ * Magazines are not deleted with the pool (that would need the other threads' cooperation), but
+ * with their threads, so pools are meant to be long lived, e.g. static.
+ */
+class GrConcurrentMemoryPool {
+public:
+    /**
+     * Each thread's magazine is a GrMemoryPool made with these sizes.
+     */
+    GrConcurrentMemoryPool(size_t preallocSize, size_t minAllocSize);
+
+    ~GrConcurrentMemoryPool();
+
+    /**
+     * Allocates memory from this thread's magazine. The memory must be freed with release(), on
+     * any thread.
+     */
+    void* allocate(size_t size);
+
+    /**
+     * p must have been returned by allocate(), on any thread.
+     */
+    void release(void* p);
+
+#ifdef SK_DEBUG
+    /**
+     * Returns the number of allocations that haven't been released yet.
+     */
+    int allocationCount() const { return fAllocationCnt.load(std::memory_order_relaxed); }
+#endif
+
+private:
+    class Magazine;
+    struct Rack;
+
+    Magazine* magazineForThisThread();
+
+    const uint32_t   fUniqueID;
+    const size_t     fPreallocSize;
+    const size_t     fMinAllocSize;
+#ifdef SK_DEBUG
+    std::atomic<int> fAllocationCnt;
+#endif
+};
+
+#endif
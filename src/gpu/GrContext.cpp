@@ -12,6 +12,7 @@
 #include "GrContextPriv.h"
 #include "GrDrawingManager.h"
 #include "GrGpu.h"
+#include "GrProgramKeyAnalysis.h"
 #include "GrProxyProvider.h"
 #include "GrRenderTargetContext.h"
 #include "GrRenderTargetProxy.h"
@@ -33,9 +34,9 @@
 #include "SkImageInfoPriv.h"
 #include "SkJSONWriter.h"
 #include "SkMakeUnique.h"
+#include "SkOpts.h"
 #include "SkSurface_Gpu.h"
 #include "SkTaskGroup.h"
-#include "SkUnPreMultiplyPriv.h"
 #include "effects/GrConfigConversionEffect.h"
 #include "text/GrTextBlobCache.h"
 
@@ -101,6 +102,9 @@ bool GrContext::initCommon(const GrContextOptions& options) {
 
     GrPathRendererChain::Options prcOptions;
     prcOptions.fAllowPathMaskCaching = options.fAllowPathMaskCaching;
+    prcOptions.fCacheCoverageCountingPathMasks = options.fCacheCoverageCountingPathMasks;
+    prcOptions.fCacheClippedSoftwarePathMasks = options.fCacheClippedSoftwarePathMasks;
+    prcOptions.fExecutor = options.fExecutor;
 #if GR_TEST_UTILS
     prcOptions.fGpuPathRenderers = options.fGpuPathRenderers;
 #endif
@@ -131,7 +135,9 @@ bool GrContext::initCommon(const GrContextOptions& options) {
                                             : false;
     fDrawingManager.reset(new GrDrawingManager(this, prcOptions, atlasTextContextOptions,
                                                &fSingleOwner, explicitlyAllocatingResources,
-                                               options.fSortRenderTargets));
+                                               options.fSortRenderTargets,
+                                               options.fIndexOpBoundsForCombining,
+                                               options.fReuseLargerSurfacesForApproxFit));
 
     fGlyphCache = new GrGlyphCache(fCaps.get(), options.fGlyphCacheTextureMaximumBytes);
 
@@ -145,6 +151,11 @@ bool GrContext::initCommon(const GrContextOptions& options) {
     }
 
     fPersistentCache = options.fPersistentCache;
+#if GR_TEST_UTILS
+    if (options.fAnalyzeProgramKeys) {
+        fProgramKeyAnalysis.reset(new GrProgramKeyAnalysis);
+    }
+#endif
 
     return true;
 }
@@ -157,6 +168,9 @@ GrContext::~GrContext() {
     }
 
     fTextureStripAtlasManager = nullptr;
+    if (fProxyProvider) {
+        fProxyProvider->releaseImageAtlas();
+    }
     delete fResourceProvider;
     delete fResourceCache;
     delete fProxyProvider;
@@ -274,6 +288,10 @@ void GrContext::freeGpuResources() {
     fDrawingManager->freeGpuResources();
 
     fResourceCache->purgeAllUnlocked();
+
+    if (fGpu) {
+        fGpu->releaseUnusedMemory();
+    }
 }
 
 void GrContext::purgeUnlockedResources(bool scratchResourcesOnly) {
@@ -847,7 +865,7 @@ bool GrContextPriv::readSurfacePixels(GrSurfaceContext* src, int left, int top,
         }
 
         for (int y = 0; y < height; y++) {
-            SkUnpremultiplyRow<false>((uint32_t*) buffer, (const uint32_t*) buffer, width);
+            SkOpts::rgbA_to_RGBA((uint32_t*) buffer, buffer, width);
             buffer = SkTAddOffset<void>(buffer, rowBytes);
         }
     }
@@ -1357,6 +1375,11 @@ void GrContextPriv::copyOpListsFromDDL(const SkDeferredDisplayList* ddl,
     fContext->fDrawingManager->copyOpListsFromDDL(ddl, newDest);
 }
 
+void GrContextPriv::copyOpListsFromDDLs(int count, const SkDeferredDisplayList* const ddls[],
+                                        GrRenderTargetProxy* const newDests[]) {
+    fContext->fDrawingManager->copyOpListsFromDDLs(count, ddls, newDests);
+}
+
 static inline GrPixelConfig GrPixelConfigFallback(GrPixelConfig config) {
     switch (config) {
         case kAlpha_8_GrPixelConfig:
@@ -1516,10 +1539,41 @@ void GrContext::setResourceCacheLimits(int maxResources, size_t maxResourceBytes
     fResourceCache->setLimits(maxResources, maxResourceBytes);
 }
 
+void GrContext::setResourceCacheIncrementalPurging(size_t maxBytesPerFlush) {
+    ASSERT_SINGLE_OWNER
+    fResourceCache->setMaxBytesPurgedPerFlush(maxBytesPerFlush);
+}
+
+void GrContext::reportFrameTime(std::chrono::microseconds frameTime,
+                                std::chrono::microseconds targetFrameTime) {
+    ASSERT_SINGLE_OWNER
+    fResourceCache->setLastFrameHadHeadroom(frameTime < targetFrameTime);
+}
+
+void GrContext::notifyMemoryPressure(MemoryPressureLevel level) {
+    ASSERT_SINGLE_OWNER
+    switch (level) {
+        case MemoryPressureLevel::kModerate:
+            fResourceCache->purgeUnlockedResources(true);
+            break;
+        case MemoryPressureLevel::kCritical:
+            fResourceCache->purgeAllUnlocked();
+            if (fGpu) {
+                fGpu->releaseUnusedMemory();
+            }
+            break;
+    }
+    fTextBlobCache->purgeStaleBlobs();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 void GrContext::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
     ASSERT_SINGLE_OWNER
     fResourceCache->dumpMemoryStatistics(traceMemoryDump);
+    fTextBlobCache->dumpMemoryStatistics(traceMemoryDump);
+    if (fGpu) {
+        fGpu->dumpMemoryStatistics(traceMemoryDump);
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////
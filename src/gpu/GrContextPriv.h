@@ -209,6 +209,8 @@ public:
 
     void moveOpListsToDDL(SkDeferredDisplayList*);
     void copyOpListsFromDDL(const SkDeferredDisplayList*, GrRenderTargetProxy* newDest);
+    void copyOpListsFromDDLs(int count, const SkDeferredDisplayList* const[],
+                             GrRenderTargetProxy* const newDests[]);
 
     /**
      * Purge all the unlocked resources from the cache.
@@ -265,6 +267,12 @@ public:
     void dumpGpuStatsKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>* values) const;
     void printGpuStats() const;
 
+    /**
+     * Prints which program key bits changed the generated SkSL, if
+     * GrContextOptions::fAnalyzeProgramKeys was set.
+     */
+    void dumpProgramKeyAnalysis(SkString*) const;
+
     /** Returns a string with detailed information about the context & GPU, in JSON format. */
     SkString dump() const;
 
@@ -285,6 +293,9 @@ public:
 
     GrContextOptions::PersistentCache* getPersistentCache() { return fContext->fPersistentCache; }
 
+    /** Non-null if GrContextOptions::fAnalyzeProgramKeys was set. */
+    GrProgramKeyAnalysis* programKeyAnalysis() { return fContext->fProgramKeyAnalysis.get(); }
+
     /** This is only useful for debug purposes */
     SkDEBUGCODE(GrSingleOwner* debugSingleOwner() const { return &fContext->fSingleOwner; } )
 
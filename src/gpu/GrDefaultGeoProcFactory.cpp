@@ -7,6 +7,7 @@
 
 #include "GrDefaultGeoProcFactory.h"
 
+#include "GrShaderCaps.h"
 #include "SkRefCnt.h"
 #include "glsl/GrGLSLColorSpaceXformHelper.h"
 #include "glsl/GrGLSLFragmentShaderBuilder.h"
@@ -68,7 +69,7 @@ public:
     class GLSLProcessor : public GrGLSLGeometryProcessor {
     public:
         GLSLProcessor()
-            : fViewMatrix(SkMatrix::InvalidMatrix()), fColor(GrColor_ILLEGAL), fCoverage(0xff) {}
+            : fViewMatrix(SkMatrix::InvalidMatrix()), fColor(GrColor_ILLEGAL), fCoverage(-1) {}
 
         void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
             const DefaultGeoProc& gp = args.fGP.cast<DefaultGeoProc>();
@@ -162,7 +163,7 @@ public:
                 fragBuilder->codeAppendf("half alpha = 1.0;");
                 varyingHandler->addPassThroughAttribute(gp.inCoverage(), "alpha");
                 fragBuilder->codeAppendf("%s = half4(alpha);", args.fOutputCoverage);
-            } else if (gp.coverage() == 0xff) {
+            } else if (UsesSolidCoverage(gp, *args.fShaderCaps)) {
                 fragBuilder->codeAppendf("%s = half4(1);", args.fOutputCoverage);
             } else {
                 const char* fragCoverage;
@@ -175,13 +176,13 @@ public:
         }
 
         static inline void GenKey(const GrGeometryProcessor& gp,
-                                  const GrShaderCaps&,
+                                  const GrShaderCaps& caps,
                                   GrProcessorKeyBuilder* b) {
             const DefaultGeoProc& def = gp.cast<DefaultGeoProc>();
             uint32_t key = def.fFlags;
-            key |= (def.coverage() == 0xff) ? 0x10 : 0;
+            key |= UsesSolidCoverage(def, caps) ? 0x10 : 0;
             key |= (def.localCoordsWillBeRead() && def.localMatrix().hasPerspective()) ? 0x20 : 0x0;
-            key |= ComputePosKey(def.viewMatrix()) << 20;
+            key |= ComputePosKey(def.viewMatrix(), caps) << 20;
             b->add32(key);
             if (def.linearizeColor()) {
                 b->add32(GrColorSpaceXform::XformKey(def.fColorSpaceXform.get()));
@@ -193,7 +194,7 @@ public:
                      FPCoordTransformIter&& transformIter) override {
             const DefaultGeoProc& dgp = gp.cast<DefaultGeoProc>();
 
-            if (!dgp.viewMatrix().isIdentity() && !fViewMatrix.cheapEqualTo(dgp.viewMatrix())) {
+            if (fViewMatrixUniform.isValid() && !fViewMatrix.cheapEqualTo(dgp.viewMatrix())) {
                 fViewMatrix = dgp.viewMatrix();
                 float viewMatrix[3 * 3];
                 GrGLSLGetMatrix<3>(viewMatrix, fViewMatrix);
@@ -207,7 +208,7 @@ public:
                 fColor = dgp.color();
             }
 
-            if (dgp.coverage() != fCoverage && !dgp.hasVertexCoverage()) {
+            if (fCoverageUniform.isValid() && dgp.coverage() != fCoverage) {
                 pdman.set1f(fCoverageUniform, GrNormalizeByteToFloat(dgp.coverage()));
                 fCoverage = dgp.coverage();
             }
@@ -219,9 +220,16 @@ public:
         }
 
     private:
+        // Solid coverage skips the coverage uniform, unless GrUniformKeyBits::kSolidCoverage asks
+        // for it to be keyed like any other constant coverage.
+        static bool UsesSolidCoverage(const DefaultGeoProc& gp, const GrShaderCaps& caps) {
+            return !gp.hasVertexCoverage() && gp.coverage() == 0xff &&
+                   !(caps.uniformKeyBits() & GrUniformKeyBits::kSolidCoverage);
+        }
+
         SkMatrix fViewMatrix;
         GrColor fColor;
-        uint8_t fCoverage;
+        int fCoverage;  // -1 until the uniform is set.
         UniformHandle fViewMatrixUniform;
         UniformHandle fColorUniform;
         UniformHandle fCoverageUniform;
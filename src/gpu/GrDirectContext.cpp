@@ -80,7 +80,8 @@ protected:
 
         fAtlasManager = new GrAtlasManager(proxyProvider, glyphCache,
                                            options.fGlyphCacheTextureMaximumBytes,
-                                           allowMultitexturing);
+                                           allowMultitexturing,
+                                           options.fPackGlyphsByLifetime);
         this->contextPriv().addOnFlushCallbackObject(fAtlasManager);
 
         SkASSERT(glyphCache->getGlyphSizeLimit() == fAtlasManager->getGlyphSizeLimit());
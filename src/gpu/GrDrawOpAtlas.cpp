@@ -59,6 +59,8 @@ GrDrawOpAtlas::Plot::Plot(int pageIndex, int plotIndex, uint64_t genID, int offX
         : fLastUpload(GrDeferredUploadToken::AlreadyFlushedToken())
         , fLastUse(GrDeferredUploadToken::AlreadyFlushedToken())
         , fFlushesSinceLastUse(0)
+        , fHasSubImages(false)
+        , fLifetime(Lifetime::kShort)
         , fPageIndex(pageIndex)
         , fPlotIndex(plotIndex)
         , fGenID(genID)
@@ -88,7 +90,8 @@ GrDrawOpAtlas::Plot::~Plot() {
     delete fRects;
 }
 
-bool GrDrawOpAtlas::Plot::addSubImage(int width, int height, const void* image, SkIPoint16* loc) {
+bool GrDrawOpAtlas::Plot::addSubImage(int width, int height, const void* image, SkIPoint16* loc,
+                                      Lifetime lifetime) {
     SkASSERT(width <= fWidth && height <= fHeight);
 
     if (!fRects) {
@@ -98,6 +101,10 @@ bool GrDrawOpAtlas::Plot::addSubImage(int width, int height, const void* image,
     if (!fRects->addRect(width, height, loc)) {
         return false;
     }
+    if (!fHasSubImages) {
+        fHasSubImages = true;
+        fLifetime = lifetime;
+    }
 
     if (!fData) {
         fData = reinterpret_cast<unsigned char*>(sk_calloc_throw(fBytesPerPixel * fWidth *
@@ -162,6 +169,7 @@ void GrDrawOpAtlas::Plot::resetRects() {
         fRects->reset();
     }
 
+    fHasSubImages = false;
     fGenID++;
     fID = CreateId(fPageIndex, fPlotIndex, fGenID);
     fLastUpload = GrDeferredUploadToken::AlreadyFlushedToken();
@@ -187,7 +195,9 @@ GrDrawOpAtlas::GrDrawOpAtlas(GrProxyProvider* proxyProvider,
         , fAtlasGeneration(kInvalidAtlasGeneration + 1)
         , fPrevFlushToken(GrDeferredUploadToken::AlreadyFlushedToken())
         , fMaxPages(AllowMultitexturing::kYes == allowMultitexturing ? kMaxMultitexturePages : 1)
-        , fNumActivePages(0) {
+        , fNumActivePages(0)
+        , fPackByLifetime(false)
+        , fProxyProvider(proxyProvider) {
     fPlotWidth = fTextureWidth / numPlotsX;
     fPlotHeight = fTextureHeight / numPlotsY;
     SkASSERT(numPlotsX * numPlotsY <= BulkUseTokenUpdater::kMaxPlots);
@@ -196,7 +206,7 @@ GrDrawOpAtlas::GrDrawOpAtlas(GrProxyProvider* proxyProvider,
 
     fNumPlots = numPlotsX * numPlotsY;
 
-    this->createPages(proxyProvider);
+    this->createPage(0);
 }
 
 inline void GrDrawOpAtlas::processEviction(AtlasID id) {
@@ -204,6 +214,87 @@ inline void GrDrawOpAtlas::processEviction(AtlasID id) {
         (*fEvictionCallbacks[i].fFunc)(id, fEvictionCallbacks[i].fData);
     }
     ++fAtlasGeneration;
+    ++fFlushStats.fEvictions;
+}
+
+void GrDrawOpAtlas::UploadPlots(const SkTArray<sk_sp<Plot>>& plots,
+                                GrDeferredTextureUploadWritePixelsFn& writePixels,
+                                GrTextureProxy* proxy) {
+    TRACE_EVENT0("skia.gpu", TRACE_FUNC);
+    // Find the page area the plots' new data spans, and check that it is covered by plots in this
+    // upload. The texels outside their dirty rects then already hold the plots' CPU data, and can
+    // be written again along with the new data.
+    int numPlotsX = proxy->width() / plots[0]->fWidth;
+    uint64_t uploadedPlots = 0;
+    bool canBatch = plots.count() > 1;
+    SkIRect bounds = SkIRect::MakeEmpty();
+    for (const sk_sp<Plot>& plot : plots) {
+        if (plot->fDirtyRect.isEmpty()) {
+            continue;
+        }
+        uint64_t bit = (uint64_t)1 << (plot->fY * numPlotsX + plot->fX);
+        if (uploadedPlots & bit) {
+            // An evicted plot and its replacement both have data waiting.
+            canBatch = false;
+        }
+        uploadedPlots |= bit;
+        bounds.join(plot->fDirtyRect.makeOffset(plot->fOffset.fX, plot->fOffset.fY));
+    }
+    if (bounds.isEmpty()) {
+        return;
+    }
+    const Plot* first = plots[0].get();
+    int left = bounds.fLeft / first->fWidth, right = (bounds.fRight - 1) / first->fWidth;
+    int top = bounds.fTop / first->fHeight, bottom = (bounds.fBottom - 1) / first->fHeight;
+    for (int y = top; y <= bottom && canBatch; ++y) {
+        for (int x = left; x <= right; ++x) {
+            if (!(uploadedPlots & ((uint64_t)1 << (y * numPlotsX + x)))) {
+                canBatch = false;
+                break;
+            }
+        }
+    }
+    if (!canBatch) {
+        for (const sk_sp<Plot>& plot : plots) {
+            if (!plot->fDirtyRect.isEmpty()) {
+                plot->uploadToTexture(writePixels, proxy);
+            }
+        }
+        return;
+    }
+
+    // Clamp to 4-byte aligned boundaries, as in Plot::uploadToTexture. Plots are 4-byte aligned,
+    // so this stays within the plots found above.
+    size_t bpp = first->fBytesPerPixel;
+    unsigned int clearBits = 0x3 / bpp;
+    bounds.fLeft &= ~clearBits;
+    bounds.fRight = (bounds.fRight + clearBits) & ~clearBits;
+    size_t rowBytes = bpp * bounds.width();
+    SkAutoTMalloc<unsigned char> data(rowBytes * bounds.height());
+    for (const sk_sp<Plot>& plot : plots) {
+        if (plot->fDirtyRect.isEmpty()) {
+            continue;
+        }
+        SkIRect plotRect = SkIRect::MakeXYWH(plot->fOffset.fX, plot->fOffset.fY,
+                                             plot->fWidth, plot->fHeight);
+        SkIRect rect;
+        SkAssertResult(rect.intersect(plotRect, bounds));
+        size_t plotRowBytes = bpp * plot->fWidth;
+        const unsigned char* src = plot->fData + plotRowBytes * (rect.fTop - plotRect.fTop) +
+                                   bpp * (rect.fLeft - plotRect.fLeft);
+        unsigned char* dst = data.get() + rowBytes * (rect.fTop - bounds.fTop) +
+                             bpp * (rect.fLeft - bounds.fLeft);
+        for (int i = 0; i < rect.height(); ++i) {
+            memcpy(dst, src, bpp * rect.width());
+            src += plotRowBytes;
+            dst += rowBytes;
+        }
+        plot->fDirtyRect.setEmpty();
+        SkDEBUGCODE(plot->fDirty = false;)
+    }
+    auto colorType = GrPixelConfigToColorType(first->fConfig);
+    writePixels(proxy, bounds.fLeft, bounds.fTop, bounds.width(), bounds.height(), colorType,
+                data.get(), rowBytes);
 }
 
 inline bool GrDrawOpAtlas::updatePlot(GrDeferredUploadTarget* target, AtlasID* id, Plot* plot) {
@@ -213,25 +304,33 @@ inline bool GrDrawOpAtlas::updatePlot(GrDeferredUploadTarget* target, AtlasID* i
     // If our most recent upload has already occurred then we have to insert a new
     // upload. Otherwise, we already have a scheduled upload that hasn't yet ocurred.
     // This new update will piggy back on that previously scheduled update.
-    if (plot->lastUploadToken() < target->tokenTracker()->nextTokenToFlush()) {
-        // With c+14 we could move sk_sp into lamba to only ref once.
-        sk_sp<Plot> plotsp(SkRef(plot));
-
-        GrTextureProxy* proxy = fProxies[pageIdx].get();
-        SkASSERT(proxy->priv().isInstantiated());  // This is occurring at flush time
-
-        GrDeferredUploadToken lastUploadToken = target->addASAPUpload(
-                [plotsp, proxy](GrDeferredTextureUploadWritePixelsFn& writePixels) {
-                    plotsp->uploadToTexture(writePixels, proxy);
-                });
-        plot->setLastUploadToken(lastUploadToken);
+    GrDeferredUploadToken nextTokenToFlush = target->tokenTracker()->nextTokenToFlush();
+    if (plot->lastUploadToken() < nextTokenToFlush) {
+        // All of a page's plots that get new data before the next flush share one upload.
+        Page& page = fPages[pageIdx];
+        if (!page.fPendingUpload || page.fPendingUploadToken < nextTokenToFlush) {
+            page.fPendingUpload = sk_make_sp<PendingUpload>();
+            // With c+14 we could move sk_sp into lamba to only ref once.
+            sk_sp<PendingUpload> upload = page.fPendingUpload;
+
+            GrTextureProxy* proxy = fProxies[pageIdx].get();
+            SkASSERT(proxy->priv().isInstantiated());  // This is occurring at flush time
+
+            page.fPendingUploadToken = target->addASAPUpload(
+                    [upload, proxy](GrDeferredTextureUploadWritePixelsFn& writePixels) {
+                        UploadPlots(upload->fPlots, writePixels, proxy);
+                    });
+        }
+        page.fPendingUpload->fPlots.push_back(sk_ref_sp(plot));
+        plot->setLastUploadToken(page.fPendingUploadToken);
     }
     *id = plot->id();
     return true;
 }
 
 bool GrDrawOpAtlas::uploadToPage(unsigned int pageIdx, AtlasID* id, GrDeferredUploadTarget* target,
-                                 int width, int height, const void* image, SkIPoint16* loc) {
+                                 int width, int height, const void* image, SkIPoint16* loc,
+                                 Lifetime lifetime, bool mixLifetimes) {
     SkASSERT(fProxies[pageIdx] && fProxies[pageIdx]->priv().isInstantiated());
 
     // look through all allocated plots for one we can share, in Most Recently Refed order
@@ -240,8 +339,11 @@ bool GrDrawOpAtlas::uploadToPage(unsigned int pageIdx, AtlasID* id, GrDeferredUp
 
     for (Plot* plot = plotIter.get(); plot; plot = plotIter.next()) {
         SkASSERT(GrBytesPerPixel(fProxies[pageIdx]->config()) == plot->bpp());
+        if (fPackByLifetime && !mixLifetimes && !plot->isEmpty() && plot->lifetime() != lifetime) {
+            continue;
+        }
 
-        if (plot->addSubImage(width, height, image, loc)) {
+        if (plot->addSubImage(width, height, image, loc, lifetime)) {
             return this->updatePlot(target, id, plot);
         }
     }
@@ -260,7 +362,26 @@ static constexpr auto kRecentlyUsedCount = 256;
 GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceProvider,
                                                    AtlasID* id, GrDeferredUploadTarget* target,
                                                    int width, int height,
-                                                   const void* image, SkIPoint16* loc) {
+                                                   const void* image, SkIPoint16* loc,
+                                                   Lifetime lifetime) {
+    ErrorCode code = this->internalAddToAtlas(resourceProvider, id, target, width, height, image,
+                                              loc, lifetime);
+    if (ErrorCode::kSucceeded == code) {
+        size_t bytes = width * height * GrBytesPerPixel(fPixelConfig);
+        fFlushStats.fUploadedBytes += bytes;
+        if (Lifetime::kLong == lifetime) {
+            fFlushStats.fReuploadedBytes += bytes;
+        }
+    }
+    return code;
+}
+
+GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::internalAddToAtlas(GrResourceProvider* resourceProvider,
+                                                           AtlasID* id,
+                                                           GrDeferredUploadTarget* target,
+                                                           int width, int height,
+                                                           const void* image, SkIPoint16* loc,
+                                                           Lifetime lifetime) {
     if (width > fPlotWidth || height > fPlotHeight) {
         return ErrorCode::kError;
     }
@@ -269,10 +390,19 @@ GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceP
     // We prioritize this upload to the first pages, not the most recently used, to make it easier
     // to remove unused pages in reverse page order.
     for (unsigned int pageIdx = 0; pageIdx < fNumActivePages; ++pageIdx) {
-        if (this->uploadToPage(pageIdx, id, target, width, height, image, loc)) {
+        if (this->uploadToPage(pageIdx, id, target, width, height, image, loc, lifetime, false)) {
             return ErrorCode::kSucceeded;
         }
     }
+    // When packing by lifetime, mixing lifetimes in a plot still beats evicting one.
+    if (fPackByLifetime) {
+        for (unsigned int pageIdx = 0; pageIdx < fNumActivePages; ++pageIdx) {
+            if (this->uploadToPage(pageIdx, id, target, width, height, image, loc, lifetime,
+                                   true)) {
+                return ErrorCode::kSucceeded;
+            }
+        }
+    }
 
     // If the above fails, then see if the least recently used plot per page has already been
     // flushed to the gpu if we're at max page allocation, or if the plot has aged out otherwise.
@@ -287,7 +417,7 @@ GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceP
                 plot->flushesSinceLastUsed() >= kRecentlyUsedCount) {
                 this->processEvictionAndResetRects(plot);
                 SkASSERT(GrBytesPerPixel(fProxies[pageIdx]->config()) == plot->bpp());
-                SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc);
+                SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc, lifetime);
                 SkASSERT(verify);
                 if (!this->updatePlot(target, id, plot)) {
                     return ErrorCode::kError;
@@ -301,7 +431,8 @@ GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceP
             return ErrorCode::kError;
         }
 
-        if (this->uploadToPage(fNumActivePages-1, id, target, width, height, image, loc)) {
+        if (this->uploadToPage(fNumActivePages-1, id, target, width, height, image, loc,
+                               lifetime, false)) {
             return ErrorCode::kSucceeded;
         } else {
             // If we fail to upload to a newly activated page then something has gone terribly
@@ -342,7 +473,7 @@ GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceP
 
     fPages[pageIdx].fPlotList.addToHead(newPlot.get());
     SkASSERT(GrBytesPerPixel(fProxies[pageIdx]->config()) == newPlot->bpp());
-    SkDEBUGCODE(bool verify = )newPlot->addSubImage(width, height, image, loc);
+    SkDEBUGCODE(bool verify = )newPlot->addSubImage(width, height, image, loc, lifetime);
     SkASSERT(verify);
 
     // Note that this plot will be uploaded inline with the draws whereas the
@@ -364,9 +495,22 @@ GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceP
     return ErrorCode::kSucceeded;
 }
 
+void GrDrawOpAtlas::endFlushStats() {
+    fLastFlushStats = fFlushStats;
+    fFlushStats = FlushStats();
+#ifdef DUMP_ATLAS_DATA
+    if (gDumpAtlasData) {
+        SkDebugf("evictions: %d, uploaded bytes: %zu, reuploaded bytes: %zu\n",
+                 fLastFlushStats.fEvictions, fLastFlushStats.fUploadedBytes,
+                 fLastFlushStats.fReuploadedBytes);
+    }
+#endif
+}
+
 void GrDrawOpAtlas::compact(GrDeferredUploadToken startTokenForNextFlush) {
     if (fNumActivePages <= 1) {
         fPrevFlushToken = startTokenForNextFlush;
+        this->endFlushStats();
         return;
     }
 
@@ -506,10 +650,12 @@ void GrDrawOpAtlas::compact(GrDeferredUploadToken startTokenForNextFlush) {
     }
 
     fPrevFlushToken = startTokenForNextFlush;
+    this->endFlushStats();
 }
 
-bool GrDrawOpAtlas::createPages(GrProxyProvider* proxyProvider) {
+bool GrDrawOpAtlas::createPage(uint32_t pageIdx) {
     SkASSERT(SkIsPow2(fTextureWidth) && SkIsPow2(fTextureHeight));
+    SkASSERT(!fProxies[pageIdx]);
 
     GrSurfaceDesc desc;
     desc.fFlags = kNone_GrSurfaceFlags;
@@ -520,29 +666,26 @@ bool GrDrawOpAtlas::createPages(GrProxyProvider* proxyProvider) {
     int numPlotsX = fTextureWidth/fPlotWidth;
     int numPlotsY = fTextureHeight/fPlotHeight;
 
-    for (uint32_t i = 0; i < this->maxPages(); ++i) {
-        fProxies[i] = proxyProvider->createProxy(desc, kTopLeft_GrSurfaceOrigin,
-                SkBackingFit::kExact, SkBudgeted::kYes, GrInternalSurfaceFlags::kNoPendingIO);
-        if (!fProxies[i]) {
-            return false;
-        }
+    fProxies[pageIdx] = fProxyProvider->createProxy(desc, kTopLeft_GrSurfaceOrigin,
+            SkBackingFit::kExact, SkBudgeted::kYes, GrInternalSurfaceFlags::kNoPendingIO);
+    if (!fProxies[pageIdx]) {
+        return false;
+    }
 
-        // set up allocated plots
-        fPages[i].fPlotArray.reset(new sk_sp<Plot>[ numPlotsX * numPlotsY ]);
+    // set up allocated plots
+    fPages[pageIdx].fPlotArray.reset(new sk_sp<Plot>[ numPlotsX * numPlotsY ]);
 
-        sk_sp<Plot>* currPlot = fPages[i].fPlotArray.get();
-        for (int y = numPlotsY - 1, r = 0; y >= 0; --y, ++r) {
-            for (int x = numPlotsX - 1, c = 0; x >= 0; --x, ++c) {
-                uint32_t plotIndex = r * numPlotsX + c;
-                currPlot->reset(new Plot(i, plotIndex, 1, x, y, fPlotWidth, fPlotHeight,
-                                         fPixelConfig));
+    sk_sp<Plot>* currPlot = fPages[pageIdx].fPlotArray.get();
+    for (int y = numPlotsY - 1, r = 0; y >= 0; --y, ++r) {
+        for (int x = numPlotsX - 1, c = 0; x >= 0; --x, ++c) {
+            uint32_t plotIndex = r * numPlotsX + c;
+            currPlot->reset(new Plot(pageIdx, plotIndex, 1, x, y, fPlotWidth, fPlotHeight,
+                                     fPixelConfig));
 
-                // build LRU list
-                fPages[i].fPlotList.addToHead(currPlot->get());
-                ++currPlot;
-            }
+            // build LRU list
+            fPages[pageIdx].fPlotList.addToHead(currPlot->get());
+            ++currPlot;
         }
-
     }
 
     return true;
@@ -552,6 +695,10 @@ bool GrDrawOpAtlas::createPages(GrProxyProvider* proxyProvider) {
 bool GrDrawOpAtlas::activateNewPage(GrResourceProvider* resourceProvider) {
     SkASSERT(fNumActivePages < this->maxPages());
 
+    // Pages past the first are only created once the atlas grows into them.
+    if (!fProxies[fNumActivePages] && !this->createPage(fNumActivePages)) {
+        return false;
+    }
     if (!fProxies[fNumActivePages]->instantiate(resourceProvider)) {
         return false;
     }
@@ -593,5 +740,6 @@ inline void GrDrawOpAtlas::deactivateLastPage() {
 
     // remove ref to the backing texture
     fProxies[lastPageIndex]->deInstantiate();
+    fPages[lastPageIndex].fPendingUpload.reset();
     --fNumActivePages;
 }
@@ -108,6 +108,10 @@ public:
      * 'kError' will be returned when some unrecoverable error was encountered while trying to
      * add the subimage. In this case the op being created should be discarded.
      *
+     * 'lifetime' says whether the subimage is expected to stay in use for a long time, e.g.
+     * because it was evicted before and is needed again. It only matters if the atlas packs by
+     * lifetime (see setPackByLifetime).
+     *
      * NOTE: When the GrDrawOp prepares a draw that reads from the atlas, it must immediately call
      * 'setUseToken' with the currentToken from the GrDrawOp::Target, otherwise the next call to
      * addToAtlas might cause the previous data to be overwritten before it has been read.
@@ -119,9 +123,31 @@ public:
         kTryAgain
     };
 
+    enum class Lifetime : bool { kShort, kLong };
+
     ErrorCode addToAtlas(GrResourceProvider*, AtlasID*, GrDeferredUploadTarget*,
                          int width, int height,
-                         const void* image, SkIPoint16* loc);
+                         const void* image, SkIPoint16* loc,
+                         Lifetime lifetime = Lifetime::kShort);
+
+    /**
+     * If true, the atlas keeps long-lived subimages in plots apart from short-lived ones, as long
+     * as it has room to. The least recently used plots, which are evicted first, then mostly hold
+     * short-lived data that is no longer needed, rather than a mix that has to be uploaded again.
+     */
+    void setPackByLifetime(bool packByLifetime) { fPackByLifetime = packByLifetime; }
+
+    /** How much the atlas' contents changed during a flush. */
+    struct FlushStats {
+        // Plots evicted, and so emptied, to make room or to compact the atlas.
+        int    fEvictions = 0;
+        // Bytes of all subimages added, and of those added with Lifetime::kLong.
+        size_t fUploadedBytes = 0;
+        size_t fReuploadedBytes = 0;
+    };
+
+    /** The stats of the flush that the last call to compact() ended. */
+    const FlushStats& lastFlushStats() const { return fLastFlushStats; }
 
     const sk_sp<GrTextureProxy>* getProxies() const { return fProxies; }
 
@@ -274,7 +300,15 @@ private:
         }
         SkDEBUGCODE(size_t bpp() const { return fBytesPerPixel; })
 
-        bool addSubImage(int width, int height, const void* image, SkIPoint16* loc);
+        bool addSubImage(int width, int height, const void* image, SkIPoint16* loc,
+                         Lifetime lifetime);
+
+        /**
+         * A plot takes the lifetime of the first subimage added to it after it was last reset.
+         * An atlas that packs by lifetime prefers to add subimages to plots of the same lifetime.
+         */
+        bool isEmpty() const { return !fHasSubImages; }
+        Lifetime lifetime() const { return fLifetime; }
 
         /**
          * To manage the lifetime of a plot, we use two tokens. We use the last upload token to
@@ -322,6 +356,8 @@ private:
         GrDeferredUploadToken fLastUse;
         // the number of flushes since this plot has been last used
         int                   fFlushesSinceLastUse;
+        bool                  fHasSubImages;
+        Lifetime              fLifetime;
 
         struct {
             const uint32_t fPageIndex : 16;
@@ -371,14 +407,23 @@ private:
         // the front and remove from the back there is no need for MRU.
     }
 
+    ErrorCode internalAddToAtlas(GrResourceProvider*, AtlasID*, GrDeferredUploadTarget*,
+                                 int width, int height, const void* image, SkIPoint16* loc,
+                                 Lifetime);
+
+    // If 'mixLifetimes' is false and the atlas packs by lifetime, only plots that are empty or
+    // have the same lifetime are considered.
     bool uploadToPage(unsigned int pageIdx, AtlasID* id, GrDeferredUploadTarget* target,
-                      int width, int height, const void* image, SkIPoint16* loc);
+                      int width, int height, const void* image, SkIPoint16* loc,
+                      Lifetime lifetime, bool mixLifetimes);
 
-    bool createPages(GrProxyProvider*);
+    bool createPage(uint32_t pageIdx);
     bool activateNewPage(GrResourceProvider*);
     void deactivateLastPage();
 
     void processEviction(AtlasID);
+    // Makes fFlushStats the last flush's stats, and starts counting the next flush's.
+    void endFlushStats();
     inline void processEvictionAndResetRects(Plot* plot) {
         this->processEviction(plot->id());
         plot->resetRects();
@@ -402,11 +447,24 @@ private:
 
     SkTDArray<EvictionData> fEvictionCallbacks;
 
+    // The plots of a page that got new data since the page's last ASAP upload.
+    struct PendingUpload : public SkRefCnt {
+        SkSTArray<4, sk_sp<Plot>> fPlots;
+    };
+
+    // Writes the plots' new data to the page. If the data's bounds are covered by these plots,
+    // which is typical while an atlas fills up, this is a single writePixels.
+    static void UploadPlots(const SkTArray<sk_sp<Plot>>&, GrDeferredTextureUploadWritePixelsFn&,
+                            GrTextureProxy*);
+
     struct Page {
         // allocated array of Plots
         std::unique_ptr<sk_sp<Plot>[]> fPlotArray;
         // LRU list of Plots (MRU at head - LRU at tail)
         PlotList fPlotList;
+        // The page's most recent ASAP upload, which plots can join until it happens.
+        sk_sp<PendingUpload> fPendingUpload;
+        GrDeferredUploadToken fPendingUploadToken = GrDeferredUploadToken::AlreadyFlushedToken();
     };
     // proxies kept separate to make it easier to pass them up to client
     sk_sp<GrTextureProxy> fProxies[kMaxMultitexturePages];
@@ -414,6 +472,12 @@ private:
     uint32_t fMaxPages;
 
     uint32_t fNumActivePages;
+
+    bool fPackByLifetime;
+    // Creates the pages after the first when the atlas grows into them.
+    GrProxyProvider* fProxyProvider;
+    FlushStats fFlushStats;
+    FlushStats fLastFlushStats;
 };
 
 #endif
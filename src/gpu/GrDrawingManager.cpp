@@ -8,6 +8,7 @@
 #include "GrDrawingManager.h"
 
 #include "GrBackendSemaphore.h"
+#include "GrClipMaskCache.h"
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "GrGpu.h"
@@ -18,6 +19,7 @@
 #include "GrResourceAllocator.h"
 #include "GrResourceProvider.h"
 #include "GrSoftwarePathRenderer.h"
+#include "GrStreamingBufferRing.h"
 #include "GrSurfaceProxyPriv.h"
 #include "GrTextureContext.h"
 #include "GrTextureOpList.h"
@@ -30,6 +32,7 @@
 
 #include "GrTracing.h"
 #include "text/GrAtlasTextContext.h"
+#include "text/GrTextBlobCache.h"
 
 // Turn on/off the sorting of opLists at flush time
 #ifndef SK_DISABLE_RENDER_TARGET_SORTING
@@ -41,7 +44,9 @@ GrDrawingManager::GrDrawingManager(GrContext* context,
                                    const GrAtlasTextContext::Options& optionsForAtlasTextContext,
                                    GrSingleOwner* singleOwner,
                                    bool explicitlyAllocating,
-                                   GrContextOptions::Enable sortRenderTargets)
+                                   GrContextOptions::Enable sortRenderTargets,
+                                   bool indexOpBounds,
+                                   bool reuseLargerSurfaces)
         : fContext(context)
         , fOptionsForPathRendererChain(optionsForPathRendererChain)
         , fOptionsForAtlasTextContext(optionsForAtlasTextContext)
@@ -50,7 +55,9 @@ GrDrawingManager::GrDrawingManager(GrContext* context,
         , fAtlasTextContext(nullptr)
         , fPathRendererChain(nullptr)
         , fSoftwarePathRenderer(nullptr)
-        , fFlushing(false) {
+        , fFlushing(false)
+        , fIndexOpBounds(indexOpBounds)
+        , fReuseLargerSurfaces(reuseLargerSurfaces) {
 
     if (GrContextOptions::Enable::kNo == sortRenderTargets) {
         fSortRenderTargets = false;
@@ -82,6 +89,11 @@ void GrDrawingManager::cleanup() {
     delete fPathRendererChain;
     fPathRendererChain = nullptr;
     SkSafeSetNull(fSoftwarePathRenderer);
+    fClipMaskCache.reset();
+    if (fStreamingBufferRing) {
+        fStreamingBufferRing->reset(fAbandoned);
+        fStreamingBufferRing.reset();
+    }
 
     fOnFlushCBObjects.reset();
 }
@@ -107,6 +119,11 @@ void GrDrawingManager::freeGpuResources() {
     delete fPathRendererChain;
     fPathRendererChain = nullptr;
     SkSafeSetNull(fSoftwarePathRenderer);
+    // as do cached clip masks and recycled vertex buffers
+    fClipMaskCache.reset();
+    if (fStreamingBufferRing) {
+        fStreamingBufferRing->reset(false);
+    }
 }
 
 // MDB TODO: make use of the 'proxy' parameter.
@@ -156,7 +173,7 @@ GrSemaphoresSubmitted GrDrawingManager::internalFlush(GrSurfaceProxy*,
     }
 
     GrOpFlushState flushState(gpu, fContext->contextPriv().resourceProvider(),
-                              &fTokenTracker);
+                              &fTokenTracker, this->getStreamingBufferRing());
 
     GrOnFlushResourceProvider onFlushProvider(this);
     // TODO: AFAICT the only reason fFlushState is on GrDrawingManager rather than on the
@@ -205,7 +222,8 @@ GrSemaphoresSubmitted GrDrawingManager::internalFlush(GrSurfaceProxy*,
     bool flushed = false;
 
     {
-        GrResourceAllocator alloc(fContext->contextPriv().resourceProvider());
+        GrResourceAllocator alloc(fContext->contextPriv().resourceProvider(),
+                                  fReuseLargerSurfaces);
         for (int i = 0; i < fOpLists.count(); ++i) {
             fOpLists[i]->gatherProxyIntervals(&alloc);
             alloc.markEndOfOpList(i);
@@ -237,6 +255,9 @@ GrSemaphoresSubmitted GrDrawingManager::internalFlush(GrSurfaceProxy*,
     fOpLists.reset();
 
     GrSemaphoresSubmitted result = gpu->finishFlush(numSemaphores, backendSemaphores);
+    if (fStreamingBufferRing) {
+        fStreamingBufferRing->endFlush();
+    }
 
     flushState.uninstantiateProxyTracker()->uninstantiateAllProxies();
 
@@ -248,6 +269,7 @@ GrSemaphoresSubmitted GrDrawingManager::internalFlush(GrSurfaceProxy*,
         onFlushCBObject->postFlush(fTokenTracker.nextTokenToFlush(), fFlushingOpListIDs.begin(),
                                    fFlushingOpListIDs.count());
     }
+    fContext->contextPriv().getTextBlobCache()->didFlush();
     fFlushingOpListIDs.reset();
     fFlushing = false;
 
@@ -261,6 +283,32 @@ static void end_oplist_flush_if_not_unique(const sk_sp<GrOpList>& opList) {
     }
 }
 
+void GrDrawingManager::regenerateMipMaps(int startIndex, int stopIndex, GrGpu* gpu) {
+    SkSTArray<16, GrTextureProxy*> proxies;
+    for (int i = startIndex; i < stopIndex; ++i) {
+        if (GrRenderTargetOpList* opList = fOpLists[i] ? fOpLists[i]->asRenderTargetOpList()
+                                                       : nullptr) {
+            opList->gatherDirtyMipMapProxies(&proxies);
+        }
+    }
+
+    SkSTArray<16, GrTexture*> textures;
+    SkSTArray<16, GrSurfaceOrigin> origins;
+    for (GrTextureProxy* proxy : proxies) {
+        // Textures that are rendered to in this flush would have their mips dirtied again before
+        // they are sampled, so leave them to the draws.
+        bool isTarget = false;
+        for (int i = startIndex; i < stopIndex && !isTarget; ++i) {
+            isTarget = fOpLists[i] && fOpLists[i]->fTarget.get() == proxy;
+        }
+        if (!isTarget) {
+            textures.push_back(proxy->priv().peekTexture());
+            origins.push_back(proxy->origin());
+        }
+    }
+    gpu->regenerateMipMapLevels(textures.begin(), origins.begin(), textures.count());
+}
+
 bool GrDrawingManager::executeOpLists(int startIndex, int stopIndex, GrOpFlushState* flushState) {
     SkASSERT(startIndex <= stopIndex && stopIndex <= fOpLists.count());
 
@@ -305,6 +353,10 @@ bool GrDrawingManager::executeOpLists(int startIndex, int stopIndex, GrOpFlushSt
     // Upload all data to the GPU
     flushState->preExecuteDraws();
 
+    if (fContext->caps()->batchMipMapRegeneration()) {
+        this->regenerateMipMaps(startIndex, stopIndex, flushState->gpu());
+    }
+
     // Execute the onFlush op lists first, if any.
     for (sk_sp<GrOpList>& onFlushOpList : fOnFlushCBOpLists) {
         if (!onFlushOpList->execute(flushState)) {
@@ -394,6 +446,19 @@ void GrDrawingManager::copyOpListsFromDDL(const SkDeferredDisplayList* ddl,
     fOpLists.push_back_n(ddl->fOpLists.count(), ddl->fOpLists.begin());
 }
 
+void GrDrawingManager::copyOpListsFromDDLs(int count, const SkDeferredDisplayList* const ddls[],
+                                           GrRenderTargetProxy* const newDests[]) {
+    int numOpLists = 0;
+    for (int i = 0; i < count; ++i) {
+        numOpLists += ddls[i]->fOpLists.count();
+    }
+    fOpLists.reserve(numOpLists);
+
+    for (int i = 0; i < count; ++i) {
+        this->copyOpListsFromDDL(ddls[i], newDests[i]);
+    }
+}
+
 sk_sp<GrRenderTargetOpList> GrDrawingManager::newRTOpList(GrRenderTargetProxy* rtp,
                                                           bool managedOpList) {
     SkASSERT(fContext);
@@ -410,7 +475,8 @@ sk_sp<GrRenderTargetOpList> GrDrawingManager::newRTOpList(GrRenderTargetProxy* r
     sk_sp<GrRenderTargetOpList> opList(new GrRenderTargetOpList(
                                                         resourceProvider,
                                                         rtp,
-                                                        fContext->contextPriv().getAuditTrail()));
+                                                        fContext->contextPriv().getAuditTrail(),
+                                                        fIndexOpBounds));
     SkASSERT(rtp->getLastOpList() == opList.get());
 
     if (managedOpList) {
@@ -469,7 +535,9 @@ GrPathRenderer* GrDrawingManager::getPathRenderer(const GrPathRenderer::CanDrawP
         if (!fSoftwarePathRenderer) {
             fSoftwarePathRenderer =
                     new GrSoftwarePathRenderer(fContext->contextPriv().proxyProvider(),
-                                               fOptionsForPathRendererChain.fAllowPathMaskCaching);
+                                               fOptionsForPathRendererChain.fAllowPathMaskCaching,
+                                               fOptionsForPathRendererChain
+                                                       .fCacheClippedSoftwarePathMasks);
         }
         if (GrPathRenderer::CanDrawPath::kNo != fSoftwarePathRenderer->canDrawPath(args)) {
             pr = fSoftwarePathRenderer;
@@ -486,6 +554,20 @@ GrCoverageCountingPathRenderer* GrDrawingManager::getCoverageCountingPathRendere
     return fPathRendererChain->getCoverageCountingPathRenderer();
 }
 
+GrClipMaskCache* GrDrawingManager::getClipMaskCache() {
+    if (!fClipMaskCache) {
+        fClipMaskCache.reset(new GrClipMaskCache);
+    }
+    return fClipMaskCache.get();
+}
+
+GrStreamingBufferRing* GrDrawingManager::getStreamingBufferRing() {
+    if (!fStreamingBufferRing && !fAbandoned && fContext->caps()->useStreamingBufferRing()) {
+        fStreamingBufferRing.reset(new GrStreamingBufferRing(fContext->contextPriv().getGpu()));
+    }
+    return fStreamingBufferRing.get();
+}
+
 sk_sp<GrRenderTargetContext> GrDrawingManager::makeRenderTargetContext(
                                                             sk_sp<GrSurfaceProxy> sProxy,
                                                             sk_sp<SkColorSpace> colorSpace,
@@ -15,6 +15,8 @@
 #include "SkTArray.h"
 #include "text/GrAtlasTextContext.h"
 
+class GrClipMaskCache;
+class GrStreamingBufferRing;
 class GrContext;
 class GrCoverageCountingPathRenderer;
 class GrOnFlushCallbackObject;
@@ -63,6 +65,13 @@ public:
     // supported and turned on.
     GrCoverageCountingPathRenderer* getCoverageCountingPathRenderer();
 
+    // Returns the cache of recently used clip masks keyed by clip content.
+    GrClipMaskCache* getClipMaskCache();
+
+    // Returns the ring that recycles vertex and index buffers across flushes, or null if it is not
+    // supported and turned on.
+    GrStreamingBufferRing* getStreamingBufferRing();
+
     void flushIfNecessary() {
         GrResourceCache* resourceCache = fContext->contextPriv().getResourceCache();
         if (resourceCache && resourceCache->requestsFlush()) {
@@ -81,11 +90,16 @@ public:
 
     void moveOpListsToDDL(SkDeferredDisplayList* ddl);
     void copyOpListsFromDDL(const SkDeferredDisplayList*, GrRenderTargetProxy* newDest);
+    // Copy the opLists of all the DDLs, which must be distinct, in order. They're then sorted
+    // and flushed together with everything else at the next flush.
+    void copyOpListsFromDDLs(int count, const SkDeferredDisplayList* const[],
+                             GrRenderTargetProxy* const newDests[]);
 
 private:
     GrDrawingManager(GrContext*, const GrPathRendererChain::Options&,
                      const GrAtlasTextContext::Options&, GrSingleOwner*,
-                     bool explicitlyAllocating, GrContextOptions::Enable sortRenderTargets);
+                     bool explicitlyAllocating, GrContextOptions::Enable sortRenderTargets,
+                     bool indexOpBounds, bool reuseLargerSurfaces);
 
     void abandon();
     void cleanup();
@@ -93,6 +107,10 @@ private:
     // return true if any opLists were actually executed; false otherwise
     bool executeOpLists(int startIndex, int stopIndex, GrOpFlushState*);
 
+    // Regenerates the dirty mips of the textures sampled by the opLists in one pass before they
+    // execute.
+    void regenerateMipMaps(int startIndex, int stopIndex, GrGpu*);
+
     GrSemaphoresSubmitted flush(GrSurfaceProxy* proxy,
                                 int numSemaphores = 0,
                                 GrBackendSemaphore backendSemaphores[] = nullptr) {
@@ -129,10 +147,14 @@ private:
 
     GrPathRendererChain*              fPathRendererChain;
     GrSoftwarePathRenderer*           fSoftwarePathRenderer;
+    std::unique_ptr<GrClipMaskCache>  fClipMaskCache;
+    std::unique_ptr<GrStreamingBufferRing> fStreamingBufferRing;
 
     GrTokenTracker                    fTokenTracker;
     bool                              fFlushing;
     bool                              fSortRenderTargets;
+    bool                              fIndexOpBounds;
+    bool                              fReuseLargerSurfaces;
 
     SkTArray<GrOnFlushCallbackObject*> fOnFlushCBObjects;
 };
@@ -37,6 +37,9 @@ struct GrGlyph {
     GrIRect16             fBounds;
     SkIPoint16            fAtlasLocation;
     bool                  fTooLargeForAtlas;
+    // Set once the glyph has been added to the atlas. A glyph that is added again after being
+    // evicted is likely to stay in use, so the atlas packs it with other long-lived glyphs.
+    bool                  fWasAtlased;
 
     void init(GrGlyph::PackedID packed, const SkIRect& bounds, GrMaskFormat format) {
         fID = GrDrawOpAtlas::kInvalidAtlasID;
@@ -46,6 +49,7 @@ struct GrGlyph {
         fMaskFormat = format;
         fAtlasLocation.set(0, 0);
         fTooLargeForAtlas = GrDrawOpAtlas::GlyphTooLargeForAtlas(bounds.width(), bounds.height());
+        fWasAtlased = false;
     }
 
     void reset() {
@@ -214,6 +214,16 @@ bool GrGpu::copySurface(GrSurface* dst, GrSurfaceOrigin dstOrigin,
                                canDiscardOutsideDstRect);
 }
 
+void GrGpu::regenerateMipMapLevels(GrTexture* const textures[], const GrSurfaceOrigin origins[],
+                                   int count) {
+    GR_CREATE_TRACE_MARKER_CONTEXT("GrGpu", "regenerateMipMapLevels", fContext);
+    if (!count) {
+        return;
+    }
+    this->handleDirtyContext();
+    fStats.incBatchedMipMapRegenerations(this->onRegenerateMipMapLevels(textures, origins, count));
+}
+
 bool GrGpu::getReadPixelsInfo(GrSurface* srcSurface, GrSurfaceOrigin srcOrigin, int width,
                               int height, size_t rowBytes, GrColorType dstColorType,
                               GrSRGBConversion srgbConversion, DrawPreference* drawPreference,
@@ -40,6 +40,7 @@ class GrStencilSettings;
 class GrSurface;
 class GrTexture;
 class SkJSONWriter;
+class SkTraceMemoryDump;
 
 class GrGpu : public SkRefCnt {
 public:
@@ -387,6 +388,21 @@ public:
      */
     virtual sk_sp<GrSemaphore> prepareTextureForCrossContextUsage(GrTexture*) = 0;
 
+    /**
+     * Frees any memory the backend keeps around to make later resources from, but which currently
+     * holds none.
+     */
+    virtual void releaseUnusedMemory() {}
+
+    /**
+     * Regenerates the dirty mip levels of the textures together, before the op lists of a flush
+     * execute. Otherwise each texture's levels are regenerated by the first draw that samples it
+     * with mip filtering, in between that draw's state changes. Textures the backend can't handle
+     * here are left to be regenerated by their draws.
+     */
+    void regenerateMipMapLevels(GrTexture* const textures[], const GrSurfaceOrigin origins[],
+                                int count);
+
     ///////////////////////////////////////////////////////////////////////////
     // Debugging and Stats
 
@@ -404,6 +420,12 @@ public:
             fStencilAttachmentCreates = 0;
             fNumDraws = 0;
             fNumFailedDraws = 0;
+            fTessellations = 0;
+            fTessellationCacheHits = 0;
+            fTessellationMs = 0;
+            fMipMapRegenerations = 0;
+            fBatchedMipMapRegenerations = 0;
+            fRedundantStateCallsAvoided = 0;
         }
 
         int renderTargetBinds() const { return fRenderTargetBinds; }
@@ -423,6 +445,22 @@ public:
         void dumpKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>* values);
         int numDraws() const { return fNumDraws; }
         int numFailedDraws() const { return fNumFailedDraws; }
+        // Paths GrTessellatingPathRenderer ran GrTessellator on, and the time that took.
+        int tessellations() const { return fTessellations; }
+        double tessellationMs() const { return fTessellationMs; }
+        void incTessellations(double ms) { fTessellations++; fTessellationMs += ms; }
+        // Paths GrTessellatingPathRenderer drew from a cached vertex buffer instead.
+        int tessellationCacheHits() const { return fTessellationCacheHits; }
+        void incTessellationCacheHits() { fTessellationCacheHits++; }
+        // Textures whose dirty mips were regenerated by a draw, and together at the start of a
+        // flush (see regenerateMipMapLevels()).
+        int mipMapRegenerations() const { return fMipMapRegenerations; }
+        void incMipMapRegenerations() { fMipMapRegenerations++; }
+        int batchedMipMapRegenerations() const { return fBatchedMipMapRegenerations; }
+        void incBatchedMipMapRegenerations(int n) { fBatchedMipMapRegenerations += n; }
+        // Backend API calls skipped because they would have set state to its current value.
+        int redundantStateCallsAvoided() const { return fRedundantStateCallsAvoided; }
+        void incRedundantStateCallsAvoided() { fRedundantStateCallsAvoided++; }
     private:
         int fRenderTargetBinds;
         int fShaderCompilations;
@@ -432,6 +470,12 @@ public:
         int fStencilAttachmentCreates;
         int fNumDraws;
         int fNumFailedDraws;
+        int fTessellations;
+        int fTessellationCacheHits;
+        double fTessellationMs;
+        int fMipMapRegenerations;
+        int fBatchedMipMapRegenerations;
+        int fRedundantStateCallsAvoided;
 #else
         void dump(SkString*) {}
         void dumpKeyValuePairs(SkTArray<SkString>*, SkTArray<double>*) {}
@@ -443,12 +487,23 @@ public:
         void incStencilAttachmentCreates() {}
         void incNumDraws() {}
         void incNumFailedDraws() {}
+        void incTessellations(double) {}
+        void incTessellationCacheHits() {}
+        void incMipMapRegenerations() {}
+        void incBatchedMipMapRegenerations(int) {}
+        void incRedundantStateCallsAvoided() {}
 #endif
     };
 
     Stats* stats() { return &fStats; }
     void dumpJSON(SkJSONWriter*) const;
 
+    /**
+     * Reports memory the backend holds beyond what each GrGpuResource reports for itself, e.g. the
+     * device memory that resources are sub-allocated from.
+     */
+    virtual void dumpMemoryStatistics(SkTraceMemoryDump*) const {}
+
 #if GR_TEST_UTILS
     /** Creates a texture directly in the backend API without wrapping it in a GrTexture. This is
         only to be used for testing (particularly for testing the methods that import an externally
@@ -584,6 +639,12 @@ private:
                                const SkIRect& srcRect, const SkIPoint& dstPoint,
                                bool canDiscardOutsideDstRect) = 0;
 
+    // overridden by backend specific derived class to regenerate mips ahead of the draws. Returns
+    // the number of textures whose mips were regenerated.
+    virtual int onRegenerateMipMapLevels(GrTexture* const[], const GrSurfaceOrigin[], int) {
+        return 0;
+    }
+
     virtual void onFinishFlush(bool insertedSemaphores) = 0;
 
     virtual void onDumpJSON(SkJSONWriter*) const {}
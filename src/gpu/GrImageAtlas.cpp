@@ -0,0 +1,173 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrImageAtlas.h"
+#include "GrCaps.h"
+#include "GrDeferredUpload.h"
+#include "GrProxyProvider.h"
+#include "GrRectanizer.h"
+#include "GrTextureProxy.h"
+#include "SkGr.h"
+#include "SkIPoint16.h"
+#include "SkMathPriv.h"
+
+constexpr int GrImageAtlas::kMaxImageSize;
+constexpr int GrImageAtlas::kMaxPages;
+constexpr int GrImageAtlas::kMinCandidatesBeforePacking;
+
+static constexpr int kMinPageSize = 512;
+static constexpr int kMaxPageSize = 4096;
+// Pages are sized so that at least this many images of the common size fit across a page.
+static constexpr int kImagesAcrossPage = 8;
+// Each image is surrounded by a copy of its edge pixels.
+static constexpr int kBorder = 1;
+
+GrImageAtlas::GrImageAtlas(GrProxyProvider* proxyProvider, const GrCaps& caps)
+        : fProxyProvider(proxyProvider)
+        , fConfig(SkImageInfo2GrPixelConfig(kN32_SkColorType, nullptr, caps))
+        , fMaxTextureSize(SkTMin(caps.maxTextureSize(), kMaxPageSize)) {
+    if (!caps.isConfigTexturable(fConfig)) {
+        fConfig = kUnknown_GrPixelConfig;
+    }
+}
+
+GrImageAtlas::~GrImageAtlas() {}
+
+bool GrImageAtlas::isCandidate(const SkBitmap& bitmap) const {
+    return kUnknown_GrPixelConfig != fConfig && kN32_SkColorType == bitmap.colorType() &&
+           kUnpremul_SkAlphaType != bitmap.alphaType() && !bitmap.colorSpace() &&
+           bitmap.getPixels() && bitmap.width() > 0 && bitmap.height() > 0 &&
+           bitmap.width() <= kMaxImageSize && bitmap.height() <= kMaxImageSize;
+}
+
+int GrImageAtlas::choosePageSize() const {
+    // Size the pages for the 90th percentile image so that a few large images don't inflate them.
+    int total = 0;
+    for (int i = 0; i < kNumSizeBuckets; ++i) {
+        total += fSizeHistogram[i];
+    }
+    int bucket = 0;
+    for (int seen = 0; bucket < kNumSizeBuckets - 1; ++bucket) {
+        seen += fSizeHistogram[bucket];
+        if (10 * seen >= 9 * total) {
+            break;
+        }
+    }
+    int imageSize = (16 << bucket) + 2 * kBorder;
+    int pageSize = SkNextPow2(kImagesAcrossPage * imageSize);
+    return SkTMin(SkTMax(pageSize, kMinPageSize), fMaxTextureSize);
+}
+
+bool GrImageAtlas::addToPage(int width, int height, int* pageIdx, SkIPoint* location) {
+    SkIPoint16 loc;
+    for (int i = 0; i < fPages.count(); ++i) {
+        if (fPages[i].fRectanizer->addRect(width, height, &loc)) {
+            *pageIdx = i;
+            location->set(loc.fX, loc.fY);
+            return true;
+        }
+    }
+    if (fPages.count() >= kMaxPages) {
+        return false;
+    }
+
+    GrSurfaceDesc desc;
+    desc.fFlags = kNone_GrSurfaceFlags;
+    desc.fWidth = fPageSize;
+    desc.fHeight = fPageSize;
+    desc.fConfig = fConfig;
+    sk_sp<GrTextureProxy> proxy = fProxyProvider->createProxy(desc, kTopLeft_GrSurfaceOrigin,
+                                                              SkBackingFit::kExact,
+                                                              SkBudgeted::kYes);
+    if (!proxy) {
+        return false;
+    }
+    Page& page = fPages.push_back();
+    page.fProxy = std::move(proxy);
+    page.fRectanizer.reset(GrRectanizer::Factory(fPageSize, fPageSize));
+    if (!page.fRectanizer->addRect(width, height, &loc)) {
+        return false;
+    }
+    *pageIdx = fPages.count() - 1;
+    location->set(loc.fX, loc.fY);
+    return true;
+}
+
+bool GrImageAtlas::findOrAdd(const SkBitmap& bitmap, sk_sp<GrTextureProxy>* page,
+                             SkIPoint* offset) {
+    if (const Entry* entry = fEntries.find(bitmap.getGenerationID())) {
+        *page = fPages[entry->fPageIdx].fProxy;
+        *offset = entry->fOffset;
+        return true;
+    }
+    if (!this->isCandidate(bitmap)) {
+        return false;
+    }
+
+    if (!fPageSize) {
+        int maxDim = SkTMax(bitmap.width(), bitmap.height());
+        int bucket = SkTMax(SkNextLog2(maxDim) - 4, 0);
+        SkASSERT(bucket < kNumSizeBuckets);
+        ++fSizeHistogram[bucket];
+        if (++fCandidateCount < kMinCandidatesBeforePacking) {
+            return false;
+        }
+        fPageSize = this->choosePageSize();
+    }
+
+    int paddedWidth = bitmap.width() + 2 * kBorder;
+    int paddedHeight = bitmap.height() + 2 * kBorder;
+    if (paddedWidth > fPageSize || paddedHeight > fPageSize) {
+        return false;
+    }
+    int pageIdx;
+    SkIPoint location;
+    if (!this->addToPage(paddedWidth, paddedHeight, &pageIdx, &location)) {
+        return false;
+    }
+
+    Upload& upload = fPendingUploads.push_back();
+    upload.fProxy = fPages[pageIdx].fProxy;
+    upload.fLocation = location;
+    if (!upload.fPixels.tryAllocPixels(bitmap.info().makeWH(paddedWidth, paddedHeight))) {
+        fPendingUploads.pop_back();
+        return false;
+    }
+    int w = bitmap.width();
+    for (int y = 0; y < paddedHeight; ++y) {
+        int srcY = SkTPin(y - kBorder, 0, bitmap.height() - 1);
+        const uint32_t* src = bitmap.getAddr32(0, srcY);
+        uint32_t* dst = upload.fPixels.getAddr32(0, y);
+        dst[0] = src[0];
+        memcpy(dst + kBorder, src, w * sizeof(uint32_t));
+        dst[w + kBorder] = src[w - 1];
+    }
+
+    Entry entry;
+    entry.fPageIdx = pageIdx;
+    entry.fOffset.set(location.fX + kBorder, location.fY + kBorder);
+    fEntries.set(bitmap.getGenerationID(), entry);
+    *page = fPages[pageIdx].fProxy;
+    *offset = entry.fOffset;
+    return true;
+}
+
+void GrImageAtlas::addPendingUploads(GrDeferredUploadTarget* target,
+                                     GrResourceProvider* resourceProvider) {
+    GrColorType colorType = GrPixelConfigToColorType(fConfig);
+    for (const Upload& upload : fPendingUploads) {
+        if (!upload.fProxy->instantiate(resourceProvider)) {
+            continue;
+        }
+        target->addASAPUpload([upload, colorType](GrDeferredTextureUploadWritePixelsFn& write) {
+            write(upload.fProxy.get(), upload.fLocation.fX, upload.fLocation.fY,
+                  upload.fPixels.width(), upload.fPixels.height(), colorType,
+                  upload.fPixels.getPixels(), upload.fPixels.rowBytes());
+        });
+    }
+    fPendingUploads.reset();
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrImageAtlas_DEFINED
+#define GrImageAtlas_DEFINED
+
+#include "GrTypesPriv.h"
+#include "SkBitmap.h"
+#include "SkPoint.h"
+#include "SkRefCnt.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+
+class GrCaps;
+class GrDeferredUploadTarget;
+class GrProxyProvider;
+class GrRectanizer;
+class GrResourceProvider;
+class GrTextureProxy;
+
+/**
+ * Packs small raster images into a few shared textures ("pages") so that GrTextureOp can draw a
+ * grid of distinct images from one texture and batch it into a single draw. It is owned by
+ * GrProxyProvider and only used when GrContextOptions::fPackSmallImagesInAtlas is set.
+ *
+ * The page size is picked from a histogram of the dimensions of the candidate images seen before
+ * the first page is created. An image's pixels are copied, with a one pixel border replicating its
+ * edges so filtering behaves like clamping, when the image is added. The copies are uploaded as
+ * ASAP uploads by the first op that draws from the atlas in the next flush. Images are never
+ * evicted; once the pages are full later images keep their own textures.
+ */
+class GrImageAtlas {
+public:
+    // Images with a larger width or height are never packed.
+    static constexpr int kMaxImageSize = 256;
+    static constexpr int kMaxPages = 4;
+    // Number of candidate draws that are recorded in the histogram before any page is created.
+    static constexpr int kMinCandidatesBeforePacking = 16;
+
+    GrImageAtlas(GrProxyProvider*, const GrCaps&);
+    ~GrImageAtlas();
+
+    /**
+     * Returns the page holding the bitmap's pixels and the offset of its top left corner within
+     * the page, adding the bitmap to the atlas if it is a candidate and there is room. Returns
+     * false if the bitmap is not in the atlas.
+     */
+    bool findOrAdd(const SkBitmap&, sk_sp<GrTextureProxy>* page, SkIPoint* offset);
+
+    /** Schedules the uploads of all the images added since the last call. */
+    void addPendingUploads(GrDeferredUploadTarget*, GrResourceProvider*);
+
+    int pageSize() const { return fPageSize; }
+    int numPages() const { return fPages.count(); }
+    int numImages() const { return fEntries.count(); }
+
+private:
+    static constexpr int kNumSizeBuckets = 5;
+
+    bool isCandidate(const SkBitmap&) const;
+    int choosePageSize() const;
+    bool addToPage(int width, int height, int* pageIdx, SkIPoint* location);
+
+    struct Entry {
+        int fPageIdx;
+        SkIPoint fOffset;
+    };
+
+    struct Page {
+        sk_sp<GrTextureProxy> fProxy;
+        std::unique_ptr<GrRectanizer> fRectanizer;
+    };
+
+    struct Upload {
+        sk_sp<GrTextureProxy> fProxy;
+        SkIPoint fLocation;
+        SkBitmap fPixels;
+    };
+
+    GrProxyProvider* fProxyProvider;
+    GrPixelConfig fConfig;
+    int fMaxTextureSize;
+    int fPageSize = 0;
+    // Candidate draws by the power of two bucket of their larger dimension (<= 16, 32, ... 256).
+    int fSizeHistogram[kNumSizeBuckets] = {};
+    int fCandidateCount = 0;
+    SkTArray<Page> fPages;
+    SkTHashMap<uint32_t, Entry> fEntries;
+    SkTArray<Upload> fPendingUploads;
+};
+
+#endif
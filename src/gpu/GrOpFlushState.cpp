@@ -17,9 +17,10 @@
 
 GrOpFlushState::GrOpFlushState(GrGpu* gpu,
                                GrResourceProvider* resourceProvider,
-                               GrTokenTracker* tokenTracker)
-        : fVertexPool(gpu)
-        , fIndexPool(gpu)
+                               GrTokenTracker* tokenTracker,
+                               GrStreamingBufferRing* bufferRing)
+        : fVertexPool(gpu, bufferRing)
+        , fIndexPool(gpu, bufferRing)
         , fGpu(gpu)
         , fResourceProvider(resourceProvider)
         , fTokenTracker(tokenTracker) {
@@ -21,11 +21,13 @@ class GrGpu;
 class GrGpuCommandBuffer;
 class GrGpuRTCommandBuffer;
 class GrResourceProvider;
+class GrStreamingBufferRing;
 
 /** Tracks the state across all the GrOps (really just the GrDrawOps) in a GrOpList flush. */
 class GrOpFlushState final : public GrDeferredUploadTarget, public GrMeshDrawOp::Target {
 public:
-    GrOpFlushState(GrGpu*, GrResourceProvider*, GrTokenTracker*);
+    GrOpFlushState(GrGpu*, GrResourceProvider*, GrTokenTracker*,
+                   GrStreamingBufferRing* = nullptr);
 
     ~GrOpFlushState() final { this->reset(); }
 
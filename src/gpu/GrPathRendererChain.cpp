@@ -42,9 +42,10 @@ GrPathRendererChain::GrPathRendererChain(GrContext* context, const Options& opti
     fChain.push_back(sk_make_sp<GrAAHairLinePathRenderer>());
 
     if (options.fGpuPathRenderers & GpuPathRenderers::kCoverageCounting) {
-        bool drawCachablePaths = !options.fAllowPathMaskCaching;
-        if (auto ccpr = GrCoverageCountingPathRenderer::CreateIfSupported(*context->caps(),
-                                                                          drawCachablePaths)) {
+        bool cachePathMasks = options.fCacheCoverageCountingPathMasks;
+        bool drawCachablePaths = !options.fAllowPathMaskCaching || cachePathMasks;
+        if (auto ccpr = GrCoverageCountingPathRenderer::CreateIfSupported(
+                    *context->caps(), drawCachablePaths, cachePathMasks, options.fExecutor)) {
             fCoverageCountingPathRenderer = ccpr.get();
             context->contextPriv().addOnFlushCallbackObject(fCoverageCountingPathRenderer);
             fChain.push_back(std::move(ccpr));
@@ -62,7 +63,7 @@ GrPathRendererChain::GrPathRendererChain(GrContext* context, const Options& opti
         fChain.push_back(std::move(spr));
     }
     if (options.fGpuPathRenderers & GpuPathRenderers::kTessellating) {
-        fChain.push_back(sk_make_sp<GrTessellatingPathRenderer>());
+        fChain.push_back(sk_make_sp<GrTessellatingPathRenderer>(options.fExecutor));
     }
 
     // We always include the default path renderer (as well as SW), so we can draw any path
@@ -16,6 +16,7 @@
 
 class GrContext;
 class GrCoverageCountingPathRenderer;
+class SkExecutor;
 
 /**
  * Keeps track of an ordered list of path renderers. When a path needs to be
@@ -27,6 +28,9 @@ class GrPathRendererChain : public SkNoncopyable {
 public:
     struct Options {
         bool fAllowPathMaskCaching = false;
+        bool fCacheCoverageCountingPathMasks = false;
+        bool fCacheClippedSoftwarePathMasks = false;
+        SkExecutor* fExecutor = nullptr;
         GpuPathRenderers fGpuPathRenderers = GpuPathRenderers::kDefault;
     };
     GrPathRendererChain(GrContext* context, const Options&);
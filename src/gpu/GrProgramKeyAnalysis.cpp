@@ -0,0 +1,187 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrProgramKeyAnalysis.h"
+
+#include "GrPipeline.h"
+#include "GrPrimitiveProcessor.h"
+#include "GrProcessor.h"
+#include "GrProgramDesc.h"
+#include "GrXferProcessor.h"
+#include "SkTSort.h"
+
+#include <cstring>
+
+namespace {
+
+// What the programs compared so far say about one processor class's key bits, word by word.
+struct ClassBits {
+    const char*              fName;
+    int                      fPrograms = 0;
+    SkTArray<uint32_t, true> fChangedSkSL;
+    SkTArray<uint32_t, true> fDidNotChangeSkSL;
+};
+
+ClassBits* find_class(SkTArray<ClassBits>* classes, const char* name) {
+    for (ClassBits& c : *classes) {
+        if (!strcmp(c.fName, name)) {
+            return &c;
+        }
+    }
+    ClassBits& c = classes->push_back();
+    c.fName = name;
+    return &c;
+}
+
+void grow(SkTArray<uint32_t, true>* bits, int count) {
+    while (bits->count() < count) {
+        bits->push_back(0);
+    }
+}
+
+template <typename T>
+void add_key(T&& getKey, SkTArray<uint32_t, true>* key) {
+    SkTArray<uint8_t, true> bytes;
+    GrProcessorKeyBuilder b(&bytes);
+    getKey(&b);
+    key->reset(bytes.count() / sizeof(uint32_t));
+    memcpy(key->begin(), bytes.begin(), bytes.count());
+}
+
+// Counts the words that differ between two keys of the same length.
+int count_differences(const SkTArray<uint32_t, true>& a, const SkTArray<uint32_t, true>& b) {
+    int differences = 0;
+    for (int i = 0; i < a.count(); ++i) {
+        differences += a[i] != b[i];
+    }
+    return differences;
+}
+
+}  // namespace
+
+void GrProgramKeyAnalysis::addProgram(const GrProgramDesc& desc,
+                                      const GrPrimitiveProcessor& primProc,
+                                      const GrPipeline& pipeline,
+                                      const GrShaderCaps& caps,
+                                      const SkString& sksl) {
+    Program& program = fPrograms.push_back();
+
+    // Skip the length and checksum, which differ whenever anything else does.
+    static constexpr int kSkippedWords = 2;
+    const int keyWords = desc.keyLength() / sizeof(uint32_t) - kSkippedWords;
+    program.fKey.reset(keyWords);
+    memcpy(program.fKey.begin(), desc.asKey() + kSkippedWords, keyWords * sizeof(uint32_t));
+
+    // The processors' keys, in the order GrProgramDesc::Build() adds them. Each fragment
+    // processor's key includes its children's.
+    ProcessorKey* key = &program.fProcessors.push_back();
+    key->fName = primProc.name();
+    add_key([&](GrProcessorKeyBuilder* b) { primProc.getGLSLProcessorKey(caps, b); },
+            &key->fKey);
+    for (int i = 0; i < pipeline.numFragmentProcessors(); ++i) {
+        const GrFragmentProcessor& fp = pipeline.getFragmentProcessor(i);
+        key = &program.fProcessors.push_back();
+        key->fName = fp.name();
+        add_key([&](GrProcessorKeyBuilder* b) { fp.getGLSLProcessorKey(caps, b); }, &key->fKey);
+    }
+    const GrXferProcessor& xp = pipeline.getXferProcessor();
+    GrSurfaceOrigin origin;
+    const GrSurfaceOrigin* originIfDstTexture = nullptr;
+    if (pipeline.dstTextureProxy()) {
+        origin = pipeline.dstTextureProxy()->origin();
+        originIfDstTexture = &origin;
+    }
+    key = &program.fProcessors.push_back();
+    key->fName = xp.name();
+    add_key([&](GrProcessorKeyBuilder* b) {
+        xp.getGLSLProcessorKey(caps, b, originIfDstTexture);
+    }, &key->fKey);
+
+    if (const int* id = fSkSLIDs.find(sksl)) {
+        program.fSkSLID = *id;
+    } else {
+        program.fSkSLID = fSkSLIDs.count();
+        fSkSLIDs.set(sksl, program.fSkSLID);
+    }
+}
+
+void GrProgramKeyAnalysis::dump(SkString* out) const {
+    SkTArray<ClassBits> classes;
+    for (const Program& program : fPrograms) {
+        for (const ProcessorKey& key : program.fProcessors) {
+            find_class(&classes, key.fName)->fPrograms++;
+        }
+    }
+
+    for (int i = 0; i < fPrograms.count(); ++i) {
+        for (int j = i + 1; j < fPrograms.count(); ++j) {
+            const Program& a = fPrograms[i];
+            const Program& b = fPrograms[j];
+            if (a.fKey.count() != b.fKey.count() ||
+                a.fProcessors.count() != b.fProcessors.count()) {
+                continue;
+            }
+            // Find the one processor whose key differs.
+            int differing = -1;
+            for (int k = 0; k < a.fProcessors.count(); ++k) {
+                const ProcessorKey& ka = a.fProcessors[k];
+                const ProcessorKey& kb = b.fProcessors[k];
+                if (strcmp(ka.fName, kb.fName) || ka.fKey.count() != kb.fKey.count()) {
+                    differing = -2;
+                    break;
+                }
+                if (count_differences(ka.fKey, kb.fKey)) {
+                    if (differing != -1) {
+                        differing = -2;
+                        break;
+                    }
+                    differing = k;
+                }
+            }
+            if (differing < 0) {
+                continue;
+            }
+            const ProcessorKey& ka = a.fProcessors[differing];
+            const ProcessorKey& kb = b.fProcessors[differing];
+            // The rest of the program key (the header, and the processors' samplers and
+            // transforms) has to match as well.
+            if (count_differences(a.fKey, b.fKey) != count_differences(ka.fKey, kb.fKey)) {
+                continue;
+            }
+            ClassBits* c = find_class(&classes, ka.fName);
+            SkTArray<uint32_t, true>* bits = a.fSkSLID == b.fSkSLID ? &c->fDidNotChangeSkSL
+                                                                     : &c->fChangedSkSL;
+            grow(bits, ka.fKey.count());
+            for (int w = 0; w < ka.fKey.count(); ++w) {
+                (*bits)[w] |= ka.fKey[w] ^ kb.fKey[w];
+            }
+        }
+    }
+
+    out->appendf("Programs: %d\n", fPrograms.count());
+    out->appendf("Distinct SkSL: %d\n", fSkSLIDs.count());
+    auto byName = [](const ClassBits& a, const ClassBits& b) {
+        return strcmp(a.fName, b.fName) < 0;
+    };
+    if (classes.count() > 1) {
+        SkTQSort(classes.begin(), classes.end() - 1, byName);
+    }
+    for (ClassBits& c : classes) {
+        out->appendf("%s: %d programs\n", c.fName, c.fPrograms);
+        int words = SkTMax(c.fChangedSkSL.count(), c.fDidNotChangeSkSL.count());
+        grow(&c.fChangedSkSL, words);
+        grow(&c.fDidNotChangeSkSL, words);
+        for (int w = 0; w < words; ++w) {
+            // Bits that differed together with others that changed the SkSL may not have.
+            uint32_t never = c.fDidNotChangeSkSL[w] & ~c.fChangedSkSL[w];
+            if (c.fChangedSkSL[w] || never) {
+                out->appendf("    key word %d: changed SkSL 0x%08x, never changed SkSL 0x%08x\n",
+                             w, c.fChangedSkSL[w], never);
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrProgramKeyAnalysis_DEFINED
+#define GrProgramKeyAnalysis_DEFINED
+
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+
+class GrPipeline;
+class GrPrimitiveProcessor;
+class GrProgramDesc;
+class GrShaderCaps;
+
+/**
+ * Finds the program key bits that don't change the generated SkSL. Every program the context
+ * builds is recorded with its key, the keys of its processors, and its SkSL. Whenever two programs
+ * differ only in the key of one processor, the bits that differ are charged to that processor's
+ * class, as bits that changed the SkSL or as bits that didn't. Bits that never changed the SkSL
+ * only cost program compiles; the ones that did, and that a uniform could express, are candidates
+ * for GrUniformKeyBits.
+ *
+ * Enabled by GrContextOptions::fAnalyzeProgramKeys.
+ */
+class GrProgramKeyAnalysis {
+public:
+    void addProgram(const GrProgramDesc&, const GrPrimitiveProcessor&, const GrPipeline&,
+                    const GrShaderCaps&, const SkString& sksl);
+
+    void dump(SkString*) const;
+
+private:
+    struct ProcessorKey {
+        const char*              fName;
+        SkTArray<uint32_t, true> fKey;
+    };
+
+    struct Program {
+        SkTArray<uint32_t, true> fKey;  // The whole program key, after its length and checksum.
+        SkTArray<ProcessorKey>   fProcessors;
+        int                      fSkSLID;
+    };
+
+    SkTArray<Program>         fPrograms;
+    SkTHashMap<SkString, int> fSkSLIDs;
+};
+
+#endif
@@ -660,6 +660,17 @@ void GrProxyProvider::processInvalidProxyUniqueKey(const GrUniqueKey& key, GrTex
     }
 }
 
+GrImageAtlas* GrProxyProvider::imageAtlas() {
+    ASSERT_SINGLE_OWNER
+    if (!fCaps->packSmallImagesInAtlas() || this->isAbandoned() || this->recordingDDL()) {
+        return nullptr;
+    }
+    if (!fImageAtlas) {
+        fImageAtlas.reset(new GrImageAtlas(this, *fCaps));
+    }
+    return fImageAtlas.get();
+}
+
 void GrProxyProvider::removeAllUniqueKeys() {
     UniquelyKeyedProxyHash::Iter iter(&fUniquelyKeyedProxies);
     for (UniquelyKeyedProxyHash::Iter iter(&fUniquelyKeyedProxies); !iter.done(); ++iter) {
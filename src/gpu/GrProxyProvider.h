@@ -9,6 +9,7 @@
 #define GrProxyProvider_DEFINED
 
 #include "GrCaps.h"
+#include "GrImageAtlas.h"
 #include "GrResourceKey.h"
 #include "GrTextureProxy.h"
 #include "GrTypes.h"
@@ -216,7 +217,18 @@ public:
     const GrCaps* caps() const { return fCaps.get(); }
     sk_sp<const GrCaps> refCaps() const { return fCaps; }
 
+    /**
+     * Returns the atlas small raster images are packed into, creating it on first use. Returns
+     * null unless GrContextOptions::fPackSmallImagesInAtlas is set, or when the provider is
+     * abandoned or recording a DDL.
+     */
+    GrImageAtlas* imageAtlas();
+
+    /** Drops the image atlas and its pages. Must be called before the resource cache is freed. */
+    void releaseImageAtlas() { fImageAtlas.reset(); }
+
     void abandon() {
+        fImageAtlas.reset();
         fResourceCache = nullptr;
         fResourceProvider = nullptr;
         fAbandoned = true;
@@ -260,6 +272,7 @@ private:
     GrResourceCache*       fResourceCache;
     bool                   fAbandoned;
     sk_sp<const GrCaps>    fCaps;
+    std::unique_ptr<GrImageAtlas> fImageAtlas;
 
     // In debug builds we guard against improper thread handling
     SkDEBUGCODE(mutable GrSingleOwner* fSingleOwner;)
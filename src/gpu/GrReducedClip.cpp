@@ -25,6 +25,7 @@
 #include "effects/GrAARectEffect.h"
 #include "effects/GrConvexPolyEffect.h"
 #include "effects/GrRRectEffect.h"
+#include "effects/GrSimpleTextureEffect.h"
 
 /**
  * There are plenty of optimizations that could be added here. Maybe flips could be folded into
@@ -734,7 +735,8 @@ static void draw_element(GrRenderTargetContext* rtc,
     }
 }
 
-bool GrReducedClip::drawAlphaClipMask(GrRenderTargetContext* rtc) const {
+bool GrReducedClip::drawAlphaClipMask(GrRenderTargetContext* rtc, sk_sp<GrTextureProxy> prefixMask,
+                                      const SkIRect& prefixBounds) const {
     // The texture may be larger than necessary, this rect represents the part of the texture
     // we populate with a rasterization of the clip.
     GrFixedClip clip(SkIRect::MakeWH(fScissor.width(), fScissor.height()));
@@ -744,17 +746,33 @@ bool GrReducedClip::drawAlphaClipMask(GrRenderTargetContext* rtc) const {
                                  GrWindowRectsState::Mode::kExclusive);
     }
 
-    // The scratch texture that we are drawing into can be substantially larger than the mask. Only
-    // clear the part that we care about.
-    GrColor initialCoverage = InitialState::kAllIn == this->initialState() ? -1 : 0;
-    rtc->priv().clear(clip, initialCoverage, GrRenderTargetContext::CanClearFullscreen::kYes);
+    ElementList::Iter::IterStart iterStart = ElementList::Iter::kHead_IterStart;
+    if (prefixMask) {
+        SkASSERT(prefixBounds.contains(fScissor));
+        // Copy the mask of all but the last element and then only apply the last element.
+        SkMatrix maskToPrefix =
+                SkMatrix::MakeTrans(SkIntToScalar(fScissor.left() - prefixBounds.left()),
+                                    SkIntToScalar(fScissor.top() - prefixBounds.top()));
+        GrPaint paint;
+        paint.setPorterDuffXPFactory(SkBlendMode::kSrc);
+        paint.addColorFragmentProcessor(GrSimpleTextureEffect::Make(std::move(prefixMask),
+                                                                    maskToPrefix));
+        rtc->drawRect(clip, std::move(paint), GrAA::kNo, SkMatrix::I(),
+                      SkRect::MakeIWH(fScissor.width(), fScissor.height()));
+        iterStart = ElementList::Iter::kTail_IterStart;
+    } else {
+        // The scratch texture that we are drawing into can be substantially larger than the mask.
+        // Only clear the part that we care about.
+        GrColor initialCoverage = InitialState::kAllIn == this->initialState() ? -1 : 0;
+        rtc->priv().clear(clip, initialCoverage, GrRenderTargetContext::CanClearFullscreen::kYes);
+    }
 
     // Set the matrix so that rendered clip elements are transformed to mask space from clip space.
     SkMatrix translate;
     translate.setTranslate(SkIntToScalar(-fScissor.left()), SkIntToScalar(-fScissor.top()));
 
     // walk through each clip element and perform its set op
-    for (ElementList::Iter iter(fMaskElements); iter.get(); iter.next()) {
+    for (ElementList::Iter iter(fMaskElements, iterStart); iter.get(); iter.next()) {
         const Element* element = iter.get();
         SkRegion::Op op = (SkRegion::Op)element->getOp();
         GrAA aa = GrAA(element->isAA());
@@ -16,6 +16,7 @@
 class GrContext;
 class GrCoverageCountingPathRenderer;
 class GrRenderTargetContext;
+class GrTextureProxy;
 
 /**
  * This class takes a clip stack and produces a reduced set of elements that are equivalent to
@@ -82,7 +83,13 @@ public:
      */
     bool maskRequiresAA() const { SkASSERT(!fMaskElements.isEmpty()); return fMaskRequiresAA; }
 
-    bool drawAlphaClipMask(GrRenderTargetContext*) const;
+    /**
+     * Draws the alpha clip mask. If 'prefixMask' is provided it must be an alpha clip mask of all
+     * but the last mask element covering 'prefixBounds' (a superset of scissor()) in device space.
+     * The mask is then composed from it and the last element.
+     */
+    bool drawAlphaClipMask(GrRenderTargetContext*, sk_sp<GrTextureProxy> prefixMask = nullptr,
+                           const SkIRect& prefixBounds = SkIRect::MakeEmpty()) const;
     bool drawStencilClipMask(GrContext*, GrRenderTargetContext*) const;
 
     int numAnalyticFPs() const { return fAnalyticFPs.count() + fCCPRClipPaths.count(); }
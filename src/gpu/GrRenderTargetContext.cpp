@@ -768,7 +768,8 @@ void GrRenderTargetContext::drawTextureAffine(const GrClip& clip, sk_sp<GrTextur
                                               GrSamplerState::Filter filter, GrColor color,
                                               const SkRect& srcRect, const SkRect& dstRect, GrAA aa,
                                               const SkMatrix& viewMatrix,
-                                              sk_sp<GrColorSpaceXform> colorSpaceXform) {
+                                              sk_sp<GrColorSpaceXform> colorSpaceXform,
+                                              GrImageAtlas* imageAtlas) {
     ASSERT_SINGLE_OWNER
     RETURN_IF_ABANDONED
     SkDEBUGCODE(this->validate();)
@@ -787,7 +788,8 @@ void GrRenderTargetContext::drawTextureAffine(const GrClip& clip, sk_sp<GrTextur
     bool allowSRGB = SkToBool(this->colorSpaceInfo().colorSpace());
     this->addDrawOp(
             clip, GrTextureOp::Make(std::move(proxy), filter, color, clippedSrcRect, clippedDstRect,
-                                    aaType, viewMatrix, std::move(colorSpaceXform), allowSRGB));
+                                    aaType, viewMatrix, std::move(colorSpaceXform), allowSRGB,
+                                    imageAtlas));
 }
 
 void GrRenderTargetContext::fillRectWithLocalMatrix(const GrClip& clip,
@@ -28,6 +28,7 @@ class GrCoverageCountingPathRenderer;
 class GrDrawingManager;
 class GrDrawOp;
 class GrFixedClip;
+class GrImageAtlas;
 class GrRenderTarget;
 class GrRenderTargetContextPriv;
 class GrRenderTargetOpList;
@@ -146,11 +147,13 @@ public:
      * Creates an op that draws a subrectangle of a texture. The passed color is modulated by the
      * texture's color. 'srcRect' specifies the rectangle of the texture to draw. 'dstRect'
      * specifies the rectangle to draw in local coords which will be transformed by 'viewMatrix' to
-     * device space. This asserts that the view matrix does not have perspective.
+     * device space. This asserts that the view matrix does not have perspective. 'imageAtlas' must
+     * be provided when the texture is a page of the GrProxyProvider's image atlas.
      */
     void drawTextureAffine(const GrClip& clip, sk_sp<GrTextureProxy>, GrSamplerState::Filter,
                            GrColor, const SkRect& srcRect, const SkRect& dstRect, GrAA aa,
-                           const SkMatrix& viewMatrix, sk_sp<GrColorSpaceXform>);
+                           const SkMatrix& viewMatrix, sk_sp<GrColorSpaceXform>,
+                           GrImageAtlas* imageAtlas = nullptr);
 
     /**
      * Draw a roundrect using a paint.
@@ -13,8 +13,12 @@
 #include "GrRect.h"
 #include "GrRenderTargetContext.h"
 #include "GrResourceAllocator.h"
+#include "GrSurfaceProxyPriv.h"
+#include "GrTexturePriv.h"
+#include "GrTextureProxy.h"
 #include "ops/GrClearOp.h"
 #include "ops/GrCopySurfaceOp.h"
+#include "SkCounters.h"
 #include "SkTraceEvent.h"
 
 
@@ -24,12 +28,112 @@
 static const int kMaxOpLookback = 10;
 static const int kMaxOpLookahead = 10;
 
+static inline bool can_reorder(const SkRect& a, const SkRect& b) { return !GrRectsOverlap(a, b); }
+
+// With an OpIndex the candidates may be anywhere in the opList, but we still don't want each op
+// to try thousands of ops of its class that have a different pipeline.
+static const int kMaxIndexedCombineAttempts = 64;
+
+/**
+ * A uniform grid over the render target. Each cell lists the ops whose bounds touch it, so we can
+ * find the last op a new op overlaps without looking at all of them. It also lists the ops of
+ * each class in the order they were recorded; any of them after the last overlap may combine with
+ * the new op without breaking painter's order.
+ */
+class GrRenderTargetOpList::OpIndex {
+public:
+    OpIndex(int width, int height)
+            : fCols(SkTMax(1, (width  + kCellSize - 1) / kCellSize))
+            , fRows(SkTMax(1, (height + kCellSize - 1) / kCellSize))
+            , fCells(new SkTDArray<int>[fCols * fRows]) {}
+
+    void reset() {
+        for (int i = 0; i < fCols * fRows; ++i) {
+            fCells[i].rewind();
+        }
+        fOpsByClass.reset();
+    }
+
+    // The index of the last of ops that overlaps bounds, or -1.
+    int lastOverlap(const SkRect& bounds, const RecordedOp ops[]) const {
+        int last = -1;
+        SkIRect cells;
+        if (this->getCells(bounds, &cells)) {
+            for (int y = cells.fTop; y < cells.fBottom; ++y) {
+                for (int x = cells.fLeft; x < cells.fRight; ++x) {
+                    for (int opIndex : fCells[y * fCols + x]) {
+                        if (opIndex > last && ops[opIndex].fOp &&
+                            !can_reorder(ops[opIndex].fOp->bounds(), bounds)) {
+                            last = opIndex;
+                        }
+                    }
+                }
+            }
+        }
+        return last;
+    }
+
+    void add(int opIndex, uint32_t classID, const SkRect& bounds) {
+        this->addBounds(opIndex, bounds);
+        if ((int)classID >= fOpsByClass.count()) {
+            fOpsByClass.push_back_n(classID + 1 - fOpsByClass.count());
+        }
+        fOpsByClass[classID].push(opIndex);
+    }
+
+    // The op at opIndex has combined with another, so its bounds have grown to bounds.
+    void grow(int opIndex, const SkRect& bounds) { this->addBounds(opIndex, bounds); }
+
+    // The indices of the ops of this class, in recording order.
+    const SkTDArray<int>* opsOfClass(uint32_t classID) const {
+        return (int)classID < fOpsByClass.count() ? &fOpsByClass[classID] : nullptr;
+    }
+
+private:
+    static constexpr int kCellSize = 64;
+
+    bool getCells(const SkRect& bounds, SkIRect* cells) const {
+        if (!bounds.isFinite()) {
+            return false;
+        }
+        // Ops are clipped to the render target, so what's outside it can't collide.
+        cells->fLeft   = SkTPin(SkScalarFloorToInt(bounds.fLeft   / kCellSize), 0, fCols);
+        cells->fTop    = SkTPin(SkScalarFloorToInt(bounds.fTop    / kCellSize), 0, fRows);
+        cells->fRight  = SkTPin(SkScalarFloorToInt(bounds.fRight  / kCellSize) + 1, 0, fCols);
+        cells->fBottom = SkTPin(SkScalarFloorToInt(bounds.fBottom / kCellSize) + 1, 0, fRows);
+        return !cells->isEmpty();
+    }
+
+    void addBounds(int opIndex, const SkRect& bounds) {
+        SkIRect cells;
+        if (this->getCells(bounds, &cells)) {
+            for (int y = cells.fTop; y < cells.fBottom; ++y) {
+                for (int x = cells.fLeft; x < cells.fRight; ++x) {
+                    SkTDArray<int>& cell = fCells[y * fCols + x];
+                    if (cell.isEmpty() || cell.top() != opIndex) {
+                        cell.push(opIndex);
+                    }
+                }
+            }
+        }
+    }
+
+    const int                         fCols;
+    const int                         fRows;
+    std::unique_ptr<SkTDArray<int>[]> fCells;
+    SkTArray<SkTDArray<int>>          fOpsByClass;
+};
+
 GrRenderTargetOpList::GrRenderTargetOpList(GrResourceProvider* resourceProvider,
                                            GrRenderTargetProxy* proxy,
-                                           GrAuditTrail* auditTrail)
+                                           GrAuditTrail* auditTrail,
+                                           bool indexOpBounds)
         : INHERITED(resourceProvider, proxy, auditTrail)
         , fLastClipStackGenID(SK_InvalidUniqueID)
         SkDEBUGCODE(, fNumClips(0)) {
+    if (indexOpBounds) {
+        fOpIndex.reset(new OpIndex(proxy->width(), proxy->height()));
+    }
 }
 
 GrRenderTargetOpList::~GrRenderTargetOpList() {
@@ -188,6 +292,9 @@ bool GrRenderTargetOpList::onExecute(GrOpFlushState* flushState) {
 void GrRenderTargetOpList::endFlush() {
     fLastClipStackGenID = SK_InvalidUniqueID;
     fRecordedOps.reset();
+    if (fOpIndex) {
+        fOpIndex->reset();
+    }
     fClipAllocator.reset();
     INHERITED::endFlush();
 }
@@ -210,6 +317,9 @@ void GrRenderTargetOpList::fullClear(const GrCaps& caps, GrColor color) {
     // buffer we will need a more elaborate tracking system (skbug.com/7002).
     if (this->isEmpty() || !fTarget.get()->asRenderTargetProxy()->needsStencil()) {
         fRecordedOps.reset();
+        if (fOpIndex) {
+            fOpIndex->reset();
+        }
         fDeferredProxies.reset();
         fColorLoadOp = GrLoadOp::kClear;
         fLoadClearColor = color;
@@ -296,30 +406,100 @@ void GrRenderTargetOpList::gatherProxyIntervals(GrResourceAllocator* alloc) cons
     }
 }
 
-static inline bool can_reorder(const SkRect& a, const SkRect& b) { return !GrRectsOverlap(a, b); }
+void GrRenderTargetOpList::gatherDirtyMipMapProxies(SkTArray<GrTextureProxy*>* proxies) const {
+    auto gather = [proxies](GrSurfaceProxy* p) {
+        GrTextureProxy* textureProxy = p->asTextureProxy();
+        if (!textureProxy || GrMipMapped::kYes != textureProxy->mipMapped() ||
+            !textureProxy->priv().isInstantiated() ||
+            !textureProxy->priv().peekTexture()->texturePriv().mipMapsAreDirty()) {
+            return;
+        }
+        for (GrTextureProxy* gathered : *proxies) {
+            if (gathered == textureProxy) {
+                return;
+            }
+        }
+        proxies->push_back(textureProxy);
+    };
+    for (const RecordedOp& recordedOp : fRecordedOps) {
+        recordedOp.visitProxies(gather);
+    }
+}
+
+static bool applied_clips_match(const GrAppliedClip* a, const GrAppliedClip* b) {
+    if (a) {
+        return b && *a == *b;
+    }
+    return !b;
+}
+
+static bool dst_proxies_match(const GrXferProcessor::DstProxy& a,
+                              const GrXferProcessor::DstProxy* b) {
+    if (b) {
+        return a == *b;
+    }
+    return !a.proxy();
+}
 
 bool GrRenderTargetOpList::combineIfPossible(const RecordedOp& a, GrOp* b,
                                              const GrAppliedClip* bClip,
                                              const DstProxy* bDstProxy,
                                              const GrCaps& caps) {
-    if (a.fAppliedClip) {
-        if (!bClip) {
-            return false;
+    using CombineOutcome = GrAuditTrail::CombineOutcome;
+    CombineOutcome outcome;
+    if (a.fOp->classID() != b->classID()) {
+        outcome = CombineOutcome::kDifferentClass;
+    } else if (!applied_clips_match(a.fAppliedClip, bClip) ||
+               !dst_proxies_match(a.fDstProxy, bDstProxy)) {
+        outcome = CombineOutcome::kPipelineMismatch;
+    } else if (a.fOp->combineIfPossible(b, caps)) {
+        outcome = CombineOutcome::kCombined;
+        SkCounters::Add(SkCounter::kOpsCombined);
+    } else {
+        outcome = CombineOutcome::kOpRefused;
+    }
+    GR_AUDIT_TRAIL_COMBINE_ATTEMPTED(fAuditTrail, outcome);
+    return CombineOutcome::kCombined == outcome;
+}
+
+int GrRenderTargetOpList::indexedCombine(GrOp* op, const GrAppliedClip* clip,
+                                         const DstProxy* dstProxy, const GrCaps& caps) {
+    const SkTDArray<int>* candidates = fOpIndex->opsOfClass(op->classID());
+    if (!candidates) {
+        GrOP_INFO("\t\tIndexed: No ops of this class\n");
+        return -1;
+    }
+    // We can move op back past anything it doesn't overlap.
+    const int lastOverlap = fOpIndex->lastOverlap(op->bounds(), fRecordedOps.begin());
+    int attempts = 0;
+    for (int i = candidates->count() - 1; i >= 0; --i) {
+        const int candidateIndex = (*candidates)[i];
+        if (candidateIndex < lastOverlap) {
+            GrOP_INFO("\t\tIndexed: Intersects with (%s, opID: %u)\n",
+                      fRecordedOps[lastOverlap].fOp->name(),
+                      fRecordedOps[lastOverlap].fOp->uniqueID());
+            GR_AUDIT_TRAIL_COMBINE_SEARCH_ENDED(fAuditTrail,
+                                                GrAuditTrail::CombineSearchEnd::kOverlap);
+            break;
         }
-        if (*a.fAppliedClip != *bClip) {
-            return false;
+        const RecordedOp& candidate = fRecordedOps[candidateIndex];
+        if (this->combineIfPossible(candidate, op, clip, dstProxy, caps)) {
+            GrOP_INFO("\t\tIndexed: Combining with (%s, opID: %u)\n", candidate.fOp->name(),
+                      candidate.fOp->uniqueID());
+            GrOP_INFO("\t\t\tIndexed: Combined op info:\n");
+            GrOP_INFO(SkTabString(candidate.fOp->dumpInfo(), 4).c_str());
+            GR_AUDIT_TRAIL_OPS_RESULT_COMBINED(fAuditTrail, candidate.fOp.get(), op);
+            fOpIndex->grow(candidateIndex, candidate.fOp->bounds());
+            return candidateIndex;
         }
-    } else if (bClip) {
-        return false;
-    }
-    if (bDstProxy) {
-        if (a.fDstProxy != *bDstProxy) {
-            return false;
+        if (++attempts == kMaxIndexedCombineAttempts) {
+            GrOP_INFO("\t\tIndexed: Reached max attempts %d\n", attempts);
+            GR_AUDIT_TRAIL_COMBINE_SEARCH_ENDED(fAuditTrail,
+                                                GrAuditTrail::CombineSearchEnd::kLimit);
+            break;
         }
-    } else if (a.fDstProxy.proxy()) {
-        return false;
     }
-    return a.fOp->combineIfPossible(b, caps);
+    return -1;
 }
 
 void GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
@@ -347,7 +527,11 @@ void GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
     GrOP_INFO("\tOutcome:\n");
     int maxCandidates = SkTMin(kMaxOpLookback, fRecordedOps.count());
     // If we don't have a valid destination render target then we cannot reorder.
-    if (maxCandidates) {
+    if (fOpIndex) {
+        if (this->indexedCombine(op.get(), clip, dstProxy, caps) >= 0) {
+            return;
+        }
+    } else if (maxCandidates) {
         int i = 0;
         while (true) {
             const RecordedOp& candidate = fRecordedOps.fromBack(i);
@@ -364,11 +548,17 @@ void GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
             if (!can_reorder(fRecordedOps.fromBack(i).fOp->bounds(), op->bounds())) {
                 GrOP_INFO("\t\tBackward: Intersects with (%s, opID: %u)\n", candidate.fOp->name(),
                           candidate.fOp->uniqueID());
+                GR_AUDIT_TRAIL_COMBINE_SEARCH_ENDED(fAuditTrail,
+                                                    GrAuditTrail::CombineSearchEnd::kOverlap);
                 break;
             }
             ++i;
             if (i == maxCandidates) {
                 GrOP_INFO("\t\tBackward: Reached max lookback or beginning of op array %d\n", i);
+                if (i < fRecordedOps.count()) {
+                    GR_AUDIT_TRAIL_COMBINE_SEARCH_ENDED(fAuditTrail,
+                                                        GrAuditTrail::CombineSearchEnd::kLimit);
+                }
                 break;
             }
         }
@@ -382,6 +572,10 @@ void GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
     }
     fRecordedOps.emplace_back(std::move(op), clip, dstProxy);
     fRecordedOps.back().fOp->wasRecorded(this);
+    if (fOpIndex) {
+        const GrOp* recorded = fRecordedOps.back().fOp.get();
+        fOpIndex->add(fRecordedOps.count() - 1, recorded->classID(), recorded->bounds());
+    }
 }
 
 void GrRenderTargetOpList::forwardCombine(const GrCaps& caps) {
@@ -411,12 +605,18 @@ void GrRenderTargetOpList::forwardCombine(const GrCaps& caps) {
                 GrOP_INFO("\t\t%d: (%s opID: %u) -> Intersects with (%s, opID: %u)\n",
                           i, op->name(), op->uniqueID(),
                           candidate.fOp->name(), candidate.fOp->uniqueID());
+                GR_AUDIT_TRAIL_COMBINE_SEARCH_ENDED(fAuditTrail,
+                                                    GrAuditTrail::CombineSearchEnd::kOverlap);
                 break;
             }
             ++j;
             if (j > maxCandidateIdx) {
                 GrOP_INFO("\t\t%d: (%s opID: %u) -> Reached max lookahead or end of array\n",
                           i, op->name(), op->uniqueID());
+                if (j < fRecordedOps.count()) {
+                    GR_AUDIT_TRAIL_COMBINE_SEARCH_ENDED(fAuditTrail,
+                                                        GrAuditTrail::CombineSearchEnd::kLimit);
+                }
                 break;
             }
         }
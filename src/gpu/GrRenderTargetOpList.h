@@ -32,7 +32,10 @@ private:
     using DstProxy = GrXferProcessor::DstProxy;
 
 public:
-    GrRenderTargetOpList(GrResourceProvider*, GrRenderTargetProxy*, GrAuditTrail*);
+    // If indexOpBounds is true, recordOp() looks for an op to combine with among all the ops the
+    // new op may be reordered with (see GrContextOptions::fIndexOpBoundsForCombining).
+    GrRenderTargetOpList(GrResourceProvider*, GrRenderTargetProxy*, GrAuditTrail*,
+                         bool indexOpBounds = false);
 
     ~GrRenderTargetOpList() override;
 
@@ -109,6 +112,9 @@ public:
 
     GrRenderTargetOpList* asRenderTargetOpList() override { return this; }
 
+    // Appends the instantiated, mip mapped textures read by this opList's ops whose mips are dirty.
+    void gatherDirtyMipMapProxies(SkTArray<GrTextureProxy*>*) const;
+
     SkDEBUGCODE(void dump(bool printDependencies) const override;)
 
     SkDEBUGCODE(int numOps() const override { return fRecordedOps.count(); })
@@ -156,12 +162,21 @@ private:
     bool combineIfPossible(const RecordedOp& a, GrOp* b, const GrAppliedClip* bClip,
                            const DstProxy* bDstTexture, const GrCaps&);
 
+    // Tries to combine op with one of the ops found by fOpIndex. The return value is the index of
+    // the op it was merged into, or -1.
+    int indexedCombine(GrOp* op, const GrAppliedClip* clip, const DstProxy* dstProxy,
+                       const GrCaps&);
+
+    class OpIndex;
+
     uint32_t                       fLastClipStackGenID;
     SkIRect                        fLastDevClipBounds;
     int                            fLastClipNumAnalyticFPs;
 
     // For ops/opList we have mean: 5 stdDev: 28
     SkSTArray<5, RecordedOp, true> fRecordedOps;
+    // Where fRecordedOps are, and which are of each class, if we're indexing op bounds.
+    std::unique_ptr<OpIndex>       fOpIndex;
 
     // MDB TODO: 4096 for the first allocation of the clip space will be huge overkill.
     // Gather statistics to determine the correct size.
@@ -9,12 +9,14 @@
 
 #include "GrGpuResourcePriv.h"
 #include "GrOpList.h"
+#include "GrRenderTarget.h"
 #include "GrRenderTargetProxy.h"
 #include "GrResourceCache.h"
 #include "GrResourceProvider.h"
 #include "GrSurfacePriv.h"
 #include "GrSurfaceProxy.h"
 #include "GrSurfaceProxyPriv.h"
+#include "GrTexturePriv.h"
 #include "GrTextureProxy.h"
 #include "GrUninstantiateProxyTracker.h"
 
@@ -37,6 +39,7 @@ void GrResourceAllocator::markEndOfOpList(int opListIndex) {
 }
 
 GrResourceAllocator::~GrResourceAllocator() {
+    SkASSERT(!fReuseLargerSurfaces || fFreeSurfaces.count() == fFreePool.count());
     SkASSERT(fIntvlList.empty());
     SkASSERT(fActiveIntvls.empty());
     SkASSERT(!fIntvlHash.count());
@@ -153,9 +156,45 @@ void GrResourceAllocator::freeUpSurface(sk_sp<GrSurface> surface) {
     }
 
     // TODO: fix this insertion so we get a more LRU-ish behavior
+    if (fReuseLargerSurfaces) {
+        *fFreeSurfaces.append() = surface.get();
+    }
     fFreePool.insert(key, surface.release());
 }
 
+// Finds the smallest surface in the free pool that an approx-fit proxy could use in place of one
+// that matches its scratch key. The surface stays in the free pool.
+GrSurface* GrResourceAllocator::findLargerSurfaceFor(const GrSurfaceProxy* proxy) {
+    SkASSERT(!proxy->priv().isExact());
+    const GrRenderTargetProxy* rtp = proxy->asRenderTargetProxy();
+    const GrTextureProxy* tp = proxy->asTextureProxy();
+    int width = proxy->worstCaseWidth();
+    int height = proxy->worstCaseHeight();
+
+    GrSurface* best = nullptr;
+    for (int i = 0; i < fFreeSurfaces.count(); ++i) {
+        GrSurface* s = fFreeSurfaces[i];
+        if (s->config() != proxy->config() || s->width() < width || s->height() < height ||
+            SkToBool(s->asRenderTarget()) != SkToBool(rtp) ||
+            SkToBool(s->asTexture()) != SkToBool(tp)) {
+            continue;
+        }
+        if (rtp && s->asRenderTarget()->numStencilSamples() != rtp->numStencilSamples()) {
+            continue;
+        }
+        if (tp && GrMipMapped::kNo != s->asTexture()->texturePriv().mipMapped()) {
+            continue;
+        }
+        if (proxy->priv().requiresNoPendingIO() && s->surfacePriv().hasPendingIO()) {
+            continue;
+        }
+        if (!best || (int64_t)s->width() * s->height() < (int64_t)best->width() * best->height()) {
+            best = s;
+        }
+    }
+    return best;
+}
+
 // First try to reuse one of the recently allocated/used GrSurfaces in the free pool.
 // If we can't find a useable one, create a new one.
 sk_sp<GrSurface> GrResourceAllocator::findSurfaceFor(const GrSurfaceProxy* proxy,
@@ -169,6 +208,17 @@ sk_sp<GrSurface> GrResourceAllocator::findSurfaceFor(const GrSurfaceProxy* proxy
         return !proxy->priv().requiresNoPendingIO() || !s->surfacePriv().hasPendingIO();
     };
     sk_sp<GrSurface> surface(fFreePool.findAndRemove(key, filter));
+    if (!surface && fReuseLargerSurfaces && !proxy->priv().isExact()) {
+        if (GrSurface* larger = this->findLargerSurfaceFor(proxy)) {
+            fFreePool.remove(larger->resourcePriv().getScratchKey(), larger);
+            surface.reset(larger);
+        }
+    }
+    if (surface && fReuseLargerSurfaces) {
+        int index = fFreeSurfaces.find(surface.get());
+        SkASSERT(index >= 0);
+        fFreeSurfaces.removeShuffle(index);
+    }
     if (surface) {
         if (SkBudgeted::kYes == proxy->isBudgeted() &&
             SkBudgeted::kNo == surface->resourcePriv().isBudgeted()) {
@@ -13,6 +13,7 @@
 #include "GrSurfaceProxy.h"
 
 #include "SkArenaAlloc.h"
+#include "SkTDArray.h"
 #include "SkTDynamicHash.h"
 #include "SkTMultiMap.h"
 
@@ -33,11 +34,17 @@ class GrUninstantiateProxyTracker;
  *
  * Note: the op indices (used in the usage intervals) come from the order of the ops in
  * their opLists after the opList DAG has been linearized.
+ *
+ * If 'reuseLargerSurfaces' is set, an approx-fit proxy for which the free pool has no exact match
+ * may take the smallest free GrSurface that is at least as big and otherwise compatible (same
+ * config, sample count and render target-ness) instead of a new one. This lets transient render
+ * targets of different sizes share backing stores when their lifetimes don't overlap.
  */
 class GrResourceAllocator {
 public:
-    GrResourceAllocator(GrResourceProvider* resourceProvider)
-            : fResourceProvider(resourceProvider) {
+    GrResourceAllocator(GrResourceProvider* resourceProvider, bool reuseLargerSurfaces = false)
+            : fResourceProvider(resourceProvider)
+            , fReuseLargerSurfaces(reuseLargerSurfaces) {
     }
 
     ~GrResourceAllocator();
@@ -83,6 +90,7 @@ private:
     // These two methods wrap the interactions with the free pool
     void freeUpSurface(sk_sp<GrSurface> surface);
     sk_sp<GrSurface> findSurfaceFor(const GrSurfaceProxy* proxy, bool needsStencil);
+    GrSurface* findLargerSurfaceFor(const GrSurfaceProxy* proxy);
 
     struct FreePoolTraits {
         static const GrScratchKey& GetKey(const GrSurface& s) {
@@ -179,6 +187,9 @@ private:
 
     GrResourceProvider*    fResourceProvider;
     FreePoolMultiMap       fFreePool;          // Recently created/used GrSurfaces
+    bool                   fReuseLargerSurfaces;
+    SkTDArray<GrSurface*>  fFreeSurfaces;      // Everything in fFreePool, when reusing larger
+                                               // surfaces (which needs more than key lookups)
     IntvlHash              fIntvlHash;         // All the intervals, hashed by proxyID
 
     IntervalList           fIntvlList;         // All the intervals sorted by increasing start
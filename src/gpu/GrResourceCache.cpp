@@ -82,6 +82,9 @@ GrResourceCache::GrResourceCache(const GrCaps* caps, uint32_t contextUniqueID)
     , fPurgeableBytes(0)
     , fRequestFlush(false)
     , fExternalFlushCnt(0)
+    , fMaxBytesPurgedPerFlush(0)
+    , fBytesPurgedSinceFlush(0)
+    , fLastFrameHadHeadroom(true)
     , fContextUniqueID(contextUniqueID)
     , fPreferVRAMUseOverFlushes(caps->preferVRAMUseOverFlushes()) {
     SkDEBUGCODE(fCount = 0;)
@@ -460,6 +463,17 @@ void GrResourceCache::didChangeBudgetStatus(GrGpuResource* resource) {
     this->validate();
 }
 
+bool GrResourceCache::mayPurgeMoreThisFlush() const {
+    if (!fMaxBytesPurgedPerFlush) {
+        return true;
+    }
+    if (fBudgetedBytes > 2 * fMaxBytes || fBudgetedCount > 2 * fMaxCount) {
+        // Past the hard limit: purge whatever the frame costs.
+        return true;
+    }
+    return fLastFrameHadHeadroom && fBytesPurgedSinceFlush < fMaxBytesPurgedPerFlush;
+}
+
 void GrResourceCache::purgeAsNeeded() {
     SkTArray<GrUniqueKeyInvalidatedMessage> invalidKeyMsgs;
     fInvalidUniqueKeyInbox.poll(&invalidKeyMsgs);
@@ -477,7 +491,7 @@ void GrResourceCache::purgeAsNeeded() {
         uint32_t oldestAllowedFlushCnt = fExternalFlushCnt - fMaxUnusedFlushes - 1;
         // check for underflow
         if (oldestAllowedFlushCnt < fExternalFlushCnt) {
-            while (fPurgeableQueue.count()) {
+            while (fPurgeableQueue.count() && this->mayPurgeMoreThisFlush()) {
                 uint32_t flushWhenResourceBecamePurgeable =
                         fPurgeableQueue.peek()->cacheAccess().flushCntWhenResourceBecamePurgeable();
                 if (oldestAllowedFlushCnt < flushWhenResourceBecamePurgeable) {
@@ -490,22 +504,26 @@ void GrResourceCache::purgeAsNeeded() {
                 }
                 GrGpuResource* resource = fPurgeableQueue.peek();
                 SkASSERT(resource->isPurgeable());
+                fBytesPurgedSinceFlush += resource->gpuMemorySize();
                 resource->cacheAccess().release();
             }
         }
     }
 
     bool stillOverbudget = this->overBudget();
-    while (stillOverbudget && fPurgeableQueue.count()) {
+    while (stillOverbudget && fPurgeableQueue.count() && this->mayPurgeMoreThisFlush()) {
         GrGpuResource* resource = fPurgeableQueue.peek();
         SkASSERT(resource->isPurgeable());
+        fBytesPurgedSinceFlush += resource->gpuMemorySize();
         resource->cacheAccess().release();
         stillOverbudget = this->overBudget();
     }
 
     this->validate();
 
-    if (stillOverbudget) {
+    // If we stopped short because of the per-flush limit the next flush will purge more, so it's
+    // only worth asking for one when nothing is left to purge.
+    if (stillOverbudget && !fPurgeableQueue.count()) {
         // Set this so that GrDrawingManager will issue a flush to free up resources with pending
         // IO that we were unable to purge in this pass.
         fRequestFlush = true;
@@ -597,10 +615,14 @@ void GrResourceCache::purgeUnlockedResources(size_t bytesToPurge, bool preferScr
 
     // Purge any remaining resources in LRU order
     if (stillOverbudget) {
+        // The caller asked for these bytes now, so don't spread them over flushes.
         const size_t cachedByteCount = fMaxBytes;
+        const size_t cachedBytesPerFlush = fMaxBytesPurgedPerFlush;
         fMaxBytes = tmpByteBudget;
+        fMaxBytesPurgedPerFlush = 0;
         this->purgeAsNeeded();
         fMaxBytes = cachedByteCount;
+        fMaxBytesPurgedPerFlush = cachedBytesPerFlush;
     }
 }
 
@@ -720,6 +742,7 @@ void GrResourceCache::notifyFlushOccurred(FlushType type) {
             fRequestFlush = false;
             break;
         case FlushType::kExternal:
+            fBytesPurgedSinceFlush = 0;
             ++fExternalFlushCnt;
             if (0 == fExternalFlushCnt) {
                 // When this wraps just reset all the purgeable resources' last used flush state.
@@ -75,6 +75,22 @@ public:
      */
     void setLimits(int count, size_t bytes, int maxUnusedFlushes = kDefaultMaxUnusedFlushes);
 
+    /**
+     * Limits how many bytes of resources purgeAsNeeded() releases between external flushes, so
+     * that getting back under budget (or rid of resources unused for too many flushes) is spread
+     * over several frames. Whatever the limit, the cache releases what it must to stay within
+     * twice its budget. Zero, the default, means no limit.
+     */
+    void setMaxBytesPurgedPerFlush(size_t bytes) { fMaxBytesPurgedPerFlush = bytes; }
+    size_t getMaxBytesPurgedPerFlush() const { return fMaxBytesPurgedPerFlush; }
+
+    /**
+     * Tells the cache whether the last frame finished within its target time. With a per-flush
+     * purge limit, purgeAsNeeded() holds off on limited purging after a frame that didn't, until
+     * one that does.
+     */
+    void setLastFrameHadHeadroom(bool hadHeadroom) { fLastFrameHadHeadroom = hadHeadroom; }
+
     /**
      * Returns the number of resources.
      */
@@ -180,6 +196,9 @@ public:
 
     bool overBudget() const { return fBudgetedBytes > fMaxBytes || fBudgetedCount > fMaxCount; }
 
+    // Whether the per-flush purge limit, if there is one, lets purgeAsNeeded() release more.
+    bool mayPurgeMoreThisFlush() const;
+
     /**
      * Purge unlocked resources from the cache until the the provided byte count has been reached
      * or we have purged all unlocked resources. The default policy is to purge in LRU order, but
@@ -362,6 +381,11 @@ private:
     bool                                fRequestFlush;
     uint32_t                            fExternalFlushCnt;
 
+    // Incremental purging, see setMaxBytesPurgedPerFlush()
+    size_t                              fMaxBytesPurgedPerFlush;
+    size_t                              fBytesPurgedSinceFlush;
+    bool                                fLastFrameHadHeadroom;
+
     InvalidUniqueKeyInbox               fInvalidUniqueKeyInbox;
     FreedGpuResourceInbox               fFreedGpuResourceInbox;
 
@@ -72,6 +72,8 @@ GrShaderCaps::GrShaderCaps(const GrContextOptions& options) {
     // TODO: Default this to 0 and only enable image multitexturing when a "safe" threshold is
     // known for a GPU class.
     fDisableImageMultitexturingDstRectAreaThreshold = std::numeric_limits<size_t>::max();
+
+    fUniformKeyBits = GrUniformKeyBits::kNone;
 }
 
 void GrShaderCaps::dumpJSON(SkJSONWriter* writer) const {
@@ -132,6 +134,7 @@ void GrShaderCaps::dumpJSON(SkJSONWriter* writer) const {
                          kAdvBlendEqInteractionStr[fAdvBlendEqInteraction]);
     writer->appendU64("Disable image multitexturing dst area threshold",
                       fDisableImageMultitexturingDstRectAreaThreshold);
+    writer->appendHexU32("Uniform key bits", (uint32_t)fUniformKeyBits);
 
     writer->endObject();
 }
@@ -151,6 +154,7 @@ void GrShaderCaps::applyOptionsOverrides(const GrContextOptions& options) {
         SkASSERT(!fInterpolantsAreInaccurate);
         SkASSERT(!fIncompleteShortIntPrecision);
     }
+    fUniformKeyBits = options.fUniformKeyBits;
 #if GR_TEST_UTILS
     fDualSourceBlendingSupport = fDualSourceBlendingSupport && !options.fSuppressDualSourceBlending;
     if (options.fDisableImageMultitexturing) {
@@ -7,6 +7,8 @@
 
 #include "GrShape.h"
 
+#include "SkStyledPathCache.h"
+
 GrShape& GrShape::operator=(const GrShape& that) {
     fStyle = that.fStyle;
     this->changeType(that.fType, Type::kPath == that.fType ? &that.path() : nullptr);
@@ -414,6 +416,53 @@ GrShape::GrShape(const GrShape& that) : fStyle(that.fStyle) {
     }
 }
 
+// Like GrStyle::applyPathEffectToPath(), but looks in the SkStyledPathCache first when src is a
+// path that can be cached. Sets fromCache if the result was found there.
+static bool apply_path_effect(const GrStyle& style, SkPath* dst, SkStrokeRec* remainingStroke,
+                              const SkPath& src, SkScalar scale, bool canCache, bool* fromCache) {
+    *fromCache = false;
+    SkStrokeRec rec = style.strokeRec();
+    rec.setResScale(scale);
+    canCache = canCache && SkStyledPathCache::CanCache(src);
+    if (canCache && SkStyledPathCache::Find(SkStyledPathCache::Step::kGrPathEffect, src, rec,
+                                            style.pathEffect(), nullptr, dst, remainingStroke)) {
+        *fromCache = true;
+        return true;
+    }
+    if (!style.applyPathEffectToPath(dst, remainingStroke, src, scale)) {
+        return false;
+    }
+    if (canCache) {
+        SkStyledPathCache::Add(SkStyledPathCache::Step::kGrPathEffect, src, rec,
+                               style.pathEffect(), nullptr, *dst, *remainingStroke);
+    }
+    return true;
+}
+
+// Like GrStyle::applyToPath(), but looks in the SkStyledPathCache first when src is a path that
+// can be cached.
+static bool apply_style(const GrStyle& style, SkPath* dst, SkStrokeRec::InitStyle* fillOrHairline,
+                        const SkPath& src, SkScalar scale, bool canCache) {
+    SkStrokeRec rec = style.strokeRec();
+    rec.setResScale(scale);
+    SkStrokeRec dstRec(SkStrokeRec::kFill_InitStyle);
+    canCache = canCache && SkStyledPathCache::CanCache(src);
+    if (canCache && SkStyledPathCache::Find(SkStyledPathCache::Step::kGrStyle, src, rec,
+                                            style.pathEffect(), nullptr, dst, &dstRec)) {
+        *fillOrHairline = dstRec.isHairlineStyle() ? SkStrokeRec::kHairline_InitStyle
+                                                   : SkStrokeRec::kFill_InitStyle;
+        return true;
+    }
+    if (!style.applyToPath(dst, fillOrHairline, src, scale)) {
+        return false;
+    }
+    if (canCache) {
+        SkStyledPathCache::Add(SkStyledPathCache::Step::kGrStyle, src, rec, style.pathEffect(),
+                               nullptr, *dst, SkStrokeRec(*fillOrHairline));
+    }
+    return true;
+}
+
 GrShape::GrShape(const GrShape& parent, GrStyle::Apply apply, SkScalar scale) {
     // TODO: Add some quantization of scale for better cache performance here or leave that up
     // to caller?
@@ -427,6 +476,8 @@ GrShape::GrShape(const GrShape& parent, GrStyle::Apply apply, SkScalar scale) {
     }
 
     SkPathEffect* pe = parent.fStyle.pathEffect();
+    // Only a path keeps its gen ID from draw to draw, other shapes are turned into new paths.
+    bool canCache = Type::kPath == parent.fType && !parent.path().isVolatile();
     SkTLazy<SkPath> tmpPath;
     const GrShape* parentForKey = &parent;
     SkTLazy<GrShape> tmpParent;
@@ -443,8 +494,9 @@ GrShape::GrShape(const GrShape& parent, GrStyle::Apply apply, SkScalar scale) {
         // Should we consider bounds? Would have to include in key, but it'd be nice to know
         // if the bounds actually modified anything before including in key.
         SkStrokeRec strokeRec = parent.fStyle.strokeRec();
-        if (!parent.fStyle.applyPathEffectToPath(&this->path(), &strokeRec, *srcForPathEffect,
-                                                 scale)) {
+        bool peFromCache;
+        if (!apply_path_effect(parent.fStyle, &this->path(), &strokeRec, *srcForPathEffect, scale,
+                               canCache, &peFromCache)) {
             tmpParent.init(*srcForPathEffect, GrStyle(strokeRec, nullptr));
             *this = tmpParent.get()->applyStyle(apply, scale);
             return;
@@ -466,11 +518,16 @@ GrShape::GrShape(const GrShape& parent, GrStyle::Apply apply, SkScalar scale) {
                 tmpPath.init();
             }
             tmpParent.get()->asPath(tmpPath.get());
+            // A path effect result from the cache keeps its gen ID, so stroking it can be cached
+            // too, unless the intermediate shape was simplified into a new path.
+            bool canCacheStroke = peFromCache &&
+                    tmpPath.get()->getGenerationID() == this->path().getGenerationID();
             SkStrokeRec::InitStyle fillOrHairline;
             // The parent shape may have simplified away the strokeRec, check for that here.
             if (tmpParent.get()->style().applies()) {
-                SkAssertResult(tmpParent.get()->style().applyToPath(&this->path(), &fillOrHairline,
-                                                                    *tmpPath.get(), scale));
+                SkAssertResult(apply_style(tmpParent.get()->style(), &this->path(),
+                                           &fillOrHairline, *tmpPath.get(), scale,
+                                           canCacheStroke));
             } else if (tmpParent.get()->style().isSimpleFill()) {
                 fillOrHairline = SkStrokeRec::kFill_InitStyle;
             } else {
@@ -493,8 +550,8 @@ GrShape::GrShape(const GrShape& parent, GrStyle::Apply apply, SkScalar scale) {
         SkStrokeRec::InitStyle fillOrHairline;
         SkASSERT(parent.fStyle.applies());
         SkASSERT(!parent.fStyle.pathEffect());
-        SkAssertResult(parent.fStyle.applyToPath(&this->path(), &fillOrHairline, *srcForParentStyle,
-                                                 scale));
+        SkAssertResult(apply_style(parent.fStyle, &this->path(), &fillOrHairline,
+                                   *srcForParentStyle, scale, canCache));
         fStyle.resetToInitStyle(fillOrHairline);
     }
     if (parent.fInheritedPathForListeners.isValid()) {
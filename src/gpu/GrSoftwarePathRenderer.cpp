@@ -262,6 +262,7 @@ bool GrSoftwarePathRenderer::onDrawPath(const DrawPathArgs& args) {
     }
 
     const SkIRect* boundsForMask = &clippedDevShapeBounds;
+    bool cacheClippedMask = false;
     if (useCache) {
         // Use the cache only if >50% of the path is visible.
         int unclippedWidth = unclippedDevShapeBounds.width();
@@ -272,14 +273,32 @@ bool GrSoftwarePathRenderer::onDrawPath(const DrawPathArgs& args) {
         int maxTextureSize = args.fRenderTargetContext->caps()->maxTextureSize();
         if (unclippedArea > 2 * clippedArea || unclippedWidth > maxTextureSize ||
             unclippedHeight > maxTextureSize) {
-            useCache = false;
+            // The clipped mask can still be reused if the path is drawn again under this clip.
+            useCache = cacheClippedMask = fCacheClippedMasks;
         } else {
             boundsForMask = &unclippedDevShapeBounds;
         }
     }
 
     GrUniqueKey maskKey;
-    if (useCache) {
+    if (cacheClippedMask) {
+        // A clipped mask covers only its device bounds, so the whole matrix must match, along with
+        // the bounds.
+        static const GrUniqueKey::Domain kClippedDomain = GrUniqueKey::GenerateDomain();
+        GrUniqueKey::Builder builder(&maskKey, kClippedDomain,
+                                     10 + args.fShape->unstyledKeySize(), "SW Clipped Path Mask");
+        builder[0] = SkFloat2Bits(args.fViewMatrix->get(SkMatrix::kMScaleX));
+        builder[1] = SkFloat2Bits(args.fViewMatrix->get(SkMatrix::kMScaleY));
+        builder[2] = SkFloat2Bits(args.fViewMatrix->get(SkMatrix::kMSkewX));
+        builder[3] = SkFloat2Bits(args.fViewMatrix->get(SkMatrix::kMSkewY));
+        builder[4] = SkFloat2Bits(args.fViewMatrix->get(SkMatrix::kMTransX));
+        builder[5] = SkFloat2Bits(args.fViewMatrix->get(SkMatrix::kMTransY));
+        builder[6] = clippedDevShapeBounds.fLeft;
+        builder[7] = clippedDevShapeBounds.fTop;
+        builder[8] = clippedDevShapeBounds.fRight;
+        builder[9] = clippedDevShapeBounds.fBottom;
+        args.fShape->writeUnstyledKey(&builder[10]);
+    } else if (useCache) {
         // We require the upper left 2x2 of the matrix to match exactly for a cache hit.
         SkScalar sx = args.fViewMatrix->get(SkMatrix::kMScaleX);
         SkScalar sy = args.fViewMatrix->get(SkMatrix::kMScaleY);
@@ -18,9 +18,13 @@ class GrProxyProvider;
  */
 class GrSoftwarePathRenderer : public GrPathRenderer {
 public:
-    GrSoftwarePathRenderer(GrProxyProvider* proxyProvider, bool allowCaching)
+    // If cacheClippedMasks is true (and allowCaching), masks of paths that are mostly clipped out
+    // are cached too, keyed by their integer device bounds.
+    GrSoftwarePathRenderer(GrProxyProvider* proxyProvider, bool allowCaching,
+                           bool cacheClippedMasks = false)
             : fProxyProvider(proxyProvider)
-            , fAllowCaching(allowCaching) {
+            , fAllowCaching(allowCaching)
+            , fCacheClippedMasks(allowCaching && cacheClippedMasks) {
     }
 
 private:
@@ -62,6 +66,7 @@ private:
 private:
     GrProxyProvider*       fProxyProvider;
     bool                   fAllowCaching;
+    bool                   fCacheClippedMasks;
 
     typedef GrPathRenderer INHERITED;
 };
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrStreamingBufferRing.h"
+#include "GrBuffer.h"
+#include "GrGpu.h"
+
+constexpr int GrStreamingBufferRing::kMaxFlushesInFlight;
+constexpr int GrStreamingBufferRing::kMaxFreeBuffers;
+
+GrStreamingBufferRing::GrStreamingBufferRing(GrGpu* gpu) : fGpu(gpu) {}
+
+GrStreamingBufferRing::~GrStreamingBufferRing() {
+    SkASSERT(fFree.empty() && fReleased.empty() && !fInFlightCount);
+}
+
+void GrStreamingBufferRing::addFree(const Buffer& buffer) {
+    if (buffer.fBuffer->wasDestroyed() || fFree.count() >= kMaxFreeBuffers) {
+        buffer.fBuffer->unref();
+        return;
+    }
+    fFree.push_back(buffer);
+}
+
+void GrStreamingBufferRing::retireOldestFlush(bool signaled) {
+    SkASSERT(fInFlightCount);
+    InFlight& oldest = fInFlight[fInFlightHead];
+    for (const Buffer& buffer : oldest.fBuffers) {
+        if (signaled) {
+            this->addFree(buffer);
+        } else {
+            // The resource cache keeps the buffer until the GPU is done with it.
+            buffer.fBuffer->unref();
+        }
+    }
+    oldest.fBuffers.reset();
+    fGpu->deleteFence(oldest.fFence);
+    fInFlightHead = (fInFlightHead + 1) % kMaxFlushesInFlight;
+    --fInFlightCount;
+}
+
+void GrStreamingBufferRing::retireSignaledFlushes() {
+    // Flushes complete in order, so stop at the first one that is still in flight.
+    while (fInFlightCount && fGpu->waitFence(fInFlight[fInFlightHead].fFence, 0)) {
+        this->retireOldestFlush(true);
+    }
+}
+
+GrBuffer* GrStreamingBufferRing::acquire(GrBufferType type, size_t size) {
+    this->retireSignaledFlushes();
+    int best = -1;
+    for (int i = 0; i < fFree.count(); ++i) {
+        size_t bufferSize = fFree[i].fBuffer->gpuMemorySize();
+        if (type == fFree[i].fType && bufferSize >= size &&
+            (best < 0 || bufferSize < fFree[best].fBuffer->gpuMemorySize())) {
+            best = i;
+        }
+    }
+    if (best < 0) {
+        return nullptr;
+    }
+    GrBuffer* buffer = fFree[best].fBuffer;
+    fFree.removeShuffle(best);
+    ++fNumReused;
+    return buffer;
+}
+
+void GrStreamingBufferRing::release(GrBufferType type, GrBuffer* buffer) {
+    SkASSERT(buffer && !buffer->isMapped());
+    fReleased.push_back({buffer, type});
+}
+
+void GrStreamingBufferRing::endFlush() {
+    if (fReleased.empty()) {
+        return;
+    }
+    if (kMaxFlushesInFlight == fInFlightCount) {
+        InFlight& oldest = fInFlight[fInFlightHead];
+        this->retireOldestFlush(fGpu->waitFence(oldest.fFence, 0));
+    }
+    int tail = (fInFlightHead + fInFlightCount) % kMaxFlushesInFlight;
+    fInFlight[tail].fFence = fGpu->insertFence();
+    fInFlight[tail].fBuffers.swap(&fReleased);
+    ++fInFlightCount;
+}
+
+void GrStreamingBufferRing::reset(bool abandoned) {
+    while (fInFlightCount) {
+        InFlight& oldest = fInFlight[fInFlightHead];
+        for (const Buffer& buffer : oldest.fBuffers) {
+            buffer.fBuffer->unref();
+        }
+        oldest.fBuffers.reset();
+        if (!abandoned) {
+            fGpu->deleteFence(oldest.fFence);
+        }
+        fInFlightHead = (fInFlightHead + 1) % kMaxFlushesInFlight;
+        --fInFlightCount;
+    }
+    fInFlightHead = 0;
+    for (const Buffer& buffer : fFree) {
+        buffer.fBuffer->unref();
+    }
+    fFree.reset();
+    for (const Buffer& buffer : fReleased) {
+        buffer.fBuffer->unref();
+    }
+    fReleased.reset();
+}
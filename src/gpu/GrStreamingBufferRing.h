@@ -0,0 +1,88 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrStreamingBufferRing_DEFINED
+#define GrStreamingBufferRing_DEFINED
+
+#include "GrTypesPriv.h"
+#include "SkTArray.h"
+
+class GrBuffer;
+class GrGpu;
+
+/**
+ * Recycles the dynamic vertex and index buffers of GrBufferAllocPool across flushes. Without it
+ * the pools unref their blocks at the end of each flush and allocate (or find in the resource
+ * cache) new ones in the next flush. The ring instead keeps the blocks of the last
+ * kMaxFlushesInFlight flushes behind a fence, and hands a block back to a pool once the GPU is
+ * done reading it. Since a recycled block is known to be idle the pools map it directly instead
+ * of filling CPU staging memory and uploading it with updateData().
+ *
+ * The ring never stalls the CPU: when a flush is still in flight once kMaxFlushesInFlight newer
+ * flushes have ended, its blocks are handed back to the resource cache.
+ *
+ * It is owned by GrDrawingManager and only used when GrContextOptions::fUseStreamingBufferRing is
+ * set and the backend supports fences and buffer mapping.
+ */
+class GrStreamingBufferRing : SkNoncopyable {
+public:
+    static constexpr int kMaxFlushesInFlight = 3;
+    // Idle buffers beyond this count are returned to the resource cache.
+    static constexpr int kMaxFreeBuffers = 16;
+
+    explicit GrStreamingBufferRing(GrGpu*);
+    ~GrStreamingBufferRing();
+
+    /**
+     * Returns a buffer of the given type with at least 'size' bytes that the GPU is no longer
+     * reading, or null if there is none. The caller owns a ref on the buffer.
+     */
+    GrBuffer* acquire(GrBufferType, size_t size);
+
+    /** Takes over the caller's ref on a buffer whose contents are read by the current flush. */
+    void release(GrBufferType, GrBuffer*);
+
+    /**
+     * Fences the buffers released since the last call. Must be called once the work of the flush
+     * has been submitted to the GPU.
+     */
+    void endFlush();
+
+    /** Drops all buffers. Fences are not deleted if the context has been abandoned. */
+    void reset(bool abandoned);
+
+    int numFreeBuffers() const { return fFree.count(); }
+    int numFlushesInFlight() const { return fInFlightCount; }
+    int numReused() const { return fNumReused; }
+
+private:
+    struct Buffer {
+        GrBuffer*    fBuffer;
+        GrBufferType fType;
+    };
+
+    struct InFlight {
+        GrFence          fFence;
+        SkTArray<Buffer> fBuffers;
+    };
+
+    // Moves the buffers of the oldest flushes whose fences have signaled to the free list.
+    void retireSignaledFlushes();
+    void retireOldestFlush(bool signaled);
+    void addFree(const Buffer&);
+
+    GrGpu*           fGpu;
+    SkTArray<Buffer> fFree;
+    SkTArray<Buffer> fReleased;
+    // Circular queue of the flushes the GPU may still be reading from, oldest first.
+    InFlight         fInFlight[kMaxFlushesInFlight];
+    int              fInFlightHead = 0;
+    int              fInFlightCount = 0;
+    int              fNumReused = 0;
+};
+
+#endif
@@ -11,10 +11,12 @@
 #include "GrPathUtils.h"
 
 #include "SkArenaAlloc.h"
+#include "SkAutoMalloc.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
 #include "SkPointPriv.h"
 #include "SkTDPQueue.h"
+#include "SkTaskGroup.h"
 
 #include <algorithm>
 #include <stdio.h>
@@ -2128,10 +2130,178 @@ void* outer_mesh_to_triangles(const VertexList& outerMesh, const AAParams* aaPar
     return data;
 }
 
+// Each slab gets at least this many of the path's points.
+const int kMinPointsPerSlab = GrTessellator::kMinSlabbedPathPoints / 2;
+const int kMaxSlabs = 16;
+
+// Receives one slab's triangles. Without antialiasing, the tessellator only emits positions.
+class SlabVertexAllocator : public GrTessellator::VertexAllocator {
+public:
+    SlabVertexAllocator() : VertexAllocator(sizeof(SkPoint)), fCount(0) {}
+    void* lock(int vertexCount) override {
+        return fVertices.reset(vertexCount * this->stride());
+    }
+    void unlock(int actualCount) override { fCount = actualCount; }
+    const void* vertices() const { return fVertices.get(); }
+    int count() const { return fCount; }
+private:
+    SkAutoMalloc fVertices;
+    int fCount;
+};
+
+// Returns where the segment between a and b crosses y. Computed the same way whichever way the
+// segment points, so slabs on either side of y agree exactly on their shared vertices.
+SkPoint y_intercept(SkPoint a, SkPoint b, SkScalar y) {
+    if (a.fY > b.fY) {
+        std::swap(a, b);
+    }
+    SkScalar t = (y - a.fY) / (b.fY - a.fY);
+    return {a.fX + t * (b.fX - a.fX), y};
+}
+
+// Clips a closed polygon to the points above y (sign = -1) or below y (sign = 1), Sutherland-
+// Hodgman style. Clipping every contour of a path to a convex region leaves the winding number of
+// every point inside the region unchanged.
+void clip_polygon(const SkPoint* pts, int count, SkScalar y, int sign, SkTDArray<SkPoint>* out) {
+    out->rewind();
+    for (int i = 0; i < count; ++i) {
+        const SkPoint& prev = pts[(i + count - 1) % count];
+        const SkPoint& curr = pts[i];
+        bool prevInside = sign * (prev.fY - y) >= 0;
+        bool currInside = sign * (curr.fY - y) >= 0;
+        if (currInside != prevInside) {
+            *out->append() = y_intercept(prev, curr, y);
+        }
+        if (currInside) {
+            *out->append() = curr;
+        }
+    }
+}
+
+struct SlabContour {
+    SkTDArray<SkPoint> fPoints;
+    SkScalar fTop;
+    SkScalar fBottom;
+};
+
+// Triangulates the part of the contours between top and bottom.
+void tessellate_slab(const SkTArray<SlabContour>& contours, SkScalar top, SkScalar bottom,
+                     SkPath::FillType fillType, SkScalar tolerance, const SkRect& clipBounds,
+                     SlabVertexAllocator* allocator) {
+    SkPath slabPath;
+    slabPath.setFillType(fillType);
+    SkTDArray<SkPoint> clippedAbove, clipped;
+    for (const SlabContour& contour : contours) {
+        if (contour.fBottom < top || contour.fTop > bottom) {
+            continue;
+        }
+        const SkPoint* pts = contour.fPoints.begin();
+        int count = contour.fPoints.count();
+        if (contour.fTop < top) {
+            clip_polygon(pts, count, top, 1, &clippedAbove);
+            pts = clippedAbove.begin();
+            count = clippedAbove.count();
+        }
+        if (contour.fBottom > bottom) {
+            clip_polygon(pts, count, bottom, -1, &clipped);
+            pts = clipped.begin();
+            count = clipped.count();
+        }
+        if (count >= 3) {
+            slabPath.addPoly(pts, count, true);
+        }
+    }
+    bool isLinear;
+    GrTessellator::PathToTriangles(slabPath, tolerance, clipBounds, allocator, false, GrColor(),
+                                   false, &isLinear);
+}
+
 } // namespace
 
 namespace GrTessellator {
 
+int PathToTrianglesInSlabs(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
+                           VertexAllocator* vertexAllocator, SkExecutor* executor,
+                           bool* isLinear) {
+    int contourCnt;
+    int maxPts = GrPathUtils::worstCasePointCount(path, &contourCnt, tolerance);
+    if (!executor || path.isInverseFillType() || maxPts < kMinSlabbedPathPoints) {
+        return PathToTriangles(path, tolerance, clipBounds, vertexAllocator, false, GrColor(),
+                               false, isLinear);
+    }
+
+    // Flatten the path's curves, the same way the tessellator would.
+    SkTArray<SlabContour> contours(contourCnt);
+    SkTDArray<SkScalar> ys;
+    {
+        SkArenaAlloc alloc(kArenaChunkSize);
+        std::unique_ptr<VertexList[]> vertexContours(new VertexList[contourCnt]);
+        path_to_contours(path, tolerance, clipBounds, vertexContours.get(), alloc, isLinear);
+        for (int i = 0; i < contourCnt; ++i) {
+            if (!vertexContours[i].fHead) {
+                continue;
+            }
+            SlabContour& contour = contours.push_back();
+            contour.fTop = contour.fBottom = vertexContours[i].fHead->fPoint.fY;
+            for (Vertex* v = vertexContours[i].fHead; v; v = v->fNext) {
+                *contour.fPoints.append() = v->fPoint;
+                contour.fTop = SkTMin(contour.fTop, v->fPoint.fY);
+                contour.fBottom = SkTMax(contour.fBottom, v->fPoint.fY);
+                *ys.append() = v->fPoint.fY;
+            }
+        }
+    }
+
+    // Split at quantiles of the points' y coordinates, so the slabs have similar amounts of work.
+    int numSlabs = SkTMin(ys.count() / kMinPointsPerSlab, kMaxSlabs);
+    SkSTArray<kMaxSlabs + 1, SkScalar, true> splits;
+    splits.push_back(SK_ScalarNegativeInfinity);
+    for (int i = 1; i < numSlabs; ++i) {
+        SkScalar* nth = ys.begin() + (int64_t)ys.count() * i / numSlabs;
+        std::nth_element(ys.begin(), nth, ys.end());
+        if (*nth > splits.back()) {
+            splits.push_back(*nth);
+        }
+    }
+    splits.push_back(SK_ScalarInfinity);
+    numSlabs = splits.count() - 1;
+    if (numSlabs < 2) {
+        return PathToTriangles(path, tolerance, clipBounds, vertexAllocator, false, GrColor(),
+                               false, isLinear);
+    }
+
+    SkASSERT(sizeof(SkPoint) == vertexAllocator->stride());
+    std::unique_ptr<SlabVertexAllocator[]> slabAllocators(new SlabVertexAllocator[numSlabs]);
+    SkTaskGroup taskGroup(*executor);
+    taskGroup.batch(numSlabs, [&](int i) {
+        tessellate_slab(contours, splits[i], splits[i + 1], path.getFillType(), tolerance,
+                        clipBounds, &slabAllocators[i]);
+    });
+    taskGroup.wait();
+
+    // Stitch the slabs back together.
+    int count = 0;
+    for (int i = 0; i < numSlabs; ++i) {
+        count += slabAllocators[i].count();
+    }
+    if (0 == count) {
+        return 0;
+    }
+    void* verts = vertexAllocator->lock(count);
+    if (!verts) {
+        SkDebugf("Could not allocate vertices\n");
+        return 0;
+    }
+    char* end = static_cast<char*>(verts);
+    for (int i = 0; i < numSlabs; ++i) {
+        size_t size = slabAllocators[i].count() * vertexAllocator->stride();
+        memcpy(end, slabAllocators[i].vertices(), size);
+        end += size;
+    }
+    vertexAllocator->unlock(count);
+    return count;
+}
+
 // Stage 6: Triangulate the monotone polygons into a vertex buffer.
 
 int PathToTriangles(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
@@ -12,6 +12,7 @@
 #include "SkColorData.h"
 #include "SkPoint.h"
 
+class SkExecutor;
 class SkPath;
 struct SkRect;
 
@@ -49,6 +50,17 @@ int PathToVertices(const SkPath& path, SkScalar tolerance, const SkRect& clipBou
 int PathToTriangles(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
                     VertexAllocator*, bool antialias, const GrColor& color,
                     bool canTweakAlphaForCoverage, bool *isLinear);
+
+// Paths with at least this many points, once flattened, can be triangulated in slabs.
+constexpr int kMinSlabbedPathPoints = 8192;
+
+// Like PathToTriangles without antialiasing, but a large path is first cut into horizontal slabs,
+// which are triangulated in parallel on the executor and then stitched back together. The slabs
+// share vertices along their seams. Small and inverse-filled paths, or a null executor, just go to
+// PathToTriangles. Slabs also each get their own vertex limit (see PathToTriangles), so this
+// handles paths too big for PathToTriangles.
+int PathToTrianglesInSlabs(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
+                           VertexAllocator*, SkExecutor*, bool* isLinear);
 }
 
 #endif
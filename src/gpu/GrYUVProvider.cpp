@@ -9,6 +9,7 @@
 #include "GrClip.h"
 #include "GrContext.h"
 #include "GrContextPriv.h"
+#include "GrDeferredProxyUploader.h"
 #include "GrProxyProvider.h"
 #include "GrRenderTargetContext.h"
 #include "GrTextureProxy.h"
@@ -21,6 +22,23 @@
 #include "effects/GrSRGBEffect.h"
 #include "effects/GrYUVtoRGBEffect.h"
 
+namespace {
+
+// Uploads one plane straight from the decoded YUV data, which it keeps alive until the upload has
+// happened. The planes are already decoded, so the pixels are ready as soon as it is created.
+class YUVPlaneUploader : public GrDeferredProxyUploader {
+public:
+    YUVPlaneUploader(const SkPixmap& plane, sk_sp<SkCachedData> data) : fData(std::move(data)) {
+        this->getPixels()->reset(plane.info(), plane.addr(), plane.rowBytes());
+        this->signalAndFreeData();
+    }
+
+private:
+    sk_sp<SkCachedData> fData;
+};
+
+}  // anonymous namespace
+
 sk_sp<SkCachedData> init_provider(GrYUVProvider* provider, SkYUVPlanesCache::Info* yuvInfo,
                                   void* planes[3]) {
     sk_sp<SkCachedData> data;
@@ -92,6 +110,26 @@ sk_sp<GrTextureProxy> GrYUVProvider::refAsTextureProxy(GrContext* ctx, const GrS
 
         SkImageInfo imageInfo = SkImageInfo::MakeA8(componentWidth, componentHeight);
         SkPixmap pixmap(imageInfo, planes[i], yuvInfo.fSizeInfo.fWidthBytes[i]);
+        auto proxyProvider = ctx->contextPriv().proxyProvider();
+
+        if (ctx->caps()->deferYUVPlaneUploads() && !proxyProvider->recordingDDL()) {
+            // The plane is uploaded by the first flush that samples it, after which the uploader
+            // (and its ref on the cached yuv data) is deleted.
+            GrSurfaceDesc planeDesc;
+            planeDesc.fWidth = componentWidth;
+            planeDesc.fHeight = componentHeight;
+            planeDesc.fConfig = kAlpha_8_GrPixelConfig;
+            yuvTextureProxies[i] = proxyProvider->createProxy(
+                    planeDesc, kTopLeft_GrSurfaceOrigin, fit, SkBudgeted::kYes,
+                    GrInternalSurfaceFlags::kNoPendingIO);
+            if (!yuvTextureProxies[i]) {
+                return nullptr;
+            }
+            yuvTextureProxies[i]->texPriv().setDeferredUploader(
+                    skstd::make_unique<YUVPlaneUploader>(pixmap, dataStorage));
+            continue;
+        }
+
         SkCachedData* dataStoragePtr = dataStorage.get();
         // We grab a ref to cached yuv data. When the SkImage we create below goes away it will call
         // the YUVGen_DataReleaseProc which will release this ref.
@@ -103,7 +141,6 @@ sk_sp<GrTextureProxy> GrYUVProvider::refAsTextureProxy(GrContext* ctx, const GrS
         sk_sp<SkImage> yuvImage = SkImage::MakeFromRaster(pixmap, YUVGen_DataReleaseProc,
                                                           dataStoragePtr);
 
-        auto proxyProvider = ctx->contextPriv().proxyProvider();
         yuvTextureProxies[i] = proxyProvider->createTextureProxy(yuvImage, kNone_GrSurfaceFlags,
                                                                  1, SkBudgeted::kYes, fit);
     }
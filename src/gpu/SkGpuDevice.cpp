@@ -1306,6 +1306,10 @@ void SkGpuDevice::drawImage(const SkImage* image, SkScalar x, SkScalar y, const
         return;
     }
     if (as_IB(image)->getROPixels(&bm, fRenderTargetContext->colorSpaceInfo().colorSpace())) {
+        if (this->drawBitmapFromImageAtlas(bm, nullptr, nullptr, SkCanvas::kFast_SrcRectConstraint,
+                                           viewMatrix, paint)) {
+            return;
+        }
         GrBitmapTextureMaker maker(fContext.get(), bm);
         this->drawTextureMaker(&maker, image->width(), image->height(), nullptr, nullptr,
                                SkCanvas::kFast_SrcRectConstraint, viewMatrix, paint);
@@ -1344,6 +1348,9 @@ void SkGpuDevice::drawImageRect(const SkImage* image, const SkRect* src, const S
         return;
     }
     if (as_IB(image)->getROPixels(&bm, fRenderTargetContext->colorSpaceInfo().colorSpace())) {
+        if (this->drawBitmapFromImageAtlas(bm, src, &dst, constraint, this->ctm(), paint)) {
+            return;
+        }
         GrBitmapTextureMaker maker(fContext.get(), bm);
         this->drawTextureMaker(&maker, image->width(), image->height(), src, &dst, constraint,
                                this->ctm(), paint);
@@ -216,6 +216,15 @@ private:
                                 const SkMatrix& viewMatrix,
                                 const SkPaint&);
 
+    // Draws a raster image's pixels from the GrProxyProvider's image atlas, adding them to the
+    // atlas if needed. Returns false if the image must be drawn from its own texture.
+    bool drawBitmapFromImageAtlas(const SkBitmap&,
+                                  const SkRect* srcRect,
+                                  const SkRect* dstRect,
+                                  SkCanvas::SrcRectConstraint,
+                                  const SkMatrix& viewMatrix,
+                                  const SkPaint&);
+
     void drawTextureMaker(GrTextureMaker* maker,
                           int imageW,
                           int imageH,
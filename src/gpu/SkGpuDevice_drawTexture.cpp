@@ -9,6 +9,9 @@
 #include "GrBlurUtils.h"
 #include "GrCaps.h"
 #include "GrColorSpaceXform.h"
+#include "GrContextPriv.h"
+#include "GrImageAtlas.h"
+#include "GrProxyProvider.h"
 #include "GrRenderTargetContext.h"
 #include "GrStyle.h"
 #include "GrTextureAdjuster.h"
@@ -102,7 +105,7 @@ static bool can_use_draw_texture_affine(const SkPaint& paint, GrAA aa, const SkM
 static void draw_texture_affine(const SkPaint& paint, const SkMatrix& ctm, const SkRect* src,
                                 const SkRect* dst, GrAA aa, sk_sp<GrTextureProxy> proxy,
                                 SkColorSpace* colorSpace, const GrClip& clip,
-                                GrRenderTargetContext* rtc) {
+                                GrRenderTargetContext* rtc, GrImageAtlas* imageAtlas = nullptr) {
     SkASSERT(!(SkToBool(src) && !SkToBool(dst)));
     SkRect srcRect = src ? *src : SkRect::MakeWH(proxy->width(), proxy->height());
     SkRect dstRect = dst ? *dst : srcRect;
@@ -131,7 +134,7 @@ static void draw_texture_affine(const SkPaint& paint, const SkMatrix& ctm, const
                             ? SkColorToPremulGrColor(paint.getColor())
                             : SkColorAlphaToGrColor(paint.getColor());
     rtc->drawTextureAffine(clip, std::move(proxy), filter, color, srcRect, dstRect, aa, ctm,
-                           std::move(csxf));
+                           std::move(csxf), imageAtlas);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -152,6 +155,42 @@ void SkGpuDevice::drawPinnedTextureProxy(sk_sp<GrTextureProxy> proxy, uint32_t p
     this->drawTextureProducer(&adjuster, srcRect, dstRect, constraint, viewMatrix, paint);
 }
 
+bool SkGpuDevice::drawBitmapFromImageAtlas(const SkBitmap& bitmap, const SkRect* srcRect,
+                                           const SkRect* dstRect,
+                                           SkCanvas::SrcRectConstraint constraint,
+                                           const SkMatrix& viewMatrix, const SkPaint& paint) {
+    GrAA aa = GrAA(paint.isAntiAlias());
+    if (!can_use_draw_texture_affine(paint, aa, viewMatrix, constraint)) {
+        return false;
+    }
+    GrImageAtlas* imageAtlas = fContext->contextPriv().proxyProvider()->imageAtlas();
+    if (!imageAtlas) {
+        return false;
+    }
+    sk_sp<GrTextureProxy> page;
+    SkIPoint offset;
+    if (!imageAtlas->findOrAdd(bitmap, &page, &offset)) {
+        return false;
+    }
+    // The page is larger than the image so clip the src rect to the image here rather than
+    // letting draw_texture_affine clip it to the page.
+    const SkRect bounds = SkRect::MakeIWH(bitmap.width(), bitmap.height());
+    SkRect src = srcRect ? *srcRect : bounds;
+    SkRect dst = dstRect ? *dstRect : src;
+    if (!bounds.contains(src)) {
+        SkMatrix srcToDst;
+        srcToDst.setRectToRect(src, dst, SkMatrix::kFill_ScaleToFit);
+        if (!src.intersect(bounds)) {
+            return true;
+        }
+        srcToDst.mapRect(&dst, src);
+    }
+    src.offset(SkIntToScalar(offset.fX), SkIntToScalar(offset.fY));
+    draw_texture_affine(paint, viewMatrix, &src, &dst, aa, std::move(page), bitmap.colorSpace(),
+                        this->clip(), fRenderTargetContext.get(), imageAtlas);
+    return true;
+}
+
 void SkGpuDevice::drawTextureMaker(GrTextureMaker* maker, int imageW, int imageH,
                                    const SkRect* srcRect, const SkRect* dstRect,
                                    SkCanvas::SrcRectConstraint constraint,
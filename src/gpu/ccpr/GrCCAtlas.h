@@ -40,9 +40,15 @@ public:
         fCoverageCountBatchID = batchID;
     }
 
+    // Makes the atlas's render target and records an op that draws the coverage counts of the
+    // parser's batch into it.
     sk_sp<GrRenderTargetContext> SK_WARN_UNUSED_RESULT finalize(GrOnFlushResourceProvider*,
                                                                 sk_sp<const GrCCPathParser>);
 
+    // Makes the atlas's render target and records the given op, which fills in the atlas itself.
+    sk_sp<GrRenderTargetContext> SK_WARN_UNUSED_RESULT finalize(GrOnFlushResourceProvider*,
+                                                                std::unique_ptr<GrDrawOp>);
+
     GrTextureProxy* textureProxy() const { return fTextureProxy.get(); }
 
 private:
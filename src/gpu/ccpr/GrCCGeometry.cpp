@@ -20,6 +20,17 @@ GR_STATIC_ASSERT(0 == offsetof(SkPoint, fX));
 
 static constexpr float kFlatnessThreshold = 1/16.f; // 1/16 of a pixel.
 
+void GrCCGeometry::append(const GrCCGeometry& that, const Location& begin, const Location& end) {
+    SkASSERT(!fBuildingContour);
+    SkASSERT(!that.fBuildingContour);
+    SkASSERT(begin.fVerbsIdx <= end.fVerbsIdx && end.fVerbsIdx <= that.fVerbs.count());
+    fPoints.push_back_n(end.fPointsIdx - begin.fPointsIdx,
+                        that.fPoints.begin() + begin.fPointsIdx);
+    fVerbs.push_back_n(end.fVerbsIdx - begin.fVerbsIdx, that.fVerbs.begin() + begin.fVerbsIdx);
+    fConicWeights.push_back_n(end.fConicWeightsIdx - begin.fConicWeightsIdx,
+                              that.fConicWeights.begin() + begin.fConicWeightsIdx);
+}
+
 void GrCCGeometry::beginPath() {
     SkASSERT(!fBuildingContour);
     fVerbs.push_back(Verb::kBeginPath);
@@ -74,6 +74,22 @@ public:
                  fVerbs.back() == Verb::kEndClosedContour);
     }
 
+    // Marks a position in the geometry's points, verbs and conic weights, e.g. the start of a path.
+    struct Location {
+        int fPointsIdx;
+        int fVerbsIdx;
+        int fConicWeightsIdx;
+    };
+
+    Location location() const {
+        SkASSERT(!fBuildingContour);
+        return {fPoints.count(), fVerbs.count(), fConicWeights.count()};
+    }
+
+    // Appends everything another geometry has between two of its locations. This is how paths
+    // that were chopped up into separate geometries, e.g. on separate threads, get merged.
+    void append(const GrCCGeometry&, const Location& begin, const Location& end);
+
     void beginPath();
     void beginContour(const SkPoint&);
     void lineTo(const SkPoint P[2]);
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrCCPathCache.h"
+
+#include "GrTextureProxy.h"
+#include "SkMatrix.h"
+#include "SkOpts.h"
+#include "ccpr/GrCCAtlas.h"
+
+constexpr int GrCCPathCache::kMaxCacheCount;
+
+bool GrCCPathCache::Key::set(const SkPath& path, const SkMatrix& m, SkIVector* shift) {
+    SkASSERT(!m.hasPerspective());
+    if (path.isVolatile()) {
+        return false;
+    }
+    // Past this, floats can't tell a subpixel translate from an integer one anyway. (This also
+    // rejects non-finite translates.)
+    constexpr float kMaxTranslate = 1 << 24;
+    float tx = m.getTranslateX(), ty = m.getTranslateY();
+    if (!(SkScalarAbs(tx) <= kMaxTranslate && SkScalarAbs(ty) <= kMaxTranslate)) {
+        return false;
+    }
+    float floorTx = floorf(tx), floorTy = floorf(ty);
+    // Zero first, so even the padding (of which there shouldn't be any) gets hashed consistently.
+    memset(this, 0, sizeof(Key));
+    fPathGenID = path.getGenerationID();
+    fFillType = path.getFillType();
+    fMatrix2x2[0] = m.getScaleX();
+    fMatrix2x2[1] = m.getSkewY();
+    fMatrix2x2[2] = m.getSkewX();
+    fMatrix2x2[3] = m.getScaleY();
+    fSubpixelTranslate[0] = tx - floorTx;
+    fSubpixelTranslate[1] = ty - floorTy;
+    shift->set((int)floorTx, (int)floorTy);
+    return true;
+}
+
+uint32_t GrCCPathCache::HashTraits::Hash(const Key& key) {
+    return SkOpts::hash(&key, sizeof(Key));
+}
+
+GrCCPathCache::Entry::~Entry() {
+    SkASSERT(!fIsInCache);
+}
+
+GrCCPathCache::~GrCCPathCache() {
+    fPendingEntries.reset();
+    fStashedEntries.reset();
+    while (Entry* entry = fLRU.head()) {
+        entry->fPendingAtlas = nullptr;
+        this->evict(entry);
+    }
+}
+
+GrCCPathCache::Entry* GrCCPathCache::find(const Key& key) {
+    Entry** entry = fHashTable.find(key);
+    if (!entry) {
+        return nullptr;
+    }
+    if (fLRU.head() != *entry) {
+        fLRU.remove(*entry);
+        fLRU.addToHead(*entry);
+    }
+    return *entry;
+}
+
+void GrCCPathCache::insert(const Key& key, const SkIVector& shift, const SkRect& devBounds,
+                           const SkRect& devBounds45, const SkIRect& devIBounds,
+                           const GrCCAtlas* atlas, const SkIVector& atlasOffset) {
+    SkASSERT(!fHashTable.find(key));
+    SkASSERT(atlas);
+    Entry* entry = new Entry(key);
+    entry->fShift = shift;
+    entry->fDevBounds = devBounds;
+    entry->fDevBounds45 = devBounds45;
+    entry->fDevIBounds = devIBounds;
+    entry->fAtlasOffset = atlasOffset;
+    entry->fPendingAtlas = atlas;
+    fHashTable.set(entry);
+    fLRU.addToHead(entry);
+    fPendingEntries.push_back(sk_ref_sp(entry));
+}
+
+void GrCCPathCache::setCopyAtlas(Entry* entry, const GrCCAtlas* atlas,
+                                 const SkIVector& atlasOffset) {
+    SkASSERT(entry->fIsInCache);
+    SkASSERT(entry->fIsCoverageCount);
+    SkASSERT(!entry->fPendingAtlas);
+    SkASSERT(atlas);
+    entry->fAtlasOffset = atlasOffset;
+    entry->fIsCoverageCount = false;
+    entry->fPendingAtlas = atlas;
+    fPendingEntries.push_back(sk_ref_sp(entry));
+}
+
+void GrCCPathCache::postFlush() {
+    // Point the entries at the textures of this flush's atlases, before the atlases go away. The
+    // atlases that failed to allocate don't have one.
+    for (const sk_sp<Entry>& entry : fPendingEntries) {
+        SkASSERT(entry->fPendingAtlas);
+        entry->fAtlasProxy = sk_ref_sp(entry->fPendingAtlas->textureProxy());
+        entry->fPendingAtlas = nullptr;
+    }
+
+    // Last flush's stashed coverage counts couldn't have been copied in any later flush than this.
+    for (const sk_sp<Entry>& entry : fStashedEntries) {
+        if (entry->fIsInCache && entry->fIsCoverageCount) {
+            this->evict(entry.get());
+        }
+    }
+    fStashedEntries.reset();
+
+    for (sk_sp<Entry>& entry : fPendingEntries) {
+        if (!entry->fIsInCache) {
+            continue;
+        }
+        if (!entry->fAtlasProxy) {
+            this->evict(entry.get());
+        } else if (entry->fIsCoverageCount) {
+            fStashedEntries.push_back(std::move(entry));
+        }
+    }
+    fPendingEntries.reset();
+
+    while (fHashTable.count() > kMaxCacheCount) {
+        this->evict(fLRU.tail());
+    }
+}
+
+void GrCCPathCache::evict(Entry* entry) {
+    SkASSERT(entry->fIsInCache);
+    SkASSERT(!entry->fPendingAtlas);
+    fHashTable.remove(entry->fKey);
+    fLRU.remove(entry);
+    entry->fIsInCache = false;
+    entry->unref();
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrCCPathCache_DEFINED
+#define GrCCPathCache_DEFINED
+
+#include "SkPath.h"
+#include "SkRefCnt.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+#include "SkTInternalLList.h"
+
+class GrCCAtlas;
+class GrTextureProxy;
+class SkMatrix;
+
+/**
+ * Keeps the masks CCPR renders for paths from one flush to the next, so a path drawn again with
+ * the same fill rule and view matrix (up to integer translation) doesn't need to be rendered again.
+ *
+ * A path's mask is first rendered as a coverage count into its flush's atlas, like any other, and
+ * the cache holds on to ("stashes") that atlas until the end of the next flush. If the path is
+ * drawn again in that flush, its mask is resolved to literal coverage and copied into a longer
+ * lived atlas, where it stays until the entry is evicted. Stashed entries that weren't drawn in the
+ * next flush are evicted, as are the least recently used entries past kMaxCacheCount.
+ *
+ * Entries are only evicted in postFlush(), so they can be pointed at throughout a flush.
+ */
+class GrCCPathCache {
+public:
+    static constexpr int kMaxCacheCount = 1 << 10;
+
+    // Identifies a path's mask: the path, its fill rule, and every part of its view matrix except
+    // the integer part of the translate.
+    class Key {
+    public:
+        // Returns false if the path can't be cached. Otherwise also returns the integer translate
+        // that moves the key's mask to where the matrix puts the path.
+        bool set(const SkPath&, const SkMatrix&, SkIVector* shift);
+
+        SkPath::FillType fillType() const { return (SkPath::FillType)fFillType; }
+
+        bool operator==(const Key& that) const { return !memcmp(this, &that, sizeof(Key)); }
+
+    private:
+        uint32_t fPathGenID;
+        uint32_t fFillType;
+        float fMatrix2x2[4];
+        float fSubpixelTranslate[2];
+    };
+
+    class Entry : public SkNVRefCnt<Entry> {
+    public:
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+
+        const Key& key() const { return fKey; }
+
+        // The path's device-space bounds when its mask was rendered, and the integer translate of
+        // the matrix it was rendered with.
+        const SkRect& devBounds() const { return fDevBounds; }
+        const SkRect& devBounds45() const { return fDevBounds45; }
+        const SkIRect& devIBounds() const { return fDevIBounds; }
+        const SkIVector& shift() const { return fShift; }
+
+        // Maps device space, at the time the mask was rendered, to atlas space.
+        const SkIVector& atlasOffset() const { return fAtlasOffset; }
+
+        // True if the mask is a coverage count in a flush's atlas, rather than literal coverage.
+        bool isCoverageCount() const { return fIsCoverageCount; }
+
+        // Non-null if the mask is in one of the current flush's atlases.
+        const GrCCAtlas* pendingAtlas() const { return fPendingAtlas; }
+
+        // Otherwise, the texture that holds the mask.
+        GrTextureProxy* atlasProxy() const { return fAtlasProxy.get(); }
+
+        ~Entry();
+
+    private:
+        Entry(const Key& key) : fKey(key) {}
+
+        const Key fKey;
+        SkRect fDevBounds;
+        SkRect fDevBounds45;
+        SkIRect fDevIBounds;
+        SkIVector fShift;
+        SkIVector fAtlasOffset;
+        bool fIsCoverageCount = true;
+        bool fIsInCache = true;
+        const GrCCAtlas* fPendingAtlas = nullptr;
+        sk_sp<GrTextureProxy> fAtlasProxy;
+
+        friend class GrCCPathCache;
+    };
+
+    ~GrCCPathCache();
+
+    int count() const { return fHashTable.count(); }
+
+    // Returns the entry for the key, if there is one, and marks it most recently used.
+    Entry* find(const Key&);
+
+    // Like find(), but leaves the entry's place in the LRU alone.
+    bool has(const Key& key) const { return SkToBool(fHashTable.find(key)); }
+
+    // Adds an entry for a path whose coverage count is being rendered into one of this flush's
+    // atlases. There must not be an entry for the key already.
+    void insert(const Key&, const SkIVector& shift, const SkRect& devBounds,
+                const SkRect& devBounds45, const SkIRect& devIBounds, const GrCCAtlas*,
+                const SkIVector& atlasOffset);
+
+    // Notes that a stashed entry's mask is being copied into one of this flush's atlases, as
+    // literal coverage.
+    void setCopyAtlas(Entry*, const GrCCAtlas*, const SkIVector& atlasOffset);
+
+    // Must be called at the end of every flush, while this flush's atlases are still alive. Entries
+    // take refs on the textures their masks went into this flush, and the ones that didn't get a
+    // texture, or weren't copied out of their stash in time, are evicted.
+    void postFlush();
+
+private:
+    struct HashTraits {
+        static const Key& GetKey(const Entry* entry) { return entry->fKey; }
+        static uint32_t Hash(const Key&);
+    };
+
+    void evict(Entry*);
+
+    SkTHashTable<Entry*, const Key&, HashTraits> fHashTable;
+    SkTInternalLList<Entry> fLRU;
+    SkTArray<sk_sp<Entry>> fPendingEntries;  // Entries whose masks went into this flush's atlases.
+    SkTArray<sk_sp<Entry>> fStashedEntries;  // Entries rendered last flush that may be copied.
+};
+
+#endif
@@ -15,6 +15,7 @@
 #include "SkPath.h"
 #include "SkPathPriv.h"
 #include "SkPoint.h"
+#include "SkTaskGroup.h"
 #include "ccpr/GrCCGeometry.h"
 #include <stdlib.h>
 
@@ -37,18 +38,13 @@ GrCCPathParser::GrCCPathParser(int maxTotalPaths, int maxPathPoints, int numSkPo
                                          PrimitiveTallies()};
 }
 
-void GrCCPathParser::parsePath(const SkMatrix& m, const SkPath& path, SkRect* devBounds,
-                               SkRect* devBounds45) {
+// Maps the path's points to device space, and returns device-space and "45 degree" bounds. devPts
+// must have room for one more point than the path has.
+static void map_path_points(const SkMatrix& m, const SkPath& path, SkPoint* devPts,
+                            SkRect* devBounds, SkRect* devBounds45) {
     const SkPoint* pts = SkPathPriv::PointData(path);
     int numPts = path.countPoints();
-    SkASSERT(numPts + 1 <= fLocalDevPtsBuffer.count());
-
-    if (!numPts) {
-        devBounds->setEmpty();
-        devBounds45->setEmpty();
-        this->parsePath(path, nullptr);
-        return;
-    }
+    SkASSERT(numPts);
 
     // m45 transforms path points into "45 degree" device space. A bounding box in this space gives
     // the circumscribing octagon's diagonals. We could use SK_ScalarRoot2Over2, but an orthonormal
@@ -73,14 +69,14 @@ void GrCCPathParser::parsePath(const SkMatrix& m, const SkPath& path, SkRect* de
     // Store all 4 values [dev.x, dev.y, dev45.x, dev45.y]. We are only interested in the first two,
     // and will overwrite [dev45.x, dev45.y] with the next point. This is why the dst buffer must
     // be at least one larger than the number of points.
-    devPt.store(&fLocalDevPtsBuffer[0]);
+    devPt.store(&devPts[0]);
 
     for (int i = 1; i < numPts; ++i) {
         devPt = SkNx_fma(Y, Sk4f(pts[i].y()), T);
         devPt = SkNx_fma(X, Sk4f(pts[i].x()), devPt);
         topLeft = Sk4f::Min(topLeft, devPt);
         bottomRight = Sk4f::Max(bottomRight, devPt);
-        devPt.store(&fLocalDevPtsBuffer[i]);
+        devPt.store(&devPts[i]);
     }
 
     SkPoint topLeftPts[2], bottomRightPts[2];
@@ -90,28 +86,19 @@ void GrCCPathParser::parsePath(const SkMatrix& m, const SkPath& path, SkRect* de
                        bottomRightPts[0].y());
     devBounds45->setLTRB(topLeftPts[1].x(), topLeftPts[1].y(), bottomRightPts[1].x(),
                          bottomRightPts[1].y());
-
-    this->parsePath(path, fLocalDevPtsBuffer.get());
 }
 
-void GrCCPathParser::parseDeviceSpacePath(const SkPath& deviceSpacePath) {
-    this->parsePath(deviceSpacePath, SkPathPriv::PointData(deviceSpacePath));
-}
-
-void GrCCPathParser::parsePath(const SkPath& path, const SkPoint* deviceSpacePts) {
-    SkASSERT(!fInstanceBuffer); // Can't call after finalize().
-    SkASSERT(!fParsingPath); // Call saveParsedPath() or discardParsedPath() for the last one first.
-    SkDEBUGCODE(fParsingPath = true);
+// Chops a device-space path up into the geometry, and returns the number of primitives it needs.
+static GrCCGeometry::PrimitiveTallies parse_device_space_path(const SkPath& path,
+                                                              const SkPoint* deviceSpacePts,
+                                                              GrCCGeometry* geometry) {
     SkASSERT(path.isEmpty() || deviceSpacePts);
+    GrCCGeometry::PrimitiveTallies primitiveCounts = GrCCGeometry::PrimitiveTallies();
 
-    fCurrPathPointsIdx = fGeometry.points().count();
-    fCurrPathVerbsIdx = fGeometry.verbs().count();
-    fCurrPathPrimitiveCounts = PrimitiveTallies();
-
-    fGeometry.beginPath();
+    geometry->beginPath();
 
     if (path.isEmpty()) {
-        return;
+        return primitiveCounts;
     }
 
     const float* conicWeights = SkPathPriv::ConicWeightData(path);
@@ -122,29 +109,33 @@ void GrCCPathParser::parsePath(const SkPath& path, const SkPoint* deviceSpacePts
     for (SkPath::Verb verb : SkPathPriv::Verbs(path)) {
         switch (verb) {
             case SkPath::kMove_Verb:
-                this->endContourIfNeeded(insideContour);
-                fGeometry.beginContour(deviceSpacePts[ptsIdx]);
+                if (insideContour) {
+                    primitiveCounts += geometry->endContour();
+                }
+                geometry->beginContour(deviceSpacePts[ptsIdx]);
                 ++ptsIdx;
                 insideContour = true;
                 continue;
             case SkPath::kClose_Verb:
-                this->endContourIfNeeded(insideContour);
+                if (insideContour) {
+                    primitiveCounts += geometry->endContour();
+                }
                 insideContour = false;
                 continue;
             case SkPath::kLine_Verb:
-                fGeometry.lineTo(&deviceSpacePts[ptsIdx - 1]);
+                geometry->lineTo(&deviceSpacePts[ptsIdx - 1]);
                 ++ptsIdx;
                 continue;
             case SkPath::kQuad_Verb:
-                fGeometry.quadraticTo(&deviceSpacePts[ptsIdx - 1]);
+                geometry->quadraticTo(&deviceSpacePts[ptsIdx - 1]);
                 ptsIdx += 2;
                 continue;
             case SkPath::kCubic_Verb:
-                fGeometry.cubicTo(&deviceSpacePts[ptsIdx - 1]);
+                geometry->cubicTo(&deviceSpacePts[ptsIdx - 1]);
                 ptsIdx += 3;
                 continue;
             case SkPath::kConic_Verb:
-                fGeometry.conicTo(&deviceSpacePts[ptsIdx - 1], conicWeights[conicWeightsIdx]);
+                geometry->conicTo(&deviceSpacePts[ptsIdx - 1], conicWeights[conicWeightsIdx]);
                 ptsIdx += 2;
                 ++conicWeightsIdx;
                 continue;
@@ -155,13 +146,112 @@ void GrCCPathParser::parsePath(const SkPath& path, const SkPoint* deviceSpacePts
     SkASSERT(ptsIdx == path.countPoints());
     SkASSERT(conicWeightsIdx == SkPathPriv::ConicWeightCnt(path));
 
-    this->endContourIfNeeded(insideContour);
+    if (insideContour) {
+        primitiveCounts += geometry->endContour();
+    }
+    return primitiveCounts;
 }
 
-void GrCCPathParser::endContourIfNeeded(bool insideContour) {
-    if (insideContour) {
-        fCurrPathPrimitiveCounts += fGeometry.endContour();
+void GrCCPathParser::parsePath(const SkMatrix& m, const SkPath& path, SkRect* devBounds,
+                               SkRect* devBounds45) {
+    int numPts = path.countPoints();
+    SkASSERT(numPts + 1 <= fLocalDevPtsBuffer.count());
+
+    if (!numPts) {
+        devBounds->setEmpty();
+        devBounds45->setEmpty();
+        this->parsePath(path, nullptr);
+        return;
     }
+
+    map_path_points(m, path, fLocalDevPtsBuffer.get(), devBounds, devBounds45);
+    this->parsePath(path, fLocalDevPtsBuffer.get());
+}
+
+void GrCCPathParser::parseDeviceSpacePath(const SkPath& deviceSpacePath) {
+    this->parsePath(deviceSpacePath, SkPathPriv::PointData(deviceSpacePath));
+}
+
+void GrCCPathParser::parsePath(const SkPath& path, const SkPoint* deviceSpacePts) {
+    this->beginParsingPath();
+    fCurrPathPrimitiveCounts = parse_device_space_path(path, deviceSpacePts, &fGeometry);
+}
+
+void GrCCPathParser::beginParsingPath() {
+    SkASSERT(!fInstanceBuffer); // Can't call after finalize().
+    SkASSERT(!fParsingPath); // Call saveParsedPath() or discardParsedPath() for the last one first.
+    SkDEBUGCODE(fParsingPath = true);
+
+    fCurrPathPointsIdx = fGeometry.points().count();
+    fCurrPathVerbsIdx = fGeometry.verbs().count();
+    fCurrPathPrimitiveCounts = PrimitiveTallies();
+}
+
+// Each preparse job chops up this many paths, so there is enough work in each to be worth sending
+// to another thread.
+static constexpr int kPathsPerPreparseJob = 32;
+
+void GrCCPathParser::preparsePaths(SkExecutor* executor, const PathToPreparse paths[],
+                                   int count) {
+    SkASSERT(!fInstanceBuffer);
+    SkASSERT(fPreparsedPaths.empty());
+    if (!count) {
+        return;
+    }
+
+    int numJobs = (count + kPathsPerPreparseJob - 1) / kPathsPerPreparseJob;
+    fPreparsedPaths.push_back_n(count);
+    fPreparsedGeometries.reserve(numJobs);
+    for (int i = 0; i < numJobs; ++i) {
+        int numSkPoints = 0, numSkVerbs = 0;
+        for (int j = i * kPathsPerPreparseJob; j < SkTMin((i + 1) * kPathsPerPreparseJob, count);
+             ++j) {
+            numSkPoints += paths[j].fPath->countPoints();
+            numSkVerbs += paths[j].fPath->countVerbs();
+        }
+        fPreparsedGeometries.emplace_back(numSkPoints, numSkVerbs);
+    }
+
+    // Each job only touches its own geometry, and its own paths' entries in fPreparsedPaths.
+    SkTaskGroup taskGroup(*executor);
+    taskGroup.batch(numJobs, [&](int jobIdx) {
+        GrCCGeometry* geometry = &fPreparsedGeometries[jobIdx];
+        int endIdx = SkTMin((jobIdx + 1) * kPathsPerPreparseJob, count);
+        int maxPathPoints = 0;
+        for (int i = jobIdx * kPathsPerPreparseJob; i < endIdx; ++i) {
+            maxPathPoints = SkTMax(paths[i].fPath->countPoints(), maxPathPoints);
+        }
+        // Overallocate by one point, like fLocalDevPtsBuffer.
+        SkAutoSTArray<32, SkPoint> devPts(maxPathPoints + 1);
+        for (int i = jobIdx * kPathsPerPreparseJob; i < endIdx; ++i) {
+            const SkPath& path = *paths[i].fPath;
+            PreparsedPath* preparsed = &fPreparsedPaths[i];
+            preparsed->fGeometryIdx = jobIdx;
+            preparsed->fBegin = geometry->location();
+            if (path.countPoints()) {
+                map_path_points(*paths[i].fMatrix, path, devPts.get(), &preparsed->fDevBounds,
+                                &preparsed->fDevBounds45);
+                preparsed->fPrimitiveCounts =
+                        parse_device_space_path(path, devPts.get(), geometry);
+            } else {
+                preparsed->fDevBounds.setEmpty();
+                preparsed->fDevBounds45.setEmpty();
+                preparsed->fPrimitiveCounts = parse_device_space_path(path, nullptr, geometry);
+            }
+            preparsed->fEnd = geometry->location();
+        }
+    });
+    taskGroup.wait();
+}
+
+void GrCCPathParser::parsePreparsedPath(int idx, SkRect* devBounds, SkRect* devBounds45) {
+    const PreparsedPath& preparsed = fPreparsedPaths[idx];
+    this->beginParsingPath();
+    fGeometry.append(fPreparsedGeometries[preparsed.fGeometryIdx], preparsed.fBegin,
+                     preparsed.fEnd);
+    fCurrPathPrimitiveCounts = preparsed.fPrimitiveCounts;
+    *devBounds = preparsed.fDevBounds;
+    *devBounds45 = preparsed.fDevBounds45;
 }
 
 void GrCCPathParser::saveParsedPath(ScissorMode scissorMode, const SkIRect& clippedDevIBounds,
@@ -18,6 +18,7 @@
 #include "ops/GrDrawOp.h"
 
 class GrOnFlushResourceProvider;
+class SkExecutor;
 class SkMatrix;
 class SkPath;
 
@@ -49,6 +50,20 @@ public:
     //                                                                 | 1  1 |
     void parsePath(const SkMatrix&, const SkPath&, SkRect* devBounds, SkRect* devBounds45);
 
+    struct PathToPreparse {
+        const SkMatrix* fMatrix;
+        const SkPath* fPath;
+    };
+
+    // Does the bulk of parsePath's work for the given paths ahead of time, on the executor's
+    // threads. Each job chops its share of the paths into a geometry of its own, and blocks until
+    // they are all done. The matrices and paths must outlive the parser.
+    void preparsePaths(SkExecutor*, const PathToPreparse[], int count);
+
+    // Equivalent to parsePath(*paths[idx].fMatrix, *paths[idx].fPath, ...) for the paths given to
+    // preparsePaths, but only has to copy the path's geometry into place.
+    void parsePreparsedPath(int idx, SkRect* devBounds, SkRect* devBounds45);
+
     // Parses a device-space SkPath into a temporary staging area. The path will not be included in
     // the current batch until there is a matching call to saveParsedPath. The user must complement
     // this with a following call to either saveParsedPath or discardParsedPath.
@@ -124,8 +139,18 @@ private:
         SkIRect fScissor;
     };
 
+    // A path that preparsePaths chopped into one of the jobs' geometries.
+    struct PreparsedPath {
+        int fGeometryIdx;
+        GrCCGeometry::Location fBegin;
+        GrCCGeometry::Location fEnd;
+        PrimitiveTallies fPrimitiveCounts;
+        SkRect fDevBounds;
+        SkRect fDevBounds45;
+    };
+
     void parsePath(const SkPath&, const SkPoint* deviceSpacePts);
-    void endContourIfNeeded(bool insideContour);
+    void beginParsingPath();
 
     void drawPrimitives(GrOpFlushState*, const GrPipeline&, CoverageCountBatchID,
                         GrCCCoverageProcessor::PrimitiveType, int PrimitiveTallies::*instanceType,
@@ -139,6 +164,8 @@ private:
     PrimitiveTallies fCurrPathPrimitiveCounts;
 
     GrCCGeometry fGeometry;
+    SkTArray<GrCCGeometry> fPreparsedGeometries;
+    SkTArray<PreparsedPath, true> fPreparsedPaths;
     SkSTArray<32, PathInfo, true> fPathsInfo;
     SkSTArray<32, CoverageCountBatch, true> fCoverageCountBatches;
     SkSTArray<32, ScissorSubBatch, true> fScissorSubBatches;
@@ -19,6 +19,7 @@
 #include "SkMakeUnique.h"
 #include "SkMatrix.h"
 #include "SkPathOps.h"
+#include "SkTSort.h"
 #include "ccpr/GrCCClipProcessor.h"
 
 // Shorthand for keeping line lengths under control with nested classes...
@@ -28,6 +29,9 @@ using CCPR = GrCoverageCountingPathRenderer;
 // precision.
 static constexpr float kPathCropThreshold = 1 << 16;
 
+// Parsing a flush's paths on the executor's threads only pays off once there are enough of them.
+static constexpr int kMinPathsToPreparse = 256;
+
 static void crop_path(const SkPath& path, const SkIRect& cropbox, SkPath* out) {
     SkPath cropPath;
     cropPath.addRect(SkRect::Make(cropbox));
@@ -37,6 +41,74 @@ static void crop_path(const SkPath& path, const SkIRect& cropbox, SkPath* out) {
     }
 }
 
+namespace {
+// Resolves cached coverage counts, stashed in last flush's atlases, to literal coverage in a copy
+// atlas. Masks in a copy atlas can be drawn with either fill rule: GrCCPathProcessor maps any
+// coverage in [0, 1] to itself under both.
+class CopyPathsOp : public GrDrawOp {
+public:
+    DEFINE_OP_CLASS_ID
+
+    CopyPathsOp(sk_sp<const GrBuffer> indexBuffer, sk_sp<const GrBuffer> vertexBuffer,
+                sk_sp<const GrBuffer> instanceBuffer, int baseInstance, const SkISize& drawBounds)
+            : INHERITED(ClassID())
+            , fIndexBuffer(std::move(indexBuffer))
+            , fVertexBuffer(std::move(vertexBuffer))
+            , fInstanceBuffer(std::move(instanceBuffer))
+            , fBaseInstance(baseInstance) {
+        this->setBounds(SkRect::MakeIWH(drawBounds.width(), drawBounds.height()),
+                        GrOp::HasAABloat::kNo, GrOp::IsZeroArea::kNo);
+    }
+
+    // The instances before endInstance (and after the previous range) all read from srcProxy.
+    void addRange(sk_sp<GrTextureProxy> srcProxy, SkPath::FillType fillType, int endInstance) {
+        SkASSERT(endInstance > (fRanges.empty() ? fBaseInstance : fRanges.back().fEndInstance));
+        fRanges.push_back() = {std::move(srcProxy), fillType, endInstance};
+    }
+
+    // GrDrawOp interface.
+    const char* name() const override { return "GrCoverageCountingPathRenderer::CopyPathsOp"; }
+    FixedFunctionFlags fixedFunctionFlags() const override { return FixedFunctionFlags::kNone; }
+    RequiresDstTexture finalize(const GrCaps&, const GrAppliedClip*,
+                                GrPixelConfigIsClamped) override { return RequiresDstTexture::kNo; }
+    bool onCombineIfPossible(GrOp* other, const GrCaps& caps) override { return false; }
+    void onPrepare(GrOpFlushState*) override {}
+    void onExecute(GrOpFlushState* flushState) override {
+        GrPipeline pipeline(flushState->drawOpArgs().fProxy, GrPipeline::ScissorState::kDisabled,
+                            SkBlendMode::kSrc);
+        int baseInstance = fBaseInstance;
+        for (const Range& range : fRanges) {
+            GrCCPathProcessor pathProc(flushState->resourceProvider(), range.fSrcProxy,
+                                       range.fFillType);
+            GrMesh mesh(GrCCPathProcessor::MeshPrimitiveType(flushState->caps()));
+            mesh.setIndexedInstanced(fIndexBuffer.get(),
+                                     GrCCPathProcessor::NumIndicesPerInstance(flushState->caps()),
+                                     fInstanceBuffer.get(), range.fEndInstance - baseInstance,
+                                     baseInstance);
+            mesh.setVertexData(fVertexBuffer.get());
+            flushState->rtCommandBuffer()->draw(pipeline, pathProc, &mesh, nullptr, 1,
+                                                this->bounds());
+            baseInstance = range.fEndInstance;
+        }
+    }
+
+private:
+    struct Range {
+        sk_sp<GrTextureProxy> fSrcProxy;
+        SkPath::FillType fFillType;
+        int fEndInstance;
+    };
+
+    const sk_sp<const GrBuffer> fIndexBuffer;
+    const sk_sp<const GrBuffer> fVertexBuffer;
+    const sk_sp<const GrBuffer> fInstanceBuffer;
+    const int fBaseInstance;
+    SkSTArray<4, Range> fRanges;
+
+    typedef GrDrawOp INHERITED;
+};
+}  // namespace
+
 bool GrCoverageCountingPathRenderer::IsSupported(const GrCaps& caps) {
     const GrShaderCaps& shaderCaps = *caps.shaderCaps();
     return shaderCaps.integerSupport() && shaderCaps.flatInterpolationSupport() &&
@@ -47,11 +119,24 @@ bool GrCoverageCountingPathRenderer::IsSupported(const GrCaps& caps) {
 }
 
 sk_sp<GrCoverageCountingPathRenderer> GrCoverageCountingPathRenderer::CreateIfSupported(
-        const GrCaps& caps, bool drawCachablePaths) {
-    auto ccpr = IsSupported(caps) ? new GrCoverageCountingPathRenderer(drawCachablePaths) : nullptr;
+        const GrCaps& caps, bool drawCachablePaths, bool cachePathMasks,
+        SkExecutor* parseExecutor) {
+    auto ccpr = IsSupported(caps)
+            ? new GrCoverageCountingPathRenderer(drawCachablePaths, cachePathMasks, parseExecutor)
+            : nullptr;
     return sk_sp<GrCoverageCountingPathRenderer>(ccpr);
 }
 
+GrCoverageCountingPathRenderer::GrCoverageCountingPathRenderer(bool drawCachablePaths,
+                                                               bool cachePathMasks,
+                                                               SkExecutor* parseExecutor)
+        : fDrawCachablePaths(drawCachablePaths)
+        , fParseExecutor(parseExecutor) {
+    if (cachePathMasks) {
+        fPathCache = skstd::make_unique<GrCCPathCache>();
+    }
+}
+
 GrPathRenderer::CanDrawPath GrCoverageCountingPathRenderer::onCanDrawPath(
         const CanDrawPathArgs& args) const {
     if (args.fShape->hasUnstyledKey() && !fDrawCachablePaths) {
@@ -122,9 +207,11 @@ CCPR::DrawPathsOp::DrawPathsOp(GrCoverageCountingPathRenderer* ccpr, const DrawP
         fHeadDraw.fMatrix.setIdentity();
         crop_path(path, fHeadDraw.fClipIBounds, &fHeadDraw.fPath);
         devBounds = fHeadDraw.fPath.getBounds();
+        fHeadDraw.fIsCachable = false;
     } else {
         fHeadDraw.fMatrix = *args.fViewMatrix;
         args.fShape->asPath(&fHeadDraw.fPath);
+        fHeadDraw.fIsCachable = !fHeadDraw.fPath.isVolatile();
     }
     fHeadDraw.fColor = color;  // Can't call args.fPaint.getColor() because it has been std::move'd.
 
@@ -259,6 +346,8 @@ void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlush
     SkASSERT(!fPerFlushInstanceBuffer);
     SkASSERT(!fPerFlushPathParser);
     SkASSERT(fPerFlushAtlases.empty());
+    SkASSERT(fPerFlushCopyAtlases.empty());
+    SkASSERT(fPerFlushCopies.empty());
     SkDEBUGCODE(fFlushing = true);
 
     if (fRTPendingPathsMap.empty()) {
@@ -270,6 +359,7 @@ void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlush
     // Count the paths that are being flushed.
     int maxTotalPaths = 0, maxPathPoints = 0, numSkPoints = 0, numSkVerbs = 0;
     SkDEBUGCODE(int numClipPaths = 0);
+    SkSTArray<32, GrCCPathParser::PathToPreparse, true> pathsToPreparse;
     for (int i = 0; i < numOpListIDs; ++i) {
         auto it = fRTPendingPathsMap.find(opListIDs[i]);
         if (fRTPendingPathsMap.end() == it) {
@@ -287,6 +377,9 @@ void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlush
                 numSkPoints += draw->fPath.countPoints();
                 numSkVerbs += draw->fPath.countVerbs();
             }
+            if (fParseExecutor) {
+                op->collectPathsToPreparse(fPathCache.get(), &pathsToPreparse);
+            }
             drawOpsIter.next();
         }
 
@@ -330,6 +423,10 @@ void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlush
 
     fPerFlushPathParser = sk_make_sp<GrCCPathParser>(maxTotalPaths, maxPathPoints, numSkPoints,
                                                      numSkVerbs);
+    if (pathsToPreparse.count() >= kMinPathsToPreparse) {
+        fPerFlushPathParser->preparsePaths(fParseExecutor, pathsToPreparse.begin(),
+                                           pathsToPreparse.count());
+    }
     SkDEBUGCODE(int skippedTotalPaths = 0);
 
     // Allocate atlas(es) and fill out GPU instance buffers.
@@ -363,11 +460,16 @@ void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlush
         fPerFlushAtlases.back().setCoverageCountBatchID(coverageCountBatchID);
     }
 
-    if (!fPerFlushPathParser->finalize(onFlushRP)) {
+    // If every path came from the cache, there is nothing to parse.
+    if (!fPerFlushAtlases.empty() && !fPerFlushPathParser->finalize(onFlushRP)) {
         SkDebugf("WARNING: failed to allocate GPU buffers for CCPR. No paths will be drawn.\n");
         return;
     }
 
+    if (!fPerFlushCopies.empty()) {
+        this->setupCopies(onFlushRP, results);
+    }
+
     // Draw the atlas(es).
     GrTAllocator<GrCCAtlas>::Iter atlasIter(&fPerFlushAtlases);
     while (atlasIter.next()) {
@@ -379,37 +481,96 @@ void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlush
     fPerFlushResourcesAreValid = true;
 }
 
+void CCPR::DrawPathsOp::collectPathsToPreparse(
+        const GrCCPathCache* pathCache,
+        SkTArray<GrCCPathParser::PathToPreparse, true>* pathsToPreparse) {
+    for (SingleDraw* draw = &fHeadDraw; draw; draw = draw->fNext) {
+        GrCCPathCache::Key key;
+        SkIVector shift;
+        if (pathCache && draw->fIsCachable && key.set(draw->fPath, draw->fMatrix, &shift) &&
+            pathCache->has(key)) {
+            continue;
+        }
+        draw->fPreparsedPathIdx = pathsToPreparse->count();
+        pathsToPreparse->push_back() = {&draw->fMatrix, &draw->fPath};
+    }
+}
+
 int CCPR::DrawPathsOp::setupResources(GrOnFlushResourceProvider* onFlushRP,
                                       GrCCPathProcessor::Instance* pathInstanceData,
                                       int pathInstanceIdx) {
     GrCCPathParser* parser = fCCPR->fPerFlushPathParser.get();
+    GrCCPathCache* pathCache = fCCPR->fPathCache.get();
     const GrCCAtlas* currentAtlas = nullptr;
+    GrTextureProxy* currentCachedAtlasProxy = nullptr;
     SkASSERT(fInstanceCount > 0);
     SkASSERT(-1 == fBaseInstance);
     fBaseInstance = pathInstanceIdx;
 
     for (const SingleDraw* draw = this->head(); draw; draw = draw->fNext) {
-        // parsePath gives us two tight bounding boxes: one in device space, as well as a second
-        // one rotated an additional 45 degrees. The path vertex shader uses these two bounding
-        // boxes to generate an octagon that circumscribes the path.
+        // The path vertex shader uses two tight bounding boxes, one in device space and a second
+        // one rotated an additional 45 degrees, to generate an octagon that circumscribes the path.
         SkRect devBounds, devBounds45;
-        parser->parsePath(draw->fMatrix, draw->fPath, &devBounds, &devBounds45);
+        int16_t offsetX, offsetY;
+        const GrCCAtlas* atlas;
+        GrTextureProxy* cachedAtlasProxy = nullptr;
+
+        GrCCPathCache::Key key;
+        SkIVector shift;
+        bool isCachable = pathCache && draw->fIsCachable &&
+                          key.set(draw->fPath, draw->fMatrix, &shift);
+        GrCCPathCache::Entry* entry = isCachable ? pathCache->find(key) : nullptr;
+
+        if (entry) {
+            // We already have a mask for the path. Only the integer translate can have changed.
+            SkIVector delta = shift - entry->shift();
+            if (!SkIRect::Intersects(entry->devIBounds().makeOffset(delta.x(), delta.y()),
+                                     draw->fClipIBounds)) {
+                SkDEBUGCODE(++fNumSkippedInstances);
+                continue;
+            }
+            if (!entry->pendingAtlas() && entry->isCoverageCount()) {
+                fCCPR->copyStashedPathToAtlas(onFlushRP, entry);
+            }
+            atlas = entry->pendingAtlas();
+            if (!atlas) {
+                cachedAtlasProxy = entry->atlasProxy();
+                SkASSERT(cachedAtlasProxy);
+            }
+            devBounds = entry->devBounds().makeOffset(delta.x(), delta.y());
+            devBounds45 = entry->devBounds45().makeOffset(delta.x() - delta.y(),
+                                                          delta.x() + delta.y());
+            offsetX = entry->atlasOffset().x() - delta.x();
+            offsetY = entry->atlasOffset().y() - delta.y();
+        } else {
+            if (draw->fPreparsedPathIdx >= 0) {
+                parser->parsePreparsedPath(draw->fPreparsedPathIdx, &devBounds, &devBounds45);
+            } else {
+                parser->parsePath(draw->fMatrix, draw->fPath, &devBounds, &devBounds45);
+            }
 
-        SkIRect devIBounds;
-        devBounds.roundOut(&devIBounds);
+            SkIRect devIBounds;
+            devBounds.roundOut(&devIBounds);
 
-        int16_t offsetX, offsetY;
-        GrCCAtlas* atlas = fCCPR->placeParsedPathInAtlas(onFlushRP, draw->fClipIBounds, devIBounds,
-                                                         &offsetX, &offsetY);
-        if (!atlas) {
-            SkDEBUGCODE(++fNumSkippedInstances);
-            continue;
+            atlas = fCCPR->placeParsedPathInAtlas(onFlushRP, draw->fClipIBounds, devIBounds,
+                                                  &offsetX, &offsetY);
+            if (!atlas) {
+                SkDEBUGCODE(++fNumSkippedInstances);
+                continue;
+            }
+            // A mask that was cut short by the clip can't be used again elsewhere.
+            if (isCachable && draw->fClipIBounds.contains(devIBounds)) {
+                pathCache->insert(key, shift, devBounds, devBounds45, devIBounds, atlas,
+                                  {offsetX, offsetY});
+            }
         }
-        if (currentAtlas != atlas) {
-            if (currentAtlas) {
-                this->addAtlasBatch(currentAtlas, pathInstanceIdx);
+
+        if (currentAtlas != atlas || currentCachedAtlasProxy != cachedAtlasProxy) {
+            if (currentAtlas || currentCachedAtlasProxy) {
+                this->addAtlasBatch(currentAtlas, currentCachedAtlasProxy, pathInstanceIdx);
             }
             currentAtlas = atlas;
+            currentCachedAtlasProxy = cachedAtlasProxy;
         }
 
         const SkMatrix& m = draw->fMatrix;
@@ -423,8 +584,8 @@ int CCPR::DrawPathsOp::setupResources(GrOnFlushResourceProvider* onFlushRP,
     }
 
     SkASSERT(pathInstanceIdx == fBaseInstance + fInstanceCount - fNumSkippedInstances);
-    if (currentAtlas) {
-        this->addAtlasBatch(currentAtlas, pathInstanceIdx);
+    if (currentAtlas || currentCachedAtlasProxy) {
+        this->addAtlasBatch(currentAtlas, currentCachedAtlasProxy, pathInstanceIdx);
     }
 
     return pathInstanceIdx;
@@ -481,6 +642,93 @@ GrCCAtlas* GrCoverageCountingPathRenderer::placeParsedPathInAtlas(
     return &fPerFlushAtlases.back();
 }
 
+void GrCoverageCountingPathRenderer::copyStashedPathToAtlas(GrOnFlushResourceProvider* onFlushRP,
+                                                            GrCCPathCache::Entry* entry) {
+    SkASSERT(entry->isCoverageCount());
+    SkASSERT(!entry->pendingAtlas());
+    SkASSERT(entry->atlasProxy());
+
+    const SkIRect& devIBounds = entry->devIBounds();
+    int w = devIBounds.width(), h = devIBounds.height();
+    SkIPoint16 location;
+    if (fPerFlushCopyAtlases.empty() || !fPerFlushCopyAtlases.back().addRect(w, h, &location)) {
+        fPerFlushCopyAtlases.emplace_back(*onFlushRP->caps(), SkTMax(w, h));
+        SkAssertResult(fPerFlushCopyAtlases.back().addRect(w, h, &location));
+    }
+    GrCCAtlas* copyAtlas = &fPerFlushCopyAtlases.back();
+    SkIVector copyOffset = {location.x() - devIBounds.left(), location.y() - devIBounds.top()};
+
+    // The copy draws the mask's rectangle in the copy atlas, and samples the stashed atlas where
+    // the mask was. A 45-degree bounding box that touches the rectangle's corners leaves the
+    // octagon a rectangle.
+    SkRect dst = SkRect::MakeXYWH(location.x(), location.y(), w, h);
+    SkIVector srcOffset = entry->atlasOffset() - copyOffset;
+    CopyInstance& copy = fPerFlushCopies.push_back();
+    copy.fDstAtlas = copyAtlas;
+    copy.fSrcAtlasProxy = sk_ref_sp(entry->atlasProxy());
+    copy.fFillType = entry->key().fillType();
+    copy.fInstance = {
+            dst,
+            {dst.left() - dst.bottom(), dst.left() + dst.top(),
+             dst.right() - dst.top(), dst.right() + dst.bottom()},
+            {{1, 0, 0, 1}},
+            {{0, 0}},
+            {{static_cast<int16_t>(srcOffset.x()), static_cast<int16_t>(srcOffset.y())}},
+            GrColor_WHITE};
+
+    fPathCache->setCopyAtlas(entry, copyAtlas, copyOffset);
+}
+
+void GrCoverageCountingPathRenderer::setupCopies(GrOnFlushResourceProvider* onFlushRP,
+                                                 SkTArray<sk_sp<GrRenderTargetContext>>* results) {
+    using PathInstance = GrCCPathProcessor::Instance;
+
+    // Each copy atlas gets one op, which draws the copies from each stashed atlas (and with each
+    // fill rule) together.
+    SkTQSort(fPerFlushCopies.begin(), fPerFlushCopies.end() - 1,
+             [](const CopyInstance& a, const CopyInstance& b) {
+                 if (a.fDstAtlas != b.fDstAtlas) {
+                     return a.fDstAtlas < b.fDstAtlas;
+                 }
+                 if (a.fSrcAtlasProxy != b.fSrcAtlasProxy) {
+                     return a.fSrcAtlasProxy.get() < b.fSrcAtlasProxy.get();
+                 }
+                 return a.fFillType < b.fFillType;
+             });
+
+    int numCopies = fPerFlushCopies.count();
+    sk_sp<GrBuffer> instanceBuffer =
+            onFlushRP->makeBuffer(kVertex_GrBufferType, numCopies * sizeof(PathInstance));
+    if (!instanceBuffer) {
+        SkDebugf("WARNING: failed to allocate ccpr copy instance buffer. "
+                 "Some cached paths will not be drawn.\n");
+        return;
+    }
+    PathInstance* copyInstanceData = static_cast<PathInstance*>(instanceBuffer->map());
+    SkASSERT(copyInstanceData);
+    for (int i = 0; i < numCopies; ++i) {
+        copyInstanceData[i] = fPerFlushCopies[i].fInstance;
+    }
+    instanceBuffer->unmap();
+
+    for (int i = 0; i < numCopies;) {
+        GrCCAtlas* copyAtlas = fPerFlushCopies[i].fDstAtlas;
+        auto op = skstd::make_unique<CopyPathsOp>(fPerFlushIndexBuffer, fPerFlushVertexBuffer,
+                                                  instanceBuffer, i, copyAtlas->drawBounds());
+        for (; i < numCopies && fPerFlushCopies[i].fDstAtlas == copyAtlas; ++i) {
+            const CopyInstance& copy = fPerFlushCopies[i];
+            if (i + 1 == numCopies || fPerFlushCopies[i + 1].fDstAtlas != copyAtlas ||
+                fPerFlushCopies[i + 1].fSrcAtlasProxy != copy.fSrcAtlasProxy ||
+                fPerFlushCopies[i + 1].fFillType != copy.fFillType) {
+                op->addRange(copy.fSrcAtlasProxy, copy.fFillType, i + 1);
+            }
+        }
+        if (auto rtc = copyAtlas->finalize(onFlushRP, std::move(op))) {
+            results->push_back(std::move(rtc));
+        }
+    }
+}
+
 void CCPR::DrawPathsOp::onExecute(GrOpFlushState* flushState) {
     SkASSERT(fCCPR->fFlushing);
     SkASSERT(flushState->rtCommandBuffer());
@@ -505,12 +753,14 @@ void CCPR::DrawPathsOp::onExecute(GrOpFlushState* flushState) {
         const AtlasBatch& batch = fAtlasBatches[i];
         SkASSERT(batch.fEndInstanceIdx > baseInstance);
 
-        if (!batch.fAtlas->textureProxy()) {
+        GrTextureProxy* atlasProxy = batch.fAtlas ? batch.fAtlas->textureProxy()
+                                                  : batch.fCachedAtlasProxy.get();
+        if (!atlasProxy) {
             continue;  // Atlas failed to allocate.
         }
 
-        GrCCPathProcessor pathProc(flushState->resourceProvider(),
-                                   sk_ref_sp(batch.fAtlas->textureProxy()), this->getFillType());
+        GrCCPathProcessor pathProc(flushState->resourceProvider(), sk_ref_sp(atlasProxy),
+                                   this->getFillType());
 
         GrMesh mesh(GrCCPathProcessor::MeshPrimitiveType(flushState->caps()));
         mesh.setIndexedInstanced(fCCPR->fPerFlushIndexBuffer.get(),
@@ -528,6 +778,12 @@ void CCPR::DrawPathsOp::onExecute(GrOpFlushState* flushState) {
 void GrCoverageCountingPathRenderer::postFlush(GrDeferredUploadToken, const uint32_t* opListIDs,
                                                int numOpListIDs) {
     SkASSERT(fFlushing);
+    if (fPathCache) {
+        // This needs this flush's atlases, to take refs on their textures.
+        fPathCache->postFlush();
+    }
+    fPerFlushCopies.reset();
+    fPerFlushCopyAtlases.reset();
     fPerFlushAtlases.reset();
     fPerFlushPathParser.reset();
     fPerFlushInstanceBuffer.reset();
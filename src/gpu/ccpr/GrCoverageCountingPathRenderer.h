@@ -14,6 +14,7 @@
 #include "GrPathRenderer.h"
 #include "SkTInternalLList.h"
 #include "ccpr/GrCCAtlas.h"
+#include "ccpr/GrCCPathCache.h"
 #include "ccpr/GrCCPathParser.h"
 #include "ccpr/GrCCPathProcessor.h"
 #include "ops/GrDrawOp.h"
@@ -30,8 +31,12 @@ class GrCoverageCountingPathRenderer : public GrPathRenderer, public GrOnFlushCa
 
 public:
     static bool IsSupported(const GrCaps&);
+    // If parseExecutor is non-null, paths are parsed on its threads when a flush has enough of
+    // them.
     static sk_sp<GrCoverageCountingPathRenderer> CreateIfSupported(const GrCaps&,
-                                                                   bool drawCachablePaths);
+                                                                   bool drawCachablePaths,
+                                                                   bool cachePathMasks,
+                                                                   SkExecutor* parseExecutor);
 
     ~GrCoverageCountingPathRenderer() override {
         // Ensure no Ops exist that could have a dangling pointer back into this class.
@@ -54,6 +59,8 @@ public:
             SkMatrix fMatrix;
             SkPath fPath;
             GrColor fColor;
+            bool fIsCachable;  // False if the path is volatile, or had to be cropped.
+            int fPreparsedPathIdx = -1;  // Index into the paths given to the parser to preparse.
             SingleDraw* fNext = nullptr;
         };
 
@@ -77,6 +84,11 @@ public:
         void onPrepare(GrOpFlushState*) override {}
         void onExecute(GrOpFlushState*) override;
 
+        // Adds the paths that setupResources will need parsed, i.e. the ones not already in the
+        // cache, to the list.
+        void collectPathsToPreparse(const GrCCPathCache*,
+                                    SkTArray<GrCCPathParser::PathToPreparse, true>*);
+
         int setupResources(GrOnFlushResourceProvider*,
                            GrCCPathProcessor::Instance* pathInstanceData, int pathInstanceIdx);
 
@@ -86,16 +98,21 @@ public:
             return fHeadDraw.fPath.getFillType();
         }
 
+        // Each batch of instances reads from either one of this flush's atlases, or a texture the
+        // path cache kept from an earlier flush.
         struct AtlasBatch {
             const GrCCAtlas* fAtlas;
+            sk_sp<GrTextureProxy> fCachedAtlasProxy;
             int fEndInstanceIdx;
         };
 
-        void addAtlasBatch(const GrCCAtlas* atlas, int endInstanceIdx) {
+        void addAtlasBatch(const GrCCAtlas* atlas, GrTextureProxy* cachedAtlasProxy,
+                           int endInstanceIdx) {
             SkASSERT(endInstanceIdx > fBaseInstance);
             SkASSERT(fAtlasBatches.empty() ||
                      endInstanceIdx > fAtlasBatches.back().fEndInstanceIdx);
-            fAtlasBatches.push_back() = {atlas, endInstanceIdx};
+            SkASSERT(!atlas != !cachedAtlasProxy);
+            fAtlasBatches.push_back() = {atlas, sk_ref_sp(cachedAtlasProxy), endInstanceIdx};
         }
 
         GrCoverageCountingPathRenderer* const fCCPR;
@@ -193,14 +210,24 @@ public:
                   SkTArray<sk_sp<GrRenderTargetContext>>* results) override;
     void postFlush(GrDeferredUploadToken, const uint32_t* opListIDs, int numOpListIDs) override;
 
+    // Null unless path mask caching is enabled.
+    const GrCCPathCache* pathCache() const { return fPathCache.get(); }
+
 private:
-    GrCoverageCountingPathRenderer(bool drawCachablePaths)
-            : fDrawCachablePaths(drawCachablePaths) {}
+    GrCoverageCountingPathRenderer(bool drawCachablePaths, bool cachePathMasks,
+                                   SkExecutor* parseExecutor);
 
     GrCCAtlas* placeParsedPathInAtlas(GrOnFlushResourceProvider*, const SkIRect& accessRect,
                                       const SkIRect& pathIBounds, int16_t* atlasOffsetX,
                                       int16_t* atlasOffsetY);
 
+    // Places a cached coverage count, stashed last flush, in one of this flush's copy atlases, where
+    // it will be resolved to literal coverage.
+    void copyStashedPathToAtlas(GrOnFlushResourceProvider*, GrCCPathCache::Entry*);
+
+    // Issues the copies set up by copyStashedPathToAtlas(), one op per copy atlas.
+    void setupCopies(GrOnFlushResourceProvider*, SkTArray<sk_sp<GrRenderTargetContext>>* results);
+
     struct RTPendingPaths {
         ~RTPendingPaths() {
             // Ensure there are no surviving DrawPathsOps with a dangling pointer into this class.
@@ -230,7 +257,19 @@ private:
     bool fPerFlushResourcesAreValid;
     SkDEBUGCODE(bool fFlushing = false);
 
+    // Cached masks that are copied out of last flush's atlases this flush, as literal coverage.
+    struct CopyInstance {
+        GrCCAtlas* fDstAtlas;
+        sk_sp<GrTextureProxy> fSrcAtlasProxy;
+        SkPath::FillType fFillType;
+        GrCCPathProcessor::Instance fInstance;
+    };
+    SkTArray<CopyInstance> fPerFlushCopies;
+    GrSTAllocator<4, GrCCAtlas> fPerFlushCopyAtlases;
+
     const bool fDrawCachablePaths;
+    std::unique_ptr<GrCCPathCache> fPathCache;
+    SkExecutor* const fParseExecutor;
 };
 
 #endif
@@ -18,7 +18,10 @@
 
 class GrGLBitmapTextGeoProc : public GrGLSLGeometryProcessor {
 public:
-    GrGLBitmapTextGeoProc() : fColor(GrColor_ILLEGAL), fAtlasSize({0,0}) {}
+    GrGLBitmapTextGeoProc()
+            : fColor(GrColor_ILLEGAL)
+            , fAtlasSize({0,0})
+            , fTranslate(SkVector::Make(SK_ScalarNaN, SK_ScalarNaN)) {}
 
     void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
         const GrBitmapTextGeoProc& btgp = args.fGP.cast<GrBitmapTextGeoProc>();
@@ -53,13 +56,25 @@ public:
         }
 
         // Setup position
-        this->writeOutputPosition(vertBuilder, gpArgs, btgp.inPosition()->fName);
+        GrShaderVar position = btgp.inPosition()->asShaderVar();
+        if (btgp.hasTranslate()) {
+            const char* translateName;
+            fTranslateUniform = uniformHandler->addUniform(kVertex_GrShaderFlag,
+                                                           kFloat2_GrSLType,
+                                                           kHigh_GrSLPrecision,
+                                                           "Translate",
+                                                           &translateName);
+            vertBuilder->codeAppendf("float2 translatedPosition = %s + %s;",
+                                     btgp.inPosition()->fName, translateName);
+            position = GrShaderVar("translatedPosition", kFloat2_GrSLType);
+        }
+        this->writeOutputPosition(vertBuilder, gpArgs, position.c_str());
 
         // emit transforms
         this->emitTransforms(vertBuilder,
                              varyingHandler,
                              uniformHandler,
-                             btgp.inPosition()->asShaderVar(),
+                             position,
                              btgp.localMatrix(),
                              args.fFPCoordTransformHandler);
 
@@ -94,6 +109,10 @@ public:
             pdman.set2f(fAtlasSizeInvUniform, 1.0f / atlas->width(), 1.0f / atlas->height());
             fAtlasSize.set(atlas->width(), atlas->height());
         }
+        if (btgp.hasTranslate() && btgp.translate() != fTranslate) {
+            pdman.set2f(fTranslateUniform, btgp.translate().fX, btgp.translate().fY);
+            fTranslate = btgp.translate();
+        }
         this->setTransformDataHelper(btgp.localMatrix(), pdman, &transformIter);
     }
 
@@ -104,6 +123,7 @@ public:
         uint32_t key = 0;
         key |= (btgp.usesLocalCoords() && btgp.localMatrix().hasPerspective()) ? 0x1 : 0x0;
         key |= btgp.maskFormat() << 1;
+        key |= btgp.hasTranslate() ? 0x10 : 0x0;
         b->add32(key);
         b->add32(btgp.numTextureSamplers());
     }
@@ -115,6 +135,9 @@ private:
     SkISize       fAtlasSize;
     UniformHandle fAtlasSizeInvUniform;
 
+    SkVector      fTranslate;
+    UniformHandle fTranslateUniform;
+
     typedef GrGLSLGeometryProcessor INHERITED;
 };
 
@@ -124,11 +147,14 @@ GrBitmapTextGeoProc::GrBitmapTextGeoProc(GrColor color,
                                          const sk_sp<GrTextureProxy>* proxies,
                                          int numProxies,
                                          const GrSamplerState& params, GrMaskFormat format,
-                                         const SkMatrix& localMatrix, bool usesLocalCoords)
+                                         const SkMatrix& localMatrix, bool usesLocalCoords,
+                                         const SkVector* translate)
         : INHERITED(kGrBitmapTextGeoProc_ClassID)
         , fColor(color)
         , fLocalMatrix(localMatrix)
         , fUsesLocalCoords(usesLocalCoords)
+        , fHasTranslate(SkToBool(translate))
+        , fTranslate(translate ? *translate : SkVector::Make(0, 0))
         , fInColor(nullptr)
         , fMaskFormat(format) {
     SkASSERT(numProxies <= kMaxTextures);
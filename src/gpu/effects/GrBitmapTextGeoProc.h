@@ -22,14 +22,19 @@ class GrInvariantOutput;
 class GrBitmapTextGeoProc : public GrGeometryProcessor {
 public:
 
+    /**
+     * If translate is not null it is added to the vertex positions in the vertex shader. This lets
+     * vertices that are kept in a GPU buffer be drawn at a new position without re-uploading them.
+     */
     static sk_sp<GrGeometryProcessor> Make(GrColor color,
                                            const sk_sp<GrTextureProxy>* proxies,
                                            int numProxies,
                                            const GrSamplerState& p, GrMaskFormat format,
-                                           const SkMatrix& localMatrix, bool usesLocalCoords) {
+                                           const SkMatrix& localMatrix, bool usesLocalCoords,
+                                           const SkVector* translate = nullptr) {
         return sk_sp<GrGeometryProcessor>(
             new GrBitmapTextGeoProc(color, proxies, numProxies, p, format,
-                                    localMatrix, usesLocalCoords));
+                                    localMatrix, usesLocalCoords, translate));
     }
 
     ~GrBitmapTextGeoProc() override {}
@@ -44,6 +49,8 @@ public:
     bool hasVertexColor() const { return SkToBool(fInColor); }
     const SkMatrix& localMatrix() const { return fLocalMatrix; }
     bool usesLocalCoords() const { return fUsesLocalCoords; }
+    bool hasTranslate() const { return fHasTranslate; }
+    const SkVector& translate() const { return fTranslate; }
 
     void addNewProxies(const sk_sp<GrTextureProxy>* proxies, int numProxies, const GrSamplerState&);
 
@@ -56,11 +63,14 @@ private:
 
     GrBitmapTextGeoProc(GrColor, const sk_sp<GrTextureProxy>* proxies, int numProxies,
                         const GrSamplerState& params, GrMaskFormat format,
-                        const SkMatrix& localMatrix, bool usesLocalCoords);
+                        const SkMatrix& localMatrix, bool usesLocalCoords,
+                        const SkVector* translate);
 
     GrColor          fColor;
     SkMatrix         fLocalMatrix;
     bool             fUsesLocalCoords;
+    bool             fHasTranslate;
+    SkVector         fTranslate;
     TextureSampler   fTextureSamplers[kMaxTextures];
     const Attribute* fInPosition;
     const Attribute* fInColor;
@@ -181,6 +181,12 @@ sk_sp<const GrGLInterface> GrGLMakeAssembledGLInterface(void *ctx, GrGLGetProc g
     GET_PROC(LinkProgram);
     GET_PROC(MapBuffer);
 
+    if (extensions.has("GL_KHR_parallel_shader_compile")) {
+        GET_PROC_SUFFIX(MaxShaderCompilerThreads, KHR);
+    } else if (extensions.has("GL_ARB_parallel_shader_compile")) {
+        GET_PROC_SUFFIX(MaxShaderCompilerThreads, ARB);
+    }
+
     if (glVer >= GR_GL_VER(4,3) || extensions.has("GL_ARB_multi_draw_indirect")) {
         GET_PROC(MultiDrawArraysIndirect);
         GET_PROC(MultiDrawElementsIndirect);
@@ -546,6 +552,10 @@ sk_sp<const GrGLInterface> GrGLMakeAssembledGLESInterface(void *ctx, GrGLGetProc
     GET_PROC(LineWidth);
     GET_PROC(LinkProgram);
 
+    if (extensions.has("GL_KHR_parallel_shader_compile")) {
+        GET_PROC_SUFFIX(MaxShaderCompilerThreads, KHR);
+    }
+
     if (extensions.has("GL_EXT_multi_draw_indirect")) {
         GET_PROC_SUFFIX(MultiDrawArraysIndirect, EXT);
         GET_PROC_SUFFIX(MultiDrawElementsIndirect, EXT);
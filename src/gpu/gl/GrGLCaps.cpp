@@ -63,6 +63,7 @@ GrGLCaps::GrGLCaps(const GrContextOptions& contextOptions,
     fRequiresCullFaceEnableDisableWhenDrawingLinesAfterNonLines = false;
     fRequiresFlushBetweenNonAndInstancedDraws = false;
     fProgramBinarySupport = false;
+    fParallelShaderCompileSupport = false;
 
     fBlitFramebufferFlags = kNoSupport_BlitFramebufferFlag;
     fMaxInstancesPerDrawArraysWithoutCrashing = 0;
@@ -592,6 +593,8 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
         fProgramBinarySupport = count > 0;
     }
 
+    fParallelShaderCompileSupport = static_cast<bool>(gli->fFunctions.fMaxShaderCompilerThreads);
+
     // Requires fTextureRedSupport, fTextureSwizzleSupport, msaa support, ES compatibility have
     // already been detected.
     this->initConfigTable(contextOptions, ctxInfo, gli, shaderCaps);
@@ -1156,6 +1159,7 @@ void GrGLCaps::onDumpJSON(SkJSONWriter* writer) const {
     writer->appendBool("Texture swizzle support", fTextureSwizzleSupport);
     writer->appendBool("BGRA to RGBA readback conversions are slow",
                        fRGBAToBGRAReadbackConversionsAreSlow);
+    writer->appendBool("Parallel shader compile support", fParallelShaderCompileSupport);
     writer->appendBool("Use buffer data null hint", fUseBufferDataNullHint);
     writer->appendBool("Draw To clear color", fUseDrawToClearColor);
     writer->appendBool("Draw To clear stencil clip", fUseDrawToClearStencilClip);
@@ -432,6 +432,12 @@ public:
         return fProgramBinarySupport;
     }
 
+    // The driver can compile shaders and link programs on threads of its own (with
+    // KHR_parallel_shader_compile or ARB_parallel_shader_compile).
+    bool parallelShaderCompileSupport() const {
+        return fParallelShaderCompileSupport;
+    }
+
     bool validateBackendTexture(const GrBackendTexture&, SkColorType,
                                 GrPixelConfig*) const override;
     bool validateBackendRenderTarget(const GrBackendRenderTarget&, SkColorType,
@@ -514,6 +520,7 @@ private:
     bool fUseBufferDataNullHint                : 1;
     bool fClearTextureSupport : 1;
     bool fProgramBinarySupport : 1;
+    bool fParallelShaderCompileSupport : 1;
 
     // Driver workarounds
     bool fDoManualMipmapping : 1;
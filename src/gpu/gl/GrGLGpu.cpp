@@ -239,6 +239,19 @@ GrGLGpu::GrGLGpu(std::unique_ptr<GrGLContext> ctx, GrContext* context)
         fPathRendering.reset(new GrGLPathRendering(this));
     }
 
+    for (GrGLenum name : { GR_GL_VENDOR, GR_GL_RENDERER, GR_GL_VERSION }) {
+        const GrGLubyte* str;
+        GL_CALL_RET(str, GetString(name));
+        fProgramBinaryKeyPrefix.append(str ? (const char*)str : "");
+        fProgramBinaryKeyPrefix.append("\n");
+    }
+
+    if (this->glCaps().parallelShaderCompileSupport()) {
+        // How many threads the driver compiles on by default is up to the driver, and can be none.
+        // 0xFFFFFFFF asks for as many as it's willing to use.
+        GL_CALL(MaxShaderCompilerThreads(0xFFFFFFFF));
+    }
+
     GrGLClearErr(this->glInterface());
 }
 
@@ -1732,6 +1745,8 @@ void GrGLGpu::flushScissor(const GrScissorState& scissorState,
             if (fHWScissorSettings.fRect != scissor) {
                 scissor.pushToGLScissor(this->glInterface());
                 fHWScissorSettings.fRect = scissor;
+            } else {
+                fStats.incRedundantStateCallsAvoided();
             }
             if (kYes_TriState != fHWScissorSettings.fEnabled) {
                 GL_CALL(Enable(GR_GL_SCISSOR_TEST));
@@ -1818,6 +1833,8 @@ bool GrGLGpu::flushGLState(const GrPipeline& pipeline, const GrPrimitiveProcesso
     if (fHWProgramID != programID) {
         GL_CALL(UseProgram(programID));
         fHWProgramID = programID;
+    } else {
+        fStats.incRedundantStateCallsAvoided();
     }
 
     if (blendInfo.fWriteColor) {
@@ -2493,6 +2510,8 @@ void GrGLGpu::flushRenderTargetNoColorWrites(GrGLRenderTarget* target, bool disa
         }
         fHWBoundRenderTargetUniqueID = rtID;
         this->flushViewport(target->getViewport());
+    } else {
+        fStats.incRedundantStateCallsAvoided();
     }
 
     if (this->glCaps().srgbWriteControl()) {
@@ -2819,6 +2838,8 @@ void GrGLGpu::flushStencil(const GrStencilSettings& stencilSettings) {
                            GR_GL_FRONT_AND_BACK);
         }
         fHWStencilSettings = stencilSettings;
+    } else {
+        fStats.incRedundantStateCallsAvoided();
     }
 }
 
@@ -2928,6 +2949,8 @@ void GrGLGpu::flushBlend(const GrXferProcessor::BlendInfo& blendInfo, const GrSw
                           gXfermodeCoeff2Blend[dstCoeff]));
         fHWBlendState.fSrcCoeff = srcCoeff;
         fHWBlendState.fDstCoeff = dstCoeff;
+    } else {
+        fStats.incRedundantStateCallsAvoided();
     }
 
     if ((BlendCoeffReferencesConstant(srcCoeff) || BlendCoeffReferencesConstant(dstCoeff))) {
@@ -3037,6 +3060,8 @@ void GrGLGpu::bindTexture(int unitIdx, const GrSamplerState& samplerState, bool
         this->setTextureUnit(unitIdx);
         GL_CALL(BindTexture(target, texture->textureID()));
         fHWBoundTextureUniqueIDs[unitIdx] = textureID;
+    } else {
+        fStats.incRedundantStateCallsAvoided();
     }
 
     ResetTimestamp timestamp;
@@ -3197,6 +3222,16 @@ void GrGLGpu::generateMipmaps(const GrSamplerState& params, bool allowSRGBInputs
         return;
     }
 
+    fStats.incMipMapRegenerations();
+    this->regenerateMipMaps(texture, textureOrigin, allowSRGBInputs);
+}
+
+void GrGLGpu::regenerateMipMaps(GrGLTexture* texture, GrSurfaceOrigin textureOrigin,
+                                bool allowSRGBInputs) {
+    SkDestinationSurfaceColorMode colorMode = allowSRGBInputs
+        ? SkDestinationSurfaceColorMode::kGammaAndColorSpaceAware
+        : SkDestinationSurfaceColorMode::kLegacy;
+
     // If we created a rt/tex and rendered to it without using a texture and now we're texturing
     // from the rt it will still be the last bound texture, but it needs resolving.
     GrGLRenderTarget* texRT = static_cast<GrGLRenderTarget*>(texture->asRenderTarget());
@@ -3237,6 +3272,22 @@ void GrGLGpu::generateMipmaps(const GrSamplerState& params, bool allowSRGBInputs
     texture->textureParamsModified();
 }
 
+int GrGLGpu::onRegenerateMipMapLevels(GrTexture* const textures[],
+                                      const GrSurfaceOrigin origins[], int count) {
+    int regenerated = 0;
+    for (int i = 0; i < count; ++i) {
+        GrGLTexture* texture = static_cast<GrGLTexture*>(textures[i]);
+        // sRGB mips depend on whether the sampling draw is gamma correct, so they are left to be
+        // regenerated by that draw.
+        if (!texture->texturePriv().mipMapsAreDirty() || GrPixelConfigIsSRGB(texture->config())) {
+            continue;
+        }
+        this->regenerateMipMaps(texture, origins[i], false);
+        ++regenerated;
+    }
+    return regenerated;
+}
+
 void GrGLGpu::setTextureSwizzle(int unitIdx, GrGLenum target, const GrGLenum swizzle[]) {
     this->setTextureUnit(unitIdx);
     if (this->glStandard() == kGLES_GrGLStandard) {
@@ -4235,8 +4286,10 @@ bool GrGLGpu::generateMipmap(GrGLTexture* texture, GrSurfaceOrigin textureOrigin
                 return false;
             }
         }
-        GL_CALL(UseProgram(fMipmapPrograms[progIdx].fProgram));
-        fHWProgramID = fMipmapPrograms[progIdx].fProgram;
+        if (fHWProgramID != fMipmapPrograms[progIdx].fProgram) {
+            GL_CALL(UseProgram(fMipmapPrograms[progIdx].fProgram));
+            fHWProgramID = fMipmapPrograms[progIdx].fProgram;
+        }
 
         // Texcoord uniform is expected to contain (1/w, (w-1)/w, 1/h, (h-1)/h)
         const float invWidth = 1.0f / width;
@@ -4594,6 +4647,15 @@ int GrGLGpu::TextureToCopyProgramIdx(GrTexture* texture) {
     }
 }
 
+sk_sp<SkData> GrGLGpu::makeProgramBinaryKey(const GrProgramDesc& desc) const {
+    size_t prefixLength = fProgramBinaryKeyPrefix.size();
+    sk_sp<SkData> key = SkData::MakeUninitialized(prefixLength + desc.keyLength());
+    memcpy(key->writable_data(), fProgramBinaryKeyPrefix.c_str(), prefixLength);
+    memcpy(SkTAddOffset<void>(key->writable_data(), prefixLength), desc.asKey(),
+           desc.keyLength());
+    return key;
+}
+
 void GrGLGpu::onDumpJSON(SkJSONWriter* writer) const {
     // We are called by the base class, which has already called beginObject(). We choose to nest
     // all of our caps information in a named sub-object.
@@ -48,6 +48,11 @@ public:
     GrGLSLGeneration glslGeneration() const { return fGLContext->glslGeneration(); }
     const GrGLCaps& glCaps() const { return *fGLContext->caps(); }
 
+    // The key desc's program binary goes by in the persistent cache. Binaries are only good for
+    // the driver that made them, so the key leads with the GL_VENDOR, GL_RENDERER and GL_VERSION
+    // strings, which between them name the driver and its version.
+    sk_sp<SkData> makeProgramBinaryKey(const GrProgramDesc& desc) const;
+
     GrGLPathRendering* glPathRendering() {
         SkASSERT(glCaps().shaderCaps()->pathRenderingSupport());
         return static_cast<GrGLPathRendering*>(pathRendering());
@@ -254,6 +259,8 @@ private:
                        const SkIRect& srcRect, const SkIPoint& dstPoint,
                        bool canDiscardOutsideDstRect) override;
 
+    int onRegenerateMipMapLevels(GrTexture* const[], const GrSurfaceOrigin[], int count) override;
+
     // binds texture unit in GL
     void setTextureUnit(int unitIdx);
 
@@ -286,6 +293,8 @@ private:
     bool copySurfaceAsBlitFramebuffer(GrSurface* dst, GrSurfaceOrigin dstOrigin,
                                       GrSurface* src, GrSurfaceOrigin srcOrigin,
                                       const SkIRect& srcRect, const SkIPoint& dstPoint);
+    // Regenerates the texture's dirty mip levels and marks them clean.
+    void regenerateMipMaps(GrGLTexture*, GrSurfaceOrigin, bool allowSRGBInputs);
     bool generateMipmap(GrGLTexture* texture, GrSurfaceOrigin textureOrigin, bool gammaCorrect);
     void clearStencilClipAsDraw(const GrFixedClip&, bool insideStencilMask,
                                 GrRenderTarget*, GrSurfaceOrigin);
@@ -407,6 +416,7 @@ private:
 
     // GL program-related state
     ProgramCache*               fProgramCache;
+    SkString                    fProgramBinaryKeyPrefix;
 
     ///////////////////////////////////////////////////////////////////////////
     ///@name Caching of GL State
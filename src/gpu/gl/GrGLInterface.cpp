@@ -232,6 +232,13 @@ bool GrGLInterface::validate() const {
         }
     }
 
+    if (fExtensions.has("GL_KHR_parallel_shader_compile") ||
+        (kGL_GrGLStandard == fStandard && fExtensions.has("GL_ARB_parallel_shader_compile"))) {
+        if (!fFunctions.fMaxShaderCompilerThreads) {
+            RETURN_FALSE_INTERFACE
+        }
+    }
+
     if (fExtensions.has("GL_KHR_blend_equation_advanced") ||
         fExtensions.has("GL_NV_blend_equation_advanced")) {
         if (!fFunctions.fBlendBarrier) {
@@ -14,6 +14,24 @@
          SkASSERT((COUNT) <= (UNI).fArrayCount || \
                   (1 == (COUNT) && GrShaderVar::kNonArray == (UNI).fArrayCount))
 
+// Returns the number of 32 bit components of a uniform of the given type, or 0 if its values
+// aren't shadowed.
+static int uniform_components(GrSLType type) {
+    switch (type) {
+        case kFloat2x2_GrSLType:
+        case kHalf2x2_GrSLType:
+            return 4;
+        case kFloat3x3_GrSLType:
+        case kHalf3x3_GrSLType:
+            return 9;
+        case kFloat4x4_GrSLType:
+        case kHalf4x4_GrSLType:
+            return 16;
+        default:
+            return SkTMax(GrSLTypeVecLength(type), 0);
+    }
+}
+
 GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, GrGLuint programID,
                                                const UniformInfoArray& uniforms,
                                                const VaryingInfoArray& pathProcVaryings)
@@ -21,6 +39,8 @@ GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, GrGLuint programID,
     , fProgramID(programID) {
     int count = uniforms.count();
     fUniforms.push_back_n(count);
+    fShadowCounts.push_back_n(count, 0);
+    int shadowSize = 0;
     for (int i = 0; i < count; i++) {
         Uniform& uniform = fUniforms[i];
         const UniformInfo& builderUniform = uniforms[i];
@@ -31,7 +51,12 @@ GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, GrGLuint programID,
             uniform.fType = builderUniform.fVariable.getType();
         );
         uniform.fLocation = builderUniform.fLocation;
+        uniform.fShadowOffset = shadowSize;
+        uniform.fShadowComponents = uniform_components(builderUniform.fVariable.getType());
+        shadowSize += uniform.fShadowComponents *
+                      SkTMax(builderUniform.fVariable.getArrayCount(), 1);
     }
+    fShadowValues.reset(shadowSize);
 
     // NVPR programs have separable varyings
     count = pathProcVaryings.count();
@@ -61,11 +86,29 @@ void GrGLProgramDataManager::setSamplerUniforms(const UniformInfoArray& samplers
     }
 }
 
+bool GrGLProgramDataManager::valuesUnchanged(UniformHandle u, int arrayCount,
+                                             const void* values) const {
+    const Uniform& uni = fUniforms[u.toIndex()];
+    if (!uni.fShadowComponents) {
+        return false;
+    }
+    int& knownCount = fShadowCounts[u.toIndex()];
+    uint32_t* shadow = fShadowValues.get() + uni.fShadowOffset;
+    size_t size = arrayCount * uni.fShadowComponents * sizeof(uint32_t);
+    if (arrayCount <= knownCount && !memcmp(shadow, values, size)) {
+        fGpu->stats()->incRedundantStateCallsAvoided();
+        return true;
+    }
+    memcpy(shadow, values, size);
+    knownCount = SkTMax(knownCount, arrayCount);
+    return false;
+}
+
 void GrGLProgramDataManager::set1i(UniformHandle u, int32_t i) const {
     const Uniform& uni = fUniforms[u.toIndex()];
     SkASSERT(uni.fType == kInt_GrSLType || uni.fType == kShort_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, 1, &i)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1i(uni.fLocation, i));
     }
 }
@@ -77,7 +120,7 @@ void GrGLProgramDataManager::set1iv(UniformHandle u,
     SkASSERT(uni.fType == kInt_GrSLType || uni.fType == kShort_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1iv(uni.fLocation, arrayCount, v));
     }
 }
@@ -86,7 +129,7 @@ void GrGLProgramDataManager::set1f(UniformHandle u, float v0) const {
     const Uniform& uni = fUniforms[u.toIndex()];
     SkASSERT(uni.fType == kFloat_GrSLType || uni.fType == kHalf_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, 1, &v0)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1f(uni.fLocation, v0));
     }
 }
@@ -102,7 +145,7 @@ void GrGLProgramDataManager::set1fv(UniformHandle u,
     // Once the uniform manager is responsible for inserting the duplicate uniform
     // arrays in VS and FS driver bug workaround, this can be enabled.
     // this->printUni(uni);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1fv(uni.fLocation, arrayCount, v));
     }
 }
@@ -111,7 +154,8 @@ void GrGLProgramDataManager::set2f(UniformHandle u, float v0, float v1) const {
     const Uniform& uni = fUniforms[u.toIndex()];
     SkASSERT(uni.fType == kFloat2_GrSLType || uni.fType == kHalf2_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    const float v[] = { v0, v1 };
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, 1, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform2f(uni.fLocation, v0, v1));
     }
 }
@@ -123,7 +167,7 @@ void GrGLProgramDataManager::set2fv(UniformHandle u,
     SkASSERT(uni.fType == kFloat2_GrSLType || uni.fType == kHalf2_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform2fv(uni.fLocation, arrayCount, v));
     }
 }
@@ -132,7 +176,8 @@ void GrGLProgramDataManager::set3f(UniformHandle u, float v0, float v1, float v2
     const Uniform& uni = fUniforms[u.toIndex()];
     SkASSERT(uni.fType == kFloat3_GrSLType || uni.fType == kHalf3_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    const float v[] = { v0, v1, v2 };
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, 1, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform3f(uni.fLocation, v0, v1, v2));
     }
 }
@@ -144,7 +189,7 @@ void GrGLProgramDataManager::set3fv(UniformHandle u,
     SkASSERT(uni.fType == kFloat3_GrSLType || uni.fType == kHalf3_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform3fv(uni.fLocation, arrayCount, v));
     }
 }
@@ -157,7 +202,8 @@ void GrGLProgramDataManager::set4f(UniformHandle u,
     const Uniform& uni = fUniforms[u.toIndex()];
     SkASSERT(uni.fType == kFloat4_GrSLType || uni.fType == kHalf4_GrSLType);
     SkASSERT(GrShaderVar::kNonArray == uni.fArrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    const float v[] = { v0, v1, v2, v3 };
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, 1, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform4f(uni.fLocation, v0, v1, v2, v3));
     }
 }
@@ -169,7 +215,7 @@ void GrGLProgramDataManager::set4fv(UniformHandle u,
     SkASSERT(uni.fType == kFloat4_GrSLType || uni.fType == kHalf4_GrSLType);
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, arrayCount, v)) {
         GR_GL_CALL(fGpu->glInterface(), Uniform4fv(uni.fLocation, arrayCount, v));
     }
 }
@@ -208,7 +254,7 @@ template<int N> inline void GrGLProgramDataManager::setMatrices(UniformHandle u,
              uni.fType == kHalf2x2_GrSLType + (N - 2));
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
-    if (kUnusedUniform != uni.fLocation) {
+    if (kUnusedUniform != uni.fLocation && !this->valuesUnchanged(u, arrayCount, matrices)) {
         set_uniform_matrix<N>::set(fGpu->glInterface(), uni.fLocation, arrayCount, matrices);
     }
 }
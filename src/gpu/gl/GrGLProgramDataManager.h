@@ -14,6 +14,7 @@
 #include "glsl/GrGLSLProgramDataManager.h"
 
 #include "SkTArray.h"
+#include "SkTemplates.h"
 
 class GrGLGpu;
 class SkMatrix;
@@ -49,6 +50,9 @@ public:
 
     /** Functions for uploading uniform values. The varities ending in v can be used to upload to an
     *  array of uniforms. arrayCount must be <= the array count of the uniform.
+    *
+    *  Uniform values are program state, so the last values uploaded to each uniform are kept and
+    *  uploads of unchanged values are skipped.
     */
     void set1i(UniformHandle, int32_t) const override;
     void set1iv(UniformHandle, int arrayCount, const int v[]) const override;
@@ -80,6 +84,10 @@ private:
 
     struct Uniform {
         GrGLint     fLocation;
+        // Offset and size, in 32 bit words, of one element of the uniform in fShadowValues. Zero
+        // components means the uniform's values are not shadowed.
+        int         fShadowOffset;
+        int         fShadowComponents;
 #ifdef SK_DEBUG
         GrSLType    fType;
         int         fArrayCount;
@@ -100,7 +108,15 @@ private:
     template<int N> inline void setMatrices(UniformHandle, int arrayCount,
                                             const float matrices[]) const;
 
+    // Returns true if the first arrayCount elements of the uniform are known to hold 'values'.
+    // Otherwise records 'values' as the uniform's values and returns false.
+    bool valuesUnchanged(UniformHandle, int arrayCount, const void* values) const;
+
     SkTArray<Uniform, true> fUniforms;
+    // The last values uploaded to the shadowed uniforms, and the number of leading elements of
+    // each uniform whose values are known.
+    mutable SkAutoTMalloc<uint32_t> fShadowValues;
+    mutable SkTArray<int, true> fShadowCounts;
     SkTArray<PathProcVarying, true> fPathProcVaryings;
     GrGLGpu* fGpu;
     GrGLuint fProgramID;
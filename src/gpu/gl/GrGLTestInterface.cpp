@@ -117,6 +117,7 @@ GrGLTestInterface::GrGLTestInterface() {
     fFunctions.fMapBufferRange = bind_to_member(this, &GrGLTestInterface::mapBufferRange);
     fFunctions.fMapBufferSubData = bind_to_member(this, &GrGLTestInterface::mapBufferSubData);
     fFunctions.fMapTexSubImage2D = bind_to_member(this, &GrGLTestInterface::mapTexSubImage2D);
+    fFunctions.fMaxShaderCompilerThreads = bind_to_member(this, &GrGLTestInterface::maxShaderCompilerThreads);
     fFunctions.fMinSampleShading = bind_to_member(this, &GrGLTestInterface::minSampleShading);
     fFunctions.fPixelStorei = bind_to_member(this, &GrGLTestInterface::pixelStorei);
     fFunctions.fPolygonMode = bind_to_member(this, &GrGLTestInterface::polygonMode);
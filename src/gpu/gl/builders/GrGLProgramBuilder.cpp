@@ -13,6 +13,7 @@
 #include "GrCoordTransform.h"
 #include "GrGLProgramBuilder.h"
 #include "GrProgramDesc.h"
+#include "GrProgramKeyAnalysis.h"
 #include "GrShaderCaps.h"
 #include "GrSwizzle.h"
 #include "SkAutoMalloc.h"
@@ -48,8 +49,7 @@ GrGLProgram* GrGLProgramBuilder::CreateProgram(const GrPipeline& pipeline,
 
     auto persistentCache = gpu->getContext()->contextPriv().getPersistentCache();
     if (persistentCache && gpu->glCaps().programBinarySupport()) {
-        sk_sp<SkData> key = SkData::MakeWithoutCopy(desc->asKey(), desc->keyLength());
-        builder.fCached = persistentCache->load(*key);
+        builder.fCached = persistentCache->load(*gpu->makeProgramBinaryKey(*desc));
         // the eventual end goal is to completely skip emitAndInstallProcs on a cache hit, but it's
         // doing necessary setup in addition to generating the SkSL code. Currently we are only able
         // to skip the SkSL->GLSL step on a cache hit.
@@ -150,6 +150,10 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
 
     // compile shaders and bind attributes / uniforms
     const GrPrimitiveProcessor& primProc = this->primitiveProcessor();
+    if (auto analysis = this->gpu()->getContext()->contextPriv().programKeyAnalysis()) {
+        analysis->addProgram(*this->desc(), primProc, this->pipeline(),
+                             *this->gpu()->glCaps().shaderCaps(), this->sksl());
+    }
     SkSL::Program::Settings settings;
     settings.fCaps = this->gpu()->glCaps().shaderCaps();
     settings.fFlipY = this->pipeline().proxy()->origin() != kTopLeft_GrSurfaceOrigin;
@@ -284,7 +288,7 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
         GL_CALL(GetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &length));
         if (length > 0) {
             // store shader in cache
-            sk_sp<SkData> key = SkData::MakeWithoutCopy(desc()->asKey(), desc()->keyLength());
+            sk_sp<SkData> key = fGpu->makeProgramBinaryKey(*this->desc());
             GrGLenum binaryFormat;
             std::unique_ptr<char[]> binary(new char[length]);
             GL_CALL(GetProgramBinary(programID, length, &length, &binaryFormat, binary.get()));
@@ -8,6 +8,7 @@
 #include "GrGLShaderStringBuilder.h"
 #include "GrSKSLPrettyPrint.h"
 #include "SkAutoMalloc.h"
+#include "SkCounters.h"
 #include "SkSLCompiler.h"
 #include "SkSLGLSLCodeGenerator.h"
 #include "SkTraceEvent.h"
@@ -128,10 +129,14 @@ GrGLuint GrGLCompileAndAttachShader(const GrGLContext& glCtx,
     GR_GL_CALL(gli, ShaderSource(shaderId, 1, &glsl, &glslLength));
 
     stats->incShaderCompilations();
+    SkCounters::Add(SkCounter::kShaderCompiles);
     GR_GL_CALL(gli, CompileShader(shaderId));
 
     // Calling GetShaderiv in Chromium is quite expensive. Assume success in release builds.
-    bool checkCompiled = kChromium_GrGLDriver != glCtx.driver();
+    // Likewise if the driver compiles in parallel: asking now would wait for this shader to finish
+    // before we can start on the next one. A failed compile still fails the link, which we check.
+    bool checkCompiled = kChromium_GrGLDriver != glCtx.driver() &&
+                         !glCtx.caps()->parallelShaderCompileSupport();
 #ifdef SK_DEBUG
     checkCompiled = true;
 #endif
@@ -8,11 +8,18 @@
 #include "GrGLSLGeometryProcessor.h"
 
 #include "GrCoordTransform.h"
+#include "GrShaderCaps.h"
 #include "glsl/GrGLSLFragmentShaderBuilder.h"
+#include "glsl/GrGLSLProgramBuilder.h"
 #include "glsl/GrGLSLUniformHandler.h"
 #include "glsl/GrGLSLVarying.h"
 #include "glsl/GrGLSLVertexGeoBuilder.h"
 
+bool GrGLSLGeometryProcessor::UsesViewMatrixUniform(const SkMatrix& mat,
+                                                    const GrShaderCaps& caps) {
+    return !mat.isIdentity() || (caps.uniformKeyBits() & GrUniformKeyBits::kIdentityViewMatrix);
+}
+
 void GrGLSLGeometryProcessor::emitCode(EmitArgs& args) {
     GrGPArgs gpArgs;
     this->onEmitCode(args, &gpArgs);
@@ -127,7 +134,7 @@ void GrGLSLGeometryProcessor::writeOutputPosition(GrGLSLVertexBuilder* vertBuild
                                                   const char* posName,
                                                   const SkMatrix& mat,
                                                   UniformHandle* viewMatrixUniform) {
-    if (mat.isIdentity()) {
+    if (!UsesViewMatrixUniform(mat, *vertBuilder->getProgramBuilder()->shaderCaps())) {
         gpArgs->fPositionVar.set(kFloat2_GrSLType, "pos2");
         vertBuilder->codeAppendf("float2 %s = %s;", gpArgs->fPositionVar.c_str(), posName);
     } else {
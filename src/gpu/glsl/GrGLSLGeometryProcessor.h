@@ -60,7 +60,8 @@ protected:
     // assumption that the position is 2D. The second version transforms the input position by a
     // view matrix and the output variable is 2D or 3D depending on whether the view matrix is
     // perspective. Both versions declare the output position variable and will set
-    // GrGPArgs::fPositionVar.
+    // GrGPArgs::fPositionVar. The second only adds the view matrix uniform when
+    // UsesViewMatrixUniform(); processors should set it when its handle is valid.
     void writeOutputPosition(GrGLSLVertexBuilder*, GrGPArgs*, const char* posName);
     void writeOutputPosition(GrGLSLVertexBuilder*,
                              GrGLSLUniformHandler* uniformHandler,
@@ -69,8 +70,12 @@ protected:
                              const SkMatrix& mat,
                              UniformHandle* viewMatrixUniform);
 
-    static uint32_t ComputePosKey(const SkMatrix& mat) {
-        if (mat.isIdentity()) {
+    // An identity view matrix skips the uniform, unless GrUniformKeyBits::kIdentityViewMatrix
+    // asks for it to be keyed like any other matrix without perspective.
+    static bool UsesViewMatrixUniform(const SkMatrix& mat, const GrShaderCaps& caps);
+
+    static uint32_t ComputePosKey(const SkMatrix& mat, const GrShaderCaps& caps) {
+        if (!UsesViewMatrixUniform(mat, caps)) {
             return 0x0;
         } else if (!mat.hasPerspective()) {
             return 0x01;
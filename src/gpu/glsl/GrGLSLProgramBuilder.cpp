@@ -418,3 +418,18 @@ void GrGLSLProgramBuilder::finalizeShaders() {
     }
     fFS.finalize(kFragment_GrShaderFlag);
 }
+
+SkString GrGLSLProgramBuilder::sksl() const {
+    SkString sksl;
+    auto append = [&sksl](const GrGLSLShaderBuilder& shader) {
+        for (int i = 0; i < shader.fCompilerStrings.count(); ++i) {
+            sksl.append(shader.fCompilerStrings[i], shader.fCompilerStringLengths[i]);
+        }
+    };
+    append(fVS);
+    if (this->primitiveProcessor().willUseGeoShader()) {
+        append(fGS);
+    }
+    append(fFS);
+    return sksl;
+}
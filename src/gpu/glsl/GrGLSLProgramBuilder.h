@@ -115,6 +115,9 @@ protected:
 
     void finalizeShaders();
 
+    // The SkSL of the shaders, once they're finalized.
+    SkString sksl() const;
+
     bool fragColorIsInOut() const { return fFS.primaryColorOutputIsInOut(); }
 
 private:
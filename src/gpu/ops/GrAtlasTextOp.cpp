@@ -268,15 +268,25 @@ void GrAtlasTextOp::onPrepareDraws(Target* target) {
 
     char* currVertex = reinterpret_cast<char*>(vertices);
 
+    // Unclipped bitmap sub runs may be drawn straight from a GPU copy of their vertices, with any
+    // translation since the copy was made applied by the geometry processor.
+    bool reuseVertexBuffers = !this->usesDistanceFields() &&
+                              target->caps().reuseTextVertexBuffers();
+
     SkExclusiveStrikePtr autoGlyphCache;
     // each of these is a SubRun
     for (int i = 0; i < fGeoCount; i++) {
         const Geometry& args = fGeoData[i];
         Blob* blob = args.fBlob;
+        bool translateOnGpu = reuseVertexBuffers && args.fClipRect.isEmpty();
+        if (translateOnGpu) {
+            // Draws from the sub run's own buffer must stay in order with the glyphs before it.
+            this->flush(target, &flushInfo);
+        }
         GrAtlasTextBlob::VertexRegenerator regenerator(
                 resourceProvider, blob, args.fRun, args.fSubRun, args.fViewMatrix, args.fX, args.fY,
                 args.fColor, target->deferredUploadTarget(), glyphCache, atlasManager,
-                &autoGlyphCache);
+                &autoGlyphCache, translateOnGpu);
         bool done = false;
         while (!done) {
             GrAtlasTextBlob::VertexRegenerator::Result result;
@@ -285,10 +295,27 @@ void GrAtlasTextOp::onPrepareDraws(Target* target) {
             }
             done = result.fFinished;
 
+            if (translateOnGpu && result.fFinished &&
+                result.fGlyphsRegenerated == regenerator.glyphCount()) {
+                // The whole sub run is ready in one piece, so it can be drawn from its buffer.
+                if (this->drawFromSubRunBuffer(target, flushInfo, &regenerator,
+                                               result.fFirstVertex, vertexStride, localMatrix)) {
+                    break;
+                }
+            }
+
             // Copy regenerated vertices from the blob to our vertex buffer.
             size_t vertexBytes = result.fGlyphsRegenerated * kVerticesPerGlyph * vertexStride;
             if (args.fClipRect.isEmpty()) {
                 memcpy(currVertex, result.fFirstVertex, vertexBytes);
+                if (translateOnGpu) {
+                    const SkVector& translate = regenerator.gpuTranslation();
+                    auto* pos = reinterpret_cast<SkPoint*>(currVertex);
+                    for (int v = 0; v < result.fGlyphsRegenerated * kVerticesPerGlyph; ++v) {
+                        pos->offset(translate.fX, translate.fY);
+                        pos = SkTAddOffset<SkPoint>(pos, vertexStride);
+                    }
+                }
             } else {
                 SkASSERT(!dfPerspective);
                 clip_quads(args.fClipRect, currVertex, result.fFirstVertex, vertexStride,
@@ -320,6 +347,42 @@ void GrAtlasTextOp::onPrepareDraws(Target* target) {
     this->flush(target, &flushInfo);
 }
 
+bool GrAtlasTextOp::drawFromSubRunBuffer(Target* target, const FlushInfo& flushInfo,
+                                         GrAtlasTextBlob::VertexRegenerator* regenerator,
+                                         const char* vertices, size_t vertexStride,
+                                         const SkMatrix& localMatrix) const {
+    int glyphCount = regenerator->glyphCount();
+    if (!regenerator->vertexBuffer()) {
+        // The blob's vertices changed since they were last uploaded, or never were.
+        sk_sp<const GrBuffer> buffer(target->resourceProvider()->createBuffer(
+                glyphCount * kVerticesPerGlyph * vertexStride, kVertex_GrBufferType,
+                kStatic_GrAccessPattern, GrResourceProvider::kNoPendingIO_Flag, vertices));
+        if (!buffer) {
+            return false;
+        }
+        regenerator->setVertexBuffer(std::move(buffer));
+    }
+
+    GrMaskFormat maskFormat = this->maskFormat();
+    unsigned int numProxies;
+    const sk_sp<GrTextureProxy>* proxies =
+            target->atlasManager()->getProxies(maskFormat, &numProxies);
+    GrSamplerState samplerState = fHasScaledGlyphs ? GrSamplerState::ClampBilerp()
+                                                   : GrSamplerState::ClampNearest();
+    sk_sp<GrGeometryProcessor> gp = GrBitmapTextGeoProc::Make(
+            this->color(), proxies, numProxies, samplerState, maskFormat, localMatrix,
+            this->usesLocalCoords(), &regenerator->gpuTranslation());
+
+    GrMesh mesh(GrPrimitiveType::kTriangles);
+    int maxGlyphsPerDraw =
+            static_cast<int>(flushInfo.fIndexBuffer->gpuMemorySize() / sizeof(uint16_t) / 6);
+    mesh.setIndexedPatterned(flushInfo.fIndexBuffer.get(), kIndicesPerGlyph, kVerticesPerGlyph,
+                             glyphCount, maxGlyphsPerDraw);
+    mesh.setVertexData(regenerator->vertexBuffer());
+    target->draw(gp.get(), flushInfo.fPipeline, mesh);
+    return true;
+}
+
 void GrAtlasTextOp::flush(GrMeshDrawOp::Target* target, FlushInfo* flushInfo) const {
     if (!flushInfo->fGlyphsToFlush) {
         return;
@@ -138,6 +138,12 @@ private:
 
     void onPrepareDraws(Target*) override;
 
+    // Draws a whole sub run from the GPU buffer kept with it, uploading the vertices first if the
+    // buffer is missing or stale. Returns false if the buffer could not be created.
+    bool drawFromSubRunBuffer(Target*, const FlushInfo&, GrAtlasTextBlob::VertexRegenerator*,
+                              const char* vertices, size_t vertexStride,
+                              const SkMatrix& localMatrix) const;
+
     GrMaskFormat maskFormat() const {
         switch (fMaskType) {
             case kLCDCoverageMask_MaskType:
@@ -7,38 +7,34 @@
 
 #include "GrOp.h"
 
+#include "GrConcurrentMemoryPool.h"
 #include "GrMemoryPool.h"
-#include "SkSpinlock.h"
 
 // TODO I noticed a small benefit to using a larger exclusive pool for ops. Its very small, but
 // seems to be mostly consistent.  There is a lot in flux right now, but we should really revisit
 // this.
 
 
-// We use a global pool protected by a mutex(spinlock). Chrome may use the same GrContext on
-// different threads. The GrContext is not used concurrently on different threads and there is a
-// memory barrier between accesses of a context on different threads. Also, there may be multiple
-// GrContexts and those contexts may be in use concurrently on different threads.
+// We know in the Android framework there is only one GrContext, so it keeps one pool and no lock.
+//
+// Everywhere else, several threads may be recording at once (e.g. SkDeferredDisplayListRecorders,
+// or one GrContext each), and an op may be deleted on another thread than the one that made it (a
+// DDL's ops are deleted by the GrContext that replays it). GrConcurrentMemoryPool gives each
+// thread a magazine of its own, and takes ops deleted elsewhere back without a lock.
 namespace {
-#if !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
-static SkSpinlock gOpPoolSpinLock;
-#endif
 class MemoryPoolAccessor {
 public:
-
-// We know in the Android framework there is only one GrContext.
 #if defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
-    MemoryPoolAccessor() {}
-    ~MemoryPoolAccessor() {}
-#else
-    MemoryPoolAccessor() { gOpPoolSpinLock.acquire(); }
-    ~MemoryPoolAccessor() { gOpPoolSpinLock.release(); }
-#endif
-
     GrMemoryPool* pool() const {
         static GrMemoryPool gPool(16384, 16384);
         return &gPool;
     }
+#else
+    GrConcurrentMemoryPool* pool() const {
+        static GrConcurrentMemoryPool gPool(16384, 16384);
+        return &gPool;
+    }
+#endif
 };
 }
 
@@ -14,12 +14,17 @@
 #include "GrQuad.h"
 #include "GrResourceProvider.h"
 #include "GrSimpleMeshDrawOpHelper.h"
+#include "GrTexture.h"
 #include "SkAutoMalloc.h"
 #include "SkAutoPixmapStorage.h"
 #include "SkDistanceFieldGen.h"
 #include "SkRasterClip.h"
+#include "effects/GrAtlasedShaderHelpers.h"
 #include "effects/GrBitmapTextGeoProc.h"
 #include "effects/GrDistanceFieldGeoProc.h"
+#include "glsl/GrGLSLGeometryProcessor.h"
+#include "glsl/GrGLSLProgramDataManager.h"
+#include "glsl/GrGLSLUniformHandler.h"
 #include "ops/GrMeshDrawOp.h"
 
 #define ATLAS_TEXTURE_WIDTH 2048
@@ -214,6 +219,173 @@ GrPathRenderer::CanDrawPath GrSmallPathRenderer::onCanDrawPath(const CanDrawPath
 // padding around path bounds to allow for antialiased pixels
 static const SkScalar kAntiAliasPad = 1.0f;
 
+/**
+ * Draws coverage mask paths as instances. Each instance is a device space rect, the packed atlas
+ * rect of the cached mask, and a color. The quad corners come from a static vertex buffer, so a
+ * draw only writes one instance per path instead of four vertices.
+ */
+class SmallPathInstanceProc : public GrGeometryProcessor {
+public:
+    struct Instance {
+        SkRect   fDevBounds;
+        GrColor  fColor;
+        uint16_t fTexCoordsLT[2];
+        uint16_t fTexCoordsRB[2];
+    };
+
+    static sk_sp<GrGeometryProcessor> Make(const sk_sp<GrTextureProxy>* proxies, int numProxies,
+                                           const SkMatrix& localMatrix, bool usesLocalCoords) {
+        return sk_sp<GrGeometryProcessor>(
+                new SmallPathInstanceProc(proxies, numProxies, localMatrix, usesLocalCoords));
+    }
+
+    const char* name() const override { return "SmallPathInstance"; }
+
+    void addNewProxies(const sk_sp<GrTextureProxy>* proxies, int numProxies) {
+        SkASSERT(numProxies <= kMaxTextures);
+        for (int i = 0; i < numProxies; ++i) {
+            SkASSERT(proxies[i]);
+            if (!fTextureSamplers[i].isInitialized()) {
+                fTextureSamplers[i].reset(proxies[i], GrSamplerState::ClampNearest());
+                this->addTextureSampler(&fTextureSamplers[i]);
+            }
+        }
+    }
+
+    void getGLSLProcessorKey(const GrShaderCaps&, GrProcessorKeyBuilder* b) const override {
+        b->add32(fUsesLocalCoords && fLocalMatrix.hasPerspective() ? 0x1 : 0x0);
+        b->add32(this->numTextureSamplers());
+    }
+
+    GrGLSLPrimitiveProcessor* createGLSLInstance(const GrShaderCaps&) const override;
+
+    static sk_sp<const GrBuffer> FindCornerBuffer(GrResourceProvider*);
+
+private:
+    static constexpr int kMaxTextures = 4;
+
+    SmallPathInstanceProc(const sk_sp<GrTextureProxy>* proxies, int numProxies,
+                          const SkMatrix& localMatrix, bool usesLocalCoords)
+            : INHERITED(kSmallPathInstanceProc_ClassID)
+            , fLocalMatrix(localMatrix)
+            , fUsesLocalCoords(usesLocalCoords) {
+        fInCorner = &this->addVertexAttrib("inCorner", kFloat2_GrVertexAttribType);
+        fInDevBounds = &this->addInstanceAttrib("inDevBounds", kFloat4_GrVertexAttribType);
+        fInColor = &this->addInstanceAttrib("inColor", kUByte4_norm_GrVertexAttribType);
+        fInTexCoordsLT = &this->addInstanceAttrib("inTexCoordsLT", kUShort2_GrVertexAttribType);
+        fInTexCoordsRB = &this->addInstanceAttrib("inTexCoordsRB", kUShort2_GrVertexAttribType);
+        SkASSERT(offsetof(Instance, fColor) == fInColor->fOffsetInRecord);
+        SkASSERT(offsetof(Instance, fTexCoordsLT) == fInTexCoordsLT->fOffsetInRecord);
+        SkASSERT(offsetof(Instance, fTexCoordsRB) == fInTexCoordsRB->fOffsetInRecord);
+        SkASSERT(sizeof(Instance) == this->getInstanceStride());
+        this->addNewProxies(proxies, numProxies);
+    }
+
+    SkMatrix         fLocalMatrix;
+    bool             fUsesLocalCoords;
+    TextureSampler   fTextureSamplers[kMaxTextures];
+    const Attribute* fInCorner;
+    const Attribute* fInDevBounds;
+    const Attribute* fInColor;
+    const Attribute* fInTexCoordsLT;
+    const Attribute* fInTexCoordsRB;
+
+    class GLSLProcessor;
+
+    typedef GrGeometryProcessor INHERITED;
+};
+
+class SmallPathInstanceProc::GLSLProcessor : public GrGLSLGeometryProcessor {
+public:
+    GLSLProcessor() : fAtlasSize({0, 0}) {}
+
+    void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
+        const SmallPathInstanceProc& proc = args.fGP.cast<SmallPathInstanceProc>();
+        GrGLSLVertexBuilder* vertBuilder = args.fVertBuilder;
+        GrGLSLVaryingHandler* varyingHandler = args.fVaryingHandler;
+        GrGLSLUniformHandler* uniformHandler = args.fUniformHandler;
+
+        varyingHandler->emitAttributes(proc);
+
+        const char* atlasSizeInvName;
+        fAtlasSizeInvUniform = uniformHandler->addUniform(kVertex_GrShaderFlag,
+                                                          kFloat2_GrSLType,
+                                                          kHigh_GrSLPrecision,
+                                                          "AtlasSizeInv",
+                                                          &atlasSizeInvName);
+
+        // The corners are exactly 0 or 1, so mixing keeps the page index in the low bits intact.
+        const char* corner = proc.fInCorner->fName;
+        vertBuilder->codeAppendf("float2 position = mix(%s.xy, %s.zw, %s);",
+                                 proc.fInDevBounds->fName, proc.fInDevBounds->fName, corner);
+        vertBuilder->codeAppendf("float2 texCoordsLT = float2(%s.x, %s.y);",
+                                 proc.fInTexCoordsLT->fName, proc.fInTexCoordsLT->fName);
+        vertBuilder->codeAppendf("float2 texCoordsRB = float2(%s.x, %s.y);",
+                                 proc.fInTexCoordsRB->fName, proc.fInTexCoordsRB->fName);
+        vertBuilder->codeAppendf("float2 packedTexCoords = mix(texCoordsLT, texCoordsRB, %s);",
+                                 corner);
+
+        GrGLSLVarying uv(kFloat2_GrSLType);
+        GrSLType texIdxType = args.fShaderCaps->integerSupport() ? kInt_GrSLType : kFloat_GrSLType;
+        GrGLSLVarying texIdx(texIdxType);
+        append_index_uv_varyings(args, "packedTexCoords", atlasSizeInvName, &uv, &texIdx, nullptr);
+
+        varyingHandler->addPassThroughAttribute(proc.fInColor, args.fOutputColor);
+
+        this->writeOutputPosition(vertBuilder, gpArgs, "position");
+        this->emitTransforms(vertBuilder,
+                             varyingHandler,
+                             uniformHandler,
+                             GrShaderVar("position", kFloat2_GrSLType),
+                             proc.fLocalMatrix,
+                             args.fFPCoordTransformHandler);
+
+        GrGLSLFPFragmentBuilder* fragBuilder = args.fFragBuilder;
+        fragBuilder->codeAppend("half4 texColor;");
+        append_multitexture_lookup(args, proc.numTextureSamplers(), texIdx, uv.fsIn(),
+                                   "texColor");
+        fragBuilder->codeAppendf("%s = texColor;", args.fOutputCoverage);
+    }
+
+    void setData(const GrGLSLProgramDataManager& pdman, const GrPrimitiveProcessor& gp,
+                 FPCoordTransformIter&& transformIter) override {
+        const SmallPathInstanceProc& proc = gp.cast<SmallPathInstanceProc>();
+        GrTexture* atlas = proc.textureSampler(0).peekTexture();
+        SkASSERT(atlas && SkIsPow2(atlas->width()) && SkIsPow2(atlas->height()));
+        if (fAtlasSize.fWidth != atlas->width() || fAtlasSize.fHeight != atlas->height()) {
+            pdman.set2f(fAtlasSizeInvUniform, 1.0f / atlas->width(), 1.0f / atlas->height());
+            fAtlasSize.set(atlas->width(), atlas->height());
+        }
+        this->setTransformDataHelper(proc.fLocalMatrix, pdman, &transformIter);
+    }
+
+private:
+    SkISize       fAtlasSize;
+    UniformHandle fAtlasSizeInvUniform;
+
+    typedef GrGLSLGeometryProcessor INHERITED;
+};
+
+GrGLSLPrimitiveProcessor* SmallPathInstanceProc::createGLSLInstance(const GrShaderCaps&) const {
+    return new GLSLProcessor();
+}
+
+// Corners of the unit square in the same triangle strip order as SkPointPriv::SetRectTriStrip.
+static constexpr float kQuadCorners[] = {
+    0, 0,
+    0, 1,
+    1, 0,
+    1, 1,
+};
+
+GR_DECLARE_STATIC_UNIQUE_KEY(gSmallPathCornerBufferKey);
+
+sk_sp<const GrBuffer> SmallPathInstanceProc::FindCornerBuffer(GrResourceProvider* provider) {
+    GR_DEFINE_STATIC_UNIQUE_KEY(gSmallPathCornerBufferKey);
+    return provider->findOrMakeStaticBuffer(kVertex_GrBufferType, sizeof(kQuadCorners),
+                                            kQuadCorners, gSmallPathCornerBufferKey);
+}
+
 class GrSmallPathRenderer::SmallPathOp final : public GrMeshDrawOp {
 private:
     using Helper = GrSimpleMeshDrawOpHelperWithStencil;
@@ -297,6 +469,9 @@ private:
         sk_sp<const GrBuffer> fVertexBuffer;
         sk_sp<const GrBuffer> fIndexBuffer;
         sk_sp<GrGeometryProcessor>   fGeometryProcessor;
+        // Set when coverage masks are drawn with SmallPathInstanceProc. fVertexBuffer then holds
+        // instances and fVertexOffset counts instances rather than vertices.
+        sk_sp<const GrBuffer> fCornerBuffer;
         const GrPipeline* fPipeline;
         int fVertexOffset;
         int fInstancesToFlush;
@@ -307,6 +482,10 @@ private:
 
         FlushInfo flushInfo;
         flushInfo.fPipeline = fHelper.makePipeline(target);
+        if (!fUsesDistanceField && target->caps().instanceAttribSupport()) {
+            flushInfo.fCornerBuffer =
+                    SmallPathInstanceProc::FindCornerBuffer(target->resourceProvider());
+        }
         // Setup GrGeometryProcessor
         const SkMatrix& ctm = fShapes[0].fViewMatrix;
         if (fUsesDistanceField) {
@@ -339,27 +518,45 @@ private:
                 }
             }
 
-            flushInfo.fGeometryProcessor = GrBitmapTextGeoProc::Make(
-                    this->color(), fAtlas->getProxies(), fAtlas->numActivePages(),
-                    GrSamplerState::ClampNearest(), kA8_GrMaskFormat, invert,
-                    fHelper.usesLocalCoords());
+            if (flushInfo.fCornerBuffer) {
+                flushInfo.fGeometryProcessor = SmallPathInstanceProc::Make(
+                        fAtlas->getProxies(), fAtlas->numActivePages(), invert,
+                        fHelper.usesLocalCoords());
+            } else {
+                flushInfo.fGeometryProcessor = GrBitmapTextGeoProc::Make(
+                        this->color(), fAtlas->getProxies(), fAtlas->numActivePages(),
+                        GrSamplerState::ClampNearest(), kA8_GrMaskFormat, invert,
+                        fHelper.usesLocalCoords());
+            }
         }
 
         // allocate vertices
-        size_t vertexStride = flushInfo.fGeometryProcessor->getVertexStride();
-        SkASSERT(vertexStride == sizeof(SkPoint) + sizeof(GrColor) + 2*sizeof(uint16_t));
+        size_t vertexStride;
+        int verticesPerShape;
+        if (flushInfo.fCornerBuffer) {
+            vertexStride = flushInfo.fGeometryProcessor->getInstanceStride();
+            verticesPerShape = 1;
+        } else {
+            vertexStride = flushInfo.fGeometryProcessor->getVertexStride();
+            verticesPerShape = kVerticesPerQuad;
+            SkASSERT(vertexStride == sizeof(SkPoint) + sizeof(GrColor) + 2*sizeof(uint16_t));
+            flushInfo.fIndexBuffer = target->resourceProvider()->refQuadIndexBuffer();
+            if (!flushInfo.fIndexBuffer) {
+                SkDebugf("Could not allocate indices\n");
+                return;
+            }
+        }
 
         const GrBuffer* vertexBuffer;
         void* vertices = target->makeVertexSpace(vertexStride,
-                                                 kVerticesPerQuad * instanceCount,
+                                                 verticesPerShape * instanceCount,
                                                  &vertexBuffer,
                                                  &flushInfo.fVertexOffset);
-        flushInfo.fVertexBuffer.reset(SkRef(vertexBuffer));
-        flushInfo.fIndexBuffer = target->resourceProvider()->refQuadIndexBuffer();
-        if (!vertices || !flushInfo.fIndexBuffer) {
+        if (!vertices) {
             SkDebugf("Could not allocate vertices\n");
             return;
         }
+        flushInfo.fVertexBuffer.reset(SkRef(vertexBuffer));
 
         flushInfo.fInstancesToFlush = 0;
         // Pointer to the next set of vertices to write.
@@ -465,13 +662,17 @@ private:
             auto uploadTarget = target->deferredUploadTarget();
             fAtlas->setLastUseToken(shapeData->fID, uploadTarget->tokenTracker()->nextDrawToken());
 
-            this->writePathVertices(fAtlas,
-                                    offset,
-                                    args.fColor,
-                                    vertexStride,
-                                    args.fViewMatrix,
-                                    shapeData);
-            offset += kVerticesPerQuad * vertexStride;
+            if (flushInfo.fCornerBuffer) {
+                this->writePathInstance(offset, args.fColor, args.fViewMatrix, shapeData);
+            } else {
+                this->writePathVertices(fAtlas,
+                                        offset,
+                                        args.fColor,
+                                        vertexStride,
+                                        args.fViewMatrix,
+                                        shapeData);
+            }
+            offset += verticesPerShape * vertexStride;
             flushInfo.fInstancesToFlush++;
         }
 
@@ -797,12 +998,29 @@ private:
         textureCoords[1] = b;
     }
 
+    void writePathInstance(intptr_t offset, GrColor color, const SkMatrix& ctm,
+                           const ShapeData* shapeData) const {
+        SkASSERT(!fUsesDistanceField);
+        auto* instance = reinterpret_cast<SmallPathInstanceProc::Instance*>(offset);
+        instance->fDevBounds = shapeData->fBounds;
+        instance->fDevBounds.offset(SkScalarFloorToScalar(ctm.get(SkMatrix::kMTransX)),
+                                    SkScalarFloorToScalar(ctm.get(SkMatrix::kMTransY)));
+        instance->fColor = color;
+        instance->fTexCoordsLT[0] = shapeData->fTextureCoords.fLeft;
+        instance->fTexCoordsLT[1] = shapeData->fTextureCoords.fTop;
+        instance->fTexCoordsRB[0] = shapeData->fTextureCoords.fRight;
+        instance->fTexCoordsRB[1] = shapeData->fTextureCoords.fBottom;
+    }
+
     void flush(GrMeshDrawOp::Target* target, FlushInfo* flushInfo) const {
         GrGeometryProcessor* gp = flushInfo->fGeometryProcessor.get();
         if (gp->numTextureSamplers() != (int)fAtlas->numActivePages()) {
             // During preparation the number of atlas pages has increased.
             // Update the proxies used in the GP to match.
-            if (fUsesDistanceField) {
+            if (flushInfo->fCornerBuffer) {
+                static_cast<SmallPathInstanceProc*>(gp)->addNewProxies(
+                    fAtlas->getProxies(), fAtlas->numActivePages());
+            } else if (fUsesDistanceField) {
                 reinterpret_cast<GrDistanceFieldPathGeoProc*>(gp)->addNewProxies(
                     fAtlas->getProxies(), fAtlas->numActivePages(), GrSamplerState::ClampBilerp());
             } else {
@@ -811,7 +1029,15 @@ private:
             }
         }
 
-        if (flushInfo->fInstancesToFlush) {
+        if (flushInfo->fInstancesToFlush && flushInfo->fCornerBuffer) {
+            GrMesh mesh(GrPrimitiveType::kTriangleStrip);
+            mesh.setInstanced(flushInfo->fVertexBuffer.get(), flushInfo->fInstancesToFlush,
+                              flushInfo->fVertexOffset, kVerticesPerQuad);
+            mesh.setVertexData(flushInfo->fCornerBuffer.get());
+            target->draw(flushInfo->fGeometryProcessor.get(), flushInfo->fPipeline, mesh);
+            flushInfo->fVertexOffset += flushInfo->fInstancesToFlush;
+            flushInfo->fInstancesToFlush = 0;
+        } else if (flushInfo->fInstancesToFlush) {
             GrMesh mesh(GrPrimitiveType::kTriangles);
             int maxInstancesPerDraw =
                 static_cast<int>(flushInfo->fIndexBuffer->gpuMemorySize() / sizeof(uint16_t) / 6);
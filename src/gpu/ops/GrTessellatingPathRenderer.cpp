@@ -11,13 +11,16 @@
 #include "GrClip.h"
 #include "GrDefaultGeoProcFactory.h"
 #include "GrDrawOpTest.h"
+#include "GrGpu.h"
 #include "GrMesh.h"
 #include "GrOpFlushState.h"
 #include "GrPathUtils.h"
 #include "GrResourceCache.h"
 #include "GrResourceProvider.h"
+#include "GrResourceProviderPriv.h"
 #include "GrTessellator.h"
 #include "SkGeometry.h"
+#include "SkTime.h"
 
 #include "GrSimpleMeshDrawOpHelper.h"
 #include "ops/GrMeshDrawOp.h"
@@ -66,6 +69,46 @@ bool cache_match(GrBuffer* vertexBuffer, SkScalar tol, int* actualCount) {
     return false;
 }
 
+// Tessellations are cached per tolerance bucket: tolerances in [2^(b-1), 2^b) share bucket b. Any
+// two tolerances in a bucket are within a factor of two of each other, which cache_match accepts,
+// so a path whose scale animates within a bucket is only tessellated once. Linear paths don't
+// depend on the tolerance, and share one bucket.
+static constexpr uint32_t kLinearToleranceBucket = 0x80000000;
+
+uint32_t tolerance_bucket(const SkPath& path, SkScalar tol) {
+    if (SkPath::kLine_SegmentMask == path.getSegmentMasks()) {
+        return kLinearToleranceBucket;
+    }
+    int bucket = 0;
+    if (SkScalarIsFinite(tol)) {
+        frexpf(tol, &bucket);
+    }
+    return static_cast<uint32_t>(bucket);
+}
+
+// Runs GrTessellator, and counts it in the GPU's stats. Large non-AA paths are triangulated on the
+// executor, if there is one.
+int path_to_triangles(GrGpu::Stats* stats, SkExecutor* executor, const SkPath& path,
+                      SkScalar tol, const SkRect& clipBounds,
+                      GrTessellator::VertexAllocator* allocator, bool antialias, GrColor color,
+                      bool canTweakAlphaForCoverage, bool* isLinear) {
+#if GR_GPU_STATS
+    double startNs = SkTime::GetNSecs();
+#endif
+    int count;
+    if (executor && !antialias) {
+        count = GrTessellator::PathToTrianglesInSlabs(path, tol, clipBounds, allocator, executor,
+                                                      isLinear);
+    } else {
+        count = GrTessellator::PathToTriangles(path, tol, clipBounds, allocator, antialias, color,
+                                               canTweakAlphaForCoverage, isLinear);
+    }
+#if GR_GPU_STATS
+    stats->incTessellations((SkTime::GetNSecs() - startNs) * 1e-6);
+#endif
+    return count;
+}
+
 class StaticVertexAllocator : public GrTessellator::VertexAllocator {
 public:
     StaticVertexAllocator(size_t stride, GrResourceProvider* resourceProvider, bool canMapVB)
@@ -133,7 +176,8 @@ private:
 
 }  // namespace
 
-GrTessellatingPathRenderer::GrTessellatingPathRenderer() {
+GrTessellatingPathRenderer::GrTessellatingPathRenderer(SkExecutor* executor)
+        : fExecutor(executor) {
 }
 
 GrPathRenderer::CanDrawPath
@@ -143,8 +187,8 @@ GrTessellatingPathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
     // ones to simpler algorithms. We pass on paths that have styles, though they may come back
     // around after applying the styling information to the geometry to create a filled path. In
     // the non-AA case, We skip paths that don't have a key since the real advantage of this path
-    // renderer comes from caching the tessellated geometry. In the AA case, we do not cache, so we
-    // accept paths without keys.
+    // renderer comes from caching the tessellated geometry, unless they are big enough to be worth
+    // triangulating in parallel. In the AA case, we do not cache, so we accept paths without keys.
     if (!args.fShape->style().isSimpleFill() || args.fShape->knownToBeConvex()) {
         return CanDrawPath::kNo;
     }
@@ -155,7 +199,11 @@ GrTessellatingPathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
             return CanDrawPath::kNo;
         }
     } else if (!args.fShape->hasUnstyledKey()) {
-        return CanDrawPath::kNo;
+        SkPath path;
+        args.fShape->asPath(&path);
+        if (!fExecutor || path.countPoints() < GrTessellator::kMinSlabbedPathPoints) {
+            return CanDrawPath::kNo;
+        }
     }
     return CanDrawPath::kYes;
 }
@@ -174,9 +222,11 @@ public:
                                           const SkMatrix& viewMatrix,
                                           SkIRect devClipBounds,
                                           GrAAType aaType,
-                                          const GrUserStencilSettings* stencilSettings) {
+                                          const GrUserStencilSettings* stencilSettings,
+                                          SkExecutor* executor) {
         return Helper::FactoryHelper<TessellatingPathOp>(std::move(paint), shape, viewMatrix,
-                                                         devClipBounds, aaType, stencilSettings);
+                                                         devClipBounds, aaType, stencilSettings,
+                                                         executor);
     }
 
     const char* name() const override { return "TessellatingPathOp"; }
@@ -199,14 +249,16 @@ public:
                        const SkMatrix& viewMatrix,
                        const SkIRect& devClipBounds,
                        GrAAType aaType,
-                       const GrUserStencilSettings* stencilSettings)
+                       const GrUserStencilSettings* stencilSettings,
+                       SkExecutor* executor)
             : INHERITED(ClassID())
             , fHelper(helperArgs, aaType, stencilSettings)
             , fColor(color)
             , fShape(shape)
             , fViewMatrix(viewMatrix)
             , fDevClipBounds(devClipBounds)
-            , fAntiAlias(GrAAType::kCoverage == aaType) {
+            , fAntiAlias(GrAAType::kCoverage == aaType)
+            , fExecutor(executor) {
         SkRect devBounds;
         viewMatrix.mapRect(&devBounds, shape.bounds());
         if (shape.inverseFilled()) {
@@ -235,30 +287,51 @@ private:
         return path;
     }
 
-    void draw(Target* target, const GrGeometryProcessor* gp) {
-        SkASSERT(!fAntiAlias);
-        GrResourceProvider* rp = target->resourceProvider();
-        bool inverseFill = fShape.inverseFilled();
-        // construct a cache key from the path's genID and the view matrix
+    // Builds the cache key for the path's tessellation in the given tolerance bucket.
+    void makeKey(uint32_t toleranceBucket, GrUniqueKey* key) const {
         static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
-        GrUniqueKey key;
         static constexpr int kClipBoundsCnt = sizeof(fDevClipBounds) / sizeof(uint32_t);
         int shapeKeyDataCnt = fShape.unstyledKeySize();
         SkASSERT(shapeKeyDataCnt >= 0);
-        GrUniqueKey::Builder builder(&key, kDomain, shapeKeyDataCnt + kClipBoundsCnt, "Path");
+        GrUniqueKey::Builder builder(key, kDomain, shapeKeyDataCnt + kClipBoundsCnt + 1, "Path");
         fShape.writeUnstyledKey(&builder[0]);
         // For inverse fills, the tessellation is dependent on clip bounds.
-        if (inverseFill) {
+        if (fShape.inverseFilled()) {
             memcpy(&builder[shapeKeyDataCnt], &fDevClipBounds, sizeof(fDevClipBounds));
         } else {
             memset(&builder[shapeKeyDataCnt], 0, sizeof(fDevClipBounds));
         }
+        builder[shapeKeyDataCnt + kClipBoundsCnt] = toleranceBucket;
         builder.finish();
-        sk_sp<GrBuffer> cachedVertexBuffer(rp->findByUniqueKey<GrBuffer>(key));
-        int actualCount;
+    }
+
+    void draw(Target* target, const GrGeometryProcessor* gp) {
+        SkASSERT(!fAntiAlias);
+        GrResourceProvider* rp = target->resourceProvider();
+        GrGpu::Stats* stats = rp->priv().gpu()->stats();
+        SkPath path = this->getPath();
         SkScalar tol = GrPathUtils::kDefaultTolerance;
         tol = GrPathUtils::scaleToleranceToSrc(tol, fViewMatrix, fShape.bounds());
+
+        // Construct a cache key from the path's genID and the tolerance's bucket. A tessellation
+        // from the next finer bucket works just as well, e.g. while a path is animating smaller.
+        // Paths without a key (see onCanDrawPath) aren't cached.
+        bool canCache = fShape.hasUnstyledKey();
+        uint32_t bucket = tolerance_bucket(path, tol);
+        GrUniqueKey key;
+        sk_sp<GrBuffer> cachedVertexBuffer;
+        if (canCache) {
+            this->makeKey(bucket, &key);
+            cachedVertexBuffer = rp->findByUniqueKey<GrBuffer>(key);
+        }
+        if (canCache && !cachedVertexBuffer && kLinearToleranceBucket != bucket) {
+            GrUniqueKey finerKey;
+            this->makeKey(bucket - 1, &finerKey);
+            cachedVertexBuffer = rp->findByUniqueKey<GrBuffer>(finerKey);
+        }
+        int actualCount;
         if (cache_match(cachedVertexBuffer.get(), tol, &actualCount)) {
+            stats->incTessellationCacheHits();
             this->drawVertices(target, gp, cachedVertexBuffer.get(), 0, actualCount);
             return;
         }
@@ -273,12 +346,15 @@ private:
         bool isLinear;
         bool canMapVB = GrCaps::kNone_MapFlags != target->caps().mapBufferFlags();
         StaticVertexAllocator allocator(gp->getVertexStride(), rp, canMapVB);
-        int count = GrTessellator::PathToTriangles(getPath(), tol, clipBounds, &allocator,
-                                                   false, GrColor(), false, &isLinear);
+        int count = path_to_triangles(stats, fExecutor, path, tol, clipBounds, &allocator, false,
+                                      GrColor(), false, &isLinear);
         if (count == 0) {
             return;
         }
         this->drawVertices(target, gp, allocator.vertexBuffer(), 0, count);
+        if (!canCache) {
+            return;
+        }
         TessInfo info;
         info.fTolerance = isLinear ? 0 : tol;
         info.fCount = count;
@@ -298,9 +374,9 @@ private:
         SkScalar tol = GrPathUtils::kDefaultTolerance;
         bool isLinear;
         DynamicVertexAllocator allocator(gp->getVertexStride(), target);
-        int count =
-                GrTessellator::PathToTriangles(path, tol, clipBounds, &allocator, true, fColor,
-                                               fHelper.compatibleWithAlphaAsCoverage(), &isLinear);
+        int count = path_to_triangles(target->resourceProvider()->priv().gpu()->stats(), nullptr,
+                                      path, tol, clipBounds, &allocator, true, fColor,
+                                      fHelper.compatibleWithAlphaAsCoverage(), &isLinear);
         if (count == 0) {
             return;
         }
@@ -361,6 +437,7 @@ private:
     SkMatrix                fViewMatrix;
     SkIRect                 fDevClipBounds;
     bool                    fAntiAlias;
+    SkExecutor*             fExecutor;
 
     typedef GrMeshDrawOp INHERITED;
 };
@@ -379,7 +456,8 @@ bool GrTessellatingPathRenderer::onDrawPath(const DrawPathArgs& args) {
                                                             *args.fViewMatrix,
                                                             clipBoundsI,
                                                             args.fAAType,
-                                                            args.fUserStencilSettings);
+                                                            args.fUserStencilSettings,
+                                                            fExecutor);
     args.fRenderTargetContext->addDrawOp(*args.fClip, std::move(op));
     return true;
 }
@@ -405,7 +483,7 @@ GR_DRAW_OP_TEST_DEFINE(TesselatingPathOp) {
     } while (!style.isSimpleFill());
     GrShape shape(path, style);
     return TessellatingPathOp::Make(std::move(paint), shape, viewMatrix, devClipBounds, aaType,
-                                    GrGetRandomStencil(random, context));
+                                    GrGetRandomStencil(random, context), nullptr);
 }
 
 #endif
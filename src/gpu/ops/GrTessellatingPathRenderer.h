@@ -10,13 +10,16 @@
 
 #include "GrPathRenderer.h"
 
+class SkExecutor;
+
 /**
  *  Subclass that renders the path by converting to screen-space trapezoids plus
  *   extra 1-pixel geometry for AA.
  */
 class SK_API GrTessellatingPathRenderer : public GrPathRenderer {
 public:
-    GrTessellatingPathRenderer();
+    // If executor is non-null, large non-AA paths are triangulated in parallel on its threads.
+    GrTessellatingPathRenderer(SkExecutor* executor = nullptr);
 
 private:
     CanDrawPath onCanDrawPath(const CanDrawPathArgs&) const override;
@@ -27,6 +30,8 @@ private:
 
     bool onDrawPath(const DrawPathArgs&) override;
 
+    SkExecutor* const fExecutor;
+
     typedef GrPathRenderer INHERITED;
 };
 
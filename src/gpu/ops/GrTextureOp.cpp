@@ -10,6 +10,7 @@
 #include "GrCaps.h"
 #include "GrDrawOpTest.h"
 #include "GrGeometryProcessor.h"
+#include "GrImageAtlas.h"
 #include "GrMeshDrawOp.h"
 #include "GrOpFlushState.h"
 #include "GrQuad.h"
@@ -61,6 +62,20 @@ public:
         SkPoint3 fEdges[4];
         GrColor fColor;
     };
+    // When every quad is a device space rect and there is no coverage AA the quads can be drawn as
+    // instances of a unit quad. Each rect holds the values at the first (xy) and last (zw) corner
+    // in tri-strip order and the shader interpolates between them using the unit quad corner.
+    struct Instance {
+        SkRect fPositions;
+        SkRect fTextureCoords;
+        GrColor fColor;
+    };
+    struct MultiTextureInstance {
+        SkRect fPositions;
+        SkRect fTextureCoords;
+        GrColor fColor;
+        int fTextureIdx;
+    };
 
     // Maximum number of textures supported by this op. Must also be checked against the caps
     // limit. These numbers were based on some limited experiments on a HP Z840 and Pixel XL 2016
@@ -77,7 +92,7 @@ public:
 
     static sk_sp<GrGeometryProcessor> Make(sk_sp<GrTextureProxy> proxies[], int proxyCnt,
                                            sk_sp<GrColorSpaceXform> csxf, bool coverageAA,
-                                           const GrSamplerState::Filter filters[],
+                                           bool instanced, const GrSamplerState::Filter filters[],
                                            const GrShaderCaps& caps) {
         // We use placement new to avoid always allocating space for kMaxTextures TextureSampler
         // instances.
@@ -85,7 +100,8 @@ public:
         size_t size = sizeof(TextureGeometryProcessor) + sizeof(TextureSampler) * (samplerCnt - 1);
         void* mem = GrGeometryProcessor::operator new(size);
         return sk_sp<TextureGeometryProcessor>(new (mem) TextureGeometryProcessor(
-                proxies, proxyCnt, samplerCnt, std::move(csxf), coverageAA, filters, caps));
+                proxies, proxyCnt, samplerCnt, std::move(csxf), coverageAA, instanced, filters,
+                caps));
     }
 
     ~TextureGeometryProcessor() override {
@@ -99,7 +115,8 @@ public:
 
     void getGLSLProcessorKey(const GrShaderCaps&, GrProcessorKeyBuilder* b) const override {
         b->add32(GrColorSpaceXform::XformKey(fColorSpaceXform.get()));
-        b->add32(static_cast<uint32_t>(this->usesCoverageEdgeAA()));
+        b->add32(static_cast<uint32_t>(this->usesCoverageEdgeAA()) |
+                 (static_cast<uint32_t>(this->usesInstances()) << 1));
     }
 
     GrGLSLPrimitiveProcessor* createGLSLInstance(const GrShaderCaps& caps) const override {
@@ -122,18 +139,43 @@ public:
                         args.fUniformHandler, textureGP.fColorSpaceXform.get());
                 args.fVaryingHandler->setNoPerspective();
                 args.fVaryingHandler->emitAttributes(textureGP);
-                this->writeOutputPosition(args.fVertBuilder, gpArgs, textureGP.fPositions.fName);
-                this->emitTransforms(args.fVertBuilder,
-                                     args.fVaryingHandler,
-                                     args.fUniformHandler,
-                                     textureGP.fTextureCoords.asShaderVar(),
-                                     args.fFPCoordTransformHandler);
-                args.fVaryingHandler->addPassThroughAttribute(&textureGP.fColors,
-                                                              args.fOutputColor,
-                                                              Interpolation::kCanBeFlat);
-                args.fFragBuilder->codeAppend("float2 texCoord;");
-                args.fVaryingHandler->addPassThroughAttribute(&textureGP.fTextureCoords,
-                                                              "texCoord");
+                if (textureGP.usesInstances()) {
+                    const char* corner = textureGP.fCorner.fName;
+                    const char* positions = textureGP.fPositions.fName;
+                    const char* textureCoords = textureGP.fTextureCoords.fName;
+                    args.fVertBuilder->codeAppendf("float2 position = mix(%s.xy, %s.zw, %s);",
+                                                   positions, positions, corner);
+                    args.fVertBuilder->codeAppendf("float2 textureCoords = mix(%s.xy, %s.zw, %s);",
+                                                   textureCoords, textureCoords, corner);
+                    this->writeOutputPosition(args.fVertBuilder, gpArgs, "position");
+                    this->emitTransforms(args.fVertBuilder,
+                                         args.fVaryingHandler,
+                                         args.fUniformHandler,
+                                         GrShaderVar("textureCoords", kFloat2_GrSLType),
+                                         args.fFPCoordTransformHandler);
+                    args.fVaryingHandler->addPassThroughAttribute(&textureGP.fColors,
+                                                                  args.fOutputColor,
+                                                                  Interpolation::kCanBeFlat);
+                    GrGLSLVarying texCoordVarying(kFloat2_GrSLType);
+                    args.fVaryingHandler->addVarying("texCoord", &texCoordVarying);
+                    args.fVertBuilder->codeAppendf("%s = textureCoords;", texCoordVarying.vsOut());
+                    args.fFragBuilder->codeAppendf("float2 texCoord = %s;",
+                                                   texCoordVarying.fsIn());
+                } else {
+                    this->writeOutputPosition(args.fVertBuilder, gpArgs,
+                                              textureGP.fPositions.fName);
+                    this->emitTransforms(args.fVertBuilder,
+                                         args.fVaryingHandler,
+                                         args.fUniformHandler,
+                                         textureGP.fTextureCoords.asShaderVar(),
+                                         args.fFPCoordTransformHandler);
+                    args.fVaryingHandler->addPassThroughAttribute(&textureGP.fColors,
+                                                                  args.fOutputColor,
+                                                                  Interpolation::kCanBeFlat);
+                    args.fFragBuilder->codeAppend("float2 texCoord;");
+                    args.fVaryingHandler->addPassThroughAttribute(&textureGP.fTextureCoords,
+                                                                  "texCoord");
+                }
                 if (textureGP.numTextureSamplers() > 1) {
                     // If this changes to float, reconsider Interpolation::kMustBeFlat.
                     SkASSERT(kInt_GrVertexAttribType == textureGP.fTextureIdx.fType);
@@ -220,6 +262,11 @@ public:
     }
 
     bool usesCoverageEdgeAA() const { return SkToBool(fAAEdges[0].isInitialized()); }
+    bool usesInstances() const { return SkToBool(fCorner.isInitialized()); }
+
+    // Returns a vertex buffer holding the four corners of a unit quad in tri-strip order. This is
+    // the per-vertex data when the processor draws instances.
+    static sk_sp<const GrBuffer> FindCornerBuffer(GrResourceProvider*);
 
 private:
     // This exists to reduce the number of shaders generated. It does some rounding of sampler
@@ -238,11 +285,11 @@ private:
     }
 
     TextureGeometryProcessor(sk_sp<GrTextureProxy> proxies[], int proxyCnt, int samplerCnt,
-                             sk_sp<GrColorSpaceXform> csxf, bool coverageAA,
+                             sk_sp<GrColorSpaceXform> csxf, bool coverageAA, bool instanced,
                              const GrSamplerState::Filter filters[], const GrShaderCaps& caps)
             : INHERITED(kTextureGeometryProcessor_ClassID), fColorSpaceXform(std::move(csxf)) {
         SkASSERT(proxyCnt > 0 && samplerCnt >= proxyCnt);
-        fPositions = this->addVertexAttrib("position", kFloat2_GrVertexAttribType);
+        SkASSERT(!(coverageAA && instanced));
         fSamplers[0].reset(std::move(proxies[0]), filters[0]);
         this->addTextureSampler(&fSamplers[0]);
         for (int i = 1; i < proxyCnt; ++i) {
@@ -260,9 +307,22 @@ private:
                 this->addTextureSampler(&fSamplers[i]);
             }
             SkASSERT(caps.integerSupport());
-            fTextureIdx = this->addVertexAttrib("textureIdx", kInt_GrVertexAttribType);
         }
 
+        if (instanced) {
+            fCorner = this->addVertexAttrib("corner", kFloat2_GrVertexAttribType);
+            fPositions = this->addInstanceAttrib("positions", kFloat4_GrVertexAttribType);
+            fTextureCoords = this->addInstanceAttrib("textureCoords", kFloat4_GrVertexAttribType);
+            fColors = this->addInstanceAttrib("color", kUByte4_norm_GrVertexAttribType);
+            if (samplerCnt > 1) {
+                fTextureIdx = this->addInstanceAttrib("textureIdx", kInt_GrVertexAttribType);
+            }
+            return;
+        }
+        fPositions = this->addVertexAttrib("position", kFloat2_GrVertexAttribType);
+        if (samplerCnt > 1) {
+            fTextureIdx = this->addVertexAttrib("textureIdx", kInt_GrVertexAttribType);
+        }
         fTextureCoords = this->addVertexAttrib("textureCoords", kFloat2_GrVertexAttribType);
         if (coverageAA) {
             fAAEdges[0] = this->addVertexAttrib("aaEdge0", kFloat3_GrVertexAttribType);
@@ -273,6 +333,7 @@ private:
         fColors = this->addVertexAttrib("color", kUByte4_norm_GrVertexAttribType);
     }
 
+    Attribute fCorner;
     Attribute fPositions;
     Attribute fTextureIdx;
     Attribute fTextureCoords;
@@ -284,6 +345,21 @@ private:
     typedef GrGeometryProcessor INHERITED;
 };
 
+static constexpr float kQuadCorners[] = {
+    0, 0,
+    0, 1,
+    1, 0,
+    1, 1,
+};
+
+GR_DECLARE_STATIC_UNIQUE_KEY(gTextureOpCornerBufferKey);
+
+sk_sp<const GrBuffer> TextureGeometryProcessor::FindCornerBuffer(GrResourceProvider* provider) {
+    GR_DEFINE_STATIC_UNIQUE_KEY(gTextureOpCornerBufferKey);
+    return provider->findOrMakeStaticBuffer(kVertex_GrBufferType, sizeof(kQuadCorners),
+                                            kQuadCorners, gTextureOpCornerBufferKey);
+}
+
 namespace {
 // This is a class soley so it can be partially specialized (functions cannot be).
 template<GrAA, typename Vertex> class VertexAAHandler;
@@ -398,10 +474,8 @@ template <typename Vertex> struct TexIdAssigner<Vertex, false> {
 };
 }  // anonymous namespace
 
-template <typename Vertex, bool IsMultiTex, GrAA AA>
-static void tessellate_quad(const GrQuad& devQuad, const SkRect& srcRect, GrColor color,
-                            GrSurfaceOrigin origin, Vertex* vertices, SkScalar iw, SkScalar ih,
-                            int textureIdx) {
+static SkRect normalized_tex_rect(const SkRect& srcRect, GrSurfaceOrigin origin, SkScalar iw,
+                                  SkScalar ih) {
     SkRect texRect = {
             iw * srcRect.fLeft,
             ih * srcRect.fTop,
@@ -412,6 +486,14 @@ static void tessellate_quad(const GrQuad& devQuad, const SkRect& srcRect, GrColo
         texRect.fTop = 1.f - texRect.fTop;
         texRect.fBottom = 1.f - texRect.fBottom;
     }
+    return texRect;
+}
+
+template <typename Vertex, bool IsMultiTex, GrAA AA>
+static void tessellate_quad(const GrQuad& devQuad, const SkRect& srcRect, GrColor color,
+                            GrSurfaceOrigin origin, Vertex* vertices, SkScalar iw, SkScalar ih,
+                            int textureIdx) {
+    SkRect texRect = normalized_tex_rect(srcRect, origin, iw, ih);
     VertexAAHandler<AA, Vertex>::AssignPositionsAndTexCoords(vertices, devQuad, texRect);
     vertices[0].fColor = color;
     vertices[1].fColor = color;
@@ -419,6 +501,16 @@ static void tessellate_quad(const GrQuad& devQuad, const SkRect& srcRect, GrColo
     vertices[3].fColor = color;
     TexIdAssigner<Vertex, IsMultiTex>::Assign(vertices, textureIdx);
 }
+
+// Only valid for quads that are device space rects (see TextureOp::fQuadsAreRects).
+template <typename Instance>
+static void write_instance(const GrQuad& devQuad, const SkRect& srcRect, GrColor color,
+                           GrSurfaceOrigin origin, Instance* instance, SkScalar iw, SkScalar ih) {
+    instance->fPositions = {devQuad.point(0).fX, devQuad.point(0).fY,
+                            devQuad.point(3).fX, devQuad.point(3).fY};
+    instance->fTextureCoords = normalized_tex_rect(srcRect, origin, iw, ih);
+    instance->fColor = color;
+}
 /**
  * Op that implements GrTextureOp::Make. It draws textured quads. Each quad can modulate against a
  * the texture by color. The blend with the destination is always src-over. The edges are non-AA.
@@ -429,10 +521,11 @@ public:
                                           GrSamplerState::Filter filter, GrColor color,
                                           const SkRect& srcRect, const SkRect& dstRect,
                                           GrAAType aaType, const SkMatrix& viewMatrix,
-                                          sk_sp<GrColorSpaceXform> csxf, bool allowSRBInputs) {
+                                          sk_sp<GrColorSpaceXform> csxf, bool allowSRBInputs,
+                                          GrImageAtlas* imageAtlas) {
         return std::unique_ptr<GrDrawOp>(new TextureOp(std::move(proxy), filter, color, srcRect,
                                                        dstRect, aaType, viewMatrix, std::move(csxf),
-                                                       allowSRBInputs));
+                                                       allowSRBInputs, imageAtlas));
     }
 
     ~TextureOp() override {
@@ -515,15 +608,18 @@ __attribute__((no_sanitize("float-cast-overflow")))
 
     TextureOp(sk_sp<GrTextureProxy> proxy, GrSamplerState::Filter filter, GrColor color,
               const SkRect& srcRect, const SkRect& dstRect, GrAAType aaType,
-              const SkMatrix& viewMatrix, sk_sp<GrColorSpaceXform> csxf, bool allowSRGBInputs)
+              const SkMatrix& viewMatrix, sk_sp<GrColorSpaceXform> csxf, bool allowSRGBInputs,
+              GrImageAtlas* imageAtlas)
             : INHERITED(ClassID())
             , fColorSpaceXform(std::move(csxf))
+            , fImageAtlas(imageAtlas)
             , fProxy0(proxy.release())
             , fFilter0(filter)
             , fProxyCnt(1)
             , fAAType(static_cast<unsigned>(aaType))
             , fFinalized(0)
-            , fAllowSRGBInputs(allowSRGBInputs ? 1 : 0) {
+            , fAllowSRGBInputs(allowSRGBInputs ? 1 : 0)
+            , fQuadsAreRects(viewMatrix.isScaleTranslate() ? 1 : 0) {
         SkASSERT(aaType != GrAAType::kMixedSamples);
         Draw& draw = fDraws.push_back();
         draw.fSrcRect = srcRect;
@@ -547,11 +643,24 @@ __attribute__((no_sanitize("float-cast-overflow")))
             }
             proxiesSPs[i] = sk_ref_sp(proxies[i]);
         }
+        if (fImageAtlas) {
+            fImageAtlas->addPendingUploads(target->deferredUploadTarget(),
+                                           target->resourceProvider());
+        }
 
         bool coverageAA = GrAAType::kCoverage == this->aaType();
+        // A single quad is already one triangle strip so instancing only pays off for batches.
+        bool instanced = !coverageAA && fQuadsAreRects && fDraws.count() > 1 &&
+                         target->caps().instanceAttribSupport();
+        sk_sp<const GrBuffer> cornerBuffer;
+        if (instanced) {
+            cornerBuffer = TextureGeometryProcessor::FindCornerBuffer(target->resourceProvider());
+            instanced = SkToBool(cornerBuffer);
+        }
         sk_sp<GrGeometryProcessor> gp =
                 TextureGeometryProcessor::Make(proxiesSPs, fProxyCnt, std::move(fColorSpaceXform),
-                                               coverageAA, filters, *target->caps().shaderCaps());
+                                               coverageAA, instanced, filters,
+                                               *target->caps().shaderCaps());
         GrPipeline::InitArgs args;
         args.fProxy = target->proxy();
         args.fCaps = &target->caps();
@@ -566,6 +675,10 @@ __attribute__((no_sanitize("float-cast-overflow")))
 
         const GrPipeline* pipeline = target->allocPipeline(args, GrProcessorSet::MakeEmptySet(),
                                                            target->detachAppliedClip());
+        if (instanced) {
+            this->drawInstances(target, gp.get(), pipeline, cornerBuffer.get());
+            return;
+        }
         int vstart;
         const GrBuffer* vbuffer;
         void* vdata = target->makeVertexSpace(gp->getVertexStride(), 4 * fDraws.count(), &vbuffer,
@@ -648,6 +761,52 @@ __attribute__((no_sanitize("float-cast-overflow")))
         target->draw(gp.get(), pipeline, mesh);
     }
 
+    void drawInstances(Target* target, const GrGeometryProcessor* gp, const GrPipeline* pipeline,
+                       const GrBuffer* cornerBuffer) {
+        auto proxies = this->proxies();
+        int istart;
+        const GrBuffer* ibuffer;
+        void* idata = target->makeVertexSpace(gp->getInstanceStride(), fDraws.count(), &ibuffer,
+                                              &istart);
+        if (!idata) {
+            SkDebugf("Could not allocate instances\n");
+            return;
+        }
+        if (1 == fProxyCnt) {
+            SkASSERT(gp->getInstanceStride() == sizeof(TextureGeometryProcessor::Instance));
+            GrSurfaceOrigin origin = proxies[0]->origin();
+            GrTexture* texture = proxies[0]->priv().peekTexture();
+            float iw = 1.f / texture->width();
+            float ih = 1.f / texture->height();
+            auto instances = static_cast<TextureGeometryProcessor::Instance*>(idata);
+            for (int i = 0; i < fDraws.count(); ++i) {
+                write_instance(fDraws[i].fQuad, fDraws[i].fSrcRect, fDraws[i].fColor, origin,
+                               instances + i, iw, ih);
+            }
+        } else {
+            SkASSERT(gp->getInstanceStride() ==
+                     sizeof(TextureGeometryProcessor::MultiTextureInstance));
+            float iw[kMaxTextures];
+            float ih[kMaxTextures];
+            for (int t = 0; t < fProxyCnt; ++t) {
+                GrTexture* texture = proxies[t]->priv().peekTexture();
+                iw[t] = 1.f / texture->width();
+                ih[t] = 1.f / texture->height();
+            }
+            auto instances = static_cast<TextureGeometryProcessor::MultiTextureInstance*>(idata);
+            for (int i = 0; i < fDraws.count(); ++i) {
+                auto tidx = fDraws[i].fTextureIdx;
+                write_instance(fDraws[i].fQuad, fDraws[i].fSrcRect, fDraws[i].fColor,
+                               proxies[tidx]->origin(), instances + i, iw[tidx], ih[tidx]);
+                instances[i].fTextureIdx = tidx;
+            }
+        }
+        GrMesh mesh(GrPrimitiveType::kTriangleStrip);
+        mesh.setInstanced(ibuffer, fDraws.count(), istart, 4);
+        mesh.setVertexData(cornerBuffer);
+        target->draw(gp, pipeline, mesh);
+    }
+
     bool onCombineIfPossible(GrOp* t, const GrCaps& caps) override {
         const auto* that = t->cast<TextureOp>();
         const auto& shaderCaps = *caps.shaderCaps();
@@ -708,7 +867,11 @@ __attribute__((no_sanitize("float-cast-overflow")))
             }
             fDraws.push_back_n(that->fDraws.count(), that->fDraws.begin());
         }
+        if (!fImageAtlas) {
+            fImageAtlas = that->fImageAtlas;
+        }
         this->joinBounds(*that);
+        fQuadsAreRects = fQuadsAreRects && that->fQuadsAreRects;
         fMaxApproxDstPixelArea = SkTMax(that->fMaxApproxDstPixelArea, fMaxApproxDstPixelArea);
         return true;
     }
@@ -790,6 +953,8 @@ __attribute__((no_sanitize("float-cast-overflow")))
     };
     SkSTArray<1, Draw, true> fDraws;
     sk_sp<GrColorSpaceXform> fColorSpaceXform;
+    // Set when one of the textures is an image atlas page whose pixels may still need uploading.
+    GrImageAtlas* fImageAtlas;
     // Initially we store a single proxy ptr and a single filter. If we grow to have more than
     // one proxy we instead store pointers to dynamically allocated arrays of size kMaxTextures
     // followed by kMaxTextures filters.
@@ -804,6 +969,9 @@ __attribute__((no_sanitize("float-cast-overflow")))
     // Used to track whether fProxy is ref'ed or has a pending IO after finalize() is called.
     unsigned fFinalized : 1;
     unsigned fAllowSRGBInputs : 1;
+    // Set when every draw's quad is a device space rect in tri-strip order, allowing the op to
+    // draw them as instances of a unit quad.
+    unsigned fQuadsAreRects : 1;
 
     typedef GrMeshDrawOp INHERITED;
 };
@@ -818,10 +986,11 @@ namespace GrTextureOp {
 std::unique_ptr<GrDrawOp> Make(sk_sp<GrTextureProxy> proxy, GrSamplerState::Filter filter,
                                GrColor color, const SkRect& srcRect, const SkRect& dstRect,
                                GrAAType aaType, const SkMatrix& viewMatrix,
-                               sk_sp<GrColorSpaceXform> csxf, bool allowSRGBInputs) {
+                               sk_sp<GrColorSpaceXform> csxf, bool allowSRGBInputs,
+                               GrImageAtlas* imageAtlas) {
     SkASSERT(!viewMatrix.hasPerspective());
     return TextureOp::Make(std::move(proxy), filter, color, srcRect, dstRect, aaType, viewMatrix,
-                           std::move(csxf), allowSRGBInputs);
+                           std::move(csxf), allowSRGBInputs, imageAtlas);
 }
 
 }  // namespace GrTextureOp
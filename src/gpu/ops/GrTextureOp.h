@@ -12,6 +12,7 @@
 
 class GrColorSpaceXform;
 class GrDrawOp;
+class GrImageAtlas;
 class GrTextureProxy;
 struct SkRect;
 class SkMatrix;
@@ -21,10 +22,11 @@ namespace GrTextureOp {
  * Creates an op that draws a sub-rectangle of a texture. The passed color is modulated by the
  * texture's color. 'srcRect' specifies the rectangle of the texture to draw. 'dstRect' specifies
  * the rectangle to draw in local coords which will be transformed by 'viewMatrix' to be in device
- * space. 'viewMatrix' must be affine.
+ * space. 'viewMatrix' must be affine. If the texture is a page of 'imageAtlas' the op schedules
+ * the atlas's pending uploads when it is prepared.
  */
 std::unique_ptr<GrDrawOp> Make(sk_sp<GrTextureProxy>, GrSamplerState::Filter, GrColor,
                                const SkRect& srcRect, const SkRect& dstRect, GrAAType,
                                const SkMatrix& viewMatrix, sk_sp<GrColorSpaceXform>,
-                               bool allowSRGBInputs);
+                               bool allowSRGBInputs, GrImageAtlas* imageAtlas = nullptr);
 }
@@ -38,8 +38,10 @@ void GrAtlasManager::ComputeAtlasLimits(const GrCaps* caps, float maxTextureByte
 
 GrAtlasManager::GrAtlasManager(GrProxyProvider* proxyProvider, GrGlyphCache* glyphCache,
                                float maxTextureBytes,
-                               GrDrawOpAtlas::AllowMultitexturing allowMultitexturing)
+                               GrDrawOpAtlas::AllowMultitexturing allowMultitexturing,
+                               bool packByLifetime)
             : fAllowMultitexturing(allowMultitexturing)
+            , fPackByLifetime(packByLifetime)
             , fProxyProvider(proxyProvider)
             , fGlyphCache(glyphCache) {
     fCaps = fProxyProvider->refCaps();
@@ -102,10 +104,11 @@ GrDrawOpAtlas::ErrorCode GrAtlasManager::addToAtlas(
                                 GrGlyphCache* glyphCache,
                                 GrTextStrike* strike, GrDrawOpAtlas::AtlasID* id,
                                 GrDeferredUploadTarget* target, GrMaskFormat format,
-                                int width, int height, const void* image, SkIPoint16* loc) {
+                                int width, int height, const void* image, SkIPoint16* loc,
+                                GrDrawOpAtlas::Lifetime lifetime) {
     glyphCache->setStrikeToPreserve(strike);
     return this->getAtlas(format)->addToAtlas(resourceProvider, id, target, width, height,
-                                              image, loc);
+                                              image, loc, lifetime);
 }
 
 void GrAtlasManager::addGlyphToBulkAndSetUseToken(GrDrawOpAtlas::BulkUseTokenUpdater* updater,
@@ -221,6 +224,7 @@ bool GrAtlasManager::initAtlas(GrMaskFormat format) {
         if (!fAtlases[index]) {
             return false;
         }
+        fAtlases[index]->setPackByLifetime(fPackByLifetime);
     }
     return true;
 }
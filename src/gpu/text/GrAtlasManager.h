@@ -25,7 +25,8 @@ struct GrGlyph;
 class GrAtlasManager : public GrOnFlushCallbackObject {
 public:
     GrAtlasManager(GrProxyProvider*, GrGlyphCache*,
-                   float maxTextureBytes, GrDrawOpAtlas::AllowMultitexturing);
+                   float maxTextureBytes, GrDrawOpAtlas::AllowMultitexturing,
+                   bool packByLifetime = false);
     ~GrAtlasManager() override;
 
     // if getProxies returns nullptr, the client must not try to use other functions on the
@@ -67,7 +68,8 @@ public:
     GrDrawOpAtlas::ErrorCode addToAtlas(
                     GrResourceProvider*, GrGlyphCache*, GrTextStrike*,
                     GrDrawOpAtlas::AtlasID*, GrDeferredUploadTarget*, GrMaskFormat,
-                    int width, int height, const void* image, SkIPoint16* loc);
+                    int width, int height, const void* image, SkIPoint16* loc,
+                    GrDrawOpAtlas::Lifetime = GrDrawOpAtlas::Lifetime::kShort);
 
     // Some clients may wish to verify the integrity of the texture backing store of the
     // GrDrawOpAtlas. The atlasGeneration returned below is a monotonically increasing number which
@@ -76,6 +78,14 @@ public:
         return this->getAtlas(format)->atlasGeneration();
     }
 
+    // How much the atlas for this format changed during the last flush. Text that thrashes the
+    // atlas shows up as evictions and re-uploaded bytes in every flush.
+    GrDrawOpAtlas::FlushStats lastFlushStats(GrMaskFormat format) const {
+        int atlasIndex = MaskFormatToAtlasIndex(format);
+        return fAtlases[atlasIndex] ? fAtlases[atlasIndex]->lastFlushStats()
+                                    : GrDrawOpAtlas::FlushStats();
+    }
+
     // GrOnFlushCallbackObject overrides
 
     void preFlush(GrOnFlushResourceProvider* onFlushResourceProvider, const uint32_t*, int,
@@ -133,6 +143,7 @@ private:
 
     sk_sp<const GrCaps> fCaps;
     GrDrawOpAtlas::AllowMultitexturing fAllowMultitexturing;
+    bool fPackByLifetime;
     std::unique_ptr<GrDrawOpAtlas> fAtlases[kMaskFormatCount];
     GrDrawOpAtlasConfig fAtlasConfigs[kMaskFormatCount];
     SkScalar fGlyphSizeLimit;
@@ -8,6 +8,7 @@
 #ifndef GrAtlasTextBlob_DEFINED
 #define GrAtlasTextBlob_DEFINED
 
+#include "GrBuffer.h"
 #include "GrColor.h"
 #include "GrDrawOpAtlas.h"
 #include "GrGlyphCache.h"
@@ -130,6 +131,18 @@ public:
 
     int runCount() const { return fRunCount; }
 
+    size_t size() const { return fSize; }
+
+    // Number of times the blob was reused from the text blob cache, decayed by the cache as it
+    // ages the blob.
+    int useCount() const { return fUseCount; }
+    void noteUse() {
+        if (fUseCount < SK_MaxS32) {
+            ++fUseCount;
+        }
+    }
+    void ageUseCount() { fUseCount >>= 1; }
+
     void push_back_run(int currRun) {
         SkASSERT(currRun < fRunCount);
         if (currRun > 0) {
@@ -284,7 +297,8 @@ public:
 
 private:
     GrAtlasTextBlob()
-        : fMaxMinScale(-SK_ScalarMax)
+        : fUseCount(0)
+        , fMaxMinScale(-SK_ScalarMax)
         , fMinMaxScale(SK_ScalarMax)
         , fTextType(0) {}
 
@@ -343,6 +357,7 @@ private:
                     , fVertexEndIndex(0)
                     , fGlyphStartIndex(0)
                     , fGlyphEndIndex(0)
+                    , fGpuTranslation(SkVector::Make(0, 0))
                     , fColor(GrColor_ILLEGAL)
                     , fMaskFormat(kA8_GrMaskFormat)
                     , fFlags(0) {
@@ -360,6 +375,8 @@ private:
                 , fGlyphEndIndex(that.fGlyphEndIndex)
                 , fX(that.fX)
                 , fY(that.fY)
+                , fGpuTranslation(that.fGpuTranslation)
+                , fVertexBuffer(that.fVertexBuffer)
                 , fColor(that.fColor)
                 , fMaskFormat(that.fMaskFormat)
                 , fFlags(that.fFlags) {
@@ -417,6 +434,18 @@ private:
             void computeTranslation(const SkMatrix& viewMatrix, SkScalar x, SkScalar y,
                                     SkScalar* transX, SkScalar* transY);
 
+            // When vertex buffers are reused, position changes that are pure translations are not
+            // applied to the blob's vertices. They accumulate here and are added on the GPU instead.
+            void addGpuTranslation(SkScalar transX, SkScalar transY) {
+                fGpuTranslation.offset(transX, transY);
+            }
+            const SkVector& gpuTranslation() const { return fGpuTranslation; }
+            void resetGpuTranslation() { fGpuTranslation.set(0, 0); }
+
+            // A GPU copy of this sub run's vertices, valid until the vertices are regenerated.
+            void setVertexBuffer(sk_sp<const GrBuffer> buffer) { fVertexBuffer = std::move(buffer); }
+            const GrBuffer* vertexBuffer() const { return fVertexBuffer.get(); }
+
             // df properties
             void setDrawAsDistanceFields() { fFlags |= kDrawAsSDF_Flag; }
             bool drawAsDistanceFields() const { return SkToBool(fFlags & kDrawAsSDF_Flag); }
@@ -458,6 +487,8 @@ private:
             uint32_t fGlyphEndIndex;
             SkScalar fX;
             SkScalar fY;
+            SkVector fGpuTranslation;
+            sk_sp<const GrBuffer> fVertexBuffer;
             GrColor fColor;
             GrMaskFormat fMaskFormat;
             uint32_t fFlags;
@@ -543,6 +574,7 @@ private:
     SkColor fLuminanceColor;
     SkScalar fInitialX;
     SkScalar fInitialY;
+    int fUseCount;
 
     // We can reuse distance field text, but only if the new viewmatrix would not result in
     // a mip change.  Because there can be multiple runs in a blob, we track the overall
@@ -567,11 +599,15 @@ public:
      * Consecutive VertexRegenerators often use the same SkGlyphCache. If the same instance of
      * SkAutoGlyphCache is reused then it can save the cost of multiple detach/attach operations of
      * SkGlyphCache.
+     *
+     * If translateOnGpu is true a pure translation of the sub run is not applied to its vertices.
+     * It is accumulated in the sub run's gpuTranslation() instead, which the caller must add to the
+     * vertex positions when drawing.
      */
     VertexRegenerator(GrResourceProvider*, GrAtlasTextBlob*, int runIdx, int subRunIdx,
                       const SkMatrix& viewMatrix, SkScalar x, SkScalar y, GrColor color,
                       GrDeferredUploadTarget*, GrGlyphCache*, GrAtlasManager*,
-                      SkExclusiveStrikePtr*);
+                      SkExclusiveStrikePtr*, bool translateOnGpu = false);
 
     struct Result {
         /**
@@ -594,6 +630,20 @@ public:
 
     bool regenerate(Result*);
 
+    int glyphCount() const { return fSubRun->glyphCount(); }
+
+    /** The translation the caller must add to the sub run's vertices when translateOnGpu is set. */
+    const SkVector& gpuTranslation() const { return fSubRun->gpuTranslation(); }
+
+    /**
+     * A GPU copy of the sub run's vertices that the caller may keep with the blob. It is dropped
+     * whenever regenerate() changes the vertices.
+     */
+    const GrBuffer* vertexBuffer() const { return fSubRun->vertexBuffer(); }
+    void setVertexBuffer(sk_sp<const GrBuffer> buffer) {
+        fSubRun->setVertexBuffer(std::move(buffer));
+    }
+
 private:
     template <bool regenPos, bool regenCol, bool regenTexCoords, bool regenGlyphs>
     bool doRegen(Result*);
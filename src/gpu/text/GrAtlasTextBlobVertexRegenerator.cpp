@@ -195,7 +195,8 @@ Regenerator::VertexRegenerator(GrResourceProvider* resourceProvider, GrAtlasText
                                int runIdx, int subRunIdx,
                                const SkMatrix& viewMatrix, SkScalar x, SkScalar y, GrColor color,
                                GrDeferredUploadTarget* uploadTarget, GrGlyphCache* glyphCache,
-                               GrAtlasManager* fullAtlasManager, SkExclusiveStrikePtr* lazyCache)
+                               GrAtlasManager* fullAtlasManager, SkExclusiveStrikePtr* lazyCache,
+                               bool translateOnGpu)
         : fResourceProvider(resourceProvider)
         , fViewMatrix(viewMatrix)
         , fBlob(blob)
@@ -208,6 +209,15 @@ Regenerator::VertexRegenerator(GrResourceProvider* resourceProvider, GrAtlasText
         , fColor(color) {
     // Compute translation if any
     fSubRun->computeTranslation(fViewMatrix, x, y, &fTransX, &fTransY);
+    if (translateOnGpu) {
+        fSubRun->addGpuTranslation(fTransX, fTransY);
+        fTransX = fTransY = 0;
+    } else {
+        // Fold in any translation a previous draw left to the GPU.
+        fTransX += fSubRun->gpuTranslation().fX;
+        fTransY += fSubRun->gpuTranslation().fY;
+        fSubRun->resetGpuTranslation();
+    }
 
     // Because the GrGlyphCache may evict the strike a blob depends on using for
     // generating its texture coords, we have to track whether or not the strike has
@@ -232,6 +242,8 @@ Regenerator::VertexRegenerator(GrResourceProvider* resourceProvider, GrAtlasText
 template <bool regenPos, bool regenCol, bool regenTexCoords, bool regenGlyphs>
 bool Regenerator::doRegen(Regenerator::Result* result) {
     static_assert(!regenGlyphs || regenTexCoords, "must regenTexCoords along regenGlyphs");
+    // The blob's vertices are about to change so any GPU copy of them is stale.
+    fSubRun->setVertexBuffer(nullptr);
     sk_sp<GrTextStrike> strike;
     if (regenTexCoords) {
         fSubRun->resetBulkUseToken();
@@ -262,12 +262,15 @@ GrDrawOpAtlas::ErrorCode GrTextStrike::addGlyphToAtlas(
         return GrDrawOpAtlas::ErrorCode::kError;
     }
 
+    GrDrawOpAtlas::Lifetime lifetime = glyph->fWasAtlased ? GrDrawOpAtlas::Lifetime::kLong
+                                                          : GrDrawOpAtlas::Lifetime::kShort;
     GrDrawOpAtlas::ErrorCode result = fullAtlasManager->addToAtlas(
                                                 resourceProvider, glyphCache, this,
                                                 &glyph->fID, target, expectedMaskFormat,
                                                 width, height,
-                                                storage.get(), &glyph->fAtlasLocation);
+                                                storage.get(), &glyph->fAtlasLocation, lifetime);
     if (GrDrawOpAtlas::ErrorCode::kSucceeded == result) {
+        glyph->fWasAtlased = true;
         if (addPad) {
             glyph->fAtlasLocation.fX += 1;
             glyph->fAtlasLocation.fY += 1;
@@ -7,6 +7,8 @@
 
 #include "GrTextBlobCache.h"
 
+#include "SkTraceMemoryDump.h"
+
 DECLARE_SKMESSAGEBUS_MESSAGE(GrTextBlobCache::PurgeBlobMessage)
 
 GrTextBlobCache::~GrTextBlobCache() {
@@ -17,7 +19,7 @@ GrTextBlobCache::~GrTextBlobCache() {
 void GrTextBlobCache::freeAll() {
     fBlobIDCache.foreach([this](uint32_t, BlobIDCacheEntry* entry) {
         for (const auto& blob : entry->fBlobs) {
-            fBlobList.remove(blob.get());
+            this->removeFromList(blob.get());
         }
     });
 
@@ -46,7 +48,9 @@ void GrTextBlobCache::purgeStaleBlobs() {
 
         // remove all blob entries from the LRU list
         for (const auto& blob : idEntry->fBlobs) {
-            fBlobList.remove(blob.get());
+            fFlushStats.fStalePurges++;
+            fFlushStats.fPurgedBytes += blob->size();
+            this->removeFromList(blob.get());
         }
 
         // drop the idEntry itself (unrefs all blobs)
@@ -64,12 +68,31 @@ bool GrTextBlobCache::overBudget() const {
     return false;
 }
 
+// How often a blob must have been redrawn to survive when it reaches the tail of the LRU list.
+// Large blobs must earn their place, so a blob that is redrawn every frame is kept over a large
+// one that was drawn once.
+static int min_uses_to_keep(GrTextBlobCache::SizeClass sizeClass) {
+    switch (sizeClass) {
+        case GrTextBlobCache::kSmall_SizeClass:  return 1;
+        case GrTextBlobCache::kMedium_SizeClass: return 2;
+        case GrTextBlobCache::kLarge_SizeClass:  return 4;
+    }
+    SK_ABORT("Unexpected size class");
+    return 1;
+}
+
 void GrTextBlobCache::checkPurge(GrAtlasTextBlob* blob) {
     // First, purge all stale blob IDs.
     this->purgeStaleBlobs();
 
     // If we are still over budget, then unref until we are below budget again
     if (this->overBudget()) {
+        // Every blob can be spared at most about once per purge so that this terminates.
+        int secondChances = 0;
+        for (const auto& stats : fSizeClassStats) {
+            secondChances += stats.fBlobCount;
+        }
+
         BitmapBlobList::Iter iter;
         iter.init(fBlobList, BitmapBlobList::Iter::kTail_IterStart);
         GrAtlasTextBlob* lruBlob = nullptr;
@@ -77,6 +100,19 @@ void GrTextBlobCache::checkPurge(GrAtlasTextBlob* blob) {
             // Backup the iterator before removing and unrefing the blob
             iter.prev();
 
+            if (secondChances > 0 &&
+                lruBlob->useCount() >= min_uses_to_keep(ClassifySize(lruBlob->size()))) {
+                // Frequently used blobs move back to the head with their use count decayed, so
+                // they are only kept while they stay in use.
+                --secondChances;
+                lruBlob->ageUseCount();
+                fBlobList.remove(lruBlob);
+                fBlobList.addToHead(lruBlob);
+                continue;
+            }
+
+            fFlushStats.fBudgetPurges++;
+            fFlushStats.fPurgedBytes += lruBlob->size();
             this->remove(lruBlob);
         }
 
@@ -95,5 +131,39 @@ void GrTextBlobCache::checkPurge(GrAtlasTextBlob* blob) {
     }
 }
 
+void GrTextBlobCache::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
+    static const char* kDumpName = "skia/gr_text_blob_cache";
+    static const char* kSizeClassDumpNames[kSizeClassCount] = {
+        "skia/gr_text_blob_cache/small",
+        "skia/gr_text_blob_cache/medium",
+        "skia/gr_text_blob_cache/large",
+    };
+
+    size_t totalBytes = 0;
+    int totalBlobs = 0;
+    for (int i = 0; i < kSizeClassCount; ++i) {
+        const SizeClassStats& stats = fSizeClassStats[i];
+        totalBytes += stats.fBytes;
+        totalBlobs += stats.fBlobCount;
+        if (SkTraceMemoryDump::kLight_LevelOfDetail != traceMemoryDump->getRequestedDetails()) {
+            traceMemoryDump->dumpNumericValue(kSizeClassDumpNames[i], "size", "bytes",
+                                              stats.fBytes);
+            traceMemoryDump->dumpNumericValue(kSizeClassDumpNames[i], "blob_count", "objects",
+                                              stats.fBlobCount);
+        }
+    }
 
-
+    traceMemoryDump->dumpNumericValue(kDumpName, "size", "bytes", totalBytes);
+    traceMemoryDump->dumpNumericValue(kDumpName, "budget", "bytes", fBudget);
+    traceMemoryDump->dumpNumericValue(kDumpName, "blob_count", "objects", totalBlobs);
+    traceMemoryDump->dumpNumericValue(kDumpName, "last_flush_hits", "objects",
+                                      fLastFlushStats.fHits);
+    traceMemoryDump->dumpNumericValue(kDumpName, "last_flush_misses", "objects",
+                                      fLastFlushStats.fMisses);
+    traceMemoryDump->dumpNumericValue(kDumpName, "last_flush_budget_purges", "objects",
+                                      fLastFlushStats.fBudgetPurges);
+    traceMemoryDump->dumpNumericValue(kDumpName, "last_flush_stale_purges", "objects",
+                                      fLastFlushStats.fStalePurges);
+    traceMemoryDump->dumpNumericValue(kDumpName, "last_flush_purged_size", "bytes",
+                                      fLastFlushStats.fPurgedBytes);
+}
@@ -15,6 +15,8 @@
 #include "SkTextBlobRunIterator.h"
 #include "SkTHash.h"
 
+class SkTraceMemoryDump;
+
 class GrTextBlobCache {
 public:
     /**
@@ -52,6 +54,7 @@ public:
                                           const SkPaint& paint) {
         sk_sp<GrAtlasTextBlob> cacheBlob(this->makeBlob(blob));
         cacheBlob->setupKey(key, blurRec, paint);
+        fFlushStats.fMisses++;
         this->add(cacheBlob);
         blob->notifyAddedToCache(fUniqueID);
         return cacheBlob;
@@ -67,7 +70,7 @@ public:
         auto* idEntry = fBlobIDCache.find(id);
         SkASSERT(idEntry);
 
-        fBlobList.remove(blob);
+        this->removeFromList(blob);
         idEntry->removeBlob(blob);
         if (idEntry->fBlobs.empty()) {
             fBlobIDCache.remove(id);
@@ -75,6 +78,8 @@ public:
     }
 
     void makeMRU(GrAtlasTextBlob* blob) {
+        fFlushStats.fHits++;
+        blob->noteUse();
         if (fBlobList.head() == blob) {
             return;
         }
@@ -106,6 +111,54 @@ public:
 
     void purgeStaleBlobs();
 
+    /**
+     * Blobs are accounted in size classes so that the dump shows whether the budget goes to many
+     * small blobs or a few large ones.
+     */
+    enum SizeClass {
+        kSmall_SizeClass,   // < 4KB
+        kMedium_SizeClass,  // < 64KB
+        kLarge_SizeClass,
+        kLast_SizeClass = kLarge_SizeClass
+    };
+    static const int kSizeClassCount = kLast_SizeClass + 1;
+
+    static SizeClass ClassifySize(size_t size) {
+        if (size < (1 << 12)) {
+            return kSmall_SizeClass;
+        }
+        return size < (1 << 16) ? kMedium_SizeClass : kLarge_SizeClass;
+    }
+
+    struct SizeClassStats {
+        int    fBlobCount = 0;
+        size_t fBytes = 0;
+    };
+
+    const SizeClassStats& sizeClassStats(SizeClass sizeClass) const {
+        return fSizeClassStats[sizeClass];
+    }
+
+    /** Counts of cache activity between two flushes. */
+    struct FlushStats {
+        int fHits = 0;          // cached blobs that were drawn again
+        int fMisses = 0;        // blobs that had to be (re)generated and were added to the cache
+        int fBudgetPurges = 0;  // blobs purged to stay within the budget
+        int fStalePurges = 0;   // blobs purged because their SkTextBlob was deleted
+        size_t fPurgedBytes = 0;
+    };
+
+    /** The counters of the most recently completed flush. */
+    const FlushStats& lastFlushStats() const { return fLastFlushStats; }
+
+    /** Called at the end of every flush to start counting for the next one. */
+    void didFlush() {
+        fLastFlushStats = fFlushStats;
+        fFlushStats = FlushStats();
+    }
+
+    void dumpMemoryStatistics(SkTraceMemoryDump*) const;
+
 private:
     using BitmapBlobList = SkTInternalLList<GrAtlasTextBlob>;
 
@@ -165,11 +218,22 @@ private:
         // Safe to retain a raw ptr temporarily here, because the cache will hold a ref.
         GrAtlasTextBlob* rawBlobPtr = blob.get();
         fBlobList.addToHead(rawBlobPtr);
+        SizeClassStats& stats = fSizeClassStats[ClassifySize(rawBlobPtr->size())];
+        stats.fBlobCount++;
+        stats.fBytes += rawBlobPtr->size();
         idEntry->addBlob(std::move(blob));
 
         this->checkPurge(rawBlobPtr);
     }
 
+    void removeFromList(GrAtlasTextBlob* blob) {
+        fBlobList.remove(blob);
+        SizeClassStats& stats = fSizeClassStats[ClassifySize(blob->size())];
+        SkASSERT(stats.fBlobCount > 0 && stats.fBytes >= blob->size());
+        stats.fBlobCount--;
+        stats.fBytes -= blob->size();
+    }
+
     void checkPurge(GrAtlasTextBlob* blob = nullptr);
     bool overBudget() const;
 
@@ -183,6 +247,9 @@ private:
     size_t fBudget;
     uint32_t fUniqueID;      // unique id to use for messaging
     SkMessageBus<PurgeBlobMessage>::Inbox fPurgeBlobInbox;
+    SizeClassStats fSizeClassStats[kSizeClassCount];
+    FlushStats fFlushStats;
+    FlushStats fLastFlushStats;
 };
 
 #endif
@@ -20,8 +20,100 @@
 #include "GrVkTransferBuffer.h"
 #include "GrVkUtil.h"
 #include "GrVkVertexBuffer.h"
+#include "SkArenaAlloc.h"
 #include "SkRect.h"
 
+// The commands a deferred command buffer has been given since it began. Each one is a functor that
+// encodes the command, kept (along with copies of any arrays it points at) in an arena that is
+// emptied once the commands have been encoded.
+class GrVkCommandBuffer::DeferredCommands {
+public:
+    DeferredCommands() : fArena(kArenaSize), fHead(nullptr), fTail(&fHead) {}
+
+    template <typename Fn> void add(Fn&& fn) {
+        using FnType = typename std::decay<Fn>::type;
+        static_assert(std::is_trivially_destructible<FnType>::value,
+                      "Deferred commands are never destroyed.");
+        CommandImpl<FnType>* command = fArena.make<CommandImpl<FnType>>(std::forward<Fn>(fn));
+        *fTail = command;
+        fTail = &command->fNext;
+    }
+
+    template <typename T> const T* copy(const T* src, uint32_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "");
+        T* dst = fArena.makeArrayDefault<T>(count);
+        memcpy(dst, src, count * sizeof(T));
+        return dst;
+    }
+
+    void encode(const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+        for (const Command* command = fHead; command; command = command->fNext) {
+            command->fEncode(command, vkInterface, cmdBuffer);
+        }
+        this->reset();
+    }
+
+    void reset() {
+        fArena.reset();
+        fHead = nullptr;
+        fTail = &fHead;
+    }
+
+private:
+    static constexpr size_t kArenaSize = 4096;
+
+    struct Command {
+        using EncodeProc = void (*)(const Command*, const GrVkInterface*, VkCommandBuffer);
+
+        explicit Command(EncodeProc encode) : fEncode(encode), fNext(nullptr) {}
+
+        EncodeProc fEncode;
+        Command*   fNext;
+    };
+
+    template <typename Fn> struct CommandImpl : public Command {
+        explicit CommandImpl(Fn fn) : Command(Encode), fFn(std::move(fn)) {}
+
+        static void Encode(const Command* command, const GrVkInterface* vkInterface,
+                           VkCommandBuffer cmdBuffer) {
+            static_cast<const CommandImpl*>(command)->fFn(vkInterface, cmdBuffer);
+        }
+
+        Fn fFn;
+    };
+
+    SkArenaAlloc fArena;
+    Command*     fHead;
+    Command**    fTail;
+};
+
+template <typename Fn> void GrVkCommandBuffer::record(const GrVkGpu* gpu, Fn&& fn) const {
+    if (fDeferredCommands) {
+        fDeferredCommands->add(std::forward<Fn>(fn));
+    } else {
+        fn(gpu->vkInterface(), fCmdBuffer);
+    }
+}
+
+template <typename T>
+const T* GrVkCommandBuffer::copyIfDeferred(const T* src, uint32_t count) const {
+    return fDeferredCommands ? fDeferredCommands->copy(src, count) : src;
+}
+
+GrVkCommandBuffer::GrVkCommandBuffer(VkCommandBuffer cmdBuffer, VkCommandPool cmdPool,
+                                     const GrVkRenderPass* rp)
+        : fIsActive(false)
+        , fActiveRenderPass(rp)
+        , fCmdBuffer(cmdBuffer)
+        , fCmdPool(cmdPool)
+        , fNumResets(0) {
+    fTrackedResources.setReserve(kInitialTrackedResourcesCount);
+    fTrackedRecycledResources.setReserve(kInitialTrackedResourcesCount);
+    this->invalidateState();
+}
+
+GrVkCommandBuffer::~GrVkCommandBuffer() {}
+
 void GrVkCommandBuffer::invalidateState() {
     for (auto& boundInputBuffer : fBoundInputBuffers) {
         boundInputBuffer = VK_NULL_HANDLE;
@@ -49,8 +141,7 @@ void GrVkCommandBuffer::freeGPUData(const GrVkGpu* gpu) const {
         fTrackedRecycledResources[i]->recycle(const_cast<GrVkGpu*>(gpu));
     }
 
-    GR_VK_CALL(gpu->vkInterface(), FreeCommandBuffers(gpu->device(), gpu->cmdPool(),
-                                                      1, &fCmdBuffer));
+    GR_VK_CALL(gpu->vkInterface(), FreeCommandBuffers(gpu->device(), fCmdPool, 1, &fCmdBuffer));
 
     this->onFreeGPUData(gpu);
 }
@@ -88,6 +179,10 @@ void GrVkCommandBuffer::reset(GrVkGpu* gpu) {
 
 
     this->invalidateState();
+    if (fDeferredCommands) {
+        // These would only be left if the command buffer ended without ever being encoded.
+        fDeferredCommands->reset();
+    }
 
     // we will retain resources for later use
     VkCommandBufferResetFlags flags = 0;
@@ -107,6 +202,8 @@ void GrVkCommandBuffer::pipelineBarrier(const GrVkGpu* gpu,
                                         BarrierType barrierType,
                                         void* barrier) const {
     SkASSERT(fIsActive);
+    // Only the primary command buffer, which is never deferred, has barriers.
+    SkASSERT(!fDeferredCommands);
     // For images we can have barriers inside of render passes but they require us to add more
     // support in subpasses which need self dependencies to have barriers inside them. Also, we can
     // never have buffer barriers inside of a render pass. For now we will just assert that we are
@@ -159,11 +256,10 @@ void GrVkCommandBuffer::bindInputBuffer(GrVkGpu* gpu, uint32_t binding,
     // to know if we can skip binding or not.
     if (vkBuffer != fBoundInputBuffers[binding]) {
         VkDeviceSize offset = vbuffer->offset();
-        GR_VK_CALL(gpu->vkInterface(), CmdBindVertexBuffers(fCmdBuffer,
-                                                            binding,
-                                                            1,
-                                                            &vkBuffer,
-                                                            &offset));
+        this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+            GR_VK_CALL(vkInterface, CmdBindVertexBuffers(cmdBuffer, binding, 1, &vkBuffer,
+                                                         &offset));
+        });
         fBoundInputBuffers[binding] = vkBuffer;
         addResource(vbuffer->resource());
     }
@@ -175,10 +271,11 @@ void GrVkCommandBuffer::bindIndexBuffer(GrVkGpu* gpu, const GrVkIndexBuffer* ibu
     // TODO: once ibuffer->offset() no longer always returns 0, we will need to track the offset
     // to know if we can skip binding or not.
     if (vkBuffer != fBoundIndexBuffer) {
-        GR_VK_CALL(gpu->vkInterface(), CmdBindIndexBuffer(fCmdBuffer,
-                                                          vkBuffer,
-                                                          ibuffer->offset(),
-                                                          VK_INDEX_TYPE_UINT16));
+        VkDeviceSize offset = ibuffer->offset();
+        this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+            GR_VK_CALL(vkInterface, CmdBindIndexBuffer(cmdBuffer, vkBuffer, offset,
+                                                       VK_INDEX_TYPE_UINT16));
+        });
         fBoundIndexBuffer = vkBuffer;
         addResource(ibuffer->resource());
     }
@@ -202,11 +299,36 @@ void GrVkCommandBuffer::clearAttachments(const GrVkGpu* gpu,
         }
     }
 #endif
-    GR_VK_CALL(gpu->vkInterface(), CmdClearAttachments(fCmdBuffer,
-                                                       numAttachments,
-                                                       attachments,
-                                                       numRects,
-                                                       clearRects));
+    attachments = this->copyIfDeferred(attachments, numAttachments);
+    clearRects = this->copyIfDeferred(clearRects, numRects);
+    this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+        GR_VK_CALL(vkInterface, CmdClearAttachments(cmdBuffer,
+                                                    numAttachments,
+                                                    attachments,
+                                                    numRects,
+                                                    clearRects));
+    });
+}
+
+void GrVkCommandBuffer::recordBindDescriptorSets(const GrVkGpu* gpu,
+                                                 VkPipelineLayout layout,
+                                                 uint32_t firstSet,
+                                                 uint32_t setCount,
+                                                 const VkDescriptorSet* descriptorSets,
+                                                 uint32_t dynamicOffsetCount,
+                                                 const uint32_t* dynamicOffsets) {
+    descriptorSets = this->copyIfDeferred(descriptorSets, setCount);
+    dynamicOffsets = this->copyIfDeferred(dynamicOffsets, dynamicOffsetCount);
+    this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+        GR_VK_CALL(vkInterface, CmdBindDescriptorSets(cmdBuffer,
+                                                      VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                      layout,
+                                                      firstSet,
+                                                      setCount,
+                                                      descriptorSets,
+                                                      dynamicOffsetCount,
+                                                      dynamicOffsets));
+    });
 }
 
 void GrVkCommandBuffer::bindDescriptorSets(const GrVkGpu* gpu,
@@ -218,14 +340,8 @@ void GrVkCommandBuffer::bindDescriptorSets(const GrVkGpu* gpu,
                                            uint32_t dynamicOffsetCount,
                                            const uint32_t* dynamicOffsets) {
     SkASSERT(fIsActive);
-    GR_VK_CALL(gpu->vkInterface(), CmdBindDescriptorSets(fCmdBuffer,
-                                                         VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                         layout,
-                                                         firstSet,
-                                                         setCount,
-                                                         descriptorSets,
-                                                         dynamicOffsetCount,
-                                                         dynamicOffsets));
+    this->recordBindDescriptorSets(gpu, layout, firstSet, setCount, descriptorSets,
+                                   dynamicOffsetCount, dynamicOffsets);
     pipelineState->addUniformResources(*this);
 }
 
@@ -239,14 +355,8 @@ void GrVkCommandBuffer::bindDescriptorSets(const GrVkGpu* gpu,
                                            uint32_t dynamicOffsetCount,
                                            const uint32_t* dynamicOffsets) {
     SkASSERT(fIsActive);
-    GR_VK_CALL(gpu->vkInterface(), CmdBindDescriptorSets(fCmdBuffer,
-                                                         VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                         layout,
-                                                         firstSet,
-                                                         setCount,
-                                                         descriptorSets,
-                                                         dynamicOffsetCount,
-                                                         dynamicOffsets));
+    this->recordBindDescriptorSets(gpu, layout, firstSet, setCount, descriptorSets,
+                                   dynamicOffsetCount, dynamicOffsets);
     for (int i = 0; i < recycled.count(); ++i) {
         this->addRecycledResource(recycled[i]);
     }
@@ -257,9 +367,11 @@ void GrVkCommandBuffer::bindDescriptorSets(const GrVkGpu* gpu,
 
 void GrVkCommandBuffer::bindPipeline(const GrVkGpu* gpu, const GrVkPipeline* pipeline) {
     SkASSERT(fIsActive);
-    GR_VK_CALL(gpu->vkInterface(), CmdBindPipeline(fCmdBuffer,
-                                                   VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                   pipeline->pipeline()));
+    VkPipeline vkPipeline = pipeline->pipeline();
+    this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+        GR_VK_CALL(vkInterface, CmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                vkPipeline));
+    });
     this->addResource(pipeline);
 }
 
@@ -271,12 +383,14 @@ void GrVkCommandBuffer::drawIndexed(const GrVkGpu* gpu,
                                     uint32_t firstInstance) const {
     SkASSERT(fIsActive);
     SkASSERT(fActiveRenderPass);
-    GR_VK_CALL(gpu->vkInterface(), CmdDrawIndexed(fCmdBuffer,
-                                                  indexCount,
-                                                  instanceCount,
-                                                  firstIndex,
-                                                  vertexOffset,
-                                                  firstInstance));
+    this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+        GR_VK_CALL(vkInterface, CmdDrawIndexed(cmdBuffer,
+                                               indexCount,
+                                               instanceCount,
+                                               firstIndex,
+                                               vertexOffset,
+                                               firstInstance));
+    });
 }
 
 void GrVkCommandBuffer::draw(const GrVkGpu* gpu,
@@ -286,11 +400,13 @@ void GrVkCommandBuffer::draw(const GrVkGpu* gpu,
                              uint32_t firstInstance) const {
     SkASSERT(fIsActive);
     SkASSERT(fActiveRenderPass);
-    GR_VK_CALL(gpu->vkInterface(), CmdDraw(fCmdBuffer,
-                                           vertexCount,
-                                           instanceCount,
-                                           firstVertex,
-                                           firstInstance));
+    this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+        GR_VK_CALL(vkInterface, CmdDraw(cmdBuffer,
+                                        vertexCount,
+                                        instanceCount,
+                                        firstVertex,
+                                        firstInstance));
+    });
 }
 
 void GrVkCommandBuffer::setViewport(const GrVkGpu* gpu,
@@ -300,11 +416,14 @@ void GrVkCommandBuffer::setViewport(const GrVkGpu* gpu,
     SkASSERT(fIsActive);
     SkASSERT(1 == viewportCount);
     if (memcmp(viewports, &fCachedViewport, sizeof(VkViewport))) {
-        GR_VK_CALL(gpu->vkInterface(), CmdSetViewport(fCmdBuffer,
-                                                      firstViewport,
-                                                      viewportCount,
-                                                      viewports));
         fCachedViewport = viewports[0];
+        viewports = this->copyIfDeferred(viewports, viewportCount);
+        this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+            GR_VK_CALL(vkInterface, CmdSetViewport(cmdBuffer,
+                                                   firstViewport,
+                                                   viewportCount,
+                                                   viewports));
+        });
     }
 }
 
@@ -315,11 +434,14 @@ void GrVkCommandBuffer::setScissor(const GrVkGpu* gpu,
     SkASSERT(fIsActive);
     SkASSERT(1 == scissorCount);
     if (memcmp(scissors, &fCachedScissor, sizeof(VkRect2D))) {
-        GR_VK_CALL(gpu->vkInterface(), CmdSetScissor(fCmdBuffer,
-                                                     firstScissor,
-                                                     scissorCount,
-                                                     scissors));
         fCachedScissor = scissors[0];
+        scissors = this->copyIfDeferred(scissors, scissorCount);
+        this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+            GR_VK_CALL(vkInterface, CmdSetScissor(cmdBuffer,
+                                                  firstScissor,
+                                                  scissorCount,
+                                                  scissors));
+        });
     }
 }
 
@@ -327,8 +449,11 @@ void GrVkCommandBuffer::setBlendConstants(const GrVkGpu* gpu,
                                           const float blendConstants[4]) {
     SkASSERT(fIsActive);
     if (memcmp(blendConstants, fCachedBlendConstant, 4 * sizeof(float))) {
-        GR_VK_CALL(gpu->vkInterface(), CmdSetBlendConstants(fCmdBuffer, blendConstants));
         memcpy(fCachedBlendConstant, blendConstants, 4 * sizeof(float));
+        const float* constants = this->copyIfDeferred(blendConstants, 4);
+        this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+            GR_VK_CALL(vkInterface, CmdSetBlendConstants(cmdBuffer, constants));
+        });
     }
 }
 
@@ -357,7 +482,7 @@ GrVkPrimaryCommandBuffer* GrVkPrimaryCommandBuffer::Create(const GrVkGpu* gpu,
     if (err) {
         return nullptr;
     }
-    return new GrVkPrimaryCommandBuffer(cmdBuffer);
+    return new GrVkPrimaryCommandBuffer(cmdBuffer, cmdPool);
 }
 
 void GrVkPrimaryCommandBuffer::begin(const GrVkGpu* gpu) {
@@ -798,7 +923,38 @@ GrVkSecondaryCommandBuffer* GrVkSecondaryCommandBuffer::Create(const GrVkGpu* gp
     if (err) {
         return nullptr;
     }
-    return new GrVkSecondaryCommandBuffer(cmdBuffer);
+    return new GrVkSecondaryCommandBuffer(cmdBuffer, cmdPool);
+}
+
+GrVkSecondaryCommandBuffer* GrVkSecondaryCommandBuffer::CreateDeferred(const GrVkGpu* gpu) {
+    const VkCommandPoolCreateInfo cmdPoolInfo = {
+        VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,      // sType
+        nullptr,                                         // pNext
+        VK_COMMAND_POOL_CREATE_TRANSIENT_BIT |
+        VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, // CmdPoolCreateFlags
+        gpu->queueIndex(),                               // queueFamilyIndex
+    };
+    VkCommandPool cmdPool;
+    VkResult err = GR_VK_CALL(gpu->vkInterface(), CreateCommandPool(gpu->device(), &cmdPoolInfo,
+                                                                    nullptr, &cmdPool));
+    if (err) {
+        return nullptr;
+    }
+
+    GrVkSecondaryCommandBuffer* cmdBuffer = Create(gpu, cmdPool);
+    if (!cmdBuffer) {
+        GR_VK_CALL(gpu->vkInterface(), DestroyCommandPool(gpu->device(), cmdPool, nullptr));
+        return nullptr;
+    }
+    cmdBuffer->fOwnsCmdPool = true;
+    cmdBuffer->fDeferredCommands.reset(new DeferredCommands);
+    return cmdBuffer;
+}
+
+void GrVkSecondaryCommandBuffer::onFreeGPUData(const GrVkGpu* gpu) const {
+    if (fOwnsCmdPool) {
+        GR_VK_CALL(gpu->vkInterface(), DestroyCommandPool(gpu->device(), fCmdPool, nullptr));
+    }
 }
 
 
@@ -808,34 +964,44 @@ void GrVkSecondaryCommandBuffer::begin(const GrVkGpu* gpu, const GrVkFramebuffer
     SkASSERT(compatibleRenderPass);
     fActiveRenderPass = compatibleRenderPass;
 
-    VkCommandBufferInheritanceInfo inheritanceInfo;
-    memset(&inheritanceInfo, 0, sizeof(VkCommandBufferInheritanceInfo));
-    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
-    inheritanceInfo.pNext = nullptr;
-    inheritanceInfo.renderPass = fActiveRenderPass->vkRenderPass();
-    inheritanceInfo.subpass = 0; // Currently only using 1 subpass for each render pass
-    inheritanceInfo.framebuffer = framebuffer ? framebuffer->framebuffer() : VK_NULL_HANDLE;
-    inheritanceInfo.occlusionQueryEnable = false;
-    inheritanceInfo.queryFlags = 0;
-    inheritanceInfo.pipelineStatistics = 0;
-
-    VkCommandBufferBeginInfo cmdBufferBeginInfo;
-    memset(&cmdBufferBeginInfo, 0, sizeof(VkCommandBufferBeginInfo));
-    cmdBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    cmdBufferBeginInfo.pNext = nullptr;
-    cmdBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
-                               VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    cmdBufferBeginInfo.pInheritanceInfo = &inheritanceInfo;
-
-    GR_VK_CALL_ERRCHECK(gpu->vkInterface(), BeginCommandBuffer(fCmdBuffer,
-                                                               &cmdBufferBeginInfo));
+    VkRenderPass vkRenderPass = fActiveRenderPass->vkRenderPass();
+    VkFramebuffer vkFramebuffer = framebuffer ? framebuffer->framebuffer() : VK_NULL_HANDLE;
+    this->record(gpu, [=](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+        VkCommandBufferInheritanceInfo inheritanceInfo;
+        memset(&inheritanceInfo, 0, sizeof(VkCommandBufferInheritanceInfo));
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.pNext = nullptr;
+        inheritanceInfo.renderPass = vkRenderPass;
+        inheritanceInfo.subpass = 0; // Currently only using 1 subpass for each render pass
+        inheritanceInfo.framebuffer = vkFramebuffer;
+        inheritanceInfo.occlusionQueryEnable = false;
+        inheritanceInfo.queryFlags = 0;
+        inheritanceInfo.pipelineStatistics = 0;
+
+        VkCommandBufferBeginInfo cmdBufferBeginInfo;
+        memset(&cmdBufferBeginInfo, 0, sizeof(VkCommandBufferBeginInfo));
+        cmdBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        cmdBufferBeginInfo.pNext = nullptr;
+        cmdBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                                   VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        cmdBufferBeginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        GR_VK_CALL_ERRCHECK(vkInterface, BeginCommandBuffer(cmdBuffer, &cmdBufferBeginInfo));
+    });
     fIsActive = true;
 }
 
 void GrVkSecondaryCommandBuffer::end(const GrVkGpu* gpu) {
     SkASSERT(fIsActive);
-    GR_VK_CALL_ERRCHECK(gpu->vkInterface(), EndCommandBuffer(fCmdBuffer));
+    this->record(gpu, [](const GrVkInterface* vkInterface, VkCommandBuffer cmdBuffer) {
+        GR_VK_CALL_ERRCHECK(vkInterface, EndCommandBuffer(cmdBuffer));
+    });
     this->invalidateState();
     fIsActive = false;
 }
 
+void GrVkSecondaryCommandBuffer::encode(const GrVkInterface* vkInterface) {
+    SkASSERT(fDeferredCommands && !fIsActive);
+    fDeferredCommands->encode(vkInterface, fCmdBuffer);
+}
+
@@ -14,6 +14,8 @@
 #include "GrVkUtil.h"
 #include "vk/GrVkDefines.h"
 
+#include <memory>
+
 class GrVkBuffer;
 class GrVkFramebuffer;
 class GrVkIndexBuffer;
@@ -27,6 +29,8 @@ class GrVkVertexBuffer;
 
 class GrVkCommandBuffer : public GrVkResource {
 public:
+    ~GrVkCommandBuffer() override;
+
     void invalidateState();
 
     ////////////////////////////////////////////////////////////////////////////
@@ -118,16 +122,15 @@ public:
 
     void reset(GrVkGpu* gpu);
 
+    // Whether commands are recorded to be encoded into the VkCommandBuffer later, rather than
+    // being encoded as they're added. See GrVkSecondaryCommandBuffer::CreateDeferred.
+    bool isDeferred() const { return SkToBool(fDeferredCommands); }
+
 protected:
-        GrVkCommandBuffer(VkCommandBuffer cmdBuffer, const GrVkRenderPass* rp = VK_NULL_HANDLE)
-            : fIsActive(false)
-            , fActiveRenderPass(rp)
-            , fCmdBuffer(cmdBuffer)
-            , fNumResets(0) {
-            fTrackedResources.setReserve(kInitialTrackedResourcesCount);
-            fTrackedRecycledResources.setReserve(kInitialTrackedResourcesCount);
-            this->invalidateState();
-        }
+        class DeferredCommands;
+
+        GrVkCommandBuffer(VkCommandBuffer cmdBuffer, VkCommandPool cmdPool,
+                          const GrVkRenderPass* rp = VK_NULL_HANDLE);
 
         SkTDArray<const GrVkResource*>          fTrackedResources;
         SkTDArray<const GrVkRecycledResource*>  fTrackedRecycledResources;
@@ -142,6 +145,16 @@ protected:
         const GrVkRenderPass*     fActiveRenderPass;
 
         VkCommandBuffer           fCmdBuffer;
+        VkCommandPool             fCmdPool;
+
+        // Set only for deferred command buffers, which hold their commands here until encoded.
+        std::unique_ptr<DeferredCommands> fDeferredCommands;
+
+        // Encodes a command with fn(interface, commandBuffer): right away, or for deferred command
+        // buffers when they're encoded. Anything fn points at must outlive the call, so arrays are
+        // passed through copyIfDeferred() first.
+        template <typename Fn> void record(const GrVkGpu* gpu, Fn&& fn) const;
+        template <typename T> const T* copyIfDeferred(const T* src, uint32_t count) const;
 
 private:
     static const int kInitialTrackedResourcesCount = 32;
@@ -152,6 +165,14 @@ private:
 
     virtual void onReset(GrVkGpu* gpu) {}
 
+    void recordBindDescriptorSets(const GrVkGpu* gpu,
+                                  VkPipelineLayout layout,
+                                  uint32_t firstSet,
+                                  uint32_t setCount,
+                                  const VkDescriptorSet* descriptorSets,
+                                  uint32_t dynamicOffsetCount,
+                                  const uint32_t* dynamicOffsets);
+
     static constexpr uint32_t kMaxInputBuffers = 2;
 
     VkBuffer fBoundInputBuffers[kMaxInputBuffers];
@@ -280,8 +301,8 @@ public:
 #endif
 
 private:
-    explicit GrVkPrimaryCommandBuffer(VkCommandBuffer cmdBuffer)
-        : INHERITED(cmdBuffer)
+    GrVkPrimaryCommandBuffer(VkCommandBuffer cmdBuffer, VkCommandPool cmdPool)
+        : INHERITED(cmdBuffer, cmdPool)
         , fSubmitFence(VK_NULL_HANDLE) {}
 
     void onFreeGPUData(const GrVkGpu* gpu) const override;
@@ -298,10 +319,21 @@ class GrVkSecondaryCommandBuffer : public GrVkCommandBuffer {
 public:
     static GrVkSecondaryCommandBuffer* Create(const GrVkGpu* gpu, VkCommandPool cmdPool);
 
+    // Creates a command buffer that only records what's added to it, from begin() to end(). The
+    // Vulkan commands are encoded when encode() is called, which may be on another thread. So that
+    // encoding needs no synchronization with the rest of the GrVkGpu, the command buffer is
+    // allocated from a command pool of its own.
+    static GrVkSecondaryCommandBuffer* CreateDeferred(const GrVkGpu* gpu);
+
     void begin(const GrVkGpu* gpu, const GrVkFramebuffer* framebuffer,
                const GrVkRenderPass* compatibleRenderPass);
     void end(const GrVkGpu* gpu);
 
+    // Encodes everything recorded into a deferred command buffer since it began. This may be
+    // called from any thread after end(), but must finish before the command buffer is executed,
+    // reset or recorded into again.
+    void encode(const GrVkInterface* vkInterface);
+
 #ifdef SK_TRACE_VK_RESOURCES
     void dumpInfo() const override {
         SkDebugf("GrVkSecondaryCommandBuffer: %d (%d refs)\n", fCmdBuffer, this->getRefCnt());
@@ -309,11 +341,14 @@ public:
 #endif
 
 private:
-    explicit GrVkSecondaryCommandBuffer(VkCommandBuffer cmdBuffer)
-        : INHERITED(cmdBuffer) {
+    GrVkSecondaryCommandBuffer(VkCommandBuffer cmdBuffer, VkCommandPool cmdPool)
+        : INHERITED(cmdBuffer, cmdPool)
+        , fOwnsCmdPool(false) {
     }
 
-    void onFreeGPUData(const GrVkGpu* gpu) const override {}
+    void onFreeGPUData(const GrVkGpu* gpu) const override;
+
+    bool fOwnsCmdPool;
 
     friend class GrVkPrimaryCommandBuffer;
 
@@ -12,8 +12,7 @@
 #include "GrVkGpu.h"
 #include "GrVkUniformHandler.h"
 
-GrVkDescriptorSetManager* GrVkDescriptorSetManager::CreateUniformManager(GrVkGpu* gpu) {
-    SkSTArray<2, uint32_t> visibilities;
+static void get_uniform_visibilities(GrVkGpu* gpu, SkTArray<uint32_t>* visibilities) {
     // We set the visibility of the first binding to all supported geometry processing shader
     // stages (vertex, tesselation, geometry, etc.) and the second binding to the fragment
     // shader.
@@ -21,11 +20,23 @@ GrVkDescriptorSetManager* GrVkDescriptorSetManager::CreateUniformManager(GrVkGpu
     if (gpu->vkCaps().shaderCaps()->geometryShaderSupport()) {
         geomStages |= kGeometry_GrShaderFlag;
     }
-    visibilities.push_back(geomStages);
-    visibilities.push_back(kFragment_GrShaderFlag);
+    visibilities->push_back(geomStages);
+    visibilities->push_back(kFragment_GrShaderFlag);
+}
+
+GrVkDescriptorSetManager* GrVkDescriptorSetManager::CreateUniformManager(GrVkGpu* gpu) {
+    SkSTArray<2, uint32_t> visibilities;
+    get_uniform_visibilities(gpu, &visibilities);
     return new GrVkDescriptorSetManager(gpu, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, visibilities);
 }
 
+GrVkDescriptorSetManager* GrVkDescriptorSetManager::CreateDynamicUniformManager(GrVkGpu* gpu) {
+    SkSTArray<2, uint32_t> visibilities;
+    get_uniform_visibilities(gpu, &visibilities);
+    return new GrVkDescriptorSetManager(gpu, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                                        visibilities);
+}
+
 GrVkDescriptorSetManager* GrVkDescriptorSetManager::CreateSamplerManager(
         GrVkGpu* gpu, VkDescriptorType type, const GrVkUniformHandler& uniformHandler) {
     SkSTArray<4, uint32_t> visibilities;
@@ -203,7 +214,8 @@ GrVkDescriptorSetManager::DescriptorPoolManager::DescriptorPoolManager(
                                                       &fDescLayout));
         fDescCountPerSet = visibilities.count();
     } else {
-        SkASSERT(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER == type);
+        SkASSERT(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER == type ||
+                 VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC == type);
         GR_STATIC_ASSERT(2 == kUniformDescPerSet);
         SkASSERT(kUniformDescPerSet == visibilities.count());
         // Create Uniform Buffer Descriptor
@@ -213,7 +225,7 @@ GrVkDescriptorSetManager::DescriptorPoolManager::DescriptorPoolManager(
         memset(&dsUniBindings, 0, kUniformDescPerSet * sizeof(VkDescriptorSetLayoutBinding));
         for (int i = 0; i < kUniformDescPerSet; ++i) {
             dsUniBindings[i].binding = bindings[i];
-            dsUniBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            dsUniBindings[i].descriptorType = type;
             dsUniBindings[i].descriptorCount = 1;
             dsUniBindings[i].stageFlags = visibility_to_vk_stage_flags(visibilities[i]);
             dsUniBindings[i].pImmutableSamplers = nullptr;
@@ -27,6 +27,8 @@ public:
     GR_DEFINE_RESOURCE_HANDLE_CLASS(Handle);
 
     static GrVkDescriptorSetManager* CreateUniformManager(GrVkGpu* gpu);
+    // Like a uniform manager, but its sets' buffers are bound with dynamic offsets.
+    static GrVkDescriptorSetManager* CreateDynamicUniformManager(GrVkGpu* gpu);
     static GrVkDescriptorSetManager* CreateSamplerManager(GrVkGpu* gpu, VkDescriptorType type,
                                                           const GrVkUniformHandler&);
     static GrVkDescriptorSetManager* CreateSamplerManager(GrVkGpu* gpu, VkDescriptorType type,
@@ -35,6 +35,7 @@
 
 #include "SkConvertPixels.h"
 #include "SkMipMap.h"
+#include "SkTraceMemoryDump.h"
 
 #include "vk/GrVkInterface.h"
 #include "vk/GrVkTypes.h"
@@ -95,6 +96,8 @@ GrVkGpu::GrVkGpu(GrContext* context, const GrContextOptions& options,
         , fDevice(fBackendContext->fDevice)
         , fQueue(fBackendContext->fQueue)
         , fResourceProvider(this)
+        , fCommandEncodingExecutor(options.fEncodeVulkanCommandsOnExecutor ? options.fExecutor
+                                                                           : nullptr)
         , fDisconnected(false) {
 #ifdef SK_ENABLE_VK_LAYERS
     fCallback = VK_NULL_HANDLE;
@@ -266,6 +269,9 @@ void GrVkGpu::submitCommandBuffer(SyncQueue sync) {
     SkASSERT(fCurrentCmdBuffer);
     fCurrentCmdBuffer->end(this);
 
+    // The device must see every uniform written for this command buffer before it runs.
+    fResourceProvider.uniformRingBuffer()->flush(this);
+
     fCurrentCmdBuffer->submitToQueue(this, fQueue, sync, fSemaphoresToSignal, fSemaphoresToWaitOn);
 
     for (int i = 0; i < fSemaphoresToWaitOn.count(); ++i) {
@@ -991,6 +997,26 @@ sk_sp<GrRenderTarget> GrVkGpu::onWrapBackendTextureAsRenderTarget(const GrBacken
     return GrVkRenderTarget::MakeWrappedRenderTarget(this, desc, imageInfo, std::move(layout));
 }
 
+int GrVkGpu::onRegenerateMipMapLevels(GrTexture* const textures[],
+                                      const GrSurfaceOrigin origins[], int count) {
+    // Record all the blits back to back on the primary command buffer instead of in between the
+    // render passes of the draws that sample the textures.
+    int regenerated = 0;
+    for (int i = 0; i < count; ++i) {
+        GrVkTexture* vkTexture = static_cast<GrVkTexture*>(textures[i]);
+        if (!vkTexture->texturePriv().mipMapsAreDirty()) {
+            continue;
+        }
+        if (GrVkRenderTarget* texRT = static_cast<GrVkRenderTarget*>(vkTexture->asRenderTarget())) {
+            this->onResolveRenderTarget(texRT);
+        }
+        this->generateMipmap(vkTexture, origins[i]);
+        vkTexture->texturePriv().markMipMapsClean();
+        ++regenerated;
+    }
+    return regenerated;
+}
+
 void GrVkGpu::generateMipmap(GrVkTexture* tex, GrSurfaceOrigin texOrigin) {
     // don't do anything for linearly tiled textures (can't have mipmaps)
     if (tex->isLinearTiled()) {
@@ -2207,3 +2233,34 @@ sk_sp<GrSemaphore> GrVkGpu::prepareTextureForCrossContextUsage(GrTexture* textur
     return nullptr;
 }
 
+void GrVkGpu::releaseUnusedMemory() {
+    for (int i = 0; i < kHeapCount; ++i) {
+        fHeaps[i]->freeEmptySubHeaps();
+    }
+}
+
+void GrVkGpu::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
+    static const char* kHeapNames[] = {
+        "linear_image",
+        "optimal_image",
+        "small_optimal_image",
+        "vertex_buffer",
+        "index_buffer",
+        "uniform_buffer",
+        "texel_buffer",
+        "copy_read_buffer",
+        "copy_write_buffer",
+    };
+    GR_STATIC_ASSERT(SK_ARRAY_COUNT(kHeapNames) == kHeapCount);
+
+    for (int i = 0; i < kHeapCount; ++i) {
+        const GrVkHeap* heap = fHeaps[i].get();
+        SkString dumpName = SkStringPrintf("skia/gpu_resources/vk_heap_%s", kHeapNames[i]);
+        traceMemoryDump->dumpNumericValue(dumpName.c_str(), "size", "bytes",
+                                          heap->allocSize() + heap->dedicatedSize());
+        traceMemoryDump->dumpNumericValue(dumpName.c_str(), "used_size", "bytes",
+                                          heap->usedSize() + heap->dedicatedSize());
+        traceMemoryDump->dumpNumericValue(dumpName.c_str(), "sub_heap_count", "objects",
+                                          heap->subHeapCount());
+    }
+}
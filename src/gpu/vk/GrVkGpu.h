@@ -21,6 +21,7 @@
 #include "vk/GrVkDefines.h"
 
 class GrPipeline;
+class SkExecutor;
 
 class GrVkBufferImpl;
 class GrVkPipeline;
@@ -49,6 +50,9 @@ public:
     VkDevice device() const { return fDevice; }
     VkQueue  queue() const { return fQueue; }
     VkCommandPool cmdPool() const { return fCmdPool; }
+    uint32_t queueIndex() const { return fBackendContext->fGraphicsQueueIndex; }
+    // If not null, render target command buffers encode their secondary command buffers here.
+    SkExecutor* commandEncodingExecutor() const { return fCommandEncodingExecutor; }
     VkPhysicalDeviceProperties physicalDeviceProperties() const {
         return fPhysDevProps;
     }
@@ -134,6 +138,9 @@ public:
 
     sk_sp<GrSemaphore> prepareTextureForCrossContextUsage(GrTexture*) override;
 
+    void releaseUnusedMemory() override;
+    void dumpMemoryStatistics(SkTraceMemoryDump*) const override;
+
     void generateMipmap(GrVkTexture* tex, GrSurfaceOrigin texOrigin);
 
     void copyBuffer(GrVkBuffer* srcBuffer, GrVkBuffer* dstBuffer, VkDeviceSize srcOffset,
@@ -204,6 +211,8 @@ private:
                        GrSurfaceOrigin srcOrigin, const SkIRect& srcRect,
                        const SkIPoint& dstPoint, bool canDiscardOutsideDstRect) override;
 
+    int onRegenerateMipMapLevels(GrTexture* const[], const GrSurfaceOrigin[], int count) override;
+
     void onFinishFlush(bool insertedSemaphores) override;
 
     // Ends and submits the current command buffer to the queue and then creates a new command
@@ -261,6 +270,7 @@ private:
     // Created by GrVkGpu
     GrVkResourceProvider                         fResourceProvider;
     VkCommandPool                                fCmdPool;
+    SkExecutor*                                  fCommandEncodingExecutor;
 
     GrVkPrimaryCommandBuffer*                    fCurrentCmdBuffer;
 
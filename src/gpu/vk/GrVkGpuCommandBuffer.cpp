@@ -21,6 +21,7 @@
 #include "GrVkResourceProvider.h"
 #include "GrVkTexture.h"
 #include "SkRect.h"
+#include "SkTaskGroup.h"
 
 void GrVkGpuTextureCommandBuffer::copy(GrSurface* src, GrSurfaceOrigin srcOrigin,
                                        const SkIRect& srcRect, const SkIPoint& dstPoint) {
@@ -88,6 +89,10 @@ GrVkGpuRTCommandBuffer::GrVkGpuRTCommandBuffer(GrVkGpu* gpu,
                           &fVkStencilLoadOp, &fVkStencilStoreOp);
     fCurrentCmdInfo = -1;
 
+    if (SkExecutor* executor = fGpu->commandEncodingExecutor()) {
+        fEncodeTasks.reset(new SkTaskGroup(*executor));
+    }
+
     this->init();
 }
 
@@ -131,12 +136,17 @@ void GrVkGpuRTCommandBuffer::init() {
         cbInfo.fLoadStoreState = LoadStoreState::kStartsWithDiscard;
     }
 
-    cbInfo.fCommandBuffers.push_back(fGpu->resourceProvider().findOrCreateSecondaryCommandBuffer());
+    cbInfo.fCommandBuffers.push_back(
+            fGpu->resourceProvider().findOrCreateSecondaryCommandBuffer(SkToBool(fEncodeTasks)));
     cbInfo.currentCmdBuf()->begin(fGpu, vkRT->framebuffer(), cbInfo.fRenderPass);
 }
 
 
 GrVkGpuRTCommandBuffer::~GrVkGpuRTCommandBuffer() {
+    if (fEncodeTasks) {
+        // Don't let go of command buffers that are still being encoded.
+        fEncodeTasks->wait();
+    }
     for (int i = 0; i < fCommandBufferInfos.count(); ++i) {
         CommandBufferInfo& cbInfo = fCommandBufferInfos[i];
         for (int j = 0; j < cbInfo.fCommandBuffers.count(); ++j) {
@@ -150,7 +160,17 @@ GrGpu* GrVkGpuRTCommandBuffer::gpu() { return fGpu; }
 
 void GrVkGpuRTCommandBuffer::end() {
     if (fCurrentCmdInfo >= 0) {
-        fCommandBufferInfos[fCurrentCmdInfo].currentCmdBuf()->end(fGpu);
+        this->endCurrentCmdBuf();
+    }
+}
+
+void GrVkGpuRTCommandBuffer::endCurrentCmdBuf() {
+    GrVkSecondaryCommandBuffer* cmdBuf = fCommandBufferInfos[fCurrentCmdInfo].currentCmdBuf();
+    cmdBuf->end(fGpu);
+    if (fEncodeTasks) {
+        // Nothing else touches the command buffer until submit(), which waits for this.
+        const GrVkInterface* vkInterface = fGpu->vkInterface();
+        fEncodeTasks->add([cmdBuf, vkInterface] { cmdBuf->encode(vkInterface); });
     }
 }
 
@@ -159,6 +179,10 @@ void GrVkGpuRTCommandBuffer::submit() {
         return;
     }
 
+    if (fEncodeTasks) {
+        fEncodeTasks->wait();
+    }
+
     GrVkRenderTarget* vkRT = static_cast<GrVkRenderTarget*>(fRenderTarget);
     GrVkImage* targetImage = vkRT->msaaImage() ? vkRT->msaaImage() : vkRT;
     GrStencilAttachment* stencil = fRenderTarget->renderTargetPriv().getStencilAttachment();
@@ -429,16 +453,17 @@ void GrVkGpuRTCommandBuffer::onClear(const GrFixedClip& clip, GrColor color) {
 void GrVkGpuRTCommandBuffer::addAdditionalCommandBuffer() {
     GrVkRenderTarget* vkRT = static_cast<GrVkRenderTarget*>(fRenderTarget);
 
+    this->endCurrentCmdBuf();
     CommandBufferInfo& cbInfo = fCommandBufferInfos[fCurrentCmdInfo];
-    cbInfo.currentCmdBuf()->end(fGpu);
-    cbInfo.fCommandBuffers.push_back(fGpu->resourceProvider().findOrCreateSecondaryCommandBuffer());
+    cbInfo.fCommandBuffers.push_back(
+            fGpu->resourceProvider().findOrCreateSecondaryCommandBuffer(SkToBool(fEncodeTasks)));
     cbInfo.currentCmdBuf()->begin(fGpu, vkRT->framebuffer(), cbInfo.fRenderPass);
 }
 
 void GrVkGpuRTCommandBuffer::addAdditionalRenderPass() {
     GrVkRenderTarget* vkRT = static_cast<GrVkRenderTarget*>(fRenderTarget);
 
-    fCommandBufferInfos[fCurrentCmdInfo].currentCmdBuf()->end(fGpu);
+    this->endCurrentCmdBuf();
 
     CommandBufferInfo& cbInfo = fCommandBufferInfos.push_back();
     fCurrentCmdInfo++;
@@ -461,7 +486,8 @@ void GrVkGpuRTCommandBuffer::addAdditionalRenderPass() {
     }
     cbInfo.fLoadStoreState = LoadStoreState::kLoadAndStore;
 
-    cbInfo.fCommandBuffers.push_back(fGpu->resourceProvider().findOrCreateSecondaryCommandBuffer());
+    cbInfo.fCommandBuffers.push_back(
+            fGpu->resourceProvider().findOrCreateSecondaryCommandBuffer(SkToBool(fEncodeTasks)));
     // It shouldn't matter what we set the clear color to here since we will assume loading of the
     // attachment.
     memset(&cbInfo.fColorClearValue, 0, sizeof(VkClearValue));
@@ -622,6 +648,7 @@ static void prepare_sampled_images(const GrResourceIOProcessor& processor,
         // Check if we need to regenerate any mip maps
         if (GrSamplerState::Filter::kMipMap == sampler.samplerState().filter()) {
             if (vkTexture->texturePriv().mipMapsAreDirty()) {
+                gpu->stats()->incMipMapRegenerations();
                 gpu->generateMipmap(vkTexture, sampler.proxy()->origin());
                 vkTexture->texturePriv().markMipMapsClean();
             }
@@ -20,6 +20,7 @@ class GrVkImage;
 class GrVkRenderPass;
 class GrVkRenderTarget;
 class GrVkSecondaryCommandBuffer;
+class SkTaskGroup;
 
 class GrVkGpuTextureCommandBuffer : public GrGpuTextureCommandBuffer {
 public:
@@ -133,6 +134,10 @@ private:
     void addAdditionalCommandBuffer();
     void addAdditionalRenderPass();
 
+    // Ends the secondary command buffer we're recording into, and starts encoding it if we encode
+    // on the GrVkGpu's executor.
+    void endCurrentCmdBuf();
+
     struct InlineUploadInfo {
         InlineUploadInfo(GrOpFlushState* state, const GrDeferredTextureUploadFn& upload)
                 : fFlushState(state), fUpload(upload) {}
@@ -195,6 +200,8 @@ private:
     VkAttachmentStoreOp         fVkStencilStoreOp;
     GrColor4f                   fClearColor;
     GrVkPipelineState*          fLastPipelineState;
+    // Encodes our (deferred) secondary command buffers, if the GrVkGpu has an executor for that.
+    std::unique_ptr<SkTaskGroup> fEncodeTasks;
 
     typedef GrGpuRTCommandBuffer INHERITED;
 };
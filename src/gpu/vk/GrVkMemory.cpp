@@ -571,6 +571,7 @@ bool GrVkHeap::subAlloc(VkDeviceSize size, VkDeviceSize alignment,
         alloc->fOffset = 0;
         alloc->fSize = alignedSize;
         alloc->fUsesSystemHeap = true;
+        fDedicatedSize += alignedSize;
 #ifdef SK_DEBUG
         gHeapUsage[VK_MAX_MEMORY_HEAPS] += alignedSize;
 #endif
@@ -612,7 +613,7 @@ bool GrVkHeap::subAlloc(VkDeviceSize size, VkDeviceSize alignment,
             return false;
         }
     }
-    fAllocSize += fSubHeapSize;
+    fAllocSize += subHeap->size();
     if (subHeap->alloc(size, alloc)) {
         fUsedSize += alloc->fSize;
         return true;
@@ -666,6 +667,10 @@ bool GrVkHeap::free(const GrVkAlloc& alloc) {
     if (alloc.fUsesSystemHeap) {
         const GrVkInterface* iface = fGpu->vkInterface();
         GR_VK_CALL(iface, FreeMemory(fGpu->device(), alloc.fMemory, nullptr));
+        fDedicatedSize -= alloc.fSize;
+#ifdef SK_DEBUG
+        gHeapUsage[VK_MAX_MEMORY_HEAPS] -= alloc.fSize;
+#endif
         return true;
     }
 
@@ -680,4 +685,11 @@ bool GrVkHeap::free(const GrVkAlloc& alloc) {
     return false;
 }
 
-
+void GrVkHeap::freeEmptySubHeaps() {
+    for (int i = fSubHeaps.count() - 1; i >= 0; --i) {
+        if (fSubHeaps[i]->unallocated()) {
+            fAllocSize -= fSubHeaps[i]->size();
+            fSubHeaps.removeShuffle(i);
+        }
+    }
+}
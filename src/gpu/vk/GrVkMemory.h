@@ -127,7 +127,8 @@ public:
         : fGpu(gpu)
         , fSubHeapSize(subHeapSize)
         , fAllocSize(0)
-        , fUsedSize(0) {
+        , fUsedSize(0)
+        , fDedicatedSize(0) {
         if (strategy == kSubAlloc_Strategy) {
             fAllocFunc = &GrVkHeap::subAlloc;
         } else {
@@ -137,8 +138,12 @@ public:
 
     ~GrVkHeap() {}
 
+    // Sizes of the subheaps, and how much of them is in use.
     VkDeviceSize allocSize() const { return fAllocSize; }
     VkDeviceSize usedSize() const { return fUsedSize; }
+    // Allocations too big for a subheap get a VkDeviceMemory of their own.
+    VkDeviceSize dedicatedSize() const { return fDedicatedSize; }
+    int subHeapCount() const { return fSubHeaps.count(); }
 
     bool alloc(VkDeviceSize size, VkDeviceSize alignment, uint32_t memoryTypeIndex,
                uint32_t heapIndex, GrVkAlloc* alloc) {
@@ -148,6 +153,9 @@ public:
     }
     bool free(const GrVkAlloc& alloc);
 
+    // Frees the VkDeviceMemory of every subheap with nothing allocated from it.
+    void freeEmptySubHeaps();
+
 private:
     typedef bool (GrVkHeap::*AllocFunc)(VkDeviceSize size, VkDeviceSize alignment,
                                         uint32_t memoryTypeIndex, uint32_t heapIndex,
@@ -164,6 +172,7 @@ private:
     VkDeviceSize           fSubHeapSize;
     VkDeviceSize           fAllocSize;
     VkDeviceSize           fUsedSize;
+    VkDeviceSize           fDedicatedSize;
     AllocFunc              fAllocFunc;
     SkTArray<std::unique_ptr<GrVkSubHeap>> fSubHeaps;
 };
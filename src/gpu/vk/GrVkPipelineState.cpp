@@ -39,6 +39,7 @@ GrVkPipelineState::GrVkPipelineState(GrVkGpu* gpu,
                                      const UniformInfoArray& uniforms,
                                      uint32_t geometryUniformSize,
                                      uint32_t fragmentUniformSize,
+                                     bool useUniformRingBuffer,
                                      uint32_t numSamplers,
                                      uint32_t numTexelBuffers,
                                      std::unique_ptr<GrGLSLPrimitiveProcessor> geometryProcessor,
@@ -51,6 +52,7 @@ GrVkPipelineState::GrVkPipelineState(GrVkGpu* gpu,
     , fTexelBufferDescriptorSet(nullptr)
     , fSamplerDSHandle(samplerDSHandle)
     , fTexelBufferDSHandle(texelBufferDSHandle)
+    , fUsesUniformRingBuffer(useUniformRingBuffer)
     , fBuiltinUniformHandles(builtinUniformHandles)
     , fGeometryProcessor(std::move(geometryProcessor))
     , fXferProcessor(std::move(xferProcessor))
@@ -67,8 +69,10 @@ GrVkPipelineState::GrVkPipelineState(GrVkGpu* gpu,
     fDescriptorSets[1] = VK_NULL_HANDLE;
     fDescriptorSets[2] = VK_NULL_HANDLE;
 
-    fGeometryUniformBuffer.reset(GrVkUniformBuffer::Create(gpu, geometryUniformSize));
-    fFragmentUniformBuffer.reset(GrVkUniformBuffer::Create(gpu, fragmentUniformSize));
+    if (!fUsesUniformRingBuffer) {
+        fGeometryUniformBuffer.reset(GrVkUniformBuffer::Create(gpu, geometryUniformSize));
+        fFragmentUniformBuffer.reset(GrVkUniformBuffer::Create(gpu, fragmentUniformSize));
+    }
 
     fNumSamplers = numSamplers;
     fNumTexelBuffers = numTexelBuffers;
@@ -295,7 +299,10 @@ void GrVkPipelineState::setData(GrVkGpu* gpu,
         this->writeTexelBuffers(gpu, bufferAccesses);
     }
 
-    if (fGeometryUniformBuffer || fFragmentUniformBuffer) {
+    if (fUsesUniformRingBuffer) {
+        SkAssertResult(fDataManager.uploadUniformRingBuffer(
+                gpu, gpu->resourceProvider().uniformRingBuffer(), &fUniformAllocation));
+    } else if (fGeometryUniformBuffer || fFragmentUniformBuffer) {
         if (fDataManager.uploadUniformBuffers(gpu,
                                               fGeometryUniformBuffer.get(),
                                               fFragmentUniformBuffer.get())
@@ -489,7 +496,17 @@ void GrVkPipelineState::setRenderTargetState(const GrRenderTargetProxy* proxy) {
 void GrVkPipelineState::bind(const GrVkGpu* gpu, GrVkCommandBuffer* commandBuffer) {
     commandBuffer->bindPipeline(gpu, fPipeline);
 
-    if (fGeometryUniformBuffer || fFragmentUniformBuffer) {
+    if (fUsesUniformRingBuffer) {
+        if (fUniformAllocation.fChunk) {
+            int dsIndex = GrVkUniformHandler::kUniformBufferDescSet;
+            VkDescriptorSet descriptorSet = fUniformAllocation.fChunk->descriptorSet();
+            commandBuffer->bindDescriptorSets(gpu, this, fPipelineLayout,
+                                              dsIndex, 1,
+                                              &descriptorSet,
+                                              SK_ARRAY_COUNT(fUniformAllocation.fDynamicOffsets),
+                                              fUniformAllocation.fDynamicOffsets);
+        }
+    } else if (fGeometryUniformBuffer || fFragmentUniformBuffer) {
         int dsIndex = GrVkUniformHandler::kUniformBufferDescSet;
         commandBuffer->bindDescriptorSets(gpu, this, fPipelineLayout,
                                           dsIndex, 1,
@@ -520,6 +537,10 @@ void GrVkPipelineState::addUniformResources(GrVkCommandBuffer& commandBuffer) {
         commandBuffer.addRecycledResource(fTexelBufferDescriptorSet);
     }
 
+    if (fUsesUniformRingBuffer && fUniformAllocation.fChunk) {
+        commandBuffer.addRecycledResource(fUniformAllocation.fChunk);
+    }
+
     if (fGeometryUniformBuffer.get()) {
         commandBuffer.addRecycledResource(fGeometryUniformBuffer->resource());
     }
@@ -98,6 +98,7 @@ private:
                       const UniformInfoArray& uniforms,
                       uint32_t geometryUniformSize,
                       uint32_t fragmentUniformSize,
+                      bool useUniformRingBuffer,
                       uint32_t numSamplers,
                       uint32_t numTexelBuffers,
                       std::unique_ptr<GrGLSLPrimitiveProcessor> geometryProcessor,
@@ -178,6 +179,12 @@ private:
     std::unique_ptr<GrVkUniformBuffer> fGeometryUniformBuffer;
     std::unique_ptr<GrVkUniformBuffer> fFragmentUniformBuffer;
 
+    // If our uniforms live in the uniform ring buffer, rather than in the buffers above, this is
+    // where we last put them. It doesn't hold a ref on the chunk: command buffers do that for as
+    // long as they need it.
+    bool                                fUsesUniformRingBuffer;
+    GrVkUniformRingBuffer::Allocation   fUniformAllocation;
+
     // GrVkResources used for sampling textures
     SkTDArray<GrVkSampler*> fSamplers;
     SkTDArray<const GrVkImageView*> fTextureViews;
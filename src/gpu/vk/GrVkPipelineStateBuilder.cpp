@@ -9,6 +9,7 @@
 
 #include "GrContext.h"
 #include "GrContextPriv.h"
+#include "GrProgramKeyAnalysis.h"
 #include "GrShaderCaps.h"
 #include "vk/GrVkDescriptorSetManager.h"
 #include "vk/GrVkGpu.h"
@@ -99,8 +100,15 @@ GrVkPipelineState* GrVkPipelineStateBuilder::finalize(const GrStencilSettings& s
     VkShaderModule fragShaderModule = VK_NULL_HANDLE;
 
     GrVkResourceProvider& resourceProvider = fGpu->resourceProvider();
+    // Uniform blocks that are small enough are streamed through the uniform ring buffer, whose
+    // descriptor sets are bound with dynamic offsets.
+    bool useUniformRingBuffer =
+            GrVkUniformRingBuffer::CanHold(fUniformHandler.fCurrentGeometryUBOOffset,
+                                           fUniformHandler.fCurrentFragmentUBOOffset);
     // These layouts are not owned by the PipelineStateBuilder and thus should not be destroyed
-    dsLayout[GrVkUniformHandler::kUniformBufferDescSet] = resourceProvider.getUniformDSLayout();
+    dsLayout[GrVkUniformHandler::kUniformBufferDescSet] =
+            useUniformRingBuffer ? resourceProvider.getDynamicUniformDSLayout()
+                                 : resourceProvider.getUniformDSLayout();
 
     GrVkDescriptorSetManager::Handle samplerDSHandle;
     resourceProvider.getSamplerDescriptorSetHandle(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
@@ -138,6 +146,10 @@ GrVkPipelineState* GrVkPipelineStateBuilder::finalize(const GrStencilSettings& s
     fFS.extensions().appendf("#extension GL_ARB_shading_language_420pack : enable\n");
 
     this->finalizeShaders();
+    if (auto analysis = this->gpu()->getContext()->contextPriv().programKeyAnalysis()) {
+        analysis->addProgram(*this->desc(), this->primitiveProcessor(), this->pipeline(),
+                             *this->caps()->shaderCaps(), this->sksl());
+    }
 
     VkPipelineShaderStageCreateInfo shaderStageInfo[3];
     SkSL::Program::Settings settings;
@@ -206,6 +218,7 @@ GrVkPipelineState* GrVkPipelineStateBuilder::finalize(const GrStencilSettings& s
                                  fUniformHandler.fUniforms,
                                  fUniformHandler.fCurrentGeometryUBOOffset,
                                  fUniformHandler.fCurrentFragmentUBOOffset,
+                                 useUniformRingBuffer,
                                  (uint32_t)fUniformHandler.numSamplers(),
                                  (uint32_t)fUniformHandler.numTexelBuffers(),
                                  std::move(fGeometryProcessor),
@@ -288,3 +288,19 @@ bool GrVkPipelineStateDataManager::uploadUniformBuffers(GrVkGpu* gpu,
 
     return updatedBuffer;
 }
+
+bool GrVkPipelineStateDataManager::uploadUniformRingBuffer(
+        GrVkGpu* gpu,
+        GrVkUniformRingBuffer* ringBuffer,
+        GrVkUniformRingBuffer::Allocation* allocation) const {
+    if (!fGeometryUniformsDirty && !fFragmentUniformsDirty && ringBuffer->isCurrent(*allocation)) {
+        return true;
+    }
+    if (!ringBuffer->upload(gpu, fGeometryUniformData.get(), fGeometryUniformSize,
+                            fFragmentUniformData.get(), fFragmentUniformSize, allocation)) {
+        return false;
+    }
+    fGeometryUniformsDirty = false;
+    fFragmentUniformsDirty = false;
+    return true;
+}
@@ -10,6 +10,7 @@
 
 #include "glsl/GrGLSLProgramDataManager.h"
 
+#include "GrVkUniformRingBuffer.h"
 #include "SkAutoMalloc.h"
 #include "vk/GrVkUniformHandler.h"
 
@@ -55,6 +56,13 @@ public:
     bool uploadUniformBuffers(GrVkGpu* gpu,
                               GrVkUniformBuffer* geometryBuffer,
                               GrVkUniformBuffer* fragmentBuffer) const;
+
+    // Puts the uniforms in the ring buffer and sets *allocation to where they went, unless they
+    // haven't changed since they were put at *allocation and are still there. Returns false if the
+    // ring buffer couldn't take them.
+    bool uploadUniformRingBuffer(GrVkGpu* gpu,
+                                 GrVkUniformRingBuffer* ringBuffer,
+                                 GrVkUniformRingBuffer::Allocation* allocation) const;
 private:
     struct Uniform {
         uint32_t fBinding;
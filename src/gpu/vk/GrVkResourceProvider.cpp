@@ -7,6 +7,7 @@
 
 #include "GrVkResourceProvider.h"
 
+#include "GrContextPriv.h"
 #include "GrSamplerState.h"
 #include "GrVkCommandBuffer.h"
 #include "GrVkCopyPipeline.h"
@@ -16,6 +17,8 @@
 #include "GrVkSampler.h"
 #include "GrVkUniformBuffer.h"
 #include "GrVkUtil.h"
+#include "SkAutoMalloc.h"
+#include "SkStream.h"
 
 #ifdef SK_TRACE_VK_RESOURCES
 GrVkResource::Trace GrVkResource::fTrace;
@@ -35,26 +38,77 @@ GrVkResourceProvider::~GrVkResourceProvider() {
 }
 
 void GrVkResourceProvider::init() {
-    VkPipelineCacheCreateInfo createInfo;
-    memset(&createInfo, 0, sizeof(VkPipelineCacheCreateInfo));
-    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-    createInfo.pNext = nullptr;
-    createInfo.flags = 0;
-    createInfo.initialDataSize = 0;
-    createInfo.pInitialData = nullptr;
-    VkResult result = GR_VK_CALL(fGpu->vkInterface(),
-                                 CreatePipelineCache(fGpu->device(), &createInfo, nullptr,
-                                                     &fPipelineCache));
-    SkASSERT(VK_SUCCESS == result);
-    if (VK_SUCCESS != result) {
-        fPipelineCache = VK_NULL_HANDLE;
-    }
-
     // Init uniform descriptor objects
     GrVkDescriptorSetManager* dsm = GrVkDescriptorSetManager::CreateUniformManager(fGpu);
     fDescriptorSetManagers.emplace_back(dsm);
     SkASSERT(1 == fDescriptorSetManagers.count());
     fUniformDSHandle = GrVkDescriptorSetManager::Handle(0);
+
+    dsm = GrVkDescriptorSetManager::CreateDynamicUniformManager(fGpu);
+    fDescriptorSetManagers.emplace_back(dsm);
+    SkASSERT(2 == fDescriptorSetManagers.count());
+    fDynamicUniformDSHandle = GrVkDescriptorSetManager::Handle(1);
+    fUniformRingBuffer.reset(new GrVkUniformRingBuffer(fGpu));
+}
+
+// The driver checks that pipeline cache data it's given came from the same device and driver, but
+// we key it by them too, so that one persistent cache can serve several GPUs.
+static sk_sp<SkData> pipeline_cache_key(const VkPhysicalDeviceProperties& props) {
+    static const uint32_t kTag = SkSetFourByteTag('v', 'k', 'p', 'c');
+    SkDynamicMemoryWStream key;
+    key.write32(kTag);
+    key.write32(props.vendorID);
+    key.write32(props.deviceID);
+    key.write32(props.driverVersion);
+    key.write(props.pipelineCacheUUID, VK_UUID_SIZE);
+    return key.detachAsData();
+}
+
+VkPipelineCache GrVkResourceProvider::pipelineCache() {
+    if (VK_NULL_HANDLE == fPipelineCache) {
+        sk_sp<SkData> cached;
+        if (auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache()) {
+            cached = persistentCache->load(*pipeline_cache_key(fGpu->physicalDeviceProperties()));
+        }
+
+        VkPipelineCacheCreateInfo createInfo;
+        memset(&createInfo, 0, sizeof(VkPipelineCacheCreateInfo));
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.initialDataSize = cached ? cached->size() : 0;
+        createInfo.pInitialData = cached ? cached->data() : nullptr;
+        VkResult result = GR_VK_CALL(fGpu->vkInterface(),
+                                     CreatePipelineCache(fGpu->device(), &createInfo, nullptr,
+                                                         &fPipelineCache));
+        SkASSERT(VK_SUCCESS == result);
+        if (VK_SUCCESS != result) {
+            fPipelineCache = VK_NULL_HANDLE;
+        }
+    }
+    return fPipelineCache;
+}
+
+void GrVkResourceProvider::storePipelineCacheData() {
+    auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache();
+    if (!persistentCache || VK_NULL_HANDLE == fPipelineCache) {
+        return;
+    }
+    size_t dataSize = 0;
+    VkResult result = GR_VK_CALL(fGpu->vkInterface(), GetPipelineCacheData(fGpu->device(),
+                                                                            fPipelineCache,
+                                                                            &dataSize, nullptr));
+    if (VK_SUCCESS != result || !dataSize) {
+        return;
+    }
+    SkAutoMalloc data(dataSize);
+    result = GR_VK_CALL(fGpu->vkInterface(), GetPipelineCacheData(fGpu->device(), fPipelineCache,
+                                                                  &dataSize, data.get()));
+    if (VK_SUCCESS != result) {
+        return;
+    }
+    persistentCache->store(*pipeline_cache_key(fGpu->physicalDeviceProperties()),
+                           *SkData::MakeWithoutCopy(data.get(), dataSize));
 }
 
 GrVkPipeline* GrVkResourceProvider::createPipeline(const GrPipeline& pipeline,
@@ -68,7 +122,7 @@ GrVkPipeline* GrVkResourceProvider::createPipeline(const GrPipeline& pipeline,
 
     return GrVkPipeline::Create(fGpu, pipeline, stencil, primProc, shaderStageInfo,
                                 shaderStageCount, primitiveType, renderPass, layout,
-                                fPipelineCache);
+                                this->pipelineCache());
 }
 
 GrVkCopyPipeline* GrVkResourceProvider::findOrCreateCopyPipeline(
@@ -87,7 +141,7 @@ GrVkCopyPipeline* GrVkResourceProvider::findOrCreateCopyPipeline(
                                             pipelineLayout,
                                             dst->numColorSamples(),
                                             *dst->simpleRenderPass(),
-                                            fPipelineCache);
+                                            this->pipelineCache());
         if (!pipeline) {
             return nullptr;
         }
@@ -231,6 +285,11 @@ VkDescriptorSetLayout GrVkResourceProvider::getUniformDSLayout() const {
     return fDescriptorSetManagers[fUniformDSHandle.toIndex()]->layout();
 }
 
+VkDescriptorSetLayout GrVkResourceProvider::getDynamicUniformDSLayout() const {
+    SkASSERT(fDynamicUniformDSHandle.isValid());
+    return fDescriptorSetManagers[fDynamicUniformDSHandle.toIndex()]->layout();
+}
+
 VkDescriptorSetLayout GrVkResourceProvider::getSamplerDSLayout(
         const GrVkDescriptorSetManager::Handle& handle) const {
     SkASSERT(handle.isValid());
@@ -243,6 +302,12 @@ const GrVkDescriptorSet* GrVkResourceProvider::getUniformDescriptorSet() {
                                                                                 fUniformDSHandle);
 }
 
+const GrVkDescriptorSet* GrVkResourceProvider::getDynamicUniformDescriptorSet() {
+    SkASSERT(fDynamicUniformDSHandle.isValid());
+    return fDescriptorSetManagers[fDynamicUniformDSHandle.toIndex()]->getDescriptorSet(
+            fGpu, fDynamicUniformDSHandle);
+}
+
 const GrVkDescriptorSet* GrVkResourceProvider::getSamplerDescriptorSet(
         const GrVkDescriptorSetManager::Handle& handle) {
     SkASSERT(handle.isValid());
@@ -284,21 +349,31 @@ void GrVkResourceProvider::checkCommandBuffers() {
     }
 }
 
-GrVkSecondaryCommandBuffer* GrVkResourceProvider::findOrCreateSecondaryCommandBuffer() {
+GrVkSecondaryCommandBuffer* GrVkResourceProvider::findOrCreateSecondaryCommandBuffer(
+        bool deferred) {
+    SkTArray<GrVkSecondaryCommandBuffer*, true>& available =
+            deferred ? fAvailableDeferredCommandBuffers : fAvailableSecondaryCommandBuffers;
     GrVkSecondaryCommandBuffer* cmdBuffer = nullptr;
-    int count = fAvailableSecondaryCommandBuffers.count();
+    int count = available.count();
     if (count > 0) {
-        cmdBuffer = fAvailableSecondaryCommandBuffers[count-1];
-        fAvailableSecondaryCommandBuffers.removeShuffle(count - 1);
+        cmdBuffer = available[count-1];
+        available.removeShuffle(count - 1);
+    } else if (deferred) {
+        cmdBuffer = GrVkSecondaryCommandBuffer::CreateDeferred(fGpu);
     } else {
         cmdBuffer = GrVkSecondaryCommandBuffer::Create(fGpu, fGpu->cmdPool());
     }
+    SkASSERT(!cmdBuffer || cmdBuffer->isDeferred() == deferred);
     return cmdBuffer;
 }
 
 void GrVkResourceProvider::recycleSecondaryCommandBuffer(GrVkSecondaryCommandBuffer* cb) {
     cb->reset(fGpu);
-    fAvailableSecondaryCommandBuffers.push_back(cb);
+    if (cb->isDeferred()) {
+        fAvailableDeferredCommandBuffers.push_back(cb);
+    } else {
+        fAvailableSecondaryCommandBuffers.push_back(cb);
+    }
 }
 
 const GrVkResource* GrVkResourceProvider::findOrCreateStandardUniformBufferResource() {
@@ -341,6 +416,12 @@ void GrVkResourceProvider::destroyResources(bool deviceLost) {
     }
     fAvailableSecondaryCommandBuffers.reset();
 
+    for (int i = 0; i < fAvailableDeferredCommandBuffers.count(); ++i) {
+        SkASSERT(fAvailableDeferredCommandBuffers[i]->unique());
+        fAvailableDeferredCommandBuffers[i]->unref(fGpu);
+    }
+    fAvailableDeferredCommandBuffers.reset();
+
     // Release all copy pipelines
     for (int i = 0; i < fCopyPipelines.count(); ++i) {
         fCopyPipelines[i]->unref(fGpu);
@@ -361,9 +442,18 @@ void GrVkResourceProvider::destroyResources(bool deviceLost) {
 
     fPipelineStateCache->release();
 
+    if (!deviceLost) {
+        this->storePipelineCacheData();
+    }
     GR_VK_CALL(fGpu->vkInterface(), DestroyPipelineCache(fGpu->device(), fPipelineCache, nullptr));
     fPipelineCache = VK_NULL_HANDLE;
 
+    // The uniform ring buffer's chunks hold descriptor sets, and must go before their managers.
+    if (fUniformRingBuffer) {
+        fUniformRingBuffer->release(fGpu);
+        fUniformRingBuffer.reset();
+    }
+
     // We must release/destroy all command buffers and pipeline states before releasing the
     // GrVkDescriptorSetManagers
     for (int i = 0; i < fDescriptorSetManagers.count(); ++i) {
@@ -402,6 +492,12 @@ void GrVkResourceProvider::abandonResources() {
     }
     fAvailableSecondaryCommandBuffers.reset();
 
+    for (int i = 0; i < fAvailableDeferredCommandBuffers.count(); ++i) {
+        SkASSERT(fAvailableDeferredCommandBuffers[i]->unique());
+        fAvailableDeferredCommandBuffers[i]->unrefAndAbandon();
+    }
+    fAvailableDeferredCommandBuffers.reset();
+
     // Abandon all copy pipelines
     for (int i = 0; i < fCopyPipelines.count(); ++i) {
         fCopyPipelines[i]->unrefAndAbandon();
@@ -424,6 +520,11 @@ void GrVkResourceProvider::abandonResources() {
 
     fPipelineCache = VK_NULL_HANDLE;
 
+    if (fUniformRingBuffer) {
+        fUniformRingBuffer->abandon();
+        fUniformRingBuffer.reset();
+    }
+
     // We must abandon all command buffers and pipeline states before abandoning the
     // GrVkDescriptorSetManagers
     for (int i = 0; i < fDescriptorSetManagers.count(); ++i) {
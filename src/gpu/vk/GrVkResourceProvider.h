@@ -14,6 +14,7 @@
 #include "GrVkPipelineState.h"
 #include "GrVkRenderPass.h"
 #include "GrVkResource.h"
+#include "GrVkUniformRingBuffer.h"
 #include "GrVkUtil.h"
 #include "SkLRUCache.h"
 #include "SkTArray.h"
@@ -85,7 +86,9 @@ public:
     GrVkPrimaryCommandBuffer* findOrCreatePrimaryCommandBuffer();
     void checkCommandBuffers();
 
-    GrVkSecondaryCommandBuffer* findOrCreateSecondaryCommandBuffer();
+    // Deferred command buffers are kept apart from the others, since they each have a command pool
+    // of their own. See GrVkSecondaryCommandBuffer::CreateDeferred.
+    GrVkSecondaryCommandBuffer* findOrCreateSecondaryCommandBuffer(bool deferred = false);
     void recycleSecondaryCommandBuffer(GrVkSecondaryCommandBuffer* cb);
 
     // Finds or creates a compatible GrVkDescriptorPool for the requested type and count.
@@ -117,6 +120,10 @@ public:
     // when the caller needs the layout to create a VkPipelineLayout.
     VkDescriptorSetLayout getUniformDSLayout() const;
 
+    // Returns the VkDescriptorSetLayout for uniform buffers bound with dynamic offsets, which
+    // pipeline states that take their uniforms from the uniformRingBuffer() must use.
+    VkDescriptorSetLayout getDynamicUniformDSLayout() const;
+
     // Returns the compatible VkDescriptorSetLayout to use for a specific sampler handle. The caller
     // does not own the VkDescriptorSetLayout and thus should not delete it. This function should be
     // used when the caller needs the layout to create a VkPipelineLayout.
@@ -126,6 +133,10 @@ public:
     // is already reffed for the caller.
     const GrVkDescriptorSet* getUniformDescriptorSet();
 
+    // Returns a GrVkDescriptorSet for uniform buffers bound with dynamic offsets. The
+    // GrVkDescriptorSet is already reffed for the caller.
+    const GrVkDescriptorSet* getDynamicUniformDescriptorSet();
+
     // Returns a GrVkDescriptorSet that can be used for sampler descriptors that are compatible with
     // the GrVkDescriptorSetManager::Handle passed in. The GrVkDescriptorSet is already reffed for
     // the caller.
@@ -145,6 +156,8 @@ public:
     // can be reused by the next uniform buffer resource request.
     void recycleStandardUniformBufferResource(const GrVkResource*);
 
+    GrVkUniformRingBuffer* uniformRingBuffer() { return fUniformRingBuffer.get(); }
+
     // Destroy any cached resources. To be called before destroying the VkDevice.
     // The assumption is that all queues are idle and all command buffers are finished.
     // For resource tracing to work properly, this should be called after unrefing all other
@@ -228,6 +241,12 @@ private:
         int                           fLastReturnedIndex;
     };
 
+    // Our central cache for creating pipelines. It's made the first time it's needed, rather than
+    // in init(), so that it can start out with the data from the context's persistent cache.
+    VkPipelineCache pipelineCache();
+    // Hands the pipeline cache's data to the context's persistent cache, if there is one.
+    void storePipelineCacheData();
+
     GrVkGpu* fGpu;
 
     // Central cache for creating pipelines
@@ -245,10 +264,15 @@ private:
 
     // Array of available secondary command buffers
     SkSTArray<16, GrVkSecondaryCommandBuffer*, true> fAvailableSecondaryCommandBuffers;
+    // Array of available deferred secondary command buffers
+    SkSTArray<16, GrVkSecondaryCommandBuffer*, true> fAvailableDeferredCommandBuffers;
 
     // Array of available uniform buffer resources
     SkSTArray<16, const GrVkResource*, true> fAvailableUniformBufferResources;
 
+    // Where pipeline states with small enough uniform blocks put their uniforms
+    std::unique_ptr<GrVkUniformRingBuffer> fUniformRingBuffer;
+
     // Stores GrVkSampler objects that we've already created so we can reuse them across multiple
     // GrVkPipelineStates
     SkTDynamicHash<GrVkSampler, uint16_t> fSamplers;
@@ -259,6 +283,7 @@ private:
     SkSTArray<4, std::unique_ptr<GrVkDescriptorSetManager>> fDescriptorSetManagers;
 
     GrVkDescriptorSetManager::Handle fUniformDSHandle;
+    GrVkDescriptorSetManager::Handle fDynamicUniformDSHandle;
 };
 
 #endif
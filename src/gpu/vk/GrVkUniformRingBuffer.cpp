@@ -0,0 +1,230 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrVkUniformRingBuffer.h"
+
+#include "GrVkBuffer.h"
+#include "GrVkDescriptorSet.h"
+#include "GrVkGpu.h"
+#include "GrVkMemory.h"
+#include "GrVkUniformHandler.h"
+
+#define VK_CALL(GPU, X) GR_VK_CALL(GPU->vkInterface(), X)
+
+// This is larger than the subheaps of the uniform buffer heap, so each chunk gets device memory of
+// its own, which we can then keep mapped without getting in the way of other buffers' maps.
+static const uint32_t kChunkSize = 512 * 1024;
+
+static uint32_t align_offset(uint32_t offset, uint32_t alignment) {
+    SkASSERT(SkIsPow2(alignment));
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+VkDescriptorSet GrVkUniformRingBuffer::Chunk::descriptorSet() const {
+    return fDescriptorSet->descriptorSet();
+}
+
+void GrVkUniformRingBuffer::Chunk::freeGPUData(const GrVkGpu* gpu) const {
+    VK_CALL(gpu, UnmapMemory(gpu->device(), fAlloc.fMemory));
+    VK_CALL(gpu, DestroyBuffer(gpu->device(), fBuffer, nullptr));
+    GrVkMemory::FreeBufferMemory(gpu, GrVkBuffer::kUniform_Type, fAlloc);
+    fDescriptorSet->recycle(const_cast<GrVkGpu*>(gpu));
+}
+
+void GrVkUniformRingBuffer::Chunk::abandonGPUData() const {
+    fDescriptorSet->unrefAndAbandon();
+}
+
+void GrVkUniformRingBuffer::Chunk::onRecycle(GrVkGpu* gpu) const {
+    gpu->resourceProvider().uniformRingBuffer()->recycleChunk(this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+GrVkUniformRingBuffer::GrVkUniformRingBuffer(GrVkGpu* gpu)
+    : fCurrentChunk(nullptr)
+    , fChunkSerial(0)
+    , fOffset(0)
+    , fFlushedOffset(0) {
+    const VkPhysicalDeviceLimits& limits = gpu->physicalDeviceProperties().limits;
+    fAlignment = SkTMax<uint32_t>((uint32_t)limits.minUniformBufferOffsetAlignment, 16);
+    fNonCoherentAtomSize = limits.nonCoherentAtomSize;
+    SkASSERT(kMaxUniformSize <= limits.maxUniformBufferRange);
+}
+
+GrVkUniformRingBuffer::~GrVkUniformRingBuffer() {
+    // Must have been released or abandoned before this is destroyed
+    SkASSERT(!fCurrentChunk);
+    SkASSERT(!fAvailableChunks.count());
+}
+
+const GrVkUniformRingBuffer::Chunk* GrVkUniformRingBuffer::createChunk(GrVkGpu* gpu) {
+    VkBuffer buffer;
+    GrVkAlloc alloc;
+
+    VkBufferCreateInfo bufInfo;
+    memset(&bufInfo, 0, sizeof(VkBufferCreateInfo));
+    bufInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufInfo.flags = 0;
+    bufInfo.size = kChunkSize;
+    bufInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bufInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    bufInfo.queueFamilyIndexCount = 0;
+    bufInfo.pQueueFamilyIndices = nullptr;
+
+    VkResult err = VK_CALL(gpu, CreateBuffer(gpu->device(), &bufInfo, nullptr, &buffer));
+    if (err) {
+        return nullptr;
+    }
+
+    if (!GrVkMemory::AllocAndBindBufferMemory(gpu, buffer, GrVkBuffer::kUniform_Type,
+                                              true,  // dynamic
+                                              &alloc)) {
+        VK_CALL(gpu, DestroyBuffer(gpu->device(), buffer, nullptr));
+        return nullptr;
+    }
+    SkASSERT(0 == alloc.fOffset && alloc.fSize >= kChunkSize);
+
+    void* mapPtr;
+    err = VK_CALL(gpu, MapMemory(gpu->device(), alloc.fMemory, alloc.fOffset, alloc.fSize, 0,
+                                 &mapPtr));
+    if (err) {
+        VK_CALL(gpu, DestroyBuffer(gpu->device(), buffer, nullptr));
+        GrVkMemory::FreeBufferMemory(gpu, GrVkBuffer::kUniform_Type, alloc);
+        return nullptr;
+    }
+
+    // The chunk's descriptor set never changes: draws only move the dynamic offsets.
+    const GrVkDescriptorSet* descriptorSet =
+            gpu->resourceProvider().getDynamicUniformDescriptorSet();
+
+    static const uint32_t kBindings[2] = { GrVkUniformHandler::kGeometryBinding,
+                                           GrVkUniformHandler::kFragBinding };
+    VkDescriptorBufferInfo bufferInfo;
+    memset(&bufferInfo, 0, sizeof(VkDescriptorBufferInfo));
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = kMaxUniformSize;
+
+    VkWriteDescriptorSet descriptorWrites[2];
+    for (int i = 0; i < 2; ++i) {
+        memset(&descriptorWrites[i], 0, sizeof(VkWriteDescriptorSet));
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].pNext = nullptr;
+        descriptorWrites[i].dstSet = descriptorSet->descriptorSet();
+        descriptorWrites[i].dstBinding = kBindings[i];
+        descriptorWrites[i].dstArrayElement = 0;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorWrites[i].pImageInfo = nullptr;
+        descriptorWrites[i].pBufferInfo = &bufferInfo;
+        descriptorWrites[i].pTexelBufferView = nullptr;
+    }
+    VK_CALL(gpu, UpdateDescriptorSets(gpu->device(), 2, descriptorWrites, 0, nullptr));
+
+    return new Chunk(buffer, alloc, mapPtr, descriptorSet);
+}
+
+bool GrVkUniformRingBuffer::nextChunk(GrVkGpu* gpu) {
+    if (fCurrentChunk) {
+        this->flush(gpu);
+        const Chunk* full = fCurrentChunk;
+        fCurrentChunk = nullptr;
+        // If no command buffer is using the chunk this puts it straight back in fAvailableChunks.
+        full->recycle(gpu);
+    }
+
+    int count = fAvailableChunks.count();
+    if (count > 0) {
+        fCurrentChunk = fAvailableChunks[count - 1];
+        fAvailableChunks.removeShuffle(count - 1);
+    } else {
+        fCurrentChunk = this->createChunk(gpu);
+        if (!fCurrentChunk) {
+            return false;
+        }
+    }
+    ++fChunkSerial;
+    fOffset = 0;
+    fFlushedOffset = 0;
+    return true;
+}
+
+bool GrVkUniformRingBuffer::upload(GrVkGpu* gpu, const void* geometryData, uint32_t geometrySize,
+                                   const void* fragmentData, uint32_t fragmentSize,
+                                   Allocation* allocation) {
+    SkASSERT(CanHold(geometrySize, fragmentSize));
+    // Each descriptor covers kMaxUniformSize bytes from its offset, all of which must be in the
+    // buffer, however little of it the pipeline state reads.
+    uint32_t geometryOffset = align_offset(fOffset, fAlignment);
+    uint32_t fragmentOffset = align_offset(geometryOffset + geometrySize, fAlignment);
+    if (!fCurrentChunk || fragmentOffset + kMaxUniformSize > kChunkSize) {
+        if (!this->nextChunk(gpu)) {
+            allocation->fChunk = nullptr;
+            return false;
+        }
+        geometryOffset = 0;
+        fragmentOffset = align_offset(geometrySize, fAlignment);
+    }
+
+    if (geometrySize) {
+        memcpy(fCurrentChunk->fMapPtr + geometryOffset, geometryData, geometrySize);
+    }
+    if (fragmentSize) {
+        memcpy(fCurrentChunk->fMapPtr + fragmentOffset, fragmentData, fragmentSize);
+    }
+    fOffset = fragmentOffset + fragmentSize;
+
+    allocation->fChunk = fCurrentChunk;
+    allocation->fChunkSerial = fChunkSerial;
+    allocation->fDynamicOffsets[0] = geometryOffset;
+    allocation->fDynamicOffsets[1] = fragmentOffset;
+    return true;
+}
+
+void GrVkUniformRingBuffer::flush(GrVkGpu* gpu) {
+    if (!fCurrentChunk || fFlushedOffset == fOffset) {
+        return;
+    }
+    const GrVkAlloc& alloc = fCurrentChunk->fAlloc;
+    // Flushed ranges of non-coherent memory must start and end on atom boundaries (or at the end
+    // of the allocation).
+    VkDeviceSize start = fFlushedOffset & ~(fNonCoherentAtomSize - 1);
+    VkDeviceSize end = (fOffset + fNonCoherentAtomSize - 1) & ~(fNonCoherentAtomSize - 1);
+    end = SkTMin(end, alloc.fSize);
+    GrVkMemory::FlushMappedAlloc(gpu, alloc, alloc.fOffset + start, end - start);
+    fFlushedOffset = fOffset;
+}
+
+void GrVkUniformRingBuffer::recycleChunk(const Chunk* chunk) {
+    SkASSERT(chunk && chunk != fCurrentChunk);
+    fAvailableChunks.push_back(chunk);
+}
+
+void GrVkUniformRingBuffer::release(const GrVkGpu* gpu) {
+    if (fCurrentChunk) {
+        fCurrentChunk->unref(gpu);
+        fCurrentChunk = nullptr;
+    }
+    for (int i = 0; i < fAvailableChunks.count(); ++i) {
+        SkASSERT(fAvailableChunks[i]->unique());
+        fAvailableChunks[i]->unref(gpu);
+    }
+    fAvailableChunks.reset();
+}
+
+void GrVkUniformRingBuffer::abandon() {
+    if (fCurrentChunk) {
+        fCurrentChunk->unrefAndAbandon();
+        fCurrentChunk = nullptr;
+    }
+    for (int i = 0; i < fAvailableChunks.count(); ++i) {
+        SkASSERT(fAvailableChunks[i]->unique());
+        fAvailableChunks[i]->unrefAndAbandon();
+    }
+    fAvailableChunks.reset();
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrVkUniformRingBuffer_DEFINED
+#define GrVkUniformRingBuffer_DEFINED
+
+#include "GrVkResource.h"
+#include "SkTArray.h"
+#include "vk/GrVkTypes.h"
+
+class GrVkDescriptorSet;
+class GrVkGpu;
+
+/**
+ * Streams the uniforms of GrVkPipelineStates through large, persistently mapped buffers, rather
+ * than giving each pipeline state buffers of its own. Each of these buffers (a Chunk) has a single
+ * descriptor set, written when the chunk is made, whose two dynamic uniform buffer descriptors each
+ * cover kMaxUniformSize bytes. Draws pick out their uniforms with dynamic offsets when they bind
+ * the set, so new uniform values cost a memcpy rather than a vkUpdateDescriptorSets (and often a
+ * new VkBuffer too).
+ *
+ * Uniforms are only ever appended to the current chunk. When it's full we move on to another one,
+ * and the old chunk is reused once the last command buffer that read from it has finished.
+ */
+class GrVkUniformRingBuffer {
+public:
+    // The largest geometry or fragment uniform block we'll take. Pipeline states with larger blocks
+    // keep using GrVkUniformBuffers.
+    static const uint32_t kMaxUniformSize = 4096;
+
+    static bool CanHold(uint32_t geometryUniformSize, uint32_t fragmentUniformSize) {
+        return geometryUniformSize <= kMaxUniformSize && fragmentUniformSize <= kMaxUniformSize;
+    }
+
+    class Chunk : public GrVkRecycledResource {
+    public:
+        VkDescriptorSet descriptorSet() const;
+
+#ifdef SK_TRACE_VK_RESOURCES
+        void dumpInfo() const override {
+            SkDebugf("GrVkUniformRingBuffer::Chunk: %d (%d refs)\n", fBuffer, this->getRefCnt());
+        }
+#endif
+
+    private:
+        friend class GrVkUniformRingBuffer;
+
+        Chunk(VkBuffer buffer, const GrVkAlloc& alloc, void* mapPtr,
+              const GrVkDescriptorSet* descriptorSet)
+            : fBuffer(buffer)
+            , fAlloc(alloc)
+            , fMapPtr(static_cast<char*>(mapPtr))
+            , fDescriptorSet(descriptorSet) {}
+
+        void freeGPUData(const GrVkGpu* gpu) const override;
+        void abandonGPUData() const override;
+        void onRecycle(GrVkGpu* gpu) const override;
+
+        VkBuffer                 fBuffer;
+        GrVkAlloc                fAlloc;
+        char*                    fMapPtr;
+        const GrVkDescriptorSet* fDescriptorSet;
+
+        typedef GrVkRecycledResource INHERITED;
+    };
+
+    // Where upload() put a pipeline state's uniforms.
+    struct Allocation {
+        const Chunk* fChunk = nullptr;
+        uint32_t     fChunkSerial = 0;
+        uint32_t     fDynamicOffsets[2];  // geometry, then fragment, in binding order
+    };
+
+    explicit GrVkUniformRingBuffer(GrVkGpu* gpu);
+    ~GrVkUniformRingBuffer();
+
+    // Copies the uniforms into the current chunk, moving on to a new one if they don't fit.
+    // Returns false if we needed a new chunk and couldn't make one.
+    bool upload(GrVkGpu* gpu, const void* geometryData, uint32_t geometrySize,
+                const void* fragmentData, uint32_t fragmentSize, Allocation* allocation);
+
+    // Returns true if what was uploaded to the allocation is in the chunk we're still filling, and
+    // so can be bound again rather than uploaded again.
+    bool isCurrent(const Allocation& allocation) const {
+        return allocation.fChunk && allocation.fChunk == fCurrentChunk &&
+               allocation.fChunkSerial == fChunkSerial;
+    }
+
+    // Makes everything written since the last flush visible to the device. This must be called
+    // before submitting command buffers that may read it.
+    void flush(GrVkGpu* gpu);
+
+    // Signals that the chunk, which no command buffer is using any more, can be filled again.
+    void recycleChunk(const Chunk* chunk);
+
+    void release(const GrVkGpu* gpu);
+    void abandon();
+
+private:
+    const Chunk* createChunk(GrVkGpu* gpu);
+    bool nextChunk(GrVkGpu* gpu);
+
+    uint32_t                         fAlignment;
+    VkDeviceSize                     fNonCoherentAtomSize;
+    const Chunk*                     fCurrentChunk;
+    uint32_t                         fChunkSerial;
+    uint32_t                         fOffset;         // where the next upload can go
+    uint32_t                         fFlushedOffset;  // everything before this has been flushed
+    SkSTArray<4, const Chunk*, true> fAvailableChunks;
+};
+
+#endif
@@ -7,8 +7,10 @@
 
 #include "GrVkUtil.h"
 
+#include "GrContextPriv.h"
 #include "vk/GrVkGpu.h"
 #include "SkSLCompiler.h"
+#include "SkStream.h"
 
 bool GrPixelConfigToVkFormat(GrPixelConfig config, VkFormat* format) {
     VkFormat dontCare;
@@ -306,37 +308,75 @@ SkSL::Program::Kind vk_shader_stage_to_skiasl_kind(VkShaderStageFlagBits stage)
     return SkSL::Program::kFragment_Kind;
 }
 
-VkShaderStageFlagBits skiasl_kind_to_vk_shader_stage(SkSL::Program::Kind kind) {
-    if (SkSL::Program::kVertex_Kind == kind) {
-        return VK_SHADER_STAGE_VERTEX_BIT;
-    }
-    if (SkSL::Program::kGeometry_Kind == kind) {
-        return VK_SHADER_STAGE_GEOMETRY_BIT;
-    }
-    SkASSERT(SkSL::Program::kFragment_Kind == kind);
-    return VK_SHADER_STAGE_FRAGMENT_BIT;
+// Turning SkSL into SPIR-V is the part of making a pipeline that the VkPipelineCache can't save us,
+// so when there's a persistent cache we keep the SPIR-V in it too. The key holds the SkSL and
+// everything else that goes into the SPIR-V, including the device, whose caps shape it.
+static sk_sp<SkData> spirv_key(const GrVkGpu* gpu, const char* shaderString,
+                               VkShaderStageFlagBits stage,
+                               const SkSL::Program::Settings& settings) {
+    VkPhysicalDeviceProperties props = gpu->physicalDeviceProperties();
+    SkDynamicMemoryWStream key;
+    key.write32(SkSetFourByteTag('s', 'p', 'r', 'v'));
+    key.write32(props.vendorID);
+    key.write32(props.deviceID);
+    key.write32(props.driverVersion);
+    key.write32(stage);
+    key.writeBool(settings.fFlipY);
+    key.writeBool(settings.fFragColorIsInOut);
+    key.writeBool(settings.fReplaceSettings);
+    key.writeBool(settings.fForceHighPrecision);
+    key.writeBool(settings.fSharpenTextures);
+    key.write(shaderString, strlen(shaderString));
+    return key.detachAsData();
 }
 
-bool GrCompileVkShaderModule(const GrVkGpu* gpu,
+bool GrCompileVkShaderModule(GrVkGpu* gpu,
                              const char* shaderString,
                              VkShaderStageFlagBits stage,
                              VkShaderModule* shaderModule,
                              VkPipelineShaderStageCreateInfo* stageInfo,
                              const SkSL::Program::Settings& settings,
                              SkSL::Program::Inputs* outInputs) {
-    std::unique_ptr<SkSL::Program> program = gpu->shaderCompiler()->convertProgram(
+    auto persistentCache = gpu->getContext()->contextPriv().getPersistentCache();
+    sk_sp<SkData> key;
+    sk_sp<SkData> cached;
+    if (persistentCache) {
+        key = spirv_key(gpu, shaderString, stage, settings);
+        cached = persistentCache->load(*key);
+    }
+
+    // The cached data is the SPIR-V followed by the program's inputs, which keeps the SPIR-V
+    // aligned for pCode.
+    SkSL::String code;
+    const void* spirv;
+    size_t spirvSize;
+    if (cached && cached->size() > sizeof(SkSL::Program::Inputs) &&
+        0 == (cached->size() - sizeof(SkSL::Program::Inputs)) % sizeof(uint32_t)) {
+        spirvSize = cached->size() - sizeof(SkSL::Program::Inputs);
+        memcpy(outInputs, cached->bytes() + spirvSize, sizeof(SkSL::Program::Inputs));
+        spirv = cached->data();
+    } else {
+        std::unique_ptr<SkSL::Program> program = gpu->shaderCompiler()->convertProgram(
                                                               vk_shader_stage_to_skiasl_kind(stage),
                                                               SkSL::String(shaderString),
                                                               settings);
-    if (!program) {
-        SkDebugf("SkSL error:\n%s\n", gpu->shaderCompiler()->errorText().c_str());
-        SkASSERT(false);
-    }
-    *outInputs = program->fInputs;
-    SkSL::String code;
-    if (!gpu->shaderCompiler()->toSPIRV(*program, &code)) {
-        SkDebugf("%s\n", gpu->shaderCompiler()->errorText().c_str());
-        return false;
+        if (!program) {
+            SkDebugf("SkSL error:\n%s\n", gpu->shaderCompiler()->errorText().c_str());
+            SkASSERT(false);
+        }
+        *outInputs = program->fInputs;
+        if (!gpu->shaderCompiler()->toSPIRV(*program, &code)) {
+            SkDebugf("%s\n", gpu->shaderCompiler()->errorText().c_str());
+            return false;
+        }
+        if (persistentCache) {
+            SkDynamicMemoryWStream data;
+            data.write(code.c_str(), code.size());
+            data.write(outInputs, sizeof(SkSL::Program::Inputs));
+            persistentCache->store(*key, *data.detachAsData());
+        }
+        spirv = code.c_str();
+        spirvSize = code.size();
     }
 
     VkShaderModuleCreateInfo moduleCreateInfo;
@@ -344,8 +384,8 @@ bool GrCompileVkShaderModule(const GrVkGpu* gpu,
     moduleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
     moduleCreateInfo.pNext = nullptr;
     moduleCreateInfo.flags = 0;
-    moduleCreateInfo.codeSize = code.size();
-    moduleCreateInfo.pCode = (const uint32_t*)code.c_str();
+    moduleCreateInfo.codeSize = spirvSize;
+    moduleCreateInfo.pCode = (const uint32_t*)spirv;
 
     VkResult err = GR_VK_CALL(gpu->vkInterface(), CreateShaderModule(gpu->device(),
                                                                      &moduleCreateInfo,
@@ -359,7 +399,7 @@ bool GrCompileVkShaderModule(const GrVkGpu* gpu,
     stageInfo->sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     stageInfo->pNext = nullptr;
     stageInfo->flags = 0;
-    stageInfo->stage = skiasl_kind_to_vk_shader_stage(program->fKind);
+    stageInfo->stage = stage;
     stageInfo->module = *shaderModule;
     stageInfo->pName = "main";
     stageInfo->pSpecializationInfo = nullptr;
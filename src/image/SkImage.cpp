@@ -9,6 +9,8 @@
 #include "SkBitmapCache.h"
 #include "SkCanvas.h"
 #include "SkData.h"
+#include "SkExecutor.h"
+#include "SkGraphics.h"
 #include "SkImageEncoder.h"
 #include "SkImageFilter.h"
 #include "SkImageFilterCache.h"
@@ -127,6 +129,9 @@ sk_sp<SkImage> SkImage::MakeFromEncoded(sk_sp<SkData> encoded, const SkIRect* su
     if (nullptr == encoded || 0 == encoded->size()) {
         return nullptr;
     }
+    if (SkGraphics::GetSharedEncodedImageCountLimit() > 0) {
+        return SkSharedEncodedImageCache::Global()->makeImage(std::move(encoded), subset);
+    }
     return SkImage::MakeFromGenerator(SkImageGenerator::MakeFromEncoded(encoded), subset);
 }
 
@@ -363,6 +368,25 @@ sk_sp<SkImage> SkImage::makeRasterImage() const {
     return SkImage::MakeRasterData(info, std::move(data), rowBytes);
 }
 
+void SkImage::makeDecodedAsync(SkExecutor* executor, SkColorSpace* dstColorSpace,
+                               DecodeCompleteProc proc) const {
+    if (!executor || !this->isLazyGenerated()) {
+        proc(this->makeRasterImage());
+        return;
+    }
+    sk_sp<SkImage> image = sk_ref_sp(const_cast<SkImage*>(this));
+    sk_sp<SkColorSpace> colorSpace = sk_ref_sp(dstColorSpace);
+    executor->add([image, colorSpace, proc] {
+        // This adds the pixels to SkBitmapCache, where later draws of image will find them.
+        SkBitmap bitmap;
+        if (!as_IB(image)->getROPixels(&bitmap, colorSpace.get(), kAllow_CachingHint)) {
+            proc(nullptr);
+            return;
+        }
+        proc(SkImage::MakeFromBitmap(bitmap));
+    });
+}
+
 //////////////////////////////////////////////////////////////////////////////////////
 
 #if !SK_SUPPORT_GPU
@@ -77,6 +77,9 @@ public:
     virtual sk_sp<SkImage> onMakeSubset(const SkIRect&) const = 0;
 
     virtual SkData* onRefEncoded() const { return nullptr; }
+    // The bounds of this image in the image that onRefEncoded() decodes to. Subsets of lazy
+    // images share the encoded data of the whole image.
+    virtual SkIRect onEncodedSubset() const { return this->bounds(); }
 
     virtual bool onAsLegacyBitmap(SkBitmap*) const;
 
@@ -11,9 +11,13 @@
 #include "SkBitmap.h"
 #include "SkBitmapCache.h"
 #include "SkData.h"
+#include "SkGraphics.h"
 #include "SkImageGenerator.h"
 #include "SkImagePriv.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 #include "SkNextID.h"
+#include "SkOpts.h"
 #include "SkPixelRef.h"
 
 #if SK_SUPPORT_GPU
@@ -86,6 +90,9 @@ public:
                                             SkScalar scaleAdjust[2]) const override;
 #endif
     SkData* onRefEncoded() const override;
+    SkIRect onEncodedSubset() const override {
+        return SkIRect::MakeXYWH(fOrigin.x(), fOrigin.y(), fInfo.width(), fInfo.height());
+    }
     sk_sp<SkImage> onMakeSubset(const SkIRect&) const override;
     bool getROPixels(SkBitmap*, SkColorSpace* dstColorSpace, CachingHint) const override;
     bool onIsLazyGenerated() const override { return true; }
@@ -666,6 +673,105 @@ sk_sp<SkImage> SkImage::MakeFromGenerator(std::unique_ptr<SkImageGenerator> gene
     return validator ? sk_make_sp<SkImage_Lazy>(&validator) : nullptr;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// The generators of recently made images, by their encoded bytes, so that images made from the
+// same bytes share one generator, and so one unique ID and one cached decode.
+namespace {
+
+struct EncodedKey {
+    uint32_t      fHash;
+    sk_sp<SkData> fEncoded;
+
+    bool operator==(const EncodedKey& that) const {
+        return fHash == that.fHash && fEncoded->equals(that.fEncoded.get());
+    }
+};
+
+struct EncodedKeyHash {
+    uint32_t operator()(const EncodedKey& key) const { return key.fHash; }
+};
+
+}  // namespace
+
+struct SkSharedEncodedImageCache::Entries {
+    using Generators = SkLRUCache<EncodedKey, sk_sp<SharedGenerator>, EncodedKeyHash>;
+
+    SkMutex                     fMutex;
+    std::unique_ptr<Generators> fGenerators;  // Guarded by fMutex, null when the limit is zero.
+};
+
+SkSharedEncodedImageCache::SkSharedEncodedImageCache(int countLimit, Factory factory)
+        : fEntries(new Entries)
+        , fCountLimit(0)
+        , fFactory(factory ? factory : SkImageGenerator::MakeFromEncoded) {
+    this->setCountLimit(countLimit);
+}
+
+SkSharedEncodedImageCache::~SkSharedEncodedImageCache() {}
+
+SkSharedEncodedImageCache* SkSharedEncodedImageCache::Global() {
+    // Leaked, so images can still be made while other statics are destroyed.
+    static SkSharedEncodedImageCache* gCache = new SkSharedEncodedImageCache(0);
+    return gCache;
+}
+
+int SkSharedEncodedImageCache::setCountLimit(int count) {
+    SkAutoMutexAcquire lock(fEntries->fMutex);
+    count = SkTMax(count, 0);
+    // SkLRUCache can't change its limit, so start over.
+    fEntries->fGenerators.reset(count ? new Entries::Generators(count) : nullptr);
+    return fCountLimit.exchange(count);
+}
+
+void SkSharedEncodedImageCache::purgeAll() {
+    SkAutoMutexAcquire lock(fEntries->fMutex);
+    if (fEntries->fGenerators) {
+        fEntries->fGenerators->reset();
+    }
+}
+
+sk_sp<SkImage> SkSharedEncodedImageCache::makeImage(sk_sp<SkData> encoded,
+                                                    const SkIRect* subset) {
+    // Hash outside the lock; it reads every byte.
+    EncodedKey key = { SkOpts::hash(encoded->data(), encoded->size()), encoded };
+    sk_sp<SharedGenerator> gen;
+    {
+        SkAutoMutexAcquire lock(fEntries->fMutex);
+        if (fEntries->fGenerators) {
+            if (sk_sp<SharedGenerator>* found = fEntries->fGenerators->find(key)) {
+                gen = *found;
+            }
+        }
+    }
+
+    if (!gen) {
+        gen = SharedGenerator::Make(fFactory(encoded));
+        if (gen) {
+            SkAutoMutexAcquire lock(fEntries->fMutex);
+            if (fEntries->fGenerators) {
+                // Another thread may have made one while we were; use theirs.
+                if (sk_sp<SharedGenerator>* existing = fEntries->fGenerators->find(key)) {
+                    gen = *existing;
+                } else {
+                    fEntries->fGenerators->insert(key, gen);
+                }
+            }
+        }
+    }
+
+    SkImage_Lazy::Validator validator(std::move(gen), subset, nullptr);
+    return validator ? sk_make_sp<SkImage_Lazy>(&validator) : nullptr;
+}
+
+int SkGraphics::SetSharedEncodedImageCountLimit(int count) {
+    return SkSharedEncodedImageCache::Global()->setCountLimit(count);
+}
+
+int SkGraphics::GetSharedEncodedImageCountLimit() {
+    return SkSharedEncodedImageCache::Global()->getCountLimit();
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -120,6 +120,48 @@ void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
     }
 }
 
+static int64_t area(const SkIRect& r) {
+    return sk_64_mul(r.width(), r.height());
+}
+
+void SkSurface_Base::addDamage(const SkIRect& rect) {
+    if (!fTrackingDamage) {
+        return;
+    }
+    SkIRect damage = rect;
+    if (!damage.intersect(SkIRect::MakeWH(this->width(), this->height()))) {
+        return;
+    }
+    for (int i = fDamage.count() - 1; i >= 0; --i) {
+        if (fDamage[i].contains(damage)) {
+            return;
+        }
+        if (damage.contains(fDamage[i])) {
+            fDamage.removeShuffle(i);
+        }
+    }
+    fDamage.push_back(damage);
+
+    if (fDamage.count() > kMaxDamageRects) {
+        int mergeA = 0, mergeB = 1;
+        int64_t leastGrowth = SK_MaxS64;
+        for (int a = 0; a < fDamage.count(); ++a) {
+            for (int b = a + 1; b < fDamage.count(); ++b) {
+                SkIRect merged = fDamage[a];
+                merged.join(fDamage[b]);
+                int64_t growth = area(merged) - area(fDamage[a]) - area(fDamage[b]);
+                if (growth < leastGrowth) {
+                    leastGrowth = growth;
+                    mergeA = a;
+                    mergeB = b;
+                }
+            }
+        }
+        fDamage[mergeA].join(fDamage[mergeB]);
+        fDamage.removeShuffle(mergeB);
+    }
+}
+
 uint32_t SkSurface_Base::newGenerationID() {
     SkASSERT(!fCachedCanvas || fCachedCanvas->getSurfaceBase() == this);
     static int32_t gID;
@@ -157,6 +199,36 @@ uint32_t SkSurface::generationID() {
 
 void SkSurface::notifyContentWillChange(ContentChangeMode mode) {
     asSB(this)->aboutToDraw(mode);
+    asSB(this)->addDamage(SkIRect::MakeWH(this->width(), this->height()));
+}
+
+void SkSurface::setTrackDamage(bool track) {
+    SkSurface_Base* sb = asSB(this);
+    if (track && !sb->fTrackingDamage) {
+        sb->fDamage.reset();
+    }
+    sb->fTrackingDamage = track;
+}
+
+SkIRect SkSurface::takeDamage(std::vector<SkIRect>* rects) {
+    SkSurface_Base* sb = asSB(this);
+    if (!sb->fTrackingDamage) {
+        SkIRect bounds = SkIRect::MakeWH(this->width(), this->height());
+        if (rects) {
+            rects->assign(1, bounds);
+        }
+        return bounds;
+    }
+
+    SkIRect damage = SkIRect::MakeEmpty();
+    for (const SkIRect& r : sb->fDamage) {
+        damage.join(r);
+    }
+    if (rects) {
+        rects->assign(sb->fDamage.begin(), sb->fDamage.end());
+    }
+    sb->fDamage.reset();
+    return damage;
 }
 
 SkCanvas* SkSurface::getCanvas() {
@@ -207,6 +279,7 @@ void SkSurface::writePixels(const SkPixmap& pmap, int x, int y) {
             mode = kDiscard_ContentChangeMode;
         }
         asSB(this)->aboutToDraw(mode);
+        asSB(this)->addDamage(srcR);
         asSB(this)->onWritePixels(pmap, x, y);
     }
 }
@@ -328,4 +401,8 @@ sk_sp<SkSurface> SkSurface::MakeFromBackendTextureAsRenderTarget(GrContext*,
     return nullptr;
 }
 
+bool SkSurface::DrawBatch(int, SkSurface* const[], SkDeferredDisplayList* const[]) {
+    return false;
+}
+
 #endif
@@ -12,6 +12,7 @@
 #include "SkImagePriv.h"
 #include "SkSurface.h"
 #include "SkSurfacePriv.h"
+#include "SkTArray.h"
 
 class SkSurface_Base : public SkSurface {
 public:
@@ -112,9 +113,21 @@ public:
     // called by SkSurface to compute a new genID
     uint32_t newGenerationID();
 
+    bool isTrackingDamage() const { return fTrackingDamage; }
+
+    /**
+     *  If tracking damage, adds rect, in surface pixels, to it. The damage is kept as a few
+     *  rects; past kMaxDamageRects, the two whose union adds the least area are merged.
+     */
+    void addDamage(const SkIRect& rect);
+
 private:
+    static constexpr int kMaxDamageRects = 8;
+
     std::unique_ptr<SkCanvas>   fCachedCanvas;
     sk_sp<SkImage>              fCachedImage;
+    bool                        fTrackingDamage = false;
+    SkSTArray<kMaxDamageRects + 1, SkIRect> fDamage;
 
     void aboutToDraw(ContentChangeMode mode);
 
@@ -288,6 +288,44 @@ bool SkSurface_Gpu::onDraw(const SkDeferredDisplayList* ddl) {
     return true;
 }
 
+bool SkSurface::DrawBatch(int count, SkSurface* const surfaces[],
+                          SkDeferredDisplayList* const ddls[]) {
+    if (count <= 0) {
+        return false;
+    }
+
+    GrContext* ctx = nullptr;
+    SkSTArray<16, GrRenderTargetProxy*, true> newDests(count);
+    for (int i = 0; i < count; ++i) {
+        if (!surfaces[i] || !ddls[i]) {
+            return false;
+        }
+        // Only GPU surfaces have a GrContext.
+        GrContext* surfaceCtx = surfaces[i]->getCanvas()->getGrContext();
+        if (!surfaceCtx || (ctx && surfaceCtx != ctx)) {
+            return false;
+        }
+        ctx = surfaceCtx;
+
+        SkSurface_Gpu* surface = static_cast<SkSurface_Gpu*>(surfaces[i]);
+        if (!surface->isCompatible(ddls[i]->characterization())) {
+            return false;
+        }
+        // A DDL only remembers the last surface it was drawn into until the next flush.
+        for (int j = 0; j < i; ++j) {
+            if (ddls[j] == ddls[i]) {
+                return false;
+            }
+        }
+        newDests.push_back(surface->getDevice()->accessRenderTargetContext()
+                                  ->asRenderTargetProxy());
+    }
+
+    ctx->contextPriv().copyOpListsFromDDLs(count, ddls, newDests.begin());
+    ctx->flush();
+    return true;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
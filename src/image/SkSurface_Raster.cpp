@@ -6,6 +6,7 @@
  */
 
 #include "SkSurface_Base.h"
+#include "SkCOWPixelRef.h"
 #include "SkImageInfoPriv.h"
 #include "SkImagePriv.h"
 #include "SkCanvas.h"
@@ -17,7 +18,8 @@ public:
     SkSurface_Raster(const SkImageInfo&, void*, size_t rb,
                      void (*releaseProc)(void* pixels, void* context), void* context,
                      const SkSurfaceProps*);
-    SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef>, const SkSurfaceProps*);
+    SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef>, bool cowPixels,
+                     const SkSurfaceProps*);
 
     SkCanvas* onNewCanvas() override;
     sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
@@ -31,6 +33,7 @@ private:
     SkBitmap    fBitmap;
     size_t      fRowBytes;
     bool        fWeOwnThePixels;
+    bool        fCOWPixels;         // Our pixel ref is from SkCOWPixelRef.
 
     typedef SkSurface_Base INHERITED;
 };
@@ -108,9 +111,10 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, void* pixels, size_t
     fBitmap.installPixels(info, pixels, rb, releaseProc, context);
     fRowBytes = 0;              // don't need to track the rowbytes
     fWeOwnThePixels = false;    // We are "Direct"
+    fCOWPixels = false;
 }
 
-SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef> pr,
+SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef> pr, bool cowPixels,
                                    const SkSurfaceProps* props)
     : INHERITED(pr->width(), pr->height(), props)
 {
@@ -118,6 +122,7 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef> pr
     fRowBytes = pr->rowBytes(); // we track this, so that subsequent re-allocs will match
     fBitmap.setPixelRef(std::move(pr), 0, 0);
     fWeOwnThePixels = true;
+    fCOWPixels = cowPixels;
 }
 
 SkCanvas* SkSurface_Raster::onNewCanvas() { return new SkCanvas(fBitmap, this->props()); }
@@ -165,7 +170,18 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     SkASSERT(cached);
     if (SkBitmapImageGetPixelRef(cached.get()) == fBitmap.pixelRef()) {
         SkASSERT(fWeOwnThePixels);
-        if (kDiscard_ContentChangeMode == mode) {
+        // The image's pixels won't change again, so a copy-on-write pixel ref can share their
+        // pages, copying only those we go on to draw into.
+        sk_sp<SkPixelRef> cow;
+        if (fCOWPixels) {
+            cow = kDiscard_ContentChangeMode == mode
+                ? SkCOWPixelRef::MakeZeroed(fBitmap.info(), fRowBytes)
+                : SkCOWPixelRef::MakeCopy(fBitmap.pixelRef());
+            fCOWPixels = SkToBool(cow);
+        }
+        if (cow) {
+            fBitmap.setPixelRef(std::move(cow), 0, 0);
+        } else if (kDiscard_ContentChangeMode == mode) {
             fBitmap.allocPixels();
         } else {
             SkBitmap prev(fBitmap);
@@ -213,12 +229,25 @@ sk_sp<SkSurface> SkSurface::MakeRaster(const SkImageInfo& info, size_t rowBytes,
         return nullptr;
     }
 
-    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeZeroed(info, rowBytes);
+    // Big surfaces are often snapshotted and then drawn into again while the snapshot is still
+    // in use, e.g. being encoded.  Copy-on-write pixels make that cost only the pages we redraw,
+    // but they hold a file descriptor and are shared across fork(), so callers must ask for them.
+    static const size_t kMinCOWPixelsBytes = 4 << 20;
+    sk_sp<SkPixelRef> pr;
+    bool cowPixels = false;
+    if (props && (props->flags() & SkSurfaceProps::kCopyOnWritePixels_Flag) &&
+        info.computeByteSize(rowBytes ? rowBytes : info.minRowBytes()) >= kMinCOWPixelsBytes) {
+        pr = SkCOWPixelRef::MakeZeroed(info, rowBytes);
+        cowPixels = SkToBool(pr);
+    }
+    if (!pr) {
+        pr = SkMallocPixelRef::MakeZeroed(info, rowBytes);
+    }
     if (!pr) {
         return nullptr;
     }
     if (rowBytes) {
         SkASSERT(pr->rowBytes() == rowBytes);
     }
-    return sk_make_sp<SkSurface_Raster>(info, std::move(pr), props);
+    return sk_make_sp<SkSurface_Raster>(info, std::move(pr), cowPixels, props);
 }
@@ -20,7 +20,6 @@
 #include "SkPreConfig.h"
 #include "SkRasterPipeline.h"
 #include "SkUnPreMultiply.h"
-#include "SkUnPreMultiplyPriv.h"
 #include "../jumper/SkJumper.h"
 
 /**
@@ -152,7 +151,7 @@ static inline void transform_scanline_444(char* SK_RESTRICT dst, const char* SK_
  */
 static inline void transform_scanline_rgbA(char* SK_RESTRICT dst, const char* SK_RESTRICT src,
                                            int width, int, const SkPMColor*) {
-    SkUnpremultiplyRow<false>((uint32_t*) dst, (const uint32_t*) src, width);
+    SkOpts::rgbA_to_RGBA((uint32_t*) dst, src, width);
 }
 
 /**
@@ -160,7 +159,7 @@ static inline void transform_scanline_rgbA(char* SK_RESTRICT dst, const char* SK
  */
 static inline void transform_scanline_bgrA(char* SK_RESTRICT dst, const char* SK_RESTRICT src,
                                            int width, int, const SkPMColor*) {
-    SkUnpremultiplyRow<true>((uint32_t*) dst, (const uint32_t*) src, width);
+    SkOpts::rgbA_to_BGRA((uint32_t*) dst, src, width);
 }
 
 template <bool kIsRGBA>
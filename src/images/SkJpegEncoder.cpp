@@ -10,14 +10,18 @@
 #ifdef SK_HAS_JPEG_LIBRARY
 
 #include "SkColorData.h"
+#include "SkExecutor.h"
 #include "SkImageEncoderFns.h"
 #include "SkImageInfoPriv.h"
 #include "SkJpegEncoder.h"
 #include "SkJPEGWriteUtility.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 
+#include <atomic>
 #include <stdio.h>
+#include <vector>
 
 extern "C" {
     #include "jpeglib.h"
@@ -179,27 +183,28 @@ bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder
     return true;
 }
 
-std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
-                                               const Options& options) {
-    if (!SkPixmapIsValid(src, options.fBlendBehavior)) {
-        return nullptr;
-    }
-
-    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
-
+// Sets the compression parameters and writes the headers.  A non-zero |restartInterval| (in MCUs)
+// also turns off Huffman table optimization, so that separately encoded intervals share tables.
+static bool start_compress(SkJpegEncoderMgr* encoderMgr, const SkImageInfo& info,
+                           const SkJpegEncoder::Options& options, unsigned restartInterval) {
     skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
     if (setjmp(jmp)) {
-        return nullptr;
+        return false;
     }
 
-    if (!encoderMgr->setParams(src.info(), options)) {
-        return nullptr;
+    if (!encoderMgr->setParams(info, options)) {
+        return false;
+    }
+
+    if (restartInterval) {
+        encoderMgr->cinfo()->optimize_coding = FALSE;
+        encoderMgr->cinfo()->restart_interval = restartInterval;
     }
 
     jpeg_set_quality(encoderMgr->cinfo(), options.fQuality, TRUE);
     jpeg_start_compress(encoderMgr->cinfo(), TRUE);
 
-    sk_sp<SkData> icc = icc_from_color_space(src.info());
+    sk_sp<SkData> icc = icc_from_color_space(info);
     if (icc) {
         // Create a contiguous block of memory with the icc signature followed by the profile.
         sk_sp<SkData> markerData =
@@ -214,6 +219,49 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& s
         jpeg_write_marker(encoderMgr->cinfo(), kICCMarker, markerData->bytes(), markerData->size());
     }
 
+    return true;
+}
+
+// Writes |numRows| rows of |src| starting at |firstRow|, and finishes the image after its last
+// row.  |storage| must hold a transformed row if the encoder has a proc.
+static bool write_rows(SkJpegEncoderMgr* encoderMgr, const SkPixmap& src, int firstRow,
+                       int numRows, uint8_t* storage) {
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return false;
+    }
+
+    const void* srcRow = src.addr(0, firstRow);
+    for (int i = 0; i < numRows; i++) {
+        JSAMPLE* jpegSrcRow = (JSAMPLE*) srcRow;
+        if (encoderMgr->proc()) {
+            encoderMgr->proc()((char*)storage, (const char*)srcRow, src.width(),
+                               encoderMgr->cinfo()->input_components, nullptr);
+            jpegSrcRow = storage;
+        }
+
+        jpeg_write_scanlines(encoderMgr->cinfo(), &jpegSrcRow, 1);
+        srcRow = SkTAddOffset<const void>(srcRow, src.rowBytes());
+    }
+
+    if (firstRow + numRows == src.height()) {
+        jpeg_finish_compress(encoderMgr->cinfo());
+    }
+
+    return true;
+}
+
+std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
+                                               const Options& options) {
+    if (!SkPixmapIsValid(src, options.fBlendBehavior)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
+    if (!start_compress(encoderMgr.get(), src.info(), options, 0)) {
+        return nullptr;
+    }
+
     return std::unique_ptr<SkJpegEncoder>(new SkJpegEncoder(std::move(encoderMgr), src));
 }
 
@@ -225,33 +273,139 @@ SkJpegEncoder::SkJpegEncoder(std::unique_ptr<SkJpegEncoderMgr> encoderMgr, const
 SkJpegEncoder::~SkJpegEncoder() {}
 
 bool SkJpegEncoder::onEncodeRows(int numRows) {
-    skjpeg_error_mgr::AutoPushJmpBuf jmp(fEncoderMgr->errorMgr());
-    if (setjmp(jmp)) {
+    if (!write_rows(fEncoderMgr.get(), fSrc, fCurrRow, numRows, fStorage.get())) {
         return false;
     }
 
-    const void* srcRow = fSrc.addr(0, fCurrRow);
-    for (int i = 0; i < numRows; i++) {
-        JSAMPLE* jpegSrcRow = (JSAMPLE*) srcRow;
-        if (fEncoderMgr->proc()) {
-            fEncoderMgr->proc()((char*)fStorage.get(), (const char*)srcRow, fSrc.width(),
-                                fEncoderMgr->cinfo()->input_components, nullptr);
-            jpegSrcRow = fStorage.get();
+    fCurrRow += numRows;
+    return true;
+}
+
+// Returns the number of rows in each band of a parallel encode, or 0 if |src| shouldn't be split.
+// Bands are whole MCU rows, and |restartInterval| is set to the number of MCUs in a band.
+static int parallel_band_rows(const SkPixmap& src, const SkJpegEncoder::Options& options,
+                              unsigned* restartInterval) {
+    // Roughly the number of rows in a band.
+    constexpr int kBandRows = 128;
+
+    int mcuWidth = 8, mcuHeight = 8;
+    if (kGray_8_SkColorType != src.colorType()) {
+        switch (options.fDownsample) {
+            case SkJpegEncoder::Downsample::k420:
+                mcuWidth = mcuHeight = 16;
+                break;
+            case SkJpegEncoder::Downsample::k422:
+                mcuWidth = 16;
+                break;
+            case SkJpegEncoder::Downsample::k444:
+                break;
         }
+    }
 
-        jpeg_write_scanlines(fEncoderMgr->cinfo(), &jpegSrcRow, 1);
-        srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
+    // The restart interval is stored in 16 bits.
+    const int mcusPerRow = (src.width() + mcuWidth - 1) / mcuWidth;
+    const int bandMCURows = SkTMin(kBandRows / mcuHeight, 0xFFFF / mcusPerRow);
+    if (bandMCURows < 1 || src.height() <= bandMCURows * mcuHeight) {
+        return 0;
     }
 
-    fCurrRow += numRows;
-    if (fCurrRow == fSrc.height()) {
-        jpeg_finish_compress(fEncoderMgr->cinfo());
+    *restartInterval = bandMCURows * mcusPerRow;
+    return bandMCURows * mcuHeight;
+}
+
+// Returns the offset of the entropy coded data that follows the SOS segment of a jpeg written by
+// libjpeg, or 0 if it is not found.  Sets |sofHeight| to the offset of the height in the SOF
+// segment.
+static size_t find_scan_data(const uint8_t* data, size_t size, size_t* sofHeight) {
+    size_t offset = 2;
+    while (offset + 4 <= size && 0xFF == data[offset]) {
+        const uint8_t marker = data[offset + 1];
+        const size_t length = (data[offset + 2] << 8) | data[offset + 3];
+        if (0xC0 == marker || 0xC1 == marker) {
+            *sofHeight = offset + 5;
+        }
+        offset += 2 + length;
+        if (0xDA == marker) {
+            return offset <= size ? offset : 0;
+        }
     }
+    return 0;
+}
 
-    return true;
+// Encodes each band as a separate jpeg with a single restart interval, and stitches their
+// entropy coded data together with restart markers.  libjpeg ends a restart interval the same
+// way it ends the image, so the result matches a single encode with that restart interval.
+static bool encode_in_parallel(SkWStream* dst, const SkPixmap& src,
+                               const SkJpegEncoder::Options& options, int bandRows,
+                               unsigned restartInterval) {
+    const int numBands = (src.height() + bandRows - 1) / bandRows;
+    std::vector<sk_sp<SkData>> bands(numBands);
+    std::atomic<bool> success(true);
+
+    SkTaskGroup taskGroup(*options.fExecutor);
+    taskGroup.batch(numBands, [&](int i) {
+        SkPixmap band;
+        const int firstRow = i * bandRows;
+        src.extractSubset(&band, SkIRect::MakeXYWH(0, firstRow, src.width(),
+                                                   SkTMin(bandRows, src.height() - firstRow)));
+
+        SkDynamicMemoryWStream stream;
+        std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(&stream);
+        if (!start_compress(encoderMgr.get(), band.info(), options, restartInterval)) {
+            success = false;
+            return;
+        }
+        SkAutoTMalloc<uint8_t> storage(
+                encoderMgr->proc() ? encoderMgr->cinfo()->input_components * src.width() : 0);
+        if (!write_rows(encoderMgr.get(), band, 0, band.height(), storage.get())) {
+            success = false;
+            return;
+        }
+        bands[i] = stream.detachAsData();
+    });
+    taskGroup.wait();
+    if (!success) {
+        return false;
+    }
+
+    for (int i = 0; i < numBands; i++) {
+        const uint8_t* data = bands[i]->bytes();
+        const size_t size = bands[i]->size();
+        size_t sofHeight = 0;
+        const size_t scanData = find_scan_data(data, size, &sofHeight);
+        if (!scanData || !sofHeight || size < scanData + 2 ||
+                0xFF != data[size - 2] || 0xD9 != data[size - 1]) {
+            return false;
+        }
+
+        if (0 == i) {
+            // Keep the headers of the first band, with the height of the whole image.
+            const uint8_t height[2] = { (uint8_t) (src.height() >> 8), (uint8_t) src.height() };
+            if (!dst->write(data, sofHeight) || !dst->write(height, sizeof(height)) ||
+                !dst->write(data + sofHeight + 2, size - 2 - (sofHeight + 2))) {
+                return false;
+            }
+        } else {
+            const uint8_t restart[2] = { 0xFF, (uint8_t) (0xD0 + ((i - 1) & 7)) };
+            if (!dst->write(restart, sizeof(restart)) ||
+                !dst->write(data + scanData, size - 2 - scanData)) {
+                return false;
+            }
+        }
+    }
+
+    const uint8_t eoi[2] = { 0xFF, 0xD9 };
+    return dst->write(eoi, sizeof(eoi));
 }
 
 bool SkJpegEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    if (options.fExecutor && SkPixmapIsValid(src, options.fBlendBehavior)) {
+        unsigned restartInterval;
+        if (int bandRows = parallel_band_rows(src, options, &restartInterval)) {
+            return encode_in_parallel(dst, src, options, bandRows, restartInterval);
+        }
+    }
+
     auto encoder = SkJpegEncoder::Make(dst, src, options);
     return encoder.get() && encoder->encodeRows(src.height());
 }
@@ -10,14 +10,20 @@
 #ifdef SK_HAS_PNG_LIBRARY
 
 #include "SkColorTable.h"
+#include "SkExecutor.h"
 #include "SkImageEncoderFns.h"
 #include "SkImageInfoPriv.h"
 #include "SkStream.h"
 #include "SkString.h"
 #include "SkPngEncoder.h"
 #include "SkPngPriv.h"
+#include "SkTaskGroup.h"
 
 #include "png.h"
+#include "zlib.h"
+
+#include <atomic>
+#include <vector>
 
 static_assert(PNG_FILTER_NONE  == (int)SkPngEncoder::FilterFlag::kNone,  "Skia libpng filter err.");
 static_assert(PNG_FILTER_SUB   == (int)SkPngEncoder::FilterFlag::kSub,   "Skia libpng filter err.");
@@ -420,9 +426,226 @@ bool SkPngEncoder::onEncodeRows(int numRows) {
     return true;
 }
 
+// Filters a row with one of the PNG filter types.  'prev' is the previous unfiltered row, or
+// zeros for the first row.  'bpp' is the number of bytes per complete pixel, rounded up to one.
+static void filter_row(int type, const uint8_t* row, const uint8_t* prev, size_t rowBytes,
+                       size_t bpp, uint8_t* dst) {
+    auto paeth = [](int a, int b, int c) {
+        int p = a + b - c;
+        int pa = SkTAbs(p - a),
+            pb = SkTAbs(p - b),
+            pc = SkTAbs(p - c);
+        return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+    };
+
+    // The pixel to the left of the first pixel is treated as zero.
+    const size_t first = SkTMin(bpp, rowBytes);
+    switch (type) {
+        case 0:
+            memcpy(dst, row, rowBytes);
+            break;
+        case 1:
+            memcpy(dst, row, first);
+            for (size_t i = first; i < rowBytes; i++) {
+                dst[i] = row[i] - row[i - bpp];
+            }
+            break;
+        case 2:
+            for (size_t i = 0; i < rowBytes; i++) {
+                dst[i] = row[i] - prev[i];
+            }
+            break;
+        case 3:
+            for (size_t i = 0; i < first; i++) {
+                dst[i] = row[i] - (prev[i] >> 1);
+            }
+            for (size_t i = first; i < rowBytes; i++) {
+                dst[i] = row[i] - ((row[i - bpp] + prev[i]) >> 1);
+            }
+            break;
+        case 4:
+            for (size_t i = 0; i < first; i++) {
+                dst[i] = row[i] - prev[i];
+            }
+            for (size_t i = first; i < rowBytes; i++) {
+                dst[i] = row[i] - paeth(row[i - bpp], prev[i], prev[i - bpp]);
+            }
+            break;
+    }
+}
+
+// Writes the filter type byte and the filtered row to 'dst'.  When several filters are allowed,
+// this picks the one with the smallest sum of absolute (signed) values, like libpng does.
+static void filter_row(int filterFlags, const uint8_t* row, const uint8_t* prev, size_t rowBytes,
+                       size_t bpp, uint8_t* scratch, uint8_t* dst) {
+    static constexpr int kFlags[] = { PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP,
+                                      PNG_FILTER_AVG, PNG_FILTER_PAETH };
+    int best = -1;
+    uint64_t bestSum = 0;
+    for (int type = 0; type < 5; type++) {
+        if (!(filterFlags & kFlags[type])) {
+            continue;
+        }
+        uint8_t* filtered = best < 0 ? dst + 1 : scratch;
+        filter_row(type, row, prev, rowBytes, bpp, filtered);
+        if (filterFlags == kFlags[type]) {
+            best = type;
+            break;
+        }
+        uint64_t sum = 0;
+        for (size_t i = 0; i < rowBytes; i++) {
+            sum += filtered[i] < 128 ? filtered[i] : 256 - filtered[i];
+        }
+        if (best < 0 || sum < bestSum) {
+            if (best >= 0) {
+                memcpy(dst + 1, scratch, rowBytes);
+            }
+            best = type;
+            bestSum = sum;
+        }
+    }
+    dst[0] = (uint8_t) best;
+}
+
+bool SkPngEncoder::encodeInParallel(const Options& options) {
+    png_structp pngPtr = fEncoderMgr->pngPtr();
+    const size_t rowBytes = png_get_rowbytes(pngPtr, fEncoderMgr->infoPtr());
+    if (rowBytes != fEncoderMgr->pngBytesPerPixel() * (size_t) fSrc.width()) {
+        // libpng strips the filler from opaque F16 rows.
+        return this->encodeRows(fSrc.height());
+    }
+
+    // Bands are about 1MB of filtered data.  Each band's deflate stream is primed with the
+    // (up to) 32KB of filtered data before it, like pigz does, so splitting the image costs
+    // very little compression.
+    constexpr size_t kBandBytes = 1 << 20;
+    constexpr size_t kWindowBytes = 1 << 15;
+    const size_t filteredRowBytes = rowBytes + 1;
+    const int height = fSrc.height();
+    const int bandRows = (int) SkTMax<size_t>(1, kBandBytes / filteredRowBytes);
+    const int dictRows = (int) ((kWindowBytes + filteredRowBytes - 1) / filteredRowBytes);
+    const int numBands = (height + bandRows - 1) / bandRows;
+    if (numBands < 2) {
+        return this->encodeRows(height);
+    }
+
+    const size_t bpp = SkTMax<size_t>(1, rowBytes / fSrc.width());
+    int filters = (int)options.fFilterFlags & (int)FilterFlag::kAll;
+    if (!filters) {
+        filters = PNG_FILTER_NONE;
+    }
+    const int zlibLevel = SkTMin(SkTMax(0, options.fZLibLevel), 9);
+    // Matches libpng's default strategy.
+    const int strategy = PNG_FILTER_NONE == filters ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+
+    struct Band {
+        SkAutoTMalloc<uint8_t> fData;
+        size_t                 fSize;
+        size_t                 fFilteredSize;
+        uLong                  fAdler;
+    };
+    std::vector<Band> bands(numBands);
+    std::atomic<bool> success(true);
+    auto proc = fEncoderMgr->proc();
+    const SkPixmap& src = fSrc;
+    auto encodeBand = [&](int i) {
+        const int firstRow = i * bandRows,
+                  endRow   = SkTMin(firstRow + bandRows, height),
+                  dictRow  = SkTMax(0, firstRow - dictRows);
+        const int srcBPP = SkColorTypeBytesPerPixel(src.colorType());
+
+        // Transform and filter this band, and the rows before it that prime the window.
+        SkAutoTMalloc<uint8_t> rows(2 * rowBytes), scratch(rowBytes),
+                               filtered((endRow - dictRow) * filteredRowBytes);
+        uint8_t* prev = rows.get();
+        uint8_t* curr = rows.get() + rowBytes;
+        if (dictRow > 0) {
+            proc((char*) prev, (const char*) src.addr(0, dictRow - 1), src.width(), srcBPP,
+                 nullptr);
+        } else {
+            memset(prev, 0, rowBytes);
+        }
+        for (int y = dictRow; y < endRow; y++) {
+            proc((char*) curr, (const char*) src.addr(0, y), src.width(), srcBPP, nullptr);
+            filter_row(filters, curr, prev, rowBytes, bpp, scratch.get(),
+                       filtered.get() + (y - dictRow) * filteredRowBytes);
+            std::swap(prev, curr);
+        }
+
+        const size_t dictSize = SkTMin(kWindowBytes, (firstRow - dictRow) * filteredRowBytes);
+        const uint8_t* input = filtered.get() + (firstRow - dictRow) * filteredRowBytes;
+        const size_t inputSize = (endRow - firstRow) * filteredRowBytes;
+
+        Band& band = bands[i];
+        band.fFilteredSize = inputSize;
+        band.fAdler = adler32(adler32(0, nullptr, 0), input, (uInt) inputSize);
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (Z_OK != deflateInit2(&stream, zlibLevel, Z_DEFLATED, -15, 8, strategy)) {
+            success = false;
+            return;
+        }
+        if (dictSize) {
+            deflateSetDictionary(&stream, input - dictSize, (uInt) dictSize);
+        }
+        // Sync flushes end a band on a byte boundary without ending the stream, so the bands
+        // can be concatenated.  Only the last band finishes the stream.
+        const size_t bound = deflateBound(&stream, (uLong) inputSize) + 16;
+        band.fData.reset(bound);
+        stream.next_in = const_cast<uint8_t*>(input);
+        stream.avail_in = (uInt) inputSize;
+        stream.next_out = band.fData.get();
+        stream.avail_out = (uInt) bound;
+        const bool last = i == numBands - 1;
+        int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        if (last ? Z_STREAM_END != result : (Z_OK != result || stream.avail_in)) {
+            success = false;
+        }
+        band.fSize = bound - stream.avail_out;
+        deflateEnd(&stream);
+    };
+
+    SkTaskGroup taskGroup(*options.fExecutor);
+    taskGroup.batch(numBands, encodeBand);
+    taskGroup.wait();
+    if (!success) {
+        return false;
+    }
+
+    if (setjmp(png_jmpbuf(pngPtr))) {
+        return false;
+    }
+
+    // The zlib header, with the same compression level hint zlib writes.
+    const int levelFlags = zlibLevel < 2 ? 0 : zlibLevel < 6 ? 1 : zlibLevel == 6 ? 2 : 3;
+    uint8_t header[2] = { 0x78, (uint8_t) (levelFlags << 6) };
+    header[1] += 31 - (header[0] * 256 + header[1]) % 31;
+    png_write_chunk(pngPtr, (png_const_bytep) "IDAT", header, sizeof(header));
+
+    uLong adler = adler32(0, nullptr, 0);
+    for (const Band& band : bands) {
+        png_write_chunk(pngPtr, (png_const_bytep) "IDAT", band.fData.get(), band.fSize);
+        adler = adler32_combine(adler, band.fAdler, (z_off_t) band.fFilteredSize);
+    }
+    const uint8_t trailer[4] = { (uint8_t) (adler >> 24), (uint8_t) (adler >> 16),
+                                 (uint8_t) (adler >>  8), (uint8_t) (adler >>  0) };
+    png_write_chunk(pngPtr, (png_const_bytep) "IDAT", trailer, sizeof(trailer));
+    png_write_chunk(pngPtr, (png_const_bytep) "IEND", nullptr, 0);
+
+    fCurrRow = height;
+    return true;
+}
+
 bool SkPngEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
     auto encoder = SkPngEncoder::Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    if (!encoder) {
+        return false;
+    }
+    if (options.fExecutor) {
+        return static_cast<SkPngEncoder*>(encoder.get())->encodeInParallel(options);
+    }
+    return encoder->encodeRows(src.height());
 }
 
 #endif
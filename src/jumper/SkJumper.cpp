@@ -5,41 +5,108 @@
  * found in the LICENSE file.
  */
 
+#include "SkChecksum.h"
+#include "SkCounters.h"
+#include "SkJSONWriter.h"
 #include "SkJumper.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkTHash.h"
+#include "SkTInternalLList.h"
+#include "SkTLS.h"
 #include "SkTemplates.h"
+#include "SkTraceEvent.h"
+#include <atomic>
+#include <vector>
 
-SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip) const {
+constexpr int SkRasterPipeline::kNumStockStages;
+
+static const char* kStockStageNames[] = {
+#define M(st) #st,
+    SK_RASTER_PIPELINE_STAGES(M)
+#undef M
+};
+
+#ifndef SK_JUMPER_DISABLE_8BIT
+// How many pipelines have used a stage with no lowp implementation, so run in highp.
+static std::atomic<int> gHighpFallbacks{0};
+#endif
+
+void SkRasterPipeline::init_profile(SkJumper_ProfileCtx* profileCtxs, uint64_t* last,
+                                    uint64_t* cycles, uint64_t* pixels) const {
+    // profileCtxs[0] is for the profile stage before the first stage, and profileCtxs[i] for
+    // the one after the i-th stage of fStages, counting back to front.
+    profileCtxs[0] = { last, nullptr, nullptr };
+    for (int i = 1; i <= fNumStages; i++) {
+        cycles[i] = pixels[i] = 0;
+        profileCtxs[i] = { last, &cycles[i], &pixels[i] };
+    }
+}
+
+void SkRasterPipeline::add_profile(StageProfiles* profiles,
+                                   const uint64_t* cycles, const uint64_t* pixels) const {
+    int i = 1;
+    for (const StageList* st = fStages; st; st = st->prev, i++) {
+        int index = st->rawFunction ? kNumStockStages : (int)st->stage;
+        profiles->fCycles[index].fetch_add(cycles[i], std::memory_order_relaxed);
+        profiles->fPixels[index].fetch_add(pixels[i], std::memory_order_relaxed);
+    }
+}
+
+SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(
+        void** ip, void*** program, const SkJumper_ProfileCtx* profileCtxs) const {
 #ifndef SK_JUMPER_DISABLE_8BIT
     // We'll try to build a lowp pipeline, but if that fails fallback to a highp float pipeline.
     void** reset_point = ip;
+    SkOpts::StageFn profile_lowp = SkOpts::stages_lowp[SkRasterPipeline::profile];
 
     // Stages are stored backwards in fStages, so we reverse here, back to front.
     *--ip = (void*)SkOpts::just_return_lowp;
-    for (const StageList* st = fStages; st; st = st->prev) {
+    int i = 1;
+    for (const StageList* st = fStages; st; st = st->prev, i++) {
         if (st->stage == SkRasterPipeline::clamp_0 ||
             st->stage == SkRasterPipeline::clamp_1) {
             continue;  // No-ops in lowp.
         }
         SkOpts::StageFn fn;
-        if (!st->rawFunction && (fn = SkOpts::stages_lowp[st->stage])) {
+        if (!st->rawFunction && (fn = SkOpts::stages_lowp[st->stage])
+                             && (profile_lowp || !profileCtxs)) {
+            if (profileCtxs) {
+                *--ip = (void*)&profileCtxs[i];
+                *--ip = (void*)profile_lowp;
+            }
             if (st->ctx) {
                 *--ip = st->ctx;
             }
             *--ip = (void*)fn;
         } else {
+            // Count the pipelines that fall back to highp, and note the stage that made them.
+            TRACE_COUNTER1("skia", "SkRasterPipeline highp fallbacks", ++gHighpFallbacks);
+            SkCounters::Add(SkCounter::kPipelineHighpFallbacks);
+            TRACE_EVENT_INSTANT1("skia", "SkRasterPipeline::highp_fallback",
+                                 TRACE_EVENT_SCOPE_THREAD, "stage",
+                                 st->rawFunction ? "raw function" : kStockStageNames[st->stage]);
             ip = reset_point;
             break;
         }
     }
     if (ip != reset_point) {
+        if (profileCtxs) {
+            *--ip = (void*)&profileCtxs[0];
+            *--ip = (void*)profile_lowp;
+        }
+        *program = ip;
         return SkOpts::start_pipeline_lowp;
     }
 #endif
 
     *--ip = (void*)SkOpts::just_return_highp;
-    for (const StageList* st = fStages; st; st = st->prev) {
+    int j = 1;
+    for (const StageList* st = fStages; st; st = st->prev, j++) {
+        if (profileCtxs) {
+            *--ip = (void*)&profileCtxs[j];
+            *--ip = (void*)SkOpts::stages_highp[SkRasterPipeline::profile];
+        }
         if (st->ctx) {
             *--ip = st->ctx;
         }
@@ -49,30 +116,284 @@ SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip) co
             *--ip = (void*)SkOpts::stages_highp[st->stage];
         }
     }
+    if (profileCtxs) {
+        *--ip = (void*)&profileCtxs[0];
+        *--ip = (void*)SkOpts::stages_highp[SkRasterPipeline::profile];
+    }
+    *program = ip;
     return SkOpts::start_pipeline_highp;
 }
 
-void SkRasterPipeline::run(size_t x, size_t y, size_t w, size_t h) const {
+static SkRasterPipeline::StageProfiles* global_stage_profiles() {
+    static auto* profiles = new SkRasterPipeline::StageProfiles;
+    return profiles;
+}
+
+void SkRasterPipeline::run(size_t x, size_t y, size_t w, size_t h,
+                           StageProfiles* profiles) const {
     if (this->empty()) {
         return;
     }
 
+    if (!profiles && gSkRasterPipelineProfileStages) {
+        profiles = global_stage_profiles();
+    }
+    if (profiles) {
+        // This run counts into its own totals, so runs on other threads can't race with it.
+        SkAutoSTMalloc<64, void*> program(fSlotsNeeded + this->profile_slots());
+        SkAutoSTMalloc<32, SkJumper_ProfileCtx> profileCtxs(fNumStages + 1);
+        SkAutoSTMalloc<64, uint64_t> counts(2*(fNumStages + 1));
+        uint64_t last = 0;
+        uint64_t* cycles = counts.get();
+        uint64_t* pixels = counts.get() + fNumStages + 1;
+        this->init_profile(profileCtxs.get(), &last, cycles, pixels);
+
+        void** first;
+        auto start_pipeline = this->build_pipeline(program.get() + fSlotsNeeded
+                                                                 + this->profile_slots(),
+                                                   &first, profileCtxs.get());
+        start_pipeline(x,y,x+w,y+h, first);
+        this->add_profile(profiles, cycles, pixels);
+        return;
+    }
+
     // Best to not use fAlloc here... we can't bound how often run() will be called.
     SkAutoSTMalloc<64, void*> program(fSlotsNeeded);
 
-    auto start_pipeline = this->build_pipeline(program.get() + fSlotsNeeded);
-    start_pipeline(x,y,x+w,y+h, program.get());
+    void** first;
+    auto start_pipeline = this->build_pipeline(program.get() + fSlotsNeeded, &first);
+    start_pipeline(x,y,x+w,y+h, first);
+}
+
+uint32_t SkRasterPipeline::program_hash() const {
+    uint32_t hash = fNumStages;
+    for (const StageList* st = fStages; st; st = st->prev) {
+        hash = SkChecksum::Mix(hash ^ (uint32_t)st->stage ^ (uint32_t)(st->stage >> 32));
+        hash = SkChecksum::Mix(hash ^ (st->ctx ? 1 : 0) ^ (st->rawFunction ? 2 : 0));
+    }
+    return hash;
+}
+
+// The compiled form of a pipeline with its contexts left out: the start function, and the
+// function of each stage (nullptr if the stage is dropped, e.g. clamps in lowp). Stages are kept
+// in the same back to front order as SkRasterPipeline::fStages.
+//
+// Each thread keeps its own cache, so compile() never waits on another thread's lookup.
+class SkRasterPipelineProgramCache {
+public:
+    static constexpr int kMaxCount = 128;
+
+    static SkRasterPipelineProgramCache* Get() {
+        return static_cast<SkRasterPipelineProgramCache*>(SkTLS::Get(Create, Delete));
+    }
+
+    // Fill program (with fSlotsNeeded slots) from a cached entry, pointing *first at its first
+    // slot like build_pipeline() does. Returns nullptr on a miss.
+    SkRasterPipeline::StartPipelineFn fill(const SkRasterPipeline& pipeline, uint32_t hash,
+                                           void** program, void*** first) {
+        Entry** found = fMap.find(hash);
+        if (!found || !(*found)->matches(pipeline)) {
+            fMisses++;
+            return nullptr;
+        }
+        Entry* entry = *found;
+        fLRU.remove(entry);
+        fLRU.addToHead(entry);
+        fHits++;
+
+        void** ip = program + pipeline.fSlotsNeeded;
+        *--ip = entry->fJustReturn;
+        int i = 0;
+        for (auto st = pipeline.fStages; st; st = st->prev, i++) {
+            if (void* fn = entry->fFns[i]) {
+                if (st->ctx) {
+                    *--ip = st->ctx;
+                }
+                *--ip = fn;
+            }
+        }
+        *first = ip;
+        return entry->fStart;
+    }
+
+    // Remember the choices build_pipeline() made for pipeline, which compiled into program.
+    void add(const SkRasterPipeline& pipeline, uint32_t hash,
+             SkRasterPipeline::StartPipelineFn start, void** program) {
+        std::unique_ptr<Entry> entry(new Entry);
+        entry->fHash  = hash;
+        entry->fStart = start;
+
+        void** ip = program + pipeline.fSlotsNeeded;
+        entry->fJustReturn = *--ip;
+        // The only stages build_pipeline() ever drops are the clamps in lowp.
+        bool lowp = entry->fJustReturn != (void*)SkOpts::just_return_highp;
+        for (auto st = pipeline.fStages; st; st = st->prev) {
+            entry->fStages.push_back({st->stage, st->ctx != nullptr, st->rawFunction});
+            if (lowp && !st->rawFunction && (st->stage == SkRasterPipeline::clamp_0 ||
+                                             st->stage == SkRasterPipeline::clamp_1)) {
+                entry->fFns.push_back(nullptr);
+                continue;
+            }
+            if (st->ctx) {
+                --ip;
+            }
+            entry->fFns.push_back(*--ip);
+        }
+
+        if (Entry** found = fMap.find(hash)) {
+            // A hash collision. Replace it.
+            this->remove(*found);
+        }
+        fMap.set(hash, entry.get());
+        fLRU.addToHead(entry.release());
+        while (fMap.count() > kMaxCount) {
+            this->remove(fLRU.tail());
+        }
+    }
+
+    SkRasterPipeline::ProgramCacheStats stats() const {
+        return { fHits, fMisses, fMap.count() };
+    }
+
+    void purge() {
+        while (Entry* entry = fLRU.head()) {
+            this->remove(entry);
+        }
+        fHits = fMisses = 0;
+    }
+
+private:
+    struct Stage {
+        uint64_t stage;
+        bool     hasCtx;
+        bool     rawFunction;
+    };
+
+    struct Entry {
+        bool matches(const SkRasterPipeline& pipeline) const {
+            if ((int)fStages.size() != pipeline.fNumStages) {
+                return false;
+            }
+            int i = 0;
+            for (auto st = pipeline.fStages; st; st = st->prev, i++) {
+                if (fStages[i].stage       != st->stage              ||
+                    fStages[i].hasCtx      != (st->ctx != nullptr)   ||
+                    fStages[i].rawFunction != st->rawFunction) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        uint32_t                          fHash;
+        SkRasterPipeline::StartPipelineFn fStart;
+        void*                             fJustReturn;
+        std::vector<Stage>                fStages;
+        std::vector<void*>                fFns;
+
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+    };
+
+    static void* Create() { return new SkRasterPipelineProgramCache; }
+    static void Delete(void* cache) { delete static_cast<SkRasterPipelineProgramCache*>(cache); }
+
+    ~SkRasterPipelineProgramCache() { this->purge(); }
+
+    void remove(Entry* entry) {
+        fMap.remove(entry->fHash);
+        fLRU.remove(entry);
+        delete entry;
+    }
+
+    SkTHashMap<uint32_t, Entry*>   fMap;
+    SkTInternalLList<Entry>        fLRU;
+    int                            fHits   = 0;
+    int                            fMisses = 0;
+};
+
+SkRasterPipeline::ProgramCacheStats SkRasterPipeline::GetProgramCacheStats() {
+    return SkRasterPipelineProgramCache::Get()->stats();
 }
 
-std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile() const {
+void SkRasterPipeline::PurgeProgramCache() {
+    SkRasterPipelineProgramCache::Get()->purge();
+}
+
+std::atomic<bool> gSkRasterPipelineProfileStages{false};
+
+SkRasterPipeline::StageProfile SkRasterPipeline::StageProfiles::get(StockStage stage) const {
+    return { fPixels[stage].load(std::memory_order_relaxed),
+             fCycles[stage].load(std::memory_order_relaxed) };
+}
+
+void SkRasterPipeline::StageProfiles::reset() {
+    for (int i = 0; i <= kNumStockStages; i++) {
+        fPixels[i].store(0, std::memory_order_relaxed);
+        fCycles[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void SkRasterPipeline::StageProfiles::dump(SkJSONWriter* writer) const {
+    writer->beginArray();
+    for (int i = 0; i <= kNumStockStages; i++) {
+        uint64_t pixels = fPixels[i].load(std::memory_order_relaxed),
+                 cycles = fCycles[i].load(std::memory_order_relaxed);
+        if (!pixels) {
+            continue;
+        }
+        writer->beginObject(nullptr, false);
+        writer->appendString("stage", i < kNumStockStages ? kStockStageNames[i] : "raw");
+        writer->appendU64("pixels", pixels);
+        writer->appendU64("cycles", cycles);
+        writer->appendDouble("cycles_per_pixel", (double)cycles / pixels);
+        writer->endObject();
+    }
+    writer->endArray();
+}
+
+SkRasterPipeline::StageProfile SkRasterPipeline::GetStageProfile(StockStage stage) {
+    return global_stage_profiles()->get(stage);
+}
+
+void SkRasterPipeline::ResetStageProfile() {
+    global_stage_profiles()->reset();
+}
+
+void SkRasterPipeline::DumpStageProfile(SkJSONWriter* writer) {
+    global_stage_profiles()->dump(writer);
+}
+
+std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile(
+        StageProfiles* profiles) const {
     if (this->empty()) {
         return [](size_t, size_t, size_t, size_t) {};
     }
 
+    if (!profiles && gSkRasterPipelineProfileStages) {
+        profiles = global_stage_profiles();
+    }
+    if (profiles) {
+        // Profiled programs aren't cached.  Each call builds its own, like run(), so that calls
+        // on several threads don't share counters.  The thunk may outlive this pipeline (but not
+        // fAlloc), so it runs a copy.
+        auto copy = fAlloc->make<SkRasterPipeline>(fAlloc);
+        copy->extend(*this);
+        return [=](size_t x, size_t y, size_t w, size_t h) {
+            copy->run(x,y,w,h, profiles);
+        };
+    }
+
     void** program = fAlloc->makeArray<void*>(fSlotsNeeded);
 
-    auto start_pipeline = this->build_pipeline(program + fSlotsNeeded);
+    auto cache = SkRasterPipelineProgramCache::Get();
+    uint32_t hash = this->program_hash();
+    void** first;
+    auto start_pipeline = cache->fill(*this, hash, program, &first);
+    if (!start_pipeline) {
+        start_pipeline = this->build_pipeline(program + fSlotsNeeded, &first);
+        cache->add(*this, hash, start_pipeline, program);
+    }
     return [=](size_t x, size_t y, size_t w, size_t h) {
-        start_pipeline(x,y,x+w,y+h, program);
+        start_pipeline(x,y,x+w,y+h, first);
     };
 }
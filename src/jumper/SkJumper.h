@@ -52,6 +52,25 @@ struct SkJumper_DecalTileCtx {
     float    limit_y;
 };
 
+// bilerp_tile_8888 repeats or mirrors each sample point along an axis, or leaves it to be clamped.
+static const int SkJumper_kTileClamp  = 0,
+                 SkJumper_kTileRepeat = 1,
+                 SkJumper_kTileMirror = 2;
+
+struct SkJumper_BilerpTileCtx {
+    SkJumper_GatherCtx gather;
+    SkJumper_TileCtx   limit_x, limit_y;
+    int                tile_x, tile_y;   // SkJumper_kTileClamp, kTileRepeat or kTileMirror.
+};
+
+// SkRasterPipeline places a profile stage before the first stage and after every stage when
+// profiling.  Each adds the time since the last one ran to the stage just before it.
+struct SkJumper_ProfileCtx {
+    uint64_t* last;     // When the last profile stage in this program ran.
+    uint64_t* cycles;   // Where to add the time since then and the pixels it covered,
+    uint64_t* pixels;   // or both null for the profile stage before the first stage.
+};
+
 struct SkJumper_CallbackCtx {
     void (*fn)(SkJumper_CallbackCtx* self, int active_pixels/*<= SkJumper_kMaxStride*/);
 
@@ -88,6 +107,25 @@ struct SkJumper_GradientCtx {
     float* ts;
 };
 
+// rgba[] hold the color for t < 0, then size samples evenly spaced over [0,1], then the last
+// sample again, so that the sample after any t in [0,1] is in bounds.
+struct SkJumper_GradientLUTCtx {
+    int          size;
+    const float* rgba[4];
+};
+
+// An analytic rrect shadow, in device space: the rrect's center, the half extents of its
+// corners' centers, and its corner radius, then the width of the shadow's falloff inward from the
+// rrect's edge, where it clamps, and how far in from the edge it's drawn.
+struct SkJumper_RRectShadowCtx {
+    float cx, cy,
+          hx, hy,
+          radius,
+          invBlurWidth,
+          blurClamp,
+          insetWidth;
+};
+
 struct SkJumper_2PtConicalCtx {
     uint32_t fMask[SkJumper_kMaxStride];
     float    fP0,
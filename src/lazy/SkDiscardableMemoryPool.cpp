@@ -13,9 +13,25 @@
 #include "SkTInternalLList.h"
 #include "SkTemplates.h"
 
+#include <atomic>
+
+#if defined(SK_BUILD_FOR_UNIX) && defined(__linux__)
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #if defined(MADV_FREE)
+        #define SK_DISCARDABLE_MADV_FREE
+    #endif
+#endif
+
 // Note:
 // A PoolDiscardableMemory is memory that is counted in a pool.
 // A DiscardableMemoryPool is a pool of PoolDiscardableMemorys.
+//
+// On Linux, big PoolDiscardableMemorys are mapped straight from the kernel, and their pages are
+// marked MADV_FREE while they're unlocked.  Under memory pressure the kernel can take those pages
+// back without waiting for the pool to purge, and until it does, lock() gets them back as they
+// were.  Before marking the pages, unlock() moves the first word of each page aside and writes
+// kPageCookie there; a page the kernel took reads as zeros, so lock() fails if any cookie is gone.
 
 namespace {
 
@@ -78,7 +94,8 @@ private:
  */
 class PoolDiscardableMemory : public SkDiscardableMemory {
 public:
-    PoolDiscardableMemory(sk_sp<DiscardableMemoryPool> pool, SkAutoFree pointer, size_t bytes);
+    PoolDiscardableMemory(sk_sp<DiscardableMemoryPool> pool, void* pointer, size_t bytes,
+                          size_t mappedBytes);
     ~PoolDiscardableMemory() override;
     bool lock() override;
     void* data() override;
@@ -86,16 +103,62 @@ public:
     friend class DiscardableMemoryPool;
 private:
     SK_DECLARE_INTERNAL_LLIST_INTERFACE(PoolDiscardableMemory);
+
+    /** Frees the memory; fPointer becomes nullptr. */
+    void release();
+    /** Lets the kernel take the pages of mapped memory until reclaimPages(). */
+    void allowPageReclaim();
+    /** Takes the pages back; returns false if the kernel took any of them. */
+    bool reclaimPages();
+
     sk_sp<DiscardableMemoryPool> fPool;
     bool                         fLocked;
-    SkAutoFree                   fPointer;
+    void*                        fPointer;
     const size_t                 fBytes;
+    const size_t                 fMappedBytes;   // 0 if fPointer was malloc'd.
+    SkAutoTMalloc<intptr_t>      fSavedWords;    // First word of each page while reclaimable.
+    bool                         fReclaimable;
 };
 
+#if defined(SK_DISCARDABLE_MADV_FREE)
+// Smaller allocations stay in malloc, where they don't each take up whole pages.
+static constexpr size_t kMinMappedBytes = 64 * 1024;
+static constexpr intptr_t kPageCookie = (intptr_t)0x5ca1ab1e;
+
+static size_t page_size() {
+    static const size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    return size;
+}
+#endif
+
+// Returns the memory for a PoolDiscardableMemory of the given size, and sets mappedBytes to the
+// size of its mapping, or 0 if it's from malloc.
+static void* alloc_discardable(size_t bytes, size_t* mappedBytes) {
+    *mappedBytes = 0;
+#if defined(SK_DISCARDABLE_MADV_FREE)
+    if (bytes >= kMinMappedBytes) {
+        const size_t size = (bytes + page_size() - 1) / page_size() * page_size();
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                          -1, 0);
+        if (addr != MAP_FAILED) {
+            *mappedBytes = size;
+            return addr;
+        }
+    }
+#endif
+    return sk_malloc_canfail(bytes);
+}
+
 PoolDiscardableMemory::PoolDiscardableMemory(sk_sp<DiscardableMemoryPool> pool,
-                                             SkAutoFree pointer,
-                                             size_t bytes)
-        : fPool(std::move(pool)), fLocked(true), fPointer(std::move(pointer)), fBytes(bytes) {
+                                             void* pointer,
+                                             size_t bytes,
+                                             size_t mappedBytes)
+        : fPool(std::move(pool))
+        , fLocked(true)
+        , fPointer(pointer)
+        , fBytes(bytes)
+        , fMappedBytes(mappedBytes)
+        , fReclaimable(false) {
     SkASSERT(fPool != nullptr);
     SkASSERT(fPointer != nullptr);
     SkASSERT(fBytes > 0);
@@ -104,6 +167,72 @@ PoolDiscardableMemory::PoolDiscardableMemory(sk_sp<DiscardableMemoryPool> pool,
 PoolDiscardableMemory::~PoolDiscardableMemory() {
     SkASSERT(!fLocked); // contract for SkDiscardableMemory
     fPool->removeFromPool(this);
+    this->release();
+}
+
+void PoolDiscardableMemory::release() {
+    if (!fPointer) {
+        return;
+    }
+#if defined(SK_DISCARDABLE_MADV_FREE)
+    if (fMappedBytes) {
+        munmap(fPointer, fMappedBytes);
+    } else
+#endif
+    {
+        sk_free(fPointer);
+    }
+    fPointer = nullptr;
+    fSavedWords.reset(0);
+    fReclaimable = false;
+}
+
+void PoolDiscardableMemory::allowPageReclaim() {
+#if defined(SK_DISCARDABLE_MADV_FREE)
+    SkASSERT(fPointer && !fLocked && !fReclaimable);
+    if (!fMappedBytes) {
+        return;
+    }
+    const size_t pages = fMappedBytes / page_size();
+    if (!fSavedWords) {
+        fSavedWords.reset(pages);
+    }
+    char* base = (char*)fPointer;
+    for (size_t i = 0; i < pages; i++) {
+        intptr_t* word = (intptr_t*)(base + i * page_size());
+        fSavedWords[i] = *word;
+        *word = kPageCookie;
+    }
+    if (madvise(fPointer, fMappedBytes, MADV_FREE) == 0) {
+        fReclaimable = true;
+        return;
+    }
+    // Kernels before 4.5 don't know MADV_FREE.  The pages stay put until the pool purges them.
+    for (size_t i = 0; i < pages; i++) {
+        *(intptr_t*)(base + i * page_size()) = fSavedWords[i];
+    }
+#endif
+}
+
+bool PoolDiscardableMemory::reclaimPages() {
+#if defined(SK_DISCARDABLE_MADV_FREE)
+    if (!fReclaimable) {
+        return true;
+    }
+    fReclaimable = false;
+    const size_t pages = fMappedBytes / page_size();
+    char* base = (char*)fPointer;
+    for (size_t i = 0; i < pages; i++) {
+        // Writing to a page keeps the kernel from taking it, so swapping the saved word back in
+        // for the cookie both checks that the page is still there and holds on to it.
+        auto word = reinterpret_cast<std::atomic<intptr_t>*>(base + i * page_size());
+        intptr_t expected = kPageCookie;
+        if (!word->compare_exchange_strong(expected, fSavedWords[i])) {
+            return false;
+        }
+    }
+#endif
+    return true;
 }
 
 bool PoolDiscardableMemory::lock() {
@@ -113,7 +242,7 @@ bool PoolDiscardableMemory::lock() {
 
 void* PoolDiscardableMemory::data() {
     SkASSERT(fLocked); // contract for SkDiscardableMemory
-    return fPointer.get();
+    return fPointer;
 }
 
 void PoolDiscardableMemory::unlock() {
@@ -150,7 +279,7 @@ void DiscardableMemoryPool::dumpDownTo(size_t budget) {
         if (!cur->fLocked) {
             PoolDiscardableMemory* dm = cur;
             SkASSERT(dm->fPointer != nullptr);
-            dm->fPointer = nullptr;
+            dm->release();
             SkASSERT(fUsed >= dm->fBytes);
             fUsed -= dm->fBytes;
             cur = iter.prev();
@@ -164,11 +293,13 @@ void DiscardableMemoryPool::dumpDownTo(size_t budget) {
 }
 
 std::unique_ptr<SkDiscardableMemory> DiscardableMemoryPool::make(size_t bytes) {
-    SkAutoFree addr(sk_malloc_canfail(bytes));
+    size_t mappedBytes;
+    void* addr = alloc_discardable(bytes, &mappedBytes);
     if (nullptr == addr) {
         return nullptr;
     }
-    auto dm = skstd::make_unique<PoolDiscardableMemory>(sk_ref_sp(this), std::move(addr), bytes);
+    auto dm = skstd::make_unique<PoolDiscardableMemory>(sk_ref_sp(this), addr, bytes,
+                                                        mappedBytes);
     SkAutoMutexAcquire autoMutexAcquire(fMutex);
     fList.addToHead(dm.get());
     fUsed += bytes;
@@ -198,6 +329,17 @@ bool DiscardableMemoryPool::lock(PoolDiscardableMemory* dm) {
         #endif  // SK_LAZY_CACHE_STATS
         return false;
     }
+    if (!dm->reclaimPages()) {
+        // The kernel took some of its pages.
+        dm->release();
+        SkASSERT(fUsed >= dm->fBytes);
+        fUsed -= dm->fBytes;
+        fList.remove(dm);
+        #if SK_LAZY_CACHE_STATS
+        ++fCacheMisses;
+        #endif  // SK_LAZY_CACHE_STATS
+        return false;
+    }
     dm->fLocked = true;
     fList.remove(dm);
     fList.addToHead(dm);
@@ -212,6 +354,9 @@ void DiscardableMemoryPool::unlock(PoolDiscardableMemory* dm) {
     SkAutoMutexAcquire autoMutexAcquire(fMutex);
     dm->fLocked = false;
     this->dumpDownTo(fBudget);
+    if (dm->fPointer) {
+        dm->allowPageReclaim();
+    }
 }
 
 size_t DiscardableMemoryPool::getRAMUsed() {
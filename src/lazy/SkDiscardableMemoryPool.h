@@ -24,6 +24,10 @@
  *  budget of memory.  When the allocated memory exceeds this size,
  *  unlocked blocks of memory are purged.  If all memory is locked, it
  *  can exceed the memory-use budget.
+ *
+ *  On Linux, the kernel may also take back the pages of big unlocked
+ *  blocks when it runs short of memory, before the budget is reached;
+ *  lock() then fails as if the pool had purged them.
  */
 class SkDiscardableMemoryPool : public SkDiscardableMemory::Factory {
 public:
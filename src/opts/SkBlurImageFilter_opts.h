@@ -0,0 +1,64 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurImageFilter_opts_DEFINED
+#define SkBlurImageFilter_opts_DEFINED
+
+#include "SkNx.h"
+
+#include <algorithm>
+
+namespace SK_OPTS_NS {
+
+// Averages each scaleX x scaleY block of the first rows rows of src into one dst pixel. src is
+// transparent past srcW and rows, so partial blocks at the edges are darkened as a blur would.
+static inline void blur_downsample_row(const uint32_t* src, int srcRowBytesAsPixels, int srcW,
+                                       int rows, int scaleX, int scaleY, uint32_t* dst, int dstW) {
+    auto divisor = scaleX * scaleY;
+    SkASSERT(divisor > 1);
+
+    // Same rounding divide as the blur itself: (sum + divisor/2) * 2^32/divisor >> 32.
+    auto weight = static_cast<uint32_t>(((1ull << 32) + divisor / 2) / divisor);
+    auto half = static_cast<uint32_t>((divisor + 1) / 2);
+
+    for (int x = 0; x < dstW; x++) {
+        const int left = x * scaleX,
+                  right = std::min(left + scaleX, srcW);
+        Sk4u sum{half};
+        const uint32_t* row = src;
+        for (int y = 0; y < rows; y++) {
+            for (int i = left; i < right; i++) {
+                sum += SkNx_cast<uint32_t>(Sk4b::Load(row + i));
+            }
+            row += srcRowBytesAsPixels;
+        }
+        SkNx_cast<uint8_t>(sum.mulHi(weight)).store(dst + x);
+    }
+}
+
+// Interpolates one dst row between src rows row0 and row1, weighted weightY/256 towards row1.
+// Each dst pixel x lies between src pixels srcX[x] and srcX[x] + 1, weighted weightX[x]/256
+// towards the second.
+static void blur_upsample_row(const uint32_t* row0, const uint32_t* row1, uint32_t weightY,
+                              const int* srcX, const uint32_t* weightX,
+                              uint32_t* dst, int dstW) {
+    const Sk4u wy{weightY}, iy{256 - weightY};
+    for (int x = 0; x < dstW; x++) {
+        const int i = srcX[x];
+        const Sk4u wx{weightX[x]}, ix{256 - weightX[x]};
+        Sk4u top = SkNx_cast<uint32_t>(Sk4b::Load(row0 + i)) * ix +
+                   SkNx_cast<uint32_t>(Sk4b::Load(row0 + i + 1)) * wx;
+        Sk4u bot = SkNx_cast<uint32_t>(Sk4b::Load(row1 + i)) * ix +
+                   SkNx_cast<uint32_t>(Sk4b::Load(row1 + i + 1)) * wx;
+        Sk4u value = (top * iy + bot * wy + Sk4u{1u << 15}) >> 16;
+        SkNx_cast<uint8_t>(value).store(dst + x);
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif
@@ -28,7 +28,7 @@ static inline T unaligned_load(const P* p) {
 
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE42 && (defined(__x86_64__) || defined(_M_X64))
     // This is not a CRC32.  It's Just A Hash that uses those instructions because they're fast.
-    /*not static*/ inline uint32_t hash_fn(const void* vdata, size_t bytes, uint32_t seed) {
+    static inline uint32_t crc_hash(const void* vdata, size_t bytes, uint32_t seed) {
         auto data = (const uint8_t*)vdata;
 
         // _mm_crc32_u64() operates on 64-bit registers, so we use uint64_t for a while.
@@ -82,6 +82,80 @@ static inline T unaligned_load(const P* p) {
         return hash32;
     }
 
+  #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // _mm_crc32_u64() tops out around 8 bytes a cycle.  Past kMinWideHashBytes, we instead mix
+    // 64-byte stripes into 8 64-bit accumulators with 32x32->64-bit multiplies, like xxh3, then
+    // crc_hash() the accumulators and whatever's left over.  Shorter keys hash as they do above.
+    static constexpr size_t kMinWideHashBytes = 512;
+
+    // Stripe i of each 1024-byte block is keyed by kWideKeys[i..i+7]; kWideKeys[16..23] then
+    // scramble the accumulators.  These are just arbitrary bits, from splitmix64.
+    static const uint64_t kWideKeys[24] = {
+        0x09f1fd9d03f0a9b4, 0x553274161bbf8475, 0x5d5bca4696b343b3, 0x70d29b6c7d22528d,
+        0x0bf2b716f9915475, 0x5eb7f92b95387cca, 0x296cd0f2c21d7f90, 0x1289a69805c125b1,
+        0xdaa27fb8dacb9e73, 0x3ed08d59cb3f4727, 0x58a5f17b6c15c659, 0x651ac042fa7b481a,
+        0x22af6aeaa88e8dcc, 0x2d2bae64640abfb9, 0xad0e83a710231b07, 0x9d30ff2169d91f12,
+        0xf5ff07c9523504dd, 0x1273c823ba66eec0, 0x47e1dbe249cb520b, 0xbbea42bd69484adc,
+        0xc33e61bc6ef9e4c4, 0x752cd583231b5114, 0xe53dc6e1988622e5, 0x928eb721ed361ba3,
+    };
+    static const uint64_t kWideInit[8] = {
+        0x10bf7972f379031e, 0x974041d15ad75c38, 0xff9b273f42286387, 0x2601349fef087eb0,
+        0x5753f8ef429a4a7e, 0x2663e5e9dcbcbaba, 0xa8bb872e52c6235c, 0xe1774d56b0dc91ac,
+    };
+
+    /*not static*/ inline uint32_t hash_fn(const void* vdata, size_t bytes, uint32_t seed) {
+        if (bytes < kMinWideHashBytes) {
+            return crc_hash(vdata, bytes, seed);
+        }
+        auto data = (const uint8_t*)vdata;
+
+        auto accumulate = [](__m256i acc, const uint8_t* data, const uint64_t* keys) {
+            __m256i d  = _mm256_loadu_si256((const __m256i*)data),
+                    dk = _mm256_xor_si256(d, _mm256_loadu_si256((const __m256i*)keys));
+            // Multiply the low and high halves of each 64-bit lane of dk together, and add in
+            // the data itself, lanes swapped, so no input is lost when a product is zero.
+            __m256i product = _mm256_mul_epu32(dk, _mm256_srli_epi64(dk, 32));
+            return _mm256_add_epi64(_mm256_add_epi64(acc, product),
+                                    _mm256_shuffle_epi32(d, _MM_SHUFFLE(1,0,3,2)));
+        };
+        auto scramble = [](__m256i acc, const uint64_t* keys) {
+            const __m256i prime = _mm256_set1_epi64x(0x9E3779B1);
+            acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+            acc = _mm256_xor_si256(acc, _mm256_loadu_si256((const __m256i*)keys));
+            __m256i lo = _mm256_mul_epu32(acc, prime),
+                    hi = _mm256_mul_epu32(_mm256_srli_epi64(acc, 32), prime);
+            return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+        };
+
+        const __m256i s = _mm256_set1_epi64x(seed);
+        __m256i a = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(kWideInit+0)), s),
+                b = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(kWideInit+4)), s);
+        for (; bytes >= 1024; bytes -= 1024) {
+            for (int i = 0; i < 16; i++) {
+                a = accumulate(a, data +  0, kWideKeys + i + 0);
+                b = accumulate(b, data + 32, kWideKeys + i + 4);
+                data += 64;
+            }
+            a = scramble(a, kWideKeys + 16);
+            b = scramble(b, kWideKeys + 20);
+        }
+        for (int i = 0; bytes >= 64; i++, bytes -= 64) {
+            a = accumulate(a, data +  0, kWideKeys + i + 0);
+            b = accumulate(b, data + 32, kWideKeys + i + 4);
+            data += 64;
+        }
+
+        uint64_t acc[8];
+        _mm256_storeu_si256((__m256i*)(acc+0), a);
+        _mm256_storeu_si256((__m256i*)(acc+4), b);
+        return crc_hash(data, bytes, crc_hash(acc, sizeof(acc), seed) ^ (uint32_t)bytes);
+    }
+  #else
+    /*not static*/ inline uint32_t hash_fn(const void* vdata, size_t bytes, uint32_t seed) {
+        return crc_hash(vdata, bytes, seed);
+    }
+  #endif
+
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE42
     // 32-bit version of above, using _mm_crc32_u32() but not _mm_crc32_u64().
     /*not static*/ inline uint32_t hash_fn(const void* vdata, size_t bytes, uint32_t hash) {
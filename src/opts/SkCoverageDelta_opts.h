@@ -0,0 +1,116 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCoverageDelta_opts_DEFINED
+#define SkCoverageDelta_opts_DEFINED
+
+#include "SkCoverageDelta.h"
+#include "SkNx.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <immintrin.h>
+#endif
+
+namespace SK_OPTS_NS {
+
+// Accumulate 8 deltas into 8 coverages, i.e., an inclusive prefix sum starting from *carry.
+// *carry holds the running coverage (the last coverage we've produced) and is updated on return.
+// We keep the running coverage splatted across the whole register so it's a single add to apply.
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+    struct CoverageCarry { __m256i fVec = _mm256_setzero_si256(); };
+
+    static SK_ALWAYS_INLINE Sk8i accumulate_deltas(const int32_t* deltas, CoverageCarry* carry) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)deltas);
+        // Prefix sum within each 128-bit lane...
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+        // ... then add the low lane's total to every value in the high lane.
+        __m256i lo = _mm256_shuffle_epi32(v, 0xff);
+        v = _mm256_add_epi32(v, _mm256_permute2x128_si256(lo, lo, 0x08));
+
+        v = _mm256_add_epi32(v, carry->fVec);
+        carry->fVec = _mm256_permutevar8x32_epi32(v, _mm256_set1_epi32(7));
+        return { Sk4i(_mm256_castsi256_si128(v)), Sk4i(_mm256_extracti128_si256(v, 1)) };
+    }
+
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2 || defined(SK_ARM_HAS_NEON)
+
+    // A raw vector rather than Sk4i: SkNx lives in an anonymous namespace, and a member of that
+    // type would give this SK_OPTS_NS struct internal linkage (GCC's -Wsubobject-linkage).
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        struct CoverageCarry { __m128i fVec = _mm_setzero_si128(); };
+    #else
+        struct CoverageCarry { int32x4_t fVec = vdupq_n_s32(0); };
+    #endif
+
+    static SK_ALWAYS_INLINE Sk4i accumulate_deltas4(const Sk4i& d, CoverageCarry* carry) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        __m128i v = d.fVec;
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, carry->fVec);
+        carry->fVec = _mm_shuffle_epi32(v, 0xff);
+    #else
+        int32x4_t zero = vdupq_n_s32(0),
+                  v    = d.fVec;
+        v = vaddq_s32(v, vextq_s32(zero, v, 3));
+        v = vaddq_s32(v, vextq_s32(zero, v, 2));
+        v = vaddq_s32(v, carry->fVec);
+        carry->fVec = vdupq_n_s32(vgetq_lane_s32(v, 3));
+    #endif
+        return v;
+    }
+
+    static SK_ALWAYS_INLINE Sk8i accumulate_deltas(const int32_t* deltas, CoverageCarry* carry) {
+        Sk4i lo = accumulate_deltas4(Sk4i::Load(deltas    ), carry),
+             hi = accumulate_deltas4(Sk4i::Load(deltas + 4), carry);
+        return { lo, hi };
+    }
+
+#else
+
+    struct CoverageCarry { int32_t fVal = 0; };
+
+    static SK_ALWAYS_INLINE Sk8i accumulate_deltas(const int32_t* deltas, CoverageCarry* carry) {
+        int32_t c[8];
+        c[0] = carry->fVal + deltas[0];
+        for (int j = 1; j < 8; ++j) {
+            c[j] = c[j - 1] + deltas[j];
+        }
+        carry->fVal = c[7];
+        return Sk8i::Load(c);
+    }
+
+#endif
+
+template <bool kIsConvex>
+static SK_ALWAYS_INLINE void accumulate_coverage_row(const int32_t* deltas, uint8_t* alphas,
+                                                     int width, bool isEvenOdd, bool isInverse) {
+    CoverageCarry carry;
+    for (int ix = 0; ix < width; ix += 8) {
+        Sk8i cn = accumulate_deltas(deltas + ix, &carry);
+        Sk8i an = kIsConvex ? ConvexCoverageToAlpha(cn, isInverse)
+                            : CoverageToAlpha(cn, isEvenOdd, isInverse);
+        SkNx_cast<uint8_t>(an).store(alphas + ix);
+    }
+}
+
+/*not static*/ inline void coverage_to_alpha(const int32_t* deltas, uint8_t* alphas, int width,
+                                             bool isEvenOdd, bool isInverse, bool isConvex) {
+    static_assert(SkCoverageDeltaMask::SIMD_WIDTH == 8, "accumulate_deltas() works 8 at a time");
+    SkASSERT(width % 8 == 0);
+    if (isConvex) {
+        accumulate_coverage_row<true >(deltas, alphas, width, isEvenOdd, isInverse);
+    } else {
+        accumulate_coverage_row<false>(deltas, alphas, width, isEvenOdd, isInverse);
+    }
+}
+
+}  // SK_OPTS_NS
+
+#endif//SkCoverageDelta_opts_DEFINED
@@ -9,6 +9,8 @@
 #define SkMorphologyImageFilter_opts_DEFINED
 
 #include "SkColor.h"
+#include "SkNx.h"
+#include "SkTemplates.h"
 
 namespace SK_OPTS_NS {
 
@@ -128,10 +130,107 @@ static void morph(const SkPMColor* src, SkPMColor* dst,
 
 #endif
 
-static auto dilate_x = &morph<kDilate, MorphDirection::kX>,
-            dilate_y = &morph<kDilate, MorphDirection::kY>,
-             erode_x = &morph<kErode,  MorphDirection::kX>,
-             erode_y = &morph<kErode,  MorphDirection::kY>;
+// From this radius on, morph_lines() below does fewer min/max per pixel than morph().
+static constexpr int kMinVanHerkRadius = 4;
+
+// Loads pixel p of four neighboring lines, which are stride pixels apart.
+template<MorphDirection direction>
+static inline Sk16b load_lines(const SkPMColor* p, int stride) {
+    if (direction == MorphDirection::kY) {
+        return Sk16b::Load(p);  // The lines are neighboring columns.
+    }
+    const SkPMColor pixels[4] = { p[0], p[stride], p[2 * stride], p[3 * stride] };
+    return Sk16b::Load(pixels);
+}
+
+template<MorphDirection direction>
+static inline void store_lines(const Sk16b& v, SkPMColor* p, int stride) {
+    if (direction == MorphDirection::kY) {
+        v.store(p);
+        return;
+    }
+    SkPMColor pixels[4];
+    v.store(pixels);
+    p[0] = pixels[0];
+    p[stride] = pixels[1];
+    p[2 * stride] = pixels[2];
+    p[3 * stride] = pixels[3];
+}
+
+// Same as morph(), but with the van Herk/Gil-Werman algorithm, which takes three min/max per
+// pixel whatever the radius, and four lines at a time. Each line is padded by radius pixels
+// that don't change the result, and cut into blocks of one window. The extreme of a window is
+// that of the end of the block it starts in and the start of the block it ends in, which are
+// precomputed in a backward and a forward pass over each block.
+template<MorphType type, MorphDirection direction>
+static void morph_lines(const SkPMColor* src, SkPMColor* dst,
+                        int radius, int width, int height, int srcStride, int dstStride) {
+    const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
+    const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
+    const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
+    const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
+    radius = SkMin32(radius, width - 1);
+    if (radius < kMinVanHerkRadius) {
+        morph<type, direction>(src, dst, radius, width, height, srcStride, dstStride);
+        return;
+    }
+
+    auto extreme = [](const Sk16b& a, const Sk16b& b) {
+        return type == kDilate ? Sk16b::Max(a, b) : Sk16b::Min(a, b);
+    };
+    const Sk16b identity(type == kDilate ? 0 : 255);
+    const int window = 2 * radius + 1;
+    const int padded = (width + 2 * radius + window - 1) / window * window;
+
+    // Four pixels per entry: head[i] is the extreme from the start of i's block through i, and
+    // tail[i] from i through the end of i's block.
+    SkAutoTMalloc<SkPMColor> storage(8 * padded);
+    SkPMColor* head = storage.get();
+    SkPMColor* tail = head + 4 * padded;
+
+    int y = 0;
+    for (; y + 4 <= height; y += 4) {
+        for (int i = 0; i < radius; i++) {
+            identity.store(tail + 4 * i);
+        }
+        for (int x = 0; x < width; x++) {
+            load_lines<direction>(src + x * srcStrideX, srcStrideY).store(tail + 4 * (x + radius));
+        }
+        for (int i = width + radius; i < padded; i++) {
+            identity.store(tail + 4 * i);
+        }
+
+        for (int block = 0; block < padded; block += window) {
+            Sk16b forward = Sk16b::Load(tail + 4 * block);
+            forward.store(head + 4 * block);
+            for (int i = block + 1; i < block + window; i++) {
+                forward = extreme(forward, Sk16b::Load(tail + 4 * i));
+                forward.store(head + 4 * i);
+            }
+            Sk16b backward = Sk16b::Load(tail + 4 * (block + window - 1));
+            for (int i = block + window - 2; i >= block; i--) {
+                backward = extreme(backward, Sk16b::Load(tail + 4 * i));
+                backward.store(tail + 4 * i);
+            }
+        }
+
+        for (int x = 0; x < width; x++) {
+            store_lines<direction>(extreme(Sk16b::Load(tail + 4 * x),
+                                           Sk16b::Load(head + 4 * (x + 2 * radius))),
+                                   dst + x * dstStrideX, dstStrideY);
+        }
+        src += 4 * srcStrideY;
+        dst += 4 * dstStrideY;
+    }
+    if (y < height) {
+        morph<type, direction>(src, dst, radius, width, height - y, srcStride, dstStride);
+    }
+}
+
+static auto dilate_x = &morph_lines<kDilate, MorphDirection::kX>,
+            dilate_y = &morph_lines<kDilate, MorphDirection::kY>,
+             erode_x = &morph_lines<kErode,  MorphDirection::kX>,
+             erode_y = &morph_lines<kErode,  MorphDirection::kY>;
 
 }  // namespace SK_OPTS_NS
 
@@ -8,11 +8,35 @@
 #include "SkOpts.h"
 
 #define SK_OPTS_NS hsw
+#include "SkChecksum_opts.h"
+#include "SkCoverageDelta_opts.h"
 #include "SkRasterPipeline_opts.h"
+#include "SkSwizzler_opts.h"
 #include "SkUtils_opts.h"
 
 namespace SkOpts {
     void Init_hsw() {
+        coverage_to_alpha = hsw::coverage_to_alpha;
+
+        hash_fn = hsw::hash_fn;
+
+        RGBA_to_BGRA          = hsw::RGBA_to_BGRA;
+        RGBA_to_rgbA          = hsw::RGBA_to_rgbA;
+        RGBA_to_bgrA          = hsw::RGBA_to_bgrA;
+        RGB_to_RGB1           = hsw::RGB_to_RGB1;
+        RGB_to_BGR1           = hsw::RGB_to_BGR1;
+        gray_to_RGB1          = hsw::gray_to_RGB1;
+        grayA_to_RGBA         = hsw::grayA_to_RGBA;
+        grayA_to_rgbA         = hsw::grayA_to_rgbA;
+        inverted_CMYK_to_RGB1 = hsw::inverted_CMYK_to_RGB1;
+        inverted_CMYK_to_BGR1 = hsw::inverted_CMYK_to_BGR1;
+        RGB16_to_RGB1         = hsw::RGB16_to_RGB1;
+        RGB16_to_BGR1         = hsw::RGB16_to_BGR1;
+        RGBA16_to_RGBA        = hsw::RGBA16_to_RGBA;
+        RGBA16_to_BGRA        = hsw::RGBA16_to_BGRA;
+        rgbA_to_RGBA          = hsw::rgbA_to_RGBA;
+        rgbA_to_BGRA          = hsw::rgbA_to_BGRA;
+
     #define M(st) stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
         SK_RASTER_PIPELINE_STAGES(M)
         just_return_highp = (StageFn)SK_OPTS_NS::just_return;
@@ -8,13 +8,20 @@
 #include "SkOpts.h"
 
 #define SK_OPTS_NS sse41
+#include "SkCoverageDelta_opts.h"
 #include "SkRasterPipeline_opts.h"
 #include "SkBlitRow_opts.h"
+#include "SkBlurImageFilter_opts.h"
 
 namespace SkOpts {
     void Init_sse41() {
+        coverage_to_alpha = sse41::coverage_to_alpha;
+
         blit_row_s32a_opaque = sse41::blit_row_s32a_opaque;
 
+        // SSE4.1 has a real 32-bit multiply for the interpolation.
+        blur_upsample_row = sse41::blur_upsample_row;
+
     #define M(st) stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
         SK_RASTER_PIPELINE_STAGES(M)
         just_return_highp = (StageFn)SK_OPTS_NS::just_return;
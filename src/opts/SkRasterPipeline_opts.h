@@ -41,6 +41,9 @@
 
 #if defined(JUMPER_IS_SCALAR)
     #include <math.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
 #elif defined(JUMPER_IS_NEON)
     #include <arm_neon.h>
 #else
@@ -933,6 +936,21 @@ STAGE(seed_shader, Ctx::None) {
     dr = dg = db = da = 0;
 }
 
+// seed_shader then matrix_2x3, fused by SkRasterPipeline::try_fuse().
+STAGE(seed_shader_matrix_2x3, const float* m) {
+    static const float iota[] = {
+        0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
+        8.5f, 9.5f,10.5f,11.5f,12.5f,13.5f,14.5f,15.5f,
+    };
+    F x = cast(dx) + unaligned_load<F>(iota),
+      y = cast(dy) + 0.5f;
+    r = mad(x,m[0], mad(y,m[2], m[4]));
+    g = mad(x,m[1], mad(y,m[3], m[5]));
+    b = 1.0f;
+    a = 0;
+    dr = dg = db = da = 0;
+}
+
 STAGE(dither, const float* rate) {
     // Get [(dx,dy), (dx+1,dy), (dx+2,dy), ...] loaded up in integer vectors.
     uint32_t iota[] = {0,1,2,3,4,5,6,7};
@@ -1989,6 +2007,26 @@ STAGE(evenly_spaced_2_stop_gradient, const void* ctx) {
     a = mad(t, c->f[3], c->b[3]);
 }
 
+STAGE(gradient_lut, const SkJumper_GradientLUTCtx* c) {
+    auto t = r;
+    F x = clamp_01(t) * (float)(c->size - 1);
+    U32 ix = trunc_(x);
+    F   fx = x - cast(ix);
+    // Written so that NaN t takes the color for t < 0, rather than reading out of bounds.
+    ix = if_then_else(t >= 0, ix + 1, U32(0));
+    fx = if_then_else(t >= 0, fx, F(0));
+
+    auto sample = [&](const float* lut) {
+        F lo = gather(lut, ix),
+          hi = gather(lut, ix + 1);
+        return mad(fx, hi - lo, lo);
+    };
+    r = sample(c->rgba[0]);
+    g = sample(c->rgba[1]);
+    b = sample(c->rgba[2]);
+    a = sample(c->rgba[3]);
+}
+
 STAGE(xy_to_unit_angle, Ctx::None) {
     F X = r,
       Y = g;
@@ -2195,6 +2233,33 @@ STAGE(callback, SkJumper_CallbackCtx* c) {
     load4(c->read_from,0, &r,&g,&b,&a);
 }
 
+// The profile stage reads a cheap counter: cycles on x86, the virtual timer on ARMv8.
+// Elsewhere we've got nothing cheap enough, and only count pixels.
+SI uint64_t cycle_counter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return 0;
+#endif
+}
+
+SI void profile_(const SkJumper_ProfileCtx* ctx, size_t pixels) {
+    uint64_t now = cycle_counter();
+    if (ctx->cycles) {
+        *ctx->cycles += now - *ctx->last;
+        *ctx->pixels += pixels;
+    }
+    *ctx->last = now;
+}
+
+STAGE(profile, const SkJumper_ProfileCtx* ctx) { profile_(ctx, tail ? tail : N); }
+
 // Our general strategy is to recursively interpolate each dimension,
 // accumulating the index to sample at, and our current pixel stride to help accumulate the index.
 template <int dim>
@@ -2263,11 +2328,23 @@ STAGE(gauss_a_to_rgba, Ctx::None) {
     b = a;
 }
 
-// A specialized fused image shader for clamp-x, clamp-y, non-sRGB sampling.
-STAGE(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
-    // (cx,cy) are the center of our sample.
-    F cx = r,
-      cy = g;
+// Shadow coverage at (r,g) for a gauss_a_to_rgba to follow: the distance inward from the edge of
+// the rrect, as a fraction of the falloff's width, clamped, and nothing past the inset.
+STAGE(rrect_shadow, const SkJumper_RRectShadowCtx* ctx) {
+    F qx = abs_(r - ctx->cx) - ctx->hx,
+      qy = abs_(g - ctx->cy) - ctx->hy;
+    F ox = max(qx, 0),
+      oy = max(qy, 0);
+    // Inside the rrect, the distance to its nearest straight edge or corner circle.
+    F t = ctx->radius - sqrt_(ox*ox + oy*oy) - min(max(qx, qy), 0);
+    F v = min(max(t * ctx->invBlurWidth, 0), ctx->blurClamp);
+    r = g = b = a = if_then_else(t > ctx->insetWidth, 0, v);
+}
+
+// Bilinearly samples an 8888 image around (cx,cy), tiling each sample point with tile(&x,&y).
+template <typename Tile>
+SI void bilerp_8888(const SkJumper_GatherCtx* ctx, F cx, F cy, Tile&& tile,
+                    F* r, F* g, F* b, F* a) {
 
     // All sample points are at the same fractional offset (fx,fy).
     // They're the 4 corners of a logical 1x1 pixel surrounding (x,y) at (0.5,0.5) offsets.
@@ -2275,13 +2352,14 @@ STAGE(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
       fy = fract(cy + 0.5f);
 
     // We'll accumulate the color of all four samples into {r,g,b,a} directly.
-    r = g = b = a = 0;
+    *r = *g = *b = *a = 0;
 
     for (float dy = -0.5f; dy <= +0.5f; dy += 1.0f)
     for (float dx = -0.5f; dx <= +0.5f; dx += 1.0f) {
         // (x,y) are the coordinates of this sample point.
         F x = cx + dx,
           y = cy + dy;
+        tile(&x, &y);
 
         // ix_and_ptr() will clamp to the image's bounds for us.
         const uint32_t* ptr;
@@ -2298,13 +2376,32 @@ STAGE(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
           sy = (dy > 0) ? fy : 1.0f - fy,
           area = sx * sy;
 
-        r += sr * area;
-        g += sg * area;
-        b += sb * area;
-        a += sa * area;
+        *r += sr * area;
+        *g += sg * area;
+        *b += sb * area;
+        *a += sa * area;
     }
 }
 
+SI F tile(F v, int mode, const SkJumper_TileCtx* limit) {
+    if (mode == SkJumper_kTileRepeat) { return exclusive_repeat(v, limit); }
+    if (mode == SkJumper_kTileMirror) { return exclusive_mirror(v, limit); }
+    return v;
+}
+
+// A specialized fused image shader for clamp-x, clamp-y, non-sRGB sampling.
+STAGE(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
+    bilerp_8888(ctx, r,g, [](F*, F*) {}, &r,&g,&b,&a);
+}
+
+// The same for any mix of clamp, repeat and mirror tiling.
+STAGE(bilerp_tile_8888, const SkJumper_BilerpTileCtx* ctx) {
+    bilerp_8888(&ctx->gather, r,g, [&](F* px, F* py) {
+        *px = tile(*px, ctx->tile_x, &ctx->limit_x);
+        *py = tile(*py, ctx->tile_y, &ctx->limit_y);
+    }, &r,&g,&b,&a);
+}
+
 namespace lowp {
 #if defined(JUMPER_IS_SCALAR)
     // If we're not compiled by Clang, or otherwise switched into scalar mode (old Clang, manually),
@@ -2613,6 +2710,16 @@ STAGE_GG(seed_shader, Ctx::None) {
     x = cast<F>(I32(dx)) + unaligned_load<F>(iota);
     y = cast<F>(I32(dy)) + 0.5f;
 }
+STAGE_GG(seed_shader_matrix_2x3, const float* m) {
+    static const float iota[] = {
+        0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
+        8.5f, 9.5f,10.5f,11.5f,12.5f,13.5f,14.5f,15.5f,
+    };
+    F X = cast<F>(I32(dx)) + unaligned_load<F>(iota),
+      Y = cast<F>(I32(dy)) + 0.5f;
+    x = mad(X,m[0], mad(Y,m[2], m[4]));
+    y = mad(X,m[1], mad(Y,m[3], m[5]));
+}
 
 STAGE_GG(matrix_translate, const float* m) {
     x += m[0];
@@ -2644,6 +2751,7 @@ STAGE_PP(uniform_color, const SkJumper_UniformColorCtx* c) {
     a = c->rgba[3];
 }
 STAGE_PP(black_color, Ctx::None) { r = g = b =   0; a = 255; }
+STAGE_PP(profile, const SkJumper_ProfileCtx* ctx) { profile_(ctx, tail ? tail : N); }
 STAGE_PP(white_color, Ctx::None) { r = g = b = 255; a = 255; }
 
 STAGE_PP(set_rgb, const float rgb[3]) {
@@ -3172,6 +3280,20 @@ STAGE_GG(mirror_x_1, Ctx::None) {
     x = clamp_01(abs_( (x-1.0f) - two(floor_((x-1.0f)*0.5f)) - 1.0f ));
 }
 
+// Tile x or y to [0,limit) for sampling from images, as in highp.
+SI F exclusive_repeat(F v, const SkJumper_TileCtx* ctx) {
+    return v - floor_(v*ctx->invScale)*ctx->scale;
+}
+SI F exclusive_mirror(F v, const SkJumper_TileCtx* ctx) {
+    auto limit = ctx->scale;
+    auto invLimit = ctx->invScale;
+    return abs_( (v-limit) - (limit+limit)*floor_((v-limit)*(invLimit*0.5f)) - limit );
+}
+STAGE_GG(repeat_x, const SkJumper_TileCtx* ctx) { x = exclusive_repeat(x, ctx); }
+STAGE_GG(repeat_y, const SkJumper_TileCtx* ctx) { y = exclusive_repeat(y, ctx); }
+STAGE_GG(mirror_x, const SkJumper_TileCtx* ctx) { x = exclusive_mirror(x, ctx); }
+STAGE_GG(mirror_y, const SkJumper_TileCtx* ctx) { y = exclusive_mirror(y, ctx); }
+
 SI I16 cond_to_mask_16(I32 cond) { return cast<I16>(cond); }
 
 STAGE_GG(decal_x, SkJumper_DecalTileCtx* ctx) {
@@ -3271,6 +3393,26 @@ STAGE_GP(evenly_spaced_2_stop_gradient, const void* ctx) {
     a = round_F_to_U16(mad(t, c->f[3], c->b[3]));
 }
 
+STAGE_GP(gradient_lut, const SkJumper_GradientLUTCtx* c) {
+    auto t = x;
+    F fx = clamp_01(t) * (float)(c->size - 1);
+    U32 ix = trunc_(fx);
+    fx = fx - cast<F>(ix);
+    // Written so that NaN t takes the color for t < 0, rather than reading out of bounds.
+    ix = if_then_else(t >= 0, ix + 1, U32(0));
+    fx = if_then_else(t >= 0, fx, F(0));
+
+    auto sample = [&](const float* lut) {
+        F lo = gather<F>(lut, ix),
+          hi = gather<F>(lut, ix + 1);
+        return round_F_to_U16(mad(fx, hi - lo, lo));
+    };
+    r = sample(c->rgba[0]);
+    g = sample(c->rgba[1]);
+    b = sample(c->rgba[2]);
+    a = sample(c->rgba[3]);
+}
+
 STAGE_GG(xy_to_unit_angle, Ctx::None) {
     F xabs = abs_(x),
       yabs = abs_(y);
@@ -3321,21 +3463,17 @@ STAGE_PP(srcover_bgra_8888, const SkJumper_MemoryCtx* ctx) {
     store_8888_(ptr, tail, b,g,r,a);
 }
 
-#if defined(SK_DISABLE_LOWP_BILERP_CLAMP_CLAMP_STAGE)
-    static void(*bilerp_clamp_8888)(void) = nullptr;
-#else
-STAGE_GP(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
-    // (cx,cy) are the center of our sample.
-    F cx = x,
-      cy = y;
-
+// Bilinearly samples an 8888 image around (cx,cy), tiling each sample point with tile(&x,&y).
+template <typename Tile>
+SI void bilerp_8888(const SkJumper_GatherCtx* ctx, F cx, F cy, Tile&& tile,
+                    U16* r, U16* g, U16* b, U16* a) {
     // All sample points are at the same fractional offset (fx,fy).
     // They're the 4 corners of a logical 1x1 pixel surrounding (x,y) at (0.5,0.5) offsets.
     F fx = fract(cx + 0.5f),
       fy = fract(cy + 0.5f);
 
     // We'll accumulate the color of all four samples into {r,g,b,a} directly.
-    r = g = b = a = 0;
+    *r = *g = *b = *a = 0;
 
     // The first three sample points will calculate their area using math
     // just like in the float code above, but the fourth will take up all the rest.
@@ -3353,6 +3491,7 @@ STAGE_GP(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
         // (x,y) are the coordinates of this sample point.
         F x = cx + dx,
           y = cy + dy;
+        tile(&x, &y);
 
         // ix_and_ptr() will clamp to the image's bounds for us.
         const uint32_t* ptr;
@@ -3372,19 +3511,39 @@ STAGE_GP(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
                                               : cast<U16>(sx * sy * bias);
         remaining -= area;
 
-        r += sr * area;
-        g += sg * area;
-        b += sb * area;
-        a += sa * area;
+        *r += sr * area;
+        *g += sg * area;
+        *b += sb * area;
+        *a += sa * area;
     }
 
-    r /= bias;
-    g /= bias;
-    b /= bias;
-    a /= bias;
+    *r /= bias;
+    *g /= bias;
+    *b /= bias;
+    *a /= bias;
+}
+
+#if defined(SK_DISABLE_LOWP_BILERP_CLAMP_CLAMP_STAGE)
+    static void(*bilerp_clamp_8888)(void) = nullptr;
+#else
+STAGE_GP(bilerp_clamp_8888, const SkJumper_GatherCtx* ctx) {
+    bilerp_8888(ctx, x,y, [](F*, F*) {}, &r,&g,&b,&a);
 }
 #endif
 
+SI F tile(F v, int mode, const SkJumper_TileCtx* limit) {
+    if (mode == SkJumper_kTileRepeat) { return exclusive_repeat(v, limit); }
+    if (mode == SkJumper_kTileMirror) { return exclusive_mirror(v, limit); }
+    return v;
+}
+
+STAGE_GP(bilerp_tile_8888, const SkJumper_BilerpTileCtx* ctx) {
+    bilerp_8888(&ctx->gather, x,y, [&](F* px, F* py) {
+        *px = tile(*px, ctx->tile_x, &ctx->limit_x);
+        *py = tile(*py, ctx->tile_y, &ctx->limit_y);
+    }, &r,&g,&b,&a);
+}
+
 // Now we'll add null stand-ins for stages we haven't implemented in lowp.
 // If a pipeline uses these stages, it'll boot it out of lowp into highp.
 
@@ -3407,9 +3566,7 @@ static NotImplemented
         table_r, table_g, table_b, table_a,
         gamma, gamma_dst,
         lab_to_xyz, rgb_to_hsl, hsl_to_rgb, clut_3D, clut_4D,
-        gauss_a_to_rgba,
-        mirror_x, repeat_x,
-        mirror_y, repeat_y,
+        gauss_a_to_rgba, rrect_shadow,
         negate_x,
         bilinear_nx, bilinear_ny, bilinear_px, bilinear_py,
         bicubic_n3x, bicubic_n1x, bicubic_p1x, bicubic_p3x,
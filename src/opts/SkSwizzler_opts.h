@@ -9,6 +9,9 @@
 #define SkSwizzler_opts_DEFINED
 
 #include "SkColorData.h"
+#include "SkNx.h"
+#include "SkUnPreMultiply.h"
+#include <utility>
 
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
     #include <immintrin.h>
@@ -166,6 +169,65 @@ static void inverted_CMYK_to_BGR1_portable(uint32_t* dst, const void* vsrc, int
     }
 }
 
+// 16-bit components are big-endian, so we keep the first (most significant) byte of each.
+static void RGB16_to_RGB1_portable(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*)vsrc;
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4];
+        src += 6;
+        dst[i] = (uint32_t)0xFF << 24
+               | (uint32_t)b    << 16
+               | (uint32_t)g    <<  8
+               | (uint32_t)r    <<  0;
+    }
+}
+
+static void RGB16_to_BGR1_portable(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*)vsrc;
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4];
+        src += 6;
+        dst[i] = (uint32_t)0xFF << 24
+               | (uint32_t)r    << 16
+               | (uint32_t)g    <<  8
+               | (uint32_t)b    <<  0;
+    }
+}
+
+static void RGBA16_to_RGBA_portable(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*)vsrc;
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4],
+                a = src[6];
+        src += 8;
+        dst[i] = (uint32_t)a << 24
+               | (uint32_t)b << 16
+               | (uint32_t)g <<  8
+               | (uint32_t)r <<  0;
+    }
+}
+
+static void RGBA16_to_BGRA_portable(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*)vsrc;
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4],
+                a = src[6];
+        src += 8;
+        dst[i] = (uint32_t)a << 24
+               | (uint32_t)r << 16
+               | (uint32_t)g <<  8
+               | (uint32_t)b <<  0;
+    }
+}
+
 #if defined(SK_ARM_HAS_NEON)
 
 // Rounded divide by 255, (x + 127) / 255
@@ -490,6 +552,75 @@ static void inverted_cmyk_to(uint32_t* dst, const void* vsrc, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+template <bool kSwapRB>
+static void strip16_insert_alpha_should_swaprb(uint32_t dst[], const void* vsrc, int count) {
+    const uint16_t* src = (const uint16_t*) vsrc;
+    while (count >= 8) {
+        // Load 8 pixels and deinterleave.  The components are big-endian, so their most
+        // significant bytes are the low bytes of the lanes.
+        uint16x8x3_t rgb16 = vld3q_u16(src);
+
+        // Narrow to 8-bit and insert an opaque alpha.
+        uint8x8x4_t rgba;
+        rgba.val[kSwapRB ? 2 : 0] = vmovn_u16(rgb16.val[0]);
+        rgba.val[1]               = vmovn_u16(rgb16.val[1]);
+        rgba.val[kSwapRB ? 0 : 2] = vmovn_u16(rgb16.val[2]);
+        rgba.val[3]               = vdup_n_u8(0xFF);
+
+        // Store 8 pixels.
+        vst4_u8((uint8_t*) dst, rgba);
+        src += 8*3;
+        dst += 8;
+        count -= 8;
+    }
+
+    // Call portable code to finish up the tail of [0,8) pixels.
+    auto proc = kSwapRB ? RGB16_to_BGR1_portable : RGB16_to_RGB1_portable;
+    proc(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const void* src, int count) {
+    strip16_insert_alpha_should_swaprb<false>(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const void* src, int count) {
+    strip16_insert_alpha_should_swaprb<true>(dst, src, count);
+}
+
+template <bool kSwapRB>
+static void strip16_should_swaprb(uint32_t dst[], const void* vsrc, int count) {
+    const uint16_t* src = (const uint16_t*) vsrc;
+    while (count >= 8) {
+        // Load 8 pixels and deinterleave.
+        uint16x8x4_t rgba16 = vld4q_u16(src);
+
+        // Narrow to 8-bit.
+        uint8x8x4_t rgba;
+        rgba.val[kSwapRB ? 2 : 0] = vmovn_u16(rgba16.val[0]);
+        rgba.val[1]               = vmovn_u16(rgba16.val[1]);
+        rgba.val[kSwapRB ? 0 : 2] = vmovn_u16(rgba16.val[2]);
+        rgba.val[3]               = vmovn_u16(rgba16.val[3]);
+
+        // Store 8 pixels.
+        vst4_u8((uint8_t*) dst, rgba);
+        src += 8*4;
+        dst += 8;
+        count -= 8;
+    }
+
+    // Call portable code to finish up the tail of [0,8) pixels.
+    auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+    proc(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const void* src, int count) {
+    strip16_should_swaprb<false>(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const void* src, int count) {
+    strip16_should_swaprb<true>(dst, src, count);
+}
+
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
 
 // Scale a byte by another.
@@ -797,6 +928,140 @@ static void inverted_cmyk_to(uint32_t* dst, const void* vsrc, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+template <bool kSwapRB>
+static void strip16_insert_alpha_should_swaprb(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*) vsrc;
+
+    // The components are big-endian, so we keep the first (most significant) byte of each.
+    // Four pixels span 24 bytes: we load bytes [0,16) for the first two and bytes [8,24) for
+    // the last two.
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+    __m128i stripLo, stripHi;
+    const uint8_t X = 0xFF; // Used a placeholder.  The value of X is irrelevant.
+    if (kSwapRB) {
+        stripLo = _mm_setr_epi8(4,2,0,X, 10,8,6,X, X,X,X,X, X,X,X,X);
+        stripHi = _mm_setr_epi8(X,X,X,X, X,X,X,X, 8,6,4,X, 14,12,10,X);
+    } else {
+        stripLo = _mm_setr_epi8(0,2,4,X, 6,8,10,X, X,X,X,X, X,X,X,X);
+        stripHi = _mm_setr_epi8(X,X,X,X, X,X,X,X, 4,6,8,X, 10,12,14,X);
+    }
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    const __m256i alphaMask8 = _mm256_set1_epi32(0xFF000000),
+                  stripLo8   = _mm256_broadcastsi128_si256(stripLo),
+                  stripHi8   = _mm256_broadcastsi128_si256(stripHi);
+    while (count >= 8) {
+        // Each 128-bit lane handles four pixels, as below.
+        __m256i lo = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) (src + 0))),
+                _mm_loadu_si128((const __m128i*) (src + 24)), 1);
+        __m256i hi = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) (src + 8))),
+                _mm_loadu_si128((const __m128i*) (src + 32)), 1);
+
+        __m256i rgba = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(lo, stripLo8),
+                                                       _mm256_shuffle_epi8(hi, stripHi8)),
+                                       alphaMask8);
+
+        // Store 8 pixels.
+        _mm256_storeu_si256((__m256i*) dst, rgba);
+
+        src += 8*6;
+        dst += 8;
+        count -= 8;
+    }
+#endif
+
+    while (count >= 4) {
+        __m128i lo = _mm_loadu_si128((const __m128i*) (src + 0)),
+                hi = _mm_loadu_si128((const __m128i*) (src + 8));
+
+        __m128i rgba = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(lo, stripLo),
+                                                 _mm_shuffle_epi8(hi, stripHi)),
+                                    alphaMask);
+
+        // Store 4 pixels.
+        _mm_storeu_si128((__m128i*) dst, rgba);
+
+        src += 4*6;
+        dst += 4;
+        count -= 4;
+    }
+
+    // Call portable code to finish up the tail of [0,4) pixels.
+    auto proc = kSwapRB ? RGB16_to_BGR1_portable : RGB16_to_RGB1_portable;
+    proc(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const void* src, int count) {
+    strip16_insert_alpha_should_swaprb<false>(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const void* src, int count) {
+    strip16_insert_alpha_should_swaprb<true>(dst, src, count);
+}
+
+template <bool kSwapRB>
+static void strip16_should_swaprb(uint32_t dst[], const void* vsrc, int count) {
+    const uint8_t* src = (const uint8_t*) vsrc;
+
+    // Keep the first (most significant) byte of each component of two pixels.
+    __m128i strip;
+    const uint8_t X = 0xFF; // Used a placeholder.  The value of X is irrelevant.
+    if (kSwapRB) {
+        strip = _mm_setr_epi8(4,2,0,6, 12,10,8,14, X,X,X,X, X,X,X,X);
+    } else {
+        strip = _mm_setr_epi8(0,2,4,6, 8,10,12,14, X,X,X,X, X,X,X,X);
+    }
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    const __m256i strip8 = _mm256_broadcastsi128_si256(strip);
+    while (count >= 8) {
+        __m256i lo = _mm256_loadu_si256((const __m256i*) (src +  0)),    // pixels 0-1 | 2-3
+                hi = _mm256_loadu_si256((const __m256i*) (src + 32));    // pixels 4-5 | 6-7
+
+        // 0-1 4-5 | 2-3 6-7, then reorder the 64-bit halves to 0-1 2-3 | 4-5 6-7.
+        __m256i rgba = _mm256_unpacklo_epi64(_mm256_shuffle_epi8(lo, strip8),
+                                             _mm256_shuffle_epi8(hi, strip8));
+        rgba = _mm256_permute4x64_epi64(rgba, 0xD8);
+
+        // Store 8 pixels.
+        _mm256_storeu_si256((__m256i*) dst, rgba);
+
+        src += 8*8;
+        dst += 8;
+        count -= 8;
+    }
+#endif
+
+    while (count >= 4) {
+        __m128i lo = _mm_loadu_si128((const __m128i*) (src +  0)),
+                hi = _mm_loadu_si128((const __m128i*) (src + 16));
+
+        __m128i rgba = _mm_unpacklo_epi64(_mm_shuffle_epi8(lo, strip),
+                                          _mm_shuffle_epi8(hi, strip));
+
+        // Store 4 pixels.
+        _mm_storeu_si128((__m128i*) dst, rgba);
+
+        src += 4*8;
+        dst += 4;
+        count -= 4;
+    }
+
+    // Call portable code to finish up the tail of [0,4) pixels.
+    auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+    proc(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const void* src, int count) {
+    strip16_should_swaprb<false>(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const void* src, int count) {
+    strip16_should_swaprb<true>(dst, src, count);
+}
+
 #else
 
 /*not static*/ inline void RGBA_to_rgbA(uint32_t* dst, const void* src, int count) {
@@ -839,8 +1104,104 @@ static void inverted_cmyk_to(uint32_t* dst, const void* vsrc, int count) {
     inverted_CMYK_to_BGR1_portable(dst, src, count);
 }
 
+/*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const void* src, int count) {
+    RGB16_to_RGB1_portable(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const void* src, int count) {
+    RGB16_to_BGR1_portable(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const void* src, int count) {
+    RGBA16_to_RGBA_portable(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const void* src, int count) {
+    RGBA16_to_BGRA_portable(dst, src, count);
+}
+
+#endif
+
+// Unpremultiplies exactly like SkUnPreMultiply, just several pixels at a time: each alpha's scale
+// still comes from SkUnPreMultiply's table, and only the multiplies are vectorized.  Like it, we
+// leave pixels with alpha 0 alone (the table's scale for 0 is 0, so we substitute 1.0).
+template <bool kSwapRB>
+static void unpremul_should_swapRB(uint32_t* dst, const void* vsrc, int count) {
+    auto src = (const uint32_t*)vsrc;
+    const SkUnPreMultiply::Scale* table = SkUnPreMultiply::GetScaleTable();
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    const __m256i zero   = _mm256_setzero_si256(),
+                  one    = _mm256_set1_epi32(1 << 24),
+                  half   = _mm256_set1_epi32(1 << 23),
+                  mask   = _mm256_set1_epi32(0xFF);
+    while (count >= 8) {
+        __m256i px = _mm256_loadu_si256((const __m256i*)src),
+                a  = _mm256_srli_epi32(px, 24),
+                scale = _mm256_blendv_epi8(_mm256_i32gather_epi32((const int*)table, a, 4), one,
+                                           _mm256_cmpeq_epi32(a, zero));
+        auto apply = [&](__m256i c) {
+            c = _mm256_and_si256(c, mask);
+            return _mm256_srli_epi32(_mm256_add_epi32(_mm256_mullo_epi32(scale, c), half), 24);
+        };
+        __m256i r = apply(px),
+                g = apply(_mm256_srli_epi32(px,  8)),
+                b = apply(_mm256_srli_epi32(px, 16));
+        if (kSwapRB) {
+            std::swap(r, b);
+        }
+        px = _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                             _mm256_or_si256(_mm256_slli_epi32(b, 16), _mm256_slli_epi32(a, 24)));
+        _mm256_storeu_si256((__m256i*)dst, px);
+
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
 #endif
 
+    while (count >= 4) {
+        Sk4u px = Sk4u::Load(src),
+             a  = px >> 24,
+             scale = (a == Sk4u(0)).thenElse(Sk4u(1 << 24),
+                                             Sk4u(table[a[0]], table[a[1]],
+                                                  table[a[2]], table[a[3]]));
+        auto apply = [&](const Sk4u& c) { return (scale * (c & 0xFF) + (1 << 23)) >> 24; };
+        Sk4u r = apply(px),
+             g = apply(px >>  8),
+             b = apply(px >> 16);
+        if (kSwapRB) {
+            std::swap(r, b);
+        }
+        (r | g << 8 | b << 16 | a << 24).store(dst);
+
+        src += 4;
+        dst += 4;
+        count -= 4;
+    }
+
+    while (count --> 0) {
+        uint32_t px = *src++;
+        uint32_t a = px >> 24,
+                 scale = a ? table[a] : 1 << 24;
+        uint32_t r = (scale * ((px >>  0) & 0xFF) + (1 << 23)) >> 24,
+                 g = (scale * ((px >>  8) & 0xFF) + (1 << 23)) >> 24,
+                 b = (scale * ((px >> 16) & 0xFF) + (1 << 23)) >> 24;
+        if (kSwapRB) {
+            std::swap(r, b);
+        }
+        *dst++ = r | g << 8 | b << 16 | a << 24;
+    }
+}
+
+/*not static*/ inline void rgbA_to_RGBA(uint32_t* dst, const void* src, int count) {
+    unpremul_should_swapRB<false>(dst, src, count);
+}
+
+/*not static*/ inline void rgbA_to_BGRA(uint32_t* dst, const void* src, int count) {
+    unpremul_should_swapRB<true>(dst, src, count);
+}
+
 }
 
 #endif // SkSwizzler_opts_DEFINED
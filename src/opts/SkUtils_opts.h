@@ -11,6 +11,10 @@
 #include <stdint.h>
 #include "SkNx.h"
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <immintrin.h>
+#endif
+
 namespace SK_OPTS_NS {
 
     template <typename T>
@@ -40,6 +44,65 @@ namespace SK_OPTS_NS {
         memsetT(buffer, value, count);
     }
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    static inline __m128i splat(uint16_t v) { return _mm_set1_epi16((short)v); }
+    static inline __m128i splat(uint32_t v) { return _mm_set1_epi32((int)v); }
+    static inline __m128i splat(uint64_t v) { return _mm_set1_epi64x((long long)v); }
+#endif
+
+    // Fills bigger than this would push most everything else out of a typical last level cache,
+    // only to leave it full of pixels that won't be read again for a while.  We write those
+    // around the cache with non-temporal stores where we have them.  (Smaller fills that still fit
+    // in a big server cache are faster with regular stores, so this errs on the large side.)
+    static const size_t kNonTemporalFillBytes = 16 << 20;
+
+    template <typename T>
+    static void rect_memsetT(T buffer[], T value, int count, size_t rowBytes, int height) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        if ((size_t)count * sizeof(T) * height > kNonTemporalFillBytes) {
+            static const int N = 16 / sizeof(T);
+            const __m128i v = splat(value);
+            for (int y = 0; y < height; y++) {
+                T* row = (T*)((char*)buffer + y * rowBytes);
+                int n = count;
+                // Non-temporal stores must be aligned.
+                while (n > 0 && ((uintptr_t)row & 15)) {
+                    *row++ = value;
+                    n--;
+                }
+                while (n >= N) {
+                    _mm_stream_si128((__m128i*)row, v);
+                    row += N;
+                    n   -= N;
+                }
+                while (n --> 0) {
+                    *row++ = value;
+                }
+            }
+            // Non-temporal stores aren't ordered with other stores, so make sure they're done
+            // before anyone might read these pixels.
+            _mm_sfence();
+            return;
+        }
+    #endif
+        for (int y = 0; y < height; y++) {
+            memsetT((T*)((char*)buffer + y * rowBytes), value, count);
+        }
+    }
+
+    /*not static*/ inline void rect_memset16(uint16_t buffer[], uint16_t value, int count,
+                                             size_t rowBytes, int height) {
+        rect_memsetT(buffer, value, count, rowBytes, height);
+    }
+    /*not static*/ inline void rect_memset32(uint32_t buffer[], uint32_t value, int count,
+                                             size_t rowBytes, int height) {
+        rect_memsetT(buffer, value, count, rowBytes, height);
+    }
+    /*not static*/ inline void rect_memset64(uint64_t buffer[], uint64_t value, int count,
+                                             size_t rowBytes, int height) {
+        rect_memsetT(buffer, value, count, rowBytes, height);
+    }
+
 }
 
 #endif//SkUtils_opts_DEFINED
@@ -5,8 +5,15 @@
  * found in the LICENSE file.
  */
 #include "SkAddIntersections.h"
+#include "SkExecutor.h"
+#include "SkMakeUnique.h"
 #include "SkOpCoincidence.h"
 #include "SkPathOpsBounds.h"
+#include "SkTHash.h"
+#include "SkTSort.h"
+#include "SkTaskGroup.h"
+
+#include <algorithm>
 
 #if DEBUG_ADD_INTERSECTING_TS
 
@@ -254,323 +261,525 @@ static void debugShowCubicIntersection(int , const SkIntersectionHelper& ,
 }
 #endif
 
-bool AddIntersectTs(SkOpContour* test, SkOpContour* next, SkOpCoincidence* coincidence) {
-    if (test != next) {
-        if (AlmostLessUlps(test->bounds().fBottom, next->bounds().fTop)) {
-            return false;
-        }
-        // OPTIMIZATION: outset contour bounds a smidgen instead?
-        if (!SkPathOpsBounds::Intersects(test->bounds(), next->bounds())) {
-            return true;
-        }
-    }
-    SkIntersectionHelper wt;
-    wt.init(test);
-    do {
-        SkIntersectionHelper wn;
-        wn.init(next);
-        test->debugValidate();
-        next->debugValidate();
-        if (test == next && !wn.startAfter(wt)) {
-            continue;
-        }
-        do {
-            if (!SkPathOpsBounds::Intersects(wt.bounds(), wn.bounds())) {
-                continue;
+// Finds where the segments of wt and wn cross. This only reads their points and bounds, so it
+// may run for several pairs at once. Sets swap if ts holds wn's t values first.
+static int intersect_segments(const SkIntersectionHelper& wt, const SkIntersectionHelper& wn,
+                              SkIntersections* intersections, bool* swapPtr) {
+    SkIntersections& ts = *intersections;
+    int pts = 0;
+    bool swap = false;
+    SkDQuad quad1, quad2;
+    SkDConic conic1, conic2;
+    SkDCubic cubic1, cubic2;
+    switch (wt.segmentType()) {
+        case SkIntersectionHelper::kHorizontalLine_Segment:
+            swap = true;
+            switch (wn.segmentType()) {
+                case SkIntersectionHelper::kHorizontalLine_Segment:
+                case SkIntersectionHelper::kVerticalLine_Segment:
+                case SkIntersectionHelper::kLine_Segment:
+                    pts = ts.lineHorizontal(wn.pts(), wt.left(),
+                            wt.right(), wt.y(), wt.xFlipped());
+                    debugShowLineIntersection(pts, wn, wt, ts);
+                    break;
+                case SkIntersectionHelper::kQuad_Segment:
+                    pts = ts.quadHorizontal(wn.pts(), wt.left(),
+                            wt.right(), wt.y(), wt.xFlipped());
+                    debugShowQuadLineIntersection(pts, wn, wt, ts);
+                    break;
+                case SkIntersectionHelper::kConic_Segment:
+                    pts = ts.conicHorizontal(wn.pts(), wn.weight(), wt.left(),
+                            wt.right(), wt.y(), wt.xFlipped());
+                    debugShowConicLineIntersection(pts, wn, wt, ts);
+                    break;
+                case SkIntersectionHelper::kCubic_Segment:
+                    pts = ts.cubicHorizontal(wn.pts(), wt.left(),
+                            wt.right(), wt.y(), wt.xFlipped());
+                    debugShowCubicLineIntersection(pts, wn, wt, ts);
+                    break;
+                default:
+                    SkASSERT(0);
             }
-            int pts = 0;
-            SkIntersections ts { SkDEBUGCODE(test->globalState()) };
-            bool swap = false;
-            SkDQuad quad1, quad2;
-            SkDConic conic1, conic2;
-            SkDCubic cubic1, cubic2;
-            switch (wt.segmentType()) {
+            break;
+        case SkIntersectionHelper::kVerticalLine_Segment:
+            swap = true;
+            switch (wn.segmentType()) {
                 case SkIntersectionHelper::kHorizontalLine_Segment:
-                    swap = true;
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                        case SkIntersectionHelper::kLine_Segment:
-                            pts = ts.lineHorizontal(wn.pts(), wt.left(),
-                                    wt.right(), wt.y(), wt.xFlipped());
-                            debugShowLineIntersection(pts, wn, wt, ts);
-                            break;
-                        case SkIntersectionHelper::kQuad_Segment:
-                            pts = ts.quadHorizontal(wn.pts(), wt.left(),
-                                    wt.right(), wt.y(), wt.xFlipped());
-                            debugShowQuadLineIntersection(pts, wn, wt, ts);
-                            break;
-                        case SkIntersectionHelper::kConic_Segment:
-                            pts = ts.conicHorizontal(wn.pts(), wn.weight(), wt.left(),
-                                    wt.right(), wt.y(), wt.xFlipped());
-                            debugShowConicLineIntersection(pts, wn, wt, ts);
-                            break;
-                        case SkIntersectionHelper::kCubic_Segment:
-                            pts = ts.cubicHorizontal(wn.pts(), wt.left(),
-                                    wt.right(), wt.y(), wt.xFlipped());
-                            debugShowCubicLineIntersection(pts, wn, wt, ts);
-                            break;
-                        default:
-                            SkASSERT(0);
-                    }
+                case SkIntersectionHelper::kVerticalLine_Segment:
+                case SkIntersectionHelper::kLine_Segment: {
+                    pts = ts.lineVertical(wn.pts(), wt.top(),
+                            wt.bottom(), wt.x(), wt.yFlipped());
+                    debugShowLineIntersection(pts, wn, wt, ts);
+                    break;
+                }
+                case SkIntersectionHelper::kQuad_Segment: {
+                    pts = ts.quadVertical(wn.pts(), wt.top(),
+                            wt.bottom(), wt.x(), wt.yFlipped());
+                    debugShowQuadLineIntersection(pts, wn, wt, ts);
+                    break;
+                }
+                case SkIntersectionHelper::kConic_Segment: {
+                    pts = ts.conicVertical(wn.pts(), wn.weight(), wt.top(),
+                            wt.bottom(), wt.x(), wt.yFlipped());
+                    debugShowConicLineIntersection(pts, wn, wt, ts);
+                    break;
+                }
+                case SkIntersectionHelper::kCubic_Segment: {
+                    pts = ts.cubicVertical(wn.pts(), wt.top(),
+                            wt.bottom(), wt.x(), wt.yFlipped());
+                    debugShowCubicLineIntersection(pts, wn, wt, ts);
+                    break;
+                }
+                default:
+                    SkASSERT(0);
+            }
+            break;
+        case SkIntersectionHelper::kLine_Segment:
+            switch (wn.segmentType()) {
+                case SkIntersectionHelper::kHorizontalLine_Segment:
+                    pts = ts.lineHorizontal(wt.pts(), wn.left(),
+                            wn.right(), wn.y(), wn.xFlipped());
+                    debugShowLineIntersection(pts, wt, wn, ts);
                     break;
                 case SkIntersectionHelper::kVerticalLine_Segment:
-                    swap = true;
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                        case SkIntersectionHelper::kLine_Segment: {
-                            pts = ts.lineVertical(wn.pts(), wt.top(),
-                                    wt.bottom(), wt.x(), wt.yFlipped());
-                            debugShowLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kQuad_Segment: {
-                            pts = ts.quadVertical(wn.pts(), wt.top(),
-                                    wt.bottom(), wt.x(), wt.yFlipped());
-                            debugShowQuadLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kConic_Segment: {
-                            pts = ts.conicVertical(wn.pts(), wn.weight(), wt.top(),
-                                    wt.bottom(), wt.x(), wt.yFlipped());
-                            debugShowConicLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kCubic_Segment: {
-                            pts = ts.cubicVertical(wn.pts(), wt.top(),
-                                    wt.bottom(), wt.x(), wt.yFlipped());
-                            debugShowCubicLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        default:
-                            SkASSERT(0);
-                    }
+                    pts = ts.lineVertical(wt.pts(), wn.top(),
+                            wn.bottom(), wn.x(), wn.yFlipped());
+                    debugShowLineIntersection(pts, wt, wn, ts);
                     break;
                 case SkIntersectionHelper::kLine_Segment:
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                            pts = ts.lineHorizontal(wt.pts(), wn.left(),
-                                    wn.right(), wn.y(), wn.xFlipped());
-                            debugShowLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                            pts = ts.lineVertical(wt.pts(), wn.top(),
-                                    wn.bottom(), wn.x(), wn.yFlipped());
-                            debugShowLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kLine_Segment:
-                            pts = ts.lineLine(wt.pts(), wn.pts());
-                            debugShowLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kQuad_Segment:
-                            swap = true;
-                            pts = ts.quadLine(wn.pts(), wt.pts());
-                            debugShowQuadLineIntersection(pts, wn, wt, ts);
-                            break;
-                        case SkIntersectionHelper::kConic_Segment:
-                            swap = true;
-                            pts = ts.conicLine(wn.pts(), wn.weight(), wt.pts());
-                            debugShowConicLineIntersection(pts, wn, wt, ts);
-                            break;
-                        case SkIntersectionHelper::kCubic_Segment:
-                            swap = true;
-                            pts = ts.cubicLine(wn.pts(), wt.pts());
-                            debugShowCubicLineIntersection(pts, wn, wt, ts);
-                            break;
-                        default:
-                            SkASSERT(0);
-                    }
+                    pts = ts.lineLine(wt.pts(), wn.pts());
+                    debugShowLineIntersection(pts, wt, wn, ts);
                     break;
                 case SkIntersectionHelper::kQuad_Segment:
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                            pts = ts.quadHorizontal(wt.pts(), wn.left(),
-                                    wn.right(), wn.y(), wn.xFlipped());
-                            debugShowQuadLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                            pts = ts.quadVertical(wt.pts(), wn.top(),
-                                    wn.bottom(), wn.x(), wn.yFlipped());
-                            debugShowQuadLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kLine_Segment:
-                            pts = ts.quadLine(wt.pts(), wn.pts());
-                            debugShowQuadLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kQuad_Segment: {
-                            pts = ts.intersect(quad1.set(wt.pts()), quad2.set(wn.pts()));
-                            debugShowQuadIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kConic_Segment: {
-                            swap = true;
-                            pts = ts.intersect(conic2.set(wn.pts(), wn.weight()),
-                                    quad1.set(wt.pts()));
-                            debugShowConicQuadIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kCubic_Segment: {
-                            swap = true;
-                            pts = ts.intersect(cubic2.set(wn.pts()), quad1.set(wt.pts()));
-                            debugShowCubicQuadIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        default:
-                            SkASSERT(0);
-                    }
+                    swap = true;
+                    pts = ts.quadLine(wn.pts(), wt.pts());
+                    debugShowQuadLineIntersection(pts, wn, wt, ts);
                     break;
                 case SkIntersectionHelper::kConic_Segment:
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                            pts = ts.conicHorizontal(wt.pts(), wt.weight(), wn.left(),
-                                    wn.right(), wn.y(), wn.xFlipped());
-                            debugShowConicLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                            pts = ts.conicVertical(wt.pts(), wt.weight(), wn.top(),
-                                    wn.bottom(), wn.x(), wn.yFlipped());
-                            debugShowConicLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kLine_Segment:
-                            pts = ts.conicLine(wt.pts(), wt.weight(), wn.pts());
-                            debugShowConicLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kQuad_Segment: {
-                            pts = ts.intersect(conic1.set(wt.pts(), wt.weight()),
-                                    quad2.set(wn.pts()));
-                            debugShowConicQuadIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kConic_Segment: {
-                            pts = ts.intersect(conic1.set(wt.pts(), wt.weight()),
-                                    conic2.set(wn.pts(), wn.weight()));
-                            debugShowConicIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kCubic_Segment: {
-                            swap = true;
-                            pts = ts.intersect(cubic2.set(wn.pts()
-                                    SkDEBUGPARAMS(ts.globalState())),
-                                    conic1.set(wt.pts(), wt.weight()
-                                    SkDEBUGPARAMS(ts.globalState())));
-                            debugShowCubicConicIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                    }
+                    swap = true;
+                    pts = ts.conicLine(wn.pts(), wn.weight(), wt.pts());
+                    debugShowConicLineIntersection(pts, wn, wt, ts);
                     break;
                 case SkIntersectionHelper::kCubic_Segment:
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                            pts = ts.cubicHorizontal(wt.pts(), wn.left(),
-                                    wn.right(), wn.y(), wn.xFlipped());
-                            debugShowCubicLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                            pts = ts.cubicVertical(wt.pts(), wn.top(),
-                                    wn.bottom(), wn.x(), wn.yFlipped());
-                            debugShowCubicLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kLine_Segment:
-                            pts = ts.cubicLine(wt.pts(), wn.pts());
-                            debugShowCubicLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kQuad_Segment: {
-                            pts = ts.intersect(cubic1.set(wt.pts()), quad2.set(wn.pts()));
-                            debugShowCubicQuadIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kConic_Segment: {
-                            pts = ts.intersect(cubic1.set(wt.pts()
-                                    SkDEBUGPARAMS(ts.globalState())),
-                                    conic2.set(wn.pts(), wn.weight()
-                                    SkDEBUGPARAMS(ts.globalState())));
-                            debugShowCubicConicIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kCubic_Segment: {
-                            pts = ts.intersect(cubic1.set(wt.pts()), cubic2.set(wn.pts()));
-                            debugShowCubicIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        default:
-                            SkASSERT(0);
-                    }
+                    swap = true;
+                    pts = ts.cubicLine(wn.pts(), wt.pts());
+                    debugShowCubicLineIntersection(pts, wn, wt, ts);
                     break;
                 default:
                     SkASSERT(0);
             }
-#if DEBUG_T_SECT_LOOP_COUNT
-            test->globalState()->debugAddLoopCount(&ts, wt, wn);
-#endif
-            int coinIndex = -1;
-            SkOpPtT* coinPtT[2];
-            for (int pt = 0; pt < pts; ++pt) {
-                SkASSERT(ts[0][pt] >= 0 && ts[0][pt] <= 1);
-                SkASSERT(ts[1][pt] >= 0 && ts[1][pt] <= 1);
-                wt.segment()->debugValidate();
-                // if t value is used to compute pt in addT, error may creep in and
-                // rect intersections may result in non-rects. if pt value from intersection
-                // is passed in, current tests break. As a workaround, pass in pt
-                // value from intersection only if pt.x and pt.y is integral
-                SkPoint iPt = ts.pt(pt).asSkPoint();
-                bool iPtIsIntegral = iPt.fX == floor(iPt.fX) && iPt.fY == floor(iPt.fY);
-                SkOpPtT* testTAt = iPtIsIntegral ? wt.segment()->addT(ts[swap][pt], iPt)
-                        : wt.segment()->addT(ts[swap][pt]);
-                wn.segment()->debugValidate();
-                SkOpPtT* nextTAt = iPtIsIntegral ? wn.segment()->addT(ts[!swap][pt], iPt)
-                        : wn.segment()->addT(ts[!swap][pt]);
-                if (!testTAt->contains(nextTAt)) {
-                    SkOpPtT* oppPrev = testTAt->oppPrev(nextTAt);  //  Returns nullptr if pair
-                    if (oppPrev) {                                 //  already share a pt-t loop.
-                        testTAt->span()->mergeMatches(nextTAt->span());
-                        testTAt->addOpp(nextTAt, oppPrev);
-                    }
-                    if (testTAt->fPt != nextTAt->fPt) {
-                        testTAt->span()->unaligned();
-                        nextTAt->span()->unaligned();
-                    }
-                    wt.segment()->debugValidate();
-                    wn.segment()->debugValidate();
+            break;
+        case SkIntersectionHelper::kQuad_Segment:
+            switch (wn.segmentType()) {
+                case SkIntersectionHelper::kHorizontalLine_Segment:
+                    pts = ts.quadHorizontal(wt.pts(), wn.left(),
+                            wn.right(), wn.y(), wn.xFlipped());
+                    debugShowQuadLineIntersection(pts, wt, wn, ts);
+                    break;
+                case SkIntersectionHelper::kVerticalLine_Segment:
+                    pts = ts.quadVertical(wt.pts(), wn.top(),
+                            wn.bottom(), wn.x(), wn.yFlipped());
+                    debugShowQuadLineIntersection(pts, wt, wn, ts);
+                    break;
+                case SkIntersectionHelper::kLine_Segment:
+                    pts = ts.quadLine(wt.pts(), wn.pts());
+                    debugShowQuadLineIntersection(pts, wt, wn, ts);
+                    break;
+                case SkIntersectionHelper::kQuad_Segment: {
+                    pts = ts.intersect(quad1.set(wt.pts()), quad2.set(wn.pts()));
+                    debugShowQuadIntersection(pts, wt, wn, ts);
+                    break;
                 }
-                if (!ts.isCoincident(pt)) {
-                    continue;
+                case SkIntersectionHelper::kConic_Segment: {
+                    swap = true;
+                    pts = ts.intersect(conic2.set(wn.pts(), wn.weight()),
+                            quad1.set(wt.pts()));
+                    debugShowConicQuadIntersection(pts, wn, wt, ts);
+                    break;
                 }
-                if (coinIndex < 0) {
-                    coinPtT[0] = testTAt;
-                    coinPtT[1] = nextTAt;
-                    coinIndex = pt;
-                    continue;
+                case SkIntersectionHelper::kCubic_Segment: {
+                    swap = true;
+                    pts = ts.intersect(cubic2.set(wn.pts()), quad1.set(wt.pts()));
+                    debugShowCubicQuadIntersection(pts, wn, wt, ts);
+                    break;
                 }
-                if (coinPtT[0]->span() == testTAt->span()) {
-                    coinIndex = -1;
-                    continue;
+                default:
+                    SkASSERT(0);
+            }
+            break;
+        case SkIntersectionHelper::kConic_Segment:
+            switch (wn.segmentType()) {
+                case SkIntersectionHelper::kHorizontalLine_Segment:
+                    pts = ts.conicHorizontal(wt.pts(), wt.weight(), wn.left(),
+                            wn.right(), wn.y(), wn.xFlipped());
+                    debugShowConicLineIntersection(pts, wt, wn, ts);
+                    break;
+                case SkIntersectionHelper::kVerticalLine_Segment:
+                    pts = ts.conicVertical(wt.pts(), wt.weight(), wn.top(),
+                            wn.bottom(), wn.x(), wn.yFlipped());
+                    debugShowConicLineIntersection(pts, wt, wn, ts);
+                    break;
+                case SkIntersectionHelper::kLine_Segment:
+                    pts = ts.conicLine(wt.pts(), wt.weight(), wn.pts());
+                    debugShowConicLineIntersection(pts, wt, wn, ts);
+                    break;
+                case SkIntersectionHelper::kQuad_Segment: {
+                    pts = ts.intersect(conic1.set(wt.pts(), wt.weight()),
+                            quad2.set(wn.pts()));
+                    debugShowConicQuadIntersection(pts, wt, wn, ts);
+                    break;
                 }
-                if (coinPtT[1]->span() == nextTAt->span()) {
-                    coinIndex = -1;  // coincidence span collapsed
-                    continue;
+                case SkIntersectionHelper::kConic_Segment: {
+                    pts = ts.intersect(conic1.set(wt.pts(), wt.weight()),
+                            conic2.set(wn.pts(), wn.weight()));
+                    debugShowConicIntersection(pts, wt, wn, ts);
+                    break;
                 }
-                if (swap) {
-                    SkTSwap(coinPtT[0], coinPtT[1]);
-                    SkTSwap(testTAt, nextTAt);
+                case SkIntersectionHelper::kCubic_Segment: {
+                    swap = true;
+                    pts = ts.intersect(cubic2.set(wn.pts()
+                            SkDEBUGPARAMS(ts.globalState())),
+                            conic1.set(wt.pts(), wt.weight()
+                            SkDEBUGPARAMS(ts.globalState())));
+                    debugShowCubicConicIntersection(pts, wn, wt, ts);
+                    break;
                 }
-                SkASSERT(coincidence->globalState()->debugSkipAssert()
-                        || coinPtT[0]->span()->t() < testTAt->span()->t());
-                if (coinPtT[0]->span()->deleted()) {
-                    coinIndex = -1;
-                    continue;
+            }
+            break;
+        case SkIntersectionHelper::kCubic_Segment:
+            switch (wn.segmentType()) {
+                case SkIntersectionHelper::kHorizontalLine_Segment:
+                    pts = ts.cubicHorizontal(wt.pts(), wn.left(),
+                            wn.right(), wn.y(), wn.xFlipped());
+                    debugShowCubicLineIntersection(pts, wt, wn, ts);
+                    break;
+                case SkIntersectionHelper::kVerticalLine_Segment:
+                    pts = ts.cubicVertical(wt.pts(), wn.top(),
+                            wn.bottom(), wn.x(), wn.yFlipped());
+                    debugShowCubicLineIntersection(pts, wt, wn, ts);
+                    break;
+                case SkIntersectionHelper::kLine_Segment:
+                    pts = ts.cubicLine(wt.pts(), wn.pts());
+                    debugShowCubicLineIntersection(pts, wt, wn, ts);
+                    break;
+                case SkIntersectionHelper::kQuad_Segment: {
+                    pts = ts.intersect(cubic1.set(wt.pts()), quad2.set(wn.pts()));
+                    debugShowCubicQuadIntersection(pts, wt, wn, ts);
+                    break;
+                }
+                case SkIntersectionHelper::kConic_Segment: {
+                    pts = ts.intersect(cubic1.set(wt.pts()
+                            SkDEBUGPARAMS(ts.globalState())),
+                            conic2.set(wn.pts(), wn.weight()
+                            SkDEBUGPARAMS(ts.globalState())));
+                    debugShowCubicConicIntersection(pts, wt, wn, ts);
+                    break;
                 }
-                if (testTAt->span()->deleted()) {
-                    coinIndex = -1;
+                case SkIntersectionHelper::kCubic_Segment: {
+                    pts = ts.intersect(cubic1.set(wt.pts()), cubic2.set(wn.pts()));
+                    debugShowCubicIntersection(pts, wt, wn, ts);
+                    break;
+                }
+                default:
+                    SkASSERT(0);
+            }
+            break;
+        default:
+            SkASSERT(0);
+    }
+    *swapPtr = swap;
+    return pts;
+}
+
+// Adds the crossings found by intersect_segments() to both segments, and records coincidences.
+static void add_intersection_ts(const SkIntersectionHelper& wt, const SkIntersectionHelper& wn,
+                                SkIntersections* intersections, int pts, bool swap,
+                                SkOpCoincidence* coincidence) {
+    SkIntersections& ts = *intersections;
+#if DEBUG_T_SECT_LOOP_COUNT
+    wt.contour()->globalState()->debugAddLoopCount(&ts, wt, wn);
+#endif
+    int coinIndex = -1;
+    SkOpPtT* coinPtT[2];
+    for (int pt = 0; pt < pts; ++pt) {
+        SkASSERT(ts[0][pt] >= 0 && ts[0][pt] <= 1);
+        SkASSERT(ts[1][pt] >= 0 && ts[1][pt] <= 1);
+        wt.segment()->debugValidate();
+        // if t value is used to compute pt in addT, error may creep in and
+        // rect intersections may result in non-rects. if pt value from intersection
+        // is passed in, current tests break. As a workaround, pass in pt
+        // value from intersection only if pt.x and pt.y is integral
+        SkPoint iPt = ts.pt(pt).asSkPoint();
+        bool iPtIsIntegral = iPt.fX == floor(iPt.fX) && iPt.fY == floor(iPt.fY);
+        SkOpPtT* testTAt = iPtIsIntegral ? wt.segment()->addT(ts[swap][pt], iPt)
+                : wt.segment()->addT(ts[swap][pt]);
+        wn.segment()->debugValidate();
+        SkOpPtT* nextTAt = iPtIsIntegral ? wn.segment()->addT(ts[!swap][pt], iPt)
+                : wn.segment()->addT(ts[!swap][pt]);
+        if (!testTAt->contains(nextTAt)) {
+            SkOpPtT* oppPrev = testTAt->oppPrev(nextTAt);  //  Returns nullptr if pair
+            if (oppPrev) {                                 //  already share a pt-t loop.
+                testTAt->span()->mergeMatches(nextTAt->span());
+                testTAt->addOpp(nextTAt, oppPrev);
+            }
+            if (testTAt->fPt != nextTAt->fPt) {
+                testTAt->span()->unaligned();
+                nextTAt->span()->unaligned();
+            }
+            wt.segment()->debugValidate();
+            wn.segment()->debugValidate();
+        }
+        if (!ts.isCoincident(pt)) {
+            continue;
+        }
+        if (coinIndex < 0) {
+            coinPtT[0] = testTAt;
+            coinPtT[1] = nextTAt;
+            coinIndex = pt;
+            continue;
+        }
+        if (coinPtT[0]->span() == testTAt->span()) {
+            coinIndex = -1;
+            continue;
+        }
+        if (coinPtT[1]->span() == nextTAt->span()) {
+            coinIndex = -1;  // coincidence span collapsed
+            continue;
+        }
+        if (swap) {
+            SkTSwap(coinPtT[0], coinPtT[1]);
+            SkTSwap(testTAt, nextTAt);
+        }
+        SkASSERT(coincidence->globalState()->debugSkipAssert()
+                || coinPtT[0]->span()->t() < testTAt->span()->t());
+        if (coinPtT[0]->span()->deleted()) {
+            coinIndex = -1;
+            continue;
+        }
+        if (testTAt->span()->deleted()) {
+            coinIndex = -1;
+            continue;
+        }
+        coincidence->add(coinPtT[0], testTAt, coinPtT[1], nextTAt);
+        wt.segment()->debugValidate();
+        wn.segment()->debugValidate();
+        coinIndex = -1;
+    }
+    SkOPOBJASSERT(coincidence, coinIndex < 0);  // expect coincidence to be paired
+}
+
+namespace {
+
+// A contour with fewer segments is tested segment by segment, as sorting it costs more than it
+// saves.
+static constexpr int kMinSegmentsToSweep = 32;
+
+// With an executor, pairs of segments are intersected in parallel in batches of up to this many,
+// then added to the segments serially in the order the serial path would add them.
+static constexpr int kMaxBatchPairs = 1024;
+static constexpr int kMinPairsPerTask = 16;
+static constexpr int kMaxTasks = 64;
+
+// Widens the sweep window beyond the ulps tolerance SkPathOpsBounds::Intersects() allows, so the
+// sweep never skips a pair that test would accept.
+static SkScalar sweep_margin(SkScalar v) {
+    return (SkScalarAbs(v) + 1) * (1.0f / 4096);
+}
+
+// The segments of a contour, sorted by the top of their bounds.
+class SegmentSweep {
+public:
+    struct Entry {
+        SkScalar     fTop;
+        int          fIndex;     // position in the contour
+        SkOpSegment* fSegment;
+    };
+
+    explicit SegmentSweep(SkOpContour* contour) : fMaxHeight(0) {
+        int index = 0;
+        SkOpSegment* segment = contour->first();
+        do {
+            const SkPathOpsBounds& bounds = segment->bounds();
+            fEntries.push_back({bounds.fTop, index++, segment});
+            fMaxHeight = SkTMax(fMaxHeight, bounds.fBottom - bounds.fTop);
+        } while ((segment = segment->next()));
+        SkTQSort(fEntries.begin(), fEntries.end() - 1, [](const Entry& a, const Entry& b) {
+            return a.fTop < b.fTop || (a.fTop == b.fTop && a.fIndex < b.fIndex);
+        });
+    }
+
+    // Sets found to the segments after minIndex whose bounds intersect bounds, in contour order.
+    void find(const SkPathOpsBounds& bounds, int minIndex, SkTArray<Entry, true>* found) const {
+        found->reset();
+        SkScalar minTop = bounds.fTop - fMaxHeight;
+        minTop -= sweep_margin(minTop);
+        SkScalar maxTop = bounds.fBottom + sweep_margin(bounds.fBottom);
+        const Entry* entry = std::lower_bound(fEntries.begin(), fEntries.end(), minTop,
+                [](const Entry& e, SkScalar top) { return e.fTop < top; });
+        for (; entry < fEntries.end() && entry->fTop <= maxTop; ++entry) {
+            if (entry->fIndex > minIndex
+                    && SkPathOpsBounds::Intersects(bounds, entry->fSegment->bounds())) {
+                found->push_back(*entry);
+            }
+        }
+        if (found->count() > 1) {
+            SkTQSort(found->begin(), found->end() - 1, [](const Entry& a, const Entry& b) {
+                return a.fIndex < b.fIndex;
+            });
+        }
+    }
+
+private:
+    SkTArray<Entry, true> fEntries;
+    SkScalar              fMaxHeight;
+};
+
+struct SegmentPair {
+    SegmentPair(SkOpSegment* test, SkOpSegment* next  SkDEBUGPARAMS(SkOpGlobalState* state))
+        : fTest(test)
+        , fNext(next)
+        , fTs(SkDEBUGCODE(state))
+        , fPts(0)
+        , fSwap(false) {}
+
+    SkOpSegment*    fTest;
+    SkOpSegment*    fNext;
+    SkIntersections fTs;
+    int             fPts;
+    bool            fSwap;
+};
+
+// Finds the pairs of segments to intersect in the order the serial path visits them, and adds
+// their intersections in that order too, so the result doesn't depend on the executor.
+class IntersectionFinder {
+public:
+    IntersectionFinder(SkOpGlobalState* globalState, SkOpCoincidence* coincidence)
+        : fGlobalState(globalState)
+        , fExecutor(fGlobalState->executor())
+        , fCoincidence(coincidence) {}
+
+    // Returns false if next starts below test, so the contours sorted after it do too.
+    bool addContours(SkOpContour* test, SkOpContour* next) {
+        if (test != next) {
+            if (AlmostLessUlps(test->bounds().fBottom, next->bounds().fTop)) {
+                return false;
+            }
+            // OPTIMIZATION: outset contour bounds a smidgen instead?
+            if (!SkPathOpsBounds::Intersects(test->bounds(), next->bounds())) {
+                return true;
+            }
+        }
+        if (next->count() < kMinSegmentsToSweep) {
+            SkIntersectionHelper wt;
+            wt.init(test);
+            do {
+                SkIntersectionHelper wn;
+                wn.init(next);
+                if (test == next && !wn.startAfter(wt)) {
                     continue;
                 }
-                coincidence->add(coinPtT[0], testTAt, coinPtT[1], nextTAt);
-                wt.segment()->debugValidate();
-                wn.segment()->debugValidate();
-                coinIndex = -1;
+                do {
+                    if (SkPathOpsBounds::Intersects(wt.bounds(), wn.bounds())) {
+                        this->addPair(wt.segment(), wn.segment());
+                    }
+                } while (wn.advance());
+            } while (wt.advance());
+            return true;
+        }
+        const SegmentSweep* sweep = this->sweep(next);
+        SkTArray<SegmentSweep::Entry, true> found;
+        int index = 0;
+        SkOpSegment* segment = test->first();
+        do {
+            sweep->find(segment->bounds(), test == next ? index : -1, &found);
+            for (const SegmentSweep::Entry& entry : found) {
+                this->addPair(segment, entry.fSegment);
             }
-            SkOPOBJASSERT(coincidence, coinIndex < 0);  // expect coincidence to be paired
-        } while (wn.advance());
-    } while (wt.advance());
-    return true;
+            ++index;
+        } while ((segment = segment->next()));
+        return true;
+    }
+
+    void flush() {
+        int count = fPairs.count();
+        if (!count) {
+            return;
+        }
+        int taskCount = SkTMin(kMaxTasks, count / kMinPairsPerTask);
+        if (taskCount < 2) {
+            for (SegmentPair& pair : fPairs) {
+                intersect(&pair);
+            }
+        } else {
+            SkTaskGroup tasks(*fExecutor);
+            tasks.batch(taskCount, [&](int i) {
+                int start = count *  i      / taskCount,
+                    end   = count * (i + 1) / taskCount;
+                for (int j = start; j < end; ++j) {
+                    intersect(&fPairs[j]);
+                }
+            });
+            tasks.wait();
+        }
+        for (SegmentPair& pair : fPairs) {
+            SkIntersectionHelper wt, wn;
+            wt.init(pair.fTest);
+            wn.init(pair.fNext);
+            add_intersection_ts(wt, wn, &pair.fTs, pair.fPts, pair.fSwap, fCoincidence);
+        }
+        fPairs.reset();
+    }
+
+private:
+    static void intersect(SegmentPair* pair) {
+        SkIntersectionHelper wt, wn;
+        wt.init(pair->fTest);
+        wn.init(pair->fNext);
+        pair->fPts = intersect_segments(wt, wn, &pair->fTs, &pair->fSwap);
+    }
+
+    void addPair(SkOpSegment* test, SkOpSegment* next) {
+        test->debugValidate();
+        next->debugValidate();
+        if (!fExecutor) {
+            SegmentPair pair(test, next  SkDEBUGPARAMS(fGlobalState));
+            intersect(&pair);
+            SkIntersectionHelper wt, wn;
+            wt.init(test);
+            wn.init(next);
+            add_intersection_ts(wt, wn, &pair.fTs, pair.fPts, pair.fSwap, fCoincidence);
+            return;
+        }
+        fPairs.emplace_back(test, next  SkDEBUGPARAMS(fGlobalState));
+        if (fPairs.count() == kMaxBatchPairs) {
+            this->flush();
+        }
+    }
+
+    const SegmentSweep* sweep(SkOpContour* contour) {
+        if (std::unique_ptr<SegmentSweep>* sweep = fSweeps.find(contour)) {
+            return sweep->get();
+        }
+        return fSweeps.set(contour, skstd::make_unique<SegmentSweep>(contour))->get();
+    }
+
+    SkOpGlobalState*                                         fGlobalState;
+    SkExecutor*                                              fExecutor;
+    SkOpCoincidence*                                         fCoincidence;
+    SkTHashMap<SkOpContour*, std::unique_ptr<SegmentSweep>>  fSweeps;
+    SkTArray<SegmentPair>                                    fPairs;
+};
+
+}  // namespace
+
+void AddIntersectTs(SkOpContourHead* contourList, SkOpCoincidence* coincidence) {
+    IntersectionFinder finder(contourList->globalState(), coincidence);
+    SkOpContour* current = contourList;
+    do {
+        SkOpContour* next = current;
+        while (finder.addContours(current, next)
+                && (next = next->next()))
+            ;
+    } while ((current = current->next()));
+    finder.flush();
 }
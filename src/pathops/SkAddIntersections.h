@@ -12,6 +12,8 @@
 
 class SkOpCoincidence;
 
-bool AddIntersectTs(SkOpContour* test, SkOpContour* next, SkOpCoincidence* coincidence);
+// Adds the intersections between every pair of segments in the sorted contour list. If the global
+// state has an executor, the intersections are found in parallel; the result is the same.
+void AddIntersectTs(SkOpContourHead* contourList, SkOpCoincidence* coincidence);
 
 #endif
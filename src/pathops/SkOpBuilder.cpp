@@ -124,6 +124,10 @@ void SkOpBuilder::reset() {
    paths with union ops could be locally resolved and still improve over doing the
    ops one at a time. */
 bool SkOpBuilder::resolve(SkPath* result) {
+    return this->resolve(result, nullptr);
+}
+
+bool SkOpBuilder::resolve(SkPath* result, SkExecutor* executor) {
     SkPath original = *result;
     int count = fOps.count();
     bool allUnion = true;
@@ -161,7 +165,7 @@ bool SkOpBuilder::resolve(SkPath* result) {
     if (!allUnion) {
         *result = fPathRefs[0];
         for (int index = 1; index < count; ++index) {
-            if (!Op(*result, fPathRefs[index], fOps[index], result)) {
+            if (!Op(*result, fPathRefs[index], fOps[index], result, executor)) {
                 reset();
                 *result = original;
                 return false;
@@ -172,7 +176,7 @@ bool SkOpBuilder::resolve(SkPath* result) {
     }
     SkPath sum;
     for (int index = 0; index < count; ++index) {
-        if (!Simplify(fPathRefs[index], &fPathRefs[index])) {
+        if (!Simplify(fPathRefs[index], &fPathRefs[index], executor)) {
             reset();
             *result = original;
             return false;
@@ -187,7 +191,7 @@ bool SkOpBuilder::resolve(SkPath* result) {
         }
     }
     reset();
-    bool success = Simplify(sum, result);
+    bool success = Simplify(sum, result, executor);
     if (!success) {
         *result = original;
     }
@@ -10,6 +10,7 @@
 #include "SkOpAngle.h"
 #include "SkTDArray.h"
 
+class SkExecutor;
 class SkOpCoincidence;
 class SkOpContour;
 class SkPathWriter;
@@ -26,6 +27,10 @@ bool HandleCoincidence(SkOpContourHead* , SkOpCoincidence* );
 bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
              SkDEBUGPARAMS(bool skipAssert)
              SkDEBUGPARAMS(const char* testName));
+bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+             SkExecutor* executor
+             SkDEBUGPARAMS(bool skipAssert)
+             SkDEBUGPARAMS(const char* testName));
 SkScalar ScaleFactor(const SkPath& path);
 void ScalePath(const SkPath& path, SkScalar scale, SkPath* scaled);
 
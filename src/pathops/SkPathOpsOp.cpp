@@ -217,11 +217,18 @@ extern void (*gVerboseFinalize)();
 
 bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
         SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
+    return OpDebug(one, two, op, result, nullptr  SkDEBUGPARAMS(skipAssert)
+                   SkDEBUGPARAMS(testName));
+}
+
+bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+        SkExecutor* executor  SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
     SkSTArenaAlloc<4096> allocator;  // FIXME: add a constant expression here, tune
     SkOpContour contour;
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
     SkOpGlobalState globalState(contourList, &allocator
             SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+    globalState.setExecutor(executor);
     SkOpCoincidence coincidence(&globalState);
 #if DEBUG_DUMP_VERIFY
 #ifndef SK_DEBUG
@@ -275,13 +282,7 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
         return true;
     }
     // find all intersections between segments
-    SkOpContour* current = contourList;
-    do {
-        SkOpContour* next = current;
-        while (AddIntersectTs(current, next, &coincidence)
-                && (next = next->next()))
-            ;
-    } while ((current = current->next()));
+    AddIntersectTs(contourList, &coincidence);
 #if DEBUG_VALIDATE
     globalState.setPhase(SkOpPhase::kWalking);
 #endif
@@ -319,9 +320,14 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
 }
 
 bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
+    return Op(one, two, op, result, nullptr);
+}
+
+bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result, SkExecutor* executor) {
 #if DEBUG_DUMP_VERIFY
     if (SkPathOpsDebug::gVerifyOp) {
-        if (!OpDebug(one, two, op, result  SkDEBUGPARAMS(false) SkDEBUGPARAMS(nullptr))) {
+        if (!OpDebug(one, two, op, result, executor  SkDEBUGPARAMS(false)
+                     SkDEBUGPARAMS(nullptr))) {
             SkPathOpsDebug::ReportOpFail(one, two, op);
             return false;
         }
@@ -329,5 +335,5 @@ bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
         return true;
     }
 #endif
-    return OpDebug(one, two, op, result  SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+    return OpDebug(one, two, op, result, executor  SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
 }
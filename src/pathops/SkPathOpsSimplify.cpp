@@ -133,7 +133,7 @@ static bool bridgeXor(SkOpContourHead* contourList, SkPathWriter* simple) {
 }
 
 // FIXME : add this as a member of SkPath
-bool SimplifyDebug(const SkPath& path, SkPath* result
+bool SimplifyDebug(const SkPath& path, SkPath* result, SkExecutor* executor
         SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     SkPath::FillType fillType = path.isInverseFillType() ? SkPath::kInverseEvenOdd_FillType
@@ -151,6 +151,7 @@ bool SimplifyDebug(const SkPath& path, SkPath* result
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
     SkOpGlobalState globalState(contourList, &allocator
             SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+    globalState.setExecutor(executor);
     SkOpCoincidence coincidence(&globalState);
 #if DEBUG_DUMP_VERIFY
 #ifndef SK_DEBUG
@@ -185,12 +186,7 @@ bool SimplifyDebug(const SkPath& path, SkPath* result
         return true;
     }
     // find all intersections between segments
-    SkOpContour* current = contourList;
-    do {
-        SkOpContour* next = current;
-        while (AddIntersectTs(current, next, &coincidence)
-                && (next = next->next()));
-    } while ((current = current->next()));
+    AddIntersectTs(contourList, &coincidence);
 #if DEBUG_VALIDATE
     globalState.setPhase(SkOpPhase::kWalking);
 #endif
@@ -219,10 +215,19 @@ bool SimplifyDebug(const SkPath& path, SkPath* result
     return true;
 }
 
+bool SimplifyDebug(const SkPath& path, SkPath* result
+        SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
+    return SimplifyDebug(path, result, nullptr  SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+}
+
 bool Simplify(const SkPath& path, SkPath* result) {
+    return Simplify(path, result, nullptr);
+}
+
+bool Simplify(const SkPath& path, SkPath* result, SkExecutor* executor) {
 #if DEBUG_DUMP_VERIFY
     if (SkPathOpsDebug::gVerifyOp) {
-        if (!SimplifyDebug(path, result  SkDEBUGPARAMS(false) SkDEBUGPARAMS(nullptr))) {
+        if (!SimplifyDebug(path, result, executor  SkDEBUGPARAMS(false) SkDEBUGPARAMS(nullptr))) {
             SkPathOpsDebug::ReportSimplifyFail(path);
             return false;
         }
@@ -230,5 +235,5 @@ bool Simplify(const SkPath& path, SkPath* result) {
         return true;
     }
 #endif
-    return SimplifyDebug(path, result  SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+    return SimplifyDebug(path, result, executor  SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
 }
@@ -235,6 +235,7 @@ SkOpGlobalState::SkOpGlobalState(SkOpContourHead* head,
     : fAllocator(allocator)
     , fCoincidence(nullptr)
     , fContourHead(head)
+    , fExecutor(nullptr)
     , fNested(0)
     , fWindingFailed(false)
     , fPhase(SkOpPhase::kIntersecting)
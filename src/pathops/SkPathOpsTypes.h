@@ -23,6 +23,7 @@ enum SkPathOpsMask {
 };
 
 class SkArenaAlloc;
+class SkExecutor;
 class SkOpCoincidence;
 class SkOpContour;
 class SkOpContourHead;
@@ -70,6 +71,11 @@ public:
         return fContourHead;
     }
 
+    // Finds intersections in parallel when not null.
+    SkExecutor* executor() const {
+        return fExecutor;
+    }
+
 #ifdef SK_DEBUG
     const class SkOpAngle* debugAngle(int id) const;
     const SkOpCoincidence* debugCoincidence() const;
@@ -163,6 +169,10 @@ public:
         fContourHead = contourHead;
     }
 
+    void setExecutor(SkExecutor* executor) {
+        fExecutor = executor;
+    }
+
     void setPhase(SkOpPhase phase) {
         if (SkOpPhase::kNoChange == phase) {
             return;
@@ -184,6 +194,7 @@ private:
     SkArenaAlloc* fAllocator;
     SkOpCoincidence* fCoincidence;
     SkOpContourHead* fContourHead;
+    SkExecutor* fExecutor;
     int fNested;
     bool fAllocatedOpSpan;
     bool fWindingFailed;
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkTaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+
+// Unlike SkRect::Intersects(), counts bounds that only touch, so that paths sharing an edge are
+// merged rather than appended, which would leave a seam along the edge.
+static bool bounds_touch(const SkRect& a, const SkRect& b) {
+    return a.fLeft <= b.fRight && b.fLeft <= a.fRight && a.fTop <= b.fBottom && b.fTop <= a.fBottom;
+}
+
+static int find_root(SkTDArray<int>* parents, int i) {
+    while ((*parents)[i] != i) {
+        (*parents)[i] = (*parents)[(*parents)[i]];
+        i = (*parents)[i];
+    }
+    return i;
+}
+
+// Runs fn(i) for i in [0, count), on the executor if there is one.
+template <typename Fn>
+static void run_all(SkExecutor* executor, int count, Fn&& fn) {
+    if (executor && count > 1) {
+        SkTaskGroup tasks(*executor);
+        tasks.batch(count, fn);
+        tasks.wait();
+    } else {
+        for (int i = 0; i < count; ++i) {
+            fn(i);
+        }
+    }
+}
+
+// Appends b to a if their bounds are apart, otherwise unions them with Op(). Both are even-odd
+// paths without overlapping contours, as Simplify() and Op() make them, so the appended path is
+// one too.
+static bool merge(SkPath* a, const SkPath& b) {
+    if (b.isEmpty()) {
+        return true;
+    }
+    if (a->isEmpty()) {
+        *a = b;
+        return true;
+    }
+    if (!bounds_touch(a->getBounds(), b.getBounds())) {
+        a->addPath(b);
+        return true;
+    }
+    return Op(*a, b, kUnion_SkPathOp, a);
+}
+
+bool Union(const SkPath paths[], int count, SkPath* result, SkExecutor* executor) {
+    for (int i = 0; i < count; ++i) {
+        if (paths[i].isInverseFillType()) {
+            // An inverse path is unbounded, so nothing is apart from it.
+            SkOpBuilder builder;
+            for (int j = 0; j < count; ++j) {
+                builder.add(paths[j], kUnion_SkPathOp);
+            }
+            return builder.resolve(result, executor);
+        }
+    }
+
+    // Each path is simplified on its own first, so every merge sees non-overlapping contours.
+    SkTArray<SkPath> simple;
+    simple.reset(count);
+    std::atomic<bool> failed{false};
+    run_all(executor, count, [&](int i) {
+        if (!Simplify(paths[i], &simple[i])) {
+            failed = true;
+        }
+    });
+    if (failed) {
+        return false;
+    }
+
+    // Group the paths whose bounds overlap, directly or through others, by sweeping them left to
+    // right. Groups can't overlap each other, so they're unioned independently and appended.
+    SkTDArray<int> order, parents;
+    for (int i = 0; i < count; ++i) {
+        if (!simple[i].isEmpty()) {
+            *order.append() = i;
+        }
+        *parents.append() = i;
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return simple[a].getBounds().fLeft < simple[b].getBounds().fLeft;
+    });
+    SkTDArray<int> active;
+    for (int i : order) {
+        const SkRect& bounds = simple[i].getBounds();
+        int kept = 0;
+        for (int j : active) {
+            const SkRect& other = simple[j].getBounds();
+            if (other.fRight < bounds.fLeft) {
+                continue;   // Every later path starts further right, so drop this one.
+            }
+            active[kept++] = j;
+            if (bounds_touch(bounds, other)) {
+                parents[find_root(&parents, j)] = find_root(&parents, i);
+            }
+        }
+        active.setCount(kept);
+        *active.append() = i;
+    }
+
+    SkTArray<SkTDArray<int>> groups;
+    SkTDArray<int> groupOfRoot;
+    groupOfRoot.setCount(count);
+    for (int i : order) {
+        int root = find_root(&parents, i);
+        if (root == i) {
+            groupOfRoot[root] = groups.count();
+            groups.push_back();
+        }
+    }
+    for (int i : order) {
+        *groups[groupOfRoot[find_root(&parents, i)]].append() = i;
+    }
+
+    // Union each group in a balanced tree, so each Op() has operands of similar size, rather than
+    // one ever growing operand. Paths next to each other in the tree are near each other, which
+    // keeps the operands compact. All the merges of a level are independent.
+    for (SkTDArray<int>& group : groups) {
+        std::sort(group.begin(), group.end(), [&](int a, int b) {
+            const SkRect& ra = simple[a].getBounds();
+            const SkRect& rb = simple[b].getBounds();
+            return ra.centerY() < rb.centerY()
+                || (ra.centerY() == rb.centerY() && ra.centerX() < rb.centerX());
+        });
+    }
+    for (int step = 1; ; step *= 2) {
+        struct Merge {
+            int fInto;
+            int fFrom;
+        };
+        SkTDArray<Merge> merges;
+        for (const SkTDArray<int>& group : groups) {
+            for (int i = 0; i + step < group.count(); i += 2 * step) {
+                *merges.append() = { group[i], group[i + step] };
+            }
+        }
+        if (merges.isEmpty()) {
+            break;
+        }
+        run_all(executor, merges.count(), [&](int i) {
+            if (!merge(&simple[merges[i].fInto], simple[merges[i].fFrom])) {
+                failed = true;
+            }
+        });
+        if (failed) {
+            return false;
+        }
+    }
+
+    SkPath sum;
+    sum.setFillType(SkPath::kEvenOdd_FillType);
+    for (const SkTDArray<int>& group : groups) {
+        sum.addPath(simple[group[0]]);
+    }
+    *result = sum;
+    return true;
+}
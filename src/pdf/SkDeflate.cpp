@@ -10,10 +10,14 @@
 #include "SkDeflate.h"
 #include "SkMakeUnique.h"
 #include "SkMalloc.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
 #include "SkTraceEvent.h"
 
 #include "zlib.h"
 
+#include <atomic>
+
 namespace {
 
 // Different zlib implementations use different T.
@@ -54,32 +58,157 @@ static void do_deflate(int flush,
                  : returnValue == Z_OK);
 }
 
+static void init_deflate(z_stream* zStream, int compressionLevel, int windowBits) {
+    zStream->next_in = nullptr;
+    zStream->zalloc = &skia_alloc_func;
+    zStream->zfree = &skia_free_func;
+    zStream->opaque = nullptr;
+    SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
+    SkDEBUGCODE(int r =) deflateInit2(zStream, compressionLevel, Z_DEFLATED, windowBits,
+                                      8, Z_DEFAULT_STRATEGY);
+    SkASSERT(Z_OK == r);
+}
+
+constexpr size_t SkDeflateWStream::kParallelBlockSize;
+
+// The end of the previous block primes the compressor of a parallel block.  This is the size of
+// the deflate window, so the block can refer back as far as the serial compressor could.
+static constexpr size_t kDictionarySize = 32 * 1024;
+// With more blocks than this in flight, write() waits for them before buffering more input.
+static constexpr int kMaxPendingBlocks = 16;
+
+namespace {
+// A block of input that is compressed on the executor.  Blocks other than the last end with a
+// sync flush, so that their raw deflate data can be concatenated.
+struct DeflateBlock {
+    sk_sp<SkData> fInput;
+    size_t fInputSize;
+    sk_sp<SkData> fDictionary;  // The previous block's input, or null.
+    SkDynamicMemoryWStream fOutput;
+    std::atomic<bool> fDone{false};
+};
+}  // namespace
+
+static void deflate_block(DeflateBlock* block, int compressionLevel, bool last) {
+    z_stream zStream;
+    init_deflate(&zStream, compressionLevel, -0x0F);  // Raw deflate data.
+    if (block->fDictionary) {
+        size_t dictionarySize = SkTMin(block->fDictionary->size(), kDictionarySize);
+        const uint8_t* dictionary =
+                block->fDictionary->bytes() + block->fDictionary->size() - dictionarySize;
+        SkDEBUGCODE(int r =) deflateSetDictionary(&zStream, dictionary,
+                                                  SkToUInt(dictionarySize));
+        SkASSERT(Z_OK == r);
+    }
+    do_deflate(last ? Z_FINISH : Z_SYNC_FLUSH, &zStream, &block->fOutput,
+               const_cast<unsigned char*>(block->fInput->bytes()), block->fInputSize);
+    (void)deflateEnd(&zStream);
+    block->fDone.store(true, std::memory_order_release);
+}
+
+// The zlib header that deflateInit2() would write for this level (RFC 1950).
+static void write_zlib_header(SkWStream* out, int compressionLevel) {
+    int levelFlags = compressionLevel < 0 ? 2               // Z_DEFAULT_COMPRESSION is 6.
+                   : compressionLevel < 2 ? 0
+                   : compressionLevel < 6 ? 1
+                   : compressionLevel == 6 ? 2 : 3;
+    unsigned header = (0x78 << 8) | (levelFlags << 6);  // Deflate with a 32K window.
+    header += 31 - (header % 31);
+    out->write8(header >> 8);
+    out->write8(header & 0xFF);
+}
+
 // Hide all zlib impl details.
 struct SkDeflateWStream::Impl {
     SkWStream* fOut;
     unsigned char fInBuffer[SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE];
     size_t fInBufferIndex;
     z_stream fZStream;
+    int fCompressionLevel;
+
+    // In parallel mode input is collected in fBlock.  fZStream is only initialized if the input
+    // fits in one block, once the stream is finalized.
+    SkExecutor* fExecutor;
+    std::unique_ptr<SkTaskGroup> fTasks;
+    sk_sp<SkData> fBlock;
+    size_t fBlockIndex;
+    size_t fBlocksInputSize;  // The input of the blocks passed to the executor.
+    uLong fAdler;             // The checksum of that input.
+    SkTArray<std::unique_ptr<DeflateBlock>> fPendingBlocks;
+    sk_sp<SkData> fPreviousBlock;
+
+    void addBlock(bool last);
+    void writeDoneBlocks(bool wait);
 };
 
+// Passes fBlock to the executor and starts a new one.
+void SkDeflateWStream::Impl::addBlock(bool last) {
+    if (!fTasks) {
+        fTasks.reset(new SkTaskGroup(*fExecutor));
+        fAdler = adler32(0, nullptr, 0);
+        write_zlib_header(fOut, fCompressionLevel);
+    }
+    DeflateBlock* block = fPendingBlocks.emplace_back(new DeflateBlock).get();
+    block->fInput = std::move(fBlock);
+    block->fInputSize = fBlockIndex;
+    block->fDictionary = std::move(fPreviousBlock);
+    fAdler = adler32(fAdler, block->fInput->bytes(), SkToUInt(fBlockIndex));
+    fBlocksInputSize += fBlockIndex;
+    int compressionLevel = fCompressionLevel;
+    fTasks->add([block, compressionLevel, last]() {
+        deflate_block(block, compressionLevel, last);
+    });
+
+    fBlockIndex = 0;
+    if (!last) {
+        fPreviousBlock = block->fInput;
+        fBlock = SkData::MakeUninitialized(kParallelBlockSize);
+    }
+    this->writeDoneBlocks(fPendingBlocks.count() > kMaxPendingBlocks);
+}
+
+// Writes the compressed blocks that are done, in order.  If 'wait' is true, waits for all of them.
+void SkDeflateWStream::Impl::writeDoneBlocks(bool wait) {
+    if (wait) {
+        fTasks->wait();
+    }
+    int done = 0;
+    for (; done < fPendingBlocks.count(); ++done) {
+        DeflateBlock* block = fPendingBlocks[done].get();
+        if (!block->fDone.load(std::memory_order_acquire)) {
+            break;
+        }
+        block->fOutput.writeToAndReset(fOut);
+    }
+    if (done > 0) {
+        SkTArray<std::unique_ptr<DeflateBlock>> stillPending;
+        for (int i = done; i < fPendingBlocks.count(); ++i) {
+            stillPending.push_back(std::move(fPendingBlocks[i]));
+        }
+        fPendingBlocks.swap(&stillPending);
+    }
+}
+
 SkDeflateWStream::SkDeflateWStream(SkWStream* out,
                                    int compressionLevel,
-                                   bool gzip)
+                                   bool gzip,
+                                   SkExecutor* executor)
     : fImpl(skstd::make_unique<SkDeflateWStream::Impl>()) {
     fImpl->fOut = out;
     fImpl->fInBufferIndex = 0;
+    fImpl->fCompressionLevel = compressionLevel;
+    fImpl->fExecutor = nullptr;
+    fImpl->fBlockIndex = 0;
+    fImpl->fBlocksInputSize = 0;
     if (!fImpl->fOut) {
         return;
     }
-    fImpl->fZStream.next_in = nullptr;
-    fImpl->fZStream.zalloc = &skia_alloc_func;
-    fImpl->fZStream.zfree = &skia_free_func;
-    fImpl->fZStream.opaque = nullptr;
-    SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
-    SkDEBUGCODE(int r =) deflateInit2(&fImpl->fZStream, compressionLevel,
-                                      Z_DEFLATED, gzip ? 0x1F : 0x0F,
-                                      8, Z_DEFAULT_STRATEGY);
-    SkASSERT(Z_OK == r);
+    if (executor && !gzip) {
+        fImpl->fExecutor = executor;
+        fImpl->fBlock = SkData::MakeUninitialized(kParallelBlockSize);
+        return;
+    }
+    init_deflate(&fImpl->fZStream, compressionLevel, gzip ? 0x1F : 0x0F);
 }
 
 SkDeflateWStream::~SkDeflateWStream() { this->finalize(); }
@@ -89,8 +218,26 @@ void SkDeflateWStream::finalize() {
     if (!fImpl->fOut) {
         return;
     }
-    do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
-               fImpl->fInBufferIndex);
+    if (fImpl->fExecutor && fImpl->fTasks) {
+        fImpl->addBlock(true);
+        fImpl->writeDoneBlocks(true);
+        SkASSERT(fImpl->fPendingBlocks.empty());
+        uint8_t adler[4] = { (uint8_t)(fImpl->fAdler >> 24), (uint8_t)(fImpl->fAdler >> 16),
+                             (uint8_t)(fImpl->fAdler >>  8), (uint8_t)(fImpl->fAdler >>  0) };
+        fImpl->fOut->write(adler, sizeof(adler));
+        fImpl->fOut = nullptr;
+        return;
+    }
+    if (fImpl->fExecutor) {
+        // The input fits in one block, so compress it as if there were no executor.
+        init_deflate(&fImpl->fZStream, fImpl->fCompressionLevel, 0x0F);
+        do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut,
+                   static_cast<unsigned char*>(fImpl->fBlock->writable_data()),
+                   fImpl->fBlockIndex);
+    } else {
+        do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
+                   fImpl->fInBufferIndex);
+    }
     (void)deflateEnd(&fImpl->fZStream);
     fImpl->fOut = nullptr;
 }
@@ -101,6 +248,20 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
         return false;
     }
     const char* buffer = (const char*)void_buffer;
+    if (fImpl->fExecutor) {
+        while (len > 0) {
+            size_t tocopy = SkTMin(len, kParallelBlockSize - fImpl->fBlockIndex);
+            memcpy(static_cast<char*>(fImpl->fBlock->writable_data()) + fImpl->fBlockIndex,
+                   buffer, tocopy);
+            len -= tocopy;
+            buffer += tocopy;
+            fImpl->fBlockIndex += tocopy;
+            if (kParallelBlockSize == fImpl->fBlockIndex) {
+                fImpl->addBlock(false);
+            }
+        }
+        return true;
+    }
     while (len > 0) {
         size_t tocopy =
                 SkTMin(len, sizeof(fImpl->fInBuffer) - fImpl->fInBufferIndex);
@@ -121,5 +282,8 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 }
 
 size_t SkDeflateWStream::bytesWritten() const {
+    if (fImpl->fExecutor) {
+        return fImpl->fBlocksInputSize + fImpl->fBlockIndex;
+    }
     return fImpl->fZStream.total_in + fImpl->fInBufferIndex;
 }
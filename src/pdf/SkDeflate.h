@@ -11,6 +11,8 @@
 
 #include "SkStream.h"
 
+class SkExecutor;
+
 /**
   * Wrap a stream in this class to compress the information written to
   * this stream using the Deflate algorithm.
@@ -29,10 +31,18 @@ public:
         a wrapper, documented in RFC 1952, around a deflate stream."
         gzip adds a header with a magic number to the beginning of the
         stream, alowing a client to identify a gzip file.
+
+        @param executor if not null, and gzip is false, input longer
+        than kParallelBlockSize is split into blocks that are compressed
+        independently on the executor's threads, each using the end of
+        the previous block as its dictionary.  The blocks are joined into
+        one zlib stream, which is a little larger than the output without
+        an executor.
      */
     SkDeflateWStream(SkWStream*,
                      int compressionLevel = -1,
-                     bool gzip = false);
+                     bool gzip = false,
+                     SkExecutor* executor = nullptr);
 
     /** The destructor calls finalize(). */
     ~SkDeflateWStream() override;
@@ -45,6 +55,8 @@ public:
     bool write(const void*, size_t) override;
     size_t bytesWritten() const override;
 
+    static constexpr size_t kParallelBlockSize = 128 * 1024;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> fImpl;
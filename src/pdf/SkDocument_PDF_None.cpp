@@ -15,3 +15,7 @@ sk_sp<SkDocument> SkDocument::MakePDF(SkWStream* stream) {
     return nullptr;
 }
 
+
+sk_sp<SkDocument::PDFCache> SkDocument::PDFCache::Make(size_t byteLimit) {
+    return nullptr;
+}
@@ -11,8 +11,11 @@
 #include "SkData.h"
 #include "SkDeflate.h"
 #include "SkImage.h"
+#include "SkImage_Base.h"
 #include "SkJpegInfo.h"
 #include "SkPDFCanon.h"
+#include "SkPDFResourceDict.h"
+#include "SkPDFSharedCache.h"
 #include "SkPDFTypes.h"
 #include "SkPDFUtils.h"
 #include "SkStream.h"
@@ -275,11 +278,10 @@ static void bitmap_alpha_to_a8(const SkBitmap& bitmap, SkWStream* out) {
     }
 }
 
-static void emit_image_xobject(SkWStream* stream,
-                               const SkImage* image,
-                               bool alpha,
-                               const sk_sp<SkPDFObject>& smask,
-                               const SkPDFObjNumMap& objNumMap) {
+// Returns the compressed pixels (or alpha) of the image and, in fInfo, their component count.
+static SkPDFSharedCache::Entry compress_image_pixels(const SkImage* image,
+                                                     bool alpha,
+                                                     const SkPDFCompression& compression) {
     SkBitmap bitmap;
     if (!SkPDFUtils::ToBitmap(image, &bitmap)) {
         // no pixels or wrong size: fill with zeros.
@@ -288,21 +290,46 @@ static void emit_image_xobject(SkWStream* stream,
 
     // Write to a temporary buffer to get the compressed length.
     SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
+    SkDeflateWStream deflateWStream(&buffer, compression.fLevel, false, compression.fExecutor);
     if (alpha) {
         bitmap_alpha_to_a8(bitmap, &deflateWStream);
     } else {
         bitmap_to_pdf_pixels(bitmap, &deflateWStream);
     }
-    deflateWStream.finalize();  // call before buffer.bytesWritten().
+    deflateWStream.finalize();  // call before buffer.detachAsData().
+
+    SkPDFSharedCache::Entry pixels;
+    pixels.fData = buffer.detachAsData();
+    pixels.fInfo = alpha ? 1 : SkToU32(pdf_color_component_count(bitmap.colorType()));
+    return pixels;
+}
+
+static void emit_image_xobject(SkWStream* stream,
+                               const SkImage* image,
+                               bool alpha,
+                               const sk_sp<SkPDFObject>& smask,
+                               const SkPDFObjNumMap& objNumMap,
+                               const SkPDFCompression& compression,
+                               SkPDFSharedCache* cache,
+                               const SkBitmapKey& cacheKey) {
+    SkPDFSharedCache::Entry pixels;
+    if (cache) {
+        auto key = SkPDFSharedCache::Key::Image(alpha ? SkPDFSharedCache::Kind::kImageAlpha
+                                                      : SkPDFSharedCache::Kind::kImagePixels,
+                                                cacheKey, compression);
+        if (!cache->find(key, &pixels)) {
+            pixels = compress_image_pixels(image, alpha, compression);
+            cache->add(key, pixels);
+        }
+    } else {
+        pixels = compress_image_pixels(image, alpha, compression);
+    }
 
     SkPDFDict pdfDict("XObject");
     pdfDict.insertName("Subtype", "Image");
-    pdfDict.insertInt("Width", bitmap.width());
-    pdfDict.insertInt("Height", bitmap.height());
-    if (alpha) {
-        pdfDict.insertName("ColorSpace", "DeviceGray");
-    } else if (1 == pdf_color_component_count(bitmap.colorType())) {
+    pdfDict.insertInt("Width", image->width());
+    pdfDict.insertInt("Height", image->height());
+    if (1 == pixels.fInfo) {
         pdfDict.insertName("ColorSpace", "DeviceGray");
     } else {
         pdfDict.insertName("ColorSpace", "DeviceRGB");
@@ -312,11 +339,11 @@ static void emit_image_xobject(SkWStream* stream,
     }
     pdfDict.insertInt("BitsPerComponent", 8);
     pdfDict.insertName("Filter", "FlateDecode");
-    pdfDict.insertInt("Length", buffer.bytesWritten());
+    pdfDict.insertInt("Length", SkToInt(pixels.fData->size()));
     pdfDict.emitObject(stream, objNumMap);
 
     stream->writeText(kStreamBegin);
-    buffer.writeToAndReset(stream);
+    stream->write(pixels.fData->data(), pixels.fData->size());
     stream->writeText(kStreamEnd);
 }
 
@@ -326,16 +353,25 @@ namespace {
 // This SkPDFObject only outputs the alpha layer of the given bitmap.
 class PDFAlphaBitmap final : public SkPDFObject {
 public:
-    PDFAlphaBitmap(sk_sp<SkImage> image) : fImage(std::move(image)) { SkASSERT(fImage); }
+    PDFAlphaBitmap(sk_sp<SkImage> image, const SkPDFCompression& compression,
+                   SkPDFSharedCache* cache, const SkBitmapKey& cacheKey)
+        : fImage(std::move(image))
+        , fCompression(compression)
+        , fCache(cache)
+        , fCacheKey(cacheKey) { SkASSERT(fImage); }
     void emitObject(SkWStream*  stream,
                     const SkPDFObjNumMap& objNumMap) const override {
         SkASSERT(fImage);
-        emit_image_xobject(stream, fImage.get(), true, nullptr, objNumMap);
+        emit_image_xobject(stream, fImage.get(), true, nullptr, objNumMap, fCompression,
+                           fCache, fCacheKey);
     }
     void drop() override { fImage = nullptr; }
 
 private:
     sk_sp<SkImage> fImage;
+    const SkPDFCompression fCompression;
+    SkPDFSharedCache* const fCache;
+    const SkBitmapKey fCacheKey;
 };
 
 }  // namespace
@@ -348,18 +384,30 @@ public:
     void emitObject(SkWStream* stream,
                     const SkPDFObjNumMap& objNumMap) const override {
         SkASSERT(fImage);
-        emit_image_xobject(stream, fImage.get(), false, fSMask, objNumMap);
+        emit_image_xobject(stream, fImage.get(), false, fSMask, objNumMap, fCompression,
+                           fCache, fCacheKey);
     }
     void addResources(SkPDFObjNumMap* catalog) const override {
         catalog->addObjectRecursively(fSMask.get());
     }
     void drop() override { fImage = nullptr; fSMask = nullptr; }
-    PDFDefaultBitmap(sk_sp<SkImage> image, sk_sp<SkPDFObject> smask)
-        : fImage(std::move(image)), fSMask(std::move(smask)) { SkASSERT(fImage); }
+    PDFDefaultBitmap(sk_sp<SkImage> image, sk_sp<SkPDFObject> smask,
+                     const SkPDFCompression& compression,
+                     SkPDFSharedCache* cache, const SkBitmapKey& cacheKey)
+        : fImage(std::move(image))
+        , fSMask(std::move(smask))
+        , fCompression(compression)
+        , fCache(cache)
+        , fCacheKey(cacheKey) {
+        SkASSERT(fImage);
+    }
 
 private:
     sk_sp<SkImage> fImage;
     sk_sp<SkPDFObject> fSMask;
+    const SkPDFCompression fCompression;
+    SkPDFSharedCache* const fCache;
+    const SkBitmapKey fCacheKey;
 };
 }  // namespace
 
@@ -406,7 +454,51 @@ void PDFJpegBitmap::emitObject(SkWStream* stream,
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
-sk_sp<PDFJpegBitmap> make_jpeg_bitmap(sk_sp<SkData> data, SkISize size) {
+
+namespace {
+/**
+ *  This PDFObject embeds the image data of an 8 bit gray or RGB, non-interlaced PNG without
+ *  transparency. Its IDAT chunks form a zlib stream of rows that start with a PNG filter type
+ *  byte, which PDF decodes with FlateDecode and predictor 15.
+ */
+class PDFPngBitmap final : public SkPDFObject {
+public:
+    PDFPngBitmap(SkISize size, sk_sp<SkData> data, int components)
+        : fSize(size), fData(std::move(data)), fComponents(components) { SkASSERT(fData); }
+    void emitObject(SkWStream*, const SkPDFObjNumMap&) const override;
+    void drop() override { fData = nullptr; }
+
+private:
+    SkISize fSize;
+    sk_sp<SkData> fData;
+    int fComponents;
+};
+
+void PDFPngBitmap::emitObject(SkWStream* stream, const SkPDFObjNumMap& objNumMap) const {
+    SkASSERT(fData);
+    SkPDFDict pdfDict("XObject");
+    pdfDict.insertName("Subtype", "Image");
+    pdfDict.insertInt("Width", fSize.width());
+    pdfDict.insertInt("Height", fSize.height());
+    pdfDict.insertName("ColorSpace", 1 == fComponents ? "DeviceGray" : "DeviceRGB");
+    pdfDict.insertInt("BitsPerComponent", 8);
+    pdfDict.insertName("Filter", "FlateDecode");
+    auto decodeParms = sk_make_sp<SkPDFDict>();
+    decodeParms->insertInt("Predictor", 15);
+    decodeParms->insertInt("Colors", fComponents);
+    decodeParms->insertInt("BitsPerComponent", 8);
+    decodeParms->insertInt("Columns", fSize.width());
+    pdfDict.insertObject("DecodeParms", std::move(decodeParms));
+    pdfDict.insertInt("Length", SkToInt(fData->size()));
+    pdfDict.emitObject(stream, objNumMap);
+    stream->writeText(kStreamBegin);
+    stream->write(fData->data(), fData->size());
+    stream->writeText(kStreamEnd);
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+static sk_sp<PDFJpegBitmap> make_jpeg_bitmap(sk_sp<SkData> data, SkISize* size) {
     SkISize jpegSize;
     SkEncodedInfo::Color jpegColorType;
     SkEncodedOrigin exifOrientation;
@@ -414,43 +506,188 @@ sk_sp<PDFJpegBitmap> make_jpeg_bitmap(sk_sp<SkData> data, SkISize size) {
                               &jpegColorType, &exifOrientation)) {
         bool yuv = jpegColorType == SkEncodedInfo::kYUV_Color;
         bool goodColorType = yuv || jpegColorType == SkEncodedInfo::kGray_Color;
-        if (jpegSize == size  // Sanity check.
-                && goodColorType
-                && kTopLeft_SkEncodedOrigin == exifOrientation) {
+        if (goodColorType && kTopLeft_SkEncodedOrigin == exifOrientation) {
             // hold on to data, not image.
             #ifdef SK_PDF_IMAGE_STATS
             gJpegImageObjects.fetch_add(1);
             #endif
+            *size = jpegSize;
             return sk_make_sp<PDFJpegBitmap>(jpegSize, std::move(data), yuv);
         }
     }
     return nullptr;
 }
 
-sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage> image, int encodingQuality) {
+static uint32_t read_be32(const uint8_t* p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static sk_sp<PDFPngBitmap> make_png_bitmap(const SkData* data, SkISize* size) {
+    static const uint8_t kSignature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (!data || data->size() < sizeof(kSignature) ||
+        0 != memcmp(data->data(), kSignature, sizeof(kSignature))) {
+        return nullptr;
+    }
+    const uint8_t* ptr = data->bytes() + sizeof(kSignature);
+    const uint8_t* end = data->bytes() + data->size();
+    SkISize pngSize = SkISize::MakeEmpty();
+    int components = 0;
+    SkDynamicMemoryWStream imageData;
+    while (end - ptr >= 12) {
+        uint32_t length = read_be32(ptr);
+        const uint8_t* type = ptr + 4;
+        const uint8_t* chunk = ptr + 8;
+        if (length > (size_t)(end - chunk) - 4) {
+            return nullptr;
+        }
+        if (0 == memcmp(type, "IHDR", 4)) {
+            // Width, height, bit depth, color type, compression, filter and interlace method.
+            if (length != 13 || chunk[8] != 8 || chunk[10] != 0 || chunk[11] != 0 ||
+                chunk[12] != 0) {
+                return nullptr;
+            }
+            if (0 == chunk[9]) {
+                components = 1;
+            } else if (2 == chunk[9]) {
+                components = 3;
+            } else {
+                return nullptr;
+            }
+            uint32_t width = read_be32(chunk), height = read_be32(chunk + 4);
+            if (width - 1 >= SK_MaxS32 || height - 1 >= SK_MaxS32) {
+                return nullptr;
+            }
+            pngSize.set(width, height);
+        } else if (!components || 0 == memcmp(type, "tRNS", 4)) {
+            // IHDR must come first; transparency needs a soft mask.
+            return nullptr;
+        } else if (0 == memcmp(type, "IDAT", 4)) {
+            imageData.write(chunk, length);
+        } else if (0 == memcmp(type, "IEND", 4)) {
+            if (0 == imageData.bytesWritten()) {
+                return nullptr;
+            }
+            *size = pngSize;
+            return sk_make_sp<PDFPngBitmap>(pngSize, imageData.detachAsData(), components);
+        }
+        ptr = chunk + length + 4;  // Skip the CRC.
+    }
+    return nullptr;
+}
+
+// Returns an image XObject that embeds encoded data as is, if PDF can decode it, and sets 'size'
+// to the size of the encoded image.
+static sk_sp<SkPDFObject> make_pass_through_bitmap(sk_sp<SkData> data, SkISize* size) {
+    if (auto png = make_png_bitmap(data.get(), size)) {
+        return std::move(png);
+    }
+    return make_jpeg_bitmap(std::move(data), size);
+}
+
+// Whether the image is opaque, cached since it may require decoding the image.
+static bool compute_is_opaque(const SkImage* image, SkPDFSharedCache* cache,
+                              const SkBitmapKey& cacheKey) {
+    if (!cache || image->isOpaque()) {
+        return image_compute_is_opaque(image);
+    }
+    auto key = SkPDFSharedCache::Key::Image(SkPDFSharedCache::Kind::kImageOpacity, cacheKey,
+                                            SkPDFCompression());
+    SkPDFSharedCache::Entry opacity;
+    if (!cache->find(key, &opacity)) {
+        opacity.fInfo = image_compute_is_opaque(image);
+        cache->add(key, opacity);
+    }
+    return SkToBool(opacity.fInfo);
+}
+
+sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage> image, int encodingQuality,
+                                           const SkPDFCompression& compression,
+                                           SkPDFSharedCache* cache,
+                                           const SkBitmapKey& cacheKey) {
     SkASSERT(image);
     SkASSERT(encodingQuality >= 0);
     SkISize dimensions = image->dimensions();
+    SkISize encodedSize;
     sk_sp<SkData> data = image->refEncodedData();
-    if (auto jpeg = make_jpeg_bitmap(std::move(data), dimensions)) {
-        return std::move(jpeg);
+    auto passThrough = make_pass_through_bitmap(std::move(data), &encodedSize);
+    if (passThrough && encodedSize == dimensions) {  // Sanity check.
+        return passThrough;
     }
 
-    const bool isOpaque = image_compute_is_opaque(image.get());
+    const bool isOpaque = compute_is_opaque(image.get(), cache, cacheKey);
 
     if (encodingQuality <= 100 && isOpaque) {
         data = image->encodeToData(SkEncodedImageFormat::kJPEG, encodingQuality);
-        if (auto jpeg = make_jpeg_bitmap(std::move(data), dimensions)) {
+        auto jpeg = make_jpeg_bitmap(std::move(data), &encodedSize);
+        if (jpeg && encodedSize == dimensions) {
             return std::move(jpeg);
         }
     }
 
     sk_sp<SkPDFObject> smask;
     if (!isOpaque) {
-        smask = sk_make_sp<PDFAlphaBitmap>(image);
+        smask = sk_make_sp<PDFAlphaBitmap>(image, compression, cache, cacheKey);
     }
     #ifdef SK_PDF_IMAGE_STATS
     gRegularImageObjects.fetch_add(1);
     #endif
-    return sk_make_sp<PDFDefaultBitmap>(std::move(image), std::move(smask));
+    return sk_make_sp<PDFDefaultBitmap>(std::move(image), std::move(smask), compression,
+                                        cache, cacheKey);
+}
+
+// Returns a form XObject that draws 'subset' of an image XObject of the given size in the unit
+// square, the way an image XObject of just the subset would be drawn.
+static sk_sp<SkPDFObject> make_subset_form(sk_sp<SkPDFObject> image, SkISize size,
+                                           const SkIRect& subset) {
+    // Map the unit square of the whole image so that the subset covers the unit square. The
+    // top row of an image is at the top of its unit square.
+    SkScalar w = subset.width(), h = subset.height();
+    SkMatrix matrix = SkMatrix::MakeAll(size.width() / w, 0, -subset.x() / w,
+                                        0, size.height() / h, (subset.bottom() - size.height()) / h,
+                                        0, 0, 1);
+    SkDynamicMemoryWStream content;
+    SkPDFUtils::AppendTransform(matrix, &content);
+    SkPDFUtils::DrawFormXObject(0, &content);
+    SkTDArray<SkPDFObject*> xObjects;
+    xObjects.push(image.get());
+
+    auto form = sk_make_sp<SkPDFStream>(content.detachAsStream());
+    form->dict()->insertName("Type", "XObject");
+    form->dict()->insertName("Subtype", "Form");
+    form->dict()->insertObject("BBox", SkPDFUtils::RectToArray(SkRect::MakeWH(1, 1)));
+    form->dict()->insertObject("Resources",
+                               SkPDFResourceDict::Make(nullptr, nullptr, &xObjects, nullptr));
+    return std::move(form);
+}
+
+sk_sp<SkPDFObject> SkPDFCreateEncodedImageObject(const SkImage* image, SkPDFCanon* canon) {
+    SkASSERT(image);
+    sk_sp<SkData> data = image->refEncodedData();
+    if (!data) {
+        return nullptr;
+    }
+    SkPDFCanon::EncodedImage* encoded = canon->fEncodedImageMap.find(data.get());
+    if (!encoded) {
+        SkPDFCanon::EncodedImage entry;
+        entry.fObject = make_pass_through_bitmap(data, &entry.fSize);
+        entry.fData = std::move(data);
+        entry.fUsed = false;
+        encoded = canon->fEncodedImageMap.set(entry.fData.get(), std::move(entry));
+    }
+    SkIRect subset = as_IB(image)->onEncodedSubset();
+    SkIRect bounds = SkIRect::MakeSize(encoded->fSize);
+    if (!encoded->fObject || subset.isEmpty() || !bounds.contains(subset)) {
+        return nullptr;
+    }
+    if (subset == bounds) {
+        encoded->fUsed = true;
+        return encoded->fObject;
+    }
+    // Don't embed a large image for a small part of it.
+    if (!encoded->fUsed && 4 * (int64_t)subset.width() * subset.height() <
+                           (int64_t)bounds.width() * bounds.height()) {
+        return nullptr;
+    }
+    encoded->fUsed = true;
+    return make_subset_form(encoded->fObject, encoded->fSize, subset);
 }
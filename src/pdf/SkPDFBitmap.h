@@ -7,10 +7,12 @@
 #ifndef SkPDFBitmap_DEFINED
 #define SkPDFBitmap_DEFINED
 
-#include "SkRefCnt.h"
+#include "SkBitmapKey.h"
+#include "SkPDFTypes.h"
 
 class SkImage;
-class SkPDFObject;
+class SkPDFCanon;
+class SkPDFSharedCache;
 
 /**
  * SkPDFBitmap wraps a SkImage and serializes it as an image Xobject.
@@ -18,7 +20,22 @@ class SkPDFObject;
  * the image, and its emitObject() does not cache any data.
  *
  *  quality > 100 means lossless
+ *
+ *  If a shared cache is given, the image's opacity and compressed pixels are found in or added
+ *  to it under the image's SkBitmapKey.
+ */
+sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage>, int encodingQuality = 101,
+                                           const SkPDFCompression& = SkPDFCompression(),
+                                           SkPDFSharedCache* = nullptr,
+                                           const SkBitmapKey& = SkBitmapKey{{0, 0, 0, 0}, 0});
+
+/**
+ *  If the image's encoded data is a JPEG or PNG that PDF can decode, returns an object that
+ *  embeds the data without decoding it, or null otherwise. Subsets of lazy images (see
+ *  SkImage::makeSubset()) are drawn with a form XObject that clips the whole encoded image,
+ *  which is embedded once per document; this is only done if the subset covers a large part
+ *  of the image, or the image is embedded already.
  */
-sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage>, int encodingQuality = 101);
+sk_sp<SkPDFObject> SkPDFCreateEncodedImageObject(const SkImage*, SkPDFCanon*);
 
 #endif  // SkPDFBitmap_DEFINED
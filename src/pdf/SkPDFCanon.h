@@ -19,6 +19,7 @@
 #include "SkString.h"
 
 class SkPDFFont;
+class SkPDFSharedCache;
 struct SkAdvancedTypefaceMetrics;
 
 /**
@@ -40,6 +41,16 @@ public:
 
     SkTHashMap<SkBitmapKey, sk_sp<SkPDFObject>> fPDFBitmapMap;
 
+    // Encoded images that are embedded as is, keyed by their data. fObject is null if PDF
+    // can't decode the data.
+    struct EncodedImage {
+        sk_sp<SkData> fData;
+        sk_sp<SkPDFObject> fObject;
+        SkISize fSize;
+        bool fUsed;
+    };
+    SkTHashMap<const SkData*, EncodedImage> fEncodedImageMap;
+
     SkTHashMap<uint32_t, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics;
     SkTHashMap<uint32_t, std::vector<SkString>> fType1GlyphNames;
     SkTHashMap<uint32_t, sk_sp<SkPDFDict>> fFontDescriptors;
@@ -67,6 +78,9 @@ public:
         SkIPoint fOffset;
     };
     SkTHashMap<BitmapGlyphKey, BitmapGlyph> fBitmapGlyphImages;
+
+    // Owned by the document's metadata; null unless PDFMetadata::fCache is set.
+    SkPDFSharedCache* fSharedCache = nullptr;
 };
 
 inline bool operator==(const SkPDFCanon::BitmapGlyphKey& u, const SkPDFCanon::BitmapGlyphKey& v) {
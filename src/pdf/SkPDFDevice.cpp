@@ -1057,10 +1057,8 @@ static SkUnichar map_glyph(const SkTDArray<SkUnichar>& glyphToUnicode, SkGlyphID
 }
 
 static void update_font(SkWStream* wStream, int fontIndex, SkScalar textSize) {
-    wStream->writeText("/");
-    char prefix = SkPDFResourceDict::GetResourceTypePrefix(SkPDFResourceDict::kFont_ResourceType);
-    wStream->write(&prefix, 1);
-    wStream->writeDecAsText(fontIndex);
+    SkPDFResourceDict::WriteResourceName(wStream, SkPDFResourceDict::kFont_ResourceType,
+                                         fontIndex);
     wStream->writeText(" ");
     SkPDFUtils::AppendScalar(textSize, wStream);
     wStream->writeText(" Tf\n");
@@ -1646,7 +1644,8 @@ sk_sp<SkPDFObject> SkPDFDevice::makeFormXObjectFromDevice(bool alpha) {
     const char* colorSpace = alpha ? "DeviceGray" : nullptr;
     sk_sp<SkPDFObject> xobject =
         SkPDFMakeFormXObject(this->content(), this->copyMediaBox(),
-                             this->makeResourceDict(), inverseTransform, colorSpace);
+                             this->makeResourceDict(), inverseTransform, colorSpace,
+                             fDocument->compression());
     // We always draw the form xobjects that we create back into the device, so
     // we simply preserve the font usage instead of pulling it out and merging
     // it back in later.
@@ -2263,8 +2262,13 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
     sk_sp<SkPDFObject> pdfimage = pdfimagePtr ? *pdfimagePtr : nullptr;
     if (!pdfimage) {
         SkASSERT(imageSubset);
-        pdfimage = SkPDFCreateBitmapObject(imageSubset.release(),
-                                           fDocument->metadata().fEncodingQuality);
+        pdfimage = SkPDFCreateEncodedImageObject(imageSubset.image().get(), fDocument->canon());
+        if (!pdfimage) {
+            pdfimage = SkPDFCreateBitmapObject(imageSubset.release(),
+                                               fDocument->metadata().fEncodingQuality,
+                                               fDocument->compression(),
+                                               fDocument->canon()->fSharedCache, key);
+        }
         if (!pdfimage) {
             return;
         }
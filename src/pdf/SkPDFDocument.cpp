@@ -11,12 +11,24 @@
 #include "SkMakeUnique.h"
 #include "SkPDFCanon.h"
 #include "SkPDFDevice.h"
+#include "SkPDFSharedCache.h"
 #include "SkPDFUtils.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 
-SkPDFObjectSerializer::SkPDFObjectSerializer() : fBaseOffset(0), fNextToBeSerialized(0) {}
+#include <atomic>
+
+struct SkPDFObjectSerializer::EmittedObject {
+    SkDynamicMemoryWStream fBytes;
+    std::atomic<bool> fDone{false};
+    bool fDeferred = false;
+};
+
+SkPDFObjectSerializer::SkPDFObjectSerializer()
+    : fBaseOffset(0), fNextToBeSerialized(0), fNextToBeEmitted(0) {}
 
 SkPDFObjectSerializer::~SkPDFObjectSerializer() {
+    this->waitForEmittedObjects();
     for (int i = 0; i < fObjNumMap.objects().count(); ++i) {
         fObjNumMap.objects()[i]->drop();
     }
@@ -24,11 +36,30 @@ SkPDFObjectSerializer::~SkPDFObjectSerializer() {
 SkPDFObjectSerializer::SkPDFObjectSerializer(SkPDFObjectSerializer&&) = default;
 SkPDFObjectSerializer& SkPDFObjectSerializer::operator=(SkPDFObjectSerializer&&) = default;
 
+void SkPDFObjectSerializer::setExecutor(SkExecutor* executor) {
+    SkASSERT(!fEmitTasks);
+    fExecutor = executor;
+    if (executor) {
+        fObjNumMap.makeThreadSafe();
+        fEmitTasks.reset(new SkTaskGroup(*executor));
+    }
+}
+
+void SkPDFObjectSerializer::waitForEmittedObjects() {
+    if (fEmitTasks) {
+        fEmitTasks->wait();
+    }
+}
+
 
 void SkPDFObjectSerializer::addObjectRecursively(const sk_sp<SkPDFObject>& object) {
     fObjNumMap.addObjectRecursively(object.get());
 }
 
+void SkPDFObjectSerializer::deferObject(const SkPDFObject* object) {
+    fDeferred.add(object);
+}
+
 #define SKPDF_MAGIC "\xD3\xEB\xE9\xE1"
 #ifndef SK_BUILD_FOR_WIN
 static_assert((SKPDF_MAGIC[0] & 0x7F) == "Skia"[0], "");
@@ -53,8 +84,34 @@ void SkPDFObjectSerializer::serializeHeader(SkWStream* wStream,
 // Serialize all objects in the fObjNumMap that have not yet been serialized;
 void SkPDFObjectSerializer::serializeObjects(SkWStream* wStream) {
     const SkTArray<sk_sp<SkPDFObject>>& objects = fObjNumMap.objects();
+    if (fExecutor) {
+        // The objects only read each other's object numbers while they are emitted, so they can
+        // be emitted in any order. They are written in order by writeEmittedObjects().
+        const SkPDFObjNumMap* objNumMap = &fObjNumMap;
+        for (; fNextToBeEmitted < objects.count(); ++fNextToBeEmitted) {
+            SkPDFObject* object = objects[fNextToBeEmitted].get();
+            EmittedObject* emitted = fEmitted.emplace_back(new EmittedObject).get();
+            if (fDeferred.contains(object)) {
+                emitted->fDeferred = true;
+                emitted->fDone.store(true, std::memory_order_relaxed);
+                continue;
+            }
+            fEmitTasks->add([object, emitted, objNumMap]() {
+                object->emitObject(&emitted->fBytes, *objNumMap);
+                emitted->fDone.store(true, std::memory_order_release);
+            });
+        }
+        this->writeEmittedObjects(wStream, false);
+        return;
+    }
     while (fNextToBeSerialized < objects.count()) {
         SkPDFObject* object = objects[fNextToBeSerialized].get();
+        if (fDeferred.contains(object)) {
+            fOffsets.push(0);  // Set by serializeDeferredObjects().
+            fDeferredIndices.push_back(fNextToBeSerialized);
+            ++fNextToBeSerialized;
+            continue;
+        }
         int32_t index = fNextToBeSerialized + 1;  // Skip object 0.
         // "The first entry in the [XREF] table (object number 0) is
         // always free and has a generation number of 65,535; it is
@@ -70,11 +127,66 @@ void SkPDFObjectSerializer::serializeObjects(SkWStream* wStream) {
     }
 }
 
+// Write the objects emitted on the executor, in order, up to the first one that is not done.
+// If 'wait' is true, wait for all of them.
+void SkPDFObjectSerializer::writeEmittedObjects(SkWStream* wStream, bool wait) {
+    if (wait) {
+        this->waitForEmittedObjects();
+    }
+    const SkTArray<sk_sp<SkPDFObject>>& objects = fObjNumMap.objects();
+    while (fNextToBeSerialized < fNextToBeEmitted) {
+        std::unique_ptr<EmittedObject>& emitted = fEmitted[fNextToBeSerialized];
+        if (!emitted->fDone.load(std::memory_order_acquire)) {
+            break;
+        }
+        if (emitted->fDeferred) {
+            fOffsets.push(0);  // Set by serializeDeferredObjects().
+            fDeferredIndices.push_back(fNextToBeSerialized);
+            emitted.reset();
+            ++fNextToBeSerialized;
+            continue;
+        }
+        int32_t index = fNextToBeSerialized + 1;  // Skip object 0.
+        SkASSERT(fOffsets.count() == fNextToBeSerialized);
+        fOffsets.push(this->offset(wStream));
+        wStream->writeDecAsText(index);
+        wStream->writeText(" 0 obj\n");  // Generation number is always 0.
+        emitted->fBytes.writeToAndReset(wStream);
+        wStream->writeText("\nendobj\n");
+        objects[fNextToBeSerialized]->drop();
+        emitted.reset();
+        ++fNextToBeSerialized;
+    }
+}
+
+void SkPDFObjectSerializer::serializeDeferredObjects(SkWStream* wStream) {
+    this->serializeObjects(wStream);
+    this->writeEmittedObjects(wStream, true);
+    const SkTArray<sk_sp<SkPDFObject>>& objects = fObjNumMap.objects();
+    // Serializing a deferred object may number more of them.
+    for (int i = 0; i < fDeferredIndices.count(); ++i) {
+        int32_t index = fDeferredIndices[i];
+        SkPDFObject* object = objects[index].get();
+        // The object was empty when it was numbered, so number what it refers to now.
+        object->addResources(&fObjNumMap);
+        fOffsets[index] = this->offset(wStream);
+        wStream->writeDecAsText(index + 1);
+        wStream->writeText(" 0 obj\n");  // Generation number is always 0.
+        object->emitObject(wStream, fObjNumMap);
+        wStream->writeText("\nendobj\n");
+        object->drop();
+        this->serializeObjects(wStream);
+        this->writeEmittedObjects(wStream, true);
+    }
+    fDeferredIndices.reset();
+}
+
 // Xref table and footer
 void SkPDFObjectSerializer::serializeFooter(SkWStream* wStream,
                                             const sk_sp<SkPDFObject> docCatalog,
                                             sk_sp<SkPDFObject> id) {
     this->serializeObjects(wStream);
+    this->writeEmittedObjects(wStream, true);
     int32_t xRefFileOffset = this->offset(wStream);
     // Include the special zeroth object in the count.
     int32_t objCount = SkToS32(fOffsets.count() + 1);
@@ -176,6 +288,8 @@ SkPDFDocument::SkPDFDocument(SkWStream* stream,
                              const SkDocument::PDFMetadata& metadata)
     : SkDocument(stream)
     , fMetadata(metadata) {
+    fObjectSerializer.setExecutor(fMetadata.fExecutor);
+    fCanon.fSharedCache = static_cast<SkPDFSharedCache*>(fMetadata.fCache.get());
 }
 
 SkPDFDocument::~SkPDFDocument() {
@@ -183,17 +297,52 @@ SkPDFDocument::~SkPDFDocument() {
     this->close();
 }
 
+SkPDFCompression SkPDFDocument::compression() const {
+    SkPDFCompression compression;
+    compression.fLevel = fMetadata.fCompressionLevel;
+    if (fMetadata.fParallelCompression) {
+        compression.fExecutor = fMetadata.fExecutor;
+    }
+    return compression;
+}
+
 void SkPDFDocument::serialize(const sk_sp<SkPDFObject>& object) {
     fObjectSerializer.addObjectRecursively(object);
     fObjectSerializer.serializeObjects(this->getStream());
 }
 
+namespace {
+// A page's content stream that is compressed when it is emitted rather than when it is made, so
+// that with an executor the compression happens on the executor's threads. It emits the same
+// bytes as an SkPDFStream of the same content.
+class PDFDeferredStream final : public SkPDFObject {
+public:
+    PDFDeferredStream(std::unique_ptr<SkStreamAsset> content, const SkPDFCompression& compression)
+        : fContent(std::move(content)), fCompression(compression) {}
+    void emitObject(SkWStream* stream, const SkPDFObjNumMap& objNumMap) const override {
+        SkASSERT(fContent);
+        SkPDFStream(std::unique_ptr<SkStreamAsset>(fContent->duplicate()), fCompression)
+                .emitObject(stream, objNumMap);
+    }
+    void drop() override { fContent = nullptr; }
+
+private:
+    std::unique_ptr<SkStreamAsset> fContent;
+    const SkPDFCompression fCompression;
+};
+}  // namespace
+
 SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
     SkASSERT(!fCanvas.get());  // endPage() was called before this.
-    if (fPages.empty()) {
+    if (0 == fPageCount) {
         // if this is the first page if the document.
         fObjectSerializer.serializeHeader(this->getStream(), fMetadata);
         fDests = sk_make_sp<SkPDFDict>();
+        if (fMetadata.fStreaming) {
+            fPageTreeRoot = sk_make_sp<SkPDFDict>("Pages");
+            fPageTreeKids = sk_make_sp<SkPDFArray>();
+            fObjectSerializer.deferObject(fPageTreeRoot.get());
+        }
         if (fMetadata.fPDFA) {
             SkPDFMetadata::UUID uuid = SkPDFMetadata::CreateUUID(fMetadata);
             // We use the same UUID for Document ID and Instance ID since this
@@ -228,14 +377,37 @@ void SkPDFDocument::onEndPage() {
     if (annotations->size() > 0) {
         page->insertObject("Annots", std::move(annotations));
     }
-    auto contentObject = sk_make_sp<SkPDFStream>(fPageDevice->content());
+    sk_sp<SkPDFObject> contentObject;
+    if (fMetadata.fExecutor) {
+        contentObject = sk_make_sp<PDFDeferredStream>(fPageDevice->content(),
+                                                      this->compression());
+    } else {
+        contentObject = sk_make_sp<SkPDFStream>(fPageDevice->content(), this->compression());
+    }
     this->serialize(contentObject);
     page->insertObjRef("Contents", std::move(contentObject));
     fPageDevice->appendDestinations(fDests.get(), page.get());
-    fPages.emplace_back(std::move(page));
+    if (fPageTreeRoot) {
+        // Write the page and its resources now; only the objects shared with later pages
+        // stay alive, as the canon holds them.
+        page->insertObjRef("Parent", fPageTreeRoot);
+        fPageTreeKids->appendObjRef(page);
+        this->serialize(page);
+    } else {
+        fPages.emplace_back(std::move(page));
+    }
+    ++fPageCount;
     fPageDevice.reset(nullptr);
 }
 
+void SkPDFDocument::registerFont(SkPDFFont* font) {
+    if (fMetadata.fStreaming && !fFonts.contains(font)) {
+        // Fonts are subset once every page is known.
+        fObjectSerializer.deferObject(font);
+    }
+    fFonts.add(font);
+}
+
 void SkPDFDocument::onAbort() {
     this->reset();
 }
@@ -243,8 +415,15 @@ void SkPDFDocument::onAbort() {
 void SkPDFDocument::reset() {
     fCanvas.reset(nullptr);
     fPages.reset();
+    fPageCount = 0;
+    fPageTreeRoot = nullptr;
+    fPageTreeKids = nullptr;
     fCanon = SkPDFCanon();
+    fCanon.fSharedCache = static_cast<SkPDFSharedCache*>(fMetadata.fCache.get());
+    // Objects may still be emitted on the executor if the document was aborted.
+    fObjectSerializer.waitForEmittedObjects();
     fObjectSerializer = SkPDFObjectSerializer();
+    fObjectSerializer.setExecutor(fMetadata.fExecutor);
     fFonts.reset();
 }
 
@@ -393,7 +572,7 @@ static sk_sp<SkPDFArray> make_srgb_output_intents() {
 
 void SkPDFDocument::onClose(SkWStream* stream) {
     SkASSERT(!fCanvas.get());
-    if (fPages.empty()) {
+    if (0 == fPageCount) {
         this->reset();
         return;
     }
@@ -405,9 +584,15 @@ void SkPDFDocument::onClose(SkWStream* stream) {
         // no one has ever asked for this feature.
         docCatalog->insertObject("OutputIntents", make_srgb_output_intents());
     }
-    SkASSERT(!fPages.empty());
-    docCatalog->insertObjRef("Pages", generate_page_tree(&fPages));
-    SkASSERT(fPages.empty());
+    if (fPageTreeRoot) {
+        fPageTreeRoot->insertInt("Count", fPageCount);
+        fPageTreeRoot->insertObject("Kids", std::move(fPageTreeKids));
+        docCatalog->insertObjRef("Pages", fPageTreeRoot);
+    } else {
+        SkASSERT(!fPages.empty());
+        docCatalog->insertObjRef("Pages", generate_page_tree(&fPages));
+        SkASSERT(fPages.empty());
+    }
 
     if (fDests->size() > 0) {
         docCatalog->insertObjRef("Dests", std::move(fDests));
@@ -415,9 +600,22 @@ void SkPDFDocument::onClose(SkWStream* stream) {
 
     // Build font subsetting info before calling addObjectRecursively().
     SkPDFCanon* canon = &fCanon;
-    fFonts.foreach([canon](SkPDFFont* p){ p->getFontSubset(canon); });
+    if (fMetadata.fExecutor) {
+        // Subsetting only reads the typeface metrics in the canon, which were cached when the
+        // fonts were made, so the fonts can be subset in parallel.
+        SkTArray<SkPDFFont*> fonts;
+        fFonts.foreach([&fonts](SkPDFFont* p){ fonts.push_back(p); });
+        SkTaskGroup subsetTasks(*fMetadata.fExecutor);
+        subsetTasks.batch(fonts.count(), [&fonts, canon](int i) {
+            fonts[i]->getFontSubset(canon);
+        });
+        subsetTasks.wait();
+    } else {
+        fFonts.foreach([canon](SkPDFFont* p){ p->getFontSubset(canon); });
+    }
     fObjectSerializer.addObjectRecursively(docCatalog);
     fObjectSerializer.serializeObjects(this->getStream());
+    fObjectSerializer.serializeDeferredObjects(this->getStream());
     fObjectSerializer.serializeFooter(this->getStream(), docCatalog, fID);
     this->reset();
 }
@@ -433,6 +631,7 @@ sk_sp<SkDocument> SkPDFMakeDocument(SkWStream* stream,
     if (meta.fEncodingQuality < 0) {
         meta.fEncodingQuality = 0;
     }
+    meta.fCompressionLevel = SkTPin(meta.fCompressionLevel, -1, 9);
     return stream ? sk_make_sp<SkPDFDocument>(stream, meta) : nullptr;
 }
 
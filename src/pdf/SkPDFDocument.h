@@ -12,7 +12,9 @@
 #include "SkPDFMetadata.h"
 #include "SkPDFFont.h"
 
+class SkExecutor;
 class SkPDFDevice;
+class SkTaskGroup;
 
 /*  @param rasterDpi the DPI at which features without native PDF
  *         support will be rasterized (e.g. draw image with
@@ -30,22 +32,41 @@ sk_sp<SkDocument> SkPDFMakeDocument(SkWStream* stream,
 // Logically part of SkPDFDocument (like SkPDFCanon), but separate to
 // keep similar functionality together.
 struct SkPDFObjectSerializer : SkNoncopyable {
+    struct EmittedObject;
+
     SkPDFObjNumMap fObjNumMap;
     SkTDArray<int32_t> fOffsets;
     sk_sp<SkPDFObject> fInfoDict;
     size_t fBaseOffset;
     int32_t fNextToBeSerialized;  // index in fObjNumMap
+    // With an executor, objects are emitted on its threads into fEmitted, and written in order
+    // once they are done.
+    SkExecutor* fExecutor = nullptr;
+    std::unique_ptr<SkTaskGroup> fEmitTasks;
+    SkTArray<std::unique_ptr<EmittedObject>> fEmitted;  // index in fObjNumMap
+    int32_t fNextToBeEmitted;  // index in fObjNumMap
+    // Objects that are numbered when they are first referenced, but only serialized by
+    // serializeDeferredObjects(). Their offsets are set once they are written.
+    SkTHashSet<const SkPDFObject*> fDeferred;
+    SkTArray<int32_t> fDeferredIndices;  // index in fObjNumMap
 
     SkPDFObjectSerializer();
     ~SkPDFObjectSerializer();
     SkPDFObjectSerializer(SkPDFObjectSerializer&&);
     SkPDFObjectSerializer& operator=(SkPDFObjectSerializer&&);
 
+    void setExecutor(SkExecutor*);
     void addObjectRecursively(const sk_sp<SkPDFObject>&);
     void serializeHeader(SkWStream*, const SkDocument::PDFMetadata&);
     void serializeObjects(SkWStream*);
+    void writeEmittedObjects(SkWStream*, bool wait);
+    void deferObject(const SkPDFObject*);
+    // Serializes the deferred objects that have been numbered, and the objects they refer to.
+    void serializeDeferredObjects(SkWStream*);
     void serializeFooter(SkWStream*, const sk_sp<SkPDFObject>, sk_sp<SkPDFObject>);
     int32_t offset(SkWStream*);
+    // Blocks until the objects being emitted on the executor are done.
+    void waitForEmittedObjects();
 };
 
 /** Concrete implementation of SkDocument that creates PDF files. This
@@ -73,13 +94,18 @@ public:
     void serialize(const sk_sp<SkPDFObject>&);
     SkPDFCanon* canon() { return &fCanon; }
     SkScalar rasterDpi() const { return fMetadata.fRasterDPI; }
-    void registerFont(SkPDFFont* f) { fFonts.add(f); }
+    void registerFont(SkPDFFont*);
     const PDFMetadata& metadata() const { return fMetadata; }
+    SkPDFCompression compression() const;
 
 private:
     SkPDFObjectSerializer fObjectSerializer;
     SkPDFCanon fCanon;
     SkTArray<sk_sp<SkPDFDict>> fPages;
+    int fPageCount = 0;
+    // The page tree in streaming mode. The root is deferred until all its kids are known.
+    sk_sp<SkPDFDict> fPageTreeRoot;
+    sk_sp<SkPDFArray> fPageTreeKids;
     SkTHashSet<SkPDFFont*> fFonts;
     sk_sp<SkPDFDict> fDests;
     sk_sp<SkPDFDevice> fPageDevice;
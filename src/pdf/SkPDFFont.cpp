@@ -14,6 +14,7 @@
 #include "SkPDFFont.h"
 #include "SkPDFMakeCIDGlyphWidthsArray.h"
 #include "SkPDFMakeToUnicodeCmap.h"
+#include "SkPDFSharedCache.h"
 #include "SkPDFUtils.h"
 #include "SkPaint.h"
 #include "SkRefCnt.h"
@@ -326,7 +327,7 @@ static sk_sp<SkData> stream_to_data(std::unique_ptr<SkStreamAsset> stream) {
     return SkData::MakeFromStream(stream.get(), size);
 }
 
-static sk_sp<SkPDFStream> get_subset_font_stream(
+static sk_sp<SkData> subset_font_data(
         std::unique_ptr<SkStreamAsset> fontAsset,
         const SkBitSet& glyphUsage,
         const char* fontName,
@@ -366,16 +367,96 @@ static sk_sp<SkPDFStream> get_subset_font_stream(
         return nullptr;
     }
     SkASSERT(subsetFont != nullptr);
-    auto subsetStream = sk_make_sp<SkPDFStream>(
-            SkData::MakeWithProc(
-                    subsetFont, subsetFontSize,
-                    [](const void* p, void*) { delete[] (unsigned char*)p; },
-                    nullptr));
+    return SkData::MakeWithProc(subsetFont, subsetFontSize,
+                                [](const void* p, void*) { delete[] (unsigned char*)p; },
+                                nullptr);
+}
+
+static sk_sp<SkPDFStream> get_subset_font_stream(
+        std::unique_ptr<SkStreamAsset> fontAsset,
+        const SkBitSet& glyphUsage,
+        const char* fontName,
+        int ttcIndex,
+        SkFontID fontID,
+        SkPDFSharedCache* cache) {
+    sk_sp<SkData> subsetData;
+    if (cache) {
+        auto key = SkPDFSharedCache::Key::Font(SkPDFSharedCache::Kind::kFontSubset,
+                                               fontID, glyphUsage);
+        SkPDFSharedCache::Entry entry;
+        if (cache->find(key, &entry)) {
+            subsetData = std::move(entry.fData);
+        } else {
+            subsetData = subset_font_data(std::move(fontAsset), glyphUsage, fontName, ttcIndex);
+            if (subsetData) {
+                entry.fData = subsetData;
+                cache->add(key, std::move(entry));
+            }
+        }
+    } else {
+        subsetData = subset_font_data(std::move(fontAsset), glyphUsage, fontName, ttcIndex);
+    }
+    if (!subsetData) {
+        return nullptr;
+    }
+    size_t subsetFontSize = subsetData->size();
+    auto subsetStream = sk_make_sp<SkPDFStream>(std::move(subsetData));
     subsetStream->dict()->insertInt("Length1", subsetFontSize);
     return subsetStream;
 }
 #endif  // SK_PDF_USE_SFNTLY
 
+namespace {
+// A direct object that was serialized earlier, possibly by another document.
+class SkPDFSerializedObject final : public SkPDFObject {
+public:
+    explicit SkPDFSerializedObject(sk_sp<SkData> data) : fData(std::move(data)) {}
+    void emitObject(SkWStream* stream, const SkPDFObjNumMap&) const override {
+        stream->write(fData->data(), fData->size());
+    }
+
+private:
+    sk_sp<SkData> fData;
+};
+}  // namespace
+
+// Returns the /W array of the font, or null if it is empty. The array only holds numbers, so
+// the shared cache keeps it serialized, with the em size and default width in the entry's info.
+static sk_sp<SkPDFObject> make_glyph_widths(SkTypeface* face,
+                                            const SkBitSet& glyphUsage,
+                                            SkPDFSharedCache* cache,
+                                            int* emSize,
+                                            int16_t* defaultWidth) {
+    *defaultWidth = 0;
+    if (!cache) {
+        auto glyphCache = SkPDFFont::MakeVectorCache(face, emSize);
+        sk_sp<SkPDFArray> widths = SkPDFMakeCIDGlyphWidthsArray(
+                glyphCache.get(), &glyphUsage, SkToS16(*emSize), defaultWidth);
+        return widths && widths->size() > 0 ? std::move(widths) : nullptr;
+    }
+    auto key = SkPDFSharedCache::Key::Font(SkPDFSharedCache::Kind::kGlyphWidths,
+                                           face->uniqueID(), glyphUsage);
+    SkPDFSharedCache::Entry entry;
+    if (!cache->find(key, &entry)) {
+        auto glyphCache = SkPDFFont::MakeVectorCache(face, emSize);
+        sk_sp<SkPDFArray> widths = SkPDFMakeCIDGlyphWidthsArray(
+                glyphCache.get(), &glyphUsage, SkToS16(*emSize), defaultWidth);
+        SkDynamicMemoryWStream serialized;
+        if (widths && widths->size() > 0) {
+            widths->emitObject(&serialized, SkPDFObjNumMap());
+        }
+        entry.fData = serialized.detachAsData();
+        entry.fInfo = (uint32_t)*emSize << 16 | (uint16_t)*defaultWidth;
+        cache->add(key, entry);
+    }
+    *emSize = entry.fInfo >> 16;
+    *defaultWidth = (int16_t)(entry.fInfo & 0xFFFF);
+    if (entry.fData->isEmpty()) {
+        return nullptr;
+    }
+    return sk_make_sp<SkPDFSerializedObject>(std::move(entry.fData));
+}
+
 void SkPDFType0Font::getFontSubset(SkPDFCanon* canon) {
     const SkAdvancedTypefaceMetrics* metricsPtr =
         SkPDFFont::GetMetrics(this->typeface(), canon);
@@ -406,7 +487,8 @@ void SkPDFType0Font::getFontSubset(SkPDFCanon* canon) {
                               SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
                     sk_sp<SkPDFStream> subsetStream = get_subset_font_stream(
                             std::move(fontAsset), this->glyphUsage(),
-                            metrics.fFontName.c_str(), ttcIndex);
+                            metrics.fFontName.c_str(), ttcIndex, face->uniqueID(),
+                            canon->fSharedCache);
                     if (subsetStream) {
                         descriptor->insertObjRef("FontFile2", std::move(subsetStream));
                         break;
@@ -455,13 +537,13 @@ void SkPDFType0Font::getFontSubset(SkPDFCanon* canon) {
     sysInfo->insertInt("Supplement", 0);
     newCIDFont->insertObject("CIDSystemInfo", std::move(sysInfo));
 
-    int16_t defaultWidth = 0;
     {
         int emSize;
-        auto glyphCache = SkPDFFont::MakeVectorCache(face, &emSize);
-        sk_sp<SkPDFArray> widths = SkPDFMakeCIDGlyphWidthsArray(
-                glyphCache.get(), &this->glyphUsage(), SkToS16(emSize), &defaultWidth);
-        if (widths && widths->size() > 0) {
+        int16_t defaultWidth;
+        sk_sp<SkPDFObject> widths = make_glyph_widths(face, this->glyphUsage(),
+                                                      canon->fSharedCache,
+                                                      &emSize, &defaultWidth);
+        if (widths) {
             newCIDFont->insertObject("W", std::move(widths));
         }
         newCIDFont->insertScalar(
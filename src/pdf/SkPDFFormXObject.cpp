@@ -13,8 +13,9 @@ sk_sp<SkPDFObject> SkPDFMakeFormXObject(std::unique_ptr<SkStreamAsset> content,
                                         sk_sp<SkPDFArray> mediaBox,
                                         sk_sp<SkPDFDict> resourceDict,
                                         const SkMatrix& inverseTransform,
-                                        const char* colorSpace) {
-    auto form = sk_make_sp<SkPDFStream>(std::move(content));
+                                        const char* colorSpace,
+                                        const SkPDFCompression& compression) {
+    auto form = sk_make_sp<SkPDFStream>(std::move(content), compression);
     form->dict()->insertName("Type", "XObject");
     form->dict()->insertName("Subtype", "Form");
     if (!inverseTransform.isIdentity()) {
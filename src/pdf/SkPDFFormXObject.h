@@ -21,5 +21,6 @@ sk_sp<SkPDFObject> SkPDFMakeFormXObject(std::unique_ptr<SkStreamAsset> content,
                                         sk_sp<SkPDFArray> mediaBox,
                                         sk_sp<SkPDFDict> resourceDict,
                                         const SkMatrix& inverseTransform,
-                                        const char* colorSpace);
+                                        const char* colorSpace,
+                                        const SkPDFCompression& = SkPDFCompression());
 #endif
@@ -6,8 +6,10 @@
  */
 
 #include "SkPDFResourceDict.h"
+#include "SkOnce.h"
 #include "SkPDFTypes.h"
 #include "SkPostConfig.h"
+#include "SkStream.h"
 
 // Sanity check that the values of enum SkPDFResourceType correspond to the
 // expected values as defined in the arrays below.
@@ -53,6 +55,39 @@ SkString SkPDFResourceDict::getResourceName(
     return SkStringPrintf("%c%d", SkPDFResourceDict::GetResourceTypePrefix(type), key);
 }
 
+constexpr int SkPDFResourceDict::kInternedNameCount;
+
+// Room for the prefix, up to three digits and the terminator.
+using InternedName = char[5];
+static_assert(SkPDFResourceDict::kInternedNameCount <= 1000, "interned_name_too_long");
+
+const char* SkPDFResourceDict::GetInternedResourceName(
+        SkPDFResourceDict::SkPDFResourceType type, int key) {
+    SkASSERT(key >= 0);
+    if (key >= kInternedNameCount) {
+        return nullptr;
+    }
+    static SkOnce once;
+    static InternedName names[kResourceTypeCount][kInternedNameCount];
+    once([] {
+        for (int t = 0; t < kResourceTypeCount; t++) {
+            for (int k = 0; k < kInternedNameCount; k++) {
+                snprintf(names[t][k], sizeof(InternedName), "%c%d",
+                         resource_type_prefixes[t], k);
+            }
+        }
+    });
+    return names[type][key];
+}
+
+void SkPDFResourceDict::WriteResourceName(SkWStream* content,
+                                          SkPDFResourceDict::SkPDFResourceType type,
+                                          int key) {
+    char prefix[2] = { '/', GetResourceTypePrefix(type) };
+    content->write(prefix, sizeof(prefix));
+    content->writeDecAsText(key);
+}
+
 static void add_subdict(
         const SkTDArray<SkPDFObject*>& resourceList,
         SkPDFResourceDict::SkPDFResourceType type,
@@ -61,9 +96,15 @@ static void add_subdict(
         return;
     }
     auto resources = sk_make_sp<SkPDFDict>();
+    resources->reserve(resourceList.count());
     for (int i = 0; i < resourceList.count(); i++) {
-        resources->insertObjRef(SkPDFResourceDict::getResourceName(type, i),
-                                sk_ref_sp(resourceList[i]));
+        // Small keys use interned names, so that the key isn't copied into an SkString.
+        if (const char* name = SkPDFResourceDict::GetInternedResourceName(type, i)) {
+            resources->insertObjRef(name, sk_ref_sp(resourceList[i]));
+        } else {
+            resources->insertObjRef(SkPDFResourceDict::getResourceName(type, i),
+                                    sk_ref_sp(resourceList[i]));
+        }
     }
     dst->insertObject(get_resource_type_name(type), std::move(resources));
 }
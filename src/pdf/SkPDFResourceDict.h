@@ -14,6 +14,7 @@
 
 class SkPDFDict;
 class SkPDFObject;
+class SkWStream;
 
 /** \class SkPDFResourceDict
 
@@ -56,6 +57,17 @@ public:
      *  @param key   The resource key, should be unique within its type.
      */
     static SkString getResourceName(SkPDFResourceType type, int key);
+
+    /**
+     * Returns the same name as getResourceName() from a table that lives as
+     * long as the process, or nullptr if the key is kInternedNameCount or
+     * larger. Interned names can be used as dictionary keys without copying.
+     */
+    static constexpr int kInternedNameCount = 256;
+    static const char* GetInternedResourceName(SkPDFResourceType type, int key);
+
+    /** Writes "/" followed by the resource's name to the content stream. */
+    static void WriteResourceName(SkWStream* content, SkPDFResourceType type, int key);
 };
 
 #endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPDFSharedCache.h"
+
+#include "SkBitSet.h"
+#include "SkOpts.h"
+#include "SkPDFTypes.h"
+
+sk_sp<SkDocument::PDFCache> SkDocument::PDFCache::Make(size_t byteLimit) {
+    return sk_make_sp<SkPDFSharedCache>(byteLimit);
+}
+
+SkPDFSharedCache::Key SkPDFSharedCache::Key::Image(Kind kind, const SkBitmapKey& bitmapKey,
+                                                   const SkPDFCompression& compression) {
+    Key key(kind);
+    key.fWords.push_back(bitmapKey.fID);
+    key.fWords.push_back(bitmapKey.fSubset.fLeft);
+    key.fWords.push_back(bitmapKey.fSubset.fTop);
+    key.fWords.push_back(bitmapKey.fSubset.fRight);
+    key.fWords.push_back(bitmapKey.fSubset.fBottom);
+    // Parallel compression produces different (but equally valid) bytes.
+    key.fWords.push_back(compression.fLevel);
+    key.fWords.push_back(compression.fExecutor ? 1 : 0);
+    key.finish();
+    return key;
+}
+
+SkPDFSharedCache::Key SkPDFSharedCache::Key::Font(Kind kind, uint32_t typefaceID,
+                                                  const SkBitSet& glyphUsage) {
+    Key key(kind);
+    key.fWords.push_back(typefaceID);
+    SkTDArray<uint32_t> glyphs;
+    glyphUsage.exportTo(&glyphs);
+    key.fWords.push_back_n(glyphs.count(), glyphs.begin());
+    key.finish();
+    return key;
+}
+
+void SkPDFSharedCache::Key::finish() {
+    fHash = SkOpts::hash(fWords.begin(), this->bytes());
+}
+
+SkPDFSharedCache::SkPDFSharedCache(size_t byteLimit) : fByteLimit(byteLimit) {}
+
+bool SkPDFSharedCache::find(const Key& key, Entry* entry) {
+    SkAutoMutexAcquire lock(fMutex);
+    Value* value = fMap.find(key);
+    if (!value) {
+        return false;
+    }
+    value->fLastUse = ++fUseCount;
+    *entry = value->fEntry;
+    ++fNumHits;
+    return true;
+}
+
+void SkPDFSharedCache::add(const Key& key, Entry entry) {
+    size_t bytes = key.bytes() + (entry.fData ? entry.fData->size() : 0);
+    if (bytes > fByteLimit) {
+        return;
+    }
+    SkAutoMutexAcquire lock(fMutex);
+    if (fMap.find(key)) {
+        // Another document made the same entry concurrently.
+        return;
+    }
+    fMap.set(key, Value{std::move(entry), ++fUseCount});
+    fBytesUsed += bytes;
+    this->purgeAsNeeded();
+}
+
+void SkPDFSharedCache::purgeAsNeeded() {
+    // Entries are few and large, so a linear scan for the oldest one is cheap compared to the
+    // work each entry saves.
+    while (fBytesUsed > fByteLimit) {
+        const Key* oldest = nullptr;
+        uint64_t oldestUse = UINT64_MAX;
+        size_t oldestBytes = 0;
+        fMap.foreach([&](const Key& key, Value* value) {
+            if (value->fLastUse < oldestUse) {
+                oldest = &key;
+                oldestUse = value->fLastUse;
+                oldestBytes = key.bytes() + (value->fEntry.fData ? value->fEntry.fData->size() : 0);
+            }
+        });
+        SkASSERT(oldest);
+        fBytesUsed -= oldestBytes;
+        Key oldestKey = *oldest;
+        fMap.remove(oldestKey);
+    }
+}
+
+int SkPDFSharedCache::count() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fMap.count();
+}
+
+size_t SkPDFSharedCache::bytesUsed() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fBytesUsed;
+}
+
+int SkPDFSharedCache::numHits() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fNumHits;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPDFSharedCache_DEFINED
+#define SkPDFSharedCache_DEFINED
+
+#include "SkBitmapKey.h"
+#include "SkData.h"
+#include "SkDocument.h"
+#include "SkMutex.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+
+class SkBitSet;
+struct SkPDFCompression;
+
+/**
+ *  The implementation of SkDocument::PDFCache. Unlike SkPDFCanon, which holds PDF objects that
+ *  belong to one document, it holds serialized bytes that are spliced into the objects of any
+ *  document that shares it:
+ *    - the compressed pixels and alpha of image XObjects, and whether an image is opaque,
+ *      keyed by SkBitmapKey and the compression settings;
+ *    - font subsets and /W glyph width arrays, keyed by typeface and glyph usage.
+ *
+ *  All methods are thread-safe. Once the cache holds more than its byte limit the least
+ *  recently used entries are evicted.
+ */
+class SkPDFSharedCache final : public SkDocument::PDFCache {
+public:
+    enum class Kind : uint32_t {
+        kImageOpacity,
+        kImagePixels,
+        kImageAlpha,
+        kFontSubset,
+        kGlyphWidths,
+    };
+
+    class Key {
+    public:
+        Key() {}
+        static Key Image(Kind, const SkBitmapKey&, const SkPDFCompression&);
+        static Key Font(Kind, uint32_t typefaceID, const SkBitSet& glyphUsage);
+
+        bool operator==(const Key& that) const { return fWords == that.fWords; }
+        uint32_t hash() const { return fHash; }
+        size_t bytes() const { return fWords.count() * sizeof(uint32_t); }
+
+    private:
+        explicit Key(Kind kind) { fWords.push_back((uint32_t)kind); }
+        void finish();
+
+        SkSTArray<8, uint32_t> fWords;
+        uint32_t fHash = 0;
+    };
+
+    /** The cached bytes, plus a small value whose meaning depends on the Kind. */
+    struct Entry {
+        sk_sp<SkData> fData;
+        uint32_t fInfo = 0;
+    };
+
+    explicit SkPDFSharedCache(size_t byteLimit);
+
+    /** Returns true and sets 'entry' if the key is in the cache. */
+    bool find(const Key&, Entry* entry);
+    void add(const Key&, Entry);
+
+    int count() const;
+    size_t bytesUsed() const;
+    int numHits() const;
+
+private:
+    struct Value {
+        Entry fEntry;
+        uint64_t fLastUse;
+    };
+    struct KeyHash {
+        uint32_t operator()(const Key& key) const { return key.hash(); }
+    };
+
+    void purgeAsNeeded();
+
+    const size_t fByteLimit;
+    mutable SkMutex fMutex;
+    SkTHashMap<Key, Value, KeyHash> fMap;
+    size_t fBytesUsed = 0;
+    uint64_t fUseCount = 0;
+    int fNumHits = 0;
+};
+
+#endif  // SkPDFSharedCache_DEFINED
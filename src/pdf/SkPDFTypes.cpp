@@ -500,12 +500,13 @@ void SkPDFSharedStream::addResources(
 
 ////////////////////////////////////////////////////////////////////////////////
 
-SkPDFStream:: SkPDFStream(sk_sp<SkData> data) {
-    this->setData(skstd::make_unique<SkMemoryStream>(std::move(data)));
+SkPDFStream:: SkPDFStream(sk_sp<SkData> data, const SkPDFCompression& compression) {
+    this->setData(skstd::make_unique<SkMemoryStream>(std::move(data)), compression);
 }
 
-SkPDFStream::SkPDFStream(std::unique_ptr<SkStreamAsset> stream) {
-    this->setData(std::move(stream));
+SkPDFStream::SkPDFStream(std::unique_ptr<SkStreamAsset> stream,
+                         const SkPDFCompression& compression) {
+    this->setData(std::move(stream), compression);
 }
 
 SkPDFStream::SkPDFStream() {}
@@ -535,7 +536,8 @@ void SkPDFStream::emitObject(SkWStream* stream,
     stream->writeText("\nendstream");
 }
 
-void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream) {
+void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream,
+                          const SkPDFCompression& compression) {
     SkASSERT(!fCompressedData);  // Only call this function once.
     SkASSERT(stream);
     // Code assumes that the stream starts at the beginning.
@@ -548,7 +550,8 @@ void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream) {
 
     SkASSERT(stream->hasLength());
     SkDynamicMemoryWStream compressedData;
-    SkDeflateWStream deflateWStream(&compressedData);
+    SkDeflateWStream deflateWStream(&compressedData, compression.fLevel, false,
+                                    compression.fExecutor);
     if (stream->getLength() > 0) {
         SkStreamCopy(&deflateWStream, stream.get());
     }
@@ -571,17 +574,32 @@ void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void SkPDFObjNumMap::addObjectRecursively(SkPDFObject* obj) {
-    if (obj && !fObjectNumbers.find(obj)) {
-        fObjectNumbers.set(obj, fObjectNumbers.count() + 1);
-        fObjects.emplace_back(sk_ref_sp(obj));
-        obj->addResources(this);
+    // Only this thread adds objects, so it may look for them without the lock.
+    if (!obj || fObjectNumbers.find(obj)) {
+        return;
+    }
+    if (fLock) {
+        fLock->acquire();
+    }
+    fObjectNumbers.set(obj, fObjectNumbers.count() + 1);
+    if (fLock) {
+        fLock->release();
     }
+    fObjects.emplace_back(sk_ref_sp(obj));
+    obj->addResources(this);
 }
 
 int32_t SkPDFObjNumMap::getObjectNumber(SkPDFObject* obj) const {
+    if (fLock) {
+        fLock->acquireShared();
+    }
     int32_t* objectNumberFound = fObjectNumbers.find(obj);
     SkASSERT(objectNumberFound);
-    return *objectNumberFound;
+    int32_t objectNumber = *objectNumberFound;
+    if (fLock) {
+        fLock->releaseShared();
+    }
+    return objectNumber;
 }
 
 #ifdef SK_PDF_IMAGE_STATS
@@ -12,10 +12,13 @@
 
 #include "SkRefCnt.h"
 #include "SkScalar.h"
+#include "SkSharedMutex.h"
+#include "SkTArray.h"
 #include "SkTHash.h"
 #include "SkTypes.h"
 
 class SkData;
+class SkExecutor;
 class SkPDFObjNumMap;
 class SkPDFObject;
 class SkStreamAsset;
@@ -234,7 +237,8 @@ public:
     void appendObjRef(sk_sp<SkPDFObject>);
 
 private:
-    SkTArray<SkPDFUnion> fValues;
+    // Most arrays are short (rects, matrices, /Filter lists), so keep them inline.
+    SkSTArray<4, SkPDFUnion> fValues;
     void append(SkPDFUnion&& value);
     SkDEBUGCODE(bool fDumped;)
 };
@@ -297,7 +301,8 @@ private:
         SkPDFUnion fKey;
         SkPDFUnion fValue;
     };
-    SkTArray<Record> fRecords;
+    // Small dictionaries (resource sub-dicts, ExtGStates) don't allocate their records.
+    SkSTArray<4, Record> fRecords;
     SkDEBUGCODE(bool fDumped;)
 };
 
@@ -324,6 +329,13 @@ private:
     typedef SkPDFObject INHERITED;
 };
 
+/** How SkPDFStream and image XObjects are deflated. See SkDocument::PDFMetadata. */
+struct SkPDFCompression {
+    int fLevel = -1;
+    // If set, large streams are deflated in parallel on this executor.
+    SkExecutor* fExecutor = nullptr;
+};
+
 /** \class SkPDFStream
 
     This class takes an asset and assumes that it is the only owner of
@@ -338,8 +350,9 @@ public:
      *  stream dictionary.
      *  @param data   The data part of the stream.
      *  @param stream The data part of the stream. */
-    explicit SkPDFStream(sk_sp<SkData> data);
-    explicit SkPDFStream(std::unique_ptr<SkStreamAsset> stream);
+    explicit SkPDFStream(sk_sp<SkData> data, const SkPDFCompression& = SkPDFCompression());
+    explicit SkPDFStream(std::unique_ptr<SkStreamAsset> stream,
+                         const SkPDFCompression& = SkPDFCompression());
     ~SkPDFStream() override;
 
     SkPDFDict* dict() { return &fDict; }
@@ -356,7 +369,8 @@ protected:
     SkPDFStream();
 
     /** Only call this function once. */
-    void setData(std::unique_ptr<SkStreamAsset> stream);
+    void setData(std::unique_ptr<SkStreamAsset> stream,
+                 const SkPDFCompression& = SkPDFCompression());
 
 private:
     std::unique_ptr<SkStreamAsset> fCompressedData;
@@ -386,9 +400,13 @@ public:
 
     const SkTArray<sk_sp<SkPDFObject>>& objects() const { return fObjects; }
 
+    /** Allows getObjectNumber() to be called on other threads while objects are added. */
+    void makeThreadSafe() { fLock.reset(new SkSharedMutex); }
+
 private:
     SkTArray<sk_sp<SkPDFObject>> fObjects;
     SkTHashMap<SkPDFObject*, int32_t> fObjectNumbers;
+    std::unique_ptr<SkSharedMutex> fLock;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
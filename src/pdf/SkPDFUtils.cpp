@@ -238,19 +238,15 @@ void SkPDFUtils::StrokePath(SkWStream* content) {
 
 // static
 void SkPDFUtils::DrawFormXObject(int objectIndex, SkWStream* content) {
-    content->writeText("/");
-    content->writeText(SkPDFResourceDict::getResourceName(
-            SkPDFResourceDict::kXObject_ResourceType,
-            objectIndex).c_str());
+    SkPDFResourceDict::WriteResourceName(content, SkPDFResourceDict::kXObject_ResourceType,
+                                         objectIndex);
     content->writeText(" Do\n");
 }
 
 // static
 void SkPDFUtils::ApplyGraphicState(int objectIndex, SkWStream* content) {
-    content->writeText("/");
-    content->writeText(SkPDFResourceDict::getResourceName(
-            SkPDFResourceDict::kExtGState_ResourceType,
-            objectIndex).c_str());
+    SkPDFResourceDict::WriteResourceName(content, SkPDFResourceDict::kExtGState_ResourceType,
+                                         objectIndex);
     content->writeText(" gs\n");
 }
 
@@ -258,13 +254,12 @@ void SkPDFUtils::ApplyGraphicState(int objectIndex, SkWStream* content) {
 void SkPDFUtils::ApplyPattern(int objectIndex, SkWStream* content) {
     // Select Pattern color space (CS, cs) and set pattern object as current
     // color (SCN, scn)
-    SkString resourceName = SkPDFResourceDict::getResourceName(
-            SkPDFResourceDict::kPattern_ResourceType,
-            objectIndex);
-    content->writeText("/Pattern CS/Pattern cs/");
-    content->writeText(resourceName.c_str());
-    content->writeText(" SCN/");
-    content->writeText(resourceName.c_str());
+    content->writeText("/Pattern CS/Pattern cs");
+    SkPDFResourceDict::WriteResourceName(content, SkPDFResourceDict::kPattern_ResourceType,
+                                         objectIndex);
+    content->writeText(" SCN");
+    SkPDFResourceDict::WriteResourceName(content, SkPDFResourceDict::kPattern_ResourceType,
+                                         objectIndex);
     content->writeText(" scn\n");
 }
 
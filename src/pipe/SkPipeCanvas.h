@@ -13,42 +13,32 @@
 #include "SkImage.h"
 #include "SkNoDrawCanvas.h"
 #include "SkPipe.h"
+#include "SkTHash.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
 
 class SkPipeCanvas;
 class SkPipeWriter;
 
+// The sets live as long as the serializer, across frames, so they're hashed rather than searched.
 template <typename T> class SkTIndexSet {
 public:
-    void reset() { fArray.reset(); }
+    void reset() { fMap.reset(); }
 
     // returns the found index or 0
     int find(const T& key) const {
-        const Rec* stop = fArray.end();
-        for (const Rec* curr = fArray.begin(); curr < stop; ++curr) {
-            if (key == curr->fKey) {
-                return curr->fIndex;
-            }
-        }
-        return 0;
+        const int* index = fMap.find(key);
+        return index ? *index : 0;
     }
 
     // returns the new index
     int add(const T& key) {
-        Rec* rec = fArray.append();
-        rec->fKey = key;
-        rec->fIndex = fNextIndex++;
-        return rec->fIndex;
+        SkASSERT(!fMap.find(key));
+        return *fMap.set(key, fNextIndex++);
     }
 
 private:
-    struct Rec {
-        T   fKey;
-        int fIndex;
-    };
-
-    SkTDArray<Rec>  fArray;
+    SkTHashMap<T, int>  fMap;
     int fNextIndex = 1;
 };
 
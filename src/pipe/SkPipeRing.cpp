@@ -0,0 +1,118 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPipeRing.h"
+
+#include <atomic>
+#include <thread>
+
+// Positions count bytes through the ring since it was created. Messages start 8 byte aligned
+// with their length, and one that would run off the end of the ring is moved to the start,
+// leaving kWrap in place of its length.
+class SkPipeRing::Header {
+public:
+    std::atomic<uint64_t> fWritten;    // The end of the last finished message.
+    std::atomic<uint64_t> fReleased;   // The end of the last message the reader released.
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "");
+
+static constexpr size_t kHeaderSize = SkAlign8(sizeof(SkPipeRing::Header));
+static constexpr size_t kLengthSize = 8;
+static constexpr uint32_t kWrap = 0xFFFFFFFF;
+
+static SkPipeRing::Header* header(void* memory, size_t size) {
+    SkASSERT(SkIsAlign8(reinterpret_cast<uintptr_t>(memory)));
+    SkASSERT(size >= SkPipeRing::kMinSize);
+    return static_cast<SkPipeRing::Header*>(memory);
+}
+
+static uint64_t capacity(size_t size) { return (size - kHeaderSize) & ~7; }
+
+SkPipeRingWriter::SkPipeRingWriter(void* memory, size_t size)
+        : fHeader{header(memory, size)}
+        , fData{static_cast<char*>(memory) + kHeaderSize}
+        , fCapacity{capacity(size)}
+        , fMessageStart{fHeader->fWritten.load(std::memory_order_relaxed)} {}
+
+bool SkPipeRingWriter::reserve(size_t bytes) {
+    const uint64_t total = kLengthSize + SkAlign8(fMessageSize + bytes);
+    if (total > fCapacity || fMessageSize + bytes >= kWrap) {
+        return false;
+    }
+
+    uint64_t start = fMessageStart;
+    const uint64_t offset = start % fCapacity;
+    if (offset + total > fCapacity) {
+        start += fCapacity - offset;
+    }
+    while (start + total - fHeader->fReleased.load(std::memory_order_acquire) > fCapacity) {
+        std::this_thread::yield();
+    }
+    if (start != fMessageStart) {
+        // The reader is done with the start of the ring, since it's caught up to this message.
+        memcpy(fData + kLengthSize, fData + offset + kLengthSize, fMessageSize);
+        *reinterpret_cast<uint32_t*>(fData + offset) = kWrap;
+        fMessageStart = start;
+    }
+    return true;
+}
+
+bool SkPipeRingWriter::write(const void* buffer, size_t size) {
+    if (fFailed || !this->reserve(size)) {
+        fFailed = true;
+        return false;
+    }
+    memcpy(fData + fMessageStart % fCapacity + kLengthSize + fMessageSize, buffer, size);
+    fMessageSize += size;
+    return true;
+}
+
+bool SkPipeRingWriter::endMessage() {
+    if (fFailed || !this->reserve(0)) {
+        fFailed = false;
+        fMessageSize = 0;
+        return false;
+    }
+    *reinterpret_cast<uint32_t*>(fData + fMessageStart % fCapacity) = SkToU32(fMessageSize);
+    fMessageStart += kLengthSize + SkAlign8(fMessageSize);
+    fMessageSize = 0;
+    fHeader->fWritten.store(fMessageStart, std::memory_order_release);
+    return true;
+}
+
+SkPipeRingReader::SkPipeRingReader(void* memory, size_t size)
+        : fHeader{header(memory, size)}
+        , fData{static_cast<const char*>(memory) + kHeaderSize}
+        , fCapacity{capacity(size)}
+        , fReadPos{fHeader->fReleased.load(std::memory_order_relaxed)} {}
+
+const void* SkPipeRingReader::peekMessage(size_t* size) {
+    const uint64_t written = fHeader->fWritten.load(std::memory_order_acquire);
+    while (fReadPos < written) {
+        const uint64_t offset = fReadPos % fCapacity;
+        const uint32_t length = *reinterpret_cast<const uint32_t*>(fData + offset);
+        if (length == kWrap) {
+            fReadPos += fCapacity - offset;
+            continue;
+        }
+        // The writer is in another process, so don't trust it to have kept to the ring.
+        if (offset + kLengthSize + SkAlign8(uint64_t(length)) > fCapacity) {
+            return nullptr;
+        }
+        fPeekedSize = length;
+        *size = length;
+        return fData + offset + kLengthSize;
+    }
+    return nullptr;
+}
+
+void SkPipeRingReader::releaseMessage() {
+    fReadPos += kLengthSize + SkAlign8(fPeekedSize);
+    fPeekedSize = 0;
+    fHeader->fReleased.store(fReadPos, std::memory_order_release);
+}
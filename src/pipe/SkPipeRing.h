@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPipeRing_DEFINED
+#define SkPipeRing_DEFINED
+
+#include "SkStream.h"
+
+/**
+ *  A queue of pipe messages in memory shared by one producer and one consumer, e.g. a renderer
+ *  and an out of process rasterizer, so commands can be streamed across without copying them
+ *  through a pipe or socket. Both sides are handed the same memory, which must start out
+ *  zeroed (as new shared memory is), be 8 byte aligned, and be at least kMinSize bytes.
+ *
+ *  The producer serializes straight into the ring with an SkPipeRingWriter, and the consumer
+ *  plays each message back from where it is with an SkPipeRingReader. Messages are kept whole,
+ *  as SkPipeDeserializer::playback() needs them, so the producer waits for the consumer when
+ *  the ring is too full for the next one.
+ *
+ *  Typefaces, images and pictures are only sent once for as long as the SkPipeSerializer and
+ *  SkPipeDeserializer on either side live, so they should be kept across frames.
+ */
+class SkPipeRing {
+public:
+    static constexpr size_t kMinSize = 64;
+
+    class Header;
+};
+
+/**
+ *  Writes one message into the ring at a time. Everything written between calls to
+ *  endMessage() (e.g. by SkPipeSerializer::beginWrite() ... endWrite()) is one message.
+ */
+class SkPipeRingWriter : public SkWStream {
+public:
+    SkPipeRingWriter(void* memory, size_t size);
+
+    bool write(const void* buffer, size_t size) override;
+
+    // Bytes written to the current message.
+    size_t bytesWritten() const override { return fMessageSize; }
+
+    /**
+     *  Makes the message written so far available to the reader. Returns false, dropping it,
+     *  if it couldn't fit in the ring at all; the serializer that wrote it should then
+     *  resetCache(), since what it defined in the message never arrives.
+     */
+    bool endMessage();
+
+private:
+    // Waits until the ring has room for bytes more of the current message, moving it to the
+    // start of the ring if it would run off the end. Returns false if it never can.
+    bool reserve(size_t bytes);
+
+    SkPipeRing::Header* const fHeader;
+    char* const               fData;
+    const uint64_t            fCapacity;
+
+    uint64_t fMessageStart = 0;  // Where the current message's length goes.
+    size_t   fMessageSize = 0;
+    bool     fFailed = false;
+};
+
+class SkPipeRingReader {
+public:
+    SkPipeRingReader(void* memory, size_t size);
+
+    /**
+     *  Returns the next message and sets size to its length, or returns nullptr if the writer
+     *  hasn't finished one. The message stays where it is, for playback, until releaseMessage().
+     */
+    const void* peekMessage(size_t* size);
+
+    // Gives the space of the message from peekMessage() back to the writer.
+    void releaseMessage();
+
+private:
+    SkPipeRing::Header* const fHeader;
+    const char* const         fData;
+    const uint64_t            fCapacity;
+
+    uint64_t fReadPos = 0;
+    size_t   fPeekedSize = 0;
+};
+
+#endif
@@ -9,10 +9,13 @@
 
 #include "SkAutoMalloc.h"
 #include "SkBuffer.h"
+#include "SkChecksum.h"
+#include "SkData.h"
 #include "SkFixed.h"
 #include "SkFontConfigInterface_direct.h"
 #include "SkFontStyle.h"
 #include "SkMutex.h"
+#include "SkOpts.h"
 #include "SkStream.h"
 #include "SkString.h"
 #include "SkTArray.h"
@@ -506,7 +509,10 @@ const char* kFontFormatTrueType = "TrueType";
 const char* kFontFormatCFF = "CFF";
 #endif
 
-SkFontConfigInterfaceDirect::SkFontConfigInterfaceDirect() {
+// Lookups by web content can ask for any number of families, so only keep the most recent.
+static constexpr int kMaxMatches = 1024;
+
+SkFontConfigInterfaceDirect::SkFontConfigInterfaceDirect() : fMatches(kMaxMatches) {
     FCLocker lock;
 
     FcInit();
@@ -583,11 +589,201 @@ FcPattern* SkFontConfigInterfaceDirect::MatchFont(FcFontSet* font_set,
   return match;
 }
 
+uint32_t SkFontConfigInterfaceDirect::MatchKeyHash::operator()(const MatchKey& key) const {
+    return SkOpts::hash(key.fFamilyName.c_str(), key.fFamilyName.size(),
+                        SkChecksum::Mix(key.fStyle.weight() << 16 | key.fStyle.width() << 8 |
+                                        key.fStyle.slant()));
+}
+
 bool SkFontConfigInterfaceDirect::matchFamilyName(const char familyName[],
                                                   SkFontStyle style,
                                                   FontIdentity* outIdentity,
                                                   SkString* outFamilyName,
                                                   SkFontStyle* outStyle) {
+    MatchKey key = { SkString(familyName ? familyName : ""), style };
+    {
+        SkAutoMutexAcquire lock(fMatchesMutex);
+        if (const Match* match = fMatches.find(key)) {
+            if (!match->fFound) {
+                return false;
+            }
+            if (outIdentity) {
+                *outIdentity = match->fIdentity;
+            }
+            if (outFamilyName) {
+                *outFamilyName = match->fFamilyName;
+            }
+            if (outStyle) {
+                *outStyle = match->fStyle;
+            }
+            return true;
+        }
+    }
+
+    Match match = { key, false, FontIdentity(), SkString(), SkFontStyle() };
+    match.fFound = this->matchFamilyNameUncached(familyName, style, &match.fIdentity,
+                                                 &match.fFamilyName, &match.fStyle);
+    if (match.fFound) {
+        if (outIdentity) {
+            *outIdentity = match.fIdentity;
+        }
+        if (outFamilyName) {
+            *outFamilyName = match.fFamilyName;
+        }
+        if (outStyle) {
+            *outStyle = match.fStyle;
+        }
+    }
+    const bool found = match.fFound;
+
+    SkAutoMutexAcquire lock(fMatchesMutex);
+    if (!fMatches.find(key)) {
+        fMatches.insert(key, std::move(match));
+    }
+    return found;
+}
+
+void SkFontConfigInterfaceDirect::prewarm(const char* const familyNames[], int familyCount,
+                                          const SkFontStyle styles[], int styleCount) {
+    for (int i = 0; i < familyCount; ++i) {
+        for (int j = 0; j < styleCount; ++j) {
+            this->matchFamilyName(familyNames[i], styles[j], nullptr, nullptr, nullptr);
+        }
+    }
+}
+
+// Changes whenever fonts or config files are added or removed.
+uint32_t SkFontConfigInterfaceDirect::fontSetFingerprint() {
+    FCLocker lock;
+
+    uint32_t hash = 0;
+    if (FcFontSet* fonts = FcConfigGetFonts(nullptr, FcSetSystem)) {
+        for (int i = 0; i < fonts->nfont; ++i) {
+            if (const char* file = get_string(fonts->fonts[i], FC_FILE)) {
+                hash = SkOpts::hash(file, strlen(file), hash);
+            }
+            hash = SkChecksum::Mix(hash + get_int(fonts->fonts[i], FC_INDEX, 0));
+        }
+    }
+    if (FcStrList* configFiles = FcConfigGetConfigFiles(nullptr)) {
+        while (const FcChar8* file = FcStrListNext(configFiles)) {
+            hash = SkOpts::hash(file, strlen((const char*)file), hash);
+        }
+        FcStrListDone(configFiles);
+    }
+    return hash;
+}
+
+static constexpr uint32_t kMatchesMagic   = SkSetFourByteTag('f', 'c', 'm', 'c');
+static constexpr uint32_t kMatchesVersion = 1;
+
+static void write_string(SkDynamicMemoryWStream* stream, const SkString& str) {
+    stream->write32(SkToU32(str.size()));
+    stream->write(str.c_str(), str.size());
+    stream->padToAlign4();
+}
+
+static bool read_string(SkRBuffer* buffer, SkString* str) {
+    uint32_t size;
+    if (!buffer->readU32(&size) || size > buffer->available()) {
+        return false;
+    }
+    str->resize(size);
+    return buffer->read(str->writable_str(), size) && buffer->skipToAlign4();
+}
+
+static void write_style(SkDynamicMemoryWStream* stream, const SkFontStyle& style) {
+    stream->write32(style.weight());
+    stream->write32(style.width());
+    stream->write32(style.slant());
+}
+
+static bool read_style(SkRBuffer* buffer, SkFontStyle* style) {
+    int32_t weight, width, slant;
+    if (!buffer->readS32(&weight) || !buffer->readS32(&width) || !buffer->readS32(&slant) ||
+        slant < SkFontStyle::kUpright_Slant || slant > SkFontStyle::kOblique_Slant) {
+        return false;
+    }
+    *style = SkFontStyle(weight, width, (SkFontStyle::Slant)slant);
+    return true;
+}
+
+sk_sp<SkData> SkFontConfigInterfaceDirect::saveMatches() {
+    SkDynamicMemoryWStream stream;
+    stream.write32(kMatchesMagic);
+    stream.write32(kMatchesVersion);
+    stream.write32(this->fontSetFingerprint());
+
+    SkAutoMutexAcquire lock(fMatchesMutex);
+    stream.write32(fMatches.count());
+    fMatches.foreach([&stream](Match* match) {
+        write_string(&stream, match->fKey.fFamilyName);
+        write_style(&stream, match->fKey.fStyle);
+        stream.write32(match->fFound);
+        if (match->fFound) {
+            size_t identitySize = match->fIdentity.writeToMemory();
+            SkAutoMalloc identity(identitySize);
+            match->fIdentity.writeToMemory(identity.get());
+            stream.write32(SkToU32(identitySize));
+            stream.write(identity.get(), identitySize);
+            write_string(&stream, match->fFamilyName);
+            write_style(&stream, match->fStyle);
+        }
+    });
+    return stream.detachAsData();
+}
+
+bool SkFontConfigInterfaceDirect::loadMatches(const SkData& data) {
+    SkRBuffer buffer(data.data(), data.size());
+    uint32_t magic, version, fingerprint, count;
+    if (!buffer.readU32(&magic) || magic != kMatchesMagic ||
+        !buffer.readU32(&version) || version != kMatchesVersion ||
+        !buffer.readU32(&fingerprint) || fingerprint != this->fontSetFingerprint() ||
+        !buffer.readU32(&count)) {
+        return false;
+    }
+
+    SkTArray<Match> matches;
+    for (uint32_t i = 0; i < count; ++i) {
+        Match match = { MatchKey(), false, FontIdentity(), SkString(), SkFontStyle() };
+        uint32_t found;
+        if (!read_string(&buffer, &match.fKey.fFamilyName) ||
+            !read_style(&buffer, &match.fKey.fStyle) ||
+            !buffer.readU32(&found)) {
+            return false;
+        }
+        match.fFound = SkToBool(found);
+        if (match.fFound) {
+            uint32_t identitySize;
+            if (!buffer.readU32(&identitySize) || identitySize > buffer.available() ||
+                match.fIdentity.readFromMemory(buffer.skip(identitySize), identitySize)
+                        != identitySize ||
+                !read_string(&buffer, &match.fFamilyName) ||
+                !read_style(&buffer, &match.fStyle)) {
+                return false;
+            }
+            if (!this->isAccessible(match.fIdentity.fString.c_str())) {
+                continue;
+            }
+        }
+        matches.push_back(std::move(match));
+    }
+
+    SkAutoMutexAcquire lock(fMatchesMutex);
+    // Saved in most recently used first order; insert the oldest first to keep it.
+    for (int i = matches.count() - 1; i >= 0; --i) {
+        if (!fMatches.find(matches[i].fKey)) {
+            fMatches.insert(matches[i].fKey, std::move(matches[i]));
+        }
+    }
+    return true;
+}
+
+bool SkFontConfigInterfaceDirect::matchFamilyNameUncached(const char familyName[],
+                                                          SkFontStyle style,
+                                                          FontIdentity* outIdentity,
+                                                          SkString* outFamilyName,
+                                                          SkFontStyle* outStyle) {
     SkString familyStr(familyName ? familyName : "");
     if (familyStr.size() > kMaxFontFamilyLength) {
         return false;
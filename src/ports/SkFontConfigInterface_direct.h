@@ -10,9 +10,13 @@
 #define SKFONTCONFIGINTERFACE_DIRECT_H_
 
 #include "SkFontConfigInterface.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 
 #include <fontconfig/fontconfig.h>
 
+class SkData;
+
 class SkFontConfigInterfaceDirect : public SkFontConfigInterface {
 public:
     SkFontConfigInterfaceDirect();
@@ -26,13 +30,58 @@ public:
 
     SkStreamAsset* openStream(const FontIdentity&) override;
 
+    /**
+     *  matchFamilyName() remembers its results, including failed matches, so that repeated
+     *  lookups don't go through fontconfig matching and its lock.
+     *
+     *  prewarm() matches every given family in every given style ahead of time, for instance
+     *  from a list of the families an application uses.
+     */
+    void prewarm(const char* const familyNames[], int familyCount,
+                 const SkFontStyle styles[], int styleCount);
+
+    /**
+     *  Saves the remembered matches, to be restored by loadMatches() in a later process. Saved
+     *  matches are only restored when the same fonts are installed, and only those whose font
+     *  files are still accessible.
+     */
+    sk_sp<SkData> saveMatches();
+    bool loadMatches(const SkData&);
+
 protected:
     virtual bool isAccessible(const char* filename);
 
 private:
+    bool matchFamilyNameUncached(const char familyName[], SkFontStyle requested,
+                                 FontIdentity* outFontIdentifier, SkString* outFamilyName,
+                                 SkFontStyle* outStyle);
     bool isValidPattern(FcPattern* pattern);
     FcPattern* MatchFont(FcFontSet* font_set, const char* post_config_family,
                          const SkString& family);
+    uint32_t fontSetFingerprint();
+
+    struct MatchKey {
+        SkString    fFamilyName;
+        SkFontStyle fStyle;
+
+        bool operator==(const MatchKey& other) const {
+            return fFamilyName == other.fFamilyName && fStyle == other.fStyle;
+        }
+    };
+    struct MatchKeyHash {
+        uint32_t operator()(const MatchKey&) const;
+    };
+    struct Match {
+        MatchKey     fKey;
+        bool         fFound;
+        FontIdentity fIdentity;
+        SkString     fFamilyName;
+        SkFontStyle  fStyle;
+    };
+
+    SkMutex                                   fMatchesMutex;
+    SkLRUCache<MatchKey, Match, MatchKeyHash> fMatches;
+
     typedef SkFontConfigInterface INHERITED;
 };
 
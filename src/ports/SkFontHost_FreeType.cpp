@@ -26,6 +26,7 @@
 #include "SkStream.h"
 #include "SkString.h"
 #include "SkTemplates.h"
+#include "SkThreadID.h"
 #include <memory>
 
 #include <ft2build.h>
@@ -231,12 +232,24 @@ static void unref_ft_library() {
 
 struct SkFaceRec {
     SkFaceRec* fNext;
+    // Guards all use of fFace, which FreeType allows from one thread at a time. Opening and closing
+    // faces, and the list of them, are still guarded by gFTMutex, which is never held while waiting
+    // for this, so that a busy face doesn't hold up scaler contexts of other fonts.
+    SkMutex fMutex;
+    // The thread that opened the face. Scaler contexts prefer their own thread's face of a font,
+    // so that threads rasterizing the same typeface don't wait on each other.
+    SkThreadID fOwner;
     std::unique_ptr<FT_FaceRec, SkFunctionWrapper<FT_Error, FT_FaceRec, FT_Done_Face>> fFace;
     FT_StreamRec fFTStream;
     std::unique_ptr<SkStreamAsset> fSkStream;
     uint32_t fRefCnt;
     uint32_t fFontID;
 
+    // Faces opened from memory without variations can be shared by every typeface whose data is
+    // the same memory and index, like typefaces mapping the same font file.
+    const void* fSharedMemoryBase;
+    int fIndex;
+
     // FreeType prior to 2.7.1 does not implement retreiving variation design metrics.
     // Cache the variation design metrics used to create the font if the user specifies them.
     SkAutoSTMalloc<4, SkFixed> fAxes;
@@ -271,8 +284,9 @@ extern "C" {
 }
 
 SkFaceRec::SkFaceRec(std::unique_ptr<SkStreamAsset> stream, uint32_t fontID)
-        : fNext(nullptr), fSkStream(std::move(stream)), fRefCnt(1), fFontID(fontID)
-        , fAxesCount(0), fNamedVariationSpecified(false)
+        : fNext(nullptr), fOwner(kIllegalThreadID)
+        , fSkStream(std::move(stream)), fRefCnt(1), fFontID(fontID)
+        , fSharedMemoryBase(nullptr), fIndex(0), fAxesCount(0), fNamedVariationSpecified(false)
 {
     sk_bzero(&fFTStream, sizeof(fFTStream));
     fFTStream.size = fSkStream->getLength();
@@ -325,20 +339,46 @@ static void ft_face_setup_axes(SkFaceRec* rec, const SkFontData& data) {
     }
 }
 
+// The most faces opened on the same font, for scaler contexts created on different threads.
+static constexpr int kMaxFacesPerFont = 4;
+
+// Of the faces in the list matching a font, returns the one opened by owner, or if there is none
+// and no more faces may be opened on the font, the least used one. Returns nullptr otherwise.
+template <typename Matches>
+static SkFaceRec* find_ft_face(SkThreadID owner, Matches&& matches) {
+    gFTMutex.assertHeld();
+
+    SkFaceRec* leastUsed = nullptr;
+    int count = 0;
+    for (SkFaceRec* rec = gFaceRecHead; rec; rec = rec->fNext) {
+        if (!matches(rec)) {
+            continue;
+        }
+        SkASSERT(rec->fFace);
+        if (rec->fOwner == owner || kIllegalThreadID == owner) {
+            return rec;
+        }
+        if (!leastUsed || rec->fRefCnt < leastUsed->fRefCnt) {
+            leastUsed = rec;
+        }
+        ++count;
+    }
+    return count < kMaxFacesPerFont ? nullptr : leastUsed;
+}
+
 // Will return nullptr on failure
 // Caller must lock gFTMutex before calling this function.
-static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
+// Prefers the face opened by owner; any face of the typeface will do if owner is kIllegalThreadID.
+static SkFaceRec* ref_ft_face(const SkTypeface* typeface, SkThreadID owner) {
     gFTMutex.assertHeld();
 
     const SkFontID fontID = typeface->uniqueID();
-    SkFaceRec* cachedRec = gFaceRecHead;
-    while (cachedRec) {
-        if (cachedRec->fFontID == fontID) {
-            SkASSERT(cachedRec->fFace);
-            cachedRec->fRefCnt += 1;
-            return cachedRec;
-        }
-        cachedRec = cachedRec->fNext;
+    SkFaceRec* cachedRec = find_ft_face(owner, [fontID](const SkFaceRec* rec) {
+        return rec->fFontID == fontID;
+    });
+    if (cachedRec) {
+        cachedRec->fRefCnt += 1;
+        return cachedRec;
     }
 
     std::unique_ptr<SkFontData> data = typeface->makeFontData();
@@ -346,7 +386,23 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
         return nullptr;
     }
 
+    const void* sharedMemoryBase = data->getAxisCount() == 0
+                                 ? data->getStream()->getMemoryBase() : nullptr;
+    if (sharedMemoryBase) {
+        const int index = data->getIndex();
+        cachedRec = find_ft_face(owner, [sharedMemoryBase, index](const SkFaceRec* rec) {
+            return rec->fSharedMemoryBase == sharedMemoryBase && rec->fIndex == index;
+        });
+        if (cachedRec) {
+            cachedRec->fRefCnt += 1;
+            return cachedRec;
+        }
+    }
+
     std::unique_ptr<SkFaceRec> rec(new SkFaceRec(data->detachStream(), fontID));
+    rec->fOwner = owner;
+    rec->fSharedMemoryBase = sharedMemoryBase;
+    rec->fIndex = data->getIndex();
 
     FT_Open_Args args;
     memset(&args, 0, sizeof(args));
@@ -417,17 +473,25 @@ extern /*static*/ void unref_ft_face(SkFaceRec* faceRec) {
 class AutoFTAccess {
 public:
     AutoFTAccess(const SkTypeface* tf) : fFaceRec(nullptr) {
-        gFTMutex.acquire();
-        SkASSERT_RELEASE(ref_ft_library());
-        fFaceRec = ref_ft_face(tf);
+        {
+            SkAutoMutexAcquire ac(gFTMutex);
+            SkASSERT_RELEASE(ref_ft_library());
+            fFaceRec = ref_ft_face(tf, kIllegalThreadID);
+        }
+        if (fFaceRec) {
+            fFaceRec->fMutex.acquire();
+        }
     }
 
     ~AutoFTAccess() {
+        if (fFaceRec) {
+            fFaceRec->fMutex.release();
+        }
+        SkAutoMutexAcquire ac(gFTMutex);
         if (fFaceRec) {
             unref_ft_face(fFaceRec);
         }
         unref_ft_library();
-        gFTMutex.release();
     }
 
     FT_Face face() { return fFaceRec ? fFaceRec->fFace.get() : nullptr; }
@@ -463,6 +527,7 @@ protected:
     bool generatePath(SkGlyphID glyphID, SkPath* path) override;
     void generateFontMetrics(SkPaint::FontMetrics*) override;
     SkUnichar generateGlyphToChar(uint16_t glyph) override;
+    void generateBatch(const std::function<void()>& fn) override;
 
 private:
     using UnrefFTFace = SkFunctionWrapper<void, SkFaceRec, unref_ft_face>;
@@ -486,13 +551,20 @@ private:
     bool      fDoLinearMetrics;
     bool      fLCDIsVert;
 
+    /** While generateBatch() runs, it holds the face's mutex and has already called setupSize(). */
+    bool      fInBatch;
+    FT_Error  fBatchSetupError;
+
+    /** The mutex to hold while using fFace: the face's, or nullptr if generateBatch() holds it. */
+    SkBaseMutex* ftMutex() { return fInBatch ? nullptr : &fFaceRec->fMutex; }
+
     FT_Error setupSize();
     void getBBoxForCurrentGlyph(SkGlyph* glyph, FT_BBox* bbox,
                                 bool snapToPixelBoundary = false);
     bool getCBoxForLetter(char letter, FT_BBox* bbox);
-    // Caller must lock gFTMutex before calling this function.
+    // Caller must lock the face's mutex before calling this function.
     void updateGlyphIfLCD(SkGlyph* glyph);
-    // Caller must lock gFTMutex before calling this function.
+    // Caller must lock the face's mutex before calling this function.
     // update FreeType2 glyph slot with glyph emboldened
     void emboldenIfNeeded(FT_Face face, FT_GlyphSlot glyph, SkGlyphID gid);
     bool shouldSubpixelBitmap(const SkGlyph&, const SkMatrix&);
@@ -692,6 +764,27 @@ void SkTypeface_FreeType::onFilterRec(SkScalerContextRec* rec) const {
 #endif
 }
 
+bool SkTypeface_FreeType::onGetLinearAdvanceSize(const SkScalerContextRec& rec,
+                                                 SkScalar* size) const {
+    // SkScalerContext_FreeType uses linear metrics for subpixel positioned or unhinted text. Fake
+    // bold and vertical text change the advances, and other than a scale, so would the matrix.
+    if (!(rec.fFlags & SkScalerContext::kSubpixelPositioning_Flag) &&
+        rec.getHinting() != SkPaint::kNo_Hinting) {
+        return false;
+    }
+    if (rec.fFlags & (SkScalerContext::kEmbolden_Flag | SkScalerContext::kVertical_Flag)) {
+        return false;
+    }
+    SkMatrix matrix;
+    rec.getSingleMatrix(&matrix);
+    if (!matrix.isScaleTranslate() || matrix.getScaleX() <= 0 || matrix.getScaleY() <= 0) {
+        return false;
+    }
+    // As FT_Set_Char_Size gets it.
+    *size = SkFDot6ToScalar(SkScalarToFDot6(matrix.getScaleX()));
+    return true;
+}
+
 int SkTypeface_FreeType::onGetUPEM() const {
     AutoFTAccess fta(this);
     FT_Face face = fta.face();
@@ -757,17 +850,21 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
     , fFace(nullptr)
     , fFTSize(nullptr)
     , fStrikeIndex(-1)
+    , fInBatch(false)
+    , fBatchSetupError(0)
 {
-    SkAutoMutexAcquire  ac(gFTMutex);
-    SkASSERT_RELEASE(ref_ft_library());
-
-    fFaceRec.reset(ref_ft_face(this->getTypeface()));
+    {
+        SkAutoMutexAcquire  ac(gFTMutex);
+        SkASSERT_RELEASE(ref_ft_library());
+        fFaceRec.reset(ref_ft_face(this->getTypeface(), SkGetThreadID()));
+    }
 
     // load the font file
     if (nullptr == fFaceRec) {
         SkDEBUGF(("Could not create FT_Face.\n"));
         return;
     }
+    SkAutoMutexAcquire faceLock(fFaceRec->fMutex);
 
     fRec.computeMatrices(SkScalerContextRec::kFull_PreMatrixScale, &fScale, &fMatrix22Scalar);
 
@@ -923,12 +1020,12 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
 }
 
 SkScalerContext_FreeType::~SkScalerContext_FreeType() {
-    SkAutoMutexAcquire  ac(gFTMutex);
-
     if (fFTSize != nullptr) {
+        SkAutoMutexAcquire faceLock(fFaceRec->fMutex);
         FT_Done_Size(fFTSize);
     }
 
+    SkAutoMutexAcquire  ac(gFTMutex);
     fFaceRec = nullptr;
 
     unref_ft_library();
@@ -938,7 +1035,11 @@ SkScalerContext_FreeType::~SkScalerContext_FreeType() {
     this face with other context (at different sizes).
 */
 FT_Error SkScalerContext_FreeType::setupSize() {
-    gFTMutex.assertHeld();
+    fFaceRec->fMutex.assertHeld();
+    if (fInBatch) {
+        // Nobody else can have touched fFace since generateBatch() set it up.
+        return fBatchSetupError;
+    }
     FT_Error err = FT_Activate_Size(fFTSize);
     if (err != 0) {
         return err;
@@ -947,17 +1048,30 @@ FT_Error SkScalerContext_FreeType::setupSize() {
     return 0;
 }
 
+void SkScalerContext_FreeType::generateBatch(const std::function<void()>& fn) {
+    if (fInBatch) {
+        fn();
+        return;
+    }
+
+    SkAutoMutexAcquire  ac(fFaceRec->fMutex);
+    fBatchSetupError = this->setupSize();
+    fInBatch = true;
+    fn();
+    fInBatch = false;
+}
+
 unsigned SkScalerContext_FreeType::generateGlyphCount() {
     return fFace->num_glyphs;
 }
 
 uint16_t SkScalerContext_FreeType::generateCharToGlyph(SkUnichar uni) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->ftMutex());
     return SkToU16(FT_Get_Char_Index( fFace, uni ));
 }
 
 SkUnichar SkScalerContext_FreeType::generateGlyphToChar(uint16_t glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->ftMutex());
     // iterate through each cmap entry, looking for matching glyph indices
     FT_UInt glyphIndex;
     SkUnichar charCode = FT_Get_First_Char( fFace, &glyphIndex );
@@ -981,7 +1095,7 @@ void SkScalerContext_FreeType::generateAdvance(SkGlyph* glyph) {
     * which are very cheap to compute with some font formats...
     */
     if (fDoLinearMetrics) {
-        SkAutoMutexAcquire  ac(gFTMutex);
+        SkAutoMutexAcquire  ac(this->ftMutex());
 
         if (this->setupSize()) {
             glyph->zeroMetrics();
@@ -1088,7 +1202,7 @@ bool SkScalerContext_FreeType::shouldSubpixelBitmap(const SkGlyph& glyph, const
 }
 
 void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->ftMutex());
 
     FT_Error    err;
 
@@ -1193,7 +1307,7 @@ static void clear_glyph_image(const SkGlyph& glyph) {
 }
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->ftMutex());
 
     if (this->setupSize()) {
         clear_glyph_image(glyph);
@@ -1226,7 +1340,7 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
 bool SkScalerContext_FreeType::generatePath(SkGlyphID glyphID, SkPath* path) {
     SkASSERT(path);
 
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->ftMutex());
 
     if (this->setupSize()) {
         path->reset();
@@ -1266,7 +1380,7 @@ void SkScalerContext_FreeType::generateFontMetrics(SkPaint::FontMetrics* metrics
         return;
     }
 
-    SkAutoMutexAcquire ac(gFTMutex);
+    SkAutoMutexAcquire ac(this->ftMutex());
 
     if (this->setupSize()) {
         sk_bzero(metrics, sizeof(*metrics));
@@ -6,12 +6,14 @@
  */
 
 #include "SkAdvancedTypefaceMetrics.h"
+#include "SkData.h"
 #include "SkDataTable.h"
 #include "SkFixed.h"
 #include "SkFontDescriptor.h"
 #include "SkFontHost_FreeType_common.h"
 #include "SkFontMgr.h"
 #include "SkFontStyle.h"
+#include "SkLRUCache.h"
 #include "SkMakeUnique.h"
 #include "SkMath.h"
 #include "SkMutex.h"
@@ -449,6 +451,30 @@ private:
     typedef SkTypeface_FreeType INHERITED;
 };
 
+SK_DECLARE_STATIC_MUTEX(gMappedFilesMutex);
+
+/** Opens font files through a process wide cache of their mappings, so that a file opened by
+ *  several typefaces, or by one typeface many times, is mapped once. Streams on the same mapping
+ *  also let FreeType share the face it opens from it.
+ */
+static std::unique_ptr<SkStreamAsset> open_font_file(const char path[]) {
+    static constexpr int kMaxMappedFiles = 64;
+    static SkLRUCache<SkString, sk_sp<SkData>>* gMappedFiles =
+            new SkLRUCache<SkString, sk_sp<SkData>>(kMaxMappedFiles);
+
+    const SkString key(path);
+    SkAutoMutexAcquire lock(gMappedFilesMutex);
+    if (sk_sp<SkData>* data = gMappedFiles->find(key)) {
+        return skstd::make_unique<SkMemoryStream>(*data);
+    }
+    if (sk_sp<SkData> data = SkData::MakeFromFileName(path)) {
+        gMappedFiles->insert(key, data);
+        return skstd::make_unique<SkMemoryStream>(std::move(data));
+    }
+    // Not mappable, so read it as a file.
+    return SkStream::MakeFromFile(path);
+}
+
 class SkTypeface_fontconfig : public SkTypeface_FreeType {
 public:
     /** @param pattern takes ownership of the reference. */
@@ -473,7 +499,7 @@ public:
     SkStreamAsset* onOpenStream(int* ttcIndex) const override {
         FCLocker lock;
         *ttcIndex = get_int(fPattern, FC_INDEX, 0);
-        return SkStream::MakeFromFile(get_string(fPattern, FC_FILE)).release();
+        return open_font_file(get_string(fPattern, FC_FILE)).release();
     }
 
     void onFilterRec(SkScalerContextRec* rec) const override {
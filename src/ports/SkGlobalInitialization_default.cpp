@@ -34,6 +34,7 @@
 #include "SkPaintImageFilter.h"
 #include "SkPerlinNoiseShader.h"
 #include "SkPictureImageFilter.h"
+#include "SkRuntimeShader.h"
 #include "SkShaderMaskFilter.h"
 #include "SkTableColorFilter.h"
 #include "SkTileImageFilter.h"
@@ -78,6 +79,7 @@ void SkFlattenable::PrivateInitializer::InitEffects() {
 
     // Shader
     SkPerlinNoiseShader::InitializeFlattenables();
+    SkRuntimeShader::InitializeFlattenables();
     SkGradientShader::InitializeFlattenables();
 
     // PathEffect
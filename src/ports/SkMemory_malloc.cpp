@@ -7,6 +7,8 @@
 
 #include "SkMalloc.h"
 
+#include "SkAllocationCounter.h"
+
 #include <cstdlib>
 
 #define SK_DEBUGFAILF(fmt, ...) \
@@ -52,11 +54,15 @@ void sk_out_of_memory(void) {
 }
 
 void* sk_realloc_throw(void* addr, size_t size) {
-    return throw_on_failure(size, realloc(addr, size));
+    SkAllocationCounter::RecordFree(addr);
+    void* p = throw_on_failure(size, realloc(addr, size));
+    SkAllocationCounter::RecordAlloc(p);
+    return p;
 }
 
 void sk_free(void* p) {
     if (p) {
+        SkAllocationCounter::RecordFree(p);
         free(p);
     }
 }
@@ -68,6 +74,7 @@ void* sk_malloc_flags(size_t size, unsigned flags) {
     } else {
         p = malloc(size);
     }
+    SkAllocationCounter::RecordAlloc(p);
     if (flags & SK_MALLOC_THROW) {
         return throw_on_failure(size, p);
     } else {
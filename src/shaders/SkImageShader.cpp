@@ -432,6 +432,35 @@ bool SkImageShader::onAppendStages(const StageRec& rec) const {
         return append_misc();
     }
 
+    // And another for the same sampling when either axis repeats or mirrors.
+    auto fused_tile_mode = [](TileMode mode) {
+        switch (mode) {
+            case kClamp_TileMode:  return SkJumper_kTileClamp;
+            case kRepeat_TileMode: return SkJumper_kTileRepeat;
+            case kMirror_TileMode: return SkJumper_kTileMirror;
+            default:               return -1;
+        }
+    };
+    if (true
+        && (ct == kRGBA_8888_SkColorType || ct == kBGRA_8888_SkColorType)
+        && quality == kLow_SkFilterQuality
+        && fused_tile_mode(fTileModeX) >= 0
+        && fused_tile_mode(fTileModeY) >= 0
+        && !is_srgb) {
+
+        auto ctx = alloc->make<SkJumper_BilerpTileCtx>();
+        ctx->gather  = *gather;
+        ctx->limit_x = *limit_x;
+        ctx->limit_y = *limit_y;
+        ctx->tile_x  = fused_tile_mode(fTileModeX);
+        ctx->tile_y  = fused_tile_mode(fTileModeY);
+        p->append(SkRasterPipeline::bilerp_tile_8888, ctx);
+        if (ct == kBGRA_8888_SkColorType) {
+            p->append(SkRasterPipeline::swap_rb);
+        }
+        return append_misc();
+    }
+
     SkJumper_SamplerCtx* sampler = nullptr;
     if (quality != kNone_SkFilterQuality) {
         sampler = alloc->make<SkJumper_SamplerCtx>();
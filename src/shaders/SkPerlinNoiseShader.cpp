@@ -8,10 +8,14 @@
 #include "SkPerlinNoiseShader.h"
 
 #include "SkArenaAlloc.h"
+#include "SkCachedData.h"
 #include "SkDither.h"
 #include "SkColorFilter.h"
 #include "SkMakeUnique.h"
+#include "SkNx.h"
+#include "SkPerlinNoiseShaderPriv.h"
 #include "SkReadBuffer.h"
+#include "SkResourceCache.h"
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkUnPreMultiply.h"
@@ -34,6 +38,9 @@ static const int kBlockMask = kBlockSize - 1;
 static const int kPerlinNoise = 4096;
 static const int kRandMaximum = SK_MaxS32; // 2**31 - 1
 
+// 4MB of SkPMColor.
+static const int kMaxCachedTilePixels = 1024 * 1024;
+
 static uint8_t improved_noise_permutations[] = {
     151, 160, 137,  91,  90,  15, 131,  13, 201,  95,  96,  53, 194, 233,   7, 225, 140,  36, 103,
      30,  69, 142,   8,  99,  37, 240,  21,  10,  23, 190,   6, 148, 247, 120, 234,  75,   0,  26,
@@ -335,7 +342,7 @@ public:
 
     SkPerlinNoiseShaderImpl(SkPerlinNoiseShaderImpl::Type type, SkScalar baseFrequencyX,
                       SkScalar baseFrequencyY, int numOctaves, SkScalar seed,
-                      const SkISize* tileSize);
+                      const SkISize* tileSize, bool cacheTiles = false);
 
     class PerlinNoiseShaderContext : public Context {
     public:
@@ -344,7 +351,10 @@ public:
         void shadeSpan(int x, int y, SkPMColor[], int count) override;
 
     private:
+        // These take points in noise space, already mapped by fMatrix and rounded.
         SkPMColor shade(const SkPoint& point, StitchData& stitchData) const;
+        void shade4(const SkPoint& point, SkPMColor result[4]) const;
+        void shadeNoise(const SkPoint& point, SkPMColor result[], int count) const;
         SkScalar calculateTurbulenceValueForPoint(
                                                   int channel,
                                                   StitchData& stitchData, const SkPoint& point) const;
@@ -352,8 +362,10 @@ public:
         SkScalar noise2D(int channel,
                          const StitchData& stitchData, const SkPoint& noiseVector) const;
 
-        SkMatrix     fMatrix;
-        PaintingData fPaintingData;
+        SkMatrix            fMatrix;
+        PaintingData        fPaintingData;
+        // If cached, the colors of the noise points (1, 1) through fPaintingData.fTileSize.
+        sk_sp<SkCachedData> fTile;
 
         typedef Context INHERITED;
     };
@@ -377,6 +389,7 @@ private:
     const SkScalar                  fSeed;
     const SkISize                   fTileSize;
     const bool                      fStitchTiles;
+    const bool                      fCacheTiles;
 
     friend class ::SkPerlinNoiseShader;
 
@@ -409,7 +422,8 @@ SkPerlinNoiseShaderImpl::SkPerlinNoiseShaderImpl(SkPerlinNoiseShaderImpl::Type t
                                                  SkScalar baseFrequencyY,
                                                  int numOctaves,
                                                  SkScalar seed,
-                                                 const SkISize* tileSize)
+                                                 const SkISize* tileSize,
+                                                 bool cacheTiles)
   : fType(type)
   , fBaseFrequencyX(baseFrequencyX)
   , fBaseFrequencyY(baseFrequencyY)
@@ -417,6 +431,7 @@ SkPerlinNoiseShaderImpl::SkPerlinNoiseShaderImpl(SkPerlinNoiseShaderImpl::Type t
   , fSeed(seed)
   , fTileSize(nullptr == tileSize ? SkISize::Make(0, 0) : *tileSize)
   , fStitchTiles(!fTileSize.isEmpty())
+  , fCacheTiles(cacheTiles)
 {
     SkASSERT(numOctaves >= 0 && numOctaves <= kMaxOctaves);
 }
@@ -626,25 +641,203 @@ SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::calculateImprovedNoi
 SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
         const SkPoint& point, StitchData& stitchData) const {
     const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
-    SkPoint newPoint;
-    fMatrix.mapPoints(&newPoint, &point, 1);
-    newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
-    newPoint.fY = SkScalarRoundToScalar(newPoint.fY);
 
     U8CPU rgba[4];
     for (int channel = 3; channel >= 0; --channel) {
         SkScalar value;
         if (perlinNoiseShader.fType == kImprovedNoise_Type) {
-            value = calculateImprovedNoiseValueForPoint(channel, newPoint);
+            value = calculateImprovedNoiseValueForPoint(channel, point);
         }
         else {
-            value = calculateTurbulenceValueForPoint(channel, stitchData, newPoint);
+            value = calculateTurbulenceValueForPoint(channel, stitchData, point);
         }
         rgba[channel] = SkScalarFloorToInt(255 * value);
     }
     return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
 }
 
+// The same as shade() for fractal noise and turbulence, at the four points starting at point and
+// stepping along x, a lane each. Each octave finds the four points' lattice cells once, for all
+// four channels.
+void SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade4(const SkPoint& point,
+                                                                SkPMColor result[4]) const {
+    const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
+    SkASSERT(perlinNoiseShader.fType != kImprovedNoise_Type);
+
+    StitchData stitchData = fPaintingData.fStitchDataInit;
+    Sk4f noiseX = (point.fX + Sk4f(0, 1, 2, 3)) * fPaintingData.fBaseFrequency.fX,
+         noiseY = Sk4f(point.fY * fPaintingData.fBaseFrequency.fY);
+    Sk4f turbulence[4] = { 0, 0, 0, 0 };
+    SkScalar ratio = SK_Scalar1;
+    for (int octave = 0; octave < perlinNoiseShader.fNumOctaves; ++octave) {
+        const Sk4f positionX = noiseX + SkIntToScalar(kPerlinNoise),
+                   positionY = noiseY + SkIntToScalar(kPerlinNoise);
+        const Sk4f fractionX = positionX - positionX.floor(),
+                   fractionY = positionY - positionY.floor();
+
+        // The lattice lookups are gathers, so they stay scalar; see noise2D().
+        int x0[4], y0[4], b00[4], b10[4], b01[4], b11[4];
+        SkNx_cast<int>(positionX.floor()).store(x0);
+        SkNx_cast<int>(positionY.floor()).store(y0);
+        for (int k = 0; k < 4; ++k) {
+            int nextX = x0[k] + 1,
+                nextY = y0[k] + 1;
+            if (perlinNoiseShader.fStitchTiles) {
+                x0[k] = checkNoise(x0[k], stitchData.fWrapX, stitchData.fWidth);
+                y0[k] = checkNoise(y0[k], stitchData.fWrapY, stitchData.fHeight);
+                nextX = checkNoise(nextX, stitchData.fWrapX, stitchData.fWidth);
+                nextY = checkNoise(nextY, stitchData.fWrapY, stitchData.fHeight);
+            }
+            const int i = fPaintingData.fLatticeSelector[x0[k] & kBlockMask];
+            const int j = fPaintingData.fLatticeSelector[nextX & kBlockMask];
+            b00[k] = (i + (y0[k] & kBlockMask)) & kBlockMask;
+            b10[k] = (j + (y0[k] & kBlockMask)) & kBlockMask;
+            b01[k] = (i + (nextY & kBlockMask)) & kBlockMask;
+            b11[k] = (j + (nextY & kBlockMask)) & kBlockMask;
+        }
+
+        const Sk4f sx = fractionX * fractionX * (3.0f - 2.0f * fractionX),
+                   sy = fractionY * fractionY * (3.0f - 2.0f * fractionY);
+        // Pathological inputs make no noise, as in noise2D().
+        const Sk4f minS = Sk4f::Min(sx, sy),
+                   maxS = Sk4f::Max(sx, sy);
+        auto interp = [](const Sk4f& a, const Sk4f& b, const Sk4f& t) { return a + (b - a) * t; };
+
+        for (int channel = 0; channel < 4; ++channel) {
+            const SkPoint* gradient = fPaintingData.fGradient[channel];
+            auto dot = [&](const int cell[4], const Sk4f& fx, const Sk4f& fy) {
+                return Sk4f(gradient[cell[0]].fX, gradient[cell[1]].fX,
+                            gradient[cell[2]].fX, gradient[cell[3]].fX) * fx +
+                       Sk4f(gradient[cell[0]].fY, gradient[cell[1]].fY,
+                            gradient[cell[2]].fY, gradient[cell[3]].fY) * fy;
+            };
+            const Sk4f a = interp(dot(b00, fractionX, fractionY),
+                                  dot(b10, fractionX - 1.0f, fractionY), sx);
+            const Sk4f b = interp(dot(b01, fractionX, fractionY - 1.0f),
+                                  dot(b11, fractionX - 1.0f, fractionY - 1.0f), sx);
+            Sk4f noise = (minS < 0.0f).thenElse(0.0f,
+                         (maxS > 1.0f).thenElse(0.0f, interp(a, b, sy)));
+            if (perlinNoiseShader.fType != kFractalNoise_Type) {
+                noise = noise.abs();
+            }
+            turbulence[channel] = turbulence[channel] + noise / ratio;
+        }
+
+        noiseX = noiseX * 2.0f;
+        noiseY = noiseY * 2.0f;
+        ratio *= 2;
+        if (perlinNoiseShader.fStitchTiles) {
+            stitchData.fWidth  *= 2;
+            stitchData.fWrapX   = stitchData.fWidth + kPerlinNoise;
+            stitchData.fHeight *= 2;
+            stitchData.fWrapY   = stitchData.fHeight + kPerlinNoise;
+        }
+    }
+
+    int rgba[4][4];
+    for (int channel = 0; channel < 4; ++channel) {
+        Sk4f value = turbulence[channel];
+        if (perlinNoiseShader.fType == kFractalNoise_Type) {
+            value = (value + 1.0f) * SK_ScalarHalf;
+        }
+        if (channel == 3) {
+            value = value * (SkIntToScalar(getPaintAlpha()) / 255);
+        }
+        value = Sk4f::Max(Sk4f::Min(value, 1.0f), 0.0f);
+        SkNx_cast<int>((255.0f * value).floor()).store(rgba[channel]);
+    }
+    for (int k = 0; k < 4; ++k) {
+        result[k] = SkPreMultiplyARGB(rgba[3][k], rgba[0][k], rgba[1][k], rgba[2][k]);
+    }
+}
+
+void SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shadeNoise(
+        const SkPoint& point, SkPMColor result[], int count) const {
+    const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
+    int i = 0;
+    if (perlinNoiseShader.fType != kImprovedNoise_Type) {
+        for (; i + 4 <= count; i += 4) {
+            this->shade4(SkPoint::Make(point.fX + i, point.fY), result + i);
+        }
+    }
+    StitchData stitchData;
+    for (; i < count; ++i) {
+        result[i] = this->shade(SkPoint::Make(point.fX + i, point.fY), stitchData);
+    }
+}
+
+namespace {
+static unsigned gPerlinNoiseTileKeyNamespaceLabel;
+
+// Everything the colors of a stitched tile depend on: the shader's parameters, with the
+// frequencies and tile size as the matrix and stitching adjusted them, and the paint's alpha.
+struct PerlinNoiseTileKey : public SkResourceCache::Key {
+public:
+    PerlinNoiseTileKey(int type, int numOctaves, SkScalar seed, const SkVector& baseFrequency,
+                       const SkISize& tileSize, U8CPU alpha)
+        : fType(type)
+        , fNumOctaves(numOctaves)
+        , fSeed(seed)
+        , fBaseFrequency(baseFrequency)
+        , fTileSize(tileSize)
+        , fAlpha(alpha)
+    {
+        this->init(&gPerlinNoiseTileKeyNamespaceLabel, 0,
+                   sizeof(fType) + sizeof(fNumOctaves) + sizeof(fSeed) + sizeof(fBaseFrequency) +
+                   sizeof(fTileSize) + sizeof(fAlpha));
+    }
+
+    int32_t  fType;
+    int32_t  fNumOctaves;
+    SkScalar fSeed;
+    SkVector fBaseFrequency;
+    SkISize  fTileSize;
+    uint32_t fAlpha;
+};
+
+struct PerlinNoiseTileRec : public SkResourceCache::Rec {
+    PerlinNoiseTileRec(const PerlinNoiseTileKey& key, SkCachedData* data, int numOctaves)
+        : fKey(key)
+        , fData(data)
+        , fNumOctaves(numOctaves) {
+        fData->attachToCacheAndRef();
+    }
+    ~PerlinNoiseTileRec() override {
+        fData->detachFromCacheAndUnref();
+    }
+
+    PerlinNoiseTileKey fKey;
+    SkCachedData*      fData;
+    int                fNumOctaves;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+    // Each byte is a channel of noise, summed over the octaves.
+    size_t regenerationCost() const override {
+        return SkTMax(fNumOctaves, 1) * fData->size();
+    }
+    bool canBeFoundConcurrently() const override { return true; }
+    const char* getCategory() const override { return "perlin-noise-tile"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PerlinNoiseTileRec& rec = static_cast<const PerlinNoiseTileRec&>(baseRec);
+        SkCachedData** result = static_cast<SkCachedData**>(contextData);
+
+        SkCachedData* tmpData = rec.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = tmpData;
+        return true;
+    }
+};
+} // namespace
+
 SkShaderBase::Context* SkPerlinNoiseShaderImpl::onMakeContext(const ContextRec& rec,
                                                            SkArenaAlloc* alloc) const {
     return alloc->make<PerlinNoiseShaderContext>(*this, rec);
@@ -671,16 +864,54 @@ SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
     // (as opposed to 0 based, usually). The same adjustment is in the setData() function.
     fMatrix.setTranslate(-fMatrix.getTranslateX() + SK_Scalar1,
                          -fMatrix.getTranslateY() + SK_Scalar1);
+
+    // A stitched tile is all that should be drawn of the noise, and it doesn't move with the
+    // matrix's translate, so it can be rendered once and copied after.
+    const SkISize& tileSize = fPaintingData.fTileSize;
+    if (shader.fCacheTiles && shader.fStitchTiles &&
+        tileSize.width() > 0 && tileSize.height() > 0 &&
+        (int64_t)tileSize.width() * tileSize.height() <= kMaxCachedTilePixels) {
+        PerlinNoiseTileKey key(shader.fType, shader.fNumOctaves, shader.fSeed,
+                               fPaintingData.fBaseFrequency, tileSize, this->getPaintAlpha());
+        SkCachedData* data = nullptr;
+        if (!SkResourceCache::Find(key, PerlinNoiseTileRec::Visitor, &data)) {
+            data = SkResourceCache::NewCachedData(tileSize.width() * tileSize.height() *
+                                                  sizeof(SkPMColor));
+            if (data) {
+                SkPMColor* row = static_cast<SkPMColor*>(data->writable_data());
+                for (int y = 1; y <= tileSize.height(); ++y) {
+                    this->shadeNoise(SkPoint::Make(1, SkIntToScalar(y)), row, tileSize.width());
+                    row += tileSize.width();
+                }
+                SkResourceCache::Add(new PerlinNoiseTileRec(key, data, shader.fNumOctaves));
+            }
+        }
+        fTile.reset(data);
+    }
 }
 
 void SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shadeSpan(
         int x, int y, SkPMColor result[], int count) {
     SkPoint point = SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y));
-    StitchData stitchData;
-    for (int i = 0; i < count; ++i) {
-        result[i] = shade(point, stitchData);
-        point.fX += SK_Scalar1;
+    fMatrix.mapPoints(&point, 1);
+    point.set(SkScalarRoundToScalar(point.fX), SkScalarRoundToScalar(point.fY));
+
+    if (fTile) {
+        const SkISize& tileSize = fPaintingData.fTileSize;
+        const int tileX = SkScalarFloorToInt(point.fX) - 1,
+                  tileY = SkScalarFloorToInt(point.fY) - 1;
+        if (0 <= tileY && tileY < tileSize.height()) {
+            const int begin = SkTPin(-tileX, 0, count),
+                      end   = SkTPin(tileSize.width() - tileX, begin, count);
+            const SkPMColor* row = static_cast<const SkPMColor*>(fTile->data()) +
+                                   tileY * tileSize.width() + tileX;
+            this->shadeNoise(point, result, begin);
+            memcpy(result + begin, row + begin, (end - begin) * sizeof(SkPMColor));
+            this->shadeNoise(SkPoint::Make(point.fX + end, point.fY), result + end, count - end);
+            return;
+        }
     }
+    this->shadeNoise(point, result, count);
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -1533,6 +1764,26 @@ sk_sp<SkShader> SkPerlinNoiseShader::MakeImprovedNoise(SkScalar baseFrequencyX,
                                                  nullptr));
 }
 
+sk_sp<SkShader> SkPerlinNoiseShaderPriv::MakeFractalNoiseCachingTiles(SkScalar baseFrequencyX,
+                                                                      SkScalar baseFrequencyY,
+                                                                      int numOctaves,
+                                                                      SkScalar seed,
+                                                                      const SkISize* tileSize) {
+    return sk_sp<SkShader>(new SkPerlinNoiseShaderImpl(SkPerlinNoiseShaderImpl::kFractalNoise_Type,
+                                                       baseFrequencyX, baseFrequencyY, numOctaves,
+                                                       seed, tileSize, true));
+}
+
+sk_sp<SkShader> SkPerlinNoiseShaderPriv::MakeTurbulenceCachingTiles(SkScalar baseFrequencyX,
+                                                                    SkScalar baseFrequencyY,
+                                                                    int numOctaves,
+                                                                    SkScalar seed,
+                                                                    const SkISize* tileSize) {
+    return sk_sp<SkShader>(new SkPerlinNoiseShaderImpl(SkPerlinNoiseShaderImpl::kTurbulence_Type,
+                                                       baseFrequencyX, baseFrequencyY, numOctaves,
+                                                       seed, tileSize, true));
+}
+
 SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_START(SkPerlinNoiseShader)
     SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkPerlinNoiseShaderImpl)
 SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_END
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPerlinNoiseShaderPriv_DEFINED
+#define SkPerlinNoiseShaderPriv_DEFINED
+
+#include "SkRefCnt.h"
+#include "SkScalar.h"
+#include "SkSize.h"
+
+class SkShader;
+
+class SkPerlinNoiseShaderPriv {
+public:
+    // Like SkPerlinNoiseShader::MakeFractalNoise() and MakeTurbulence(), but when stitching tiles
+    // the raster shader keeps its rendered tile in the SkResourceCache, keyed by the shader's
+    // parameters, and redraws of it copy the tile rather than evaluate the noise again. Tiles
+    // larger than a few megabytes are never cached. Caching isn't serialized.
+    static sk_sp<SkShader> MakeFractalNoiseCachingTiles(SkScalar baseFrequencyX,
+                                                        SkScalar baseFrequencyY, int numOctaves,
+                                                        SkScalar seed, const SkISize* tileSize);
+    static sk_sp<SkShader> MakeTurbulenceCachingTiles(SkScalar baseFrequencyX,
+                                                      SkScalar baseFrequencyY, int numOctaves,
+                                                      SkScalar seed, const SkISize* tileSize);
+};
+
+#endif
@@ -12,13 +12,16 @@
 #include "SkBitmapProcShader.h"
 #include "SkCanvas.h"
 #include "SkColorSpaceXformCanvas.h"
+#include "SkExecutor.h"
 #include "SkImage.h"
+#include "SkImage_Base.h"
 #include "SkImageShader.h"
 #include "SkMatrixUtils.h"
 #include "SkPicture.h"
 #include "SkPictureImageGenerator.h"
 #include "SkReadBuffer.h"
 #include "SkResourceCache.h"
+#include "SkTSort.h"
 
 #if SK_SUPPORT_GPU
 #include "GrCaps.h"
@@ -91,6 +94,7 @@ struct BitmapShaderRec : public SkResourceCache::Rec {
         // Just the record overhead -- the actual pixels are accounted by SkImageCacherator.
         return sizeof(fKey) + sizeof(SkImageShader);
     }
+    bool canBeFoundConcurrently() const override { return true; }
     const char* getCategory() const override { return "bitmap-shader"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
 
@@ -106,6 +110,27 @@ struct BitmapShaderRec : public SkResourceCache::Rec {
     }
 };
 
+// With an executor, tile scales are rounded up to the next of this many steps per octave. Zooms
+// within a step reuse the tile, downscaled by less than 16%.
+static constexpr SkScalar kScaleBucketsPerOctave = 4;
+
+SkScalar bucket_scale(SkScalar scale) {
+    if (!(scale > 0)) {
+        return scale;
+    }
+    SkScalar steps = SkScalarCeilToScalar(SkScalarLog2(scale) * kScaleBucketsPerOctave);
+    return SkScalarPow(2, steps / kScaleBucketsPerOctave);
+}
+
+// How far apart two tile scales are, in octaves.
+SkScalar scale_distance(const SkSize& a, const SkSize& b) {
+    return SkScalarAbs(SkScalarLog2(a.width() / b.width())) +
+           SkScalarAbs(SkScalarLog2(a.height() / b.height()));
+}
+
+// The most tile scales that a shader remembers to fall back on.
+static constexpr int kMaxTileScales = 8;
+
 static int32_t gNextID = 1;
 uint32_t next_id() {
     int32_t id;
@@ -119,7 +144,7 @@ uint32_t next_id() {
 
 SkPictureShader::SkPictureShader(sk_sp<SkPicture> picture, TileMode tmx, TileMode tmy,
                                  const SkMatrix* localMatrix, const SkRect* tile,
-                                 sk_sp<SkColorSpace> colorSpace)
+                                 sk_sp<SkColorSpace> colorSpace, SkExecutor* executor)
     : INHERITED(localMatrix)
     , fPicture(std::move(picture))
     , fTile(tile ? *tile : fPicture->cullRect())
@@ -127,7 +152,8 @@ SkPictureShader::SkPictureShader(sk_sp<SkPicture> picture, TileMode tmx, TileMod
     , fTmy(tmy)
     , fColorSpace(std::move(colorSpace))
     , fUniqueID(next_id())
-    , fAddedToCache(false) {}
+    , fAddedToCache(false)
+    , fExecutor(executor) {}
 
 SkPictureShader::~SkPictureShader() {
     if (fAddedToCache.load()) {
@@ -136,12 +162,13 @@ SkPictureShader::~SkPictureShader() {
 }
 
 sk_sp<SkShader> SkPictureShader::Make(sk_sp<SkPicture> picture, TileMode tmx, TileMode tmy,
-                                      const SkMatrix* localMatrix, const SkRect* tile) {
+                                      const SkMatrix* localMatrix, const SkRect* tile,
+                                      SkExecutor* executor) {
     if (!picture || picture->cullRect().isEmpty() || (tile && tile->isEmpty())) {
         return SkShader::MakeEmptyShader();
     }
     return sk_sp<SkShader>(new SkPictureShader(std::move(picture), tmx, tmy, localMatrix, tile,
-                                               nullptr));
+                                               nullptr, executor));
 }
 
 sk_sp<SkFlattenable> SkPictureShader::CreateProc(SkReadBuffer& buffer) {
@@ -191,6 +218,9 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
         scale.set(SkScalarSqrt(m.getScaleX() * m.getScaleX() + m.getSkewX() * m.getSkewX()),
                   SkScalarSqrt(m.getScaleY() * m.getScaleY() + m.getSkewY() * m.getSkewY()));
     }
+    if (fExecutor) {
+        scale.set(bucket_scale(SkScalarAbs(scale.x())), bucket_scale(SkScalarAbs(scale.y())));
+    }
     SkSize scaledSize = SkSize::Make(SkScalarAbs(scale.x() * fTile.width()),
                                      SkScalarAbs(scale.y() * fTile.height()));
 
@@ -230,8 +260,7 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
     SkTransferFunctionBehavior blendBehavior = dstColorSpace ? SkTransferFunctionBehavior::kRespect
                                                              : SkTransferFunctionBehavior::kIgnore;
 
-    sk_sp<SkShader> tileShader;
-    BitmapShaderKey key(std::move(keyCS),
+    BitmapShaderKey key(keyCS,
                         fUniqueID,
                         fTile,
                         fTmx,
@@ -239,33 +268,142 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
                         tileScale,
                         blendBehavior);
 
+    sk_sp<SkShader> tileShader;
+    SkSize shaderScale = tileScale;
     if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
-        SkMatrix tileMatrix;
-        tileMatrix.setRectToRect(fTile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
-                                 SkMatrix::kFill_ScaleToFit);
-
-        sk_sp<SkImage> tileImage = SkImage::MakeFromGenerator(
-                SkPictureImageGenerator::Make(tileSize, fPicture, &tileMatrix, nullptr,
-                                              SkImage::BitDepth::kU8, sk_ref_sp(dstColorSpace)));
-        if (!tileImage) {
-            return nullptr;
+        if (fExecutor && this->findNearestTile(keyCS, blendBehavior, tileScale,
+                                               &tileShader, &shaderScale)) {
+            this->rasterizeTileAsync(keyCS, blendBehavior, tileSize, tileScale,
+                                     sk_ref_sp(dstColorSpace));
+        } else {
+            tileShader = this->makeTileShader(tileSize, dstColorSpace);
+            if (!tileShader) {
+                return nullptr;
+            }
+            SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get()));
+            fAddedToCache.store(true);
         }
+    }
+    if (fExecutor) {
+        this->useTileScale(tileScale);
+    }
 
-        if (fColorSpace) {
-            tileImage = tileImage->makeColorSpace(fColorSpace, SkTransferFunctionBehavior::kIgnore);
-        }
+    if (shaderScale.width() != 1 || shaderScale.height() != 1) {
+        localMatrix->writable()->preScale(1 / shaderScale.width(), 1 / shaderScale.height());
+    }
+
+    return tileShader;
+}
 
-        tileShader = tileImage->makeShader(fTmx, fTmy);
+sk_sp<SkShader> SkPictureShader::makeTileShader(const SkISize& tileSize,
+                                                SkColorSpace* dstColorSpace) const {
+    SkMatrix tileMatrix;
+    tileMatrix.setRectToRect(fTile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
+                             SkMatrix::kFill_ScaleToFit);
 
-        SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get()));
-        fAddedToCache.store(true);
+    sk_sp<SkImage> tileImage = SkImage::MakeFromGenerator(
+            SkPictureImageGenerator::Make(tileSize, fPicture, &tileMatrix, nullptr,
+                                          SkImage::BitDepth::kU8, sk_ref_sp(dstColorSpace)));
+    if (!tileImage) {
+        return nullptr;
     }
 
-    if (tileScale.width() != 1 || tileScale.height() != 1) {
-        localMatrix->writable()->preScale(1 / tileScale.width(), 1 / tileScale.height());
+    if (fColorSpace) {
+        tileImage = tileImage->makeColorSpace(fColorSpace, SkTransferFunctionBehavior::kIgnore);
     }
 
-    return tileShader;
+    return tileImage->makeShader(fTmx, fTmy);
+}
+
+// Looks for the cached tile whose scale is nearest to tileScale, among those drawn recently.
+bool SkPictureShader::findNearestTile(const sk_sp<SkColorSpace>& keyCS,
+                                      SkTransferFunctionBehavior blendBehavior,
+                                      const SkSize& tileScale, sk_sp<SkShader>* tileShader,
+                                      SkSize* shaderScale) const {
+    SkTArray<SkSize> scales;
+    {
+        SkAutoMutexAcquire lock(fTileScalesMutex);
+        scales = fTileScales;
+    }
+    if (scales.empty()) {
+        return false;
+    }
+    SkTQSort(scales.begin(), scales.end() - 1, [&](const SkSize& a, const SkSize& b) {
+        return scale_distance(a, tileScale) < scale_distance(b, tileScale);
+    });
+
+    // Tiles at scales that were purged from the cache are skipped.
+    for (const SkSize& scale : scales) {
+        BitmapShaderKey key(keyCS, fUniqueID, fTile, fTmx, fTmy, scale, blendBehavior);
+        if (SkResourceCache::Find(key, BitmapShaderRec::Visitor, tileShader)) {
+            *shaderScale = scale;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Rasterizes the tile at tileScale on the executor, unless that's already under way. Until the
+// tile is cached, draws keep falling back on other scales; the draw after that finds it.
+void SkPictureShader::rasterizeTileAsync(sk_sp<SkColorSpace> keyCS,
+                                         SkTransferFunctionBehavior blendBehavior,
+                                         const SkISize& tileSize, const SkSize& tileScale,
+                                         sk_sp<SkColorSpace> dstColorSpace) const {
+    {
+        SkAutoMutexAcquire lock(fTileScalesMutex);
+        for (const SkSize& scale : fPendingScales) {
+            if (scale == tileScale) {
+                return;
+            }
+        }
+        fPendingScales.push_back(tileScale);
+    }
+
+    // The task keeps the shader alive, so the tile is purged with the rest of its cache entries.
+    sk_sp<const SkPictureShader> self = sk_ref_sp(this);
+    fExecutor->add([self, keyCS, blendBehavior, tileSize, tileScale, dstColorSpace] {
+        sk_sp<SkShader> tileShader = self->makeTileShader(tileSize, dstColorSpace.get());
+        SkImage* tileImage = tileShader ? tileShader->isAImage(nullptr, nullptr) : nullptr;
+
+        // This adds the pixels to SkBitmapCache, where raster draws of the tile will find them.
+        // GPU draws still upload them on the drawing thread.
+        SkBitmap bitmap;
+        if (tileImage && as_IB(tileImage)->getROPixels(&bitmap, dstColorSpace.get(),
+                                                       SkImage::kAllow_CachingHint)) {
+            BitmapShaderKey key(keyCS, self->fUniqueID, self->fTile, self->fTmx, self->fTmy,
+                                tileScale, blendBehavior);
+            SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get()));
+            self->fAddedToCache.store(true);
+        }
+
+        SkAutoMutexAcquire lock(self->fTileScalesMutex);
+        for (int i = 0; i < self->fPendingScales.count(); i++) {
+            if (self->fPendingScales[i] == tileScale) {
+                self->fPendingScales.removeShuffle(i);
+                break;
+            }
+        }
+    });
+}
+
+// Makes tileScale the most recently drawn scale, forgetting the least recent if there are too many.
+void SkPictureShader::useTileScale(const SkSize& tileScale) const {
+    SkAutoMutexAcquire lock(fTileScalesMutex);
+    int i = 0;
+    while (i < fTileScales.count() && !(fTileScales[i] == tileScale)) {
+        i++;
+    }
+    if (i == fTileScales.count()) {
+        if (fTileScales.count() < kMaxTileScales) {
+            fTileScales.push_back(tileScale);
+            return;
+        }
+        i = 0;
+    }
+    for (; i + 1 < fTileScales.count(); i++) {
+        fTileScales[i] = fTileScales[i + 1];
+    }
+    fTileScales.back() = tileScale;
 }
 
 bool SkPictureShader::onAppendStages(const StageRec& rec) const {
@@ -312,7 +450,7 @@ sk_sp<SkShader> SkPictureShader::onMakeColorSpace(SkColorSpaceXformer* xformer)
     }
 
     return sk_sp<SkPictureShader>(new SkPictureShader(fPicture, fTmx, fTmy, &this->getLocalMatrix(),
-                                                      &fTile, std::move(dstCS)));
+                                                      &fTile, std::move(dstCS), fExecutor));
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////
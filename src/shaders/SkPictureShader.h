@@ -9,10 +9,13 @@
 #define SkPictureShader_DEFINED
 
 #include "SkAtomics.h"
+#include "SkMutex.h"
 #include "SkShaderBase.h"
+#include "SkTArray.h"
 
 class SkArenaAlloc;
 class SkBitmap;
+class SkExecutor;
 class SkPicture;
 
 /*
@@ -26,7 +29,7 @@ public:
     ~SkPictureShader() override;
 
     static sk_sp<SkShader> Make(sk_sp<SkPicture>, TileMode, TileMode, const SkMatrix*,
-                                const SkRect*);
+                                const SkRect*, SkExecutor* executor = nullptr);
 
     void toString(SkString* str) const override;
     SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkPictureShader)
@@ -44,11 +47,19 @@ protected:
 
 private:
     SkPictureShader(sk_sp<SkPicture>, TileMode, TileMode, const SkMatrix*, const SkRect*,
-                    sk_sp<SkColorSpace>);
+                    sk_sp<SkColorSpace>, SkExecutor*);
 
     sk_sp<SkShader> refBitmapShader(const SkMatrix&, SkTCopyOnFirstWrite<SkMatrix>* localMatrix,
                                     SkColorSpace* dstColorSpace,
                                     const int maxTextureSize = 0) const;
+    sk_sp<SkShader> makeTileShader(const SkISize& tileSize, SkColorSpace* dstColorSpace) const;
+    bool findNearestTile(const sk_sp<SkColorSpace>& keyCS, SkTransferFunctionBehavior,
+                         const SkSize& tileScale, sk_sp<SkShader>* tileShader,
+                         SkSize* shaderScale) const;
+    void rasterizeTileAsync(sk_sp<SkColorSpace> keyCS, SkTransferFunctionBehavior,
+                            const SkISize& tileSize, const SkSize& tileScale,
+                            sk_sp<SkColorSpace> dstColorSpace) const;
+    void useTileScale(const SkSize& tileScale) const;
 
     class PictureShaderContext : public Context {
     public:
@@ -77,6 +88,14 @@ private:
     const uint32_t         fUniqueID;
     mutable SkAtomic<bool> fAddedToCache;
 
+    // With an executor, tile scales are rounded up to buckets, and a tile missing from the cache
+    // is rasterized there while draws use the nearest scale that is cached. fTileScales holds the
+    // most recently used bucketed scales, and fPendingScales those being rasterized.
+    SkExecutor*              fExecutor;
+    mutable SkMutex          fTileScalesMutex;
+    mutable SkTArray<SkSize> fTileScales;
+    mutable SkTArray<SkSize> fPendingScales;
+
     typedef SkShaderBase INHERITED;
 };
 
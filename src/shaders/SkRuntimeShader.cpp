@@ -0,0 +1,256 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRuntimeShader.h"
+
+#if SK_SUPPORT_GPU
+
+#include "SkArenaAlloc.h"
+#include "SkJumper.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
+#include "SkRasterPipeline.h"
+#include "SkReadBuffer.h"
+#include "SkShaderBase.h"
+#include "SkSLCompiler.h"
+#include "SkSLInterpreter.h"
+#include "SkString.h"
+#include "SkWriteBuffer.h"
+
+#ifdef SK_LLVM_AVAILABLE
+#include "SkSLJIT.h"
+#endif
+
+namespace {
+
+// Calls main() with the pipeline's coordinates, and returns its color as a float4, for the JIT.
+static constexpr char kJITStageSkSL[] =
+    "void sk_runtime_shader_stage(int dx, int dy, inout float4 color) {"
+    "    float r = 0.0, g = 0.0, b = 0.0, a = 0.0;"
+    "    main(color.r, color.g, r, g, b, a);"
+    "    color = float4(r, g, b, a);"
+    "}";
+
+// The compiled form of an SkSL program, shared by the shaders made from it.
+class RuntimeProgram : public SkNVRefCnt<RuntimeProgram> {
+public:
+    static sk_sp<RuntimeProgram> Make(const SkString& sksl) {
+        sk_sp<RuntimeProgram> program(new RuntimeProgram);
+        SkSL::Program::Settings settings;
+        program->fProgram = program->fCompiler.convertProgram(SkSL::Program::kCPU_Kind,
+                                                              SkSL::String(sksl.c_str()),
+                                                              settings);
+        if (!program->fProgram) {
+            SkDebugf("%s\n", program->fCompiler.errorText().c_str());
+            return nullptr;
+        }
+        std::vector<SkSL::Interpreter::Value> stack;
+        program->fMain = SkSL::Interpreter(*program->fProgram, &stack).findFunction("main");
+        if (!program->fMain || !HasMainSignature(*program->fMain)) {
+            SkDebugf("SkRuntimeShader: main() is missing, or has the wrong signature\n");
+            return nullptr;
+        }
+
+    #ifdef SK_LLVM_AVAILABLE
+        SkString jitSkSL(sksl);
+        jitSkSL.append(kJITStageSkSL);
+        std::unique_ptr<SkSL::Program> jitProgram =
+                program->fJITCompiler.convertProgram(SkSL::Program::kCPU_Kind,
+                                                     SkSL::String(jitSkSL.c_str()), settings);
+        if (jitProgram) {
+            program->fJIT.reset(new SkSL::JIT(&program->fJITCompiler));
+            program->fModule = program->fJIT->compile(std::move(jitProgram));
+            if (program->fModule) {
+                program->fStage = program->fModule->getJumperStage("sk_runtime_shader_stage");
+            }
+        }
+        if (program->fStage) {
+            return program;
+        }
+    #endif
+
+        if (!SkSL::Interpreter::CanRun(*program->fMain)) {
+            SkDebugf("SkRuntimeShader: main() can't be interpreted\n");
+            return nullptr;
+        }
+        return program;
+    }
+
+    bool appendStages(SkRasterPipeline* p, SkArenaAlloc* alloc) const {
+    #ifdef SK_LLVM_AVAILABLE
+        if (fStage) {
+            p->append(fStage, nullptr);
+            return true;
+        }
+    #endif
+
+        struct InterpreterCtx : public SkJumper_CallbackCtx {
+            sk_sp<const RuntimeProgram>           fProgram;
+            std::vector<SkSL::Interpreter::Value> fStack;
+            SkSL::Interpreter*                    fInterpreter;
+        };
+        auto ctx = alloc->make<InterpreterCtx>();
+        ctx->fProgram = sk_ref_sp(this);
+        ctx->fInterpreter = alloc->make<SkSL::Interpreter>(*fProgram, &ctx->fStack);
+        ctx->fn = [](SkJumper_CallbackCtx* self, int active_pixels) {
+            static_assert(SkJumper_kMaxStride <= SkSL::Interpreter::kLanes, "");
+            auto ctx = (InterpreterCtx*)self;
+            SkSL::Interpreter* interpreter = ctx->fInterpreter;
+            // main() runs once over all the pixels, each in a lane of its parameters.
+            SkSL::Interpreter::Lanes x, y, zero;  // Lanes start at 0.
+            for (int i = 0; i < active_pixels; ++i) {
+                x.fValues[i] = ctx->rgba[4 * i + 0];
+                y.fValues[i] = ctx->rgba[4 * i + 1];
+            }
+            interpreter->pushLanes(x);
+            interpreter->pushLanes(y);
+            for (int c = 0; c < 4; ++c) {
+                interpreter->pushLanes(zero);
+            }
+            interpreter->runLanes(*ctx->fProgram->fMain, active_pixels);
+            for (int c = 3; c >= 0; --c) {
+                SkSL::Interpreter::Lanes channel = interpreter->popLanes();
+                for (int i = 0; i < active_pixels; ++i) {
+                    ctx->rgba[4 * i + c] = channel.fValues[i].fFloat;
+                }
+            }
+            interpreter->popLanes();
+            interpreter->popLanes();
+        };
+        p->append(SkRasterPipeline::callback, ctx);
+        return true;
+    }
+
+private:
+    RuntimeProgram() = default;
+
+    // void main(float x, float y, inout float r, inout float g, inout float b, inout float a)
+    static bool HasMainSignature(const SkSL::FunctionDefinition& main) {
+        const auto& params = main.fDeclaration.fParameters;
+        if (6 != params.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < params.size(); ++i) {
+            const bool out = SkToBool(params[i]->fModifiers.fFlags & SkSL::Modifiers::kOut_Flag);
+            if (!(params[i]->fType.fName == "float") || out != (i >= 2)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    SkSL::Compiler                  fCompiler;
+    std::unique_ptr<SkSL::Program>  fProgram;
+    const SkSL::FunctionDefinition* fMain = nullptr;
+
+#ifdef SK_LLVM_AVAILABLE
+    // The module must be destroyed before its JIT, and the JIT before its compiler.
+    SkSL::Compiler                     fJITCompiler;
+    std::unique_ptr<SkSL::JIT>         fJIT;
+    std::unique_ptr<SkSL::JIT::Module> fModule;
+    void*                              fStage = nullptr;
+#endif
+};
+
+SK_DECLARE_STATIC_MUTEX(gRuntimeProgramCacheMutex);
+
+// Finds the compiled program in the cache, keyed by a hash of its SkSL, or compiles it.
+static sk_sp<RuntimeProgram> find_or_compile(const SkString& sksl) {
+    static constexpr int kMaxCachedPrograms = 32;
+    static SkLRUCache<SkString, sk_sp<RuntimeProgram>>* gCache;
+
+    SkAutoMutexAcquire ama(gRuntimeProgramCacheMutex);
+    if (!gCache) {
+        gCache = new SkLRUCache<SkString, sk_sp<RuntimeProgram>>(kMaxCachedPrograms);
+    }
+    if (sk_sp<RuntimeProgram>* program = gCache->find(sksl)) {
+        return *program;
+    }
+    sk_sp<RuntimeProgram> program = RuntimeProgram::Make(sksl);
+    if (program) {
+        gCache->insert(sksl, program);
+    }
+    return program;
+}
+
+}  // namespace
+
+class SkRuntimeShaderImpl : public SkShaderBase {
+public:
+    SkRuntimeShaderImpl(SkString sksl, sk_sp<RuntimeProgram> program)
+        : fSkSL(std::move(sksl))
+        , fProgram(std::move(program)) {}
+
+    void toString(SkString* str) const override {
+        str->append("SkRuntimeShader: (");
+        this->INHERITED::toString(str);
+        str->append(")");
+    }
+
+    SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkRuntimeShaderImpl)
+
+protected:
+    void flatten(SkWriteBuffer& buffer) const override {
+        buffer.writeString(fSkSL.c_str());
+    }
+
+    bool onAppendStages(const StageRec& rec) const override {
+        SkMatrix matrix;
+        if (!this->computeTotalInverse(rec.fCTM, rec.fLocalM, &matrix)) {
+            return false;
+        }
+        rec.fPipeline->append(SkRasterPipeline::seed_shader);
+        rec.fPipeline->append_matrix(rec.fAlloc, matrix);
+        if (!fProgram->appendStages(rec.fPipeline, rec.fAlloc)) {
+            return false;
+        }
+        // Keep whatever the program computes a valid premultiplied color.
+        rec.fPipeline->append(SkRasterPipeline::clamp_0);
+        rec.fPipeline->append(SkRasterPipeline::clamp_a);
+        return true;
+    }
+
+private:
+    SkString              fSkSL;
+    sk_sp<RuntimeProgram> fProgram;
+
+    friend class ::SkRuntimeShader;
+
+    typedef SkShaderBase INHERITED;
+};
+
+sk_sp<SkFlattenable> SkRuntimeShaderImpl::CreateProc(SkReadBuffer& buffer) {
+    SkString sksl;
+    buffer.readString(&sksl);
+    return buffer.isValid() ? SkRuntimeShader::Make(sksl.c_str()) : nullptr;
+}
+
+sk_sp<SkShader> SkRuntimeShader::Make(const char* sksl) {
+    if (!sksl) {
+        return nullptr;
+    }
+    SkString source(sksl);
+    sk_sp<RuntimeProgram> program = find_or_compile(source);
+    if (!program) {
+        return nullptr;
+    }
+    return sk_make_sp<SkRuntimeShaderImpl>(std::move(source), std::move(program));
+}
+
+SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_START(SkRuntimeShader)
+    SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkRuntimeShaderImpl)
+SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_END
+
+#else
+
+sk_sp<SkShader> SkRuntimeShader::Make(const char*) {
+    return nullptr;
+}
+
+void SkRuntimeShader::InitializeFlattenables() {}
+
+#endif
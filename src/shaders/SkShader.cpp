@@ -201,11 +201,12 @@ sk_sp<SkShader> SkShader::MakeBitmapShader(const SkBitmap& src, TileMode tmx, Ti
 }
 
 sk_sp<SkShader> SkShader::MakePictureShader(sk_sp<SkPicture> src, TileMode tmx, TileMode tmy,
-                                            const SkMatrix* localMatrix, const SkRect* tile) {
+                                            const SkMatrix* localMatrix, const SkRect* tile,
+                                            SkExecutor* executor) {
     if (localMatrix && !localMatrix->invert(nullptr)) {
         return nullptr;
     }
-    return SkPictureShader::Make(std::move(src), tmx, tmy, localMatrix, tile);
+    return SkPictureShader::Make(std::move(src), tmx, tmy, localMatrix, tile, executor);
 }
 
 void SkShaderBase::toString(SkString* str) const {
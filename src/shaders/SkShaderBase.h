@@ -177,6 +177,7 @@ public:
     struct StageRec {
         SkRasterPipeline*   fPipeline;
         SkArenaAlloc*       fAlloc;
+        SkColorType         fDstColorType;
         SkColorSpace*       fDstCS;         // may be nullptr
         const SkPaint&      fPaint;
         const SkMatrix*     fLocalM;        // may be nullptr
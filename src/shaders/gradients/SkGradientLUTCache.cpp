@@ -0,0 +1,186 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGradientLUTCache.h"
+
+#include "SkArenaAlloc.h"
+#include "SkAutoMalloc.h"
+#include "SkCachedData.h"
+#include "SkJumper.h"
+#include "SkMathPriv.h"
+#include "SkResourceCache.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+// Up to this many stops, searching them is about as fast as sampling a table. The gradient stage
+// also keeps up to 8 stops in registers on AVX2.
+static constexpr int kMaxStopsToSearch = 8;
+
+// Each gap between stops gets about this many samples, within the limits on the table's size.
+// With interpolation between samples, that's exact but for the samples that straddle a stop.
+static constexpr int kSamplesPerStop = 32;
+static constexpr int kMinLUTSize = 256;
+static constexpr int kMaxLUTSize = 4096;
+
+static int lut_size(int stopCount) {
+    return SkTPin(SkNextPow2(stopCount) * kSamplesPerStop, kMinLUTSize, kMaxLUTSize);
+}
+
+// The color for t < 0, the samples, then the last sample again; see SkJumper_GradientLUTCtx.
+static size_t lut_floats_per_channel(int size) {
+    return size + 2;
+}
+
+// Samples the gradient as the gradient stage evaluates it: f*t + b, with the factor and bias of
+// the last stop at or before t.
+static void build_lut(const SkJumper_GradientCtx& grad, int size, float* lut) {
+    const size_t stride = lut_floats_per_channel(size);
+    auto write = [&](int i, size_t stop, float t) {
+        for (int c = 0; c < 4; c++) {
+            lut[c * stride + i] = grad.fs[c][stop] * t + grad.bs[c][stop];
+        }
+    };
+
+    // Stop 0 is the constant color before the first stop.
+    write(0, 0, 0);
+    size_t stop = 0;
+    for (int i = 0; i < size; i++) {
+        float t = i * (1.0f / (size - 1));
+        while (stop + 1 < grad.stopCount && t >= grad.ts[stop + 1]) {
+            stop++;
+        }
+        write(i + 1, stop, t);
+    }
+    for (int c = 0; c < 4; c++) {
+        lut[c * stride + size + 1] = lut[c * stride + size];
+    }
+}
+
+namespace {
+static unsigned gGradientLUTKeyNamespaceLabel;
+
+// The stops' positions, then each channel's factors, then each channel's biases. The key's size
+// depends on the number of stops, so it's laid out in storage of its own.
+class GradientLUTKey {
+public:
+    explicit GradientLUTKey(const SkJumper_GradientCtx& grad)
+        : fStorage(sizeof(SkResourceCache::Key) + DataSize(grad.stopCount)) {
+        auto* key = new (fStorage.get()) SkResourceCache::Key;
+        float* data = reinterpret_cast<float*>(key + 1);
+        // ts[0] isn't searched, so it isn't part of the key.
+        memcpy(data, grad.ts + 1, (grad.stopCount - 1) * sizeof(float));
+        data += grad.stopCount - 1;
+        for (int c = 0; c < 4; c++) {
+            memcpy(data, grad.fs[c], grad.stopCount * sizeof(float));
+            data += grad.stopCount;
+            memcpy(data, grad.bs[c], grad.stopCount * sizeof(float));
+            data += grad.stopCount;
+        }
+        key->init(&gGradientLUTKeyNamespaceLabel, 0, DataSize(grad.stopCount));
+    }
+
+    const SkResourceCache::Key& get() const {
+        return *static_cast<const SkResourceCache::Key*>(fStorage.get());
+    }
+
+private:
+    static size_t DataSize(size_t stopCount) {
+        return (stopCount - 1 + 8 * stopCount) * sizeof(float);
+    }
+
+    SkAutoMalloc fStorage;
+};
+
+struct GradientLUTRec : public SkResourceCache::Rec {
+    GradientLUTRec(const SkResourceCache::Key& key, SkCachedData* data)
+        : fKeyStorage(key.size())
+        , fData(data) {
+        memcpy(fKeyStorage.get(), &key, key.size());
+        fData->attachToCacheAndRef();
+    }
+    ~GradientLUTRec() override {
+        fData->detachFromCacheAndUnref();
+    }
+
+    SkAutoMalloc  fKeyStorage;
+    SkCachedData* fData;
+
+    const Key& getKey() const override {
+        return *static_cast<const Key*>(fKeyStorage.get());
+    }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + this->getKey().size() + fData->size();
+    }
+    bool canBeFoundConcurrently() const override { return true; }
+    const char* getCategory() const override { return "gradient-lut"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const GradientLUTRec& rec = static_cast<const GradientLUTRec&>(baseRec);
+        SkCachedData** result = static_cast<SkCachedData**>(contextData);
+
+        SkCachedData* tmpData = rec.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = tmpData;
+        return true;
+    }
+};
+} // namespace
+
+bool SkGradientLUTCache::ShouldUseLUT(int stopCount, SkColorType dst) {
+    if (stopCount <= kMaxStopsToSearch) {
+        return false;
+    }
+    switch (dst) {
+        case kAlpha_8_SkColorType:
+        case kRGB_565_SkColorType:
+        case kARGB_4444_SkColorType:
+        case kRGBA_8888_SkColorType:
+        case kRGB_888x_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kGray_8_SkColorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+const SkJumper_GradientLUTCtx* SkGradientLUTCache::Make(const SkJumper_GradientCtx& grad,
+                                                        SkArenaAlloc* alloc,
+                                                        SkResourceCache* localCache) {
+    const int size = lut_size(SkToInt(grad.stopCount));
+    const size_t stride = lut_floats_per_channel(size);
+
+    GradientLUTKey key(grad);
+    SkCachedData* data = nullptr;
+    if (!CHECK_LOCAL(localCache, find, Find, key.get(), GradientLUTRec::Visitor, &data)) {
+        data = CHECK_LOCAL(localCache, newCachedData, NewCachedData,
+                           4 * stride * sizeof(float));
+        if (!data) {
+            return nullptr;
+        }
+        build_lut(grad, size, static_cast<float*>(data->writable_data()));
+        CHECK_LOCAL(localCache, add, Add, new GradientLUTRec(key.get(), data));
+    }
+
+    // The pipeline runs after this returns, so the arena keeps our ref until it's done.
+    alloc->make<sk_sp<SkCachedData>>(data);
+    const float* lut = static_cast<const float*>(data->data());
+    auto* ctx = alloc->make<SkJumper_GradientLUTCtx>();
+    ctx->size = size;
+    for (int c = 0; c < 4; c++) {
+        ctx->rgba[c] = lut + c * stride;
+    }
+    return ctx;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradientLUTCache_DEFINED
+#define SkGradientLUTCache_DEFINED
+
+#include "SkImageInfo.h"
+
+class SkArenaAlloc;
+class SkResourceCache;
+struct SkJumper_GradientCtx;
+struct SkJumper_GradientLUTCtx;
+
+/** \class SkGradientLUTCache
+
+    Keeps the color tables that raster pipeline gradients with many arbitrary stops sample, so
+    that they don't search their stops for every pixel. Tables live in the SkResourceCache, keyed
+    by the stops as the gradient stage searches them: their positions, and their colors already
+    in the destination's color space and premultiplied or not as they are interpolated. The same
+    gradient drawn to a different color space so gets a table of its own.
+
+    A table samples the gradient finely enough for 8-bit destinations, interpolating between its
+    samples, but smooths hard stops over one sample. Higher precision destinations, such as F16,
+    keep searching the stops.
+*/
+class SkGradientLUTCache {
+public:
+    /** Should a gradient of stopCount arbitrary stops, drawn to dst, sample a table? */
+    static bool ShouldUseLUT(int stopCount, SkColorType dst);
+
+    /**
+     *  Returns the context for the gradient_lut stage that samples the gradient ctx describes,
+     *  finding its table in the cache or adding it. alloc keeps a ref to the table for as long
+     *  as the pipeline lives. Returns nullptr if the table can't be made.
+     */
+    static const SkJumper_GradientLUTCtx* Make(const SkJumper_GradientCtx& ctx, SkArenaAlloc* alloc,
+                                               SkResourceCache* localCache = nullptr);
+};
+
+#endif
@@ -11,6 +11,7 @@
 #include "SkColorSpaceXformer.h"
 #include "SkFloatBits.h"
 #include "SkGradientBitmapCache.h"
+#include "SkGradientLUTCache.h"
 #include "SkGradientShaderPriv.h"
 #include "SkHalf.h"
 #include "SkLinearGradient.h"
@@ -388,7 +389,16 @@ bool SkGradientShaderBase::onAppendStages(const StageRec& rec) const {
             add_const_color(ctx, stopCount++, c_l);
 
             ctx->stopCount = stopCount;
-            p->append(SkRasterPipeline::gradient, ctx);
+            // Searching many stops costs more per pixel than sampling a table of them.
+            const SkJumper_GradientLUTCtx* lut = nullptr;
+            if (SkGradientLUTCache::ShouldUseLUT(SkToInt(stopCount), rec.fDstColorType)) {
+                lut = SkGradientLUTCache::Make(*ctx, alloc);
+            }
+            if (lut) {
+                p->append(SkRasterPipeline::gradient_lut, lut);
+            } else {
+                p->append(SkRasterPipeline::gradient, ctx);
+            }
         }
     }
 
@@ -14,17 +14,32 @@
 #include "SkSLIRGenerator.h"
 #include "SkSLMetalCodeGenerator.h"
 #include "SkSLSPIRVCodeGenerator.h"
+#include "ir/SkSLBoolLiteral.h"
+#include "ir/SkSLConstructor.h"
+#include "ir/SkSLDoStatement.h"
 #include "ir/SkSLEnum.h"
 #include "ir/SkSLExpression.h"
 #include "ir/SkSLExpressionStatement.h"
+#include "ir/SkSLFieldAccess.h"
+#include "ir/SkSLFloatLiteral.h"
+#include "ir/SkSLForStatement.h"
 #include "ir/SkSLFunctionCall.h"
+#include "ir/SkSLIfStatement.h"
+#include "ir/SkSLIndexExpression.h"
 #include "ir/SkSLIntLiteral.h"
 #include "ir/SkSLModifiersDeclaration.h"
 #include "ir/SkSLNop.h"
+#include "ir/SkSLPostfixExpression.h"
+#include "ir/SkSLPrefixExpression.h"
+#include "ir/SkSLReturnStatement.h"
+#include "ir/SkSLSwitchStatement.h"
+#include "ir/SkSLSwizzle.h"
 #include "ir/SkSLSymbolTable.h"
 #include "ir/SkSLTernaryExpression.h"
 #include "ir/SkSLUnresolvedFunction.h"
 #include "ir/SkSLVarDeclarations.h"
+#include "ir/SkSLVarDeclarationsStatement.h"
+#include "ir/SkSLWhileStatement.h"
 
 #ifdef SK_ENABLE_SPIRV_VALIDATION
 #include "spirv-tools/libspirv.hpp"
@@ -61,13 +76,55 @@ static const char* SKSL_CPU_INCLUDE =
 
 namespace SkSL {
 
-Compiler::Compiler(Flags flags)
-: fFlags(flags)
-, fContext(new Context())
+/**
+ * The types, symbols and IR of the built-in modules (sksl.inc, sksl_vert.inc, sksl_frag.inc and
+ * sksl_geom.inc). They are built once per process, and shared by every Compiler. Once built
+ * nothing changes them, so compilers on several threads may use them at once.
+ */
+class Compiler::BuiltinModules : public ErrorReporter {
+public:
+    static BuiltinModules& Get() {
+        static BuiltinModules* modules = new BuiltinModules();
+        return *modules;
+    }
+
+    void error(int offset, String msg) override {
+        fErrorText += "error: " + msg + "\n";
+        fErrorCount++;
+    }
+
+    int errorCount() override {
+        return fErrorCount;
+    }
+
+    std::shared_ptr<Context> fContext;
+    std::shared_ptr<SymbolTable> fTypes;
+    std::shared_ptr<SymbolTable> fSymbolTable;
+    std::vector<std::unique_ptr<ProgramElement>> fVertexInclude;
+    std::shared_ptr<SymbolTable> fVertexSymbolTable;
+    std::vector<std::unique_ptr<ProgramElement>> fFragmentInclude;
+    std::shared_ptr<SymbolTable> fFragmentSymbolTable;
+    std::vector<std::unique_ptr<ProgramElement>> fGeometryInclude;
+    std::shared_ptr<SymbolTable> fGeometrySymbolTable;
+
+private:
+    BuiltinModules();
+
+    std::shared_ptr<SymbolTable> convertModule(IRGenerator* irGenerator,
+                                               const Program::Settings& settings,
+                                               Program::Kind kind, const char* text,
+                                               std::vector<std::unique_ptr<ProgramElement>>* out);
+
+    int fErrorCount;
+    String fErrorText;
+};
+
+Compiler::BuiltinModules::BuiltinModules()
+: fContext(new Context())
 , fErrorCount(0) {
     auto types = std::shared_ptr<SymbolTable>(new SymbolTable(this));
     auto symbols = std::shared_ptr<SymbolTable>(new SymbolTable(types, this));
-    fIRGenerator = new IRGenerator(fContext.get(), symbols, *this);
+    IRGenerator irGenerator(fContext.get(), symbols, *this);
     fTypes = types;
     #define ADD_TYPE(t) types->addWithoutOwnership(fContext->f ## t ## _Type->fName, \
                                                    fContext->f ## t ## _Type.get())
@@ -199,43 +256,60 @@ Compiler::Compiler(Flags flags)
     StringFragment skCapsName("sk_Caps");
     Variable* skCaps = new Variable(-1, Modifiers(), skCapsName,
                                     *fContext->fSkCaps_Type, Variable::kGlobal_Storage);
-    fIRGenerator->fSymbolTable->add(skCapsName, std::unique_ptr<Symbol>(skCaps));
+    symbols->add(skCapsName, std::unique_ptr<Symbol>(skCaps));
 
     StringFragment skArgsName("sk_Args");
     Variable* skArgs = new Variable(-1, Modifiers(), skArgsName,
                                     *fContext->fSkArgs_Type, Variable::kGlobal_Storage);
-    fIRGenerator->fSymbolTable->add(skArgsName, std::unique_ptr<Symbol>(skArgs));
+    symbols->add(skArgsName, std::unique_ptr<Symbol>(skArgs));
 
     std::vector<std::unique_ptr<ProgramElement>> ignored;
-    fIRGenerator->convertProgram(Program::kFragment_Kind, SKSL_INCLUDE, strlen(SKSL_INCLUDE),
-                                 *fTypes, &ignored);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
+    irGenerator.convertProgram(Program::kFragment_Kind, SKSL_INCLUDE, strlen(SKSL_INCLUDE),
+                               *fTypes, &ignored);
+    symbols->markAllFunctionsBuiltin();
+    fSymbolTable = symbols;
+
+    Program::Settings settings;
+    fVertexSymbolTable = this->convertModule(&irGenerator, settings, Program::kFragment_Kind,
+                                             SKSL_VERT_INCLUDE, &fVertexInclude);
+    fFragmentSymbolTable = this->convertModule(&irGenerator, settings, Program::kVertex_Kind,
+                                               SKSL_FRAG_INCLUDE, &fFragmentInclude);
+    fGeometrySymbolTable = this->convertModule(&irGenerator, settings,
+                                               Program::kGeometry_Kind, SKSL_GEOM_INCLUDE,
+                                               &fGeometryInclude);
     if (fErrorCount) {
         printf("Unexpected errors: %s\n", fErrorText.c_str());
     }
     ASSERT(!fErrorCount);
+    symbols->resolveInheritedFunctions();
+    fVertexSymbolTable->resolveInheritedFunctions();
+    fFragmentSymbolTable->resolveInheritedFunctions();
+    fGeometrySymbolTable->resolveInheritedFunctions();
+}
 
-    Program::Settings settings;
-    fIRGenerator->start(&settings, nullptr);
-    fIRGenerator->convertProgram(Program::kFragment_Kind, SKSL_VERT_INCLUDE,
-                                 strlen(SKSL_VERT_INCLUDE), *fTypes, &fVertexInclude);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    fVertexSymbolTable = fIRGenerator->fSymbolTable;
-    fIRGenerator->finish();
-
-    fIRGenerator->start(&settings, nullptr);
-    fIRGenerator->convertProgram(Program::kVertex_Kind, SKSL_FRAG_INCLUDE,
-                                 strlen(SKSL_FRAG_INCLUDE), *fTypes, &fFragmentInclude);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    fFragmentSymbolTable = fIRGenerator->fSymbolTable;
-    fIRGenerator->finish();
+std::shared_ptr<SymbolTable> Compiler::BuiltinModules::convertModule(
+        IRGenerator* irGenerator, const Program::Settings& settings, Program::Kind kind,
+        const char* text, std::vector<std::unique_ptr<ProgramElement>>* out) {
+    irGenerator->start(&settings, nullptr);
+    irGenerator->convertProgram(kind, text, strlen(text), *fTypes, out);
+    irGenerator->fSymbolTable->markAllFunctionsBuiltin();
+    std::shared_ptr<SymbolTable> result = irGenerator->fSymbolTable;
+    irGenerator->finish();
+    return result;
+}
 
-    fIRGenerator->start(&settings, nullptr);
-    fIRGenerator->convertProgram(Program::kGeometry_Kind, SKSL_GEOM_INCLUDE,
-                                 strlen(SKSL_GEOM_INCLUDE), *fTypes, &fGeometryInclude);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    fGeometrySymbolTable = fIRGenerator->fSymbolTable;
-    fIRGenerator->finish();
+Compiler::Compiler(Flags flags)
+: fFlags(flags)
+, fContext(BuiltinModules::Get().fContext)
+, fErrorCount(0) {
+    BuiltinModules& modules = BuiltinModules::Get();
+    fIRGenerator = new IRGenerator(fContext.get(), modules.fSymbolTable, *this);
+    fVertexInclude = &modules.fVertexInclude;
+    fVertexSymbolTable = modules.fVertexSymbolTable;
+    fFragmentInclude = &modules.fFragmentInclude;
+    fFragmentSymbolTable = modules.fFragmentSymbolTable;
+    fGeometryInclude = &modules.fGeometryInclude;
+    fGeometrySymbolTable = modules.fGeometrySymbolTable;
 }
 
 Compiler::~Compiler() {
@@ -1092,6 +1166,399 @@ void Compiler::simplifyStatement(DefinitionMap& definitions,
     }
 }
 
+// Calls visit on each of the expressions directly inside expr, which may replace them.
+template <typename Visitor>
+static void visit_subexpressions(Expression* expr, const Visitor& visit) {
+    switch (expr->fKind) {
+        case Expression::kBinary_Kind:
+            visit(&((BinaryExpression*) expr)->fLeft);
+            visit(&((BinaryExpression*) expr)->fRight);
+            break;
+        case Expression::kConstructor_Kind:
+            for (auto& arg : ((Constructor*) expr)->fArguments) {
+                visit(&arg);
+            }
+            break;
+        case Expression::kFieldAccess_Kind:
+            visit(&((FieldAccess*) expr)->fBase);
+            break;
+        case Expression::kFunctionCall_Kind:
+            for (auto& arg : ((FunctionCall*) expr)->fArguments) {
+                visit(&arg);
+            }
+            break;
+        case Expression::kIndex_Kind:
+            visit(&((IndexExpression*) expr)->fBase);
+            visit(&((IndexExpression*) expr)->fIndex);
+            break;
+        case Expression::kPrefix_Kind:
+            visit(&((PrefixExpression*) expr)->fOperand);
+            break;
+        case Expression::kPostfix_Kind:
+            visit(&((PostfixExpression*) expr)->fOperand);
+            break;
+        case Expression::kSwizzle_Kind:
+            visit(&((Swizzle*) expr)->fBase);
+            break;
+        case Expression::kTernary_Kind:
+            visit(&((TernaryExpression*) expr)->fTest);
+            visit(&((TernaryExpression*) expr)->fIfTrue);
+            visit(&((TernaryExpression*) expr)->fIfFalse);
+            break;
+        default:
+            break;
+    }
+}
+
+// Calls visit on each of the outermost expressions inside stmt, which may replace them.
+template <typename Visitor>
+static void visit_expressions(Statement* stmt, const Visitor& visit) {
+    switch (stmt->fKind) {
+        case Statement::kBlock_Kind:
+            for (auto& s : ((Block*) stmt)->fStatements) {
+                visit_expressions(s.get(), visit);
+            }
+            break;
+        case Statement::kDo_Kind:
+            visit_expressions(((DoStatement*) stmt)->fStatement.get(), visit);
+            visit(&((DoStatement*) stmt)->fTest);
+            break;
+        case Statement::kExpression_Kind:
+            visit(&((ExpressionStatement*) stmt)->fExpression);
+            break;
+        case Statement::kFor_Kind: {
+            ForStatement* f = (ForStatement*) stmt;
+            if (f->fInitializer) {
+                visit_expressions(f->fInitializer.get(), visit);
+            }
+            if (f->fTest) {
+                visit(&f->fTest);
+            }
+            if (f->fNext) {
+                visit(&f->fNext);
+            }
+            visit_expressions(f->fStatement.get(), visit);
+            break;
+        }
+        case Statement::kIf_Kind: {
+            IfStatement* i = (IfStatement*) stmt;
+            visit(&i->fTest);
+            visit_expressions(i->fIfTrue.get(), visit);
+            if (i->fIfFalse) {
+                visit_expressions(i->fIfFalse.get(), visit);
+            }
+            break;
+        }
+        case Statement::kReturn_Kind:
+            if (((ReturnStatement*) stmt)->fExpression) {
+                visit(&((ReturnStatement*) stmt)->fExpression);
+            }
+            break;
+        case Statement::kSwitch_Kind:
+            visit(&((SwitchStatement*) stmt)->fValue);
+            for (auto& c : ((SwitchStatement*) stmt)->fCases) {
+                for (auto& s : c->fStatements) {
+                    visit_expressions(s.get(), visit);
+                }
+            }
+            break;
+        case Statement::kVarDeclaration_Kind:
+            if (((VarDeclaration*) stmt)->fValue) {
+                visit(&((VarDeclaration*) stmt)->fValue);
+            }
+            break;
+        case Statement::kVarDeclarations_Kind:
+            for (auto& decl : ((VarDeclarationsStatement*) stmt)->fDeclaration->fVars) {
+                visit_expressions(decl.get(), visit);
+            }
+            break;
+        case Statement::kWhile_Kind:
+            visit(&((WhileStatement*) stmt)->fTest);
+            visit_expressions(((WhileStatement*) stmt)->fStatement.get(), visit);
+            break;
+        default:
+            break;
+    }
+}
+
+// Returns the index of var among f's parameters, or -1.
+static int parameter_index(const FunctionDeclaration* f, const Variable& var) {
+    if (f) {
+        for (size_t i = 0; i < f->fParameters.size(); i++) {
+            if (f->fParameters[i] == &var) {
+                return (int) i;
+            }
+        }
+    }
+    return -1;
+}
+
+// Counts the nodes of expr, and how often it reads each of f's parameters. Returns false if expr
+// contains anything that clone_expression() can't copy.
+static bool measure_expression(const Expression& expr, const FunctionDeclaration* f,
+                               std::vector<int>* uses, int* size) {
+    ++*size;
+    switch (expr.fKind) {
+        case Expression::kBoolLiteral_Kind:
+        case Expression::kFloatLiteral_Kind:
+        case Expression::kIntLiteral_Kind:
+            return true;
+        case Expression::kVariableReference_Kind: {
+            int index = parameter_index(f, ((const VariableReference&) expr).fVariable);
+            if (index >= 0) {
+                (*uses)[index]++;
+            }
+            return true;
+        }
+        case Expression::kBinary_Kind:
+        case Expression::kConstructor_Kind:
+        case Expression::kFieldAccess_Kind:
+        case Expression::kFunctionCall_Kind:
+        case Expression::kIndex_Kind:
+        case Expression::kPrefix_Kind:
+        case Expression::kPostfix_Kind:
+        case Expression::kSwizzle_Kind:
+        case Expression::kTernary_Kind: {
+            bool result = true;
+            visit_subexpressions((Expression*) &expr, [&](std::unique_ptr<Expression>* e) {
+                result = result && measure_expression(**e, f, uses, size);
+            });
+            return result;
+        }
+        default:
+            return false;
+    }
+}
+
+// Copies expr, which must pass measure_expression(), replacing references to f's parameters with
+// copies of the corresponding arguments.
+static std::unique_ptr<Expression> clone_expression(
+                                        const Context& context, const Expression& expr,
+                                        const FunctionDeclaration* f,
+                                        const std::vector<std::unique_ptr<Expression>>* arguments) {
+    auto clone = [&](const std::unique_ptr<Expression>& e) {
+        return clone_expression(context, *e, f, arguments);
+    };
+    switch (expr.fKind) {
+        case Expression::kBinary_Kind: {
+            const BinaryExpression& b = (const BinaryExpression&) expr;
+            return std::unique_ptr<Expression>(new BinaryExpression(b.fOffset, clone(b.fLeft),
+                                                                    b.fOperator, clone(b.fRight),
+                                                                    b.fType));
+        }
+        case Expression::kBoolLiteral_Kind:
+            return std::unique_ptr<Expression>(new BoolLiteral(context, expr.fOffset,
+                                                               ((const BoolLiteral&) expr).fValue));
+        case Expression::kConstructor_Kind: {
+            std::vector<std::unique_ptr<Expression>> args;
+            for (const auto& arg : ((const Constructor&) expr).fArguments) {
+                args.push_back(clone(arg));
+            }
+            return std::unique_ptr<Expression>(new Constructor(expr.fOffset, expr.fType,
+                                                               std::move(args)));
+        }
+        case Expression::kFieldAccess_Kind: {
+            const FieldAccess& a = (const FieldAccess&) expr;
+            return std::unique_ptr<Expression>(new FieldAccess(clone(a.fBase), a.fFieldIndex,
+                                                               a.fOwnerKind));
+        }
+        case Expression::kFloatLiteral_Kind:
+            return std::unique_ptr<Expression>(new FloatLiteral(context, expr.fOffset,
+                                                                ((const FloatLiteral&) expr).fValue,
+                                                                &expr.fType));
+        case Expression::kFunctionCall_Kind: {
+            const FunctionCall& c = (const FunctionCall&) expr;
+            std::vector<std::unique_ptr<Expression>> args;
+            for (const auto& arg : c.fArguments) {
+                args.push_back(clone(arg));
+            }
+            return std::unique_ptr<Expression>(new FunctionCall(c.fOffset, c.fType, c.fFunction,
+                                                                std::move(args)));
+        }
+        case Expression::kIndex_Kind: {
+            const IndexExpression& i = (const IndexExpression&) expr;
+            return std::unique_ptr<Expression>(new IndexExpression(context, clone(i.fBase),
+                                                                   clone(i.fIndex)));
+        }
+        case Expression::kIntLiteral_Kind:
+            return std::unique_ptr<Expression>(new IntLiteral(context, expr.fOffset,
+                                                              ((const IntLiteral&) expr).fValue,
+                                                              &expr.fType));
+        case Expression::kPrefix_Kind: {
+            const PrefixExpression& p = (const PrefixExpression&) expr;
+            return std::unique_ptr<Expression>(new PrefixExpression(p.fOperator,
+                                                                    clone(p.fOperand)));
+        }
+        case Expression::kPostfix_Kind: {
+            const PostfixExpression& p = (const PostfixExpression&) expr;
+            return std::unique_ptr<Expression>(new PostfixExpression(clone(p.fOperand),
+                                                                     p.fOperator));
+        }
+        case Expression::kSwizzle_Kind: {
+            const Swizzle& s = (const Swizzle&) expr;
+            return std::unique_ptr<Expression>(new Swizzle(context, clone(s.fBase),
+                                                           s.fComponents));
+        }
+        case Expression::kTernary_Kind: {
+            const TernaryExpression& t = (const TernaryExpression&) expr;
+            return std::unique_ptr<Expression>(new TernaryExpression(t.fOffset, clone(t.fTest),
+                                                                     clone(t.fIfTrue),
+                                                                     clone(t.fIfFalse)));
+        }
+        case Expression::kVariableReference_Kind: {
+            const VariableReference& v = (const VariableReference&) expr;
+            int index = parameter_index(f, v.fVariable);
+            if (index >= 0) {
+                return clone_expression(context, *(*arguments)[index], nullptr, nullptr);
+            }
+            return std::unique_ptr<Expression>(new VariableReference(v.fOffset, v.fVariable,
+                                                                     v.fRefKind));
+        }
+        default:
+            ABORT("unsupported expression: %s\n", expr.description().c_str());
+    }
+}
+
+namespace {
+
+// A function whose body is just 'return <fResult>;'.
+struct InlineCandidate {
+    const FunctionDeclaration* fDeclaration;
+    const Expression* fResult;
+    std::vector<int> fUses;
+    int fSize;
+    int fCalls;
+    bool fWasCalled;
+};
+
+} // namespace
+
+void Compiler::inlineFunctions(std::vector<std::unique_ptr<ProgramElement>>* elements) {
+    // Functions this small are always inlined; larger ones only when they're called once, as then
+    // the function goes away and the program doesn't grow.
+    static constexpr int kInlineThreshold = 12;
+    // Stops inlining into the results of inlining, which can't recurse, from getting out of hand.
+    static constexpr int kMaxInlineDepth = 8;
+
+    std::unordered_map<const FunctionDeclaration*, InlineCandidate> candidates;
+    for (const auto& e : *elements) {
+        if (e->fKind != ProgramElement::kFunction_Kind) {
+            continue;
+        }
+        const FunctionDefinition& f = (const FunctionDefinition&) *e;
+        const Block& body = (const Block&) *f.fBody;
+        if (f.fDeclaration.fBuiltin || f.fDeclaration.fName == "main" ||
+            body.fStatements.size() != 1 ||
+            body.fStatements[0]->fKind != Statement::kReturn_Kind ||
+            !((const ReturnStatement&) *body.fStatements[0]).fExpression) {
+            continue;
+        }
+        bool writesParameter = false;
+        for (const Variable* p : f.fDeclaration.fParameters) {
+            writesParameter |= (p->fModifiers.fFlags & Modifiers::kOut_Flag) || p->fWriteCount;
+        }
+        InlineCandidate c;
+        c.fDeclaration = &f.fDeclaration;
+        c.fResult = ((const ReturnStatement&) *body.fStatements[0]).fExpression.get();
+        c.fUses.resize(f.fDeclaration.fParameters.size());
+        c.fSize = 0;
+        c.fCalls = 0;
+        c.fWasCalled = false;
+        if (!writesParameter && measure_expression(*c.fResult, c.fDeclaration, &c.fUses,
+                                                   &c.fSize)) {
+            candidates.insert(std::make_pair(c.fDeclaration, std::move(c)));
+        }
+    }
+    if (candidates.empty()) {
+        return;
+    }
+
+    // Counts the calls to each candidate that are left in the program.
+    auto countCalls = [&]() {
+        for (auto& pair : candidates) {
+            pair.second.fCalls = 0;
+        }
+        std::function<void(std::unique_ptr<Expression>*)> count =
+                [&](std::unique_ptr<Expression>* expr) {
+            if ((*expr)->fKind == Expression::kFunctionCall_Kind) {
+                auto found = candidates.find(&((FunctionCall&) **expr).fFunction);
+                if (found != candidates.end()) {
+                    found->second.fCalls++;
+                }
+            }
+            visit_subexpressions(expr->get(), count);
+        };
+        for (auto& e : *elements) {
+            if (e->fKind == ProgramElement::kFunction_Kind) {
+                visit_expressions(((FunctionDefinition&) *e).fBody.get(), count);
+            }
+        }
+    };
+    countCalls();
+    for (auto& pair : candidates) {
+        pair.second.fWasCalled = pair.second.fCalls > 0;
+    }
+
+    int depth = 0;
+    std::function<void(std::unique_ptr<Expression>*)> inlineCall =
+            [&](std::unique_ptr<Expression>* expr) {
+        visit_subexpressions(expr->get(), inlineCall);
+        if ((*expr)->fKind != Expression::kFunctionCall_Kind || depth >= kMaxInlineDepth) {
+            return;
+        }
+        const FunctionCall& call = (const FunctionCall&) **expr;
+        auto found = candidates.find(&call.fFunction);
+        if (found == candidates.end()) {
+            return;
+        }
+        const InlineCandidate& c = found->second;
+        if (c.fSize > kInlineThreshold && c.fCalls > 1) {
+            return;
+        }
+        // The arguments are copied once for each use of their parameter, so they must be free of
+        // side effects, and must be cheap if they're used more than once.
+        for (size_t i = 0; i < call.fArguments.size(); i++) {
+            const Expression& arg = *call.fArguments[i];
+            std::vector<int> ignored;
+            int size = 0;
+            if (arg.hasSideEffects() || !measure_expression(arg, nullptr, &ignored, &size) ||
+                (c.fUses[i] > 1 && size > 1)) {
+                return;
+            }
+        }
+        *expr = clone_expression(*fContext, *c.fResult, c.fDeclaration, &call.fArguments);
+        depth++;
+        inlineCall(expr);
+        depth--;
+    };
+    for (auto& e : *elements) {
+        if (e->fKind == ProgramElement::kFunction_Kind &&
+            !candidates.count(&((FunctionDefinition&) *e).fDeclaration)) {
+            visit_expressions(((FunctionDefinition&) *e).fBody.get(), inlineCall);
+        }
+    }
+
+    // Candidates that were called, but aren't any more, are removed. Removing one may leave
+    // another uncalled, so this repeats until nothing changes.
+    for (bool removed = true; removed;) {
+        countCalls();
+        removed = false;
+        for (auto iter = elements->begin(); iter != elements->end();) {
+            if ((*iter)->fKind == ProgramElement::kFunction_Kind) {
+                auto found = candidates.find(&((FunctionDefinition&) **iter).fDeclaration);
+                if (found != candidates.end() && found->second.fWasCalled &&
+                    !found->second.fCalls) {
+                    candidates.erase(found);
+                    iter = elements->erase(iter);
+                    removed = true;
+                    continue;
+                }
+            }
+            ++iter;
+        }
+    }
+}
+
 void Compiler::scanCFG(FunctionDefinition& f) {
     CFG cfg = CFGGenerator().getCFG(f);
     this->computeDataFlow(&cfg);
@@ -1210,37 +1677,41 @@ std::unique_ptr<Program> Compiler::convertProgram(Program::Kind kind, String tex
     fErrorCount = 0;
     std::vector<std::unique_ptr<ProgramElement>>* inherited;
     std::vector<std::unique_ptr<ProgramElement>> elements;
+    std::shared_ptr<SymbolTable> builtins;
+    const char* include = nullptr;
     switch (kind) {
         case Program::kVertex_Kind:
-            inherited = &fVertexInclude;
-            fIRGenerator->fSymbolTable = fVertexSymbolTable;
-            fIRGenerator->start(&settings, inherited);
+            inherited = fVertexInclude;
+            builtins = fVertexSymbolTable;
             break;
         case Program::kFragment_Kind:
-            inherited = &fFragmentInclude;
-            fIRGenerator->fSymbolTable = fFragmentSymbolTable;
-            fIRGenerator->start(&settings, inherited);
+            inherited = fFragmentInclude;
+            builtins = fFragmentSymbolTable;
             break;
         case Program::kGeometry_Kind:
-            inherited = &fGeometryInclude;
-            fIRGenerator->fSymbolTable = fGeometrySymbolTable;
-            fIRGenerator->start(&settings, inherited);
+            inherited = fGeometryInclude;
+            builtins = fGeometrySymbolTable;
             break;
         case Program::kFragmentProcessor_Kind:
             inherited = nullptr;
-            fIRGenerator->start(&settings, nullptr);
-            fIRGenerator->convertProgram(kind, SKSL_FP_INCLUDE, strlen(SKSL_FP_INCLUDE), *fTypes,
-                                         &elements);
-            fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
+            builtins = fIRGenerator->fRootSymbolTable;
+            include = SKSL_FP_INCLUDE;
             break;
         case Program::kCPU_Kind:
             inherited = nullptr;
-            fIRGenerator->start(&settings, nullptr);
-            fIRGenerator->convertProgram(kind, SKSL_CPU_INCLUDE, strlen(SKSL_CPU_INCLUDE),
-                                         *fTypes, &elements);
-            fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
+            builtins = fIRGenerator->fRootSymbolTable;
+            include = SKSL_CPU_INCLUDE;
             break;
     }
+    // The types and symbols the program declares go in tables of its own, so that the tables of
+    // the built-in modules, which are shared, are never modified.
+    std::shared_ptr<SymbolTable> types(new SymbolTable(builtins, this));
+    fIRGenerator->fSymbolTable = types;
+    fIRGenerator->start(&settings, inherited);
+    if (include) {
+        fIRGenerator->convertProgram(kind, include, strlen(include), *types, &elements);
+        fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
+    }
     for (auto& element : elements) {
         if (element->fKind == ProgramElement::kEnum_Kind) {
             ((Enum&) *element).fBuiltin = true;
@@ -1248,8 +1719,9 @@ std::unique_ptr<Program> Compiler::convertProgram(Program::Kind kind, String tex
     }
     std::unique_ptr<String> textPtr(new String(std::move(text)));
     fSource = textPtr.get();
-    fIRGenerator->convertProgram(kind, textPtr->c_str(), textPtr->size(), *fTypes, &elements);
+    fIRGenerator->convertProgram(kind, textPtr->c_str(), textPtr->size(), *types, &elements);
     if (!fErrorCount) {
+        this->inlineFunctions(&elements);
         for (auto& element : elements) {
             if (element->fKind == ProgramElement::kFunction_Kind) {
                 this->scanCFG((FunctionDefinition&) *element);
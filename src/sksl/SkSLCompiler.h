@@ -43,6 +43,10 @@ class IRGenerator;
  * produce a Program (a tree of IRNodes), then feeds the Program into a CodeGenerator to produce
  * compiled output.
  *
+ * The built-in modules are parsed and converted once per process, and shared by every Compiler.
+ * A Compiler itself compiles one program at a time, but several compilers may be used at once
+ * from different threads.
+ *
  * See the README for information about SkSL.
  */
 class Compiler : public ErrorReporter {
@@ -98,6 +102,8 @@ public:
     static bool IsAssignment(Token::Kind token);
 
 private:
+    class BuiltinModules;
+
     void addDefinition(const Expression* lvalue, std::unique_ptr<Expression>* expr,
                        DefinitionMap* definitions);
 
@@ -131,16 +137,22 @@ private:
 
     void scanCFG(FunctionDefinition& f);
 
+    /**
+     * Replaces calls to functions that just return an expression with the expression, and removes
+     * the functions that are no longer called.
+     */
+    void inlineFunctions(std::vector<std::unique_ptr<ProgramElement>>* elements);
+
     Position position(int offset);
 
-    std::vector<std::unique_ptr<ProgramElement>> fVertexInclude;
+    // The built-in modules, which are shared by every compiler.
+    std::vector<std::unique_ptr<ProgramElement>>* fVertexInclude;
     std::shared_ptr<SymbolTable> fVertexSymbolTable;
-    std::vector<std::unique_ptr<ProgramElement>> fFragmentInclude;
+    std::vector<std::unique_ptr<ProgramElement>>* fFragmentInclude;
     std::shared_ptr<SymbolTable> fFragmentSymbolTable;
-    std::vector<std::unique_ptr<ProgramElement>> fGeometryInclude;
+    std::vector<std::unique_ptr<ProgramElement>>* fGeometryInclude;
     std::shared_ptr<SymbolTable> fGeometrySymbolTable;
 
-    std::shared_ptr<SymbolTable> fTypes;
     IRGenerator* fIRGenerator;
     int fFlags;
 
@@ -1047,6 +1047,20 @@ void GLSLCodeGenerator::writeTypePrecision(const Type& type) {
     this->write(this->getTypePrecision(type));
 }
 
+// Uniforms and fragment shader inputs that are never read are left out of the GLSL. The GL gives
+// unused uniforms no location, which setting them already tolerates, and vertex shader outputs
+// need not be read.
+static bool is_unread_interface_variable(const Program& program, const Variable& var) {
+    if (var.fReadCount) {
+        return false;
+    }
+    if (var.fModifiers.fFlags & Modifiers::kUniform_Flag) {
+        return true;
+    }
+    return program.fKind == Program::kFragment_Kind &&
+           (var.fModifiers.fFlags & Modifiers::kIn_Flag);
+}
+
 void GLSLCodeGenerator::writeVarDeclarations(const VarDeclarations& decl, bool global) {
     if (!decl.fVars.size()) {
         return;
@@ -1054,6 +1068,9 @@ void GLSLCodeGenerator::writeVarDeclarations(const VarDeclarations& decl, bool g
     bool wroteType = false;
     for (const auto& stmt : decl.fVars) {
         VarDeclaration& var = (VarDeclaration&) *stmt;
+        if (global && is_unread_interface_variable(fProgram, *var.fVar)) {
+            continue;
+        }
         if (wroteType) {
             this->write(", ");
         } else {
@@ -1282,8 +1299,14 @@ void GLSLCodeGenerator::writeProgramElement(const ProgramElement& e) {
                 int builtin = ((VarDeclaration&) *decl.fVars[0]).fVar->fModifiers.fLayout.fBuiltin;
                 if (builtin == -1) {
                     // normal var
-                    this->writeVarDeclarations(decl, true);
-                    this->writeLine();
+                    for (const auto& var : decl.fVars) {
+                        if (!is_unread_interface_variable(fProgram,
+                                                          *((VarDeclaration&) *var).fVar)) {
+                            this->writeVarDeclarations(decl, true);
+                            this->writeLine();
+                            break;
+                        }
+                    }
                 } else if (builtin == SK_FRAGCOLOR_BUILTIN &&
                            fProgram.fSettings.fCaps->mustDeclareFragmentShaderOutput()) {
                     if (fProgram.fSettings.fFragColorIsInOut) {
@@ -314,13 +314,8 @@ std::unique_ptr<VarDeclarations> IRGenerator::convertVarDeclarations(const ASTVa
         if (storage == Variable::kGlobal_Storage && varDecl.fName == "sk_FragColor" &&
             (*fSymbolTable)[varDecl.fName]) {
             // already defined, ignore
-        } else if (storage == Variable::kGlobal_Storage && (*fSymbolTable)[varDecl.fName] &&
-                   (*fSymbolTable)[varDecl.fName]->fKind == Symbol::kVariable_Kind &&
-                   ((Variable*) (*fSymbolTable)[varDecl.fName])->fModifiers.fLayout.fBuiltin >= 0) {
-            // already defined, just update the modifiers
-            Variable* old = (Variable*) (*fSymbolTable)[varDecl.fName];
-            old->fModifiers = var->fModifiers;
         } else {
+            // A redeclared built-in shadows the original, which is shared by every program.
             variables.emplace_back(new VarDeclaration(var.get(), std::move(sizes),
                                                       std::move(value)));
             fSymbolTable->add(varDecl.fName, std::move(var));
@@ -338,10 +333,20 @@ std::unique_ptr<ModifiersDeclaration> IRGenerator::convertModifiersDeclaration(
         fInvocations = modifiers.fLayout.fInvocations;
         if (fSettings->fCaps && !fSettings->fCaps->gsInvocationsSupport()) {
             modifiers.fLayout.fInvocations = -1;
-            Variable* invocationId = (Variable*) (*fSymbolTable)["sk_InvocationID"];
-            ASSERT(invocationId);
-            invocationId->fModifiers.fFlags = 0;
-            invocationId->fModifiers.fLayout.fBuiltin = -1;
+            // sk_InvocationID becomes the loop counter of the invocations, an ordinary global
+            // that shadows the shared built-in.
+            const Variable* builtin = (const Variable*) (*fSymbolTable)["sk_InvocationID"];
+            ASSERT(builtin);
+            Variable* invocationId = new Variable(builtin->fOffset, Modifiers(), builtin->fName,
+                                                  builtin->fType, Variable::kGlobal_Storage);
+            std::vector<std::unique_ptr<VarDeclaration>> vars;
+            vars.emplace_back(new VarDeclaration(invocationId,
+                                                 std::vector<std::unique_ptr<Expression>>(),
+                                                 nullptr));
+            fProgramElements->insert(fProgramElements->begin(),
+                                     std::unique_ptr<ProgramElement>(new VarDeclarations(
+                                             -1, &invocationId->fType, std::move(vars))));
+            fSymbolTable->add(invocationId->fName, std::unique_ptr<Symbol>(invocationId));
             if (modifiers.fLayout.description() == "") {
                 return nullptr;
             }
@@ -29,16 +29,139 @@
 namespace SkSL {
 
 void Interpreter::run() {
-    for (const auto& e : *fProgram) {
+    const FunctionDefinition* f = this->findFunction("appendStages");
+    ASSERT(f);
+    if (f) {
+        this->run(*f);
+    }
+}
+
+const FunctionDefinition* Interpreter::findFunction(const char* name) const {
+    for (const auto& e : fProgram) {
         if (ProgramElement::kFunction_Kind == e.fKind) {
             const FunctionDefinition& f = (const FunctionDefinition&) e;
-            if ("appendStages" == f.fDeclaration.fName) {
-                this->run(f);
-                return;
+            if (name == f.fDeclaration.fName) {
+                return &f;
+            }
+        }
+    }
+    return nullptr;
+}
+
+static bool is_scalar(const Type& type) {
+    return type.fName == "int" || type.fName == "float" || type.fName == "bool";
+}
+
+static bool can_evaluate(const Expression& expr) {
+    if (!is_scalar(expr.fType)) {
+        return false;
+    }
+    switch (expr.fKind) {
+        case Expression::kBinary_Kind: {
+            const BinaryExpression& b = (const BinaryExpression&) expr;
+            switch (b.fOperator) {
+                case Token::EQ:
+                case Token::PLUSEQ:
+                case Token::MINUSEQ:
+                case Token::STAREQ:
+                case Token::SLASHEQ:
+                case Token::BITWISEANDEQ:
+                case Token::BITWISEOREQ:
+                case Token::BITWISEXOREQ:
+                    if (Expression::kVariableReference_Kind != b.fLeft->fKind) {
+                        return false;
+                    }
+                    // fall through
+                case Token::PLUS:
+                case Token::MINUS:
+                case Token::STAR:
+                case Token::SLASH:
+                case Token::BITWISEAND:
+                case Token::BITWISEOR:
+                case Token::BITWISEXOR:
+                case Token::LT:
+                case Token::GT:
+                case Token::LTEQ:
+                case Token::GTEQ:
+                case Token::LOGICALAND:
+                case Token::LOGICALOR:
+                    return can_evaluate(*b.fLeft) && can_evaluate(*b.fRight);
+                default:
+                    return false;
+            }
+        }
+        case Expression::kBoolLiteral_Kind:
+        case Expression::kIntLiteral_Kind:
+        case Expression::kFloatLiteral_Kind:
+            return true;
+        case Expression::kPrefix_Kind: {
+            const PrefixExpression& p = (const PrefixExpression&) expr;
+            return (Token::MINUS == p.fOperator || Token::LOGICALNOT == p.fOperator) &&
+                   can_evaluate(*p.fOperand);
+        }
+        case Expression::kPostfix_Kind: {
+            const PostfixExpression& p = (const PostfixExpression&) expr;
+            return Expression::kVariableReference_Kind == p.fOperand->fKind;
+        }
+        case Expression::kVariableReference_Kind:
+            return Variable::kGlobal_Storage !=
+                   ((const VariableReference&) expr).fVariable.fStorage;
+        case Expression::kTernary_Kind: {
+            const TernaryExpression& t = (const TernaryExpression&) expr;
+            return can_evaluate(*t.fTest) && can_evaluate(*t.fIfTrue) &&
+                   can_evaluate(*t.fIfFalse);
+        }
+        default:
+            return false;
+    }
+}
+
+static bool can_run(const Statement& stmt) {
+    switch (stmt.fKind) {
+        case Statement::kBlock_Kind:
+            for (const auto& s : ((const Block&) stmt).fStatements) {
+                if (!can_run(*s)) {
+                    return false;
+                }
+            }
+            return true;
+        case Statement::kExpression_Kind:
+            return can_evaluate(*((const ExpressionStatement&) stmt).fExpression);
+        case Statement::kFor_Kind: {
+            const ForStatement& f = (const ForStatement&) stmt;
+            return (!f.fInitializer || can_run(*f.fInitializer)) &&
+                   (!f.fTest || can_evaluate(*f.fTest)) &&
+                   (!f.fNext || can_evaluate(*f.fNext)) &&
+                   can_run(*f.fStatement);
+        }
+        case Statement::kIf_Kind: {
+            const IfStatement& i = (const IfStatement&) stmt;
+            return can_evaluate(*i.fTest) && can_run(*i.fIfTrue) &&
+                   (!i.fIfFalse || can_run(*i.fIfFalse));
+        }
+        case Statement::kNop_Kind:
+            return true;
+        case Statement::kVarDeclarations_Kind:
+            for (const auto& decl : ((const VarDeclarationsStatement&) stmt).fDeclaration->fVars) {
+                const Variable* var = ((const VarDeclaration&) *decl).fVar;
+                if (!is_scalar(var->fType) ||
+                    (var->fInitialValue && !can_evaluate(*var->fInitialValue))) {
+                    return false;
+                }
             }
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Interpreter::CanRun(const FunctionDefinition& f) {
+    for (const Variable* param : f.fDeclaration.fParameters) {
+        if (!is_scalar(param->fType)) {
+            return false;
         }
     }
-    ASSERT(false);
+    return can_run(*f.fBody);
 }
 
 static int SizeOf(const Type& type) {
@@ -47,7 +170,8 @@ static int SizeOf(const Type& type) {
 
 void Interpreter::run(const FunctionDefinition& f) {
     fVars.emplace_back();
-    StackIndex current = (StackIndex) fStack.size();
+    const StackIndex locals = (StackIndex) fStack.size();
+    StackIndex current = locals;
     for (int i = f.fDeclaration.fParameters.size() - 1; i >= 0; --i) {
         current -= SizeOf(f.fDeclaration.fParameters[i]->fType);
         fVars.back()[f.fDeclaration.fParameters[i]] = current;
@@ -56,6 +180,9 @@ void Interpreter::run(const FunctionDefinition& f) {
     while (fCurrentIndex.size()) {
         this->runStatement();
     }
+    // Pop the function's locals, so that its parameters are back at the top of the stack.
+    fStack.erase(fStack.begin() + locals, fStack.end());
+    fVars.pop_back();
 }
 
 void Interpreter::push(Value value) {
@@ -232,11 +359,12 @@ static void do_callback(SkJumper_CallbackCtx* raw, int activePixels) {
 }
 
 void Interpreter::appendStage(const AppendStage& a) {
+    ASSERT(fPipeline);
     switch (a.fStage) {
         case SkRasterPipeline::matrix_4x5: {
             ASSERT(a.fArguments.size() == 1);
             StackIndex transpose = evaluate(*a.fArguments[0]).fInt;
-            fPipeline.append(SkRasterPipeline::matrix_4x5, &fStack[transpose]);
+            fPipeline->append(SkRasterPipeline::matrix_4x5, &fStack[transpose]);
             break;
         }
         case SkRasterPipeline::callback: {
@@ -244,7 +372,7 @@ void Interpreter::appendStage(const AppendStage& a) {
             CallbackCtx* ctx = new CallbackCtx();
             ctx->fInterpreter = this;
             ctx->fn = do_callback;
-            for (const auto& e : *fProgram) {
+            for (const auto& e : fProgram) {
                 if (ProgramElement::kFunction_Kind == e.fKind) {
                     const FunctionDefinition& f = (const FunctionDefinition&) e;
                     if (&f.fDeclaration ==
@@ -253,11 +381,11 @@ void Interpreter::appendStage(const AppendStage& a) {
                     }
                 }
             }
-            fPipeline.append(SkRasterPipeline::callback, ctx);
+            fPipeline->append(SkRasterPipeline::callback, ctx);
             break;
         }
         default:
-            fPipeline.append(a.fStage);
+            fPipeline->append(a.fStage);
     }
 }
 
@@ -468,6 +596,323 @@ Interpreter::Value Interpreter::evaluate(const Expression& expr) {
     ABORT("unsupported expression: %s\n", expr.description().c_str());
 }
 
+bool Interpreter::Mask::any() const {
+    bool any = false;
+    for (int i = 0; i < kLanes; ++i) {
+        any |= fLanes[i];
+    }
+    return any;
+}
+
+void Interpreter::pushLanes(const Lanes& lanes) {
+    fLaneStack.push_back(lanes);
+}
+
+Interpreter::Lanes Interpreter::popLanes() {
+    Lanes result = fLaneStack.back();
+    fLaneStack.pop_back();
+    return result;
+}
+
+void Interpreter::runLanes(const FunctionDefinition& f, int count) {
+    ASSERT(count <= kLanes);
+    fVars.emplace_back();
+    const StackIndex locals = (StackIndex) fLaneStack.size();
+    StackIndex current = locals;
+    for (int i = f.fDeclaration.fParameters.size() - 1; i >= 0; --i) {
+        current -= SizeOf(f.fDeclaration.fParameters[i]->fType);
+        fVars.back()[f.fDeclaration.fParameters[i]] = current;
+    }
+    Mask mask;
+    for (int i = 0; i < kLanes; ++i) {
+        mask.fLanes[i] = i < count;
+    }
+    this->runLanes(*f.fBody, mask);
+    fLaneStack.erase(fLaneStack.begin() + locals, fLaneStack.end());
+    fVars.pop_back();
+}
+
+void Interpreter::runLanes(const Statement& stmt, const Mask& mask) {
+    switch (stmt.fKind) {
+        case Statement::kBlock_Kind:
+            for (const auto& s : ((const Block&) stmt).fStatements) {
+                this->runLanes(*s, mask);
+            }
+            break;
+        case Statement::kExpression_Kind:
+            this->evaluateLanes(*((const ExpressionStatement&) stmt).fExpression, mask);
+            break;
+        case Statement::kFor_Kind: {
+            const ForStatement& f = (const ForStatement&) stmt;
+            if (f.fInitializer) {
+                this->runLanes(*f.fInitializer, mask);
+            }
+            // Lanes leave the loop as their test fails, and the loop ends when none are left.
+            Mask loop = mask;
+            for (;;) {
+                if (f.fTest) {
+                    Lanes test = this->evaluateLanes(*f.fTest, loop);
+                    for (int i = 0; i < kLanes; ++i) {
+                        loop.fLanes[i] &= test.fValues[i].fBool;
+                    }
+                }
+                if (!loop.any()) {
+                    break;
+                }
+                this->runLanes(*f.fStatement, loop);
+                if (f.fNext) {
+                    this->evaluateLanes(*f.fNext, loop);
+                }
+            }
+            break;
+        }
+        case Statement::kIf_Kind: {
+            const IfStatement& i = (const IfStatement&) stmt;
+            Lanes test = this->evaluateLanes(*i.fTest, mask);
+            Mask ifTrue, ifFalse;
+            for (int l = 0; l < kLanes; ++l) {
+                ifTrue.fLanes[l]  = mask.fLanes[l] &&  test.fValues[l].fBool;
+                ifFalse.fLanes[l] = mask.fLanes[l] && !test.fValues[l].fBool;
+            }
+            if (ifTrue.any()) {
+                this->runLanes(*i.fIfTrue, ifTrue);
+            }
+            if (i.fIfFalse && ifFalse.any()) {
+                this->runLanes(*i.fIfFalse, ifFalse);
+            }
+            break;
+        }
+        case Statement::kNop_Kind:
+            break;
+        case Statement::kVarDeclarations_Kind:
+            for (const auto& decl :((const VarDeclarationsStatement&) stmt).fDeclaration->fVars) {
+                const Variable* var = ((VarDeclaration&) *decl).fVar;
+                Lanes value;
+                if (var->fInitialValue) {
+                    value = this->evaluateLanes(*var->fInitialValue, mask);
+                }
+                fVars.back()[var] = (StackIndex) fLaneStack.size();
+                fLaneStack.push_back(value);
+            }
+            break;
+        default:
+            ABORT("unsupported statement: %s\n", stmt.description().c_str());
+    }
+}
+
+void Interpreter::storeLanes(const Expression& lvalue, const Lanes& value, const Mask& mask) {
+    ASSERT(Expression::kVariableReference_Kind == lvalue.fKind);
+    ASSERT(fVars.back().find(&((const VariableReference&) lvalue).fVariable) !=
+           fVars.back().end());
+    Lanes& dst = fLaneStack[fVars.back()[&((const VariableReference&) lvalue).fVariable]];
+    for (int i = 0; i < kLanes; ++i) {
+        if (mask.fLanes[i]) {
+            dst.fValues[i] = value.fValues[i];
+        }
+    }
+}
+
+Interpreter::Lanes Interpreter::evaluateLanes(const Expression& expr, const Mask& mask) {
+    Lanes result;
+    switch (expr.fKind) {
+        case Expression::kBinary_Kind: {
+            const BinaryExpression& b = (const BinaryExpression&) expr;
+            #define LANES(type, field, op)                                  \
+                for (int i = 0; i < kLanes; ++i) {                          \
+                    result.fValues[i] = Value((type) (left.fValues[i].field \
+                                                   op right.fValues[i].field)); \
+                }
+            #define LANE_ARITHMETIC(op) {                                   \
+                Lanes left = this->evaluateLanes(*b.fLeft, mask);           \
+                Lanes right = this->evaluateLanes(*b.fRight, mask);         \
+                switch (type_kind(b.fLeft->fType)) {                        \
+                    case kFloat_TypeKind: LANES(float, fFloat, op) break;   \
+                    case kInt_TypeKind:   LANES(int, fInt, op)     break;   \
+                    default: abort();                                       \
+                }                                                           \
+                return result;                                              \
+            }
+            #define LANE_COMPARISON(op) {                                   \
+                Lanes left = this->evaluateLanes(*b.fLeft, mask);           \
+                Lanes right = this->evaluateLanes(*b.fRight, mask);         \
+                switch (type_kind(b.fLeft->fType)) {                        \
+                    case kFloat_TypeKind: LANES(bool, fFloat, op) break;    \
+                    case kInt_TypeKind:   LANES(bool, fInt, op)   break;    \
+                    default: abort();                                       \
+                }                                                           \
+                return result;                                              \
+            }
+            #define LANE_BITWISE(op) {                                      \
+                Lanes left = this->evaluateLanes(*b.fLeft, mask);           \
+                Lanes right = this->evaluateLanes(*b.fRight, mask);         \
+                LANES(int, fInt, op)                                        \
+                return result;                                              \
+            }
+            #define LANE_COMPOUND_ARITHMETIC(op) {                          \
+                Lanes right = this->evaluateLanes(*b.fRight, mask);         \
+                Lanes left = this->evaluateLanes(*b.fLeft, mask);           \
+                switch (type_kind(b.fLeft->fType)) {                        \
+                    case kFloat_TypeKind: LANES(float, fFloat, op) break;   \
+                    case kInt_TypeKind:   LANES(int, fInt, op)     break;   \
+                    default: abort();                                       \
+                }                                                           \
+                this->storeLanes(*b.fLeft, result, mask);                   \
+                return result;                                              \
+            }
+            #define LANE_COMPOUND_BITWISE(op) {                             \
+                Lanes right = this->evaluateLanes(*b.fRight, mask);         \
+                Lanes left = this->evaluateLanes(*b.fLeft, mask);           \
+                LANES(int, fInt, op)                                        \
+                this->storeLanes(*b.fLeft, result, mask);                   \
+                return result;                                              \
+            }
+            // Lanes that are masked off may hold anything, so ints are only divided in active
+            // lanes.
+            #define LANE_DIVIDE(compound) {                                 \
+                Lanes right = this->evaluateLanes(*b.fRight, mask);         \
+                Lanes left = this->evaluateLanes(*b.fLeft, mask);           \
+                if (kFloat_TypeKind == type_kind(b.fLeft->fType)) {         \
+                    LANES(float, fFloat, /)                                 \
+                } else {                                                    \
+                    for (int i = 0; i < kLanes; ++i) {                      \
+                        const int r = right.fValues[i].fInt;                \
+                        result.fValues[i] = Value(mask.fLanes[i] && r       \
+                                                  ? left.fValues[i].fInt / r : 0); \
+                    }                                                       \
+                }                                                           \
+                if (compound) {                                             \
+                    this->storeLanes(*b.fLeft, result, mask);               \
+                }                                                           \
+                return result;                                              \
+            }
+            switch (b.fOperator) {
+                case Token::PLUS:       LANE_ARITHMETIC(+)
+                case Token::MINUS:      LANE_ARITHMETIC(-)
+                case Token::STAR:       LANE_ARITHMETIC(*)
+                case Token::SLASH:      LANE_DIVIDE(false)
+                case Token::BITWISEAND: LANE_BITWISE(&)
+                case Token::BITWISEOR:  LANE_BITWISE(|)
+                case Token::BITWISEXOR: LANE_BITWISE(^)
+                case Token::LT:         LANE_COMPARISON(<)
+                case Token::GT:         LANE_COMPARISON(>)
+                case Token::LTEQ:       LANE_COMPARISON(<=)
+                case Token::GTEQ:       LANE_COMPARISON(>=)
+                case Token::LOGICALAND:
+                case Token::LOGICALOR: {
+                    // The right side only runs on the lanes that the left side doesn't decide.
+                    const bool isAnd = Token::LOGICALAND == b.fOperator;
+                    Lanes left = this->evaluateLanes(*b.fLeft, mask);
+                    Mask rightMask;
+                    for (int i = 0; i < kLanes; ++i) {
+                        rightMask.fLanes[i] = mask.fLanes[i] && left.fValues[i].fBool == isAnd;
+                        result.fValues[i] = Value(left.fValues[i].fBool);
+                    }
+                    if (rightMask.any()) {
+                        Lanes right = this->evaluateLanes(*b.fRight, rightMask);
+                        for (int i = 0; i < kLanes; ++i) {
+                            if (rightMask.fLanes[i]) {
+                                result.fValues[i] = Value(right.fValues[i].fBool);
+                            }
+                        }
+                    }
+                    return result;
+                }
+                case Token::EQ:
+                    result = this->evaluateLanes(*b.fRight, mask);
+                    this->storeLanes(*b.fLeft, result, mask);
+                    return result;
+                case Token::PLUSEQ:       LANE_COMPOUND_ARITHMETIC(+)
+                case Token::MINUSEQ:      LANE_COMPOUND_ARITHMETIC(-)
+                case Token::STAREQ:       LANE_COMPOUND_ARITHMETIC(*)
+                case Token::SLASHEQ:      LANE_DIVIDE(true)
+                case Token::BITWISEANDEQ: LANE_COMPOUND_BITWISE(&)
+                case Token::BITWISEOREQ:  LANE_COMPOUND_BITWISE(|)
+                case Token::BITWISEXOREQ: LANE_COMPOUND_BITWISE(^)
+                default:
+                    ABORT("unsupported operator: %s\n", expr.description().c_str());
+            }
+            #undef LANES
+            #undef LANE_ARITHMETIC
+            #undef LANE_COMPARISON
+            #undef LANE_BITWISE
+            #undef LANE_COMPOUND_ARITHMETIC
+            #undef LANE_COMPOUND_BITWISE
+            #undef LANE_DIVIDE
+        }
+        case Expression::kBoolLiteral_Kind:
+            for (auto& v : result.fValues) {
+                v = Value(((const BoolLiteral&) expr).fValue);
+            }
+            return result;
+        case Expression::kIntLiteral_Kind:
+            for (auto& v : result.fValues) {
+                v = Value((int) ((const IntLiteral&) expr).fValue);
+            }
+            return result;
+        case Expression::kFloatLiteral_Kind:
+            for (auto& v : result.fValues) {
+                v = Value((float) ((const FloatLiteral&) expr).fValue);
+            }
+            return result;
+        case Expression::kPrefix_Kind: {
+            const PrefixExpression& p = (const PrefixExpression&) expr;
+            Lanes base = this->evaluateLanes(*p.fOperand, mask);
+            for (int i = 0; i < kLanes; ++i) {
+                const Value& v = base.fValues[i];
+                if (Token::LOGICALNOT == p.fOperator) {
+                    result.fValues[i] = Value(!v.fBool);
+                } else {
+                    ASSERT(Token::MINUS == p.fOperator);
+                    result.fValues[i] = kFloat_TypeKind == type_kind(p.fType) ? Value(-v.fFloat)
+                                                                              : Value(-v.fInt);
+                }
+            }
+            return result;
+        }
+        case Expression::kPostfix_Kind: {
+            const PostfixExpression& p = (const PostfixExpression&) expr;
+            result = this->evaluateLanes(*p.fOperand, mask);
+            const int delta = Token::PLUSPLUS == p.fOperator ? 1 : -1;
+            Lanes next;
+            for (int i = 0; i < kLanes; ++i) {
+                const Value& v = result.fValues[i];
+                next.fValues[i] = kFloat_TypeKind == type_kind(p.fType) ? Value(v.fFloat + delta)
+                                                                        : Value(v.fInt + delta);
+            }
+            this->storeLanes(*p.fOperand, next, mask);
+            return result;
+        }
+        case Expression::kVariableReference_Kind:
+            ASSERT(fVars.back().find(&((const VariableReference&) expr).fVariable) !=
+                   fVars.back().end());
+            return fLaneStack[fVars.back()[&((const VariableReference&) expr).fVariable]];
+        case Expression::kTernary_Kind: {
+            const TernaryExpression& t = (const TernaryExpression&) expr;
+            Lanes test = this->evaluateLanes(*t.fTest, mask);
+            Mask ifTrue, ifFalse;
+            for (int i = 0; i < kLanes; ++i) {
+                ifTrue.fLanes[i]  = mask.fLanes[i] &&  test.fValues[i].fBool;
+                ifFalse.fLanes[i] = mask.fLanes[i] && !test.fValues[i].fBool;
+            }
+            if (ifTrue.any()) {
+                result = this->evaluateLanes(*t.fIfTrue, ifTrue);
+            }
+            if (ifFalse.any()) {
+                Lanes f = this->evaluateLanes(*t.fIfFalse, ifFalse);
+                for (int i = 0; i < kLanes; ++i) {
+                    if (ifFalse.fLanes[i]) {
+                        result.fValues[i] = f.fValues[i];
+                    }
+                }
+            }
+            return result;
+        }
+        default:
+            break;
+    }
+    ABORT("unsupported expression: %s\n", expr.description().c_str());
+}
+
 } // namespace
 
 #endif
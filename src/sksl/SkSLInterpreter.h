@@ -31,6 +31,9 @@ class Interpreter {
 
 public:
     union Value {
+        Value()
+        : fInt(0) {}
+
         Value(float f)
         : fFloat(f) {}
 
@@ -51,15 +54,63 @@ public:
         kBool_TypeKind
     };
 
+    /**
+     * The number of invocations runLanes() interprets at once.
+     */
+    static constexpr int kLanes = 16;
+
+    /**
+     * A value for each of kLanes invocations.
+     */
+    struct Lanes {
+        Value fValues[kLanes];
+    };
+
     Interpreter(std::unique_ptr<Program> program, SkRasterPipeline* pipeline, std::vector<Value>* stack)
-    : fProgram(std::move(program))
-    , fPipeline(*pipeline)
+    : fOwnedProgram(std::move(program))
+    , fProgram(*fOwnedProgram)
+    , fPipeline(pipeline)
+    , fStack(*stack) {}
+
+    /**
+     * Interprets functions of a program that outlives the interpreter, and that doesn't append
+     * stages. Interpreters may share a program, so long as each has a stack of its own.
+     */
+    Interpreter(const Program& program, std::vector<Value>* stack)
+    : fProgram(program)
+    , fPipeline(nullptr)
     , fStack(*stack) {}
 
     void run();
 
+    /**
+     * Runs f on the parameters at the top of the stack, leaving their final values there.
+     */
     void run(const FunctionDefinition& f);
 
+    /**
+     * Runs f on count <= kLanes invocations at once, on the parameters at the top of the lane
+     * stack, and leaves their final values there. Each node of f is interpreted once for all of
+     * the invocations, masking off those that don't take a branch or have left a loop. f must
+     * pass CanRun().
+     */
+    void runLanes(const FunctionDefinition& f, int count);
+
+    void pushLanes(const Lanes& lanes);
+
+    Lanes popLanes();
+
+    /**
+     * Returns the definition of the named function, or null if the program has none.
+     */
+    const FunctionDefinition* findFunction(const char* name) const;
+
+    /**
+     * Can run(f) interpret f? The interpreter handles scalar int, float and bool code: local
+     * variables, arithmetic, comparisons, and if and for statements. It doesn't call functions.
+     */
+    static bool CanRun(const FunctionDefinition& f);
+
     void push(Value value);
 
     Value pop();
@@ -77,11 +128,25 @@ public:
     Value evaluate(const Expression& expr);
 
 private:
-    std::unique_ptr<Program> fProgram;
-    SkRasterPipeline& fPipeline;
+    struct Mask {
+        bool fLanes[kLanes];
+
+        bool any() const;
+    };
+
+    void runLanes(const Statement& stmt, const Mask& mask);
+
+    Lanes evaluateLanes(const Expression& expr, const Mask& mask);
+
+    void storeLanes(const Expression& lvalue, const Lanes& value, const Mask& mask);
+
+    std::unique_ptr<Program> fOwnedProgram;
+    const Program& fProgram;
+    SkRasterPipeline* fPipeline;
     std::vector<StatementIndex> fCurrentIndex;
     std::vector<std::map<const Variable*, StackIndex>> fVars;
     std::vector<Value> &fStack;
+    std::vector<Lanes> fLaneStack;
 };
 
 } // namespace
@@ -186,7 +186,8 @@ void Parser::error(int offset, String msg) {
 }
 
 bool Parser::isType(StringFragment name) {
-    return nullptr != fTypes[name];
+    const Symbol* symbol = fTypes[name];
+    return symbol && Symbol::kType_Kind == symbol->fKind;
 }
 
 /* DIRECTIVE(#version) INT_LITERAL ("es" | "compatibility")? |
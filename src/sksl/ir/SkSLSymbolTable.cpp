@@ -120,6 +120,14 @@ void SymbolTable::markAllFunctionsBuiltin() {
     }
 }
 
+void SymbolTable::resolveInheritedFunctions() {
+    for (auto& pair : fSymbols) {
+        if (GetFunctions(*pair.second).size() > 0) {
+            pair.second = (*this)[pair.first];
+        }
+    }
+}
+
 std::map<StringFragment, const Symbol*>::iterator SymbolTable::begin() {
     return fSymbols.begin();
 }
@@ -43,6 +43,13 @@ public:
 
     void markAllFunctionsBuiltin();
 
+    /**
+     * Merges each function's overloads with those it inherits from the parent tables, so that
+     * looking functions up no longer changes this table. Tables that are shared between threads
+     * must be resolved once they're complete.
+     */
+    void resolveInheritedFunctions();
+
     std::map<StringFragment, const Symbol*>::iterator begin();
 
     std::map<StringFragment, const Symbol*>::iterator end();
@@ -13,6 +13,8 @@
 #include "SkSLSymbol.h"
 #include "SkSLType.h"
 
+#include <atomic>
+
 namespace SkSL {
 
 struct Expression;
@@ -62,11 +64,12 @@ struct Variable : public Symbol {
     Expression* fInitialValue = nullptr;
 
     // Tracks how many sites read from the variable. If this is zero for a non-out variable (or
-    // becomes zero during optimization), the variable is dead and may be eliminated.
-    mutable int fReadCount;
+    // becomes zero during optimization), the variable is dead and may be eliminated. The counts
+    // are atomic because the built-in variables are referenced by compilers on several threads.
+    mutable std::atomic<int> fReadCount;
     // Tracks how many sites write to the variable. If this is zero, the variable is dead and may be
     // eliminated.
-    mutable int fWriteCount;
+    mutable std::atomic<int> fWriteCount;
 
     typedef Symbol INHERITED;
 };
@@ -19,6 +19,11 @@ std::unique_ptr<SkCanvas> SkSVGCanvas::Make(const SkRect& bounds, SkXMLWriter* w
 }
 
 std::unique_ptr<SkCanvas> SkSVGCanvas::Make(const SkRect& bounds, SkWStream* writer) {
-    SkXMLStreamWriter xmlWriter(writer);
-    return Make(bounds, &xmlWriter);
+    // The device writes straight to the stream as it draws, and owns the xml writer so that it
+    // outlives the canvas.
+    SkISize size = bounds.roundOut().size();
+    sk_sp<SkBaseDevice> device(
+            SkSVGDevice::Create(size, skstd::make_unique<SkXMLStreamWriter>(writer)));
+
+    return skstd::make_unique<SkCanvas>(device);
 }
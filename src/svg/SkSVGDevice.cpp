@@ -271,10 +271,26 @@ bool RequiresViewportReset(const SkPaint& paint) {
 
 }  // namespace
 
-// For now all this does is serve unique serial IDs, but it will eventually evolve to track
-// and deduplicate resources.
+// Serves unique serial IDs, and remembers the resources already written to <defs> so that later
+// draws can reference them instead of writing them again.
 class SkSVGDevice::ResourceBucket : ::SkNoncopyable {
 public:
+    // Identifies a bitmap's pixels.
+    struct BitmapKey {
+        uint32_t fGenID;
+        SkIRect  fSubset;
+
+        bool operator==(const BitmapKey& other) const {
+            return fGenID == other.fGenID && fSubset == other.fSubset;
+        }
+    };
+
+    static BitmapKey MakeBitmapKey(const SkBitmap& bm) {
+        const SkIPoint origin = bm.pixelRefOrigin();
+        return { bm.getGenerationID(),
+                 SkIRect::MakeXYWH(origin.x(), origin.y(), bm.width(), bm.height()) };
+    }
+
     ResourceBucket()
             : fGradientCount(0), fClipCount(0), fPathCount(0), fImageCount(0), fPatternCount(0) {}
 
@@ -298,12 +314,51 @@ public:
       return SkStringPrintf("pattern_%d", fPatternCount++);
     }
 
+    // Clips are in device space, so clip stacks with the same generation define the same clip.
+    const SkString* findClip(uint32_t clipGenID) const { return fClips.find(clipGenID); }
+    void setClip(uint32_t clipGenID, const SkString& url) { fClips.set(clipGenID, url); }
+
+    const SkString* findPaintServer(const SkShader* shader) const {
+        return fPaintServers.find(shader);
+    }
+    void setPaintServer(const SkShader* shader, const SkString& url) {
+        // Hold on to the shader, so that its address can't be reused by another one.
+        fPaintServerShaders.push_back(sk_ref_sp(shader));
+        fPaintServers.set(shader, url);
+    }
+
+    const SkString* findImage(uint32_t imageID) const { return fImages.find(imageID); }
+    void setImage(uint32_t imageID, const SkString& id) { fImages.set(imageID, id); }
+
+    const SkString* findBitmap(const BitmapKey& key) const { return fBitmaps.find(key); }
+    void setBitmap(const BitmapKey& key, const SkString& id) { fBitmaps.set(key, id); }
+
+    // Paths are only moved to <defs> once they're drawn a second time: returns false and
+    // remembers the path the first time it's seen.
+    bool seenPath(uint32_t pathGenID) {
+        if (fSeenPaths.contains(pathGenID)) {
+            return true;
+        }
+        fSeenPaths.add(pathGenID);
+        return false;
+    }
+    const SkString* findPath(uint32_t pathGenID) const { return fPaths.find(pathGenID); }
+    void setPath(uint32_t pathGenID, const SkString& id) { fPaths.set(pathGenID, id); }
+
 private:
     uint32_t fGradientCount;
     uint32_t fClipCount;
     uint32_t fPathCount;
     uint32_t fImageCount;
     uint32_t fPatternCount;
+
+    SkTHashMap<uint32_t, SkString>           fClips;         // clip gen ID -> url(#clip_N)
+    SkTHashMap<const SkShader*, SkString>    fPaintServers;  // shader -> url(#gradient_N)
+    SkTArray<sk_sp<const SkShader>>          fPaintServerShaders;
+    SkTHashMap<uint32_t, SkString>           fImages;        // image unique ID -> img_N
+    SkTHashMap<BitmapKey, SkString>          fBitmaps;       // -> img_N
+    SkTHashSet<uint32_t>                     fSeenPaths;
+    SkTHashMap<uint32_t, SkString>           fPaths;         // path gen ID -> path_N
 };
 
 struct SkSVGDevice::MxCp {
@@ -442,10 +497,23 @@ void SkSVGDevice::AutoElement::addPaint(const SkPaint& paint, const Resources& r
 Resources SkSVGDevice::AutoElement::addResources(const MxCp& mc, const SkPaint& paint) {
     Resources resources(paint);
 
-    // FIXME: this is a weak heuristic and we end up with LOTS of redundant clips.
     bool hasClip   = !mc.fClipStack->isWideOpen();
     bool hasShader = SkToBool(paint.getShader());
 
+    // Reference the clip and paint server if they've been defined already.
+    if (hasClip) {
+        if (const SkString* clip = fResourceBucket->findClip(mc.fClipStack->getTopmostGenID())) {
+            resources.fClip = *clip;
+            hasClip = false;
+        }
+    }
+    if (hasShader) {
+        if (const SkString* server = fResourceBucket->findPaintServer(paint.getShader())) {
+            resources.fPaintServer = *server;
+            hasShader = false;
+        }
+    }
+
     if (hasClip || hasShader) {
         AutoElement defs("defs", fWriter);
 
@@ -483,6 +551,7 @@ void SkSVGDevice::AutoElement::addGradientShaderResources(const SkShader* shader
     SkASSERT(grInfo.fColorCount <= grOffsets.count());
 
     resources->fPaintServer.printf("url(#%s)", addLinearGradientDef(grInfo, shader).c_str());
+    fResourceBucket->setPaintServer(shader, resources->fPaintServer);
 }
 
 // Returns data uri from bytes.
@@ -534,10 +603,15 @@ void SkSVGDevice::AutoElement::addImageShaderResources(const SkShader* shader, c
 
     SkString patternDims[2];  // width, height
 
-    sk_sp<SkData> dataUri = AsDataUri(image);
-    if (!dataUri) {
-        SkDebugf("Failed to encode data as data URI.");
-        return;
+    // Images shared by several shaders are only encoded once.
+    const SkString* sharedImageID = fResourceBucket->findImage(image->uniqueID());
+    sk_sp<SkData> dataUri;
+    if (!sharedImageID) {
+        dataUri = AsDataUri(image);
+        if (!dataUri) {
+            SkDebugf("Failed to encode data as data URI.");
+            return;
+        }
     }
     SkIRect imageSize = image->bounds();
     for (int i = 0; i < 2; i++) {
@@ -563,7 +637,10 @@ void SkSVGDevice::AutoElement::addImageShaderResources(const SkShader* shader, c
         pattern.addAttribute("x", 0);
         pattern.addAttribute("y", 0);
 
-        {
+        if (sharedImageID) {
+            AutoElement imageUse("use", fWriter);
+            imageUse.addAttribute("xlink:href", SkStringPrintf("#%s", sharedImageID->c_str()));
+        } else {
             SkString imageID = fResourceBucket->addImage();
             AutoElement imageTag("image", fWriter);
             imageTag.addAttribute("id", imageID);
@@ -572,9 +649,11 @@ void SkSVGDevice::AutoElement::addImageShaderResources(const SkShader* shader, c
             imageTag.addAttribute("width", image->width());
             imageTag.addAttribute("height", image->height());
             imageTag.addAttribute("xlink:href", static_cast<const char*>(dataUri->data()));
+            fResourceBucket->setImage(image->uniqueID(), imageID);
         }
     }
     resources->fPaintServer.printf("url(#%s)", patternID.c_str());
+    fResourceBucket->setPaintServer(shader, resources->fPaintServer);
 }
 
 void SkSVGDevice::AutoElement::addShaderResources(const SkPaint& paint, Resources* resources) {
@@ -618,6 +697,7 @@ void SkSVGDevice::AutoElement::addClipResources(const MxCp& mc, Resources* resou
     }
 
     resources->fClip.printf("url(#%s)", clipID.c_str());
+    fResourceBucket->setClip(mc.fClipStack->getTopmostGenID(), resources->fClip);
 }
 
 SkString SkSVGDevice::AutoElement::addLinearGradientDef(const SkShader::GradientInfo& info,
@@ -737,6 +817,16 @@ SkBaseDevice* SkSVGDevice::Create(const SkISize& size, SkXMLWriter* writer) {
     return new SkSVGDevice(size, writer);
 }
 
+SkBaseDevice* SkSVGDevice::Create(const SkISize& size, std::unique_ptr<SkXMLWriter> writer) {
+    if (!writer) {
+        return nullptr;
+    }
+
+    SkSVGDevice* device = new SkSVGDevice(size, writer.get());
+    device->fOwnedWriter = std::move(writer);
+    return device;
+}
+
 SkSVGDevice::SkSVGDevice(const SkISize& size, SkXMLWriter* writer)
     : INHERITED(SkImageInfo::MakeUnknown(size.fWidth, size.fHeight),
                 SkSurfaceProps(0, kUnknown_SkPixelGeometry))
@@ -856,10 +946,39 @@ void SkSVGDevice::drawRRect(const SkRRect& rr, const SkPaint& paint) {
     elem.addPathAttributes(path);
 }
 
+SkString SkSVGDevice::sharedPathID(const SkPath& path) {
+    const uint32_t genID = path.getGenerationID();
+    if (const SkString* id = fResourceBucket->findPath(genID)) {
+        return *id;
+    }
+
+    SkString id = fResourceBucket->addPath();
+    {
+        AutoElement defs("defs", fWriter);
+        AutoElement pathElement("path", fWriter);
+        pathElement.addAttribute("id", id);
+        pathElement.addPathAttributes(path);
+    }
+    fResourceBucket->setPath(genID, id);
+    return id;
+}
+
 void SkSVGDevice::drawPath(const SkPath& path, const SkPaint& paint,
                            const SkMatrix* prePathMatrix, bool pathIsMutable) {
-    AutoElement elem("path", fWriter, fResourceBucket.get(), MxCp(this), paint);
-    elem.addPathAttributes(path);
+    // Geometry drawn repeatedly, like chart markers, is written once to <defs> and then
+    // referenced by a <use> per draw, which carries the paint and transform.
+    SkString pathID;
+    if (!path.isEmpty() && fResourceBucket->seenPath(path.getGenerationID())) {
+        pathID = this->sharedPathID(path);
+    }
+
+    AutoElement elem(pathID.isEmpty() ? "path" : "use", fWriter, fResourceBucket.get(),
+                     MxCp(this), paint);
+    if (pathID.isEmpty()) {
+        elem.addPathAttributes(path);
+    } else {
+        elem.addAttribute("xlink:href", SkStringPrintf("#%s", pathID.c_str()));
+    }
 
     // TODO: inverse fill types?
     if (path.getFillType() == SkPath::kEvenOdd_FillType) {
@@ -873,6 +992,13 @@ static sk_sp<SkData> encode(const SkBitmap& src) {
 }
 
 void SkSVGDevice::drawBitmapCommon(const MxCp& mc, const SkBitmap& bm, const SkPaint& paint) {
+    const ResourceBucket::BitmapKey key = ResourceBucket::MakeBitmapKey(bm);
+    if (const SkString* imageID = fResourceBucket->findBitmap(key)) {
+        AutoElement imageUse("use", fWriter, fResourceBucket.get(), mc, paint);
+        imageUse.addAttribute("xlink:href", SkStringPrintf("#%s", imageID->c_str()));
+        return;
+    }
+
     sk_sp<SkData> pngData = encode(bm);
     if (!pngData) {
         return;
@@ -896,6 +1022,7 @@ void SkSVGDevice::drawBitmapCommon(const MxCp& mc, const SkBitmap& bm, const SkP
             image.addAttribute("xlink:href", svgImageData);
         }
     }
+    fResourceBucket->setBitmap(key, imageID);
 
     {
         AutoElement imageUse("use", fWriter, fResourceBucket.get(), mc, paint);
@@ -969,15 +1096,7 @@ void SkSVGDevice::drawPosText(const void* text, size_t len,
 
 void SkSVGDevice::drawTextOnPath(const void* text, size_t len, const SkPath& path,
                                  const SkMatrix* matrix, const SkPaint& paint) {
-    SkString pathID = fResourceBucket->addPath();
-
-    {
-        AutoElement defs("defs", fWriter);
-        AutoElement pathElement("path", fWriter);
-        pathElement.addAttribute("id", pathID);
-        pathElement.addPathAttributes(path);
-
-    }
+    SkString pathID = this->sharedPathID(path);
 
     {
         AutoElement textElement("text", fWriter);
@@ -16,6 +16,8 @@ class SkXMLWriter;
 class SkSVGDevice : public SkClipStackDevice {
 public:
     static SkBaseDevice* Create(const SkISize& size, SkXMLWriter* writer);
+    // The device owns the writer.
+    static SkBaseDevice* Create(const SkISize& size, std::unique_ptr<SkXMLWriter> writer);
 
 protected:
     void drawPaint(const SkPaint& paint) override;
@@ -57,9 +59,13 @@ private:
     struct MxCp;
     void drawBitmapCommon(const MxCp&, const SkBitmap& bm, const SkPaint& paint);
 
+    // Returns the id of the path's entry in <defs>, writing it the first time.
+    SkString sharedPathID(const SkPath&);
+
     class AutoElement;
     class ResourceBucket;
 
+    std::unique_ptr<SkXMLWriter>    fOwnedWriter;  // Declared first, to outlive fRootElement.
     SkXMLWriter*                    fWriter;
     std::unique_ptr<AutoElement>    fRootElement;
     std::unique_ptr<ResourceBucket> fResourceBucket;
@@ -16,6 +16,9 @@ class SkStreamSeekable;
 
 /**
  *  Writes into a file format that is similar to SkPicture::serialize()
+ *
+ *  Each page is a picture nested in the one written, so if procs has an executor, the pages are
+ *  serialized in parallel on it.
  */
 SK_API sk_sp<SkDocument> SkMakeMultiPictureDocument(SkWStream* dst, const SkSerialProcs* = nullptr);
 
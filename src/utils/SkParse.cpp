@@ -199,10 +199,68 @@ const char* SkParse::FindMSec(const char str[], SkMSec* value)
     return str;
 }
 
+// Parses the plain decimals that make up nearly all path and attribute data, like "-12.5" or
+// ".25", without going through strtod(). Only mantissas of up to 15 significant digits divided
+// by a power of ten of at most 22 are handled: both are exact doubles, so the quotient is the
+// correctly rounded double that strtod() would return. Returns nullptr to defer anything else
+// (exponents, hex, inf and nan, long mantissas) to strtod().
+static const char* find_simple_decimal(const char str[], double* value) {
+    static const double kPow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    static constexpr int kMaxSignificantDigits = 15;
+
+    bool negative = false;
+    if (*str == '-' || *str == '+') {
+        negative = *str == '-';
+        str += 1;
+    }
+
+    uint64_t mantissa = 0;
+    int significantDigits = 0,
+        fractionDigits = 0;
+    bool anyDigits = false;
+    while (is_digit(*str)) {
+        mantissa = 10*mantissa + (*str - '0');
+        significantDigits += mantissa != 0;
+        anyDigits = true;
+        str += 1;
+    }
+    if (*str == '.') {
+        str += 1;
+        while (is_digit(*str)) {
+            mantissa = 10*mantissa + (*str - '0');
+            significantDigits += mantissa != 0;
+            fractionDigits += 1;
+            anyDigits = true;
+            str += 1;
+        }
+    }
+
+    if (!anyDigits || significantDigits > kMaxSignificantDigits ||
+        fractionDigits >= (int)SK_ARRAY_COUNT(kPow10) ||
+        *str == 'e' || *str == 'E' || *str == 'x' || *str == 'X') {
+        return nullptr;
+    }
+
+    double v = (double)mantissa / kPow10[fractionDigits];
+    *value = negative ? -v : v;
+    return str;
+}
+
 const char* SkParse::FindScalar(const char str[], SkScalar* value) {
     SkASSERT(str);
     str = skip_ws(str);
 
+    double d;
+    if (const char* stop = find_simple_decimal(str, &d)) {
+        if (value) {
+            *value = (float)d;
+        }
+        return stop;
+    }
+
     char* stop;
     float v = (float)strtod(str, &stop);
     if (str == stop) {
@@ -72,8 +72,22 @@ static const char* find_scalar(const char str[], SkScalar* value,
     return str;
 }
 
+// Counts the numbers in path data, to reserve room for the points they'll make up front.
+static int count_numbers(const char str[]) {
+    int count = 0;
+    bool inNumber = false;
+    for (; *str; ++str) {
+        bool isNumberChar = is_digit(*str) || *str == '.';
+        count += isNumberChar && !inNumber;
+        inNumber = isNumberChar;
+    }
+    return count;
+}
+
 bool SkParsePath::FromSVGString(const char data[], SkPath* result) {
     SkPath path;
+    // Most commands take numbers in pairs, one per point.
+    path.incReserve(count_numbers(data) / 2);
     SkPoint first = {0, 0};
     SkPoint c = {0, 0};
     SkPoint lastc = {0, 0};
@@ -6,18 +6,23 @@
 */
 
 #include "SkShadowUtils.h"
+#include "SkBitmapDevice.h"
 #include "SkBlurMask.h"
 #include "SkCanvas.h"
 #include "SkColorFilter.h"
 #include "SkColorData.h"
 #include "SkDevice.h"
 #include "SkDrawShadowInfo.h"
+#include "SkJumper.h"
 #include "SkMaskFilter.h"
 #include "SkPath.h"
 #include "SkPM4f.h"
+#include "SkPointPriv.h"
 #include "SkRandom.h"
 #include "SkRasterPipeline.h"
 #include "SkResourceCache.h"
+#include "SkRRectPriv.h"
+#include "SkShaderBase.h"
 #include "SkShadowTessellator.h"
 #include "SkString.h"
 #include "SkTLazy.h"
@@ -75,6 +80,46 @@ std::unique_ptr<GrFragmentProcessor> SkGaussianColorFilter::asFragmentProcessor(
 }
 #endif
 
+/**
+*  Analytic rrect shadow shader -- produces the distance inward from the edge of a rrect, as a
+*                                  fraction of the shadow's falloff and clamped, in each channel,
+*                                  for SkGaussianColorFilter to ramp. The rrect is in the space the
+*                                  shadow is drawn in, device space.
+*/
+class SkRRectShadowShader : public SkShaderBase {
+public:
+    explicit SkRRectShadowShader(const SkJumper_RRectShadowCtx& ctx) : fCtx(ctx) {}
+
+    void toString(SkString* str) const override;
+
+    // For serialization.  This will never be called.
+    Factory getFactory() const override { SK_ABORT("not reached"); return nullptr; }
+
+protected:
+    Context* onMakeContext(const ContextRec&, SkArenaAlloc*) const override { return nullptr; }
+    bool onAppendStages(const StageRec& rec) const override {
+        SkMatrix inverse;
+        if (!rec.fCTM.invert(&inverse)) {
+            return false;
+        }
+        rec.fPipeline->append(SkRasterPipeline::seed_shader);
+        rec.fPipeline->append_matrix(rec.fAlloc, inverse);
+        rec.fPipeline->append(SkRasterPipeline::rrect_shadow, &fCtx);
+        return true;
+    }
+
+private:
+    const SkJumper_RRectShadowCtx fCtx;
+
+    typedef SkShaderBase INHERITED;
+};
+
+void SkRRectShadowShader::toString(SkString* str) const {
+    str->append("SkRRectShadowShader: (");
+    this->INHERITED::toString(str);
+    str->append(")");
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 namespace {
@@ -368,8 +413,13 @@ public:
     }
     bool isRRect(SkRRect* rrect) { return fShapeForKey.asRRect(rrect, nullptr, nullptr, nullptr); }
 #else
-    int keyBytes() const { return -1; }
-    void writeKey(void* key) const { SK_ABORT("Should never be called"); }
+    // Without GrShape, key by the path's geometry as its generation ID identifies it.
+    int keyBytes() const { return 2 * sizeof(uint32_t); }
+    void writeKey(void* key) const {
+        uint32_t* data = reinterpret_cast<uint32_t*>(key);
+        data[0] = fPath->getGenerationID();
+        data[1] = fPath->getFillType();
+    }
     bool isRRect(SkRRect* rrect) { return false; }
 #endif
 
@@ -449,6 +499,19 @@ bool draw_shadow(const FACTORY& factory,
 }
 }
 
+// Cached shadows are tessellated for their occluder's height rounded down to a multiple of this,
+// so that occluders whose elevation animates share tessellations rather than each add their own.
+// Rounding down keeps the shadow within the bounds SkDrawShadowMetrics computes for the height.
+// Heights below one step, whose shadows would vanish, are left as they are.
+static constexpr SkScalar kCachedElevationStep = 1.0f / 8;
+
+static SkScalar cached_elevation(SkScalar height) {
+    if (height < kCachedElevationStep) {
+        return height;
+    }
+    return SkScalarFloorToScalar(height / kCachedElevationStep) * kCachedElevationStep;
+}
+
 static bool tilted(const SkPoint3& zPlaneParams) {
     return !SkScalarNearlyZero(zPlaneParams.fX) || !SkScalarNearlyZero(zPlaneParams.fY);
 }
@@ -537,6 +600,29 @@ void SkShadowUtils::DrawShadow(SkCanvas* canvas, const SkPath& path, const SkPoi
     canvas->private_draw_shadow_rec(path, rec);
 }
 
+void SkShadowUtils::DrawShadows(SkCanvas* canvas, const SkPath paths[],
+                                const SkPoint3 zPlaneParams[], int count,
+                                const SkPoint3& devLightPos, SkScalar lightRadius,
+                                SkColor ambientColor, SkColor spotColor, uint32_t flags) {
+    SkMatrix inverse;
+    if (count <= 0 || !canvas->getTotalMatrix().invert(&inverse)) {
+        return;
+    }
+    SkPoint pt = inverse.mapXY(devLightPos.fX, devLightPos.fY);
+
+    SkDrawShadowRec rec;
+    rec.fLightPos       = { pt.fX, pt.fY, devLightPos.fZ };
+    rec.fLightRadius    = lightRadius;
+    rec.fAmbientColor   = ambientColor;
+    rec.fSpotColor      = spotColor;
+    rec.fFlags          = flags;
+
+    for (int i = 0; i < count; ++i) {
+        rec.fZPlaneParams = zPlaneParams[i];
+        canvas->private_draw_shadow_rec(paths[i], rec);
+    }
+}
+
 static bool validate_rec(const SkDrawShadowRec& rec) {
     return rec.fLightPos.isFinite() && rec.fZPlaneParams.isFinite() &&
            SkScalarIsFinite(rec.fLightRadius);
@@ -588,7 +674,7 @@ void SkBaseDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
 
         if (!success) {
             AmbientVerticesFactory factory;
-            factory.fOccluderHeight = zPlaneParams.fZ;
+            factory.fOccluderHeight = cached_elevation(zPlaneParams.fZ);
             factory.fTransparent = transparent;
             if (viewMatrix.hasPerspective()) {
                 factory.fOffset.set(0, 0);
@@ -669,7 +755,7 @@ void SkBaseDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
 
         if (!success) {
             SpotVerticesFactory factory;
-            factory.fOccluderHeight = zPlaneParams.fZ;
+            factory.fOccluderHeight = cached_elevation(zPlaneParams.fZ);
             factory.fDevLightPos = devLightPos;
             factory.fLightRadius = lightRadius;
 
@@ -677,7 +763,8 @@ void SkBaseDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
             factory.fLocalCenter = center;
             viewMatrix.mapPoints(&center, 1);
             SkScalar radius, scale;
-            SkDrawShadowMetrics::GetSpotParams(zPlaneParams.fZ, devLightPos.fX - center.fX,
+            SkDrawShadowMetrics::GetSpotParams(factory.fOccluderHeight,
+                                               devLightPos.fX - center.fX,
                                                devLightPos.fY - center.fY, devLightPos.fZ,
                                                lightRadius, &radius, &scale, &factory.fOffset);
             SkRect devBounds;
@@ -732,3 +819,156 @@ void SkBaseDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
         }
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Makes the paint for the shadow of a rrect with circular corners, or of a rect, drawn over the
+ * bounds of 'outer' in device space: a gaussian falloff over blurWidth inward from the edge of
+ * 'outer', clamped at blurClamp, and drawn only within insetWidth of that edge. These are the
+ * shadows GrShadowRRectOp draws on the GPU.
+ */
+static SkPaint rrect_shadow_paint(const SkRRect& outer, SkScalar blurWidth, SkScalar insetWidth,
+                                  SkScalar blurClamp, SkColor color) {
+    const SkRect& rect = outer.rect();
+    const SkScalar radius = SkRRectPriv::GetSimpleRadii(outer).fX;
+
+    SkJumper_RRectShadowCtx ctx;
+    ctx.cx           = rect.centerX();
+    ctx.cy           = rect.centerY();
+    ctx.hx           = 0.5f * rect.width() - radius;
+    ctx.hy           = 0.5f * rect.height() - radius;
+    ctx.radius       = radius;
+    ctx.invBlurWidth = 1 / blurWidth;
+    ctx.blurClamp    = blurClamp;
+    ctx.insetWidth   = insetWidth;
+
+    SkPaint paint;
+    paint.setShader(sk_make_sp<SkRRectShadowShader>(ctx));
+    // As for tessellated shadows, ramp the distance through a GaussianColorFilter and then
+    // modulate that against 'color'.
+    paint.setColorFilter(
+         SkColorFilter::MakeModeFilter(color, SkBlendMode::kModulate)->makeComposed(
+                                                                    SkGaussianColorFilter::Make()));
+    return paint;
+}
+
+// Draws the shadows of rects, circles and rrects with circular corners analytically, rather than
+// tessellating them, when the CTM keeps them so. Mirrors GrRenderTargetContext::drawFastShadow(),
+// but works in device space throughout.
+void SkBitmapDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
+    const SkMatrix& viewMatrix = this->ctm();
+    const bool skipAnalytic = SkToBool(rec.fFlags & SkShadowFlags::kGeometricOnly_ShadowFlag);
+    if (!validate_rec(rec) || tilted(rec.fZPlaneParams) || skipAnalytic ||
+        !viewMatrix.rectStaysRect() || !viewMatrix.isSimilarity()) {
+        this->INHERITED::drawShadow(path, rec);
+        return;
+    }
+
+    SkRRect rrect;
+    SkRect rect;
+    bool isRRect = path.isRRect(&rrect) && SkRRectPriv::IsSimpleCircular(rrect) &&
+                   rrect.radii(SkRRect::kUpperLeft_Corner).fX > SK_ScalarNearlyZero;
+    if (!isRRect &&
+        path.isOval(&rect) && SkScalarNearlyEqual(rect.width(), rect.height()) &&
+        rect.width() > SK_ScalarNearlyZero) {
+        rrect.setOval(rect);
+        isRRect = true;
+    }
+    if (!isRRect && path.isRect(&rect)) {
+        rrect.setRect(rect);
+        isRRect = true;
+    }
+    SkRRect devRRect;
+    if (!isRRect || !rrect.transform(viewMatrix, &devRRect)) {
+        this->INHERITED::drawShadow(path, rec);
+        return;
+    }
+    if (devRRect.isEmpty()) {
+        return;
+    }
+
+    const SkPoint3 devLightPos = map(viewMatrix, rec.fLightPos);
+    const SkScalar occluderHeight = rec.fZPlaneParams.fZ;
+    const bool transparent = SkToBool(rec.fFlags & SkShadowFlags::kTransparentOccluder_ShadowFlag);
+    const SkScalar devRadius = SkRRectPriv::GetSimpleRadii(devRRect).fX;
+
+    // The ambient shadow's falloff ends at the rrect outset by its inset width.
+    SkScalar ambientInset = SkDrawShadowMetrics::AmbientBlurRadius(occluderHeight);
+    const SkScalar umbraRecipAlpha = SkDrawShadowMetrics::AmbientRecipAlpha(occluderHeight);
+    const SkScalar ambientBlur = ambientInset * umbraRecipAlpha;
+    SkRRect ambientRRect;
+    {
+        SkScalar outsetRad = devRadius + ambientInset;
+        ambientRRect.setRectXY(devRRect.rect().makeOutset(ambientInset, ambientInset),
+                               outsetRad, outsetRad);
+    }
+    if (transparent) {
+        // Fill the whole shadow.
+        ambientInset = SK_ScalarInfinity;
+    }
+
+    // The spot shadow is the rrect scaled and offset away from the light, its falloff ending at
+    // that outset by the blur radius.
+    SkScalar spotBlur, spotScale;
+    SkVector spotOffset;
+    SkDrawShadowMetrics::GetSpotParams(occluderHeight, devLightPos.fX, devLightPos.fY,
+                                       devLightPos.fZ, rec.fLightRadius,
+                                       &spotBlur, &spotScale, &spotOffset);
+    SkRRect spotRRect;
+    devRRect.transform(SkMatrix::Concat(SkMatrix::MakeTrans(spotOffset.fX, spotOffset.fY),
+                                        SkMatrix::MakeScale(spotScale)), &spotRRect);
+    const SkScalar spotRadius = SkRRectPriv::GetSimpleRadii(spotRRect).fX;
+    SkScalar spotInset = spotBlur;
+    if (transparent) {
+        spotInset = SK_ScalarInfinity;
+    } else {
+        // Extend the drawn band inward until it meets the occluder, as far as the shadow is
+        // offset from it; see GrRenderTargetContext::drawFastShadow().
+        const SkRect& spotRect = spotRRect.rect();
+        const SkRect& devRect = devRRect.rect();
+        SkScalar maxOffset;
+        if (devRRect.isRect()) {
+            maxOffset = SkTMax(SkTMax(SkTAbs(spotRect.fLeft - devRect.fLeft),
+                                      SkTAbs(spotRect.fTop - devRect.fTop)),
+                               SkTMax(SkTAbs(spotRect.fRight - devRect.fRight),
+                                      SkTAbs(spotRect.fBottom - devRect.fBottom)));
+        } else {
+            SkScalar dr = spotRadius - devRadius;
+            SkPoint upperLeftOffset = SkPoint::Make(spotRect.fLeft - devRect.fLeft + dr,
+                                                    spotRect.fTop - devRect.fTop + dr);
+            SkPoint lowerRightOffset = SkPoint::Make(spotRect.fRight - devRect.fRight - dr,
+                                                     spotRect.fBottom - devRect.fBottom - dr);
+            maxOffset = SkScalarSqrt(SkTMax(SkPointPriv::LengthSqd(upperLeftOffset),
+                                            SkPointPriv::LengthSqd(lowerRightOffset))) + dr;
+        }
+        spotInset += SkTMax(spotBlur, maxOffset);
+    }
+    SkRRect spotOuterRRect;
+    {
+        SkScalar outsetRad = spotRadius + spotBlur;
+        spotOuterRRect.setRectXY(spotRRect.rect().makeOutset(spotBlur, spotBlur),
+                                 outsetRad, outsetRad);
+    }
+
+    // Hard edged shadows are left to the tessellator.
+    const bool drawAmbient = SkColorGetA(rec.fAmbientColor) > 0,
+               drawSpot    = SkColorGetA(rec.fSpotColor) > 0;
+    if ((drawAmbient && !(ambientBlur > 0)) || (drawSpot && !(spotBlur > 0))) {
+        this->INHERITED::drawShadow(path, rec);
+        return;
+    }
+
+    SkAutoDeviceCTMRestore adr(this, SkMatrix::I());
+    if (drawAmbient) {
+        // The fraction of the blur that's applied is insetWidth/blurWidth, 1/umbraRecipAlpha.
+        this->drawRect(ambientRRect.rect(),
+                       rrect_shadow_paint(ambientRRect, ambientBlur, ambientInset,
+                                          SkScalarInvert(umbraRecipAlpha), rec.fAmbientColor));
+    }
+    if (drawSpot) {
+        this->drawRect(spotOuterRRect.rect(),
+                       rrect_shadow_paint(spotOuterRRect, 2 * spotBlur, spotInset, 1,
+                                          rec.fSpotColor));
+    }
+}
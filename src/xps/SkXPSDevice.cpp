@@ -117,7 +117,11 @@ SkXPSDevice::SkXPSDevice(SkISize s)
                 SkSurfaceProps(0, kUnknown_SkPixelGeometry))
     , fCurrentPage(0) {}
 
-SkXPSDevice::~SkXPSDevice() {}
+SkXPSDevice::~SkXPSDevice() {
+    fImageResources.foreach([](const ImageKey&, IXpsOMImageResource** image) {
+        (*image)->Release();
+    });
+}
 
 SkXPSDevice::TypefaceUse::TypefaceUse()
     : typefaceId(0xffffffff)
@@ -621,12 +625,18 @@ static XPS_TILE_MODE SkToXpsTileMode[SkShader::kTileModeCount+1]
     /*None  */ {XTM_N,  XTM_N,   XTM_Y,   XTM_N},
 };
 
-HRESULT SkXPSDevice::createXpsImageBrush(
-        const SkBitmap& bitmap,
-        const SkMatrix& localMatrix,
-        const SkShader::TileMode (&xy)[2],
-        const SkAlpha alpha,
-        IXpsOMTileBrush** xpsBrush) {
+HRESULT SkXPSDevice::createXpsImageResource(const SkBitmap& bitmap,
+                                            IXpsOMImageResource** image) {
+    // Volatile bitmaps, like the masks we draw, won't be drawn again, so aren't worth keeping.
+    ImageKey key = { bitmap.getGenerationID(), bitmap.getSubset() };
+    const bool cacheable = !bitmap.isVolatile() && bitmap.pixelRef();
+    if (cacheable) {
+        if (IXpsOMImageResource** cached = fImageResources.find(key)) {
+            *image = SkRefComPtr(*cached);
+            return S_OK;
+        }
+    }
+
     SkDynamicMemoryWStream write;
     if (!SkEncodeImage(&write, bitmap, SkEncodedImageFormat::kPNG, 100)) {
         HRM(E_FAIL, "Unable to encode bitmap as png.");
@@ -648,14 +658,28 @@ HRESULT SkXPSDevice::createXpsImageBrush(
     HRM(this->fXpsFactory->CreatePartUri(buffer, &imagePartUri),
         "Could not create image part uri.");
 
-    SkTScopedComPtr<IXpsOMImageResource> imageResource;
     HRM(this->fXpsFactory->CreateImageResource(
             readWrapper.get(),
             XPS_IMAGE_TYPE_PNG,
             imagePartUri.get(),
-            &imageResource),
+            image),
         "Could not create image resource.");
 
+    if (cacheable) {
+        fImageResources.set(key, SkRefComPtr(*image));
+    }
+    return S_OK;
+}
+
+HRESULT SkXPSDevice::createXpsImageBrush(
+        const SkBitmap& bitmap,
+        const SkMatrix& localMatrix,
+        const SkShader::TileMode (&xy)[2],
+        const SkAlpha alpha,
+        IXpsOMTileBrush** xpsBrush) {
+    SkTScopedComPtr<IXpsOMImageResource> imageResource;
+    HR(this->createXpsImageResource(bitmap, &imageResource));
+
     XPS_RECT bitmapRect = {
         0.0, 0.0,
         static_cast<FLOAT>(bitmap.width()), static_cast<FLOAT>(bitmap.height())
@@ -1423,6 +1447,7 @@ HRESULT SkXPSDevice::applyMask(const SkMask& mask,
 
     SkBitmap bm;
     bm.installMaskPixels(mask);
+    bm.setIsVolatile(true);
 
     SkTScopedComPtr<IXpsOMTileBrush> maskBrush;
     HR(this->createXpsImageBrush(bm, m, xy, 0xFF, &maskBrush));
@@ -27,6 +27,7 @@
 #include "SkShader.h"
 #include "SkSize.h"
 #include "SkTArray.h"
+#include "SkTHash.h"
 #include "SkTScopedComPtr.h"
 #include "SkTypeface.h"
 
@@ -134,6 +135,19 @@ private:
 
     SkTArray<TypefaceUse, true> fTypefaces;
 
+    // The image resources we've made, by the pixels they were encoded from, so that an image
+    // drawn many times, on one page or many, is encoded and written to the package once.
+    // Each holds a ref, released when the device is destroyed.
+    struct ImageKey {
+        uint32_t fGenID;
+        SkIRect  fSubset;
+
+        bool operator==(const ImageKey& that) const {
+            return fGenID == that.fGenID && fSubset == that.fSubset;
+        }
+    };
+    SkTHashMap<ImageKey, IXpsOMImageResource*> fImageResources;
+
     /** Creates a GUID based id and places it into buffer.
         buffer should have space for at least GUID_ID_LEN wide characters.
         The string will always be wchar null terminated.
@@ -170,6 +184,10 @@ private:
         const SkColor skColor, const SkAlpha alpha,
         IXpsOMBrush** xpsBrush);
 
+    HRESULT createXpsImageResource(
+        const SkBitmap& bitmap,
+        IXpsOMImageResource** image);
+
     HRESULT createXpsImageBrush(
         const SkBitmap& bitmap,
         const SkMatrix& localMatrix,
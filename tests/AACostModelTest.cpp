@@ -0,0 +1,69 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAACostModel.h"
+#include "SkPath.h"
+#include "Test.h"
+
+DEF_TEST(AACostModel_Parse, r) {
+    SkAACostModel model = SkAACostModel::Get();
+
+    SkAACostModel parsed;
+    REPORTER_ASSERT(r, parsed.parse(model.toString().c_str()));
+    REPORTER_ASSERT(r, 0 == memcmp(&parsed, &model, sizeof(model)));
+
+    for (const char* bad : {"",
+                            "1,2,3",
+                            "1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16",
+                            "1,2,3,4,5,6,7,8,9,10,11,12,13,14,x",
+                            "1,2,3,4,5,6,7,8,9,10,11,12,13,14,"}) {
+        SkAACostModel unchanged = model;
+        REPORTER_ASSERT(r, !unchanged.parse(bad), "%s", bad);
+        REPORTER_ASSERT(r, 0 == memcmp(&unchanged, &model, sizeof(model)));
+    }
+}
+
+DEF_TEST(AACostModel_Choose, r) {
+    // Supersampling costs 1 per pixel, analytic 1 per crossing, and delta 10 per path.
+    SkAACostModel model;
+    REPORTER_ASSERT(r, model.parse("0,0,0,1,0, 0,0,0,0,1, 10,0,0,0,0"));
+
+    SkAACostModel::Features f = {0, 0, 4, 100};    // 4 pixels, 100 crossings
+    REPORTER_ASSERT(r, SkAACostModel::kSupersample == model.choose(f, true, true));
+
+    f = {0, 0, 100, 4};                             // 100 pixels, 4 crossings
+    REPORTER_ASSERT(r, SkAACostModel::kAnalytic    == model.choose(f, true,  true));
+    REPORTER_ASSERT(r, SkAACostModel::kSupersample == model.choose(f, false, false));
+
+    f = {0, 0, 100, 50};                            // 100 pixels, 50 crossings
+    REPORTER_ASSERT(r, SkAACostModel::kDelta       == model.choose(f, true,  true));
+    REPORTER_ASSERT(r, SkAACostModel::kAnalytic    == model.choose(f, true,  false));
+}
+
+DEF_TEST(AACostModel_Features, r) {
+    SkPath convex;
+    convex.addCircle(50, 50, 40);
+    SkAACostModel::Features f = SkAACostModel::Features::Make(convex, SkIRect::MakeWH(100, 100));
+    REPORTER_ASSERT(r, f.fEdges == convex.countPoints());
+    REPORTER_ASSERT(r, f.fPixels == 80 * 80);
+    REPORTER_ASSERT(r, f.fCrossings == 0);
+
+    // Clipping out most of the path makes it cheaper.
+    SkAACostModel::Features clipped = SkAACostModel::Features::Make(convex,
+                                                                    SkIRect::MakeWH(100, 20));
+    REPORTER_ASSERT(r, clipped.fPixels   < f.fPixels);
+    REPORTER_ASSERT(r, clipped.fEdgeRows < f.fEdgeRows);
+
+    SkPath zigzag;
+    zigzag.moveTo(0, 0);
+    for (int i = 1; i < 100; ++i) {
+        zigzag.lineTo(i, (i & 1) ? 100 : 0);
+    }
+    f = SkAACostModel::Features::Make(zigzag, SkIRect::MakeWH(100, 100));
+    REPORTER_ASSERT(r, f.fCrossings > 0);
+    REPORTER_ASSERT(r, f.fEdgeRows  > 99 * 99);
+}
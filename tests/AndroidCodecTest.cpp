@@ -196,3 +196,65 @@ DEF_TEST(AndroidCodec_orientation, r) {
         }
     }
 }
+
+// A box filtered sampled decode must average each block of the full size decode.
+DEF_TEST(AndroidCodec_boxFilter, r) {
+    auto codec = SkAndroidCodec::MakeFromData(GetResourceAsData("images/mandrill_512.png"));
+    if (!codec) {
+        ERRORF(r, "Missing images/mandrill_512.png");
+        return;
+    }
+    const auto info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(info, full.getPixels(),
+                                                                    full.rowBytes()));
+
+    for (int sampleSize : { 3, 4, 8 }) {
+        for (bool useSubset : { false, true }) {
+            SkIRect subset = SkIRect::MakeXYWH(64, 100, 300, 200);
+            SkAndroidCodec::AndroidOptions options;
+            options.fSampleSize = sampleSize;
+            options.fSampleFilter = SkAndroidCodec::SampleFilter::kBox;
+            SkISize size = codec->getSampledDimensions(sampleSize);
+            if (useSubset) {
+                options.fSubset = &subset;
+                size = codec->getSampledSubsetDimensions(sampleSize, subset);
+            } else {
+                subset = SkIRect::MakeSize(info.dimensions());
+            }
+            SkBitmap bm;
+            bm.allocPixels(info.makeWH(size.width(), size.height()));
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(bm.info(),
+                    bm.getPixels(), bm.rowBytes(), &options));
+
+            const int sampleX = subset.width() / size.width();
+            const int sampleY = subset.height() / size.height();
+            for (int y = 0; y < size.height(); y++) {
+                for (int x = 0; x < size.width(); x++) {
+                    int sums[4] = { 0, 0, 0, 0 };
+                    for (int j = 0; j < sampleY; j++) {
+                        for (int i = 0; i < sampleX; i++) {
+                            const uint8_t* src = (const uint8_t*) full.getAddr(
+                                    subset.x() + x * sampleX + i, subset.y() + y * sampleY + j);
+                            for (int c = 0; c < 4; c++) {
+                                sums[c] += src[c];
+                            }
+                        }
+                    }
+                    const uint8_t* dst = (const uint8_t*) bm.getAddr(x, y);
+                    for (int c = 0; c < 4; c++) {
+                        const int expected = (sums[c] + sampleX * sampleY / 2)
+                                           / (sampleX * sampleY);
+                        if (expected != dst[c]) {
+                            ERRORF(r, "sampleSize %i subset %i: (%i, %i) channel %i is %i, "
+                                   "expected %i", sampleSize, useSubset, x, y, c, dst[c],
+                                   expected);
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "SkArenaAlloc.h"
 #include "SkRefCnt.h"
+#include "SkScratchArena.h"
 #include "SkTypes.h"
 #include "Test.h"
 
@@ -186,3 +187,41 @@ DEF_TEST(ArenaAlloc, r) {
     REPORTER_ASSERT(r, created == 1);
     REPORTER_ASSERT(r, destroyed == 1);
 }
+
+DEF_TEST(ScratchArena, r) {
+    SkScratchArena::PurgeThreadBlocks();
+
+    auto draw = [](size_t bytes) {
+        SkScratchArena outer;
+        outer.makeArrayDefault<char>(16);
+        {
+            SkScratchArena inner;
+            inner.makeArrayDefault<char>(bytes);
+        }
+        outer.makeArrayDefault<char>(16);
+    };
+
+    // Small scratch fits in the blocks.
+    draw(100);
+    SkScratchArena::Stats stats = SkScratchArena::GetThreadStats();
+    int spills = stats.fSpills;
+    REPORTER_ASSERT(r, stats.fBlockBytes > 0);
+
+    // A draw that outgrows its block spills once, then its block is grown to fit.
+    draw(20000);
+    REPORTER_ASSERT(r, SkScratchArena::GetThreadStats().fSpills == spills + 1);
+    draw(20000);
+    stats = SkScratchArena::GetThreadStats();
+    REPORTER_ASSERT(r, stats.fSpills == spills + 1);
+    REPORTER_ASSERT(r, stats.fHighWater >= 20000);
+
+    // Blocks are never grown past the cap.
+    draw(2 * SkScratchArena::kMaxBlockSize);
+    draw(2 * SkScratchArena::kMaxBlockSize);
+    stats = SkScratchArena::GetThreadStats();
+    REPORTER_ASSERT(r, stats.fSpills == spills + 3);
+    REPORTER_ASSERT(r, stats.fBlockBytes <= 4 * SkScratchArena::kMaxBlockSize);
+
+    SkScratchArena::PurgeThreadBlocks();
+    REPORTER_ASSERT(r, SkScratchArena::GetThreadStats().fBlockBytes == 0);
+}
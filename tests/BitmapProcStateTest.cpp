@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkBitmapProcState.h"
+#include "SkBitmapProvider.h"
+#include "SkImage.h"
+#include "SkPaint.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+// The fused scale shader procs must draw exactly what the matrix and sample procs they replace
+// draw, for each tile mode, filter and alpha they're specialized on.
+DEF_TEST(BitmapProcState_ScaleShaderProcs, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(37, 23);
+    SkRandom rand;
+    for (int y = 0; y < bitmap.height(); y++) {
+        for (int x = 0; x < bitmap.width(); x++) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    const SkMatrix invs[] = {
+        SkMatrix::MakeScale(0.37f, 0.61f),
+        SkMatrix::Concat(SkMatrix::MakeTrans(-11.5f, 7.25f), SkMatrix::MakeScale(1.7f, 0.8f)),
+        SkMatrix::MakeTrans(3.5f, -2.25f),
+    };
+    const SkShader::TileMode tiles[] = { SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode };
+    const SkFilterQuality qualities[] = { kNone_SkFilterQuality, kLow_SkFilterQuality };
+    const U8CPU alphas[] = { 0xFF, 0x80 };
+
+    constexpr int kWidth = 97;
+    uint32_t xy[2 * kWidth + 1];
+    SkPMColor expected[kWidth], actual[kWidth];
+
+    int fused = 0;
+    for (const SkMatrix& inv : invs)
+    for (SkShader::TileMode tile : tiles)
+    for (SkFilterQuality quality : qualities)
+    for (U8CPU alpha : alphas) {
+        SkPaint paint;
+        paint.setFilterQuality(quality);
+        paint.setAlpha(alpha);
+
+        SkBitmapProvider provider(image.get(), nullptr);
+        SkBitmapProcState state(provider, tile, tile);
+        if (!state.setup(inv, paint) || !state.getShaderProc32() || !state.getSampleProc32()) {
+            continue;
+        }
+        fused++;
+
+        const int count = SkTMin(kWidth, state.maxCountForBufferSize(sizeof(xy)));
+        for (int y = -9; y < 40; y += 7) {
+            state.getMatrixProc()(state, xy, count, -13, y);
+            state.getSampleProc32()(state, xy, count, expected);
+            state.getShaderProc32()(&state, -13, y, actual, count);
+            REPORTER_ASSERT(r, !memcmp(expected, actual, count * sizeof(SkPMColor)),
+                            "tile %d, quality %d, alpha %u, y %d", tile, quality, alpha, y);
+        }
+    }
+    REPORTER_ASSERT(r, fused > 0);
+}
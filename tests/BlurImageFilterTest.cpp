@@ -0,0 +1,130 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkImageFilterPriv.h"
+#include "SkOpts.h"
+#include "SkRandom.h"
+#include "SkSpecialImage.h"
+#include "Test.h"
+
+// The portable rows, to check the ones SkOpts picked for this CPU against.
+#define SK_OPTS_NS portable
+#include "../src/opts/SkBlurImageFilter_opts.h"
+#undef SK_OPTS_NS
+
+DEF_TEST(BlurImageFilter_downsampleRows, reporter) {
+    SkRandom rand;
+    const int kSrcW = 37, kRows = 8;
+    uint32_t src[kSrcW * kRows];
+    for (uint32_t& px : src) {
+        px = rand.nextU();
+    }
+
+    for (int scale : { 2, 4, 8 }) {
+        // The last block of each row, and of the last rows, is partial.
+        const int dstW = (kSrcW + scale - 1) / scale;
+        for (int rows : { scale, kRows % scale ? kRows % scale : 1 }) {
+            uint32_t want[kSrcW], got[kSrcW];
+            portable::blur_downsample_row(src, kSrcW, kSrcW, std::min(rows, kRows), scale, scale,
+                                          want, dstW);
+            SkOpts::blur_downsample_row(src, kSrcW, kSrcW, std::min(rows, kRows), scale, scale,
+                                        got, dstW);
+            REPORTER_ASSERT(reporter, !memcmp(want, got, dstW * sizeof(uint32_t)),
+                            "downsample by %d, %d rows", scale, rows);
+        }
+    }
+
+    const int kDstW = 29;
+    int srcX[kDstW];
+    uint32_t weightX[kDstW];
+    for (int x = 0; x < kDstW; x++) {
+        srcX[x] = rand.nextULessThan(kSrcW - 1);
+        weightX[x] = rand.nextULessThan(257);
+    }
+    for (uint32_t weightY : { 0u, 1u, 77u, 128u, 255u, 256u }) {
+        uint32_t want[kDstW], got[kDstW];
+        portable::blur_upsample_row(src, src + kSrcW, weightY, srcX, weightX, want, kDstW);
+        SkOpts::blur_upsample_row(src, src + kSrcW, weightY, srcX, weightX, got, kDstW);
+        REPORTER_ASSERT(reporter, !memcmp(want, got, sizeof(want)), "upsample weight %u", weightY);
+    }
+}
+
+// Premultiplied pixels with hard edges, fine detail and translucency, at an odd size.
+static sk_sp<SkSpecialImage> make_blur_input(int w, int h) {
+    SkBitmap bm;
+    bm.allocN32Pixels(w, h);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            U8CPU a = (x / 13 + y / 11) % 3 ? 0xFF : (U8CPU)(x * 255 / w);
+            U8CPU r = (x * 3 + y) & 0xFF,
+                  g = ((x ^ y) & 4) ? 0xFF : 0x00,
+                  b = y * 255 / h;
+            *bm.getAddr32(x, y) = SkPremultiplyARGBInline(a, r, g, b);
+        }
+    }
+    return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(w, h), bm);
+}
+
+// Returns the largest difference between the channels of a and b, or 256 if they can't be
+// compared.
+static int max_channel_diff(const sk_sp<SkSpecialImage>& a, const sk_sp<SkSpecialImage>& b) {
+    SkBitmap bmA, bmB;
+    if (!a || !b || a->width() != b->width() || a->height() != b->height() ||
+        !a->getROPixels(&bmA) || !b->getROPixels(&bmB)) {
+        return 256;
+    }
+    int maxDiff = 0;
+    for (int y = 0; y < a->height(); y++) {
+        for (int x = 0; x < a->width(); x++) {
+            uint32_t pa = *bmA.getAddr32(a->subset().fLeft + x, a->subset().fTop + y),
+                     pb = *bmB.getAddr32(b->subset().fLeft + x, b->subset().fTop + y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                maxDiff = SkTMax(maxDiff, SkTAbs((int)((pa >> shift) & 0xFF) -
+                                                 (int)((pb >> shift) & 0xFF)));
+            }
+        }
+    }
+    return maxDiff;
+}
+
+DEF_TEST(BlurImageFilter_downsampled, reporter) {
+    const sk_sp<SkSpecialImage> input = make_blur_input(151, 97);
+    const SkIRect whole = SkIRect::MakeWH(151, 97);
+
+    const struct {
+        SkVector fSigma;
+        SkIRect  fSrcBounds;
+        SkIRect  fDstBounds;
+    } kCases[] = {
+        // The whole input, grown by the blur.
+        { {16, 16}, whole, whole.makeOutset(48, 48) },
+        { {40, 40}, whole, whole.makeOutset(120, 120) },
+        // Part of the input, offset in bounds that clip the blur on some sides.
+        { {16, 16}, SkIRect::MakeLTRB(5, 7, 136, 90), SkIRect::MakeLTRB(-11, 7, 140, 101) },
+        { {33, 20}, SkIRect::MakeLTRB(30, 1, 101, 96), SkIRect::MakeLTRB(17, -40, 101, 96) },
+        // Only one direction downsampled.
+        { {24,  3}, whole, whole.makeOutset(72, 9) },
+        { { 2, 50}, SkIRect::MakeLTRB(9, 10, 150, 80), SkIRect::MakeLTRB(3, -60, 150, 91) },
+    };
+
+    for (const auto& c : kCases) {
+        sk_sp<SkSpecialImage> full = SkRasterBlurForTesting(c.fSigma, 0, input, c.fSrcBounds,
+                                                            c.fDstBounds),
+                              down = SkRasterBlurForTesting(c.fSigma, 16, input, c.fSrcBounds,
+                                                            c.fDstBounds);
+        REPORTER_ASSERT(reporter, full && full->width() == c.fDstBounds.width() &&
+                                  full->height() == c.fDstBounds.height());
+        // The box sizes round differently at the lower resolution, which reads as a sigma a few
+        // percent off; that, not misplaced pixels, is what these differences are.
+        int diff = max_channel_diff(full, down);
+        REPORTER_ASSERT(reporter, 0 < diff && diff <= 6,
+                        "sigma %g,%g: downsampled differs by %d",
+                        c.fSigma.x(), c.fSigma.y(), diff);
+    }
+}
@@ -664,6 +664,54 @@ DEF_TEST(BlurredRRectNinePatchComputation, reporter) {
 }
 
 // https://crbugs.com/787712
+// Round rects too small to stretch are drawn from a patch that keeps their whole width or
+// height, which should look just like blurring them directly.
+DEF_TEST(BlurredRRectUnstretchedNinePatch, reporter) {
+    const SkRRect rrects[] = {
+        SkRRect::MakeRectXY(SkRect::MakeXYWH(20, 10.25f, 80, 12), 4, 4),       // too short
+        SkRRect::MakeRectXY(SkRect::MakeXYWH(30.75f, 8, 10, 40), 3, 5),        // too narrow
+        SkRRect::MakeRectXY(SkRect::MakeXYWH(60.25f, 20.5f, 6, 6), 2, 2),      // both
+    };
+
+    auto draw = [](const SkRRect& rrect, bool asPath) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::MakeA8(128, 64));
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bm);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 4));
+        if (asPath) {
+            SkPath path;
+            path.addRRect(rrect);
+            canvas.drawPath(path, paint);
+        } else {
+            canvas.drawRRect(rrect, paint);
+        }
+        return bm;
+    };
+
+    for (const SkRRect& rrect : rrects) {
+        SkBitmap patched = draw(rrect, false),
+                 blurred = draw(rrect, true);
+        int maxDiff = 0;
+        for (int y = 0; y < patched.height(); ++y) {
+            for (int x = 0; x < patched.width(); ++x) {
+                maxDiff = SkTMax(maxDiff, SkAbs32(*patched.getAddr8(x, y) -
+                                                  *blurred.getAddr8(x, y)));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 1, "maxDiff %d", maxDiff);
+
+        // Moving it by whole pixels shares the patch, and moves the pixels with it.
+        SkBitmap again = draw(rrect.makeOffset(7, 3), false);
+        REPORTER_ASSERT(reporter, *again.getAddr8(SkScalarFloorToInt(rrect.rect().centerX()) + 7,
+                                                  SkScalarFloorToInt(rrect.rect().centerY()) + 3)
+                               == *patched.getAddr8(SkScalarFloorToInt(rrect.rect().centerX()),
+                                                    SkScalarFloorToInt(rrect.rect().centerY())));
+    }
+}
+
 DEF_TEST(EmbossPerlinCrash, reporter) {
     SkPaint p;
 
@@ -8,6 +8,7 @@
 #include "Test.h"
 #include "sk_canvas.h"
 #include "sk_paint.h"
+#include "sk_picture.h"
 #include "sk_shader.h"
 #include "sk_surface.h"
 #include "sk_types.h"
@@ -84,7 +85,64 @@ static void test_c(skiatest::Reporter* reporter) {
     sk_surface_unref(surface);
 }
 
+static void batch_test(skiatest::Reporter* reporter) {
+    sk_imageinfo_t info = {4, 1, sk_colortype_get_default_8888(), PREMUL_SK_ALPHATYPE};
+    uint32_t pixels[4] = { 0, 0, 0, 0 };
+    sk_surface_t* surface = sk_surface_new_raster_direct(&info, pixels, sizeof(pixels), nullptr);
+    sk_canvas_t* canvas = sk_surface_get_canvas(surface);
+
+    sk_paint_t* white = sk_paint_new();
+    sk_paint_set_color(white, sk_color_set_argb(0xFF, 0xFF, 0xFF, 0xFF));
+    sk_paint_t* black = sk_paint_new();
+    const sk_paint_t* paints[] = { white, black };
+
+    // One pixel each, the last with a bad paint index.
+    sk_rect_t rects[] = { {0,0,1,1}, {1,0,2,1}, {2,0,3,1}, {3,0,4,1} };
+    int32_t paintIndices[] = { 0, 1, 0, 2 };
+    sk_canvas_draw_rects(canvas, rects, paintIndices, 4, paints, 2);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[0]);
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[1]);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[2]);
+    REPORTER_ASSERT(reporter, 0x00000000 == pixels[3]);
+
+    // Record a picture that blacks out the whole row but the second pixel, then draw it.
+    sk_drawcommand_t commands[] = {
+        { SAVE_SK_DRAWOP,       0, 0, {0, 0, 0, 0} },
+        { TRANSLATE_SK_DRAWOP,  0, 0, {2, 0, 0, 0} },
+        { DRAW_RECT_SK_DRAWOP,  1, 0, {0, 0, 2, 1} },
+        { RESTORE_SK_DRAWOP,    0, 0, {0, 0, 0, 0} },
+        { DRAW_RECT_SK_DRAWOP,  1, 0, {0, 0, 1, 1} },
+        { DRAW_RECT_SK_DRAWOP,  5, 0, {1, 0, 2, 1} },  // Bad paint index.
+        { SAVE_SK_DRAWOP,       0, 0, {0, 0, 0, 0} },  // Left unbalanced.
+    };
+    sk_drawtables_t tables = { paints, 2, nullptr, 0, nullptr, 0 };
+    sk_rect_t cull = {0, 0, 4, 1};
+    sk_picture_t* picture = sk_picture_record_commands(&cull, commands,
+                                                       SK_ARRAY_COUNT(commands), &tables);
+    REPORTER_ASSERT(reporter, picture != nullptr);
+
+    sk_canvas_draw_paint(canvas, white);
+    sk_canvas_draw_picture(canvas, picture, nullptr, nullptr);
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[0]);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[1]);
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[2]);
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[3]);
+
+    // The same commands, straight to the canvas.
+    sk_canvas_draw_paint(canvas, white);
+    sk_canvas_draw_commands(canvas, commands, SK_ARRAY_COUNT(commands), &tables);
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[0]);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[1]);
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[3]);
+
+    sk_picture_unref(picture);
+    sk_paint_delete(white);
+    sk_paint_delete(black);
+    sk_surface_unref(surface);
+}
+
 DEF_TEST(C_API, reporter) {
     test_c(reporter);
     shader_test(reporter);
+    batch_test(reporter);
 }
@@ -662,6 +662,47 @@ DEF_TEST(Canvas_SaveState, reporter) {
     REPORTER_ASSERT(reporter, 1 == canvas.getSaveCount());
 }
 
+// Saves that change only the matrix don't copy the clip; make sure they still nest with saves
+// that do, and with saves that change nothing.
+DEF_TEST(Canvas_SaveMatrixOnly, reporter) {
+    SkCanvas canvas(100, 100);
+    const SkIRect fullClip = canvas.getDeviceClipBounds();
+
+    canvas.save();
+    canvas.translate(10, 20);
+    canvas.save();                                      // changes nothing
+    canvas.save();
+    canvas.scale(2, 2);
+    REPORTER_ASSERT(reporter, 4 == canvas.getSaveCount());
+
+    canvas.clipRect(SkRect::MakeWH(10, 10));            // needs a full save after all
+    REPORTER_ASSERT(reporter, canvas.getDeviceClipBounds() == SkIRect::MakeXYWH(10, 20, 20, 20));
+    canvas.translate(1, 1);
+    canvas.save();
+    canvas.rotate(45);
+    canvas.restore();
+    SkMatrix expected = SkMatrix::MakeTrans(10, 20);
+    expected.preScale(2, 2);
+    expected.preTranslate(1, 1);
+    REPORTER_ASSERT(reporter, canvas.getTotalMatrix() == expected);
+
+    canvas.restore();
+    REPORTER_ASSERT(reporter, canvas.getTotalMatrix() == SkMatrix::MakeTrans(10, 20));
+    REPORTER_ASSERT(reporter, canvas.getDeviceClipBounds() == fullClip);
+    canvas.restore();
+    REPORTER_ASSERT(reporter, canvas.getTotalMatrix() == SkMatrix::MakeTrans(10, 20));
+    canvas.restore();
+    REPORTER_ASSERT(reporter, canvas.getTotalMatrix().isIdentity());
+    REPORTER_ASSERT(reporter, 1 == canvas.getSaveCount());
+
+    canvas.save();
+    canvas.setMatrix(SkMatrix::MakeScale(3, 3));
+    canvas.saveLayer(nullptr, nullptr);
+    canvas.translate(5, 5);
+    canvas.restoreToCount(1);
+    REPORTER_ASSERT(reporter, canvas.getTotalMatrix().isIdentity());
+}
+
 DEF_TEST(Canvas_ClipEmptyPath, reporter) {
     SkCanvas canvas(10, 10);
     canvas.save();
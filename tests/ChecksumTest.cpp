@@ -8,6 +8,7 @@
 #include "SkChecksum.h"
 #include "SkOpts.h"
 #include "SkRandom.h"
+#include "SkTemplates.h"
 #include "SkTypes.h"
 #include "Test.h"
 
@@ -43,3 +44,62 @@ DEF_TEST(GoodHash, r) {
     REPORTER_ASSERT(r, SkGoodHash()(( int32_t)4) ==  614249093);
     REPORTER_ASSERT(r, SkGoodHash()((uint32_t)4) ==  614249093);
 }
+
+DEF_TEST(Checksum_big, r) {
+    // Big enough for the widest hash, plus some left over.
+    const size_t kBytes = 5000;
+    SkRandom rand;
+    SkAutoTMalloc<uint8_t> data(kBytes);
+    for (size_t i = 0; i < kBytes; i++) {
+        data[i] = (uint8_t)rand.nextU();
+    }
+    const uint32_t hash = SkOpts::hash(data.get(), kBytes);
+    REPORTER_ASSERT(r, hash == SkOpts::hash(data.get(), kBytes));
+    REPORTER_ASSERT(r, hash != SkOpts::hash(data.get(), kBytes, 1));
+    REPORTER_ASSERT(r, hash != SkOpts::hash(data.get(), kBytes - 1));
+
+    // Changing any byte should change the hash.
+    for (size_t i = 0; i < kBytes; i += 7) {
+        data[i] ^= 0x10;
+        REPORTER_ASSERT(r, hash != SkOpts::hash(data.get(), kBytes));
+        data[i] ^= 0x10;
+    }
+
+    // So should swapping two 64-byte stripes.
+    uint8_t stripe[64];
+    memcpy(stripe,           data.get() +   0, 64);
+    memcpy(data.get() +   0, data.get() + 128, 64);
+    memcpy(data.get() + 128, stripe,           64);
+    REPORTER_ASSERT(r, hash != SkOpts::hash(data.get(), kBytes));
+}
+
+DEF_TEST(Checksum_Hasher, r) {
+    const size_t kBytes = 3000;
+    SkRandom rand;
+    SkAutoTMalloc<uint8_t> data(kBytes);
+    for (size_t i = 0; i < kBytes; i++) {
+        data[i] = (uint8_t)rand.nextU();
+    }
+
+    SkChecksum::Hasher whole;
+    whole.write(data.get(), kBytes);
+    const uint32_t hash = whole.finish();
+
+    // However the bytes are split up, the hash is the same.
+    for (int trial = 0; trial < 10; trial++) {
+        SkChecksum::Hasher pieces;
+        size_t written = 0;
+        while (written < kBytes) {
+            size_t n = SkTMin(kBytes - written, (size_t)rand.nextULessThan(1500));
+            pieces.write(data.get() + written, n);
+            written += n;
+        }
+        REPORTER_ASSERT(r, hash == pieces.finish());
+    }
+
+    SkChecksum::Hasher shorter, seeded(1);
+    shorter.write(data.get(), kBytes - 1);
+    seeded.write(data.get(), kBytes);
+    REPORTER_ASSERT(r, hash != shorter.finish());
+    REPORTER_ASSERT(r, hash != seeded.finish());
+}
@@ -30,11 +30,13 @@
 #if SK_SUPPORT_GPU
 #include "GrCaps.h"
 #include "GrClip.h"
+#include "GrClipMaskCache.h"
 #include "GrClipStackClip.h"
 #include "GrConfig.h"
 #include "GrContext.h"
 #include "GrContextFactory.h"
 #include "GrContextPriv.h"
+#include "GrDrawingManager.h"
 #include "GrReducedClip.h"
 #include "GrResourceCache.h"
 #include "GrResourceKey.h"
@@ -637,7 +639,7 @@ static void test_rect_merging(skiatest::Reporter* reporter) {
         REPORTER_ASSERT(reporter, isIntersectionOfRects);
     }
 
-    // reverse nested (aa inside bw) - should _not_ merge
+    // reverse nested (aa around bw) - the parent can't cut into the child, so it's dropped
     {
         SkClipStack stack;
 
@@ -645,6 +647,23 @@ static void test_rect_merging(skiatest::Reporter* reporter) {
 
         stack.clipRect(nestedParent, SkMatrix::I(), kIntersect_SkClipOp, true);
 
+        REPORTER_ASSERT(reporter, 1 == count(stack));
+
+        stack.getBounds(&bound, &type, &isIntersectionOfRects);
+
+        REPORTER_ASSERT(reporter, isIntersectionOfRects);
+    }
+
+    // reverse nested (aa around bw), but the aa edge cuts into the bw child's edge pixels -
+    // should _not_ merge
+    {
+        SkClipStack stack;
+
+        stack.clipRect(nestedChild.makeOffset(0.4f, 0), SkMatrix::I(), kReplace_SkClipOp, false);
+
+        stack.clipRect(SkRect::MakeLTRB(40.2f, 10, 90, 90), SkMatrix::I(), kIntersect_SkClipOp,
+                       true);
+
         REPORTER_ASSERT(reporter, 2 == count(stack));
 
         stack.getBounds(&bound, &type, &isIntersectionOfRects);
@@ -653,6 +672,49 @@ static void test_rect_merging(skiatest::Reporter* reporter) {
     }
 }
 
+// Deep hierarchies re-clip at every level, often to the same or a larger shape.
+static void test_nested_clips(skiatest::Reporter* reporter) {
+    const SkRRect rrect = SkRRect::MakeRectXY(SkRect::MakeLTRB(10, 10, 90, 90), 5, 5);
+    SkClipStack stack;
+    stack.clipRRect(rrect, SkMatrix::I(), kIntersect_SkClipOp, true);
+    const uint32_t genID = stack.getTopmostGenID();
+
+    for (int i = 0; i < 20; ++i) {
+        stack.save();
+        // Neither of these can shrink the clip, so they shouldn't change it.
+        stack.clipRRect(rrect, SkMatrix::I(), kIntersect_SkClipOp, true);
+        stack.clipRect(SkRect::MakeLTRB(0, 0, 100, 100), SkMatrix::I(), kIntersect_SkClipOp,
+                       false);
+    }
+    REPORTER_ASSERT(reporter, 1 == count(stack));
+    REPORTER_ASSERT(reporter, genID == stack.getTopmostGenID());
+
+    // Shrinking rects inside the rrect leave a stack equivalent to the innermost one, however
+    // deep it is.
+    for (int i = 0; i < 10; ++i) {
+        stack.save();
+        stack.clipRect(SkRect::MakeLTRB(20 + i, 20 + i, 80 - i, 80 - i), SkMatrix::I(),
+                       kIntersect_SkClipOp, i & 1);
+    }
+    REPORTER_ASSERT(reporter, 11 == count(stack));
+    SkRRect result;
+    bool aa;
+    REPORTER_ASSERT(reporter, stack.isRRect(SkRect::MakeWH(100, 100), &result, &aa));
+    REPORTER_ASSERT(reporter, result.rect() == SkRect::MakeLTRB(29, 29, 71, 71) && aa);
+    REPORTER_ASSERT(reporter, !stack.isRRect(SkRect::MakeLTRB(0, 0, 5, 5), &result, &aa));
+
+    // A rect that only overlaps the innermost one leaves two shapes to intersect.
+    stack.save();
+    stack.clipRect(SkRect::MakeLTRB(10, 10, 50, 50), SkMatrix::I(), kIntersect_SkClipOp, true);
+    REPORTER_ASSERT(reporter, !stack.isRRect(SkRect::MakeWH(100, 100), &result, &aa));
+
+    for (int i = 0; i < 31; ++i) {
+        stack.restore();
+    }
+    REPORTER_ASSERT(reporter, 1 == count(stack));
+    REPORTER_ASSERT(reporter, genID == stack.getTopmostGenID());
+}
+
 static void test_quickContains(skiatest::Reporter* reporter) {
     SkRect testRect = SkRect::MakeLTRB(10, 10, 40, 40);
     SkRect insideRect = SkRect::MakeLTRB(20, 20, 30, 30);
@@ -1473,6 +1535,7 @@ DEF_TEST(ClipStack, reporter) {
     test_bounds(reporter, SkClipStack::Element::DeviceSpaceType::kPath);
     test_isWideOpen(reporter);
     test_rect_merging(reporter);
+    test_nested_clips(reporter);
     test_rect_replace(reporter);
     test_rect_inverse_fill(reporter);
     test_path_replace(reporter);
@@ -1535,6 +1598,36 @@ DEF_GPUTEST_FOR_ALL_CONTEXTS(ClipMaskCache, reporter, ctxInfo) {
 #endif
 }
 
+// Verify that a clip mask is reused when the same clip is pushed again after being popped, even
+// when it has moved by whole pixels.
+DEF_GPUTEST_FOR_ALL_CONTEXTS(ClipMaskContentCache, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    GrClipMaskCache* maskCache =
+            context->contextPriv().drawingManager()->getClipMaskCache();
+    maskCache->reset();
+    int initialHits = maskCache->numHits();
+
+    SkPath path;
+    path.addCircle(10, 10, 8);
+    path.addCircle(15, 15, 8);
+    path.setFillType(SkPath::kEvenOdd_FillType);
+
+    SkClipStack stack;
+    sk_sp<GrTextureProxy> masks[2];
+    for (int i = 0; i < 2; ++i) {
+        SkMatrix m;
+        m.setTranslate(0.5f + 20 * i, 0.5f + 20 * i);
+        stack.save();
+        stack.clipPath(path, m, SkClipOp::kIntersect, true);
+        masks[i] = GrClipStackClip(&stack).testingOnly_createClipMask(context);
+        stack.restore();
+        context->contextPriv().getResourceCache()->purgeAsNeeded();
+    }
+    REPORTER_ASSERT(reporter, masks[0] && masks[0] == masks[1]);
+    REPORTER_ASSERT(reporter, initialHits + 1 == maskCache->numHits());
+    REPORTER_ASSERT(reporter, 1 == maskCache->count());
+}
+
 DEF_GPUTEST_FOR_ALL_CONTEXTS(canvas_private_clipRgn, reporter, ctxInfo) {
     GrContext* context = ctxInfo.grContext();
 
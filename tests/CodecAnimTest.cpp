@@ -12,6 +12,7 @@
 #include "SkCodec.h"
 #include "SkCodecAnimation.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkImageInfo.h"
 #include "SkRefCnt.h"
 #include "SkSize.h"
@@ -428,3 +429,63 @@ DEF_TEST(AndroidCodec_animated, r) {
         }
     }
 }
+
+// Decoding frames with a frame cache, in order and then backwards, must match decoding each
+// frame from scratch. The small budget only holds a few frames, so frames are evicted.
+DEF_TEST(Codec_frameCache, r) {
+    auto executor = SkExecutor::MakeFIFOThreadPool(1);
+    for (const char* file : { "images/required.gif", "images/alphabetAnim.gif",
+                              "images/randPixelsAnim.gif", "images/required.webp",
+                              "images/webp-animated.webp" }) {
+        sk_sp<SkData> data(GetResourceAsData(file));
+        if (!data) {
+            ERRORF(r, "Missing %s", file);
+            continue;
+        }
+        auto codec = SkCodec::MakeFromData(data);
+        if (!codec) {
+            ERRORF(r, "Failed to create codec for %s", file);
+            continue;
+        }
+        const int frameCount = codec->getFrameCount();
+        const auto info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                          .makeAlphaType(kPremul_SkAlphaType);
+        std::vector<SkBitmap> expected(frameCount);
+        for (int i = 0; i < frameCount; ++i) {
+            SkCodec::Options options;
+            options.fFrameIndex = i;
+            expected[i].allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info,
+                    expected[i].getPixels(), expected[i].rowBytes(), &options));
+        }
+
+        const size_t frameSize = info.computeMinByteSize();
+        for (size_t budget : { 3 * frameSize, frameCount * frameSize }) {
+            for (bool prefetch : { false, true }) {
+                auto cachedCodec = SkCodec::MakeFromData(data);
+                cachedCodec->setFrameCache(budget, prefetch ? executor.get() : nullptr,
+                                           prefetch ? SkCodec::MakeFromData(data) : nullptr);
+                std::vector<int> order;
+                for (int i = 0; i < frameCount; ++i) {
+                    order.push_back(i);
+                }
+                for (int i = frameCount - 1; i >= 0; --i) {
+                    order.push_back(i);
+                }
+                SkBitmap bm;
+                bm.allocPixels(info);
+                for (int i : order) {
+                    SkCodec::Options options;
+                    options.fFrameIndex = i;
+                    bm.eraseColor(SK_ColorRED);
+                    REPORTER_ASSERT(r, SkCodec::kSuccess == cachedCodec->getPixels(info,
+                            bm.getPixels(), bm.rowBytes(), &options));
+                    if (memcmp(bm.getPixels(), expected[i].getPixels(), bm.computeByteSize())) {
+                        ERRORF(r, "%s: frame %i differs with budget %zu and prefetch %i",
+                               file, i, budget, prefetch);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -14,10 +14,12 @@
 #include "SkCodec.h"
 #include "SkCodecImageGenerator.h"
 #include "SkColor.h"
+#include "SkColorData.h"
 #include "SkColorSpace.h"
 #include "SkColorSpacePriv.h"
 #include "SkData.h"
 #include "SkEncodedImageFormat.h"
+#include "SkExecutor.h"
 #include "SkFrontBufferedStream.h"
 #include "SkImage.h"
 #include "SkImageGenerator.h"
@@ -37,6 +39,7 @@
 #include "SkStream.h"
 #include "SkStreamPriv.h"
 #include "SkString.h"
+#include "SkTArray.h"
 #include "SkTemplates.h"
 #include "SkTypes.h"
 #include "SkUnPreMultiply.h"
@@ -1616,3 +1619,327 @@ DEF_TEST(Codec_crbug807324, r) {
         }
     }
 }
+
+// icc-v2-gbr.jpg is a 4:2:0 baseline jpeg with a restart marker after every MCU row, so it is
+// decoded as bands that need the rows around them for chroma upsampling.
+DEF_TEST(Codec_jpeg_parallel, r) {
+    const char* file = "images/icc-v2-gbr.jpg";
+    sk_sp<SkData> data = GetResourceAsData(file);
+    if (!data) {
+        ERRORF(r, "Missing %s", file);
+        return;
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkColorType colorType : { kN32_SkColorType, kRGB_565_SkColorType }) {
+        for (sk_sp<SkColorSpace> colorSpace : { sk_sp<SkColorSpace>(), SkColorSpace::MakeSRGB() }) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+            REPORTER_ASSERT(r, codec);
+            if (!codec) {
+                return;
+            }
+            SkImageInfo info = codec->getInfo().makeColorType(colorType)
+                                               .makeColorSpace(colorSpace);
+            SkBitmap serial, parallel;
+            serial.allocPixels(info);
+            parallel.allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(serial.pixmap()));
+
+            SkCodec::Options options;
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                               codec->getPixels(info, parallel.getPixels(), parallel.rowBytes(),
+                                                &options));
+            REPORTER_ASSERT(r, !memcmp(serial.getPixels(), parallel.getPixels(),
+                                       serial.computeByteSize()));
+        }
+    }
+}
+
+// Region decodes of jpegs with restart markers start decoding at the restart marker above the
+// region, and must match the same rows of a full decode.
+DEF_TEST(Codec_jpeg_restartSeek, r) {
+    const char* file = "images/icc-v2-gbr.jpg";
+    sk_sp<SkData> data = GetResourceAsData(file);
+    if (!data) {
+        ERRORF(r, "Missing %s", file);
+        return;
+    }
+
+    std::unique_ptr<SkAndroidCodec> codec = SkAndroidCodec::MakeFromData(data);
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(info, full.getPixels(),
+                                                                    full.rowBytes()));
+
+    for (SkIRect subset : { SkIRect::MakeXYWH(0, 100, info.width(), 50),
+                            SkIRect::MakeXYWH(37, 17, 100, 100),
+                            SkIRect::MakeXYWH(100, 190, 60, 17) }) {
+        SkAndroidCodec::AndroidOptions options;
+        options.fSubset = &subset;
+        SkBitmap region;
+        region.allocPixels(info.makeWH(subset.width(), subset.height()));
+        REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                           codec->getAndroidPixels(region.info(), region.getPixels(),
+                                                   region.rowBytes(), &options));
+        for (int y = 0; y < subset.height(); y++) {
+            REPORTER_ASSERT(r, !memcmp(region.getAddr(0, y),
+                                       full.getAddr(subset.x(), subset.y() + y),
+                                       subset.width() * info.bytesPerPixel()));
+        }
+    }
+}
+
+// Png decodes given an executor swizzle and color transform batches of rows on it, and must match
+// serial decodes.
+DEF_TEST(Codec_png_parallel, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const char* file : { "images/mandrill_256.png", "images/index8.png",
+                              "images/yellow_rose.png" }) {
+        sk_sp<SkData> data = GetResourceAsData(file);
+        if (!data) {
+            ERRORF(r, "Missing %s", file);
+            continue;
+        }
+
+        for (sk_sp<SkColorSpace> colorSpace : { sk_sp<SkColorSpace>(), SkColorSpace::MakeSRGB() }) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+            REPORTER_ASSERT(r, codec);
+            if (!codec) {
+                return;
+            }
+            SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                               .makeColorSpace(colorSpace);
+            SkBitmap serial, parallel;
+            serial.allocPixels(info);
+            parallel.allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(serial.pixmap()));
+
+            SkCodec::Options options;
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                               codec->getPixels(info, parallel.getPixels(), parallel.rowBytes(),
+                                                &options));
+            REPORTER_ASSERT(r, !memcmp(serial.getPixels(), parallel.getPixels(),
+                                       serial.computeByteSize()));
+        }
+    }
+}
+
+// Codecs read straight from the memory of an SkMemoryStream. They must decode the same pixels
+// as from a stream without a memory base.
+DEF_TEST(Codec_memoryBase, r) {
+    for (const char* file : { "images/randPixels.gif", "images/color_wheel.ico",
+                              "images/google_chrome.ico", "images/randPixels.bmp",
+                              "images/mandrill_256.png", "images/randPixels.png" }) {
+        sk_sp<SkData> data(GetResourceAsData(file));
+        if (!data) {
+            ERRORF(r, "Missing %s", file);
+            continue;
+        }
+        SkBitmap bms[2];
+        for (int useMemory = 0; useMemory < 2; ++useMemory) {
+            std::unique_ptr<SkStream> stream;
+            if (useMemory) {
+                stream = skstd::make_unique<SkMemoryStream>(data);
+            } else {
+                stream = skstd::make_unique<NotAssetMemStream>(data);
+            }
+            auto codec = SkCodec::MakeFromStream(std::move(stream));
+            if (!codec) {
+                ERRORF(r, "Failed to create codec for %s", file);
+                break;
+            }
+            auto info = codec->getInfo().makeColorType(kN32_SkColorType);
+            if (kUnpremul_SkAlphaType == info.alphaType()) {
+                info = info.makeAlphaType(kPremul_SkAlphaType);
+            }
+            bms[useMemory].allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info,
+                    bms[useMemory].getPixels(), bms[useMemory].rowBytes()));
+        }
+        if (bms[0].getPixels() && bms[1].getPixels()) {
+            REPORTER_ASSERT(r, !memcmp(bms[0].getPixels(), bms[1].getPixels(),
+                                       bms[0].computeByteSize()));
+        }
+    }
+}
+
+// Writes a bottom-up bmp with a V4 (108 byte) info header.
+static sk_sp<SkData> make_bmp(int width, int height, int bitsPerPixel, uint32_t compression,
+                              const uint32_t masks[4], const SkTArray<SkColor>& colors,
+                              const SkData* pixels) {
+    const uint32_t offset = 14 + 108 + 4 * colors.count();
+    SkDynamicMemoryWStream stream;
+    stream.write("BM", 2);
+    stream.write32(offset + SkToU32(pixels->size()));
+    stream.write32(0);
+    stream.write32(offset);
+    stream.write32(108);
+    stream.write32(width);
+    stream.write32(height);
+    stream.write16(1);
+    stream.write16(bitsPerPixel);
+    stream.write32(compression);
+    stream.write32(SkToU32(pixels->size()));
+    stream.write32(2835);
+    stream.write32(2835);
+    stream.write32(colors.count());
+    stream.write32(0);
+    const uint32_t noMasks[4] = { 0, 0, 0, 0 };
+    stream.write(masks ? masks : noMasks, 16);
+    stream.write32(0x73524742);     // 'sRGB'
+    for (int i = 0; i < 12; i++) {
+        stream.write32(0);
+    }
+    for (SkColor color : colors) {
+        uint8_t bgrx[4] = { (uint8_t) SkColorGetB(color), (uint8_t) SkColorGetG(color),
+                            (uint8_t) SkColorGetR(color), 0 };
+        stream.write(bgrx, 4);
+    }
+    stream.write(pixels->data(), pixels->size());
+    return stream.detachAsData();
+}
+
+static int scale_to_8(uint32_t comp, int bits) {
+    const uint32_t max = (1 << bits) - 1;
+    return (comp * 255 + max / 2) / max;
+}
+
+// The mask swizzler converts several pixels at a time. Check each pixel of an odd width image
+// against a scalar conversion, for components of 4, 5 and 6 bits.
+DEF_TEST(Codec_bmpBitMasks, r) {
+    constexpr int kWidth = 37;
+    constexpr int kHeight = 3;
+    const uint32_t masks[4] = { 0x0000F800, 0x000007E0, 0x0000001F, 0x000F0000 };
+    SkRandom random;
+    uint32_t srcPixels[kHeight][kWidth];
+    for (int y = 0; y < kHeight; y++) {
+        for (int x = 0; x < kWidth; x++) {
+            srcPixels[y][x] = random.nextU();
+        }
+    }
+    sk_sp<SkData> pixels = SkData::MakeWithCopy(srcPixels, sizeof(srcPixels));
+    sk_sp<SkData> data = make_bmp(kWidth, kHeight, 32, 3, masks, SkTArray<SkColor>(),
+                                  pixels.get());
+
+    for (SkColorType colorType : { kRGBA_8888_SkColorType, kBGRA_8888_SkColorType }) {
+        for (SkAlphaType alphaType : { kPremul_SkAlphaType, kUnpremul_SkAlphaType }) {
+            std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(data));
+            if (!codec) {
+                ERRORF(r, "Failed to create codec for bit mask bmp");
+                return;
+            }
+            SkBitmap bm;
+            bm.allocPixels(codec->getInfo().makeColorType(colorType).makeAlphaType(alphaType));
+            REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                               codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes()));
+            for (int y = 0; y < kHeight; y++) {
+                for (int x = 0; x < kWidth; x++) {
+                    uint32_t p = srcPixels[kHeight - 1 - y][x];
+                    int red   = scale_to_8((p >> 11) & 0x1F, 5);
+                    int green = scale_to_8((p >>  5) & 0x3F, 6);
+                    int blue  = scale_to_8((p >>  0) & 0x1F, 5);
+                    int alpha = scale_to_8((p >> 16) & 0x0F, 4);
+                    if (kPremul_SkAlphaType == alphaType) {
+                        red   = SkMulDiv255Round(red, alpha);
+                        green = SkMulDiv255Round(green, alpha);
+                        blue  = SkMulDiv255Round(blue, alpha);
+                    }
+                    uint32_t expected = kRGBA_8888_SkColorType == colorType
+                            ? SkPackARGB_as_RGBA(alpha, red, green, blue)
+                            : SkPackARGB_as_BGRA(alpha, red, green, blue);
+                    if (*bm.getAddr32(x, y) != expected) {
+                        ERRORF(r, "Mismatch at (%d, %d): %08x vs %08x", x, y,
+                               *bm.getAddr32(x, y), expected);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// RLE runs of a single color are filled a whole run at a time. Check full and sampled decodes of
+// RLE8, RLE4 and RLE24 images against their source colors.
+DEF_TEST(Codec_bmpRLERuns, r) {
+    constexpr int kWidth = 61;
+    constexpr int kHeight = 7;
+    SkTArray<SkColor> colors;
+    for (int i = 0; i < 16; i++) {
+        colors.push_back(SkColorSetRGB(i * 17, 255 - i * 17, i * 5));
+    }
+
+    for (int bitsPerPixel : { 4, 8, 24 }) {
+        SkBitmap expected;
+        expected.allocPixels(SkImageInfo::MakeN32Premul(kWidth, kHeight));
+        SkDynamicMemoryWStream stream;
+        SkRandom random;
+        for (int y = kHeight - 1; y >= 0; y--) {
+            for (int x = 0; x < kWidth;) {
+                const int run = SkTMin<int>(random.nextRangeU(1, 9), kWidth - x);
+                const int index = random.nextULessThan(16);
+                SkColor color = colors[index];
+                if (24 == bitsPerPixel) {
+                    color = random.nextU() | 0xFF000000;
+                    uint8_t code[4] = { (uint8_t) run, (uint8_t) SkColorGetB(color),
+                                        (uint8_t) SkColorGetG(color),
+                                        (uint8_t) SkColorGetR(color) };
+                    stream.write(code, 4);
+                } else {
+                    uint8_t code[2] = { (uint8_t) run, (uint8_t) index };
+                    if (4 == bitsPerPixel) {
+                        code[1] |= index << 4;
+                    }
+                    stream.write(code, 2);
+                }
+                for (int i = 0; i < run; i++) {
+                    *expected.getAddr32(x + i, y) = SkPreMultiplyColor(color);
+                }
+                x += run;
+            }
+            const uint8_t eol[2] = { 0, 0 };
+            stream.write(eol, 2);
+        }
+        const uint8_t eof[2] = { 0, 1 };
+        stream.write(eof, 2);
+        sk_sp<SkData> pixels = stream.detachAsData();
+        // RLE24 bmps use the jpeg compression value.
+        const uint32_t compression = 24 == bitsPerPixel ? 4 : (4 == bitsPerPixel ? 2 : 1);
+        sk_sp<SkData> data = make_bmp(kWidth, kHeight, bitsPerPixel, compression, nullptr,
+                                      24 == bitsPerPixel ? SkTArray<SkColor>() : colors,
+                                      pixels.get());
+
+        for (int sampleSize : { 1, 3 }) {
+            auto codec = SkAndroidCodec::MakeFromData(data);
+            if (!codec) {
+                ERRORF(r, "Failed to create codec for RLE%d bmp", bitsPerPixel);
+                break;
+            }
+            SkISize size = codec->getSampledDimensions(sampleSize);
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::MakeN32Premul(size.width(), size.height()));
+            SkAndroidCodec::AndroidOptions options;
+            options.fSampleSize = sampleSize;
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(bm.info(),
+                    bm.getPixels(), bm.rowBytes(), &options));
+            const int start = sampleSize / 2;
+            for (int y = 0; y < size.height(); y++) {
+                for (int x = 0; x < size.width(); x++) {
+                    SkPMColor want = *expected.getAddr32(start + x * sampleSize,
+                                                         start + y * sampleSize);
+                    if (*bm.getAddr32(x, y) != want) {
+                        ERRORF(r, "RLE%d sample %d mismatch at (%d, %d): %08x vs %08x",
+                               bitsPerPixel, sampleSize, x, y, *bm.getAddr32(x, y), want);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
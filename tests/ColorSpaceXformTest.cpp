@@ -363,3 +363,46 @@ DEF_TEST(SkColorSpaceXform_LoadTail, r) {
     REPORTER_ASSERT(r, success);
 }
 
+
+// applyRows() must match apply() on each row, whether the rows are packed together or not.
+DEF_TEST(SkColorSpaceXform_ApplyRows, r) {
+    sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkColorSpace::kSRGB_RenderTargetGamma,
+                                                   SkColorSpace::kDCIP3_D65_Gamut);
+    sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+    std::unique_ptr<SkColorSpaceXform> xform = SkColorSpaceXform::New(srgb.get(), p3.get());
+
+    constexpr int kWidth = 13, kHeight = 5, kPadding = 3;
+    uint32_t src[kHeight][kWidth + kPadding];
+    for (int y = 0; y < kHeight; y++) {
+        for (int x = 0; x < kWidth + kPadding; x++) {
+            src[y][x] = 0x01000193 * (y * kWidth + x) + 0x7f3a1c05;
+        }
+    }
+
+    uint32_t expected[kHeight][kWidth];
+    for (int y = 0; y < kHeight; y++) {
+        REPORTER_ASSERT(r, xform->apply(SkColorSpaceXform::kRGBA_8888_ColorFormat, expected[y],
+                                        SkColorSpaceXform::kRGBA_8888_ColorFormat, src[y], kWidth,
+                                        kPremul_SkAlphaType));
+    }
+
+    for (int width : { kWidth, kWidth + kPadding }) {
+        uint32_t dst[kHeight][kWidth + kPadding];
+        REPORTER_ASSERT(r, xform->applyRows(SkColorSpaceXform::kRGBA_8888_ColorFormat,
+                                            dst, sizeof(dst[0]),
+                                            SkColorSpaceXform::kRGBA_8888_ColorFormat,
+                                            src, sizeof(src[0]),
+                                            width, kHeight, kPremul_SkAlphaType));
+        for (int y = 0; y < kHeight; y++) {
+            REPORTER_ASSERT(r, !memcmp(dst[y], expected[y], sizeof(expected[y])));
+        }
+    }
+
+    // A second xform between the same color spaces shares the first's profiles, and matches it.
+    std::unique_ptr<SkColorSpaceXform> again = SkColorSpaceXform::New(srgb.get(), p3.get());
+    uint32_t dst[kWidth];
+    REPORTER_ASSERT(r, again->apply(SkColorSpaceXform::kRGBA_8888_ColorFormat, dst,
+                                    SkColorSpaceXform::kRGBA_8888_ColorFormat, src[0], kWidth,
+                                    kPremul_SkAlphaType));
+    REPORTER_ASSERT(r, !memcmp(dst, expected[0], sizeof(dst)));
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCounterDump.h"
+#include "SkCounters.h"
+#include "SkGraphics.h"
+#include "SkString.h"
+#include "SkTHash.h"
+#include "Test.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+class TestCounterDump : public SkCounterDump {
+public:
+    void dumpCounter(const char* name, uint64_t value) override {
+        fCounters.set(SkString(name), value);
+    }
+    void dumpHistogram(const char* name, const uint64_t buckets[], int bucketCount) override {
+        fHistograms.set(SkString(name), std::vector<uint64_t>(buckets, buckets + bucketCount));
+    }
+
+    uint64_t counter(const char* name) const {
+        uint64_t* value = fCounters.find(SkString(name));
+        return value ? *value : 0;
+    }
+    uint64_t bucket(const char* name, int i) const {
+        std::vector<uint64_t>* buckets = fHistograms.find(SkString(name));
+        return buckets && i < (int)buckets->size() ? (*buckets)[i] : 0;
+    }
+
+private:
+    SkTHashMap<SkString, uint64_t>              fCounters;
+    SkTHashMap<SkString, std::vector<uint64_t>> fHistograms;
+};
+
+}  // namespace
+
+DEF_TEST(Counters, r) {
+    // Other tests may be counting too, so only look at how the counts change.
+    static const char kShaderCompiles[] = "skia/gpu/shader_compiles";
+    static const char kDecodeBytes[] = "skia/codec/decode_bytes";
+    TestCounterDump before;
+    SkGraphics::DumpCounters(&before);
+
+    SkCounters::Add(SkCounter::kShaderCompiles);
+    SkCounters::Record(SkHistogram::kCodecDecodeBytes, 0);
+    SkCounters::Record(SkHistogram::kCodecDecodeBytes, 1000);
+    // Counts from threads that have exited are kept.
+    std::thread([] {
+        SkCounters::Add(SkCounter::kShaderCompiles, 2);
+        SkCounters::Record(SkHistogram::kCodecDecodeBytes, 1023);
+    }).join();
+
+    TestCounterDump after;
+    SkGraphics::DumpCounters(&after);
+    REPORTER_ASSERT(r, after.counter(kShaderCompiles) - before.counter(kShaderCompiles) >= 3);
+    REPORTER_ASSERT(r, after.bucket(kDecodeBytes, 0) - before.bucket(kDecodeBytes, 0) >= 1);
+    // 1000 and 1023 are both in [512, 1024).
+    REPORTER_ASSERT(r, after.bucket(kDecodeBytes, 10) - before.bucket(kDecodeBytes, 10) >= 2);
+}
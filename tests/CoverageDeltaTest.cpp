@@ -0,0 +1,98 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaAlloc.h"
+#include "SkBitmap.h"
+#include "SkBlitter.h"
+#include "SkCoverageDelta.h"
+#include "SkOpts.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkScan.h"
+#include "Test.h"
+
+// SkOpts::coverage_to_alpha() should match accumulating the deltas and converting them one at a time.
+DEF_TEST(CoverageDelta_CoverageToAlpha, r) {
+    constexpr int kWidth = 5 * SkCoverageDeltaMask::SIMD_WIDTH;
+
+    SkRandom rand;
+    for (int iter = 0; iter < 100; ++iter) {
+        bool isConvex = iter % 2 == 0;
+
+        // Convex coverage has to stay within [-SK_Fixed1, SK_Fixed1].
+        SkFixed deltas[kWidth];
+        SkFixed coverage = 0;
+        for (int i = 0; i < kWidth; ++i) {
+            SkFixed next = isConvex ? rand.nextRangeU(0, SK_Fixed1)
+                                    : rand.nextRangeU(0, 4 * SK_Fixed1) - 2 * SK_Fixed1;
+            deltas[i] = next - coverage;
+            coverage  = next;
+        }
+
+        for (bool isEvenOdd : {false, true})
+        for (bool isInverse : {false, true}) {
+            SkAlpha alphas[kWidth];
+            SkOpts::coverage_to_alpha(deltas, alphas, kWidth, isEvenOdd, isInverse, isConvex);
+
+            coverage = 0;
+            for (int i = 0; i < kWidth; ++i) {
+                coverage += deltas[i];
+                SkAlpha expected = isConvex ? ConvexCoverageToAlpha(coverage, isInverse)
+                                            : CoverageToAlpha(coverage, isEvenOdd, isInverse);
+                REPORTER_ASSERT(r, alphas[i] == expected, "%d: %d != %d", i, alphas[i], expected);
+            }
+        }
+    }
+}
+
+// Splitting a big path into bands whose deltas are generated in parallel should draw exactly the
+// same thing as drawing it in one go.
+DEF_TEST(CoverageDelta_Bands, r) {
+    constexpr int kSize   = 400;
+    constexpr int kPoints = 50000;
+
+    SkPath path;
+    SkRandom rand;
+    for (int i = 0; i < kPoints; ++i) {
+        SkScalar angle  = 2 * SK_ScalarPI * i / kPoints,
+                 radius = rand.nextRangeScalar(50, 190);
+        SkPoint p = {kSize / 2 + radius * SkScalarCos(angle),
+                     kSize / 2 + radius * SkScalarSin(angle)};
+        if (i == 0) {
+            path.moveTo(p);
+        } else {
+            path.lineTo(p);
+        }
+    }
+    path.close();
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    auto draw = [&](int threshold, SkBitmap* bm) {
+        bm->allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+        bm->eraseColor(SK_ColorTRANSPARENT);
+
+        SkSTArenaAlloc<2048> alloc;
+        SkBlitter* blitter = SkBlitter::Choose(bm->pixmap(), SkMatrix::I(), paint, &alloc);
+        SkScan::DAAFillPathForTesting(path, SkIRect::MakeWH(kSize, kSize), blitter, threshold);
+    };
+
+    // Our path has more than kPoints - 1 points, so only the second draw is banded.
+    SkBitmap whole, banded;
+    draw(0, &whole);
+    draw(kPoints - 1, &banded);
+
+    int maxDiff = 0;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            maxDiff = SkTMax(maxDiff, SkAbs32(*whole.getAddr8(x, y) - *banded.getAddr8(x, y)));
+        }
+    }
+    REPORTER_ASSERT(r, maxDiff == 0, "max diff %d", maxDiff);
+}
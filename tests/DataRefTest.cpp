@@ -307,6 +307,44 @@ DEF_TEST(RWBuffer_threaded, reporter) {
     tasks.wait();
 }
 
+// Reading stream's memory a chunk at a time should see the same bytes as read() would.
+static void check_alphabet_chunks(skiatest::Reporter* reporter, SkStream* stream) {
+    size_t position = 0, size;
+    while (const char* chunk = (const char*)stream->getMemoryChunk(&size)) {
+        REPORTER_ASSERT(reporter, size > 0);
+        REPORTER_ASSERT(reporter, stream->getPosition() == position);
+        for (size_t i = 0; i < size; i++) {
+            REPORTER_ASSERT(reporter, chunk[i] == gABC[(position + i) % 26]);
+        }
+        // Read only part of some chunks, so the next starts partway through one.
+        position += stream->skip(SkTMax<size_t>(size / 2, 1));
+    }
+    REPORTER_ASSERT(reporter, position == stream->getLength());
+    REPORTER_ASSERT(reporter, stream->isAtEnd());
+}
+
+DEF_TEST(RWBuffer_memoryChunks, reporter) {
+    static constexpr int N = 1000;
+    SkRWBuffer buffer;
+    SkDynamicMemoryWStream wstream;
+    for (int i = 0; i < N; ++i) {
+        buffer.append(gABC, 26);
+        wstream.write(gABC, 26);
+    }
+
+    // The chunks are the buffer's own memory.
+    std::unique_ptr<SkStream> stream = buffer.makeStreamSnapshot();
+    sk_sp<SkROBuffer> reader = buffer.makeROBufferSnapshot();
+    size_t size;
+    REPORTER_ASSERT(reporter, stream->getMemoryChunk(&size) == SkROBuffer::Iter(reader).data());
+    check_alphabet_chunks(reporter, stream.get());
+
+    check_alphabet_chunks(reporter, wstream.detachAsStream().get());
+
+    std::unique_ptr<SkStream> empty = SkRWBuffer().makeStreamSnapshot();
+    REPORTER_ASSERT(reporter, !empty->getMemoryChunk(&size));
+}
+
 // Tests that it is safe to call SkROBuffer::Iter::size() when exhausted.
 DEF_TEST(RWBuffer_size, r) {
     SkRWBuffer buffer;
@@ -809,6 +809,55 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DDLFlushWhileRecording, reporter, ctxInfo) {
     canvas->getGrContext()->flush();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Draw several DDLs, one per surface, with one call
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DDLDrawBatchTest, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+
+    static constexpr int kNumTiles = 3;
+    static constexpr SkColor kColors[kNumTiles] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+
+    SkImageInfo ii = SkImageInfo::MakeN32Premul(32, 32);
+    sk_sp<SkSurface> surfaces[kNumTiles];
+    std::unique_ptr<SkDeferredDisplayList> ddls[kNumTiles];
+    for (int i = 0; i < kNumTiles; ++i) {
+        surfaces[i] = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, ii);
+        REPORTER_ASSERT(reporter, surfaces[i]);
+        if (!surfaces[i]) {
+            return;
+        }
+
+        SkSurfaceCharacterization characterization;
+        SkAssertResult(surfaces[i]->characterize(&characterization));
+
+        SkDeferredDisplayListRecorder recorder(characterization);
+        recorder.getCanvas()->clear(kColors[i]);
+        ddls[i] = recorder.detach();
+    }
+
+    SkSurface* batchSurfaces[kNumTiles] = { surfaces[0].get(), surfaces[1].get(),
+                                            surfaces[2].get() };
+    SkDeferredDisplayList* batchDDLs[kNumTiles] = { ddls[0].get(), ddls[1].get(),
+                                                    ddls[2].get() };
+
+    // The same DDL twice, or a raster surface, rejects the whole batch.
+    SkDeferredDisplayList* repeatedDDLs[kNumTiles] = { ddls[0].get(), ddls[1].get(),
+                                                       ddls[0].get() };
+    REPORTER_ASSERT(reporter, !SkSurface::DrawBatch(kNumTiles, batchSurfaces, repeatedDDLs));
+    sk_sp<SkSurface> raster = SkSurface::MakeRaster(ii);
+    SkSurface* mixedSurfaces[kNumTiles] = { surfaces[0].get(), raster.get(), surfaces[2].get() };
+    REPORTER_ASSERT(reporter, !SkSurface::DrawBatch(kNumTiles, mixedSurfaces, batchDDLs));
+
+    REPORTER_ASSERT(reporter, SkSurface::DrawBatch(kNumTiles, batchSurfaces, batchDDLs));
+
+    for (int i = 0; i < kNumTiles; ++i) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(ii);
+        REPORTER_ASSERT(reporter, surfaces[i]->readPixels(bitmap, 0, 0));
+        REPORTER_ASSERT(reporter, bitmap.getColor(16, 16) == kColors[i]);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Check that the texture-specific flags (i.e., for external & rectangle textures) work
 // for promise images. As such, this is a GL-only test.
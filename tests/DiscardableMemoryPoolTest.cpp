@@ -32,3 +32,34 @@ DEF_TEST(DiscardableMemoryPool, reporter) {
     REPORTER_ASSERT(reporter, !dm2->lock());
     REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
 }
+
+DEF_TEST(DiscardableMemoryPool_big, reporter) {
+    // Big enough to be mapped, with pages the kernel may reclaim while it's unlocked.
+    const size_t bytes = 1 << 20;
+    sk_sp<SkDiscardableMemoryPool> pool(SkDiscardableMemoryPool::Make(4 * bytes));
+
+    std::unique_ptr<SkDiscardableMemory> dm(pool->create(bytes));
+    REPORTER_ASSERT(reporter, dm->data() != nullptr);
+    uint32_t* words = static_cast<uint32_t*>(dm->data());
+    for (size_t i = 0; i < bytes / 4; i++) {
+        words[i] = (uint32_t)i * 0x9E3779B9;
+    }
+    dm->unlock();
+    REPORTER_ASSERT(reporter, bytes == pool->getRAMUsed());
+
+    // Nothing should be short on memory here, so the pages should still be there, unchanged.
+    for (int round = 0; round < 3; round++) {
+        REPORTER_ASSERT(reporter, dm->lock());
+        words = static_cast<uint32_t*>(dm->data());
+        bool same = true;
+        for (size_t i = 0; i < bytes / 4; i++) {
+            same &= words[i] == (uint32_t)i * 0x9E3779B9;
+        }
+        REPORTER_ASSERT(reporter, same);
+        dm->unlock();
+    }
+
+    pool->dumpPool();
+    REPORTER_ASSERT(reporter, !dm->lock());
+    REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
+}
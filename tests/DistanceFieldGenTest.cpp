@@ -0,0 +1,58 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDistanceFieldGen.h"
+#include "SkRandom.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// The vectorized edge finding and distance packing must give the same bytes as the scalar ones.
+DEF_TEST(DistanceFieldGen_vectorized, reporter) {
+    enum Mask { kEmpty, kFull, kAllEdges, kCheckers, kRandom, kGlyph };
+    const char* kMaskNames[] = { "empty", "full", "all edges", "checkers", "random", "glyph" };
+
+    SkRandom rand;
+    // Widths around the sixteen texels find_edges() checks and four the packing writes at once,
+    // where the image's own border, two texels wider, is what rounds up.
+    for (int width : { 1, 2, 3, 5, 13, 14, 15, 17, 18, 30, 31, 33, 35, 46, 61 }) {
+        for (int height : { 1, 2, 3, 7, 20 }) {
+            SkAutoTMalloc<uint8_t> image(width * height);
+            for (Mask mask : { kEmpty, kFull, kAllEdges, kCheckers, kRandom, kGlyph }) {
+                for (int y = 0; y < height; y++) {
+                    for (int x = 0; x < width; x++) {
+                        uint8_t val = 0;
+                        switch (mask) {
+                            case kEmpty:    val = 0; break;
+                            case kFull:     val = 0xFF; break;
+                            // Neighbors both under 128 and non-zero are edges everywhere.
+                            case kAllEdges: val = 64; break;
+                            case kCheckers: val = (x ^ y) & 1 ? 0xFF : 0; break;
+                            case kRandom:   val = rand.nextU() >> 24; break;
+                            case kGlyph: {
+                                // A disc, antialiased at its rim, touching the image's border.
+                                float dx = x - width * 0.5f, dy = y - height * 0.6f,
+                                      r = SkTMax(width, height) * 0.45f;
+                                float cov = SkTPin(r - sqrtf(dx*dx + dy*dy), 0.f, 1.f);
+                                val = (uint8_t)(cov * 255 + 0.5f);
+                            } break;
+                        }
+                        image[y * width + x] = val;
+                    }
+                }
+
+                const size_t size = SkComputeDistanceFieldSize(width, height);
+                SkAutoTMalloc<uint8_t> scalar(size), vectorized(size);
+                REPORTER_ASSERT(reporter, SkGenerateDistanceFieldFromA8ImageForTesting(
+                        scalar.get(), image.get(), width, height, width, false));
+                REPORTER_ASSERT(reporter, SkGenerateDistanceFieldFromA8ImageForTesting(
+                        vectorized.get(), image.get(), width, height, width, true));
+                REPORTER_ASSERT(reporter, !memcmp(scalar.get(), vectorized.get(), size),
+                                "%s mask, %dx%d", kMaskNames[mask], width, height);
+            }
+        }
+    }
+}
@@ -20,7 +20,7 @@ static const int kAtlasSize = kNumPlots * kPlotSize;
 int GrDrawOpAtlas::numAllocated_TestingOnly() const {
     int count = 0;
     for (uint32_t i = 0; i < this->maxPages(); ++i) {
-        if (fProxies[i]->priv().isInstantiated()) {
+        if (fProxies[i] && fProxies[i]->priv().isInstantiated()) {
             ++count;
         }
     }
@@ -66,14 +66,24 @@ public:
     }
 
     virtual GrDeferredUploadToken addASAPUpload(GrDeferredTextureUploadFn&& upload) final {
+        fASAPUploads.push_back(std::move(upload));
         return fTokenTracker.nextTokenToFlush();
     }
 
     void issueDrawToken() { fTokenTracker.issueDrawToken(); }
     void flushToken() { fTokenTracker.flushToken(); }
 
+    int numASAPUploads() const { return fASAPUploads.count(); }
+    void executeASAPUploads(GrDeferredTextureUploadWritePixelsFn& writePixels) {
+        for (GrDeferredTextureUploadFn& upload : fASAPUploads) {
+            upload(writePixels);
+        }
+        fASAPUploads.reset();
+    }
+
 private:
     GrTokenTracker fTokenTracker;
+    SkTArray<GrDeferredTextureUploadFn> fASAPUploads;
 
     typedef GrDeferredUploadTarget INHERITED;
 };
@@ -145,6 +155,107 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(BasicDrawOpAtlas, reporter, ctxInfo) {
     check(reporter, atlas.get(), 1, 4, 1);
 }
 
+// Filling every plot of a page before a flush uploads the page with a single writePixels.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DrawOpAtlasBatchedUploads, reporter, ctxInfo) {
+    auto context = ctxInfo.grContext();
+    auto proxyProvider = context->contextPriv().proxyProvider();
+    auto resourceProvider = context->contextPriv().resourceProvider();
+
+    TestingUploadTarget uploadTarget;
+    std::unique_ptr<GrDrawOpAtlas> atlas = GrDrawOpAtlas::Make(
+                                                proxyProvider,
+                                                kAlpha_8_GrPixelConfig,
+                                                kAtlasSize, kAtlasSize,
+                                                kNumPlots, kNumPlots,
+                                                GrDrawOpAtlas::AllowMultitexturing::kYes,
+                                                EvictionFunc, nullptr);
+    // Only the first page exists until the atlas grows.
+    REPORTER_ASSERT(reporter, atlas->getProxies()[0] && !atlas->getProxies()[1]);
+
+    GrDrawOpAtlas::AtlasID atlasIDs[kNumPlots * kNumPlots];
+    for (int i = 0; i < kNumPlots * kNumPlots; ++i) {
+        REPORTER_ASSERT(reporter, fill_plot(atlas.get(), resourceProvider, &uploadTarget,
+                                            &atlasIDs[i], i * 32 + 1));
+    }
+    REPORTER_ASSERT(reporter, 1 == uploadTarget.numASAPUploads());
+
+    int numWrites = 0;
+    GrDeferredTextureUploadWritePixelsFn writePixels =
+            [&](GrTextureProxy*, int left, int top, int width, int height, GrColorType,
+                const void* buffer, size_t rowBytes) {
+                ++numWrites;
+                REPORTER_ASSERT(reporter, 0 == left && 0 == top);
+                REPORTER_ASSERT(reporter, kAtlasSize == width && kAtlasSize == height);
+                // Every texel holds the data of one of the plots.
+                const uint8_t* pixels = static_cast<const uint8_t*>(buffer);
+                for (int y = 0; y < height; y += kPlotSize) {
+                    for (int x = 0; x < width; x += kPlotSize) {
+                        REPORTER_ASSERT(reporter, 1 == pixels[y * rowBytes + x] % 32);
+                    }
+                }
+                return true;
+            };
+    uploadTarget.executeASAPUploads(writePixels);
+    REPORTER_ASSERT(reporter, 1 == numWrites);
+}
+
+static bool add_entry(GrDrawOpAtlas* atlas, GrResourceProvider* resourceProvider,
+                      GrDeferredUploadTarget* target, GrDrawOpAtlas::Lifetime lifetime,
+                      SkIPoint* plot) {
+    static constexpr int kEntrySize = kPlotSize / 2;
+    SkBitmap data;
+    data.allocPixels(SkImageInfo::MakeA8(kEntrySize, kEntrySize));
+    data.eraseARGB(0xFF, 0, 0, 0);
+
+    GrDrawOpAtlas::AtlasID atlasID;
+    SkIPoint16 loc;
+    GrDrawOpAtlas::ErrorCode code = atlas->addToAtlas(resourceProvider, &atlasID, target,
+                                                      kEntrySize, kEntrySize, data.getAddr(0, 0),
+                                                      &loc, lifetime);
+    plot->set(loc.fX / kPlotSize, loc.fY / kPlotSize);
+    return GrDrawOpAtlas::ErrorCode::kSucceeded == code;
+}
+
+// Checks that an atlas that packs by lifetime keeps long-lived entries out of the plots of
+// short-lived ones, and that it counts the bytes uploaded in each flush.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DrawOpAtlasPackByLifetime, reporter, ctxInfo) {
+    auto context = ctxInfo.grContext();
+    auto proxyProvider = context->contextPriv().proxyProvider();
+    auto resourceProvider = context->contextPriv().resourceProvider();
+
+    for (bool packByLifetime : {false, true}) {
+        TestingUploadTarget uploadTarget;
+        std::unique_ptr<GrDrawOpAtlas> atlas = GrDrawOpAtlas::Make(
+                                                    proxyProvider,
+                                                    kAlpha_8_GrPixelConfig,
+                                                    kAtlasSize, kAtlasSize,
+                                                    kNumPlots, kNumPlots,
+                                                    GrDrawOpAtlas::AllowMultitexturing::kNo,
+                                                    EvictionFunc, nullptr);
+        atlas->setPackByLifetime(packByLifetime);
+
+        SkIPoint shortPlot, longPlot, secondShortPlot;
+        REPORTER_ASSERT(reporter, add_entry(atlas.get(), resourceProvider, &uploadTarget,
+                                            GrDrawOpAtlas::Lifetime::kShort, &shortPlot));
+        REPORTER_ASSERT(reporter, add_entry(atlas.get(), resourceProvider, &uploadTarget,
+                                            GrDrawOpAtlas::Lifetime::kLong, &longPlot));
+        REPORTER_ASSERT(reporter, add_entry(atlas.get(), resourceProvider, &uploadTarget,
+                                            GrDrawOpAtlas::Lifetime::kShort, &secondShortPlot));
+        REPORTER_ASSERT(reporter, packByLifetime == (shortPlot != longPlot));
+        REPORTER_ASSERT(reporter, shortPlot == secondShortPlot);
+
+        uploadTarget.flushToken();
+        atlas->compact(uploadTarget.tokenTracker()->nextTokenToFlush());
+        const GrDrawOpAtlas::FlushStats& stats = atlas->lastFlushStats();
+        REPORTER_ASSERT(reporter, 0 == stats.fEvictions);
+        REPORTER_ASSERT(reporter, 3 * kPlotSize * kPlotSize / 4 == (int)stats.fUploadedBytes);
+        REPORTER_ASSERT(reporter, kPlotSize * kPlotSize / 4 == (int)stats.fReuploadedBytes);
+
+        atlas->compact(uploadTarget.tokenTracker()->nextTokenToFlush());
+        REPORTER_ASSERT(reporter, 0 == atlas->lastFlushStats().fUploadedBytes);
+    }
+}
+
 #include "GrTest.h"
 
 #include "GrDrawingManager.h"
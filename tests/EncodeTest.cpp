@@ -9,8 +9,10 @@
 #include "Test.h"
 
 #include "SkBitmap.h"
+#include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkEncodedImageFormat.h"
+#include "SkExecutor.h"
 #include "SkImage.h"
 #include "SkJpegEncoder.h"
 #include "SkPngEncoder.h"
@@ -286,6 +288,62 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+// Encodes with an executor must decode to the same pixels as serial encodes, and must not depend
+// on the number of threads.
+DEF_TEST(Encode_Parallel, r) {
+    SkBitmap mandrill;
+    if (!GetResourceAsBitmap("images/mandrill_512.png", &mandrill)) {
+        return;
+    }
+
+    // Large enough to be split into several bands.
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(1024, 1000);
+    SkCanvas canvas(bitmap);
+    canvas.scale(2, 2);
+    canvas.drawBitmap(mandrill, 0, 0);
+    SkPixmap src;
+    REPORTER_ASSERT(r, bitmap.peekPixels(&src));
+
+    std::unique_ptr<SkExecutor> executors[] = { SkExecutor::MakeFIFOThreadPool(1),
+                                                SkExecutor::MakeFIFOThreadPool(4) };
+    for (SkEncodedImageFormat format : { SkEncodedImageFormat::kPNG,
+                                         SkEncodedImageFormat::kJPEG }) {
+        auto encodeWith = [&](SkExecutor* executor, SkWStream* dst) {
+            if (SkEncodedImageFormat::kPNG == format) {
+                SkPngEncoder::Options options;
+                options.fExecutor = executor;
+                return SkPngEncoder::Encode(dst, src, options);
+            }
+            SkJpegEncoder::Options options;
+            options.fExecutor = executor;
+            return SkJpegEncoder::Encode(dst, src, options);
+        };
+
+        SkDynamicMemoryWStream serialDst, parallelDst[2];
+        REPORTER_ASSERT(r, encodeWith(nullptr, &serialDst));
+        for (int i = 0; i < 2; i++) {
+            REPORTER_ASSERT(r, encodeWith(executors[i].get(), &parallelDst[i]));
+        }
+
+        sk_sp<SkData> serialData = serialDst.detachAsData();
+        sk_sp<SkData> parallelData[2] = { parallelDst[0].detachAsData(),
+                                          parallelDst[1].detachAsData() };
+        REPORTER_ASSERT(r, parallelData[0]->equals(parallelData[1].get()));
+
+        SkBitmap serialBitmap, parallelBitmap;
+        sk_sp<SkImage> serialImage = SkImage::MakeFromEncoded(serialData),
+                       parallelImage = SkImage::MakeFromEncoded(parallelData[0]);
+        REPORTER_ASSERT(r, serialImage && parallelImage);
+        if (!serialImage || !parallelImage) {
+            continue;
+        }
+        serialImage->asLegacyBitmap(&serialBitmap);
+        parallelImage->asLegacyBitmap(&parallelBitmap);
+        REPORTER_ASSERT(r, almost_equals(serialBitmap, parallelBitmap, 0));
+    }
+}
+
 DEF_TEST(Encode_WebpOptions, r) {
     SkBitmap bitmap;
     bool success = GetResourceAsBitmap("images/google_chrome.ico", &bitmap);
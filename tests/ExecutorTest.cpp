@@ -0,0 +1,104 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkSemaphore.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+#include <atomic>
+#include <vector>
+
+DEF_TEST(Executor_WorkStealingBatch, reporter) {
+    auto pool = SkExecutor::MakeWorkStealingThreadPool(4);
+
+    // Each index runs once, including those of batches added from the pool's own threads.
+    const int N = 1000;
+    std::vector<std::atomic<int>> counts(N);
+    for (auto& count : counts) {
+        count = 0;
+    }
+    SkTaskGroup outer(*pool);
+    outer.batch(8, [&](int) {
+        SkTaskGroup inner(*pool);
+        inner.batch(N, [&](int i) { counts[i]++; });
+    });
+    outer.wait();
+    for (const auto& count : counts) {
+        REPORTER_ASSERT(reporter, count == 8);
+    }
+}
+
+DEF_TEST(Executor_WorkStealingPriority, reporter) {
+    auto pool = SkExecutor::MakeWorkStealingThreadPool(1);
+
+    // Hold up the only thread while queueing work behind it.
+    SkSemaphore started, release;
+    pool->add([&] {
+        started.signal();
+        release.wait();
+    });
+    started.wait();
+
+    std::vector<int> order;
+    SkSemaphore done;
+    pool->addPrioritized([&] { order.push_back(2); done.signal(); },
+                         SkExecutor::Priority::kLow);
+    pool->addPrioritized([&] { order.push_back(1); done.signal(); },
+                         SkExecutor::Priority::kNormal);
+    pool->addPrioritized([&] { order.push_back(0); done.signal(); },
+                         SkExecutor::Priority::kHigh, 0);
+    release.signal();
+    done.wait();
+    done.wait();
+    done.wait();
+    REPORTER_ASSERT(reporter, order == std::vector<int>({0, 1, 2}));
+}
+
+DEF_TEST(Executor_WorkStealingShutdown, reporter) {
+    // Work still waiting when the pool is destroyed is done first.
+    std::atomic<int> count{0};
+    {
+        auto pool = SkExecutor::MakeWorkStealingThreadPool(2);
+        for (int i = 0; i < 100; i++) {
+            pool->add([&] { count++; });
+        }
+        pool->batch(100, [&](int) { count++; });
+    }
+    REPORTER_ASSERT(reporter, count == 200);
+}
+
+DEF_TEST(Executor_TaskGroupParallelFor, reporter) {
+    auto pools = {SkExecutor::MakeFIFOThreadPool(3), SkExecutor::MakeLIFOThreadPool(3),
+                  SkExecutor::MakeWorkStealingThreadPool(3)};
+    for (const auto& pool : pools) {
+        const int N = 1001;
+        std::vector<std::atomic<int>> counts(N);
+        for (auto& count : counts) {
+            count = 0;
+        }
+        SkTaskGroup tg(*pool);
+        tg.parallelFor(N, 64, [&](int begin, int end) {
+            REPORTER_ASSERT(reporter, end - begin == 64 || end == N);
+            for (int i = begin; i < end; i++) {
+                counts[i]++;
+            }
+        });
+
+        // Tasks with more to capture than std::function holds in place.
+        std::atomic<int> sum{0};
+        for (int i = 0; i < 100; i++) {
+            int a = i, b = 2 * i, c = 3 * i, d = 4 * i;
+            tg.add([&sum, a, b, c, d] { sum += a + b + c + d; });
+        }
+        tg.wait();
+        for (const auto& count : counts) {
+            REPORTER_ASSERT(reporter, count == 1);
+        }
+        REPORTER_ASSERT(reporter, sum == 10 * 99 * 100 / 2);
+    }
+}
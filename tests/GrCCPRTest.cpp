@@ -19,6 +19,7 @@
 #include "GrRenderTargetContext.h"
 #include "GrRenderTargetContextPriv.h"
 #include "GrShape.h"
+#include "SkExecutor.h"
 #include "SkMatrix.h"
 #include "SkPathPriv.h"
 #include "SkRect.h"
@@ -75,22 +76,17 @@ public:
     void clear() const { fRTC->clear(nullptr, 0, GrRenderTargetContext::CanClearFullscreen::kYes); }
     void abandonGrContext() { fCtx = nullptr; fCCPR = nullptr; fRTC = nullptr; }
 
-    void drawPath(SkPath path, GrColor4f color = GrColor4f(0, 1, 0, 1)) const {
-        SkASSERT(this->valid());
-
-        GrPaint paint;
-        paint.setColor4f(color);
-
-        GrNoClip noClip;
-        SkIRect clipBounds = SkIRect::MakeWH(kCanvasSize, kCanvasSize);
-
-        SkMatrix matrix = SkMatrix::I();
+    GrCoverageCountingPathRenderer* ccpr() const { return fCCPR; }
 
+    void drawPath(SkPath path, GrColor4f color = GrColor4f(0, 1, 0, 1)) const {
         path.setIsVolatile(true);
-        GrShape shape(path);
+        this->drawPathWithMatrix(path, SkMatrix::I(), color);
+    }
 
-        fCCPR->drawPath({fCtx, std::move(paint), &GrUserStencilSettings::kUnused, fRTC.get(),
-                         &noClip, &clipBounds, &matrix, &shape, GrAAType::kCoverage, false});
+    // Unlike drawPath(), leaves the path non-volatile, so ccpr may cache its mask.
+    void drawCachablePath(const SkPath& path, const SkMatrix& matrix) const {
+        SkASSERT(!path.isVolatile());
+        this->drawPathWithMatrix(path, matrix, GrColor4f(0, 1, 0, 1));
     }
 
     void clipFullscreenRect(SkPath clipPath, GrColor4f color = GrColor4f(0, 1, 0, 1)) {
@@ -109,6 +105,21 @@ public:
     }
 
 private:
+    void drawPathWithMatrix(const SkPath& path, const SkMatrix& matrix, GrColor4f color) const {
+        SkASSERT(this->valid());
+
+        GrPaint paint;
+        paint.setColor4f(color);
+
+        GrNoClip noClip;
+        SkIRect clipBounds = SkIRect::MakeWH(kCanvasSize, kCanvasSize);
+
+        GrShape shape(path);
+
+        fCCPR->drawPath({fCtx, std::move(paint), &GrUserStencilSettings::kUnused, fRTC.get(),
+                         &noClip, &clipBounds, &matrix, &shape, GrAAType::kCoverage, false});
+    }
+
     GrContext*                        fCtx;
     GrCoverageCountingPathRenderer*   fCCPR;
     sk_sp<GrRenderTargetContext>      fRTC;
@@ -131,6 +142,7 @@ public:
         GrContextOptions ctxOptions;
         ctxOptions.fAllowPathMaskCaching = false;
         ctxOptions.fGpuPathRenderers = GpuPathRenderers::kCoverageCounting;
+        this->customizeContextOptions(&ctxOptions);
 
         fMockContext = GrContext::MakeMock(&mockOptions, ctxOptions);
         if (!fMockContext) {
@@ -156,6 +168,7 @@ public:
 
 protected:
     virtual void customizeMockOptions(GrMockOptions*) {}
+    virtual void customizeContextOptions(GrContextOptions*) {}
     virtual void onRun(skiatest::Reporter* reporter, CCPRPathDrawer& ccpr) = 0;
 
     sk_sp<GrContext>   fMockContext;
@@ -259,6 +272,97 @@ class GrCCPRTest_parseEmptyPath : public CCPRTest {
 };
 DEF_CCPR_TEST(GrCCPRTest_parseEmptyPath)
 
+class GrCCPRTest_cache : public CCPRTest {
+    void customizeContextOptions(GrContextOptions* options) override {
+        options->fCacheCoverageCountingPathMasks = true;
+    }
+
+    void onRun(skiatest::Reporter* reporter, CCPRPathDrawer& ccpr) override {
+        const GrCCPathCache* pathCache = ccpr.ccpr()->pathCache();
+        if (!pathCache) {
+            ERRORF(reporter, "ccpr path cache not enabled");
+            return;
+        }
+        SkPath volatilePath = fPath;
+        volatilePath.setIsVolatile(true);
+
+        // The first draw renders the mask, and the cache stashes it.
+        ccpr.drawCachablePath(fPath, SkMatrix::MakeTrans(10, 10));
+        ccpr.flush();
+        REPORTER_ASSERT(reporter, 1 == pathCache->count());
+
+        // Volatile paths are never cached. The stash is evicted, since the path wasn't drawn
+        // again in the flush after it.
+        ccpr.drawPath(volatilePath);
+        ccpr.flush();
+        REPORTER_ASSERT(reporter, 0 == pathCache->count());
+
+        ccpr.drawCachablePath(fPath, SkMatrix::MakeTrans(10, 10));
+        ccpr.flush();
+        REPORTER_ASSERT(reporter, 1 == pathCache->count());
+
+        // An integer translate reuses the entry (and copies it out of the stash), as does drawing
+        // it twice in one flush. A subpixel translate makes a new one.
+        ccpr.drawCachablePath(fPath, SkMatrix::MakeTrans(30, 20));
+        ccpr.drawCachablePath(fPath, SkMatrix::MakeTrans(0, 5));
+        ccpr.drawCachablePath(fPath, SkMatrix::MakeTrans(10.5f, 10));
+        ccpr.flush();
+        REPORTER_ASSERT(reporter, 2 == pathCache->count());
+
+        // The copied entry stays when it isn't drawn. The stashed subpixel one doesn't.
+        ccpr.drawPath(volatilePath);
+        ccpr.flush();
+        REPORTER_ASSERT(reporter, 1 == pathCache->count());
+        ccpr.drawPath(volatilePath);
+        ccpr.drawCachablePath(fPath, SkMatrix::MakeTrans(-5, 40));
+        ccpr.flush();
+        REPORTER_ASSERT(reporter, 1 == pathCache->count());
+
+        // A different matrix is a different mask.
+        ccpr.drawCachablePath(fPath, SkMatrix::MakeScale(1.5f));
+        ccpr.flush();
+        REPORTER_ASSERT(reporter, 2 == pathCache->count());
+    }
+};
+DEF_CCPR_TEST(GrCCPRTest_cache)
+
+class GrCCPRTest_parallelParse : public CCPRTest {
+    void customizeContextOptions(GrContextOptions* options) override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(4);
+        options->fExecutor = fExecutor.get();
+    }
+
+    void onRun(skiatest::Reporter* reporter, CCPRPathDrawer& ccpr) override {
+        SkPath conicPath;
+        conicPath.moveTo(10, 10);
+        conicPath.conicTo(90, 10, 90, 90, 0.5f);
+        conicPath.lineTo(10, 90);
+        SkPath emptyPath;
+
+        // Enough paths to be parsed on the executor, with the same paths in more than one job.
+        for (int i = 0; i < 1000; ++i) {
+            switch (i % 3) {
+                case 0: ccpr.drawPath(fPath); break;
+                case 1: ccpr.drawPath(conicPath); break;
+                case 2: ccpr.drawPath(emptyPath); break;
+            }
+            if (0 == i % 100) {
+                ccpr.clipFullscreenRect(fPath);
+            }
+        }
+        REPORTER_ASSERT(reporter, !SkPathPriv::TestingOnly_unique(fPath));
+        ccpr.flush();
+        REPORTER_ASSERT(reporter, SkPathPriv::TestingOnly_unique(fPath));
+
+        // The executor has to outlive the context.
+        ccpr.abandonGrContext();
+        fMockContext.reset();
+    }
+
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+DEF_CCPR_TEST(GrCCPRTest_parallelParse)
+
 class CCPRRenderingTest {
 public:
     void run(skiatest::Reporter* reporter, GrContext* ctx) const {
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test.
+
+#include "Test.h"
+
+#if SK_SUPPORT_GPU && GR_GPU_STATS
+
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrGpu.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkSurface.h"
+
+// Draws a gradient, whose colors and positions are uploaded as uniforms, and reads it back.
+static void draw_gradient(SkSurface* surface, SkBitmap* result) {
+    const SkPoint pts[] = { { 0, 0 }, { 64, 64 } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                 SkShader::kClamp_TileMode));
+    surface->getCanvas()->drawRect(SkRect::MakeWH(64, 64), paint);
+    surface->readPixels(*result, 0, 0);
+}
+
+DEF_GPUTEST_FOR_GL_RENDERING_CONTEXTS(GLRedundantStateCallsAvoided, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    auto surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        return;
+    }
+    SkBitmap first, second;
+    first.allocPixels(info);
+    second.allocPixels(info);
+
+    GrGpu::Stats* stats = context->contextPriv().getGpu()->stats();
+    draw_gradient(surface.get(), &first);
+    int avoided = stats->redundantStateCallsAvoided();
+
+    // The second draw uses the same program, render target and uniform values as the first.
+    draw_gradient(surface.get(), &second);
+    REPORTER_ASSERT(reporter, stats->redundantStateCallsAvoided() > avoided);
+    REPORTER_ASSERT(reporter, 0 == memcmp(first.getPixels(), second.getPixels(),
+                                          first.computeByteSize()));
+}
+
+#endif
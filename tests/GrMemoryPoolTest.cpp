@@ -8,11 +8,16 @@
 #include "Test.h"
 // This is a GPU-backend specific test
 #if SK_SUPPORT_GPU
+#include "GrConcurrentMemoryPool.h"
 #include "GrMemoryPool.h"
 #include "SkRandom.h"
 #include "SkTArray.h"
 #include "SkTDArray.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
+#include "ops/GrOp.h"
+
+#include <thread>
 
 // A is the top of an inheritance tree of classes that overload op new and
 // and delete to use a GrMemoryPool. The objects have values of different types
@@ -398,4 +403,116 @@ DEF_TEST(GrObjectMemoryPoolAPI, reporter) {
     }
 }
 
+// Ops come from a pool per thread, and may be deleted on any thread.
+namespace {
+class PoolTestOp : public GrOp {
+public:
+    DEFINE_OP_CLASS_ID
+
+    explicit PoolTestOp(int value) : INHERITED(ClassID()), fValue(value) {
+        this->setBounds(SkRect::MakeWH(1, 1), HasAABloat::kNo, IsZeroArea::kNo);
+    }
+
+    const char* name() const override { return "PoolTestOp"; }
+    int value() const { return fValue; }
+
+private:
+    bool onCombineIfPossible(GrOp*, const GrCaps&) override { return false; }
+    void onPrepare(GrOpFlushState*) override {}
+    void onExecute(GrOpFlushState*) override {}
+
+    int fValue;
+
+    typedef GrOp INHERITED;
+};
+}  // namespace
+
+DEF_TEST(GrOpMemoryPoolThreads, reporter) {
+    constexpr int kThreads = 4, kOpsPerThread = 500;
+    std::unique_ptr<PoolTestOp> ops[kThreads][kOpsPerThread];
+
+    SkTaskGroup().batch(kThreads, [&](int t) {
+        for (int i = 0; i < kOpsPerThread; ++i) {
+            ops[t][i].reset(new PoolTestOp(t * kOpsPerThread + i));
+            // Free some on the thread that made them, and leave the rest for later.
+            if (i % 3 == 0) {
+                ops[t][i].reset();
+            }
+        }
+    });
+
+    for (int t = 0; t < kThreads; ++t) {
+        for (int i = 0; i < kOpsPerThread; ++i) {
+            if (ops[t][i]) {
+                REPORTER_ASSERT(reporter, ops[t][i]->value() == t * kOpsPerThread + i);
+            }
+        }
+    }
+
+    // Free everything else on some other thread.
+    SkTaskGroup().batch(kThreads, [&](int t) {
+        for (auto& op : ops[kThreads - 1 - t]) {
+            op.reset();
+        }
+    });
+}
+
+DEF_TEST(GrConcurrentMemoryPool, reporter) {
+    constexpr int kThreads = 4, kAllocsPerThread = 1000;
+    GrConcurrentMemoryPool pool(0, GrMemoryPool::kSmallestMinAllocSize);
+    int* allocs[kThreads][kAllocsPerThread];
+
+    auto allocate = [&](int t) {
+        SkRandom r(t);
+        for (int i = 0; i < kAllocsPerThread; ++i) {
+            // Enough space for the value, and up to a few hundred bytes more.
+            size_t size = sizeof(int) * (1 + r.nextULessThan(100));
+            allocs[t][i] = static_cast<int*>(pool.allocate(size));
+            *allocs[t][i] = t * kAllocsPerThread + i;
+            if (i % 3 == 0) {
+                pool.release(allocs[t][i]);
+                allocs[t][i] = nullptr;
+            }
+        }
+    };
+    auto check = [&] {
+        for (int t = 0; t < kThreads; ++t) {
+            for (int i = 0; i < kAllocsPerThread; ++i) {
+                if (allocs[t][i]) {
+                    REPORTER_ASSERT(reporter, *allocs[t][i] == t * kAllocsPerThread + i);
+                }
+            }
+        }
+    };
+    auto release = [&](int t) {
+        for (int*& p : allocs[t]) {
+            if (p) {
+                pool.release(p);
+                p = nullptr;
+            }
+        }
+    };
+
+    // Release what each thread allocated on another one, while the threads that allocated it
+    // still have their magazines. Then allocate again, taking the space back.
+    for (int round = 0; round < 2; ++round) {
+        SkTaskGroup().batch(kThreads, allocate);
+        check();
+        SkTaskGroup().batch(kThreads, [&](int t) { release(kThreads - 1 - t); });
+        SkDEBUGCODE(REPORTER_ASSERT(reporter, 0 == pool.allocationCount()));
+    }
+
+    // Release the allocations of threads that have exited, orphaning their magazines.
+    std::thread threads[kThreads];
+    for (int t = 0; t < kThreads; ++t) {
+        threads[t] = std::thread(allocate, t);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    check();
+    SkTaskGroup().batch(kThreads, release);
+    SkDEBUGCODE(REPORTER_ASSERT(reporter, 0 == pool.allocationCount()));
+}
+
 #endif
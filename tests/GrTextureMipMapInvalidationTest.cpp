@@ -10,6 +10,9 @@
 #if SK_SUPPORT_GPU
 
 #include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrContextPriv.h"
+#include "GrGpu.h"
 #include "GrTexturePriv.h"
 #include "SkCanvas.h"
 #include "SkImage_Base.h"
@@ -54,4 +57,40 @@ DEF_GPUTEST_FOR_NULLGL_CONTEXT(GrTextureMipMapInvalidationTest, reporter, ctxInf
     REPORTER_ASSERT(reporter, mipsAreDirty(surf1.get()));
 }
 
+// Tests that dirty MIP maps are regenerated at the start of the flush that samples them when
+// GrContextOptions::fBatchMipMapRegeneration is set.
+DEF_GPUTEST(GrTextureMipMapBatchRegenerationTest, reporter, options) {
+    GrContextOptions contextOptions = options;
+    contextOptions.fBatchMipMapRegeneration = true;
+    sk_gpu_test::GrContextFactory factory(contextOptions);
+    GrContext* context = factory.get(sk_gpu_test::GrContextFactory::kNullGL_ContextType);
+    if (!context || !context->caps()->batchMipMapRegeneration()) {
+        return;
+    }
+
+    auto info = SkImageInfo::MakeN32Premul(256, 256);
+    auto src = SkSurface::MakeRenderTarget(context, SkBudgeted::kYes, info, 0,
+                                           kTopLeft_GrSurfaceOrigin, nullptr, true);
+    auto dst = SkSurface::MakeRenderTarget(context, SkBudgeted::kYes, info);
+    src->getCanvas()->drawCircle(128, 128, 50, SkPaint());
+    src->getCanvas()->flush();
+    GrTexture* texture = src->makeImageSnapshot()->getTexture();
+    REPORTER_ASSERT(reporter, texture->texturePriv().mipMapsAreDirty());
+
+#if GR_GPU_STATS
+    int batched = context->contextPriv().getGpu()->stats()->batchedMipMapRegenerations();
+#endif
+    SkPaint paint;
+    paint.setFilterQuality(kMedium_SkFilterQuality);
+    dst->getCanvas()->scale(0.2f, 0.2f);
+    dst->getCanvas()->drawImage(src->makeImageSnapshot(), 0, 0, &paint);
+    dst->getCanvas()->flush();
+    REPORTER_ASSERT(reporter, !texture->texturePriv().mipMapsAreDirty());
+#if GR_GPU_STATS
+    REPORTER_ASSERT(reporter,
+                    batched + 1 ==
+                    context->contextPriv().getGpu()->stats()->batchedMipMapRegenerations());
+#endif
+}
+
 #endif
@@ -9,6 +9,7 @@
 #include "SkColorPriv.h"
 #include "SkColorShader.h"
 #include "SkGradientShader.h"
+#include "SkRandom.h"
 #include "SkShader.h"
 #include "SkSurface.h"
 #include "SkTemplates.h"
@@ -538,6 +539,50 @@ static void test_sweep_fuzzer(skiatest::Reporter*) {
     }
 }
 
+// Gradients with many stops sample a cached table when drawn to 8-bit destinations, but search
+// their stops when drawn to F16. Both should draw the same gradient, up to the table smoothing
+// the corners at the stops over one sample.
+static void test_many_stops_lut(skiatest::Reporter* reporter) {
+    constexpr int kStops = 50,
+                  kWidth = 512;
+    SkColor colors[kStops];
+    SkScalar pos[kStops];
+    SkRandom rand;
+    for (int i = 0; i < kStops; i++) {
+        colors[i] = rand.nextU() | 0xFF000000;
+        pos[i] = (i + rand.nextRangeScalar(-0.1f, 0.1f)) / (kStops - 1);
+    }
+    pos[0] = 0;
+    pos[kStops - 1] = 1;
+    const SkPoint pts[] = {{ 0, 0 }, { kWidth, 0 }};
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, pos, kStops,
+                                                 SkShader::kClamp_TileMode));
+
+    // Perspective keeps legacy 8888 from drawing the gradient any other way.
+    SkMatrix perspective;
+    perspective.setPerspX(1e-6f);
+
+    const SkImageInfo n32 = SkImageInfo::MakeN32Premul(kWidth, 1);
+    SkAutoTMalloc<uint32_t> lut(kWidth), searched(kWidth);
+    for (SkColorType ct : { kN32_SkColorType, kRGBA_F16_SkColorType }) {
+        auto surface = SkSurface::MakeRaster(n32.makeColorType(ct));
+        surface->getCanvas()->concat(perspective);
+        surface->getCanvas()->drawPaint(paint);
+        uint32_t* pixels = ct == kN32_SkColorType ? lut.get() : searched.get();
+        REPORTER_ASSERT(reporter, surface->readPixels(n32, pixels, kWidth * 4, 0, 0));
+    }
+
+    int maxDiff = 0;
+    for (int x = 0; x < kWidth; x++) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            int diff = SkTAbs((int)(lut[x] >> shift & 0xFF) - (int)(searched[x] >> shift & 0xFF));
+            maxDiff = SkTMax(maxDiff, diff);
+        }
+    }
+    REPORTER_ASSERT(reporter, maxDiff <= 6, "max diff %d", maxDiff);
+}
+
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestGradientOptimization(reporter);
@@ -551,4 +596,5 @@ DEF_TEST(Gradient, reporter) {
     test_degenerate_linear(reporter);
     test_linear_fuzzer(reporter);
     test_sweep_fuzzer(reporter);
+    test_many_stops_lut(reporter);
 }
@@ -7,7 +7,9 @@
 
 #include "SkChecksum.h"
 #include "SkRefCnt.h"
+#include "SkRandom.h"
 #include "SkString.h"
+#include "SkTFlatHash.h"
 #include "SkTHash.h"
 #include "Test.h"
 
@@ -177,3 +179,66 @@ DEF_TEST(HashSetCopyCounter, r) {
     // We allow copies for same-value adds for now.
     REPORTER_ASSERT(r, globalCounter == 5);
 }
+
+namespace {
+
+struct FlatEntry {
+    int key;
+    int val;
+};
+
+// Only 64 different hashes, so keys collide, fill groups and probe on past them.
+template <uint32_t kHashMask>
+struct FlatEntryTraits {
+    static int GetKey(const FlatEntry& e) { return e.key; }
+    static uint32_t Hash(int key) { return SkGoodHash()(key) & kHashMask; }
+};
+
+template <uint32_t kHashMask>
+void test_flat_hash_table(skiatest::Reporter* r) {
+    SkTFlatHashTable<FlatEntry, int, FlatEntryTraits<kHashMask>> table;
+    SkTHashMap<int, int> expected;
+    SkRandom random;
+
+    REPORTER_ASSERT(r, !table.find(0));
+    for (int i = 0; i < 5000; i++) {
+        int key = random.nextULessThan(1000);
+        if (random.nextBool() && expected.find(key)) {
+            table.remove(key);
+            expected.remove(key);
+        } else {
+            FlatEntry* e = table.set({key, i});
+            REPORTER_ASSERT(r, e->key == key && e->val == i);
+            expected.set(key, i);
+        }
+        REPORTER_ASSERT(r, table.count() == expected.count());
+    }
+
+    for (int key = 0; key < 1000; key++) {
+        FlatEntry* e = table.find(key);
+        int* val = expected.find(key);
+        REPORTER_ASSERT(r, !e == !val);
+        if (e && val) {
+            REPORTER_ASSERT(r, e->val == *val);
+        }
+    }
+    int n = 0;
+    const auto& constTable = table;
+    constTable.foreach([&](const FlatEntry& e) {
+        REPORTER_ASSERT(r, expected.find(e.key));
+        n++;
+    });
+    REPORTER_ASSERT(r, n == expected.count());
+    REPORTER_ASSERT(r, table.approxBytesUsed() > 0);
+
+    table.reset();
+    REPORTER_ASSERT(r, table.count() == 0);
+    REPORTER_ASSERT(r, !table.find(0));
+}
+
+}  // namespace
+
+DEF_TEST(FlatHashTable, r) {
+    test_flat_hash_table<0xFFFFFFFF>(r);
+    test_flat_hash_table<0x3F>(r);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test.
+
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrContextPriv.h"
+#include "GrImageAtlas.h"
+#include "GrProxyProvider.h"
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkSurface.h"
+
+static constexpr int kGridSize = 6;
+static constexpr int kImageSize = 32;
+
+static sk_sp<SkImage> make_image(int i) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kImageSize, kImageSize);
+    for (int y = 0; y < kImageSize; ++y) {
+        for (int x = 0; x < kImageSize; ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyARGB(0xFF, 7 * i, 4 * x, 4 * y);
+        }
+    }
+    bitmap.setImmutable();
+    return SkImage::MakeFromBitmap(bitmap);
+}
+
+// Draws a grid of distinct raster images for two frames and reads back the last one.
+static void draw_image_grid(GrContext* context, SkBitmap* result) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kGridSize * kImageSize, kGridSize * kImageSize);
+    auto surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        return;
+    }
+    SkTArray<sk_sp<SkImage>> images;
+    for (int i = 0; i < kGridSize * kGridSize; ++i) {
+        images.push_back(make_image(i));
+    }
+    for (int frame = 0; frame < 2; ++frame) {
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->clear(SK_ColorWHITE);
+        for (int i = 0; i < images.count(); ++i) {
+            SkRect dst = SkRect::MakeXYWH((i % kGridSize) * kImageSize,
+                                          (i / kGridSize) * kImageSize, kImageSize, kImageSize);
+            canvas->drawImageRect(images[i].get(), dst, nullptr);
+        }
+        canvas->flush();
+    }
+    result->allocPixels(info);
+    surface->readPixels(*result, 0, 0);
+}
+
+DEF_GPUTEST(ImageAtlasPacksSmallImages, reporter, options) {
+    SkBitmap results[2];
+    for (int pack = 0; pack < 2; ++pack) {
+        GrContextOptions contextOptions = options;
+        contextOptions.fPackSmallImagesInAtlas = SkToBool(pack);
+        sk_gpu_test::GrContextFactory factory(contextOptions);
+        GrContext* context = factory.get(sk_gpu_test::GrContextFactory::kGL_ContextType);
+        if (!context) {
+            return;
+        }
+        draw_image_grid(context, &results[pack]);
+        GrImageAtlas* atlas = context->contextPriv().proxyProvider()->imageAtlas();
+        if (pack) {
+            REPORTER_ASSERT(reporter, atlas);
+            REPORTER_ASSERT(reporter, kGridSize * kGridSize == atlas->numImages());
+            REPORTER_ASSERT(reporter, 1 == atlas->numPages());
+            REPORTER_ASSERT(reporter, 512 == atlas->pageSize());
+        } else {
+            REPORTER_ASSERT(reporter, !atlas);
+        }
+    }
+    if (!results[0].getPixels() || !results[1].getPixels()) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, 0 == memcmp(results[0].getPixels(), results[1].getPixels(),
+                                          results[0].computeByteSize()));
+}
+
+#endif
@@ -37,6 +37,23 @@ struct TestingRec : public SkResourceCache::Rec {
         return true;
     }
 };
+
+struct CostedTestingRec : public TestingRec {
+    CostedTestingRec(const TestingKey& key, size_t size, size_t cost)
+        : TestingRec(key, key.fValue), fSize(size), fCost(cost) {}
+
+    size_t bytesUsed() const override { return fSize; }
+    size_t regenerationCost() const override { return fCost; }
+
+    size_t fSize;
+    size_t fCost;
+};
+
+struct ConcurrentTestingRec : public TestingRec {
+    using TestingRec::TestingRec;
+
+    bool canBeFoundConcurrently() const override { return true; }
+};
 }
 
 static const int COUNT = 10;
@@ -150,3 +167,106 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+static bool in_cache(SkResourceCache& cache, intptr_t k) {
+    intptr_t value;
+    return cache.find(TestingKey(k), TestingRec::Visitor, &value);
+}
+
+DEF_TEST(ImageCache_costAware, r) {
+    // Room for 10 Recs. Even keys are expensive to make, odd ones cheap.
+    auto fill = [](SkResourceCache& cache) {
+        for (int i = 0; i < 10; ++i) {
+            cache.add(new CostedTestingRec(TestingKey(i), 100, (i & 1) ? 100 : 10000));
+        }
+        // A stream of cheap Recs we never look at again.
+        for (int i = 100; i < 110; ++i) {
+            cache.add(new CostedTestingRec(TestingKey(i), 100, 100));
+        }
+    };
+
+    SkResourceCache lru(1000);
+    fill(lru);
+    for (int i = 0; i < 10; ++i) {
+        REPORTER_ASSERT(r, !in_cache(lru, i));
+    }
+
+    SkResourceCache costAware(1000);
+    costAware.setEvictionPolicy(SkResourceCache::EvictionPolicy::kCostAware);
+    fill(costAware);
+    for (int i = 0; i < 10; ++i) {
+        REPORTER_ASSERT(r, in_cache(costAware, i) == !(i & 1));
+    }
+
+    // Expensive Recs nobody uses still age out eventually.
+    for (int i = 200; i < 1000; ++i) {
+        costAware.add(new CostedTestingRec(TestingKey(i), 100, 100));
+    }
+    for (int i = 0; i < 10; ++i) {
+        REPORTER_ASSERT(r, !in_cache(costAware, i));
+    }
+    REPORTER_ASSERT(r, costAware.getTotalBytesUsed() <= 1000);
+}
+
+DEF_TEST(ImageCache_largeRecAdmission, r) {
+    for (auto policy : { SkResourceCache::EvictionPolicy::kLRU,
+                         SkResourceCache::EvictionPolicy::kCostAware }) {
+        SkResourceCache cache(1000);
+        cache.setEvictionPolicy(policy);
+        cache.setLargeRecAdmissionLimit(300);
+
+        // The working set, and a huge Rec that would push out most of it.
+        for (int i = 0; i < 8; ++i) {
+            cache.add(new CostedTestingRec(TestingKey(i), 100, 100));
+        }
+        cache.add(new CostedTestingRec(TestingKey(100), 500, 500));
+        for (int i = 0; i < 8; ++i) {
+            REPORTER_ASSERT(r, in_cache(cache, i));
+        }
+        REPORTER_ASSERT(r, !in_cache(cache, 100));
+
+        // The second time we see it, it's admitted like anything else.
+        cache.add(new CostedTestingRec(TestingKey(100), 500, 500));
+        REPORTER_ASSERT(r, in_cache(cache, 100));
+        REPORTER_ASSERT(r, cache.getTotalBytesUsed() <= 1000);
+    }
+}
+
+#include "SkRandom.h"
+#include "SkTaskGroup.h"
+
+DEF_TEST(ImageCache_concurrentFind, r) {
+    // Look up in the global cache from many threads while they add and purge, some of the Recs
+    // taking the unlocked path and some not, and make sure nobody ever finds the wrong Rec.
+    static constexpr int kKeys = 256;
+    static constexpr int kThreads = 8;
+    static constexpr int kLookups = 20000;
+    const uint64_t sharedID = ((uint64_t)SkSetFourByteTag('t', 'e', 's', 't') << 32) | 0x1234;
+
+    std::atomic<int> wrong{0}, hits{0};
+    SkTaskGroup().batch(kThreads, [&](int thread) {
+        SkRandom rand(thread);
+        for (int i = 0; i < kLookups; ++i) {
+            intptr_t k = rand.nextULessThan(kKeys);
+            TestingKey key(k, sharedID);
+            intptr_t value = -1;
+            if (SkResourceCache::Find(key, TestingRec::Visitor, &value)) {
+                hits++;
+                if (value != k) {
+                    wrong++;
+                }
+            } else if (k & 1) {
+                SkResourceCache::Add(new ConcurrentTestingRec(key, k));
+            } else {
+                SkResourceCache::Add(new TestingRec(key, k));
+            }
+            if (thread == 0 && i % 1000 == 999) {
+                SkResourceCache::PostPurgeSharedID(sharedID);
+            }
+        }
+    });
+    REPORTER_ASSERT(r, wrong == 0);
+    REPORTER_ASSERT(r, hits > 0);
+
+    SkResourceCache::PostPurgeSharedID(sharedID);
+}
@@ -8,13 +8,17 @@
 #include "Test.h"
 
 #include "SkBitmap.h"
+#include "SkBlurImageFilter.h"
+#include "SkCanvas.h"
 #include "SkColorFilter.h"
 #include "SkColorFilterImageFilter.h"
+#include "SkColorPriv.h"
 #include "SkImage.h"
 #include "SkImageFilter.h"
 #include "SkImageFilterCache.h"
 #include "SkMatrix.h"
 #include "SkSpecialImage.h"
+#include "SkSurface.h"
 
 static const int kSmallerSize = 10;
 static const int kPad = 3;
@@ -164,6 +168,157 @@ DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     test_explicit_purging(reporter, fullImg, subsetImg);
 }
 
+// A cache with a tile size keeps filtered tiles, which requests with overlapping clips share.
+DEF_TEST(ImageFilterCache_Tiles, reporter) {
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(100, 100);
+    srcBM.eraseColor(SK_ColorRED);
+    sk_sp<SkSpecialImage> srcImg(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(100, 100),
+                                                                srcBM));
+
+    static const size_t kCacheSize = 1000000;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize, 16));
+    REPORTER_ASSERT(reporter, 16 == cache->tileSize());
+    auto filter = make_filter();
+
+    auto check = [&](const SkIRect& clip, int expectedCount) {
+        SkImageFilter::OutputProperties noColorSpace(nullptr);
+        SkImageFilter::Context ctx(SkMatrix::I(), clip, cache.get(), noColorSpace);
+        SkIPoint offset;
+        sk_sp<SkSpecialImage> result(filter->filterImageTiled(srcImg.get(), ctx, &offset,
+                                                              nullptr));
+        REPORTER_ASSERT(reporter, result);
+        REPORTER_ASSERT(reporter, SkIRect::MakeXYWH(offset.x(), offset.y(), result->width(),
+                                                    result->height()) == clip);
+        SkBitmap resultBM;
+        REPORTER_ASSERT(reporter, result->getROPixels(&resultBM));
+        const SkIRect& subset = result->subset();
+        for (int y = subset.fTop; y < subset.fBottom; ++y) {
+            for (int x = subset.fLeft; x < subset.fRight; ++x) {
+                if (SK_ColorBLUE != resultBM.getColor(x, y)) {
+                    ERRORF(reporter, "wrong color at %d, %d", x, y);
+                    return;
+                }
+            }
+        }
+        SkDEBUGCODE(REPORTER_ASSERT(reporter, expectedCount == cache->count());)
+    };
+
+    check(SkIRect::MakeWH(40, 40), 9);
+    // Scrolling within the same tiles filters nothing new.
+    check(SkIRect::MakeXYWH(8, 0, 40, 40), 9);
+    // Scrolling further filters only the new column of tiles.
+    check(SkIRect::MakeXYWH(20, 0, 40, 40), 12);
+}
+
+// Pixels of a pattern with no two columns alike, from x to x + w.
+static SkBitmap make_scrolled_content(int x, int w, int h) {
+    SkBitmap bm;
+    bm.allocN32Pixels(w, h);
+    for (int j = 0; j < h; ++j) {
+        for (int i = 0; i < w; ++i) {
+            *bm.getAddr32(i, j) = SkPackARGB32(0xFF, ((x + i) * 7) & 0xFF, (j * 13) & 0xFF,
+                                               (((x + i) ^ j) * 5) & 0xFF);
+        }
+    }
+    return bm;
+}
+
+// Does b, placed at offsetB, have a's pixels wherever a, placed at offsetA, covers?
+static bool covers_same_pixels(const SkSpecialImage* a, const SkIPoint& offsetA,
+                               const SkSpecialImage* b, const SkIPoint& offsetB) {
+    SkBitmap bmA, bmB;
+    const SkIRect boundsA = SkIRect::MakeXYWH(offsetA.x(), offsetA.y(), a->width(), a->height());
+    if (!SkIRect::MakeXYWH(offsetB.x(), offsetB.y(), b->width(), b->height()).contains(boundsA) ||
+        !a->getROPixels(&bmA) || !b->getROPixels(&bmB)) {
+        return false;
+    }
+    for (int y = boundsA.fTop; y < boundsA.fBottom; ++y) {
+        for (int x = boundsA.fLeft; x < boundsA.fRight; ++x) {
+            if (*bmA.getAddr32(a->subset().fLeft + x - offsetA.x(),
+                               a->subset().fTop  + y - offsetA.y()) !=
+                *bmB.getAddr32(b->subset().fLeft + x - offsetB.x(),
+                               b->subset().fTop  + y - offsetB.y())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// A scrolled layer is drawn anew, and its CTM moves, but its tiles whose input is unchanged are
+// found in the cache again.
+DEF_TEST(ImageFilterCache_TilesScrolled, reporter) {
+    const int kW = 96, kH = 64;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(1000000, 16));
+    // Each tile reads 6 pixels past its edges.
+    sk_sp<SkImageFilter> blur = SkBlurImageFilter::Make(2, 2, nullptr);
+
+    auto draw = [&](int scroll, int expectedCount) {
+        SkBitmap layer = make_scrolled_content(scroll, kW, kH);
+        sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kW, kH), layer));
+        SkImageFilter::OutputProperties noColorSpace(nullptr);
+        const SkMatrix ctm = SkMatrix::MakeTrans(SkIntToScalar(-scroll), 0);
+
+        SkImageFilter::Context ctx(ctm, SkIRect::MakeWH(kW, kH), cache.get(), noColorSpace);
+        SkIPoint offset;
+        sk_sp<SkSpecialImage> result(blur->filterImageTiled(src.get(), ctx, &offset, nullptr));
+        REPORTER_ASSERT(reporter, result && offset == SkIPoint::Make(0, 0));
+        SkDEBUGCODE(REPORTER_ASSERT(reporter, expectedCount == cache->count(),
+                                    "scroll %d: %d tiles cached", scroll, cache->count());)
+
+        SkImageFilter::Context uncached(ctm, SkIRect::MakeWH(kW, kH), nullptr, noColorSpace);
+        SkIPoint expectedOffset;
+        sk_sp<SkSpecialImage> expected(blur->filterImage(src.get(), uncached, &expectedOffset));
+        REPORTER_ASSERT(reporter, result && expected &&
+                                  covers_same_pixels(result.get(), offset,
+                                                     expected.get(), expectedOffset),
+                        "scroll %d: tiled result differs", scroll);
+    };
+
+    draw(0, 24);
+    // Drawing again finds every tile.
+    draw(0, 24);
+    // Of the 24 tiles scrolled 32 pixels, the two interior columns read the same content as
+    // before. The rest read pixels that are new, or were outside the layer before.
+    draw(32, 40);
+    // Scrolling back by whole tiles finds them all again.
+    draw(0, 40);
+}
+
+// Surfaces made with kCacheImageFilterTiles_Flag draw filtered layers the same as others.
+DEF_TEST(ImageFilterCache_TilesSurface, reporter) {
+    const int kW = 96, kH = 64;
+    SkBitmap content = make_scrolled_content(0, 2 * kW, kH);
+    SkPaint layerPaint;
+    layerPaint.setImageFilter(SkBlurImageFilter::Make(2, 2, nullptr));
+
+    SkSurfaceProps tiledProps(SkSurfaceProps::kCacheImageFilterTiles_Flag,
+                              kUnknown_SkPixelGeometry);
+    sk_sp<SkSurface> tiled = SkSurface::MakeRasterN32Premul(kW, kH, &tiledProps),
+                     plain = SkSurface::MakeRasterN32Premul(kW, kH);
+    for (int scroll : { 0, 16, 40, 16 }) {
+        for (SkSurface* surface : { tiled.get(), plain.get() }) {
+            SkCanvas* canvas = surface->getCanvas();
+            canvas->clear(SK_ColorWHITE);
+            canvas->save();
+            canvas->translate(SkIntToScalar(-scroll), 0);
+            canvas->saveLayer(nullptr, &layerPaint);
+            canvas->drawBitmap(content, 0, 0);
+            canvas->restore();
+            canvas->restore();
+        }
+
+        SkBitmap tiledBM, plainBM;
+        tiledBM.allocN32Pixels(kW, kH);
+        plainBM.allocN32Pixels(kW, kH);
+        REPORTER_ASSERT(reporter, tiled->readPixels(tiledBM, 0, 0) &&
+                                  plain->readPixels(plainBM, 0, 0));
+        REPORTER_ASSERT(reporter, !memcmp(tiledBM.getPixels(), plainBM.getPixels(),
+                                          tiledBM.computeByteSize()),
+                        "scroll %d: tiled surface differs", scroll);
+    }
+}
 
 // Shared test code for both the raster and gpu-backed image cases
 static void test_image_backed(skiatest::Reporter* reporter, const sk_sp<SkImage>& srcImage) {
@@ -9,12 +9,14 @@
 #include "SkBitmap.h"
 #include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkColorFilterImageFilter.h"
 #include "SkColorMatrixFilter.h"
 #include "SkColorSpaceXformer.h"
 #include "SkComposeImageFilter.h"
 #include "SkDisplacementMapEffect.h"
 #include "SkDropShadowImageFilter.h"
+#include "SkExecutor.h"
 #include "SkGradientShader.h"
 #include "SkImage.h"
 #include "SkImageFilterPriv.h"
@@ -30,6 +32,7 @@
 #include "SkPictureImageFilter.h"
 #include "SkPictureRecorder.h"
 #include "SkPoint3.h"
+#include "SkRandom.h"
 #include "SkReadBuffer.h"
 #include "SkRect.h"
 #include "SkSpecialImage.h"
@@ -993,6 +996,189 @@ DEF_TEST(ImageFilterMergeResultSize, reporter) {
     test_imagefilter_merge_result_size(reporter, nullptr);
 }
 
+static SkBitmap draw_filter_result(const SkSpecialImage* result, const SkIPoint& offset,
+                                   int size) {
+    SkBitmap bm;
+    bm.allocN32Pixels(size, size);
+    SkCanvas canvas(bm);
+    canvas.clear(0x0);
+    if (result) {
+        result->draw(&canvas, SkIntToScalar(offset.x()), SkIntToScalar(offset.y()), nullptr);
+    }
+    return bm;
+}
+
+static bool nearly_equal(const SkBitmap& a, const SkBitmap& b, int tolerance) {
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            SkPMColor ca = *a.getAddr32(x, y), cb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                if (SkTAbs((int)((ca >> shift) & 0xFF) - (int)((cb >> shift) & 0xFF)) > tolerance) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Merge and xfermode filters apply color filter inputs as they composite them. The results must
+// match those of color filter nodes that make their own images, which a crop rect forces.
+DEF_TEST(ImageFilterFusedColorFilter, reporter) {
+    const int kSize = 64;
+    sk_sp<SkSpecialSurface> surf(SkSpecialSurface::MakeRaster(
+            SkImageInfo::MakeN32Premul(kSize, kSize)));
+    SkCanvas* canvas = surf->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    canvas->drawCircle(24, 24, 20, paint);
+    paint.setColor(0x8000FF00);
+    canvas->drawRect(SkRect::MakeLTRB(30, 8, 60, 56), paint);
+    sk_sp<SkSpecialImage> srcImg(surf->makeImageSnapshot());
+
+    SkImageFilter::CropRect noCrop(SkRect::MakeLTRB(-100, -100, 200, 200));
+    auto make_inputs = [](const SkImageFilter::CropRect* crop, sk_sp<SkImageFilter> inputs[2]) {
+        inputs[0] = make_grayscale(nullptr, crop);
+        inputs[1] = make_blue(SkBlurImageFilter::Make(2, 2, nullptr), crop);
+    };
+    sk_sp<SkImageFilter> fused[2], unfused[2];
+    make_inputs(nullptr, fused);
+    make_inputs(&noCrop, unfused);
+    REPORTER_ASSERT(reporter, fused[0]->isColorFilterNode(nullptr));
+    REPORTER_ASSERT(reporter, !unfused[0]->isColorFilterNode(nullptr));
+
+    SkImageFilter::OutputProperties noColorSpace(nullptr);
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                               noColorSpace);
+    auto check = [&](const sk_sp<SkImageFilter>& a, const sk_sp<SkImageFilter>& b) {
+        SkIPoint offsetA, offsetB;
+        sk_sp<SkSpecialImage> resultA(a->filterImage(srcImg.get(), ctx, &offsetA));
+        sk_sp<SkSpecialImage> resultB(b->filterImage(srcImg.get(), ctx, &offsetB));
+        REPORTER_ASSERT(reporter, nearly_equal(draw_filter_result(resultA.get(), offsetA, kSize),
+                                               draw_filter_result(resultB.get(), offsetB, kSize),
+                                               2));
+    };
+    check(SkMergeImageFilter::Make(fused[0], fused[1]),
+          SkMergeImageFilter::Make(unfused[0], unfused[1]));
+    for (SkBlendMode mode : { SkBlendMode::kSrcOver, SkBlendMode::kMultiply,
+                              SkBlendMode::kDstIn, SkBlendMode::kXor }) {
+        check(SkXfermodeImageFilter::Make(mode, fused[0], fused[1], nullptr),
+              SkXfermodeImageFilter::Make(mode, unfused[0], unfused[1], nullptr));
+    }
+}
+
+DEF_TEST(ImageFilterTiled, reporter) {
+    const int kSize = 100;
+    sk_sp<SkSpecialSurface> surf(SkSpecialSurface::MakeRaster(
+            SkImageInfo::MakeN32Premul(kSize, kSize)));
+    SkCanvas* canvas = surf->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    canvas->drawCircle(40, 40, 30, paint);
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawRect(SkRect::MakeLTRB(50, 10, 90, 90), paint);
+    sk_sp<SkSpecialImage> srcImg(surf->makeImageSnapshot());
+
+    // blur -> color matrix -> merge, as big layers often use.
+    sk_sp<SkImageFilter> blur(SkBlurImageFilter::Make(3, 3, nullptr));
+    sk_sp<SkImageFilter> merge(SkMergeImageFilter::Make(make_scale(0.5f, blur),
+                                                        make_grayscale(nullptr, nullptr)));
+
+    SkImageFilter::OutputProperties noColorSpace(nullptr);
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                               noColorSpace);
+    SkIPoint offset;
+    sk_sp<SkSpecialImage> expected(merge->filterImage(srcImg.get(), ctx, &offset));
+    SkBitmap expectedBM = draw_filter_result(expected.get(), offset, kSize);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkExecutor* exec : { (SkExecutor*)nullptr, executor.get() }) {
+        for (int tileSize : { 16, 33, 100 }) {
+            SkIPoint tiledOffset;
+            sk_sp<SkSpecialImage> tiled(merge->filterImageTiled(srcImg.get(), ctx, &tiledOffset,
+                                                                exec, tileSize));
+            REPORTER_ASSERT(reporter, tiled);
+            SkBitmap tiledBM = draw_filter_result(tiled.get(), tiledOffset, kSize);
+            for (int y = 0; y < kSize; ++y) {
+                if (memcmp(expectedBM.getAddr32(0, y), tiledBM.getAddr32(0, y), kSize * 4)) {
+                    ERRORF(reporter, "tiles of %d differ at row %d", tileSize, y);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(ImageFilterBands, reporter) {
+    const int kSize = 150;
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(kSize, kSize);
+    SkRandom rand;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            *srcBM.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    sk_sp<SkSpecialImage> srcImg(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kSize, kSize),
+                                                                srcBM));
+
+    // The radius takes dilation through its per-window path, rather than the per-pixel one.
+    const int kRadius = 9;
+    SkScalar kernel[9] = { 1, 1, 1, 1, -7, 1, 1, 1, 1 };
+    sk_sp<SkImageFilter> filters[] = {
+        SkDilateImageFilter::Make(kRadius, kRadius, nullptr),
+        SkErodeImageFilter::Make(kRadius, 0, nullptr),
+        SkMatrixConvolutionImageFilter::Make(SkISize::Make(3, 3), kernel, 0.3f, 100,
+                                             SkIPoint::Make(1, 1),
+                                             SkMatrixConvolutionImageFilter::kRepeat_TileMode,
+                                             true, nullptr),
+    };
+
+    SkImageFilter::OutputProperties noColorSpace(nullptr);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                               noColorSpace);
+    SkImageFilter::Context bandCtx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                   noColorSpace, executor.get());
+    for (const sk_sp<SkImageFilter>& filter : filters) {
+        SkIPoint offset, bandOffset;
+        sk_sp<SkSpecialImage> expected(filter->filterImage(srcImg.get(), ctx, &offset));
+        sk_sp<SkSpecialImage> banded(filter->filterImage(srcImg.get(), bandCtx, &bandOffset));
+        REPORTER_ASSERT(reporter, expected && banded);
+        SkBitmap expectedBM = draw_filter_result(expected.get(), offset, kSize);
+        SkBitmap bandedBM = draw_filter_result(banded.get(), bandOffset, kSize);
+        for (int y = 0; y < kSize; ++y) {
+            if (memcmp(expectedBM.getAddr32(0, y), bandedBM.getAddr32(0, y), kSize * 4)) {
+                ERRORF(reporter, "%s differs in bands at row %d", filter->getTypeName(), y);
+                break;
+            }
+        }
+    }
+
+    // Every dilated pixel is the largest of its window, clipped to the image.
+    SkIPoint offset;
+    sk_sp<SkSpecialImage> dilated(filters[0]->filterImage(srcImg.get(), bandCtx, &offset));
+    SkBitmap dilatedBM = draw_filter_result(dilated.get(), offset, kSize);
+    for (int y = 0; y < kSize; y += 7) {
+        for (int x = 0; x < kSize; x += 5) {
+            SkPMColor expected = 0;
+            for (int v = SkTMax(y - kRadius, 0); v <= SkTMin(y + kRadius, kSize - 1); ++v) {
+                for (int u = SkTMax(x - kRadius, 0); u <= SkTMin(x + kRadius, kSize - 1); ++u) {
+                    SkPMColor c = *srcBM.getAddr32(u, v);
+                    expected = SkPackARGB32NoCheck(
+                            SkTMax(SkGetPackedA32(expected), SkGetPackedA32(c)),
+                            SkTMax(SkGetPackedR32(expected), SkGetPackedR32(c)),
+                            SkTMax(SkGetPackedG32(expected), SkGetPackedG32(c)),
+                            SkTMax(SkGetPackedB32(expected), SkGetPackedB32(c)));
+                }
+            }
+            REPORTER_ASSERT(reporter, expected == *dilatedBM.getAddr32(x, y));
+        }
+    }
+}
+
 #if SK_SUPPORT_GPU
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageFilterMergeResultSize_Gpu, reporter, ctxInfo) {
     test_imagefilter_merge_result_size(reporter, ctxInfo.grContext());
@@ -8,8 +8,10 @@
 #include "SkData.h"
 #include "SkCanvas.h"
 #include "SkGraphics.h"
+#include "SkImage.h"
 #include "SkImageGenerator.h"
 #include "SkImageInfoPriv.h"
+#include "SkImagePriv.h"
 #include "Test.h"
 
 static bool gMyFactoryWasCalled;
@@ -113,3 +115,54 @@ DEF_TEST(PictureImageGenerator, reporter) {
     }
 }
 
+
+static int gSolidDecodes;
+
+class SolidGenerator : public SkImageGenerator {
+public:
+    SolidGenerator() : SkImageGenerator(SkImageInfo::MakeN32Premul(4, 4)) {}
+
+protected:
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     const Options&) override {
+        gSolidDecodes++;
+        SkPixmap pm(info, pixels, rowBytes);
+        return pm.erase(SK_ColorBLUE);
+    }
+};
+
+static std::unique_ptr<SkImageGenerator> solid_factory(sk_sp<SkData>) {
+    return std::unique_ptr<SkImageGenerator>(new SolidGenerator);
+}
+
+DEF_TEST(ImageGenerator_sharedEncoded, reporter) {
+    // A cache of our own, so no other test sees SolidGenerators or shared images.
+    SkSharedEncodedImageCache cache(8, solid_factory);
+
+    sk_sp<SkImage> a = cache.makeImage(SkData::MakeWithCString("logo"), nullptr),
+                   b = cache.makeImage(SkData::MakeWithCString("logo"), nullptr),
+                   c = cache.makeImage(SkData::MakeWithCString("avatar"), nullptr);
+    REPORTER_ASSERT(reporter, a && b && c);
+    REPORTER_ASSERT(reporter, a->uniqueID() == b->uniqueID());
+    REPORTER_ASSERT(reporter, a->uniqueID() != c->uniqueID());
+
+    // b finds a's decode in the cache.
+    gSolidDecodes = 0;
+    SkPMColor pixels[16];
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(4, 4);
+    REPORTER_ASSERT(reporter, a->readPixels(info, pixels, 16, 0, 0));
+    REPORTER_ASSERT(reporter, b->readPixels(info, pixels, 16, 0, 0));
+    REPORTER_ASSERT(reporter, 1 == gSolidDecodes);
+
+    // Purging forgets the bytes, but not the images made from them.
+    cache.purgeAll();
+    sk_sp<SkImage> d = cache.makeImage(SkData::MakeWithCString("logo"), nullptr);
+    REPORTER_ASSERT(reporter, d && d->uniqueID() != a->uniqueID());
+    REPORTER_ASSERT(reporter, a->uniqueID() == b->uniqueID());
+    sk_sp<SkImage> e = cache.makeImage(SkData::MakeWithCString("logo"), nullptr);
+    REPORTER_ASSERT(reporter, e && e->uniqueID() == d->uniqueID());
+
+    REPORTER_ASSERT(reporter, 8 == cache.setCountLimit(0));
+    sk_sp<SkImage> f = cache.makeImage(SkData::MakeWithCString("logo"), nullptr);
+    REPORTER_ASSERT(reporter, f && f->uniqueID() != d->uniqueID());
+}
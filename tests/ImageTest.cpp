@@ -14,6 +14,7 @@
 #include "SkCanvas.h"
 #include "SkColorSpacePriv.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkImageEncoder.h"
 #include "SkImageGenerator.h"
 #include "SkImage_Base.h"
@@ -22,6 +23,7 @@
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkRRect.h"
+#include "SkSemaphore.h"
 #include "SkSerialProcs.h"
 #include "SkStream.h"
 #include "SkSurface.h"
@@ -191,6 +193,42 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageEncode_Gpu, reporter, ctxInfo) {
 }
 #endif
 
+DEF_TEST(Image_makeDecodedAsync, reporter) {
+    sk_sp<SkImage> lazy = SkImage::MakeFromEncoded(GetResourceAsData("images/mandrill_128.png"));
+    if (!lazy) {
+        ERRORF(reporter, "Missing images/mandrill_128.png");
+        return;
+    }
+    auto executor = SkExecutor::MakeFIFOThreadPool(1);
+    SkSemaphore done;
+    sk_sp<SkImage> decoded;
+    lazy->makeDecodedAsync(executor.get(), nullptr, [&](sk_sp<SkImage> image) {
+        decoded = std::move(image);
+        done.signal();
+    });
+    done.wait();
+    REPORTER_ASSERT(reporter, decoded && !decoded->isLazyGenerated());
+    if (!decoded) {
+        return;
+    }
+
+    SkPixmap decodedPixels;
+    REPORTER_ASSERT(reporter, decoded->peekPixels(&decodedPixels));
+    SkBitmap expected;
+    expected.allocPixels(decodedPixels.info());
+    REPORTER_ASSERT(reporter, lazy->readPixels(expected.pixmap(), 0, 0));
+    REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), decodedPixels.addr(),
+                                      expected.computeByteSize()));
+
+    // Images that are not lazy are passed back right away.
+    sk_sp<SkImage> raster = create_image();
+    sk_sp<SkImage> result;
+    raster->makeDecodedAsync(executor.get(), nullptr, [&](sk_sp<SkImage> image) {
+        result = std::move(image);
+    });
+    REPORTER_ASSERT(reporter, result == raster);
+}
+
 DEF_TEST(Image_MakeFromRasterBitmap, reporter) {
     const struct {
         SkCopyPixelsMode fCPM;
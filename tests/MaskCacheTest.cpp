@@ -102,3 +102,30 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+DEF_TEST(BlurProfileCache, reporter) {
+    SkResourceCache cache(1024);
+
+    SkScalar sigma = 4;
+    SkCachedData* data = SkMaskCache::FindAndRefProfile(sigma, &cache);
+    REPORTER_ASSERT(reporter, nullptr == data);
+
+    size_t size = 24;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    SkMaskCache::AddProfile(sigma, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    data->unref();
+    check_data(reporter, data, 1, kInCache, kUnlocked);
+
+    REPORTER_ASSERT(reporter, nullptr == SkMaskCache::FindAndRefProfile(2 * sigma, &cache));
+    data = SkMaskCache::FindAndRefProfile(sigma, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, data->size() == size);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    cache.purgeAll();
+    check_data(reporter, data, 1, kNotInCache, kLocked);
+    data->unref();
+}
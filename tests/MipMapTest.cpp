@@ -202,3 +202,51 @@ DEF_TEST(MipMap_ComputeLevelSize, reporter) {
         REPORTER_ASSERT(reporter, currentTest.fExpectedMipMapLevelSize == levelSize);
     }
 }
+
+// Levels large enough to be filtered in bands must match filtering each pixel on its own.
+DEF_TEST(MipMap_Bands, reporter) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(1030, 1030, kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+    SkRandom rand;
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 0; x < bm.width(); x++) {
+            *bm.getAddr32(x, y) = rand.nextU();
+        }
+    }
+    sk_sp<SkMipMap> mm(SkMipMap::Build(bm, SkDestinationSurfaceColorMode::kLegacy, nullptr));
+    SkMipMap::Level level;
+    REPORTER_ASSERT(reporter, mm && mm->getLevel(0, &level));
+
+    const SkPixmap& pm = level.fPixmap;
+    for (int y = 0; y < pm.height(); y++) {
+        for (int x = 0; x < pm.width(); x++) {
+            uint32_t expected = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                uint32_t sum = 0;
+                for (int i = 0; i < 4; i++) {
+                    sum += (*bm.getAddr32(2 * x + (i & 1), 2 * y + (i >> 1)) >> shift) & 0xFF;
+                }
+                expected |= (sum >> 2) << shift;
+            }
+            if (*pm.addr32(x, y) != expected) {
+                ERRORF(reporter, "(%d, %d): %08x != %08x", x, y, *pm.addr32(x, y), expected);
+                return;
+            }
+        }
+    }
+}
+
+DEF_TEST(MipMap_MaxLevelCount, reporter) {
+    SkBitmap bm;
+    make_bitmap(&bm, 100, 100);
+    sk_sp<SkMipMap> mm(SkMipMap::Build(bm, SkDestinationSurfaceColorMode::kLegacy, nullptr, 2));
+    REPORTER_ASSERT(reporter, mm && mm->countLevels() == 2);
+
+    SkMipMap::Level level;
+    REPORTER_ASSERT(reporter, mm->extractLevel(SkSize::Make(0.1f, 0.1f), &level));
+    REPORTER_ASSERT(reporter, level.fPixmap.width() == 25);
+
+    REPORTER_ASSERT(reporter, SkMipMap::ComputeLevelCountForScale(SkSize::Make(0.6f, 0.6f)) == 0);
+    REPORTER_ASSERT(reporter, SkMipMap::ComputeLevelCountForScale(SkSize::Make(0.3f, 0.3f)) == 1);
+    REPORTER_ASSERT(reporter, SkMipMap::ComputeLevelCountForScale(SkSize::Make(0.2f, 0.2f)) == 2);
+}
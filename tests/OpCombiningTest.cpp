@@ -0,0 +1,172 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTypes.h"
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+#include "GrAuditTrail.h"
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrContextPriv.h"
+#include "GrFixedClip.h"
+#include "GrRenderTargetContext.h"
+#include "GrRenderTargetContextPriv.h"
+#include "ops/GrDrawOp.h"
+
+namespace {
+// Combines with any other op that combines, and counts how often it did.
+class CombiningTestOp final : public GrDrawOp {
+public:
+    DEFINE_OP_CLASS_ID
+
+    static std::unique_ptr<GrDrawOp> Make(const SkRect& bounds, bool combines, int* combineCount) {
+        return std::unique_ptr<GrDrawOp>(new CombiningTestOp(bounds, combines, combineCount));
+    }
+
+    const char* name() const override { return "CombiningTestOp"; }
+
+    FixedFunctionFlags fixedFunctionFlags() const override { return FixedFunctionFlags::kNone; }
+
+    RequiresDstTexture finalize(const GrCaps&, const GrAppliedClip*,
+                                GrPixelConfigIsClamped) override {
+        return RequiresDstTexture::kNo;
+    }
+
+private:
+    CombiningTestOp(const SkRect& bounds, bool combines, int* combineCount)
+            : INHERITED(ClassID()), fCombines(combines), fCombineCount(combineCount) {
+        this->setBounds(bounds, HasAABloat::kNo, IsZeroArea::kNo);
+    }
+
+    bool onCombineIfPossible(GrOp* t, const GrCaps&) override {
+        CombiningTestOp* that = t->cast<CombiningTestOp>();
+        if (!fCombines || !that->fCombines) {
+            return false;
+        }
+        this->joinBounds(*that);
+        ++*fCombineCount;
+        return true;
+    }
+
+    void onPrepare(GrOpFlushState*) override {}
+    void onExecute(GrOpFlushState*) override {}
+
+    bool fCombines;
+    int* fCombineCount;
+
+    typedef GrDrawOp INHERITED;
+};
+}  // namespace
+
+DEF_GPUTEST(IndexedOpCombining, reporter, options) {
+    for (bool indexOpBounds : { false, true }) {
+        GrContextOptions contextOptions = options;
+        contextOptions.fIndexOpBoundsForCombining = indexOpBounds;
+        sk_gpu_test::GrContextFactory factory(contextOptions);
+        GrContext* context = factory.get(sk_gpu_test::GrContextFactory::kMock_ContextType);
+        if (!context) {
+            continue;
+        }
+
+        sk_sp<GrRenderTargetContext> rtc(context->contextPriv().makeDeferredRenderTargetContext(
+                SkBackingFit::kExact, 256, 256, kRGBA_8888_GrPixelConfig, nullptr));
+        if (!rtc) {
+            ERRORF(reporter, "could not create render target context.");
+            return;
+        }
+
+        int combineCount = 0;
+        auto addOp = [&](const SkRect& bounds, bool combines) {
+            rtc->priv().testingOnly_addDrawOp(
+                    CombiningTestOp::Make(bounds, combines, &combineCount));
+        };
+
+        // More ops than we look back over between two that could combine...
+        addOp(SkRect::MakeXYWH(0, 0, 10, 10), true);
+        for (int i = 0; i < 20; ++i) {
+            addOp(SkRect::MakeXYWH(100, 100, 10, 10), false);
+        }
+        addOp(SkRect::MakeXYWH(20, 0, 10, 10), true);
+        REPORTER_ASSERT(reporter, combineCount == (indexOpBounds ? 1 : 0));
+
+        // ... but never past one they overlap.
+        addOp(SkRect::MakeXYWH(40, 0, 10, 10), false);
+        addOp(SkRect::MakeXYWH(45, 0, 10, 10), true);
+        REPORTER_ASSERT(reporter, combineCount == (indexOpBounds ? 1 : 0));
+
+        context->flush();
+    }
+}
+
+DEF_GPUTEST(OpCombiningAuditStats, reporter, options) {
+    sk_gpu_test::GrContextFactory factory(options);
+    GrContext* context = factory.get(sk_gpu_test::GrContextFactory::kMock_ContextType);
+    if (!context) {
+        return;
+    }
+    auto makeRTC = [&]() {
+        return context->contextPriv().makeDeferredRenderTargetContext(
+                SkBackingFit::kExact, 512, 512, kRGBA_8888_GrPixelConfig, nullptr);
+    };
+    sk_sp<GrRenderTargetContext> rtc(makeRTC());
+    if (!rtc) {
+        ERRORF(reporter, "could not create render target context.");
+        return;
+    }
+
+    GrAuditTrail* auditTrail = context->contextPriv().getAuditTrail();
+    GrAuditTrail::AutoManageOpList enable(auditTrail);
+    const GrAuditTrail::CombineStats& stats = auditTrail->combineStats();
+
+    int combineCount = 0;
+    auto addOp = [&](GrRenderTargetContext* rtc, const SkRect& bounds, bool combines) {
+        rtc->priv().testingOnly_addDrawOp(CombiningTestOp::Make(bounds, combines, &combineCount));
+    };
+
+    addOp(rtc.get(), SkRect::MakeXYWH(0, 0, 10, 10), true);
+    // Refused by the op itself.
+    addOp(rtc.get(), SkRect::MakeXYWH(100, 100, 10, 10), false);
+    REPORTER_ASSERT(reporter, 1 == stats.fAttempts && 1 == stats.fOpRefused);
+    // A scissored op can't combine with either of the unscissored ones.
+    GrFixedClip scissor(SkIRect::MakeWH(25, 25));
+    rtc->priv().testingOnly_addDrawOp(
+            scissor, CombiningTestOp::Make(SkRect::MakeXYWH(20, 0, 10, 10), true, &combineCount));
+    REPORTER_ASSERT(reporter, 3 == stats.fAttempts && 2 == stats.fPipelineMismatch);
+    REPORTER_ASSERT(reporter, 0 == stats.fStoppedAtOverlap && 0 == stats.fStoppedAtLimit);
+    // Passes the scissored op, is refused by the one it overlaps, and stops there.
+    addOp(rtc.get(), SkRect::MakeXYWH(105, 105, 10, 10), true);
+    REPORTER_ASSERT(reporter, 5 == stats.fAttempts);
+    REPORTER_ASSERT(reporter, 3 == stats.fPipelineMismatch && 2 == stats.fOpRefused);
+    REPORTER_ASSERT(reporter, 1 == stats.fStoppedAtOverlap);
+    REPORTER_ASSERT(reporter, 0 == stats.fCombined && 0 == combineCount);
+
+    // In a fresh opList, twelve ops that never combine or overlap: the last one is the only one
+    // to run out of lookback before it runs out of ops. Flush first, so that closing the first
+    // opList doesn't add its forward combining to what we count.
+    context->flush();
+    sk_sp<GrRenderTargetContext> rtc2(makeRTC());
+    const GrAuditTrail::CombineStats before = stats;
+    combineCount = 0;
+    for (int i = 0; i < 12; ++i) {
+        addOp(rtc2.get(), SkRect::MakeXYWH(20 * i, 300, 10, 10), false);
+    }
+    REPORTER_ASSERT(reporter, stats.fAttempts - before.fAttempts == 65);
+    REPORTER_ASSERT(reporter, stats.fOpRefused - before.fOpRefused == 65);
+    REPORTER_ASSERT(reporter, stats.fStoppedAtLimit - before.fStoppedAtLimit == 1);
+
+    // Ops that do combine are counted, and it all shows up in the JSON.
+    addOp(rtc2.get(), SkRect::MakeXYWH(0, 400, 10, 10), true);
+    addOp(rtc2.get(), SkRect::MakeXYWH(20, 400, 10, 10), true);
+    REPORTER_ASSERT(reporter, stats.fCombined - before.fCombined == 1 && 1 == combineCount);
+    SkString combined = SkStringPrintf("\"Combined\": %d,", stats.fCombined);
+    REPORTER_ASSERT(reporter, auditTrail->toJson().contains(combined.c_str()));
+
+    context->flush();
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "OverdrawAnalysis.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkPictureRecorder.h"
+#include "SkStream.h"
+#include "Test.h"
+
+#include <cstring>
+
+DEF_TEST(OverdrawAnalysis, r) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    SkPaint paint;
+    canvas->drawRect(SkRect::MakeWH(50, 50), paint);
+
+    // Half the rect is drawn twice.
+    paint.setAlpha(0x80);
+    canvas->drawRect(SkRect::MakeXYWH(0, 25, 100, 25), paint);
+
+    const SkPoint pts[] = {{0, 0}, {100, 0}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+    SkPaint gradient;
+    gradient.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                    SkShader::kClamp_TileMode));
+    canvas->saveLayer(SkRect::MakeXYWH(60, 60, 20, 20), &paint);
+    canvas->drawRect(SkRect::MakeXYWH(60, 60, 10, 10), gradient);
+    canvas->drawRect(SkRect::MakeXYWH(70, 70, 10, 10), gradient);
+    canvas->restore();
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    sk_tools::OverdrawAnalysis analysis = sk_tools::analyzeOverdraw(*picture);
+    REPORTER_ASSERT(r, 100 == analysis.fWidth && 100 == analysis.fHeight);
+    REPORTER_ASSERT(r, 5 == analysis.fOps.size());
+    if (5 != analysis.fOps.size()) {
+        return;
+    }
+    REPORTER_ASSERT(r, 5600 == analysis.fPixels);
+
+    // An opaque color is the unit of cost; translucent draws and layers also read what's under
+    // them, and gradients cost a little more to shade.
+    struct { const char* fName; const char* fPaint; int64_t fPixels; double fCost; } expected[] = {
+        {"DrawRect",  "color",            2500, 5000},
+        {"DrawRect",  "color",            2500, 2500},
+        {"SaveLayer", "layer",             400,  800},
+        {"DrawRect",  "SkLinearGradient",  100,  200},
+        {"DrawRect",  "SkLinearGradient",  100,  200},
+    };
+    for (int i = 0; i < 5; ++i) {
+        const sk_tools::OverdrawAnalysis::Op& op = analysis.fOps[i];
+        REPORTER_ASSERT(r, !strcmp(expected[i].fName, op.fName), "%d %s", i, op.fName);
+        REPORTER_ASSERT(r, !strcmp(expected[i].fPaint, op.fPaint), "%d %s", i, op.fPaint);
+        REPORTER_ASSERT(r, expected[i].fPixels == op.fPixels, "%d %lld", i, op.fPixels);
+        REPORTER_ASSERT(r, expected[i].fCost == op.fCost, "%d %g", i, op.fCost);
+    }
+
+    REPORTER_ASSERT(r, 3 == analysis.fPaints.size());
+    REPORTER_ASSERT(r, !strcmp(analysis.fPaints[0].fName, "color"));
+    REPORTER_ASSERT(r, 2 == analysis.fPaints[0].fOps && 5000 == analysis.fPaints[0].fPixels);
+    REPORTER_ASSERT(r, 8700 == analysis.fCost);
+
+    SkDynamicMemoryWStream stream;
+    sk_tools::writeOverdrawJSON(analysis, 2, &stream);
+    sk_sp<SkData> json = stream.detachAsData();
+    SkString str(static_cast<const char*>(json->data()), json->size());
+    REPORTER_ASSERT(r, str.contains("\"pixels\": 5600"));
+    REPORTER_ASSERT(r, str.contains("\"paint\": \"layer\""));
+}
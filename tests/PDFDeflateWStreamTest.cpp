@@ -9,7 +9,9 @@
 
 #ifdef SK_SUPPORT_PDF
 
+#include "SkData.h"
 #include "SkDeflate.h"
+#include "SkExecutor.h"
 #include "SkRandom.h"
 
 namespace {
@@ -166,4 +168,55 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
     REPORTER_ASSERT(r, !emptyDeflateWStream.writeText("FOO"));
 }
 
+static sk_sp<SkData> deflate(const void* data, size_t size, SkExecutor* executor,
+                             skiatest::Reporter* r) {
+    SkDynamicMemoryWStream dst;
+    {
+        SkDeflateWStream deflateWStream(&dst, -1, false, executor);
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        size_t written = 0;
+        while (written < size) {
+            size_t writeSize = SkTMin<size_t>(size - written, 7000);
+            deflateWStream.write(bytes + written, writeSize);
+            written += writeSize;
+        }
+        REPORTER_ASSERT(r, deflateWStream.bytesWritten() == size);
+    }
+    return dst.detachAsData();
+}
+
+// Inputs that span several blocks are compressed in parallel into a single valid zlib stream;
+// inputs that fit in one block are compressed exactly like without an executor.
+DEF_TEST(SkPDF_DeflateWStream_parallel, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRandom random(654321);
+    const size_t kSizes[] = { 0, 1000, SkDeflateWStream::kParallelBlockSize,
+                              SkDeflateWStream::kParallelBlockSize + 1,
+                              5 * SkDeflateWStream::kParallelBlockSize + 333 };
+    for (size_t size : kSizes) {
+        // Short repeated words, so matches often reach back across block boundaries.
+        SkAutoTMalloc<uint8_t> buffer(size);
+        for (size_t j = 0; j < size; ++j) {
+            buffer[j] = (j % 64 < 32) ? 'a' + (j % 11) : random.nextULessThan(4);
+        }
+        sk_sp<SkData> parallel = deflate(buffer.get(), size, executor.get(), r);
+        if (size <= SkDeflateWStream::kParallelBlockSize) {
+            sk_sp<SkData> serial = deflate(buffer.get(), size, nullptr, r);
+            REPORTER_ASSERT(r, serial->equals(parallel.get()));
+        }
+
+        SkMemoryStream compressed(parallel);
+        std::unique_ptr<SkStreamAsset> decompressed(stream_inflate(r, &compressed));
+        if (!decompressed) {
+            ERRORF(r, "Decompression failed for %u bytes.", (unsigned)size);
+            continue;
+        }
+        sk_sp<SkData> result = SkData::MakeFromStream(decompressed.get(),
+                                                      decompressed->getLength());
+        REPORTER_ASSERT(r, result->size() == size);
+        REPORTER_ASSERT(r, result->size() == size && 0 == memcmp(result->data(), buffer.get(),
+                                                                 size));
+    }
+}
+
 #endif
@@ -9,12 +9,19 @@
 #include "Resources.h"
 #include "SkCanvas.h"
 #include "SkDocument.h"
+#include "SkExecutor.h"
+#include "SkImage.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
+#include "SkRandom.h"
 #include "SkStream.h"
 
 #include "sk_tool_utils.h"
 
+#ifdef SK_SUPPORT_PDF
+#include "SkPDFSharedCache.h"
+#endif
+
 static void test_empty(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
 
@@ -222,3 +229,149 @@ DEF_TEST(SkPDF_unicode_metadata, r) {
         }
     }
 }
+
+// Serializing on an executor must not change the document.
+DEF_TEST(SkPDF_executor, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_executor, r);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    sk_sp<SkData> docs[2];
+    for (int threaded = 0; threaded < 2; ++threaded) {
+        SkDocument::PDFMetadata metadata;
+        metadata.fExecutor = threaded ? executor.get() : nullptr;
+        SkDynamicMemoryWStream stream;
+        sk_sp<SkDocument> doc = SkDocument::MakePDF(&stream, metadata);
+        SkRandom random;
+        for (int page = 0; page < 8; ++page) {
+            SkCanvas* canvas = doc->beginPage(612, 792);
+            SkBitmap bitmap;
+            bitmap.allocN32Pixels(64, 64);
+            for (int y = 0; y < 64; ++y) {
+                for (int x = 0; x < 64; ++x) {
+                    *bitmap.getAddr32(x, y) = SkPreMultiplyColor(random.nextU());
+                }
+            }
+            canvas->drawBitmap(bitmap, 20, 20);
+            SkPaint paint;
+            paint.setColor(SK_ColorBLUE);
+            canvas->drawRect(SkRect::MakeXYWH(100, 100 + page, 200, 50), paint);
+            SkString text;
+            text.printf("Page %d", page);
+            canvas->drawText(text.c_str(), text.size(), 100, 300, paint);
+            doc->endPage();
+        }
+        doc->close();
+        docs[threaded] = stream.detachAsData();
+    }
+    REPORTER_ASSERT(r, docs[0]->equals(docs[1].get()));
+}
+
+// Documents sharing a PDFCache must be identical to documents made without it.
+DEF_TEST(SkPDF_sharedCache, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_sharedCache, r);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(64, 64);
+    SkRandom random;
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(random.nextU());
+        }
+    }
+    sk_sp<SkImage> logo = SkImage::MakeFromBitmap(bitmap);
+    sk_sp<SkDocument::PDFCache> cache = SkDocument::PDFCache::Make();
+
+    // The first document doesn't use the cache, the second fills it and the third reuses it.
+    sk_sp<SkData> docs[3];
+    for (int i = 0; i < 3; ++i) {
+        SkDocument::PDFMetadata metadata;
+        if (i > 0) {
+            metadata.fCache = cache;
+        }
+        SkDynamicMemoryWStream stream;
+        sk_sp<SkDocument> doc = SkDocument::MakePDF(&stream, metadata);
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        canvas->drawImage(logo, 20, 20);
+        canvas->drawImageRect(logo, SkIRect::MakeWH(32, 32), SkRect::MakeXYWH(100, 20, 32, 32),
+                              nullptr);
+        SkPaint paint;
+        canvas->drawText("Invoice", 7, 100, 300, paint);
+        doc->close();
+        docs[i] = stream.detachAsData();
+    }
+    REPORTER_ASSERT(r, docs[0]->equals(docs[1].get()));
+    REPORTER_ASSERT(r, docs[0]->equals(docs[2].get()));
+
+#ifdef SK_SUPPORT_PDF
+    SkPDFSharedCache* sharedCache = static_cast<SkPDFSharedCache*>(cache.get());
+    REPORTER_ASSERT(r, sharedCache->count() > 0);
+    REPORTER_ASSERT(r, sharedCache->numHits() > 0);
+#endif
+}
+
+// Checks that each in-use entry of the cross-reference table points at its object.
+static bool check_xref(skiatest::Reporter* r, const SkData* pdf) {
+    const char* bytes = static_cast<const char*>(pdf->data());
+    SkString text(bytes, pdf->size());
+    int startxref = -1;
+    for (int i = text.size() - 10; i >= 0; --i) {
+        if (0 == strncmp(text.c_str() + i, "startxref\n", 10)) {
+            startxref = atoi(text.c_str() + i + 10);
+            break;
+        }
+    }
+    int count = 0;
+    if (startxref < 0 || 1 != sscanf(text.c_str() + startxref, "xref\n0 %d\n", &count)) {
+        ERRORF(r, "Missing cross-reference table.");
+        return false;
+    }
+    const char* entries = strchr(text.c_str() + startxref + 5, '\n') + 1;
+    for (int i = 1; i < count; ++i) {
+        size_t offset = atol(entries + 20 * i);
+        SkString object = SkStringPrintf("%d 0 obj\n", i);
+        if (offset + object.size() > text.size() ||
+            0 != strncmp(text.c_str() + offset, object.c_str(), object.size())) {
+            ERRORF(r, "Object %d is not at its cross-reference offset.", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Streaming documents write each page when it ends, and defer only fonts and the page tree.
+DEF_TEST(SkPDF_streaming, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_streaming, r);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(32, 32);
+    bitmap.eraseColor(SK_ColorGREEN);
+    sk_sp<SkImage> logo = SkImage::MakeFromBitmap(bitmap);
+    for (int threaded = 0; threaded < 2; ++threaded) {
+        for (int streaming = 0; streaming < 2; ++streaming) {
+            SkDocument::PDFMetadata metadata;
+            metadata.fStreaming = SkToBool(streaming);
+            metadata.fExecutor = threaded ? executor.get() : nullptr;
+            SkDynamicMemoryWStream stream;
+            sk_sp<SkDocument> doc = SkDocument::MakePDF(&stream, metadata);
+            size_t lastSize = 0;
+            for (int page = 0; page < 20; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                canvas->drawImage(logo, 20, 20);
+                SkPaint paint;
+                SkString text;
+                text.printf("Page %d", page);
+                canvas->drawText(text.c_str(), text.size(), 100, 300, paint);
+                doc->endPage();
+                if (streaming && !threaded) {
+                    // The page's content and dictionary have been written.
+                    REPORTER_ASSERT(r, stream.bytesWritten() > lastSize);
+                    lastSize = stream.bytesWritten();
+                }
+            }
+            doc->close();
+            sk_sp<SkData> pdf = stream.detachAsData();
+            REPORTER_ASSERT(r, check_xref(r, pdf.get()));
+            if (streaming) {
+                REPORTER_ASSERT(r, contains(pdf->bytes(), pdf->size(), "/Count 20"));
+            }
+        }
+    }
+}
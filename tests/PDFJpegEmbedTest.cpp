@@ -8,6 +8,7 @@
 #include "SkCanvas.h"
 #include "SkData.h"
 #include "SkDocument.h"
+#include "SkImageEncoder.h"
 #include "SkImageGenerator.h"
 #include "SkStream.h"
 
@@ -255,3 +256,56 @@ DEF_TEST(SkPDF_JpegIdentification, r) {
     }
 }
 #endif
+
+static sk_sp<SkData> draw_into_pdf(const sk_sp<SkImage>& image) {
+    SkDynamicMemoryWStream pdf;
+    sk_sp<SkDocument> document(SkDocument::MakePDF(&pdf));
+    document->beginPage(612, 792)->drawImage(image, 10, 10);
+    document->close();
+    return pdf.detachAsData();
+}
+
+static bool pdf_contains(const SkData* pdf, const char* text) {
+    sk_sp<SkData> data = SkData::MakeWithoutCopy(text, strlen(text));
+    return is_subset_of(data.get(), const_cast<SkData*>(pdf));
+}
+
+// Subsets of JPEG images embed the whole JPEG, drawn by a form XObject that clips it.
+DEF_TEST(SkPDF_JpegSubsetEmbedTest, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_JpegSubsetEmbedTest, r);
+    sk_sp<SkData> mandrillData(load_resource(r, "SkPDF_JpegSubsetEmbedTest",
+                                             "images/mandrill_512_q075.jpg"));
+    if (!mandrillData) {
+        return;
+    }
+    sk_sp<SkImage> image = SkImage::MakeFromEncoded(mandrillData);
+    sk_sp<SkData> pdf = draw_into_pdf(image->makeSubset(SkIRect::MakeXYWH(64, 32, 400, 300)));
+    REPORTER_ASSERT(r, is_subset_of(mandrillData.get(), pdf.get()));
+    REPORTER_ASSERT(r, pdf_contains(pdf.get(), "/BBox [0 0 1 1]"));
+
+    // A small part of a large image is decoded instead.
+    pdf = draw_into_pdf(image->makeSubset(SkIRect::MakeXYWH(0, 0, 100, 100)));
+    REPORTER_ASSERT(r, !is_subset_of(mandrillData.get(), pdf.get()));
+}
+
+// Opaque 8 bit gray and RGB PNGs embed their image data with the PNG predictors.
+DEF_TEST(SkPDF_PngEmbedTest, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_PngEmbedTest, r);
+    for (SkAlphaType alphaType : { kOpaque_SkAlphaType, kPremul_SkAlphaType }) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeN32(64, 64, alphaType));
+        for (int y = 0; y < 64; ++y) {
+            for (int x = 0; x < 64; ++x) {
+                U8CPU a = kOpaque_SkAlphaType == alphaType ? 0xFF : 0x80;
+                *bitmap.getAddr32(x, y) = SkPreMultiplyARGB(a, 4 * x, 4 * y, 0x40);
+            }
+        }
+        SkDynamicMemoryWStream png;
+        if (!SkEncodeImage(&png, bitmap, SkEncodedImageFormat::kPNG, 100)) {
+            continue;
+        }
+        sk_sp<SkData> pdf = draw_into_pdf(SkImage::MakeFromEncoded(png.detachAsData()));
+        REPORTER_ASSERT(r, pdf_contains(pdf.get(), "/Predictor 15") ==
+                           (kOpaque_SkAlphaType == alphaType));
+    }
+}
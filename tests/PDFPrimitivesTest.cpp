@@ -23,6 +23,7 @@
 #include "SkPDFCanon.h"
 #include "SkPDFDevice.h"
 #include "SkPDFFont.h"
+#include "SkPDFResourceDict.h"
 #include "SkPDFTypes.h"
 #include "SkPDFUtils.h"
 #include "SkReadBuffer.h"
@@ -339,6 +340,43 @@ static void TestPDFDict(skiatest::Reporter* reporter) {
     assert_eq(reporter, result, "<</Type /DType\n/n1 1 0 R>>");
 }
 
+static void TestResourceNames(skiatest::Reporter* reporter) {
+    using Dict = SkPDFResourceDict;
+    for (int type = 0; type < Dict::kResourceTypeCount; ++type) {
+        auto resourceType = (Dict::SkPDFResourceType)type;
+        for (int key : {0, 9, 10, 255, 256, 1000}) {
+            SkString name = Dict::getResourceName(resourceType, key);
+            const char* interned = Dict::GetInternedResourceName(resourceType, key);
+            if (key < Dict::kInternedNameCount) {
+                REPORTER_ASSERT(reporter, interned && name.equals(interned));
+                REPORTER_ASSERT(reporter, interned ==
+                                          Dict::GetInternedResourceName(resourceType, key));
+            } else {
+                REPORTER_ASSERT(reporter, !interned);
+            }
+            SkDynamicMemoryWStream stream;
+            Dict::WriteResourceName(&stream, resourceType, key);
+            sk_sp<SkData> data = stream.detachAsData();
+            assert_eql(reporter, SkStringPrintf("/%s", name.c_str()),
+                       (const char*)data->data(), data->size());
+        }
+    }
+
+    // Resource sub-dicts switch from interned to copied keys past kInternedNameCount.
+    SkTDArray<SkPDFObject*> xObjects;
+    sk_sp<SkPDFArray> object(new SkPDFArray);
+    for (int i = 0; i <= Dict::kInternedNameCount; ++i) {
+        xObjects.push(object.get());
+    }
+    SkPDFObjNumMap catalog;
+    catalog.addObjectRecursively(object.get());
+    sk_sp<SkPDFDict> resources = Dict::Make(nullptr, nullptr, &xObjects, nullptr);
+    SkString result = emit_to_string(*resources, &catalog);
+    REPORTER_ASSERT(reporter, result.contains("/X0 1 0 R\n"));
+    REPORTER_ASSERT(reporter, result.contains("/X255 1 0 R\n"));
+    REPORTER_ASSERT(reporter, result.contains("/X256 1 0 R>>"));
+}
+
 DEF_TEST(SkPDF_Primitives, reporter) {
     TestPDFUnion(reporter);
     TestPDFArray(reporter);
@@ -346,6 +384,7 @@ DEF_TEST(SkPDF_Primitives, reporter) {
     TestPDFStream(reporter);
     TestObjectNumberMap(reporter);
     TestObjectRef(reporter);
+    TestResourceNames(reporter);
     test_issue1083();
 }
 
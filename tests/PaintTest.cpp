@@ -365,3 +365,51 @@ DEF_TEST(Paint_nothingToDraw, r) {
     paint.setColorFilter(SkColorFilter::MakeMatrixFilterRowMajor255(cm.fMat));
     REPORTER_ASSERT(r, !paint.nothingToDraw());
 }
+
+#include "Resources.h"
+
+// Text measured without bounds may use advances read from the font, and with bounds always uses
+// a strike. They have to agree.
+DEF_TEST(Paint_measureText_advances, r) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto2-Regular_NoEmbed.ttf");
+    if (!typeface) {
+        return;
+    }
+    const char text[] = "Hamburgefons 0123456789";
+    const size_t length = strlen(text);
+
+    SkPaint paint;
+    paint.setTypeface(typeface);
+    for (SkPaint::Hinting hinting : { SkPaint::kNo_Hinting, SkPaint::kNormal_Hinting }) {
+        for (bool subpixel : { false, true }) {
+            for (SkScalar size : { 9.5f, 12.0f, 300.0f }) {
+                paint.setHinting(hinting);
+                paint.setSubpixelText(subpixel);
+                paint.setTextSize(size);
+
+                SkRect bounds;
+                const SkScalar width = paint.measureText(text, length);
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(width, paint.measureText(text, length,
+                                                                               &bounds), 0.01f));
+
+                SkScalar widths[SK_ARRAY_COUNT(text)];
+                SkScalar strikeWidths[SK_ARRAY_COUNT(text)];
+                SkRect strikeBounds[SK_ARRAY_COUNT(text)];
+                const int count = paint.getTextWidths(text, length, widths);
+                REPORTER_ASSERT(r, count == (int)length);
+                REPORTER_ASSERT(r, paint.getTextWidths(text, length, strikeWidths,
+                                                       strikeBounds) == count);
+                SkScalar sum = 0;
+                for (int i = 0; i < count; ++i) {
+                    REPORTER_ASSERT(r, SkScalarNearlyEqual(widths[i], strikeWidths[i], 0.001f));
+                    sum += widths[i];
+                }
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(width, sum, 0.01f));
+
+                SkScalar measured;
+                REPORTER_ASSERT(r, paint.breakText(text, length, width, &measured) == length);
+                REPORTER_ASSERT(r, measured == width);
+            }
+        }
+    }
+}
@@ -128,3 +128,40 @@ DEF_TEST(ParsePathOptionalCommand, r) {
         REPORTER_ASSERT(r, path.countPoints() == gTests[i].fPoints);
     }
 }
+
+#include "SkFloatBits.h"
+#include "SkParse.h"
+#include <stdlib.h>
+
+// SkParse::FindScalar() parses plain decimals itself; they must match what strtod() makes of them.
+DEF_TEST(ParseScalar, r) {
+    auto check = [r](const char* str) {
+        char* expectedStop;
+        float expected = (float)strtod(str, &expectedStop);
+
+        SkScalar value;
+        const char* stop = SkParse::FindScalar(str, &value);
+        if (expectedStop == str) {
+            REPORTER_ASSERT(r, !stop);
+            return;
+        }
+        REPORTER_ASSERT(r, stop == expectedStop);
+        REPORTER_ASSERT(r, SkFloat2Bits(value) == SkFloat2Bits(expected));
+    };
+
+    static const char* gStrs[] = {
+        "0", "-0", "+0", ".5", "-.5", "5.", "12.25,", "1.5.5", "007", "0.000000000000000000000001",
+        "1.00000000000000000000", "123456789012345", "1234567890123456789", "3.4028235e38",
+        "1e-3", "0x10", "inf", "-nan", ".", "-", "+.", "e5", "", "16777217", "0.1", "2.675",
+    };
+    for (const char* str : gStrs) {
+        check(str);
+    }
+
+    SkRandom rand;
+    for (int i = 0; i < 10000; ++i) {
+        SkString str;
+        str.printf("%.*f", rand.nextRangeU(0, 12), rand.nextRangeF(-1e6f, 1e6f));
+        check(str.c_str());
+    }
+}
@@ -8,6 +8,7 @@
 #include "PathOpsExtendedTest.h"
 #include "PathOpsTestCommon.h"
 #include "SkBitmap.h"
+#include "SkExecutor.h"
 #include "Test.h"
 
 DEF_TEST(PathOpsBuilder, reporter) {
@@ -361,3 +362,88 @@ SkOpBuilder builder;
     builder.add(path1, SkPathOp::kUnion_SkPathOp);
     builder.resolve(&path);
 }
+
+// Large operands take the sweep and the parallel intersection paths. Both must give exactly
+// what the serial path gives.
+DEF_TEST(PathOpsExecutor, reporter) {
+    SkPath wave, circles;
+    wave.moveTo(0, 0);
+    for (int i = 1; i <= 400; i++) {
+        wave.lineTo(i, (i & 1) ? 40.0f : 0.0f);
+    }
+    wave.lineTo(400, 60);
+    wave.cubicTo(300, 90, 100, -30, 0, 60);
+    wave.close();
+    for (int i = 0; i < 40; i++) {
+        circles.addCircle(10.0f * i + 5, 20 + 15 * SkScalarSin(i * 0.7f), 9);
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (int op = kDifference_SkPathOp; op <= kReverseDifference_SkPathOp; op++) {
+        SkPath serial, parallel;
+        bool serialOk = Op(wave, circles, (SkPathOp) op, &serial);
+        bool parallelOk = Op(wave, circles, (SkPathOp) op, &parallel, executor.get());
+        REPORTER_ASSERT(reporter, serialOk == parallelOk);
+        REPORTER_ASSERT(reporter, serial == parallel);
+    }
+
+    SkPath serial, parallel;
+    REPORTER_ASSERT(reporter, Simplify(circles, &serial));
+    REPORTER_ASSERT(reporter, Simplify(circles, &parallel, executor.get()));
+    REPORTER_ASSERT(reporter, serial == parallel);
+
+    SkOpBuilder serialBuilder, parallelBuilder;
+    for (SkOpBuilder* builder : { &serialBuilder, &parallelBuilder }) {
+        builder->add(wave, kUnion_SkPathOp);
+        builder->add(circles, kXOR_SkPathOp);
+    }
+    REPORTER_ASSERT(reporter, serialBuilder.resolve(&serial));
+    REPORTER_ASSERT(reporter, parallelBuilder.resolve(&parallel, executor.get()));
+    REPORTER_ASSERT(reporter, serial == parallel);
+}
+
+static int count_contours(const SkPath& path) {
+    int count = 0;
+    SkPath::RawIter iter(path);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        count += SkPath::kMove_Verb == verb;
+    }
+    return count;
+}
+
+DEF_TEST(PathOpsUnion, reporter) {
+    // Rows of overlapping rects, and single rects apart from everything else.
+    SkTArray<SkPath> paths;
+    for (int row = 0; row < 4; row++) {
+        for (int i = 0; i < 10; i++) {
+            SkPath rect;
+            rect.addRect(SkRect::MakeXYWH(8.0f * i, 30.0f * row, 10, 10 + i % 3));
+            paths.push_back(rect);
+        }
+        SkPath alone;
+        alone.addRect(SkRect::MakeXYWH(100, 30.0f * row, 5, 5));
+        paths.push_back(alone);
+    }
+
+    SkOpBuilder builder;
+    for (const SkPath& path : paths) {
+        builder.add(path, kUnion_SkPathOp);
+    }
+    SkPath expected;
+    REPORTER_ASSERT(reporter, builder.resolve(&expected));
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkExecutor* exec : { (SkExecutor*) nullptr, executor.get() }) {
+        SkPath result;
+        REPORTER_ASSERT(reporter, Union(paths.begin(), paths.count(), &result, exec));
+        REPORTER_ASSERT(reporter, 0 == comparePaths(reporter, __FUNCTION__, expected, result));
+        // One contour per row, and one per rect that's apart.
+        REPORTER_ASSERT(reporter, 8 == count_contours(result));
+    }
+
+    SkPath empty;
+    REPORTER_ASSERT(reporter, Union(nullptr, 0, &empty));
+    REPORTER_ASSERT(reporter, empty.isEmpty());
+}
@@ -5051,3 +5051,61 @@ DEF_TEST(Path_isRect, reporter) {
     compare.set(&points53[1], 4);
     REPORTER_ASSERT(reporter, rect == compare);
 }
+
+DEF_TEST(Path_boundsCheckLarge, reporter) {
+    // Every count up to a few times the unrolled loop, with the extremes and a NaN in each slot.
+    SkRandom rand;
+    SkPoint pts[19];
+    for (int count = 1; count <= (int)SK_ARRAY_COUNT(pts); ++count) {
+        for (int i = 0; i < count; ++i) {
+            pts[i].set(rand.nextSScalar1(), rand.nextSScalar1());
+        }
+        for (int extreme = 0; extreme < count; ++extreme) {
+            SkPoint saved = pts[extreme];
+            pts[extreme].set(-2, 3);
+            SkRect bounds;
+            REPORTER_ASSERT(reporter, bounds.setBoundsCheck(pts, count));
+            REPORTER_ASSERT(reporter, -2 == bounds.fLeft && 3 == bounds.fBottom);
+            for (int i = 0; i < count; ++i) {
+                REPORTER_ASSERT(reporter, bounds.fLeft <= pts[i].fX && pts[i].fX <= bounds.fRight);
+                REPORTER_ASSERT(reporter, bounds.fTop <= pts[i].fY && pts[i].fY <= bounds.fBottom);
+            }
+
+            pts[extreme].set(SK_ScalarNaN, 0);
+            REPORTER_ASSERT(reporter, !bounds.setBoundsCheck(pts, count));
+            REPORTER_ASSERT(reporter, bounds.isEmpty());
+            pts[extreme] = saved;
+        }
+    }
+}
+
+DEF_TEST(Path_Iterate, reporter) {
+    SkPath path;
+    path.moveTo(1, 2);
+    path.lineTo(3, 4);
+    path.quadTo(5, 6, 7, 8);
+    path.conicTo(9, 10, 11, 12, 0.5f);
+    path.close();
+    path.moveTo(13, 14);
+    path.cubicTo(15, 16, 17, 18, 19, 20);
+    path.conicTo(21, 22, 23, 24, 2);
+
+    // The same verbs, points and weights as SkPath::RawIter.
+    SkPath::RawIter iter(path);
+    SkPoint pts[4];
+    int count = 0;
+    for (SkPathPriv::Segment segment : SkPathPriv::Iterate(path)) {
+        SkPath::Verb verb = iter.next(pts);
+        REPORTER_ASSERT(reporter, verb == segment.fVerb);
+        int n = SkPathPriv::PtsInIter(verb);
+        if (SkPath::kClose_Verb != verb) {
+            REPORTER_ASSERT(reporter, 0 == memcmp(pts, segment.fPts, n * sizeof(SkPoint)));
+        }
+        if (SkPath::kConic_Verb == verb) {
+            REPORTER_ASSERT(reporter, iter.conicWeight() == *segment.fWeight);
+        }
+        ++count;
+    }
+    REPORTER_ASSERT(reporter, SkPath::kDone_Verb == iter.next(pts));
+    REPORTER_ASSERT(reporter, path.countVerbs() == count);
+}
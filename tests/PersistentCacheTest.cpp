@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTypes.h"
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrContextPriv.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkSurface.h"
+#include "gl/GrGLDefines.h"
+#include "gl/GrGLGpu.h"
+#include "gl/GrGLUtil.h"
+
+#include <utility>
+#include <vector>
+
+namespace {
+class MemoryCache : public GrContextOptions::PersistentCache {
+public:
+    sk_sp<SkData> load(const SkData& key) override {
+        for (const auto& entry : fEntries) {
+            if (entry.first->equals(&key)) {
+                ++fHits;
+                return entry.second;
+            }
+        }
+        return nullptr;
+    }
+
+    void store(const SkData& key, const SkData& data) override {
+        fEntries.emplace_back(SkData::MakeWithCopy(key.data(), key.size()),
+                              SkData::MakeWithCopy(data.data(), data.size()));
+    }
+
+    std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>> fEntries;
+    int fHits = 0;
+};
+}  // namespace
+
+DEF_GPUTEST(GLProgramBinaryCache, reporter, options) {
+    using sk_gpu_test::GrContextFactory;
+    for (auto type : { GrContextFactory::kGL_ContextType, GrContextFactory::kGLES_ContextType }) {
+        MemoryCache cache;
+        GrContextOptions contextOptions = options;
+        contextOptions.fPersistentCache = &cache;
+
+        // Draw the same thing with two contexts in turn: the second should find the first's
+        // program binaries.
+        for (int run = 0; run < 2; ++run) {
+            GrContextFactory factory(contextOptions);
+            GrContext* context = factory.get(type);
+            if (!context) {
+                break;
+            }
+            GrGLGpu* gpu = static_cast<GrGLGpu*>(context->contextPriv().getGpu());
+            if (!gpu->glCaps().programBinarySupport()) {
+                break;
+            }
+
+            SkImageInfo info = SkImageInfo::MakeN32Premul(16, 16);
+            sk_sp<SkSurface> surface(SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info));
+            if (!surface) {
+                break;
+            }
+            surface->getCanvas()->drawRect(SkRect::MakeWH(8, 8), SkPaint());
+            surface->getCanvas()->flush();
+
+            if (0 == run) {
+                REPORTER_ASSERT(reporter, !cache.fEntries.empty());
+                REPORTER_ASSERT(reporter, 0 == cache.fHits);
+
+                // Every key says which driver made the binary.
+                const GrGLubyte* vendor;
+                GR_GL_CALL_RET(gpu->glInterface(), vendor, GetString(GR_GL_VENDOR));
+                size_t vendorLength = strlen((const char*)vendor);
+                for (const auto& entry : cache.fEntries) {
+                    REPORTER_ASSERT(reporter, entry.first->size() > vendorLength &&
+                                              !memcmp(entry.first->data(), vendor, vendorLength));
+                }
+            } else {
+                REPORTER_ASSERT(reporter, cache.fHits > 0);
+            }
+        }
+    }
+}
+
+#endif
@@ -6,6 +6,7 @@
  */
 
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureShader.h"
@@ -13,6 +14,8 @@
 #include "SkSurface.h"
 #include "Test.h"
 
+#include <vector>
+
 // Test that attempting to create a picture shader with a nullptr picture or
 // empty picture returns a shader that draws nothing.
 DEF_TEST(PictureShader_empty, reporter) {
@@ -78,3 +81,64 @@ DEF_TEST(PictureShader_caching, reporter) {
     // All but the local ref should be gone now.
     REPORTER_ASSERT(reporter, picture->unique());
 }
+
+namespace {
+// Queues work until the test runs it.
+class QueueExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override { fWork.push_back(std::move(work)); }
+
+    int pending() const { return SkToInt(fWork.size()); }
+
+    void run() {
+        std::vector<std::function<void(void)>> work;
+        work.swap(fWork);
+        for (auto& fn : work) {
+            fn();
+        }
+    }
+
+private:
+    std::vector<std::function<void(void)>> fWork;
+};
+} // namespace
+
+// With an executor, a new scale draws the nearest cached tile while the exact one is rasterized.
+DEF_TEST(PictureShader_asyncTiles, reporter) {
+    SkPictureRecorder recorder;
+    recorder.beginRecording(10, 10)->drawColor(SK_ColorGREEN);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    QueueExecutor executor;
+    SkPaint paint;
+    paint.setShader(SkShader::MakePictureShader(picture, SkShader::kRepeat_TileMode,
+                                                SkShader::kRepeat_TileMode, nullptr, nullptr,
+                                                &executor));
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    SkCanvas canvas(bitmap);
+
+    // Nothing is cached at first, so the tile is rasterized right away.
+    canvas.scale(1.1f, 1.1f);
+    canvas.drawPaint(paint);
+    REPORTER_ASSERT(reporter, executor.pending() == 0);
+    REPORTER_ASSERT(reporter, *bitmap.getAddr32(50, 50) == SkPreMultiplyColor(SK_ColorGREEN));
+
+    // Zooming within a scale bucket reuses the tile.
+    canvas.scale(1.05f, 1.05f);
+    canvas.drawPaint(paint);
+    REPORTER_ASSERT(reporter, executor.pending() == 0);
+
+    // A new bucket draws the old tile and rasterizes the new one, just once.
+    canvas.clear(SK_ColorRED);
+    canvas.scale(2, 2);
+    canvas.drawPaint(paint);
+    canvas.drawPaint(paint);
+    REPORTER_ASSERT(reporter, executor.pending() == 1);
+    REPORTER_ASSERT(reporter, *bitmap.getAddr32(50, 50) == SkPreMultiplyColor(SK_ColorGREEN));
+
+    executor.run();
+    canvas.drawPaint(paint);
+    REPORTER_ASSERT(reporter, executor.pending() == 0);
+}
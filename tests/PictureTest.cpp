@@ -9,18 +9,24 @@
 #include "SkBBoxHierarchy.h"
 #include "SkBigPicture.h"
 #include "SkBitmap.h"
+#include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
 #include "SkClipOp.h"
 #include "SkClipOpPriv.h"
 #include "SkColor.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkFontStyle.h"
+#include "SkImage.h"
 #include "SkImageInfo.h"
 #include "SkMatrix.h"
 #include "SkMiniRecorder.h"
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkPicture.h"
+#include "SkPictureCommon.h"
+#include "SkPictureData.h"
+#include "SkPictureLayerCache.h"
 #include "SkPictureRecorder.h"
 #include "SkPixelRef.h"
 #include "SkRandom.h"
@@ -34,7 +40,10 @@
 #include "SkTypes.h"
 #include "Test.h"
 
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <vector>
 
 class SkRRect;
 class SkRegion;
@@ -873,3 +882,270 @@ DEF_TEST(Picture_empty_serial, reporter) {
     REPORTER_ASSERT(reporter, pic2);
 }
 
+
+// Loads 'data' from a stream that doesn't expose its memory, so everything is copied.
+static sk_sp<SkPicture> make_from_copying_stream(const SkData* data) {
+    struct CopyingStream : public SkMemoryStream {
+        CopyingStream(const SkData* data) : SkMemoryStream(data->data(), data->size()) {}
+        const void* getMemoryBase() override { return nullptr; }
+    } stream(data);
+    return SkPicture::MakeFromStream(&stream);
+}
+
+DEF_TEST(Picture_serial_in_place, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    sk_sp<SkPicture> inner = recorder.finishRecordingAsPicture();
+
+    canvas = recorder.beginRecording(100, 100);
+    SkRandom rand;
+    for (int i = 0; i < 50; ++i) {
+        SkPaint paint;
+        paint.setColor(rand.nextU());
+        SkPath path;
+        path.moveTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+        path.lineTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+        path.lineTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+        canvas->drawPath(path, paint);
+        canvas->drawText("abc", 3, 10, 10 + i, paint);
+    }
+    canvas->drawPicture(inner);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+    sk_sp<SkData> data = picture->serialize();
+
+    // The op data is read in place from an aligned memory stream.
+    {
+        SkMemoryStream stream(data);
+        SkPictInfo info;
+        REPORTER_ASSERT(reporter, SkPicture_StreamIsSKP(&stream, &info));
+        REPORTER_ASSERT(reporter, 1 == stream.readU8());
+        std::unique_ptr<SkPictureData> pictureData(
+                SkPictureData::CreateFromStream(&stream, info, SkDeserialProcs(), nullptr));
+        REPORTER_ASSERT(reporter, pictureData && pictureData->opData());
+        if (pictureData && pictureData->opData()) {
+            const uint8_t* ops = pictureData->opData()->bytes();
+            REPORTER_ASSERT(reporter, ops > data->bytes() &&
+                                      ops < data->bytes() + data->size());
+        }
+    }
+
+    // Unaligned and non-memory streams are copied, and all three load the same picture.
+    sk_sp<SkData> unaligned = SkData::MakeUninitialized(data->size() + 1);
+    memcpy((char*)unaligned->writable_data() + 1, data->data(), data->size());
+    sk_sp<SkPicture> loaded[] = {
+        SkPicture::MakeFromData(data.get()),
+        SkPicture::MakeFromData(unaligned->bytes() + 1, data->size()),
+        make_from_copying_stream(data.get()),
+    };
+    for (const sk_sp<SkPicture>& pic : loaded) {
+        REPORTER_ASSERT(reporter, pic);
+        if (pic) {
+            REPORTER_ASSERT(reporter, pic->approximateOpCount() == picture->approximateOpCount());
+        }
+    }
+}
+
+DEF_TEST(Picture_lazy_sub_pictures, reporter) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    bitmap.eraseColor(SK_ColorBLUE);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    // Two sub-pictures with more than one op, so they aren't unrolled into the outer one.
+    SkPictureRecorder recorder;
+    sk_sp<SkPicture> inner[2];
+    for (int i = 0; i < 2; ++i) {
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeXYWH(100 * i, 0, 50, 50));
+        canvas->drawRect(SkRect::MakeXYWH(100 * i, 0, 50, 50), SkPaint());
+        canvas->drawImage(image, 100 * i, 0);
+        inner[i] = recorder.finishRecordingAsPicture();
+    }
+    SkCanvas* canvas = recorder.beginRecording(200, 50);
+    canvas->drawPicture(inner[0]);
+    canvas->drawPicture(inner[1]);
+    sk_sp<SkData> data = recorder.finishRecordingAsPicture()->serialize();
+
+    // Counts the images that are deserialized, and lets Skia decode them.
+    int imageCount = 0;
+    SkDeserialProcs procs;
+    procs.fImageCtx = &imageCount;
+    procs.fImageProc = [](const void*, size_t, void* ctx) -> sk_sp<SkImage> {
+        ++*(int*)ctx;
+        return nullptr;
+    };
+
+    sk_sp<SkPicture> eager = SkPicture::MakeFromData(data.get(), &procs);
+    REPORTER_ASSERT(reporter, eager && 2 == imageCount);
+
+    imageCount = 0;
+    procs.fLazyPictures = true;
+    sk_sp<SkPicture> lazy = SkPicture::MakeFromData(data.get(), &procs);
+    REPORTER_ASSERT(reporter, lazy && 0 == imageCount);
+    if (!lazy) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, lazy->asSkBigPicture() && lazy->asSkBigPicture()->bbh());
+
+    // Playing back the left half only parses the left sub-picture.
+    SkBitmap dst;
+    dst.allocN32Pixels(200, 50);
+    SkCanvas dstCanvas(dst);
+    dstCanvas.save();
+    dstCanvas.clipRect(SkRect::MakeWH(50, 50));
+    lazy->playback(&dstCanvas);
+    dstCanvas.restore();
+    REPORTER_ASSERT(reporter, 1 == imageCount);
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == dst.getColor(4, 4));
+
+    lazy->playback(&dstCanvas);
+    REPORTER_ASSERT(reporter, 2 == imageCount);
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == dst.getColor(104, 4));
+
+    // Parsed sub-pictures are reused.
+    lazy->playback(&dstCanvas);
+    REPORTER_ASSERT(reporter, 2 == imageCount);
+}
+
+DEF_TEST(Picture_parallel_deserialize, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(160, 40);
+    SkPaint textPaint;
+    textPaint.setTypeface(SkTypeface::MakeFromName("serif", SkFontStyle()));
+    for (int i = 0; i < 8; ++i) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(16, 16);
+        bitmap.eraseColor(SkColorSetARGB(0xFF, 32 * i, 0, 255 - 32 * i));
+        canvas->drawImage(SkImage::MakeFromBitmap(bitmap), 20 * i, 0);
+    }
+    canvas->drawText("Hamburgefons", 12, 0, 36, textPaint);
+    sk_sp<SkData> data = recorder.finishRecordingAsPicture()->serialize();
+
+    std::atomic<int> imageCount{0};
+    SkDeserialProcs procs;
+    procs.fImageCtx = &imageCount;
+    procs.fImageProc = [](const void*, size_t, void* ctx) -> sk_sp<SkImage> {
+        ++*(std::atomic<int>*)ctx;
+        return nullptr;
+    };
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(160, 40);
+    actual.allocN32Pixels(160, 40);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+
+    sk_sp<SkPicture> serial = SkPicture::MakeFromData(data.get(), &procs);
+    REPORTER_ASSERT(reporter, serial && 8 == imageCount);
+    SkCanvas(expected).drawPicture(serial);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    imageCount = 0;
+    procs.fExecutor = executor.get();
+    sk_sp<SkPicture> parallel = SkPicture::MakeFromData(data.get(), &procs);
+    REPORTER_ASSERT(reporter, parallel && 8 == imageCount);
+    if (!parallel) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, parallel->approximateOpCount() == serial->approximateOpCount());
+    SkCanvas(actual).drawPicture(parallel);
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.computeByteSize()));
+}
+
+DEF_TEST(Picture_LayerCache, reporter) {
+    SkBitmap pixels;
+    pixels.allocN32Pixels(16, 16);
+    pixels.eraseColor(SK_ColorBLUE);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(pixels);
+
+    SkPaint layerPaint;
+    layerPaint.setImageFilter(SkBlurImageFilter::Make(2, 2, nullptr));
+    SkPictureRecorder recorder;
+    SkCanvas* recording = recorder.beginRecording(64, 64);
+    recording->saveLayer(nullptr, &layerPaint);
+    recording->drawImage(image, 24, 24);
+    recording->restore();
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    // Only canvases that ask for it cache layers, so other canvases drawing this picture at
+    // the same time don't see them.
+    auto draw = [&](uint32_t flags) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(64, 64);
+        bitmap.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bitmap, SkSurfaceProps(flags, kUnknown_SkPixelGeometry));
+        REPORTER_ASSERT(reporter, SkPictureLayerCache::IsEnabled(&canvas) ==
+                                  SkToBool(flags & SkSurfaceProps::kCachePictureLayers_Flag));
+        canvas.translate(3, 5);
+        canvas.drawPicture(picture);
+        return bitmap;
+    };
+    auto equal = [](const SkBitmap& a, const SkBitmap& b) {
+        return 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+    };
+
+    SkBitmap expected = draw(0);
+    // The first draw caches the layer, the second draws it from the cache.
+    REPORTER_ASSERT(reporter, equal(expected, draw(SkSurfaceProps::kCachePictureLayers_Flag)));
+    REPORTER_ASSERT(reporter, equal(expected, draw(SkSurfaceProps::kCachePictureLayers_Flag)));
+    REPORTER_ASSERT(reporter, equal(expected, draw(0)));
+}
+
+// Draws one of four bands of a page.  Leaves a translate and a clip behind, which must not reach
+// the other bands.
+static void draw_band(SkCanvas* canvas, int band) {
+    SkPaint paint;
+    canvas->clipRect(SkRect::MakeXYWH(0, 25 * band, 100, 25));
+    canvas->translate(0, 25 * band);
+    for (int i = 0; i < 50; ++i) {
+        paint.setColor(SkColorSetARGB(0xFF, 50 * band, 5 * i, 255 - 5 * i));
+        canvas->drawRect(SkRect::MakeXYWH(2 * i, i % 5, 10, 20), paint);
+    }
+}
+
+DEF_TEST(PictureRecorder_SubRecordings, reporter) {
+    SkRTreeFactory factory;
+    const SkRect cull = SkRect::MakeWH(100, 100);
+
+    SkPictureRecorder serialRecorder;
+    SkCanvas* serialCanvas = serialRecorder.beginRecording(cull, &factory);
+    for (int band = 0; band < 4; ++band) {
+        serialCanvas->save();
+        draw_band(serialCanvas, band);
+        serialCanvas->restore();
+    }
+    sk_sp<SkPicture> serial = serialRecorder.finishRecordingAsPicture();
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvases[4];
+    canvases[0] = recorder.beginRecording(cull, &factory);
+    for (int band = 1; band < 4; ++band) {
+        canvases[band] = recorder.beginSubRecording();
+    }
+    std::vector<std::thread> threads;
+    for (int band = 0; band < 4; ++band) {
+        threads.emplace_back([&canvases, band] { draw_band(canvases[band], band); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    sk_sp<SkPicture> parallel = recorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(reporter, parallel->approximateOpCount() == serial->approximateOpCount());
+
+    // Draw everything, then only the middle, which goes through the BBH.
+    for (const SkRect& clip : { cull, SkRect::MakeLTRB(10, 30, 90, 70) }) {
+        SkBitmap expected, actual;
+        expected.allocN32Pixels(100, 100);
+        actual.allocN32Pixels(100, 100);
+        expected.eraseColor(SK_ColorWHITE);
+        actual.eraseColor(SK_ColorWHITE);
+        SkCanvas expectedCanvas(expected), actualCanvas(actual);
+        expectedCanvas.clipRect(clip);
+        actualCanvas.clipRect(clip);
+        expectedCanvas.drawPicture(serial);
+        actualCanvas.drawPicture(parallel);
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                              expected.computeByteSize()));
+    }
+}
@@ -8,6 +8,7 @@
 #include "Resources.h"
 #include "SkCanvas.h"
 #include "SkPipe.h"
+#include "SkPipeRing.h"
 #include "SkPaint.h"
 #include "SkStream.h"
 #include "SkSurface.h"
@@ -17,6 +18,8 @@
 #include "SkAutoPixmapStorage.h"
 #include "SkPictureRecorder.h"
 
+#include <thread>
+
 static void drain(SkPipeDeserializer* deserial, SkDynamicMemoryWStream* stream) {
     std::unique_ptr<SkCanvas> canvas = SkMakeNullCanvas();
     sk_sp<SkData> data = stream->detachAsData();
@@ -185,3 +188,58 @@ DEF_TEST(Pipe_picture_draw_second, reporter) {
     size_t offset2 = stream.bytesWritten();
     REPORTER_ASSERT(reporter, offset2 <= 16);
 }
+
+DEF_TEST(Pipe_ring, reporter) {
+    // Small enough that the frames wrap around it many times, and the writer has to wait.
+    constexpr size_t kRingSize = 1024;
+    constexpr int kFrames = 200;
+    std::unique_ptr<uint64_t[]> memory(new uint64_t[kRingSize / sizeof(uint64_t)]());
+
+    std::thread producer([&memory, reporter] {
+        SkPipeSerializer serializer;
+        SkPipeRingWriter writer(memory.get(), kRingSize);
+        SkPaint paint;
+        for (int i = 0; i < kFrames; ++i) {
+            SkCanvas* wc = serializer.beginWrite(SkRect::MakeWH(10, 10), &writer);
+            paint.setColor(SkColorSetARGB(0xFF, i, 0, 0));
+            for (int j = 0; j <= i % 8; ++j) {
+                wc->drawRect(SkRect::MakeXYWH(j, 0, 1, 10), paint);
+            }
+            serializer.endWrite();
+            REPORTER_ASSERT(reporter, writer.endMessage());
+        }
+    });
+
+    auto surface = SkSurface::MakeRasterN32Premul(10, 10);
+    SkPipeDeserializer deserializer;
+    SkPipeRingReader reader(memory.get(), kRingSize);
+    for (int i = 0; i < kFrames;) {
+        size_t size;
+        const void* message = reader.peekMessage(&size);
+        if (!message) {
+            std::this_thread::yield();
+            continue;
+        }
+        REPORTER_ASSERT(reporter, deserializer.playback(message, size, surface->getCanvas()));
+        reader.releaseMessage();
+        ++i;
+    }
+    producer.join();
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(10, 10);
+    surface->readPixels(bitmap, 0, 0);
+    // The last frame drew over the first 8 columns.
+    for (int x = 0; x < 10; ++x) {
+        SkColor expected = x < 8 ? SkColorSetARGB(0xFF, kFrames - 1, 0, 0) : SK_ColorTRANSPARENT;
+        REPORTER_ASSERT(reporter, bitmap.getColor(x, 5) == expected);
+    }
+
+    // A message that can never fit is dropped.
+    SkPipeRingWriter writer(memory.get(), kRingSize);
+    char big[kRingSize] = {};
+    REPORTER_ASSERT(reporter, !writer.write(big, sizeof(big)));
+    REPORTER_ASSERT(reporter, !writer.endMessage());
+    size_t size;
+    REPORTER_ASSERT(reporter, !reader.peekMessage(&size));
+}
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkPackedRTree.h"
 #include "SkRTree.h"
 #include "SkRandom.h"
 #include "Test.h"
@@ -25,10 +26,11 @@ static SkRect random_rect(SkRandom& rand) {
     return rect;
 }
 
-static bool verify_query(SkRect query, SkRect rects[], SkTDArray<int>& found) {
+static bool verify_query(SkRect query, SkRect rects[], SkTDArray<int>& found,
+                         int numRects = NUM_RECTS) {
     SkTDArray<int> expected;
     // manually intersect with every rectangle
-    for (int i = 0; i < NUM_RECTS; ++i) {
+    for (int i = 0; i < numRects; ++i) {
         if (SkRect::Intersects(query, rects[i])) {
             expected.push(i);
         }
@@ -44,12 +46,12 @@ static bool verify_query(SkRect query, SkRect rects[], SkTDArray<int>& found) {
 }
 
 static void run_queries(skiatest::Reporter* reporter, SkRandom& rand, SkRect rects[],
-                        const SkRTree& tree) {
+                        const SkBBoxHierarchy& tree, int numRects = NUM_RECTS) {
     for (size_t i = 0; i < NUM_QUERIES; ++i) {
         SkTDArray<int> hits;
         SkRect query = random_rect(rand);
         tree.search(query, &hits);
-        REPORTER_ASSERT(reporter, verify_query(query, rects, hits));
+        REPORTER_ASSERT(reporter, verify_query(query, rects, hits, numRects));
     }
 }
 
@@ -89,3 +91,32 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(PackedRTree, reporter) {
+    SkRandom rand;
+    for (int numRects : { 0, 1, 7, 8, 9, NUM_RECTS, 5000 }) {
+        SkAutoTMalloc<SkRect> rects(numRects);
+        for (int j = 0; j < numRects; j++) {
+            rects[j] = random_rect(rand);
+        }
+        if (numRects > 2) {
+            rects[1].setEmpty();  // Empty bounds are never found.
+        }
+
+        SkPackedRTree tree;
+        tree.insert(rects.get(), numRects);
+        run_queries(reporter, rand, rects, tree, numRects);
+
+        int expectedCount = numRects > 2 ? numRects - 1 : numRects;
+        int expectedDepth = 0;
+        for (int nodes = expectedCount; nodes > 0;) {
+            nodes = (nodes + SkPackedRTree::kFanout - 1) / SkPackedRTree::kFanout;
+            expectedDepth++;
+            if (1 == nodes) {
+                break;
+            }
+        }
+        REPORTER_ASSERT(reporter, expectedCount == tree.getCount());
+        REPORTER_ASSERT(reporter, expectedDepth == tree.getDepth());
+    }
+}
@@ -8,9 +8,11 @@
 #include <initializer_list>
 #include "SkCanvas.h"
 #include "SkColorData.h"
+#include "SkExecutor.h"
 #include "SkHalf.h"
 #include "SkImageInfoPriv.h"
 #include "SkMathPriv.h"
+#include "SkRandom.h"
 #include "SkSurface.h"
 #include "Test.h"
 
@@ -694,3 +696,48 @@ DEF_TEST(ReadPixels_ValidConversion, reporter) {
         }
     }
 }
+
+DEF_TEST(ReadPixels_Executor, reporter) {
+    // Big enough to be split into bands, with a partial band at the bottom.
+    const int kW = 700, kH = 500;
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::Make(kW, kH, kRGBA_F16_SkColorType, kPremul_SkAlphaType,
+                                      SkColorSpace::MakeSRGBLinear()));
+    SkRandom random;
+    for (int y = 0; y < kH; y++) {
+        uint64_t* row = src.pixmap().writable_addr64(0, y);
+        for (int x = 0; x < kW; x++) {
+            float a = random.nextF(),
+                  rgba[] = { a * random.nextF(), a * random.nextF(), a * random.nextF(), a };
+            SkFloatToHalf_finite_ftz(Sk4f::Load(rgba)).store(row + x);
+        }
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkColorType kDstColorTypes[] = {
+        kRGBA_8888_SkColorType,
+        kBGRA_8888_SkColorType,
+        kRGB_565_SkColorType,   // Dithered.
+    };
+    for (SkColorType ct : kDstColorTypes) {
+        SkImageInfo dstInfo = SkImageInfo::Make(kW, kH, ct, kPremul_SkAlphaType,
+                                                SkColorSpace::MakeSRGB());
+        SkBitmap serial, banded;
+        serial.allocPixels(dstInfo);
+        banded.allocPixels(dstInfo);
+        REPORTER_ASSERT(reporter, src.pixmap().readPixels(serial.pixmap()));
+        REPORTER_ASSERT(reporter, src.pixmap().readPixels(banded.info(), banded.getPixels(),
+                                                          banded.rowBytes(), 0, 0,
+                                                          SkTransferFunctionBehavior::kRespect,
+                                                          executor.get()));
+        REPORTER_ASSERT(reporter, !memcmp(serial.getPixels(), banded.getPixels(),
+                                          serial.computeByteSize()));
+
+        banded.eraseColor(SK_ColorTRANSPARENT);
+        REPORTER_ASSERT(reporter, banded.writePixels(src.pixmap(), 0, 0,
+                                                     SkTransferFunctionBehavior::kRespect,
+                                                     executor.get()));
+        REPORTER_ASSERT(reporter, !memcmp(serial.getPixels(), banded.getPixels(),
+                                          serial.computeByteSize()));
+    }
+}
@@ -10,7 +10,9 @@
 
 #include "SkDebugCanvas.h"
 #include "SkDropShadowImageFilter.h"
+#include "SkExecutor.h"
 #include "SkImagePriv.h"
+#include "SkPictureRecorder.h"
 #include "SkRecord.h"
 #include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
@@ -309,3 +311,123 @@ DEF_TEST(RecordDraw_drawImage, r){
     REPORTER_ASSERT(r, canvas.fDrawImageRectCalled);
 
 }
+
+static sk_sp<SkPicture> make_busy_picture(int w, int h, bool useBBH) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(w, h, useBBH ? &factory : nullptr);
+    canvas->clear(SK_ColorWHITE);
+    // We stick to rects: paths that get clipped by a region's bounds may be chopped differently,
+    // so they are not guaranteed to produce nearly the same pixels as an unclipped draw.
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    // Pile up most of the draws in the top-left corner to exercise the region balancing.
+    for (int i = 0; i < 200; ++i) {
+        paint.setColor(0xFF000000 | (i * 0x010305));
+        canvas->drawRect(SkRect::MakeXYWH(i % 17 + 0.25f, i % 23 + 0.5f, 10.5f, 7.25f), paint);
+    }
+    paint.setAntiAlias(false);
+    for (int i = 0; i < 20; ++i) {
+        paint.setColor(0x80000000 | (i * 0x070503));
+        canvas->drawRect(SkRect::MakeXYWH(i * 7, i * 9, w / 2, 13.5f), paint);
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+DEF_TEST(RecordDraw_Parallel, r) {
+    const int w = 200, h = 300;
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (bool useBBH : { false, true }) {
+        sk_sp<SkPicture> picture = make_busy_picture(w, h, useBBH);
+
+        SkBitmap expected;
+        expected.allocN32Pixels(w, h);
+        expected.eraseColor(SK_ColorTRANSPARENT);
+        {
+            SkCanvas canvas(expected);
+            canvas.drawPicture(picture);
+        }
+
+        for (int regionCount : { 0, 1, 3, 16, 1000 }) {
+            SkBitmap actual;
+            actual.allocN32Pixels(w, h);
+            actual.eraseColor(SK_ColorTRANSPARENT);
+            SkRecordDrawParallel(picture.get(), actual.pixmap(), executor.get(), regionCount);
+
+            // Partially covered rows of clipped AA rects may be blended through a different blit
+            // call, so we allow each channel to be off by a little after many overlapping draws.
+            int maxDiff = 0;
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    SkPMColor e = *expected.getAddr32(x, y),
+                              a = *actual.getAddr32(x, y);
+                    for (int shift = 0; shift < 32; shift += 8) {
+                        maxDiff = SkTMax(maxDiff, SkTAbs((int)((e >> shift) & 0xff) -
+                                                         (int)((a >> shift) & 0xff)));
+                    }
+                }
+            }
+            REPORTER_ASSERT(r, maxDiff <= 2, "regionCount %d, maxDiff %d", regionCount, maxDiff);
+        }
+    }
+}
+
+static sk_sp<SkPicture> make_occluded_picture(uint32_t finishFlags) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 70, 70), paint);
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawCircle(50.5f, 50.5f, 20, paint);
+
+    // The opaque background of the next frame covers everything before it, but not the rects
+    // after it.
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(0.25f, 0.25f, 90.75f, 90.75f));
+    paint.setAntiAlias(false);
+    paint.setColor(SK_ColorWHITE);
+    canvas->drawPaint(paint);
+    canvas->restore();
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawRect(SkRect::MakeXYWH(30, 30, 10, 10), paint);
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawRect(SkRect::MakeXYWH(85, 85, 10, 10), paint);
+
+    // Translucent rects cover nothing.
+    paint.setColor(0x8000FF00);
+    canvas->drawRect(SkRect::MakeWH(100, 100), paint);
+    return recorder.finishRecordingAsPicture(finishFlags);
+}
+
+DEF_TEST(RecordDraw_OcclusionCulling, r) {
+    sk_sp<SkPicture> culled =
+            make_occluded_picture(SkPictureRecorder::kCullOccludedDraws_FinishFlag);
+    sk_sp<SkPicture> reference = make_occluded_picture(0);
+
+    SkRecord record;
+    SkRecorder recorder(&record, 100, 100);
+    culled->playback(&recorder);
+    REPORTER_ASSERT(r, 0 == count_instances_of_type<SkRecords::DrawOval>(record));
+    // Only the rects after the background are left.
+    REPORTER_ASSERT(r, 3 == count_instances_of_type<SkRecords::DrawRect>(record));
+    REPORTER_ASSERT(r, 1 == count_instances_of_type<SkRecords::DrawPaint>(record));
+
+    // Culling must not change any pixel, even where the background partially covers pixels.
+    for (SkScalar scale : { 1.0f, 0.37f, 2.5f }) {
+        SkBitmap bitmaps[2];
+        int size = SkScalarCeilToInt(100 * scale);
+        const sk_sp<SkPicture>* pictures[2] = { &culled, &reference };
+        for (int i = 0; i < 2; i++) {
+            bitmaps[i].allocN32Pixels(size, size);
+            SkCanvas canvas(bitmaps[i]);
+            canvas.clear(SK_ColorTRANSPARENT);
+            canvas.scale(scale, scale);
+            canvas.drawPicture(*pictures[i]);
+        }
+        REPORTER_ASSERT(r, 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(),
+                                       bitmaps[0].computeByteSize()));
+    }
+}
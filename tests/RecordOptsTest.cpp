@@ -11,6 +11,7 @@
 #include "SkBlurImageFilter.h"
 #include "SkColorFilter.h"
 #include "SkRecord.h"
+#include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
 #include "SkRecorder.h"
 #include "SkRecords.h"
@@ -427,3 +428,160 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+
+DEF_TEST(RecordOpts_MatrixPasses, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.translate(10, 20);
+    recorder.translate(5, 5);
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    recorder.scale(2, 3);
+    recorder.concat(SkMatrix::MakeScale(5, 7));
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    recorder.rotate(45);
+    recorder.setMatrix(SkMatrix::MakeTrans(1, 2));
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+
+    SkRecordOptStats stats;
+    SkRecordOptimize2(&record, &stats);
+    REPORTER_ASSERT(r, 1 == stats.fOverwrittenMatrices);
+    REPORTER_ASSERT(r, 2 == stats.fMergedMatrices);
+
+    REPORTER_ASSERT(r, 6 == record.count());
+    const auto* translate = assert_type<SkRecords::Translate>(r, record, 0);
+    REPORTER_ASSERT(r, 15 == translate->dx && 25 == translate->dy);
+    const auto* concat = assert_type<SkRecords::Concat>(r, record, 2);
+    REPORTER_ASSERT(r, SkMatrix(concat->matrix) == SkMatrix::MakeScale(10, 21));
+    assert_type<SkRecords::SetMatrix>(r, record, 4);
+}
+
+#ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
+DEF_TEST(RecordOpts_ClipOnlySaveLayers, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint srcOver, src;
+    src.setBlendMode(SkBlendMode::kSrc);
+    src.setAlpha(0x80);  // Opaque kSrc would be the same as src-over.
+
+    // Clip, matrix and src-over draws only: the layer becomes a Save.
+    recorder.saveLayer(nullptr, nullptr);
+        recorder.clipRect(SkRect::MakeWH(100, 100));
+        recorder.drawRect(SkRect::MakeWH(200, 200), srcOver);
+        recorder.drawRect(SkRect::MakeWH(50, 50), srcOver);
+    recorder.restore();
+
+    // Translucent kSrc replaces what is under it in the layer only, so the layer has to stay.
+    recorder.saveLayer(nullptr, nullptr);
+        recorder.drawRect(SkRect::MakeWH(200, 200), srcOver);
+        recorder.drawRect(SkRect::MakeWH(50, 50), src);
+    recorder.restore();
+
+    SkRecordOptStats stats;
+    SkRecordSaveLayersToSaves(&record, &stats);
+    REPORTER_ASSERT(r, 1 == stats.fClipOnlySaveLayers);
+    assert_type<SkRecords::Save>(r, record, 0);
+    assert_type<SkRecords::SaveLayer>(r, record, 5);
+}
+#endif
+
+DEF_TEST(RecordOpts_OccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque, translucent, aa;
+    translucent.setAlpha(0x80);
+    aa.setAntiAlias(true);
+
+    recorder.drawOval(SkRect::MakeXYWH(10, 10, 50, 50), translucent);
+    recorder.drawRect(SkRect::MakeXYWH(20, 20, 10, 10), opaque);
+    recorder.drawRect(SkRect::MakeWH(100, 100), opaque);      // Covers both draws above.
+    recorder.drawRect(SkRect::MakeWH(300, 300), translucent);  // Translucent occluder.
+    recorder.drawRect(SkRect::MakeWH(200, 200), aa);           // AA occluder.
+    recorder.drawRect(SkRect::MakeWH(400, 400), opaque);       // Larger than its occluder.
+    recorder.drawRect(SkRect::MakeWH(300, 300), opaque);
+
+    SkRecordOptStats stats;
+    SkRecordNoopOccludedDraws(&record, &stats);
+    REPORTER_ASSERT(r, 2 == stats.fOccludedDraws);
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    REPORTER_ASSERT(r, 5 == count_instances_of_type<SkRecords::DrawRect>(record));
+}
+
+DEF_TEST(RecordOpts_CoalesceRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+
+    recorder.drawRect(SkRect::MakeXYWH(0, 0, 10, 10), red);
+    recorder.drawRect(SkRect::MakeXYWH(20, 0, 10, 10), red);
+    recorder.drawRect(SkRect::MakeXYWH(40, 0, 10, 10), red);
+    recorder.drawRect(SkRect::MakeXYWH(60, 0, 10, 10), blue);       // Different paint.
+    recorder.drawRect(SkRect::MakeXYWH(80, 0, 10.5f, 10), blue);    // Not pixel aligned.
+
+    SkRecordOptStats stats;
+    SkRecordCoalesceRects(&record, &stats);
+    REPORTER_ASSERT(r, 2 == stats.fCoalescedRects);
+    const auto* region = assert_type<SkRecords::DrawRegion>(r, record, 2);
+    REPORTER_ASSERT(r, region->region.isComplex());
+    REPORTER_ASSERT(r, region->region.getBounds() == SkIRect::MakeWH(50, 10));
+    REPORTER_ASSERT(r, 2 == count_instances_of_type<SkRecords::DrawRect>(record));
+}
+
+static void draw_occluded_and_coalescable(SkCanvas* canvas) {
+    SkPaint red, green, blue;
+    red.setColor(SK_ColorRED);
+    green.setColor(SK_ColorGREEN);
+    blue.setColor(SK_ColorBLUE);
+
+    canvas->drawRect(SkRect::MakeXYWH(30, 30, 11, 11), red);
+    canvas->drawRect(SkRect::MakeWH(100, 100), blue);            // Occludes the red rect.
+    canvas->drawRect(SkRect::MakeXYWH( 0, 0, 20, 10), green);
+    canvas->drawRect(SkRect::MakeXYWH(10, 0, 20, 10), green);    // Overlaps the rect above.
+}
+
+// Through an anti-aliased clip, an occluded draw still shows where the clip only partly covers a
+// pixel, and overlapping rects blend twice there, so neither pass may change those draws.
+DEF_TEST(RecordOpts_AAClip, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.save();
+        recorder.clipRect(SkRect::MakeLTRB(0.5f, 0.5f, 40.5f, 40.5f), true);
+        draw_occluded_and_coalescable(&recorder);   // 2-5
+    recorder.restore();
+    recorder.save();
+        recorder.translate(50, 0);
+        recorder.clipRect(SkRect::MakeLTRB(0.5f, 0.5f, 40.5f, 40.5f), false);
+        draw_occluded_and_coalescable(&recorder);   // 10-13
+    recorder.restore();
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 50);
+    SkBitmap before, after;
+    before.allocPixels(info);
+    after.allocPixels(info);
+    SkCanvas beforeCanvas(before);
+    beforeCanvas.clear(SK_ColorWHITE);
+    SkRecordDraw(record, &beforeCanvas, nullptr, nullptr, 0, nullptr, nullptr);
+
+    SkRecordOptStats stats;
+    SkRecordNoopOccludedDraws(&record, &stats);
+    SkRecordCoalesceRects(&record, &stats);
+    REPORTER_ASSERT(r, 1 == stats.fOccludedDraws);
+    REPORTER_ASSERT(r, 1 == stats.fCoalescedRects);
+    for (int i = 2; i <= 5; i++) {
+        assert_type<SkRecords::DrawRect>(r, record, i);
+    }
+    assert_type<SkRecords::NoOp>(r, record, 10);
+    assert_type<SkRecords::DrawRegion>(r, record, 13);
+
+    SkCanvas afterCanvas(after);
+    afterCanvas.clear(SK_ColorWHITE);
+    SkRecordDraw(record, &afterCanvas, nullptr, nullptr, 0, nullptr, nullptr);
+    REPORTER_ASSERT(r, !memcmp(before.getPixels(), after.getPixels(), before.computeByteSize()));
+}
@@ -258,6 +258,17 @@ DEF_TEST(Region, reporter) {
         REPORTER_ASSERT(reporter, test_rects(rect, N));
     }
 
+    // Many rects on a coarse grid, so that lots of them share or abut edges.
+    for (int i = 0; i < 100; i++) {
+        const int N = 64;
+        SkIRect rect[N];
+        for (int j = 0; j < N; j++) {
+            int x = rand.nextU() % 8, y = rand.nextU() % 8;
+            rect[j].setXYWH(x * 4, y * 4, (rand.nextU() % 3) * 4, (rand.nextU() % 3) * 4);
+        }
+        REPORTER_ASSERT(reporter, test_rects(rect, N));
+    }
+
     test_proc(reporter, contains_proc);
     test_proc(reporter, intersects_proc);
     test_empties(reporter);
@@ -434,3 +445,38 @@ DEF_TEST(region_inverse_union_skbug_7491, reporter) {
     REPORTER_ASSERT(reporter, clip == rgn);
 }
 
+
+// Each operand's spans lie wholly left or right of the other's, or touch it, which ops copy
+// without merging.
+DEF_TEST(Region_apart_spans, reporter) {
+    SkRegion left, right;
+    left.op(SkIRect::MakeLTRB(0, 0, 10, 10), SkRegion::kUnion_Op);
+    left.op(SkIRect::MakeLTRB(0, 20, 5, 30), SkRegion::kUnion_Op);
+    right.op(SkIRect::MakeLTRB(10, 5, 20, 25), SkRegion::kUnion_Op);
+    right.op(SkIRect::MakeLTRB(30, 0, 40, 10), SkRegion::kUnion_Op);
+
+    for (int op = 0; op <= SkRegion::kLastOp; ++op) {
+        SkRegion a, b;
+        a.op(left, right, (SkRegion::Op)op);
+        b.op(right, left, (SkRegion::Op)op);
+        for (int y = -1; y <= 31; ++y) {
+            for (int x = -1; x <= 41; ++x) {
+                bool inL = left.contains(x, y), inR = right.contains(x, y);
+                bool expected[] = {
+                    inL && !inR, inL && inR, inL || inR, inL != inR, inR && !inL, inR
+                };
+                REPORTER_ASSERT(reporter, a.contains(x, y) == expected[op]);
+            }
+        }
+        // Union and xor are symmetric.
+        if (SkRegion::kUnion_Op == op || SkRegion::kXOR_Op == op) {
+            REPORTER_ASSERT(reporter, a == b);
+        }
+    }
+
+    // Side by side rects that touch union to one rect.
+    SkRegion rgn(SkIRect::MakeLTRB(0, 0, 10, 10));
+    rgn.op(SkIRect::MakeLTRB(10, 0, 20, 10), SkRegion::kUnion_Op);
+    REPORTER_ASSERT(reporter, rgn.isRect());
+    REPORTER_ASSERT(reporter, rgn.getBounds() == SkIRect::MakeLTRB(0, 0, 20, 10));
+}
@@ -86,8 +86,8 @@ static void overlap_test(skiatest::Reporter* reporter, GrResourceProvider* resou
 // This mainly acts as a test of the ResourceAllocator's free pool.
 static void non_overlap_test(skiatest::Reporter* reporter, GrResourceProvider* resourceProvider,
                              sk_sp<GrSurfaceProxy> p1, sk_sp<GrSurfaceProxy> p2,
-                             bool expectedResult) {
-    GrResourceAllocator alloc(resourceProvider);
+                             bool expectedResult, bool reuseLargerSurfaces = false) {
+    GrResourceAllocator alloc(resourceProvider, reuseLargerSurfaces);
 
     alloc.addInterval(p1.get(), 0, 2);
     alloc.addInterval(p2.get(), 3, 5);
@@ -199,6 +199,31 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ResourceAllocatorTest, reporter, ctxInfo) {
                          std::move(p1), std::move(p2), test.fExpectation);
     }
 
+    // Allowed to reuse larger surfaces, an approx-fit proxy takes any compatible free surface that
+    // is big enough.
+    TestCase gLargerSurfaceTests[] = {
+        { { 255,   kRT, kRGBA, kA, 0, kTL }, { 127,   kRT, kRGBA, kA, 0, kTL }, kShare },
+        { { 255, kNotRT, kRGBA, kA, 0, kTL }, { 127, kNotRT, kRGBA, kA, 0, kTL },
+          kConditionallyShare },
+        { { 255,   kRT, kRGBA, kE, 0, kTL }, { 127,   kRT, kRGBA, kA, 0, kTL }, kShare },
+        // ... but never a smaller one, one of another kind, or one for an exact-fit proxy
+        { { 127,   kRT, kRGBA, kA, 0, kTL }, { 255,   kRT, kRGBA, kA, 0, kTL }, kDontShare },
+        { { 255,   kRT, kRGBA, kA, 0, kTL }, { 127,   kRT, kBGRA, kA, 0, kTL }, kDontShare },
+        { { 255,   kRT, kRGBA, kA, 0, kTL }, { 127, kNotRT, kRGBA, kA, 0, kTL }, kDontShare },
+        { { 255,   kRT, kRGBA, kA, k2, kTL },{ 127,   kRT, kRGBA, kA, k4, kTL }, k2 == k4 },
+        { { 255,   kRT, kRGBA, kA, 0, kTL }, { 127,   kRT, kRGBA, kE, 0, kTL }, kDontShare },
+    };
+
+    for (auto test : gLargerSurfaceTests) {
+        sk_sp<GrSurfaceProxy> p1 = make_deferred(proxyProvider, test.fP1);
+        sk_sp<GrSurfaceProxy> p2 = make_deferred(proxyProvider, test.fP2);
+        if (!p1 || !p2) {
+            continue; // creation can fail (i.e., for msaa4 on iOS)
+        }
+        non_overlap_test(reporter, resourceProvider,
+                         std::move(p1), std::move(p2), test.fExpectation, true);
+    }
+
     {
         // Wrapped backend textures should never be reused
         TestCase t[1] = {
@@ -1545,6 +1545,78 @@ static void test_partial_purge(skiatest::Reporter* reporter) {
     }
 }
 
+static void test_incremental_purge(skiatest::Reporter* reporter) {
+    Mock mock(100, 1000);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+    GrGpu* gpu = context->contextPriv().getGpu();
+
+    context->setResourceCacheIncrementalPurging(250);
+    REPORTER_ASSERT(reporter, 250 == cache->getMaxBytesPurgedPerFlush());
+    for (int i = 0; i < 10; ++i) {
+        TestResource* r = new TestResource(gpu);
+        GrUniqueKey k;
+        make_unique_key<1>(&k, i);
+        r->resourcePriv().setUniqueKey(k);
+        r->unref();
+    }
+    cache->notifyFlushOccurred(GrResourceCache::kExternal);
+    REPORTER_ASSERT(reporter, 1000 == cache->getBudgetedResourceBytes());
+
+    // Lowering the budget purges no more than a flush's worth (finishing the resource that takes
+    // it past the limit)...
+    cache->setLimits(100, 500);
+    REPORTER_ASSERT(reporter, 700 == cache->getBudgetedResourceBytes());
+    REPORTER_ASSERT(reporter, !cache->requestsFlush());
+    // ... and the next flush carries on.
+    cache->notifyFlushOccurred(GrResourceCache::kExternal);
+    REPORTER_ASSERT(reporter, 500 == cache->getBudgetedResourceBytes());
+
+    // Nothing is purged after a frame that missed its target...
+    context->reportFrameTime(std::chrono::microseconds(20000), std::chrono::microseconds(16000));
+    cache->setLimits(100, 300);
+    cache->notifyFlushOccurred(GrResourceCache::kExternal);
+    REPORTER_ASSERT(reporter, 500 == cache->getBudgetedResourceBytes());
+    // ... until one doesn't.
+    context->reportFrameTime(std::chrono::microseconds(10000), std::chrono::microseconds(16000));
+    cache->notifyFlushOccurred(GrResourceCache::kExternal);
+    REPORTER_ASSERT(reporter, 300 == cache->getBudgetedResourceBytes());
+
+    // Past twice the budget the cache purges regardless.
+    context->reportFrameTime(std::chrono::microseconds(20000), std::chrono::microseconds(16000));
+    cache->notifyFlushOccurred(GrResourceCache::kExternal);
+    cache->setLimits(100, 100);
+    REPORTER_ASSERT(reporter, 200 == cache->getBudgetedResourceBytes());
+
+    // Explicit purges aren't limited.
+    cache->purgeUnlockedResources((size_t)200, false);
+    REPORTER_ASSERT(reporter, 0 == cache->getBudgetedResourceBytes());
+}
+
+static void test_memory_pressure(skiatest::Reporter* reporter) {
+    Mock mock(100, 10000);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+    GrGpu* gpu = context->contextPriv().getGpu();
+
+    TestResource* scratch = TestResource::CreateScratch(gpu, SkBudgeted::kYes,
+                                                        TestResource::kA_SimulatedProperty);
+    TestResource* unique = new TestResource(gpu);
+    GrUniqueKey key;
+    make_unique_key<0>(&key, 0);
+    unique->resourcePriv().setUniqueKey(key);
+    scratch->unref();
+    unique->unref();
+    REPORTER_ASSERT(reporter, 2 == cache->getResourceCount());
+
+    context->notifyMemoryPressure(GrContext::MemoryPressureLevel::kModerate);
+    REPORTER_ASSERT(reporter, 1 == cache->getResourceCount());
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key));
+
+    context->notifyMemoryPressure(GrContext::MemoryPressureLevel::kCritical);
+    REPORTER_ASSERT(reporter, 0 == cache->getResourceCount());
+}
+
 static void test_large_resource_count(skiatest::Reporter* reporter) {
     // Set the cache size to double the resource count because we're going to create 2x that number
     // resources, using two different key domains. Add a little slop to the bytes because we resize
@@ -1711,6 +1783,8 @@ DEF_GPUTEST(ResourceCacheMisc, reporter, /* options */) {
     test_flush(reporter);
     test_time_purge(reporter);
     test_partial_purge(reporter);
+    test_incremental_purge(reporter);
+    test_memory_pressure(reporter);
     test_large_resource_count(reporter);
     test_custom_data(reporter);
     test_abandoned(reporter);
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkRuntimeShader.h"
+#include "SkSLCompiler.h"
+#include "SkSLInterpreter.h"
+#include "SkShaderBase.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+
+static const char* kGradientSkSL =
+    "void main(float x, float y, inout float r, inout float g, inout float b, inout float a) {"
+    "    r = x / 16;"
+    "    if (y > 8) {"
+    "        g = 1;"
+    "    }"
+    "    for (int i = 0; i < 4; i++) {"
+    "        b += 0.25;"
+    "    }"
+    "    a = 1;"
+    "}";
+
+static void check_gradient(skiatest::Reporter* r, sk_sp<SkShader> shader) {
+    auto surface = SkSurface::MakeRasterN32Premul(16, 16);
+    SkPaint paint;
+    paint.setShader(std::move(shader));
+    surface->getCanvas()->drawPaint(paint);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    surface->readPixels(bitmap, 0, 0);
+    for (int y = 0; y < 16; y++) {
+        for (int x = 0; x < 16; x++) {
+            SkColor c = bitmap.getColor(x, y);
+            int red = (int)((x + 0.5f) / 16 * 255 + 0.5f);
+            REPORTER_ASSERT(r, SkTAbs((int)SkColorGetR(c) - red) <= 1, "%d %d %x", x, y, c);
+            REPORTER_ASSERT(r, SkColorGetG(c) == (y + 0.5f > 8 ? 0xFF : 0));
+            REPORTER_ASSERT(r, SkColorGetB(c) == 0xFF && SkColorGetA(c) == 0xFF);
+        }
+    }
+}
+
+DEF_TEST(RuntimeShader, r) {
+    sk_sp<SkShader> shader = SkRuntimeShader::Make(kGradientSkSL);
+    REPORTER_ASSERT(r, shader);
+    if (!shader) {
+        return;
+    }
+    check_gradient(r, shader);
+
+    // Shaders made from the same SkSL share its program, and serialize as the SkSL.
+    check_gradient(r, SkRuntimeShader::Make(kGradientSkSL));
+    sk_sp<SkData> data = shader->serialize();
+    check_gradient(r, SkShaderBase::Deserialize(data->data(), data->size()));
+
+    // Programs are checked as they're made.
+    REPORTER_ASSERT(r, !SkRuntimeShader::Make("void main(float x, float y) {}"));
+    REPORTER_ASSERT(r, !SkRuntimeShader::Make("void main(float x, float y, inout float r, "
+                                              "inout float g, inout float b, float a) {}"));
+    REPORTER_ASSERT(r, !SkRuntimeShader::Make("not sksl"));
+#ifndef SK_LLVM_AVAILABLE
+    REPORTER_ASSERT(r, !SkRuntimeShader::Make("void main(float x, float y, inout float r, "
+                                              "inout float g, inout float b, inout float a) {"
+                                              "    r = sin(x);"
+                                              "}"));
+#endif
+}
+
+// Each lane of runLanes() must end up where run() would, however the lanes diverge.
+DEF_TEST(RuntimeShader_InterpreterLanes, r) {
+    static const char* kSkSL =
+        "void main(int n, float x, inout int count, inout float sum) {"
+        "    for (int i = 0; i < n; i++) {"
+        "        if ((i & 1) < 1 && x > 0) {"
+        "            sum += x;"
+        "        } else {"
+        "            sum -= 1;"
+        "        }"
+        "        count++;"
+        "    }"
+        "    count += n > 3 || x < -1 ? 100 / (n + 1) : -1;"
+        "    float t = -sum;"
+        "    sum = !(t > 0) && n > 0 ? t : sum / 2;"
+        "}";
+    SkSL::Compiler compiler;
+    SkSL::Program::Settings settings;
+    std::unique_ptr<SkSL::Program> program =
+            compiler.convertProgram(SkSL::Program::kCPU_Kind, SkSL::String(kSkSL), settings);
+    REPORTER_ASSERT(r, program);
+    if (!program) {
+        return;
+    }
+    std::vector<SkSL::Interpreter::Value> stack;
+    SkSL::Interpreter interpreter(*program, &stack);
+    const SkSL::FunctionDefinition* main = interpreter.findFunction("main");
+    REPORTER_ASSERT(r, main && SkSL::Interpreter::CanRun(*main));
+
+    // A partial batch, so the lanes past count must be left alone.
+    const int count = SkSL::Interpreter::kLanes - 3;
+    SkSL::Interpreter::Lanes n, x, zero;
+    for (int i = 0; i < count; ++i) {
+        n.fValues[i] = i % 7;
+        x.fValues[i] = (i - 5) * 0.75f;
+    }
+    interpreter.pushLanes(n);
+    interpreter.pushLanes(x);
+    interpreter.pushLanes(zero);
+    interpreter.pushLanes(zero);
+    interpreter.runLanes(*main, count);
+    SkSL::Interpreter::Lanes sums = interpreter.popLanes(),
+                             counts = interpreter.popLanes();
+    interpreter.popLanes();
+    interpreter.popLanes();
+
+    for (int i = 0; i < count; ++i) {
+        interpreter.push(n.fValues[i]);
+        interpreter.push(x.fValues[i]);
+        interpreter.push(0);
+        interpreter.push(0.0f);
+        interpreter.run(*main);
+        float sum = interpreter.pop().fFloat;
+        int iterations = interpreter.pop().fInt;
+        interpreter.pop();
+        interpreter.pop();
+        REPORTER_ASSERT(r, counts.fValues[i].fInt == iterations, "%d", i);
+        REPORTER_ASSERT(r, sums.fValues[i].fFloat == sum, "%d", i);
+    }
+    for (int i = count; i < SkSL::Interpreter::kLanes; ++i) {
+        REPORTER_ASSERT(r, counts.fValues[i].fInt == 0 && sums.fValues[i].fFloat == 0);
+    }
+}
+
+#endif
@@ -5,6 +5,8 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
+#include "SkCanvas.h"
 #include "SkRect.h"
 #include "SkRectPriv.h"
 
@@ -14,11 +16,14 @@
 #include "SkSGDraw.h"
 #include "SkSGGroup.h"
 #include "SkSGInvalidationController.h"
+#include "SkSGPictureCache.h"
 #include "SkSGRect.h"
+#include "SkSGScene.h"
 #include "SkSGTransform.h"
 
 #include "Test.h"
 
+#include <algorithm>
 #include <vector>
 
 static void check_inval(skiatest::Reporter* reporter, const sk_sp<sksg::Node>& root,
@@ -194,4 +199,80 @@ DEF_TEST(SGInvalidation, reporter) {
     inval_test2(reporter);
 }
 
+DEF_TEST(SGDamageMerge, reporter) {
+    sksg::InvalidationController ic;
+    ic.inval(SkRect::MakeLTRB(  0, 0,  10, 10));
+    ic.inval(SkRect::MakeLTRB(100, 0, 110, 10));
+    ic.inval(SkRect::MakeLTRB( 10, 0,  20, 10));
+
+    ic.merge(2);
+    std::vector<SkRect> merged(ic.begin(), ic.end());
+    REPORTER_ASSERT(reporter, merged.size() == 2);
+    REPORTER_ASSERT(reporter, std::find(merged.begin(), merged.end(),
+                                        SkRect::MakeLTRB(0, 0, 20, 10)) != merged.end());
+    REPORTER_ASSERT(reporter, std::find(merged.begin(), merged.end(),
+                                        SkRect::MakeLTRB(100, 0, 110, 10)) != merged.end());
+    REPORTER_ASSERT(reporter, ic.bounds() == SkRect::MakeLTRB(0, 0, 110, 10));
+}
+
+DEF_TEST(SGRenderDamage, reporter) {
+    auto color1 = sksg::Color::Make(0xff000000),
+         color2 = sksg::Color::Make(0xff000000);
+    auto group  = sksg::Group::Make();
+    group->addChild(sksg::Draw::Make(sksg::Rect::Make(SkRect::MakeLTRB( 0, 0, 10, 10)), color1));
+    group->addChild(sksg::Draw::Make(sksg::Rect::Make(SkRect::MakeLTRB(90, 0, 100, 10)), color2));
+    auto scene = sksg::Scene::Make(group, sksg::AnimatorList());
+
+    SkBitmap bm;
+    bm.allocN32Pixels(100, 10);
+    SkCanvas canvas(bm);
+    canvas.clear(SK_ColorTRANSPARENT);
+    scene->render(&canvas);
+
+    // Nothing changed.
+    REPORTER_ASSERT(reporter, scene->renderDamage(&canvas).isEmpty());
+
+    color2->setColor(0xffff0000);
+    const auto damage = scene->renderDamage(&canvas);
+    REPORTER_ASSERT(reporter, damage == SkIRect::MakeLTRB(89, 0, 100, 10));
+    REPORTER_ASSERT(reporter, bm.getColor(5, 5) == 0xff000000);
+    REPORTER_ASSERT(reporter, bm.getColor(95, 5) == 0xffff0000);
+}
+
+DEF_TEST(SGPictureCache, reporter) {
+    auto color = sksg::Color::Make(0xff000000);
+    auto rect  = sksg::Rect::Make(SkRect::MakeWH(10, 10));
+    auto cache = sksg::PictureCache::Make(sksg::Draw::Make(rect, color));
+    auto m     = sksg::Matrix::Make(SkMatrix::I());
+    auto root  = sksg::Transform::Make(cache, m);
+
+    SkBitmap bm;
+    bm.allocN32Pixels(20, 20);
+    SkCanvas canvas(bm);
+    auto render = [&]() {
+        sksg::InvalidationController ic;
+        root->revalidate(&ic, SkMatrix::I());
+        canvas.clear(SK_ColorTRANSPARENT);
+        root->render(&canvas);
+    };
+
+    render();
+    render();
+    REPORTER_ASSERT(reporter, cache->recordCount() == 1);
+    REPORTER_ASSERT(reporter, cache->renderCount() == 2);
+
+    // Changes above the cache don't invalidate the picture.
+    m->setMatrix(SkMatrix::MakeTrans(10, 10));
+    render();
+    REPORTER_ASSERT(reporter, cache->recordCount() == 1);
+    REPORTER_ASSERT(reporter, bm.getColor(15, 15) == 0xff000000);
+    REPORTER_ASSERT(reporter, bm.getColor(5, 5) == 0);
+
+    // Changes below it do.
+    color->setColor(0xffff0000);
+    render();
+    REPORTER_ASSERT(reporter, cache->recordCount() == 2);
+    REPORTER_ASSERT(reporter, bm.getColor(15, 15) == 0xffff0000);
+}
+
 #endif // !defined(SK_BUILD_FOR_GOOGLE3)
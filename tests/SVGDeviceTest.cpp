@@ -9,9 +9,11 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkData.h"
+#include "SkGradientShader.h"
 #include "SkImage.h"
 #include "SkImageShader.h"
 #include "SkParse.h"
+#include "SkPath.h"
 #include "SkShader.h"
 #include "SkStream.h"
 #include "Test.h"
@@ -329,4 +331,44 @@ DEF_TEST(SVGDevice_image_shader_tileboth, reporter) {
     REPORTER_ASSERT(reporter, atoi(dom.findAttr(patternNode, "height")) == imageHeight);
 }
 
+static int count_occurrences(const char* str, const char* substr) {
+    int count = 0;
+    for (str = strstr(str, substr); str; str = strstr(str + 1, substr)) {
+        count++;
+    }
+    return count;
+}
+
+DEF_TEST(SVGDevice_shared_defs, reporter) {
+    const SkPoint pts[] = { { 0, 0 }, { 10, 10 } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+
+    SkPath path;
+    path.addCircle(5, 5, 5);
+
+    SkDynamicMemoryWStream stream;
+    {
+        std::unique_ptr<SkCanvas> svgCanvas = SkSVGCanvas::Make(SkRect::MakeWH(100, 100),
+                                                                &stream);
+        svgCanvas->clipRect(SkRect::MakeWH(50, 50));
+        for (int i = 0; i < 3; ++i) {
+            svgCanvas->translate(10, 0);
+            svgCanvas->drawPath(path, paint);
+        }
+    }
+    sk_sp<SkData> data = stream.detachAsData();
+    SkString svg(static_cast<const char*>(data->data()), data->size());
+
+    // The gradient and clip are written once. The path is drawn inline the first time, then
+    // written to <defs> and used for the other two draws.
+    REPORTER_ASSERT(reporter, count_occurrences(svg.c_str(), "<linearGradient") == 1);
+    REPORTER_ASSERT(reporter, count_occurrences(svg.c_str(), "<clipPath") == 1);
+    REPORTER_ASSERT(reporter, count_occurrences(svg.c_str(), "<path") == 2);
+    REPORTER_ASSERT(reporter, count_occurrences(svg.c_str(), "<use") == 2);
+    REPORTER_ASSERT(reporter, count_occurrences(svg.c_str(), "</svg>") == 1);
+}
+
 #endif
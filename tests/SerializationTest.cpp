@@ -9,6 +9,7 @@
 #include "SkAnnotationKeys.h"
 #include "SkCanvas.h"
 #include "SkDashPathEffect.h"
+#include "SkExecutor.h"
 #include "SkFixed.h"
 #include "SkFontDescriptor.h"
 #include "SkImage.h"
@@ -16,6 +17,7 @@
 #include "SkMakeUnique.h"
 #include "SkMallocPixelRef.h"
 #include "SkMatrixPriv.h"
+#include "SkMultiPictureDocument.h"
 #include "SkOSFile.h"
 #include "SkReadBuffer.h"
 #include "SkPictureRecorder.h"
@@ -710,3 +712,38 @@ DEF_TEST(WriteBuffer_external_memory_flattenable, reporter) {
     storage.realloc(storage_size);
     REPORTER_ASSERT(reporter, path_effect->serialize(storage.get(), storage_size) != 0u);
 }
+
+static sk_sp<SkData> make_multi_picture_document(SkExecutor* executor) {
+    SkSerialProcs procs;
+    procs.fExecutor = executor;
+    SkDynamicMemoryWStream stream;
+    sk_sp<SkDocument> doc = SkMakeMultiPictureDocument(&stream, &procs);
+    const char* styles[] = { "serif", "sans-serif", "monospace" };
+    for (int page = 0; page < 6; page++) {
+        SkCanvas* canvas = doc->beginPage(100, 100);
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeXYWH(page, page, 20, 20), paint);
+        // Each page's typeface differs from the last, so typeface indices depend on page order.
+        paint.setTypeface(sk_tool_utils::create_portable_typeface(styles[(5 - page) % 3],
+                                                                  SkFontStyle()));
+        canvas->drawString("page", 10, 50, paint);
+        doc->endPage();
+    }
+    doc->close();
+    return stream.detachAsData();
+}
+
+DEF_TEST(Serialization_MultiPictureDocumentParallel, reporter) {
+    sk_sp<SkData> serial = make_multi_picture_document(nullptr);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    sk_sp<SkData> parallel = make_multi_picture_document(executor.get());
+    REPORTER_ASSERT(reporter, serial->equals(parallel.get()));
+
+    SkMemoryStream stream(parallel);
+    SkDocumentPage pages[6];
+    REPORTER_ASSERT(reporter, SkMultiPictureDocumentRead(&stream, pages, 6));
+    for (const SkDocumentPage& page : pages) {
+        REPORTER_ASSERT(reporter, page.fPicture && page.fSize == SkSize::Make(100, 100));
+    }
+}
@@ -10,6 +10,7 @@
 #include "SkCanvas.h"
 #include "SkImage.h"
 #include "SkPerlinNoiseShader.h"
+#include "SkPerlinNoiseShaderPriv.h"
 #include "SkRRect.h"
 #include "SkShader.h"
 #include "SkSurface.h"
@@ -79,3 +80,84 @@ DEF_TEST(ComposeShaderSingle, reporter) {
     rr.setRectRadii({0, 0, 0, 0}, rd);
     canvas.drawRRect(rr, p);
 }
+
+static bool colors_within(SkPMColor a, SkPMColor b, int tolerance) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        if (SkTAbs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void check_bitmaps_within(skiatest::Reporter* reporter, const SkBitmap& a,
+                                 const SkBitmap& b, int tolerance) {
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            if (!colors_within(*a.getAddr32(x, y), *b.getAddr32(x, y), tolerance)) {
+                ERRORF(reporter, "(%d, %d): %08x vs. %08x", x, y,
+                       *a.getAddr32(x, y), *b.getAddr32(x, y));
+                return;
+            }
+        }
+    }
+}
+
+static sk_sp<SkShader> make_noise(bool turbulence, const SkISize* tileSize) {
+    return turbulence ? SkPerlinNoiseShader::MakeTurbulence(0.05f, 0.07f, 3, 2.0f, tileSize)
+                      : SkPerlinNoiseShader::MakeFractalNoise(0.05f, 0.07f, 3, 2.0f, tileSize);
+}
+
+// Spans of at least four pixels evaluate the noise four at a time; single pixels don't.
+DEF_TEST(PerlinNoise_Vectorized, reporter) {
+    const SkISize tileSize = SkISize::Make(40, 30);
+    for (bool turbulence : { false, true })
+    for (const SkISize* tile : { (const SkISize*)nullptr, &tileSize }) {
+        SkPaint paint;
+        paint.setShader(make_noise(turbulence, tile));
+        paint.setAlpha(0xC0);
+
+        SkBitmap spans, pixels;
+        spans.allocN32Pixels(61, 23);
+        pixels.allocN32Pixels(61, 23);
+        spans.eraseColor(SK_ColorTRANSPARENT);
+        pixels.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas(spans).drawPaint(paint);
+        SkCanvas canvas(pixels);
+        for (int x = 0; x < pixels.width(); x++) {
+            canvas.save();
+            canvas.clipRect(SkRect::MakeXYWH(SkIntToScalar(x), 0, 1, SkIntToScalar(23)));
+            canvas.drawPaint(paint);
+            canvas.restore();
+        }
+        check_bitmaps_within(reporter, spans, pixels, 1);
+    }
+}
+
+// A cached stitched tile draws what evaluating the noise draws, inside the tile and out.
+DEF_TEST(PerlinNoise_TileCache, reporter) {
+    const SkISize tileSize = SkISize::Make(40, 30);
+    const SkMatrix localMatrix = SkMatrix::MakeTrans(5, 3);
+    for (bool turbulence : { false, true }) {
+        sk_sp<SkShader> caching =
+                turbulence ? SkPerlinNoiseShaderPriv::MakeTurbulenceCachingTiles(
+                                     0.05f, 0.07f, 3, 2.0f, &tileSize)
+                           : SkPerlinNoiseShaderPriv::MakeFractalNoiseCachingTiles(
+                                     0.05f, 0.07f, 3, 2.0f, &tileSize);
+        SkPaint paint, cachingPaint;
+        paint.setShader(make_noise(turbulence, &tileSize)->makeWithLocalMatrix(localMatrix));
+        cachingPaint.setShader(caching->makeWithLocalMatrix(localMatrix));
+
+        SkBitmap evaluated, cached;
+        evaluated.allocN32Pixels(64, 48);
+        cached.allocN32Pixels(64, 48);
+
+        evaluated.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas(evaluated).drawPaint(paint);
+        for (int i = 0; i < 2; i++) {  // Once to add the tile, then once to find it.
+            cached.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas(cached).drawPaint(cachingPaint);
+            check_bitmaps_within(reporter, evaluated, cached, 1);
+        }
+    }
+}
@@ -5,13 +5,17 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkDrawShadowInfo.h"
+#include "SkImage.h"
 #include "SkPath.h"
 #include "SkShadowTessellator.h"
 #include "SkShadowUtils.h"
+#include "SkSurface.h"
 #include "SkVertices.h"
 #include "Test.h"
+#include "sk_tool_utils.h"
 
 void tessellate_shadow(skiatest::Reporter* reporter, const SkPath& path, const SkMatrix& ctm,
                        bool expectSuccess) {
@@ -115,3 +119,105 @@ DEF_TEST(ShadowBounds, reporter) {
     path.cubicTo(100, 50, 20, 100, 0, 0);
     check_bounds(reporter, path);
 }
+
+DEF_TEST(ShadowUtils_DrawShadows, reporter) {
+    // Drawing a list's shadows at once draws what drawing each in turn does.
+    constexpr int kCount = 6;
+    SkPath paths[kCount];
+    SkPoint3 zPlaneParams[kCount];
+    for (int i = 0; i < kCount; ++i) {
+        SkRect r = SkRect::MakeXYWH(20.f + 35 * (i % 3), 20.f + 60 * (i / 3), 25, 40);
+        if (i % 2) {
+            paths[i].addRoundRect(r, 4, 4);
+        } else {
+            paths[i].moveTo(r.fLeft, r.fTop);
+            paths[i].lineTo(r.fRight, r.centerY());
+            paths[i].lineTo(r.fLeft, r.fBottom);
+        }
+        zPlaneParams[i] = SkPoint3::Make(0, 0, 2.f + 3.3f * i);
+    }
+    const SkPoint3 lightPos = SkPoint3::Make(60, 0, 600);
+
+    auto draw = [&](bool batched) {
+        auto surface = SkSurface::MakeRasterN32Premul(160, 160);
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->translate(3.5f, 7.25f);
+        if (batched) {
+            SkShadowUtils::DrawShadows(canvas, paths, zPlaneParams, kCount, lightPos, 80,
+                                       0x10000000, 0x40000000);
+        } else {
+            for (int i = 0; i < kCount; ++i) {
+                SkShadowUtils::DrawShadow(canvas, paths[i], zPlaneParams[i], lightPos, 80,
+                                          0x10000000, 0x40000000);
+            }
+        }
+        return surface->makeImageSnapshot();
+    };
+    sk_sp<SkImage> batched = draw(true),
+                   single  = draw(false);
+    REPORTER_ASSERT(reporter, sk_tool_utils::equal_pixels(batched.get(), single.get()));
+}
+
+DEF_TEST(ShadowUtils_AnalyticRaster, reporter) {
+    // Raster draws the shadows of rects and rrects analytically, unless asked for geometry. The
+    // two should look alike outside the occluder. Under it, and along its edge, the tessellated
+    // shadows fill differently; tessellated circles are also only polygons, hence the tolerance.
+    SkPath rrect, rect, circle;
+    rrect.addRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(30, 40, 80, 50), 12, 12));
+    rect.addRect(SkRect::MakeXYWH(40, 30, 70, 90));
+    circle.addCircle(80, 70, 35);
+    const SkMatrix matrices[] = {
+        SkMatrix::I(),
+        SkMatrix::MakeTrans(13.5f, 7.25f),
+        SkMatrix::Concat(SkMatrix::MakeTrans(20, 10), SkMatrix::MakeScale(1.5f)),
+    };
+    constexpr int kSize = 240;
+    constexpr int kTolerance = 64;
+
+    for (const SkPath* path : { &rrect, &rect, &circle })
+    for (const SkMatrix& matrix : matrices)
+    for (uint32_t flags : { (uint32_t)SkShadowFlags::kNone_ShadowFlag,
+                            (uint32_t)SkShadowFlags::kTransparentOccluder_ShadowFlag }) {
+        auto draw = [&](uint32_t extraFlags) {
+            SkBitmap bitmap;
+            bitmap.allocN32Pixels(kSize, kSize);
+            bitmap.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(bitmap);
+            canvas.concat(matrix);
+            SkShadowUtils::DrawShadow(&canvas, *path, SkPoint3::Make(0, 0, 8),
+                                      SkPoint3::Make(120, 0, 600), 80, 0x40000000, 0x80000000,
+                                      flags | extraFlags);
+            return bitmap;
+        };
+        SkBitmap analytic  = draw(SkShadowFlags::kNone_ShadowFlag),
+                 geometric = draw(SkShadowFlags::kGeometricOnly_ShadowFlag);
+
+        // Masks the occluder and a couple of pixels around it.
+        SkBitmap occluder;
+        occluder.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+        occluder.eraseColor(SK_ColorTRANSPARENT);
+        {
+            SkCanvas canvas(occluder);
+            canvas.concat(matrix);
+            SkPaint paint;
+            paint.setStyle(SkPaint::kStrokeAndFill_Style);
+            paint.setStrokeWidth(4);
+            canvas.drawPath(*path, paint);
+        }
+
+        int maxDiff = 0;
+        for (int y = 0; y < kSize; y++)
+        for (int x = 0; x < kSize; x++) {
+            if (*occluder.getAddr8(x, y)) {
+                continue;
+            }
+            SkPMColor a = *analytic.getAddr32(x, y),
+                      g = *geometric.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                maxDiff = SkTMax(maxDiff, SkTAbs((int)((a >> shift) & 0xFF) -
+                                                 (int)((g >> shift) & 0xFF)));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= kTolerance, "max difference %d", maxDiff);
+    }
+}
@@ -5,8 +5,10 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkLiteDL.h"
 #include "SkLiteRecorder.h"
+#include "SkRRect.h"
 #include "SkRSXform.h"
 #include "Test.h"
 
@@ -88,3 +90,43 @@ DEF_TEST(SkLiteRecorder_RSXformAlignment, r) {
     // We're just checking that this recorded our draw without SkASSERTing in Debug builds.
     REPORTER_ASSERT(r, !dl.empty());
 }
+
+DEF_TEST(SkLiteDL_compile, r) {
+    SkPaint red, blue, clear;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+    clear.setColor(SK_ColorTRANSPARENT);
+
+    SkLiteDL dl;
+    dl.save();
+        dl.translate(5, 5);
+        dl.drawRect(SkRect{0,0,20,20}, red);
+        dl.drawOval(SkRect{10,10,40,30}, clear);
+        dl.drawRect(SkRect{20,20,50,50}, blue);
+        dl.drawRRect(SkRRect::MakeRectXY(SkRect{30,0,60,20}, 4, 4), red);
+    dl.restore();
+    dl.drawPaint(clear);
+
+    auto draw = [&]() {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(64, 64);
+        bitmap.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bitmap);
+        canvas.scale(0.5f, 1.5f);
+        dl.draw(&canvas);
+        return bitmap;
+    };
+    SkBitmap expected = draw();
+
+    dl.compile();
+    REPORTER_ASSERT(r, dl.isCompiled());
+    REPORTER_ASSERT(r, 3 == dl.compiledPaintCount());
+    REPORTER_ASSERT(r, 2 == dl.compiledSkippedDraws());
+    SkBitmap actual = draw();
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.computeByteSize()));
+
+    // Recording more ops drops the compiled list.
+    dl.drawRect(SkRect{0,0,1,1}, red);
+    REPORTER_ASSERT(r, !dl.isCompiled());
+}
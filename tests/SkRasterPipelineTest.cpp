@@ -6,8 +6,14 @@
  */
 
 #include "Test.h"
+#include "SkArenaAlloc.h"
+#include "SkColorFilter.h"
+#include "SkData.h"
 #include "SkHalf.h"
+#include "SkJSONWriter.h"
 #include "SkRasterPipeline.h"
+#include "SkStream.h"
+#include "SkTableColorFilter.h"
 #include "../src/jumper/SkJumper.h"
 
 DEF_TEST(SkRasterPipeline, r) {
@@ -232,3 +238,248 @@ DEF_TEST(SkRasterPipeline_lowp, r) {
         }
     }
 }
+
+DEF_TEST(SkRasterPipeline_compileCache, r) {
+    // Two pipelines with the same stages but different contexts should share a cached program,
+    // and each should still run with its own contexts.
+    auto run = [&](uint32_t src, uint32_t dst) {
+        SkJumper_MemoryCtx load_s_ctx = { &src, 0 },
+                           load_d_ctx = { &dst, 0 },
+                           store_ctx  = { &dst, 0 };
+        SkSTArenaAlloc<256> alloc;
+        SkRasterPipeline p(&alloc);
+        p.append(SkRasterPipeline::load_8888,     &load_s_ctx);
+        p.append(SkRasterPipeline::load_8888_dst, &load_d_ctx);
+        p.append(SkRasterPipeline::clamp_0);
+        p.append(SkRasterPipeline::srcover);
+        p.append(SkRasterPipeline::store_8888, &store_ctx);
+        p.compile()(0,0,1,1);
+        return dst;
+    };
+
+    REPORTER_ASSERT(r, run(0xff0000ff, 0xffff0000) == 0xff0000ff);
+    int hits = SkRasterPipeline::GetProgramCacheStats().fHits;
+    REPORTER_ASSERT(r, run(0x00000000, 0xff00ff00) == 0xff00ff00);
+    REPORTER_ASSERT(r, SkRasterPipeline::GetProgramCacheStats().fHits > hits);
+    REPORTER_ASSERT(r, SkRasterPipeline::GetProgramCacheStats().fCount > 0);
+}
+
+DEF_TEST(SkRasterPipeline_fusion, r) {
+    // Fused stages should draw the same as the stages they replace.
+    auto run = [&](bool fuse, uint32_t src[], uint32_t dst[], float coords[]) {
+        SkSTArenaAlloc<256> alloc;
+        const float affine[] = { 2,0.5f, -1,3, 7,-2 };
+        SkJumper_MemoryCtx coords_ctx = { coords, 0 };
+        SkRasterPipeline seed(&alloc);
+        seed.setFuseStages(fuse);
+        seed.append(SkRasterPipeline::seed_shader);
+        seed.append(SkRasterPipeline::matrix_2x3, affine);
+        seed.append(SkRasterPipeline::store_f32, &coords_ctx);
+        seed.run(0,0,20,1);
+
+        SkJumper_MemoryCtx src_ctx = { src, 0 },
+                           dst_ctx = {  dst, 0 };
+        SkRasterPipeline blend(&alloc);
+        blend.setFuseStages(fuse);
+        blend.append(SkRasterPipeline::load_8888, &src_ctx);
+        blend.append(SkRasterPipeline::scale_1_float, &affine[1]);
+        blend.append(SkRasterPipeline::load_8888_dst, &dst_ctx);
+        blend.append(SkRasterPipeline::srcover);
+        blend.append(SkRasterPipeline::store_8888, &dst_ctx);
+        blend.compile()(0,0,20,1);
+    };
+
+    float coords[2][20*4];
+    uint32_t src[20], dst[2][20];
+    for (int x = 0; x < 20; x++) {
+        src[x] = (x * 0x0d) << 24 | (x * 0x0c0b0a);
+    }
+    for (int i = 0; i < 2; i++) {
+        for (int x = 0; x < 20; x++) {
+            dst[i][x] = 0xff000000 | (x * 0x0a0b0c);
+        }
+        run(i == 0, src, dst[i], coords[i]);
+    }
+
+    for (int x = 0; x < 20; x++) {
+        for (int c = 0; c < 2; c++) {
+            REPORTER_ASSERT(r, coords[0][4*x+c] == coords[1][4*x+c]);
+        }
+        for (int shift = 0; shift < 32; shift += 8) {
+            int fused   = (dst[0][x] >> shift) & 0xff,
+                unfused = (dst[1][x] >> shift) & 0xff;
+            REPORTER_ASSERT(r, SkTAbs(fused - unfused) <= 1,
+                            "pixel %d: fused %08x, unfused %08x", x, dst[0][x], dst[1][x]);
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_profile, r) {
+    uint32_t src[20], dst[20];
+    for (int x = 0; x < 20; x++) {
+        src[x] = x * 0x01020304;
+        dst[x] = 0;
+    }
+    SkJumper_MemoryCtx src_ctx = { src, 0 },
+                       dst_ctx = { dst, 0 };
+
+    SkRasterPipeline::StageProfiles profiles;
+
+    SkSTArenaAlloc<256> alloc;
+    SkRasterPipeline p(&alloc);
+    p.append(SkRasterPipeline:: load_8888, &src_ctx);
+    p.append(SkRasterPipeline::store_8888, &dst_ctx);
+    p.run(0,0, 20,1, &profiles);
+    auto fn = p.compile(&profiles);
+    fn(0,0, 20,1);
+    fn(0,0, 20,1);
+
+    // Profiling shouldn't change what we draw, and our stages should have seen each pixel 3 times.
+    REPORTER_ASSERT(r, 0 == memcmp(src, dst, sizeof(src)));
+    REPORTER_ASSERT(r, profiles.get(SkRasterPipeline:: load_8888).fPixels == 60);
+    REPORTER_ASSERT(r, profiles.get(SkRasterPipeline::store_8888).fPixels == 60);
+    REPORTER_ASSERT(r, profiles.get(SkRasterPipeline::srcover).fPixels == 0);
+
+    SkDynamicMemoryWStream stream;
+    {
+        SkJSONWriter writer(&stream);
+        profiles.dump(&writer);
+    }
+    sk_sp<SkData> json = stream.detachAsData();
+    REPORTER_ASSERT(r, json->size() > 0);
+    REPORTER_ASSERT(r, strstr((const char*)json->bytes(), "store_8888") != nullptr);
+
+    profiles.reset();
+    REPORTER_ASSERT(r, profiles.get(SkRasterPipeline::load_8888).fPixels == 0);
+}
+
+DEF_TEST(SkRasterPipeline_bilerpTile, r) {
+    // The fused bilinear stage, which runs in lowp, should sample like the generic bilinear
+    // stages, which run in highp, for each mix of clamp, repeat and mirror tiling.
+    const int kW = 5, kH = 3;
+    uint32_t image[kW*kH];
+    for (int i = 0; i < kW*kH; i++) {
+        image[i] = 0xff000000 | (i * 0x110d07);
+    }
+    SkJumper_GatherCtx gather = { image, kW, (float)kW, (float)kH };
+    SkJumper_TileCtx limit_x = { (float)kW, 1.0f / kW },
+                     limit_y = { (float)kH, 1.0f / kH };
+
+    // Covers the image a few times over, starting up and to the left of it.
+    const float scale_translate[] = { 0.7f, 0.6f, -6.3f, -3.1f };
+
+    const int kTileModes[] = { SkJumper_kTileClamp, SkJumper_kTileRepeat, SkJumper_kTileMirror };
+    for (int tile_x : kTileModes)
+    for (int tile_y : kTileModes) {
+        uint32_t fused[20*10], generic[20*10];
+
+        SkJumper_BilerpTileCtx ctx = { gather, limit_x, limit_y, tile_x, tile_y };
+        SkJumper_MemoryCtx fused_ctx = { fused, 20 };
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::seed_shader);
+        p.append(SkRasterPipeline::matrix_scale_translate, scale_translate);
+        p.append(SkRasterPipeline::bilerp_tile_8888, &ctx);
+        p.append(SkRasterPipeline::store_8888, &fused_ctx);
+        p.run(0,0,20,10);
+
+        SkJumper_SamplerCtx sampler;
+        SkJumper_MemoryCtx generic_ctx = { generic, 20 };
+        SkRasterPipeline_<256> q;
+        q.append(SkRasterPipeline::seed_shader);
+        q.append(SkRasterPipeline::matrix_scale_translate, scale_translate);
+        q.append(SkRasterPipeline::save_xy, &sampler);
+        auto sample = [&](SkRasterPipeline::StockStage setup_x,
+                          SkRasterPipeline::StockStage setup_y) {
+            q.append(setup_x, &sampler);
+            q.append(setup_y, &sampler);
+            if (tile_x == SkJumper_kTileRepeat) { q.append(SkRasterPipeline::repeat_x, &limit_x); }
+            if (tile_x == SkJumper_kTileMirror) { q.append(SkRasterPipeline::mirror_x, &limit_x); }
+            if (tile_y == SkJumper_kTileRepeat) { q.append(SkRasterPipeline::repeat_y, &limit_y); }
+            if (tile_y == SkJumper_kTileMirror) { q.append(SkRasterPipeline::mirror_y, &limit_y); }
+            q.append(SkRasterPipeline::gather_8888, &gather);
+            q.append(SkRasterPipeline::accumulate, &sampler);
+        };
+        sample(SkRasterPipeline::bilinear_nx, SkRasterPipeline::bilinear_ny);
+        sample(SkRasterPipeline::bilinear_px, SkRasterPipeline::bilinear_ny);
+        sample(SkRasterPipeline::bilinear_nx, SkRasterPipeline::bilinear_py);
+        sample(SkRasterPipeline::bilinear_px, SkRasterPipeline::bilinear_py);
+        q.append(SkRasterPipeline::move_dst_src);
+        q.append(SkRasterPipeline::store_8888, &generic_ctx);
+        q.run(0,0,20,10);
+
+        for (int i = 0; i < 20*10; i++) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                // Lowp weighs the four samples in 1/256ths, so may be off by a few.
+                int f = (fused[i] >> shift) & 0xff,
+                    g = (generic[i] >> shift) & 0xff;
+                REPORTER_ASSERT(r, SkTAbs(f - g) <= 3,
+                                "tile %d,%d pixel %d: fused %08x, generic %08x",
+                                tile_x, tile_y, i, fused[i], generic[i]);
+            }
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_colorFilterLowp, r) {
+    // Color matrix and table filters should give the same 8-bit results whether their pipeline
+    // stores 8888, which may run in lowp, or f32, which always runs in highp.
+    SkScalar gray[20] = { 0 };
+    gray[0] = gray[5] = gray[10] = 0.2126f;
+    gray[1] = gray[6] = gray[11] = 0.7152f;
+    gray[2] = gray[7] = gray[12] = 0.0722f;
+    gray[18] = 1.0f;
+    SkScalar tint[20] = { 0.9f,    0, 0.2f,    0, -20,
+                             0, 1.1f,    0,    0,  30,
+                          0.1f,    0, 0.7f, 0.1f,   5,
+                             0,    0,    0, 0.8f,   0 };
+    uint8_t invert[256], ramp[256];
+    for (int i = 0; i < 256; i++) {
+        invert[i] = 255 - i;
+        ramp[i]   = (uint8_t)(i * i / 255);
+    }
+    sk_sp<SkColorFilter> filters[] = {
+        SkColorFilter::MakeMatrixFilterRowMajor255(gray),
+        SkColorFilter::MakeMatrixFilterRowMajor255(tint),
+        SkTableColorFilter::MakeARGB(nullptr, invert, ramp, invert),
+        SkTableColorFilter::MakeARGB(ramp, invert, nullptr, ramp),
+    };
+
+    // An odd width, so the last few pixels take the tail path.
+    const int kN = 67;
+    for (bool opaque : { true, false }) {
+        uint32_t src[kN];
+        for (int i = 0; i < kN; i++) {
+            int a = opaque ? 255 : (i * 37 + 11) & 0xff;
+            src[i] = SkPackARGB32NoCheck(a, (i * 5) % (a + 1), (i * 71) % (a + 1), a - i % (a + 1));
+        }
+
+        for (const auto& filter : filters) {
+            uint32_t bytes[kN];
+            float    floats[4*kN];
+            SkJumper_MemoryCtx src_ctx    = { src,    0 },
+                               bytes_ctx  = { bytes,  0 },
+                               floats_ctx = { floats, 0 };
+
+            SkSTArenaAlloc<1024> alloc;
+            SkRasterPipeline_<256> p, q;
+            p.append(SkRasterPipeline::load_8888, &src_ctx);
+            filter->appendStages(&p, nullptr, &alloc, opaque);
+            p.append(SkRasterPipeline::store_8888, &bytes_ctx);
+            p.run(0,0,kN,1);
+
+            q.append(SkRasterPipeline::load_8888, &src_ctx);
+            filter->appendStages(&q, nullptr, &alloc, opaque);
+            q.append(SkRasterPipeline::store_f32, &floats_ctx);
+            q.run(0,0,kN,1);
+
+            for (int i = 0; i < kN; i++)
+            for (int c = 0; c < 4; c++) {
+                int lowp  = (bytes[i] >> (8*c)) & 0xff,
+                    highp = (int)(SkTPin(floats[4*i+c], 0.0f, 1.0f) * 255 + 0.5f);
+                REPORTER_ASSERT(r, SkTAbs(lowp - highp) <= 1,
+                                "opaque %d pixel %d channel %d: 8888 %d, f32 %d",
+                                opaque, i, c, lowp, highp);
+            }
+        }
+    }
+}
@@ -71,6 +71,21 @@ sk_sp<SkTextBlob> buildTextBlob(sk_sp<SkTypeface> tf, int glyphCount) {
     return builder.make();
 }
 
+sk_sp<SkTextBlob> buildTextBlob(sk_sp<SkTypeface> tf, const SkGlyphID glyphs[], int glyphCount) {
+    SkPaint font;
+    font.setTypeface(tf);
+    font.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    font.setTextSize(12u);
+
+    SkTextBlobBuilder builder;
+    const auto& runBuffer = builder.allocRunPosH(font, glyphCount, 16);
+    for (int i = 0; i < glyphCount; i++) {
+        runBuffer.glyphs[i] = glyphs[i];
+        runBuffer.pos[i] = SkIntToScalar(8 * i);
+    }
+    return builder.make();
+}
+
 SkBitmap RasterBlob(sk_sp<SkTextBlob> blob, int width, int height) {
     auto surface = SkSurface::MakeRasterN32Premul(width, height);
     SkPaint paint;
@@ -220,3 +235,154 @@ DEF_TEST(SkRemoteGlyphCache_StrikePinningClient, reporter) {
     SkGraphics::PurgeFontCache();
     REPORTER_ASSERT(reporter, clientTf->unique());
 }
+
+// Hands out chunks of at least fChunkSize, until fChunkLimit of them have been made.
+class ChunkAllocator : public SkStrikeServer::ChunkAllocator {
+public:
+    ChunkAllocator(size_t chunkSize, int chunkLimit)
+            : fChunkSize(chunkSize), fChunkLimit(chunkLimit) {}
+
+    void* allocateChunk(size_t minSize, size_t* size) override {
+        if (fAllocated == fChunkLimit) return nullptr;
+        fAllocated++;
+        *size = SkTMax(minSize, fChunkSize);
+        fPending = sk_malloc_throw(*size);
+        return fPending;
+    }
+    void finishChunk(void* chunk, size_t used) override {
+        SkASSERT(chunk == fPending);
+        fChunks.push_back(SkData::MakeFromMalloc(chunk, used));
+        fPending = nullptr;
+    }
+
+    std::vector<sk_sp<SkData>> fChunks;
+
+private:
+    const size_t fChunkSize;
+    const int    fChunkLimit;
+    int          fAllocated = 0;
+    void*        fPending = nullptr;
+};
+
+DEF_TEST(SkRemoteGlyphCache_StrikeSerializationChunked, reporter) {
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    SkStrikeServer server(discardableManager.get());
+    SkStrikeClient client(discardableManager);
+
+    // Server.
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    auto serverTfData = server.serializeTypeface(serverTf.get());
+
+    int glyphCount = 64;
+    auto serverBlob = buildTextBlob(serverTf, glyphCount);
+    const SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+    SkTextBlobCacheDiffCanvas cache_diff_canvas(10, 10, SkMatrix::I(), props, &server);
+    SkPaint paint;
+    cache_diff_canvas.drawTextBlob(serverBlob.get(), 0, 0, paint);
+
+    // Small chunks split the strike. Running out of them leaves the rest for the next write.
+    ChunkAllocator limited(512, 1);
+    REPORTER_ASSERT(reporter, !server.writeStrikeData(&limited));
+    REPORTER_ASSERT(reporter, limited.fChunks.size() == 1u);
+    ChunkAllocator allocator(512, 100);
+    REPORTER_ASSERT(reporter, server.writeStrikeData(&allocator));
+    REPORTER_ASSERT(reporter, allocator.fChunks.size() > 1u);
+
+    // Client.
+    auto clientTf = client.deserializeTypeface(serverTfData->data(), serverTfData->size());
+    std::vector<sk_sp<SkData>> chunks = limited.fChunks;
+    chunks.insert(chunks.end(), allocator.fChunks.begin(), allocator.fChunks.end());
+    for (const auto& chunk : chunks) {
+        REPORTER_ASSERT(reporter, client.readStrikeData(chunk));
+        // The strike holds on to the chunk, since its glyphs may point into it.
+        REPORTER_ASSERT(reporter, !chunk->unique());
+    }
+    auto clientBlob = buildTextBlob(clientTf, glyphCount);
+
+    SkBitmap expected = RasterBlob(serverBlob, 10, 10);
+    SkBitmap actual = RasterBlob(clientBlob, 10, 10);
+    for (int i = 0; i < expected.width(); ++i) {
+        for (int j = 0; j < expected.height(); ++j) {
+            REPORTER_ASSERT(reporter, expected.getColor(i, j) == actual.getColor(i, j));
+        }
+    }
+
+    // Purging the strike lets go of the chunks.
+    discardableManager->unlockAndDeleteAll();
+    SkGraphics::PurgeFontCache();
+    limited.fChunks.clear();
+    allocator.fChunks.clear();
+    for (const auto& chunk : chunks) {
+        REPORTER_ASSERT(reporter, chunk->unique());
+    }
+}
+
+DEF_TEST(SkRemoteGlyphCache_GlyphRequests, reporter) {
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    SkStrikeServer server(discardableManager.get());
+    SkStrikeClient client(discardableManager);
+
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    auto serverTfData = server.serializeTypeface(serverTf.get());
+    auto clientTf = client.deserializeTypeface(serverTfData->data(), serverTfData->size());
+
+    // Drawing glyphs the server hasn't sent draws nothing, and asks for them.
+    SkGlyphID glyphs[5];
+    serverTf->charsToGlyphs("Hello", SkTypeface::kUTF8_Encoding, glyphs, 5);
+    auto clientBlob = buildTextBlob(clientTf, glyphs, 5);
+    SkBitmap missed = RasterBlob(clientBlob, 40, 20);
+    std::vector<uint8_t> requests;
+    REPORTER_ASSERT(reporter, client.writeGlyphRequests(&requests));
+    REPORTER_ASSERT(reporter, server.readGlyphRequests(requests.data(), requests.size()));
+
+    std::vector<uint8_t> serverStrikeData;
+    server.writeStrikeData(&serverStrikeData);
+    REPORTER_ASSERT(reporter,
+                    client.readStrikeData(serverStrikeData.data(), serverStrikeData.size()));
+
+    auto serverBlob = buildTextBlob(serverTf, glyphs, 5);
+    SkBitmap expected = RasterBlob(serverBlob, 40, 20);
+    SkBitmap actual = RasterBlob(clientBlob, 40, 20);
+    bool drawn = false;
+    for (int i = 0; i < expected.width(); ++i) {
+        for (int j = 0; j < expected.height(); ++j) {
+            REPORTER_ASSERT(reporter, expected.getColor(i, j) == actual.getColor(i, j));
+            REPORTER_ASSERT(reporter, missed.getColor(i, j) == SK_ColorTRANSPARENT);
+            drawn |= expected.getColor(i, j) != SK_ColorTRANSPARENT;
+        }
+    }
+    REPORTER_ASSERT(reporter, drawn);
+    requests.clear();
+    REPORTER_ASSERT(reporter, !client.writeGlyphRequests(&requests));
+
+    // Truncated requests are rejected.
+    REPORTER_ASSERT(reporter, !server.readGlyphRequests(requests.data(), 0u));
+}
+
+DEF_TEST(SkRemoteGlyphCache_PrefetchASCII, reporter) {
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    SkStrikeServer server(discardableManager.get());
+    SkStrikeClient client(discardableManager);
+    server.setPrefetch(SkStrikeServer::Prefetch::kASCII);
+
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    auto serverTfData = server.serializeTypeface(serverTf.get());
+    SkGlyphID serverGlyph = 0;
+    auto serverBlob = buildTextBlob(serverTf, &serverGlyph, 1);
+    const SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+    SkTextBlobCacheDiffCanvas cache_diff_canvas(10, 10, SkMatrix::I(), props, &server);
+    cache_diff_canvas.drawTextBlob(serverBlob.get(), 0, 0, SkPaint());
+
+    std::vector<uint8_t> serverStrikeData;
+    server.writeStrikeData(&serverStrikeData);
+
+    // Text the server didn't draw is there already.
+    auto clientTf = client.deserializeTypeface(serverTfData->data(), serverTfData->size());
+    REPORTER_ASSERT(reporter,
+                    client.readStrikeData(serverStrikeData.data(), serverStrikeData.size()));
+    SkGlyphID glyphs[5];
+    serverTf->charsToGlyphs("Hello", SkTypeface::kUTF8_Encoding, glyphs, 5);
+    RasterBlob(buildTextBlob(clientTf, glyphs, 5), 40, 20);
+    std::vector<uint8_t> requests;
+    REPORTER_ASSERT(reporter, !client.writeGlyphRequests(&requests));
+}
@@ -6,6 +6,7 @@
  */
 
 #include "SkSLCompiler.h"
+#include "SkTaskGroup.h"
 
 #include "Test.h"
 
@@ -104,14 +105,11 @@ DEF_TEST(SkSLFunctions, r) {
          *SkSL::ShaderCapsFactory::Default(),
          "#version 400\n"
          "out vec4 sk_FragColor;\n"
-         "float foo(float v[2]) {\n"
-         "    return v[0] * v[1];\n"
-         "}\n"
          "void bar(inout float x) {\n"
          "    float y[2], z;\n"
          "    y[0] = x;\n"
          "    y[1] = x * 2.0;\n"
-         "    z = foo(y);\n"
+         "    z = y[0] * y[1];\n"
          "    x = z;\n"
          "}\n"
          "void main() {\n"
@@ -284,21 +282,21 @@ DEF_TEST(SkSLStructs, r) {
 
 DEF_TEST(SkSLVersion, r) {
     test(r,
-         "in float test; void main() { sk_FragColor = float4(0.75); }",
+         "in float test; void main() { sk_FragColor = float4(test); }",
          *SkSL::ShaderCapsFactory::Version450Core(),
          "#version 450 core\n"
          "out vec4 sk_FragColor;\n"
          "in float test;\n"
          "void main() {\n"
-         "    sk_FragColor = vec4(0.75);\n"
+         "    sk_FragColor = vec4(test);\n"
          "}\n");
     test(r,
-         "in float test; void main() { sk_FragColor = float4(0.75); }",
+         "in float test; void main() { sk_FragColor = float4(test); }",
          *SkSL::ShaderCapsFactory::Version110(),
          "#version 110\n"
          "varying float test;\n"
          "void main() {\n"
-         "    gl_FragColor = vec4(0.75);\n"
+         "    gl_FragColor = vec4(test);\n"
          "}\n");
 }
 
@@ -1957,4 +1955,87 @@ DEF_TEST(SkSLFrExp, r) {
          "}\n");
 }
 
+DEF_TEST(SkSLSharedBuiltins, r) {
+    // The types a program declares don't outlive it, so programs may reuse them.
+    static const char* kSrc =
+         "struct S { float x; };"
+         "void main() {"
+         "    S s;"
+         "    s.x = sqrt(sk_FragCoord.x);"
+         "    sk_FragColor = half4(s.x);"
+         "}";
+    SkSL::Compiler compiler;
+    SkSL::Program::Settings settings;
+    sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+    settings.fCaps = caps.get();
+    SkSL::String expected;
+    for (int i = 0; i < 2; ++i) {
+        std::unique_ptr<SkSL::Program> program =
+                compiler.convertProgram(SkSL::Program::kFragment_Kind, SkSL::String(kSrc),
+                                        settings);
+        REPORTER_ASSERT(r, program, "%s", compiler.errorText().c_str());
+        if (!program) {
+            return;
+        }
+        SkSL::String output;
+        REPORTER_ASSERT(r, compiler.toGLSL(*program, &output));
+        REPORTER_ASSERT(r, !i || output == expected);
+        expected = output;
+    }
+
+    // Compilers share the built-in modules, and may compile on several threads at once.
+    static constexpr int kThreads = 8;
+    SkSL::String outputs[kThreads];
+    SkTaskGroup().batch(kThreads, [&](int i) {
+        SkSL::Compiler threadCompiler;
+        std::unique_ptr<SkSL::Program> program =
+                threadCompiler.convertProgram(SkSL::Program::kFragment_Kind, SkSL::String(kSrc),
+                                              settings);
+        if (program) {
+            threadCompiler.toGLSL(*program, &outputs[i]);
+        }
+    });
+    for (const SkSL::String& output : outputs) {
+        REPORTER_ASSERT(r, output == expected);
+    }
+}
+
+DEF_TEST(SkSLInline, r) {
+    test(r,
+         "uniform float u;"
+         "float sq(float x) { return x * x; }"
+         "float scale(float x, float k) { return x * k; }"
+         "float twice(float x) { return x + x; }"
+         "void main() {"
+         "float v = sq(u);"
+         "sk_FragColor = float4(scale(v, 2), sq(3), twice(v++), 1);"
+         "}",
+         *SkSL::ShaderCapsFactory::Default(),
+         "#version 400\n"
+         "out vec4 sk_FragColor;\n"
+         "uniform float u;\n"
+         "float twice(float x) {\n"
+         "    return x + x;\n"
+         "}\n"
+         "void main() {\n"
+         "    float v = u * u;\n"
+         "    sk_FragColor = vec4(v * 2.0, 9.0, twice(v++), 1.0);\n"
+         "}\n");
+}
+
+DEF_TEST(SkSLUnusedInterfaceVariables, r) {
+    test(r,
+         "uniform float unused; uniform sampler2D tex; uniform float used, unusedToo;"
+         "in float unreadVarying;"
+         "void main() { sk_FragColor = float4(used); }",
+         *SkSL::ShaderCapsFactory::Default(),
+         "#version 400\n"
+         "out vec4 sk_FragColor;\n"
+         "uniform float used;\n"
+         "void main() {\n"
+         "    sk_FragColor = vec4(used);\n"
+         "}\n");
+}
+
 #endif
+
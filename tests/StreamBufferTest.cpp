@@ -8,6 +8,7 @@
 #include "SkData.h"
 #include "SkMakeUnique.h"
 #include "SkOSPath.h"
+#include "SkRWBuffer.h"
 #include "SkStream.h"
 #include "SkStreamBuffer.h"
 
@@ -97,6 +98,9 @@ DEF_TEST(StreamBuffer, r) {
     } factories[] = {
         { [&data]() { return skstd::make_unique<SkMemoryStream>(data); },       false  },
         { [&data]() { return skstd::make_unique<NotAssetMemStream>(data); },    false  },
+        { [&data]() { SkRWBuffer rw;
+                      rw.append(data->data(), data->size());
+                      return rw.makeStreamSnapshot(); },                        false  },
         { [&path]() { return path.isEmpty()
                              ? nullptr
                              : skstd::make_unique<SkFILEStream>(path.c_str()); }, true },
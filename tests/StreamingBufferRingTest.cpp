@@ -0,0 +1,78 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test.
+
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrContextPriv.h"
+#include "GrDrawingManager.h"
+#include "GrStreamingBufferRing.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+
+static constexpr int kNumFrames = 4;
+
+// Draws a few frames of anti-aliased circles, which write their vertices through the flush's
+// vertex and index pools, and reads back the last one. Reading back each frame makes the GPU
+// finish it, so its buffers can be reused by the next frame.
+static void draw_frames(GrContext* context, SkBitmap* result) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(128, 128);
+    auto surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info);
+    if (!surface) {
+        return;
+    }
+    result->allocPixels(info);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int frame = 0; frame < kNumFrames; ++frame) {
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->clear(SK_ColorWHITE);
+        for (int i = 0; i < 16; ++i) {
+            paint.setColor(SkColorSetARGB(0xFF, 16 * i, 255 - 16 * i, 64 * frame));
+            canvas->drawCircle(16.5f + 32 * (i % 4), 16.5f + 32 * (i / 4), 5.f + i, paint);
+        }
+        surface->readPixels(*result, 0, 0);
+    }
+}
+
+DEF_GPUTEST(StreamingBufferRingReusesBuffers, reporter, options) {
+    SkBitmap results[2];
+    for (int useRing = 0; useRing < 2; ++useRing) {
+        GrContextOptions contextOptions = options;
+        contextOptions.fUseStreamingBufferRing = SkToBool(useRing);
+        sk_gpu_test::GrContextFactory factory(contextOptions);
+        GrContext* context = factory.get(sk_gpu_test::GrContextFactory::kGL_ContextType);
+        if (!context) {
+            return;
+        }
+        draw_frames(context, &results[useRing]);
+        GrStreamingBufferRing* ring =
+                context->contextPriv().drawingManager()->getStreamingBufferRing();
+        if (!useRing || !context->caps()->useStreamingBufferRing()) {
+            REPORTER_ASSERT(reporter, !ring);
+            continue;
+        }
+        REPORTER_ASSERT(reporter, ring);
+        REPORTER_ASSERT(reporter, ring->numReused() >= kNumFrames - 1);
+        REPORTER_ASSERT(reporter, ring->numFlushesInFlight() <=
+                                  GrStreamingBufferRing::kMaxFlushesInFlight);
+        context->freeGpuResources();
+        REPORTER_ASSERT(reporter, !ring->numFreeBuffers() && !ring->numFlushesInFlight());
+    }
+    if (!results[0].getPixels() || !results[1].getPixels()) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, 0 == memcmp(results[0].getPixels(), results[1].getPixels(),
+                                          results[0].computeByteSize()));
+}
+
+#endif
@@ -0,0 +1,339 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkExecutor.h"
+#include "SkGlyphCache.h"
+#include "SkGlyphStore.h"
+#include "SkOSPath.h"
+#include "SkPaint.h"
+#include "SkPaintPriv.h"
+#include "SkSharedStrike.h"
+#include "SkStrikeCache.h"
+#include "SkPath.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+#include "sk_tool_utils.h"
+
+#include <vector>
+
+// Creates (or finds) the strike for paint at the given text size in cache.
+static SkExclusiveStrikePtr find_or_create(SkStrikeCache* cache, SkScalar textSize) {
+    SkPaint paint;
+    paint.setTextSize(textSize);
+
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            paint, nullptr, kFakeGammaAndBoostContrast, nullptr, &ad, &effects);
+
+    auto strike = cache->findStrikeExclusive(*desc);
+    if (strike == nullptr) {
+        auto tf = SkPaintPriv::GetTypefaceOrDefault(paint);
+        auto scaler = SkStrikeCache::CreateScalerContext(*desc, effects, *tf);
+        strike = cache->createStrikeExclusive(*desc, std::move(scaler));
+    }
+    return strike;
+}
+
+static sk_sp<SkSharedStrike> find_or_create_shared(SkStrikeCache* cache, SkScalar textSize) {
+    SkPaint paint;
+    paint.setTextSize(textSize);
+
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            paint, nullptr, kFakeGammaAndBoostContrast, nullptr, &ad, &effects);
+
+    auto tf = SkPaintPriv::GetTypefaceOrDefault(paint);
+    return cache->findOrCreateStrikeShared(*desc, effects, *tf);
+}
+
+DEF_TEST(StrikeCache_Sharded, reporter) {
+    for (int shards : {1, 3, 8}) {
+        SkStrikeCache cache{shards};
+        REPORTER_ASSERT(reporter, cache.shardCount() == shards);
+
+        // A strike should come back when it's returned to the cache.
+        SkGlyphCache* first;
+        {
+            auto strike = find_or_create(&cache, 12);
+            first = strike.get();
+        }
+        REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 1);
+        {
+            auto strike = find_or_create(&cache, 12);
+            REPORTER_ASSERT(reporter, strike.get() == first);
+            REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 0);
+        }
+
+        // The global count limit must hold however the strikes land in the shards.
+        constexpr int kLimit = 10;
+        cache.setCacheCountLimit(kLimit);
+        REPORTER_ASSERT(reporter, cache.getCacheCountLimit() == kLimit);
+        for (int i = 0; i < 50; ++i) {
+            find_or_create(&cache, 10 + i);
+            REPORTER_ASSERT(reporter, cache.getCacheCountUsed() <= kLimit);
+        }
+
+        cache.setCacheCountLimit(0);
+        REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 0);
+        cache.setCacheCountLimit(SK_DEFAULT_FONT_CACHE_COUNT_LIMIT);
+
+        for (int i = 0; i < 20; ++i) {
+            find_or_create(&cache, 10 + i);
+        }
+        REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 20);
+        cache.purgeAll();
+        REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 0);
+        REPORTER_ASSERT(reporter, cache.getTotalMemoryUsed() == 0);
+    }
+}
+
+DEF_TEST(StrikeCache_Threads, reporter) {
+    SkStrikeCache cache{4};
+
+    constexpr int kSizes = 16;
+    SkTaskGroup().batch(64, [&](int i) {
+        for (int j = 0; j < 100; ++j) {
+            auto strike = find_or_create(&cache, 10 + (i + j) % kSizes);
+            strike->getGlyphIDMetrics(j % 64);
+        }
+    });
+
+    // Racing threads may each create a strike for the same descriptor, but every size is cached.
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() >= kSizes);
+    cache.validate();
+}
+
+DEF_TEST(StrikeCache_Shared, reporter) {
+    SkStrikeCache cache{2};
+
+    auto shared = find_or_create_shared(&cache, 24);
+    REPORTER_ASSERT(reporter, find_or_create_shared(&cache, 24) == shared);
+    REPORTER_ASSERT(reporter, find_or_create_shared(&cache, 25) != shared);
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 2);
+
+    // A shared strike should produce exactly what an exclusive one does.
+    auto exclusive = find_or_create(&cache, 24);
+    for (SkUnichar c = 'A'; c <= 'z'; ++c) {
+        SkGlyphID id = exclusive->unicharToGlyph(c);
+        REPORTER_ASSERT(reporter, shared->unicharToGlyph(c) == id);
+
+        const SkGlyph& e = exclusive->getGlyphIDMetrics(id);
+        const SkGlyph& s = shared->getGlyphIDMetrics(id);
+        REPORTER_ASSERT(reporter, &s == &shared->getGlyphIDMetrics(id));
+        REPORTER_ASSERT(reporter, e.fWidth == s.fWidth && e.fHeight == s.fHeight);
+        REPORTER_ASSERT(reporter, e.fAdvanceX == s.fAdvanceX && e.fAdvanceY == s.fAdvanceY);
+
+        const void* eImage = exclusive->findImage(e);
+        const void* sImage = shared->findImage(s);
+        REPORTER_ASSERT(reporter, (eImage == nullptr) == (sImage == nullptr));
+        if (eImage && sImage) {
+            REPORTER_ASSERT(reporter, 0 == memcmp(eImage, sImage, e.computeImageSize()));
+        }
+        REPORTER_ASSERT(reporter, shared->findImage(s) == sImage);
+
+        const SkPath* ePath = exclusive->findPath(e);
+        const SkPath* sPath = shared->findPath(s);
+        REPORTER_ASSERT(reporter, (ePath == nullptr) == (sPath == nullptr));
+        if (ePath && sPath) {
+            REPORTER_ASSERT(reporter, *ePath == *sPath);
+        }
+    }
+    REPORTER_ASSERT(reporter, shared->countCachedGlyphs() == exclusive->countCachedGlyphs());
+
+    // Shared strikes count against the budget like any other, even while they're in use.
+    const SkGlyph* glyph = &shared->getUnicharMetrics('S');
+    const void* image = shared->findImage(*glyph);
+    cache.setCacheCountLimit(0);
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 0);
+    REPORTER_ASSERT(reporter, find_or_create_shared(&cache, 24) != shared);
+
+    // ... but they're not gone until we're done with them.
+    REPORTER_ASSERT(reporter, &shared->getUnicharMetrics('S') == glyph);
+    REPORTER_ASSERT(reporter, shared->findImage(*glyph) == image);
+}
+
+DEF_TEST(StrikeCache_SharedThreads, reporter) {
+    SkStrikeCache cache{4};
+
+    // Every thread should end up using the one strike, and see the same glyphs.
+    constexpr int kThreads = 16;
+    sk_sp<SkSharedStrike> strikes[kThreads];
+    const SkGlyph* glyphs[kThreads][128];
+    const void* images[kThreads][128];
+    SkTaskGroup().batch(kThreads, [&](int i) {
+        strikes[i] = find_or_create_shared(&cache, 18);
+        for (int j = 0; j < 128; ++j) {
+            SkGlyphID id = (SkGlyphID)((i * 7 + j) % 128);
+            glyphs[i][id] = &strikes[i]->getGlyphIDMetrics(id);
+            images[i][id] = strikes[i]->findImage(*glyphs[i][id]);
+        }
+    });
+
+    for (int i = 1; i < kThreads; ++i) {
+        REPORTER_ASSERT(reporter, strikes[i] == strikes[0]);
+        for (int j = 0; j < 128; ++j) {
+            REPORTER_ASSERT(reporter, glyphs[i][j] == glyphs[0][j]);
+            REPORTER_ASSERT(reporter, images[i][j] == images[0][j]);
+        }
+    }
+    REPORTER_ASSERT(reporter, strikes[0]->countCachedGlyphs() == 128);
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 1);
+}
+
+DEF_TEST(GlyphCache_PrepareGlyphs, reporter) {
+    // Two caches so that we get two strikes for the same descriptor.
+    SkStrikeCache batchCache, singleCache;
+    auto batch  = find_or_create(&batchCache, 20),
+         single = find_or_create(&singleCache, 20);
+
+    SkPackedGlyphID ids[64];
+    for (int i = 0; i < 64; ++i) {
+        // Include some duplicates and some glyphs we've already seen the advance of.
+        ids[i] = SkPackedGlyphID((SkGlyphID)(i % 48));
+    }
+    batch->getGlyphIDAdvance(ids[3].code());
+
+    batch->prepareGlyphs(ids, 64, false);
+    REPORTER_ASSERT(reporter, batch->countCachedGlyphs() == 48);
+    batch->prepareGlyphs(ids, 64, true);
+    REPORTER_ASSERT(reporter, batch->countCachedGlyphs() == 48);
+
+    for (int i = 0; i < 64; ++i) {
+        SkGlyph* b = batch->getRawGlyphByID(ids[i]);
+        const SkGlyph& s = single->getGlyphIDMetrics(ids[i].code());
+        REPORTER_ASSERT(reporter, !b->isJustAdvance());
+        REPORTER_ASSERT(reporter, b->fWidth == s.fWidth && b->fHeight == s.fHeight);
+        REPORTER_ASSERT(reporter, b->fAdvanceX == s.fAdvanceX);
+
+        const void* image = single->findImage(s);
+        REPORTER_ASSERT(reporter, (b->fImage == nullptr) == (image == nullptr));
+        if (b->fImage && image) {
+            REPORTER_ASSERT(reporter, 0 == memcmp(b->fImage, image, s.computeImageSize()));
+        }
+        // findImage() should find the image prepareGlyphs() made.
+        REPORTER_ASSERT(reporter, batch->findImage(*b) == b->fImage);
+    }
+    REPORTER_ASSERT(reporter, batch->getMemoryUsed() == single->getMemoryUsed());
+}
+
+DEF_TEST(GlyphCache_PrepareGlyphsInParallel, reporter) {
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    SkPaint paint;
+    paint.setTypeface(sk_tool_utils::create_portable_typeface("serif", SkFontStyle()));
+    paint.setTextSize(24);
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            paint, nullptr, kFakeGammaAndBoostContrast, nullptr, &ad, &effects);
+
+    SkStrikeCache parallelCache, serialCache;
+    auto parallel = parallelCache.createStrikeExclusive(
+            *desc, SkStrikeCache::CreateScalerContext(*desc, effects, *paint.getTypeface()));
+    auto serial = serialCache.createStrikeExclusive(
+            *desc, SkStrikeCache::CreateScalerContext(*desc, effects, *paint.getTypeface()));
+
+    constexpr int kCount = 300;
+    std::vector<SkPackedGlyphID> ids;
+    for (int i = 0; i < kCount; ++i) {
+        ids.push_back(SkPackedGlyphID(parallel->unicharToGlyph(' ' + i % 95)));
+    }
+    parallel->prepareGlyphs(ids.data(), kCount, true, executor.get());
+    serial->prepareGlyphs(ids.data(), kCount, true);
+
+    int images = 0;
+    for (SkPackedGlyphID id : ids) {
+        SkGlyph* p = parallel->getRawGlyphByID(id);
+        SkGlyph* s = serial->getRawGlyphByID(id);
+        REPORTER_ASSERT(reporter, p->fWidth == s->fWidth && p->fHeight == s->fHeight);
+        REPORTER_ASSERT(reporter, (p->fImage == nullptr) == (s->fImage == nullptr));
+        if (p->fImage && s->fImage) {
+            images++;
+            REPORTER_ASSERT(reporter, 0 == memcmp(p->fImage, s->fImage, s->computeImageSize()));
+        }
+    }
+    REPORTER_ASSERT(reporter, images > 0);
+    REPORTER_ASSERT(reporter, parallel->getMemoryUsed() == serial->getMemoryUsed());
+}
+
+DEF_TEST(GlyphStore_RoundTrip, reporter) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Em.ttf");
+    if (!typeface) {
+        // Not all SkFontMgr can MakeFromStream().
+        return;
+    }
+    SkString path = SkOSPath::Join(skiatest::GetTmpDir().c_str(), "GlyphStore_RoundTrip.skgs");
+
+    SkPaint paint;
+    paint.setTypeface(typeface);
+    paint.setTextSize(30);
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            paint, nullptr, kFakeGammaAndBoostContrast, nullptr, &ad, &effects);
+
+    constexpr int kCount = 16;
+    SkGlyphCache original{*desc, SkStrikeCache::CreateScalerContext(*desc, effects, *typeface),
+                          SkPaint::FontMetrics{}};
+    for (int i = 0; i < kCount; ++i) {
+        const SkGlyph& glyph = original.getGlyphIDMetrics(i);
+        original.findImage(glyph);
+        original.findPath(glyph);
+    }
+    {
+        SkGlyphStore store{path.c_str()};
+        REPORTER_ASSERT(reporter, !store.findStrike(*desc, *typeface));
+        store.add(original);
+        REPORTER_ASSERT(reporter, store.write());
+    }
+
+    SkGlyphStore store{path.c_str()};
+    SkGlyphStore::Strike strike = store.findStrike(*desc, *typeface);
+    REPORTER_ASSERT(reporter, strike);
+
+    // Other sizes weren't stored.
+    paint.setTextSize(31);
+    SkAutoDescriptor otherAD;
+    REPORTER_ASSERT(reporter, !store.findStrike(
+            *SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+                    paint, nullptr, kFakeGammaAndBoostContrast, nullptr, &otherAD, &effects),
+            *typeface));
+
+    SkGlyphCache restored{*desc, SkStrikeCache::CreateScalerContext(*desc, effects, *typeface),
+                          SkPaint::FontMetrics{}};
+    restored.setStoredStrike(strike);
+    for (int i = 0; i < kCount; ++i) {
+        const SkGlyph& o = original.getGlyphIDMetrics(i);
+        const SkGlyph& r = restored.getGlyphIDMetrics(i);
+        REPORTER_ASSERT(reporter, o.fWidth == r.fWidth && o.fHeight == r.fHeight);
+        REPORTER_ASSERT(reporter, o.fTop == r.fTop && o.fLeft == r.fLeft);
+        REPORTER_ASSERT(reporter, o.fAdvanceX == r.fAdvanceX && o.fAdvanceY == r.fAdvanceY);
+        REPORTER_ASSERT(reporter, o.fMaskFormat == r.fMaskFormat);
+
+        const void* image = restored.findImage(r);
+        REPORTER_ASSERT(reporter, (o.fImage == nullptr) == (image == nullptr));
+        if (o.fImage && image) {
+            REPORTER_ASSERT(reporter, 0 == memcmp(o.fImage, image, o.computeImageSize()));
+        }
+
+        const SkPath* oPath = original.findPath(o);
+        const SkPath* rPath = restored.findPath(r);
+        REPORTER_ASSERT(reporter, (oPath == nullptr) == (rPath == nullptr));
+        if (oPath && rPath) {
+            REPORTER_ASSERT(reporter, *oPath == *rPath);
+        }
+
+        // The stored strike should agree with what we just read back.
+        SkGlyph glyph;
+        glyph.initWithGlyphID(SkPackedGlyphID((SkGlyphID)i));
+        REPORTER_ASSERT(reporter, strike.findMetrics(&glyph));
+        REPORTER_ASSERT(reporter, glyph.fWidth == o.fWidth && glyph.fHeight == o.fHeight);
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDashPathEffect.h"
+#include "SkPaint.h"
+#include "SkResourceCache.h"
+#include "SkStyledPathCache.h"
+#include "Test.h"
+
+static SkPath make_zigzag() {
+    SkPath path;
+    path.moveTo(0, 0);
+    for (int i = 1; i <= 20; i++) {
+        path.lineTo(10.0f * i, (i & 1) ? 10.0f : 0.0f);
+    }
+    return path;
+}
+
+DEF_TEST(StyledPathCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPath src = make_zigzag();
+    REPORTER_ASSERT(reporter, SkStyledPathCache::CanCache(src));
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    SkScalar intervals[] = { 5, 3 };
+    paint.setPathEffect(SkDashPathEffect::Make(intervals, 2, 0));
+    SkStrokeRec rec(paint);
+
+    SkPath styled;
+    paint.getFillPath(src, &styled);
+
+    SkPath dst;
+    SkStrokeRec dstRec(SkStrokeRec::kHairline_InitStyle);
+    auto step = SkStyledPathCache::Step::kFillPath;
+    REPORTER_ASSERT(reporter, !SkStyledPathCache::Find(step, src, rec, paint.getPathEffect(),
+                                                       nullptr, &dst, &dstRec, &cache));
+
+    SkStyledPathCache::Add(step, src, rec, paint.getPathEffect(), nullptr, styled,
+                           SkStrokeRec(SkStrokeRec::kFill_InitStyle), &cache);
+    REPORTER_ASSERT(reporter, SkStyledPathCache::Find(step, src, rec, paint.getPathEffect(),
+                                                      nullptr, &dst, &dstRec, &cache));
+    REPORTER_ASSERT(reporter, dst == styled);
+    REPORTER_ASSERT(reporter, dst.getGenerationID() == styled.getGenerationID());
+    REPORTER_ASSERT(reporter, SkStrokeRec::kFill_Style == dstRec.getStyle());
+
+    // Any change to the style misses.
+    SkStrokeRec wider = rec;
+    wider.setStrokeStyle(4);
+    REPORTER_ASSERT(reporter, !SkStyledPathCache::Find(step, src, wider, paint.getPathEffect(),
+                                                       nullptr, &dst, &dstRec, &cache));
+    SkStrokeRec finer = rec;
+    finer.setResScale(2);
+    REPORTER_ASSERT(reporter, !SkStyledPathCache::Find(step, src, finer, paint.getPathEffect(),
+                                                       nullptr, &dst, &dstRec, &cache));
+    sk_sp<SkPathEffect> otherDash = SkDashPathEffect::Make(intervals, 2, 0);
+    REPORTER_ASSERT(reporter, !SkStyledPathCache::Find(step, src, rec, otherDash.get(),
+                                                       nullptr, &dst, &dstRec, &cache));
+    SkRect cull = SkRect::MakeWH(50, 50);
+    REPORTER_ASSERT(reporter, !SkStyledPathCache::Find(step, src, rec, paint.getPathEffect(),
+                                                       &cull, &dst, &dstRec, &cache));
+    REPORTER_ASSERT(reporter, !SkStyledPathCache::Find(SkStyledPathCache::Step::kGrStyle, src,
+                                                       rec, paint.getPathEffect(), nullptr,
+                                                       &dst, &dstRec, &cache));
+
+    // Editing the source path purges what was styled from it.
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() > 0);
+    src.lineTo(0, 100);
+    REPORTER_ASSERT(reporter, !SkStyledPathCache::Find(step, src, rec, paint.getPathEffect(),
+                                                       nullptr, &dst, &dstRec, &cache));
+    REPORTER_ASSERT(reporter, 0 == cache.getTotalBytesUsed());
+}
+
+DEF_TEST(StyledPathCache_InverseFill, reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    SkStrokeRec rec(paint);
+
+    // The inverse copy shares its SkPathRef, and so its gen ID, with the source.
+    SkPath src = make_zigzag();
+    SkPath inverse = src;
+    inverse.setFillType(SkPath::kInverseWinding_FillType);
+
+    SkPath styled;
+    paint.getFillPath(src, &styled);
+    REPORTER_ASSERT(reporter, !styled.isInverseFillType());
+
+    auto step = SkStyledPathCache::Step::kFillPath;
+    SkStyledPathCache::Add(step, src, rec, nullptr, nullptr, styled,
+                           SkStrokeRec(SkStrokeRec::kFill_InitStyle), &cache);
+
+    SkPath dst;
+    SkStrokeRec dstRec(SkStrokeRec::kHairline_InitStyle);
+    REPORTER_ASSERT(reporter, SkStyledPathCache::Find(step, src, rec, nullptr, nullptr,
+                                                      &dst, &dstRec, &cache));
+    REPORTER_ASSERT(reporter, !SkStyledPathCache::Find(step, inverse, rec, nullptr, nullptr,
+                                                       &dst, &dstRec, &cache));
+
+    // Through the global cache, each gets a stroke with its own fill type.
+    SkPath first, second;
+    paint.getFillPath(src, &first);
+    paint.getFillPath(inverse, &second);
+    REPORTER_ASSERT(reporter, !first.isInverseFillType());
+    REPORTER_ASSERT(reporter, second.isInverseFillType());
+    paint.getFillPath(inverse, &first);
+    paint.getFillPath(src, &second);
+    REPORTER_ASSERT(reporter, first.isInverseFillType());
+    REPORTER_ASSERT(reporter, !second.isInverseFillType());
+}
+
+DEF_TEST(StyledPathCache_FillPath, reporter) {
+    SkPath src = make_zigzag();
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(2);
+    paint.setStrokeJoin(SkPaint::kRound_Join);
+
+    // Drawing again gives back the same styled path, from the global cache.
+    SkPath first, second;
+    REPORTER_ASSERT(reporter, paint.getFillPath(src, &first));
+    REPORTER_ASSERT(reporter, paint.getFillPath(src, &second));
+    REPORTER_ASSERT(reporter, first == second);
+
+    // Hairlines are still reported as such.
+    paint.setStrokeWidth(0);
+    SkScalar intervals[] = { 4, 4 };
+    paint.setPathEffect(SkDashPathEffect::Make(intervals, 2, 0));
+    REPORTER_ASSERT(reporter, !paint.getFillPath(src, &first));
+    REPORTER_ASSERT(reporter, !paint.getFillPath(src, &second));
+    REPORTER_ASSERT(reporter, first == second);
+}
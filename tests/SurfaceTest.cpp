@@ -6,12 +6,14 @@
  */
 
 #include <functional>
+#include "SkBBHFactory.h"
 #include "SkCanvas.h"
 #include "SkData.h"
 #include "SkDevice.h"
 #include "SkImage_Base.h"
 #include "SkOverdrawCanvas.h"
 #include "SkPath.h"
+#include "SkPictureRecorder.h"
 #include "SkRegion.h"
 #include "SkRRect.h"
 #include "SkSurface.h"
@@ -476,6 +478,49 @@ static void test_writable_after_snapshot_release(skiatest::Reporter* reporter,
 DEF_TEST(SurfaceWriteableAfterSnapshotRelease, reporter) {
     test_writable_after_snapshot_release(reporter, create_surface().get());
 }
+
+// Big raster surfaces that ask for copy-on-write pixels share pages with their snapshots,
+// copying only those drawn after.
+DEF_TEST(SurfaceCopyOnWrite_Large, reporter) {
+    const SkSurfaceProps props(SkSurfaceProps::kCopyOnWritePixels_Flag,
+                               SkSurfaceProps::kLegacyFontHost_InitType);
+    auto surface(SkSurface::MakeRasterN32Premul(2048, 2048, &props));
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorRED);
+
+    // Each snapshot sees the strips drawn before it, then one draw covers the whole surface.
+    const SkColor colors[] = { SK_ColorGREEN, SK_ColorBLUE, SK_ColorWHITE, SK_ColorBLACK };
+    const int kStrips = SK_ARRAY_COUNT(colors);
+    sk_sp<SkImage> images[kStrips + 1];
+    for (int i = 0; i < kStrips; i++) {
+        images[i] = surface->makeImageSnapshot();
+        SkPaint paint;
+        paint.setColor(colors[i]);
+        canvas->drawRect(SkRect::MakeXYWH(0, 100 * i + 1, 2048, 50), paint);
+    }
+    images[kStrips] = surface->makeImageSnapshot();
+    canvas->clear(SK_ColorCYAN);
+    // Copy after most pages have been redrawn.
+    sk_sp<SkImage> cyan = surface->makeImageSnapshot();
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+
+    for (int i = 0; i <= kStrips; i++) {
+        SkPixmap pm;
+        REPORTER_ASSERT(reporter, images[i]->peekPixels(&pm));
+        for (int strip = 0; strip < kStrips; strip++) {
+            SkColor expected = strip < i ? colors[strip] : SK_ColorRED;
+            REPORTER_ASSERT(reporter, pm.getColor(2047, 100 * strip + 25) == expected);
+            REPORTER_ASSERT(reporter, pm.getColor(0, 100 * strip + 75) == SK_ColorRED);
+        }
+    }
+    SkPixmap pm;
+    REPORTER_ASSERT(reporter, cyan->peekPixels(&pm));
+    REPORTER_ASSERT(reporter, pm.getColor(5, 5) == SK_ColorCYAN);
+    REPORTER_ASSERT(reporter, pm.getColor(2047, 2047) == SK_ColorCYAN);
+    REPORTER_ASSERT(reporter, surface->peekPixels(&pm));
+    REPORTER_ASSERT(reporter, pm.getColor(5, 5) == SK_ColorBLACK);
+    REPORTER_ASSERT(reporter, pm.getColor(2047, 2047) == SK_ColorCYAN);
+}
 #if SK_SUPPORT_GPU
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SurfaceWriteableAfterSnapshotRelease_Gpu, reporter, ctxInfo) {
     for (auto& surface_func : { &create_gpu_surface, &create_gpu_scratch_surface }) {
@@ -1119,3 +1164,111 @@ DEF_TEST(surface_image_unity, reporter) {
         }
     }
 }
+
+DEF_TEST(Surface_Damage, reporter) {
+    auto surface = SkSurface::MakeRasterN32Premul(100, 100);
+    SkCanvas* canvas = surface->getCanvas();
+    const SkIRect all = SkIRect::MakeWH(100, 100);
+    SkPaint paint;
+
+    // Without tracking, all of the surface is damaged.
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), paint);
+    REPORTER_ASSERT(reporter, surface->takeDamage() == all);
+
+    surface->setTrackDamage(true);
+    REPORTER_ASSERT(reporter, surface->takeDamage().isEmpty());
+
+    // Draws damage their bounds, outset a pixel for anti-aliasing.
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), paint);
+    REPORTER_ASSERT(reporter, surface->takeDamage() == SkIRect::MakeLTRB(9, 9, 31, 31));
+    REPORTER_ASSERT(reporter, surface->takeDamage().isEmpty());
+
+    // ... within the clip, and in device space.
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(0, 0, 50, 50));
+    canvas->translate(40, 40);
+    canvas->drawRect(SkRect::MakeWH(20, 20), paint);
+    REPORTER_ASSERT(reporter, surface->takeDamage() == SkIRect::MakeLTRB(39, 39, 50, 50));
+
+    // Inverse fills and paints damage all of the clip.
+    SkPath path;
+    path.addRect(SkRect::MakeWH(5, 5));
+    path.setFillType(SkPath::kInverseWinding_FillType);
+    canvas->drawPath(path, paint);
+    REPORTER_ASSERT(reporter, surface->takeDamage() == SkIRect::MakeWH(50, 50));
+    canvas->restore();
+    canvas->drawPaint(paint);
+    REPORTER_ASSERT(reporter, surface->takeDamage() == all);
+
+    // Stroked points damage their stroke, whatever the paint's style.
+    SkPaint fat;
+    fat.setStrokeWidth(10);
+    const SkPoint pt = { 50, 50 };
+    canvas->drawPoints(SkCanvas::kPoints_PointMode, 1, &pt, fat);
+    REPORTER_ASSERT(reporter, surface->takeDamage().contains(SkIRect::MakeLTRB(45, 45, 55, 55)));
+
+    // Draws to a layer damage the surface as the layer is restored.
+    canvas->saveLayer(SkRect::MakeLTRB(20, 20, 60, 60), nullptr);
+    canvas->drawRect(SkRect::MakeXYWH(30, 30, 5, 5), paint);
+    REPORTER_ASSERT(reporter, surface->takeDamage().isEmpty());
+    canvas->restore();
+    REPORTER_ASSERT(reporter, surface->takeDamage() == SkIRect::MakeLTRB(20, 20, 60, 60));
+
+    // Pixels written are damaged.
+    SkBitmap bm;
+    bm.allocN32Pixels(10, 10);
+    bm.eraseColor(SK_ColorRED);
+    surface->writePixels(bm, 95, 5);
+    REPORTER_ASSERT(reporter, surface->takeDamage() == SkIRect::MakeLTRB(95, 5, 100, 15));
+    canvas->writePixels(bm, 0, 90);
+    REPORTER_ASSERT(reporter, surface->takeDamage() == SkIRect::MakeLTRB(0, 90, 10, 100));
+
+    // Many draws are covered by a few rects.
+    for (int i = 0; i < 20; i++) {
+        canvas->drawRect(SkRect::MakeXYWH(i * 5, (i % 4) * 25, 2, 2), paint);
+    }
+    std::vector<SkIRect> rects;
+    SkIRect damage = surface->takeDamage(&rects);
+    REPORTER_ASSERT(reporter, !rects.empty() && rects.size() <= 8);
+    SkRegion covered;
+    int64_t area = 0;
+    for (const SkIRect& r : rects) {
+        REPORTER_ASSERT(reporter, damage.contains(r));
+        covered.op(r, SkRegion::kUnion_Op);
+        area += r.width() * r.height();
+    }
+    for (int i = 0; i < 20; i++) {
+        REPORTER_ASSERT(reporter, covered.contains(SkIRect::MakeXYWH(i * 5, (i % 4) * 25, 2, 2)));
+    }
+    REPORTER_ASSERT(reporter, area < damage.width() * damage.height() / 2);
+
+    surface->setTrackDamage(false);
+    REPORTER_ASSERT(reporter, surface->takeDamage() == all);
+}
+
+DEF_TEST(Surface_DamagePlayback, reporter) {
+    SkPictureRecorder recorder;
+    SkRTreeFactory factory;
+    SkCanvas* recording = recorder.beginRecording(100, 100, &factory);
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    recording->drawRect(SkRect::MakeLTRB(0, 0, 50, 100), paint);
+    paint.setColor(SK_ColorGREEN);
+    recording->drawRect(SkRect::MakeLTRB(50, 0, 100, 100), paint);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    auto surface = SkSurface::MakeRasterN32Premul(100, 100);
+    surface->getCanvas()->clear(SK_ColorWHITE);
+    surface->setTrackDamage(true);
+    picture->playbackDamage(surface->getCanvas(), SkRegion(SkIRect::MakeLTRB(40, 40, 60, 60)));
+
+    // Only the damage is redrawn, and the surface knows that's all that changed.
+    REPORTER_ASSERT(reporter, surface->takeDamage() == SkIRect::MakeLTRB(40, 40, 60, 60));
+    SkBitmap bm;
+    bm.allocN32Pixels(100, 100);
+    surface->readPixels(bm, 0, 0);
+    REPORTER_ASSERT(reporter, *bm.getAddr32(10, 10) == SkPreMultiplyColor(SK_ColorWHITE));
+    REPORTER_ASSERT(reporter, *bm.getAddr32(45, 45) == SkPreMultiplyColor(SK_ColorBLUE));
+    REPORTER_ASSERT(reporter, *bm.getAddr32(55, 55) == SkPreMultiplyColor(SK_ColorGREEN));
+    REPORTER_ASSERT(reporter, *bm.getAddr32(90, 90) == SkPreMultiplyColor(SK_ColorWHITE));
+}
@@ -10,6 +10,7 @@
 #include "SkSwizzler.h"
 #include "Test.h"
 #include "SkOpts.h"
+#include "SkUnPreMultiply.h"
 
 // These are the values that we will look for to indicate that the fill was successful
 static const uint8_t kFillGray = 0x22;
@@ -153,6 +154,80 @@ DEF_TEST(SwizzleOpts, r) {
     REPORTER_ASSERT(r, dst == 0xFA04ADCA);
 }
 
+// The 16-bit swizzles keep the high byte of each big-endian component. Try every count up to a
+// few SIMD widths, so that both the vector loops and the tails are checked.
+DEF_TEST(SwizzleOpts16, r) {
+    constexpr int kMaxCount = 35;
+    uint8_t src[kMaxCount * 8];
+    for (size_t i = 0; i < sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    uint32_t dst[kMaxCount];
+    for (int count = 0; count <= kMaxCount; count++) {
+        SkOpts::RGB16_to_RGB1(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            const uint8_t* p = src + i * 6;
+            REPORTER_ASSERT(r, dst[i] == (0xFF000000 | (p[4] << 16) | (p[2] << 8) | p[0]));
+        }
+
+        SkOpts::RGB16_to_BGR1(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            const uint8_t* p = src + i * 6;
+            REPORTER_ASSERT(r, dst[i] == (0xFF000000 | (p[0] << 16) | (p[2] << 8) | p[4]));
+        }
+
+        SkOpts::RGBA16_to_RGBA(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            const uint8_t* p = src + i * 8;
+            REPORTER_ASSERT(r, dst[i] == (((uint32_t)p[6] << 24) | (p[4] << 16) | (p[2] << 8) |
+                                          p[0]));
+        }
+
+        SkOpts::RGBA16_to_BGRA(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            const uint8_t* p = src + i * 8;
+            REPORTER_ASSERT(r, dst[i] == (((uint32_t)p[6] << 24) | (p[0] << 16) | (p[2] << 8) |
+                                          p[4]));
+        }
+    }
+}
+
+// The unpremultiplying swizzles must match SkUnPreMultiply exactly, for every alpha and channel,
+// in the vector loops and the tails alike.
+DEF_TEST(SwizzleOptsUnpremul, r) {
+    constexpr int kCount = 256 + 11;
+    uint32_t src[kCount], dst[kCount];
+    for (int a = 0; a <= 255; a++) {
+        for (int i = 0; i < kCount; i++) {
+            int c = i & 0xFF;
+            src[i] = (uint32_t)a << 24 | (uint32_t)((c * 7) & 0xFF) << 16 | c << 8 | (255 - c);
+        }
+        auto expected = [&](uint32_t c) {
+            if (a == 0 || a == 255) {
+                return c;
+            }
+            SkUnPreMultiply::Scale scale = SkUnPreMultiply::GetScale(a);
+            return (uint32_t)a << 24
+                 | SkUnPreMultiply::ApplyScale(scale, (c >> 16) & 0xFF) << 16
+                 | SkUnPreMultiply::ApplyScale(scale, (c >>  8) & 0xFF) <<  8
+                 | SkUnPreMultiply::ApplyScale(scale, (c >>  0) & 0xFF) <<  0;
+        };
+
+        SkOpts::rgbA_to_RGBA(dst, src, kCount);
+        for (int i = 0; i < kCount; i++) {
+            REPORTER_ASSERT(r, dst[i] == expected(src[i]));
+        }
+
+        SkOpts::rgbA_to_BGRA(dst, src, kCount);
+        for (int i = 0; i < kCount; i++) {
+            uint32_t swapped;
+            SkOpts::RGBA_to_BGRA(&swapped, &src[i], 1);
+            REPORTER_ASSERT(r, dst[i] == expected(swapped));
+        }
+    }
+}
+
 DEF_TEST(PublicSwizzleOpts, r) {
     uint32_t dst, src;
 
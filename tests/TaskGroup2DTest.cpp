@@ -0,0 +1,86 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkTaskGroup2D.h"
+#include "Test.h"
+
+#include <vector>
+
+namespace {
+
+// Records the order in which each row sees its columns; odd columns need initialization.
+class OrderKernel : public SkWorkKernel2D {
+public:
+    OrderKernel(int height, int width)
+            : fWidth(width), fRows(height), fInitialized(width) {
+        for (auto& init : fInitialized) {
+            init = false;
+        }
+    }
+
+    bool work2D(int row, int column, int thread) override {
+        if ((column & 1) && !fInitialized[column]) {
+            return false;
+        }
+        fRows[row].push_back(column);
+        return true;
+    }
+
+    bool initColumn(int column, int thread) override {
+        bool expected = false;
+        return fInitialized[column].compare_exchange_strong(expected, true);
+    }
+
+    bool isInOrder(int row) const {
+        if ((int)fRows[row].size() != fWidth) {
+            return false;
+        }
+        for (int i = 0; i < fWidth; ++i) {
+            if (fRows[row][i] != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const int                       fWidth;
+    std::vector<std::vector<int>>   fRows;
+    std::vector<std::atomic<bool>>  fInitialized;
+};
+
+}  // namespace
+
+static void test_work_stealing(skiatest::Reporter* r, int height, int threadCnt) {
+    const int kWidth = 1000;
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(threadCnt);
+    OrderKernel kernel(height, kWidth);
+
+    SkWorkStealingTaskGroup2D group(&kernel, height, executor.get(), threadCnt);
+    group.start();
+    for (int i = 0; i < kWidth; ++i) {
+        group.addColumn();
+    }
+    group.finish();
+
+    for (int row = 0; row < height; ++row) {
+        REPORTER_ASSERT(r, kernel.isInOrder(row));
+        REPORTER_ASSERT(r, group.rowStats(row).fBusyMs >= 0);
+        REPORTER_ASSERT(r, group.rowStats(row).fBusyMs <= group.elapsedMs());
+    }
+    for (int t = 0; t < threadCnt; ++t) {
+        REPORTER_ASSERT(r, group.threadStats(t).fIdleMs >= 0);
+    }
+}
+
+DEF_TEST(SkWorkStealingTaskGroup2D_Order, r) {
+    test_work_stealing(r, 1, 1);
+    test_work_stealing(r, 8, 4);    // more rows than threads
+    test_work_stealing(r, 3, 8);    // more threads than rows: some threads only steal
+    test_work_stealing(r, 16, 16);
+}
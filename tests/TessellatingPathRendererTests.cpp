@@ -13,6 +13,10 @@
 #include "GrClip.h"
 #include "GrContext.h"
 #include "GrContextPriv.h"
+#include "GrGpu.h"
+#include "GrPathUtils.h"
+#include "GrTessellator.h"
+#include "SkExecutor.h"
 #include "SkGradientShader.h"
 #include "SkShaderBase.h"
 #include "effects/GrPorterDuffXferProcessor.h"
@@ -515,6 +519,68 @@ static void test_path(GrContext* ctx,
     tess.drawPath(args);
 }
 
+namespace {
+class AreaVertexAllocator : public GrTessellator::VertexAllocator {
+public:
+    AreaVertexAllocator() : VertexAllocator(sizeof(SkPoint)) {}
+    void* lock(int vertexCount) override {
+        fVertices.reset(vertexCount);
+        return fVertices.begin();
+    }
+    void unlock(int actualCount) override { fVertices.resize_back(actualCount); }
+
+    // Total area covered by the triangles.
+    double area() const {
+        double area = 0;
+        for (int i = 0; i + 2 < fVertices.count(); i += 3) {
+            SkVector u = fVertices[i + 1] - fVertices[i];
+            SkVector v = fVertices[i + 2] - fVertices[i];
+            area += SkTAbs(SkPoint::CrossProduct(u, v)) * 0.5;
+        }
+        return area;
+    }
+private:
+    SkTArray<SkPoint> fVertices;
+};
+}
+
+// Triangulating a large path in slabs covers the same area as triangulating it in one piece.
+DEF_TEST(TessellatorSlabs, reporter) {
+    // A self-intersecting star, drawn twice so that both fill rules matter.
+    SkPath path;
+    static constexpr int kPoints = GrTessellator::kMinSlabbedPathPoints;
+    for (int i = 0; i < kPoints; ++i) {
+        SkScalar angle = i * 2 * SK_ScalarPI * 3 / kPoints;
+        SkScalar radius = (i & 1) ? 300 : 390;
+        SkPoint pt = {400 + radius * SkScalarCos(angle), 400 + radius * SkScalarSin(angle)};
+        if (0 == i) {
+            path.moveTo(pt);
+        } else {
+            path.lineTo(pt);
+        }
+    }
+    path.close();
+    path.addCircle(400, 400, 200);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRect clipBounds = SkRect::MakeWH(800, 800);
+    for (SkPath::FillType fillType : {SkPath::kWinding_FillType, SkPath::kEvenOdd_FillType}) {
+        path.setFillType(fillType);
+        bool isLinear;
+        AreaVertexAllocator whole, slabs;
+        int wholeCount = GrTessellator::PathToTriangles(path, GrPathUtils::kDefaultTolerance,
+                                                        clipBounds, &whole, false, GrColor(),
+                                                        false, &isLinear);
+        int slabsCount = GrTessellator::PathToTrianglesInSlabs(path,
+                                                               GrPathUtils::kDefaultTolerance,
+                                                               clipBounds, &slabs, executor.get(),
+                                                               &isLinear);
+        REPORTER_ASSERT(reporter, wholeCount > 0 && slabsCount > 0);
+        REPORTER_ASSERT(reporter, SkTAbs(whole.area() - slabs.area()) < 1e-4 * whole.area(),
+                        "%g vs %g", whole.area(), slabs.area());
+    }
+}
+
 DEF_GPUTEST_FOR_ALL_CONTEXTS(TessellatingPathRendererTests, reporter, ctxInfo) {
     GrContext* ctx = ctxInfo.grContext();
     sk_sp<GrRenderTargetContext> rtc(ctx->contextPriv().makeDeferredRenderTargetContext(
@@ -564,4 +630,44 @@ DEF_GPUTEST_FOR_ALL_CONTEXTS(TessellatingPathRendererTests, reporter, ctxInfo) {
     test_path(ctx, rtc.get(), create_path_30());
     test_path(ctx, rtc.get(), create_path_31(), SkMatrix(), GrAAType::kCoverage);
 }
+
+#if GR_GPU_STATS
+// Scaling a path only tessellates it again when the scale leaves the cached tolerance bucket.
+DEF_GPUTEST_FOR_ALL_CONTEXTS(TessellatingPathRendererCache, reporter, ctxInfo) {
+    GrContext* ctx = ctxInfo.grContext();
+    sk_sp<GrRenderTargetContext> rtc(ctx->contextPriv().makeDeferredRenderTargetContext(
+            SkBackingFit::kApprox, 800, 800, kRGBA_8888_GrPixelConfig, nullptr, 1, GrMipMapped::kNo,
+            kTopLeft_GrSurfaceOrigin));
+    if (!rtc) {
+        return;
+    }
+    ctx->flush();
+    rtc->discard();
+
+    SkPath path;
+    path.moveTo(10, 10);
+    path.quadTo(100, 10, 100, 100);
+    path.lineTo(50, 20);
+    path.lineTo(10, 100);
+    path.close();
+
+    GrGpu::Stats* stats = ctx->contextPriv().getGpu()->stats();
+    stats->reset();
+
+    // The default tolerance is 1/4, so these scales put it in the buckets [1/4, 1/2), [1/4, 1/2),
+    // [1/8, 1/4), [1/4, 1/2) and [1/2, 1). The last one can use the tessellation from the finer
+    // [1/4, 1/2) bucket.
+    static constexpr float kScales[] = {1, 0.9f, 1.2f, 0.6f, 0.4f};
+    static constexpr int kExpectedTessellations[] = {1, 1, 2, 2, 2};
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kScales); ++i) {
+        test_path(ctx, rtc.get(), path, SkMatrix::MakeScale(kScales[i]));
+        ctx->flush();
+        int hits = static_cast<int>(i) + 1 - kExpectedTessellations[i];
+        REPORTER_ASSERT(reporter, stats->tessellations() == kExpectedTessellations[i],
+                        "scale %g: %d tessellations", kScales[i], stats->tessellations());
+        REPORTER_ASSERT(reporter, stats->tessellationCacheHits() == hits,
+                        "scale %g: %d cache hits", kScales[i], stats->tessellationCacheHits());
+    }
+}
+#endif
 #endif
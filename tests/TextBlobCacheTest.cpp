@@ -27,6 +27,8 @@
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "GrTest.h"
+#include "GrContextFactory.h"
+#include "text/GrTextBlobCache.h"
 
 static void draw(SkCanvas* canvas, int redraw, const SkTArray<sk_sp<SkTextBlob>>& blobs) {
     int yOffset = 0;
@@ -163,4 +165,109 @@ DEF_GPUTEST_FOR_NULLGL_CONTEXT(TextBlobAbnormal, reporter, ctxInfo) {
 DEF_GPUTEST_FOR_NULLGL_CONTEXT(TextBlobStressAbnormal, reporter, ctxInfo) {
     text_blob_cache_inner(reporter, ctxInfo.grContext(), 256, 256, 10, false, true);
 }
+
+static sk_sp<SkTextBlob> make_glyph_blob(int glyphCount) {
+    SkPaint paint;
+    paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    SkTextBlobBuilder builder;
+    const auto& run = builder.allocRun(paint, glyphCount, 0, 0);
+    for (int i = 0; i < glyphCount; ++i) {
+        run.glyphs[i] = i;
+    }
+    return builder.make();
+}
+
+static void over_budget_cb(void*) {}
+
+// A blob that keeps being redrawn should outlive large blobs that are drawn once.
+DEF_TEST(TextBlobCacheKeepsFrequentlyUsedBlobs, reporter) {
+    int data;
+    GrTextBlobCache cache(over_budget_cb, &data, SK_InvalidUniqueID, true);
+    cache.setBudget(1 << 19);
+
+    SkPaint paint;
+    SkMaskFilterBase::BlurRec blurRec;
+    sk_bzero(&blurRec, sizeof(blurRec));
+
+    sk_sp<SkTextBlob> hotBlob = make_glyph_blob(8);
+    GrAtlasTextBlob::Key hotKey;
+    hotKey.fUniqueID = hotBlob->uniqueID();
+    sk_sp<GrAtlasTextBlob> hot = cache.makeCachedBlob(hotBlob.get(), hotKey, blurRec, paint);
+    REPORTER_ASSERT(reporter,
+                    GrTextBlobCache::kSmall_SizeClass == GrTextBlobCache::ClassifySize(hot->size()));
+
+    for (int i = 0; i < 8; ++i) {
+        cache.makeMRU(hot.get());
+    }
+
+    // Each one-off blob is large enough that only a few fit in the budget. The hot blob reaches
+    // the tail of the LRU list several times but its earlier uses keep it in the cache.
+    SkTArray<sk_sp<SkTextBlob>> oneOffBlobs;
+    for (int i = 0; i < 10; ++i) {
+        sk_sp<SkTextBlob> blob = make_glyph_blob(2000);
+        GrAtlasTextBlob::Key key;
+        key.fUniqueID = blob->uniqueID();
+        cache.makeCachedBlob(blob.get(), key, blurRec, paint);
+        oneOffBlobs.push_back(std::move(blob));
+    }
+    cache.didFlush();
+
+    REPORTER_ASSERT(reporter, cache.find(hotKey));
+    const GrTextBlobCache::FlushStats& stats = cache.lastFlushStats();
+    REPORTER_ASSERT(reporter, 8 == stats.fHits);
+    REPORTER_ASSERT(reporter, 11 == stats.fMisses);
+    REPORTER_ASSERT(reporter, stats.fBudgetPurges > 0);
+    REPORTER_ASSERT(reporter, 0 == stats.fStalePurges);
+    REPORTER_ASSERT(reporter,
+                    cache.sizeClassStats(GrTextBlobCache::kLarge_SizeClass).fBlobCount ==
+                    10 - stats.fBudgetPurges);
+}
+
+// Draws a cached blob at a few positions, as when scrolling, and reads back each frame.
+static void draw_scrolled_text(GrContext* context, SkTArray<SkBitmap>* frames) {
+    static const int kSize = 128;
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+    auto surface(SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info));
+    if (!surface) {
+        return;
+    }
+
+    SkPaint paint;
+    paint.setTextSize(16);
+    paint.setAntiAlias(true);
+    sk_tool_utils::set_portable_typeface(&paint);
+    SkTextBlobBuilder builder;
+    sk_tool_utils::add_to_text_blob(&builder, "Scrolling text", paint, 0, 0);
+    sk_sp<SkTextBlob> blob(builder.make());
+
+    for (int y : { 20, 35, 35, 60, 41 }) {
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->clear(SK_ColorWHITE);
+        canvas->drawTextBlob(blob, 5, SkIntToScalar(y), SkPaint());
+        SkBitmap& frame = frames->push_back();
+        frame.allocPixels(info);
+        surface->readPixels(frame, 0, 0);
+    }
+}
+
+DEF_GPUTEST(TextBlobReuseVertexBuffers, reporter, options) {
+    SkTArray<SkBitmap> frames[2];
+    for (int reuse = 0; reuse < 2; ++reuse) {
+        GrContextOptions contextOptions = options;
+        contextOptions.fReuseTextVertexBuffers = SkToBool(reuse);
+        sk_gpu_test::GrContextFactory factory(contextOptions);
+        GrContext* context = factory.get(sk_gpu_test::GrContextFactory::kGL_ContextType);
+        if (!context) {
+            return;
+        }
+        draw_scrolled_text(context, &frames[reuse]);
+    }
+
+    REPORTER_ASSERT(reporter, frames[0].count() == frames[1].count());
+    for (int i = 0; i < SkTMin(frames[0].count(), frames[1].count()); ++i) {
+        const SkBitmap& a = frames[0][i];
+        const SkBitmap& b = frames[1][i];
+        REPORTER_ASSERT(reporter, 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()));
+    }
+}
 #endif
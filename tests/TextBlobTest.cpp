@@ -455,3 +455,75 @@ DEF_TEST(TextBlob_serialize, reporter) {
         REPORTER_ASSERT(reporter, sk_tool_utils::equal_pixels(img0.get(), img1.get()));
     }
 }
+
+#include "SkTextBlobRasterCache.h"
+
+/*
+ *  Draw a blob with every kind of run, with and without the raster glyph cache,
+ *  and make sure the cache never changes what we draw.
+ */
+DEF_TEST(TextBlob_rasterCache, reporter) {
+    sk_sp<SkTypeface> tf = sk_tool_utils::create_portable_typeface("serif", SkFontStyle());
+
+    SkTextBlobBuilder builder;
+    SkPaint font;
+    font.setTypeface(tf);
+    font.setAntiAlias(true);
+    font.setSubpixelText(true);
+    font.setTextSize(16);
+    SkGlyphID glyphs[8];
+    font.textToGlyphs("Skia Raz", 8, glyphs);
+    font.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+    const auto& run0 = builder.allocRun(font, 8, 10.3f, 20);
+    memcpy(run0.glyphs, glyphs, sizeof(glyphs));
+    const auto& run1 = builder.allocRunPosH(font, 8, 40);
+    memcpy(run1.glyphs, glyphs, sizeof(glyphs));
+    for (int i = 0; i < 8; ++i) {
+        run1.pos[i] = 10 + 11.25f * i;
+    }
+    const auto& run2 = builder.allocRunPos(font, 8);
+    memcpy(run2.glyphs, glyphs, sizeof(glyphs));
+    for (int i = 0; i < 8; ++i) {
+        run2.pos[2 * i + 0] = 10 + 10.6f * i;
+        run2.pos[2 * i + 1] = 60 + 0.4f * i;
+    }
+    font.setTextSize(300);   // too big for a strike; drawn as paths
+    const auto& run3 = builder.allocRun(font, 1, 10, 360);
+    run3.glyphs[0] = glyphs[0];
+    sk_sp<SkTextBlob> blob = builder.make();
+
+    auto draw = [&](const SkPaint& paint, SkScalar dx, uint32_t flags) {
+        SkSurfaceProps props(flags, kUnknown_SkPixelGeometry);
+        auto surf = SkSurface::MakeRasterN32Premul(400, 400, &props);
+        surf->getCanvas()->clear(SK_ColorWHITE);
+        surf->getCanvas()->translate(dx, 0.5f);
+        surf->getCanvas()->drawTextBlob(blob, 0, 0, paint);
+        return surf->makeImageSnapshot();
+    };
+
+    SkPaint fill, stroke;
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(1);
+
+    sk_sp<SkImage> expected[] = { draw(fill, 0.25f, 0), draw(stroke, 0.25f, 0),
+                                  draw(fill, 3.75f, 0) };
+
+    // Draw each twice, so the second comes from the cache.  The stroked blob has the same key as
+    // the first fill, but can't use the glyphs placed for it.
+    const uint32_t kCache = SkSurfaceProps::kCacheTextBlobs_Flag;
+    for (int pass = 0; pass < 2; ++pass) {
+        REPORTER_ASSERT(reporter, sk_tool_utils::equal_pixels(
+                                          expected[0].get(), draw(fill, 0.25f, kCache).get()));
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+        REPORTER_ASSERT(reporter, sk_tool_utils::equal_pixels(
+                                          expected[1].get(), draw(stroke, 0.25f, kCache).get()));
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+        REPORTER_ASSERT(reporter, sk_tool_utils::equal_pixels(
+                                          expected[2].get(), draw(fill, 3.75f, kCache).get()));
+    }
+    SkMatrix matrix = SkMatrix::MakeTrans(3.75f, 0.5f);
+    REPORTER_ASSERT(reporter, SkTextBlobRasterCache::Find(*blob, 0, 0, matrix));
+}
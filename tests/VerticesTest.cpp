@@ -147,3 +147,55 @@ DEF_TEST(Vertices_clipping, reporter) {
         }
     }
 }
+
+DEF_TEST(Vertices_sharedEdges, reporter) {
+    // Triangles that share edges, here a fan around a center point, must cover each pixel along
+    // those edges exactly once: translucent ones would otherwise blend twice, or leave gaps.
+    constexpr int kSize = 64, kFan = 37;
+    auto surf = SkSurface::MakeRasterN32Premul(kSize, kSize);
+    SkCanvas* canvas = surf->getCanvas();
+    canvas->clipRect(SkRect::MakeLTRB(3, 5, 60, 58));
+
+    const SkPoint center = { 31.3f, 29.7f };
+    const SkScalar radius = 25;
+    SkPoint pts[kFan + 1];
+    SkColor colors[kFan + 1];
+    uint16_t indices[kFan * 3];
+    pts[0] = center;
+    for (int i = 0; i < kFan; ++i) {
+        SkScalar angle = i * 2 * SK_ScalarPI / kFan;
+        pts[i + 1] = center + SkVector::Make(radius * SkScalarCos(angle),
+                                             radius * SkScalarSin(angle));
+        indices[3 * i + 0] = 0;
+        indices[3 * i + 1] = i + 1;
+        indices[3 * i + 2] = (i + 1) % kFan + 1;
+    }
+    for (SkColor& c : colors) {
+        c = 0x80FF0000;
+    }
+    canvas->drawVertices(SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, kFan + 1, pts,
+                                              nullptr, colors, kFan * 3, indices),
+                         SkBlendMode::kModulate, SkPaint());
+
+    // Every pixel inside the fan's inscribed circle is drawn, all with the color of one blend,
+    // and none outside the clip are drawn.
+    const SkIRect clip = SkIRect::MakeLTRB(3, 5, 60, 58);
+    const SkScalar inner = radius * SkScalarCos(SK_ScalarPI / kFan) - 1;
+    SkPMColor once = 0;
+    sk_tool_utils::PixelIter iter(surf.get());
+    SkIPoint loc;
+    while (void* addr = iter.next(&loc)) {
+        SkPMColor c = *(SkPMColor*)addr;
+        if (!clip.contains(loc.fX, loc.fY)) {
+            REPORTER_ASSERT(reporter, c == 0);
+            continue;
+        }
+        if (SkPoint::Distance(SkPoint::Make(loc.fX + 0.5f, loc.fY + 0.5f), center) < inner) {
+            REPORTER_ASSERT(reporter, c != 0, "%d %d", loc.fX, loc.fY);
+        }
+        if (c != 0) {
+            once = once ? once : c;
+            REPORTER_ASSERT(reporter, c == once, "%d %d: %08x", loc.fX, loc.fY, c);
+        }
+    }
+}
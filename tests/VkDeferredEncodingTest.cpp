@@ -0,0 +1,85 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#if SK_SUPPORT_GPU && defined(SK_VULKAN)
+
+#include "GrContextFactory.h"
+#include "GrContextPriv.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkSurface.h"
+#include "Test.h"
+#include "vk/GrVkCommandBuffer.h"
+#include "vk/GrVkGpu.h"
+
+DEF_GPUTEST(VkDeferredCommandEncoding, reporter, options) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    GrContextOptions contextOptions = options;
+    contextOptions.fExecutor = executor.get();
+    contextOptions.fEncodeVulkanCommandsOnExecutor = true;
+    sk_gpu_test::GrContextFactory factory(contextOptions);
+    GrContext* context = factory.get(sk_gpu_test::GrContextFactory::kVulkan_ContextType);
+    if (!context) {
+        return;
+    }
+    GrVkGpu* gpu = static_cast<GrVkGpu*>(context->contextPriv().getGpu());
+    REPORTER_ASSERT(reporter, gpu->commandEncodingExecutor() == executor.get());
+
+    GrVkSecondaryCommandBuffer* cmdBuffer =
+            gpu->resourceProvider().findOrCreateSecondaryCommandBuffer(true);
+    REPORTER_ASSERT(reporter, cmdBuffer && cmdBuffer->isDeferred());
+    if (cmdBuffer) {
+        gpu->resourceProvider().recycleSecondaryCommandBuffer(cmdBuffer);
+    }
+
+    static const int kSize = 64;
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+    sk_sp<SkSurface> surface(SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info));
+    if (!surface) {
+        ERRORF(reporter, "Could not create surface.");
+        return;
+    }
+
+    // Each quarter of the surface gets a color of its own, with a clear in between the draws so
+    // the flush records more than one secondary command buffer.
+    static const SkColor kColors[4] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorYELLOW };
+    SkCanvas* canvas = surface->getCanvas();
+    for (int i = 0; i < 4; ++i) {
+        SkIRect quarter = SkIRect::MakeXYWH((i % 2) * kSize / 2, (i / 2) * kSize / 2,
+                                            kSize / 2, kSize / 2);
+        SkPaint paint;
+        paint.setColor(kColors[i]);
+        canvas->drawIRect(quarter, paint);
+        if (1 == i) {
+            canvas->save();
+            canvas->clipRect(SkRect::Make(SkIRect::MakeXYWH(0, kSize / 2, kSize, kSize / 2)));
+            canvas->clear(SK_ColorBLACK);
+            canvas->restore();
+        }
+    }
+    canvas->flush();
+
+    SkAutoTMalloc<uint32_t> pixels(kSize * kSize);
+    SkImageInfo readInfo = SkImageInfo::Make(kSize, kSize, kBGRA_8888_SkColorType,
+                                             kPremul_SkAlphaType);
+    if (!surface->readPixels(readInfo, pixels.get(), kSize * sizeof(uint32_t), 0, 0)) {
+        ERRORF(reporter, "Could not read pixels.");
+        return;
+    }
+    for (int i = 0; i < 4; ++i) {
+        int x = (i % 2) * kSize / 2 + kSize / 4;
+        int y = (i / 2) * kSize / 2 + kSize / 4;
+        uint32_t pixel = pixels.get()[y * kSize + x];
+        REPORTER_ASSERT(reporter, pixel == kColors[i], "quarter %d: 0x%08x", i, pixel);
+    }
+}
+
+#endif
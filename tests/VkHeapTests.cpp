@@ -230,10 +230,46 @@ void singlealloc_test(skiatest::Reporter* reporter, GrContext* context) {
     REPORTER_ASSERT(reporter, heap.allocSize() == 160 * 1024 && heap.usedSize() == 0 * 1024);
 }
 
+void freeempty_test(skiatest::Reporter* reporter, GrContext* context) {
+    GrVkGpu* gpu = static_cast<GrVkGpu*>(context->contextPriv().getGpu());
+
+    GrVkHeap heap(gpu, GrVkHeap::kSubAlloc_Strategy, 64 * 1024);
+    GrVkAlloc alloc0, alloc1, alloc2, alloc3;
+    const VkDeviceSize kAlignment = 16;
+    const uint32_t kMemType = 0;
+    const uint32_t kHeapIndex = 0;
+
+    // two subheaps, one for each memory type, and one allocation too big for either
+    REPORTER_ASSERT(reporter, heap.alloc(24 * 1024, kAlignment, kMemType, kHeapIndex, &alloc0));
+    REPORTER_ASSERT(reporter, heap.alloc(24 * 1024, kAlignment, kMemType, kHeapIndex, &alloc1));
+    REPORTER_ASSERT(reporter, heap.alloc(24 * 1024, kAlignment, kMemType + 1, kHeapIndex, &alloc2));
+    REPORTER_ASSERT(reporter, heap.alloc(96 * 1024, kAlignment, kMemType, kHeapIndex, &alloc3));
+    REPORTER_ASSERT(reporter, heap.allocSize() == 128 * 1024 && heap.usedSize() == 72 * 1024);
+    REPORTER_ASSERT(reporter, heap.dedicatedSize() == 96 * 1024 && heap.subHeapCount() == 2);
+    heap.free(alloc3);
+    REPORTER_ASSERT(reporter, heap.dedicatedSize() == 0);
+
+    // only a subheap with nothing in it goes away
+    heap.free(alloc0);
+    heap.free(alloc2);
+    heap.freeEmptySubHeaps();
+    REPORTER_ASSERT(reporter, heap.allocSize() == 64 * 1024 && heap.usedSize() == 24 * 1024);
+    REPORTER_ASSERT(reporter, heap.subHeapCount() == 1);
+    // and what's left still works
+    REPORTER_ASSERT(reporter, heap.alloc(40 * 1024, kAlignment, kMemType, kHeapIndex, &alloc0));
+    REPORTER_ASSERT(reporter, heap.allocSize() == 64 * 1024 && heap.usedSize() == 64 * 1024);
+    heap.free(alloc0);
+    heap.free(alloc1);
+    heap.freeEmptySubHeaps();
+    REPORTER_ASSERT(reporter, heap.allocSize() == 0 && heap.usedSize() == 0);
+    REPORTER_ASSERT(reporter, heap.subHeapCount() == 0);
+}
+
 DEF_GPUTEST_FOR_VULKAN_CONTEXT(VkHeapTests, reporter, ctxInfo) {
     subheap_test(reporter, ctxInfo.grContext());
     suballoc_test(reporter, ctxInfo.grContext());
     singlealloc_test(reporter, ctxInfo.grContext());
+    freeempty_test(reporter, ctxInfo.grContext());
 }
 
 #endif
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This is a GPU-backend specific test. It relies on static intializers to work
+
+#include "SkTypes.h"
+
+#if SK_SUPPORT_GPU && defined(SK_VULKAN)
+
+#include "GrContextPriv.h"
+#include "GrContextFactory.h"
+#include "GrTest.h"
+#include "SkAutoMalloc.h"
+#include "Test.h"
+#include "vk/GrVkGpu.h"
+#include "vk/GrVkUniformRingBuffer.h"
+
+DEF_GPUTEST_FOR_VULKAN_CONTEXT(VkUniformRingBuffer, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    GrVkGpu* gpu = static_cast<GrVkGpu*>(context->contextPriv().getGpu());
+    GrVkUniformRingBuffer* ringBuffer = gpu->resourceProvider().uniformRingBuffer();
+    REPORTER_ASSERT(reporter, ringBuffer);
+
+    const uint32_t alignment =
+            (uint32_t)gpu->physicalDeviceProperties().limits.minUniformBufferOffsetAlignment;
+    static const uint32_t kMaxSize = GrVkUniformRingBuffer::kMaxUniformSize;
+    REPORTER_ASSERT(reporter, GrVkUniformRingBuffer::CanHold(kMaxSize, kMaxSize));
+    REPORTER_ASSERT(reporter, !GrVkUniformRingBuffer::CanHold(kMaxSize + 4, 16));
+
+    SkAutoMalloc data(kMaxSize);
+    memset(data.get(), 0, kMaxSize);
+
+    GrVkUniformRingBuffer::Allocation first;
+    REPORTER_ASSERT(reporter, ringBuffer->upload(gpu, data.get(), 64, data.get(), 32, &first));
+    REPORTER_ASSERT(reporter, first.fChunk && ringBuffer->isCurrent(first));
+    REPORTER_ASSERT(reporter, 0 == first.fDynamicOffsets[0] % alignment);
+    REPORTER_ASSERT(reporter, 0 == first.fDynamicOffsets[1] % alignment);
+    REPORTER_ASSERT(reporter, first.fDynamicOffsets[1] >= first.fDynamicOffsets[0] + 64);
+
+    // Later uploads come after it in the same chunk...
+    GrVkUniformRingBuffer::Allocation next;
+    REPORTER_ASSERT(reporter, ringBuffer->upload(gpu, data.get(), 64, nullptr, 0, &next));
+    REPORTER_ASSERT(reporter, next.fChunk == first.fChunk);
+    REPORTER_ASSERT(reporter, next.fDynamicOffsets[0] >= first.fDynamicOffsets[1] + 32);
+
+    // ... until it's full. Nothing has used the first chunk, so we may be handed it straight back,
+    // but what was in it is gone either way.
+    int uploads = 0;
+    while (ringBuffer->isCurrent(first) && uploads < 1000) {
+        REPORTER_ASSERT(reporter, ringBuffer->upload(gpu, data.get(), kMaxSize,
+                                                     data.get(), kMaxSize, &next));
+        ++uploads;
+    }
+    REPORTER_ASSERT(reporter, !ringBuffer->isCurrent(first) && ringBuffer->isCurrent(next));
+    REPORTER_ASSERT(reporter, 0 == next.fDynamicOffsets[0]);
+    ringBuffer->flush(gpu);
+}
+
+#endif
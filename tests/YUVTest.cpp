@@ -13,9 +13,15 @@
 #include "SkYUVSizeInfo.h"
 #include "Test.h"
 
+static uint32_t align_width(int width, uint32_t alignment) {
+    return ((uint32_t) width + alignment - 1) / alignment * alignment;
+}
+
 static void codec_yuv(skiatest::Reporter* reporter,
                   const char path[],
-                  SkISize expectedSizes[3]) {
+                  SkISize expectedSizes[3],
+                  SkYUVColorSpace expectedColorSpace = kJPEG_SkYUVColorSpace,
+                  uint32_t widthAlignment = 8) {
     std::unique_ptr<SkStream> stream(GetResourceAsStream(path));
     if (!stream) {
         return;
@@ -38,22 +44,22 @@ static void codec_yuv(skiatest::Reporter* reporter,
     REPORTER_ASSERT(reporter,
             0 == memcmp((const void*) &info, (const void*) expectedSizes, 3 * sizeof(SkISize)));
     REPORTER_ASSERT(reporter, info.fWidthBytes[SkYUVSizeInfo::kY] ==
-            (uint32_t) SkAlign8(info.fSizes[SkYUVSizeInfo::kY].width()));
+            align_width(info.fSizes[SkYUVSizeInfo::kY].width(), widthAlignment));
     REPORTER_ASSERT(reporter, info.fWidthBytes[SkYUVSizeInfo::kU] ==
-            (uint32_t) SkAlign8(info.fSizes[SkYUVSizeInfo::kU].width()));
+            align_width(info.fSizes[SkYUVSizeInfo::kU].width(), widthAlignment));
     REPORTER_ASSERT(reporter, info.fWidthBytes[SkYUVSizeInfo::kV] ==
-            (uint32_t) SkAlign8(info.fSizes[SkYUVSizeInfo::kV].width()));
+            align_width(info.fSizes[SkYUVSizeInfo::kV].width(), widthAlignment));
     SkYUVColorSpace colorSpace;
     success = codec->queryYUV8(&info, &colorSpace);
     REPORTER_ASSERT(reporter,
             0 == memcmp((const void*) &info, (const void*) expectedSizes, 3 * sizeof(SkISize)));
     REPORTER_ASSERT(reporter, info.fWidthBytes[SkYUVSizeInfo::kY] ==
-            (uint32_t) SkAlign8(info.fSizes[SkYUVSizeInfo::kY].width()));
+            align_width(info.fSizes[SkYUVSizeInfo::kY].width(), widthAlignment));
     REPORTER_ASSERT(reporter, info.fWidthBytes[SkYUVSizeInfo::kU] ==
-            (uint32_t) SkAlign8(info.fSizes[SkYUVSizeInfo::kU].width()));
+            align_width(info.fSizes[SkYUVSizeInfo::kU].width(), widthAlignment));
     REPORTER_ASSERT(reporter, info.fWidthBytes[SkYUVSizeInfo::kV] ==
-            (uint32_t) SkAlign8(info.fSizes[SkYUVSizeInfo::kV].width()));
-    REPORTER_ASSERT(reporter, kJPEG_SkYUVColorSpace == colorSpace);
+            align_width(info.fSizes[SkYUVSizeInfo::kV].width(), widthAlignment));
+    REPORTER_ASSERT(reporter, expectedColorSpace == colorSpace);
 
     // Allocate the memory for the YUV decode
     size_t totalBytes =
@@ -124,3 +130,17 @@ DEF_TEST(Jpeg_YUV_Codec, r) {
     // A PNG should fail.
     codec_yuv(r, "images/arrow.png", nullptr);
 }
+
+DEF_TEST(Webp_YUV_Codec, r) {
+    // Opaque lossy images are decoded to 4:2:0 planes with unpadded rows.
+    SkISize sizes[3];
+    sizes[0].set(800, 800);
+    sizes[1].set(400, 400);
+    sizes[2].set(400, 400);
+    codec_yuv(r, "images/webp-color-profile-lossy.webp", sizes, kRec601_SkYUVColorSpace, 1);
+
+    // Lossless images, images with alpha and animations should fail.
+    codec_yuv(r, "images/color_wheel.webp", nullptr);
+    codec_yuv(r, "images/yellow_rose.webp", nullptr);
+    codec_yuv(r, "images/webp-animated.webp", nullptr);
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "AACostCalibration.h"
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkScan.h"
+#include "SkTArray.h"
+#include "SkTime.h"
+
+#include <cmath>
+#include <utility>
+
+namespace {
+
+constexpr int kFeatures = 5;   // 1, edges, edgeRows, pixels, crossings
+
+struct Sample {
+    float fFeatures[kFeatures];
+    float fNanos[SkAACostModel::kScanConverterCount];
+};
+
+SkPath make_path(int kind, int points, SkScalar size, SkRandom* rand) {
+    SkPath path;
+    SkScalar c = size / 2;
+    switch (kind) {
+        case 0:     // A convex polygon.
+        case 1:     // A star, with spikes of random length.
+            for (int i = 0; i < points; ++i) {
+                SkScalar angle  = 2 * SK_ScalarPI * i / points,
+                         radius = kind == 0 || i % 2 ? c : rand->nextRangeScalar(0.1f, 1) * c;
+                SkPoint p = {c + radius * SkScalarCos(angle), c + radius * SkScalarSin(angle)};
+                if (i == 0) {
+                    path.moveTo(p);
+                } else {
+                    path.lineTo(p);
+                }
+            }
+            break;
+        case 2:     // A scribble of random lines, with lots of crossings.
+            path.moveTo(rand->nextRangeScalar(0, size), rand->nextRangeScalar(0, size));
+            for (int i = 1; i < points; ++i) {
+                path.lineTo(rand->nextRangeScalar(0, size), rand->nextRangeScalar(0, size));
+            }
+            break;
+        case 3:     // Small cubic blobs, like glyph outlines.
+            for (int i = 0; i < points / 4; ++i) {
+                SkScalar r = rand->nextRangeScalar(0.02f, 0.2f) * size;
+                path.addCircle(rand->nextRangeScalar(r, size - r),
+                               rand->nextRangeScalar(r, size - r), r);
+            }
+            break;
+    }
+    path.close();
+    return path;
+}
+
+// Returns nanoseconds per draw, the best of a few runs long enough to measure.
+double time_draws(SkCanvas* canvas, const SkPath& path, const SkPaint& paint) {
+    constexpr double kMinNanos = 500 * 1000;
+    canvas->drawPath(path, paint);   // warm up
+
+    double best = SK_ScalarInfinity;
+    for (int run = 0; run < 3; ++run) {
+        for (int loops = 1; ; loops *= 2) {
+            double start = SkTime::GetNSecs();
+            for (int i = 0; i < loops; ++i) {
+                canvas->drawPath(path, paint);
+            }
+            double elapsed = SkTime::GetNSecs() - start;
+            if (elapsed >= kMinNanos) {
+                best = SkTMin(best, elapsed / loops);
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+// Least squares fit of nanos ~= coefficients . features, minimizing the relative error.  Terms
+// whose coefficient comes out negative are dropped and the rest refit.
+SkAACostModel::Cost fit(const SkTArray<Sample>& samples, int sc) {
+    bool active[kFeatures] = {true, true, true, true, true};
+    double coefficients[kFeatures];
+
+    for (int attempt = 0; attempt < kFeatures; ++attempt) {
+        // Scale each feature so the normal equations stay well conditioned.
+        double scale[kFeatures];
+        for (int j = 0; j < kFeatures; ++j) {
+            double sum = 0;
+            for (const Sample& s : samples) {
+                sum += (s.fFeatures[j] / s.fNanos[sc]) * (s.fFeatures[j] / s.fNanos[sc]);
+            }
+            scale[j] = sum > 0 ? 1 / sqrt(sum / samples.count()) : 0;
+        }
+
+        double A[kFeatures][kFeatures + 1] = {{0}};
+        for (const Sample& s : samples) {
+            double w = 1 / s.fNanos[sc];
+            for (int j = 0; j < kFeatures; ++j) {
+                double xj = active[j] ? s.fFeatures[j] * scale[j] * w : 0;
+                for (int k = 0; k < kFeatures; ++k) {
+                    double xk = active[k] ? s.fFeatures[k] * scale[k] * w : 0;
+                    A[j][k] += xj * xk;
+                }
+                A[j][kFeatures] += xj * s.fNanos[sc] * w;
+            }
+        }
+        for (int j = 0; j < kFeatures; ++j) {
+            if (!active[j] || scale[j] == 0) {
+                active[j] = false;
+                for (int k = 0; k <= kFeatures; ++k) {
+                    A[j][k] = (k == j);
+                }
+            }
+        }
+
+        // Gaussian elimination with partial pivoting.
+        for (int j = 0; j < kFeatures; ++j) {
+            int pivot = j;
+            for (int k = j + 1; k < kFeatures; ++k) {
+                if (fabs(A[k][j]) > fabs(A[pivot][j])) {
+                    pivot = k;
+                }
+            }
+            for (int k = 0; k <= kFeatures; ++k) {
+                std::swap(A[j][k], A[pivot][k]);
+            }
+            if (A[j][j] == 0) {
+                continue;
+            }
+            for (int k = 0; k < kFeatures; ++k) {
+                if (k != j) {
+                    double f = A[k][j] / A[j][j];
+                    for (int l = j; l <= kFeatures; ++l) {
+                        A[k][l] -= f * A[j][l];
+                    }
+                }
+            }
+        }
+
+        bool allPositive = true;
+        for (int j = 0; j < kFeatures; ++j) {
+            coefficients[j] = active[j] && A[j][j] != 0 ? A[j][kFeatures] / A[j][j] * scale[j] : 0;
+            if (coefficients[j] < 0) {
+                active[j] = false;
+                allPositive = false;
+            }
+        }
+        if (allPositive) {
+            break;
+        }
+    }
+
+    return { (float)SkTMax(0.0, coefficients[0]), (float)SkTMax(0.0, coefficients[1]),
+             (float)SkTMax(0.0, coefficients[2]), (float)SkTMax(0.0, coefficients[3]),
+             (float)SkTMax(0.0, coefficients[4]) };
+}
+
+}  // namespace
+
+namespace sk_tools {
+
+SkAACostModel calibrateAACostModel() {
+    bool useAnalytic   = gSkUseAnalyticAA,
+         forceAnalytic = gSkForceAnalyticAA,
+         useDelta      = gSkUseDeltaAA,
+         forceDelta    = gSkForceDeltaAA,
+         useCostModel  = gSkUseAACostModel;
+    gSkUseAACostModel = false;
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    SkRandom rand;
+    SkTArray<Sample> samples;
+    for (int size : {16, 48, 128, 384}) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeA8(size, size));
+        SkCanvas canvas(bitmap);
+
+        for (int kind = 0; kind < 4; ++kind)
+        for (int points : {8, 32, 128, 512, 2048}) {
+            if (kind == 2 && points > 128) {
+                continue;   // Scribbles that dense are just noise.
+            }
+            SkPath path = make_path(kind, points, size, &rand);
+            SkAACostModel::Features f = SkAACostModel::Features::Make(path,
+                                                                      SkIRect::MakeWH(size, size));
+            Sample& s = samples.push_back();
+            s.fFeatures[0] = 1;
+            s.fFeatures[1] = f.fEdges;
+            s.fFeatures[2] = f.fEdgeRows;
+            s.fFeatures[3] = f.fPixels;
+            s.fFeatures[4] = f.fCrossings;
+
+            for (int sc = 0; sc < SkAACostModel::kScanConverterCount; ++sc) {
+                gSkUseAnalyticAA   = sc == SkAACostModel::kAnalytic;
+                gSkForceAnalyticAA = sc == SkAACostModel::kAnalytic;
+                gSkUseDeltaAA      = sc == SkAACostModel::kDelta;
+                gSkForceDeltaAA    = sc == SkAACostModel::kDelta;
+                s.fNanos[sc] = SkTMax(1.0, time_draws(&canvas, path, paint));
+            }
+        }
+    }
+
+    gSkUseAnalyticAA   = useAnalytic;
+    gSkForceAnalyticAA = forceAnalytic;
+    gSkUseDeltaAA      = useDelta;
+    gSkForceDeltaAA    = forceDelta;
+    gSkUseAACostModel  = useCostModel;
+
+    SkAACostModel model;
+    for (int sc = 0; sc < SkAACostModel::kScanConverterCount; ++sc) {
+        model.fCosts[sc] = fit(samples, sc);
+    }
+    return model;
+}
+
+}  // namespace sk_tools
@@ -0,0 +1,23 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef AACostCalibration_DEFINED
+#define AACostCalibration_DEFINED
+
+#include "SkAACostModel.h"
+
+namespace sk_tools {
+
+/**
+ *  Times each AA scan converter filling a set of synthetic paths on this machine, and fits an
+ *  SkAACostModel to those timings.  Takes a few seconds.  Doesn't install the model.
+ */
+SkAACostModel calibrateAACostModel();
+
+}  // namespace sk_tools
+
+#endif  // AACostCalibration_DEFINED
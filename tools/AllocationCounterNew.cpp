@@ -0,0 +1,38 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMalloc.h"
+
+#include <new>
+
+#if !defined(__has_feature)
+    #define __has_feature(x) 0
+#endif
+
+// Route operator new and delete through sk_malloc() and sk_free(), so SkAllocationCounter counts
+// them too.  Sanitizers replace operator new themselves, so leave it to them there.
+#if !__has_feature(address_sanitizer) && !__has_feature(memory_sanitizer) && \
+    !__has_feature(thread_sanitizer)
+
+void* operator new(size_t size) { return sk_malloc_throw(size ? size : 1); }
+void* operator new[](size_t size) { return sk_malloc_throw(size ? size : 1); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return sk_malloc_canfail(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return sk_malloc_canfail(size ? size : 1);
+}
+
+void operator delete(void* p) noexcept { sk_free(p); }
+void operator delete[](void* p) noexcept { sk_free(p); }
+void operator delete(void* p, size_t) noexcept { sk_free(p); }
+void operator delete[](void* p, size_t) noexcept { sk_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { sk_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { sk_free(p); }
+
+#endif
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "OverdrawAnalysis.h"
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkJSONWriter.h"
+#include "SkOverdrawCanvas.h"
+#include "SkPicture.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRecorder.h"
+#include "SkShader.h"
+#include "SkTemplates.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+struct OpInfo {
+    const char*    fName     = nullptr;
+    const SkPaint* fPaint    = nullptr;
+    bool           fDraws    = false;
+    bool           fHasImage = false;
+    bool           fLayer    = false;
+};
+
+class Inspect {
+public:
+    explicit Inspect(OpInfo* info) : fInfo(info) {}
+
+    template <typename T>
+    void operator()(const T& op) {
+    #define CASE(U) case SkRecords::U##_Type: fInfo->fName = #U; break;
+        switch (T::kType) { SK_RECORD_TYPES(CASE) }
+    #undef CASE
+        fInfo->fDraws    = SkToBool(T::kTags & SkRecords::kDraw_Tag);
+        fInfo->fHasImage = SkToBool(T::kTags & SkRecords::kHasImage_Tag);
+        fInfo->fLayer    = SkRecords::SaveLayer_Type == T::kType;
+        this->paint(op);
+    }
+
+private:
+    static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
+    static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
+
+    template <typename T>
+    SK_WHEN(T::kTags & SkRecords::kHasPaint_Tag, void) paint(const T& op) {
+        fInfo->fPaint = AsPtr(op.paint);
+    }
+    template <typename T>
+    SK_WHEN(!(T::kTags & SkRecords::kHasPaint_Tag), void) paint(const T&) {}
+
+    OpInfo* fInfo;
+};
+
+// The cost of drawing a pixel with the paint, in units of an opaque solid color write. These are
+// rough weights for ranking draws against each other, not timings. Images are assumed not to be
+// opaque, so they always read the pixels they blend with.
+double pixel_cost(const OpInfo& op) {
+    const SkPaint* paint = op.fPaint;
+    if (op.fLayer) {
+        // Reading the layer back and blending it with what's under it.
+        return 2 + (paint && paint->getColorFilter() ? 1 : 0) +
+                   (paint && paint->getImageFilter() ? 4 : 0);
+    }
+    if (!paint) {
+        return op.fHasImage ? 3 : 1;
+    }
+
+    const SkShader* shader = paint->getShader();
+    double cost = 1;
+    if (op.fHasImage || (shader && shader->isAImage())) {
+        cost += kNone_SkFilterQuality == paint->getFilterQuality() ? 1 : 2;
+    } else if (shader) {
+        cost += SkShader::kNone_GradientType != shader->asAGradient(nullptr) ? 1 : 3;
+    }
+    cost += paint->getColorFilter() ? 1 : 0;
+    cost += paint->getMaskFilter()  ? 2 : 0;
+    cost += paint->getImageFilter() ? 4 : 0;
+
+    const bool opaque = SkBlendMode::kSrc == paint->getBlendMode() ||
+                        (paint->isSrcOver() && 0xFF == paint->getAlpha() && !op.fHasImage &&
+                         (!shader || shader->isOpaque()) && !paint->getColorFilter());
+    return opaque ? cost : cost + 1;
+}
+
+const char* paint_name(const OpInfo& op) {
+    if (op.fLayer) {
+        return "layer";
+    }
+    if (op.fPaint && op.fPaint->getShader()) {
+        const char* name = op.fPaint->getShader()->getTypeName();
+        return name ? name : "shader";
+    }
+    return op.fHasImage ? "image" : "color";
+}
+
+// Sums the counts in rect, and clears them for the next op.
+int64_t take_pixels(SkBitmap* counts, const SkIRect& rect) {
+    int64_t pixels = 0;
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        uint8_t* row = counts->getAddr8(0, y);
+        for (int x = rect.fLeft; x < rect.fRight; ++x) {
+            pixels += row[x];
+        }
+        memset(row + rect.fLeft, 0, rect.width());
+    }
+    return pixels;
+}
+
+}  // namespace
+
+namespace sk_tools {
+
+OverdrawAnalysis analyzeOverdraw(const SkPicture& picture) {
+    OverdrawAnalysis analysis;
+    const SkRect cull = picture.cullRect();
+    const SkIRect area = cull.roundOut();
+    if (area.isEmpty()) {
+        return analysis;
+    }
+    analysis.fWidth  = area.width();
+    analysis.fHeight = area.height();
+
+    // Nested pictures and drawables are unrolled, so every op is drawn through the canvas here.
+    SkRecord record;
+    SkRecorder recorder(&record, cull);
+    recorder.reset(&record, cull, SkRecorder::Playback_DrawPictureMode);
+    picture.playback(&recorder);
+
+    SkAutoTMalloc<SkRect> bounds(record.count());
+    SkRecordFillBounds(cull, record, bounds);
+
+    SkBitmap counts;
+    counts.allocPixels(SkImageInfo::MakeA8(area.width(), area.height()));
+    counts.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas target(counts);
+    SkOverdrawCanvas canvas(&target);
+    canvas.translate(-area.fLeft, -area.fTop);
+    SkRecords::Draw draw(&canvas, nullptr, nullptr, 0);
+
+    const SkIRect device = SkIRect::MakeWH(area.width(), area.height());
+    for (int i = 0; i < record.count(); ++i) {
+        OpInfo op;
+        record.visit(i, Inspect(&op));
+
+        SkIRect rect = bounds[i].roundOut().makeOffset(-area.fLeft, -area.fTop);
+        if (!rect.intersect(device)) {
+            rect.setEmpty();
+        }
+
+        int64_t pixels = 0;
+        if (op.fLayer) {
+            canvas.save();
+            pixels = (int64_t)rect.width() * rect.height();
+        } else {
+            record.visit(i, draw);
+            if (op.fDraws) {
+                pixels = take_pixels(&counts, rect);
+            }
+        }
+        if (0 == pixels) {
+            continue;
+        }
+
+        const double cost = pixels * pixel_cost(op);
+        const char* paint = paint_name(op);
+        analysis.fOps.push_back({i, op.fName, paint, pixels, cost});
+        analysis.fPixels += pixels;
+        analysis.fCost   += cost;
+
+        auto same = [paint](const OverdrawAnalysis::Paint& p) { return !strcmp(p.fName, paint); };
+        auto it = std::find_if(analysis.fPaints.begin(), analysis.fPaints.end(), same);
+        if (it == analysis.fPaints.end()) {
+            analysis.fPaints.push_back({paint, 1, pixels, cost});
+        } else {
+            it->fOps    += 1;
+            it->fPixels += pixels;
+            it->fCost   += cost;
+        }
+    }
+
+    auto costlier = [](const auto& a, const auto& b) { return a.fCost > b.fCost; };
+    std::stable_sort(analysis.fOps.begin(), analysis.fOps.end(), costlier);
+    std::stable_sort(analysis.fPaints.begin(), analysis.fPaints.end(), costlier);
+    return analysis;
+}
+
+void writeOverdrawJSON(const OverdrawAnalysis& analysis, int topCount, SkWStream* stream) {
+    SkJSONWriter writer(stream, SkJSONWriter::Mode::kPretty);
+    writer.beginObject();
+    writer.appendS32("width", analysis.fWidth);
+    writer.appendS32("height", analysis.fHeight);
+    writer.appendS64("pixels", analysis.fPixels);
+    const int64_t area = (int64_t)analysis.fWidth * analysis.fHeight;
+    writer.appendDouble("overdraw", area ? (double)analysis.fPixels / area : 0);
+    writer.appendDouble("cost", analysis.fCost);
+
+    writer.beginArray("ops");
+    const int count = SkTMin(topCount, SkToInt(analysis.fOps.size()));
+    for (int i = 0; i < count; ++i) {
+        const OverdrawAnalysis::Op& op = analysis.fOps[i];
+        writer.beginObject(nullptr, false);
+        writer.appendS32("index", op.fIndex);
+        writer.appendString("op", op.fName);
+        writer.appendString("paint", op.fPaint);
+        writer.appendS64("pixels", op.fPixels);
+        writer.appendDouble("cost", op.fCost);
+        writer.endObject();
+    }
+    writer.endArray();
+
+    writer.beginArray("paints");
+    for (const OverdrawAnalysis::Paint& paint : analysis.fPaints) {
+        writer.beginObject(nullptr, false);
+        writer.appendString("paint", paint.fName);
+        writer.appendS32("ops", paint.fOps);
+        writer.appendS64("pixels", paint.fPixels);
+        writer.appendDouble("cost", paint.fCost);
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+}  // namespace sk_tools
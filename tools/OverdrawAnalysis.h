@@ -0,0 +1,60 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef OverdrawAnalysis_DEFINED
+#define OverdrawAnalysis_DEFINED
+
+#include "SkTypes.h"
+
+#include <vector>
+
+class SkPicture;
+class SkWStream;
+
+namespace sk_tools {
+
+/**
+ *  Where a picture's fill rate goes.  Each op of the picture is drawn on its own into an
+ *  SkOverdrawCanvas, and charged with the pixels it touched and an estimate of the cost of
+ *  blending them, in units of an opaque solid color write.
+ *
+ *  Layers are drawn as if their ops went straight to the surface; each saveLayer is charged
+ *  instead with compositing the layer over its bounds when it's restored.
+ */
+struct OverdrawAnalysis {
+    struct Op {
+        int         fIndex;     // Of the op in the picture, with nested pictures unrolled.
+        const char* fName;      // "DrawRect", "SaveLayer", ...
+        const char* fPaint;     // "color", "image", "layer", or the type of the paint's shader.
+        int64_t     fPixels;
+        double      fCost;
+    };
+    struct Paint {
+        const char* fName;      // As Op::fPaint.
+        int         fOps;
+        int64_t     fPixels;
+        double      fCost;
+    };
+
+    int                fWidth  = 0;
+    int                fHeight = 0;
+    int64_t            fPixels = 0;
+    double             fCost   = 0;
+    std::vector<Op>    fOps;     // Ops that touched pixels, most costly first.
+    std::vector<Paint> fPaints;  // Most costly first.
+};
+
+OverdrawAnalysis analyzeOverdraw(const SkPicture&);
+
+/**
+ *  Writes the totals, the topCount most costly ops and the cost of each kind of paint as JSON.
+ */
+void writeOverdrawJSON(const OverdrawAnalysis&, int topCount, SkWStream*);
+
+}  // namespace sk_tools
+
+#endif  // OverdrawAnalysis_DEFINED
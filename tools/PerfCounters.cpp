@@ -0,0 +1,112 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "PerfCounters.h"
+
+#if defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID)
+    #include <linux/perf_event.h>
+    #include <string.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+    static int open_counter(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        // Kernels commonly only let unprivileged users count their own code.
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return (int)syscall(__NR_perf_event_open, &attr, 0/*this thread*/, -1/*any cpu*/,
+                            -1/*no group*/, 0/*flags*/);
+    }
+
+    sk_tools::PerfCounters::PerfCounters() {
+        static const struct { uint32_t type; uint64_t config; } kEvents[kCounterCount] = {
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+            { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+        };
+        for (int i = 0; i < kCounterCount; i++) {
+            fFDs[i] = open_counter(kEvents[i].type, kEvents[i].config);
+            fValues[i] = -1;
+        }
+    }
+
+    sk_tools::PerfCounters::~PerfCounters() {
+        for (int fd : fFDs) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    void sk_tools::PerfCounters::start() {
+        for (int fd : fFDs) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    void sk_tools::PerfCounters::stop() {
+        for (int i = 0; i < kCounterCount; i++) {
+            fValues[i] = -1;
+            if (fFDs[i] < 0) {
+                continue;
+            }
+            ioctl(fFDs[i], PERF_EVENT_IOC_DISABLE, 0);
+            // value, time enabled, time running
+            uint64_t counts[3];
+            if (read(fFDs[i], counts, sizeof(counts)) == sizeof(counts)) {
+                fValues[i] = counts[2] ? (double)counts[0] * counts[1] / counts[2] : 0;
+            }
+        }
+    }
+#else
+    sk_tools::PerfCounters::PerfCounters() {
+        for (int i = 0; i < kCounterCount; i++) {
+            fFDs[i] = -1;
+            fValues[i] = -1;
+        }
+    }
+    sk_tools::PerfCounters::~PerfCounters() {}
+    void sk_tools::PerfCounters::start() {}
+    void sk_tools::PerfCounters::stop() {}
+#endif
+
+const char* sk_tools::PerfCounters::Name(Counter counter) {
+    static const char* kNames[kCounterCount] = {
+        "cycles",
+        "instructions",
+        "cache_misses",
+        "branch_misses",
+        "context_switches",
+    };
+    return kNames[counter];
+}
+
+bool sk_tools::PerfCounters::isValid() const {
+    for (int fd : fFDs) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double sk_tools::PerfCounters::value(Counter counter) const {
+    return fValues[counter];
+}
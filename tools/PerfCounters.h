@@ -0,0 +1,59 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef PerfCounters_DEFINED
+#define PerfCounters_DEFINED
+
+#include "SkTypes.h"
+
+namespace sk_tools {
+
+/**
+ *  PerfCounters - Hardware (and a few software) performance counters for the calling thread and
+ *  any threads it starts while counting.  Implemented with perf_event_open() on Linux and
+ *  Android; elsewhere, or where the kernel doesn't allow it, no counters are available.
+ */
+class PerfCounters : SkNoncopyable {
+public:
+    enum Counter {
+        kCycles,
+        kInstructions,
+        kCacheMisses,
+        kBranchMisses,
+        kContextSwitches,
+
+        kLast_Counter = kContextSwitches,
+    };
+    static constexpr int kCounterCount = kLast_Counter + 1;
+
+    // A name for the counter, suitable as a results key, e.g. "cache_misses".
+    static const char* Name(Counter);
+
+    PerfCounters();
+    ~PerfCounters();
+
+    // Are any of the counters available?
+    bool isValid() const;
+
+    // Zero the counters and start counting.
+    void start();
+
+    // Stop counting.  The counts can be read with value() until the next start().
+    void stop();
+
+    // The count since start(), scaled up if the kernel had to share the hardware counters with
+    // other events and only counted part of the time, or -1 if this counter is unavailable.
+    double value(Counter) const;
+
+private:
+    int    fFDs[kCounterCount];
+    double fValues[kCounterCount];
+};
+
+}  // namespace sk_tools
+
+#endif  // PerfCounters_DEFINED
@@ -0,0 +1,198 @@
+#!/usr/bin/env python
+#
+# Copyright 2018 Google Inc.
+#
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+"""Compares the timings in two dm.json files written by dm --timings.
+
+For each src/sink pair run in both, compares the draw times with a
+Mann-Whitney U test, and reports those that changed significantly and by
+more than --threshold, along with any whose peak heap growth changed by more
+than --threshold.  For each config, also reports the geometric mean change of
+the median times, and whether more srcs got slower than faster than chance
+would explain (a sign test), which catches regressions spread too thin to see
+in any one src, even when each was drawn only once.
+
+Exits with 1 if any src or config got significantly slower, or any src used
+more memory.
+
+Usage: compare_dm_timings.py before/dm.json after/dm.json
+"""
+
+import argparse
+import itertools
+import json
+import math
+import sys
+
+
+def load_timings(path):
+  """Returns {(config, source_type, source_options, name): timing} from path."""
+  with open(path) as f:
+    root = json.load(f)
+  timings = {}
+  for timing in root.get('timings', []):
+    key = timing['key']
+    timings[(key['config'], key['source_type'], key.get('source_options', ''),
+             key['name'])] = timing
+  return timings
+
+
+def median(values):
+  values = sorted(values)
+  mid = len(values) // 2
+  if len(values) % 2:
+    return values[mid]
+  return 0.5 * (values[mid - 1] + values[mid])
+
+
+def ranks(values):
+  """Returns the rank of each of values, averaging the ranks of ties."""
+  order = sorted(range(len(values)), key=lambda i: values[i])
+  result = [0.0] * len(values)
+  i = 0
+  while i < len(order):
+    j = i
+    while j + 1 < len(order) and values[order[j + 1]] == values[order[i]]:
+      j += 1
+    for k in range(i, j + 1):
+      result[order[k]] = 0.5 * (i + j) + 1
+    i = j + 1
+  return result
+
+
+# Peak heap growth smaller than this is noise, e.g. a cache's first entry.
+MIN_HEAP_GROWTH = 4096
+
+# Past this many ways to split the samples, use the normal approximation.
+MAX_EXACT_SPLITS = 20000
+
+
+def mann_whitney_p(a, b):
+  """Returns the two-sided p-value of a Mann-Whitney U test of a against b."""
+  n, m = len(a), len(b)
+  r = ranks(list(a) + list(b))
+  mean = 0.5 * n * (n + m + 1)
+  observed = abs(sum(r[:n]) - mean)
+
+  splits = math.factorial(n + m) // (math.factorial(n) * math.factorial(m))
+  if splits <= MAX_EXACT_SPLITS:
+    # Count the ways of splitting the ranks that are at least as extreme.
+    extreme = sum(1 for c in itertools.combinations(r, n)
+                  if abs(sum(c) - mean) >= observed - 1e-9)
+    return float(extreme) / splits
+
+  ties = {}
+  for rank in r:
+    ties[rank] = ties.get(rank, 0) + 1
+  tie_term = (sum(t ** 3 - t for t in ties.values()) /
+              float((n + m) * (n + m - 1)))
+  variance = n * m / 12.0 * ((n + m + 1) - tie_term)
+  if variance <= 0:
+    return 1.0
+  z = (observed - 0.5) / math.sqrt(variance)
+  return math.erfc(max(z, 0) / math.sqrt(2))
+
+
+def sign_test_p(worse, better):
+  """Returns the two-sided p-value of seeing worse vs. better by chance."""
+  n = worse + better
+  if n == 0:
+    return 1.0
+  k = max(worse, better)
+  tail = sum(math.factorial(n) // (math.factorial(i) * math.factorial(n - i))
+             for i in range(k, n + 1))
+  return min(1.0, 2.0 * tail / 2 ** n)
+
+
+def main():
+  parser = argparse.ArgumentParser(
+      description='Compares the timings in two dm.json files.')
+  parser.add_argument('before', help='dm.json from the baseline run')
+  parser.add_argument('after', help='dm.json from the run to check')
+  parser.add_argument('--threshold', type=float, default=0.1,
+                      help='ignore changes smaller than this fraction')
+  parser.add_argument('--config_threshold', type=float, default=0.02,
+                      help='ignore geometric mean changes in a config '
+                           'smaller than this fraction')
+  parser.add_argument('--alpha', type=float, default=0.05,
+                      help='significance level of the tests')
+  parser.add_argument('--min_ms', type=float, default=0.5,
+                      help='ignore srcs drawing faster than this')
+  args = parser.parse_args()
+
+  before = load_timings(args.before)
+  after = load_timings(args.after)
+  keys = sorted(set(before) & set(after))
+  if not keys:
+    print('No timings in common; run both with dm --timings N.')
+    return 1
+
+  worse, better, memory = [], [], []
+  configs = {}
+  for key in keys:
+    a, b = before[key]['ms'], after[key]['ms']
+    if not a or not b:
+      continue
+
+    a_heap = before[key].get('peak_heap_bytes', 0)
+    b_heap = after[key].get('peak_heap_bytes', 0)
+    if (b_heap > a_heap * (1 + args.threshold) and
+        b_heap - a_heap > MIN_HEAP_GROWTH):
+      memory.append((float(b_heap) / max(a_heap, 1), key, a_heap, b_heap))
+
+    a_med, b_med = median(a), median(b)
+    if max(a_med, b_med) < args.min_ms:
+      continue
+    ratio = b_med / max(a_med, 1e-6)
+    config = configs.setdefault(key[0], [0.0, 0, 0, 0])
+    config[0] += math.log(max(ratio, 1e-6))
+    config[1] += 1
+    if ratio > 1:
+      config[2] += 1
+    elif ratio < 1:
+      config[3] += 1
+
+    if abs(ratio - 1) <= args.threshold:
+      continue
+    p = mann_whitney_p(a, b)
+    if p < args.alpha:
+      (worse if ratio > 1 else better).append((ratio, key, a_med, b_med, p))
+
+  def describe(key):
+    return ' '.join(k for k in key if k)
+
+  print('%d src/sink pairs timed in both runs.' % len(keys))
+  for label, changes in (('slower', worse), ('faster', better)):
+    if changes:
+      print('\n%d got significantly %s:' % (len(changes), label))
+      for ratio, key, a_med, b_med, p in sorted(changes, reverse=True):
+        print('  %-60s %9.3fms -> %9.3fms  %+6.1f%%  p=%.3g' % (
+            describe(key), a_med, b_med, (ratio - 1) * 100, p))
+  if memory:
+    print('\n%d used more peak heap:' % len(memory))
+    for ratio, key, a_heap, b_heap in sorted(memory, reverse=True):
+      print('  %-60s %10d -> %10d bytes  %+6.1f%%' % (
+          describe(key), a_heap, b_heap, (ratio - 1) * 100))
+
+  print('\n%-12s %6s %8s %7s %7s %9s' % (
+      'config', 'srcs', 'geomean', 'slower', 'faster', 'sign p'))
+  regressed = bool(worse or memory)
+  for name in sorted(configs):
+    total, count, slower, faster = configs[name]
+    change = math.exp(total / count) - 1
+    p = sign_test_p(slower, faster)
+    flag = ''
+    if p < args.alpha and change > args.config_threshold:
+      flag = '  <- regressed'
+      regressed = True
+    print('%-12s %6d %+7.1f%% %7d %7d %9.3g%s' % (
+        name, count, change * 100, slower, faster, p, flag))
+
+  return 1 if regressed else 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -12,18 +12,35 @@
 #include "SkPicture.h"
 #include "SkRectPriv.h"
 #include "SkTextBlob.h"
+#include "SkTime.h"
 #include "SkClipOpPriv.h"
 
 #if SK_SUPPORT_GPU
+#include "GpuTimer.h"
 #include "GrAuditTrail.h"
 #include "GrContext.h"
 #include "GrRenderTargetContext.h"
+#include "TestContext.h"
 #endif
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #define SKDEBUGCANVAS_VERSION                     1
 #define SKDEBUGCANVAS_ATTRIBUTE_VERSION           "version"
 #define SKDEBUGCANVAS_ATTRIBUTE_COMMANDS          "commands"
 #define SKDEBUGCANVAS_ATTRIBUTE_AUDITTRAIL        "auditTrail"
+#define SKDEBUGCANVAS_ATTRIBUTE_COMMAND           "command"
+#define SKDEBUGCANVAS_ATTRIBUTE_CPUMS             "cpuMs"
+#define SKDEBUGCANVAS_ATTRIBUTE_GPUMS             "gpuMs"
+#define SKDEBUGCANVAS_ATTRIBUTE_TOTALCPUMS        "totalCpuMs"
+#define SKDEBUGCANVAS_ATTRIBUTE_TOTALGPUMS        "totalGpuMs"
+#define SKDEBUGCANVAS_ATTRIBUTE_HOTSPOTS          "hotspots"
+#define SKDEBUGCANVAS_ATTRIBUTE_HOTSPOTSBY        "hotspotsBy"
+
+// toJSONOpTimes() keeps the fastest of this many times for each command.
+static constexpr int kOpTimingRuns = 3;
 
 class DebugPaintFilterCanvas : public SkPaintFilterCanvas {
 public:
@@ -309,6 +326,113 @@ Json::Value SkDebugCanvas::toJSONOpList(int n, SkCanvas* canvas) {
     return parsedFromString;
 }
 
+Json::Value SkDebugCanvas::toJSONOpTimes(int n, SkCanvas* canvas,
+                                         sk_gpu_test::TestContext* testContext) {
+    const int count = SkTMin(n + 1, this->getSize());
+    const double kUntimed = std::numeric_limits<double>::infinity();
+    std::vector<double> cpuMs(count, kUntimed), gpuMs(count, kUntimed);
+
+#if SK_SUPPORT_GPU
+    sk_gpu_test::GpuTimer* gpuTimer = nullptr;
+    if (testContext && testContext->gpuTimingSupport() && canvas->getGrContext()) {
+        gpuTimer = testContext->gpuTimer();
+    }
+    std::vector<std::pair<int, sk_gpu_test::PlatformTimerQuery>> queries;
+#endif
+
+    for (int run = 0; run < kOpTimingRuns; run++) {
+        int saveCount = canvas->save();
+        canvas->resetMatrix();
+        canvas->clear(SK_ColorWHITE);
+        canvas->flush();
+        for (int i = 0; i < count; i++) {
+            if (!fCommandVector[i]->isVisible()) {
+                continue;
+            }
+#if SK_SUPPORT_GPU
+            if (gpuTimer) {
+                gpuTimer->queueStart();
+            }
+#endif
+            // Flushing makes the GPU backend do the work of this command, and only this command.
+            const double startNs = SkTime::GetNSecs();
+            fCommandVector[i]->execute(canvas);
+            canvas->flush();
+            cpuMs[i] = SkTMin(cpuMs[i], (SkTime::GetNSecs() - startNs) * 1e-6);
+#if SK_SUPPORT_GPU
+            if (gpuTimer) {
+                queries.emplace_back(i, gpuTimer->queueStop());
+            }
+#endif
+        }
+        canvas->restoreToCount(saveCount);
+    }
+
+    bool timedGpu = false;
+#if SK_SUPPORT_GPU
+    if (gpuTimer) {
+        testContext->finish();
+        for (const auto& query : queries) {
+            // Disjoint timings (e.g. the GPU changed clock speed) are discarded.
+            if (gpuTimer->checkQueryStatus(query.second) ==
+                    sk_gpu_test::GpuTimer::QueryStatus::kAccurate) {
+                double ms = gpuTimer->getTimeElapsed(query.second).count() * 1e-6;
+                gpuMs[query.first] = SkTMin(gpuMs[query.first], ms);
+                timedGpu = true;
+            }
+            gpuTimer->deleteQuery(query.second);
+        }
+    }
+#endif
+
+    Json::Value result = Json::Value(Json::objectValue);
+    Json::Value commands = Json::Value(Json::arrayValue);
+    double totalCpuMs = 0, totalGpuMs = 0;
+    for (int i = 0; i < count; i++) {
+        Json::Value command = Json::Value(Json::objectValue);
+        command[SKDEBUGCANVAS_ATTRIBUTE_COMMAND] =
+                SkDrawCommand::GetCommandString(fCommandVector[i]->getType());
+        if (cpuMs[i] != kUntimed) {
+            command[SKDEBUGCANVAS_ATTRIBUTE_CPUMS] = cpuMs[i];
+            totalCpuMs += cpuMs[i];
+        }
+        if (gpuMs[i] != kUntimed) {
+            command[SKDEBUGCANVAS_ATTRIBUTE_GPUMS] = gpuMs[i];
+            totalGpuMs += gpuMs[i];
+        }
+        commands[i] = command;
+    }
+    result[SKDEBUGCANVAS_ATTRIBUTE_COMMANDS] = commands;
+    result[SKDEBUGCANVAS_ATTRIBUTE_TOTALCPUMS] = totalCpuMs;
+    if (timedGpu) {
+        result[SKDEBUGCANVAS_ATTRIBUTE_TOTALGPUMS] = totalGpuMs;
+    }
+
+    // The hotspots are ranked by GPU time when we have it; that's usually what a slow SKP is
+    // waiting on.
+    const std::vector<double>& ms = timedGpu ? gpuMs : cpuMs;
+    const double total = timedGpu ? totalGpuMs : totalCpuMs;
+    std::vector<int> order;
+    for (int i = 0; i < count; i++) {
+        if (ms[i] != kUntimed) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return ms[a] > ms[b]; });
+    Json::Value hotspots = Json::Value(Json::arrayValue);
+    double sum = 0;
+    for (int i : order) {
+        if (sum >= 0.8 * total) {
+            break;
+        }
+        hotspots.append(i);
+        sum += ms[i];
+    }
+    result[SKDEBUGCANVAS_ATTRIBUTE_HOTSPOTS] = hotspots;
+    result[SKDEBUGCANVAS_ATTRIBUTE_HOTSPOTSBY] = timedGpu ? "gpu" : "cpu";
+    return result;
+}
+
 void SkDebugCanvas::setOverdrawViz(bool overdrawViz) {
     fOverdrawViz = overdrawViz;
 }
@@ -21,6 +21,7 @@
 class GrAuditTrail;
 class SkNWayCanvas;
 class SkPicture;
+namespace sk_gpu_test { class TestContext; }
 
 class SkDebugCanvas : public SkCanvas {
 public:
@@ -106,6 +107,15 @@ public:
 
     Json::Value toJSONOpList(int n, SkCanvas*);
 
+    /**
+        Returns a JSON object with the time each of the commands up to the Nth took to draw into
+        the canvas, on the CPU (including flushing it) and, if testContext is given and can time
+        the GPU, on the GPU. Each command's time is the best of a few runs, so it's about the
+        command and not whatever else the machine was doing. The JSON also lists the fewest
+        commands that together took 80% of the total, slowest first.
+     */
+    Json::Value toJSONOpTimes(int n, SkCanvas*, sk_gpu_test::TestContext* testContext = nullptr);
+
     void detachCommands(SkTDArray<SkDrawCommand*>* dst) {
         fCommandVector.swap(*dst);
     }
@@ -77,6 +77,8 @@ public:
 
     virtual ~SkDrawCommand() {}
 
+    OpType getType() const { return fOpType; }
+
     bool isVisible() const {
         return fVisible;
     }
@@ -101,6 +101,17 @@ DEFINE_bool(deltaAA, kDefaultDeltaAA,
 
 DEFINE_bool(forceDeltaAA, false, "Force delta anti-aliasing for all paths.");
 
+DEFINE_int32(daaBandEdges, 0, "If > 0, delta anti-aliasing splits paths with more edges than this "
+                              "into horizontal bands and generates their deltas in parallel.");
+
+DEFINE_int32(blurDownsampleSigma, 0, "If > 0, raster blurs with at least this sigma run at reduced "
+                                    "resolution. See gSkRasterBlurDownsampleSigma.");
+
+DEFINE_bool(aaCostModel, false, "If true, pick the cheapest AA scan converter for each path using "
+                                "the cost model in SkAACostModel.h.");
+DEFINE_string(aaCostCoefficients, "", "Comma-separated SkAACostModel coefficients to use instead "
+                                      "of the defaults, as printed by nanobench --calibrateAACost.");
+
 DEFINE_int32(backendTiles, 3, "Number of tiles in the experimental threaded backend.");
 DEFINE_int32(backendThreads, 2, "Number of threads in the experimental threaded backend.");
 
@@ -161,18 +172,34 @@ DEFINE_bool(cachePathMasks, true, "Allows path mask textures to be cached in GPU
 
 DEFINE_bool(noGS, false, "Disables support for geometry shaders.");
 
+DEFINE_bool(batchMips, false, "Regenerates dirty mips of all sampled textures at the start of "
+                              "each flush.");
+
+DEFINE_bool(deferYUV, false, "Uploads the planes of YUV decoded images at flush time.");
+
 DEFINE_string(pr, "default",
               "Set of enabled gpu path renderers. Defined as a list of: "
               "[~]all [~]default [~]dashline [~]nvpr [~]aaconvex "
               "[~]aalinearizing [~]small [~]tess]");
 
+DEFINE_string(uniformKeyBits, "",
+              "Program key bits to express as uniforms instead. Defined as a list of: "
+              "all identityViewMatrix solidCoverage");
+
+DEFINE_bool(analyzeProgramKeys, false, "Records which program key bits change the generated "
+                                       "SkSL.");
+
 void SetCtxOptionsFromCommonFlags(GrContextOptions* ctxOptions) {
     static std::unique_ptr<SkExecutor> gGpuExecutor = (0 != FLAGS_gpuThreads)
         ? SkExecutor::MakeFIFOThreadPool(FLAGS_gpuThreads) : nullptr;
     ctxOptions->fExecutor = gGpuExecutor.get();
     ctxOptions->fAllowPathMaskCaching = FLAGS_cachePathMasks;
     ctxOptions->fSuppressGeometryShaders = FLAGS_noGS;
+    ctxOptions->fBatchMipMapRegeneration = FLAGS_batchMips;
+    ctxOptions->fDeferYUVPlaneUploads = FLAGS_deferYUV;
     ctxOptions->fGpuPathRenderers = CollectGpuPathRenderersFromFlags();
+    ctxOptions->fUniformKeyBits = CollectUniformKeyBitsFromFlags();
+    ctxOptions->fAnalyzeProgramKeys = FLAGS_analyzeProgramKeys;
     ctxOptions->fDisableDriverCorrectnessWorkarounds = FLAGS_disableDriverCorrectnessWorkarounds;
 }
 
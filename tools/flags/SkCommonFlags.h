@@ -39,6 +39,10 @@ DECLARE_bool(analyticAA);
 DECLARE_bool(forceAnalyticAA);
 DECLARE_bool(deltaAA);
 DECLARE_bool(forceDeltaAA);
+DECLARE_int32(daaBandEdges);
+DECLARE_int32(blurDownsampleSigma);
+DECLARE_bool(aaCostModel);
+DECLARE_string(aaCostCoefficients);
 DECLARE_string(key);
 DECLARE_string(properties);
 DECLARE_int32(backendTiles);
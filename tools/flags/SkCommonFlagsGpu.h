@@ -17,7 +17,11 @@
 DECLARE_int32(gpuThreads);
 DECLARE_bool(cachePathMasks);
 DECLARE_bool(noGS);
+DECLARE_bool(batchMips);
+DECLARE_bool(deferYUV);
 DECLARE_string(pr);
+DECLARE_string(uniformKeyBits);
+DECLARE_bool(analyzeProgramKeys);
 
 inline GpuPathRenderers get_named_pathrenderers_flags(const char* name) {
     if (!strcmp(name, "all")) {
@@ -62,6 +66,26 @@ inline GpuPathRenderers CollectGpuPathRenderersFromFlags() {
     return gpuPathRenderers;
 }
 
+inline GrUniformKeyBits get_named_uniformkeybits_flags(const char* name) {
+    if (!strcmp(name, "all")) {
+        return GrUniformKeyBits::kAll;
+    } else if (!strcmp(name, "identityViewMatrix")) {
+        return GrUniformKeyBits::kIdentityViewMatrix;
+    } else if (!strcmp(name, "solidCoverage")) {
+        return GrUniformKeyBits::kSolidCoverage;
+    }
+    SK_ABORT(SkStringPrintf("error: unknown uniform key bits \"%s\"\n", name).c_str());
+    return GrUniformKeyBits::kNone;
+}
+
+inline GrUniformKeyBits CollectUniformKeyBitsFromFlags() {
+    GrUniformKeyBits uniformKeyBits = GrUniformKeyBits::kNone;
+    for (int i = 0; i < FLAGS_uniformKeyBits.count(); ++i) {
+        uniformKeyBits |= get_named_uniformkeybits_flags(FLAGS_uniformKeyBits[i]);
+    }
+    return uniformKeyBits;
+}
+
 /**
  *  Helper to set GrContextOptions from common GPU flags.
  */
@@ -14,6 +14,7 @@
 #include "GrDrawingManager.h"
 #include "GrGpu.h"
 #include "GrGpuResourceCacheAccess.h"
+#include "GrProgramKeyAnalysis.h"
 #include "GrRenderTargetContext.h"
 #include "GrRenderTargetContextPriv.h"
 #include "GrRenderTargetProxy.h"
@@ -124,6 +125,12 @@ void GrContextPriv::printGpuStats() const {
     SkDebugf("%s", out.c_str());
 }
 
+void GrContextPriv::dumpProgramKeyAnalysis(SkString* out) const {
+    if (fContext->fProgramKeyAnalysis) {
+        fContext->fProgramKeyAnalysis->dump(out);
+    }
+}
+
 sk_sp<SkImage> GrContextPriv::getFontAtlasImage_ForTesting(GrMaskFormat format, unsigned int index) {
     auto atlasManager = this->getAtlasManager();
     if (!atlasManager) {
@@ -151,6 +158,11 @@ void GrGpu::Stats::dump(SkString* out) {
     out->appendf("Transfers to Texture: %d\n", fTransfersToTexture);
     out->appendf("Stencil Buffer Creates: %d\n", fStencilAttachmentCreates);
     out->appendf("Number of draws: %d\n", fNumDraws);
+    out->appendf("Tessellations: %d (%.3f ms)\n", fTessellations, fTessellationMs);
+    out->appendf("Tessellation Cache Hits: %d\n", fTessellationCacheHits);
+    out->appendf("Mip Map Regenerations: %d (%d batched)\n", fMipMapRegenerations,
+                 fBatchedMipMapRegenerations);
+    out->appendf("Redundant State Calls Avoided: %d\n", fRedundantStateCallsAvoided);
 }
 
 void GrGpu::Stats::dumpKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>* values) {
@@ -159,6 +171,14 @@ void GrGpu::Stats::dumpKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>*
     keys->push_back(SkString("texture_uploads")); values->push_back(fTextureUploads);
     keys->push_back(SkString("number_of_draws")); values->push_back(fNumDraws);
     keys->push_back(SkString("number_of_failed_draws")); values->push_back(fNumFailedDraws);
+    keys->push_back(SkString("tessellations")); values->push_back(fTessellations);
+    keys->push_back(SkString("tessellation_ms")); values->push_back(fTessellationMs);
+    keys->push_back(SkString("tessellation_cache_hits")); values->push_back(fTessellationCacheHits);
+    keys->push_back(SkString("mipmap_regenerations")); values->push_back(fMipMapRegenerations);
+    keys->push_back(SkString("batched_mipmap_regenerations"));
+    values->push_back(fBatchedMipMapRegenerations);
+    keys->push_back(SkString("redundant_state_calls_avoided"));
+    values->push_back(fRedundantStateCallsAvoided);
 }
 
 #endif
@@ -130,6 +130,22 @@ GrContext* Request::getContext() {
 #endif
 }
 
+sk_gpu_test::TestContext* Request::getTestContext() {
+#if SK_SUPPORT_GPU
+    GrContextFactory* factory = fContextFactory;
+    sk_gpu_test::TestContext* result =
+            factory->getContextInfo(GrContextFactory::kGL_ContextType,
+                                    GrContextFactory::ContextOverrides::kNone).testContext();
+    if (!result) {
+        result = factory->getContextInfo(GrContextFactory::kGLES_ContextType,
+                                         GrContextFactory::ContextOverrides::kNone).testContext();
+    }
+    return result;
+#else
+    return nullptr;
+#endif
+}
+
 SkIRect Request::getBounds() {
     SkIRect bounds;
     if (fPicture) {
@@ -271,6 +287,19 @@ sk_sp<SkData> Request::getJsonOpList(int n) {
     return stream.detachAsData();
 }
 
+sk_sp<SkData> Request::getJsonOpTimes(int n) {
+    SkCanvas* canvas = this->getCanvas();
+    sk_gpu_test::TestContext* testContext = fGPUEnabled ? this->getTestContext() : nullptr;
+
+    Json::Value result = fDebugCanvas->toJSONOpTimes(n, canvas, testContext);
+    result["mode"] = Json::Value(fGPUEnabled ? "gpu" : "cpu");
+
+    SkDynamicMemoryWStream stream;
+    stream.writeText(Json::FastWriter().write(result).c_str());
+
+    return stream.detachAsData();
+}
+
 sk_sp<SkData> Request::getJsonInfo(int n) {
     // drawTo
     sk_sp<SkSurface> surface(this->createCPUSurface());
@@ -23,6 +23,7 @@
 
 namespace sk_gpu_test {
 class GrContextFactory;
+class TestContext;
 }
 struct MHD_Connection;
 struct MHD_PostProcessor;
@@ -56,6 +57,10 @@ struct Request {
     // Returns a json list of ops as an SkData
     sk_sp<SkData> getJsonOpList(int n);
 
+    // Returns json with the time each op up to N takes to draw on the CPU, and on the GPU if it's
+    // enabled and can be timed
+    sk_sp<SkData> getJsonOpTimes(int n);
+
     // Returns json with the viewMatrix and clipRect
     sk_sp<SkData> getJsonInfo(int n);
 
@@ -73,6 +78,7 @@ private:
     SkSurface* createGPUSurface();
     SkIRect getBounds();
     GrContext* getContext();
+    sk_gpu_test::TestContext* getTestContext();
 
     sk_sp<SkPicture> fPicture;
     sk_gpu_test::GrContextFactory* fContextFactory;
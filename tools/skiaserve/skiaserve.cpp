@@ -43,6 +43,7 @@ public:
         fHandlers.push_back(new DataHandler);
         fHandlers.push_back(new BreakHandler);
         fHandlers.push_back(new OpsHandler);
+        fHandlers.push_back(new OpTimesHandler);
         fHandlers.push_back(new OpBoundsHandler);
         fHandlers.push_back(new ColorModeHandler);
         fHandlers.push_back(new QuitHandler);
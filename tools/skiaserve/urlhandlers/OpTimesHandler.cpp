@@ -0,0 +1,40 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "UrlHandler.h"
+
+#include "../Request.h"
+#include "../Response.h"
+#include "microhttpd.h"
+
+using namespace Response;
+
+bool OpTimesHandler::canHandle(const char* method, const char* url) {
+    const char* kBasePath = "/opTimes";
+    return 0 == strcmp(method, MHD_HTTP_METHOD_GET) &&
+           0 == strncmp(url, kBasePath, strlen(kBasePath));
+}
+
+int OpTimesHandler::handle(Request* request, MHD_Connection* connection, const char* url,
+                           const char* method, const char* upload_data, size_t* upload_data_size) {
+    SkTArray<SkString> commands;
+    SkStrSplit(url, "/", &commands);
+
+    if (!request->hasPicture() || commands.count() > 2) {
+        return MHD_NO;
+    }
+
+    // /opTimes or /opTimes/N
+    int n = request->getLastOp();
+    if (commands.count() == 2) {
+        sscanf(commands[1].c_str(), "%d", &n);
+        n = SkTPin(n, 0, request->getLastOp());
+    }
+
+    sk_sp<SkData> data(request->getJsonOpTimes(n));
+    return SendData(connection, data.get(), "application/json");
+}
@@ -124,6 +124,19 @@ public:
                const char* upload_data, size_t* upload_data_size) override;
 };
 
+/*
+ * Returns a json description of how long each command takes to draw on the CPU, and on the GPU
+ * when it's enabled, along with the commands taking the most of the time. /opTimes times all of
+ * the commands, /opTimes/N the commands up to N.
+ */
+class OpTimesHandler : public UrlHandler {
+public:
+    bool canHandle(const char* method, const char* url) override;
+    int handle(Request* request, MHD_Connection* connection,
+               const char* url, const char* method,
+               const char* upload_data, size_t* upload_data_size) override;
+};
+
 /*
  * Enables drawing of gpu op bounds
  */
@@ -7,8 +7,10 @@
 
 #include "GpuTimer.h"
 #include "GrContextFactory.h"
+#include "GrContextPriv.h"
 #include "SkGr.h"
 
+#include "PerfCounters.h"
 #include "SkCanvas.h"
 #include "SkCommonFlags.h"
 #include "SkCommonFlagsGpu.h"
@@ -50,6 +52,7 @@ DEFINE_string(skp, "", "path to a single .skp file, or 'warmup' for a builtin wa
 DEFINE_string(png, "", "if set, save a .png proof to disk at this file location");
 DEFINE_int32(verbosity, 4, "level of verbosity (0=none to 5=debug)");
 DEFINE_bool(suppressHeader, false, "don't print a header row before the results");
+DEFINE_bool(perfCounters, false, "print cpu performance counters per frame to stderr (Linux only)");
 
 static const char* header =
 "   accum    median       max       min   stddev  samples  sample_ms  clock  metric  config    bench";
@@ -222,6 +225,35 @@ void print_result(const std::vector<Sample>& samples, const char* config, const
     fflush(stdout);
 }
 
+// These go to stderr so skpbench.py passes them along without mistaking them for results.
+static void print_perf_counters(const sk_tools::PerfCounters& perfCounters,
+                                const std::vector<Sample>& samples) {
+    using sk_tools::PerfCounters;
+    if (!perfCounters.isValid()) {
+        fprintf(stderr, "WARNING: no performance counters are available.\n");
+        return;
+    }
+    // The warmup frames before the first sample are counted too, but there are only two.
+    int frames = 0;
+    for (const Sample& sample : samples) {
+        frames += sample.fFrames;
+    }
+    fprintf(stderr, "per frame:");
+    for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+        auto counter = (PerfCounters::Counter)c;
+        if (perfCounters.value(counter) >= 0) {
+            fprintf(stderr, "  %s %.4g", PerfCounters::Name(counter),
+                    perfCounters.value(counter) / frames);
+        }
+    }
+    double cycles = perfCounters.value(PerfCounters::kCycles),
+           instructions = perfCounters.value(PerfCounters::kInstructions);
+    if (cycles > 0 && instructions >= 0) {
+        fprintf(stderr, "  ipc %.2f", instructions / cycles);
+    }
+    fprintf(stderr, "\n");
+}
+
 int main(int argc, char** argv) {
     SkCommandLineFlags::SetUsage("Use skpbench.py instead. "
                                  "You usually don't want to use this program directly.");
@@ -338,6 +370,10 @@ int main(int argc, char** argv) {
     }
     SkCanvas* canvas = surface->getCanvas();
     canvas->translate(-skp->cullRect().x(), -skp->cullRect().y());
+    sk_tools::PerfCounters perfCounters;
+    if (FLAGS_perfCounters) {
+        perfCounters.start();
+    }
     if (!FLAGS_gpuClock) {
         run_benchmark(testCtx->fenceSync(), canvas, skp.get(), &samples);
     } else {
@@ -347,7 +383,19 @@ int main(int argc, char** argv) {
         run_gpu_time_benchmark(testCtx->gpuTimer(), testCtx->fenceSync(), canvas, skp.get(),
                                &samples);
     }
+    if (FLAGS_perfCounters) {
+        perfCounters.stop();
+    }
     print_result(samples, config->getTag().c_str(), skpname.c_str());
+    if (FLAGS_perfCounters) {
+        print_perf_counters(perfCounters, samples);
+    }
+
+    if (FLAGS_analyzeProgramKeys) {
+        SkString analysis;
+        ctx->contextPriv().dumpProgramKeyAnalysis(&analysis);
+        fprintf(stderr, "%s", analysis.c_str());
+    }
 
     // Save a proof (if one was requested).
     if (!FLAGS_png.isEmpty()) {
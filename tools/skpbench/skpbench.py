@@ -62,6 +62,9 @@ __argparse.add_argument('--pr',
        "[~]aalinearizing [~]small [~]tess]")
 __argparse.add_argument('--nocache',
   action='store_true', help="disable caching of path mask textures")
+__argparse.add_argument('--perf',
+  action='store_true',
+  help="also print cpu performance counters per frame (Linux only)")
 __argparse.add_argument('-c', '--config',
   default='gl', help="comma- or space-separated list of GPU configs")
 __argparse.add_argument('-a', '--resultsfile',
@@ -120,6 +123,8 @@ class SKPBench:
     ARGV.extend(['--pr'] + re.split(r'[ ,]', FLAGS.pr))
   if FLAGS.nocache:
     ARGV.extend(['--cachePathMasks', 'false'])
+  if FLAGS.perf:
+    ARGV.extend(['--perfCounters', 'true'])
   if FLAGS.adb:
     if FLAGS.device_serial is None:
       ARGV[:0] = [FLAGS.adb_binary, 'shell']
@@ -5,10 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "OverdrawAnalysis.h"
 #include "SkCommandLineFlags.h"
 #include "SkPicture.h"
 #include "SkPictureData.h"
 #include "SkPictureCommon.h"
+#include "SkRecord.h"
+#include "SkRecordOpts.h"
+#include "SkRecorder.h"
 #include "SkStream.h"
 #include "SkFontDescriptor.h"
 
@@ -18,6 +22,10 @@ DEFINE_bool2(cullRect, c, true, "cullRect");
 DEFINE_bool2(flags, f, true, "flags");
 DEFINE_bool2(tags, t, true, "tags");
 DEFINE_bool2(quiet, q, false, "quiet");
+DEFINE_bool2(optimize, o, false, "report how often each SkRecordOptimize2 pass applies");
+DEFINE_string(overdraw, "", "write the pixels each op and paint touches, and what they cost "
+                            "to blend, as JSON to this file");
+DEFINE_int32(overdrawOps, 20, "how many of the most costly ops --overdraw reports");
 
 // This tool can print simple information about an SKP but its main use
 // is just to check if an SKP has been truncated during the recording
@@ -30,6 +38,48 @@ static const int kInvalidTag = 3;
 static const int kMissingInput = 4;
 static const int kIOError = 5;
 
+// Re-records the picture and prints how many times each optimization pass changed the record.
+static void report_optimizations(const char* path) {
+    SkFILEStream stream(path);
+    sk_sp<SkPicture> pic = SkPicture::MakeFromStream(&stream);
+    if (!pic) {
+        SkDebugf("Couldn't load picture\n");
+        return;
+    }
+    SkRecord record;
+    SkRecorder recorder(&record, pic->cullRect());
+    pic->playback(&recorder);
+    int before = record.count();
+
+    SkRecordOptStats stats;
+    SkRecordOptimize2(&record, &stats);
+    SkDebugf("Ops: %d before, %d after optimization\n", before, record.count());
+    SkDebugf("  overwritten matrices:  %d\n", stats.fOverwrittenMatrices);
+    SkDebugf("  merged matrices:       %d\n", stats.fMergedMatrices);
+    SkDebugf("  noop save/restores:    %d\n", stats.fNoopSaveRestores);
+    SkDebugf("  clip-only save layers: %d\n", stats.fClipOnlySaveLayers);
+    SkDebugf("  save layer draws:      %d\n", stats.fSaveLayerDraws);
+    SkDebugf("  svg layers:            %d\n", stats.fSvgLayers);
+    SkDebugf("  occluded draws:        %d\n", stats.fOccludedDraws);
+    SkDebugf("  coalesced rects:       %d\n", stats.fCoalescedRects);
+}
+
+// Writes where the picture's fill rate goes, op by op and by paint, as JSON.
+static void report_overdraw(const char* path, const char* jsonPath) {
+    SkFILEStream stream(path);
+    sk_sp<SkPicture> pic = SkPicture::MakeFromStream(&stream);
+    if (!pic) {
+        SkDebugf("Couldn't load picture\n");
+        return;
+    }
+    SkFILEWStream json(jsonPath);
+    if (!json.isValid()) {
+        SkDebugf("Couldn't open %s\n", jsonPath);
+        return;
+    }
+    sk_tools::writeOverdrawJSON(sk_tools::analyzeOverdraw(*pic), FLAGS_overdrawOps, &json);
+}
+
 int main(int argc, char** argv) {
     SkCommandLineFlags::SetUsage("Prints information about an skp file");
     SkCommandLineFlags::Parse(argc, argv);
@@ -64,6 +114,12 @@ int main(int argc, char** argv) {
                  info.fCullRect.fLeft, info.fCullRect.fTop,
                  info.fCullRect.fRight, info.fCullRect.fBottom);
     }
+    if (FLAGS_optimize && !FLAGS_quiet) {
+        report_optimizations(FLAGS_input[0]);
+    }
+    if (!FLAGS_overdraw.isEmpty()) {
+        report_overdraw(FLAGS_input[0], FLAGS_overdraw[0]);
+    }
 
     if (!stream.readBool()) {
         // If we read true there's a picture playback object flattened
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "ProcStats.h"
+#include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkData.h"
+#include "SkExecutor.h"
+#include "SkGraphics.h"
+#include "SkImageEncoder.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkPicture.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTaskGroup.h"
+#include "SkTime.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Measures how fast a pool of threads can turn a corpus of SKPs into PNGs, the way a raster
+ * server would: each page is decoded from its file, played back into a raster surface, and
+ * encoded, all on one of the pool's threads, sharing Skia's global caches with the others.
+ *
+ * Reports throughput in pages per second, percentiles of the time each page took (and of each
+ * step of it), and memory use.
+ */
+
+DEFINE_string(skps, "skps", "Directories of .skp files and/or .skp files to rasterize.");
+DEFINE_int32(threads, 0, "Worker threads rasterizing pages at once; 0 means one per core.");
+DEFINE_int32(repeat, 3, "Rasterize the corpus this many times.");
+DEFINE_int32(maxSize, 2048, "Crop pages larger than this in either dimension.");
+DEFINE_string(writePath, "", "If set, write the PNGs here. Otherwise they're encoded and dropped.");
+
+namespace {
+
+struct Page {
+    SkString fPath;
+    double fDecodeMs = 0;
+    double fPlaybackMs = 0;
+    double fEncodeMs = 0;
+    bool fOK = false;
+
+    double totalMs() const { return fDecodeMs + fPlaybackMs + fEncodeMs; }
+};
+
+}  // namespace
+
+static double now_ms() { return SkTime::GetNSecs() * 1e-6; }
+
+static void collect_skps(const SkCommandLineFlags::StringArray& paths,
+                         std::vector<SkString>* skps) {
+    for (int i = 0; i < paths.count(); ++i) {
+        if (SkStrEndsWith(paths[i], ".skp")) {
+            skps->push_back(SkString(paths[i]));
+        } else {
+            SkOSFile::Iter it(paths[i], ".skp");
+            SkString path;
+            while (it.next(&path)) {
+                skps->push_back(SkOSPath::Join(paths[i], path.c_str()));
+            }
+        }
+    }
+}
+
+static void rasterize(Page* page, int index) {
+    double start = now_ms();
+    sk_sp<SkData> data = SkData::MakeFromFileName(page->fPath.c_str());
+    sk_sp<SkPicture> picture = data ? SkPicture::MakeFromData(data.get()) : nullptr;
+    double decoded = now_ms();
+    page->fDecodeMs = decoded - start;
+    if (!picture) {
+        SkDebugf("Couldn't read %s.\n", page->fPath.c_str());
+        return;
+    }
+
+    const SkRect cull = picture->cullRect();
+    int width  = SkTMin(SkScalarCeilToInt(cull.width()),  FLAGS_maxSize),
+        height = SkTMin(SkScalarCeilToInt(cull.height()), FLAGS_maxSize);
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(SkTMax(width, 1),
+                                                              SkTMax(height, 1));
+    if (!surface) {
+        SkDebugf("Couldn't make a %dx%d surface for %s.\n", width, height, page->fPath.c_str());
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    canvas->translate(-cull.x(), -cull.y());
+    canvas->drawPicture(picture);
+    double played = now_ms();
+    page->fPlaybackMs = played - decoded;
+
+    SkPixmap pixmap;
+    SkAssertResult(surface->peekPixels(&pixmap));
+    bool encoded;
+    if (!FLAGS_writePath.isEmpty()) {
+        SkString name = SkOSPath::Basename(page->fPath.c_str());
+        name.appendf(".%d.png", index);
+        SkFILEWStream file(SkOSPath::Join(FLAGS_writePath[0], name.c_str()).c_str());
+        encoded = SkEncodeImage(&file, pixmap, SkEncodedImageFormat::kPNG, 100);
+    } else {
+        SkDynamicMemoryWStream stream;
+        encoded = SkEncodeImage(&stream, pixmap, SkEncodedImageFormat::kPNG, 100);
+    }
+    page->fEncodeMs = now_ms() - played;
+    if (!encoded) {
+        SkDebugf("Couldn't encode %s.\n", page->fPath.c_str());
+        return;
+    }
+    page->fOK = true;
+}
+
+// Returns the value below which fraction of the sorted values fall.
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t i = SkTMin(sorted.size() - 1, (size_t)(fraction * sorted.size()));
+    return sorted[i];
+}
+
+template <typename Fn>
+static void print_percentiles(const char* label, const std::vector<Page>& pages, Fn&& ms) {
+    std::vector<double> values;
+    for (const Page& page : pages) {
+        if (page.fOK) {
+            values.push_back(ms(page));
+        }
+    }
+    std::sort(values.begin(), values.end());
+    SkDebugf("%-10s\t%8.2f\t%8.2f\t%8.2f\n",
+             label, percentile(values, 0.5), percentile(values, 0.99),
+             values.empty() ? 0.0 : values.back());
+}
+
+int main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Rasterizes SKPs to PNGs on a pool of threads, and reports "
+                                 "pages per second, latency, and memory use.");
+    SkCommandLineFlags::Parse(argc, argv);
+    SkGraphics::Init();
+
+    std::vector<SkString> skps;
+    collect_skps(FLAGS_skps, &skps);
+    if (skps.empty()) {
+        SkDebugf("No .skp files found in --skps.\n");
+        return 1;
+    }
+    if (!FLAGS_writePath.isEmpty() && !sk_mkdir(FLAGS_writePath[0])) {
+        SkDebugf("Couldn't create %s.\n", FLAGS_writePath[0]);
+        return 1;
+    }
+
+    std::vector<Page> pages(skps.size() * SkTMax(FLAGS_repeat, 1));
+    for (size_t i = 0; i < pages.size(); i++) {
+        pages[i].fPath = skps[i % skps.size()];
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(FLAGS_threads);
+    double start = now_ms();
+    {
+        SkTaskGroup tg(*executor);
+        tg.batch(SkToInt(pages.size()), [&](int i) { rasterize(&pages[i], i); });
+    }
+    double elapsedMs = now_ms() - start;
+
+    int ok = 0;
+    for (const Page& page : pages) {
+        ok += page.fOK;
+    }
+    SkDebugf("%d of %d pages from %d skps in %.2fs: %.2f pages/s\n",
+             ok, SkToInt(pages.size()), SkToInt(skps.size()), elapsedMs * 1e-3,
+             ok / (elapsedMs * 1e-3));
+    SkDebugf("%-10s\t%8s\t%8s\t%8s\n", "ms", "p50", "p99", "max");
+    print_percentiles("page",     pages, [](const Page& p) { return p.totalMs(); });
+    print_percentiles("decode",   pages, [](const Page& p) { return p.fDecodeMs; });
+    print_percentiles("playback", pages, [](const Page& p) { return p.fPlaybackMs; });
+    print_percentiles("encode",   pages, [](const Page& p) { return p.fEncodeMs; });
+    SkDebugf("%dMB RAM, %dMB peak\n",
+             sk_tools::getCurrResidentSetSizeMB(), sk_tools::getMaxResidentSetSizeMB());
+
+    return ok == SkToInt(pages.size()) ? 0 : 1;
+}
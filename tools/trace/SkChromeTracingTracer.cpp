@@ -152,39 +152,6 @@ void SkChromeTracingTracer::updateTraceEventDuration(const uint8_t* categoryEnab
     traceEvent->fClockEnd = std::chrono::steady_clock::now().time_since_epoch().count();
 }
 
-static void trace_value_to_json(SkJSONWriter* writer, uint64_t argValue, uint8_t argType,
-                                const char* stringTableBase) {
-    skia::tracing_internals::TraceValueUnion value;
-    value.as_uint = argValue;
-
-    switch (argType) {
-        case TRACE_VALUE_TYPE_BOOL:
-            writer->appendBool(value.as_bool);
-            break;
-        case TRACE_VALUE_TYPE_UINT:
-            writer->appendU64(value.as_uint);
-            break;
-        case TRACE_VALUE_TYPE_INT:
-            writer->appendS64(value.as_int);
-            break;
-        case TRACE_VALUE_TYPE_DOUBLE:
-            writer->appendDouble(value.as_double);
-            break;
-        case TRACE_VALUE_TYPE_POINTER:
-            writer->appendPointer(value.as_pointer);
-            break;
-        case TRACE_VALUE_TYPE_STRING:
-            writer->appendString(value.as_string);
-            break;
-        case TRACE_VALUE_TYPE_COPY_STRING:
-            writer->appendString(stringTableBase + value.as_uint);
-            break;
-        default:
-            writer->appendString("<unknown type>");
-            break;
-    }
-}
-
 namespace {
 
 struct TraceEventSerializationState {
@@ -267,10 +234,10 @@ static void trace_event_to_json(SkJSONWriter* writer, TraceEvent* traceEvent,
             if (arg->fArgName && '#' == arg->fArgName[0]) {
                 writer->beginObject();
                 writer->appendName("id_ref");
-                trace_value_to_json(writer, arg->fArgValue, arg->fArgType, stringTable);
+                traceValueToJSON(writer, arg->fArgValue, arg->fArgType, stringTable);
                 writer->endObject();
             } else {
-                trace_value_to_json(writer, arg->fArgValue, arg->fArgType, stringTable);
+                traceValueToJSON(writer, arg->fArgValue, arg->fArgType, stringTable);
             }
         }
 
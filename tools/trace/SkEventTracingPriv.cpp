@@ -12,6 +12,8 @@
 #include "SkCommandLineFlags.h"
 #include "SkDebugfTracer.h"
 #include "SkEventTracer.h"
+#include "SkJSONWriter.h"
+#include "SkRingBufferTracer.h"
 #include "SkTraceEvent.h"
 
 DEFINE_string(trace, "",
@@ -20,7 +22,10 @@ DEFINE_string(trace, "",
               "  atrace     : Send events to Android ATrace\n"
               "  <filename> : Any other string is interpreted as a filename. Writes\n"
               "               trace events to specified file as JSON, for viewing\n"
-              "               with chrome://tracing");
+              "               with chrome://tracing\n"
+              "  ring:<filename> : Like <filename>, but events are recorded into\n"
+              "               per-thread ring buffers and written out as the program\n"
+              "               runs. Cheap enough to leave on when measuring performance");
 
 DEFINE_string(traceMatch, "",
               "Filter which categories are traced.\n"
@@ -39,6 +44,8 @@ void initializeEventTracingForTools(const char* traceFlag) {
         eventTracer = new SkATrace();
     } else if (0 == strcmp(traceFlag, "debugf")) {
         eventTracer = new SkDebugfTracer();
+    } else if (SkStrStartsWith(traceFlag, "ring:")) {
+        eventTracer = new SkRingBufferTracer(traceFlag + strlen("ring:"));
     } else {
         eventTracer = new SkChromeTracingTracer(traceFlag);
     }
@@ -82,3 +89,36 @@ const char* SkEventTracingCategories::getCategoryGroupName(const uint8_t* catego
     }
     return nullptr;
 }
+
+void traceValueToJSON(SkJSONWriter* writer, uint64_t argValue, uint8_t argType,
+                      const char* stringTableBase) {
+    skia::tracing_internals::TraceValueUnion value;
+    value.as_uint = argValue;
+
+    switch (argType) {
+        case TRACE_VALUE_TYPE_BOOL:
+            writer->appendBool(value.as_bool);
+            break;
+        case TRACE_VALUE_TYPE_UINT:
+            writer->appendU64(value.as_uint);
+            break;
+        case TRACE_VALUE_TYPE_INT:
+            writer->appendS64(value.as_int);
+            break;
+        case TRACE_VALUE_TYPE_DOUBLE:
+            writer->appendDouble(value.as_double);
+            break;
+        case TRACE_VALUE_TYPE_POINTER:
+            writer->appendPointer(value.as_pointer);
+            break;
+        case TRACE_VALUE_TYPE_STRING:
+            writer->appendString(value.as_string);
+            break;
+        case TRACE_VALUE_TYPE_COPY_STRING:
+            writer->appendString(stringTableBase + value.as_uint);
+            break;
+        default:
+            writer->appendString("<unknown type>");
+            break;
+    }
+}
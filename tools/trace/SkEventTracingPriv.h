@@ -10,12 +10,20 @@
 
 #include "SkMutex.h"
 
+class SkJSONWriter;
+
 /**
  * Construct and install an SkEventTracer, based on the mode,
  * defaulting to the --trace command line argument.
  */
 void initializeEventTracingForTools(const char* mode = nullptr);
 
+/**
+ * Write one trace event argument's value. Copied strings are offsets from stringTableBase.
+ */
+void traceValueToJSON(SkJSONWriter* writer, uint64_t argValue, uint8_t argType,
+                      const char* stringTableBase);
+
 /**
  * Helper class used by internal implementations of SkEventTracer to manage categories.
  */
@@ -0,0 +1,259 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRingBufferTracer.h"
+#include "SkJSONWriter.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkStream.h"
+#include "SkTraceEvent.h"
+
+#include <chrono>
+
+static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Events are a fixed size, so the rings are simple arrays. The trace macros pass at most two
+ * arguments, and copied strings are truncated to fit what's left of the event.
+ */
+struct SkRingBufferTracer::Event {
+    uint64_t fClock;
+    const char* fName;
+    uint64_t fID;
+    const char* fArgNames[2];
+    uint64_t fArgValues[2];   // Copied strings are stored as offsets into fStrings.
+    char fPhase;
+    uint8_t fNumArgs;
+    uint8_t fArgTypes[2];
+    char fStrings[64];
+};
+
+/**
+ * Each ring has one writer (its thread) and one reader (the flushing thread). Positions only
+ * increase; the writer publishes events by storing fWrite, and the reader frees their slots by
+ * storing fRead.
+ */
+struct SkRingBufferTracer::Ring {
+    static_assert(sizeof(void*) != 8 || sizeof(Event) <= 128, "Event");
+    Event fEvents[kRingEvents];
+
+    // Written only by the ring's thread.
+    std::atomic<uint64_t> fWrite{0};
+    std::atomic<uint64_t> fDropped{0};
+    uint64_t fReadCache = 0;   // A recent fRead, so the thread rarely reads the reader's line.
+    char fPad[64];
+
+    // Written only by the flushing thread.
+    std::atomic<uint64_t> fRead{0};
+    uint64_t fDroppedReported = 0;
+    int fThreadID = 0;
+};
+
+// Each tracer gets its own generation, so a thread can tell whether its cached ring belongs to
+// the current tracer, even if a new one is allocated where an old one was.
+static std::atomic<uint32_t> gNextGeneration{1};
+
+static thread_local struct {
+    uint32_t fGeneration;
+    void* fRing;
+} tThreadRing = { 0, nullptr };
+
+SkRingBufferTracer::SkRingBufferTracer(const char* filename)
+        : fFilename(filename)
+        , fGeneration(gNextGeneration++)
+        , fClockOffset(now_ns()) {
+    fFlushThread = std::thread([this] { this->flushLoop(); });
+}
+
+SkRingBufferTracer::~SkRingBufferTracer() {
+    {
+        std::lock_guard<std::mutex> lock(fFlushMutex);
+        fShuttingDown = true;
+    }
+    fFlushWake.notify_one();
+    fFlushThread.join();
+}
+
+SkRingBufferTracer::Ring* SkRingBufferTracer::threadRing() {
+    if (tThreadRing.fGeneration != fGeneration) {
+        SkAutoMutexAcquire lock(fRingsMutex);
+        Ring* ring = new Ring;
+        // Chrome tracing sorts threads by ID, so give them short ones in order of first event.
+        ring->fThreadID = fRings.count();
+        fRings.emplace_back(ring);
+        tThreadRing.fGeneration = fGeneration;
+        tThreadRing.fRing = ring;
+    }
+    return static_cast<Ring*>(tThreadRing.fRing);
+}
+
+bool SkRingBufferTracer::append(char phase, const char* name, uint64_t id, int numArgs,
+                                const char** argNames, const uint8_t* argTypes,
+                                const uint64_t* argValues) {
+    Ring* ring = this->threadRing();
+    const uint64_t write = ring->fWrite.load(std::memory_order_relaxed);
+    if (write - ring->fReadCache == kRingEvents) {
+        ring->fReadCache = ring->fRead.load(std::memory_order_acquire);
+        if (write - ring->fReadCache == kRingEvents) {
+            ring->fDropped.store(ring->fDropped.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    Event* event = &ring->fEvents[write % kRingEvents];
+    event->fClock = now_ns();
+    event->fName = name;
+    event->fID = id;
+    event->fPhase = phase;
+    event->fNumArgs = SkToU8(SkTMin(numArgs, 2));
+
+    size_t stringsUsed = 0;
+    for (int i = 0; i < event->fNumArgs; ++i) {
+        event->fArgNames[i] = argNames[i];
+        event->fArgTypes[i] = argTypes[i];
+        if (TRACE_VALUE_TYPE_COPY_STRING == argTypes[i]) {
+            skia::tracing_internals::TraceValueUnion value;
+            value.as_uint = argValues[i];
+            size_t length = SkTMin(strlen(value.as_string),
+                                   sizeof(event->fStrings) - stringsUsed - 1);
+            memcpy(event->fStrings + stringsUsed, value.as_string, length);
+            event->fStrings[stringsUsed + length] = 0;
+            event->fArgValues[i] = stringsUsed;
+            stringsUsed += length + 1;
+        } else {
+            event->fArgValues[i] = argValues[i];
+        }
+    }
+
+    ring->fWrite.store(write + 1, std::memory_order_release);
+    if (write - ring->fReadCache == kRingEvents / 2) {
+        // Don't wait for the next interval to start draining a busy thread's ring.
+        fFlushWake.notify_one();
+    }
+    return true;
+}
+
+SkEventTracer::Handle SkRingBufferTracer::addTraceEvent(char phase,
+                                                        const uint8_t* categoryEnabledFlag,
+                                                        const char* name,
+                                                        uint64_t id,
+                                                        int numArgs,
+                                                        const char** argNames,
+                                                        const uint8_t* argTypes,
+                                                        const uint64_t* argValues,
+                                                        uint8_t flags) {
+    // A complete event's duration is only known once it ends, so write it as a begin, and
+    // updateTraceEventDuration() as its end. The handle just says whether the begin made it.
+    if (TRACE_EVENT_PHASE_COMPLETE == phase) {
+        phase = TRACE_EVENT_PHASE_BEGIN;
+    }
+    return this->append(phase, name, id, numArgs, argNames, argTypes, argValues) ? 1 : 0;
+}
+
+void SkRingBufferTracer::updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                                  const char* name,
+                                                  SkEventTracer::Handle handle) {
+    if (handle) {
+        this->append(TRACE_EVENT_PHASE_END, name, 0, 0, nullptr, nullptr, nullptr);
+    }
+}
+
+void SkRingBufferTracer::drain(SkJSONWriter* writer) {
+    SkSTArray<16, Ring*, true> rings;
+    {
+        SkAutoMutexAcquire lock(fRingsMutex);
+        for (const auto& ring : fRings) {
+            rings.push_back(ring.get());
+        }
+    }
+
+    for (Ring* ring : rings) {
+        const uint64_t read = ring->fRead.load(std::memory_order_relaxed);
+        const uint64_t write = ring->fWrite.load(std::memory_order_acquire);
+        for (uint64_t i = read; i < write; ++i) {
+            const Event& event = ring->fEvents[i % kRingEvents];
+            writer->beginObject();
+
+            char phaseString[2] = { event.fPhase, 0 };
+            writer->appendString("ph", phaseString);
+            writer->appendString("name", event.fName);
+            if (0 != event.fID) {
+                // IDs are (almost) always pointers
+                writer->appendPointer("id", reinterpret_cast<void*>(event.fID));
+            }
+            // Microseconds are the standard time unit for tracing JSON files.
+            writer->appendDoubleDigits("ts", (event.fClock - fClockOffset) * 1E-3, 3);
+            writer->appendS32("tid", ring->fThreadID);
+            writer->appendS32("pid", 0);
+
+            if (event.fNumArgs) {
+                writer->beginObject("args");
+                for (int j = 0; j < event.fNumArgs; ++j) {
+                    writer->appendName(event.fArgNames[j]);
+                    traceValueToJSON(writer, event.fArgValues[j], event.fArgTypes[j],
+                                     event.fStrings);
+                }
+                writer->endObject();
+            }
+
+            writer->endObject();
+        }
+        ring->fRead.store(write, std::memory_order_release);
+
+        // Show any dropped events as a counter on the thread that dropped them.
+        const uint64_t dropped = ring->fDropped.load(std::memory_order_relaxed);
+        if (dropped != ring->fDroppedReported) {
+            writer->beginObject();
+            writer->appendString("ph", "C");
+            writer->appendString("name", "dropped events");
+            writer->appendDoubleDigits("ts", (now_ns() - fClockOffset) * 1E-3, 3);
+            writer->appendS32("tid", ring->fThreadID);
+            writer->appendS32("pid", 0);
+            writer->beginObject("args");
+            writer->appendU64("count", dropped);
+            writer->endObject();
+            writer->endObject();
+            ring->fDroppedReported = dropped;
+        }
+    }
+}
+
+void SkRingBufferTracer::flushLoop() {
+    SkString dirname = SkOSPath::Dirname(fFilename.c_str());
+    if (!dirname.isEmpty() && !sk_exists(dirname.c_str(), kWrite_SkFILE_Flag)) {
+        if (!sk_mkdir(dirname.c_str())) {
+            SkDebugf("Failed to create directory.");
+        }
+    }
+
+    SkFILEWStream fileStream(fFilename.c_str());
+    SkJSONWriter writer(&fileStream, SkJSONWriter::Mode::kFast);
+    // Viewers accept a trace with no closing bracket, so the file is usable while still growing.
+    writer.beginArray();
+
+    for (bool shuttingDown = false; !shuttingDown;) {
+        {
+            std::unique_lock<std::mutex> lock(fFlushMutex);
+            if (!fShuttingDown) {
+                // Busy threads may wake us early.
+                fFlushWake.wait_for(lock, std::chrono::milliseconds(kFlushIntervalMs));
+            }
+            shuttingDown = fShuttingDown;
+        }
+        this->drain(&writer);
+        writer.flush();
+        fileStream.flush();
+    }
+
+    writer.endArray();
+    writer.flush();
+    fileStream.flush();
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRingBufferTracer_DEFINED
+#define SkRingBufferTracer_DEFINED
+
+#include "SkEventTracer.h"
+#include "SkEventTracingPriv.h"
+#include "SkMutex.h"
+#include "SkString.h"
+#include "SkTArray.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class SkJSONWriter;
+
+/**
+ * A SkEventTracer implementation that logs events to JSON for viewing with chrome://tracing
+ * or Perfetto, cheaply enough to leave on while measuring.
+ *
+ * Each thread records fixed-size binary events into its own ring buffer, taking no locks, while
+ * a background thread drains the rings and appends their events to the file as it goes. If a
+ * thread gets a full ring ahead of the background thread, its new events are dropped (and the
+ * number dropped is recorded as a counter) rather than making the thread wait.
+ *
+ * Complete ('X') events are written as begin/end pairs, so they stream out without waiting
+ * for their duration.
+ */
+class SkRingBufferTracer : public SkEventTracer {
+public:
+    SkRingBufferTracer(const char* filename);
+    ~SkRingBufferTracer() override;
+
+    SkEventTracer::Handle addTraceEvent(char phase,
+                                        const uint8_t* categoryEnabledFlag,
+                                        const char* name,
+                                        uint64_t id,
+                                        int numArgs,
+                                        const char** argNames,
+                                        const uint8_t* argTypes,
+                                        const uint64_t* argValues,
+                                        uint8_t flags) override;
+
+    void updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                  const char* name,
+                                  SkEventTracer::Handle handle) override;
+
+    const uint8_t* getCategoryGroupEnabled(const char* name) override {
+        return fCategories.getCategoryGroupEnabled(name);
+    }
+
+    const char* getCategoryGroupName(const uint8_t* categoryEnabledFlag) override {
+        return fCategories.getCategoryGroupName(categoryEnabledFlag);
+    }
+
+private:
+    struct Event;
+    struct Ring;
+
+    enum {
+        // Events are 128 bytes, so this is 1MB per tracing thread.
+        kRingEvents = 8192,
+        kFlushIntervalMs = 50,
+    };
+
+    Ring* threadRing();
+    bool append(char phase, const char* name, uint64_t id, int numArgs, const char** argNames,
+                const uint8_t* argTypes, const uint64_t* argValues);
+
+    void flushLoop();
+    void drain(SkJSONWriter*);
+
+    SkString fFilename;
+    SkEventTracingCategories fCategories;
+    const uint32_t fGeneration;
+
+    SkMutex fRingsMutex;
+    SkTArray<std::unique_ptr<Ring>> fRings;   // Guarded by fRingsMutex.
+
+    const uint64_t fClockOffset;              // Timestamps are written relative to this.
+    std::mutex fFlushMutex;
+    std::condition_variable fFlushWake;
+    bool fShuttingDown = false;               // Guarded by fFlushMutex.
+    std::thread fFlushThread;
+};
+
+#endif
@@ -12,7 +12,7 @@
 #include "Skottie.h"
 
 static void draw_stats_box(SkCanvas* canvas, const skottie::Animation::Stats& stats) {
-    static constexpr SkRect kR = { 10, 10, 280, 120 };
+    static constexpr SkRect kR = { 10, 10, 280, 140 };
     static constexpr SkScalar kTextSize = 20;
 
     SkPaint paint;
@@ -44,6 +44,10 @@ static void draw_stats_box(SkCanvas* canvas, const skottie::Animation::Stats& st
                                                 stats.fTotalLoadTimeMS);
     canvas->drawText(total_load_time.c_str(),
                      total_load_time.size(), kR.x() + 10, kR.y() + kTextSize * 5, paint);
+    const auto static_layers = SkStringPrintf("Static layers: %lu / %lu",
+                                              stats.fStaticLayerCount, stats.fLayerCount);
+    canvas->drawText(static_layers.c_str(),
+                     static_layers.size(), kR.x() + 10, kR.y() + kTextSize * 6, paint);
 
     paint.setStyle(SkPaint::kStroke_Style);
     canvas->drawRect(kR, paint);